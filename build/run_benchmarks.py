@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 The Crashpad Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import argparse
+import os
+import subprocess
+import sys
+
+import run_tests
+
+# Benchmarks that can compare their results against a baseline, failing if
+# they regress. The others only report their results.
+BASELINE_BENCHMARKS = ('crashpad_snapshot_minidump_benchmark',)
+
+
+# Like run_tests.py, this keeps the list of benchmarks in-tree, so that a bot
+# can run them from a build directory without knowing what they are.
+def main(args):
+    parser = argparse.ArgumentParser(description='Run Crashpad benchmarks.')
+    parser.add_argument('binary_dir', help='Root of build dir')
+    parser.add_argument('benchmark',
+                        nargs='*',
+                        help='Specific benchmark(s) to run.')
+    parser.add_argument(
+        '--baseline-dir',
+        help='Fail if a benchmark regresses from its result in this '
+        'directory, written by an earlier --write-baseline-dir.')
+    parser.add_argument('--write-baseline-dir',
+                        help='Write benchmark results to this directory.')
+    parser.add_argument(
+        '--corpus',
+        action='append',
+        default=[],
+        help='A directory of minidumps for the minidump reading benchmark, '
+        'such as a fuzzer corpus. May be given more than once.')
+    args = parser.parse_args(args)
+
+    target_os = run_tests._BinaryDirTargetOS(args.binary_dir)
+    if target_os in ('android', 'fuchsia', 'ios'):
+        print('Benchmarks only run on the host, not on', target_os,
+              file=sys.stderr)
+        return 2
+
+    benchmarks = [
+        'crashpad_database_benchmark',
+        'crashpad_minidump_writer_benchmark',
+        'crashpad_snapshot_minidump_benchmark',
+    ]
+    if sys.platform.startswith('linux'):
+        benchmarks.append('crashpad_snapshot_capture_benchmark')
+
+    if args.benchmark:
+        for b in args.benchmark:
+            if b not in benchmarks:
+                print('Unrecognized benchmark:', b, file=sys.stderr)
+                return 3
+        benchmarks = args.benchmark
+
+    if args.write_baseline_dir and not os.path.isdir(args.write_baseline_dir):
+        os.makedirs(args.write_baseline_dir)
+
+    failed = []
+    for benchmark in benchmarks:
+        print('-' * 80)
+        print(benchmark)
+        print('-' * 80)
+        sys.stdout.flush()
+
+        command = [os.path.join(args.binary_dir, benchmark)]
+        if benchmark in BASELINE_BENCHMARKS:
+            baseline_name = benchmark + '.txt'
+            if args.baseline_dir:
+                baseline = os.path.join(args.baseline_dir, baseline_name)
+                if os.path.exists(baseline):
+                    command.append('--baseline=' + baseline)
+                else:
+                    print('No baseline at', baseline)
+            if args.write_baseline_dir:
+                command.append('--write-baseline=' +
+                               os.path.join(args.write_baseline_dir,
+                                            baseline_name))
+        if benchmark == 'crashpad_snapshot_minidump_benchmark':
+            for corpus in args.corpus:
+                command.append('--corpus=' + corpus)
+
+        # Keep going after a regression, so that one run reports all of them.
+        if subprocess.call(command) != 0:
+            failed.append(benchmark)
+
+    if failed:
+        print('Failed:', ', '.join(failed), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
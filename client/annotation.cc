@@ -36,6 +36,17 @@ void Annotation::SetSize(ValueSizeType size) {
   AnnotationList::Register()->Add(this);
 }
 
+void Annotation::PublishValue(void* value_ptr, ValueSizeType size) {
+  DCHECK(concurrent_access_guard_mode_ == ConcurrentAccessGuardMode::kSeqlock);
+  DCHECK_LT(size, kValueMaxSize);
+  {
+    ScopedSeqlockWrite write(seqlock_state_);
+    value_ptr_.store(value_ptr, std::memory_order_relaxed);
+    size_ = size;
+  }
+  AnnotationList::Register()->Add(this);
+}
+
 void Annotation::Clear() {
   size_ = 0;
 }
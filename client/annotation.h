@@ -28,6 +28,7 @@
 #include "base/strings/string_piece.h"
 #include "build/build_config.h"
 #include "util/synchronization/scoped_spin_guard.h"
+#include "util/synchronization/seqlock.h"
 
 namespace crashpad {
 #if BUILDFLAG(IS_IOS)
@@ -91,23 +92,42 @@ class Annotation {
     //! \brief A `NUL`-terminated C-string.
     kString = 1,
 
+    //! \brief An `int64_t`, in the byte order of the client.
+    kInt64 = 2,
+
+    //! \brief A `uint64_t`, in the byte order of the client.
+    kUint64 = 3,
+
+    //! \brief An IEEE 754 binary64 `double`, in the byte order of the client.
+    kDouble = 4,
+
+    //! \brief A crashpad::UUID structure, whose fields are in the byte order
+    //!     of the client.
+    kUUID = 5,
+
     //! \brief Clients may declare their own custom types by using values
     //!     greater than this.
     kUserDefinedStart = 0x8000,
   };
 
   //! \brief Mode used to guard concurrent reads from writes.
-  enum class ConcurrentAccessGuardMode : bool {
+  enum class ConcurrentAccessGuardMode : uint8_t {
     //! \!brief Annotation does not guard reads from concurrent
     //!     writes. Annotation values can be corrupted if the process crashes
     //!     mid-write and the handler tries to read from the Annotation while
     //!     being written to.
-    kUnguarded = false,
+    kUnguarded = 0,
 
     //! \!brief Annotation guards reads from concurrent writes using
     //!     ScopedSpinGuard. Clients must use TryCreateScopedSpinGuard()
     //!     before reading or writing the data in this Annotation.
-    kScopedSpinGuard = true,
+    kScopedSpinGuard = 1,
+
+    //! \!brief Annotation guards reads from concurrent writes using a
+    //!     sequence counter. Writers use CreateScopedSeqlockWrite() around
+    //!     each update and never wait; readers retry until they observe the
+    //!     same even sequence before and after reading the data.
+    kSeqlock = 2,
   };
 
   //! \brief Creates a user-defined Annotation::Type.
@@ -185,7 +205,9 @@ class Annotation {
   Type type() const { return type_; }
   ValueSizeType size() const { return size_; }
   const char* name() const { return name_; }
-  const void* value() const { return value_ptr_; }
+  const void* value() const {
+    return value_ptr_.load(std::memory_order_relaxed);
+  }
 
   ConcurrentAccessGuardMode concurrent_access_guard_mode() const {
     return concurrent_access_guard_mode_;
@@ -203,14 +225,25 @@ class Annotation {
     // operator<<(bool).
     DCHECK(concurrent_access_guard_mode_ ==
            ConcurrentAccessGuardMode::kScopedSpinGuard);
-    if (concurrent_access_guard_mode_ ==
-        ConcurrentAccessGuardMode::kUnguarded) {
+    if (concurrent_access_guard_mode_ !=
+        ConcurrentAccessGuardMode::kScopedSpinGuard) {
       return std::nullopt;
     }
     return ScopedSpinGuard::TryCreateScopedSpinGuard(timeout_ns,
                                                      spin_guard_state_);
   }
 
+  //! \brief Marks an update to this Annotation, which must guard concurrent
+  //!     access using a seqlock, for the lifetime of the returned object.
+  //!
+  //! This never blocks. Updates to a single Annotation must not be made from
+  //! more than one thread at a time.
+  ScopedSeqlockWrite CreateScopedSeqlockWrite() {
+    DCHECK(concurrent_access_guard_mode_ ==
+           ConcurrentAccessGuardMode::kSeqlock);
+    return ScopedSeqlockWrite(seqlock_state_);
+  }
+
  protected:
   //! \brief Constructs a new annotation.
   //!
@@ -237,7 +270,32 @@ class Annotation {
         size_(0),
         type_(type),
         concurrent_access_guard_mode_(concurrent_access_guard_mode),
-        spin_guard_state_() {}
+        spin_guard_state_() {
+    DCHECK(concurrent_access_guard_mode !=
+           ConcurrentAccessGuardMode::kSeqlock);
+  }
+
+  //! \brief A tag selecting the constructor for Annotations that guard
+  //!     concurrent access using ConcurrentAccessGuardMode::kSeqlock.
+  struct SeqlockTag {};
+
+  //! \brief Constructs a new annotation whose updates are guarded by a
+  //!     seqlock.
+  //!
+  //! \param[in] type The data type of the value of the annotation.
+  //! \param[in] name A `NUL`-terminated C-string name for the annotation.
+  //! \param[in] value_ptr A pointer to the value for the annotation.
+  constexpr Annotation(Type type,
+                       const char name[],
+                       void* value_ptr,
+                       SeqlockTag)
+      : link_node_(nullptr),
+        name_(name),
+        value_ptr_(value_ptr),
+        size_(0),
+        type_(type),
+        concurrent_access_guard_mode_(ConcurrentAccessGuardMode::kSeqlock),
+        seqlock_state_() {}
 
   friend class AnnotationList;
 #if BUILDFLAG(IS_IOS)
@@ -246,6 +304,21 @@ class Annotation {
 
   std::atomic<Annotation*>& link_node() { return link_node_; }
 
+  //! \brief Points this Annotation at a different, fully-written value.
+  //!
+  //! This is for subclasses that build each new value in separate storage.
+  //! The pointer and size are swapped under the Annotation’s seqlock, so a
+  //! reader sees either the previous value or the new one in full, and a
+  //! crash can only catch a write in progress during these two stores.
+  //! Requires ConcurrentAccessGuardMode::kSeqlock.
+  //!
+  //! \param[in] value_ptr The storage holding the new value. This must remain
+  //!     valid and be left unchanged until it is no longer published.
+  //! \param[in] size The number of bytes of \a value_ptr to record.
+  void PublishValue(void* value_ptr, ValueSizeType size);
+
+  const SeqlockState& seqlock_state() const { return seqlock_state_; }
+
   Annotation* GetLinkNode(std::memory_order order = std::memory_order_seq_cst) {
     return link_node_.load(order);
   }
@@ -263,14 +336,23 @@ class Annotation {
   std::atomic<Annotation*> link_node_;
 
   const char* const name_;
-  void* const value_ptr_;
+
+  //! \brief The value, which changes only through \sa PublishValue().
+  std::atomic<void*> value_ptr_;
+  static_assert(sizeof(std::atomic<void*>) == sizeof(void*),
+                "std::atomic<void*> adds size to void*");
   ValueSizeType size_;
   const Type type_;
 
   //! \brief Mode used to guard concurrent reads from writes.
   const ConcurrentAccessGuardMode concurrent_access_guard_mode_;
 
-  SpinGuardState spin_guard_state_;
+  //! \brief The guard state for concurrent_access_guard_mode_. Both
+  //!     alternatives are one byte, so older readers see the same layout.
+  union {
+    SpinGuardState spin_guard_state_;
+    SeqlockState seqlock_state_;
+  };
 };
 
 //! \brief An \sa Annotation that stores a `NUL`-terminated C-string value.
@@ -61,12 +61,21 @@ template class AnnotationList::IteratorBase<const Annotation>;
 
 AnnotationList::AnnotationList()
     : tail_pointer_(&tail_),
-      head_(Annotation::Type::kInvalid, nullptr, nullptr),
-      tail_(Annotation::Type::kInvalid, nullptr, nullptr) {
+      head_(Annotation::Type::kInvalid, nullptr, &first_block_),
+      tail_(Annotation::Type::kInvalid, nullptr, nullptr),
+      first_block_(),
+      current_block_(&first_block_) {
   head_.link_node().store(&tail_);
 }
 
-AnnotationList::~AnnotationList() {}
+AnnotationList::~AnnotationList() {
+  Block* block = first_block_.next.load(std::memory_order_acquire);
+  while (block) {
+    Block* next = block->next.load(std::memory_order_acquire);
+    delete block;
+    block = next;
+  }
+}
 
 // static
 AnnotationList* AnnotationList::Get() {
@@ -103,6 +112,40 @@ void AnnotationList::Add(Annotation* annotation) {
     // re-loaded |head_next|.
     annotation->link_node().store(head_next, std::memory_order_relaxed);
   }
+
+  AddToRegistry(annotation);
+}
+
+void AnnotationList::AddToRegistry(Annotation* annotation) {
+  Block* block = current_block_.load(std::memory_order_acquire);
+  while (true) {
+    // Each writer claims its own slot, so writers only contend on the counter
+    // of the block currently being filled.
+    uint32_t slot = block->used.fetch_add(1, std::memory_order_relaxed);
+    if (slot < Block::kCapacity) {
+      block->annotations[slot].store(annotation, std::memory_order_release);
+      return;
+    }
+
+    // |block| is full. Move on to the next block, installing a new one if no
+    // other thread has done so yet.
+    Block* next = block->next.load(std::memory_order_acquire);
+    if (!next) {
+      Block* new_block = new Block();
+      if (block->next.compare_exchange_strong(
+              next, new_block, std::memory_order_acq_rel)) {
+        next = new_block;
+      } else {
+        // Another thread installed a block first, and |next| now refers to it.
+        delete new_block;
+      }
+    }
+
+    Block* expected = block;
+    current_block_.compare_exchange_strong(
+        expected, next, std::memory_order_acq_rel);
+    block = next;
+  }
 }
 
 AnnotationList::Iterator AnnotationList::begin() {
@@ -15,6 +15,9 @@
 #ifndef CRASHPAD_CLIENT_ANNOTATION_LIST_H_
 #define CRASHPAD_CLIENT_ANNOTATION_LIST_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <iterator>
 
 #include "build/build_config.h"
@@ -33,8 +36,38 @@ class InProcessIntermediateDumpHandler;
 //! structure in order to use the annotations system. Once a list object has
 //! been registered on the CrashpadInfo, a different instance should not
 //! be used instead.
+//!
+//! In addition to the linked list, every added annotation is recorded in a
+//! registry of fixed-size blocks of pointers. The registry is advertised to
+//! the handler through the value of the dummy head node, and allows the
+//! handler to collect the addresses of all annotations with one remote read
+//! per block rather than one per annotation. Handlers that predate the
+//! registry continue to walk the linked list.
 class AnnotationList {
  public:
+  //! \brief A fixed-size block of the annotation registry.
+  //!
+  //! This is public so that the handler can verify its layout. Clients should
+  //! not access it directly.
+  struct Block {
+    //! \brief The number of annotation pointers held by each block, chosen so
+    //!     that a block occupies 2kB in a 64-bit process.
+    static constexpr size_t kCapacity = 254;
+
+    Block() : next(nullptr), annotations(), used(0) {}
+
+    //! \brief The next block in the registry, or `nullptr`.
+    std::atomic<Block*> next;
+
+    //! \brief The annotations recorded in this block. A slot that has been
+    //!     claimed but not yet filled is `nullptr`.
+    std::atomic<Annotation*> annotations[kCapacity];
+
+    //! \brief The number of slots that have been claimed. This may exceed
+    //!     kCapacity once the block is full.
+    std::atomic<uint32_t> used;
+  };
+
   AnnotationList();
 
   AnnotationList(const AnnotationList&) = delete;
@@ -125,13 +158,27 @@ class AnnotationList {
   const Annotation* head() const { return &head_; }
 
  private:
+  // Adds |annotation| to the first block of the registry with a free slot,
+  // allocating a new block if all are full.
+  void AddToRegistry(Annotation* annotation);
+
   // To make it easier for the handler to locate the dummy tail node, store the
   // pointer. Placed first for packing.
   const Annotation* const tail_pointer_;
 
   // Dummy linked-list head and tail elements of \a Annotation::Type::kInvalid.
+  // The value of |head_| points to |first_block_|.
   Annotation head_;
   Annotation tail_;
+
+  // The first block of the registry is embedded so that a registry exists
+  // without any allocation. Further blocks are allocated as needed, and are
+  // owned by this object.
+  Block first_block_;
+
+  // The block that new annotations are added to. This is only a hint: blocks
+  // before it are full, but it may be full as well.
+  std::atomic<Block*> current_block_;
 };
 
 }  // namespace crashpad
@@ -23,6 +23,7 @@
 #include "test/gtest_death.h"
 #include "util/misc/clock.h"
 #include "util/synchronization/scoped_spin_guard.h"
+#include "util/synchronization/seqlock.h"
 #include "util/thread/thread.h"
 
 namespace crashpad {
@@ -51,6 +52,30 @@ class SpinGuardAnnotation final : public Annotation {
   bool value_;
 };
 
+class SeqlockAnnotation final : public Annotation {
+ public:
+  SeqlockAnnotation(Annotation::Type type, const char name[])
+      : Annotation(type, name, &value_, SeqlockTag()), value_() {}
+
+  void Set(uint32_t value) {
+    ScopedSeqlockWrite write = CreateScopedSeqlockWrite();
+    value_ = value;
+    SetSize(sizeof(value_));
+  }
+
+  uint32_t Get() const {
+    uint32_t value = 0;
+    // Readers in the same process use the same protocol as the handler.
+    EXPECT_TRUE(SeqlockRead(seqlock_state(), 0, [&] { value = value_; }));
+    return value;
+  }
+
+  uint8_t sequence() const { return seqlock_state().sequence; }
+
+ private:
+  uint32_t value_;
+};
+
 class ScopedSpinGuardUnlockThread final : public Thread {
  public:
   ScopedSpinGuardUnlockThread(ScopedSpinGuard scoped_spin_guard,
@@ -211,6 +236,39 @@ TEST_F(Annotation,
   unlock_thread.Join();
 }
 
+TEST_F(Annotation, CustomAnnotationShouldSupportSeqlockAndSet) {
+  constexpr crashpad::Annotation::Type kType =
+      crashpad::Annotation::UserDefinedType(1);
+  SeqlockAnnotation seqlock_annotation(kType, "seqlock");
+  EXPECT_EQ(seqlock_annotation.concurrent_access_guard_mode(),
+            crashpad::Annotation::ConcurrentAccessGuardMode::kSeqlock);
+  EXPECT_EQ(seqlock_annotation.sequence(), 0u);
+  seqlock_annotation.Set(42);
+  EXPECT_EQ(seqlock_annotation.sequence(), 2u);
+  EXPECT_EQ(4u, seqlock_annotation.size());
+  EXPECT_EQ(42u, seqlock_annotation.Get());
+#if !DCHECK_IS_ON()
+  // A seqlock-guarded annotation can't be locked.
+  EXPECT_EQ(std::nullopt, seqlock_annotation.TryCreateScopedSpinGuard(0));
+#endif
+}
+
+TEST_F(Annotation, CustomAnnotationSeqlockSetDoesNotWaitForReaders) {
+  constexpr crashpad::Annotation::Type kType =
+      crashpad::Annotation::UserDefinedType(1);
+  SeqlockAnnotation seqlock_annotation(kType, "seqlock");
+  seqlock_annotation.Set(1);
+  {
+    // A write in progress makes the sequence odd, and is visible as such to a
+    // reader, but a writer never has to wait for anything.
+    ScopedSeqlockWrite write = seqlock_annotation.CreateScopedSeqlockWrite();
+    EXPECT_FALSE(SeqlockState::IsStable(seqlock_annotation.sequence()));
+  }
+  seqlock_annotation.Set(2);
+  EXPECT_EQ(seqlock_annotation.sequence(), 6u);
+  EXPECT_EQ(2u, seqlock_annotation.Get());
+}
+
 TEST(StringAnnotation, ArrayOfString) {
   static crashpad::StringAnnotation<4> annotations[] = {
       {"test-1", crashpad::StringAnnotation<4>::Tag::kArray},
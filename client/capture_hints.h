@@ -0,0 +1,180 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_CAPTURE_HINTS_H_
+#define CRASHPAD_CLIENT_CAPTURE_HINTS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+
+//! \brief A fixed-size table of hints that tell the Crashpad handler what to
+//!     capture from a module.
+//!
+//! The table is registered with CrashpadInfo::set_capture_hints(). Its layout
+//! is the same in 32-bit and 64-bit processes and doesn’t refer to any other
+//! structures, so the handler reads all of it at once rather than following
+//! pointers.
+//!
+//! This class doesn’t perform any dynamic allocations. It isn’t thread-safe.
+class CaptureHints {
+ public:
+  //! \brief The maximum number of ranges of each kind in the table.
+  static constexpr size_t kMaxRanges = 16;
+
+  enum : uint32_t {
+    kSignature = 'CPch',
+    kVersion = 1,
+  };
+
+  //! \brief Flags set with set_skip_annotations() and set_shallow().
+  enum Flags : uint32_t {
+    //! \brief The handler doesn’t read the module’s annotations.
+    kSkipAnnotations = 1 << 0,
+
+    //! \brief The handler records only the module’s identity.
+    kShallow = 1 << 1,
+  };
+
+  //! \brief A range of memory in the process.
+  struct Range {
+    //! \brief The base address of the range.
+    uint64_t base;
+
+    //! \brief The size of the range in bytes.
+    uint64_t size;
+  };
+
+  CaptureHints()
+      : signature_(kSignature),
+        size_(sizeof(*this)),
+        version_(kVersion),
+        flags_(0),
+        max_stack_bytes_per_thread_(0),
+        copy_range_count_(0),
+        skip_range_count_(0),
+        copy_ranges_(),
+        skip_ranges_() {}
+
+  CaptureHints(const CaptureHints&) = delete;
+  CaptureHints& operator=(const CaptureHints&) = delete;
+
+  //! \brief Adds a range that the handler always captures, as with
+  //!     CrashpadInfo::set_extra_memory_ranges().
+  //!
+  //! \return `true` on success. `false` if the table already has kMaxRanges
+  //!     ranges to capture.
+  bool AddCopyRange(const void* base, size_t size) {
+    return AddRange(copy_ranges_, &copy_range_count_, base, size);
+  }
+
+  //! \brief Adds a range that the handler never captures as memory referenced
+  //!     by the process’ threads or as a range added with AddCopyRange().
+  //!
+  //! Skip ranges from every module apply to the whole process. Ranges that
+  //! overlap a skip range aren’t captured at all, but threads’ stacks are
+  //! captured even if they overlap a skip range.
+  //!
+  //! \return `true` on success. `false` if the table already has kMaxRanges
+  //!     ranges to skip.
+  bool AddSkipRange(const void* base, size_t size) {
+    return AddRange(skip_ranges_, &skip_range_count_, base, size);
+  }
+
+  //! \brief Sets whether the handler skips reading the module’s annotations.
+  void set_skip_annotations(bool skip) {
+    flags_ = skip ? flags_ | kSkipAnnotations : flags_ & ~kSkipAnnotations;
+  }
+
+  //! \brief Sets whether the handler captures the module shallowly, recording
+  //!     its name, address range, and build ID or debug record, but nothing
+  //!     from its CrashpadInfo structure.
+  //!
+  //! This is what the handler does for modules selected by its
+  //! `--shallow-module-build-id` and `--shallow-module-path-prefix` options,
+  //! for modules that know they contribute nothing else to reports. The rest
+  //! of the table is ignored for a shallow module, other than this flag.
+  void set_shallow(bool shallow) {
+    flags_ = shallow ? flags_ | kShallow : flags_ & ~kShallow;
+  }
+
+  //! \brief Limits the number of bytes of each thread’s stack that the handler
+  //!     captures, starting from the stack pointer.
+  //!
+  //! When several modules set a limit, the smallest applies. The handler
+  //! rounds the limit down to a multiple of 16 bytes.
+  //!
+  //! \param[in] max_bytes The limit, or `0` for no limit.
+  void set_max_stack_bytes_per_thread(uint32_t max_bytes) {
+    max_stack_bytes_per_thread_ = max_bytes;
+  }
+
+  //! \return `true` if the table is well-formed. The handler ignores tables
+  //!     that aren’t.
+  bool IsValid() const {
+    return signature_ == kSignature && version_ >= kVersion &&
+           size_ >= sizeof(*this) && copy_range_count_ <= kMaxRanges &&
+           skip_range_count_ <= kMaxRanges;
+  }
+
+  //! \{
+  //! \brief Accessors used by the handler.
+  bool skip_annotations() const { return flags_ & kSkipAnnotations; }
+  bool shallow() const { return flags_ & kShallow; }
+  uint32_t max_stack_bytes_per_thread() const {
+    return max_stack_bytes_per_thread_;
+  }
+  size_t copy_range_count() const { return copy_range_count_; }
+  const Range& copy_range(size_t index) const { return copy_ranges_[index]; }
+  size_t skip_range_count() const { return skip_range_count_; }
+  const Range& skip_range(size_t index) const { return skip_ranges_[index]; }
+  //! \}
+
+ private:
+  static bool AddRange(Range* ranges,
+                       uint16_t* count,
+                       const void* base,
+                       size_t size) {
+    if (*count >= kMaxRanges) {
+      return false;
+    }
+    ranges[*count].base = FromPointerCast<uint64_t>(base);
+    ranges[*count].size = size;
+    ++*count;
+    return true;
+  }
+
+  uint32_t signature_;  // kSignature
+  uint32_t size_;  // The size of the entire CaptureHints structure.
+  uint32_t version_;  // kVersion
+  uint32_t flags_;  // Flags
+  uint32_t max_stack_bytes_per_thread_;
+  uint16_t copy_range_count_;
+  uint16_t skip_range_count_;
+  Range copy_ranges_[kMaxRanges];
+  Range skip_ranges_[kMaxRanges];
+};
+
+static_assert(std::is_standard_layout_v<CaptureHints> &&
+                  sizeof(CaptureHints) == 536,
+              "CaptureHints layout must not change across builds");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_CAPTURE_HINTS_H_
@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/capture_hints.h"
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(CaptureHints, Empty) {
+  CaptureHints hints;
+  EXPECT_TRUE(hints.IsValid());
+  EXPECT_FALSE(hints.skip_annotations());
+  EXPECT_FALSE(hints.shallow());
+  EXPECT_EQ(hints.max_stack_bytes_per_thread(), 0u);
+  EXPECT_EQ(hints.copy_range_count(), 0u);
+  EXPECT_EQ(hints.skip_range_count(), 0u);
+}
+
+TEST(CaptureHints, Ranges) {
+  char buffer[CaptureHints::kMaxRanges + 1];
+  CaptureHints hints;
+  for (size_t index = 0; index < CaptureHints::kMaxRanges; ++index) {
+    EXPECT_TRUE(hints.AddCopyRange(&buffer[index], 1));
+    EXPECT_TRUE(hints.AddSkipRange(&buffer[index], index + 1));
+  }
+  EXPECT_FALSE(hints.AddCopyRange(&buffer[CaptureHints::kMaxRanges], 1));
+  EXPECT_FALSE(hints.AddSkipRange(&buffer[CaptureHints::kMaxRanges], 1));
+
+  ASSERT_EQ(hints.copy_range_count(), CaptureHints::kMaxRanges);
+  ASSERT_EQ(hints.skip_range_count(), CaptureHints::kMaxRanges);
+  for (size_t index = 0; index < CaptureHints::kMaxRanges; ++index) {
+    EXPECT_EQ(hints.copy_range(index).base,
+              FromPointerCast<uint64_t>(&buffer[index]));
+    EXPECT_EQ(hints.copy_range(index).size, 1u);
+    EXPECT_EQ(hints.skip_range(index).base,
+              FromPointerCast<uint64_t>(&buffer[index]));
+    EXPECT_EQ(hints.skip_range(index).size, index + 1);
+  }
+  EXPECT_TRUE(hints.IsValid());
+}
+
+TEST(CaptureHints, Flags) {
+  CaptureHints hints;
+  hints.set_skip_annotations(true);
+  EXPECT_TRUE(hints.skip_annotations());
+  hints.set_skip_annotations(false);
+  EXPECT_FALSE(hints.skip_annotations());
+
+  hints.set_shallow(true);
+  hints.set_skip_annotations(true);
+  EXPECT_TRUE(hints.shallow());
+  hints.set_skip_annotations(false);
+  EXPECT_TRUE(hints.shallow());
+  hints.set_shallow(false);
+  EXPECT_FALSE(hints.shallow());
+
+  hints.set_max_stack_bytes_per_thread(8192);
+  EXPECT_EQ(hints.max_stack_bytes_per_thread(), 8192u);
+}
+
+TEST(CaptureHints, Invalid) {
+  CaptureHints hints;
+  memset(&hints, 0, sizeof(hints));
+  EXPECT_FALSE(hints.IsValid());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,12 +14,19 @@
 
 #include "client/crash_report_database.h"
 
+#include <string.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <memory>
+
+#include "base/check.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_section_reader.h"
 #include "util/file/filesystem.h"
 
 namespace crashpad {
@@ -28,6 +35,70 @@ namespace {
 constexpr base::FilePath::CharType kAttachmentsDirectory[] =
     FILE_PATH_LITERAL("attachments");
 
+constexpr base::FilePath::CharType kUploadBodiesDirectory[] =
+    FILE_PATH_LITERAL("upload_bodies");
+
+// A packed report file is the minidump, followed by the contents of each
+// packed attachment, followed by a directory of PackedAttachments, each
+// followed by name_size bytes of name, and finally a PackedReportFooter. The
+// footer is at the end so that the minidump can be written from the start of
+// the file before it’s known what will follow it.
+struct PackedAttachment {
+  uint64_t offset;
+  uint64_t size;
+  uint32_t name_size;
+  uint32_t reserved;
+};
+static_assert(sizeof(PackedAttachment) == 24,
+              "PackedAttachment must not have padding");
+
+struct PackedReportFooter {
+  static constexpr uint32_t kMagic = 'CPpk';
+  static constexpr uint32_t kVersion = 1;
+
+  uint64_t minidump_size;
+  uint64_t directory_offset;
+  uint32_t attachment_count;
+  uint32_t reserved;
+  uint32_t version;
+  uint32_t magic;
+};
+static_assert(sizeof(PackedReportFooter) == 32,
+              "PackedReportFooter must not have padding");
+
+// The file in a report’s attachments directory that holds the parameters
+// stored by NewReport::SetUploadParameters(). AttachmentNameIsOK() rejects this
+// name, so it can’t be mistaken for an attachment.
+constexpr base::FilePath::CharType kUploadParametersName[] =
+    FILE_PATH_LITERAL("~upload_parameters");
+
+// An upload parameters file is an UploadParametersHeader, followed by
+// signature_size bytes of signature, followed by parameter_count
+// UploadParameters, each followed by key_size bytes of key and value_size bytes
+// of value.
+struct UploadParametersHeader {
+  static constexpr uint32_t kMagic = 'CPup';
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t parameter_count;
+  uint32_t signature_size;
+};
+static_assert(sizeof(UploadParametersHeader) == 16,
+              "UploadParametersHeader must not have padding");
+
+struct UploadParameter {
+  uint32_t key_size;
+  uint32_t value_size;
+};
+static_assert(sizeof(UploadParameter) == 8,
+              "UploadParameter must not have padding");
+
+// Attachment names are limited to this length, which is more than enough for
+// any file name.
+constexpr uint32_t kMaxPackedAttachmentNameSize = 255;
+
 bool AttachmentNameIsOK(const std::string& name) {
   for (const char c : name) {
     if (c != '_' && c != '-' && c != '.' && !isalnum(c))
@@ -35,6 +106,125 @@ bool AttachmentNameIsOK(const std::string& name) {
   }
   return true;
 }
+
+// An archive written by ExportReports() is an ArchiveHeader, followed by a
+// sequence of ArchiveRecords, each followed by name_size bytes of name and then
+// size bytes of data. Each report begins with a kReport record, whose name is
+// the report’s remote ID and whose data is an ArchivedReport. The records for
+// its minidump, attachments, and upload parameters follow. The archive ends
+// with a kEnd record, so that a truncated archive isn’t mistaken for a whole
+// one. Records of unknown types are skipped when importing.
+struct ArchiveHeader {
+  static constexpr uint32_t kMagic = 'CPar';
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+};
+static_assert(sizeof(ArchiveHeader) == 8,
+              "ArchiveHeader must not have padding");
+
+struct ArchiveRecord {
+  enum Type : uint32_t {
+    kEnd = 0,
+    kReport,
+    kMinidump,
+
+    // The name is the attachment’s name.
+    kAttachment,
+
+    // The data is the signature given to NewReport::SetUploadParameters(). A
+    // report with upload parameters always has this record, even if the
+    // signature is empty.
+    kUploadSignature,
+
+    // The name is the parameter’s key, and the data is its value.
+    kUploadParameter,
+  };
+
+  uint64_t size;
+  uint32_t type;
+  uint32_t name_size;
+};
+static_assert(sizeof(ArchiveRecord) == 16,
+              "ArchiveRecord must not have padding");
+
+struct ArchivedReport {
+  static constexpr uint32_t kFlagUploaded = 1 << 0;
+  static constexpr uint32_t kFlagUploadExplicitlyRequested = 1 << 1;
+
+  UUID uuid;
+  int64_t creation_time;
+  int64_t last_upload_attempt_time;
+  int32_t upload_attempts;
+  uint32_t flags;
+};
+static_assert(sizeof(ArchivedReport) == 40,
+              "ArchivedReport must not have padding");
+
+// Limits on the names and on the values of upload parameters in an archive,
+// which are read into memory. Minidumps and attachments are copied in pieces
+// of kArchiveCopyBufferSize, and aren’t limited.
+constexpr uint32_t kMaxArchiveNameSize = 4096;
+constexpr uint64_t kMaxArchiveValueSize = 1024 * 1024;
+constexpr size_t kArchiveCopyBufferSize = 64 * 1024;
+
+bool WriteArchiveRecord(FileWriterInterface* writer,
+                        ArchiveRecord::Type type,
+                        const std::string& name,
+                        uint64_t size) {
+  ArchiveRecord record = {};
+  record.size = size;
+  record.type = type;
+  record.name_size = base::checked_cast<uint32_t>(name.size());
+  return writer->Write(&record, sizeof(record)) &&
+         (name.empty() || writer->Write(name.data(), name.size()));
+}
+
+// Copies exactly size bytes from reader to writer, or discards them if writer
+// is nullptr.
+bool CopyArchiveData(FileReaderInterface* reader,
+                     FileWriterInterface* writer,
+                     uint64_t size) {
+  std::unique_ptr<char[]> buffer(new char[kArchiveCopyBufferSize]);
+  while (size > 0) {
+    const size_t chunk_size = static_cast<size_t>(
+        std::min(size, static_cast<uint64_t>(kArchiveCopyBufferSize)));
+    if (!reader->ReadExactly(buffer.get(), chunk_size)) {
+      return false;
+    }
+    if (writer && !writer->Write(buffer.get(), chunk_size)) {
+      return false;
+    }
+    size -= chunk_size;
+  }
+  return true;
+}
+
+// Writes a record holding the remaining contents of reader.
+bool WriteArchiveFile(FileWriterInterface* writer,
+                      ArchiveRecord::Type type,
+                      const std::string& name,
+                      FileReaderInterface* reader) {
+  const FileOffset size = reader->Seek(0, SEEK_END);
+  if (size < 0 || reader->Seek(0, SEEK_SET) != 0) {
+    return false;
+  }
+  return WriteArchiveRecord(writer, type, name, size) &&
+         CopyArchiveData(reader, writer, size);
+}
+
+bool ReadArchiveString(FileReaderInterface* reader,
+                       uint64_t size,
+                       std::string* string) {
+  if (size > kMaxArchiveValueSize) {
+    LOG(ERROR) << "archive value size " << size << " too large";
+    return false;
+  }
+  string->resize(static_cast<size_t>(size));
+  return string->empty() || reader->ReadExactly(string->data(), string->size());
+}
+
 }  // namespace
 
 CrashReportDatabase::Report::Report()
@@ -46,15 +236,18 @@ CrashReportDatabase::Report::Report()
       last_upload_attempt_time(0),
       upload_attempts(0),
       upload_explicitly_requested(false),
-      total_size(0u) {}
+      total_size(0u),
+      upload_resumption_url() {}
 
 CrashReportDatabase::NewReport::NewReport()
     : writer_(std::make_unique<FileWriter>()),
       file_remover_(),
       attachment_writers_(),
       attachment_removers_(),
+      packed_attachments_(),
       uuid_(),
-      database_() {}
+      database_(),
+      pack_attachments_(false) {}
 
 CrashReportDatabase::NewReport::~NewReport() = default;
 
@@ -92,23 +285,31 @@ FileReaderInterface* CrashReportDatabase::NewReport::Reader() {
   return reader_.get();
 }
 
-FileWriter* CrashReportDatabase::NewReport::AddAttachment(
+base::FilePath CrashReportDatabase::NewReport::AttachmentPath(
     const std::string& name) {
   if (!AttachmentNameIsOK(name)) {
     LOG(ERROR) << "invalid name for attachment " << name;
-    return nullptr;
+    return base::FilePath();
   }
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
   if (!LoggingCreateDirectory(
           report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
-    return nullptr;
+    return base::FilePath();
   }
 #if BUILDFLAG(IS_WIN)
   const std::wstring name_string = base::UTF8ToWide(name);
 #else
   const std::string name_string = name;
 #endif
-  base::FilePath attachment_path = report_attachments_dir.Append(name_string);
+  return report_attachments_dir.Append(name_string);
+}
+
+FileWriter* CrashReportDatabase::NewReport::AddAttachment(
+    const std::string& name) {
+  base::FilePath attachment_path = AttachmentPath(name);
+  if (attachment_path.empty()) {
+    return nullptr;
+  }
   auto writer = std::make_unique<FileWriter>();
   if (!writer->Open(attachment_path,
                     FileWriteMode::kCreateOrFail,
@@ -120,6 +321,252 @@ FileWriter* CrashReportDatabase::NewReport::AddAttachment(
   return attachment_writers_.back().get();
 }
 
+bool CrashReportDatabase::NewReport::AddAttachmentFromFile(
+    const std::string& name,
+    const base::FilePath& source) {
+  if (pack_attachments_) {
+    if (!AttachmentNameIsOK(name) ||
+        name.size() > kMaxPackedAttachmentNameSize) {
+      LOG(ERROR) << "invalid name for attachment " << name;
+      return false;
+    }
+    for (const auto& [packed_name, reader] : packed_attachments_) {
+      if (packed_name == name) {
+        LOG(ERROR) << "duplicate attachment " << name;
+        return false;
+      }
+    }
+    auto reader = std::make_unique<FileReader>();
+    if (!reader->Open(source)) {
+      return false;
+    }
+    packed_attachments_.emplace_back(name, std::move(reader));
+    return true;
+  }
+
+  base::FilePath attachment_path = AttachmentPath(name);
+  if (attachment_path.empty() ||
+      !LoggingCopyFile(source, attachment_path, FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(attachment_path));
+  return true;
+}
+
+bool CrashReportDatabase::NewReport::SetUploadParameters(
+    const std::map<std::string, std::string>& parameters,
+    const std::string& signature) {
+  UploadParametersHeader header = {};
+  header.magic = UploadParametersHeader::kMagic;
+  header.version = UploadParametersHeader::kVersion;
+  header.parameter_count = static_cast<uint32_t>(parameters.size());
+  header.signature_size = static_cast<uint32_t>(signature.size());
+
+  std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+  contents.append(signature);
+  for (const auto& [key, value] : parameters) {
+    UploadParameter parameter;
+    parameter.key_size = static_cast<uint32_t>(key.size());
+    parameter.value_size = static_cast<uint32_t>(value.size());
+    contents.append(reinterpret_cast<const char*>(&parameter),
+                    sizeof(parameter));
+    contents.append(key);
+    contents.append(value);
+  }
+
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+  const base::FilePath path =
+      report_attachments_dir.Append(kUploadParametersName);
+
+  // The writer is closed before the file is removed on failure.
+  ScopedRemoveFile remover;
+  FileWriter writer;
+  if (!writer.Open(
+          path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  remover.reset(path);
+  if (!writer.Write(contents.data(), contents.size())) {
+    return false;
+  }
+  writer.Close();
+  attachment_removers_.push_back(std::move(remover));
+  return true;
+}
+
+bool CrashReportDatabase::NewReport::WritePackedAttachments() {
+  if (packed_attachments_.empty()) {
+    return true;
+  }
+
+  const FileOffset minidump_size = writer_->Seek(0, SEEK_END);
+  if (minidump_size < 0) {
+    return false;
+  }
+
+  constexpr size_t kBufferSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  std::vector<PackedAttachment> attachments;
+  for (const auto& [name, reader] : packed_attachments_) {
+    PackedAttachment attachment = {};
+    attachment.offset = writer_->SeekGet();
+    FileOperationResult read_result;
+    while ((read_result = reader->Read(buffer.get(), kBufferSize)) > 0) {
+      if (!writer_->Write(buffer.get(), read_result)) {
+        return false;
+      }
+      attachment.size += read_result;
+    }
+    if (read_result < 0) {
+      return false;
+    }
+    attachment.name_size = static_cast<uint32_t>(name.size());
+    attachments.push_back(attachment);
+  }
+
+  PackedReportFooter footer = {};
+  footer.minidump_size = minidump_size;
+  footer.directory_offset = writer_->SeekGet();
+  footer.attachment_count = static_cast<uint32_t>(attachments.size());
+  footer.version = PackedReportFooter::kVersion;
+  footer.magic = PackedReportFooter::kMagic;
+
+  for (size_t index = 0; index < attachments.size(); ++index) {
+    const std::string& name = packed_attachments_[index].first;
+    if (!writer_->Write(&attachments[index], sizeof(attachments[index])) ||
+        !writer_->Write(name.data(), name.size())) {
+      return false;
+    }
+  }
+  if (!writer_->Write(&footer, sizeof(footer))) {
+    return false;
+  }
+
+  packed_attachments_.clear();
+  return true;
+}
+
+void CrashReportDatabase::UploadReport::InitializePackedSections() {
+  const FileOffset file_size = reader_->Seek(0, SEEK_END);
+  PackedReportFooter footer;
+  if (file_size < static_cast<FileOffset>(sizeof(footer)) ||
+      !reader_->SeekSet(file_size - sizeof(footer)) ||
+      !reader_->ReadExactly(&footer, sizeof(footer)) ||
+      footer.magic != PackedReportFooter::kMagic) {
+    reader_->SeekSet(0);
+    return;
+  }
+
+  const uint64_t directory_end = file_size - sizeof(footer);
+  if (footer.version != PackedReportFooter::kVersion ||
+      footer.minidump_size > footer.directory_offset ||
+      footer.directory_offset > directory_end ||
+      !reader_->SeekSet(footer.directory_offset)) {
+    LOG(ERROR) << "invalid packed report " << uuid.ToString();
+    reader_->SeekSet(0);
+    return;
+  }
+
+  std::vector<std::pair<std::string, PackedAttachment>> attachments;
+  for (uint32_t index = 0; index < footer.attachment_count; ++index) {
+    PackedAttachment attachment;
+    std::string name;
+    bool valid = reader_->ReadExactly(&attachment, sizeof(attachment)) &&
+                 attachment.name_size <= kMaxPackedAttachmentNameSize &&
+                 attachment.offset >= footer.minidump_size &&
+                 attachment.offset <= footer.directory_offset &&
+                 attachment.size <=
+                     footer.directory_offset - attachment.offset;
+    if (valid) {
+      name.resize(attachment.name_size);
+      valid = reader_->ReadExactly(name.data(), name.size());
+    }
+    if (!valid) {
+      LOG(ERROR) << "invalid packed attachment in report " << uuid.ToString();
+      reader_->SeekSet(0);
+      return;
+    }
+    attachments.emplace_back(std::move(name), attachment);
+  }
+
+  minidump_section_reader_ = std::make_unique<FileSectionReader>(
+      reader_.get(), 0, footer.minidump_size);
+  minidump_reader_ = minidump_section_reader_.get();
+  for (const auto& [name, attachment] : attachments) {
+    auto section_reader = std::make_unique<FileSectionReader>(
+        reader_.get(), attachment.offset, attachment.size);
+    attachment_map_[name] = section_reader.get();
+    attachment_readers_.push_back(std::move(section_reader));
+  }
+  reader_->SeekSet(0);
+}
+
+void CrashReportDatabase::UploadReport::ReadUploadParameters(
+    const base::FilePath& path) {
+  std::string contents;
+  if (!LoggingReadEntireFile(path, &contents)) {
+    return;
+  }
+
+  size_t offset = 0;
+  const auto read = [&contents, &offset](void* data, size_t size) {
+    if (size > contents.size() - offset) {
+      return false;
+    }
+    memcpy(data, contents.data() + offset, size);
+    offset += size;
+    return true;
+  };
+
+  UploadParametersHeader header;
+  std::string signature;
+  std::map<std::string, std::string> parameters;
+  bool valid = read(&header, sizeof(header)) &&
+               header.magic == UploadParametersHeader::kMagic &&
+               header.version == UploadParametersHeader::kVersion;
+  if (valid) {
+    signature.resize(header.signature_size);
+    valid = read(signature.data(), signature.size());
+  }
+  for (uint32_t index = 0; valid && index < header.parameter_count; ++index) {
+    UploadParameter parameter;
+    std::string key;
+    std::string value;
+    valid = read(&parameter, sizeof(parameter));
+    if (valid) {
+      key.resize(parameter.key_size);
+      value.resize(parameter.value_size);
+      valid = read(key.data(), key.size()) && read(value.data(), value.size());
+    }
+    if (valid) {
+      parameters[std::move(key)] = std::move(value);
+    }
+  }
+  if (!valid || offset != contents.size()) {
+    LOG(ERROR) << "invalid upload parameters in report " << uuid.ToString();
+    return;
+  }
+
+  upload_parameters_ = std::move(parameters);
+  upload_signature_ = std::move(signature);
+  has_upload_parameters_ = true;
+}
+
+bool CrashReportDatabase::UploadReport::GetUploadParameters(
+    std::map<std::string, std::string>* parameters,
+    std::string* signature) const {
+  if (!has_upload_parameters_) {
+    return false;
+  }
+  *parameters = upload_parameters_;
+  *signature = upload_signature_;
+  return true;
+}
+
 void CrashReportDatabase::UploadReport::InitializeAttachments() {
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid);
   DirectoryReader dir_reader;
@@ -132,6 +579,10 @@ void CrashReportDatabase::UploadReport::InitializeAttachments() {
   while ((dir_result = dir_reader.NextFile(&filename)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath filepath(report_attachments_dir.Append(filename));
+    if (filename.value() == kUploadParametersName) {
+      ReadUploadParameters(filepath);
+      continue;
+    }
     std::unique_ptr<FileReader> file_reader(std::make_unique<FileReader>());
     if (!file_reader->Open(filepath)) {
       continue;
@@ -149,9 +600,14 @@ void CrashReportDatabase::UploadReport::InitializeAttachments() {
 CrashReportDatabase::UploadReport::UploadReport()
     : Report(),
       reader_(std::make_unique<FileReader>()),
+      minidump_section_reader_(),
+      minidump_reader_(reader_.get()),
       database_(nullptr),
       attachment_readers_(),
       attachment_map_(),
+      upload_parameters_(),
+      upload_signature_(),
+      has_upload_parameters_(false),
       report_metrics_(false) {}
 
 CrashReportDatabase::UploadReport::~UploadReport() {
@@ -164,7 +620,11 @@ bool CrashReportDatabase::UploadReport::Initialize(const base::FilePath& path,
                                                    CrashReportDatabase* db) {
   database_ = db;
   InitializeAttachments();
-  return reader_->Open(path);
+  if (!reader_->Open(path)) {
+    return false;
+  }
+  InitializePackedSections();
+  return true;
 }
 
 CrashReportDatabase::OperationStatus CrashReportDatabase::RecordUploadComplete(
@@ -173,7 +633,35 @@ CrashReportDatabase::OperationStatus CrashReportDatabase::RecordUploadComplete(
   UploadReport* report = const_cast<UploadReport*>(report_in.get());
 
   report->database_ = nullptr;
-  return RecordUploadAttempt(report, true, id);
+  OperationStatus os = RecordUploadAttempt(report, true, id);
+  if (os == kNoError) {
+    RemoveUploadBodyByUUID(report->uuid);
+  }
+  return os;
+}
+
+CrashReportDatabase::OperationStatus
+CrashReportDatabase::SetUploadResumptionURL(const UploadReport* report_in,
+                                            const std::string& url) {
+  UploadReport* report = const_cast<UploadReport*>(report_in);
+  return RecordUploadResumptionURL(report, url);
+}
+
+base::FilePath CrashReportDatabase::UploadBodyPath(const UUID& uuid) {
+  const base::FilePath upload_bodies_dir =
+      DatabasePath().Append(kUploadBodiesDirectory);
+  if (!LoggingCreateDirectory(
+          upload_bodies_dir, FilePermissions::kOwnerOnly, true)) {
+    return base::FilePath();
+  }
+
+#if BUILDFLAG(IS_WIN)
+  const std::wstring uuid_string = uuid.ToWString();
+#else
+  const std::string uuid_string = uuid.ToString();
+#endif
+
+  return upload_bodies_dir.Append(uuid_string);
 }
 
 base::FilePath CrashReportDatabase::AttachmentsPath(const UUID& uuid) {
@@ -191,6 +679,8 @@ base::FilePath CrashReportDatabase::AttachmentsRootPath() {
 }
 
 void CrashReportDatabase::RemoveAttachmentsByUUID(const UUID& uuid) {
+  RemoveUploadBodyByUUID(uuid);
+
   base::FilePath report_attachment_dir = AttachmentsPath(uuid);
   if (!IsDirectory(report_attachment_dir, /*allow_symlinks=*/false)) {
     return;
@@ -212,4 +702,226 @@ void CrashReportDatabase::RemoveAttachmentsByUUID(const UUID& uuid) {
   LoggingRemoveDirectory(report_attachment_dir);
 }
 
+void CrashReportDatabase::RemoveUploadBodyByUUID(const UUID& uuid) {
+#if BUILDFLAG(IS_WIN)
+  const std::wstring uuid_string = uuid.ToWString();
+#else
+  const std::string uuid_string = uuid.ToString();
+#endif
+
+  const base::FilePath upload_body_path =
+      DatabasePath().Append(kUploadBodiesDirectory).Append(uuid_string);
+  if (IsRegularFile(upload_body_path)) {
+    LoggingRemoveFile(upload_body_path);
+  }
+}
+
+CrashReportDatabase::OperationStatus CrashReportDatabase::ExportReports(
+    const std::vector<UUID>& uuids,
+    FileWriterInterface* writer) {
+  ArchiveHeader header = {};
+  header.magic = ArchiveHeader::kMagic;
+  header.version = ArchiveHeader::kVersion;
+  if (!writer->Write(&header, sizeof(header))) {
+    return kFileSystemError;
+  }
+
+  for (const UUID& uuid : uuids) {
+    Report report;
+    OperationStatus status = LookUpCrashReport(uuid, &report);
+    if (status != kNoError) {
+      return status;
+    }
+
+    // The report is read as it is for an upload, but without obtaining it for
+    // uploading, so that completed reports can be read too and no upload
+    // attempt is recorded.
+    UploadReport upload_report;
+    upload_report.uuid = report.uuid;
+    const bool opened = upload_report.Initialize(report.file_path, this);
+    upload_report.database_ = nullptr;
+    if (!opened) {
+      return kFileSystemError;
+    }
+
+    ArchivedReport archived_report = {};
+    archived_report.uuid = report.uuid;
+    archived_report.creation_time = report.creation_time;
+    archived_report.last_upload_attempt_time = report.last_upload_attempt_time;
+    archived_report.upload_attempts = report.upload_attempts;
+    if (report.uploaded) {
+      archived_report.flags |= ArchivedReport::kFlagUploaded;
+    }
+    if (report.upload_explicitly_requested) {
+      archived_report.flags |= ArchivedReport::kFlagUploadExplicitlyRequested;
+    }
+    if (!WriteArchiveRecord(writer,
+                            ArchiveRecord::kReport,
+                            report.id,
+                            sizeof(archived_report)) ||
+        !writer->Write(&archived_report, sizeof(archived_report)) ||
+        !WriteArchiveFile(writer,
+                          ArchiveRecord::kMinidump,
+                          std::string(),
+                          upload_report.Reader())) {
+      return kFileSystemError;
+    }
+
+    for (const auto& [name, reader] : upload_report.GetAttachments()) {
+      if (!WriteArchiveFile(writer, ArchiveRecord::kAttachment, name, reader)) {
+        return kFileSystemError;
+      }
+    }
+
+    std::map<std::string, std::string> parameters;
+    std::string signature;
+    if (upload_report.GetUploadParameters(&parameters, &signature)) {
+      if (!WriteArchiveRecord(writer,
+                              ArchiveRecord::kUploadSignature,
+                              std::string(),
+                              signature.size()) ||
+          (!signature.empty() &&
+           !writer->Write(signature.data(), signature.size()))) {
+        return kFileSystemError;
+      }
+      for (const auto& [key, value] : parameters) {
+        if (!WriteArchiveRecord(
+                writer, ArchiveRecord::kUploadParameter, key, value.size()) ||
+            (!value.empty() && !writer->Write(value.data(), value.size()))) {
+          return kFileSystemError;
+        }
+      }
+    }
+  }
+
+  return WriteArchiveRecord(writer, ArchiveRecord::kEnd, std::string(), 0)
+             ? kNoError
+             : kFileSystemError;
+}
+
+CrashReportDatabase::OperationStatus CrashReportDatabase::ImportReports(
+    FileReaderInterface* reader,
+    std::vector<std::pair<UUID, UUID>>* uuids) {
+  DCHECK(uuids->empty());
+
+  ArchiveHeader header;
+  if (!reader->ReadExactly(&header, sizeof(header))) {
+    return kFileSystemError;
+  }
+  if (header.magic != ArchiveHeader::kMagic ||
+      header.version != ArchiveHeader::kVersion) {
+    LOG(ERROR) << "not a report archive";
+    return kDatabaseError;
+  }
+
+  std::unique_ptr<NewReport> new_report;
+  UUID exported_uuid;
+  std::map<std::string, std::string> parameters;
+  std::string signature;
+  bool has_parameters = false;
+
+  // Finishes the report being imported, if there is one.
+  auto finish_report = [&]() {
+    if (!new_report) {
+      return kNoError;
+    }
+    if (has_parameters &&
+        !new_report->SetUploadParameters(parameters, signature)) {
+      return kFileSystemError;
+    }
+    parameters.clear();
+    signature.clear();
+    has_parameters = false;
+
+    UUID uuid;
+    OperationStatus status =
+        FinishedWritingCrashReport(std::move(new_report), &uuid);
+    if (status == kNoError) {
+      uuids->emplace_back(exported_uuid, uuid);
+    }
+    return status;
+  };
+
+  while (true) {
+    ArchiveRecord record;
+    if (!reader->ReadExactly(&record, sizeof(record))) {
+      return kFileSystemError;
+    }
+    if (record.name_size > kMaxArchiveNameSize) {
+      LOG(ERROR) << "archive name size " << record.name_size << " too large";
+      return kDatabaseError;
+    }
+    std::string name(record.name_size, '\0');
+    if (!name.empty() && !reader->ReadExactly(name.data(), name.size())) {
+      return kFileSystemError;
+    }
+
+    if (record.type == ArchiveRecord::kEnd) {
+      return finish_report();
+    }
+
+    if (record.type == ArchiveRecord::kReport) {
+      OperationStatus status = finish_report();
+      if (status != kNoError) {
+        return status;
+      }
+      ArchivedReport archived_report;
+      if (record.size != sizeof(archived_report)) {
+        LOG(ERROR) << "archived report size " << record.size;
+        return kDatabaseError;
+      }
+      if (!reader->ReadExactly(&archived_report, sizeof(archived_report))) {
+        return kFileSystemError;
+      }
+      exported_uuid = archived_report.uuid;
+      status = PrepareNewCrashReport(&new_report);
+      if (status != kNoError) {
+        return status;
+      }
+      continue;
+    }
+
+    if (!new_report) {
+      LOG(ERROR) << "archive record outside a report";
+      return kDatabaseError;
+    }
+
+    switch (record.type) {
+      case ArchiveRecord::kMinidump:
+        if (!CopyArchiveData(reader, new_report->Writer(), record.size)) {
+          return kFileSystemError;
+        }
+        break;
+
+      case ArchiveRecord::kAttachment: {
+        FileWriter* attachment_writer = new_report->AddAttachment(name);
+        if (!attachment_writer ||
+            !CopyArchiveData(reader, attachment_writer, record.size)) {
+          return kFileSystemError;
+        }
+        break;
+      }
+
+      case ArchiveRecord::kUploadSignature:
+        if (!ReadArchiveString(reader, record.size, &signature)) {
+          return kFileSystemError;
+        }
+        has_parameters = true;
+        break;
+
+      case ArchiveRecord::kUploadParameter:
+        if (!ReadArchiveString(reader, record.size, &parameters[name])) {
+          return kFileSystemError;
+        }
+        break;
+
+      default:
+        if (!CopyArchiveData(reader, nullptr, record.size)) {
+          return kFileSystemError;
+        }
+        break;
+    }
+  }
+}
+
 }  // namespace crashpad
@@ -21,11 +21,13 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/files/file_path.h"
 #include "util/file/file_io.h"
 #include "util/file/file_reader.h"
+#include "util/file/file_section_reader.h"
 #include "util/file/file_writer.h"
 #include "util/file/scoped_remove_file.h"
 #include "util/misc/metrics.h"
@@ -102,6 +104,25 @@ class CrashReportDatabase {
     //! The total size in bytes taken by the report, including any potential
     //! attachments.
     uint64_t total_size;
+
+    //! The URL at which an interrupted upload of this report can be resumed,
+    //! as recorded by SetUploadResumptionURL(). This is empty if no upload of
+    //! the report is in progress, and always empty once #uploaded is true.
+    std::string upload_resumption_url;
+  };
+
+  //! \brief Aggregate information about all pending and completed crash
+  //!     reports in the database.
+  struct ReportsSummary {
+    //! The number of reports.
+    size_t report_count = 0;
+
+    //! The sum of every report’s Report::total_size.
+    uint64_t total_size = 0;
+
+    //! The earliest Report::creation_time of any report, or `0` if there are
+    //! no reports.
+    time_t oldest_creation_time = 0;
   };
 
   //! \brief A crash report that is in the process of being written.
@@ -137,6 +158,43 @@ class CrashReportDatabase {
     //!     the attachment, or `nullptr` on failure with an error logged.
     FileWriter* AddAttachment(const std::string& name);
 
+    //! \brief Adds an existing file as an attachment to the report.
+    //!
+    //! The attachment is a snapshot of \a source, taken now, and is unaffected
+    //! by later changes to \a source. Where the file system supports it, it
+    //! shares storage with \a source copy-on-write, instead of being copied
+    //! into the database. See LoggingCopyFile().
+    //!
+    //! If the database packs reports, \a source is opened now, and its
+    //! contents are instead appended to the report file when the report is
+    //! finished. See SetReportPackingEnabled().
+    //!
+    //! \param[in] name The key and name for the attachment, as for
+    //!     AddAttachment().
+    //! \param[in] source The file to attach.
+    //! \return `true` on success, or `false` on failure with an error logged.
+    bool AddAttachmentFromFile(const std::string& name,
+                               const base::FilePath& source);
+
+    //! \brief Stores the HTTP form parameters with which to upload the report.
+    //!
+    //! These are derived from the snapshot that the report is written from, so
+    //! that they needn’t be recovered from the minidump each time an upload of
+    //! the report is attempted. They’re stored alongside any attachments, but
+    //! aren’t themselves an attachment.
+    //!
+    //! \sa UploadReport::GetUploadParameters()
+    //!
+    //! This may be called at most once for a report.
+    //!
+    //! \param[in] parameters The HTTP form parameters.
+    //! \param[in] signature A signature identifying the crash, or an empty
+    //!     string if there is none.
+    //! \return `true` on success, or `false` on failure with an error logged.
+    bool SetUploadParameters(
+        const std::map<std::string, std::string>& parameters,
+        const std::string& signature);
+
    private:
     friend class CrashReportDatabaseGeneric;
     friend class CrashReportDatabaseMac;
@@ -146,13 +204,25 @@ class CrashReportDatabase {
                     const base::FilePath& directory,
                     const base::FilePath::StringType& extension);
 
+    // Validates name and creates the report’s attachments directory, returning
+    // the path for the attachment, or an empty path with an error logged.
+    base::FilePath AttachmentPath(const std::string& name);
+
+    // Appends the attachments added by AddAttachmentFromFile() while packing,
+    // followed by their directory, to the report file. Returns false with an
+    // error logged on failure.
+    bool WritePackedAttachments();
+
     std::unique_ptr<FileWriter> writer_;
     std::unique_ptr<FileReader> reader_;
     ScopedRemoveFile file_remover_;
     std::vector<std::unique_ptr<FileWriter>> attachment_writers_;
     std::vector<ScopedRemoveFile> attachment_removers_;
+    std::vector<std::pair<std::string, std::unique_ptr<FileReader>>>
+        packed_attachments_;
     UUID uuid_;
     CrashReportDatabase* database_;
+    bool pack_attachments_;
   };
 
   //! \brief A crash report that is in the process of being uploaded.
@@ -167,15 +237,33 @@ class CrashReportDatabase {
 
     virtual ~UploadReport();
 
-    //! \brief An open FileReader with which to read the report.
-    FileReader* Reader() const { return reader_.get(); }
+    //! \brief An open file reader with which to read the report.
+    //!
+    //! For a packed report, this reads only the minidump. See
+    //! SetReportPackingEnabled().
+    FileReaderInterface* Reader() const { return minidump_reader_; }
 
     //! \brief Obtains a mapping of names to file readers for any attachments
     //!     for the report.
-    std::map<std::string, FileReader*> GetAttachments() const {
+    //!
+    //! The readers of a packed report’s attachments share a file with
+    //! Reader(), and each other, so they must not be read concurrently.
+    std::map<std::string, FileReaderInterface*> GetAttachments() const {
       return attachment_map_;
     }
 
+    //! \brief Obtains the HTTP form parameters stored with the report by
+    //!     NewReport::SetUploadParameters().
+    //!
+    //! \param[out] parameters The HTTP form parameters.
+    //! \param[out] signature The signature identifying the crash, which may be
+    //!     empty.
+    //! \return `true` on success, or `false` if no parameters were stored with
+    //!     the report, in which case \a parameters and \a signature are
+    //!     unchanged.
+    bool GetUploadParameters(std::map<std::string, std::string>* parameters,
+                             std::string* signature) const;
+
    private:
     friend class CrashReportDatabase;
     friend class CrashReportDatabaseGeneric;
@@ -185,10 +273,23 @@ class CrashReportDatabase {
     bool Initialize(const base::FilePath& path, CrashReportDatabase* database);
     void InitializeAttachments();
 
+    // If reader_ has a packed attachment directory, creates readers for the
+    // minidump and for each packed attachment.
+    void InitializePackedSections();
+
+    // Reads the parameters stored by NewReport::SetUploadParameters() from
+    // path, logging an error if they can’t be read.
+    void ReadUploadParameters(const base::FilePath& path);
+
     std::unique_ptr<FileReader> reader_;
+    std::unique_ptr<FileSectionReader> minidump_section_reader_;
+    FileReaderInterface* minidump_reader_;  // weak
     CrashReportDatabase* database_;
-    std::vector<std::unique_ptr<FileReader>> attachment_readers_;
-    std::map<std::string, FileReader*> attachment_map_;
+    std::vector<std::unique_ptr<FileReaderInterface>> attachment_readers_;
+    std::map<std::string, FileReaderInterface*> attachment_map_;
+    std::map<std::string, std::string> upload_parameters_;
+    std::string upload_signature_;
+    bool has_upload_parameters_;
     bool report_metrics_;
   };
 
@@ -232,6 +333,27 @@ class CrashReportDatabase {
     kCannotRequestUpload,
   };
 
+  //! \brief How durably a database stores reports. See SetDurability().
+  enum class Durability {
+    //! \brief Files are written back to storage whenever the operating system
+    //!     chooses. A report may be lost, or be left empty or truncated, if
+    //!     the system loses power soon after its write.
+    kNone,
+
+    //! \brief The contents of a report’s files are flushed to storage before
+    //!     the report becomes pending, and metadata is flushed when it
+    //!     changes, so that a report is never seen incomplete. A report may
+    //!     still be lost if the system loses power soon after it’s finished.
+    kData,
+
+    //! \brief As kData, and the directories that reports are created and
+    //!     moved in are also flushed, so that a finished report survives a
+    //!     loss of power. A single flush of a directory is shared by all
+    //!     reports finished in it while a previous flush was in progress, so
+    //!     that many reports finished together cost few flushes.
+    kFull,
+  };
+
   CrashReportDatabase(const CrashReportDatabase&) = delete;
   CrashReportDatabase& operator=(const CrashReportDatabase&) = delete;
 
@@ -327,6 +449,16 @@ class CrashReportDatabase {
   //! \return The operation status code.
   virtual OperationStatus GetCompletedReports(std::vector<Report>* reports) = 0;
 
+  //! \brief Summarizes the pending and completed crash reports, where this can
+  //!     be done more cheaply than by calling GetPendingReports() and
+  //!     GetCompletedReports().
+  //!
+  //! \param[out] summary The summary. Only valid if this returns `true`.
+  //!
+  //! \return `true` on success. `false` if a summary isn’t available, in which
+  //!     case the reports must be examined individually.
+  virtual bool GetReportsSummary(ReportsSummary* summary) { return false; }
+
   //! \brief Obtains and locks a report object for uploading to a collection
   //!     server. On iOS the file lock is released and mutual-exclusion is kept
   //!     via a file attribute.
@@ -373,6 +505,38 @@ class CrashReportDatabase {
       std::unique_ptr<const UploadReport> report,
       const std::string& id);
 
+  //! \brief Records the URL at which an upload of a report can be resumed if
+  //!     it’s interrupted.
+  //!
+  //! The URL is recorded immediately, so that it survives the failure of the
+  //! upload in progress and of the process making it. It is available as
+  //! Report::upload_resumption_url from then on, until the report is uploaded
+  //! or its upload is skipped.
+  //!
+  //! \param[in] report A UploadReport object obtained from
+  //!     GetReportForUploading(), which remains valid.
+  //! \param[in] url The URL to record, or an empty string to forget a
+  //!     previously recorded URL.
+  //!
+  //! \return The operation status code. #kDatabaseError if the database
+  //!     doesn’t support resuming uploads.
+  OperationStatus SetUploadResumptionURL(const UploadReport* report,
+                                         const std::string& url);
+
+  //! \brief Returns the path of the file in which a report’s prepared upload
+  //!     body may be cached.
+  //!
+  //! An uploader that prepares the same body for each attempt to upload a
+  //! report may write it to this file, so that later attempts can send the
+  //! file as-is. The file is removed when the report is uploaded, when its
+  //! upload is skipped, and when the report is deleted.
+  //!
+  //! \param[in] uuid The unique identifier for the crash report record.
+  //!
+  //! \return The path of the file, which may not exist, or an empty path on
+  //!     failure.
+  base::FilePath UploadBodyPath(const UUID& uuid);
+
   //! \brief Moves a report from the pending state to the completed state, but
   //!     without the report being uploaded.
   //!
@@ -415,6 +579,81 @@ class CrashReportDatabase {
   //! \return The number of reports cleaned.
   virtual int CleanDatabase(time_t lockfile_ttl) { return 0; }
 
+  //! \brief Returns the directory that report files are moved into when they
+  //!     become pending.
+  //!
+  //! Reports made pending by any process, including reports that are newly
+  //! written or whose upload is requested, are renamed into this directory,
+  //! and no other file is. Watching it for files moved in reveals new pending
+  //! reports without scanning the database.
+  //!
+  //! \return The directory, or an empty path if the database doesn’t have one.
+  virtual base::FilePath PendingReportsDirectory() { return base::FilePath(); }
+
+  //! \brief Enables or disables packing of new reports.
+  //!
+  //! A packed report is a single file. Attachments added with
+  //! NewReport::AddAttachmentFromFile() are appended to the report file after
+  //! the minidump, followed by a directory of them, instead of being stored as
+  //! files of their own. This saves creating a directory and a file for each
+  //! attachment, and flushing each of them when SetDurability() calls for
+  //! that. The minidump remains at the start of the file, so that tools that
+  //! read the report file as a minidump are unaffected. Attachments added with
+  //! NewReport::AddAttachment() are stored as files as usual.
+  //!
+  //! Reports are unpacked by default. Packed reports can be read regardless of
+  //! this setting.
+  //!
+  //! \return `true` on success, or `false` if the database doesn’t support
+  //!     packing.
+  virtual bool SetReportPackingEnabled(bool enabled) { return !enabled; }
+
+  //! \brief Sets how durably reports are stored when they’re written.
+  //!
+  //! Flushing files to storage protects reports from loss of power, at the
+  //! expense of time and of storage throughput for the rest of the system. The
+  //! default is Durability::kNone.
+  //!
+  //! \return `true` on success, or `false` if the database doesn’t support
+  //!     \a durability.
+  virtual bool SetDurability(Durability durability) {
+    return durability == Durability::kNone;
+  }
+
+  //! \brief Writes crash reports to an archive that ImportReports() can add
+  //!     to another database.
+  //!
+  //! Each report’s minidump, attachments, upload parameters, and metadata are
+  //! copied from the database’s files to \a writer as a single stream, which
+  //! is written sequentially and can be a pipe. Reports may be pending or
+  //! completed, and aren’t changed by being exported.
+  //!
+  //! \param[in] uuids The reports to export, in the order they’re written.
+  //! \param[in] writer The writer for the archive.
+  //!
+  //! \return The operation status code. On failure, \a writer may have
+  //!     received a partial archive.
+  OperationStatus ExportReports(const std::vector<UUID>& uuids,
+                                FileWriterInterface* writer);
+
+  //! \brief Adds the crash reports in an archive written by ExportReports()
+  //!     to this database.
+  //!
+  //! The archive is read sequentially from \a reader, which can be a pipe,
+  //! and each report is written straight into the database. Each report
+  //! becomes a new pending report with a new UUID and creation time,
+  //! regardless of its state when it was exported.
+  //!
+  //! \param[in] reader The reader for the archive.
+  //! \param[out] uuids For each report imported, in archive order, the UUID
+  //!     that it had in the database it was exported from and the UUID
+  //!     that it has in this database. This must be empty on entry. Reports
+  //!     imported before a failure remain in the database, and are listed.
+  //!
+  //! \return The operation status code.
+  OperationStatus ImportReports(FileReaderInterface* reader,
+                                std::vector<std::pair<UUID, UUID>>* uuids);
+
  protected:
   CrashReportDatabase() {}
 
@@ -436,12 +675,20 @@ class CrashReportDatabase {
   //! \return The filepath to the report attachments directory.
   base::FilePath AttachmentsPath(const UUID& uuid);
 
-  //! \brief Attempts to remove any attachments associated with the given
-  //!     report UUID. There may not be any, so failing is not an error.
+  //! \brief Attempts to remove any attachments, and any cached upload body,
+  //!     associated with the given report UUID. There may not be any, so
+  //!     failing is not an error.
   //!
   //! \param[in] uuid The unique identifier for the crash report record.
   void RemoveAttachmentsByUUID(const UUID& uuid);
 
+  //! \brief Attempts to remove any upload body cached at UploadBodyPath() for
+  //!     the given report UUID. There may not be one, so failing is not an
+  //!     error.
+  //!
+  //! \param[in] uuid The unique identifier for the crash report record.
+  void RemoveUploadBodyByUUID(const UUID& uuid);
+
  private:
   //! \brief Adjusts a crash report record’s metadata to account for an upload
   //!     attempt, and updates the last upload attempt time as returned by
@@ -458,6 +705,19 @@ class CrashReportDatabase {
   virtual OperationStatus RecordUploadAttempt(UploadReport* report,
                                               bool successful,
                                               const std::string& id) = 0;
+
+  //! \brief Sets a crash report record’s Report::upload_resumption_url and
+  //!     records it in the database.
+  //!
+  //! \param[in] report The report object obtained from
+  //!     GetReportForUploading().
+  //! \param[in] url The URL to record, possibly empty.
+  //!
+  //! \return The operation status code.
+  virtual OperationStatus RecordUploadResumptionURL(UploadReport* report,
+                                                    const std::string& url) {
+    return kDatabaseError;
+  }
 };
 
 }  // namespace crashpad
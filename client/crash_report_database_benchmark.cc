@@ -0,0 +1,377 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/crash_report_database.h"
+#include "test/scoped_temp_dir.h"
+#include "tools/tool_support.h"
+#include "util/file/file_writer.h"
+#include "util/misc/clock.h"
+#include "util/misc/uuid.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of CrashReportDatabase operations on a populated database.\n"
+"\n"
+"      --reports=N                 create N reports\n"
+"      --report-size=BYTES         write BYTES to each report\n"
+"      --attachments=N             add N attachments to each report\n"
+"      --lookups=N                 look up N reports by UUID\n"
+"      --scans=N                   list the pending and completed reports N\n"
+"                                  times\n"
+"      --uploads=N                 record N reports as uploaded\n"
+"      --database=PATH             use the database at PATH instead of a\n"
+"                                  temporary one\n"
+"      --help                      display this help and exit\n"
+"      --version                   output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+struct Options {
+  unsigned int reports;
+  unsigned int report_size;
+  unsigned int attachments;
+  unsigned int lookups;
+  unsigned int scans;
+  unsigned int uploads;
+  base::FilePath database;
+};
+
+// Collects the durations of calls to one database operation.
+class Operation {
+ public:
+  explicit Operation(const char* name) : name_(name), durations_ns_() {}
+
+  Operation(const Operation&) = delete;
+  Operation& operator=(const Operation&) = delete;
+
+  ~Operation() {}
+
+  // Calls function, recording how long it took. Returns false with a message
+  // logged if function doesn't return CrashReportDatabase::kNoError.
+  template <typename Function>
+  bool Time(Function function) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    const CrashReportDatabase::OperationStatus status = function();
+    durations_ns_.push_back(ClockMonotonicNanoseconds() - start_ns);
+    if (status != CrashReportDatabase::kNoError) {
+      LOG(ERROR) << name_ << " failed with status " << status;
+      return false;
+    }
+    return true;
+  }
+
+  void Print() {
+    if (durations_ns_.empty()) {
+      return;
+    }
+    std::sort(durations_ns_.begin(), durations_ns_.end());
+    uint64_t total_ns = 0;
+    for (uint64_t duration_ns : durations_ns_) {
+      total_ns += duration_ns;
+    }
+    printf("%-28s %8zu %10.3f %10.3f %10.3f %12.3f\n",
+           name_,
+           durations_ns_.size(),
+           durations_ns_.front() / 1e6,
+           durations_ns_[durations_ns_.size() / 2] / 1e6,
+           durations_ns_.back() / 1e6,
+           total_ns / 1e6);
+  }
+
+ private:
+  const char* name_;
+  std::vector<uint64_t> durations_ns_;
+};
+
+// Returns count indices spread evenly over [0, size), so that operations on a
+// subset of the reports don't favor those created first or last.
+std::vector<size_t> SpreadIndices(size_t count, size_t size) {
+  std::vector<size_t> indices;
+  count = std::min(count, size);
+  for (size_t index = 0; index < count; ++index) {
+    indices.push_back(index * size / count);
+  }
+  return indices;
+}
+
+int DatabaseBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionReports,
+    kOptionReportSize,
+    kOptionAttachments,
+    kOptionLookups,
+    kOptionScans,
+    kOptionUploads,
+    kOptionDatabase,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"reports", required_argument, nullptr, kOptionReports},
+      {"report-size", required_argument, nullptr, kOptionReportSize},
+      {"attachments", required_argument, nullptr, kOptionAttachments},
+      {"lookups", required_argument, nullptr, kOptionLookups},
+      {"scans", required_argument, nullptr, kOptionScans},
+      {"uploads", required_argument, nullptr, kOptionUploads},
+      {"database", required_argument, nullptr, kOptionDatabase},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  Options options = {};
+  options.reports = 2000;
+  options.report_size = 64 * 1024;
+  options.attachments = 1;
+  options.lookups = 100;
+  options.scans = 10;
+  options.uploads = 100;
+
+  // These are in the same order as their OptionFlags values.
+  struct {
+    const char* name;
+    unsigned int* value;
+  } const numeric_options[] = {
+      {"--reports", &options.reports},
+      {"--report-size", &options.report_size},
+      {"--attachments", &options.attachments},
+      {"--lookups", &options.lookups},
+      {"--scans", &options.scans},
+      {"--uploads", &options.uploads},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionReports:
+      case kOptionReportSize:
+      case kOptionAttachments:
+      case kOptionLookups:
+      case kOptionScans:
+      case kOptionUploads: {
+        const auto& numeric_option = numeric_options[opt - kOptionReports];
+        if (!StringToNumber(optarg, numeric_option.value)) {
+          ToolSupport::UsageHint(
+              me,
+              base::StringPrintf("%s requires an integer", numeric_option.name)
+                  .c_str());
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionDatabase: {
+        options.database = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<ScopedTempDir> temp_dir;
+  if (options.database.empty()) {
+    temp_dir = std::make_unique<ScopedTempDir>();
+    options.database = temp_dir->path().Append(FILE_PATH_LITERAL("database"));
+  }
+
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(options.database);
+  if (!database) {
+    return EXIT_FAILURE;
+  }
+
+  const std::string report_contents(options.report_size, 'r');
+  const std::string attachment_contents(options.report_size / 4, 'a');
+
+  Operation prepare("PrepareNewCrashReport");
+  Operation finish("FinishedWritingCrashReport");
+  std::vector<UUID> uuids;
+  for (unsigned int index = 0; index < options.reports; ++index) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    if (!prepare.Time([&database, &new_report]() {
+          return database->PrepareNewCrashReport(&new_report);
+        })) {
+      return EXIT_FAILURE;
+    }
+
+    if (!new_report->Writer()->Write(report_contents.data(),
+                                     report_contents.size())) {
+      return EXIT_FAILURE;
+    }
+    for (unsigned int attachment = 0; attachment < options.attachments;
+         ++attachment) {
+      FileWriter* writer = new_report->AddAttachment(
+          base::StringPrintf("attachment_%u", attachment));
+      if (!writer || !writer->Write(attachment_contents.data(),
+                                    attachment_contents.size())) {
+        return EXIT_FAILURE;
+      }
+    }
+
+    UUID uuid;
+    if (!finish.Time([&database, &new_report, &uuid]() {
+          return database->FinishedWritingCrashReport(std::move(new_report),
+                                                      &uuid);
+        })) {
+      return EXIT_FAILURE;
+    }
+    uuids.push_back(uuid);
+  }
+
+  Operation look_up("LookUpCrashReport");
+  for (size_t index : SpreadIndices(options.lookups, uuids.size())) {
+    CrashReportDatabase::Report report;
+    if (!look_up.Time([&database, &uuids, index, &report]() {
+          return database->LookUpCrashReport(uuids[index], &report);
+        })) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  Operation get_pending("GetPendingReports");
+  size_t pending_count = 0;
+  for (unsigned int scan = 0; scan < options.scans; ++scan) {
+    std::vector<CrashReportDatabase::Report> reports;
+    if (!get_pending.Time([&database, &reports]() {
+          return database->GetPendingReports(&reports);
+        })) {
+      return EXIT_FAILURE;
+    }
+    pending_count = reports.size();
+  }
+
+  Operation get_for_uploading("GetReportForUploading");
+  Operation record_upload_complete("RecordUploadComplete");
+  for (size_t index : SpreadIndices(options.uploads, uuids.size())) {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    if (!get_for_uploading.Time([&database, &uuids, index, &upload_report]() {
+          return database->GetReportForUploading(uuids[index], &upload_report);
+        })) {
+      return EXIT_FAILURE;
+    }
+    if (!record_upload_complete.Time([&database, &upload_report, index]() {
+          return database->RecordUploadComplete(
+              std::move(upload_report),
+              base::StringPrintf("server_%zu", index));
+        })) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  Operation get_completed("GetCompletedReports");
+  for (unsigned int scan = 0; scan < options.scans; ++scan) {
+    std::vector<CrashReportDatabase::Report> reports;
+    if (!get_completed.Time([&database, &reports]() {
+          return database->GetCompletedReports(&reports);
+        })) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  Operation delete_report("DeleteReport");
+  for (const UUID& uuid : uuids) {
+    if (!delete_report.Time(
+            [&database, &uuid]() { return database->DeleteReport(uuid); })) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("reports %u (%zu pending), report size %u, attachments %u\n",
+         options.reports,
+         pending_count,
+         options.report_size,
+         options.attachments);
+  printf("%-28s %8s %10s %10s %10s %12s\n",
+         "operation (ms)",
+         "calls",
+         "min",
+         "median",
+         "max",
+         "total");
+  prepare.Print();
+  finish.Print();
+  look_up.Print();
+  get_pending.Print();
+  get_for_uploading.Print();
+  record_upload_complete.Print();
+  get_completed.Print();
+  delete_report.Print();
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::test::DatabaseBenchmarkMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::test::DatabaseBenchmarkMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
@@ -14,22 +14,31 @@
 
 #include "client/crash_report_database.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdint.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
+#include <condition_variable>
+#include <map>
 #include <mutex>
+#include <set>
 #include <tuple>
 #include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "client/settings.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
 #include "util/file/filesystem.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/memory_sanitizer.h"
+#include "util/thread/thread_priority.h"
 
 namespace crashpad {
 
@@ -52,6 +61,12 @@ using OperationStatus = CrashReportDatabase::OperationStatus;
 constexpr base::FilePath::CharType kSettings[] =
     FILE_PATH_LITERAL("settings.dat");
 
+constexpr base::FilePath::CharType kIndex[] = FILE_PATH_LITERAL("index.dat");
+constexpr base::FilePath::CharType kIndexLock[] =
+    FILE_PATH_LITERAL("index.lock");
+constexpr base::FilePath::CharType kIndexTemp[] =
+    FILE_PATH_LITERAL("index.dat.new");
+
 constexpr base::FilePath::CharType kCrashReportExtension[] =
     FILE_PATH_LITERAL(".dmp");
 constexpr base::FilePath::CharType kMetadataExtension[] =
@@ -77,8 +92,47 @@ enum {
 
   //! \brief Corresponds to upload_explicity_requested bit of the report state.
   kAttributeUploadExplicitlyRequested = 1 << 1,
+
+  //! \brief Set when the report’s upload_resumption_url, and not its id, is
+  //!     recorded.
+  kAttributeUploadResumable = 1 << 2,
 };
 
+// Returns the attributes recorded for report in its metadata and in its index
+// records.
+uint8_t ReportAttributes(const CrashReportDatabase::Report& report) {
+  return (report.uploaded ? kAttributeUploaded : 0) |
+         (report.upload_explicitly_requested
+              ? kAttributeUploadExplicitlyRequested
+              : 0) |
+         (!report.uploaded && !report.upload_resumption_url.empty()
+              ? kAttributeUploadResumable
+              : 0);
+}
+
+// Returns the string recorded after report’s metadata and index records. Only
+// one of the two strings is recorded, because a report whose upload is in
+// progress hasn’t yet been assigned an id.
+const std::string& ReportTrailer(const CrashReportDatabase::Report& report) {
+  return ReportAttributes(report) & kAttributeUploadResumable
+             ? report.upload_resumption_url
+             : report.id;
+}
+
+// Sets report’s id or upload_resumption_url, according to attributes, to
+// trailer.
+void SetReportTrailer(uint32_t attributes,
+                      std::string trailer,
+                      CrashReportDatabase::Report* report) {
+  if (attributes & kAttributeUploadResumable) {
+    report->id.clear();
+    report->upload_resumption_url = std::move(trailer);
+  } else {
+    report->id = std::move(trailer);
+    report->upload_resumption_url.clear();
+  }
+}
+
 struct ReportMetadata {
   static constexpr int32_t kVersion = 1;
 
@@ -89,6 +143,107 @@ struct ReportMetadata {
   uint8_t attributes = 0;
 };
 
+// The index is a header followed by a sequence of IndexRecords, each followed
+// by id_size bytes of report ID. A record is appended each time a report
+// changes state, so the last record for a UUID describes that report. Each
+// rebuild gives the index a new generation, so a reader that has already seen
+// a prefix of an index with the same generation only needs to read what was
+// appended since.
+struct IndexHeader {
+  static constexpr uint32_t kMagic = 'CPdi';
+  static constexpr uint32_t kVersion = 2;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  UUID generation = {};
+};
+
+struct IndexRecord {
+  UUID uuid;
+
+  // A CrashReportDatabaseGeneric::ReportState. kPending or kCompleted, or
+  // kUninitialized for a report that has been removed.
+  int32_t state;
+
+  int32_t upload_attempts;
+  int64_t last_upload_attempt_time;
+  int64_t creation_time;
+  uint64_t total_size;
+  uint32_t attributes;
+  uint32_t id_size;
+
+  // The FNV-1a hash of this record, with this field set to 0, and of the
+  // report ID that follows it.
+  uint32_t checksum;
+
+  uint32_t reserved;
+};
+static_assert(sizeof(IndexRecord) == 64, "IndexRecord must not have padding");
+
+uint32_t IndexRecordChecksum(const IndexRecord& record, const char* id) {
+  IndexRecord copy = record;
+  copy.checksum = 0;
+
+  uint32_t hash = 2166136261u;
+  auto update = [&hash](const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t index = 0; index < size; ++index) {
+      hash = (hash ^ bytes[index]) * 16777619u;
+    }
+  };
+  update(&copy, sizeof(copy));
+  update(id, record.id_size);
+  return hash;
+}
+
+// A flock() on the index lock file. Anything that changes a report holds it
+// shared so that the change and its index record are made together, and index
+// rebuilds hold it exclusively so that no change is missed by the rebuild.
+class ScopedIndexLock {
+ public:
+  ScopedIndexLock() = default;
+
+  ScopedIndexLock(const ScopedIndexLock&) = delete;
+  ScopedIndexLock& operator=(const ScopedIndexLock&) = delete;
+
+  ~ScopedIndexLock() {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+    if (handle_.is_valid()) {
+      LoggingUnlockFile(handle_.get());
+    }
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  }
+
+  // Blocks until the lock is acquired. Returns `true` on success, otherwise
+  // `false`. Always fails where flock() is not supported, in which case the
+  // index is not used.
+  bool Acquire(const base::FilePath& lock_path, FileLocking locking) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+    ScopedFileHandle handle(
+        LoggingOpenFileForReadAndWrite(lock_path,
+                                       FileWriteMode::kReuseOrCreate,
+                                       FilePermissions::kOwnerOnly));
+    if (!handle.is_valid() ||
+        LoggingLockFile(handle.get(),
+                        locking,
+                        FileLockingBlocking::kBlocking) !=
+            FileLockingResult::kSuccess) {
+      return false;
+    }
+    handle_ = std::move(handle);
+    return true;
+#else
+    return false;
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  }
+
+  // Returns `true` if the lock is held.
+  bool is_valid() const { return handle_.is_valid(); }
+
+ private:
+  ScopedFileHandle handle_;
+};
+
 // A lock held while using database resources.
 class ScopedLockFile {
  public:
@@ -156,6 +311,77 @@ class ScopedLockFile {
  private:
   ScopedRemoveFile lock_file_;
 };
+
+// Flushes a file’s contents, logging a message on failure.
+bool LoggingSyncFileData(FileHandle file) {
+  if (HANDLE_EINTR(fdatasync(file)) != 0) {
+    PLOG(ERROR) << "fdatasync";
+    return false;
+  }
+  return true;
+}
+
+// Flushes a directory’s entries, logging a message on failure.
+bool LoggingSyncDirectory(const base::FilePath& path) {
+  ScopedFileHandle handle(HANDLE_EINTR(
+      open(path.value().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  if (!handle.is_valid()) {
+    PLOG(ERROR) << "open " << path.value();
+    return false;
+  }
+  if (HANDLE_EINTR(fsync(handle.get())) != 0) {
+    PLOG(ERROR) << "fsync " << path.value();
+    return false;
+  }
+  return true;
+}
+
+// Flushes a directory, sharing each flush among all of the threads that asked
+// for one before it started. A flush covers every change made to the directory
+// before it starts, so a thread that asks while another thread’s flush is in
+// progress waits for that flush to finish and then, together with every other
+// thread that asked in the meantime, for one more.
+class BatchedDirectorySync {
+ public:
+  explicit BatchedDirectorySync(const base::FilePath& path) : path_(path) {}
+
+  BatchedDirectorySync(const BatchedDirectorySync&) = delete;
+  BatchedDirectorySync& operator=(const BatchedDirectorySync&) = delete;
+
+  bool Sync() {
+    std::unique_lock<std::mutex> lock(lock_);
+    const uint64_t request = ++requested_;
+    while (synced_ < request) {
+      if (syncing_) {
+        condition_.wait(lock);
+        continue;
+      }
+
+      syncing_ = true;
+      const uint64_t target = requested_;
+      lock.unlock();
+      const bool success = LoggingSyncDirectory(path_);
+      lock.lock();
+      syncing_ = false;
+      if (success) {
+        synced_ = target;
+      }
+      condition_.notify_all();
+      if (!success) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  const base::FilePath path_;
+  std::mutex lock_;
+  std::condition_variable condition_;
+  uint64_t requested_ = 0;
+  uint64_t synced_ = 0;
+  bool syncing_ = false;
+};
 }  // namespace
 
 class CrashReportDatabaseGeneric : public CrashReportDatabase {
@@ -179,6 +405,7 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus LookUpCrashReport(const UUID& uuid, Report* report) override;
   OperationStatus GetPendingReports(std::vector<Report>* reports) override;
   OperationStatus GetCompletedReports(std::vector<Report>* reports) override;
+  bool GetReportsSummary(ReportsSummary* summary) override;
   OperationStatus GetReportForUploading(
       const UUID& uuid,
       std::unique_ptr<const UploadReport>* report,
@@ -188,6 +415,9 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus DeleteReport(const UUID& uuid) override;
   OperationStatus RequestUpload(const UUID& uuid) override;
   int CleanDatabase(time_t lockfile_ttl) override;
+  base::FilePath PendingReportsDirectory() override;
+  bool SetReportPackingEnabled(bool enabled) override;
+  bool SetDurability(Durability durability) override;
   base::FilePath DatabasePath() override;
 
  private:
@@ -215,6 +445,8 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus RecordUploadAttempt(UploadReport* report,
                                       bool successful,
                                       const std::string& id) override;
+  OperationStatus RecordUploadResumptionURL(UploadReport* report,
+                                            const std::string& url) override;
 
   // Builds a filepath for the report with the specified uuid and state.
   base::FilePath ReportPath(const UUID& uuid, ReportState state);
@@ -237,15 +469,73 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
                                  ScopedLockFile* lock_file,
                                  Report* report);
 
-  // Reads metadata for all reports in state and returns it in reports.
+  // The most recent index record for a report.
+  struct IndexEntry {
+    ReportState state;
+    Report report;
+  };
+  using Index = std::map<UUID, IndexEntry>;
+
+  // Returns reports in state from the index, falling back to scanning the
+  // report directory if the index can't be used.
   OperationStatus ReportsInState(ReportState state,
                                  std::vector<Report>* reports);
 
-  // Cleans lone metadata, reports, or expired locks in a particular state.
-  int CleanReportsInState(ReportState state, time_t lockfile_ttl);
+  // Reads metadata for all reports in state from the report directory and
+  // returns it in reports. Reports that are locked are skipped unless
+  // include_locked is true, in which case their metadata is read without
+  // being cleaned.
+  OperationStatus ScanReportsInState(ReportState state,
+                                     bool include_locked,
+                                     std::vector<Report>* reports);
+
+  // Reads the index into index. Returns `false` if the index is missing or
+  // corrupt. A record truncated by an append in progress is ignored. If
+  // record_count is not nullptr, it is set to the number of records read,
+  // including those superseded by later records. Only records appended since
+  // the index was last read or rebuilt by this object are read from disk.
+  bool ReadIndex(Index* index, size_t* record_count = nullptr);
+
+  // Parses the records in contents into index_cache_, advancing
+  // index_cache_offset_ past each whole record. index_cache_lock_ must be held.
+  bool ReadIndexRecordsLocked(const std::string& contents);
+
+  // Replaces the index with one built by scanning the report directories, and
+  // returns its contents in index. Fails without rebuilding on a thread at
+  // background priority, which must fall back to scanning the directories.
+  bool RebuildIndex(Index* index);
+
+  // Appends a record for report, now in state, to the index. state may be
+  // kUninitialized to record that the report has been removed. index_lock
+  // must be held shared while the report is changed and this is called. If
+  // the lock couldn't be acquired, the index is removed so that it will be
+  // rebuilt before it's next used.
+  void UpdateIndex(const ScopedIndexLock& index_lock,
+                   const Report& report,
+                   ReportState state);
+
+  // Acquires index_lock shared, for a change to a report.
+  void LockIndexForUpdate(ScopedIndexLock* index_lock);
+
+  // The UUID strings of the reports found while cleaning.
+  using ReportNames = std::set<base::FilePath::StringType>;
+
+  // Cleans expired reports in the new directory, adding those that remain to
+  // report_names.
+  int CleanNewReports(time_t lockfile_ttl, ReportNames* report_names);
+
+  // Cleans lone metadata, reports, or expired locks in a particular state,
+  // adding the reports that remain to report_names. The directory is read
+  // once, and its files are grouped by report, so that only the reports that
+  // need cleaning are examined further.
+  int CleanReportsInState(ReportState state,
+                          time_t lockfile_ttl,
+                          ReportNames* report_names);
 
   // Cleans any attachments that have no associated report in any state.
-  void CleanOrphanedAttachments();
+  // report_names holds reports known to exist, whose attachments are kept
+  // without looking for the report again.
+  void CleanOrphanedAttachments(const ReportNames& report_names);
 
   // Reads the metadata for a report from path and returns it in report.
   bool ReadMetadata(const base::FilePath& path, Report* report);
@@ -254,10 +544,22 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   bool CleaningReadMetadata(const base::FilePath& path, Report* report);
 
   // Writes metadata for a new report to the filesystem at path.
-  static bool WriteNewMetadata(const base::FilePath& path);
+  bool WriteNewMetadata(const base::FilePath& path, time_t creation_time);
 
   // Writes the metadata for report to the filesystem at path.
-  static bool WriteMetadata(const base::FilePath& path, const Report& report);
+  bool WriteMetadata(const base::FilePath& path, const Report& report);
+
+  // Flushes the contents of file if durability_ calls for it.
+  bool SyncFileData(FileHandle file);
+
+  // Flushes the entries of the directory for reports in state, which may be
+  // kPending or kCompleted, if durability_ calls for it. This follows a change
+  // that has already been made, so failure is only logged.
+  void SyncReportDirectory(ReportState state);
+
+  // Flushes the contents of a new report's files and, if durability_ calls for
+  // it, its attachment directories, before the report is made pending.
+  bool SyncNewReport(NewReport* report);
 
   Settings& SettingsInternal() {
     std::call_once(settings_init_, [this]() {
@@ -269,6 +571,23 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   base::FilePath base_dir_;
   Settings settings_;
   std::once_flag settings_init_;
+  bool pack_reports_ = false;
+  Durability durability_ = Durability::kNone;
+  std::unique_ptr<BatchedDirectorySync> pending_directory_sync_;
+  std::unique_ptr<BatchedDirectorySync> completed_directory_sync_;
+  std::unique_ptr<BatchedDirectorySync> attachments_directory_sync_;
+
+  // The index as of index_cache_offset_ bytes into the index with generation
+  // index_cache_generation_, shared by all threads using this object, such as
+  // the handler's upload and pruning threads. index_cache_record_count_ counts
+  // the records read, including superseded ones. An offset of 0 means that
+  // nothing is cached.
+  std::mutex index_cache_lock_;
+  Index index_cache_;
+  UUID index_cache_generation_ = {};
+  FileOffset index_cache_offset_ = 0;
+  size_t index_cache_record_count_ = 0;
+
   InitializationStateDcheck initialized_;
 };
 
@@ -299,6 +618,13 @@ bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
     return false;
   }
 
+  pending_directory_sync_ = std::make_unique<BatchedDirectorySync>(
+      base_dir_.Append(kPendingDirectory));
+  completed_directory_sync_ = std::make_unique<BatchedDirectorySync>(
+      base_dir_.Append(kCompletedDirectory));
+  attachments_directory_sync_ =
+      std::make_unique<BatchedDirectorySync>(AttachmentsRootPath());
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -321,6 +647,23 @@ base::FilePath CrashReportDatabaseGeneric::DatabasePath() {
   return base_dir_;
 }
 
+base::FilePath CrashReportDatabaseGeneric::PendingReportsDirectory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return base_dir_.Append(kPendingDirectory);
+}
+
+bool CrashReportDatabaseGeneric::SetReportPackingEnabled(bool enabled) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  pack_reports_ = enabled;
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::SetDurability(Durability durability) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  durability_ = durability;
+  return true;
+}
+
 Settings* CrashReportDatabaseGeneric::GetSettings() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return &SettingsInternal();
@@ -335,6 +678,7 @@ OperationStatus CrashReportDatabaseGeneric::PrepareNewCrashReport(
           this, base_dir_.Append(kNewDirectory), kCrashReportExtension)) {
     return kFileSystemError;
   }
+  new_report->pack_attachments_ = pack_reports_;
 
   report->reset(new_report.release());
   return kNoError;
@@ -351,12 +695,26 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
     return kBusyError;
   }
 
-  if (!WriteNewMetadata(ReplaceFinalExtension(path, kMetadataExtension))) {
+  ScopedIndexLock index_lock;
+  LockIndexForUpdate(&index_lock);
+
+  const time_t creation_time = time(nullptr);
+  if (!WriteNewMetadata(ReplaceFinalExtension(path, kMetadataExtension),
+                        creation_time)) {
     return kDatabaseError;
   }
 
   FileOffset size = report->Writer()->Seek(0, SEEK_END);
 
+  if (report->pack_attachments_ && !report->WritePackedAttachments()) {
+    return kFileSystemError;
+  }
+  const FileOffset total_size = report->Writer()->Seek(0, SEEK_END);
+
+  if (!SyncNewReport(report.get())) {
+    return kFileSystemError;
+  }
+
   report->Writer()->Close();
   if (!MoveFileOrDirectory(report->file_remover_.get(), path)) {
     return kFileSystemError;
@@ -364,6 +722,9 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
   // We've moved the report to pending, so it no longer needs to be removed.
   std::ignore = report->file_remover_.release();
 
+  // This also covers the new metadata file.
+  SyncReportDirectory(kPending);
+
   // Close all the attachments and disarm their removers too.
   for (auto& writer : report->attachment_writers_) {
     writer->Close();
@@ -374,6 +735,13 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
 
   *uuid = report->ReportID();
 
+  Report indexed_report;
+  indexed_report.uuid = *uuid;
+  indexed_report.creation_time = creation_time;
+  indexed_report.total_size =
+      total_size + GetDirectorySize(AttachmentsPath(indexed_report.uuid));
+  UpdateIndex(index_lock, indexed_report, kPending);
+
   Metrics::CrashReportPending(Metrics::PendingReportReason::kNewlyCreated);
   Metrics::CrashReportSize(size);
 
@@ -401,6 +769,26 @@ OperationStatus CrashReportDatabaseGeneric::GetCompletedReports(
   return ReportsInState(kCompleted, reports);
 }
 
+bool CrashReportDatabaseGeneric::GetReportsSummary(ReportsSummary* summary) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  Index index;
+  if (!ReadIndex(&index) && !RebuildIndex(&index)) {
+    return false;
+  }
+
+  *summary = ReportsSummary();
+  for (const auto& [uuid, entry] : index) {
+    ++summary->report_count;
+    summary->total_size += entry.report.total_size;
+    if (summary->report_count == 1 ||
+        entry.report.creation_time < summary->oldest_creation_time) {
+      summary->oldest_creation_time = entry.report.creation_time;
+    }
+  }
+  return true;
+}
+
 OperationStatus CrashReportDatabaseGeneric::GetReportForUploading(
     const UUID& uuid,
     std::unique_ptr<const UploadReport>* report,
@@ -447,7 +835,11 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
     return kBusyError;
   }
 
+  ScopedIndexLock index_lock;
+  LockIndexForUpdate(&index_lock);
+
   report.upload_explicitly_requested = false;
+  report.upload_resumption_url.clear();
   if (!WriteMetadata(completed_path, report)) {
     return kDatabaseError;
   }
@@ -455,11 +847,15 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
   if (!MoveFileOrDirectory(path, completed_path)) {
     return kFileSystemError;
   }
+  SyncReportDirectory(kCompleted);
+  UpdateIndex(index_lock, report, kCompleted);
 
   if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
     return kDatabaseError;
   }
 
+  RemoveUploadBodyByUUID(uuid);
+
   return kNoError;
 }
 
@@ -474,10 +870,17 @@ OperationStatus CrashReportDatabaseGeneric::DeleteReport(const UUID& uuid) {
     return os;
   }
 
+  ScopedIndexLock index_lock;
+  LockIndexForUpdate(&index_lock);
+
   if (!LoggingRemoveFile(path)) {
     return kFileSystemError;
   }
 
+  Report removed_report;
+  removed_report.uuid = uuid;
+  UpdateIndex(index_lock, removed_report, kUninitialized);
+
   if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
     return kDatabaseError;
   }
@@ -503,6 +906,9 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
     return kCannotRequestUpload;
   }
 
+  ScopedIndexLock index_lock;
+  LockIndexForUpdate(&index_lock);
+
   report.upload_explicitly_requested = true;
   base::FilePath pending_path = ReportPath(uuid, kPending);
   if (!MoveFileOrDirectory(path, pending_path)) {
@@ -512,6 +918,10 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
   if (!WriteMetadata(pending_path, report)) {
     return kDatabaseError;
   }
+  if (pending_path != path) {
+    SyncReportDirectory(kPending);
+  }
+  UpdateIndex(index_lock, report, kPending);
 
   if (pending_path != path) {
     if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
@@ -524,32 +934,31 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
 }
 
 int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
-  int removed = 0;
-  time_t now = time(nullptr);
-
-  DirectoryReader reader;
-  const base::FilePath new_dir(base_dir_.Append(kNewDirectory));
-  if (reader.Open(new_dir)) {
-    base::FilePath filename;
-    DirectoryReader::Result result;
-    while ((result = reader.NextFile(&filename)) ==
-           DirectoryReader::Result::kSuccess) {
-      const base::FilePath filepath(new_dir.Append(filename));
-      timespec filetime;
-      if (!FileModificationTime(filepath, &filetime)) {
-        continue;
-      }
-      if (filetime.tv_sec <= now - lockfile_ttl) {
-        if (LoggingRemoveFile(filepath)) {
-          ++removed;
-        }
+  ReportNames report_names;
+  int removed = CleanNewReports(lockfile_ttl, &report_names);
+  removed += CleanReportsInState(kPending, lockfile_ttl, &report_names);
+  removed += CleanReportsInState(kCompleted, lockfile_ttl, &report_names);
+  CleanOrphanedAttachments(report_names);
+
+  // Rebuilding the index reads every report’s metadata, so only do it when
+  // something was removed above without the index being told, or to compact it
+  // once most of its records have been superseded.
+  Index index;
+  size_t record_count;
+  constexpr size_t kMinimumRecordsToCompact = 64;
+  if (removed > 0 || !ReadIndex(&index, &record_count) ||
+      (record_count >= kMinimumRecordsToCompact &&
+       record_count > 2 * index.size())) {
+    if (!RebuildIndex(&index) && removed > 0 &&
+        GetCurrentThreadPriority() == ThreadPriority::kBackground) {
+      // The index may still list a removed report. Without it, readers scan
+      // the report directories until a thread that can rebuild it does.
+      const base::FilePath index_path(base_dir_.Append(kIndex));
+      if (IsRegularFile(index_path)) {
+        LoggingRemoveFile(index_path);
       }
     }
   }
-
-  removed += CleanReportsInState(kPending, lockfile_ttl);
-  removed += CleanReportsInState(kCompleted, lockfile_ttl);
-  CleanOrphanedAttachments();
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
   base::FilePath settings_path(kSettings);
   if (Settings::IsLockExpired(settings_path, lockfile_ttl)) {
@@ -582,27 +991,36 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
   base::FilePath report_path(report->file_path);
 
   ScopedLockFile lock_file;
+  ScopedIndexLock index_lock;
   if (successful) {
     report->upload_explicitly_requested = false;
+    report->upload_resumption_url.clear();
 
     base::FilePath completed_report_path = ReportPath(report->uuid, kCompleted);
 
     if (!lock_file.ResetAcquire(completed_report_path)) {
       return kBusyError;
     }
+    LockIndexForUpdate(&index_lock);
 
-    report->Reader()->Close();
+    report->reader_->Close();
     if (!MoveFileOrDirectory(report_path, completed_report_path)) {
       return kFileSystemError;
     }
 
     LoggingRemoveFile(ReplaceFinalExtension(report_path, kMetadataExtension));
     report_path = completed_report_path;
+  } else {
+    LockIndexForUpdate(&index_lock);
   }
 
   if (!WriteMetadata(report_path, *report)) {
     return kDatabaseError;
   }
+  if (successful) {
+    SyncReportDirectory(kCompleted);
+  }
+  UpdateIndex(index_lock, *report, successful ? kCompleted : kPending);
 
   if (!SettingsInternal().SetLastUploadAttemptTime(now)) {
     return kDatabaseError;
@@ -611,6 +1029,22 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
   return kNoError;
 }
 
+OperationStatus CrashReportDatabaseGeneric::RecordUploadResumptionURL(
+    UploadReport* report,
+    const std::string& url) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  report->upload_resumption_url = url;
+
+  ScopedIndexLock index_lock;
+  LockIndexForUpdate(&index_lock);
+  if (!WriteMetadata(report->file_path, *report)) {
+    return kDatabaseError;
+  }
+  UpdateIndex(index_lock, *report, kPending);
+  return kNoError;
+}
+
 base::FilePath CrashReportDatabaseGeneric::ReportPath(const UUID& uuid,
                                                       ReportState state) {
   DCHECK_NE(state, kUninitialized);
@@ -674,6 +1108,11 @@ OperationStatus CrashReportDatabaseGeneric::CheckoutReport(
   }
 
   if (!CleaningReadMetadata(local_path, report)) {
+    ScopedIndexLock index_lock;
+    LockIndexForUpdate(&index_lock);
+    Report removed_report;
+    removed_report.uuid = UUIDFromReportPath(local_path);
+    UpdateIndex(index_lock, removed_report, kUninitialized);
     return kDatabaseError;
   }
 
@@ -690,6 +1129,27 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
   DCHECK_NE(state, kSearchable);
   DCHECK_NE(state, kNew);
 
+  Index index;
+  if (!ReadIndex(&index) && !RebuildIndex(&index)) {
+    return ScanReportsInState(state, false, reports);
+  }
+
+  for (const auto& [uuid, entry] : index) {
+    if (entry.state == state) {
+      reports->push_back(entry.report);
+      reports->back().file_path = ReportPath(uuid, state);
+    }
+  }
+  return kNoError;
+}
+
+OperationStatus CrashReportDatabaseGeneric::ScanReportsInState(
+    ReportState state,
+    bool include_locked,
+    std::vector<Report>* reports) {
+  DCHECK(reports->empty());
+  DCHECK(state == kPending || state == kCompleted);
+
   const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
   DirectoryReader reader;
   if (!reader.Open(dir_path)) {
@@ -697,22 +1157,24 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
   }
 
   base::FilePath filename;
+  DirectoryReader::FileType type;
   DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
+  while ((result = reader.NextFile(&filename, &type)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath::StringType extension(filename.FinalExtension());
-    if (extension.compare(kCrashReportExtension) != 0) {
+    if (type != DirectoryReader::FileType::kRegularFile ||
+        extension.compare(kCrashReportExtension) != 0) {
       continue;
     }
 
     const base::FilePath filepath(dir_path.Append(filename));
     ScopedLockFile lock_file;
-    if (!lock_file.ResetAcquire(filepath)) {
-      continue;
-    }
-
     Report report;
-    if (!CleaningReadMetadata(filepath, &report)) {
+    if (!lock_file.ResetAcquire(filepath)) {
+      if (!include_locked || !ReadMetadata(filepath, &report)) {
+        continue;
+      }
+    } else if (!CleaningReadMetadata(filepath, &report)) {
       continue;
     }
     reports->push_back(report);
@@ -721,71 +1183,367 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
   return kNoError;
 }
 
+bool CrashReportDatabaseGeneric::ReadIndex(Index* index,
+                                           size_t* record_count) {
+  index->clear();
+  if (record_count) {
+    *record_count = 0;
+  }
+
+  const base::FilePath index_path(base_dir_.Append(kIndex));
+  ScopedFileHandle handle(OpenFileForRead(index_path));
+  if (!handle.is_valid()) {
+    PLOG_IF(ERROR, errno != ENOENT) << "open " << index_path.value();
+    return false;
+  }
+
+  IndexHeader header;
+  if (!LoggingReadFileExactly(handle.get(), &header, sizeof(header))) {
+    LOG(ERROR) << "index too short";
+    return false;
+  }
+  if (header.magic != IndexHeader::kMagic ||
+      header.version != IndexHeader::kVersion) {
+    LOG(ERROR) << "index header mismatch";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(index_cache_lock_);
+  if (index_cache_offset_ == 0 ||
+      header.generation != index_cache_generation_) {
+    index_cache_.clear();
+    index_cache_generation_ = header.generation;
+    index_cache_offset_ = sizeof(header);
+    index_cache_record_count_ = 0;
+  } else if (LoggingSeekFile(handle.get(), index_cache_offset_, SEEK_SET) !=
+             index_cache_offset_) {
+    index_cache_offset_ = 0;
+    return false;
+  }
+
+  std::string contents;
+  if (!LoggingReadToEOF(handle.get(), &contents) ||
+      !ReadIndexRecordsLocked(contents)) {
+    index_cache_.clear();
+    index_cache_offset_ = 0;
+    return false;
+  }
+
+  *index = index_cache_;
+  if (record_count) {
+    *record_count = index_cache_record_count_;
+  }
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::ReadIndexRecordsLocked(
+    const std::string& contents) {
+  size_t offset = 0;
+  while (contents.size() - offset >= sizeof(IndexRecord)) {
+    IndexRecord record;
+    memcpy(&record, contents.data() + offset, sizeof(record));
+    if (contents.size() - offset - sizeof(record) < record.id_size) {
+      // An append in progress.
+      break;
+    }
+    offset += sizeof(record);
+
+    const char* id = contents.data() + offset;
+    offset += record.id_size;
+    if (record.checksum != IndexRecordChecksum(record, id)) {
+      LOG(ERROR) << "index record checksum mismatch";
+      return false;
+    }
+    index_cache_offset_ += sizeof(record) + record.id_size;
+    ++index_cache_record_count_;
+
+    if (record.state == kUninitialized) {
+      index_cache_.erase(record.uuid);
+      continue;
+    }
+    if (record.state != kPending && record.state != kCompleted) {
+      LOG(ERROR) << "index record state " << record.state;
+      return false;
+    }
+
+    IndexEntry& entry = index_cache_[record.uuid];
+    entry.state = static_cast<ReportState>(record.state);
+    entry.report = Report();
+    entry.report.uuid = record.uuid;
+    SetReportTrailer(record.attributes,
+                     std::string(id, record.id_size),
+                     &entry.report);
+    entry.report.creation_time = record.creation_time;
+    entry.report.uploaded = (record.attributes & kAttributeUploaded) != 0;
+    entry.report.last_upload_attempt_time = record.last_upload_attempt_time;
+    entry.report.upload_attempts = record.upload_attempts;
+    entry.report.upload_explicitly_requested =
+        (record.attributes & kAttributeUploadExplicitlyRequested) != 0;
+    entry.report.total_size = record.total_size;
+  }
+
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::RebuildIndex(Index* index) {
+  index->clear();
+
+  // A rebuild holds the index lock exclusively, which blocks every change to a
+  // report, including the capture of a new one. A thread at background
+  // priority can be starved of CPU and disk for arbitrarily long while holding
+  // the lock, so it leaves the rebuild to other threads.
+  if (GetCurrentThreadPriority() == ThreadPriority::kBackground) {
+    return false;
+  }
+
+  ScopedIndexLock index_lock;
+  if (!index_lock.Acquire(base_dir_.Append(kIndexLock),
+                          FileLocking::kExclusive)) {
+    return false;
+  }
+
+  std::string contents;
+  IndexHeader header;
+  if (!header.generation.InitializeWithNew()) {
+    return false;
+  }
+  contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  size_t record_count = 0;
+
+  for (const ReportState state : {kPending, kCompleted}) {
+    std::vector<Report> reports;
+    OperationStatus os = ScanReportsInState(state, true, &reports);
+    if (os != kNoError) {
+      return false;
+    }
+
+    for (const Report& report : reports) {
+      IndexRecord record = {};
+      record.uuid = report.uuid;
+      record.state = state;
+      record.upload_attempts = report.upload_attempts;
+      record.last_upload_attempt_time = report.last_upload_attempt_time;
+      record.creation_time = report.creation_time;
+      record.total_size = report.total_size;
+      record.attributes = ReportAttributes(report);
+      const std::string& trailer = ReportTrailer(report);
+      record.id_size = trailer.size();
+      record.checksum = IndexRecordChecksum(record, trailer.data());
+      contents.append(reinterpret_cast<const char*>(&record), sizeof(record));
+      contents.append(trailer);
+      ++record_count;
+
+      IndexEntry& entry = (*index)[report.uuid];
+      entry.state = state;
+      entry.report = report;
+    }
+  }
+
+  const base::FilePath temp_path(base_dir_.Append(kIndexTemp));
+  ScopedFileHandle handle(
+      LoggingOpenFileForWrite(temp_path,
+                              FileWriteMode::kTruncateOrCreate,
+                              FilePermissions::kOwnerOnly));
+  if (!handle.is_valid()) {
+    return false;
+  }
+  ScopedRemoveFile temp_remover(temp_path);
+  if (!LoggingWriteFile(handle.get(), contents.data(), contents.size()) ||
+      !MoveFileOrDirectory(temp_path, base_dir_.Append(kIndex))) {
+    return false;
+  }
+  std::ignore = temp_remover.release();
+
+  std::lock_guard<std::mutex> lock(index_cache_lock_);
+  index_cache_ = *index;
+  index_cache_generation_ = header.generation;
+  index_cache_offset_ = contents.size();
+  index_cache_record_count_ = record_count;
+  return true;
+}
+
+void CrashReportDatabaseGeneric::LockIndexForUpdate(
+    ScopedIndexLock* index_lock) {
+  index_lock->Acquire(base_dir_.Append(kIndexLock), FileLocking::kShared);
+}
+
+void CrashReportDatabaseGeneric::UpdateIndex(const ScopedIndexLock& index_lock,
+                                             const Report& report,
+                                             ReportState state) {
+  DCHECK(state == kPending || state == kCompleted || state == kUninitialized);
+
+  const base::FilePath index_path(base_dir_.Append(kIndex));
+  if (!index_lock.is_valid()) {
+    // Without the lock, a record appended now could be lost to a concurrent
+    // rebuild. Removing the index guarantees it's rebuilt instead.
+    if (IsRegularFile(index_path)) {
+      LoggingRemoveFile(index_path);
+    }
+    return;
+  }
+
+  IndexRecord record = {};
+  record.uuid = report.uuid;
+  record.state = state;
+  const std::string& trailer = ReportTrailer(report);
+  if (state != kUninitialized) {
+    record.upload_attempts = report.upload_attempts;
+    record.last_upload_attempt_time = report.last_upload_attempt_time;
+    record.creation_time = report.creation_time;
+    record.total_size = report.total_size;
+    record.attributes = ReportAttributes(report);
+    record.id_size = trailer.size();
+  }
+  record.checksum = IndexRecordChecksum(record, trailer.data());
+
+  std::string contents(reinterpret_cast<const char*>(&record), sizeof(record));
+  contents.append(trailer.data(), record.id_size);
+
+  // An index that doesn't exist yet will be built from the report directories
+  // when it's first read, so it's not created here. The record is written with
+  // a single O_APPEND write so that concurrent readers and writers in other
+  // processes see either all of it or a truncated tail.
+  ScopedFileHandle handle(HANDLE_EINTR(
+      open(index_path.value().c_str(), O_WRONLY | O_APPEND | O_CLOEXEC)));
+  if (!handle.is_valid()) {
+    PLOG_IF(ERROR, errno != ENOENT) << "open " << index_path.value();
+    return;
+  }
+
+  if (!LoggingWriteFile(handle.get(), contents.data(), contents.size())) {
+    LoggingRemoveFile(index_path);
+  }
+}
+
+int CrashReportDatabaseGeneric::CleanNewReports(time_t lockfile_ttl,
+                                                ReportNames* report_names) {
+  const base::FilePath new_dir(base_dir_.Append(kNewDirectory));
+  DirectoryReader reader;
+  if (!reader.Open(new_dir)) {
+    return 0;
+  }
+  const int dir_fd = reader.DirectoryFD();
+  if (dir_fd < 0) {
+    return 0;
+  }
+
+  const time_t now = time(nullptr);
+  int removed = 0;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  while (reader.NextFile(&filename, &type) ==
+         DirectoryReader::Result::kSuccess) {
+    if (type != DirectoryReader::FileType::kRegularFile) {
+      continue;
+    }
+
+    struct stat st;
+    if (fstatat(dir_fd, filename.value().c_str(), &st, AT_SYMLINK_NOFOLLOW) !=
+        0) {
+      PLOG_IF(ERROR, errno != ENOENT) << "fstatat " << filename.value();
+      continue;
+    }
+    if (st.st_mtime <= now - lockfile_ttl &&
+        LoggingRemoveFile(new_dir.Append(filename))) {
+      ++removed;
+      continue;
+    }
+    report_names->insert(filename.RemoveFinalExtension().value());
+  }
+
+  return removed;
+}
+
 int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
-                                                    time_t lockfile_ttl) {
+                                                    time_t lockfile_ttl,
+                                                    ReportNames* report_names) {
   const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
   DirectoryReader reader;
   if (!reader.Open(dir_path)) {
     return 0;
   }
 
-  int removed = 0;
+  struct ReportFiles {
+    bool report = false;
+    bool metadata = false;
+    bool lock = false;
+  };
+  std::map<base::FilePath::StringType, ReportFiles> reports;
+
   base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
+  DirectoryReader::FileType type;
+  while (reader.NextFile(&filename, &type) ==
          DirectoryReader::Result::kSuccess) {
+    if (type != DirectoryReader::FileType::kRegularFile) {
+      continue;
+    }
     const base::FilePath::StringType extension(filename.FinalExtension());
-    const base::FilePath filepath(dir_path.Append(filename));
-
-    // Remove any report files without metadata.
+    bool ReportFiles::*member;
     if (extension.compare(kCrashReportExtension) == 0) {
-      const base::FilePath metadata_path(
-          ReplaceFinalExtension(filepath, kMetadataExtension));
-      ScopedLockFile report_lock;
-      if (report_lock.ResetAcquire(filepath) && !IsRegularFile(metadata_path) &&
-          LoggingRemoveFile(filepath)) {
-        ++removed;
-        RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
-      }
+      member = &ReportFiles::report;
+    } else if (extension.compare(kMetadataExtension) == 0) {
+      member = &ReportFiles::metadata;
+    } else if (extension.compare(kLockExtension) == 0) {
+      member = &ReportFiles::lock;
+    } else {
       continue;
     }
+    reports[filename.RemoveFinalExtension().value()].*member = true;
+  }
 
-    // Remove any metadata files without report files.
-    if (extension.compare(kMetadataExtension) == 0) {
-      const base::FilePath report_path(
-          ReplaceFinalExtension(filepath, kCrashReportExtension));
+  int removed = 0;
+  for (const auto& [name, files] : reports) {
+    const base::FilePath no_ext(dir_path.Append(name));
+    const base::FilePath report_path(no_ext.value() + kCrashReportExtension);
+    const base::FilePath metadata_path(no_ext.value() + kMetadataExtension);
+    bool report_removed = false;
+
+    // Remove any report files without metadata, and any metadata files without
+    // report files. Only lock the report, which creates a lock file, if it
+    // appears to be lone. It’s checked again while locked in case it was being
+    // written or moved.
+    if (files.report != files.metadata) {
+      const base::FilePath& missing_path =
+          files.report ? metadata_path : report_path;
       ScopedLockFile report_lock;
       if (report_lock.ResetAcquire(report_path) &&
-          !IsRegularFile(report_path) && LoggingRemoveFile(filepath)) {
+          !IsRegularFile(missing_path) &&
+          LoggingRemoveFile(files.report ? report_path : metadata_path)) {
         ++removed;
-        RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
+        report_removed = true;
+        RemoveAttachmentsByUUID(UUIDFromReportPath(report_path));
       }
-      continue;
     }
 
     // Remove any expired locks only if we can remove the report and metadata.
-    if (extension.compare(kLockExtension) == 0 &&
-        ScopedLockFile::IsExpired(filepath, lockfile_ttl)) {
-      const base::FilePath no_ext(filepath.RemoveFinalExtension());
-      const base::FilePath report_path(no_ext.value() + kCrashReportExtension);
-      const base::FilePath metadata_path(no_ext.value() + kMetadataExtension);
-      if ((IsRegularFile(report_path) && !LoggingRemoveFile(report_path)) ||
-          (IsRegularFile(metadata_path) && !LoggingRemoveFile(metadata_path))) {
-        continue;
-      }
+    if (files.lock && !report_removed) {
+      const base::FilePath lock_path(no_ext.value() + kLockExtension);
+      if (ScopedLockFile::IsExpired(lock_path, lockfile_ttl)) {
+        if ((IsRegularFile(report_path) && !LoggingRemoveFile(report_path)) ||
+            (IsRegularFile(metadata_path) &&
+             !LoggingRemoveFile(metadata_path))) {
+          report_names->insert(name);
+          continue;
+        }
 
-      if (LoggingRemoveFile(filepath)) {
-        ++removed;
-        RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
+        if (LoggingRemoveFile(lock_path)) {
+          ++removed;
+          report_removed = true;
+          RemoveAttachmentsByUUID(UUIDFromReportPath(report_path));
+        }
       }
-      continue;
+    }
+
+    if (files.report && !report_removed) {
+      report_names->insert(name);
     }
   }
 
   return removed;
 }
 
-void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
+void CrashReportDatabaseGeneric::CleanOrphanedAttachments(
+    const ReportNames& report_names) {
   base::FilePath root_attachments_dir(AttachmentsRootPath());
   DirectoryReader reader;
   if (!reader.Open(root_attachments_dir)) {
@@ -793,18 +1551,20 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
   }
 
   base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
+  DirectoryReader::FileType type;
+  while (reader.NextFile(&filename, &type) ==
          DirectoryReader::Result::kSuccess) {
-    const base::FilePath report_attachment_dir(
-        root_attachments_dir.Append(filename));
-    if (IsDirectory(report_attachment_dir, false)) {
+    if (type == DirectoryReader::FileType::kDirectory) {
       UUID uuid;
       if (!uuid.InitializeFromString(filename.value())) {
         LOG(ERROR) << "unexpected attachment dir name " << filename.value();
         continue;
       }
 
+      if (report_names.count(filename.value())) {
+        continue;
+      }
+
       // Check to see if the report is being created in "new".
       base::FilePath new_dir_path =
           base_dir_.Append(kNewDirectory)
@@ -813,7 +1573,13 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
         continue;
       }
 
-      // Check to see if the report is in "pending" or "completed".
+      // Check to see if the report is in "pending" or "completed". Locking it
+      // creates a lock file, so first look for it without locking, which
+      // suffices unless it's moving between states.
+      if (IsRegularFile(ReportPath(uuid, kPending)) ||
+          IsRegularFile(ReportPath(uuid, kCompleted))) {
+        continue;
+      }
       ScopedLockFile local_lock;
       base::FilePath local_path;
       OperationStatus os =
@@ -855,9 +1621,11 @@ bool CrashReportDatabaseGeneric::ReadMetadata(const base::FilePath& path,
     return false;
   }
 
-  if (!LoggingReadToEOF(handle.get(), &report->id)) {
+  std::string trailer;
+  if (!LoggingReadToEOF(handle.get(), &trailer)) {
     return false;
   }
+  SetReportTrailer(metadata.attributes, std::move(trailer), report);
 
   // Seed the total size with the main report size and then add the sizes of any
   // potential attachments.
@@ -889,8 +1657,8 @@ bool CrashReportDatabaseGeneric::CleaningReadMetadata(
   return false;
 }
 
-// static
-bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
+bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path,
+                                                  time_t creation_time) {
   const base::FilePath metadata_path(
       ReplaceFinalExtension(path, kMetadataExtension));
 
@@ -907,12 +1675,12 @@ bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
   memset(&metadata, 0, sizeof(metadata));
 #endif  // defined(MEMORY_SANITIZER)
   metadata = {};
-  metadata.creation_time = time(nullptr);
+  metadata.creation_time = creation_time;
 
-  return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata));
+  return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata)) &&
+         SyncFileData(handle.get());
 }
 
-// static
 bool CrashReportDatabaseGeneric::WriteMetadata(const base::FilePath& path,
                                                const Report& report) {
   const base::FilePath metadata_path(
@@ -935,13 +1703,52 @@ bool CrashReportDatabaseGeneric::WriteMetadata(const base::FilePath& path,
   metadata.creation_time = report.creation_time;
   metadata.last_upload_attempt_time = report.last_upload_attempt_time;
   metadata.upload_attempts = report.upload_attempts;
-  metadata.attributes =
-      (report.uploaded ? kAttributeUploaded : 0) |
-      (report.upload_explicitly_requested ? kAttributeUploadExplicitlyRequested
-                                          : 0);
+  metadata.attributes = ReportAttributes(report);
 
+  const std::string& trailer = ReportTrailer(report);
   return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata)) &&
-         LoggingWriteFile(handle.get(), report.id.c_str(), report.id.size());
+         LoggingWriteFile(handle.get(), trailer.data(), trailer.size()) &&
+         SyncFileData(handle.get());
+}
+
+bool CrashReportDatabaseGeneric::SyncFileData(FileHandle file) {
+  return durability_ == Durability::kNone || LoggingSyncFileData(file);
+}
+
+void CrashReportDatabaseGeneric::SyncReportDirectory(ReportState state) {
+  if (durability_ != Durability::kFull) {
+    return;
+  }
+  DCHECK(state == kPending || state == kCompleted);
+  (state == kPending ? pending_directory_sync_ : completed_directory_sync_)
+      ->Sync();
+}
+
+bool CrashReportDatabaseGeneric::SyncNewReport(NewReport* report) {
+  if (durability_ == Durability::kNone) {
+    return true;
+  }
+
+  if (!LoggingSyncFileData(report->Writer()->UnderlyingFileHandle())) {
+    return false;
+  }
+
+  if (report->attachment_removers_.empty()) {
+    return true;
+  }
+
+  // Attachments may have been copied rather than written through a writer, so
+  // they're reopened to be flushed.
+  for (const auto& remover : report->attachment_removers_) {
+    ScopedFileHandle handle(LoggingOpenFileForRead(remover.get()));
+    if (!handle.is_valid() || !LoggingSyncFileData(handle.get())) {
+      return false;
+    }
+  }
+
+  return durability_ != Durability::kFull ||
+         (LoggingSyncDirectory(AttachmentsPath(report->ReportID())) &&
+          attachments_directory_sync_->Sync());
 }
 
 }  // namespace crashpad
@@ -229,11 +229,15 @@ class CrashReportDatabaseMac : public CrashReportDatabase {
   //!     must be locked with ObtainReportLock.
   //!
   //! \param[in] path The path of the report.
+  //! \param[in] lock The lock returned by ObtainReportLock(), through which the
+  //!     xattrs are read in a single pass.
   //! \param[out] report The object into which data will be read.
   //!
   //! \return `true` if all the metadata was read successfully, `false`
   //!     otherwise.
-  bool ReadReportMetadataLocked(const base::FilePath& path, Report* report);
+  bool ReadReportMetadataLocked(const base::FilePath& path,
+                                const base::ScopedFD& lock,
+                                Report* report);
 
   //! \brief Reads the metadata from all the reports in a database subdirectory.
   //!      Invalid reports are skipped.
@@ -436,7 +440,7 @@ CrashReportDatabaseMac::LookUpCrashReport(const UUID& uuid,
 
   *report = Report();
   report->file_path = path;
-  if (!ReadReportMetadataLocked(path, report))
+  if (!ReadReportMetadataLocked(path, lock, report))
     return kDatabaseError;
 
   return kNoError;
@@ -475,8 +479,10 @@ CrashReportDatabaseMac::GetReportForUploading(
   if (!lock.is_valid())
     return kBusyError;
 
-  if (!ReadReportMetadataLocked(upload_report->file_path, upload_report.get()))
+  if (!ReadReportMetadataLocked(
+          upload_report->file_path, lock, upload_report.get())) {
     return kDatabaseError;
+  }
 
 #if BUILDFLAG(IS_IOS)
   time_t upload_start_time = 0;
@@ -610,6 +616,8 @@ CrashReportDatabase::OperationStatus CrashReportDatabaseMac::SkipReportUpload(
   }
 #endif
 
+  RemoveUploadBodyByUUID(uuid);
+
   return MarkReportCompletedLocked(report_path, nullptr);
 }
 
@@ -755,48 +763,53 @@ base::ScopedFD CrashReportDatabaseMac::ObtainReportLock(
 }
 
 bool CrashReportDatabaseMac::ReadReportMetadataLocked(
-    const base::FilePath& path, Report* report) {
+    const base::FilePath& path,
+    const base::ScopedFD& lock,
+    Report* report) {
+  XattrSet xattrs;
+  if (!xattrs.Read(lock.get(), path, XattrName(base::StringPiece()))) {
+    return false;
+  }
+
   std::string uuid_string;
-  if (ReadXattr(path, XattrName(kXattrUUID),
-                &uuid_string) != XattrStatus::kOK ||
+  if (xattrs.Get(XattrName(kXattrUUID), &uuid_string) != XattrStatus::kOK ||
       !report->uuid.InitializeFromString(uuid_string)) {
     return false;
   }
 
-  if (ReadXattrTimeT(path, XattrName(kXattrCreationTime),
-                     &report->creation_time) != XattrStatus::kOK) {
+  if (xattrs.GetTimeT(XattrName(kXattrCreationTime),
+                      &report->creation_time) != XattrStatus::kOK) {
     return false;
   }
 
   report->id = std::string();
-  if (ReadXattr(path, XattrName(kXattrCollectorID),
-                &report->id) == XattrStatus::kOtherError) {
+  if (xattrs.Get(XattrName(kXattrCollectorID), &report->id) ==
+      XattrStatus::kOtherError) {
     return false;
   }
 
   report->uploaded = false;
-  if (ReadXattrBool(path, XattrName(kXattrIsUploaded),
-                    &report->uploaded) == XattrStatus::kOtherError) {
+  if (xattrs.GetBool(XattrName(kXattrIsUploaded), &report->uploaded) ==
+      XattrStatus::kOtherError) {
     return false;
   }
 
   report->last_upload_attempt_time = 0;
-  if (ReadXattrTimeT(path, XattrName(kXattrLastUploadTime),
-                     &report->last_upload_attempt_time) ==
-          XattrStatus::kOtherError) {
+  if (xattrs.GetTimeT(XattrName(kXattrLastUploadTime),
+                      &report->last_upload_attempt_time) ==
+      XattrStatus::kOtherError) {
     return false;
   }
 
   report->upload_attempts = 0;
-  if (ReadXattrInt(path, XattrName(kXattrUploadAttemptCount),
-                   &report->upload_attempts) == XattrStatus::kOtherError) {
+  if (xattrs.GetInt(XattrName(kXattrUploadAttemptCount),
+                    &report->upload_attempts) == XattrStatus::kOtherError) {
     return false;
   }
 
   report->upload_explicitly_requested = false;
-  if (ReadXattrBool(path,
-                    XattrName(kXattrIsUploadExplicitlyRequested),
-                    &report->upload_explicitly_requested) ==
+  if (xattrs.GetBool(XattrName(kXattrIsUploadExplicitlyRequested),
+                     &report->upload_explicitly_requested) ==
       XattrStatus::kOtherError) {
     return false;
   }
@@ -835,7 +848,7 @@ CrashReportDatabase::OperationStatus CrashReportDatabaseMac::ReportsInDirectory(
     if (!lock.is_valid())
       continue;
 
-    if (!ReadReportMetadataLocked(report.file_path, &report)) {
+    if (!ReadReportMetadataLocked(report.file_path, lock, &report)) {
       LOG(WARNING) << "Failed to read report metadata for "
                    << report.file_path.value();
       continue;
@@ -23,6 +23,8 @@
 #include "test/scoped_temp_dir.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
+#include "util/file/string_file.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_IOS)
 #include "util/mac/xattr.h"
@@ -785,7 +787,7 @@ TEST_F(CrashReportDatabaseTest, Attachments) {
   std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
   ASSERT_EQ(db()->GetReportForUploading(reports[0].uuid, &upload_report),
             CrashReportDatabase::kNoError);
-  std::map<std::string, FileReader*> result_attachments =
+  std::map<std::string, FileReaderInterface*> result_attachments =
       upload_report->GetAttachments();
   EXPECT_EQ(result_attachments.size(), 1u);
   EXPECT_NE(result_attachments.find("some_file"), result_attachments.end());
@@ -794,6 +796,329 @@ TEST_F(CrashReportDatabaseTest, Attachments) {
   EXPECT_EQ(memcmp(test_data, result_buffer, sizeof(test_data)), 0);
 }
 
+TEST_F(CrashReportDatabaseTest, AttachmentFromFile) {
+  ScopedTempDir temp_dir;
+  base::FilePath source(temp_dir.path().Append(FILE_PATH_LITERAL("log")));
+  static constexpr char kContents[] = "log contents";
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(kContents, strlen(kContents)));
+  }
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(new_report->AddAttachmentFromFile("log", source));
+  EXPECT_FALSE(new_report->AddAttachmentFromFile("not/a valid fi!e", source));
+  EXPECT_FALSE(new_report->AddAttachmentFromFile(
+      "missing", temp_dir.path().Append(FILE_PATH_LITERAL("missing"))));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  // The attachment is a snapshot of the source when it was added.
+  ASSERT_TRUE(LoggingRemoveFile(source));
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  std::map<std::string, FileReaderInterface*> result_attachments =
+      upload_report->GetAttachments();
+  ASSERT_EQ(result_attachments.size(), 1u);
+  ASSERT_NE(result_attachments.find("log"), result_attachments.end());
+  char result_buffer[sizeof(kContents)] = {};
+  ASSERT_TRUE(
+      result_attachments["log"]->ReadExactly(result_buffer, strlen(kContents)));
+  EXPECT_STREQ(result_buffer, kContents);
+}
+
+TEST_F(CrashReportDatabaseTest, UploadParameters) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  const std::map<std::string, std::string> parameters = {
+      {"prod", "product"}, {"ver", "1.2"}, {"empty", ""}};
+  ASSERT_TRUE(new_report->SetUploadParameters(parameters, "signature"));
+  ASSERT_NE(new_report->AddAttachment("some_file"), nullptr);
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  std::map<std::string, std::string> result_parameters;
+  std::string result_signature;
+  ASSERT_TRUE(upload_report->GetUploadParameters(&result_parameters,
+                                                 &result_signature));
+  EXPECT_EQ(result_parameters, parameters);
+  EXPECT_EQ(result_signature, "signature");
+
+  // The parameters aren’t uploaded as an attachment.
+  std::map<std::string, FileReaderInterface*> result_attachments =
+      upload_report->GetAttachments();
+  ASSERT_EQ(result_attachments.size(), 1u);
+  EXPECT_NE(result_attachments.find("some_file"), result_attachments.end());
+  upload_report.reset();
+
+  // A report written without them has none.
+  CrashReportDatabase::Report report;
+  CreateCrashReport(&report);
+  ASSERT_EQ(db()->GetReportForUploading(report.uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_FALSE(upload_report->GetUploadParameters(&result_parameters,
+                                                  &result_signature));
+  EXPECT_EQ(result_parameters, parameters);
+}
+
+TEST_F(CrashReportDatabaseTest, UploadBody) {
+  auto write_upload_body = [this](const UUID& uuid) {
+    const base::FilePath upload_body_path = db()->UploadBodyPath(uuid);
+    ASSERT_FALSE(upload_body_path.empty());
+    EXPECT_FALSE(FileExists(upload_body_path));
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(upload_body_path,
+                            FileWriteMode::kCreateOrFail,
+                            FilePermissions::kOwnerOnly));
+    static constexpr char kBody[] = "body";
+    ASSERT_TRUE(writer.Write(kBody, strlen(kBody)));
+  };
+
+  CrashReportDatabase::Report uploaded_report;
+  CreateCrashReport(&uploaded_report);
+  write_upload_body(uploaded_report.uuid);
+  UploadReport(uploaded_report.uuid, false, std::string());
+  EXPECT_TRUE(FileExists(db()->UploadBodyPath(uploaded_report.uuid)));
+  UploadReport(uploaded_report.uuid, true, "server_id");
+  EXPECT_FALSE(FileExists(db()->UploadBodyPath(uploaded_report.uuid)));
+
+  CrashReportDatabase::Report skipped_report;
+  CreateCrashReport(&skipped_report);
+  write_upload_body(skipped_report.uuid);
+  EXPECT_EQ(db()->SkipReportUpload(skipped_report.uuid,
+                                   Metrics::CrashSkippedReason::kUploadFailed),
+            CrashReportDatabase::kNoError);
+  EXPECT_FALSE(FileExists(db()->UploadBodyPath(skipped_report.uuid)));
+
+  CrashReportDatabase::Report deleted_report;
+  CreateCrashReport(&deleted_report);
+  write_upload_body(deleted_report.uuid);
+  EXPECT_EQ(db()->DeleteReport(deleted_report.uuid),
+            CrashReportDatabase::kNoError);
+  EXPECT_FALSE(FileExists(db()->UploadBodyPath(deleted_report.uuid)));
+}
+
+std::string ReadToEOF(FileReaderInterface* reader) {
+  std::string contents;
+  char buffer[64];
+  FileOperationResult read_result;
+  while ((read_result = reader->Read(buffer, sizeof(buffer))) > 0) {
+    contents.append(buffer, read_result);
+  }
+  EXPECT_EQ(read_result, 0);
+  return contents;
+}
+
+TEST_F(CrashReportDatabaseTest, ExportImport) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kMinidumpContents[] = "minidump contents";
+  ASSERT_TRUE(new_report->Writer()->Write(kMinidumpContents,
+                                          strlen(kMinidumpContents)));
+  FileWriter* attachment_writer = new_report->AddAttachment("log");
+  ASSERT_NE(attachment_writer, nullptr);
+  static constexpr char kLogContents[] = "log contents";
+  ASSERT_TRUE(attachment_writer->Write(kLogContents, strlen(kLogContents)));
+  const std::map<std::string, std::string> parameters = {{"prod", "product"},
+                                                         {"empty", ""}};
+  ASSERT_TRUE(new_report->SetUploadParameters(parameters, std::string()));
+  UUID pending_uuid;
+  ASSERT_EQ(
+      db()->FinishedWritingCrashReport(std::move(new_report), &pending_uuid),
+      CrashReportDatabase::kNoError);
+
+  CrashReportDatabase::Report completed_report;
+  CreateCrashReport(&completed_report);
+  ASSERT_EQ(
+      db()->SkipReportUpload(completed_report.uuid,
+                             Metrics::CrashSkippedReason::kUploadsDisabled),
+      CrashReportDatabase::kNoError);
+
+  StringFile archive;
+  ASSERT_EQ(
+      db()->ExportReports({pending_uuid, completed_report.uuid}, &archive),
+      CrashReportDatabase::kNoError);
+
+  // Exporting doesn’t change the reports.
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].upload_attempts, 0);
+
+  ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> imported_db =
+      CrashReportDatabase::Initialize(
+          temp_dir.path().Append(FILE_PATH_LITERAL("imported")));
+  ASSERT_TRUE(imported_db);
+  ASSERT_EQ(archive.Seek(0, SEEK_SET), 0);
+  std::vector<std::pair<UUID, UUID>> uuids;
+  ASSERT_EQ(imported_db->ImportReports(&archive, &uuids),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(uuids.size(), 2u);
+  EXPECT_EQ(uuids[0].first, pending_uuid);
+  EXPECT_EQ(uuids[1].first, completed_report.uuid);
+
+  // Both reports are pending in the database they’re imported into.
+  reports.clear();
+  ASSERT_EQ(imported_db->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(imported_db->GetReportForUploading(uuids[0].second, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReadToEOF(upload_report->Reader()), kMinidumpContents);
+  std::map<std::string, FileReaderInterface*> attachments =
+      upload_report->GetAttachments();
+  ASSERT_EQ(attachments.size(), 1u);
+  ASSERT_NE(attachments.find("log"), attachments.end());
+  EXPECT_EQ(ReadToEOF(attachments["log"]), kLogContents);
+  std::map<std::string, std::string> result_parameters;
+  std::string result_signature("not empty");
+  ASSERT_TRUE(upload_report->GetUploadParameters(&result_parameters,
+                                                 &result_signature));
+  EXPECT_EQ(result_parameters, parameters);
+  EXPECT_EQ(result_signature, "");
+  upload_report.reset();
+
+  ASSERT_EQ(imported_db->GetReportForUploading(uuids[1].second, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReadToEOF(upload_report->Reader()), std::string("test", 5));
+  EXPECT_TRUE(upload_report->GetAttachments().empty());
+  EXPECT_FALSE(upload_report->GetUploadParameters(&result_parameters,
+                                                  &result_signature));
+  upload_report.reset();
+
+  // A truncated archive is an error. The reports before the last are still
+  // imported, but the last can’t be known to be whole, so it isn’t.
+  StringFile truncated_archive;
+  truncated_archive.SetString(
+      archive.string().substr(0, archive.string().size() - 1));
+  uuids.clear();
+  EXPECT_NE(imported_db->ImportReports(&truncated_archive, &uuids),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(uuids.size(), 1u);
+
+  // Exporting a report that isn’t in the database fails.
+  StringFile missing_archive;
+  EXPECT_EQ(db()->ExportReports({UUID()}, &missing_archive),
+            CrashReportDatabase::kReportNotFound);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_FUCHSIA)
+
+TEST_F(CrashReportDatabaseTest, PackedAttachments) {
+  ASSERT_TRUE(db()->SetReportPackingEnabled(true));
+
+  ScopedTempDir temp_dir;
+  base::FilePath source(temp_dir.path().Append(FILE_PATH_LITERAL("log")));
+  static constexpr char kLogContents[] = "log contents";
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(kLogContents, strlen(kLogContents)));
+  }
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kMinidumpContents[] = "minidump contents";
+  ASSERT_TRUE(new_report->Writer()->Write(kMinidumpContents,
+                                          strlen(kMinidumpContents)));
+  EXPECT_TRUE(new_report->AddAttachmentFromFile("log", source));
+  EXPECT_FALSE(new_report->AddAttachmentFromFile("log", source));
+  EXPECT_TRUE(new_report->AddAttachmentFromFile("log2", source));
+
+  // Attachments written by the caller are still separate files.
+  FileWriter* writer = new_report->AddAttachment("written");
+  ASSERT_NE(writer, nullptr);
+  static constexpr char kWrittenContents[] = "written contents";
+  ASSERT_TRUE(writer->Write(kWrittenContents, strlen(kWrittenContents)));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.total_size,
+            static_cast<uint64_t>(FileSize(report.file_path)) +
+                strlen(kWrittenContents));
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+
+  EXPECT_EQ(ReadToEOF(upload_report->Reader()), kMinidumpContents);
+
+  std::map<std::string, FileReaderInterface*> result_attachments =
+      upload_report->GetAttachments();
+  ASSERT_EQ(result_attachments.size(), 3u);
+  for (const auto& [name, expected] :
+       {std::make_pair("log", kLogContents),
+        std::make_pair("log2", kLogContents),
+        std::make_pair("written", kWrittenContents)}) {
+    SCOPED_TRACE(name);
+    ASSERT_NE(result_attachments.find(name), result_attachments.end());
+    EXPECT_EQ(ReadToEOF(result_attachments[name]), expected);
+  }
+}
+
+TEST_F(CrashReportDatabaseTest, Durability) {
+  for (const auto durability : {CrashReportDatabase::Durability::kNone,
+                                CrashReportDatabase::Durability::kData,
+                                CrashReportDatabase::Durability::kFull}) {
+    SCOPED_TRACE(static_cast<int>(durability));
+    ASSERT_TRUE(db()->SetDurability(durability));
+
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+              CrashReportDatabase::kNoError);
+    static constexpr char kContents[] = "contents";
+    ASSERT_TRUE(new_report->Writer()->Write(kContents, sizeof(kContents)));
+    FileWriter* writer = new_report->AddAttachment("attachment");
+    ASSERT_NE(writer, nullptr);
+    ASSERT_TRUE(writer->Write(kContents, sizeof(kContents)));
+
+    UUID uuid;
+    ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+              CrashReportDatabase::kNoError);
+
+    UploadReport(uuid, false, std::string());
+    EXPECT_EQ(db()->SkipReportUpload(
+                  uuid, Metrics::CrashSkippedReason::kUploadsDisabled),
+              CrashReportDatabase::kNoError);
+    EXPECT_EQ(db()->RequestUpload(uuid), CrashReportDatabase::kNoError);
+    UploadReport(uuid, true, "server_id");
+
+    CrashReportDatabase::Report report;
+    ASSERT_EQ(db()->LookUpCrashReport(uuid, &report),
+              CrashReportDatabase::kNoError);
+    EXPECT_TRUE(report.uploaded);
+    EXPECT_EQ(report.id, "server_id");
+  }
+}
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_FUCHSIA)
+
 TEST_F(CrashReportDatabaseTest, OrphanedAttachments) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
@@ -922,6 +1247,332 @@ TEST_F(CrashReportDatabaseTest, CleanBrokenDatabase) {
   EXPECT_FALSE(PathExists(report.file_path));
   EXPECT_FALSE(PathExists(metadata3));
 }
+
+TEST_F(CrashReportDatabaseTest, CleanDatabaseKeepsReports) {
+  // A pending report with an attachment.
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  ASSERT_NE(new_report->AddAttachment("file"), nullptr);
+  UUID pending_uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report),
+                                             &pending_uuid),
+            CrashReportDatabase::kNoError);
+
+  // A completed report with an attachment.
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  ASSERT_NE(new_report->AddAttachment("file"), nullptr);
+  UUID completed_uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report),
+                                             &completed_uuid),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->SkipReportUpload(
+                completed_uuid, Metrics::CrashSkippedReason::kUploadsDisabled),
+            CrashReportDatabase::kNoError);
+
+  // A report with metadata but no report file, whose attachments are orphaned.
+  CrashReportDatabase::Report broken;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&broken));
+  ASSERT_TRUE(LoggingRemoveFile(broken.file_path));
+  const base::FilePath broken_attachments(
+      path()
+          .Append(FILE_PATH_LITERAL("attachments"))
+          .Append(broken.uuid.ToString()));
+  ASSERT_TRUE(LoggingCreateDirectory(
+      broken_attachments, FilePermissions::kOwnerOnly, false));
+
+  EXPECT_EQ(db()->CleanDatabase(0), 1);
+  EXPECT_FALSE(PathExists(broken_attachments));
+
+  CrashReportDatabase::Report report;
+  EXPECT_EQ(db()->LookUpCrashReport(pending_uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(db()->LookUpCrashReport(completed_uuid, &report),
+            CrashReportDatabase::kNoError);
+  for (const UUID& uuid : {pending_uuid, completed_uuid}) {
+    EXPECT_TRUE(FileExists(path()
+                               .Append(FILE_PATH_LITERAL("attachments"))
+                               .Append(uuid.ToString())
+                               .Append(FILE_PATH_LITERAL("file"))));
+  }
+
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+}
+
+TEST_F(CrashReportDatabaseTest, UploadResumptionURL) {
+  static constexpr char kURL[] = "https://example.com/files/24e533e02ec3bc40";
+
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  EXPECT_TRUE(report.upload_resumption_url.empty());
+
+  // The URL outlives a failed upload attempt.
+  {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    ASSERT_EQ(db()->GetReportForUploading(report.uuid, &upload_report),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(db()->SetUploadResumptionURL(upload_report.get(), kURL),
+              CrashReportDatabase::kNoError);
+    EXPECT_EQ(upload_report->upload_resumption_url, kURL);
+  }
+
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.upload_resumption_url, kURL);
+  EXPECT_TRUE(report.id.empty());
+  EXPECT_EQ(report.upload_attempts, 1);
+
+  std::vector<CrashReportDatabase::Report> pending;
+  EXPECT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0].upload_resumption_url, kURL);
+
+  // It’s read back from the report’s metadata by another database, which
+  // rebuilds the index.
+  LoggingRemoveFile(path().Append(FILE_PATH_LITERAL("index.dat")));
+  std::unique_ptr<CrashReportDatabase> other_db(
+      CrashReportDatabase::InitializeWithoutCreating(path()));
+  ASSERT_TRUE(other_db);
+  pending.clear();
+  EXPECT_EQ(other_db->GetPendingReports(&pending),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0].upload_resumption_url, kURL);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(other_db->GetReportForUploading(report.uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(upload_report->upload_resumption_url, kURL);
+
+  // It’s forgotten once the report is uploaded.
+  EXPECT_EQ(other_db->RecordUploadComplete(std::move(upload_report), "1"),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, "1");
+  EXPECT_TRUE(report.upload_resumption_url.empty());
+}
+
+// The index is only used where flock() is available.
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+TEST_F(CrashReportDatabaseTest, RecoverIndex) {
+  CrashReportDatabase::Report pending_report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending_report));
+  CrashReportDatabase::Report completed_report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed_report));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(completed_report.uuid, true, "1"));
+
+  auto expect_reports = [this, &pending_report, &completed_report]() {
+    std::vector<CrashReportDatabase::Report> pending;
+    EXPECT_EQ(db()->GetPendingReports(&pending),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(pending.size(), 1u);
+    EXPECT_EQ(pending[0].uuid, pending_report.uuid);
+    EXPECT_EQ(pending[0].file_path, pending_report.file_path);
+    EXPECT_EQ(pending[0].creation_time, pending_report.creation_time);
+    EXPECT_EQ(pending[0].total_size, pending_report.total_size);
+    EXPECT_FALSE(pending[0].uploaded);
+
+    std::vector<CrashReportDatabase::Report> completed;
+    EXPECT_EQ(db()->GetCompletedReports(&completed),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].uuid, completed_report.uuid);
+    EXPECT_EQ(completed[0].id, "1");
+    EXPECT_TRUE(completed[0].uploaded);
+    EXPECT_EQ(completed[0].upload_attempts, 1);
+  };
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // A record only partially appended is ignored.
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      index_path, FileWriteMode::kReuseOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_NE(LoggingSeekFile(handle.get(), 0, SEEK_END), -1);
+  static constexpr char kPartialRecord[] = "partial";
+  ASSERT_TRUE(
+      LoggingWriteFile(handle.get(), kPartialRecord, sizeof(kPartialRecord)));
+  ASSERT_TRUE(LoggingCloseFile(handle.release()));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // A corrupt index is rebuilt from the report metadata.
+  handle.reset(LoggingOpenFileForWrite(index_path,
+                                       FileWriteMode::kTruncateOrCreate,
+                                       FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  static constexpr char kCorruptIndex[] = "not an index, but large enough";
+  ASSERT_TRUE(
+      LoggingWriteFile(handle.get(), kCorruptIndex, sizeof(kCorruptIndex)));
+  ASSERT_TRUE(LoggingCloseFile(handle.release()));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // So is a missing index.
+  ASSERT_TRUE(LoggingRemoveFile(index_path));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // Changes are tracked by the rebuilt index.
+  EXPECT_EQ(db()->DeleteReport(pending_report.uuid),
+            CrashReportDatabase::kNoError);
+  std::vector<CrashReportDatabase::Report> pending;
+  EXPECT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  EXPECT_TRUE(pending.empty());
+}
+
+TEST_F(CrashReportDatabaseTest, PendingReportsDirectory) {
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  EXPECT_EQ(report.file_path.DirName(), db()->PendingReportsDirectory());
+
+  ASSERT_EQ(db()->SkipReportUpload(
+                report.uuid, Metrics::CrashSkippedReason::kUploadsDisabled),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_NE(report.file_path.DirName(), db()->PendingReportsDirectory());
+
+  ASSERT_EQ(RequestUpload(report.uuid), CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.file_path.DirName(), db()->PendingReportsDirectory());
+}
+
+TEST_F(CrashReportDatabaseTest, IndexChangedByOtherDatabase) {
+  CrashReportDatabase::Report report_1;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report_1));
+
+  std::unique_ptr<CrashReportDatabase> other_db(
+      CrashReportDatabase::InitializeWithoutCreating(path()));
+  ASSERT_TRUE(other_db);
+  std::vector<CrashReportDatabase::Report> pending;
+  EXPECT_EQ(other_db->GetPendingReports(&pending),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0].uuid, report_1.uuid);
+
+  // Records appended by another database are seen.
+  CrashReportDatabase::Report report_2;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report_2));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(report_1.uuid, true, "1"));
+  pending.clear();
+  EXPECT_EQ(other_db->GetPendingReports(&pending),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0].uuid, report_2.uuid);
+  std::vector<CrashReportDatabase::Report> completed;
+  EXPECT_EQ(other_db->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(completed.size(), 1u);
+  EXPECT_EQ(completed[0].uuid, report_1.uuid);
+  EXPECT_EQ(completed[0].id, "1");
+
+  // So is an index rebuilt by another database.
+  ASSERT_TRUE(
+      LoggingRemoveFile(path().Append(FILE_PATH_LITERAL("index.dat"))));
+  EXPECT_EQ(db()->DeleteReport(report_1.uuid), CrashReportDatabase::kNoError);
+  completed.clear();
+  EXPECT_EQ(db()->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(completed.empty());
+  completed.clear();
+  EXPECT_EQ(other_db->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(completed.empty());
+  pending.clear();
+  EXPECT_EQ(other_db->GetPendingReports(&pending),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_EQ(pending[0].uuid, report_2.uuid);
+}
+
+TEST_F(CrashReportDatabaseTest, ReportsSummary) {
+  CrashReportDatabase::ReportsSummary summary;
+  ASSERT_TRUE(db()->GetReportsSummary(&summary));
+  EXPECT_EQ(summary.report_count, 0u);
+  EXPECT_EQ(summary.total_size, 0u);
+  EXPECT_EQ(summary.oldest_creation_time, 0);
+
+  CrashReportDatabase::Report report_1;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report_1));
+  CrashReportDatabase::Report report_2;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report_2));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(report_2.uuid, true, "2"));
+
+  ASSERT_TRUE(db()->GetReportsSummary(&summary));
+  EXPECT_EQ(summary.report_count, 2u);
+  EXPECT_EQ(summary.total_size, report_1.total_size + report_2.total_size);
+  EXPECT_EQ(summary.oldest_creation_time,
+            std::min(report_1.creation_time, report_2.creation_time));
+
+  EXPECT_EQ(db()->DeleteReport(report_1.uuid), CrashReportDatabase::kNoError);
+  ASSERT_TRUE(db()->GetReportsSummary(&summary));
+  EXPECT_EQ(summary.report_count, 1u);
+  EXPECT_EQ(summary.total_size, report_2.total_size);
+  EXPECT_EQ(summary.oldest_creation_time, report_2.creation_time);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Lists pending reports from a thread at background priority.
+class BackgroundPendingReportsThread final : public Thread {
+ public:
+  explicit BackgroundPendingReportsThread(CrashReportDatabase* database)
+      : database_(database) {
+    SetPriority(ThreadPriority::kBackground);
+  }
+
+  BackgroundPendingReportsThread(const BackgroundPendingReportsThread&) =
+      delete;
+  BackgroundPendingReportsThread& operator=(
+      const BackgroundPendingReportsThread&) = delete;
+
+  CrashReportDatabase::OperationStatus status() const { return status_; }
+  const std::vector<CrashReportDatabase::Report>& reports() const {
+    return reports_;
+  }
+
+ private:
+  void ThreadMain() override {
+    status_ = database_->GetPendingReports(&reports_);
+  }
+
+  CrashReportDatabase* database_;
+  CrashReportDatabase::OperationStatus status_ =
+      CrashReportDatabase::kDatabaseError;
+  std::vector<CrashReportDatabase::Report> reports_;
+};
+
+TEST_F(CrashReportDatabaseTest, BackgroundThreadDoesNotRebuildIndex) {
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  std::vector<CrashReportDatabase::Report> pending;
+  EXPECT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  ASSERT_TRUE(LoggingRemoveFile(index_path));
+
+  // A background thread scans the reports instead of rebuilding the index
+  // under its exclusive lock.
+  BackgroundPendingReportsThread thread(db());
+  thread.Start();
+  thread.Join();
+  EXPECT_EQ(thread.status(), CrashReportDatabase::kNoError);
+  ASSERT_EQ(thread.reports().size(), 1u);
+  EXPECT_EQ(thread.reports()[0].uuid, report.uuid);
+  EXPECT_FALSE(FileExists(index_path));
+
+  // Other threads still rebuild it.
+  pending.clear();
+  EXPECT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  ASSERT_EQ(pending.size(), 1u);
+  EXPECT_TRUE(FileExists(index_path));
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
 #endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
 
 TEST_F(CrashReportDatabaseTest, TotalSize_MainReportOnly) {
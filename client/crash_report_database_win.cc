@@ -15,12 +15,14 @@
 #include "client/crash_report_database.h"
 
 #include <windows.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 #include <time.h>
 #include <wchar.h>
 
+#include <map>
 #include <mutex>
 #include <tuple>
 #include <utility>
@@ -48,7 +50,16 @@ constexpr wchar_t kSettings[] = L"settings.dat";
 constexpr wchar_t kCrashReportFileExtension[] = L"dmp";
 
 constexpr uint32_t kMetadataFileHeaderMagic = 'CPAD';
-constexpr uint32_t kMetadataFileVersion = 1;
+constexpr uint32_t kMetadataFileVersion1 = 1;
+constexpr uint32_t kMetadataFileVersion = 2;
+
+// The on-disk MetadataFileReportRecord::state of a record that was deleted or
+// superseded by a later record.
+constexpr int32_t kRecordStateDead = -1;
+
+// The metadata file is compacted by rewriting it in full once it holds at least
+// this many dead records, and more dead records than live ones.
+constexpr size_t kMetadataCompactionMinimumDeadRecords = 64;
 
 using OperationStatus = CrashReportDatabase::OperationStatus;
 
@@ -91,9 +102,19 @@ bool UUIDFromReportPath(const base::FilePath& path, UUID* uuid) {
 
 // Helper structures, and conversions ------------------------------------------
 
-// The format of the on disk metadata file is a MetadataFileHeader, followed by
-// a number of fixed size records of MetadataFileReportRecord, followed by a
+// Version 1 of the on disk metadata file is a MetadataFileHeader, followed by a
+// number of fixed size records of MetadataFileReportRecord, followed by a
 // string table in UTF8 format, where each string is \0 terminated.
+//
+// Version 2 is a MetadataFileHeader followed by a log of num_records entries.
+// Each entry is a MetadataFileReportRecord immediately followed by its own
+// string table of strings_size bytes, padded to keep the next record aligned.
+// This allows the fixed size fields of a record to be updated in place, and new
+// records to be appended without rewriting the file. A record that is deleted,
+// or whose strings change, is marked with kRecordStateDead in place, and in the
+// latter case a new entry is appended. When the same UUID appears in more than
+// one live record, the last one wins. Dead records are dropped when the file is
+// compacted. Version 1 files are converted the next time they are written.
 struct MetadataFileHeader {
   uint32_t magic;
   uint32_t version;
@@ -139,7 +160,9 @@ struct MetadataFileReportRecord {
   int32_t upload_attempts;
   int32_t state;  // A ReportState.
   uint8_t attributes;  // Bitfield of kAttribute*.
-  uint8_t padding[7];
+  uint8_t padding[3];
+  uint32_t strings_size;  // Size of the string table following this record in
+                          // version 2. Zero in version 1.
 };
 
 //! \brief A private extension of the Report class that includes additional data
@@ -156,6 +179,18 @@ struct ReportDisk : public CrashReportDatabase::Report {
 
   //! \brief The current state of the report.
   ReportState state;
+
+  //! \brief The offset of this report's record in a version 2 metadata file,
+  //!     or `-1` if the record must be appended.
+  FileOffset record_offset;
+
+  //! \brief The string table stored with this report's record. If the strings
+  //!     change, the record cannot be updated in place.
+  std::string record_strings;
+
+  //! \brief `true` if the report may have been modified since it was
+  //!     written.
+  bool dirty;
 };
 
 MetadataFileReportRecord::MetadataFileReportRecord(const ReportDisk& report,
@@ -171,14 +206,26 @@ MetadataFileReportRecord::MetadataFileReportRecord(const ReportDisk& report,
       attributes((report.uploaded ? kAttributeUploaded : 0) |
                  (report.upload_explicitly_requested
                       ? kAttributeUploadExplicitlyRequested
-                      : 0)) {
+                      : 0)),
+      strings_size(0) {
   memset(&padding, 0, sizeof(padding));
 }
 
+// Builds the version 2 record for |report|, and the string table that is stored
+// following it.
+MetadataFileReportRecord BuildRecordEntry(const ReportDisk& report,
+                                          std::string* strings) {
+  strings->clear();
+  MetadataFileReportRecord record(report, strings);
+  strings->resize((strings->size() + 7) & ~static_cast<size_t>(7), '\0');
+  record.strings_size = base::checked_cast<uint32_t>(strings->size());
+  return record;
+}
+
 ReportDisk::ReportDisk(const MetadataFileReportRecord& record,
                        const base::FilePath& report_dir,
                        const std::string& string_table)
-    : Report() {
+    : Report(), record_offset(-1), record_strings(), dirty(false) {
   uuid = record.uuid;
   file_path = report_dir.Append(
       base::UTF8ToWide(&string_table[record.file_path_index]));
@@ -196,7 +243,7 @@ ReportDisk::ReportDisk(const UUID& uuid,
                        const base::FilePath& path,
                        time_t creation_time,
                        ReportState state)
-    : Report() {
+    : Report(), record_offset(-1), record_strings(), dirty(true) {
   this->uuid = uuid;
   this->file_path = path;
   this->creation_time = creation_time;
@@ -289,8 +336,42 @@ class Metadata {
   bool Rewind();
 
   void Read();
+
+  //! \brief Reads the records and string table of a version 1 file, following
+  //!     the header.
+  bool ReadVersion1(const MetadataFileHeader& header,
+                    std::vector<ReportDisk>* reports);
+
+  //! \brief Reads the log of records of a version 2 file, following the
+  //!     header.
+  bool ReadVersion2(const MetadataFileHeader& header,
+                    std::vector<ReportDisk>* reports);
+
+  //! \brief Validates \a record and appends the corresponding ReportDisk to
+  //!     \a reports.
+  bool AddReportFromRecord(const MetadataFileReportRecord& record,
+                           const std::string& string_table,
+                           std::vector<ReportDisk>* reports);
+
+  //! \brief Writes changes to disk, incrementally if possible, and otherwise by
+  //!     compacting.
   void Write();
 
+  //! \brief Updates the records of dirty and deleted reports in place, and
+  //!     appends new records.
+  //!
+  //! \return `true` on success. `false` if the file must instead be compacted,
+  //!     either because an error occurred or because it holds too many dead
+  //!     records.
+  bool WriteIncremental();
+
+  //! \brief Rewrites the entire file, containing only live records.
+  void Compact();
+
+  //! \brief Marks the record of \a report_disk, if any, to be made dead on the
+  //!     next write.
+  void KillRecord(const ReportDisk& report_disk);
+
   //! \brief Confirms that the corresponding report actually exists on disk
   //!     (that is, the dump file has not been removed), and that the report is
   //!     in the given state.
@@ -304,6 +385,23 @@ class Metadata {
   const base::FilePath report_dir_;
   const base::FilePath attachments_dir_;
   bool dirty_;  //! \brief `true` when a Write() is required on destruction.
+
+  //! \brief `true` if the file cannot be updated incrementally, because it was
+  //!     not read as a valid version 2 file.
+  bool compact_;
+
+  //! \brief The number of records in the file, live or dead.
+  uint32_t num_records_on_disk_;
+
+  //! \brief The number of dead records in the file.
+  size_t num_dead_records_on_disk_;
+
+  //! \brief The offset just past the last record in the file.
+  FileOffset end_offset_;
+
+  //! \brief The offsets of live records that must be made dead.
+  std::vector<FileOffset> dead_record_offsets_;
+
   std::vector<ReportDisk> reports_;
 };
 
@@ -358,6 +456,8 @@ std::unique_ptr<Metadata> Metadata::Create(
 void Metadata::AddNewRecord(const ReportDisk& new_report_disk) {
   DCHECK(new_report_disk.state == ReportState::kPending);
   reports_.push_back(new_report_disk);
+  reports_.back().record_offset = -1;
+  reports_.back().dirty = true;
   dirty_ = true;
 }
 
@@ -402,6 +502,7 @@ OperationStatus Metadata::FindSingleReportAndMarkDirty(
   OperationStatus os = VerifyReport(*report_iter, desired_state);
   if (os == CrashReportDatabase::kNoError) {
     dirty_ = true;
+    report_iter->dirty = true;
     *report_disk = &*report_iter;
   }
   return os;
@@ -416,6 +517,7 @@ OperationStatus Metadata::DeleteReport(const UUID& uuid,
   if (report_iter == reports_.end())
     return CrashReportDatabase::kReportNotFound;
   *report_path = report_iter->file_path;
+  KillRecord(*report_iter);
   reports_.erase(report_iter);
   dirty_ = true;
   return CrashReportDatabase::kNoError;
@@ -425,6 +527,7 @@ int Metadata::CleanDatabase() {
   int removed = 0;
   for (auto report_iter = reports_.begin(); report_iter != reports_.end();) {
     if (!IsRegularFile(report_iter->file_path)) {
+      KillRecord(*report_iter);
       report_iter = reports_.erase(report_iter);
       ++removed;
       dirty_ = true;
@@ -442,6 +545,11 @@ Metadata::Metadata(FileHandle handle,
       report_dir_(report_dir),
       attachments_dir_(attachments_dir),
       dirty_(false),
+      compact_(true),
+      num_records_on_disk_(0),
+      num_dead_records_on_disk_(0),
+      end_offset_(0),
+      dead_record_offsets_(),
       reports_() {}
 
 bool Metadata::Rewind() {
@@ -465,53 +573,246 @@ void Metadata::Read() {
     return;
   }
   if (header.magic != kMetadataFileHeaderMagic ||
-      header.version != kMetadataFileVersion) {
+      (header.version != kMetadataFileVersion1 &&
+       header.version != kMetadataFileVersion)) {
     LOG(ERROR) << "unexpected header";
     return;
   }
 
+  std::vector<ReportDisk> reports;
+  if (header.version == kMetadataFileVersion1) {
+    if (!ReadVersion1(header, &reports))
+      return;
+  } else {
+    if (!ReadVersion2(header, &reports))
+      return;
+    compact_ = false;
+  }
+  reports_.swap(reports);
+}
+
+bool Metadata::ReadVersion1(const MetadataFileHeader& header,
+                            std::vector<ReportDisk>* reports) {
   base::CheckedNumeric<uint32_t> records_size =
       base::CheckedNumeric<uint32_t>(header.num_records) *
       static_cast<uint32_t>(sizeof(MetadataFileReportRecord));
   if (!records_size.IsValid()) {
     LOG(ERROR) << "record size out of range";
-    return;
+    return false;
   }
 
-  std::vector<ReportDisk> reports;
-  if (header.num_records > 0) {
-    std::vector<MetadataFileReportRecord> records(header.num_records);
-    if (!LoggingReadFileExactly(
-            handle_.get(), &records[0], records_size.ValueOrDie())) {
+  if (header.num_records == 0)
+    return true;
+
+  std::vector<MetadataFileReportRecord> records(header.num_records);
+  if (!LoggingReadFileExactly(
+          handle_.get(), &records[0], records_size.ValueOrDie())) {
+    LOG(ERROR) << "failed to read records";
+    return false;
+  }
+
+  std::string string_table = ReadRestOfFileAsString(handle_.get());
+  if (string_table.empty() || string_table.back() != '\0') {
+    LOG(ERROR) << "bad string table";
+    return false;
+  }
+
+  for (const auto& record : records) {
+    if (!AddReportFromRecord(record, string_table, reports))
+      return false;
+  }
+  return true;
+}
+
+bool Metadata::ReadVersion2(const MetadataFileHeader& header,
+                            std::vector<ReportDisk>* reports) {
+  std::string entries = ReadRestOfFileAsString(handle_.get());
+
+  uint32_t num_dead_records = 0;
+  std::vector<FileOffset> dead_record_offsets;
+  std::map<UUID, size_t> report_indices;
+  size_t offset = 0;
+  for (uint32_t index = 0; index < header.num_records; ++index) {
+    MetadataFileReportRecord record;
+    if (entries.size() - offset < sizeof(record)) {
       LOG(ERROR) << "failed to read records";
-      return;
+      return false;
     }
+    memcpy(&record, &entries[offset], sizeof(record));
+    FileOffset record_offset =
+        static_cast<FileOffset>(sizeof(header) + offset);
+    offset += sizeof(record);
 
-    std::string string_table = ReadRestOfFileAsString(handle_.get());
-    if (string_table.empty() || string_table.back() != '\0') {
+    if (record.strings_size == 0 ||
+        entries.size() - offset < record.strings_size) {
       LOG(ERROR) << "bad string table";
-      return;
+      return false;
+    }
+    std::string strings = entries.substr(offset, record.strings_size);
+    offset += record.strings_size;
+    if (strings.back() != '\0') {
+      LOG(ERROR) << "bad string table";
+      return false;
     }
 
-    for (const auto& record : records) {
-      if (record.file_path_index >= string_table.size() ||
-          record.id_index >= string_table.size()) {
-        LOG(ERROR) << "invalid string table index";
-        return;
-      }
-      ReportDisk report_disk(record, report_dir_, string_table);
+    if (record.state == kRecordStateDead) {
+      ++num_dead_records;
+      continue;
+    }
 
-      report_disk.total_size = GetFileSize(report_disk.file_path);
-      base::FilePath report_attachment_dir =
-          attachments_dir_.Append(report_disk.uuid.ToWString());
-      report_disk.total_size += GetDirectorySize(report_attachment_dir);
-      reports.push_back(report_disk);
+    if (!AddReportFromRecord(record, strings, reports))
+      return false;
+    reports->back().record_offset = record_offset;
+    reports->back().record_strings.swap(strings);
+
+    // A report is only written twice if a process was interrupted between
+    // appending a replacement record and making the original record dead.
+    auto inserted = report_indices.insert(
+        std::make_pair(reports->back().uuid, reports->size() - 1));
+    if (!inserted.second) {
+      ReportDisk& superseded = (*reports)[inserted.first->second];
+      dead_record_offsets.push_back(superseded.record_offset);
+      superseded = std::move(reports->back());
+      reports->pop_back();
     }
   }
-  reports_.swap(reports);
+
+  num_records_on_disk_ = header.num_records;
+  num_dead_records_on_disk_ = num_dead_records;
+  end_offset_ = static_cast<FileOffset>(sizeof(header) + offset);
+  dead_record_offsets_.swap(dead_record_offsets);
+  if (!dead_record_offsets_.empty())
+    dirty_ = true;
+  return true;
+}
+
+bool Metadata::AddReportFromRecord(const MetadataFileReportRecord& record,
+                                   const std::string& string_table,
+                                   std::vector<ReportDisk>* reports) {
+  if (record.file_path_index >= string_table.size() ||
+      record.id_index >= string_table.size()) {
+    LOG(ERROR) << "invalid string table index";
+    return false;
+  }
+  ReportDisk report_disk(record, report_dir_, string_table);
+
+  report_disk.total_size = GetFileSize(report_disk.file_path);
+  base::FilePath report_attachment_dir =
+      attachments_dir_.Append(report_disk.uuid.ToWString());
+  report_disk.total_size += GetDirectorySize(report_attachment_dir);
+  reports->push_back(report_disk);
+  return true;
 }
 
 void Metadata::Write() {
+  if (compact_ || !WriteIncremental())
+    Compact();
+}
+
+bool Metadata::WriteIncremental() {
+  std::vector<FileOffset> dead_record_offsets(dead_record_offsets_);
+  std::vector<std::pair<FileOffset, MetadataFileReportRecord>> updates;
+  std::vector<ReportDisk*> appended_reports;
+  std::vector<std::string> appended_strings;
+  std::string appended;
+  for (auto& report : reports_) {
+    if (!report.dirty)
+      continue;
+
+    const base::FilePath& path = report.file_path;
+    if (path.DirName() != report_dir_) {
+      LOG(ERROR) << path << " expected to start with " << report_dir_;
+      return false;
+    }
+
+    std::string strings;
+    MetadataFileReportRecord record = BuildRecordEntry(report, &strings);
+    if (report.record_offset >= 0 && strings == report.record_strings) {
+      updates.push_back(std::make_pair(report.record_offset, record));
+      continue;
+    }
+
+    if (report.record_offset >= 0)
+      dead_record_offsets.push_back(report.record_offset);
+    appended.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    appended += strings;
+    appended_reports.push_back(&report);
+    appended_strings.push_back(std::move(strings));
+  }
+
+  size_t num_dead_records =
+      num_dead_records_on_disk_ + dead_record_offsets.size();
+  if (num_dead_records >= kMetadataCompactionMinimumDeadRecords &&
+      num_dead_records > reports_.size()) {
+    return false;
+  }
+
+  base::CheckedNumeric<uint32_t> num_records = num_records_on_disk_;
+  num_records += appended_reports.size();
+  if (!num_records.IsValid()) {
+    LOG(ERROR) << "record count out of range";
+    return false;
+  }
+
+  // Append new records before counting them in the header, so that an
+  // interrupted write leaves the existing records intact. Records are only
+  // made dead once their replacements are in place.
+  if (!appended.empty()) {
+    if (LoggingSeekFile(handle_.get(), end_offset_, SEEK_SET) != end_offset_ ||
+        !LoggingWriteFile(handle_.get(), appended.data(), appended.size())) {
+      LOG(ERROR) << "failed to append records";
+      return false;
+    }
+
+    MetadataFileHeader header = {0};
+    header.magic = kMetadataFileHeaderMagic;
+    header.version = kMetadataFileVersion;
+    header.num_records = num_records.ValueOrDie();
+    if (!Rewind() ||
+        !LoggingWriteFile(handle_.get(), &header, sizeof(header))) {
+      LOG(ERROR) << "failed to write header";
+      return false;
+    }
+  }
+
+  for (const auto& update : updates) {
+    if (LoggingSeekFile(handle_.get(), update.first, SEEK_SET) !=
+            update.first ||
+        !LoggingWriteFile(
+            handle_.get(), &update.second, sizeof(update.second))) {
+      LOG(ERROR) << "failed to update record";
+      return false;
+    }
+  }
+
+  static constexpr int32_t kDeadState = kRecordStateDead;
+  for (FileOffset record_offset : dead_record_offsets) {
+    FileOffset state_offset =
+        record_offset + offsetof(MetadataFileReportRecord, state);
+    if (LoggingSeekFile(handle_.get(), state_offset, SEEK_SET) !=
+            state_offset ||
+        !LoggingWriteFile(handle_.get(), &kDeadState, sizeof(kDeadState))) {
+      LOG(ERROR) << "failed to update record";
+      return false;
+    }
+  }
+
+  for (size_t index = 0; index < appended_reports.size(); ++index) {
+    appended_reports[index]->record_offset = end_offset_;
+    end_offset_ += sizeof(MetadataFileReportRecord) +
+                   appended_strings[index].size();
+    appended_reports[index]->record_strings.swap(appended_strings[index]);
+  }
+  for (auto& report : reports_)
+    report.dirty = false;
+  num_records_on_disk_ = num_records.ValueOrDie();
+  num_dead_records_on_disk_ = num_dead_records;
+  dead_record_offsets_.clear();
+  dirty_ = false;
+  return true;
+}
+
+void Metadata::Compact() {
   if (!Rewind()) {
     LOG(ERROR) << "failed to rewind to write";
     return;
@@ -539,30 +840,24 @@ void Metadata::Write() {
   if (num_records == 0)
     return;
 
-  // Build the records and string table we're going to write.
-  std::string string_table;
-  std::vector<MetadataFileReportRecord> records;
-  records.reserve(num_records);
+  // Build the log of records and their string tables we're going to write.
+  std::string entries;
+  std::string strings;
   for (const auto& report : reports_) {
     const base::FilePath& path = report.file_path;
     if (path.DirName() != report_dir_) {
       LOG(ERROR) << path << " expected to start with " << report_dir_;
       return;
     }
-    records.push_back(MetadataFileReportRecord(report, &string_table));
+    MetadataFileReportRecord record = BuildRecordEntry(report, &strings);
+    entries.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    entries += strings;
   }
 
-  if (!LoggingWriteFile(handle_.get(),
-                        &records[0],
-                        records.size() * sizeof(MetadataFileReportRecord))) {
+  if (!LoggingWriteFile(handle_.get(), entries.data(), entries.size())) {
     LOG(ERROR) << "failed to write records";
     return;
   }
-  if (!LoggingWriteFile(
-          handle_.get(), string_table.c_str(), string_table.size())) {
-    LOG(ERROR) << "failed to write string table";
-    return;
-  }
 }
 
 // static
@@ -901,6 +1196,7 @@ OperationStatus CrashReportDatabaseWin::SkipReportUpload(
   if (os == kNoError) {
     report_disk->state = ReportState::kCompleted;
     report_disk->upload_explicitly_requested = false;
+    RemoveUploadBodyByUUID(uuid);
   }
   return os;
 }
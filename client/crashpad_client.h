@@ -42,6 +42,12 @@
 #include <ucontext.h>
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_CHROMEOS) || \
+    DOXYGEN
+#include "client/dump_rate_limiter.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID) ||
+        // BUILDFLAG(IS_CHROMEOS) || DOXYGEN
+
 #if BUILDFLAG(IS_IOS)
 #include "client/upload_behavior_ios.h"
 #endif
@@ -157,6 +163,24 @@ class CrashpadClient {
   //!     process ID should be determined by communicating over the socket.
   bool SetHandlerSocket(ScopedFileHandle sock, pid_t pid);
 
+  //! \brief Installs a signal handler to request crash dumps from a pool of
+  //!     Crashpad handlers.
+  //!
+  //! The handler pool must have been started with `--pool-socket`. This
+  //! process connects to the pool only when it crashes, and is served by one
+  //! of the pool's already-initialized handlers, avoiding the cost of
+  //! starting a handler at crash time.
+  //!
+  //! A single handler started with `--listen-socket` is connected to the same
+  //! way, and serves every process that connects to it. Such a handler files
+  //! this process' reports according to the `prod` annotation set by one of
+  //! its modules.
+  //!
+  //! \param[in] socket_path The path given to the handler's `--pool-socket` or
+  //!     `--listen-socket`.
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  bool SetHandlerPoolSocket(const base::FilePath& socket_path);
+
   //! \brief Uses `sigaltstack()` to allocate a signal stack for the calling
   //!     thread.
   //!
@@ -179,6 +203,26 @@ class CrashpadClient {
   //!
   //! \return `true` on success. Otherwise `false` with a message logged.
   static bool InitializeSignalStackForThread();
+
+  //! \brief Sets aside alternate signal stacks for
+  //!     InitializeSignalStackForThread() to hand out.
+  //!
+  //! Without a pool, InitializeSignalStackForThread() maps a stack for each
+  //! thread and unmaps it when the thread exits. A process that creates and
+  //! destroys many short-lived threads, such as one linking
+  //! "client:pthread_create", can call this once, early, so that up to \a
+  //! stack_count threads at a time take a stack that was mapped and faulted in
+  //! ahead of time, and return it to the pool when they exit. Threads beyond
+  //! that fall back to mapping their own stacks.
+  //!
+  //! Threads that already have a signal stack keep it.
+  //!
+  //! \param[in] stack_count The number of stacks to set aside. Each occupies
+  //!     one page more than the signal stack itself.
+  //!
+  //! \return `true` on success. Otherwise `false` with a message logged,
+  //!     including if a pool has already been set aside.
+  static bool ReserveSignalStackPool(size_t stack_count);
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS) || DOXYGEN
 
@@ -421,6 +465,11 @@ class CrashpadClient {
   //!     been a crash.
   //!
   //! A handler must have already been installed before calling this method.
+  //! See EnableForkedDumpWithoutCrash() to avoid pausing this process, and
+  //! DumpWithoutCrashAsync() to avoid blocking the calling thread.
+  //!
+  //! Registered LazyStringAnnotation objects are evaluated on the calling
+  //! thread before the dump is requested, and cleared once it is taken.
   //!
   //! TODO(jperaza): Floating point information in the context is zeroed out
   //! until CaptureContext() supports collecting that information.
@@ -429,6 +478,55 @@ class CrashpadClient {
   //!     CaptureContext() or similar.
   static void DumpWithoutCrash(NativeCPUContext* context);
 
+  //! \brief The type of callback for DumpWithoutCrashAsync().
+  using DumpWithoutCrashCallback = std::function<void()>;
+
+  //! \brief Requests that the handler capture a dump even though there hasn't
+  //!     been a crash, without waiting for the dump.
+  //!
+  //! \a context and the signal information are copied, and, if
+  //! EnableCrashContextCopy() was called, so is the top of the calling thread's
+  //! stack. A thread started for the purpose then requests the dump and waits
+  //! for the handler, while this method returns. The handler reads the rest of
+  //! the calling thread's stack as it is when the handler gets to it, which
+  //! may no longer match \a context, so enabling the copy is recommended.
+  //!
+  //! Only one of these dumps is in progress at a time, which limits the rate
+  //! at which they're taken. Other threads aren't captured cooperatively for
+  //! them, and EnableForkedDumpWithoutCrash() doesn't apply to them.
+  //!
+  //! Registered LazyStringAnnotation objects are evaluated before this method
+  //! returns, and are cleared by the dump thread once the dump is taken.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //!
+  //! \param[in] context A NativeCPUContext, generally captured by
+  //!     CaptureContext() or similar.
+  //! \param[in] callback If not empty, called on the dump thread once the
+  //!     handler is done with this process, whether or not the dump succeeded.
+  //! \return `true` if the dump was requested. `false` if another one
+  //!     requested by this method is still in progress, or with a message
+  //!     logged on failure. \a callback isn't called when this returns
+  //!     `false`.
+  static bool DumpWithoutCrashAsync(NativeCPUContext* context,
+                                    DumpWithoutCrashCallback callback = {});
+
+  //! \brief Limits how often DumpWithoutCrash() and DumpWithoutCrashAsync()
+  //!     request dumps.
+  //!
+  //! Requests are told apart by the address they're made from, and each is
+  //! limited separately by a DumpRateLimiter with \a options. Requests over
+  //! the limits return without contacting the handler. When a request is
+  //! carried out, the number of requests from the same address declined since
+  //! the previous one is recorded in the "dumps_suppressed" annotation, which
+  //! is captured if AnnotationList::Register() has been called.
+  //!
+  //! Dumps are unlimited by default.
+  //!
+  //! \param[in] options The limits to apply.
+  static void SetDumpWithoutCrashLimits(
+      const DumpRateLimiter::Options& options);
+
   //! \brief Disables any installed crash handler, not including any
   //!     FirstChanceHandler and crashes the current process.
   //!
@@ -474,6 +572,90 @@ class CrashpadClient {
                                                             siginfo_t*,
                                                             ucontext_t*));
 
+  //! \brief Copies the crashing thread's state into memory shared with the
+  //!     handler when requesting a crash dump.
+  //!
+  //! The signal handler copies this process' exception information and the
+  //! tops of the crashing thread's current and interrupted stacks, which hold
+  //! its signal information and context. The handler reads those from the copy
+  //! instead of from this process, which is slow while this process waits.
+  //!
+  //! A handler must have already been installed with StartHandler(),
+  //! SetHandlerSocket(), or SetHandlerPoolSocket() before calling this method.
+  //! The copy isn't made for handlers started at crash time, or in children
+  //! forked after this method is called.
+  //!
+  //! \param[in] stack_copy_size The maximum number of bytes to copy from each
+  //!     of the crashing thread's stacks.
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  static bool EnableCrashContextCopy(size_t stack_copy_size);
+
+  //! \brief Preallocates memory for work done in this process while
+  //!     handling a crash.
+  //!
+  //! A handler that doesn't have `ptrace` access to this process has the
+  //! crashing process fork a broker to read its memory and files on the
+  //! handler's behalf. By default, the broker stages that data a page at a
+  //! time, because allocating memory while handling a crash isn't safe. This
+  //! method maps and populates \a size bytes of memory now, which the broker
+  //! uses instead, so that it can serve large reads in fewer system calls.
+  //!
+  //! A handler must have already been installed with StartHandler(),
+  //! SetHandlerSocket(), or SetHandlerPoolSocket() before calling this method.
+  //!
+  //! \param[in] size The size of the reserve, in bytes. This must be no larger
+  //!     than `INT32_MAX`. A reserve of 4096 bytes or fewer isn’t used.
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  static bool EnableCrashReserve(size_t size);
+
+  //! \brief Has this process' other threads capture their own states when
+  //!     requesting a crash dump, so that the handler needn't attach to them.
+  //!
+  //! This enables the copy made by EnableCrashContextCopy(). In addition, the
+  //! signal handler sends \a signo to each of this process' other threads. A
+  //! handler for \a signo, installed by this method, copies the thread's
+  //! interrupted context into memory shared with the handler and blocks the
+  //! thread until the crash dump is complete. Threads that don't respond
+  //! promptly, for example because they have \a signo blocked, are attached to
+  //! by the handler as usual.
+  //!
+  //! This is only supported on x86-64, and for handlers of the same
+  //! architecture as this process.
+  //!
+  //! A handler must have already been installed with StartHandler(),
+  //! SetHandlerSocket(), or SetHandlerPoolSocket() before calling this method.
+  //!
+  //! \param[in] signo A signal reserved for this purpose, for example one of
+  //!     the real-time signals. It mustn't be used for anything else.
+  //! \param[in] max_threads The maximum number of threads whose states can be
+  //!     captured.
+  //! \param[in] stack_copy_size The maximum number of bytes to copy from each
+  //!     of the crashing thread's stacks.
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  static bool EnableCooperativeThreadCapture(int signo,
+                                             size_t max_threads,
+                                             size_t stack_copy_size);
+
+  //! \brief Has DumpWithoutCrash() dump a copy of this process instead of
+  //!     this process itself.
+  //!
+  //! DumpWithoutCrash() normally keeps this process waiting until the handler
+  //! has read everything it needs from it. Once this method is called,
+  //! DumpWithoutCrash() forks a copy of this process instead, which shares its
+  //! memory copy-on-write, and returns as soon as the copy exists. The copy
+  //! requests the dump and exits when the dump is complete, so the time this
+  //! process spends in DumpWithoutCrash() is only that of the fork.
+  //!
+  //! The copy holds only the thread that called DumpWithoutCrash(), so the
+  //! dump has no other threads, and it reports the copy’s process ID. If the
+  //! fork fails, DumpWithoutCrash() dumps this process as usual. Crashes are
+  //! always dumped in place.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //!
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  static bool EnableForkedDumpWithoutCrash();
+
   //! \brief Configures a set of signals that shouldn't have Crashpad signal
   //!     handlers installed.
   //!
@@ -517,6 +699,18 @@ class CrashpadClient {
       const std::map<std::string, std::string>& annotations,
       ProcessPendingReportsObservationCallback callback);
 
+  //! \brief Records the module metadata and annotation locations of each
+  //!     image as dyld loads it, instead of discovering them at crash time.
+  //!
+  //! Writing an intermediate dump otherwise reads and walks the load commands
+  //! of every loaded image from the exception handler. With this enabled,
+  //! only the annotations themselves are read at crash time. The cost is a
+  //! fixed allocation and a short callback on each image load.
+  //!
+  //! This method is only defined on iOS. It may be called before or after
+  //! StartCrashpadInProcessHandler(), and cannot be undone.
+  static void EnableImageAnnotationRegistry();
+
   //! \brief Requests that the handler convert intermediate dumps into
   //!     minidumps and trigger an upload if possible.
   //!
@@ -532,6 +726,26 @@ class CrashpadClient {
   static void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations = {});
 
+  //! \brief Requests that the handler convert intermediate dumps into
+  //!     minidumps on a low-priority background thread, and trigger an upload
+  //!     if possible.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //! Unlike ProcessIntermediateDumps(), this method does not block, and may be
+  //! called on the main UI thread during launch. Conversion stops at the first
+  //! intermediate dump that would begin after \a time_budget_seconds have
+  //! elapsed, so that a backlog left by repeated crashes is spread over later
+  //! launches instead of being converted all at once.
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!     Useful when adding crash annotations detected on the next run after a
+  //!     crash but before upload.
+  //! \param[in] time_budget_seconds The time after which no more intermediate
+  //!     dumps will begin to be converted during this call.
+  static void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations = {},
+      double time_budget_seconds = 1);
+
   //! \brief Requests that the handler convert a single intermediate dump at \a
   //!     file generated by DumpWithoutCrashAndDeferProcessingAtPath into a
   //!     minidump and trigger an upload if possible.
@@ -681,11 +895,25 @@ class CrashpadClient {
   //! function that when reached will "signal and wait" for the crash handler
   //! process to create the dump.
   //!
+  //! If \a asynchronous_registration is `true`, the unhandled exception
+  //! handler is set up right away, and the IPC message exchange is done from a
+  //! background thread, so that this method doesn’t block on the handler,
+  //! making it suitable for use in a `DllMain()`. A crash that occurs before
+  //! the registration completes waits for it, and is then handled as usual, or
+  //! terminates this process without a dump if the registration failed.
+  //! Optionally, use WaitForHandlerStart() to join with the background thread
+  //! and retrieve the status of the registration.
+  //!
   //! \param[in] ipc_pipe The full name of the crash handler IPC pipe. This is
   //!     a string of the form `&quot;\\.\pipe\NAME&quot;`.
-  //!
-  //! \return `true` on success and `false` on failure.
-  bool SetHandlerIPCPipe(const std::wstring& ipc_pipe);
+  //! \param[in] asynchronous_registration If `true`, register with the handler
+  //!     from a background thread.
+  //!
+  //! \return `true` on success and `false` on failure. With
+  //!     \a asynchronous_registration, `true` indicates only that the
+  //!     registration was begun.
+  bool SetHandlerIPCPipe(const std::wstring& ipc_pipe,
+                         bool asynchronous_registration = false);
 
   //! \brief Retrieves the IPC pipe name used to register with the Crashpad
   //!     handler.
@@ -703,17 +931,19 @@ class CrashpadClient {
   //!     `&quot;\\.\pipe\NAME&quot;`.
   std::wstring GetHandlerIPCPipe() const;
 
-  //! \brief When `asynchronous_start` is used with StartHandler(), this method
-  //!     can be used to block until the handler launch has been completed to
-  //!     retrieve status information.
+  //! \brief When `asynchronous_start` is used with StartHandler(), or
+  //!     `asynchronous_registration` with SetHandlerIPCPipe(), this method can
+  //!     be used to block until the handler launch or registration has been
+  //!     completed to retrieve status information.
   //!
-  //! This method should not be used unless `asynchronous_start` was `true`.
+  //! This method should not be used unless `asynchronous_start` or
+  //! `asynchronous_registration` was `true`.
   //!
   //! \param[in] timeout_ms The number of milliseconds to wait for a result from
   //!     the background launch, or `0xffffffff` to block indefinitely.
   //!
-  //! \return `true` if the hander startup succeeded, `false` otherwise, and an
-  //!     error message will have been logged.
+  //! \return `true` if the hander startup or registration succeeded, `false`
+  //!     otherwise, and an error message will have been logged.
   bool WaitForHandlerStart(unsigned int timeout_ms);
 
   //! \brief Register a DLL using WerRegisterExceptionModule().
@@ -734,6 +964,9 @@ class CrashpadClient {
   //! \brief Requests that the handler capture a dump even though there hasn't
   //!     been a crash.
   //!
+  //! Registered LazyStringAnnotation objects are evaluated before the dump is
+  //! requested, and cleared once it is taken.
+  //!
   //! \param[in] context A `CONTEXT`, generally captured by CaptureContext() or
   //!     similar.
   static void DumpWithoutCrash(const CONTEXT& context);
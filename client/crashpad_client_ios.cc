@@ -25,7 +25,9 @@
 #include "base/apple/scoped_mach_port.h"
 #include "base/logging.h"
 #include "client/ios_handler/exception_processor.h"
+#include "client/ios_handler/image_annotation_registry.h"
 #include "client/ios_handler/in_process_handler.h"
+#include "client/lazy_annotation.h"
 #include "util/ios/raw_logging.h"
 #include "util/mach/exc_server_variants.h"
 #include "util/mach/exception_ports.h"
@@ -157,6 +159,13 @@ class CrashHandler : public Thread,
     in_process_handler_.ProcessIntermediateDumps(annotations);
   }
 
+  void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations,
+      double time_budget_seconds) {
+    in_process_handler_.ProcessIntermediateDumpsInBackground(
+        annotations, time_budget_seconds);
+  }
+
   void ProcessIntermediateDump(
       const base::FilePath& file,
       const std::map<std::string, std::string>& annotations) {
@@ -455,6 +464,11 @@ bool CrashpadClient::StartCrashpadInProcessHandler(
   return crash_handler->Initialize(database, url, annotations, callback);
 }
 
+// static
+void CrashpadClient::EnableImageAnnotationRegistry() {
+  internal::ImageAnnotationRegistry::Enable();
+}
+
 // static
 void CrashpadClient::ProcessIntermediateDumps(
     const std::map<std::string, std::string>& annotations) {
@@ -463,6 +477,16 @@ void CrashpadClient::ProcessIntermediateDumps(
   crash_handler->ProcessIntermediateDumps(annotations);
 }
 
+// static
+void CrashpadClient::ProcessIntermediateDumpsInBackground(
+    const std::map<std::string, std::string>& annotations,
+    double time_budget_seconds) {
+  CrashHandler* crash_handler = CrashHandler::Get();
+  DCHECK(crash_handler);
+  crash_handler->ProcessIntermediateDumpsInBackground(annotations,
+                                                      time_budget_seconds);
+}
+
 // static
 void CrashpadClient::ProcessIntermediateDump(
     const base::FilePath& file,
@@ -484,6 +508,7 @@ void CrashpadClient::StartProcessingPendingReports(
 void CrashpadClient::DumpWithoutCrash(NativeCPUContext* context) {
   CrashHandler* crash_handler = CrashHandler::Get();
   DCHECK(crash_handler);
+  internal::ScopedLazyAnnotations lazy_annotations;
   crash_handler->DumpWithoutCrash(context, /*process_dump=*/true);
 }
 
@@ -492,6 +517,7 @@ void CrashpadClient::DumpWithoutCrashAndDeferProcessing(
     NativeCPUContext* context) {
   CrashHandler* crash_handler = CrashHandler::Get();
   DCHECK(crash_handler);
+  internal::ScopedLazyAnnotations lazy_annotations;
   crash_handler->DumpWithoutCrash(context, /*process_dump=*/false);
 }
 
@@ -501,6 +527,7 @@ void CrashpadClient::DumpWithoutCrashAndDeferProcessingAtPath(
     const base::FilePath path) {
   CrashHandler* crash_handler = CrashHandler::Get();
   DCHECK(crash_handler);
+  internal::ScopedLazyAnnotations lazy_annotations;
   crash_handler->DumpWithoutCrashAtPath(context, path);
 }
 
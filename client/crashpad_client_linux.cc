@@ -16,39 +16,56 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <linux/futex.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <sys/prctl.h>
 #include <sys/socket.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include <atomic>
+#include <memory>
+#include <tuple>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
+#include "client/annotation.h"
 #include "client/client_argv_handling.h"
+#include "client/lazy_annotation.h"
+#include "client/signal_stack_pool_linux.h"
 #include "third_party/lss/lss.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
+#include "util/linux/crash_context_region.h"
 #include "util/linux/exception_handler_client.h"
 #include "util/linux/exception_information.h"
 #include "util/linux/scoped_pr_set_dumpable.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
 #include "util/linux/socket.h"
 #include "util/misc/address_sanitizer.h"
+#include "util/misc/clock.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/posix/scoped_mmap.h"
 #include "util/posix/signals.h"
 #include "util/posix/spawn_subprocess.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -161,9 +178,54 @@ class SignalHandler {
     last_chance_handler_ = handler;
   }
 
+  bool EnableCrashContextCopy(size_t stack_copy_size) {
+    return crash_context_.Initialize(stack_copy_size);
+  }
+
+  bool EnableCrashReserve(size_t size) {
+    if (size == 0 || size > size_t{INT32_MAX}) {
+      LOG(ERROR) << "invalid crash reserve size " << size;
+      return false;
+    }
+
+    // The reserve is shared rather than private so that a PtraceBroker forked
+    // while handling a crash writes to the pages populated now instead of
+    // faulting in copies of them.
+    return crash_reserve_.ResetMmap(nullptr,
+                                    size,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_ANONYMOUS | MAP_POPULATE,
+                                    -1,
+                                    0);
+  }
+
+  bool EnableCooperativeThreadCapture(int signo,
+                                      size_t max_threads,
+                                      size_t stack_copy_size) {
+    if (!crash_context_.Initialize(stack_copy_size, max_threads) ||
+        !Signals::InstallHandler(signo,
+                                 HandleThreadCaptureSignal,
+                                 SA_ONSTACK | SA_RESTART,
+                                 nullptr)) {
+      return false;
+    }
+    thread_capture_signal_ = signo;
+    return true;
+  }
+
   // The base implementation for all signal handlers, suitable for calling
   // directly to simulate signal delivery.
   void HandleCrash(int signo, siginfo_t* siginfo, void* context) {
+    CaptureCrashingThread(siginfo, context);
+    if (thread_capture_signal_) {
+      crash_context_.CaptureOtherThreads(thread_capture_signal_);
+    }
+    RequestCapturedDump();
+  }
+
+  // The first part of HandleCrash(), which must run on the crashing thread.
+  // siginfo and context must remain valid until RequestCapturedDump() returns.
+  void CaptureCrashingThread(siginfo_t* siginfo, void* context) {
     exception_information_.siginfo_address =
         FromPointerCast<decltype(exception_information_.siginfo_address)>(
             siginfo);
@@ -171,9 +233,54 @@ class SignalHandler {
         FromPointerCast<decltype(exception_information_.context_address)>(
             context);
     exception_information_.thread_id = sys_gettid();
+    crash_context_.Capture(&exception_information_);
+  }
 
+  // The rest of HandleCrash(), which may run on any thread.
+  void RequestCapturedDump() {
     ScopedPrSetDumpable set_dumpable(false);
     HandleCrashImpl();
+    crash_context_.ResumeOtherThreads();
+  }
+
+  // May be called while other threads are dumping.
+  void EnableForkedDumpWithoutCrash() {
+    fork_for_dump_without_crash_.store(true, std::memory_order_relaxed);
+  }
+
+  // Like HandleCrash(), but for a dump of a copy of this process, forked for
+  // the purpose, if EnableForkedDumpWithoutCrash() was called. Returns as soon
+  // as the copy exists, or false without requesting a dump if it wasn't made.
+  bool HandleCrashInForkedCopy(int signo, siginfo_t* siginfo, void* context) {
+    if (!fork_for_dump_without_crash_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    // The copy that's dumped is a grandchild, orphaned when the intermediate
+    // child exits right away, so that this process neither waits for the dump
+    // nor needs to reap the copy later. siginfo and context are at the same
+    // addresses in the copy.
+    pid_t pid = fork();
+    if (pid < 0) {
+      PLOG(ERROR) << "fork";
+      return false;
+    }
+    if (pid == 0) {
+      pid = fork();
+      if (pid == 0) {
+        HandleCrash(signo, siginfo, context);
+      }
+      _exit(pid < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    int status;
+    if (HANDLE_EINTR(waitpid(pid, &status, 0)) < 0) {
+      PLOG(ERROR) << "waitpid";
+    } else if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      // The copy wasn't made, so nothing requested a dump.
+      return false;
+    }
+    return true;
   }
 
  protected:
@@ -197,6 +304,19 @@ class SignalHandler {
     return exception_information_;
   }
 
+  // Returns the file descriptor of the CrashContextRegion to send with a crash
+  // dump request, or -1 if there is none.
+  int GetCrashContextFD() const { return crash_context_.RequestFD(); }
+
+  // Directs client to stage data in the reserve set up by EnableCrashReserve(),
+  // if there is one.
+  void UseCrashReserve(ExceptionHandlerClient* client) const {
+    if (crash_reserve_.is_valid()) {
+      client->SetBrokerBuffer(crash_reserve_.addr_as<char*>(),
+                              crash_reserve_.len());
+    }
+  }
+
   virtual void HandleCrashImpl() = 0;
 
  private:
@@ -245,6 +365,15 @@ class SignalHandler {
         siginfo, handler_->old_actions_.ActionForSignal(signo));
   }
 
+  // The handler for the signal that EnableCooperativeThreadCapture() sends to
+  // threads other than the crashing thread.
+  static void HandleThreadCaptureSignal(int signo,
+                                        siginfo_t* siginfo,
+                                        void* context) {
+    handler_->crash_context_.CaptureThisThread(
+        static_cast<const ucontext_t*>(context));
+  }
+
   void WaitForDumpDone() {
     kernel_timespec timeout;
     timeout.tv_sec = 5;
@@ -265,9 +394,13 @@ class SignalHandler {
 
   Signals::OldActions old_actions_ = {};
   ExceptionInformation exception_information_ = {};
+  CrashContextRegion crash_context_;
+  ScopedMmap crash_reserve_;
+  int thread_capture_signal_ = 0;
   CrashpadClient::FirstChanceHandler first_chance_handler_ = nullptr;
   LastChanceHandler last_chance_handler_ = nullptr;
   int32_t dump_done_futex_ = kDumpNotDone;
+  std::atomic<bool> fork_for_dump_without_crash_{false};
 #if !defined(__cpp_lib_atomic_value_initialization) || \
     __cpp_lib_atomic_value_initialization < 201911L
   std::atomic_flag disabled_ = ATOMIC_FLAG_INIT;
@@ -305,40 +438,89 @@ class LaunchAtCrashHandler : public SignalHandler {
                                                   &GetExceptionInfo()));
 
     StringVectorToCStringVector(argv_strings_, &argv_);
+
+    // The stack for the handler's child process is allocated now, because
+    // mapping memory while handling a crash may fail.
+    if (!child_stack_.ResetMmap(nullptr,
+                                kChildStackSize,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                                -1,
+                                0)) {
+      return false;
+    }
     return Install(unhandled_signals);
   }
 
   void HandleCrashImpl() override {
     ScopedPrSetPtracer set_ptracer(sys_getpid(), /* may_log= */ false);
 
-    pid_t pid = fork();
+    // fork() would copy this process' page tables, which can take a long time
+    // for a large process, only for them to be discarded by exec. Instead, the
+    // child shares this process' memory until it execs, with this thread
+    // suspended until then. All signals are blocked so that no signal handler
+    // runs in the child while memory is shared.
+    kernel_sigset_t all_signals;
+    sys_sigfillset(&all_signals);
+    sys_sigprocmask(SIG_SETMASK, &all_signals, &old_signal_mask_);
+
+    pid_t pid = clone(ExecHandler,
+                      child_stack_.addr_as<char*>() + kChildStackSize,
+                      CLONE_VM | CLONE_VFORK | SIGCHLD,
+                      this);
+
+    sys_sigprocmask(SIG_SETMASK, &old_signal_mask_, nullptr);
     if (pid < 0) {
       return;
     }
-    if (pid == 0) {
-      if (set_envp_) {
-        execve(argv_[0],
-               const_cast<char* const*>(argv_.data()),
-               const_cast<char* const*>(envp_.data()));
-      } else {
-        execv(argv_[0], const_cast<char* const*>(argv_.data()));
-      }
-      _exit(EXIT_FAILURE);
-    }
 
     int status;
     waitpid(pid, &status, 0);
   }
 
  private:
+  static constexpr size_t kChildStackSize = 64 * 1024;
+
   LaunchAtCrashHandler() = default;
 
   ~LaunchAtCrashHandler() = delete;
 
+  // Runs in the child on child_stack_, sharing the parent's memory, so it must
+  // not modify anything the parent relies on.
+  static int ExecHandler(void* arg) {
+    auto handler = static_cast<LaunchAtCrashHandler*>(arg);
+
+    // Signal dispositions are not shared with the parent. Reset any caught
+    // signal to its default before unblocking signals, so that a handler
+    // installed by the parent can't run here.
+    for (int signo = 1; signo < NSIG; ++signo) {
+      struct kernel_sigaction action;
+      if (sys_sigaction(signo, nullptr, &action) == 0 &&
+          action.sa_handler_ != SIG_DFL && action.sa_handler_ != SIG_IGN) {
+        memset(&action, 0, sizeof(action));
+        action.sa_handler_ = SIG_DFL;
+        sys_sigaction(signo, &action, nullptr);
+      }
+    }
+    sys_sigprocmask(SIG_SETMASK, &handler->old_signal_mask_, nullptr);
+
+    if (handler->set_envp_) {
+      execve(handler->argv_[0],
+             const_cast<char* const*>(handler->argv_.data()),
+             const_cast<char* const*>(handler->envp_.data()));
+    } else {
+      execv(handler->argv_[0],
+            const_cast<char* const*>(handler->argv_.data()));
+    }
+    _exit(EXIT_FAILURE);
+  }
+
   std::vector<std::string> argv_strings_;
   std::vector<const char*> argv_;
   std::vector<std::string> envp_strings_;
   std::vector<const char*> envp_;
+  ScopedMmap child_stack_;
+  kernel_sigset_t old_signal_mask_;
   bool set_envp_ = false;
 };
 
@@ -379,6 +561,11 @@ class RequestCrashDumpHandler : public SignalHandler {
     }
     sock_to_handler_.reset(sock.release());
     handler_pid_ = pid;
+
+    // The request only refers to state that lives as long as this object, so
+    // it's built now and HandleCrashImpl() just needs to send it.
+    crash_info_.exception_information_address =
+        FromPointerCast<VMAddress>(&GetExceptionInfo());
     return Install(unhandled_signals);
   }
 
@@ -403,20 +590,15 @@ class RequestCrashDumpHandler : public SignalHandler {
       sys_prctl(PR_SET_PTRACER, handler_pid_, 0, 0, 0);
     }
 
-    ExceptionHandlerProtocol::ClientInformation info = {};
-    info.exception_information_address =
-        FromPointerCast<VMAddress>(&GetExceptionInfo());
-#if BUILDFLAG(IS_CHROMEOS_ASH)
-    info.crash_loop_before_time = crash_loop_before_time_;
-#endif
-
     ExceptionHandlerClient client(sock_to_handler_.get(), true);
-    client.RequestCrashDump(info);
+    client.SetCrashContextFD(GetCrashContextFD());
+    UseCrashReserve(&client);
+    client.RequestCrashDump(crash_info_);
   }
 
 #if BUILDFLAG(IS_CHROMEOS_ASH)
   void SetCrashLoopBefore(uint64_t crash_loop_before_time) {
-    crash_loop_before_time_ = crash_loop_before_time;
+    crash_info_.crash_loop_before_time = crash_loop_before_time;
   }
 #endif
 
@@ -436,15 +618,186 @@ class RequestCrashDumpHandler : public SignalHandler {
   ScopedFileHandle sock_to_handler_;
   pid_t handler_pid_ = -1;
 
-#if BUILDFLAG(IS_CHROMEOS_ASH)
-  // An optional UNIX timestamp passed to us from Chrome.
-  // This will pass to crashpad_handler and then to Chrome OS crash_reporter.
-  // This should really be a time_t, but it's basically an opaque value (we
-  // don't anything with it except pass it along).
-  uint64_t crash_loop_before_time_ = 0;
-#endif
+  // The information sent with every dump request. On Chrome OS, this includes
+  // an optional UNIX timestamp passed to us from Chrome, which will pass to
+  // crashpad_handler and then to Chrome OS crash_reporter. That should really
+  // be a time_t, but it's basically an opaque value (we don't do anything with
+  // it except pass it along).
+  ExceptionHandlerProtocol::ClientInformation crash_info_ = {};
+};
+
+// Connects to a handler pool to request a dump, so that a handler is only
+// assigned to this process if it crashes.
+class ConnectAtCrashHandler : public SignalHandler {
+ public:
+  ConnectAtCrashHandler(const ConnectAtCrashHandler&) = delete;
+  ConnectAtCrashHandler& operator=(const ConnectAtCrashHandler&) = delete;
+
+  static ConnectAtCrashHandler* Get() {
+    static ConnectAtCrashHandler* instance = new ConnectAtCrashHandler();
+    return instance;
+  }
+
+  bool Initialize(const base::FilePath& socket_path,
+                  const std::set<int>* unhandled_signals) {
+    const std::string& path = socket_path.value();
+    if (path.empty() || path.size() >= sizeof(address_.sun_path)) {
+      LOG(ERROR) << "invalid socket path " << path;
+      return false;
+    }
+    address_.sun_family = AF_UNIX;
+    memcpy(address_.sun_path, path.c_str(), path.size() + 1);
+    return Install(unhandled_signals);
+  }
+
+  void HandleCrashImpl() override {
+    ScopedFileHandle sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+    if (!sock.is_valid() ||
+        HANDLE_EINTR(connect(sock.get(),
+                             reinterpret_cast<const sockaddr*>(&address_),
+                             sizeof(address_))) != 0) {
+      return;
+    }
+
+    ExceptionHandlerProtocol::ClientInformation info = {};
+    info.exception_information_address =
+        FromPointerCast<VMAddress>(&GetExceptionInfo());
+
+    ExceptionHandlerClient client(sock.get(), false);
+    client.SetCrashContextFD(GetCrashContextFD());
+    UseCrashReserve(&client);
+    client.RequestCrashDump(info);
+  }
+
+ private:
+  ConnectAtCrashHandler() = default;
+
+  ~ConnectAtCrashHandler() = delete;
+
+  sockaddr_un address_ = {};
+};
+
+// Requests the dumps made by DumpWithoutCrashAsync(), so that the threads
+// asking for them needn't wait for the handler.
+class AsyncDumpThread : public Thread {
+ public:
+  AsyncDumpThread(const AsyncDumpThread&) = delete;
+  AsyncDumpThread& operator=(const AsyncDumpThread&) = delete;
+
+  static AsyncDumpThread* Get() {
+    static AsyncDumpThread* instance = new AsyncDumpThread();
+    return instance;
+  }
+
+  // Returns false without doing anything if a previous dump is in progress.
+  bool Request(const NativeCPUContext& context,
+               CrashpadClient::DumpWithoutCrashCallback callback) {
+    if (busy_.exchange(true)) {
+      return false;
+    }
+
+    // The thread is only started when first needed. busy_ keeps this from
+    // racing with another request.
+    if (!started_) {
+      Start();
+      started_ = true;
+    }
+
+    context_ = context;
+    siginfo_ = {};
+    siginfo_.si_signo = Signals::kSimulatedSigno;
+    callback_ = std::move(callback);
+    SignalHandler::Get()->CaptureCrashingThread(&siginfo_, &context_);
+    requested_.Signal();
+    return true;
+  }
+
+ private:
+  AsyncDumpThread() : Thread() {}
+
+  // The instance is never destroyed, because the thread never exits.
+  ~AsyncDumpThread() override = default;
+
+  void ThreadMain() override {
+    while (true) {
+      requested_.Wait();
+      SignalHandler::Get()->RequestCapturedDump();
+      internal::ReleaseLazyAnnotations();
+
+      CrashpadClient::DumpWithoutCrashCallback callback = std::move(callback_);
+      callback_ = nullptr;
+      busy_ = false;
+      if (callback) {
+        callback();
+      }
+    }
+  }
+
+  // The dump's copies of the caller's context and signal information, which
+  // must outlive the call that provided them.
+  NativeCPUContext context_ = {};
+  siginfo_t siginfo_ = {};
+  CrashpadClient::DumpWithoutCrashCallback callback_;
+  Semaphore requested_{0};
+  std::atomic<bool> busy_{false};
+  bool started_ = false;
 };
 
+DumpRateLimiter* DumpWithoutCrashLimiter() {
+  static DumpRateLimiter* limiter = new DumpRateLimiter();
+  return limiter;
+}
+
+// Returns whether a dump requested from caller should be taken, recording the
+// requests declined since the last one if so.
+bool ShouldDumpWithoutCrash(const void* caller) {
+  uint64_t suppressed;
+  if (!DumpWithoutCrashLimiter()->ShouldDump(FromPointerCast<uint64_t>(caller),
+                                             ClockMonotonicNanoseconds(),
+                                             &suppressed)) {
+    return false;
+  }
+
+  // Requests may be made on several threads at once, so updates to the
+  // annotation are serialized.
+  static base::Lock* suppressed_annotation_lock = new base::Lock();
+  static StringAnnotation<24> suppressed_annotation("dumps_suppressed");
+  base::AutoLock lock(*suppressed_annotation_lock);
+  if (suppressed > 0) {
+    suppressed_annotation.Set(base::StringPrintf("%" PRIu64, suppressed));
+  } else {
+    suppressed_annotation.Clear();
+  }
+  return true;
+}
+
+// Clears the parts of context that CaptureContext() doesn't populate.
+void PrepareContextForDump(NativeCPUContext* context) {
+#if defined(ARCH_CPU_ARMEL)
+  memset(context->uc_regspace, 0, sizeof(context->uc_regspace));
+#elif defined(ARCH_CPU_ARM64)
+  memset(context->uc_mcontext.__reserved,
+         0,
+         sizeof(context->uc_mcontext.__reserved));
+#endif
+}
+
+// The size of the alternate signal stack that InitializeSignalStackForThread()
+// installs, not including its guard pages.
+size_t SignalStackSize() {
+  const size_t page_size = getpagesize();
+  const size_t stack_size = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
+#if defined(ADDRESS_SANITIZER)
+  return 2 * stack_size;
+#else
+  return stack_size;
+#endif  // ADDRESS_SANITIZER
+}
+
+// Set once by ReserveSignalStackPool(), and never freed, because threads
+// return their stacks to it as they exit.
+std::atomic<SignalStackPool*> g_signal_stack_pool;
+
 }  // namespace
 
 CrashpadClient::CrashpadClient() {}
@@ -501,6 +854,11 @@ bool CrashpadClient::SetHandlerSocket(ScopedFileHandle sock, pid_t pid) {
   return signal_handler->Initialize(std::move(sock), pid, &unhandled_signals_);
 }
 
+bool CrashpadClient::SetHandlerPoolSocket(const base::FilePath& socket_path) {
+  auto signal_handler = ConnectAtCrashHandler::Get();
+  return signal_handler->Initialize(socket_path, &unhandled_signals_);
+}
+
 // static
 bool CrashpadClient::InitializeSignalStackForThread() {
   stack_t stack;
@@ -512,25 +870,14 @@ bool CrashpadClient::InitializeSignalStackForThread() {
   DCHECK_EQ(stack.ss_flags & SS_ONSTACK, 0);
 
   const size_t page_size = getpagesize();
-#if defined(ADDRESS_SANITIZER)
-  const size_t kStackSize = 2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-  const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
+  const size_t kStackSize = SignalStackSize();
   if (stack.ss_flags & SS_DISABLE || stack.ss_size < kStackSize) {
     const size_t kGuardPageSize = page_size;
     const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
 
     static void (*stack_destructor)(void*) = [](void* stack_mem) {
-      const size_t page_size = getpagesize();
-      const size_t kGuardPageSize = page_size;
-#if defined(ADDRESS_SANITIZER)
-      const size_t kStackSize =
-          2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-      const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
-      const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
+      const size_t kGuardPageSize = getpagesize();
+      const size_t kStackAllocSize = SignalStackSize() + 2 * kGuardPageSize;
 
       stack_t stack;
       stack.ss_flags = SS_DISABLE;
@@ -541,7 +888,11 @@ bool CrashpadClient::InitializeSignalStackForThread() {
         PLOG_IF(ERROR, sigaltstack(&stack, nullptr) != 0) << "sigaltstack";
       }
 
-      if (munmap(stack_mem, kStackAllocSize) != 0) {
+      SignalStackPool* pool =
+          g_signal_stack_pool.load(std::memory_order_acquire);
+      if (pool && pool->Contains(stack_mem)) {
+        pool->Release(stack_mem);
+      } else if (munmap(stack_mem, kStackAllocSize) != 0) {
         PLOG(ERROR) << "munmap";
       }
     };
@@ -557,6 +908,17 @@ bool CrashpadClient::InitializeSignalStackForThread() {
     }
 
     auto old_stack = static_cast<char*>(pthread_getspecific(stack_key));
+    SignalStackPool* pool = g_signal_stack_pool.load(std::memory_order_acquire);
+    if (!old_stack && pool) {
+      // A pooled stack is already faulted in, and the destructor returns it to
+      // the pool instead of unmapping it.
+      old_stack = static_cast<char*>(pool->Acquire());
+      if (old_stack) {
+        errno = pthread_setspecific(stack_key, old_stack);
+        PCHECK(errno == 0) << "pthread_setspecific";
+      }
+    }
+
     if (old_stack) {
       stack.ss_sp = old_stack + kGuardPageSize;
     } else {
@@ -579,6 +941,13 @@ bool CrashpadClient::InitializeSignalStackForThread() {
 
       stack.ss_sp = stack_mem.addr_as<char*>() + kGuardPageSize;
 
+      // Fault the stack in now. Otherwise, a crashing thread takes a page fault
+      // for each page of the stack the signal handler touches, and may find
+      // that there is no memory left to back them.
+      for (size_t offset = 0; offset < kStackSize; offset += page_size) {
+        static_cast<volatile char*>(stack.ss_sp)[offset] = 0;
+      }
+
       errno = pthread_setspecific(stack_key, stack_mem.release());
       PCHECK(errno == 0) << "pthread_setspecific";
     }
@@ -593,6 +962,29 @@ bool CrashpadClient::InitializeSignalStackForThread() {
   }
   return true;
 }
+
+// static
+bool CrashpadClient::ReserveSignalStackPool(size_t stack_count) {
+  if (g_signal_stack_pool.load(std::memory_order_acquire)) {
+    LOG(ERROR) << "signal stack pool already reserved";
+    return false;
+  }
+
+  // The pool is only published once it’s initialized, so that a reservation
+  // that fails may be tried again.
+  auto pool = std::make_unique<SignalStackPool>();
+  if (!pool->Initialize(stack_count, SignalStackSize())) {
+    return false;
+  }
+  SignalStackPool* expected = nullptr;
+  if (!g_signal_stack_pool.compare_exchange_strong(
+          expected, pool.get(), std::memory_order_release)) {
+    LOG(ERROR) << "signal stack pool already reserved";
+    return false;
+  }
+  std::ignore = pool.release();
+  return true;
+}
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
 
@@ -723,22 +1115,54 @@ void CrashpadClient::DumpWithoutCrash(NativeCPUContext* context) {
     return;
   }
 
-#if defined(ARCH_CPU_ARMEL)
-  memset(context->uc_regspace, 0, sizeof(context->uc_regspace));
-#elif defined(ARCH_CPU_ARM64)
-  memset(context->uc_mcontext.__reserved,
-         0,
-         sizeof(context->uc_mcontext.__reserved));
-#endif
+  if (!ShouldDumpWithoutCrash(__builtin_return_address(0))) {
+    return;
+  }
+
+  PrepareContextForDump(context);
+  internal::ScopedLazyAnnotations lazy_annotations;
 
   siginfo_t siginfo;
   siginfo.si_signo = Signals::kSimulatedSigno;
   siginfo.si_errno = 0;
   siginfo.si_code = 0;
+  if (SignalHandler::Get()->HandleCrashInForkedCopy(
+          siginfo.si_signo, &siginfo, reinterpret_cast<void*>(context))) {
+    return;
+  }
   SignalHandler::Get()->HandleCrash(
       siginfo.si_signo, &siginfo, reinterpret_cast<void*>(context));
 }
 
+// static
+bool CrashpadClient::DumpWithoutCrashAsync(NativeCPUContext* context,
+                                           DumpWithoutCrashCallback callback) {
+  if (!SignalHandler::Get()) {
+    LOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+
+  if (!ShouldDumpWithoutCrash(__builtin_return_address(0))) {
+    return false;
+  }
+
+  PrepareContextForDump(context);
+
+  // The dump thread releases the lazy annotations once it has taken the dump.
+  internal::EvaluateLazyAnnotations();
+  if (!AsyncDumpThread::Get()->Request(*context, std::move(callback))) {
+    internal::ReleaseLazyAnnotations();
+    return false;
+  }
+  return true;
+}
+
+// static
+void CrashpadClient::SetDumpWithoutCrashLimits(
+    const DumpRateLimiter::Options& options) {
+  DumpWithoutCrashLimiter()->SetOptions(options);
+}
+
 // static
 void CrashpadClient::CrashWithoutDump(const std::string& message) {
   SignalHandler::Disable();
@@ -758,6 +1182,46 @@ void CrashpadClient::SetLastChanceExceptionHandler(LastChanceHandler handler) {
   SignalHandler::Get()->SetLastChanceExceptionHandler(handler);
 }
 
+// static
+bool CrashpadClient::EnableCrashContextCopy(size_t stack_copy_size) {
+  if (!SignalHandler::Get()) {
+    LOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+  return SignalHandler::Get()->EnableCrashContextCopy(stack_copy_size);
+}
+
+// static
+bool CrashpadClient::EnableCrashReserve(size_t size) {
+  if (!SignalHandler::Get()) {
+    LOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+  return SignalHandler::Get()->EnableCrashReserve(size);
+}
+
+// static
+bool CrashpadClient::EnableCooperativeThreadCapture(int signo,
+                                                    size_t max_threads,
+                                                    size_t stack_copy_size) {
+  if (!SignalHandler::Get()) {
+    LOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+  return SignalHandler::Get()->EnableCooperativeThreadCapture(
+      signo, max_threads, stack_copy_size);
+}
+
+// static
+bool CrashpadClient::EnableForkedDumpWithoutCrash() {
+  if (!SignalHandler::Get()) {
+    LOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+  SignalHandler::Get()->EnableForkedDumpWithoutCrash();
+  return true;
+}
+
 void CrashpadClient::SetUnhandledSignals(const std::set<int>& signals) {
   DCHECK(!SignalHandler::Get());
   unhandled_signals_ = signals;
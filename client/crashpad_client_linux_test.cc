@@ -51,6 +51,7 @@
 #include "util/misc/memory_sanitizer.h"
 #include "util/posix/scoped_mmap.h"
 #include "util/posix/signals.h"
+#include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_ANDROID)
@@ -83,6 +84,10 @@ struct StartHandlerForSelfTestOptions {
   bool client_uses_signals;
   bool gather_indirectly_referenced_memory;
   CrashType crash_type;
+
+  // Not varied by StartHandlerForSelfTest.
+  bool fork_for_dump_without_crash;
+  bool dump_without_crash_async;
 };
 
 class StartHandlerForSelfTest
@@ -424,13 +429,27 @@ CRASHPAD_CHILD_TEST_MAIN(StartHandlerForSelfTestChild) {
     client.SetLastChanceExceptionHandler(HandleCrashSuccessfullyAfterReporting);
   }
 
+  if (options.fork_for_dump_without_crash &&
+      !CrashpadClient::EnableForkedDumpWithoutCrash()) {
+    return EXIT_FAILURE;
+  }
+
 #if BUILDFLAG(IS_ANDROID)
   if (android_set_abort_message) {
     android_set_abort_message(kTestAbortMessage);
   }
 #endif
 
-  if (options.crash_non_main_thread) {
+  if (options.dump_without_crash_async) {
+    NativeCPUContext context;
+    CaptureContext(&context);
+    Semaphore done(0);
+    if (!CrashpadClient::DumpWithoutCrashAsync(&context,
+                                               [&done]() { done.Signal(); })) {
+      return EXIT_FAILURE;
+    }
+    done.Wait();
+  } else if (options.crash_non_main_thread) {
     CrashThread thread(options, &client);
     thread.Start();
     thread.Join();
@@ -600,6 +619,26 @@ INSTANTIATE_TEST_SUITE_P(
                                      CrashType::kSegvWithTagBits,
                                      CrashType::kFakeSegv)));
 
+TEST(CrashpadClient, ForkedDumpWithoutCrash) {
+  // The forked copy holds this pipe open until its dump is complete, so the
+  // report is in the database once the child's output reaches EOF.
+  StartHandlerForSelfTestOptions options;
+  memset(&options, 0, sizeof(options));
+  options.crash_type = CrashType::kSimulated;
+  options.fork_for_dump_without_crash = true;
+  StartHandlerForSelfInChildTest test(options);
+  test.Run();
+}
+
+TEST(CrashpadClient, DumpWithoutCrashAsync) {
+  StartHandlerForSelfTestOptions options;
+  memset(&options, 0, sizeof(options));
+  options.crash_type = CrashType::kSimulated;
+  options.dump_without_crash_async = true;
+  StartHandlerForSelfInChildTest test(options);
+  test.Run();
+}
+
 // Test state for starting the handler for another process.
 class StartHandlerForClientTest {
  public:
@@ -783,6 +822,36 @@ TEST(CrashpadClient, SanitizedChild) {
   test.Run();
 }
 
+#if defined(ARCH_CPU_64_BITS)
+// The pool is reserved once per process, so this is tested in a child.
+class ReserveSignalStackPoolTest : public Multiprocess {
+ public:
+  ReserveSignalStackPoolTest() = default;
+
+  ReserveSignalStackPoolTest(const ReserveSignalStackPoolTest&) = delete;
+  ReserveSignalStackPoolTest& operator=(const ReserveSignalStackPoolTest&) =
+      delete;
+
+  ~ReserveSignalStackPoolTest() = default;
+
+ private:
+  void MultiprocessParent() override {}
+
+  void MultiprocessChild() override {
+    // So many stacks don’t fit in the address space, but a failed reservation
+    // can be tried again.
+    EXPECT_FALSE(CrashpadClient::ReserveSignalStackPool(size_t{1} << 40));
+    EXPECT_TRUE(CrashpadClient::ReserveSignalStackPool(2));
+    EXPECT_FALSE(CrashpadClient::ReserveSignalStackPool(2));
+  }
+};
+
+TEST(CrashpadClient, ReserveSignalStackPoolRetry) {
+  ReserveSignalStackPoolTest test;
+  test.Run();
+}
+#endif  // ARCH_CPU_64_BITS
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
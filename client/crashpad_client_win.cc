@@ -32,6 +32,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
+#include "client/lazy_annotation.h"
 #include "util/file/file_io.h"
 #include "util/misc/capture_context.h"
 #include "util/misc/from_pointer_cast.h"
@@ -97,6 +98,11 @@ enum class StartupState : int {
 // until one of those two cases happens.
 base::subtle::AtomicWord g_handler_startup_state;
 
+// Set when SetHandlerIPCPipe() registers with the handler from a background
+// thread. Until that registration completes, g_signal_exception is not yet
+// valid, and crashes wait for it in UnhandledExceptionHandler().
+bool g_asynchronous_registration = false;
+
 // A CRITICAL_SECTION initialized with
 // RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO to force it to be allocated with a
 // valid .DebugInfo field. The address of this critical section is given to the
@@ -576,6 +582,41 @@ DWORD WINAPI BackgroundHandlerStartThreadProc(void* data) {
   return StartHandlerProcess(std::move(data_as_ptr)) ? 0 : 1;
 }
 
+struct BackgroundRegistrationThreadData {
+  std::wstring ipc_pipe;
+  ClientToServerMessage message;
+};
+
+// Registers this process with the handler listening at ipc_pipe, and stores the
+// events that it returns. The startup state is left for the caller to set, once
+// the events are in place.
+bool RegisterWithHandler(const std::wstring& ipc_pipe,
+                         const ClientToServerMessage& message) {
+  ServerToClientMessage response = {};
+  if (!SendToCrashHandlerServer(ipc_pipe, message, &response)) {
+    return false;
+  }
+
+  // The server returns these already duplicated to be valid in this process.
+  g_signal_exception =
+      IntToHandle(response.registration.request_crash_dump_event);
+  g_wer_registration.dump_without_crashing =
+      IntToHandle(response.registration.request_non_crash_dump_event);
+  g_wer_registration.dump_completed =
+      IntToHandle(response.registration.non_crash_dump_completed_event);
+  return true;
+}
+
+DWORD WINAPI BackgroundRegistrationThreadProc(void* data) {
+  std::unique_ptr<BackgroundRegistrationThreadData> data_as_ptr(
+      reinterpret_cast<BackgroundRegistrationThreadData*>(data));
+  const bool registered =
+      RegisterWithHandler(data_as_ptr->ipc_pipe, data_as_ptr->message);
+  SetHandlerStartupState(registered ? StartupState::kSucceeded
+                                    : StartupState::kFailed);
+  return registered ? 0 : 1;
+}
+
 void CommonInProcessInitialization() {
   // We create this dummy CRITICAL_SECTION with the
   // RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO flag set to have an entry point
@@ -703,7 +744,8 @@ void CrashpadClient::RegisterHandlers() {
   DCHECK_NE(rv, SIG_ERR);
 }
 
-bool CrashpadClient::SetHandlerIPCPipe(const std::wstring& ipc_pipe) {
+bool CrashpadClient::SetHandlerIPCPipe(const std::wstring& ipc_pipe,
+                                       bool asynchronous_registration) {
   DCHECK(ipc_pipe_.empty());
   DCHECK(!ipc_pipe.empty());
 
@@ -731,9 +773,33 @@ bool CrashpadClient::SetHandlerIPCPipe(const std::wstring& ipc_pipe) {
   message.registration.critical_section_address =
       FromPointerCast<WinVMAddress>(&g_critical_section_with_debug_info);
 
-  ServerToClientMessage response = {};
+  if (asynchronous_registration) {
+    // The handlers are installed right away, and a crash that occurs before
+    // the background thread has registered waits for it to finish. As with
+    // StartHandler(), the background thread must not be waited upon here, so
+    // that this can be called inside a DllMain().
+    g_asynchronous_registration = true;
+    RegisterHandlers();
+
+    auto data = new BackgroundRegistrationThreadData();
+    data->ipc_pipe = ipc_pipe_;
+    data->message = message;
+    handler_start_thread_.reset(CreateThread(nullptr,
+                                             0,
+                                             &BackgroundRegistrationThreadProc,
+                                             reinterpret_cast<void*>(data),
+                                             0,
+                                             nullptr));
+    if (!handler_start_thread_.is_valid()) {
+      PLOG(ERROR) << "CreateThread";
+      delete data;
+      SetHandlerStartupState(StartupState::kFailed);
+      return false;
+    }
+    return true;
+  }
 
-  if (!SendToCrashHandlerServer(ipc_pipe_, message, &response)) {
+  if (!RegisterWithHandler(ipc_pipe_, message)) {
     return false;
   }
 
@@ -741,14 +807,6 @@ bool CrashpadClient::SetHandlerIPCPipe(const std::wstring& ipc_pipe) {
 
   RegisterHandlers();
 
-  // The server returns these already duplicated to be valid in this process.
-  g_signal_exception =
-      IntToHandle(response.registration.request_crash_dump_event);
-  g_wer_registration.dump_without_crashing =
-      IntToHandle(response.registration.request_non_crash_dump_event);
-  g_wer_registration.dump_completed =
-      IntToHandle(response.registration.non_crash_dump_completed_event);
-
   return true;
 }
 
@@ -823,6 +881,7 @@ void CrashpadClient::DumpWithoutCrash(const CONTEXT& context) {
   // because another thread’s crash processing finished and the process was
   // terminated before this thread’s non-crash processing could be completed.
   base::AutoLock lock(*g_non_crash_dump_lock);
+  internal::ScopedLazyAnnotations lazy_annotations;
 
   // Create a fake EXCEPTION_POINTERS to give the handler something to work
   // with.
@@ -861,7 +920,8 @@ void CrashpadClient::DumpWithoutCrash(const CONTEXT& context) {
 
 // static
 void CrashpadClient::DumpAndCrash(EXCEPTION_POINTERS* exception_pointers) {
-  if (g_signal_exception == INVALID_HANDLE_VALUE) {
+  if (g_signal_exception == INVALID_HANDLE_VALUE &&
+      !g_asynchronous_registration) {
     LOG(ERROR) << "not connected";
     SafeTerminateProcess(GetCurrentProcess(),
                          kTerminationCodeNotConnectedToHandler);
@@ -14,6 +14,7 @@
 
 #include "client/crashpad_client.h"
 
+#include <string>
 #include <vector>
 
 #include "base/files/file_path.h"
@@ -192,6 +193,34 @@ TEST(CrashpadClient, HandlerLaunchFailureDumpWithoutCrash) {
   WinMultiprocess::Run<HandlerLaunchFailureDumpWithoutCrash>();
 }
 
+class AsynchronousRegistrationFailureDumpAndCrash : public WinMultiprocess {
+ public:
+  AsynchronousRegistrationFailureDumpAndCrash() : WinMultiprocess() {}
+
+ private:
+  void WinMultiprocessParent() override {
+    SetExpectedChildExitCode(crashpad::kTerminationCodeCrashNoDump);
+  }
+
+  void WinMultiprocessChild() override {
+    // No handler is listening on this pipe, so the registration fails. The
+    // crash requested before that's known waits for it, and is then not
+    // dumped.
+    CrashpadClient client;
+    ASSERT_TRUE(client.SetHandlerIPCPipe(
+        L"\\\\.\\pipe\\crashpad_no_handler_" +
+            std::to_wstring(GetCurrentProcessId()),
+        true));
+    EXCEPTION_POINTERS info = {};
+    client.DumpAndCrash(&info);
+    exit(0);
+  }
+};
+
+TEST(CrashpadClient, AsynchronousRegistrationFailureDumpAndCrash) {
+  WinMultiprocess::Run<AsynchronousRegistrationFailureDumpAndCrash>();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -137,7 +137,11 @@ CrashpadInfo::CrashpadInfo()
       extra_memory_ranges_(nullptr),
       simple_annotations_(nullptr),
       user_data_minidump_stream_head_(nullptr),
-      annotations_list_(nullptr) {}
+      annotations_list_(nullptr),
+      thread_breadcrumbs_(nullptr),
+      indexed_simple_annotations_(nullptr),
+      capture_hints_(nullptr),
+      indexed_extra_memory_ranges_(nullptr) {}
 
 UserDataMinidumpStreamHandle* CrashpadInfo::AddUserDataMinidumpStream(
     uint32_t stream_type,
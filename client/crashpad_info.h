@@ -19,6 +19,9 @@
 
 #include "build/build_config.h"
 #include "client/annotation_list.h"
+#include "client/capture_hints.h"
+#include "client/indexed_address_range_bag.h"
+#include "client/indexed_simple_string_dictionary.h"
 #include "client/simple_address_range_bag.h"
 #include "client/simple_string_dictionary.h"
 #include "util/misc/tri_state.h"
@@ -29,6 +32,8 @@
 
 namespace crashpad {
 
+class ThreadBreadcrumbList;
+
 namespace internal {
 
 #if BUILDFLAG(IS_IOS)
@@ -91,6 +96,29 @@ struct CrashpadInfo {
     extra_memory_ranges_ = address_range_bag;
   }
 
+  //! \brief Sets an additional bag of extra memory ranges to be included in
+  //!     the snapshot, indexed for fast updates.
+  //!
+  //! This is an alternative to set_extra_memory_ranges() for clients that have
+  //! more ranges than a SimpleAddressRangeBag can hold, or that insert and
+  //! remove ranges frequently. The capacity of the bag is chosen by its
+  //! template parameter, and is recorded in the bag for the handler. As with
+  //! set_extra_memory_ranges(), ranges may be added or removed after this
+  //! method is called.
+  //!
+  //! This is currently only supported on Linux, ChromeOS, and Android.
+  //!
+  //! \param[in] address_range_bag A bag of address ranges, or `nullptr`. The
+  //!     CrashpadInfo object does not take ownership of the bag. It is the
+  //!     caller’s responsibility to ensure that this pointer remains valid
+  //!     while it is in effect for a CrashpadInfo object.
+  template <size_t NumEntries>
+  void set_indexed_extra_memory_ranges(
+      TIndexedAddressRangeBag<NumEntries>* address_range_bag) {
+    indexed_extra_memory_ranges_ =
+        address_range_bag ? address_range_bag->header() : nullptr;
+  }
+
   //! \brief Sets the simple annotations dictionary.
   //!
   //! Simple annotations set on a CrashpadInfo structure are interpreted by
@@ -118,6 +146,43 @@ struct CrashpadInfo {
     return simple_annotations_;
   }
 
+  //! \brief Sets an additional dictionary of simple annotations, indexed for
+  //!     fast updates.
+  //!
+  //! Annotations in \a simple_annotations are interpreted by Crashpad as
+  //! module-level annotations, along with those in the dictionary set by
+  //! set_simple_annotations(). If a key appears in both, the value in the
+  //! dictionary set by set_simple_annotations() is used.
+  //!
+  //! \param[in] simple_annotations A dictionary that maps string keys to string
+  //!     values, or `nullptr`. The CrashpadInfo object does not take ownership
+  //!     of the dictionary. It is the caller’s responsibility to ensure that
+  //!     this pointer remains valid while it is in effect for a CrashpadInfo
+  //!     object.
+  template <size_t KeySize, size_t ValueSize, size_t NumEntries>
+  void set_indexed_simple_annotations(
+      TIndexedSimpleStringDictionary<KeySize, ValueSize, NumEntries>*
+          simple_annotations) {
+    indexed_simple_annotations_ =
+        simple_annotations ? simple_annotations->header() : nullptr;
+  }
+
+  //! \brief Sets the table of hints that tell the handler what to capture.
+  //!
+  //! The handler reads \a capture_hints once, when it reads this structure.
+  //! Changes made to \a capture_hints afterwards have no effect on that
+  //! handler.
+  //!
+  //! Capture hints are currently only used on Linux, ChromeOS, and Android.
+  //!
+  //! \param[in] capture_hints The hints, or `nullptr`. The CrashpadInfo object
+  //!     does not take ownership of the CaptureHints object. It is the
+  //!     caller’s responsibility to ensure that this pointer remains valid
+  //!     while it is in effect for a CrashpadInfo object.
+  void set_capture_hints(CaptureHints* capture_hints) {
+    capture_hints_ = capture_hints;
+  }
+
   //! \brief Sets the annotations list.
   //!
   //! Unlike the \a simple_annotations structure, the \a annotations can
@@ -145,6 +210,31 @@ struct CrashpadInfo {
   //! \sa AnnotationList::Register()
   AnnotationList* annotations_list() const { return annotations_list_; }
 
+  //! \brief Sets the list of per-thread breadcrumb buffers.
+  //!
+  //! The contents of each thread’s buffer are attached to the corresponding
+  //! thread in the snapshot produced by the handler.
+  //!
+  //! \param[in] list A list of per-thread breadcrumb buffers. The CrashpadInfo
+  //!     object does not take ownership of the ThreadBreadcrumbList object. It
+  //!     is the caller’s responsibility to ensure that this pointer remains
+  //!     valid while it is in effect for a CrashpadInfo object.
+  //!
+  //! \sa thread_breadcrumbs()
+  //! \sa ThreadBreadcrumbList::Register()
+  void set_thread_breadcrumbs(ThreadBreadcrumbList* list) {
+    thread_breadcrumbs_ = list;
+  }
+
+  //! \return The list of per-thread breadcrumb buffers.
+  //!
+  //! \sa set_thread_breadcrumbs()
+  //! \sa ThreadBreadcrumbList::Get()
+  //! \sa ThreadBreadcrumbList::Register()
+  ThreadBreadcrumbList* thread_breadcrumbs() const {
+    return thread_breadcrumbs_;
+  }
+
   //! \brief Enables or disables Crashpad handler processing.
   //!
   //! When handling an exception, the Crashpad handler will scan all modules in
@@ -296,6 +386,12 @@ struct CrashpadInfo {
   SimpleStringDictionary* simple_annotations_;  // weak
   internal::UserDataMinidumpStreamListEntry* user_data_minidump_stream_head_;
   AnnotationList* annotations_list_;  // weak
+  ThreadBreadcrumbList* thread_breadcrumbs_;  // weak
+  const internal::IndexedSimpleStringDictionaryHeader*
+      indexed_simple_annotations_;  // weak
+  CaptureHints* capture_hints_;  // weak
+  const internal::IndexedAddressRangeBagHeader*
+      indexed_extra_memory_ranges_;  // weak
 
   // It’s generally safe to add new fields without changing
   // kCrashpadInfoVersion, because readers should check size_ and ignore fields
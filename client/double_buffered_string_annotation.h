@@ -0,0 +1,101 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_DOUBLE_BUFFERED_STRING_ANNOTATION_H_
+#define CRASHPAD_CLIENT_DOUBLE_BUFFERED_STRING_ANNOTATION_H_
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_piece.h"
+#include "client/annotation.h"
+
+namespace crashpad {
+
+//! \brief An \sa Annotation that stores a string value that a crash report
+//!     always captures whole.
+//!
+//! A StringAnnotation is copied into in place, so a crash in the middle of
+//! Set(), or a snapshot taken while another thread is in Set(), can capture a
+//! value that is partly old and partly new. This annotation instead keeps two
+//! buffers. Set() fills the one that is not being reported and then switches
+//! the annotation to it, so the reported buffer is never written to. The
+//! switch uses ConcurrentAccessGuardMode::kSeqlock, so it never waits. A crash
+//! report drops the annotation only if the crash interrupts the switch itself.
+//!
+//! Set() must not be called from more than one thread at a time. Threads that
+//! each publish their own value should each use their own annotation.
+//!
+//! It is expected that the string value be valid UTF-8, although this is not
+//! validated.
+template <Annotation::ValueSizeType MaxSize>
+class DoubleBufferedStringAnnotation : public Annotation {
+ public:
+  //! \brief Constructs a new DoubleBufferedStringAnnotation with the given
+  //!     \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit DoubleBufferedStringAnnotation(const char name[])
+      : Annotation(Type::kString, name, buffers_[0], SeqlockTag()),
+        buffers_() {}
+
+  DoubleBufferedStringAnnotation(const DoubleBufferedStringAnnotation&) =
+      delete;
+  DoubleBufferedStringAnnotation& operator=(
+      const DoubleBufferedStringAnnotation&) = delete;
+
+  //! \brief Sets the Annotation's string value.
+  //!
+  //! \param[in] value The `NUL`-terminated C-string value.
+  void Set(const char* value) {
+    Set(base::StringPiece(value, strnlen(value, MaxSize)));
+  }
+
+  //! \brief Sets the Annotation's string value.
+  //!
+  //! \param[in] string The string value.
+  void Set(base::StringPiece string) {
+    Annotation::ValueSizeType size =
+        std::min(MaxSize, base::saturated_cast<ValueSizeType>(string.size()));
+    string = string.substr(0, size);
+    // Check for no embedded `NUL` characters.
+    DCHECK(string.find('\0', /*pos=*/0) == base::StringPiece::npos)
+        << "embedded NUL";
+
+    char* inactive =
+        Annotation::value() == buffers_[0] ? buffers_[1] : buffers_[0];
+    std::copy(string.begin(), string.end(), inactive);
+    PublishValue(inactive, size);
+  }
+
+  //! \brief Returns the most recently set value.
+  //!
+  //! This is only meaningful on the thread that calls Set().
+  const base::StringPiece value() const {
+    return base::StringPiece(static_cast<const char*>(Annotation::value()),
+                             size());
+  }
+
+ private:
+  // The two buffers, one of which is published by the base annotation at any
+  // time. As with StringAnnotation, neither is `NUL`-terminated.
+  char buffers_[2][MaxSize];
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_DOUBLE_BUFFERED_STRING_ANNOTATION_H_
@@ -0,0 +1,106 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/double_buffered_string_annotation.h"
+
+#include <string>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+#include "util/synchronization/seqlock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+template <Annotation::ValueSizeType MaxSize>
+class TestAnnotation : public DoubleBufferedStringAnnotation<MaxSize> {
+ public:
+  using DoubleBufferedStringAnnotation<MaxSize>::DoubleBufferedStringAnnotation;
+  using Annotation::seqlock_state;
+};
+
+class DoubleBufferedStringAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ protected:
+  AnnotationList annotations_;
+};
+
+TEST_F(DoubleBufferedStringAnnotationTest, Basics) {
+  constexpr char kName[] = "double-buffered";
+  TestAnnotation<16> annotation(kName);
+
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(annotation.type(), Annotation::Type::kString);
+  EXPECT_EQ(annotation.concurrent_access_guard_mode(),
+            Annotation::ConcurrentAccessGuardMode::kSeqlock);
+  EXPECT_EQ(std::string(kName), annotation.name());
+
+  annotation.Set("value");
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(&annotation, *annotations_.begin());
+  EXPECT_EQ(5u, annotation.size());
+  EXPECT_EQ("value", annotation.value());
+
+  annotation.Set(std::string("another"));
+  EXPECT_EQ(7u, annotation.size());
+  EXPECT_EQ("another", annotation.value());
+
+  annotation.Clear();
+  EXPECT_FALSE(annotation.is_set());
+}
+
+TEST_F(DoubleBufferedStringAnnotationTest, SetLeavesPublishedValueIntact) {
+  TestAnnotation<16> annotation("double-buffered");
+  annotation.Set("first");
+  const void* first_value = annotation.Annotation::value();
+  const uint8_t first_sequence = annotation.seqlock_state().sequence;
+
+  annotation.Set("second");
+  const void* second_value = annotation.Annotation::value();
+  EXPECT_NE(first_value, second_value);
+  EXPECT_EQ(std::string(static_cast<const char*>(first_value), 5), "first");
+  EXPECT_EQ("second", annotation.value());
+
+  // Each publication is one seqlock write.
+  EXPECT_EQ(annotation.seqlock_state().sequence,
+            static_cast<uint8_t>(first_sequence + 2));
+  EXPECT_TRUE(SeqlockState::IsStable(annotation.seqlock_state().sequence));
+
+  annotation.Set("third");
+  EXPECT_EQ(annotation.Annotation::value(), first_value);
+  EXPECT_EQ(std::string(static_cast<const char*>(second_value), 6), "second");
+  EXPECT_EQ("third", annotation.value());
+}
+
+TEST_F(DoubleBufferedStringAnnotationTest, Truncates) {
+  TestAnnotation<4> annotation("double-buffered");
+  annotation.Set("truncated");
+  EXPECT_EQ("trun", annotation.value());
+  annotation.Set(std::string("another"));
+  EXPECT_EQ("anot", annotation.value());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
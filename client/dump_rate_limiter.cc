@@ -0,0 +1,94 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/dump_rate_limiter.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace crashpad {
+
+namespace {
+
+constexpr double kNanosecondsPerMinute = 60e9;
+
+size_t SlotIndex(uint64_t signature) {
+  // Signatures such as code addresses differ mostly in their low bits, which a
+  // multiplicative hash spreads into the high bits used here.
+  return static_cast<size_t>((signature * 0x9e3779b97f4a7c15) >> 32) %
+         DumpRateLimiter::kSlotCount;
+}
+
+}  // namespace
+
+DumpRateLimiter::DumpRateLimiter() : lock_(), options_(), slots_() {}
+
+DumpRateLimiter::~DumpRateLimiter() = default;
+
+void DumpRateLimiter::SetOptions(const Options& options) {
+  std::lock_guard<std::mutex> guard(lock_);
+  options_ = options;
+  std::fill(std::begin(slots_), std::end(slots_), Slot());
+}
+
+bool DumpRateLimiter::ShouldDump(uint64_t signature,
+                                 uint64_t now_ns,
+                                 uint64_t* suppressed) {
+  std::lock_guard<std::mutex> guard(lock_);
+  const bool sampling = options_.sample_interval > 1;
+  if (!sampling && options_.burst == 0) {
+    if (suppressed) {
+      *suppressed = 0;
+    }
+    return true;
+  }
+
+  Slot& slot = slots_[SlotIndex(signature)];
+  if (!slot.in_use || slot.signature != signature) {
+    slot = Slot();
+    slot.signature = signature;
+    slot.refill_time_ns = now_ns;
+    slot.tokens = options_.burst;
+    slot.in_use = true;
+  }
+
+  // The first request of each sample interval is the one considered.
+  if (sampling && slot.requests++ % options_.sample_interval != 0) {
+    ++slot.suppressed;
+    return false;
+  }
+
+  if (options_.burst > 0) {
+    if (now_ns > slot.refill_time_ns) {
+      slot.tokens = std::min(
+          static_cast<double>(options_.burst),
+          slot.tokens + (now_ns - slot.refill_time_ns) *
+                            options_.dumps_per_minute / kNanosecondsPerMinute);
+      slot.refill_time_ns = now_ns;
+    }
+    if (slot.tokens < 1) {
+      ++slot.suppressed;
+      return false;
+    }
+    slot.tokens -= 1;
+  }
+
+  if (suppressed) {
+    *suppressed = slot.suppressed;
+  }
+  slot.suppressed = 0;
+  return true;
+}
+
+}  // namespace crashpad
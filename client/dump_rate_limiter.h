@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_DUMP_RATE_LIMITER_H_
+#define CRASHPAD_CLIENT_DUMP_RATE_LIMITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+
+namespace crashpad {
+
+//! \brief Decides which requests for dumps without a crash are carried out,
+//!     so that a code path that requests them repeatedly doesn’t flood the
+//!     handler.
+//!
+//! Requests are grouped by a signature chosen by the caller, such as the
+//! address the request was made from. Each signature is sampled, and then rate
+//! limited by a token bucket that holds Options::burst dumps and refills at
+//! Options::dumps_per_minute. Declined requests cost only a table lookup.
+//!
+//! Signatures share a fixed number of slots. A signature whose slot is taken
+//! over by another starts afresh when it returns, so many distinct signatures
+//! are limited less strictly than a few repeated ones.
+//!
+//! This class is thread-safe.
+class DumpRateLimiter {
+ public:
+  //! \brief The limits applied to each signature.
+  struct Options {
+    //! \brief One of every this many requests is considered for a dump. `0`
+    //!     and `1` consider every request.
+    uint32_t sample_interval = 1;
+
+    //! \brief The most dumps taken in quick succession. `0` disables rate
+    //!     limiting.
+    uint32_t burst = 0;
+
+    //! \brief The rate at which dumps become available again after a burst.
+    double dumps_per_minute = 0;
+  };
+
+  //! \brief The number of signatures tracked at once.
+  static constexpr size_t kSlotCount = 64;
+
+  DumpRateLimiter();
+
+  DumpRateLimiter(const DumpRateLimiter&) = delete;
+  DumpRateLimiter& operator=(const DumpRateLimiter&) = delete;
+
+  ~DumpRateLimiter();
+
+  //! \brief Replaces the limits, and forgets every signature’s history.
+  void SetOptions(const Options& options);
+
+  //! \brief Decides whether to carry out a request.
+  //!
+  //! \param[in] signature The signature of the request.
+  //! \param[in] now_ns A monotonic time, in nanoseconds, such as from
+  //!     ClockMonotonicNanoseconds().
+  //! \param[out] suppressed If this method returns `true`, the number of
+  //!     requests with \a signature that were declined since the last one that
+  //!     was carried out. Optional.
+  //! \return `true` if the request should be carried out.
+  bool ShouldDump(uint64_t signature, uint64_t now_ns, uint64_t* suppressed);
+
+ private:
+  struct Slot {
+    uint64_t signature;
+    uint64_t requests;
+    uint64_t suppressed;
+    uint64_t refill_time_ns;
+    double tokens;
+    bool in_use;
+  };
+
+  std::mutex lock_;
+  Options options_;
+  Slot slots_[kSlotCount];
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_DUMP_RATE_LIMITER_H_
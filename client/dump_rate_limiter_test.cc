@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/dump_rate_limiter.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kSignature = 0x1234;
+constexpr uint64_t kOtherSignature = 0x5678;
+constexpr uint64_t kSecond = 1000000000;
+
+TEST(DumpRateLimiter, UnlimitedByDefault) {
+  DumpRateLimiter limiter;
+  for (int i = 0; i < 100; ++i) {
+    uint64_t suppressed = 1;
+    EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, &suppressed));
+    EXPECT_EQ(suppressed, 0u);
+  }
+}
+
+TEST(DumpRateLimiter, Sampling) {
+  DumpRateLimiter limiter;
+  DumpRateLimiter::Options options;
+  options.sample_interval = 3;
+  limiter.SetOptions(options);
+
+  uint64_t suppressed;
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 0, nullptr));
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 0, nullptr));
+
+  // Each signature is sampled separately.
+  EXPECT_TRUE(limiter.ShouldDump(kOtherSignature, 0, nullptr));
+
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, &suppressed));
+  EXPECT_EQ(suppressed, 2u);
+}
+
+TEST(DumpRateLimiter, Burst) {
+  DumpRateLimiter limiter;
+  DumpRateLimiter::Options options;
+  options.burst = 2;
+  options.dumps_per_minute = 6;
+  limiter.SetOptions(options);
+
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, nullptr));
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, nullptr));
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, kSecond, nullptr));
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 5 * kSecond, nullptr));
+  EXPECT_TRUE(limiter.ShouldDump(kOtherSignature, 5 * kSecond, nullptr));
+
+  // One dump becomes available every ten seconds.
+  uint64_t suppressed;
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 10 * kSecond, &suppressed));
+  EXPECT_EQ(suppressed, 2u);
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 10 * kSecond, nullptr));
+
+  // The bucket holds no more than the burst.
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 1000 * kSecond, nullptr));
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 1000 * kSecond, nullptr));
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 1000 * kSecond, nullptr));
+}
+
+TEST(DumpRateLimiter, SetOptionsForgetsHistory) {
+  DumpRateLimiter limiter;
+  DumpRateLimiter::Options options;
+  options.burst = 1;
+  limiter.SetOptions(options);
+
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, nullptr));
+  EXPECT_FALSE(limiter.ShouldDump(kSignature, 0, nullptr));
+
+  limiter.SetOptions(options);
+  uint64_t suppressed;
+  EXPECT_TRUE(limiter.ShouldDump(kSignature, 0, &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,343 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_INDEXED_ADDRESS_RANGE_BAG_H_
+#define CRASHPAD_CLIENT_INDEXED_ADDRESS_RANGE_BAG_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+namespace internal {
+
+//! \brief The header of a TIndexedAddressRangeBag.
+//!
+//! The header lets a crash handler read the populated entries of any
+//! instantiation of TIndexedAddressRangeBag without knowing its capacity. It is
+//! immediately followed by \a num_entries entries, each consisting of a 64-bit
+//! base address followed by a 64-bit size.
+struct IndexedAddressRangeBagHeader {
+  //! \brief The expected value of #magic.
+  static constexpr uint32_t kMagic = 0x41524249;
+
+  //! \brief The expected value of #version.
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief Identifies the structure as an IndexedAddressRangeBagHeader.
+  uint32_t magic;
+
+  //! \brief The version of the bag’s layout.
+  uint32_t version;
+
+  //! \brief The maximum number of entries in the bag.
+  uint32_t num_entries;
+
+  //! \brief The number of populated entries, which are always the first
+  //!     entries following the header.
+  uint32_t used_entries;
+};
+
+static_assert(sizeof(IndexedAddressRangeBagHeader) == 16,
+              "IndexedAddressRangeBagHeader is read by the handler");
+
+}  // namespace internal
+
+//! \brief A bag of address ranges using a fixed amount of storage and a hashed
+//!     index.
+//!
+//! This is an alternative to TSimpleAddressRangeBag for bags that are large or
+//! that have ranges inserted and removed frequently. Insertions and removals
+//! are O(1) on average rather than linear in \a NumEntries. Populated entries
+//! are kept contiguous at the start of the storage, with their count recorded
+//! in a header, so that a crash handler only needs to read the populated
+//! entries however large the bag’s capacity is.
+//!
+//! Like TSimpleAddressRangeBag, this performs no dynamic allocation: its
+//! capacity, \a NumEntries, is chosen by the instantiation.
+//!
+//! Removing a range moves the last populated entry into the removed entry’s
+//! storage, so removals do not preserve the order of entries.
+//!
+//! Register an instance with CrashpadInfo::set_indexed_extra_memory_ranges()
+//! to have the memory it describes captured.
+template <size_t NumEntries = 1024>
+class TIndexedAddressRangeBag {
+ public:
+  //! Constant and publicly accessible version of the template parameter.
+  static const size_t num_entries = NumEntries;
+
+  //! \brief A single entry in the bag.
+  struct Entry {
+    //! \brief The base address of the range.
+    uint64_t base;
+
+    //! \brief The size of the range in bytes.
+    uint64_t size;
+  };
+
+  //! \brief An iterator to traverse all of the entries in a
+  //!     TIndexedAddressRangeBag.
+  class Iterator {
+   public:
+    explicit Iterator(const TIndexedAddressRangeBag& bag)
+        : bag_(bag), current_(0) {}
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    //! \brief Returns the next entry in the bag, or `nullptr` if at the end of
+    //!     the collection.
+    const Entry* Next() {
+      if (current_ < bag_.header_.used_entries) {
+        return &bag_.entries_[current_++];
+      }
+      return nullptr;
+    }
+
+   private:
+    const TIndexedAddressRangeBag& bag_;
+    size_t current_;
+  };
+
+  TIndexedAddressRangeBag()
+      : header_({internal::IndexedAddressRangeBagHeader::kMagic,
+                 internal::IndexedAddressRangeBagHeader::kVersion,
+                 NumEntries,
+                 0}),
+        entries_(),
+        index_(),
+        deleted_index_slots_(0) {}
+
+  TIndexedAddressRangeBag(const TIndexedAddressRangeBag&) = delete;
+  TIndexedAddressRangeBag& operator=(const TIndexedAddressRangeBag&) = delete;
+
+  //! \brief Returns the number of entries. The upper limit for this is \a
+  //!     NumEntries.
+  size_t GetCount() const { return header_.used_entries; }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //! ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] range The range to be inserted. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    const size_t slot = header_.used_entries;
+    if (slot == NumEntries) {
+      LOG(ERROR) << "no space available to insert range";
+      return false;
+    }
+
+    // Populate the entry before counting it, so that a handler never reads an
+    // entry that is only partially written.
+    entries_[slot].base = range.base();
+    entries_[slot].size = range.size();
+
+    const size_t position = FindInsertPosition(entries_[slot]);
+    if (index_[position] == kDeletedIndexSlot) {
+      --deleted_index_slots_;
+    }
+    index_[position] = static_cast<IndexSlot>(slot + 1);
+    ++header_.used_entries;
+    return true;
+  }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //! ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] base The base of the range to be inserted. May not be null.
+  //! \param[in] size The size of the range to be inserted. May not be zero.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Insert(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! If the range was inserted more than once, only one of its entries is
+  //! removed.
+  //!
+  //! \param[in] range The range to be removed. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //!     an error logged.
+  bool Remove(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    const Entry key = {range.base(), range.size()};
+    const size_t position = FindIndexPosition(key, kAnySlot);
+    if (position == kIndexSize) {
+      LOG(ERROR) << "did not find range to remove";
+      return false;
+    }
+
+    const size_t slot = index_[position] - 1;
+    index_[position] = kDeletedIndexSlot;
+    ++deleted_index_slots_;
+
+    // Keep populated entries contiguous by moving the last entry into the
+    // removed entry’s storage. With duplicates allowed, the index slot to
+    // update is the one referring to that particular entry.
+    const size_t last = header_.used_entries - 1;
+    if (slot != last) {
+      const size_t last_position = FindIndexPosition(entries_[last], last);
+      DCHECK_NE(last_position, kIndexSize);
+      entries_[slot] = entries_[last];
+      index_[last_position] = static_cast<IndexSlot>(slot + 1);
+    }
+    --header_.used_entries;
+    entries_[last].base = 0;
+    entries_[last].size = 0;
+
+    // Deleted index slots lengthen probe sequences, so discard them once they
+    // accumulate.
+    if (deleted_index_slots_ > kIndexSize / 4) {
+      RebuildIndex();
+    }
+    return true;
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! \param[in] base The base of the range to be removed. May not be null.
+  //! \param[in] size The size of the range to be removed. May not be zero.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //! an error logged.
+  bool Remove(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Remove(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+  //! \brief Returns the header that describes this bag’s layout.
+  const internal::IndexedAddressRangeBagHeader* header() const {
+    return &header_;
+  }
+
+ private:
+  // Each slot of the index holds 1 + the position in |entries_| of the entry
+  // it refers to, or one of these sentinel values.
+  using IndexSlot = uint32_t;
+  static constexpr IndexSlot kEmptyIndexSlot = 0;
+  static constexpr IndexSlot kDeletedIndexSlot = 0xffffffff;
+  static_assert(NumEntries < kDeletedIndexSlot, "NumEntries is too large");
+
+  // Passed to FindIndexPosition() to match an entry at any position.
+  static constexpr size_t kAnySlot = static_cast<size_t>(-1);
+
+  // The index has at least twice as many slots as there are entries, so that it
+  // is never more than half full.
+  static constexpr size_t IndexSizeFor(size_t entries) {
+    size_t size = 1;
+    while (size < 2 * entries) {
+      size *= 2;
+    }
+    return size;
+  }
+  static constexpr size_t kIndexSize = IndexSizeFor(NumEntries);
+
+  // Ranges are frequently page- or allocation-aligned, so the low bits of
+  // |base| alone would cluster. Mix both fields through a 64-bit multiply and
+  // take the high bits.
+  static size_t Hash(const Entry& entry) {
+    uint64_t hash = (entry.base ^ (entry.size * 0x9e3779b97f4a7c15u)) *
+                    0xbf58476d1ce4e5b9u;
+    return static_cast<size_t>(hash >> 32);
+  }
+
+  static bool EntryEquals(const Entry& lhs, const Entry& rhs) {
+    return lhs.base == rhs.base && lhs.size == rhs.size;
+  }
+
+  // Returns the position in |index_| of a slot referring to an entry equal to
+  // |key|, or kIndexSize if there is none. If |slot| is not kAnySlot, only the
+  // index slot referring to the entry at position |slot| matches.
+  size_t FindIndexPosition(const Entry& key, size_t slot) const {
+    size_t position = Hash(key) & (kIndexSize - 1);
+    for (size_t probe = 0; probe < kIndexSize; ++probe) {
+      const IndexSlot index_slot = index_[position];
+      if (index_slot == kEmptyIndexSlot) {
+        break;
+      }
+      if (index_slot != kDeletedIndexSlot &&
+          (slot == kAnySlot ? EntryEquals(key, entries_[index_slot - 1])
+                            : index_slot - 1 == slot)) {
+        return position;
+      }
+      position = (position + 1) & (kIndexSize - 1);
+    }
+    return kIndexSize;
+  }
+
+  // Returns the position in |index_| at which an entry equal to |key| should be
+  // inserted. Because duplicates are allowed, this is the first empty or
+  // deleted slot in |key|’s probe sequence.
+  size_t FindInsertPosition(const Entry& key) const {
+    size_t position = Hash(key) & (kIndexSize - 1);
+    while (index_[position] != kEmptyIndexSlot &&
+           index_[position] != kDeletedIndexSlot) {
+      position = (position + 1) & (kIndexSize - 1);
+    }
+    return position;
+  }
+
+  void RebuildIndex() {
+    std::fill(std::begin(index_), std::end(index_), kEmptyIndexSlot);
+    deleted_index_slots_ = 0;
+    for (size_t slot = 0; slot < header_.used_entries; ++slot) {
+      index_[FindInsertPosition(entries_[slot])] =
+          static_cast<IndexSlot>(slot + 1);
+    }
+  }
+
+  // |header_| and |entries_| are read by the handler, and must remain at the
+  // start of this object in this order.
+  internal::IndexedAddressRangeBagHeader header_;
+  Entry entries_[NumEntries];
+  IndexSlot index_[kIndexSize];
+  size_t deleted_index_slots_;
+};
+
+//! \brief A TIndexedAddressRangeBag with default template parameters.
+using IndexedAddressRangeBag = TIndexedAddressRangeBag<1024>;
+
+static_assert(std::is_standard_layout<IndexedAddressRangeBag>::value,
+              "IndexedAddressRangeBag must be standard layout");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_INDEXED_ADDRESS_RANGE_BAG_H_
@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/indexed_address_range_bag.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(IndexedAddressRangeBag, Header) {
+  using TestBag = TIndexedAddressRangeBag<15>;
+  TestBag bag;
+
+  const internal::IndexedAddressRangeBagHeader* header = bag.header();
+  EXPECT_EQ(header->magic, internal::IndexedAddressRangeBagHeader::kMagic);
+  EXPECT_EQ(header->version, internal::IndexedAddressRangeBagHeader::kVersion);
+  EXPECT_EQ(header->num_entries, 15u);
+  EXPECT_EQ(header->used_entries, 0u);
+  EXPECT_FALSE(TestBag::Iterator(bag).Next());
+
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x1000), 200));
+  EXPECT_EQ(header->used_entries, 1u);
+
+  // The first entry immediately follows the header.
+  const auto* entry = reinterpret_cast<const TestBag::Entry*>(header + 1);
+  EXPECT_EQ(entry->base, 0x1000u);
+  EXPECT_EQ(entry->size, 200u);
+  EXPECT_EQ(TestBag::Iterator(bag).Next(), entry);
+
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x1000), 200));
+  EXPECT_EQ(header->used_entries, 0u);
+  EXPECT_EQ(entry->base, 0u);
+  EXPECT_EQ(entry->size, 0u);
+}
+
+TEST(IndexedAddressRangeBag, IndexedAddressRangeBag) {
+  IndexedAddressRangeBag bag;
+
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x1000), 10));
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x2000), 20));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(bag.GetCount(), 3u);
+
+  // Duplicates added too.
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(bag.GetCount(), 5u);
+
+  // A range with the same base but a different size is distinct.
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x3000, 31)));
+
+  // Can be removed 3 times, but not the 4th time.
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(bag.GetCount(), 2u);
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(bag.GetCount(), 2u);
+
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x1000), 10));
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x2000), 20));
+  EXPECT_EQ(bag.GetCount(), 0u);
+}
+
+// Running out of space shouldn't crash.
+TEST(IndexedAddressRangeBag, OutOfSpace) {
+  TIndexedAddressRangeBag<2> bag;
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(1, 2)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(3, 4)));
+  EXPECT_FALSE(bag.Insert(CheckedRange<uint64_t>(5, 6)));
+  EXPECT_EQ(bag.GetCount(), 2u);
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(5, 6)));
+
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(1, 2)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(5, 6)));
+  EXPECT_EQ(bag.GetCount(), 2u);
+}
+
+// Continuously inserting and removing ranges, as a client registering
+// short-lived buffers would, keeps the populated entries dense and consistent
+// with the ranges that were inserted.
+TEST(IndexedAddressRangeBag, Churn) {
+  using TestBag = TIndexedAddressRangeBag<64>;
+  TestBag bag;
+  std::vector<std::pair<uint64_t, uint64_t>> expected;
+
+  uint64_t next = 1;
+  for (size_t round = 0; round < 5000; ++round) {
+    if (expected.size() < TestBag::num_entries && (round % 3 != 2)) {
+      const uint64_t base = 0x10000 * (next % 97);
+      const uint64_t size = 0x1000 * (next % 5 + 1);
+      ++next;
+      ASSERT_TRUE(bag.Insert(CheckedRange<uint64_t>(base, size)));
+      expected.push_back(std::make_pair(base, size));
+    } else if (!expected.empty()) {
+      auto it = expected.begin() + round % expected.size();
+      ASSERT_TRUE(bag.Remove(CheckedRange<uint64_t>(it->first, it->second)));
+      expected.erase(it);
+    }
+    ASSERT_EQ(bag.GetCount(), expected.size());
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> actual;
+  TestBag::Iterator iterator(bag);
+  while (const TestBag::Entry* entry = iterator.Next()) {
+    actual.push_back(std::make_pair(entry->base, entry->size));
+  }
+  std::sort(actual.begin(), actual.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(actual, expected);
+
+  while (!expected.empty()) {
+    auto it = expected.begin();
+    ASSERT_TRUE(bag.Remove(CheckedRange<uint64_t>(it->first, it->second)));
+    expected.erase(it);
+  }
+  EXPECT_EQ(bag.GetCount(), 0u);
+  EXPECT_FALSE(TestBag::Iterator(bag).Next());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,400 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_INDEXED_SIMPLE_STRING_DICTIONARY_H_
+#define CRASHPAD_CLIENT_INDEXED_SIMPLE_STRING_DICTIONARY_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "base/check_op.h"
+#include "base/strings/string_piece.h"
+
+namespace crashpad {
+
+namespace internal {
+
+//! \brief The header of a TIndexedSimpleStringDictionary.
+//!
+//! The header describes the layout of the dictionary, so that a crash handler
+//! can read the populated entries of any instantiation of
+//! TIndexedSimpleStringDictionary without knowing its template parameters. The
+//! header is immediately followed by \a num_entries entries, each consisting of
+//! \a key_size bytes of key followed by \a value_size bytes of value.
+struct IndexedSimpleStringDictionaryHeader {
+  //! \brief The expected value of #magic.
+  static constexpr uint32_t kMagic = 0x53534449;
+
+  //! \brief The expected value of #version.
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief Identifies the structure as an IndexedSimpleStringDictionaryHeader.
+  uint32_t magic;
+
+  //! \brief The version of the dictionary’s layout.
+  uint32_t version;
+
+  //! \brief The size of each entry’s key, in bytes.
+  uint32_t key_size;
+
+  //! \brief The size of each entry’s value, in bytes.
+  uint32_t value_size;
+
+  //! \brief The maximum number of entries in the dictionary.
+  uint32_t num_entries;
+
+  //! \brief The number of populated entries, which are always the first
+  //!     entries following the header.
+  uint32_t used_entries;
+};
+
+static_assert(sizeof(IndexedSimpleStringDictionaryHeader) == 24,
+              "IndexedSimpleStringDictionaryHeader is read by the handler");
+
+}  // namespace internal
+
+//! \brief A map/dictionary collection implementation using a fixed amount of
+//!     storage and a hashed index.
+//!
+//! This is an alternative to TSimpleStringDictionary for maps that are
+//! large or updated frequently. Lookups, insertions, and removals are O(1) on
+//! average rather than linear in \a NumEntries, and populated entries are kept
+//! contiguous at the start of the storage, with their count recorded in a
+//! header, so that a crash handler only needs to read the populated entries.
+//!
+//! The template parameters control the amount of storage used for the key,
+//! value, and map. The \a KeySize and \a ValueSize are measured in bytes, not
+//! glyphs, and include space for a trailing `NUL` byte. This gives space for
+//! `KeySize - 1` and `ValueSize - 1` characters in an entry. \a NumEntries is
+//! the total number of entries that will fit in the map. Keys longer than
+//! `KeySize - 1` bytes are truncated by every operation, so a long key refers
+//! to the same entry as its truncated form.
+//!
+//! Removing a key moves the last populated entry into the removed entry’s
+//! storage, so removals do not preserve the order of entries.
+//!
+//! Register an instance with CrashpadInfo::set_indexed_simple_annotations() to
+//! have its contents included as module-level annotations.
+template <size_t KeySize = 256, size_t ValueSize = 256, size_t NumEntries = 256>
+class TIndexedSimpleStringDictionary {
+ public:
+  //! \brief Constant and publicly accessible versions of the template
+  //!     parameters.
+  //! \{
+  static const size_t key_size = KeySize;
+  static const size_t value_size = ValueSize;
+  static const size_t num_entries = NumEntries;
+  //! \}
+
+  //! \brief A single entry in the map.
+  struct Entry {
+    //! \brief The entry’s key.
+    //!
+    //! This string is always `NUL`-terminated. If this is a 0-length
+    //! `NUL`-terminated string, the entry is inactive.
+    char key[KeySize];
+
+    //! \brief The entry’s value.
+    //!
+    //! This string is always `NUL`-terminated.
+    char value[ValueSize];
+
+    //! \brief Returns the validity of the entry.
+    //!
+    //! If #key is an empty string, the entry is considered inactive, and this
+    //! method returns `false`. Otherwise, returns `true`.
+    bool is_active() const { return key[0] != '\0'; }
+  };
+
+  //! \brief An iterator to traverse all of the active entries in a
+  //!     TIndexedSimpleStringDictionary.
+  class Iterator {
+   public:
+    explicit Iterator(const TIndexedSimpleStringDictionary& map)
+        : map_(map), current_(0) {}
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    //! \brief Returns the next entry in the map, or `nullptr` if at the end of
+    //!     the collection.
+    const Entry* Next() {
+      if (current_ < map_.header_.used_entries) {
+        return &map_.entries_[current_++];
+      }
+      return nullptr;
+    }
+
+   private:
+    const TIndexedSimpleStringDictionary& map_;
+    size_t current_;
+  };
+
+  TIndexedSimpleStringDictionary()
+      : header_({internal::IndexedSimpleStringDictionaryHeader::kMagic,
+                 internal::IndexedSimpleStringDictionaryHeader::kVersion,
+                 KeySize,
+                 ValueSize,
+                 NumEntries,
+                 0}),
+        entries_(),
+        index_(),
+        deleted_index_slots_(0) {}
+
+  TIndexedSimpleStringDictionary(const TIndexedSimpleStringDictionary&) =
+      delete;
+  TIndexedSimpleStringDictionary& operator=(
+      const TIndexedSimpleStringDictionary&) = delete;
+
+  //! \brief Returns the number of active key/value pairs. The upper limit for
+  //!     this is \a NumEntries.
+  size_t GetCount() const { return header_.used_entries; }
+
+  //! \brief Given \a key, returns its corresponding value.
+  //!
+  //! \param[in] key The key to look up. This must not be `nullptr`, nor an
+  //!     empty string. It must not contain embedded `NUL`s.
+  //!
+  //! \return The corresponding value for \a key, or if \a key is not found,
+  //!     `nullptr`.
+  const char* GetValueForKey(base::StringPiece key) const {
+    DCHECK(key.data());
+    DCHECK(key.size());
+    DCHECK_EQ(key.find('\0', 0), base::StringPiece::npos);
+    if (!key.data() || !key.size()) {
+      return nullptr;
+    }
+
+    const size_t position = FindIndexPosition(TruncateKey(key), nullptr);
+    if (position == kIndexSize) {
+      return nullptr;
+    }
+    return entries_[index_[position] - 1].value;
+  }
+
+  //! \brief Stores \a value into \a key, replacing the existing value if \a key
+  //!     is already present.
+  //!
+  //! If \a key is not yet in the map and the map is already full (containing
+  //! \a NumEntries active entries), this operation silently fails.
+  //!
+  //! \param[in] key The key to store. This must not be `nullptr`, nor an empty
+  //!     string. It must not contain embedded `NUL`s.
+  //! \param[in] value The value to store. If `nullptr`, \a key is removed from
+  //!     the map. Must not contain embedded `NUL`s.
+  void SetKeyValue(base::StringPiece key, base::StringPiece value) {
+    if (!value.data()) {
+      RemoveKey(key);
+      return;
+    }
+
+    DCHECK(key.data());
+    DCHECK(key.size());
+    DCHECK_EQ(key.find('\0', 0), base::StringPiece::npos);
+    if (!key.data() || !key.size()) {
+      return;
+    }
+
+    // |value| must not contain embedded NULs.
+    DCHECK_EQ(value.find('\0', 0), base::StringPiece::npos);
+
+    key = TruncateKey(key);
+    size_t insert_position;
+    const size_t position = FindIndexPosition(key, &insert_position);
+    if (position != kIndexSize) {
+      SetFromStringPiece(
+          value, entries_[index_[position] - 1].value, ValueSize);
+      return;
+    }
+
+    // If the map is out of space, silently fail.
+    const size_t slot = header_.used_entries;
+    if (slot == NumEntries) {
+      return;
+    }
+    DCHECK_NE(insert_position, kIndexSize);
+
+    // Populate the entry before counting it, so that a handler never reads an
+    // entry that is only partially written.
+    Entry* entry = &entries_[slot];
+    SetFromStringPiece(key, entry->key, KeySize);
+    SetFromStringPiece(value, entry->value, ValueSize);
+    if (index_[insert_position] == kDeletedIndexSlot) {
+      --deleted_index_slots_;
+    }
+    index_[insert_position] = static_cast<IndexSlot>(slot + 1);
+    ++header_.used_entries;
+  }
+
+  //! \brief Removes \a key from the map.
+  //!
+  //! If \a key is not found, this is a no-op.
+  //!
+  //! \param[in] key The key of the entry to remove. This must not be `nullptr`,
+  //!     nor an empty string. It must not contain embedded `NUL`s.
+  void RemoveKey(base::StringPiece key) {
+    DCHECK(key.data());
+    DCHECK(key.size());
+    DCHECK_EQ(key.find('\0', 0), base::StringPiece::npos);
+    if (!key.data() || !key.size()) {
+      return;
+    }
+
+    const size_t position = FindIndexPosition(TruncateKey(key), nullptr);
+    if (position == kIndexSize) {
+      return;
+    }
+
+    const size_t slot = index_[position] - 1;
+    index_[position] = kDeletedIndexSlot;
+    ++deleted_index_slots_;
+
+    // Keep populated entries contiguous by moving the last entry into the
+    // removed entry’s storage.
+    const size_t last = header_.used_entries - 1;
+    if (slot != last) {
+      const size_t last_position =
+          FindIndexPosition(base::StringPiece(entries_[last].key), nullptr);
+      DCHECK_NE(last_position, kIndexSize);
+      entries_[slot] = entries_[last];
+      index_[last_position] = static_cast<IndexSlot>(slot + 1);
+    }
+    --header_.used_entries;
+    entries_[last].key[0] = '\0';
+    entries_[last].value[0] = '\0';
+
+    // Deleted index slots lengthen probe sequences, so discard them once they
+    // accumulate.
+    if (deleted_index_slots_ > kIndexSize / 4) {
+      RebuildIndex();
+    }
+
+    DCHECK_EQ(FindIndexPosition(TruncateKey(key), nullptr), kIndexSize);
+  }
+
+  //! \brief Returns the header that describes this dictionary’s layout.
+  const internal::IndexedSimpleStringDictionaryHeader* header() const {
+    return &header_;
+  }
+
+ private:
+  // Each slot of the index holds 1 + the position in |entries_| of the entry
+  // it refers to, or one of these sentinel values.
+  using IndexSlot = uint16_t;
+  static constexpr IndexSlot kEmptyIndexSlot = 0;
+  static constexpr IndexSlot kDeletedIndexSlot = 0xffff;
+  static_assert(NumEntries < kDeletedIndexSlot, "NumEntries is too large");
+
+  // The index has at least twice as many slots as there are entries, so that it
+  // is never more than half full.
+  static constexpr size_t IndexSizeFor(size_t entries) {
+    size_t size = 1;
+    while (size < 2 * entries) {
+      size *= 2;
+    }
+    return size;
+  }
+  static constexpr size_t kIndexSize = IndexSizeFor(NumEntries);
+
+  static base::StringPiece TruncateKey(base::StringPiece key) {
+    return key.substr(0, KeySize - 1);
+  }
+
+  // 32-bit FNV-1a.
+  static uint32_t Hash(base::StringPiece key) {
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+  }
+
+  static void SetFromStringPiece(base::StringPiece src,
+                                 char* dst,
+                                 size_t dst_size) {
+    size_t copy_len = std::min(dst_size - 1, src.size());
+    src.copy(dst, copy_len);
+    dst[copy_len] = '\0';
+  }
+
+  static bool EntryKeyEquals(base::StringPiece key, const Entry& entry) {
+    return entry.key[key.size()] == '\0' &&
+           memcmp(key.data(), entry.key, key.size()) == 0;
+  }
+
+  // Returns the position in |index_| of the slot referring to |key|, or
+  // kIndexSize if |key| is not in the map. If |insert_position| is not nullptr,
+  // it receives the position at which |key| should be inserted.
+  size_t FindIndexPosition(base::StringPiece key,
+                           size_t* insert_position) const {
+    size_t position = Hash(key) & (kIndexSize - 1);
+    size_t reusable_position = kIndexSize;
+    for (size_t probe = 0; probe < kIndexSize; ++probe) {
+      const IndexSlot slot = index_[position];
+      if (slot == kEmptyIndexSlot) {
+        if (reusable_position == kIndexSize) {
+          reusable_position = position;
+        }
+        break;
+      }
+      if (slot == kDeletedIndexSlot) {
+        if (reusable_position == kIndexSize) {
+          reusable_position = position;
+        }
+      } else if (EntryKeyEquals(key, entries_[slot - 1])) {
+        return position;
+      }
+      position = (position + 1) & (kIndexSize - 1);
+    }
+
+    if (insert_position) {
+      *insert_position = reusable_position;
+    }
+    return kIndexSize;
+  }
+
+  void RebuildIndex() {
+    std::fill(std::begin(index_), std::end(index_), kEmptyIndexSlot);
+    deleted_index_slots_ = 0;
+    for (size_t slot = 0; slot < header_.used_entries; ++slot) {
+      size_t insert_position;
+      FindIndexPosition(base::StringPiece(entries_[slot].key),
+                        &insert_position);
+      index_[insert_position] = static_cast<IndexSlot>(slot + 1);
+    }
+  }
+
+  // |header_| and |entries_| are read by the handler, and must remain at the
+  // start of this object in this order.
+  internal::IndexedSimpleStringDictionaryHeader header_;
+  Entry entries_[NumEntries];
+  IndexSlot index_[kIndexSize];
+  size_t deleted_index_slots_;
+};
+
+//! \brief A TIndexedSimpleStringDictionary with default template parameters.
+using IndexedSimpleStringDictionary =
+    TIndexedSimpleStringDictionary<256, 256, 256>;
+
+static_assert(std::is_standard_layout<IndexedSimpleStringDictionary>::value,
+              "IndexedSimpleStringDictionary must be standard layout");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_INDEXED_SIMPLE_STRING_DICTIONARY_H_
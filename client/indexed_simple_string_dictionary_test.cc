@@ -0,0 +1,182 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/indexed_simple_string_dictionary.h"
+
+#include <map>
+#include <string>
+
+#include "base/check_op.h"
+#include "gtest/gtest.h"
+#include "test/gtest_death.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(IndexedSimpleStringDictionary, Header) {
+  using TestMap = TIndexedSimpleStringDictionary<5, 9, 15>;
+  TestMap map;
+
+  const internal::IndexedSimpleStringDictionaryHeader* header = map.header();
+  EXPECT_EQ(header->magic,
+            internal::IndexedSimpleStringDictionaryHeader::kMagic);
+  EXPECT_EQ(header->version,
+            internal::IndexedSimpleStringDictionaryHeader::kVersion);
+  EXPECT_EQ(header->key_size, 5u);
+  EXPECT_EQ(header->value_size, 9u);
+  EXPECT_EQ(header->num_entries, 15u);
+  EXPECT_EQ(header->used_entries, 0u);
+
+  map.SetKeyValue("key1", "value1");
+  EXPECT_EQ(header->used_entries, 1u);
+
+  // The first entry immediately follows the header.
+  const auto* entry = reinterpret_cast<const TestMap::Entry*>(header + 1);
+  EXPECT_STREQ(entry->key, "key1");
+  EXPECT_STREQ(entry->value, "value1");
+}
+
+TEST(IndexedSimpleStringDictionary, IndexedSimpleStringDictionary) {
+  IndexedSimpleStringDictionary dict;
+
+  dict.SetKeyValue("key1", "value1");
+  dict.SetKeyValue("key2", "value2");
+  dict.SetKeyValue("key3", "value3");
+
+  EXPECT_STREQ(dict.GetValueForKey("key1"), "value1");
+  EXPECT_STREQ(dict.GetValueForKey("key2"), "value2");
+  EXPECT_STREQ(dict.GetValueForKey("key3"), "value3");
+  EXPECT_EQ(dict.GetCount(), 3u);
+  EXPECT_FALSE(dict.GetValueForKey("key4"));
+
+  dict.SetKeyValue("key2", "value4");
+  EXPECT_STREQ(dict.GetValueForKey("key2"), "value4");
+  EXPECT_EQ(dict.GetCount(), 3u);
+
+  dict.RemoveKey("key3");
+  EXPECT_FALSE(dict.GetValueForKey("key3"));
+  EXPECT_EQ(dict.GetCount(), 2u);
+
+  dict.SetKeyValue("key2", base::StringPiece(nullptr, 0));
+  EXPECT_FALSE(dict.GetValueForKey("key2"));
+  EXPECT_EQ(dict.GetCount(), 1u);
+}
+
+TEST(IndexedSimpleStringDictionary, RemoveKeepsEntriesContiguous) {
+  using TestMap = TIndexedSimpleStringDictionary<10, 10, 10>;
+  TestMap map;
+  map.SetKeyValue("a", "1");
+  map.SetKeyValue("b", "2");
+  map.SetKeyValue("c", "3");
+  map.SetKeyValue("d", "4");
+
+  map.RemoveKey("b");
+  EXPECT_EQ(map.GetCount(), 3u);
+
+  std::map<std::string, std::string> entries;
+  TestMap::Iterator iter(map);
+  while (const TestMap::Entry* entry = iter.Next()) {
+    EXPECT_TRUE(entry->is_active());
+    entries[entry->key] = entry->value;
+  }
+  const std::map<std::string, std::string> expected = {
+      {"a", "1"}, {"c", "3"}, {"d", "4"}};
+  EXPECT_EQ(entries, expected);
+
+  // The moved entry can still be found and updated.
+  map.SetKeyValue("d", "5");
+  EXPECT_STREQ(map.GetValueForKey("d"), "5");
+  EXPECT_EQ(map.GetCount(), 3u);
+}
+
+TEST(IndexedSimpleStringDictionary, LongKeysAreTruncated) {
+  TIndexedSimpleStringDictionary<4, 4, 4> map;
+  map.SetKeyValue("abcdef", "123456");
+  EXPECT_EQ(map.GetCount(), 1u);
+  EXPECT_STREQ(map.GetValueForKey("abc"), "123");
+  EXPECT_STREQ(map.GetValueForKey("abcxyz"), "123");
+
+  map.SetKeyValue("abc", "789");
+  EXPECT_EQ(map.GetCount(), 1u);
+  EXPECT_STREQ(map.GetValueForKey("abcdef"), "789");
+
+  map.RemoveKey("abcd");
+  EXPECT_EQ(map.GetCount(), 0u);
+}
+
+TEST(IndexedSimpleStringDictionary, OutOfSpace) {
+  TIndexedSimpleStringDictionary<3, 2, 2> map;
+  map.SetKeyValue("a", "1");
+  map.SetKeyValue("b", "2");
+  map.SetKeyValue("c", "3");
+  EXPECT_EQ(map.GetCount(), 2u);
+  EXPECT_FALSE(map.GetValueForKey("c"));
+
+  map.RemoveKey("a");
+  map.SetKeyValue("c", "3");
+  EXPECT_EQ(map.GetCount(), 2u);
+  EXPECT_STREQ(map.GetValueForKey("c"), "3");
+}
+
+TEST(IndexedSimpleStringDictionary, ManyOperations) {
+  // Repeatedly filling and emptying the map leaves many deleted index slots,
+  // which must not prevent keys from being found.
+  constexpr size_t kNumEntries = 64;
+  TIndexedSimpleStringDictionary<16, 16, kNumEntries> map;
+  std::map<std::string, std::string> expected;
+
+  for (size_t round = 0; round < 20; ++round) {
+    for (size_t index = 0; index < kNumEntries; ++index) {
+      const std::string key =
+          "key" + std::to_string((index * 7 + round * 13) % 100);
+      const std::string value = std::to_string(round * 1000 + index);
+      map.SetKeyValue(key, value);
+      if (expected.size() < kNumEntries || expected.count(key)) {
+        expected[key] = value;
+      }
+    }
+    for (size_t index = 0; index < kNumEntries; index += 2 + round % 3) {
+      const std::string key = "key" + std::to_string((index * 11) % 100);
+      map.RemoveKey(key);
+      expected.erase(key);
+    }
+
+    ASSERT_EQ(map.GetCount(), expected.size());
+    for (const auto& [key, value] : expected) {
+      ASSERT_STREQ(map.GetValueForKey(key), value.c_str()) << key;
+    }
+  }
+}
+
+#if DCHECK_IS_ON()
+
+TEST(IndexedSimpleStringDictionaryDeathTest, SetKeyValueWithNullKey) {
+  TIndexedSimpleStringDictionary<4, 6, 6> map;
+  ASSERT_DEATH_CHECK(map.SetKeyValue(base::StringPiece(nullptr, 0), "hello"),
+                     "key");
+}
+
+TEST(IndexedSimpleStringDictionaryDeathTest, GetValueForKeyWithNullKey) {
+  TIndexedSimpleStringDictionary<4, 6, 6> map;
+  map.SetKeyValue("hi", "there");
+  ASSERT_DEATH_CHECK(map.GetValueForKey(base::StringPiece(nullptr, 0)), "key");
+  EXPECT_STREQ("there", map.GetValueForKey("hi"));
+}
+
+#endif
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,186 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/image_annotation_registry.h"
+
+#include <mach-o/dyld.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+std::atomic<ImageAnnotationRegistry*> g_registry;
+
+}  // namespace
+
+// static
+void ImageAnnotationRegistry::Enable() {
+  [[maybe_unused]] static ImageAnnotationRegistry* registry = [] {
+    ImageAnnotationRegistry* registry = new ImageAnnotationRegistry();
+    // Publish the registry before registering the callbacks, which are invoked
+    // synchronously for each image that is already loaded.
+    g_registry.store(registry, std::memory_order_release);
+    _dyld_register_func_for_add_image(AddImageCallback);
+    _dyld_register_func_for_remove_image(RemoveImageCallback);
+    return registry;
+  }();
+}
+
+// static
+const ImageAnnotationRegistry* ImageAnnotationRegistry::Get() {
+  return g_registry.load(std::memory_order_acquire);
+}
+
+const ImageAnnotationRegistry::Image* ImageAnnotationRegistry::Find(
+    uint64_t address,
+    size_t* hint) const {
+  const size_t count =
+      std::min(reserved_count_.load(std::memory_order_acquire), kMaxImages);
+  if (count == 0) {
+    return nullptr;
+  }
+
+  // Walk backwards from the hint, wrapping around once.
+  const size_t start = *hint < count ? *hint : count - 1;
+  for (size_t checked = 0; checked < count; ++checked) {
+    const size_t index = (start + count - checked) % count;
+    const Image& image = images_[index];
+    if (image.state.load(std::memory_order_acquire) == Image::State::kLoaded &&
+        image.address == address) {
+      *hint = index;
+      return &image;
+    }
+  }
+  return nullptr;
+}
+
+ImageAnnotationRegistry::ImageAnnotationRegistry()
+    : images_(), reserved_count_(0) {}
+
+ImageAnnotationRegistry::~ImageAnnotationRegistry() = default;
+
+// static
+void ImageAnnotationRegistry::AddImageCallback(const mach_header* header,
+                                               intptr_t slide) {
+  if (header->magic != MH_MAGIC_64) {
+    return;
+  }
+  g_registry.load(std::memory_order_acquire)
+      ->AddImage(reinterpret_cast<const mach_header_64*>(header), slide);
+}
+
+// static
+void ImageAnnotationRegistry::RemoveImageCallback(const mach_header* header,
+                                                  intptr_t slide) {
+  if (header->magic != MH_MAGIC_64) {
+    return;
+  }
+  g_registry.load(std::memory_order_acquire)
+      ->RemoveImage(reinterpret_cast<const mach_header_64*>(header));
+}
+
+void ImageAnnotationRegistry::AddImage(const mach_header_64* header,
+                                       intptr_t slide) {
+  // dyld may call back from several threads loading images concurrently, so
+  // each call reserves its own entry. Readers ignore an entry until its state
+  // is published below.
+  const size_t index =
+      reserved_count_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= kMaxImages) {
+    return;
+  }
+  Image& image = images_[index];
+  DCHECK(image.state.load(std::memory_order_relaxed) == Image::State::kEmpty);
+
+  image.address = reinterpret_cast<uint64_t>(header);
+  image.file_type = header->filetype;
+
+  // Unlike at crash time, the image was just mapped by dyld, so its load
+  // commands can be read directly.
+  const load_command* command =
+      reinterpret_cast<const load_command*>(header + 1);
+  for (uint32_t cmd_index = 0, cumulative_cmd_size = 0;
+       cmd_index < header->ncmds && cumulative_cmd_size < header->sizeofcmds;
+       ++cmd_index) {
+    if (command->cmd == LC_SEGMENT_64) {
+      const segment_command_64* segment =
+          reinterpret_cast<const segment_command_64*>(command);
+      if (strcmp(segment->segname, SEG_TEXT) == 0) {
+        image.text_size = segment->vmsize;
+        image.has_text_size = true;
+      } else if (strcmp(segment->segname, SEG_DATA) == 0) {
+        const section_64* section =
+            reinterpret_cast<const section_64*>(segment + 1);
+        for (uint32_t sect_index = 0; sect_index < segment->nsects;
+             ++sect_index, ++section) {
+          if (strncmp(section->sectname,
+                      "crashpad_info",
+                      sizeof(section->sectname)) == 0) {
+            image.crashpad_info_address = section->addr + slide;
+          } else if (strncmp(section->sectname,
+                             "__crash_info",
+                             sizeof(section->sectname)) == 0) {
+            image.crash_info_address = section->addr + slide;
+          }
+        }
+      }
+    } else if (command->cmd == LC_ID_DYLIB) {
+      image.dylib_current_version =
+          reinterpret_cast<const dylib_command*>(command)
+              ->dylib.current_version;
+      image.has_dylib_current_version = true;
+    } else if (command->cmd == LC_SOURCE_VERSION) {
+      image.source_version =
+          reinterpret_cast<const source_version_command*>(command)->version;
+      image.has_source_version = true;
+    } else if (command->cmd == LC_UUID) {
+      memcpy(image.uuid,
+             reinterpret_cast<const uuid_command*>(command)->uuid,
+             sizeof(image.uuid));
+      image.has_uuid = true;
+    }
+
+    cumulative_cmd_size += command->cmdsize;
+    command = reinterpret_cast<const load_command*>(
+        reinterpret_cast<const uint8_t*>(command) + command->cmdsize);
+  }
+
+  image.state.store(Image::State::kLoaded, std::memory_order_release);
+}
+
+void ImageAnnotationRegistry::RemoveImage(const mach_header_64* header) {
+  const uint64_t address = reinterpret_cast<uint64_t>(header);
+  const size_t count =
+      std::min(reserved_count_.load(std::memory_order_acquire), kMaxImages);
+  for (size_t index = 0; index < count; ++index) {
+    Image& image = images_[index];
+    Image::State expected = Image::State::kLoaded;
+    if (image.state.load(std::memory_order_acquire) == expected &&
+        image.address == address &&
+        image.state.compare_exchange_strong(expected,
+                                            Image::State::kUnloaded,
+                                            std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
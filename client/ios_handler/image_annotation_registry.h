@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IOS_HANDLER_IMAGE_ANNOTATION_REGISTRY_H_
+#define CRASHPAD_CLIENT_IOS_HANDLER_IMAGE_ANNOTATION_REGISTRY_H_
+
+#include <mach-o/loader.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A process-wide record of the Mach-O metadata and annotation section
+//!     locations of each loaded image.
+//!
+//! Once enabled, entries are recorded from a dyld add-image callback, so that
+//! InProcessIntermediateDumpHandler::WriteModuleInfo() can skip reading and
+//! walking every image's load commands at crash time. Only the locations are
+//! recorded: the annotations themselves change as the process runs, and are
+//! still read when the intermediate dump is written.
+//!
+//! Storage is allocated once, up front, and entries are published with atomic
+//! stores, so Find() takes no locks and may be called from a signal or Mach
+//! exception handler. Images that don't fit are simply not recorded, and the
+//! caller falls back to parsing them directly.
+class ImageAnnotationRegistry {
+ public:
+  //! \brief The metadata recorded for a single image.
+  struct Image {
+    enum class State : uint8_t {
+      //! \brief The entry is reserved but not yet filled in.
+      kEmpty = 0,
+
+      //! \brief The entry describes a loaded image.
+      kLoaded,
+
+      //! \brief The image has been unloaded.
+      kUnloaded,
+    };
+
+    std::atomic<State> state;
+    uint64_t address;
+    uint64_t text_size;
+    uint64_t crashpad_info_address;
+    uint64_t crash_info_address;
+    uint64_t source_version;
+    uint32_t dylib_current_version;
+    uint32_t file_type;
+    uint8_t uuid[16];
+    bool has_text_size;
+    bool has_source_version;
+    bool has_dylib_current_version;
+    bool has_uuid;
+  };
+
+  ImageAnnotationRegistry(const ImageAnnotationRegistry&) = delete;
+  ImageAnnotationRegistry& operator=(const ImageAnnotationRegistry&) = delete;
+
+  //! \brief Creates the registry and registers dyld image callbacks.
+  //!
+  //! Callbacks are invoked immediately for every image that is already loaded.
+  //! dyld provides no way to unregister callbacks, so the registry lives for
+  //! the remainder of the process. Calling this more than once has no further
+  //! effect.
+  static void Enable();
+
+  //! \brief Returns the registry, or `nullptr` if Enable() has not been
+  //!     called.
+  //!
+  //! This method is safe to call from a signal handler.
+  static const ImageAnnotationRegistry* Get();
+
+  //! \brief Returns the loaded image recorded at \a address, or `nullptr` if
+  //!     there is none.
+  //!
+  //! This method is safe to call from a signal handler.
+  //!
+  //! \param[in] address The image's load address.
+  //! \param[in,out] hint The index at which to start searching, updated to
+  //!     the index of the found entry. Images are usually looked up in
+  //!     reverse load order, so passing the same hint to consecutive calls
+  //!     finds each image after a single comparison. Initialize to `0`.
+  const Image* Find(uint64_t address, size_t* hint) const;
+
+ private:
+  ImageAnnotationRegistry();
+  ~ImageAnnotationRegistry();
+
+  static void AddImageCallback(const mach_header* header, intptr_t slide);
+  static void RemoveImageCallback(const mach_header* header, intptr_t slide);
+
+  void AddImage(const mach_header_64* header, intptr_t slide);
+  void RemoveImage(const mach_header_64* header);
+
+  // Large enough for an application and the system libraries it links from
+  // the shared cache.
+  static constexpr size_t kMaxImages = 2048;
+
+  Image images_[kMaxImages];
+  std::atomic<size_t> reserved_count_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IOS_HANDLER_IMAGE_ANNOTATION_REGISTRY_H_
@@ -14,12 +14,15 @@
 
 #include "client/ios_handler/in_process_handler.h"
 
+#include <pthread.h>
 #include <stdio.h>
+#include <sys/qos.h>
 #include <sys/stat.h>
 
 #include <algorithm>
 
 #include "base/logging.h"
+#include "client/ios_handler/image_annotation_registry.h"
 #include "client/ios_handler/in_process_intermediate_dump_handler.h"
 #include "client/prune_crash_reports.h"
 #include "client/settings.h"
@@ -27,6 +30,8 @@
 #include "util/file/directory_reader.h"
 #include "util/file/filesystem.h"
 #include "util/ios/raw_logging.h"
+#include "util/misc/clock.h"
+#include "util/thread/thread.h"
 
 namespace {
 
@@ -58,9 +63,44 @@ constexpr mach_exception_data_type_t kEmulatedMachExceptionCodes[2] = {};
 namespace crashpad {
 namespace internal {
 
+class InProcessHandler::BackgroundProcessingThread final : public Thread {
+ public:
+  BackgroundProcessingThread(
+      InProcessHandler* handler,
+      const std::map<std::string, std::string>& annotations,
+      double time_budget_seconds)
+      : Thread(),
+        handler_(handler),
+        annotations_(annotations),
+        time_budget_ns_(static_cast<uint64_t>(time_budget_seconds * 1E9)) {}
+
+  BackgroundProcessingThread(const BackgroundProcessingThread&) = delete;
+  BackgroundProcessingThread& operator=(const BackgroundProcessingThread&) =
+      delete;
+
+  ~BackgroundProcessingThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+    handler_->ProcessIntermediateDumpsUntil(
+        annotations_, ClockMonotonicNanoseconds() + time_budget_ns_);
+    handler_->background_processing_running_ = false;
+  }
+
+  InProcessHandler* handler_;  // weak
+  const std::map<std::string, std::string> annotations_;
+  const uint64_t time_budget_ns_;
+};
+
 InProcessHandler::InProcessHandler() = default;
 
 InProcessHandler::~InProcessHandler() {
+  if (background_processing_thread_) {
+    stop_background_processing_ = true;
+    background_processing_thread_->Join();
+  }
   if (cached_writer_) {
     cached_writer_->Close();
   }
@@ -90,6 +130,8 @@ bool InProcessHandler::Initialize(
     upload_thread_options.upload_gzip = true;
     upload_thread_options.watch_pending_reports = true;
     upload_thread_options.identify_client_via_url = true;
+    upload_thread_options.max_concurrent_uploads = 1;
+    upload_thread_options.max_upload_bytes_per_second = 0;
 
     upload_thread_.reset(new CrashReportUploadThread(
         database_.get(), url, upload_thread_options, callback));
@@ -109,7 +151,12 @@ bool InProcessHandler::Initialize(
       PruneCondition::GetDefault(),
       base_dir_,
       bundle_identifier_and_seperator_,
-      is_app_extension));
+      is_app_extension,
+      // Leave the disk to the app while it is in use on a busy device.
+      [this] {
+        return system_data_.IsApplicationActive() &&
+               system_data_.IsDeviceUnderLoad();
+      }));
   if (is_app_extension || system_data_.IsApplicationActive())
     prune_thread_->Start();
 
@@ -257,8 +304,32 @@ void InProcessHandler::ProcessIntermediateDumps(
     const std::map<std::string, std::string>& annotations) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  base::AutoLock lock(process_intermediate_dumps_lock_);
   for (auto& file : PendingFiles())
-    ProcessIntermediateDump(file, annotations);
+    ProcessIntermediateDumpLocked(file, annotations);
+}
+
+void InProcessHandler::ProcessIntermediateDumpsInBackground(
+    const std::map<std::string, std::string>& annotations,
+    double time_budget_seconds) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (background_processing_running_.exchange(true)) {
+    return;
+  }
+  if (background_processing_thread_) {
+    background_processing_thread_->Join();
+  }
+  background_processing_thread_ = std::make_unique<BackgroundProcessingThread>(
+      this, annotations, time_budget_seconds);
+  background_processing_thread_->Start();
+}
+
+void InProcessHandler::JoinBackgroundProcessingForTesting() {
+  if (background_processing_thread_) {
+    background_processing_thread_->Join();
+    background_processing_thread_.reset();
+  }
 }
 
 void InProcessHandler::ProcessIntermediateDump(
@@ -266,6 +337,38 @@ void InProcessHandler::ProcessIntermediateDump(
     const std::map<std::string, std::string>& annotations) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  base::AutoLock lock(process_intermediate_dumps_lock_);
+  ProcessIntermediateDumpLocked(file, annotations);
+}
+
+void InProcessHandler::ProcessIntermediateDumpsUntil(
+    const std::map<std::string, std::string>& annotations,
+    uint64_t deadline_ns) {
+  // PendingFiles() returns a limited number of files at a time. Converting a
+  // dump removes it, so keep asking for more until the budget is spent.
+  //
+  // The lock is taken for one dump at a time, so that a foreground request
+  // such as DumpWithoutCrash() waits for at most one background conversion.
+  std::vector<base::FilePath> files;
+  while (!(files = PendingFiles()).empty()) {
+    for (const base::FilePath& file : files) {
+      if (stop_background_processing_ ||
+          ClockMonotonicNanoseconds() >= deadline_ns) {
+        return;
+      }
+      base::AutoLock lock(process_intermediate_dumps_lock_);
+
+      // A foreground conversion may have taken this dump since it was listed.
+      if (IsRegularFile(file)) {
+        ProcessIntermediateDumpLocked(file, annotations);
+      }
+    }
+  }
+}
+
+void InProcessHandler::ProcessIntermediateDumpLocked(
+    const base::FilePath& file,
+    const std::map<std::string, std::string>& annotations) {
   ProcessSnapshotIOSIntermediateDump process_snapshot;
   if (process_snapshot.InitializeWithFilePath(file, annotations)) {
     SaveSnapshot(process_snapshot);
@@ -440,7 +543,9 @@ IOSIntermediateDumpWriter* InProcessHandler::GetCachedWriter() {
 std::unique_ptr<IOSIntermediateDumpWriter>
 InProcessHandler::CreateWriterWithPath(const base::FilePath& writer_path) {
   std::unique_ptr<IOSIntermediateDumpWriter> writer =
-      std::make_unique<IOSIntermediateDumpWriter>();
+      std::make_unique<IOSIntermediateDumpWriter>(
+          IOSIntermediateDumpWriter::kDefaultBufferSize,
+          IOSIntermediateDumpWriter::Encoding::kCompact);
   if (!writer->Open(writer_path)) {
     DLOG(ERROR) << "Unable to open intermediate dump file: "
                 << writer_path.value();
@@ -481,7 +586,8 @@ InProcessHandler::ScopedReport::~ScopedReport() {
   // DumpExceptionFrom*.)
   InProcessIntermediateDumpHandler::WriteThreadInfo(
       writer_, frames_, num_frames_);
-  InProcessIntermediateDumpHandler::WriteModuleInfo(writer_);
+  InProcessIntermediateDumpHandler::WriteModuleInfo(
+      writer_, ImageAnnotationRegistry::Get());
 }
 
 InProcessHandler::ScopedLockedWriter::ScopedLockedWriter(
@@ -162,6 +162,24 @@ class InProcessHandler {
   void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations);
 
+  //! \brief Requests that the handler convert intermediate dumps into
+  //!     minidumps on a low-priority background thread, and trigger an upload
+  //!     if possible.
+  //!
+  //! This method does not block. Conversion stops at the first intermediate
+  //! dump that would begin after \a time_budget_seconds have elapsed.
+  //! Intermediate dumps that have not been converted by then are left in
+  //! place, to be converted by a later call, such as on a later launch. If a
+  //! previous background conversion is still running, this method has no
+  //! effect.
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] time_budget_seconds The time after which no more intermediate
+  //!     dumps will begin to be converted.
+  void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations,
+      double time_budget_seconds);
+
   //! \brief Requests that the handler convert a specific intermediate dump into
   //!     a minidump and trigger an upload if possible.
   //!
@@ -180,6 +198,11 @@ class InProcessHandler {
   void StartProcessingPendingReports(
       UploadBehavior upload_behavior = UploadBehavior::kUploadWhenAppIsActive);
 
+  //! \brief Waits for a conversion started by
+  //!     ProcessIntermediateDumpsInBackground() to finish. Intended to be used
+  //!     by tests.
+  void JoinBackgroundProcessingForTesting();
+
   //! \brief Inject a callback into Mach handling. Intended to be used by
   //!     tests to trigger a reentrant exception.
   void SetMachExceptionCallbackForTesting(void (*callback)()) {
@@ -187,6 +210,8 @@ class InProcessHandler {
   }
 
  private:
+  class BackgroundProcessingThread;
+
   //! \brief Helper to start and end intermediate reports.
   class ScopedReport {
    public:
@@ -241,6 +266,20 @@ class InProcessHandler {
   //!     \a process_snapshot, and triggers the upload_thread_ if started.
   void SaveSnapshot(ProcessSnapshotIOSIntermediateDump& process_snapshot);
 
+  //! \brief Converts pending intermediate dumps until none remain, the
+  //!     ClockMonotonicNanoseconds() value \a deadline_ns is reached, or the
+  //!     handler is destroyed. Runs on background_processing_thread_, taking
+  //!     process_intermediate_dumps_lock_ for each dump in turn.
+  void ProcessIntermediateDumpsUntil(
+      const std::map<std::string, std::string>& annotations,
+      uint64_t deadline_ns);
+
+  //! \brief Converts the intermediate dump at \a file. The caller must hold
+  //!     process_intermediate_dumps_lock_.
+  void ProcessIntermediateDumpLocked(
+      const base::FilePath& file,
+      const std::map<std::string, std::string>& annotations);
+
   //! \brief Process a maximum of 20 pending intermediate dumps. Dumps named
   //!     with our bundle id get first priority to prevent spamming.
   std::vector<base::FilePath> PendingFiles();
@@ -267,6 +306,12 @@ class InProcessHandler {
 
   // Used to synchronize access to UpdatePruneAndUploadThreads().
   base::Lock prune_and_upload_lock_;
+  // Held while converting intermediate dumps, so that foreground and
+  // background conversion never pick up the same dump.
+  base::Lock process_intermediate_dumps_lock_;
+  std::unique_ptr<BackgroundProcessingThread> background_processing_thread_;
+  std::atomic_bool background_processing_running_ = false;
+  std::atomic_bool stop_background_processing_ = false;
   std::atomic_bool upload_thread_enabled_ = false;
   std::map<std::string, std::string> annotations_;
   base::FilePath base_dir_;
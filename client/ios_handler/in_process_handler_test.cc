@@ -143,6 +143,24 @@ TEST_F(InProcessHandlerTest, TestPendingFileLimit) {
   ClearFiles();
 }
 
+TEST_F(InProcessHandlerTest, ProcessIntermediateDumpsInBackground) {
+  // Clear this first to blow away the pending file held by InProcessHandler.
+  ClearFiles();
+
+  // Without a budget, nothing is converted, and the dumps are left for later.
+  CreateFiles(30, 10);
+  handler().ProcessIntermediateDumpsInBackground({}, 0);
+  handler().JoinBackgroundProcessingForTesting();
+  VerifyRemainingFileCount(30, 10);
+
+  // With enough of a budget, everything is converted, not just the 20 files
+  // that a single ProcessIntermediateDumps() would.
+  handler().ProcessIntermediateDumpsInBackground({}, 60);
+  handler().JoinBackgroundProcessingForTesting();
+  VerifyRemainingFileCount(0, 0);
+  ClearFiles();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
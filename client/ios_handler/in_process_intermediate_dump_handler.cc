@@ -21,6 +21,7 @@
 #include <sys/sysctl.h>
 #include <time.h>
 
+#include <atomic>
 #include <iterator>
 #include <optional>
 
@@ -32,6 +33,7 @@
 #include "util/ios/scoped_vm_map.h"
 #include "util/ios/scoped_vm_read.h"
 #include "util/synchronization/scoped_spin_guard.h"
+#include "util/synchronization/seqlock.h"
 
 namespace crashpad {
 namespace internal {
@@ -897,7 +899,8 @@ void InProcessIntermediateDumpHandler::WriteThreadInfo(
 
 // static
 void InProcessIntermediateDumpHandler::WriteModuleInfo(
-    IOSIntermediateDumpWriter* writer) {
+    IOSIntermediateDumpWriter* writer,
+    const ImageAnnotationRegistry* registry) {
 #ifndef ARCH_CPU_64_BITS
 #error Only 64-bit Mach-O is supported
 #endif
@@ -921,6 +924,7 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
     return;
   }
 
+  size_t registry_hint = 0;
   uint32_t image_count = image_infos->infoArrayCount;
   const dyld_image_info* image_array = image_infos->infoArray;
   for (int32_t image_index = image_count - 1; image_index >= 0; --image_index) {
@@ -939,7 +943,13 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
     WriteProperty(writer, IntermediateDumpKey::kAddress, &address);
     WriteProperty(
         writer, IntermediateDumpKey::kTimestamp, &image->imageFileModDate);
-    WriteModuleInfoAtAddress(writer, address, false /*is_dyld=false*/);
+    const ImageAnnotationRegistry::Image* registered_image =
+        registry ? registry->Find(address, &registry_hint) : nullptr;
+    if (registered_image) {
+      WriteRegisteredModuleInfo(writer, *registered_image);
+    } else {
+      WriteModuleInfoAtAddress(writer, address, false /*is_dyld=false*/);
+    }
   }
 
   {
@@ -1127,6 +1137,33 @@ void InProcessIntermediateDumpHandler::WriteModuleInfoAtAddress(
   WriteProperty(writer, IntermediateDumpKey::kFileType, &header->filetype);
 }
 
+void InProcessIntermediateDumpHandler::WriteRegisteredModuleInfo(
+    IOSIntermediateDumpWriter* writer,
+    const ImageAnnotationRegistry::Image& image) {
+  if (image.has_text_size) {
+    WriteProperty(writer, IntermediateDumpKey::kSize, &image.text_size);
+  }
+  if (image.crashpad_info_address) {
+    WriteCrashpadInfoAnnotations(writer, image.crashpad_info_address);
+  }
+  if (image.crash_info_address) {
+    WriteAppleCrashInfoAnnotations(writer, image.crash_info_address);
+  }
+  if (image.has_dylib_current_version) {
+    WriteProperty(writer,
+                  IntermediateDumpKey::kDylibCurrentVersion,
+                  &image.dylib_current_version);
+  }
+  if (image.has_source_version) {
+    WriteProperty(
+        writer, IntermediateDumpKey::kSourceVersion, &image.source_version);
+  }
+  if (image.has_uuid) {
+    WriteProperty(writer, IntermediateDumpKey::kUUID, &image.uuid);
+  }
+  WriteProperty(writer, IntermediateDumpKey::kFileType, &image.file_type);
+}
+
 void InProcessIntermediateDumpHandler::WriteDataSegmentAnnotations(
     IOSIntermediateDumpWriter* writer,
     const segment_command_64* segment_vm_read_ptr,
@@ -1137,27 +1174,40 @@ void InProcessIntermediateDumpHandler::WriteDataSegmentAnnotations(
   for (uint32_t sect_index = 0; sect_index <= segment_vm_read_ptr->nsects;
        ++sect_index) {
     if (strcmp(section_vm_read_ptr->sectname, "crashpad_info") == 0) {
-      ScopedVMRead<CrashpadInfo> crashpad_info;
-      if (crashpad_info.Read(section_vm_read_ptr->addr + slide) &&
-          crashpad_info->size() == sizeof(CrashpadInfo) &&
-          crashpad_info->signature() == CrashpadInfo::kSignature &&
-          crashpad_info->version() == 1) {
-        WriteCrashpadAnnotationsList(writer, crashpad_info.get());
-        WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
-      }
+      WriteCrashpadInfoAnnotations(writer, section_vm_read_ptr->addr + slide);
     } else if (strcmp(section_vm_read_ptr->sectname, "__crash_info") == 0) {
-      ScopedVMRead<crashreporter_annotations_t> crash_info;
-      if (!crash_info.Read(section_vm_read_ptr->addr + slide) ||
-          (crash_info->version != 4 && crash_info->version != 5)) {
-        continue;
-      }
-      WriteAppleCrashReporterAnnotations(writer, crash_info.get());
+      WriteAppleCrashInfoAnnotations(writer,
+                                     section_vm_read_ptr->addr + slide);
     }
     section_vm_read_ptr = reinterpret_cast<const section_64*>(
         reinterpret_cast<uint64_t>(section_vm_read_ptr) + sizeof(section_64));
   }
 }
 
+void InProcessIntermediateDumpHandler::WriteCrashpadInfoAnnotations(
+    IOSIntermediateDumpWriter* writer,
+    uint64_t address) {
+  ScopedVMRead<CrashpadInfo> crashpad_info;
+  if (crashpad_info.Read(address) &&
+      crashpad_info->size() == sizeof(CrashpadInfo) &&
+      crashpad_info->signature() == CrashpadInfo::kSignature &&
+      crashpad_info->version() == 1) {
+    WriteCrashpadAnnotationsList(writer, crashpad_info.get());
+    WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
+  }
+}
+
+void InProcessIntermediateDumpHandler::WriteAppleCrashInfoAnnotations(
+    IOSIntermediateDumpWriter* writer,
+    uint64_t address) {
+  ScopedVMRead<crashreporter_annotations_t> crash_info;
+  if (!crash_info.Read(address) ||
+      (crash_info->version != 4 && crash_info->version != 5)) {
+    return;
+  }
+  WriteAppleCrashReporterAnnotations(writer, crash_info.get());
+}
+
 void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
     IOSIntermediateDumpWriter* writer,
     CrashpadInfo* crashpad_info) {
@@ -1190,13 +1240,14 @@ void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
        index < kMaxNumberOfAnnotations;
        ++index) {
     ScopedVMRead<Annotation> node;
+    const Annotation* node_address = current->link_node();
 
     // Like above, use vm_read() to ensure that the node in the linked list is
     // valid and copy its memory into a newly-allocated buffer.
     //
     // In the case where the pointer has been clobbered or the memory range is
     // not readable, skip reading this and all further Annotations.
-    if (!node.Read(current->link_node())) {
+    if (!node.Read(node_address)) {
       CRASHPAD_RAW_LOG("Unable to read annotation");
       return;
     }
@@ -1240,6 +1291,39 @@ void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
       }
     }
 
+    // Seqlock-guarded Annotations are never locked. Instead, copy the value
+    // and keep the copy only if the sequence was even and unchanged around it.
+    ScopedVMRead<char> seqlock_value;
+    const void* value = node->value();
+    if (node->concurrent_access_guard_mode() ==
+        Annotation::ConcurrentAccessGuardMode::kSeqlock) {
+      constexpr int kSeqlockReadAttempts = 3;
+      bool stable = false;
+      for (int attempt = 0; attempt < kSeqlockReadAttempts && !stable;
+           ++attempt) {
+        if (attempt > 0 && !node.Read(node_address)) {
+          break;
+        }
+        const uint8_t sequence =
+            node->seqlock_state().sequence.load(std::memory_order_relaxed);
+        if (!SeqlockState::IsStable(sequence) || node->size() == 0 ||
+            node->size() > Annotation::kValueMaxSize ||
+            !seqlock_value.Read(node->value(), node->size())) {
+          continue;
+        }
+        ScopedVMRead<Annotation> recheck;
+        stable = recheck.Read(node_address) &&
+                 recheck->seqlock_state().sequence.load(
+                     std::memory_order_relaxed) == sequence;
+      }
+      if (!stable) {
+        // As with the spin guard, this is expected if the process was writing
+        // to the Annotation.
+        continue;
+      }
+      value = seqlock_value.get();
+    }
+
     IOSIntermediateDumpWriter::ScopedArrayMap annotation_map(writer);
     WritePropertyCString(writer,
                          IntermediateDumpKey::kAnnotationName,
@@ -1247,7 +1331,7 @@ void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
                          reinterpret_cast<const char*>(node->name()));
     WritePropertyBytes(writer,
                        IntermediateDumpKey::kAnnotationValue,
-                       reinterpret_cast<const void*>(node->value()),
+                       value,
                        node->size());
     Annotation::Type type = node->type();
     WritePropertyBytes(writer,
@@ -23,6 +23,7 @@
 #include <map>
 
 #include "client/crashpad_info.h"
+#include "client/ios_handler/image_annotation_registry.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/ios_system_data_collector.h"
 #include "util/mach/mach_extensions.h"
@@ -81,7 +82,12 @@ class InProcessIntermediateDumpHandler final {
   //! This includes both modules and annotations.
   //!
   //! \param[in] writer The dump writer
-  static void WriteModuleInfo(IOSIntermediateDumpWriter* writer);
+  //! \param[in] registry If not `nullptr`, images recorded here are written
+  //!     from their recorded metadata instead of by reading their load
+  //!     commands.
+  static void WriteModuleInfo(
+      IOSIntermediateDumpWriter* writer,
+      const ImageAnnotationRegistry* registry = nullptr);
 
   //! \brief Write an ExceptionSnapshot from a signal to the intermediate dump.
   //!
@@ -142,6 +148,12 @@ class InProcessIntermediateDumpHandler final {
                                        uint64_t address,
                                        bool is_dyld);
 
+  //! \brief Write module and annotation information from metadata recorded
+  //!     by an ImageAnnotationRegistry.
+  static void WriteRegisteredModuleInfo(
+      IOSIntermediateDumpWriter* writer,
+      const ImageAnnotationRegistry::Image& image);
+
   //! \brief Extract and write Apple crashreporter_annotations_t data and
   //!     Crashpad annotations. Note that \a segment_vm_read_ptr has already
   //!     been read via vm_read and may be dereferenced without a ScopedVMRead.
@@ -150,6 +162,15 @@ class InProcessIntermediateDumpHandler final {
       const segment_command_64* segment_vm_read_ptr,
       vm_size_t slide);
 
+  //! \brief Write the annotations referenced by the CrashpadInfo structure at
+  //!     \a address.
+  static void WriteCrashpadInfoAnnotations(IOSIntermediateDumpWriter* writer,
+                                           uint64_t address);
+
+  //! \brief Write the crashreporter_annotations_t data at \a address.
+  static void WriteAppleCrashInfoAnnotations(IOSIntermediateDumpWriter* writer,
+                                             uint64_t address);
+
   //! \brief Write Crashpad annotations list.
   static void WriteCrashpadAnnotationsList(IOSIntermediateDumpWriter* writer,
                                            CrashpadInfo* crashpad_info);
@@ -55,7 +55,8 @@ class InProcessIntermediateDumpHandlerTest : public testing::Test {
     EXPECT_FALSE(IsRegularFile(path_));
   }
 
-  void WriteReportAndCloseWriter() {
+  void WriteReportAndCloseWriter(
+      const internal::ImageAnnotationRegistry* registry = nullptr) {
     {
       internal::IOSIntermediateDumpWriter::ScopedRootMap rootMap(writer_.get());
       InProcessIntermediateDumpHandler::WriteHeader(writer_.get());
@@ -64,7 +65,8 @@ class InProcessIntermediateDumpHandlerTest : public testing::Test {
       InProcessIntermediateDumpHandler::WriteSystemInfo(
           writer_.get(), system_data_, ClockMonotonicNanoseconds());
       InProcessIntermediateDumpHandler::WriteThreadInfo(writer_.get(), 0, 0);
-      InProcessIntermediateDumpHandler::WriteModuleInfo(writer_.get());
+      InProcessIntermediateDumpHandler::WriteModuleInfo(writer_.get(),
+                                                        registry);
     }
     EXPECT_TRUE(writer_->Close());
   }
@@ -231,6 +233,42 @@ TEST_F(InProcessIntermediateDumpHandlerTest, TestAnnotations) {
   }
 }
 
+TEST_F(InProcessIntermediateDumpHandlerTest, TestImageAnnotationRegistry) {
+  internal::ImageAnnotationRegistry::Enable();
+  const internal::ImageAnnotationRegistry* registry =
+      internal::ImageAnnotationRegistry::Get();
+  ASSERT_NE(registry, nullptr);
+
+  crashpad::AnnotationList::Register();  // This is “leaked” to crashpad_info.
+  static crashpad::StringAnnotation<32> test_annotation{"#TEST# registry"};
+
+  // The image was recorded before this annotation was set, but annotations
+  // are still read when the dump is written.
+  test_annotation.Set("after");
+
+  WriteReportAndCloseWriter(registry);
+  internal::ProcessSnapshotIOSIntermediateDump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeWithFilePath(path(), {}));
+
+  bool saw_annotation = false;
+  for (const auto* module : process_snapshot.Modules()) {
+    EXPECT_GT(module->Size(), 0u) << module->Name();
+    for (const auto& annotation : module->AnnotationObjects()) {
+      if (annotation.name == "#TEST# registry") {
+        EXPECT_EQ(std::string(
+                      reinterpret_cast<const char*>(annotation.value.data()),
+                      annotation.value.size()),
+                  "after");
+        saw_annotation = true;
+      }
+    }
+  }
+  EXPECT_TRUE(saw_annotation);
+
+  // Keep this annotation out of TestAnnotations.
+  test_annotation.Clear();
+}
+
 TEST_F(InProcessIntermediateDumpHandlerTest, TestThreads) {
   const ScopedSetThreadName scoped_set_thread_name("TestThreads");
 
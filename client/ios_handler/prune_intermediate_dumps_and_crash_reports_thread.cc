@@ -16,6 +16,8 @@
 
 #include <utility>
 
+#include "base/logging.h"
+#include "client/crash_report_database.h"
 #include "client/prune_crash_reports.h"
 #include "util/file/directory_reader.h"
 #include "util/file/filesystem.h"
@@ -31,6 +33,13 @@ constexpr char kLockedExtension[] = ".locked";
 // Prune onces a day.
 constexpr time_t prune_interval = 60 * 60 * 24;
 
+// A prune is carried out over a series of passes, one a minute, so that each
+// pass's file system work is brief.
+constexpr double pass_interval = 60;
+
+// The number of reports deleted or intermediate dumps unlocked in one pass.
+constexpr size_t max_operations_per_pass = 16;
+
 // If the client finds a locked file matching it's own bundle id, unlock it
 // after 24 hours.
 constexpr time_t matching_bundle_locked_ttl = 60 * 60 * 24;
@@ -48,24 +57,28 @@ constexpr double app_delay = 60;
 constexpr double extension_delay = 5;
 
 
-//! \brief Unlocks old intermediate dumps.
+//! \brief Finds old intermediate dumps to unlock.
 //!
-//! This function can unlock (remove the .locked extension) intermediate dumps
-//! that are either too old to be useful, or are likely leftover dumps from
+//! Intermediate dumps can be unlocked (by removing the .locked extension) if
+//! they are either too old to be useful, or are likely leftover dumps from
 //! clean app exits.
 //!
 //! \param[in] pending_path The path to any locked intermediate dump files.
 //! \param[in] bundle_identifier_and_seperator The identifier for this client,
 //!     used to determine when locked files are considered stale.
-void UnlockOldIntermediateDumps(base::FilePath pending_path,
-                                std::string bundle_identifier_and_seperator) {
+//!
+//! \return The paths of the intermediate dumps to unlock.
+std::vector<base::FilePath> FindOldIntermediateDumps(
+    const base::FilePath& pending_path,
+    const std::string& bundle_identifier_and_seperator) {
   DirectoryReader reader;
   std::vector<base::FilePath> files;
   if (!reader.Open(pending_path)) {
-    return;
+    return files;
   }
   base::FilePath file;
   DirectoryReader::Result result;
+  time_t now = time(nullptr);
   while ((result = reader.NextFile(&file)) ==
          DirectoryReader::Result::kSuccess) {
     if (file.FinalExtension() != kLockedExtension)
@@ -73,7 +86,6 @@ void UnlockOldIntermediateDumps(base::FilePath pending_path,
 
     const base::FilePath file_path(pending_path.Append(file));
     timespec file_time;
-    time_t now = time(nullptr);
     if (!FileModificationTime(file_path, &file_time)) {
       continue;
     }
@@ -83,11 +95,10 @@ void UnlockOldIntermediateDumps(base::FilePath pending_path,
                               bundle_identifier_and_seperator) == 0 &&
          file_time.tv_sec <= now - matching_bundle_locked_ttl) ||
         (file_time.tv_sec <= now - max_locked_ttl)) {
-      base::FilePath new_path = file_path.RemoveFinalExtension();
-      MoveFileOrDirectory(file_path, new_path);
-      continue;
+      files.push_back(file_path);
     }
   }
+  return files;
 }
 
 }  // namespace
@@ -98,11 +109,17 @@ PruneIntermediateDumpsAndCrashReportsThread::
         std::unique_ptr<PruneCondition> condition,
         base::FilePath pending_path,
         std::string bundle_identifier_and_seperator,
-        bool is_extension)
-    : thread_(prune_interval, this),
+        bool is_extension,
+        std::function<bool()> should_defer_pass)
+    : thread_(pass_interval, this),
       condition_(std::move(condition)),
       pending_path_(pending_path),
       bundle_identifier_and_seperator_(bundle_identifier_and_seperator),
+      should_defer_pass_(std::move(should_defer_pass)),
+      reports_to_delete_(),
+      dumps_to_unlock_(),
+      clean_old_intermediate_dumps_(false),
+      prune_in_progress_(false),
       initial_work_delay_(is_extension ? extension_delay : app_delay),
       last_start_time_(0),
       database_(database) {}
@@ -122,26 +139,70 @@ void PruneIntermediateDumpsAndCrashReportsThread::DoWork(
     const WorkerThread* thread) {
   // This thread may be stopped and started a number of times throughout the
   // lifetime of the process to prevent 0xdead10cc kills (see
-  // crbug.com/crashpad/400), but it should only run once per prune_interval
-  // after initial_work_delay_.
-  time_t now = time(nullptr);
-  if (now - last_start_time_ < prune_interval)
+  // crbug.com/crashpad/400), but it should only begin a prune once per
+  // prune_interval after initial_work_delay_.
+  if (!prune_in_progress_ && time(nullptr) - last_start_time_ < prune_interval)
+    return;
+
+  // A deferred pass is tried again after pass_interval.
+  if (should_defer_pass_ && should_defer_pass_())
     return;
-  last_start_time_ = now;
 
   internal::ScopedBackgroundTask scoper("PruneThread");
+  if (!prune_in_progress_) {
+    BeginPrune();
+    return;
+  }
+
+  // Here and below, respect Stop() being called after each operation. Those
+  // not yet performed are left for the next pass.
+  size_t operations = 0;
+  while (!reports_to_delete_.empty() &&
+         operations < max_operations_per_pass) {
+    if (!thread_.is_running())
+      return;
+    // A report may have been uploaded and removed since the prune began.
+    CrashReportDatabase::OperationStatus status =
+        database_->DeleteReport(reports_to_delete_.back());
+    if (status != CrashReportDatabase::kNoError &&
+        status != CrashReportDatabase::kReportNotFound) {
+      LOG(ERROR) << "Database Pruning: Failed to remove report "
+                 << reports_to_delete_.back().ToString();
+    }
+    reports_to_delete_.pop_back();
+    ++operations;
+  }
+
+  while (!dumps_to_unlock_.empty() && operations < max_operations_per_pass) {
+    if (!thread_.is_running())
+      return;
+    const base::FilePath& file_path = dumps_to_unlock_.back();
+    MoveFileOrDirectory(file_path, file_path.RemoveFinalExtension());
+    dumps_to_unlock_.pop_back();
+    ++operations;
+  }
+
+  if (reports_to_delete_.empty() && dumps_to_unlock_.empty())
+    prune_in_progress_ = false;
+}
+
+void PruneIntermediateDumpsAndCrashReportsThread::BeginPrune() {
+  last_start_time_ = time(nullptr);
+  prune_in_progress_ = true;
   database_->CleanDatabase(60 * 60 * 24 * 3);
 
-  // Here and below, respect Stop() being called after each task.
+  // Here and below, respect Stop() being called after each task. The prune
+  // then completes without the remaining tasks, as it would have otherwise.
   if (!thread_.is_running())
     return;
-  PruneCrashReportDatabase(database_, condition_.get());
+  GetCrashReportsToPrune(database_, condition_.get(), &reports_to_delete_);
 
   if (!thread_.is_running())
     return;
   if (!clean_old_intermediate_dumps_) {
     clean_old_intermediate_dumps_ = true;
-    UnlockOldIntermediateDumps(pending_path_, bundle_identifier_and_seperator_);
+    dumps_to_unlock_ = FindOldIntermediateDumps(
+        pending_path_, bundle_identifier_and_seperator_);
   }
 }
 
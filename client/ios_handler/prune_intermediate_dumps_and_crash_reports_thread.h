@@ -15,9 +15,15 @@
 #ifndef CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 #define CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 
+#include <time.h>
+
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
+#include "util/misc/uuid.h"
 #include "util/thread/stoppable.h"
 #include "util/thread/worker_thread.h"
 
@@ -37,6 +43,11 @@ class PruneCondition;
 //! Locked intermediate dump files are unlocked only once, not periodically.
 //! Locked dumps that match this bundle id can be unlocked if they are over a
 //! day old. Otherwise, unlock dumps that are over 60 days old.
+//!
+//! Each prune lists the reports and intermediate dumps once, and the reports
+//! to delete and dumps to unlock are then shared by a series of short passes,
+//! each of which performs a bounded amount of file system work. A pass may be
+//! deferred, so that it does not compete with the client for disk access.
 class PruneIntermediateDumpsAndCrashReportsThread
     : public WorkerThread::Delegate,
       public Stoppable {
@@ -50,12 +61,16 @@ class PruneIntermediateDumpsAndCrashReportsThread
   //! \param[in] bundle_identifier_and_seperator The identifier for this client,
   //!  used to determine when locked files are considered stale, with a
   //!  seperator at the end to allow for substring searches.
+  //! \param[in] is_extension `true` if the client is an app extension.
+  //! \param[in] should_defer_pass If set, called before each pass. If it
+  //!     returns `true`, the pass is skipped and tried again later.
   PruneIntermediateDumpsAndCrashReportsThread(
       CrashReportDatabase* database,
       std::unique_ptr<PruneCondition> condition,
       base::FilePath pending_path,
       std::string bundle_identifier_and_seperator,
-      bool is_extension);
+      bool is_extension,
+      std::function<bool()> should_defer_pass = nullptr);
 
   PruneIntermediateDumpsAndCrashReportsThread(
       const PruneIntermediateDumpsAndCrashReportsThread&) = delete;
@@ -91,11 +106,19 @@ class PruneIntermediateDumpsAndCrashReportsThread
   // WorkerThread::Delegate:
   void DoWork(const WorkerThread* thread) override;
 
+  // Lists the reports to delete and intermediate dumps to unlock, to be worked
+  // through by this and subsequent passes.
+  void BeginPrune();
+
   WorkerThread thread_;
   std::unique_ptr<PruneCondition> condition_;
   base::FilePath pending_path_;
   std::string bundle_identifier_and_seperator_;
+  std::function<bool()> should_defer_pass_;
+  std::vector<UUID> reports_to_delete_;
+  std::vector<base::FilePath> dumps_to_unlock_;
   bool clean_old_intermediate_dumps_;
+  bool prune_in_progress_;
   double initial_work_delay_;
   time_t last_start_time_;
   CrashReportDatabase* database_;  // weak
@@ -0,0 +1,77 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/lazy_annotation.h"
+
+#include <mutex>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// Registration and evaluation are rare and never happen in a signal handler,
+// so a single lock covers the list and the count of dumps using it.
+std::mutex& LazyAnnotationLock() {
+  static std::mutex* lock = new std::mutex();
+  return *lock;
+}
+
+LazyAnnotationNode* g_lazy_annotations = nullptr;
+
+// The number of dumps that have evaluated the lazy annotations and not yet
+// released them.
+int g_lazy_annotation_users = 0;
+
+}  // namespace
+
+void RegisterLazyAnnotation(LazyAnnotationNode* node) {
+  std::lock_guard<std::mutex> lock(LazyAnnotationLock());
+  if (node->registered) {
+    return;
+  }
+  node->registered = true;
+  node->next = g_lazy_annotations;
+  g_lazy_annotations = node;
+}
+
+void EvaluateLazyAnnotations() {
+  std::lock_guard<std::mutex> lock(LazyAnnotationLock());
+  ++g_lazy_annotation_users;
+
+  // Each dump refreshes the values, even if an earlier dump already set them,
+  // so that they describe the state at the time of this dump.
+  for (LazyAnnotationNode* node = g_lazy_annotations; node;
+       node = node->next) {
+    node->evaluate(node->owner);
+  }
+}
+
+void ReleaseLazyAnnotations() {
+  std::lock_guard<std::mutex> lock(LazyAnnotationLock());
+  DCHECK_GT(g_lazy_annotation_users, 0);
+  if (--g_lazy_annotation_users > 0) {
+    return;
+  }
+
+  for (LazyAnnotationNode* node = g_lazy_annotations; node;
+       node = node->next) {
+    node->clear(node->owner);
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
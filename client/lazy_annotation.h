@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_LAZY_ANNOTATION_H_
+#define CRASHPAD_CLIENT_LAZY_ANNOTATION_H_
+
+#include <string>
+
+#include "client/annotation.h"
+
+namespace crashpad {
+
+namespace internal {
+
+//! \brief An entry in the list of annotations that are evaluated before a dump
+//!     without a crash.
+struct LazyAnnotationNode {
+  //! \brief Sets \a owner’s value by calling its callback.
+  void (*evaluate)(void* owner);
+
+  //! \brief Clears \a owner’s value.
+  void (*clear)(void* owner);
+
+  //! \brief The annotation that this node evaluates.
+  void* owner;
+
+  //! \brief The next registered node. Accessed only by
+  //!     RegisterLazyAnnotation() and the functions that walk the list.
+  LazyAnnotationNode* next;
+
+  //! \brief Whether this node has been registered.
+  bool registered;
+};
+
+//! \brief Adds \a node to the list evaluated by EvaluateLazyAnnotations().
+//!     Adding a node more than once has no effect.
+void RegisterLazyAnnotation(LazyAnnotationNode* node);
+
+//! \brief Sets the value of every registered lazy annotation.
+//!
+//! This is called by the CrashpadClient methods that dump without a crash,
+//! on the thread that requested the dump, before the dump is requested. It
+//! must never be called from a signal handler or while the process is
+//! crashing, because the callbacks may allocate or take locks.
+//!
+//! Every call must be balanced by a call to ReleaseLazyAnnotations() once the
+//! dump has been taken.
+void EvaluateLazyAnnotations();
+
+//! \brief Clears the value of every registered lazy annotation once no dump
+//!     in progress needs them.
+void ReleaseLazyAnnotations();
+
+//! \brief Evaluates the lazy annotations for the lifetime of this object.
+class ScopedLazyAnnotations {
+ public:
+  ScopedLazyAnnotations() { EvaluateLazyAnnotations(); }
+
+  ScopedLazyAnnotations(const ScopedLazyAnnotations&) = delete;
+  ScopedLazyAnnotations& operator=(const ScopedLazyAnnotations&) = delete;
+
+  ~ScopedLazyAnnotations() { ReleaseLazyAnnotations(); }
+};
+
+}  // namespace internal
+
+//! \brief A \sa StringAnnotation whose value is only produced when a dump
+//!     without a crash is requested.
+//!
+//! Some diagnostic values are expensive to keep current, and only matter when
+//! a dump is taken on purpose, such as with CrashpadClient::DumpWithoutCrash().
+//! A LazyStringAnnotation holds no value until such a dump is requested. Its
+//! callback is then run on the requesting thread just before the dump, and the
+//! value is cleared again after the dump is taken.
+//!
+//! The callback is never run for a crash, so a crash report includes a lazy
+//! annotation only if it happens while a dump without a crash is in progress.
+//! The callback must not itself request a dump.
+//!
+//! An annotation takes part once Register() has been called:
+//!
+//! \code
+//!   std::string DescribeCaches() { … }
+//!
+//!   crashpad::LazyStringAnnotation<1024> g_caches("caches", &DescribeCaches);
+//!
+//!   void Initialize() {
+//!     g_caches.Register();
+//!   }
+//! \endcode
+template <Annotation::ValueSizeType MaxSize>
+class LazyStringAnnotation : public StringAnnotation<MaxSize> {
+ public:
+  //! \brief The type of the callback that produces the annotation’s value.
+  using Callback = std::string (*)();
+
+  //! \brief Constructs a new LazyStringAnnotation with the given \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  //! \param[in] callback The function that produces the value.
+  constexpr LazyStringAnnotation(const char name[], Callback callback)
+      : StringAnnotation<MaxSize>(name),
+        callback_(callback),
+        node_{&Evaluate, &Clear, this, nullptr, false} {}
+
+  LazyStringAnnotation(const LazyStringAnnotation&) = delete;
+  LazyStringAnnotation& operator=(const LazyStringAnnotation&) = delete;
+
+  //! \brief Makes subsequent dumps without a crash evaluate this annotation.
+  void Register() { internal::RegisterLazyAnnotation(&node_); }
+
+ private:
+  static void Evaluate(void* owner) {
+    LazyStringAnnotation* annotation =
+        static_cast<LazyStringAnnotation*>(owner);
+    annotation->Set(base::StringPiece(annotation->callback_()));
+  }
+
+  static void Clear(void* owner) {
+    static_cast<LazyStringAnnotation*>(owner)->Annotation::Clear();
+  }
+
+  const Callback callback_;
+  internal::LazyAnnotationNode node_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_LAZY_ANNOTATION_H_
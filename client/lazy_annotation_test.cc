@@ -0,0 +1,100 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/lazy_annotation.h"
+
+#include <string>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+int g_evaluations = 0;
+
+std::string CountEvaluations() {
+  ++g_evaluations;
+  return "evaluation " + std::to_string(g_evaluations);
+}
+
+std::string CountOverlappingEvaluations() {
+  static int evaluations = 0;
+  return "overlapping evaluation " + std::to_string(++evaluations);
+}
+
+class LazyAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+    g_evaluations = 0;
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ protected:
+  AnnotationList annotations_;
+};
+
+TEST_F(LazyAnnotationTest, EvaluatedOnlyForDumps) {
+  static LazyStringAnnotation<32> annotation("lazy", &CountEvaluations);
+  annotation.Register();
+  // Registering again has no effect.
+  annotation.Register();
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(g_evaluations, 0);
+
+  {
+    internal::ScopedLazyAnnotations lazy_annotations;
+    EXPECT_EQ(g_evaluations, 1);
+    EXPECT_TRUE(annotation.is_set());
+    EXPECT_EQ(annotation.value(), "evaluation 1");
+  }
+  EXPECT_FALSE(annotation.is_set());
+
+  {
+    internal::ScopedLazyAnnotations lazy_annotations;
+    EXPECT_EQ(annotation.value(), "evaluation 2");
+  }
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(g_evaluations, 2);
+}
+
+TEST_F(LazyAnnotationTest, OverlappingDumps) {
+  static LazyStringAnnotation<32> annotation("lazy-overlapping",
+                                             &CountOverlappingEvaluations);
+  annotation.Register();
+
+  internal::EvaluateLazyAnnotations();
+  EXPECT_TRUE(annotation.is_set());
+  const std::string first_value(annotation.value());
+
+  // A second dump refreshes the value, and the first dump finishing does not
+  // clear it while the second is still in progress.
+  internal::EvaluateLazyAnnotations();
+  EXPECT_NE(annotation.value(), first_value);
+  internal::ReleaseLazyAnnotations();
+  EXPECT_TRUE(annotation.is_set());
+
+  internal::ReleaseLazyAnnotations();
+  EXPECT_FALSE(annotation.is_set());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_LENGTH_DELIMITED_RING_BUFFER_H_
 #define CRASHPAD_CLIENT_LENGTH_DELIMITED_RING_BUFFER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -23,8 +24,10 @@
 #include <limits>
 #include <optional>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "base/numerics/safe_math.h"
 
 namespace crashpad {
@@ -481,6 +484,135 @@ template <typename RingBufferDataType>
 LengthDelimitedRingBufferReader(RingBufferDataType&)
     -> LengthDelimitedRingBufferReader<RingBufferDataType>;
 
+//! \brief Decodes all of the variable-length buffers in the serialized bytes
+//!     of a `RingBufferData` at once.
+//!
+//! `LengthDelimitedRingBufferReader` copies each buffer out of the ring buffer
+//! in turn, a byte at a time across its length delimiter, and needs the ring
+//! buffer's capacity at compile time. This class is meant for tools that read
+//! many ring buffers of any capacity, such as from minidump annotations. It
+//! copies the readable data out of the ring buffer once, undoing any wrap
+//! around the end of the ring buffer, and then finds the boundaries of every
+//! buffer in a single pass. Each buffer is then available as a span of that
+//! copy.
+//!
+//! As with `LengthDelimitedRingBufferReader::Pop()`, decoding stops at a
+//! zero-length buffer, which is left behind by a crash in the middle of a
+//! `Push()`, or at a buffer that extends past the end of the readable data.
+class LengthDelimitedRingBufferContents final {
+ public:
+  LengthDelimitedRingBufferContents() : data_(), items_() {}
+
+  LengthDelimitedRingBufferContents(const LengthDelimitedRingBufferContents&) =
+      delete;
+  LengthDelimitedRingBufferContents& operator=(
+      const LengthDelimitedRingBufferContents&) = delete;
+
+  //! \brief Decodes the buffers in a serialized `RingBufferData`.
+  //!
+  //! \param[in] buffer The serialized `RingBufferData`, as found in a
+  //!     ring buffer annotation's value.
+  //! \param[in] length The length in bytes of \a buffer.
+  //!
+  //! \return `true` if \a buffer holds a valid `RingBufferData`, even if no
+  //!     buffers could be decoded from it, `false` otherwise.
+  bool Initialize(const void* buffer, size_t length) {
+    data_.clear();
+    items_.clear();
+
+    using Data = RingBufferData<internal::kDefaultRingBufferDataCapacity>;
+    using Header = Data::Header;
+    if (length < sizeof(Header)) {
+      return false;
+    }
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(buffer);
+    uint32_t magic;
+    uint32_t version;
+    internal::Range data_range;
+    memcpy(&magic, bytes + offsetof(Header, magic), sizeof(magic));
+    memcpy(&version, bytes + offsetof(Header, version), sizeof(version));
+    memcpy(&data_range,
+           bytes + offsetof(Header, data_range),
+           sizeof(data_range));
+    if (magic != Data::kMagic || version != Data::kVersion) {
+      return false;
+    }
+
+    // Only a ring buffer that has wrapped is serialized at its full capacity,
+    // so the serialized size stands in for the capacity when undoing a wrap.
+    const uint8_t* const ring = bytes + sizeof(Header);
+    const size_t ring_length = length - sizeof(Header);
+    if (data_range.length > ring_length ||
+        (data_range.length > 0 && data_range.offset >= ring_length)) {
+      return false;
+    }
+    const size_t first_length =
+        std::min<size_t>(data_range.length, ring_length - data_range.offset);
+    data_.reserve(data_range.length);
+    data_.insert(data_.end(),
+                 ring + data_range.offset,
+                 ring + data_range.offset + first_length);
+    data_.insert(data_.end(), ring, ring + (data_range.length - first_length));
+
+    size_t offset = 0;
+    while (offset < data_.size()) {
+      uint32_t item_length;
+      if (!ReadLength(&offset, &item_length) || item_length == 0 ||
+          item_length > data_.size() - offset) {
+        break;
+      }
+      items_.emplace_back(static_cast<uint32_t>(offset), item_length);
+      offset += item_length;
+    }
+    return true;
+  }
+
+  //! \return The number of buffers decoded.
+  size_t size() const { return items_.size(); }
+
+  //! \return The buffer at \a index, oldest first. The span remains valid
+  //!     until this object is reinitialized or destroyed.
+  base::span<const uint8_t> operator[](size_t index) const {
+    const auto& [offset, item_length] = items_[index];
+    return base::span<const uint8_t>(data_.data() + offset, item_length);
+  }
+
+ private:
+  // Decodes the Base 128 varint at *offset in data_ into *value, advancing
+  // *offset past it. Returns false if the varint is truncated or overflows.
+  bool ReadLength(size_t* offset, uint32_t* value) const {
+    // Most buffers are shorter than 128 bytes, and have one-byte delimiters.
+    const uint8_t first_byte = data_[*offset];
+    if (first_byte < 0x80) {
+      *value = first_byte;
+      ++*offset;
+      return true;
+    }
+
+    uint64_t result = 0;
+    // A 32-bit value takes at most five bytes.
+    for (int shift = 0; shift < 32 && *offset < data_.size();
+         shift += internal::kBase128ByteValueBits) {
+      const uint8_t byte = data_[(*offset)++];
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (result > std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+      if (!(byte & 0x80)) {
+        *value = static_cast<uint32_t>(result);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  //! \brief The readable data of the ring buffer, unwrapped.
+  std::vector<uint8_t> data_;
+
+  //! \brief The offset in `data_` and length of each buffer.
+  std::vector<std::pair<uint32_t, uint32_t>> items_;
+};
+
 //! \brief Writes variable-length data buffers to a `RingBufferData`,
 //!     delimited by Base128 varint-encoded length delimiters.
 //!
@@ -518,17 +650,40 @@ class LengthDelimitedRingBufferWriter final {
   //!     Otherwise, returns `false`.
   bool Push(const void* const buffer,
             typename RingBufferDataType::SizeType buffer_length) {
-    if (buffer_length == 0) {
+    return Push(nullptr, 0, buffer, buffer_length);
+  }
+
+  //! \brief Writes `prefix` followed by `buffer` to the ring buffer as a
+  //!     single item.
+  //!
+  //! This behaves as `Push(buffer, buffer_length)` for an item holding the
+  //! concatenation of `prefix` and `buffer`, without requiring the caller to
+  //! concatenate them.
+  //!
+  //! \param[in] prefix The data to be written at the start of the item.
+  //! \param[in] prefix_length The length of `prefix`, in bytes.
+  //! \param[in] buffer The data to be written after `prefix`.
+  //! \param[in] buffer_length The length of `buffer`, in bytes.
+  //! \return `true` on success, `false` otherwise.
+  bool Push(const void* const prefix,
+            typename RingBufferDataType::SizeType prefix_length,
+            const void* const buffer,
+            typename RingBufferDataType::SizeType buffer_length) {
+    internal::Range::Length item_length;
+    if (!base::CheckAdd(prefix_length, buffer_length)
+             .AssignIfValid(&item_length) ||
+        item_length == 0) {
       // Pushing a zero-length buffer is not allowed
       // (`LengthDelimitedRingBufferWriter` reserves that to represent a
       // temporarily truncated item below).
       return false;
     }
-    const internal::Range::Length buffer_varint_encoded_length =
-        internal::Base128VarintEncodedLength(buffer_length);
-    const internal::Range::Length bytes_needed =
-        buffer_varint_encoded_length + buffer_length;
-    if (bytes_needed > ring_buffer_.data.size()) {
+    const internal::Range::Length item_varint_encoded_length =
+        internal::Base128VarintEncodedLength(item_length);
+    internal::Range::Length bytes_needed;
+    if (!base::CheckAdd(item_varint_encoded_length, item_length)
+             .AssignIfValid(&bytes_needed) ||
+        bytes_needed > ring_buffer_.data.size()) {
       return false;
     }
     // If needed, move the readable region forward one buffer at a time to make
@@ -551,7 +706,7 @@ class LengthDelimitedRingBufferWriter final {
       readable_data_range.length -= bytes_to_skip;
       bytes_available += varint_length.value() + bytes_to_skip;
     }
-    // Write the varint containing `buffer_length` to the current write
+    // Write the varint containing `item_length` to the current write
     // position.
     internal::Range write_range = {
         ring_buffer_write_offset_,
@@ -559,8 +714,15 @@ class LengthDelimitedRingBufferWriter final {
     };
 
     internal::WriteBase128VarintToRingBuffer(
-        buffer_length, ring_buffer_.data, write_range);
-    // Next, write the bytes from `buffer`.
+        item_length, ring_buffer_.data, write_range);
+    // Next, write the bytes from `prefix` and `buffer`.
+    if (prefix_length > 0) {
+      internal::WriteBytesToRingBuffer(
+          reinterpret_cast<const uint8_t* const>(prefix),
+          prefix_length,
+          ring_buffer_.data,
+          write_range);
+    }
     internal::WriteBytesToRingBuffer(
         reinterpret_cast<const uint8_t* const>(buffer),
         buffer_length,
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -122,6 +123,29 @@ TEST(LengthDelimitedRingBufferTest, PushZeroLengthShouldFail) {
   ASSERT_THAT(writer.Push(nullptr, 0), IsFalse());
 }
 
+TEST(LengthDelimitedRingBufferTest, PushWithPrefixThenPopShouldSucceed) {
+  RingBufferData ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  constexpr uint8_t kPrefix[] = {0x01, 0x02};
+  ASSERT_THAT(writer.Push(kPrefix, sizeof(kPrefix), kHello, sizeof(kHello)),
+              IsTrue());
+  ASSERT_THAT(writer.Push(kPrefix, sizeof(kPrefix), nullptr, 0), IsTrue());
+  ASSERT_THAT(writer.Push(nullptr, 0, nullptr, 0), IsFalse());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> data;
+  EXPECT_THAT(reader.Pop(data), IsTrue());
+  const std::vector<uint8_t> expected1 = {0x01, 0x02, 0x68, 0x65, 0x6c, 0x6c,
+                                          0x6f};
+  EXPECT_THAT(data, Eq(expected1));
+  data.clear();
+  EXPECT_THAT(reader.Pop(data), IsTrue());
+  const std::vector<uint8_t> expected2 = {0x01, 0x02};
+  EXPECT_THAT(data, Eq(expected2));
+  data.clear();
+  EXPECT_THAT(reader.Pop(data), IsFalse());
+}
+
 TEST(LengthDelimitedRingBufferTest, PushExactlyBufferSizeThenPopShouldSucceed) {
   RingBufferData ring_buffer;
   LengthDelimitedRingBufferWriter writer(ring_buffer);
@@ -343,6 +367,106 @@ TEST(LengthDelimitedRingBufferDataTest,
   EXPECT_THAT(reader.Pop(data), IsFalse());
 }
 
+std::vector<uint8_t> ContentsItem(
+    const LengthDelimitedRingBufferContents& contents,
+    size_t index) {
+  const base::span<const uint8_t> item = contents[index];
+  return std::vector<uint8_t>(item.begin(), item.end());
+}
+
+TEST(LengthDelimitedRingBufferContentsTest, MatchesReader) {
+  RingBufferData<16> ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+
+  // Push enough to evict the first items and wrap around the end of the ring
+  // buffer.
+  const std::vector<std::vector<uint8_t>> pushed = {
+      {1, 2, 3}, {4, 5, 6, 7}, {8, 9}, {10, 11, 12, 13, 14}, {15, 16, 17}};
+  for (const auto& item : pushed) {
+    ASSERT_THAT(writer.Push(item.data(),
+                            static_cast<RingBufferCapacity>(item.size())),
+                IsTrue());
+  }
+
+  LengthDelimitedRingBufferContents contents;
+  ASSERT_THAT(
+      contents.Initialize(&ring_buffer, ring_buffer.GetRingBufferLength()),
+      IsTrue());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<std::vector<uint8_t>> popped;
+  std::vector<uint8_t> data;
+  while (reader.Pop(data)) {
+    popped.push_back(data);
+    data.clear();
+  }
+  ASSERT_THAT(popped.size(), Eq(3u));
+  EXPECT_THAT(popped.back(), Eq(pushed.back()));
+
+  ASSERT_THAT(contents.size(), Eq(popped.size()));
+  for (size_t index = 0; index < contents.size(); ++index) {
+    EXPECT_THAT(ContentsItem(contents, index), Eq(popped[index]));
+  }
+}
+
+TEST(LengthDelimitedRingBufferContentsTest, LongItem) {
+  RingBufferData ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  const std::vector<uint8_t> long_item(300, 0x5a);
+  ASSERT_THAT(writer.Push(long_item.data(),
+                          static_cast<RingBufferCapacity>(long_item.size())),
+              IsTrue());
+  ASSERT_THAT(writer.Push(kHello, sizeof(kHello)), IsTrue());
+
+  LengthDelimitedRingBufferContents contents;
+  ASSERT_THAT(
+      contents.Initialize(&ring_buffer, ring_buffer.GetRingBufferLength()),
+      IsTrue());
+  ASSERT_THAT(contents.size(), Eq(2u));
+  EXPECT_THAT(ContentsItem(contents, 0), Eq(long_item));
+  EXPECT_THAT(ContentsItem(contents, 1),
+              Eq(std::vector<uint8_t>(std::begin(kHello), std::end(kHello))));
+}
+
+TEST(LengthDelimitedRingBufferContentsTest, InvalidBuffers) {
+  LengthDelimitedRingBufferContents contents;
+  EXPECT_THAT(contents.Initialize(kInvalidVersionBuffer, 8), IsFalse());
+  EXPECT_THAT(
+      contents.Initialize(kInvalidVersionBuffer, kInvalidVersionBufferLen),
+      IsFalse());
+
+  // The data range of a valid header must fit the serialized data.
+  EXPECT_THAT(contents.Initialize(kValidBufferSize3, kValidBufferSize3Len - 1),
+              IsFalse());
+
+  ASSERT_THAT(contents.Initialize(kValidBufferSize3, kValidBufferSize3Len),
+              IsTrue());
+  ASSERT_THAT(contents.size(), Eq(1u));
+  EXPECT_THAT(ContentsItem(contents, 0), Eq(std::vector<uint8_t>{0x42, 0x23}));
+}
+
+TEST(LengthDelimitedRingBufferContentsTest, TruncatedItems) {
+  LengthDelimitedRingBufferContents contents;
+  ASSERT_THAT(contents.Initialize(kMidCrashBuffer, kMidCrashBufferLen),
+              IsTrue());
+  EXPECT_THAT(contents.size(), Eq(0u));
+
+  ASSERT_THAT(contents.Initialize(kInvalidBase128VarintBuffer,
+                                  kInvalidBase128VarintBufferLen),
+              IsTrue());
+  EXPECT_THAT(contents.size(), Eq(0u));
+
+  ASSERT_THAT(contents.Initialize(kInvalidBase128VarintBits33And34SetBuffer,
+                                  kInvalidBase128VarintBits33And34SetBufferLen),
+              IsTrue());
+  EXPECT_THAT(contents.size(), Eq(0u));
+
+  ASSERT_THAT(contents.Initialize(kInvalidPayloadBufferTooShort,
+                                  kInvalidPayloadBufferTooShortLen),
+              IsTrue());
+  EXPECT_THAT(contents.size(), Eq(0u));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
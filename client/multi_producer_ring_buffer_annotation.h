@@ -0,0 +1,395 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_ANNOTATION_H_
+#define CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_ANNOTATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "client/annotation.h"
+#include "client/length_delimited_ring_buffer.h"
+
+namespace crashpad {
+
+namespace internal {
+
+//! \brief Default capacity of each shard of a
+//!     `MultiProducerRingBufferAnnotation`, in bytes.
+inline constexpr RingBufferCapacity
+    kDefaultMultiProducerRingBufferShardCapacity = 1024;
+
+//! \brief Default number of shards of a `MultiProducerRingBufferAnnotation`.
+inline constexpr size_t kDefaultMultiProducerRingBufferShardCount = 8;
+
+//! \brief Returns a small integer identifying the calling thread.
+//!
+//! Threads are numbered in the order in which they first call this function,
+//! so that consecutive threads prefer different shards.
+inline size_t MultiProducerRingBufferThreadIndex() {
+  static std::atomic<size_t> next_thread_index(0);
+  thread_local size_t thread_index =
+      next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_index;
+}
+
+}  // namespace internal
+
+//! \brief Storage for a ring buffer split into `ShardCount` independent
+//!     `RingBufferData` shards of `ShardCapacity` bytes each.
+//!
+//! The structure of this object is:
+//!
+//! `|magic|version|shard_count|shard_capacity|shard|shard|...|`
+//!
+//! where each shard is:
+//!
+//! `|busy|reserved|RingBufferData|`
+//!
+//! Each item in a shard is prefixed by a 64-bit sequence number in host byte
+//! order, which orders items across shards. `busy` is nonzero while an item is
+//! being written to the shard.
+//!
+//! To write data to this object, see `MultiProducerRingBufferAnnotation`.
+//! To read data from this object, see `MultiProducerRingBufferReader`.
+template <RingBufferCapacity ShardCapacity, size_t ShardCount>
+struct MultiProducerRingBufferData final {
+  MultiProducerRingBufferData() = default;
+  MultiProducerRingBufferData(MultiProducerRingBufferData&) = delete;
+  MultiProducerRingBufferData& operator=(MultiProducerRingBufferData&) = delete;
+
+  //! \brief The type of each shard's ring buffer.
+  using ShardData = RingBufferData<ShardCapacity>;
+
+  //! \brief Attempts to overwrite the contents of this object by deserializing
+  //!     the buffer into this object.
+  //! \param[in] buffer The bytes to deserialize into this object.
+  //! \param[in] length The length in bytes of `buffer`.
+  //!
+  //! \return `true` if the buffer was a valid `MultiProducerRingBufferData`
+  //!     with the same shard count and capacity as this object, `false`
+  //!     otherwise.
+  bool DeserializeFromBuffer(const void* buffer, size_t length) {
+    if (length != sizeof(*this)) {
+      return false;
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+    uint32_t other_header[4];
+    memcpy(other_header, bytes, sizeof(other_header));
+    if (other_header[0] != kMagic || other_header[1] != kVersion ||
+        other_header[2] != ShardCount || other_header[3] != ShardCapacity) {
+      return false;
+    }
+    for (size_t index = 0; index < ShardCount; ++index) {
+      const uint8_t* shard_bytes =
+          bytes + sizeof(Header) + index * sizeof(Shard);
+      uint32_t busy;
+      memcpy(&busy, shard_bytes, sizeof(busy));
+      shards[index].busy.store(busy, std::memory_order_relaxed);
+      if (!shards[index].data.DeserializeFromBuffer(
+              shard_bytes + kShardDataOffset, sizeof(ShardData))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //! \brief Resets the state of the ring buffer (e.g., for testing).
+  void ResetForTesting() {
+    for (Shard& shard : shards) {
+      shard.busy.store(0, std::memory_order_relaxed);
+      shard.data.ResetForTesting();
+    }
+  }
+
+  //! \brief The magic signature of the ring buffer.
+  static constexpr uint32_t kMagic = 0xcab00d1f;
+  //! \brief The version of the ring buffer.
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief A header containing metadata preceding the shards.
+  struct Header final {
+    Header()
+        : magic(kMagic),
+          version(kVersion),
+          shard_count(ShardCount),
+          shard_capacity(ShardCapacity) {}
+
+    //! \brief The fixed magic value identifying this as a sharded ring buffer.
+    const uint32_t magic;
+
+    //! \brief The version of this ring buffer data.
+    const uint32_t version;
+
+    //! \brief The number of shards following the header.
+    const uint32_t shard_count;
+
+    //! \brief The capacity of each shard's ring buffer data, in bytes.
+    const uint32_t shard_capacity;
+  };
+
+  //! \brief A single shard, written by one thread at a time.
+  struct Shard final {
+    Shard() : busy(0), reserved(0), data() {}
+
+    //! \brief Nonzero while an item is being written to this shard.
+    std::atomic<uint32_t> busy;
+
+    //! \brief Unused, for alignment.
+    uint32_t reserved;
+
+    //! \brief The ring buffer holding this shard's items.
+    ShardData data;
+  };
+
+  //! \brief The offset of `Shard::data` within a shard.
+  static constexpr size_t kShardDataOffset = 2 * sizeof(uint32_t);
+
+  //! \brief The header containing ring buffer metadata.
+  Header header;
+
+  //! \brief The shards.
+  std::array<Shard, ShardCount> shards;
+
+  // This struct is persisted to disk, so its layout must not change.
+  static_assert(sizeof(Header) == 16);
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+  static_assert(ShardCapacity % sizeof(uint32_t) == 0,
+                "shards must be packed");
+  static_assert(ShardCount > 0 &&
+                ShardCount <= std::numeric_limits<uint32_t>::max());
+};
+
+//! \brief Reads the items from a `MultiProducerRingBufferData`, in the order
+//!     in which they were written.
+//!
+//! All items are read from the ring buffer when this object is constructed.
+//! The items of a shard that was being written to are unreliable, and are
+//! skipped.
+template <typename MultiProducerRingBufferDataType>
+class MultiProducerRingBufferReader final {
+ public:
+  //! \brief Constructs a reader of the items in `ring_buffer`.
+  //! \param[in] ring_buffer The ring buffer from which data will be read.
+  explicit MultiProducerRingBufferReader(
+      const MultiProducerRingBufferDataType& ring_buffer)
+      : items_(), next_item_(0) {
+    for (const auto& shard : ring_buffer.shards) {
+      if (shard.busy.load(std::memory_order_acquire)) {
+        continue;
+      }
+      LengthDelimitedRingBufferReader<
+          const typename MultiProducerRingBufferDataType::ShardData>
+          reader(shard.data);
+      std::vector<uint8_t> item;
+      while (reader.Pop(item)) {
+        uint64_t sequence;
+        if (item.size() < sizeof(sequence)) {
+          break;
+        }
+        memcpy(&sequence, item.data(), sizeof(sequence));
+        items_.emplace_back(
+            sequence,
+            std::vector<uint8_t>(item.begin() + sizeof(sequence), item.end()));
+        item.clear();
+      }
+    }
+    std::sort(items_.begin(),
+              items_.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+  }
+
+  MultiProducerRingBufferReader(const MultiProducerRingBufferReader&) = delete;
+  MultiProducerRingBufferReader& operator=(
+      const MultiProducerRingBufferReader&) = delete;
+
+  //! \brief Pops off the oldest remaining item.
+  //!
+  //! \param[in] target_buffer On success, the buffer to which the item's data
+  //!     will be appended.
+  //! \return `true` on success, `false` if no items remain.
+  bool Pop(std::vector<uint8_t>& target_buffer) {
+    if (next_item_ == items_.size()) {
+      return false;
+    }
+    const std::vector<uint8_t>& item = items_[next_item_++].second;
+    target_buffer.insert(target_buffer.end(), item.begin(), item.end());
+    return true;
+  }
+
+ private:
+  //! \brief The items read, with their sequence numbers, in sequence order.
+  std::vector<std::pair<uint64_t, std::vector<uint8_t>>> items_;
+
+  //! \brief The index in `items_` of the next item to return from `Pop()`.
+  size_t next_item_;
+};
+
+// Allow just `MultiProducerRingBufferReader reader(foo);` to be declared
+// without template arguments using C++17 class template argument deduction.
+template <typename MultiProducerRingBufferDataType>
+MultiProducerRingBufferReader(const MultiProducerRingBufferDataType&)
+    -> MultiProducerRingBufferReader<MultiProducerRingBufferDataType>;
+
+//! \brief An `Annotation` holding a ring buffer that many threads can write to
+//!     concurrently without locking.
+//!
+//! This is an alternative to `RingBufferAnnotation`, whose `Push()` fails when
+//! another thread is writing. The ring buffer is split into `ShardCount`
+//! shards of up to `ShardCapacity` bytes each. Each thread prefers its own
+//! shard, and moves on to the next free shard if another thread is writing to
+//! it. When the ring buffer is used by no more than `ShardCount` threads at a
+//! time, each thread writes to its own shard and writers never interfere with
+//! each other.
+//!
+//! Each item is tagged with a sequence number so that the items of all shards
+//! can be read back in the order in which they were written. Each shard drops
+//! its own oldest items in FIFO order when it is full. The ring buffer
+//! therefore retains the most recent items of each shard, rather than the most
+//! recent items overall.
+//!
+//! Readers do not synchronize with writers. Instead, a shard that was being
+//! written to when the ring buffer was read is marked busy, and its items are
+//! discarded by `MultiProducerRingBufferReader`.
+//!
+//! To deserialize the items stored in this annotation, use
+//! `MultiProducerRingBufferData::DeserializeFromBuffer()` followed by
+//! `MultiProducerRingBufferReader`.
+template <
+    RingBufferCapacity ShardCapacity =
+        internal::kDefaultMultiProducerRingBufferShardCapacity,
+    size_t ShardCount = internal::kDefaultMultiProducerRingBufferShardCount>
+class MultiProducerRingBufferAnnotation final : public Annotation {
+ public:
+  //! \brief The type of the data stored in this annotation.
+  using DataType = MultiProducerRingBufferData<ShardCapacity, ShardCount>;
+
+  //! \brief Constructs a `MultiProducerRingBufferAnnotation`.
+  //! \param[in] type A unique identifier for the type of data in the ring
+  //!     buffer.
+  //! \param[in] name The name of the annotation.
+  MultiProducerRingBufferAnnotation(Annotation::Type type, const char name[])
+      : Annotation(type,
+                   name,
+                   reinterpret_cast<void* const>(&ring_buffer_data_),
+                   ConcurrentAccessGuardMode::kUnguarded),
+        ring_buffer_data_(),
+        ring_buffer_writers_(MakeWriters(
+            ring_buffer_data_, std::make_index_sequence<ShardCount>())),
+        next_sequence_(0),
+        size_set_(false) {}
+
+  MultiProducerRingBufferAnnotation(const MultiProducerRingBufferAnnotation&) =
+      delete;
+  MultiProducerRingBufferAnnotation& operator=(
+      const MultiProducerRingBufferAnnotation&) = delete;
+
+  //! \brief Pushes data onto this annotation's ring buffer.
+  //!
+  //! This may be called by any number of threads concurrently. If the shard
+  //! that the data is written to does not have enough space to store
+  //! `buffer_length` bytes of data, old data items in that shard are dropped in
+  //! FIFO order until enough space is available to store the new data.
+  //!
+  //! \return `true` on success. `false` if the data is empty or too large for
+  //!     a shard, or if every shard was being written to by another thread.
+  bool Push(const void* const buffer,
+            RingBufferCapacity buffer_length) {
+    if (buffer_length == 0) {
+      return false;
+    }
+
+    const size_t first_shard =
+        internal::MultiProducerRingBufferThreadIndex() % ShardCount;
+    for (size_t attempt = 0; attempt < ShardCount; ++attempt) {
+      const size_t index = (first_shard + attempt) % ShardCount;
+      auto& shard = ring_buffer_data_.shards[index];
+      if (shard.busy.exchange(1, std::memory_order_acquire)) {
+        continue;
+      }
+
+      const uint64_t sequence =
+          next_sequence_.fetch_add(1, std::memory_order_relaxed);
+      const bool success = ring_buffer_writers_[index].Push(
+          &sequence, sizeof(sequence), buffer, buffer_length);
+      shard.busy.store(0, std::memory_order_release);
+
+      // The size never changes, so only the first successful Push() needs to
+      // set it.
+      if (success && !size_set_.load(std::memory_order_relaxed) &&
+          !size_set_.exchange(true, std::memory_order_relaxed)) {
+        SetSize(sizeof(ring_buffer_data_));
+      }
+      return success;
+    }
+    return false;
+  }
+
+  //! \brief Excludes this annotation from crash reports until the next
+  //!     `Push()`.
+  //!
+  //! The items already in the ring buffer are retained.
+  void Clear() {
+    size_set_.store(false, std::memory_order_relaxed);
+    Annotation::Clear();
+  }
+
+  //! \brief Reset the annotation (e.g., for testing).
+  //! This method is not thread-safe.
+  void ResetForTesting() {
+    ring_buffer_data_.ResetForTesting();
+    for (auto& writer : ring_buffer_writers_) {
+      writer.ResetForTesting();
+    }
+  }
+
+ private:
+  using RingBufferWriter =
+      LengthDelimitedRingBufferWriter<typename DataType::ShardData>;
+
+  template <size_t... Indices>
+  static std::array<RingBufferWriter, ShardCount> MakeWriters(
+      DataType& data,
+      std::index_sequence<Indices...>) {
+    return {RingBufferWriter(data.shards[Indices].data)...};
+  }
+
+  //! \brief The ring buffer data stored in this Annotation.
+  DataType ring_buffer_data_;
+
+  //! \brief The writers which wrap each of the shards of `ring_buffer_data_`.
+  //!     Each writer is only used by the thread which has marked its shard
+  //!     busy.
+  std::array<RingBufferWriter, ShardCount> ring_buffer_writers_;
+
+  //! \brief The sequence number of the next item to be written.
+  std::atomic<uint64_t> next_sequence_;
+
+  //! \brief Whether the size of this annotation has been set.
+  std::atomic<bool> size_set_;
+
+  static_assert(sizeof(DataType) < Annotation::kValueMaxSize);
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_ANNOTATION_H_
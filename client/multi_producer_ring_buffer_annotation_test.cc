@@ -0,0 +1,227 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/multi_producer_ring_buffer_annotation.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr Annotation::Type kType = Annotation::UserDefinedType(1);
+constexpr char kName[] = "multi-producer annotation";
+
+class MultiProducerRingBufferAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ protected:
+  AnnotationList annotations_;
+};
+
+template <typename AnnotationType>
+std::vector<std::string> ReadItems(const AnnotationType& annotation) {
+  typename AnnotationType::DataType data;
+  EXPECT_TRUE(
+      data.DeserializeFromBuffer(annotation.value(), annotation.size()));
+  MultiProducerRingBufferReader reader(data);
+  std::vector<std::string> items;
+  std::vector<uint8_t> item;
+  while (reader.Pop(item)) {
+    items.emplace_back(item.begin(), item.end());
+    item.clear();
+  }
+  return items;
+}
+
+bool PushString(MultiProducerRingBufferAnnotation<>& annotation,
+                const std::string& string) {
+  return annotation.Push(string.data(),
+                         static_cast<RingBufferCapacity>(string.size()));
+}
+
+TEST_F(MultiProducerRingBufferAnnotationTest, Basics) {
+  MultiProducerRingBufferAnnotation annotation(kType, kName);
+
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(annotation.type(), kType);
+  EXPECT_EQ(std::string(annotation.name()), kName);
+
+  EXPECT_TRUE(PushString(annotation, "0123456789"));
+  EXPECT_TRUE(PushString(annotation, "ABCDEF"));
+
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(annotation.size(),
+            sizeof(MultiProducerRingBufferAnnotation<>::DataType));
+  EXPECT_EQ(*annotations_.begin(), &annotation);
+
+  EXPECT_EQ(ReadItems(annotation),
+            (std::vector<std::string>{"0123456789", "ABCDEF"}));
+
+  annotation.Clear();
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_TRUE(PushString(annotation, "again"));
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(ReadItems(annotation),
+            (std::vector<std::string>{"0123456789", "ABCDEF", "again"}));
+
+  // Nothing may be pushed that can't fit in a shard.
+  EXPECT_FALSE(annotation.Push("x", 0));
+  EXPECT_FALSE(PushString(
+      annotation,
+      std::string(internal::kDefaultMultiProducerRingBufferShardCapacity,
+                  'x')));
+}
+
+TEST_F(MultiProducerRingBufferAnnotationTest, WrapsWithinShard) {
+  MultiProducerRingBufferAnnotation<64, 1> annotation(kType, kName);
+
+  // Each item occupies 1 + 8 + 4 bytes, so only the most recent 4 fit.
+  for (int i = 0; i < 10; ++i) {
+    char item[5];
+    snprintf(item, sizeof(item), "%04d", i);
+    ASSERT_TRUE(annotation.Push(item, 4));
+  }
+  EXPECT_EQ(ReadItems(annotation),
+            (std::vector<std::string>{"0006", "0007", "0008", "0009"}));
+}
+
+TEST_F(MultiProducerRingBufferAnnotationTest, BusyShardIsSkipped) {
+  MultiProducerRingBufferAnnotation<64, 2> annotation(kType, kName);
+  ASSERT_TRUE(annotation.Push("one", 3));
+
+  // Simulate a crash while a write to every shard was in progress. No writer
+  // can claim a shard, and the reader ignores the shards' contents.
+  std::vector<uint8_t> bytes(
+      reinterpret_cast<const uint8_t*>(annotation.value()),
+      reinterpret_cast<const uint8_t*>(annotation.value()) + annotation.size());
+  using DataType = decltype(annotation)::DataType;
+  for (size_t index = 0; index < 2; ++index) {
+    const uint32_t busy = 1;
+    memcpy(&bytes[sizeof(DataType::Header) + index * sizeof(DataType::Shard)],
+           &busy,
+           sizeof(busy));
+  }
+  DataType data;
+  ASSERT_TRUE(data.DeserializeFromBuffer(bytes.data(), bytes.size()));
+  MultiProducerRingBufferReader reader(data);
+  std::vector<uint8_t> item;
+  EXPECT_FALSE(reader.Pop(item));
+}
+
+TEST_F(MultiProducerRingBufferAnnotationTest, DeserializeMismatchFails) {
+  MultiProducerRingBufferAnnotation<64, 2> annotation(kType, kName);
+  ASSERT_TRUE(annotation.Push("one", 3));
+
+  MultiProducerRingBufferData<64, 4> wrong_shard_count;
+  EXPECT_FALSE(wrong_shard_count.DeserializeFromBuffer(annotation.value(),
+                                                       annotation.size()));
+
+  std::vector<uint8_t> bytes(
+      reinterpret_cast<const uint8_t*>(annotation.value()),
+      reinterpret_cast<const uint8_t*>(annotation.value()) + annotation.size());
+  bytes[0] ^= 0xff;
+  MultiProducerRingBufferData<64, 2> data;
+  EXPECT_FALSE(data.DeserializeFromBuffer(bytes.data(), bytes.size()));
+  EXPECT_FALSE(data.DeserializeFromBuffer(bytes.data(), bytes.size() - 1));
+}
+
+class PushThread : public Thread {
+ public:
+  PushThread(MultiProducerRingBufferAnnotation<>* annotation,
+             int thread_index,
+             int count)
+      : annotation_(annotation),
+        thread_index_(thread_index),
+        count_(count),
+        failures_(0) {}
+
+  int failures() const { return failures_; }
+
+ private:
+  void ThreadMain() override {
+    for (int i = 0; i < count_; ++i) {
+      char item[16];
+      int length = snprintf(item, sizeof(item), "%d %05d", thread_index_, i);
+      if (!annotation_->Push(item, length)) {
+        ++failures_;
+      }
+    }
+  }
+
+  MultiProducerRingBufferAnnotation<>* annotation_;
+  int thread_index_;
+  int count_;
+  int failures_;
+};
+
+TEST_F(MultiProducerRingBufferAnnotationTest, MultipleThreads) {
+  MultiProducerRingBufferAnnotation annotation(kType, kName);
+
+  constexpr int kThreads = 8;
+  constexpr int kPushesPerThread = 2000;
+  std::vector<std::unique_ptr<PushThread>> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.push_back(
+        std::make_unique<PushThread>(&annotation, i, kPushesPerThread));
+  }
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  // A push can only fail if every shard was busy at once.
+  for (auto& thread : threads) {
+    EXPECT_LT(thread->failures(), kPushesPerThread);
+  }
+
+  // Every item read back is intact, and each thread's items are in the order
+  // in which that thread pushed them.
+  std::vector<std::string> items = ReadItems(annotation);
+  EXPECT_FALSE(items.empty());
+  std::vector<int> last_item(kThreads, -1);
+  for (const std::string& item : items) {
+    int thread_index;
+    int index;
+    ASSERT_EQ(sscanf(item.c_str(), "%d %d", &thread_index, &index), 2)
+        << item;
+    ASSERT_GE(thread_index, 0);
+    ASSERT_LT(thread_index, kThreads);
+    EXPECT_GT(index, last_item[thread_index]);
+    last_item[thread_index] = index;
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -26,22 +26,32 @@
 
 namespace crashpad {
 
-size_t PruneCrashReportDatabase(CrashReportDatabase* database,
-                              PruneCondition* condition) {
+bool GetCrashReportsToPrune(CrashReportDatabase* database,
+                            PruneCondition* condition,
+                            std::vector<UUID>* uuids) {
+  uuids->clear();
+  condition->Reset();
+
+  CrashReportDatabase::ReportsSummary summary;
+  if (database->GetReportsSummary(&summary) &&
+      !condition->MayPruneAnyReport(summary)) {
+    return true;
+  }
+
   std::vector<CrashReportDatabase::Report> all_reports;
   CrashReportDatabase::OperationStatus status;
 
   status = database->GetPendingReports(&all_reports);
   if (status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "PruneCrashReportDatabase: Failed to get pending reports";
-    return 0;
+    return false;
   }
 
   std::vector<CrashReportDatabase::Report> completed_reports;
   status = database->GetCompletedReports(&completed_reports);
   if (status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "PruneCrashReportDatabase: Failed to get completed reports";
-    return 0;
+    return false;
   }
   all_reports.insert(all_reports.end(), completed_reports.begin(),
                      completed_reports.end());
@@ -52,16 +62,29 @@ size_t PruneCrashReportDatabase(CrashReportDatabase* database,
         return lhs.creation_time > rhs.creation_time;
       });
 
-  size_t num_pruned = 0;
   for (const auto& report : all_reports) {
     if (condition->ShouldPruneReport(report)) {
-      status = database->DeleteReport(report.uuid);
-      if (status != CrashReportDatabase::kNoError) {
-        LOG(ERROR) << "Database Pruning: Failed to remove report "
-                   << report.uuid.ToString();
-      } else {
-        num_pruned++;
-      }
+      uuids->push_back(report.uuid);
+    }
+  }
+  return true;
+}
+
+size_t PruneCrashReportDatabase(CrashReportDatabase* database,
+                              PruneCondition* condition) {
+  std::vector<UUID> uuids;
+  if (!GetCrashReportsToPrune(database, condition, &uuids)) {
+    return 0;
+  }
+
+  size_t num_pruned = 0;
+  for (const UUID& uuid : uuids) {
+    CrashReportDatabase::OperationStatus status = database->DeleteReport(uuid);
+    if (status != CrashReportDatabase::kNoError) {
+      LOG(ERROR) << "Database Pruning: Failed to remove report "
+                 << uuid.ToString();
+    } else {
+      num_pruned++;
     }
   }
 
@@ -85,12 +108,24 @@ std::unique_ptr<PruneCondition> PruneCondition::GetDefault() {
 static const time_t kSecondsInDay = 60 * 60 * 24;
 
 AgePruneCondition::AgePruneCondition(int max_age_in_days)
-    : oldest_report_time_(
-        ((time(nullptr) - (max_age_in_days * kSecondsInDay))
-             / kSecondsInDay) * kSecondsInDay) {}
+    : max_age_in_days_(max_age_in_days), oldest_report_time_() {
+  Reset();
+}
 
 AgePruneCondition::~AgePruneCondition() {}
 
+void AgePruneCondition::Reset() {
+  oldest_report_time_ =
+      ((time(nullptr) - (max_age_in_days_ * kSecondsInDay)) / kSecondsInDay) *
+      kSecondsInDay;
+}
+
+bool AgePruneCondition::MayPruneAnyReport(
+    const CrashReportDatabase::ReportsSummary& summary) {
+  return summary.report_count > 0 &&
+         summary.oldest_creation_time < oldest_report_time_;
+}
+
 bool AgePruneCondition::ShouldPruneReport(
     const CrashReportDatabase::Report& report) {
   return report.creation_time < oldest_report_time_;
@@ -101,6 +136,19 @@ DatabaseSizePruneCondition::DatabaseSizePruneCondition(size_t max_size_in_kb)
 
 DatabaseSizePruneCondition::~DatabaseSizePruneCondition() {}
 
+void DatabaseSizePruneCondition::Reset() {
+  measured_size_in_kb_ = 0;
+}
+
+bool DatabaseSizePruneCondition::MayPruneAnyReport(
+    const CrashReportDatabase::ReportsSummary& summary) {
+  // ShouldPruneReport() rounds each report up to a whole KB, adding less than
+  // 1 KB per report.
+  const uint64_t max_measured_size_in_kb =
+      (summary.total_size + 1023) / 1024 + summary.report_count;
+  return max_measured_size_in_kb > max_size_in_kb_;
+}
+
 bool DatabaseSizePruneCondition::ShouldPruneReport(
     const CrashReportDatabase::Report& report) {
   // Round up fractional KB to the next 1-KB boundary.
@@ -115,6 +163,24 @@ BinaryPruneCondition::BinaryPruneCondition(
 
 BinaryPruneCondition::~BinaryPruneCondition() {}
 
+void BinaryPruneCondition::Reset() {
+  lhs_->Reset();
+  rhs_->Reset();
+}
+
+bool BinaryPruneCondition::MayPruneAnyReport(
+    const CrashReportDatabase::ReportsSummary& summary) {
+  switch (op_) {
+    case AND:
+      return lhs_->MayPruneAnyReport(summary) &&
+             rhs_->MayPruneAnyReport(summary);
+    case OR:
+      return lhs_->MayPruneAnyReport(summary) ||
+             rhs_->MayPruneAnyReport(summary);
+  }
+  NOTREACHED();
+}
+
 bool BinaryPruneCondition::ShouldPruneReport(
     const CrashReportDatabase::Report& report) {
   switch (op_) {
@@ -19,8 +19,10 @@
 #include <time.h>
 
 #include <memory>
+#include <vector>
 
 #include "client/crash_report_database.h"
+#include "util/misc/uuid.h"
 
 namespace crashpad {
 
@@ -33,6 +35,10 @@ class PruneCondition;
 //! sorted in descending order by CrashReportDatabase::Report::creation_time.
 //! This guarantee allows conditions to be stateful.
 //!
+//! Where \a database can provide a CrashReportDatabase::ReportsSummary and
+//! \a condition determines from it that no report would be deleted, the
+//! reports are not examined individually.
+//!
 //! \param[in] database The database from which crash reports will be deleted.
 //! \param[in] condition The condition against which all reports in the database
 //!     will be evaluated.
@@ -41,6 +47,24 @@ class PruneCondition;
 size_t PruneCrashReportDatabase(CrashReportDatabase* database,
                                 PruneCondition* condition);
 
+//! \brief Determines which crash reports in \a database match \a condition,
+//!     without deleting them.
+//!
+//! The reports are evaluated as they are by PruneCrashReportDatabase(). This
+//! allows a caller to spread the deletions over time, without listing and
+//! evaluating the reports in \a database again for each batch.
+//!
+//! \param[in] database The database whose crash reports will be evaluated.
+//! \param[in] condition The condition against which all reports in the database
+//!     will be evaluated.
+//! \param[out] uuids The UUIDs of the reports that should be deleted.
+//!
+//! \return `true` on success. `false` if the reports in \a database could not
+//!     be listed, with a message logged.
+bool GetCrashReportsToPrune(CrashReportDatabase* database,
+                            PruneCondition* condition,
+                            std::vector<UUID>* uuids);
+
 std::unique_ptr<PruneCondition> GetDefaultDatabasePruneCondition();
 
 //! \brief An abstract base class for evaluating crash reports for deletion.
@@ -62,6 +86,26 @@ class PruneCondition {
 
   virtual ~PruneCondition() {}
 
+  //! \brief Prepares the condition to evaluate all of the reports in a
+  //!     database again.
+  //!
+  //! PruneCrashReportDatabase() calls this before evaluating any report, so
+  //! that a condition may be used for more than one pass over a database.
+  virtual void Reset() {}
+
+  //! \brief Determines, from aggregate information alone, whether any report
+  //!     in a database might be deleted.
+  //!
+  //! \param[in] summary A summary of the reports in the database.
+  //!
+  //! \return `false` if ShouldPruneReport() would return `false` for every
+  //!     report, so that they need not be evaluated. `true` otherwise, which
+  //!     is the default.
+  virtual bool MayPruneAnyReport(
+      const CrashReportDatabase::ReportsSummary& summary) {
+    return true;
+  }
+
   //! \brief Evaluates a crash report for deletion.
   //!
   //! \param[in] report The crash report to evaluate.
@@ -86,10 +130,14 @@ class AgePruneCondition final : public PruneCondition {
 
   ~AgePruneCondition();
 
+  void Reset() override;
+  bool MayPruneAnyReport(
+      const CrashReportDatabase::ReportsSummary& summary) override;
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
 
  private:
-  const time_t oldest_report_time_;
+  const int max_age_in_days_;
+  time_t oldest_report_time_;
 };
 
 //! \brief A PruneCondition that deletes older reports to keep the total
@@ -110,6 +158,9 @@ class DatabaseSizePruneCondition final : public PruneCondition {
 
   ~DatabaseSizePruneCondition();
 
+  void Reset() override;
+  bool MayPruneAnyReport(
+      const CrashReportDatabase::ReportsSummary& summary) override;
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
 
  private:
@@ -143,6 +194,9 @@ class BinaryPruneCondition final : public PruneCondition {
 
   ~BinaryPruneCondition();
 
+  void Reset() override;
+  bool MayPruneAnyReport(
+      const CrashReportDatabase::ReportsSummary& summary) override;
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
 
  private:
@@ -53,6 +53,7 @@ class MockDatabase : public CrashReportDatabase {
               GetCompletedReports,
               (std::vector<Report>*),
               (override));
+  MOCK_METHOD(bool, GetReportsSummary, (ReportsSummary*), (override));
   MOCK_METHOD(OperationStatus,
               GetReportForUploading,
               (const UUID&,
@@ -243,6 +244,7 @@ TEST(PruneCrashReports, PruneOrder) {
       reports.begin() + 5, reports.end());
 
   MockDatabase db;
+  EXPECT_CALL(db, GetReportsSummary(_)).WillOnce(Return(false));
   EXPECT_CALL(db, GetPendingReports(_))
       .WillOnce(DoAll(SetArgPointee<0>(pending_reports),
                       Return(CrashReportDatabase::kNoError)));
@@ -258,6 +260,131 @@ TEST(PruneCrashReports, PruneOrder) {
   EXPECT_EQ(PruneCrashReportDatabase(&db, &delete_all), kNumReports);
 }
 
+TEST(PruneCrashReports, ReportsToPrune) {
+  using ::testing::_;
+  using ::testing::DoAll;
+  using ::testing::ElementsAre;
+  using ::testing::Return;
+  using ::testing::SetArgPointee;
+
+  std::vector<CrashReportDatabase::Report> reports(3);
+  for (size_t i = 0; i < reports.size(); ++i) {
+    reports[i].uuid.data_1 = static_cast<uint32_t>(i);
+    reports[i].creation_time = NDaysAgo(static_cast<int>(i) * 20);
+  }
+
+  // The reports are selected in the order that they are evaluated, and none
+  // are deleted.
+  MockDatabase db;
+  EXPECT_CALL(db, GetReportsSummary(_)).WillOnce(Return(false));
+  EXPECT_CALL(db, GetPendingReports(_))
+      .WillOnce(DoAll(SetArgPointee<0>(std::vector<CrashReportDatabase::Report>(
+                          {reports[0], reports[2]})),
+                      Return(CrashReportDatabase::kNoError)));
+  EXPECT_CALL(db, GetCompletedReports(_))
+      .WillOnce(DoAll(SetArgPointee<0>(std::vector<CrashReportDatabase::Report>(
+                          {reports[1]})),
+                      Return(CrashReportDatabase::kNoError)));
+  EXPECT_CALL(db, DeleteReport(_)).Times(0);
+
+  AgePruneCondition condition(10);
+  std::vector<UUID> uuids;
+  ASSERT_TRUE(GetCrashReportsToPrune(&db, &condition, &uuids));
+  EXPECT_THAT(uuids, ElementsAre(TestUUID(1), TestUUID(2)));
+
+  // A failure to list the reports is reported, with nothing selected.
+  EXPECT_CALL(db, GetReportsSummary(_)).WillOnce(Return(false));
+  EXPECT_CALL(db, GetPendingReports(_))
+      .WillOnce(Return(CrashReportDatabase::kDatabaseError));
+  EXPECT_FALSE(GetCrashReportsToPrune(&db, &condition, &uuids));
+  EXPECT_TRUE(uuids.empty());
+}
+
+TEST(PruneCrashReports, SummaryConditions) {
+  CrashReportDatabase::ReportsSummary summary;
+  summary.report_count = 2;
+  summary.total_size = 1024u * 3u;
+  summary.oldest_creation_time = NDaysAgo(20);
+
+  AgePruneCondition age_10_days(10);
+  EXPECT_TRUE(age_10_days.MayPruneAnyReport(summary));
+  AgePruneCondition age_30_days(30);
+  EXPECT_FALSE(age_30_days.MayPruneAnyReport(summary));
+
+  // Each report may be rounded up by up to 1kB.
+  DatabaseSizePruneCondition size_4k(/*max_size_in_kb=*/4);
+  EXPECT_TRUE(size_4k.MayPruneAnyReport(summary));
+  DatabaseSizePruneCondition size_5k(/*max_size_in_kb=*/5);
+  EXPECT_FALSE(size_5k.MayPruneAnyReport(summary));
+
+  BinaryPruneCondition either(
+      BinaryPruneCondition::OR,
+      new DatabaseSizePruneCondition(/*max_size_in_kb=*/5),
+      new AgePruneCondition(10));
+  EXPECT_TRUE(either.MayPruneAnyReport(summary));
+  BinaryPruneCondition both(
+      BinaryPruneCondition::AND,
+      new DatabaseSizePruneCondition(/*max_size_in_kb=*/5),
+      new AgePruneCondition(10));
+  EXPECT_FALSE(both.MayPruneAnyReport(summary));
+
+  // Nothing is pruned from an empty database.
+  EXPECT_FALSE(age_10_days.MayPruneAnyReport(
+      CrashReportDatabase::ReportsSummary()));
+}
+
+TEST(PruneCrashReports, SkipWithSummary) {
+  using ::testing::_;
+  using ::testing::DoAll;
+  using ::testing::Return;
+  using ::testing::SetArgPointee;
+
+  CrashReportDatabase::ReportsSummary summary;
+  summary.report_count = 1;
+  summary.total_size = 1024u;
+  summary.oldest_creation_time = NDaysAgo(10);
+
+  MockDatabase db;
+  EXPECT_CALL(db, GetReportsSummary(_))
+      .WillOnce(DoAll(SetArgPointee<0>(summary), Return(true)));
+  EXPECT_CALL(db, GetPendingReports(_)).Times(0);
+  EXPECT_CALL(db, GetCompletedReports(_)).Times(0);
+
+  std::unique_ptr<PruneCondition> condition = PruneCondition::GetDefault();
+  EXPECT_EQ(PruneCrashReportDatabase(&db, condition.get()), 0u);
+}
+
+TEST(PruneCrashReports, SizeConditionReset) {
+  using ::testing::_;
+  using ::testing::DoAll;
+  using ::testing::Return;
+  using ::testing::SetArgPointee;
+
+  std::vector<CrashReportDatabase::Report> reports(2);
+  for (size_t i = 0; i < reports.size(); ++i) {
+    reports[i].uuid.data_1 = static_cast<uint32_t>(i);
+    reports[i].creation_time = NDaysAgo(static_cast<int>(i));
+    reports[i].total_size = 1024u;
+  }
+
+  // Both reports fit, on every pass over the database.
+  MockDatabase db;
+  EXPECT_CALL(db, GetReportsSummary(_)).WillRepeatedly(Return(false));
+  EXPECT_CALL(db, GetPendingReports(_))
+      .Times(3)
+      .WillRepeatedly(DoAll(SetArgPointee<0>(reports),
+                            Return(CrashReportDatabase::kNoError)));
+  EXPECT_CALL(db, GetCompletedReports(_))
+      .Times(3)
+      .WillRepeatedly(Return(CrashReportDatabase::kNoError));
+  EXPECT_CALL(db, DeleteReport(_)).Times(0);
+
+  DatabaseSizePruneCondition condition(/*max_size_in_kb=*/2);
+  for (int pass = 0; pass < 3; ++pass) {
+    EXPECT_EQ(PruneCrashReportDatabase(&db, &condition), 0u);
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -27,6 +27,15 @@
 
 namespace crashpad {
 
+namespace {
+
+// On file systems with coarse timestamps, a file modified again within this
+// many seconds of a read may keep the same modification time, so the cache is
+// only trusted once the file’s modification time is at least this old.
+constexpr time_t kModificationTimeGranularitySeconds = 2;
+
+}  // namespace
+
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
 
 Settings::ScopedLockedFileHandle::ScopedLockedFileHandle()
@@ -138,7 +147,15 @@ struct Settings::Data {
   UUID client_id;
 };
 
-Settings::Settings() = default;
+Settings::Settings()
+    : file_path_(),
+      cache_lock_(),
+      caching_enabled_(false),
+      cached_(false),
+      cached_data_(),
+      cached_mtime_(),
+      cached_at_(0),
+      initialized_() {}
 
 Settings::~Settings() = default;
 
@@ -155,11 +172,21 @@ bool Settings::Initialize(const base::FilePath& file_path) {
   return true;
 }
 
+void Settings::SetCachingEnabled(bool enabled) {
+  DCHECK(initialized_.is_valid());
+
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  if (!enabled) {
+    cached_ = false;
+  }
+  caching_enabled_ = enabled;
+}
+
 bool Settings::GetClientID(UUID* client_id) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadCachedSettings(&settings))
     return false;
 
   *client_id = settings.client_id;
@@ -170,7 +197,7 @@ bool Settings::GetUploadsEnabled(bool* enabled) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadCachedSettings(&settings))
     return false;
 
   *enabled = (settings.options & Data::Options::kUploadsEnabled) != 0;
@@ -180,6 +207,7 @@ bool Settings::GetUploadsEnabled(bool* enabled) {
 bool Settings::SetUploadsEnabled(bool enabled) {
   DCHECK(initialized_.is_valid());
 
+  std::lock_guard<std::mutex> lock(cache_lock_);
   Data settings;
   ScopedLockedFileHandle handle = OpenForWritingAndReadSettings(&settings);
   if (!handle.is_valid())
@@ -190,14 +218,14 @@ bool Settings::SetUploadsEnabled(bool enabled) {
   else
     settings.options &= ~Data::Options::kUploadsEnabled;
 
-  return WriteSettings(handle.get(), settings);
+  return WriteSettingsLocked(handle.get(), settings);
 }
 
 bool Settings::GetLastUploadAttemptTime(time_t* time) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadCachedSettings(&settings))
     return false;
 
   *time = InRangeCast<time_t>(settings.last_upload_attempt_time,
@@ -208,6 +236,7 @@ bool Settings::GetLastUploadAttemptTime(time_t* time) {
 bool Settings::SetLastUploadAttemptTime(time_t time) {
   DCHECK(initialized_.is_valid());
 
+  std::lock_guard<std::mutex> lock(cache_lock_);
   Data settings;
   ScopedLockedFileHandle handle = OpenForWritingAndReadSettings(&settings);
   if (!handle.is_valid())
@@ -215,7 +244,7 @@ bool Settings::SetLastUploadAttemptTime(time_t time) {
 
   settings.last_upload_attempt_time = InRangeCast<int64_t>(time, 0);
 
-  return WriteSettings(handle.get(), settings);
+  return WriteSettingsLocked(handle.get(), settings);
 }
 
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
@@ -320,6 +349,57 @@ Settings::ScopedLockedFileHandle Settings::OpenForReadingAndWriting(
       options, FileLocking::kExclusive, file_path());
 }
 
+bool Settings::ReadCachedSettings(Data* out_data) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  if (!caching_enabled_) {
+    return OpenAndReadSettings(out_data);
+  }
+
+  timespec mtime;
+  const bool have_mtime = FileModificationTime(file_path(), &mtime);
+  if (have_mtime && cached_ && mtime.tv_sec == cached_mtime_.tv_sec &&
+      mtime.tv_nsec == cached_mtime_.tv_nsec &&
+      mtime.tv_sec + kModificationTimeGranularitySeconds <= cached_at_) {
+    *out_data = *cached_data_;
+  } else {
+    if (!OpenAndReadSettings(out_data)) {
+      cached_ = false;
+      return false;
+    }
+    if (have_mtime) {
+      UpdateCacheLocked(*out_data, mtime);
+    } else {
+      cached_ = false;
+    }
+  }
+  return true;
+}
+
+bool Settings::WriteSettingsLocked(FileHandle handle, const Data& data) {
+  cached_ = false;
+  if (!WriteSettings(handle, data)) {
+    return false;
+  }
+
+  // The exclusive lock is still held, so the modification time can’t reflect
+  // a later write.
+  timespec mtime;
+  if (caching_enabled_ && FileModificationTime(file_path(), &mtime)) {
+    UpdateCacheLocked(data, mtime);
+  }
+  return true;
+}
+
+void Settings::UpdateCacheLocked(const Data& data, const timespec& mtime) {
+  if (!cached_data_) {
+    cached_data_ = std::make_unique<Data>();
+  }
+  *cached_data_ = data;
+  cached_mtime_ = mtime;
+  cached_at_ = time(nullptr);
+  cached_ = true;
+}
+
 bool Settings::OpenAndReadSettings(Data* out_data) {
   ScopedLockedFileHandle handle = OpenForReading();
   if (!handle.is_valid())
@@ -15,8 +15,12 @@
 #ifndef CRASHPAD_CLIENT_SETTINGS_H_
 #define CRASHPAD_CLIENT_SETTINGS_H_
 
+#include <stdint.h>
 #include <time.h>
 
+#include <memory>
+#include <mutex>
+
 #include "base/files/file_path.h"
 #include "base/scoped_generic.h"
 #include "build/build_config.h"
@@ -85,6 +89,20 @@ class Settings {
   //!     `false` with an error logged.
   bool Initialize(const base::FilePath& path);
 
+  //! \brief Enables or disables caching of the settings in this object.
+  //!
+  //! While caching is enabled, settings are read from memory unless the
+  //! settings file’s modification time shows that it may have changed since it
+  //! was last read. Writes always go to the settings file immediately, so that
+  //! they survive the process being killed.
+  //!
+  //! This is intended for long-lived processes such as the handler, which read
+  //! the settings for every report they upload. Caching is disabled by
+  //! default.
+  //!
+  //! \param[in] enabled Whether to cache settings.
+  void SetCachingEnabled(bool enabled);
+
   //! \brief Retrieves the immutable identifier for this client, which is used
   //!     on a server to locate all crash reports from a specific Crashpad
   //!     database.
@@ -245,6 +263,20 @@ class Settings {
   // also fails, returns false with additional log data from recovery.
   bool OpenAndReadSettings(Data* out_data);
 
+  // Like OpenAndReadSettings(), but returns the cached data when caching is
+  // enabled and the settings file hasn’t changed since it was cached.
+  bool ReadCachedSettings(Data* out_data);
+
+  // Writes data to handle as WriteSettings() does, and updates the cache to
+  // match. cache_lock_ must be held.
+  bool WriteSettingsLocked(FileHandle handle, const Data& data);
+
+  // Records data, just read from or written to the settings file, in the
+  // cache. mtime is the file’s modification time, taken before the data was
+  // read, or after it was written while holding the exclusive lock.
+  // cache_lock_ must be held.
+  void UpdateCacheLocked(const Data& data, const timespec& mtime);
+
   // Opens the settings file for writing and reads the data. If reading fails,
   // recovery is attempted. Returns the opened file handle on success, or the
   // invalid file handle on failure, with an error logged.
@@ -286,6 +318,16 @@ class Settings {
 
   base::FilePath file_path_;
 
+  // The cache, all guarded by cache_lock_. cached_data_ is only valid when
+  // cached_ is true, and reflects the settings file when its modification time
+  // was cached_mtime_, and cached_at_ was the current time.
+  std::mutex cache_lock_;
+  bool caching_enabled_;
+  bool cached_;
+  std::unique_ptr<Data> cached_data_;
+  timespec cached_mtime_;
+  time_t cached_at_;
+
   InitializationState initialized_;
 };
 
@@ -115,6 +115,48 @@ TEST_F(SettingsTest, LastUploadAttemptTime) {
   EXPECT_EQ(actual, expected);
 }
 
+TEST_F(SettingsTest, Caching) {
+  settings()->SetCachingEnabled(true);
+
+  UUID client_id;
+  EXPECT_TRUE(settings()->GetClientID(&client_id));
+  EXPECT_NE(client_id, UUID());
+
+  // Writes go to the file immediately, even in quick succession.
+  const time_t first = time(nullptr);
+  EXPECT_TRUE(settings()->SetLastUploadAttemptTime(first));
+
+  Settings local_settings;
+  ASSERT_TRUE(local_settings.Initialize(settings_path()));
+  time_t actual = -1;
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, first);
+
+  const time_t second = first + 1;
+  EXPECT_TRUE(settings()->SetLastUploadAttemptTime(second));
+  EXPECT_TRUE(settings()->GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, second);
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, second);
+
+  // Changes made by another object are seen.
+  EXPECT_TRUE(local_settings.SetUploadsEnabled(true));
+  bool enabled = false;
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+  EXPECT_TRUE(settings()->GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, second);
+
+  settings()->SetCachingEnabled(false);
+  EXPECT_TRUE(settings()->GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, second);
+  EXPECT_TRUE(local_settings.GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+  UUID actual_client_id;
+  EXPECT_TRUE(local_settings.GetClientID(&actual_client_id));
+  EXPECT_EQ(actual_client_id, client_id);
+}
+
 // The following tests write a corrupt settings file and test the recovery
 // operation.
 
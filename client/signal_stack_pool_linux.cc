@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/signal_stack_pool_linux.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+
+namespace crashpad {
+
+namespace {
+
+// The free list link lives just past the leading guard page, at the lowest
+// address of the stack. A signal handler would have to use the whole stack to
+// reach it, and it's only read while the stack is free.
+void** FreeListLink(void* stack_mem) {
+  return reinterpret_cast<void**>(static_cast<char*>(stack_mem) +
+                                  getpagesize());
+}
+
+}  // namespace
+
+SignalStackPool::SignalStackPool()
+    : arena_(), lock_(), slot_size_(0), stack_count_(0), free_list_(nullptr) {}
+
+SignalStackPool::~SignalStackPool() = default;
+
+bool SignalStackPool::Initialize(size_t stack_count, size_t stack_size) {
+  const size_t page_size = getpagesize();
+  DCHECK_EQ(stack_size % page_size, 0u);
+  DCHECK(!arena_.is_valid());
+
+  base::CheckedNumeric<size_t> slot_size = stack_size;
+  slot_size += page_size;
+  base::CheckedNumeric<size_t> arena_size = slot_size * stack_count;
+  arena_size += page_size;
+  if (!arena_size.IsValid()) {
+    LOG(ERROR) << "signal stack pool too large";
+    return false;
+  }
+
+  slot_size_ = slot_size.ValueOrDie();
+  if (!arena_.ResetMmap(nullptr,
+                        arena_size.ValueOrDie(),
+                        PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1,
+                        0)) {
+    return false;
+  }
+
+  for (size_t index = stack_count; index > 0; --index) {
+    char* stack_mem = arena_.addr_as<char*>() + (index - 1) * slot_size_;
+    char* stack = stack_mem + page_size;
+    if (mprotect(stack, stack_size, PROT_READ | PROT_WRITE) != 0) {
+      PLOG(ERROR) << "mprotect";
+      arena_.Reset();
+      free_list_ = nullptr;
+      return false;
+    }
+
+    for (size_t offset = 0; offset < stack_size; offset += page_size) {
+      static_cast<volatile char*>(stack)[offset] = 0;
+    }
+
+    *FreeListLink(stack_mem) = free_list_;
+    free_list_ = stack_mem;
+  }
+
+  stack_count_ = stack_count;
+  return true;
+}
+
+void* SignalStackPool::Acquire() {
+  base::AutoLock lock(lock_);
+  void* stack_mem = free_list_;
+  if (stack_mem) {
+    free_list_ = *FreeListLink(stack_mem);
+  }
+  return stack_mem;
+}
+
+void SignalStackPool::Release(void* stack_mem) {
+  DCHECK(Contains(stack_mem));
+  base::AutoLock lock(lock_);
+  *FreeListLink(stack_mem) = free_list_;
+  free_list_ = stack_mem;
+}
+
+bool SignalStackPool::Contains(const void* stack_mem) const {
+  if (!arena_.is_valid()) {
+    return false;
+  }
+  const char* begin = arena_.addr_as<const char*>();
+  const char* address = static_cast<const char*>(stack_mem);
+  return address >= begin && address < begin + stack_count_ * slot_size_ &&
+         (address - begin) % slot_size_ == 0;
+}
+
+}  // namespace crashpad
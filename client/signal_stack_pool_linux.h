@@ -0,0 +1,87 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
+#define CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
+
+#include <stddef.h>
+
+#include "base/synchronization/lock.h"
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+
+//! \brief A fixed set of alternate signal stacks carved out of a single
+//!     mapping, for reuse by short-lived threads.
+//!
+//! Each stack is surrounded by inaccessible guard pages, and every page of
+//! every stack is faulted in by Initialize(), so handing a stack to a thread
+//! and taking it back costs a lock and a pointer swap rather than `mmap()`,
+//! `mprotect()`, and `munmap()`.
+//!
+//! Acquire() returns the same kind of region that
+//! CrashpadClient::InitializeSignalStackForThread() maps for itself: one guard
+//! page, followed by the stack, followed by another guard page. Neighboring
+//! stacks share the guard page between them.
+//!
+//! This class is thread-safe, but Acquire() and Release() take a lock, so they
+//! must not be called from a signal handler. Stacks are meant to be acquired
+//! and released as threads start and exit.
+class SignalStackPool {
+ public:
+  SignalStackPool();
+
+  SignalStackPool(const SignalStackPool&) = delete;
+  SignalStackPool& operator=(const SignalStackPool&) = delete;
+
+  ~SignalStackPool();
+
+  //! \brief Maps and faults in the stacks.
+  //!
+  //! \param[in] stack_count The number of stacks in the pool.
+  //! \param[in] stack_size The size of each stack, which must be a multiple of
+  //!     the page size.
+  //!
+  //! \return `true` on success. Otherwise `false` with a message logged,
+  //!     including when the pool would be too large to map.
+  bool Initialize(size_t stack_count, size_t stack_size);
+
+  //! \brief Takes a stack out of the pool.
+  //!
+  //! \return The start of the guard page preceding the stack, or `nullptr` if
+  //!     every stack is in use.
+  void* Acquire();
+
+  //! \brief Returns a stack obtained from Acquire() to the pool.
+  //!
+  //! \param[in] stack_mem The value returned by Acquire().
+  void Release(void* stack_mem);
+
+  //! \brief Whether \a stack_mem was obtained from this pool.
+  bool Contains(const void* stack_mem) const;
+
+ private:
+  ScopedMmap arena_;
+  base::Lock lock_;
+  size_t slot_size_;
+  size_t stack_count_;
+
+  // Free stacks are linked through a pointer stored at the bottom of each
+  // stack, so the pool needs no storage beyond the arena.
+  void* free_list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
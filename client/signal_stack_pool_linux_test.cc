@@ -0,0 +1,87 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/signal_stack_pool_linux.h"
+
+#include <unistd.h>
+
+#include <limits>
+#include <set>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SignalStackPool, AcquireAndRelease) {
+  const size_t page_size = getpagesize();
+  const size_t stack_size = 2 * page_size;
+  constexpr size_t kStackCount = 4;
+
+  SignalStackPool pool;
+  ASSERT_TRUE(pool.Initialize(kStackCount, stack_size));
+
+  std::set<char*> stacks;
+  for (size_t index = 0; index < kStackCount; ++index) {
+    char* stack_mem = static_cast<char*>(pool.Acquire());
+    ASSERT_TRUE(stack_mem);
+    EXPECT_TRUE(pool.Contains(stack_mem));
+
+    // The stack itself must be writable from end to end.
+    char* stack = stack_mem + page_size;
+    stack[0] = 1;
+    stack[stack_size - 1] = 1;
+    stacks.insert(stack_mem);
+  }
+  EXPECT_EQ(stacks.size(), kStackCount);
+  EXPECT_FALSE(pool.Acquire());
+
+  char* released = *stacks.begin();
+  pool.Release(released);
+  EXPECT_EQ(pool.Acquire(), released);
+
+  for (char* stack_mem : stacks) {
+    pool.Release(stack_mem);
+  }
+}
+
+TEST(SignalStackPool, Contains) {
+  const size_t page_size = getpagesize();
+
+  SignalStackPool pool;
+  EXPECT_FALSE(pool.Contains(&pool));
+
+  ASSERT_TRUE(pool.Initialize(2, page_size));
+  char* stack_mem = static_cast<char*>(pool.Acquire());
+  ASSERT_TRUE(stack_mem);
+  EXPECT_TRUE(pool.Contains(stack_mem));
+  EXPECT_FALSE(pool.Contains(stack_mem + page_size));
+  EXPECT_FALSE(pool.Contains(&pool));
+  pool.Release(stack_mem);
+}
+
+TEST(SignalStackPool, TooLarge) {
+  const size_t page_size = getpagesize();
+
+  SignalStackPool pool;
+  EXPECT_FALSE(pool.Initialize(
+      std::numeric_limits<size_t>::max() / (2 * page_size) + 1, page_size));
+  EXPECT_FALSE(pool.Acquire());
+  EXPECT_FALSE(pool.Contains(&pool));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -24,6 +24,7 @@
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "build/build_config.h"
+#include "client/lazy_annotation.h"
 #include "util/mach/exc_client_variants.h"
 #include "util/mach/exception_behaviors.h"
 #include "util/mach/exception_ports.h"
@@ -205,6 +206,8 @@ void SimulateCrash(const NativeCPUContext& cpu_context) {
 #error Port to your CPU architecture
 #endif
 
+  internal::ScopedLazyAnnotations lazy_annotations;
+
   base::apple::ScopedMachSendRight thread(mach_thread_self());
   exception_type_t exception = kMachExceptionSimulated;
   mach_exception_data_type_t codes[] = {0, 0};
@@ -0,0 +1,258 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/thread_breadcrumbs.h"
+
+#include <errno.h>
+
+#include <optional>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "build/build_config.h"
+#include "client/crashpad_info.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+#elif BUILDFLAG(IS_APPLE)
+#include <pthread.h>
+#elif BUILDFLAG(IS_FUCHSIA)
+#include <lib/zx/thread.h>
+
+#include "util/fuchsia/koid_utilities.h"
+#else
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+// Returns the ID of the calling thread, as it will appear in the ThreadSnapshot
+// produced by the handler.
+uint64_t CurrentThreadID() {
+#if BUILDFLAG(IS_WIN)
+  return GetCurrentThreadId();
+#elif BUILDFLAG(IS_APPLE)
+  uint64_t thread_id;
+  errno = pthread_threadid_np(pthread_self(), &thread_id);
+  PCHECK(errno == 0) << "pthread_threadid_np";
+  return thread_id;
+#elif BUILDFLAG(IS_FUCHSIA)
+  return GetKoidForHandle(*zx::thread::self());
+#else
+  return syscall(SYS_gettid);
+#endif
+}
+
+using BufferWriter = LengthDelimitedRingBufferWriter<
+    RingBufferData<ThreadBreadcrumbList::kBufferCapacity>>;
+
+}  // namespace
+
+// The handler reads a Buffer’s data immediately following its capacity field.
+static_assert(offsetof(ThreadBreadcrumbList::Buffer, data) ==
+                  offsetof(ThreadBreadcrumbList::Buffer, capacity) +
+                      sizeof(ThreadBreadcrumbList::Buffer::capacity),
+              "unexpected padding in ThreadBreadcrumbList::Buffer");
+
+class ThreadBreadcrumbList::ThreadState {
+ public:
+  ThreadState() : buffer_(nullptr), writer_() {}
+
+  ThreadState(const ThreadState&) = delete;
+  ThreadState& operator=(const ThreadState&) = delete;
+
+  ~ThreadState() {
+    if (buffer_) {
+      ThreadBreadcrumbList::ReleaseBuffer(buffer_);
+    }
+  }
+
+  // The list that this thread’s buffer belongs to, or nullptr if the thread
+  // has no buffer or its list has been destroyed.
+  ThreadBreadcrumbList* list() const {
+    return buffer_ ? buffer_->list.load(std::memory_order_acquire) : nullptr;
+  }
+
+  Buffer* buffer() const { return buffer_; }
+  BufferWriter& writer() { return *writer_; }
+
+  void Bind(Buffer* buffer) {
+    // The thread’s reference keeps a buffer alive even if its list has been
+    // destroyed, so the previous buffer can always be released.
+    if (buffer_) {
+      ThreadBreadcrumbList::ReleaseBuffer(buffer_);
+    }
+    buffer_ = buffer;
+    writer_.emplace(buffer_->data);
+  }
+
+ private:
+  Buffer* buffer_;  // weak
+  std::optional<BufferWriter> writer_;
+};
+
+ThreadBreadcrumbList::Buffer::Buffer()
+    : thread_id(0),
+      next(nullptr),
+      busy(0),
+      capacity(kBufferCapacity),
+      data(),
+      references(1),
+      list(nullptr) {}
+
+ThreadBreadcrumbList::ThreadBreadcrumbList() : head_(nullptr) {
+#if !BUILDFLAG(IS_WIN) && !BUILDFLAG(IS_FUCHSIA)
+  [[maybe_unused]] static const bool at_fork_registered = [] {
+    errno = pthread_atfork(nullptr, nullptr, &AtForkChild);
+    PLOG_IF(ERROR, errno != 0) << "pthread_atfork";
+    return errno == 0;
+  }();
+#endif
+}
+
+ThreadBreadcrumbList::~ThreadBreadcrumbList() {
+  // Buffers still owned by running threads are left for those threads to free.
+  Buffer* buffer = head_.load(std::memory_order_acquire);
+  while (buffer) {
+    Buffer* next = buffer->next.load(std::memory_order_acquire);
+    buffer->list.store(nullptr, std::memory_order_release);
+    Unreference(buffer);
+    buffer = next;
+  }
+}
+
+// static
+ThreadBreadcrumbList* ThreadBreadcrumbList::Get() {
+  return CrashpadInfo::GetCrashpadInfo()->thread_breadcrumbs();
+}
+
+// static
+ThreadBreadcrumbList* ThreadBreadcrumbList::Register() {
+  ThreadBreadcrumbList* list = Get();
+  if (!list) {
+    list = new ThreadBreadcrumbList();
+    CrashpadInfo::GetCrashpadInfo()->set_thread_breadcrumbs(list);
+  }
+  return list;
+}
+
+bool ThreadBreadcrumbList::Push(const void* buffer,
+                                RingBufferCapacity buffer_length) {
+  ThreadState& state = CurrentThreadState();
+  if (state.list() != this) {
+    state.Bind(AcquireBuffer(CurrentThreadID()));
+  }
+
+  // Only the owning thread writes to its buffer, and the handler only reads it
+  // while this thread is suspended, so compiler fences are sufficient to keep
+  // |busy| ordered with respect to the writes to the ring buffer.
+  Buffer* thread_buffer = state.buffer();
+  thread_buffer->busy.store(1, std::memory_order_relaxed);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  bool success = state.writer().Push(buffer, buffer_length);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  thread_buffer->busy.store(0, std::memory_order_relaxed);
+  return success;
+}
+
+ThreadBreadcrumbList::Buffer* ThreadBreadcrumbList::AcquireBuffer(
+    uint64_t thread_id) {
+  for (Buffer* buffer = head_.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next.load(std::memory_order_acquire)) {
+    uint64_t unowned = 0;
+    if (buffer->thread_id.load(std::memory_order_relaxed) == 0 &&
+        buffer->thread_id.compare_exchange_strong(
+            unowned, thread_id, std::memory_order_acq_rel)) {
+      buffer->references.fetch_add(1, std::memory_order_relaxed);
+
+      // Discard the previous owner’s breadcrumbs.
+      buffer->busy.store(1, std::memory_order_relaxed);
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      buffer->data.header.data_range = {0, 0};
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      buffer->busy.store(0, std::memory_order_relaxed);
+      return buffer;
+    }
+  }
+
+  Buffer* buffer = new Buffer();
+  buffer->thread_id.store(thread_id, std::memory_order_relaxed);
+  buffer->references.store(2, std::memory_order_relaxed);
+  buffer->list.store(this, std::memory_order_relaxed);
+  Buffer* head = head_.load(std::memory_order_relaxed);
+  do {
+    buffer->next.store(head, std::memory_order_relaxed);
+  } while (!head_.compare_exchange_weak(
+      head, buffer, std::memory_order_release, std::memory_order_relaxed));
+  return buffer;
+}
+
+// static
+void ThreadBreadcrumbList::ReleaseBuffer(Buffer* buffer) {
+  DCHECK_NE(buffer->thread_id.load(std::memory_order_relaxed), 0u);
+  buffer->thread_id.store(0, std::memory_order_release);
+  Unreference(buffer);
+}
+
+// static
+void ThreadBreadcrumbList::Unreference(Buffer* buffer) {
+  if (buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete buffer;
+  }
+}
+
+void ThreadBreadcrumbList::ReleaseBuffersAfterFork(const Buffer* keep) {
+  for (Buffer* buffer = head_.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next.load(std::memory_order_acquire)) {
+    if (buffer != keep &&
+        buffer->thread_id.load(std::memory_order_relaxed) != 0) {
+      // The owning thread didn’t survive the fork, so the list’s reference
+      // keeps the buffer alive for reuse.
+      ReleaseBuffer(buffer);
+    }
+  }
+}
+
+// static
+void ThreadBreadcrumbList::AtForkChild() {
+  // Only the calling thread runs in the child, under a new thread ID. Its
+  // buffer is kept, so that breadcrumbs pushed before the fork are still
+  // attached to it.
+  Buffer* current = CurrentThreadState().buffer();
+  if (current) {
+    current->thread_id.store(CurrentThreadID(), std::memory_order_release);
+  }
+
+  ThreadBreadcrumbList* registered = Get();
+  if (registered) {
+    registered->ReleaseBuffersAfterFork(current);
+  }
+  ThreadBreadcrumbList* current_list =
+      current ? current->list.load(std::memory_order_acquire) : nullptr;
+  if (current_list && current_list != registered) {
+    current_list->ReleaseBuffersAfterFork(current);
+  }
+}
+
+// static
+ThreadBreadcrumbList::ThreadState& ThreadBreadcrumbList::CurrentThreadState() {
+  thread_local ThreadState state;
+  return state;
+}
+
+}  // namespace crashpad
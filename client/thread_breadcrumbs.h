@@ -0,0 +1,150 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_THREAD_BREADCRUMBS_H_
+#define CRASHPAD_CLIENT_THREAD_BREADCRUMBS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "client/length_delimited_ring_buffer.h"
+
+namespace crashpad {
+
+//! \brief A list of per-thread breadcrumb ring buffers.
+//!
+//! Each thread that calls Push() is given a buffer of its own, so writers never
+//! contend with each other and a write never needs to take a lock. This makes
+//! it cheap enough to leave breadcrumb logging enabled in hot paths.
+//!
+//! An instance of this class must be registered on the \a CrashpadInfo
+//! structure for the handler to find the buffers. The handler attaches the
+//! contents of each thread's buffer to the corresponding ThreadSnapshot, and
+//! they are written to the minidump in a
+//! ::kMinidumpStreamTypeCrashpadThreadBreadcrumbs stream. Each buffer’s
+//! contents are serialized as a RingBufferData, and can be read with
+//! LengthDelimitedRingBufferReader.
+//!
+//! When a thread exits, its buffer is released and may be reused by a thread
+//! created later. A released buffer’s contents are not captured. Buffers are
+//! never freed while the list exists. A list may be destroyed while threads
+//! that have pushed to it are still running: their buffers are freed when they
+//! exit or push to another list instead.
+//!
+//! In the child of a `fork()`, the buffers of the threads that weren’t copied
+//! into the child are released, and the calling thread’s buffer is reassigned
+//! to its new thread ID. This is done for the registered list, and for the
+//! list that the calling thread last pushed to.
+class ThreadBreadcrumbList {
+ public:
+  //! \brief The capacity of each thread’s ring buffer, in bytes.
+  static constexpr RingBufferCapacity kBufferCapacity = 4096;
+
+  //! \brief A single thread’s breadcrumb buffer.
+  //!
+  //! This is public so that the handler can verify its layout. Clients should
+  //! not access it directly.
+  struct Buffer {
+    Buffer();
+
+    //! \brief The ID of the thread that owns this buffer, or `0` if the buffer
+    //!     is not owned by any thread.
+    std::atomic<uint64_t> thread_id;
+
+    //! \brief The next buffer in the list, or `nullptr`.
+    std::atomic<Buffer*> next;
+
+    //! \brief Nonzero while the owning thread is modifying \a data.
+    std::atomic<uint32_t> busy;
+
+    //! \brief The size of the ring buffer in \a data, in bytes.
+    uint32_t capacity;
+
+    //! \brief The ring buffer holding this thread’s breadcrumbs.
+    RingBufferData<kBufferCapacity> data;
+
+    // The members below are not read by the handler.
+
+    //! \brief The number of references to this buffer: one from the list
+    //!     while it exists, and one from the owning thread, if any.
+    std::atomic<uint32_t> references;
+
+    //! \brief The list that this buffer belongs to, or `nullptr` if the list
+    //!     has been destroyed.
+    std::atomic<ThreadBreadcrumbList*> list;
+  };
+
+  ThreadBreadcrumbList();
+
+  ThreadBreadcrumbList(const ThreadBreadcrumbList&) = delete;
+  ThreadBreadcrumbList& operator=(const ThreadBreadcrumbList&) = delete;
+
+  ~ThreadBreadcrumbList();
+
+  //! \brief Returns the instance of the list that has been registered on the
+  //!     CrashpadInfo structure.
+  static ThreadBreadcrumbList* Get();
+
+  //! \brief Returns the instance of the list, creating and registering it if
+  //!     necessary.
+  static ThreadBreadcrumbList* Register();
+
+  //! \brief Pushes a breadcrumb onto the calling thread’s ring buffer.
+  //!
+  //! If the ring buffer does not have enough space to store \a buffer_length
+  //! bytes of data, old breadcrumbs are dropped in FIFO order until enough
+  //! space is available to store the new data.
+  //!
+  //! The first call on each thread allocates or reuses a buffer for that
+  //! thread. Subsequent calls only touch that thread’s buffer.
+  //!
+  //! \param[in] buffer The data to be written.
+  //! \param[in] buffer_length The length of \a buffer, in bytes.
+  //! \return `true` on success, `false` if \a buffer_length is `0` or too large
+  //!     to fit in the ring buffer.
+  bool Push(const void* buffer, RingBufferCapacity buffer_length);
+
+  //! \brief Returns the first buffer in the list, for use by tests.
+  const Buffer* head() const { return head_.load(std::memory_order_acquire); }
+
+ private:
+  class ThreadState;
+
+  // Claims an unowned buffer for |thread_id|, or allocates a new one if every
+  // buffer is owned.
+  Buffer* AcquireBuffer(uint64_t thread_id);
+
+  // Returns |buffer| to the pool of unowned buffers, freeing it if its list
+  // has been destroyed.
+  static void ReleaseBuffer(Buffer* buffer);
+
+  // Drops a reference to |buffer|, freeing it if that was the last one.
+  static void Unreference(Buffer* buffer);
+
+  // Releases every owned buffer but |keep|, after a fork() has left only the
+  // calling thread running.
+  void ReleaseBuffersAfterFork(const Buffer* keep);
+
+  static void AtForkChild();
+
+  static ThreadState& CurrentThreadState();
+
+  std::atomic<Buffer*> head_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_THREAD_BREADCRUMBS_H_
@@ -0,0 +1,264 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/thread_breadcrumbs.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/posix/eintr_wrapper.h"
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/test/test_thread_breadcrumbs.h"
+#include "test/errors.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Pushes |items| to |list|, then signals |pushed| and waits for |release|
+// before exiting.
+class PushThread final : public Thread {
+ public:
+  PushThread(ThreadBreadcrumbList* list,
+             const std::vector<std::string>& items,
+             Semaphore* pushed,
+             Semaphore* release)
+      : list_(list), items_(items), pushed_(pushed), release_(release) {}
+
+  bool success() const { return success_; }
+
+ private:
+  void ThreadMain() override {
+    for (const std::string& item : items_) {
+      success_ &= list_->Push(item.data(), item.size());
+    }
+    pushed_->Signal();
+    release_->Wait();
+  }
+
+  ThreadBreadcrumbList* list_;
+  const std::vector<std::string>& items_;
+  Semaphore* pushed_;
+  Semaphore* release_;
+  bool success_ = true;
+};
+
+std::vector<std::string> BufferBreadcrumbs(
+    const ThreadBreadcrumbList::Buffer* buffer) {
+  std::vector<std::string> breadcrumbs;
+  EXPECT_TRUE(DecodeThreadBreadcrumbs(
+      &buffer->data, buffer->data.GetRingBufferLength(), &breadcrumbs));
+  return breadcrumbs;
+}
+
+size_t BufferCount(const ThreadBreadcrumbList& list) {
+  size_t count = 0;
+  for (const ThreadBreadcrumbList::Buffer* buffer = list.head(); buffer;
+       buffer = buffer->next.load()) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(ThreadBreadcrumbList, EachThreadHasItsOwnBuffer) {
+  constexpr size_t kThreads = 4;
+  ThreadBreadcrumbList list;
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  std::vector<std::vector<std::string>> items(kThreads);
+  std::vector<std::unique_ptr<PushThread>> threads;
+  for (size_t index = 0; index < kThreads; ++index) {
+    for (size_t item = 0; item < 3; ++item) {
+      items[index].push_back("thread " + std::to_string(index) + " item " +
+                             std::to_string(item));
+    }
+    threads.push_back(
+        std::make_unique<PushThread>(&list, items[index], &pushed, &release));
+    threads.back()->Start();
+  }
+  for (size_t index = 0; index < kThreads; ++index) {
+    pushed.Wait();
+  }
+
+  EXPECT_EQ(BufferCount(list), kThreads);
+  std::vector<std::vector<std::string>> found;
+  for (const ThreadBreadcrumbList::Buffer* buffer = list.head(); buffer;
+       buffer = buffer->next.load()) {
+    EXPECT_NE(buffer->thread_id.load(), 0u);
+    EXPECT_EQ(buffer->busy.load(), 0u);
+    EXPECT_EQ(buffer->capacity, ThreadBreadcrumbList::kBufferCapacity);
+    found.push_back(BufferBreadcrumbs(buffer));
+  }
+  for (const auto& thread_items : items) {
+    EXPECT_NE(std::find(found.begin(), found.end(), thread_items), found.end());
+  }
+
+  for (size_t index = 0; index < kThreads; ++index) {
+    release.Signal();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+    EXPECT_TRUE(thread->success());
+  }
+
+  // Every buffer is released when its thread exits.
+  for (const ThreadBreadcrumbList::Buffer* buffer = list.head(); buffer;
+       buffer = buffer->next.load()) {
+    EXPECT_EQ(buffer->thread_id.load(), 0u);
+  }
+}
+
+TEST(ThreadBreadcrumbList, BufferReusedAfterThreadExits) {
+  ThreadBreadcrumbList list;
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  const std::vector<std::string> first_items = {"first"};
+  PushThread first(&list, first_items, &pushed, &release);
+  first.Start();
+  pushed.Wait();
+  release.Signal();
+  first.Join();
+  EXPECT_TRUE(first.success());
+
+  const std::vector<std::string> second_items = {"second", "third"};
+  PushThread second(&list, second_items, &pushed, &release);
+  second.Start();
+  pushed.Wait();
+
+  // The second thread reuses the buffer released by the first, without its
+  // breadcrumbs.
+  ASSERT_EQ(BufferCount(list), 1u);
+  EXPECT_NE(list.head()->thread_id.load(), 0u);
+  EXPECT_EQ(BufferBreadcrumbs(list.head()), second_items);
+
+  release.Signal();
+  second.Join();
+  EXPECT_TRUE(second.success());
+}
+
+TEST(ThreadBreadcrumbList, PushRejectsInvalidLengths) {
+  ThreadBreadcrumbList list;
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  const std::string kEmpty;
+  const std::string kOversized(ThreadBreadcrumbList::kBufferCapacity, 'x');
+  for (const std::string& item : {kEmpty, kOversized}) {
+    const std::vector<std::string> items = {item};
+    PushThread thread(&list, items, &pushed, &release);
+    thread.Start();
+    pushed.Wait();
+    release.Signal();
+    thread.Join();
+    EXPECT_FALSE(thread.success());
+  }
+}
+
+TEST(ThreadBreadcrumbList, ThreadOutlivesList) {
+  auto list = std::make_unique<ThreadBreadcrumbList>();
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  const std::vector<std::string> items = {"outlives"};
+  PushThread thread(list.get(), items, &pushed, &release);
+  thread.Start();
+  pushed.Wait();
+
+  // The thread’s buffer outlives the list, and is freed when the thread exits.
+  list.reset();
+  release.Signal();
+  thread.Join();
+  EXPECT_TRUE(thread.success());
+}
+
+TEST(ThreadBreadcrumbList, PushAfterListDestroyed) {
+  const std::string kFirst("first");
+  {
+    ThreadBreadcrumbList first;
+    EXPECT_TRUE(first.Push(kFirst.data(), kFirst.size()));
+  }
+
+  // The second list may occupy the first one’s storage. It must still get a
+  // buffer of its own.
+  const std::string kSecond("second");
+  ThreadBreadcrumbList second;
+  EXPECT_TRUE(second.Push(kSecond.data(), kSecond.size()));
+  ASSERT_EQ(BufferCount(second), 1u);
+  EXPECT_EQ(BufferBreadcrumbs(second.head()), std::vector<std::string>{kSecond});
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST(ThreadBreadcrumbList, ForkReleasesOtherThreadsBuffers) {
+  ThreadBreadcrumbList list;
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  const std::vector<std::string> items = {"other thread"};
+  PushThread thread(&list, items, &pushed, &release);
+  thread.Start();
+  pushed.Wait();
+
+  const std::string kItem("forking thread");
+  ASSERT_TRUE(list.Push(kItem.data(), kItem.size()));
+  ASSERT_EQ(BufferCount(list), 2u);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0) << ErrnoMessage("fork");
+  if (pid == 0) {
+    // Only this thread was copied into the child. Its buffer must be owned by
+    // its new thread ID, and the other thread’s buffer must be released.
+    const uint64_t thread_id = syscall(SYS_gettid);
+    size_t owned = 0;
+    for (const ThreadBreadcrumbList::Buffer* buffer = list.head(); buffer;
+         buffer = buffer->next.load()) {
+      const uint64_t owner = buffer->thread_id.load();
+      if (owner != 0) {
+        if (owner != thread_id) {
+          _exit(1);
+        }
+        ++owned;
+      }
+    }
+    _exit(owned == 1 ? 0 : 2);
+  }
+
+  int status;
+  ASSERT_EQ(HANDLE_EINTR(waitpid(pid, &status, 0)), pid)
+      << ErrnoMessage("waitpid");
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+
+  release.Signal();
+  thread.Join();
+  EXPECT_TRUE(thread.success());
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,136 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_TYPED_ANNOTATION_H_
+#define CRASHPAD_CLIENT_TYPED_ANNOTATION_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <type_traits>
+
+#include "client/annotation.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief An \sa Annotation that stores a fixed-size arithmetic value.
+//!
+//! The value is stored in the client’s native representation, so updating it
+//! is a single store with no formatting. This makes it suitable for counters
+//! and identifiers that change on hot paths, in place of formatting them into
+//! a StringAnnotation.
+//!
+//! \tparam T The type of the value, which must be lock-free as a
+//!     `std::atomic`.
+//! \tparam kType The Annotation::Type that describes \a T to crash processors.
+template <typename T, Annotation::Type kType>
+class NumericAnnotation : public Annotation {
+ public:
+  static_assert(std::is_arithmetic<T>::value, "T must be arithmetic");
+  static_assert(std::atomic<T>::is_always_lock_free,
+                "std::atomic<T> may not be signal-safe");
+  static_assert(sizeof(std::atomic<T>) == sizeof(T),
+                "std::atomic<T> adds size to T");
+
+  //! \brief Constructs a new NumericAnnotation with the given \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit NumericAnnotation(const char name[])
+      : Annotation(kType, name, &value_), value_() {}
+
+  NumericAnnotation(const NumericAnnotation&) = delete;
+  NumericAnnotation& operator=(const NumericAnnotation&) = delete;
+
+  //! \brief Sets the Annotation’s value.
+  //!
+  //! \param[in] value The new value.
+  void Set(T value) {
+    value_.store(value, std::memory_order_relaxed);
+    if (!is_set()) {
+      SetSize(sizeof(value_));
+    }
+  }
+
+  //! \brief Returns the Annotation’s value.
+  T value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<T> value_;
+};
+
+//! \brief An \sa Annotation storing a `int64_t` of Annotation::Type::kInt64.
+using Int64Annotation = NumericAnnotation<int64_t, Annotation::Type::kInt64>;
+
+//! \brief An \sa Annotation storing a `uint64_t` of Annotation::Type::kUint64.
+using Uint64Annotation = NumericAnnotation<uint64_t, Annotation::Type::kUint64>;
+
+//! \brief An \sa Annotation storing a `double` of Annotation::Type::kDouble.
+using DoubleAnnotation = NumericAnnotation<double, Annotation::Type::kDouble>;
+
+//! \brief An \sa Annotation that stores a small, trivially-copyable structure.
+//!
+//! A value larger than a machine word cannot be updated with a single store,
+//! so updates are guarded by ConcurrentAccessGuardMode::kSeqlock. Set() never
+//! waits, and a crash report only omits the value if the crash interrupted
+//! Set() itself. Set() must not be called from more than one thread at a time.
+//!
+//! \tparam T The type of the value.
+//! \tparam kType The Annotation::Type that describes \a T to crash processors.
+//!     Types that Crashpad does not define should use a
+//!     Annotation::UserDefinedType().
+template <typename T, Annotation::Type kType>
+class PODAnnotation : public Annotation {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "T must be trivially copyable");
+  static_assert(sizeof(T) < Annotation::kValueMaxSize, "T is too large");
+
+  //! \brief Constructs a new PODAnnotation with the given \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit PODAnnotation(const char name[])
+      : Annotation(kType, name, &value_, SeqlockTag()), value_() {}
+
+  PODAnnotation(const PODAnnotation&) = delete;
+  PODAnnotation& operator=(const PODAnnotation&) = delete;
+
+  //! \brief Sets the Annotation’s value.
+  //!
+  //! \param[in] value The new value.
+  void Set(const T& value) {
+    {
+      ScopedSeqlockWrite write = CreateScopedSeqlockWrite();
+      value_ = value;
+    }
+    if (!is_set()) {
+      SetSize(sizeof(value_));
+    }
+  }
+
+  //! \brief Returns the Annotation’s value.
+  //!
+  //! This is only meaningful on the thread that calls Set().
+  const T& value() const { return value_; }
+
+ private:
+  T value_;
+};
+
+//! \brief An \sa Annotation storing a UUID of Annotation::Type::kUUID.
+using UUIDAnnotation = PODAnnotation<UUID, Annotation::Type::kUUID>;
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_TYPED_ANNOTATION_H_
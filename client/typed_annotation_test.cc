@@ -0,0 +1,114 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/typed_annotation.h"
+
+#include <string.h>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class TypedAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ protected:
+  AnnotationList annotations_;
+};
+
+// Returns the bytes that a crash report would capture for |annotation|.
+template <typename T>
+T CapturedValue(const Annotation& annotation) {
+  EXPECT_EQ(annotation.size(), sizeof(T));
+  T value;
+  memcpy(&value, annotation.value(), sizeof(value));
+  return value;
+}
+
+TEST_F(TypedAnnotationTest, Int64) {
+  Int64Annotation annotation("int64");
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(annotation.type(), Annotation::Type::kInt64);
+
+  annotation.Set(-1);
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(&annotation, *annotations_.begin());
+  EXPECT_EQ(annotation.value(), -1);
+  EXPECT_EQ(CapturedValue<int64_t>(annotation), -1);
+
+  annotation.Set(int64_t{1} << 40);
+  EXPECT_EQ(CapturedValue<int64_t>(annotation), int64_t{1} << 40);
+
+  annotation.Clear();
+  EXPECT_FALSE(annotation.is_set());
+  annotation.Set(2);
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(CapturedValue<int64_t>(annotation), 2);
+}
+
+TEST_F(TypedAnnotationTest, Uint64AndDouble) {
+  Uint64Annotation count("count");
+  EXPECT_EQ(count.type(), Annotation::Type::kUint64);
+  count.Set(0xffffffffffffffff);
+  EXPECT_EQ(CapturedValue<uint64_t>(count), 0xffffffffffffffff);
+
+  DoubleAnnotation ratio("ratio");
+  EXPECT_EQ(ratio.type(), Annotation::Type::kDouble);
+  ratio.Set(0.25);
+  EXPECT_EQ(ratio.value(), 0.25);
+  EXPECT_EQ(CapturedValue<double>(ratio), 0.25);
+}
+
+TEST_F(TypedAnnotationTest, UUID) {
+  UUIDAnnotation annotation("uuid");
+  EXPECT_EQ(annotation.type(), Annotation::Type::kUUID);
+  EXPECT_EQ(annotation.concurrent_access_guard_mode(),
+            Annotation::ConcurrentAccessGuardMode::kSeqlock);
+
+  UUID uuid;
+  ASSERT_TRUE(
+      uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  annotation.Set(uuid);
+  EXPECT_EQ(annotation.value(), uuid);
+  EXPECT_EQ(CapturedValue<UUID>(annotation), uuid);
+}
+
+TEST_F(TypedAnnotationTest, POD) {
+  struct Point {
+    int32_t x;
+    int32_t y;
+  };
+  PODAnnotation<Point, Annotation::UserDefinedType(1)> annotation("point");
+  EXPECT_EQ(annotation.type(), Annotation::UserDefinedType(1));
+
+  annotation.Set({3, 4});
+  Point point = CapturedValue<Point>(annotation);
+  EXPECT_EQ(point.x, 3);
+  EXPECT_EQ(point.y, 4);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
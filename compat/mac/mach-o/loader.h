@@ -29,4 +29,10 @@
 #define LC_SOURCE_VERSION 0x2a
 #endif
 
+// 11.0 SDK
+
+#ifndef MH_DYLIB_IN_CACHE
+#define MH_DYLIB_IN_CACHE 0x80000000
+#endif
+
 #endif  // CRASHPAD_COMPAT_MAC_MACH_O_LOADER_H_
@@ -175,6 +175,9 @@ enum MINIDUMP_STREAM_TYPE {
   //! \brief The stream type for MINIDUMP_SYSTEM_INFO.
   SystemInfoStream = 7,
 
+  //! \brief The stream type for MINIDUMP_MEMORY64_LIST.
+  Memory64ListStream = 9,
+
   //! \brief The stream contains information about active `HANDLE`s.
   HandleDataStream = 12,
 
@@ -653,6 +656,39 @@ struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY_LIST {
   MINIDUMP_MEMORY_DESCRIPTOR MemoryRanges[0];
 };
 
+//! \brief A region of memory whose contents are contained within a
+//!     MINIDUMP_MEMORY64_LIST.
+//!
+//! \sa MINIDUMP_MEMORY64_LIST
+struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY_DESCRIPTOR64 {
+  //! \brief The base address of the memory region in the address space of the
+  //!     process that the minidump file contains a snapshot of.
+  uint64_t StartOfMemoryRange;
+
+  //! \brief The size of the memory region, in bytes.
+  uint64_t DataSize;
+};
+
+//! \brief Information about memory regions within the process, for minidump
+//!     files that may be larger than 4 GB.
+//!
+//! The contents of all of the memory regions are stored consecutively, in the
+//! order of #MemoryRanges, beginning at #BaseRva. Minidump files identified as
+//! ::MiniDumpWithFullMemory in MINIDUMP_HEADER::Flags use this stream for the
+//! process’ memory.
+struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY64_LIST {
+  //! \brief The number of memory regions present in the #MemoryRanges array.
+  uint64_t NumberOfMemoryRanges;
+
+  //! \brief The 64-bit relative virtual address of the contents of the first
+  //!     memory region within the minidump file.
+  RVA64 BaseRva;
+
+  //! \brief Structures identifying each memory region present in the minidump
+  //!     file.
+  MINIDUMP_MEMORY_DESCRIPTOR64 MemoryRanges[0];
+};
+
 //! \brief Contains the state of an individual system handle at the time the
 //!     snapshot was taken. This structure is Windows-specific.
 //!
@@ -1144,6 +1180,10 @@ enum MINIDUMP_TYPE {
   //!    the exception address or the instruction pointer.
   MiniDumpNormal = 0x00000000,
 
+  //! \brief A minidump file with the contents of all readable memory in the
+  //!     process, in a MINIDUMP_MEMORY64_LIST stream.
+  MiniDumpWithFullMemory = 0x00000002,
+
   //! \brief A minidump with extended contexts.
   //!
   //! Contains Normal plus a MISC_INFO_5 structure describing the contexts.
@@ -0,0 +1,45 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/batch_upload_response.h"
+
+namespace crashpad {
+
+std::map<UUID, std::string> ParseBatchUploadResponse(
+    const std::string& response_body) {
+  std::map<UUID, std::string> report_ids;
+  size_t line_start = 0;
+  while (line_start < response_body.size()) {
+    size_t line_end = response_body.find('\n', line_start);
+    if (line_end == std::string::npos) {
+      line_end = response_body.size();
+    }
+    std::string line = response_body.substr(line_start, line_end - line_start);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    line_start = line_end + 1;
+
+    const size_t equals = line.find('=');
+    UUID uuid;
+    if (equals == std::string::npos || equals + 1 == line.size() ||
+        !uuid.InitializeFromString(line.substr(0, equals))) {
+      continue;
+    }
+    report_ids[uuid] = line.substr(equals + 1);
+  }
+  return report_ids;
+}
+
+}  // namespace crashpad
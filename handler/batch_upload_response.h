@@ -0,0 +1,40 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_BATCH_UPLOAD_RESPONSE_H_
+#define CRASHPAD_HANDLER_BATCH_UPLOAD_RESPONSE_H_
+
+#include <map>
+#include <string>
+
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief Parses the server’s response to a batch upload.
+//!
+//! The response has a line of the form “uuid=id” for each report that the
+//! server accepted. Lines may end in either LF or CRLF. Lines that aren’t of
+//! this form, or whose UUID can’t be parsed, are ignored.
+//!
+//! \param[in] response_body The body of the server’s response.
+//!
+//! \return A map from the UUID of each report that the server accepted to the
+//!     ID that the server assigned to it.
+std::map<UUID, std::string> ParseBatchUploadResponse(
+    const std::string& response_body);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_BATCH_UPLOAD_RESPONSE_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/batch_upload_response.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr char kUUID1[] = "00112233-4455-6677-8899-aabbccddeeff";
+constexpr char kUUID2[] = "ffeeddcc-bbaa-9988-7766-554433221100";
+
+UUID UUIDFromString(const char* string) {
+  UUID uuid;
+  EXPECT_TRUE(uuid.InitializeFromString(string));
+  return uuid;
+}
+
+TEST(BatchUploadResponse, Empty) {
+  EXPECT_TRUE(ParseBatchUploadResponse(std::string()).empty());
+  EXPECT_TRUE(ParseBatchUploadResponse("\n\r\n").empty());
+}
+
+TEST(BatchUploadResponse, LineEndings) {
+  const std::string response = std::string(kUUID1) + "=id1\r\n" + kUUID2 +
+                               "=id2\n";
+  const std::map<UUID, std::string> report_ids =
+      ParseBatchUploadResponse(response);
+  ASSERT_EQ(report_ids.size(), 2u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID1)), "id1");
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID2)), "id2");
+}
+
+TEST(BatchUploadResponse, NoTrailingLineEnding) {
+  const std::map<UUID, std::string> report_ids =
+      ParseBatchUploadResponse(std::string(kUUID1) + "=id1\r");
+  ASSERT_EQ(report_ids.size(), 1u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID1)), "id1");
+}
+
+TEST(BatchUploadResponse, MalformedLines) {
+  const std::string response = std::string("garbage\r\n") + kUUID1 +
+                               "\r\n" + kUUID1 + "=\r\n" +
+                               "not-a-uuid=id\r\n=id\r\n" + kUUID2 +
+                               "=id2\r\n";
+  const std::map<UUID, std::string> report_ids =
+      ParseBatchUploadResponse(response);
+  ASSERT_EQ(report_ids.size(), 1u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID2)), "id2");
+}
+
+TEST(BatchUploadResponse, IDContainsEquals) {
+  const std::map<UUID, std::string> report_ids =
+      ParseBatchUploadResponse(std::string(kUUID1) + "=a=b\n");
+  ASSERT_EQ(report_ids.size(), 1u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID1)), "a=b");
+}
+
+TEST(BatchUploadResponse, UnknownUUIDs) {
+  // The response may name reports that weren’t in the batch. They’re parsed
+  // like any other, and it’s up to the caller to look up only the reports that
+  // it uploaded.
+  const std::map<UUID, std::string> report_ids =
+      ParseBatchUploadResponse(std::string(kUUID2) + "=id2\n");
+  ASSERT_EQ(report_ids.size(), 1u);
+  EXPECT_EQ(report_ids.count(UUIDFromString(kUUID1)), 0u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID2)), "id2");
+}
+
+TEST(BatchUploadResponse, RepeatedUUID) {
+  const std::map<UUID, std::string> report_ids = ParseBatchUploadResponse(
+      std::string(kUUID1) + "=id1\n" + kUUID1 + "=id2\n");
+  ASSERT_EQ(report_ids.size(), 1u);
+  EXPECT_EQ(report_ids.at(UUIDFromString(kUUID1)), "id2");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_loop_detector.h"
+
+namespace crashpad {
+
+namespace {
+
+// Loops that have ended with no crashes left to report are forgotten once more
+// than this many are tracked.
+constexpr size_t kMaxIdleLoops = 256;
+
+}  // namespace
+
+CrashLoopDetector::CrashLoopDetector(unsigned int captures_per_loop,
+                                     time_t interval_seconds)
+    : lock_(),
+      loops_(),
+      captures_per_loop_(captures_per_loop),
+      interval_seconds_(interval_seconds) {}
+
+CrashLoopDetector::~CrashLoopDetector() {}
+
+bool CrashLoopDetector::ShouldCapture(const std::string& signature,
+                                      time_t now,
+                                      unsigned int* skipped_count) {
+  if (!enabled() || signature.empty()) {
+    *skipped_count = 0;
+    return true;
+  }
+
+  base::AutoLock lock(lock_);
+
+  auto it = loops_.find(signature);
+  if (it == loops_.end()) {
+    if (loops_.size() >= kMaxIdleLoops) {
+      for (auto idle = loops_.begin(); idle != loops_.end();) {
+        if (idle->second.skipped == 0 &&
+            now - idle->second.last_crash > interval_seconds_) {
+          idle = loops_.erase(idle);
+        } else {
+          ++idle;
+        }
+      }
+    }
+    // If every tracked loop is still going, this crash goes untracked and is
+    // captured, so that a burst of different crashes is never skipped.
+    if (loops_.size() < kMaxIdleLoops) {
+      loops_[signature] = {now, 1, 0};
+    }
+    *skipped_count = 0;
+    return true;
+  }
+
+  LoopState& state = it->second;
+  if (now - state.last_crash > interval_seconds_ || now < state.last_crash) {
+    *skipped_count = state.skipped;
+    state = {now, 1, 0};
+    return true;
+  }
+
+  state.last_crash = now;
+  if (state.captured < captures_per_loop_) {
+    ++state.captured;
+    *skipped_count = 0;
+    return true;
+  }
+
+  ++state.skipped;
+  return false;
+}
+
+}  // namespace crashpad
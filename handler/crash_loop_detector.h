@@ -0,0 +1,87 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_CRASH_LOOP_DETECTOR_H_
+#define CRASHPAD_HANDLER_CRASH_LOOP_DETECTOR_H_
+
+#include <time.h>
+
+#include <map>
+#include <string>
+
+#include "base/synchronization/lock.h"
+
+namespace crashpad {
+
+//! \brief Recognizes crash loops, so that a client crashing repeatedly as it
+//!     restarts needn’t be captured in full each time.
+//!
+//! A crash loop is a series of crashes with the same signature, each within a
+//! fixed interval of the one before it. The first few crashes of a loop are
+//! captured, and the rest are only counted. The count is passed along with the
+//! next crash with the signature that is captured, whether later in the loop
+//! or in a new one, so that the report can account for them.
+//!
+//! The signature is computed before the client is captured, so it is expected
+//! to be cheap to compute and to serve only as a key within one handler.
+//!
+//! Methods may be called from multiple threads at once.
+class CrashLoopDetector {
+ public:
+  //! \param[in] captures_per_loop The number of crashes of each loop to
+  //!     capture. `0` disables detection.
+  //! \param[in] interval_seconds The longest time, in seconds, between
+  //!     consecutive crashes of a loop.
+  CrashLoopDetector(unsigned int captures_per_loop, time_t interval_seconds);
+
+  CrashLoopDetector(const CrashLoopDetector&) = delete;
+  CrashLoopDetector& operator=(const CrashLoopDetector&) = delete;
+
+  ~CrashLoopDetector();
+
+  //! \return `true` if crashes may be skipped, in which case signatures are
+  //!     needed.
+  bool enabled() const { return captures_per_loop_ != 0; }
+
+  //! \brief Determines whether a crash should be captured.
+  //!
+  //! \param[in] signature The crash’s signature. Crashes with an empty
+  //!     signature are always captured.
+  //! \param[in] now The current time.
+  //! \param[out] skipped_count The number of crashes with \a signature that
+  //!     were skipped since the last one captured, to be recorded with this
+  //!     crash. Only set if this method returns `true`.
+  //!
+  //! \return `true` if the crash should be captured. `false` if it is part of
+  //!     a crash loop that has already been captured enough.
+  bool ShouldCapture(const std::string& signature,
+                     time_t now,
+                     unsigned int* skipped_count);
+
+ private:
+  struct LoopState {
+    time_t last_crash;
+    unsigned int captured;
+    unsigned int skipped;
+  };
+
+  base::Lock lock_;
+  std::map<std::string, LoopState> loops_;  // Protected by lock_.
+  const unsigned int captures_per_loop_;
+  const time_t interval_seconds_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_CRASH_LOOP_DETECTOR_H_
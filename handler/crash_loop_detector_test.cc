@@ -0,0 +1,105 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_loop_detector.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr time_t kInterval = 60;
+
+TEST(CrashLoopDetector, Disabled) {
+  CrashLoopDetector detector(0, kInterval);
+  EXPECT_FALSE(detector.enabled());
+  for (time_t now = 0; now < 10; ++now) {
+    unsigned int skipped = 1;
+    EXPECT_TRUE(detector.ShouldCapture("a", now, &skipped));
+    EXPECT_EQ(skipped, 0u);
+  }
+}
+
+TEST(CrashLoopDetector, Loop) {
+  CrashLoopDetector detector(2, kInterval);
+  EXPECT_TRUE(detector.enabled());
+
+  unsigned int skipped;
+  EXPECT_TRUE(detector.ShouldCapture("a", 0, &skipped));
+  EXPECT_EQ(skipped, 0u);
+  EXPECT_TRUE(detector.ShouldCapture("b", 1, &skipped));
+  EXPECT_TRUE(detector.ShouldCapture("a", 2, &skipped));
+  EXPECT_EQ(skipped, 0u);
+  EXPECT_FALSE(detector.ShouldCapture("a", 3, &skipped));
+
+  // Each crash extends the loop, however long it lasts altogether.
+  time_t now = 3;
+  for (int crash = 0; crash < 10; ++crash) {
+    now += kInterval;
+    EXPECT_FALSE(detector.ShouldCapture("a", now, &skipped));
+  }
+
+  // A crash without a signature can’t be part of a loop.
+  EXPECT_TRUE(detector.ShouldCapture(std::string(), now, &skipped));
+  EXPECT_EQ(skipped, 0u);
+
+  // Once the loop ends, the next crash is captured along with the count of
+  // those skipped.
+  now += kInterval + 1;
+  EXPECT_TRUE(detector.ShouldCapture("a", now, &skipped));
+  EXPECT_EQ(skipped, 11u);
+  EXPECT_TRUE(detector.ShouldCapture("a", now + 1, &skipped));
+  EXPECT_EQ(skipped, 0u);
+  EXPECT_FALSE(detector.ShouldCapture("a", now + 2, &skipped));
+
+  // "b" crashed only once, long ago.
+  EXPECT_TRUE(detector.ShouldCapture("b", now, &skipped));
+  EXPECT_EQ(skipped, 0u);
+}
+
+TEST(CrashLoopDetector, ClockGoesBackward) {
+  CrashLoopDetector detector(1, kInterval);
+
+  unsigned int skipped;
+  EXPECT_TRUE(detector.ShouldCapture("a", 100, &skipped));
+  EXPECT_FALSE(detector.ShouldCapture("a", 101, &skipped));
+  EXPECT_TRUE(detector.ShouldCapture("a", 50, &skipped));
+  EXPECT_EQ(skipped, 1u);
+}
+
+TEST(CrashLoopDetector, ManyLoops) {
+  CrashLoopDetector detector(1, kInterval);
+
+  // Loops that are still going aren’t forgotten to make room for more, but
+  // crashes with new signatures are still captured.
+  unsigned int skipped;
+  for (int loop = 0; loop < 1000; ++loop) {
+    EXPECT_TRUE(
+        detector.ShouldCapture(std::to_string(loop), loop / 100, &skipped));
+  }
+  EXPECT_FALSE(detector.ShouldCapture("0", 10, &skipped));
+  EXPECT_TRUE(detector.ShouldCapture("999", 10, &skipped));
+  EXPECT_TRUE(detector.ShouldCapture("999", 10, &skipped));
+
+  // Idle loops are forgotten once the limit is reached.
+  EXPECT_TRUE(detector.ShouldCapture("new", 10 + kInterval + 1, &skipped));
+  EXPECT_FALSE(detector.ShouldCapture("new", 10 + kInterval + 2, &skipped));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,30 +15,53 @@
 #include "handler/crash_report_upload_thread.h"
 
 #include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/notreached.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
+#include "client/prune_crash_reports.h"
 #include "client/settings.h"
+#include "handler/batch_upload_response.h"
 #include "handler/minidump_to_upload_parameters.h"
+#include "handler/prune_crash_reports_thread.h"
+#include "handler/report_deduplicator.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
 #include "snapshot/module_snapshot.h"
 #include "util/file/file_reader.h"
+#include "util/file/file_section_reader.h"
+#include "util/file/file_writer.h"
+#include "util/file/filesystem.h"
+#include "util/file/scoped_remove_file.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
+#include "util/misc/time.h"
+#include "util/misc/trace_events.h"
 #include "util/misc/uuid.h"
 #include "util/net/http_body.h"
 #include "util/net/http_multipart_builder.h"
 #include "util/net/http_transport.h"
 #include "util/net/url.h"
 #include "util/stdlib/map_insert.h"
+#include "util/stream/file_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_APPLE)
 #include "handler/mac/file_limit_annotation.h"
@@ -48,6 +71,12 @@
 #include "util/ios/scoped_background_task.h"
 #endif  // BUILDFLAG(IS_IOS)
 
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+#include "util/posix/spawn_subprocess.h"
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
 namespace {
@@ -55,14 +84,36 @@ namespace {
 // The number of seconds to wait between checking for pending reports.
 const int kRetryWorkIntervalSeconds = 15 * 60;
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The number of seconds to wait between checking for pending reports when new
+// ones are noticed by watching the database’s pending reports directory, so
+// that the check only serves to retry deferred uploads.
+const int kWatchedRetryWorkIntervalSeconds = 60 * 60;
+
+// The number of seconds to wait after a report is moved into the pending
+// reports directory before processing it, giving the process that moved it
+// time to finish updating the database and release the report.
+constexpr double kPendingReportsWatchDelaySeconds = 1;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 #if BUILDFLAG(IS_IOS)
 // The number of times to attempt to upload a pending report, repeated on
 // failure. Attempts will happen once per launch, once per call to
 // ReportPending(), and, if Options.watch_pending_reports is true, once every
 // kRetryWorkIntervalSeconds. Currently iOS only.
 const int kRetryAttempts = 5;
+#else
+// The number of times to attempt to upload a pending report whose upload can
+// be resumed. Other reports are only attempted once.
+const int kResumableUploadAttempts = 5;
 #endif
 
+// The version of the tus resumable upload protocol spoken, as presented by the
+// Tus-Resumable header field.
+constexpr char kTusResumable[] = "Tus-Resumable";
+constexpr char kTusVersion[] = "1.0.0";
+
 // Wraps a reference to a no-args function (which can be empty). When this
 // object goes out of scope, invokes the function if it is non-empty.
 //
@@ -84,8 +135,259 @@ class ScopedFunctionInvoker final {
   const std::function<void()>& function_;
 };
 
+// Returns `true` if the contents of reader, from its current position, begin
+// with the gzip magic number. Reports written by a handler that compresses
+// minidumps are gzip files, while uncompressed minidumps begin with
+// MINIDUMP_SIGNATURE. The position of reader is unchanged.
+bool IsGzipCompressed(FileReaderInterface* reader) {
+  FileOffset start_offset = reader->SeekGet();
+  if (start_offset < 0) {
+    return false;
+  }
+
+  static constexpr uint8_t kGzipMagic[] = {0x1f, 0x8b};
+  uint8_t magic[std::size(kGzipMagic)];
+  bool gzip_compressed =
+      reader->ReadExactly(magic, sizeof(magic)) &&
+      memcmp(magic, kGzipMagic, sizeof(magic)) == 0;
+  return reader->SeekSet(start_offset) && gzip_compressed;
+}
+
+// Decompresses the gzip contents of reader into decompressed.
+bool DecompressGzipFile(FileReaderInterface* reader, StringFile* decompressed) {
+  ZlibOutputStream stream(ZlibOutputStream::Mode::kDecompress,
+                          ZlibOutputStream::Format::kGzip,
+                          std::make_unique<FileOutputStream>(decompressed));
+  FileOperationResult read_result;
+  do {
+    uint8_t buffer[4096];
+    read_result = reader->Read(buffer, sizeof(buffer));
+    if (read_result < 0 ||
+        (read_result > 0 && !stream.Write(buffer, read_result))) {
+      return false;
+    }
+  } while (read_result > 0);
+  return stream.Flush() && decompressed->SeekSet(0);
+}
+
+// Encodes data in base64, following RFC 4648 §4.
+std::string Base64Encode(const std::string& data) {
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve((data.size() + 2) / 3 * 4);
+  for (size_t index = 0; index < data.size(); index += 3) {
+    const size_t remaining = data.size() - index;
+    uint32_t group = static_cast<uint8_t>(data[index]) << 16;
+    if (remaining > 1) {
+      group |= static_cast<uint8_t>(data[index + 1]) << 8;
+    }
+    if (remaining > 2) {
+      group |= static_cast<uint8_t>(data[index + 2]);
+    }
+    encoded.append(1, kAlphabet[(group >> 18) & 0x3f]);
+    encoded.append(1, kAlphabet[(group >> 12) & 0x3f]);
+    encoded.append(1, remaining > 1 ? kAlphabet[(group >> 6) & 0x3f] : '=');
+    encoded.append(1, remaining > 2 ? kAlphabet[group & 0x3f] : '=');
+  }
+  return encoded;
+}
+
+// Returns the value of a tus Upload-Metadata header field presenting metadata.
+// Keys containing characters that the field can’t carry are discarded.
+std::string TusUploadMetadata(
+    const std::map<std::string, std::string>& metadata) {
+  std::string upload_metadata;
+  for (const auto& kv : metadata) {
+    if (kv.first.empty() ||
+        kv.first.find_first_of(" ,\t\r\n") != std::string::npos) {
+      LOG(WARNING) << "discarding metadata key " << kv.first;
+      continue;
+    }
+    if (!upload_metadata.empty()) {
+      upload_metadata.append(1, ',');
+    }
+    upload_metadata.append(kv.first);
+    upload_metadata.append(1, ' ');
+    upload_metadata.append(Base64Encode(kv.second));
+  }
+  return upload_metadata;
+}
+
+// A cached upload body file is the body, followed by its content headers as
+// “name: value” lines, and finally a CachedUploadBodyFooter. The footer is
+// written last, so that a file that wasn’t completely written is recognized.
+struct CachedUploadBodyFooter {
+  static constexpr uint32_t kMagic = 'CPub';
+  static constexpr uint32_t kVersion = 1;
+
+  uint64_t body_size;
+  uint32_t headers_size;
+  uint32_t version;
+  uint32_t magic;
+  uint32_t reserved;
+};
+static_assert(sizeof(CachedUploadBodyFooter) == 24,
+              "CachedUploadBodyFooter must not have padding");
+
+// Writes the contents of body_stream, to be sent with content_headers, to a
+// cached upload body file at path.
+bool WriteCachedUploadBody(const base::FilePath& path,
+                           const HTTPHeaders& content_headers,
+                           HTTPBodyStream* body_stream) {
+  FileWriter writer;
+  if (!writer.Open(path,
+                   FileWriteMode::kTruncateOrCreate,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  ScopedRemoveFile file_remover(path);
+
+  CachedUploadBodyFooter footer = {};
+  constexpr size_t kBufferSize = 64 * 1024;
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[kBufferSize]);
+  FileOperationResult read_result;
+  while ((read_result = body_stream->GetBytesBuffer(buffer.get(),
+                                                    kBufferSize)) > 0) {
+    if (!writer.Write(buffer.get(), read_result)) {
+      return false;
+    }
+    footer.body_size += read_result;
+  }
+  if (read_result < 0) {
+    return false;
+  }
+
+  std::string headers;
+  for (const auto& [name, value] : content_headers) {
+    headers.append(name + ": " + value + "\r\n");
+  }
+  footer.headers_size = static_cast<uint32_t>(headers.size());
+  footer.version = CachedUploadBodyFooter::kVersion;
+  footer.magic = CachedUploadBodyFooter::kMagic;
+  if (!writer.Write(headers.data(), headers.size()) ||
+      !writer.Write(&footer, sizeof(footer))) {
+    return false;
+  }
+
+  std::ignore = file_remover.release();
+  return true;
+}
+
+// Opens the cached upload body file at path in file, if it was completely
+// written. body is set to read the body from file, and content_headers to the
+// headers to send it with.
+bool OpenCachedUploadBody(const base::FilePath& path,
+                          FileReader* file,
+                          HTTPHeaders* content_headers,
+                          std::unique_ptr<FileSectionReader>* body) {
+  if (!IsRegularFile(path) || !file->Open(path)) {
+    return false;
+  }
+
+  const FileOffset file_size = file->Seek(0, SEEK_END);
+  CachedUploadBodyFooter footer;
+  std::string headers;
+  bool valid =
+      file_size >= static_cast<FileOffset>(sizeof(footer)) &&
+      file->SeekSet(file_size - sizeof(footer)) &&
+      file->ReadExactly(&footer, sizeof(footer)) &&
+      footer.magic == CachedUploadBodyFooter::kMagic &&
+      footer.version == CachedUploadBodyFooter::kVersion &&
+      footer.headers_size <= file_size - sizeof(footer) &&
+      footer.body_size == file_size - sizeof(footer) - footer.headers_size;
+  if (valid) {
+    headers.resize(footer.headers_size);
+    valid = file->SeekSet(footer.body_size) &&
+            file->ReadExactly(headers.data(), headers.size());
+  }
+  if (!valid) {
+    LOG(WARNING) << "discarding incomplete cached upload body";
+    file->Close();
+    return false;
+  }
+
+  content_headers->clear();
+  size_t line_start = 0;
+  size_t line_end;
+  while ((line_end = headers.find("\r\n", line_start)) != std::string::npos) {
+    const std::string line = headers.substr(line_start, line_end - line_start);
+    const size_t colon = line.find(": ");
+    if (colon != std::string::npos) {
+      (*content_headers)[line.substr(0, colon)] = line.substr(colon + 2);
+    }
+    line_start = line_end + 2;
+  }
+
+  *body = std::make_unique<FileSectionReader>(file, 0, footer.body_size);
+  return true;
+}
+
 }  // namespace
 
+struct CrashReportUploadThread::PendingUpload {
+  CrashReportDatabase::Report report;
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+
+  // A compressed minidump decompressed into memory, if the upload refers to
+  // it.
+  StringFile decompressed_minidump;
+
+  // The body of the upload cached in the database, if it’s sent from there.
+  FileReader cached_body_file;
+  std::unique_ptr<FileSectionReader> cached_body;
+
+  std::unique_ptr<HTTPTransport> transport;
+  std::string response_body;
+
+  // The body of the batch upload that this upload is part of, if it’s
+  // batched. Such an upload has no transport of its own.
+  HTTPMultipartBuilder* batch_builder = nullptr;
+
+  // The URL of the upload made with the tus protocol, if the upload can be
+  // resumed by a later attempt.
+  std::string resumption_url;
+
+  // When the upload was begun, for its trace event. Uploads overlap when they
+  // are made concurrently from one thread, so the event is recorded when the
+  // upload is finished.
+  uint64_t start_ns = 0;
+};
+
+class CrashReportUploadThread::UploadWorker : public Thread {
+ public:
+  UploadWorker(CrashReportUploadThread* upload_thread,
+               const std::vector<CrashReportDatabase::Report>* reports,
+               std::atomic<size_t>* next_index)
+      : Thread(),
+        upload_thread_(upload_thread),
+        reports_(reports),
+        next_index_(next_index) {}
+
+  UploadWorker(const UploadWorker&) = delete;
+  UploadWorker& operator=(const UploadWorker&) = delete;
+
+  ~UploadWorker() override {}
+
+  void ThreadMain() override {
+    size_t index;
+    while ((index = next_index_->fetch_add(1)) < reports_->size()) {
+      upload_thread_->ProcessPendingReport((*reports_)[index]);
+
+      // Respect Stop() being called after at least one attempt to process a
+      // report.
+      if (upload_thread_->StopRequested()) {
+        return;
+      }
+    }
+  }
+
+ private:
+  CrashReportUploadThread* upload_thread_;  // weak
+  const std::vector<CrashReportDatabase::Report>* reports_;  // weak
+  std::atomic<size_t>* next_index_;  // weak
+};
+
 CrashReportUploadThread::CrashReportUploadThread(
     CrashReportDatabase* database,
     const std::string& url,
@@ -101,29 +403,189 @@ CrashReportUploadThread::CrashReportUploadThread(
       thread_(options.watch_pending_reports ? kRetryWorkIntervalSeconds
                                             : WorkerThread::kIndefiniteWait,
               this),
+      stop_requested_(false),
+      start_lock_(),
+      awaiting_pending_report_(false),
+      prune_condition_(),
+      next_prune_time_ns_(0),
       known_pending_report_uuids_(),
+      upload_throttle_(),
+      default_scheduler_(),
+      scheduler_(options.scheduler),
+      deduplicator_(options.max_uploads_per_signature,
+                    options.signature_window_seconds),
+      idle_transports_lock_(),
+      idle_transports_(),
+      multi_transport_(),
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      pending_reports_watcher_(),
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       database_(database) {
   DCHECK(!url_.empty());
+#if !defined(CRASHPAD_USE_ZSTD)
+  LOG_IF(WARNING, options_.upload_zstd)
+      << "built without Zstandard support, using gzip";
+#endif  // !CRASHPAD_USE_ZSTD
+  if (options_.max_upload_bytes_per_second) {
+    upload_throttle_ = std::make_unique<HTTPBodyStreamThrottle>(
+        options_.max_upload_bytes_per_second);
+  }
+  if (!scheduler_) {
+    default_scheduler_ = std::make_unique<UploadScheduler>();
+    scheduler_ = default_scheduler_.get();
+  }
+  if (options_.prune_database) {
+    prune_condition_ = PruneCondition::GetDefault();
+  }
+  thread_.SetStackSize(options_.thread_stack_size);
+  thread_.SetPriority(options_.thread_priority);
 }
 
 CrashReportUploadThread::~CrashReportUploadThread() {
 }
 
 void CrashReportUploadThread::ReportPending(const UUID& report_uuid) {
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  if (!options_.upload_process_argv.empty()) {
+    // The process started scans the database, so it doesn’t need to be told
+    // which report is new.
+    StartUploadProcess();
+    return;
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   known_pending_report_uuids_.PushBack(report_uuid);
+  if (options_.start_on_demand) {
+    base::AutoLock lock(start_lock_);
+    if (awaiting_pending_report_) {
+      awaiting_pending_report_ = false;
+      StartThread();
+    }
+  }
   if (thread_.is_running())
     thread_.DoWorkNow();
 }
 
 void CrashReportUploadThread::Start() {
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  if (!options_.upload_process_argv.empty()) {
+    std::vector<CrashReportDatabase::Report> pending_reports;
+    if (database_->GetPendingReports(&pending_reports) !=
+            CrashReportDatabase::kNoError ||
+        !pending_reports.empty()) {
+      StartUploadProcess();
+    }
+    return;
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (options_.start_on_demand) {
+    // Reports left pending by an earlier run still need to be uploaded, so
+    // only wait for ReportPending() if there are none.
+    base::AutoLock lock(start_lock_);
+    std::vector<CrashReportDatabase::Report> pending_reports;
+    if (database_->GetPendingReports(&pending_reports) ==
+            CrashReportDatabase::kNoError &&
+        pending_reports.empty()) {
+      awaiting_pending_report_ = true;
+    } else {
+      StartThread();
+    }
+    return;
+  }
+  StartThread();
+}
+
+void CrashReportUploadThread::StartThread() {
+  stop_requested_.store(false, std::memory_order_release);
+  next_prune_time_ns_ =
+      ClockMonotonicNanoseconds() +
+      PruneCrashReportThread::kInitialDelaySeconds * kNanosecondsPerSecond;
+
+  // Cancellation is permanent, so a new HTTPMultiTransport is needed following
+  // Stop().
+  multi_transport_ = HTTPMultiTransport::Create();
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options_.watch_pending_reports) {
+    const base::FilePath pending_reports_directory =
+        database_->PendingReportsDirectory();
+
+    // This is set before the watch starts, so that it can’t replace the
+    // interval set if the watch ends right away.
+    thread_.SetWorkInterval(kWatchedRetryWorkIntervalSeconds);
+    const bool watching =
+        !pending_reports_directory.empty() &&
+        pending_reports_watcher_.Start(
+            pending_reports_directory,
+            kPendingReportsWatchDelaySeconds,
+            [this](const base::FilePath&) {
+              if (thread_.is_running())
+                thread_.DoWorkNow();
+            },
+            [this]() {
+              // Without the watch, new reports are only found by polling, so
+              // poll as often as when the watch couldn’t be started.
+              LOG(WARNING) << "pending reports no longer watched";
+              thread_.SetWorkInterval(kRetryWorkIntervalSeconds);
+              if (thread_.is_running())
+                thread_.DoWorkNow();
+            });
+    if (!watching) {
+      thread_.SetWorkInterval(kRetryWorkIntervalSeconds);
+    }
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   thread_.Start(
       options_.watch_pending_reports ? 0.0 : WorkerThread::kIndefiniteWait);
 }
 
 void CrashReportUploadThread::Stop() {
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  if (!options_.upload_process_argv.empty()) {
+    return;
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (options_.start_on_demand) {
+    base::AutoLock lock(start_lock_);
+    if (awaiting_pending_report_) {
+      awaiting_pending_report_ = false;
+      return;
+    }
+  }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (pending_reports_watcher_.is_running()) {
+    pending_reports_watcher_.Stop();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  stop_requested_.store(true, std::memory_order_release);
+  if (multi_transport_) {
+    multi_transport_->Cancel();
+  }
   thread_.Stop();
 }
 
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+void CrashReportUploadThread::StartUploadProcess() {
+  // The process is reparented away from this one, so there’s nothing to wait
+  // for. Failures are logged.
+  SpawnSubprocess(options_.upload_process_argv, nullptr, -1, false, nullptr);
+}
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 void CrashReportUploadThread::ProcessPendingReports() {
 #if BUILDFLAG(IS_IOS)
   internal::ScopedBackgroundTask scoper("CrashReportUploadThread");
@@ -134,20 +596,19 @@ void CrashReportUploadThread::ProcessPendingReports() {
   ScopedFunctionInvoker scoped_function_invoker(callback_);
 
   std::vector<UUID> known_report_uuids = known_pending_report_uuids_.Drain();
+  std::vector<CrashReportDatabase::Report> known_reports;
   for (const UUID& report_uuid : known_report_uuids) {
     CrashReportDatabase::Report report;
     if (database_->LookUpCrashReport(report_uuid, &report) !=
         CrashReportDatabase::kNoError) {
       continue;
     }
+    known_reports.push_back(report);
+  }
+  scheduler_->OrderReports(&known_reports);
 
-    ProcessPendingReport(report);
-
-    // Respect Stop() being called after at least one attempt to process a
-    // report.
-    if (!thread_.is_running()) {
-      return;
-    }
+  if (!ProcessReports(known_reports)) {
+    return;
   }
 
   // Known pending reports are always processed (above). The rest of this
@@ -166,28 +627,241 @@ void CrashReportUploadThread::ProcessPendingReports() {
     return;
   }
 
+  // An attempt to process any known report already occurred above. If such a
+  // report is still pending, upload must have failed. Don’t retry it
+  // immediately, it can wait until at least the next pass through this method.
+  reports.erase(std::remove_if(reports.begin(),
+                               reports.end(),
+                               [&known_report_uuids](
+                                   const CrashReportDatabase::Report& report) {
+                                 return std::find(known_report_uuids.begin(),
+                                                  known_report_uuids.end(),
+                                                  report.uuid) !=
+                                        known_report_uuids.end();
+                               }),
+                reports.end());
+
+  scheduler_->OrderReports(&reports);
+  ProcessReports(reports);
+}
+
+bool CrashReportUploadThread::ProcessReports(
+    const std::vector<CrashReportDatabase::Report>& pending_reports) {
+  // Small reports are uploaded in batches, and the rest individually. The rate
+  // limit permits only one upload attempt at a time, so there’s no batching
+  // when it’s in effect.
+  const bool batch_uploads =
+      !options_.batch_upload_url.empty() && !options_.rate_limit;
+  std::vector<CrashReportDatabase::Report> unbatched_reports;
+  if (batch_uploads &&
+      !ProcessReportBatches(pending_reports, &unbatched_reports)) {
+    return false;
+  }
+  const std::vector<CrashReportDatabase::Report>& reports =
+      batch_uploads ? unbatched_reports : pending_reports;
+
+  // The rate limit permits only one upload attempt at a time, so don’t bother
+  // with additional threads when it’s in effect.
+  const size_t threads =
+      std::min(static_cast<size_t>(
+                   options_.rate_limit ? 1 : options_.max_concurrent_uploads),
+               reports.size());
+
+  if (multi_transport_ && !reports.empty()) {
+    // All uploads are made from this thread, up to threads of them at a time.
+    // Each one that completes makes room for the next.
+    const size_t max_in_flight = std::max(threads, static_cast<size_t>(1));
+    size_t next_index = 0;
+    size_t in_flight = 0;
+    std::function<void()> start_more = [&]() {
+      while (in_flight < max_in_flight && next_index < reports.size() &&
+             !StopRequested()) {
+        std::shared_ptr<PendingUpload> upload =
+            BeginReportUpload(reports[next_index++], nullptr);
+        if (!upload) {
+          continue;
+        }
+
+        if (!multi_transport_->AddRequest(
+                upload->transport.get(),
+                &upload->response_body,
+                [this, upload, &in_flight, &start_more](
+                    HTTPMultiTransport::Result result) {
+                  --in_flight;
+                  UploadResult upload_result = UploadResult::kRetry;
+                  if (result == HTTPMultiTransport::Result::kSuccess) {
+                    upload_result = UploadResult::kSuccess;
+                  } else if (result == HTTPMultiTransport::Result::kCancelled) {
+                    upload_result = UploadResult::kCancelled;
+                  }
+                  FinishReportUpload(upload.get(), upload_result);
+                  start_more();
+                })) {
+          FinishReportUpload(upload.get(),
+                             multi_transport_->IsCancelled()
+                                 ? UploadResult::kCancelled
+                                 : UploadResult::kRetry);
+          continue;
+        }
+        ++in_flight;
+      }
+    };
+    start_more();
+    multi_transport_->Run();
+    return !StopRequested();
+  }
+
+  if (threads <= 1) {
+    for (const CrashReportDatabase::Report& report : reports) {
+      ProcessPendingReport(report);
+
+      // Respect Stop() being called after at least one attempt to process a
+      // report.
+      if (StopRequested()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The calling thread works alongside the additional threads.
+  std::atomic<size_t> next_index(0);
+  std::vector<std::unique_ptr<UploadWorker>> workers;
+  for (size_t index = 1; index < threads; ++index) {
+    workers.push_back(
+        std::make_unique<UploadWorker>(this, &reports, &next_index));
+    workers.back()->SetStackSize(options_.thread_stack_size);
+    workers.back()->SetPriority(options_.thread_priority);
+    workers.back()->Start();
+  }
+  UploadWorker(this, &reports, &next_index).ThreadMain();
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  return !StopRequested();
+}
+
+void CrashReportUploadThread::ProcessPendingReport(
+    const CrashReportDatabase::Report& report) {
+  std::unique_ptr<PendingUpload> upload = BeginReportUpload(report, nullptr);
+  if (!upload) {
+    return;
+  }
+
+  bool success =
+      upload->transport->ExecuteSynchronously(&upload->response_body);
+  FinishReportUpload(upload.get(),
+                     success ? UploadResult::kSuccess : UploadResult::kRetry);
+}
+
+bool CrashReportUploadThread::ProcessReportBatches(
+    const std::vector<CrashReportDatabase::Report>& reports,
+    std::vector<CrashReportDatabase::Report>* unbatched_reports) {
+  const size_t max_reports_per_batch =
+      std::max(options_.max_reports_per_batch, 1u);
+  std::vector<CrashReportDatabase::Report> batch;
   for (const CrashReportDatabase::Report& report : reports) {
-    if (std::find(known_report_uuids.begin(),
-                  known_report_uuids.end(),
-                  report.uuid) != known_report_uuids.end()) {
-      // An attempt to process the report already occurred above. The report is
-      // still pending, so upload must have failed. Don’t retry it immediately,
-      // it can wait until at least the next pass through this method.
+    // A report with a resumable upload session in progress is left to resume
+    // that session, rather than starting over as part of a batch.
+    if (report.total_size > options_.batch_upload_maximum_size ||
+        !report.upload_resumption_url.empty()) {
+      unbatched_reports->push_back(report);
       continue;
     }
 
-    ProcessPendingReport(report);
+    batch.push_back(report);
+    if (batch.size() == max_reports_per_batch) {
+      ProcessReportBatch(batch);
+      batch.clear();
 
-    // Respect Stop() being called after at least one attempt to process a
-    // report.
-    if (!thread_.is_running()) {
-      return;
+      // Respect Stop() being called after at least one attempt to process a
+      // batch.
+      if (StopRequested()) {
+        return false;
+      }
     }
   }
+
+  if (!batch.empty()) {
+    ProcessReportBatch(batch);
+  }
+  return !StopRequested();
 }
 
-void CrashReportUploadThread::ProcessPendingReport(
-    const CrashReportDatabase::Report& report) {
+void CrashReportUploadThread::ProcessReportBatch(
+    const std::vector<CrashReportDatabase::Report>& reports) {
+  HTTPMultipartBuilder http_multipart_builder;
+  SetMultipartCompression(&http_multipart_builder);
+
+  std::vector<std::unique_ptr<PendingUpload>> uploads;
+  for (const CrashReportDatabase::Report& report : reports) {
+    std::unique_ptr<PendingUpload> upload =
+        BeginReportUpload(report, &http_multipart_builder);
+    if (upload) {
+      uploads.push_back(std::move(upload));
+    }
+  }
+  if (uploads.empty()) {
+    return;
+  }
+
+  std::unique_ptr<HTTPTransport> http_transport = GetTransport();
+  if (!http_transport) {
+    for (const auto& upload : uploads) {
+      FinishReportUpload(upload.get(), UploadResult::kPermanentFailure);
+    }
+    return;
+  }
+
+  HTTPHeaders content_headers;
+  http_multipart_builder.PopulateContentHeaders(&content_headers);
+  for (const auto& content_header : content_headers) {
+    http_transport->SetHeader(content_header.first, content_header.second);
+  }
+  std::unique_ptr<HTTPBodyStream> body_stream =
+      http_multipart_builder.GetBodyStream();
+  if (upload_throttle_) {
+    body_stream = std::make_unique<ThrottledHTTPBodyStream>(
+        std::move(body_stream), upload_throttle_.get());
+  }
+  http_transport->SetBodyStream(std::move(body_stream));
+  http_transport->SetURL(options_.batch_upload_url);
+
+  std::string response_body;
+  const bool success = http_transport->ExecuteSynchronously(&response_body);
+
+  // The response applies to the whole batch, so it’s given to the scheduler
+  // once, rather than by FinishReportUpload() for each report.
+  const bool deferred = HandleUploadResponse(http_transport.get()) && !success;
+
+  // The body stream refers to the reports, which won’t outlive their uploads.
+  http_transport->SetBodyStream(nullptr);
+  {
+    base::AutoLock lock(idle_transports_lock_);
+    idle_transports_.push_back(std::move(http_transport));
+  }
+
+  std::map<UUID, std::string> report_ids;
+  if (success) {
+    report_ids = ParseBatchUploadResponse(response_body);
+  }
+  for (const auto& upload : uploads) {
+    UploadResult upload_result =
+        deferred ? UploadResult::kDeferred : UploadResult::kRetry;
+    const auto it = report_ids.find(upload->report.uuid);
+    if (it != report_ids.end()) {
+      upload->response_body = it->second;
+      upload_result = UploadResult::kSuccess;
+    }
+    FinishReportUpload(upload.get(), upload_result);
+  }
+}
+
+std::unique_ptr<CrashReportUploadThread::PendingUpload>
+CrashReportUploadThread::BeginReportUpload(
+    const CrashReportDatabase::Report& report,
+    HTTPMultipartBuilder* batch_builder) {
 #if BUILDFLAG(IS_APPLE)
   RecordFileLimitAnnotation();
 #endif  // BUILDFLAG(IS_APPLE)
@@ -202,15 +876,20 @@ void CrashReportUploadThread::ProcessPendingReport(
     // upload-enabled state stored in the database’s settings.
     database_->SkipReportUpload(report.uuid,
                                 Metrics::CrashSkippedReason::kUploadsDisabled);
-    return;
+    return nullptr;
+  }
+
+  // While uploads are deferred, leave the report pending without an attempt.
+  if (!scheduler_->MayUpload(report, time(nullptr))) {
+    return nullptr;
   }
 
   if (ShouldRateLimitUpload(report))
-    return;
+    return nullptr;
 
 #if BUILDFLAG(IS_IOS)
   if (ShouldRateLimitRetry(report))
-    return;
+    return nullptr;
 #endif  // BUILDFLAG(IS_IOS)
 
   std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
@@ -225,7 +904,7 @@ void CrashReportUploadThread::ProcessPendingReport(
       // Someone else may have gotten to it first. If they’re working on it now,
       // this will be kBusyError. If they’ve already finished with it, it’ll be
       // kReportNotFound.
-      return;
+      return nullptr;
 
     case CrashReportDatabase::kFileSystemError:
     case CrashReportDatabase::kDatabaseError:
@@ -233,24 +912,77 @@ void CrashReportUploadThread::ProcessPendingReport(
       // to at least try to get the report out of the way.
       database_->SkipReportUpload(report.uuid,
                                   Metrics::CrashSkippedReason::kDatabaseError);
-      return;
+      return nullptr;
 
     case CrashReportDatabase::kCannotRequestUpload:
       NOTREACHED();
   }
 
-  std::string response_body;
-  UploadResult upload_result =
-      UploadReport(upload_report.get(), &response_body);
+  auto upload = std::make_unique<PendingUpload>();
+  upload->start_ns = ClockMonotonicNanoseconds();
+  upload->report = report;
+  upload->upload_report = std::move(upload_report);
+  upload->batch_builder = batch_builder;
+  UploadResult upload_result = PrepareUpload(upload.get());
+  if (upload_result != UploadResult::kSuccess) {
+    FinishReportUpload(upload.get(), upload_result);
+    return nullptr;
+  }
+  return upload;
+}
+
+void CrashReportUploadThread::FinishReportUpload(PendingUpload* upload,
+                                                 UploadResult upload_result) {
+  TraceEvents::Complete("upload", "UploadReport", upload->start_ns);
+
+  // Only these results follow a request having been made.
+  if (upload_result == UploadResult::kSuccess ||
+      upload_result == UploadResult::kRetry) {
+    Metrics::CrashUploadDuration(ClockMonotonicNanoseconds() -
+                                 upload->start_ns);
+  }
+  if ((upload_result == UploadResult::kSuccess ||
+       upload_result == UploadResult::kRetry) &&
+      upload->transport && HandleUploadResponse(upload->transport.get()) &&
+      upload_result == UploadResult::kRetry) {
+    upload_result = UploadResult::kDeferred;
+  }
+
+  if (upload->transport) {
+    // The body stream refers to the report, which won’t outlive this upload.
+    upload->transport->SetBodyStream(nullptr);
+    base::AutoLock lock(idle_transports_lock_);
+    idle_transports_.push_back(std::move(upload->transport));
+  }
+  upload->decompressed_minidump.Reset();
+  if (upload->cached_body) {
+    upload->cached_body.reset();
+    upload->cached_body_file.Close();
+  }
+
+  const CrashReportDatabase::Report& report = upload->report;
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report =
+      std::move(upload->upload_report);
   switch (upload_result) {
     case UploadResult::kSuccess:
-      database_->RecordUploadComplete(std::move(upload_report), response_body);
+      // The server doesn’t normally respond to the request that completes an
+      // upload made with the tus protocol with a body. The upload’s URL
+      // identifies the report instead.
+      database_->RecordUploadComplete(std::move(upload_report),
+                                      upload->response_body.empty()
+                                          ? upload->resumption_url
+                                          : upload->response_body);
       break;
     case UploadResult::kPermanentFailure:
       upload_report.reset();
       database_->SkipReportUpload(
           report.uuid, Metrics::CrashSkippedReason::kPrepareForUploadFailed);
       break;
+    case UploadResult::kDuplicate:
+      upload_report.reset();
+      database_->SkipReportUpload(report.uuid,
+                                  Metrics::CrashSkippedReason::kDuplicate);
+      break;
     case UploadResult::kRetry:
 #if BUILDFLAG(IS_IOS)
       if (upload_report->upload_attempts > kRetryAttempts) {
@@ -260,11 +992,20 @@ void CrashReportUploadThread::ProcessPendingReport(
       } else {
         Metrics::CrashUploadSkipped(
             Metrics::CrashSkippedReason::kUploadFailedButCanRetry);
+        base::AutoLock lock(retry_uuid_time_map_lock_);
         retry_uuid_time_map_[report.uuid] =
             time(nullptr) +
             (1 << upload_report->upload_attempts) * kRetryWorkIntervalSeconds;
       }
 #else
+      // An upload that can be resumed is left pending, so that it’s resumed
+      // by a later attempt.
+      if (!upload->resumption_url.empty() &&
+          upload_report->upload_attempts + 1 < kResumableUploadAttempts) {
+        Metrics::CrashUploadSkipped(
+            Metrics::CrashSkippedReason::kUploadFailedButCanRetry);
+        break;
+      }
       upload_report.reset();
 
       // TODO(mark): Deal with retries properly: don’t call SkipReportUplaod()
@@ -274,36 +1015,152 @@ void CrashReportUploadThread::ProcessPendingReport(
                                   Metrics::CrashSkippedReason::kUploadFailed);
 #endif
       break;
+    case UploadResult::kDeferred:
+    case UploadResult::kCancelled:
+      // Releasing upload_report without recording the upload as complete
+      // leaves the report pending.
+      break;
+  }
+}
+
+bool CrashReportUploadThread::HandleUploadResponse(HTTPTransport* transport) {
+  std::string full_dump_percentage;
+  if (options_.dump_sampler &&
+      transport->GetResponseHeader(DumpSampler::kFullDumpPercentageHeader,
+                                   &full_dump_percentage) &&
+      !options_.dump_sampler->SetServerFullDumpPercentage(
+          full_dump_percentage)) {
+    LOG(WARNING) << "ignoring " << DumpSampler::kFullDumpPercentageHeader
+                 << " " << full_dump_percentage;
   }
+  return scheduler_->UploadAttempted(transport->response_status_code(),
+                                     transport->response_retry_after(),
+                                     time(nullptr));
 }
 
-CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
-    const CrashReportDatabase::UploadReport* report,
-    std::string* response_body) {
+void CrashReportUploadThread::SetMultipartCompression(
+    HTTPMultipartBuilder* http_multipart_builder) const {
+#if defined(CRASHPAD_USE_ZSTD)
+  const bool upload_zstd = options_.upload_zstd;
+#else
+  const bool upload_zstd = false;
+#endif  // CRASHPAD_USE_ZSTD
+  http_multipart_builder->SetGzipEnabled(options_.upload_gzip && !upload_zstd);
+  http_multipart_builder->SetGzipCompressionThreads(
+      options_.compression_threads);
+#if defined(CRASHPAD_USE_ZSTD)
+  http_multipart_builder->SetZstdEnabled(
+      upload_zstd,
+      options_.upload_zstd_level,
+      options_.upload_zstd_long_distance_matching);
+#endif  // CRASHPAD_USE_ZSTD
+}
+
+CrashReportUploadThread::UploadResult CrashReportUploadThread::PrepareUpload(
+    PendingUpload* upload) {
+  const CrashReportDatabase::UploadReport* report =
+      upload->upload_report.get();
+  // Parameters stored with the report when it was written spare interpreting
+  // the minidump to recover them.
   std::map<std::string, std::string> parameters;
+  std::string signature;
+  const bool have_upload_parameters =
+      report->GetUploadParameters(&parameters, &signature);
 
-  FileReader* reader = report->Reader();
+  FileReaderInterface* reader = report->Reader();
   FileOffset start_offset = reader->SeekGet();
   if (start_offset < 0) {
     return UploadResult::kPermanentFailure;
   }
 
+#if defined(CRASHPAD_USE_ZSTD)
+  const bool upload_zstd = options_.upload_zstd;
+#else
+  const bool upload_zstd = false;
+#endif  // CRASHPAD_USE_ZSTD
+  const bool upload_gzip = options_.upload_gzip && !upload_zstd;
+
+  // A compressed minidump is decompressed into memory to be interpreted, or to
+  // be uploaded otherwise compressed. When the upload is gzip-compressed, the
+  // file itself is uploaded as-is.
+  const bool gzip_compressed = IsGzipCompressed(reader);
+  StringFile& decompressed_minidump = upload->decompressed_minidump;
+  FileReaderInterface* minidump_reader = reader;
+  if (gzip_compressed && !(have_upload_parameters && upload_gzip)) {
+    if (DecompressGzipFile(reader, &decompressed_minidump)) {
+      minidump_reader = &decompressed_minidump;
+    } else {
+      LOG(ERROR) << "couldn't decompress minidump";
+    }
+  }
+
   // Ignore any errors that might occur when attempting to interpret the
   // minidump file. This may result in its being uploaded with few or no
   // parameters, but as long as there’s a dump file, the server can decide what
   // to do with it.
-  ProcessSnapshotMinidump minidump_process_snapshot;
-  if (minidump_process_snapshot.Initialize(reader)) {
-    parameters =
-        BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+  if (!have_upload_parameters) {
+    ProcessSnapshotMinidump minidump_process_snapshot;
+    if (minidump_process_snapshot.Initialize(minidump_reader)) {
+      parameters =
+          BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+      if (deduplicator_.enabled()) {
+        signature = CrashSignatureFromSnapshot(&minidump_process_snapshot);
+      }
+    }
+  }
+
+  if (deduplicator_.enabled()) {
+    // A report whose upload is being resumed was already counted.
+    unsigned int suppressed_count = 0;
+    if (!report->upload_explicitly_requested &&
+        report->upload_resumption_url.empty() &&
+        !deduplicator_.ShouldUpload(
+            signature, time(nullptr), &suppressed_count)) {
+      return UploadResult::kDuplicate;
+    }
+
+    // These take precedence over any annotations by the same names, so that
+    // the server can rely on them to merge duplicate reports.
+    if (!signature.empty()) {
+      parameters["crash_signature"] = signature;
+      if (suppressed_count) {
+        parameters["suppressed_duplicates"] =
+            base::StringPrintf("%u", suppressed_count);
+      }
+    }
+  }
+
+  if (!upload->batch_builder && !options_.resumable_upload_url.empty() &&
+      report->GetAttachments().empty()) {
+    const FileOffset end_offset = reader->Seek(0, SEEK_END);
+    if (end_offset < 0) {
+      return UploadResult::kPermanentFailure;
+    }
+    const FileOffset minidump_size = end_offset - start_offset;
+    if (static_cast<uint64_t>(minidump_size) >=
+        options_.resumable_upload_minimum_size) {
+      // The minidump is uploaded as stored, so the decompressed copy isn’t
+      // needed.
+      decompressed_minidump.Reset();
+      return PrepareResumableUpload(
+          upload, parameters, start_offset, minidump_size);
+    }
   }
 
   if (!reader->SeekSet(start_offset)) {
     return UploadResult::kPermanentFailure;
   }
 
-  HTTPMultipartBuilder http_multipart_builder;
-  http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+  // A batched report’s fields are added to the batch’s body, named for the
+  // report so that they can be told apart from other reports’.
+  HTTPMultipartBuilder report_multipart_builder;
+  HTTPMultipartBuilder& http_multipart_builder =
+      upload->batch_builder ? *upload->batch_builder : report_multipart_builder;
+  if (!upload->batch_builder) {
+    SetMultipartCompression(&http_multipart_builder);
+  }
+  const std::string key_prefix =
+      upload->batch_builder ? report->uuid.ToString() + "." : std::string();
 
   static constexpr char kMinidumpKey[] = "upload_file_minidump";
 
@@ -312,68 +1169,296 @@ CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
       LOG(WARNING) << "reserved key " << kv.first << ", discarding value "
                    << kv.second;
     } else {
-      http_multipart_builder.SetFormData(kv.first, kv.second);
+      http_multipart_builder.SetFormData(key_prefix + kv.first, kv.second);
     }
   }
 
   for (const auto& it : report->GetAttachments()) {
-    http_multipart_builder.SetFileAttachment(
-        it.first, it.first, it.second, "application/octet-stream");
+    http_multipart_builder.SetFileAttachment(key_prefix + it.first,
+                                             it.first,
+                                             it.second,
+                                             "application/octet-stream");
   }
 
-  http_multipart_builder.SetFileAttachment(kMinidumpKey,
-                                           report->uuid.ToString() + ".dmp",
-                                           reader,
-                                           "application/octet-stream");
+  FileReaderInterface* body_minidump_reader = minidump_reader;
+  if (gzip_compressed && upload_gzip) {
+    // The decompressed copy is no longer needed.
+    decompressed_minidump.Reset();
+    body_minidump_reader = reader;
+    http_multipart_builder.SetGzipCompressedFileAttachment(
+        key_prefix + kMinidumpKey,
+        report->uuid.ToString() + ".dmp",
+        reader,
+        "application/octet-stream");
+  } else {
+    if (minidump_reader != reader && !minidump_reader->SeekSet(0)) {
+      return UploadResult::kPermanentFailure;
+    }
+    http_multipart_builder.SetFileAttachment(key_prefix + kMinidumpKey,
+                                             report->uuid.ToString() + ".dmp",
+                                             minidump_reader,
+                                             "application/octet-stream");
+  }
+
+  // A batch is sent once all of its reports have been added.
+  if (upload->batch_builder) {
+    return UploadResult::kSuccess;
+  }
 
-  std::unique_ptr<HTTPTransport> http_transport(HTTPTransport::Create());
+  std::unique_ptr<HTTPTransport>& http_transport = upload->transport;
+  http_transport = GetTransport();
   if (!http_transport) {
     return UploadResult::kPermanentFailure;
   }
 
+  // A body cached in the database by an earlier attempt is sent as it was
+  // prepared then, without compressing it again. Otherwise, the body is
+  // prepared and cached before being sent, so that its size is known.
   HTTPHeaders content_headers;
-  http_multipart_builder.PopulateContentHeaders(&content_headers);
+  const base::FilePath upload_body_path =
+      options_.cache_upload_bodies ? database_->UploadBodyPath(report->uuid)
+                                   : base::FilePath();
+  if (!upload_body_path.empty() &&
+      !OpenCachedUploadBody(upload_body_path,
+                            &upload->cached_body_file,
+                            &content_headers,
+                            &upload->cached_body)) {
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    if (!WriteCachedUploadBody(upload_body_path,
+                               content_headers,
+                               http_multipart_builder.GetBodyStream().get()) ||
+        !OpenCachedUploadBody(upload_body_path,
+                              &upload->cached_body_file,
+                              &content_headers,
+                              &upload->cached_body)) {
+      LOG(WARNING) << "couldn't cache upload body";
+
+      // The body is sent without being cached, read again from the start.
+      for (const auto& it : report->GetAttachments()) {
+        if (!it.second->SeekSet(0)) {
+          return UploadResult::kPermanentFailure;
+        }
+      }
+      if (!body_minidump_reader->SeekSet(
+              body_minidump_reader == reader ? start_offset : 0)) {
+        return UploadResult::kPermanentFailure;
+      }
+    }
+  }
+
+  std::unique_ptr<HTTPBodyStream> body_stream;
+  if (upload->cached_body) {
+    decompressed_minidump.Reset();
+    content_headers[kContentLength] = base::StringPrintf(
+        "%" PRId64, static_cast<int64_t>(upload->cached_body->size()));
+    body_stream =
+        std::make_unique<FileReaderHTTPBodyStream>(upload->cached_body.get());
+  } else {
+    content_headers.clear();
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    body_stream = http_multipart_builder.GetBodyStream();
+  }
   for (const auto& content_header : content_headers) {
     http_transport->SetHeader(content_header.first, content_header.second);
   }
-  http_transport->SetBodyStream(http_multipart_builder.GetBodyStream());
-  // TODO(mark): The timeout should be configurable by the client.
-  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  if (upload_throttle_) {
+    body_stream = std::make_unique<ThrottledHTTPBodyStream>(
+        std::move(body_stream), upload_throttle_.get());
+  }
+  http_transport->SetBodyStream(std::move(body_stream));
+  http_transport->SetURL(ClientIdentifyingURL(url_, parameters));
 
-  std::string url = url_;
-  if (options_.identify_client_via_url) {
-    // Add parameters to the URL which identify the client to the server.
-    static constexpr struct {
-      const char* key;
-      const char* url_field_name;
-    } kURLParameterMappings[] = {
-        {"prod", "product"},
-        {"ver", "version"},
-        {"guid", "guid"},
-    };
+  return UploadResult::kSuccess;
+}
+
+CrashReportUploadThread::UploadResult
+CrashReportUploadThread::PrepareResumableUpload(
+    PendingUpload* upload,
+    const std::map<std::string, std::string>& parameters,
+    FileOffset minidump_offset,
+    FileOffset minidump_size) {
+  const CrashReportDatabase::UploadReport* report =
+      upload->upload_report.get();
+  FileReaderInterface* reader = report->Reader();
+
+  std::unique_ptr<HTTPTransport>& http_transport = upload->transport;
+  http_transport = GetTransport();
+  if (!http_transport) {
+    return UploadResult::kPermanentFailure;
+  }
 
-    for (const auto& parameter_mapping : kURLParameterMappings) {
-      const auto it = parameters.find(parameter_mapping.key);
-      if (it != parameters.end()) {
-        url.append(
-            base::StringPrintf("%c%s=%s",
-                               url.find('?') == std::string::npos ? '?' : '&',
-                               parameter_mapping.url_field_name,
-                               URLEncode(it->second).c_str()));
+  // The requests that precede the one that sends the minidump are made
+  // synchronously. They’re small ones, and are only made once per attempt.
+  std::string response_body;
+  std::string upload_url = report->upload_resumption_url;
+  FileOffset upload_offset = 0;
+  upload->resumption_url = upload_url;
+  if (!upload_url.empty()) {
+    // Ask how much of the upload created by an earlier attempt the server has
+    // received.
+    http_transport->SetMethod("HEAD");
+    http_transport->SetURL(upload_url);
+    http_transport->SetHeader(kTusResumable, kTusVersion);
+    http_transport->SetHeader(kContentLength, "0");
+    http_transport->SetBodyStream(
+        std::make_unique<StringHTTPBodyStream>(std::string()));
+    if (http_transport->ExecuteSynchronously(&response_body)) {
+      std::string offset_string;
+      int64_t offset;
+      if (http_transport->GetResponseHeader("Upload-Offset", &offset_string) &&
+          base::StringToInt64(offset_string, &offset) && offset >= 0 &&
+          offset <= minidump_size) {
+        upload_offset = offset;
+      } else {
+        LOG(WARNING) << "invalid Upload-Offset, restarting upload";
+        upload_url.clear();
+      }
+    } else {
+      // The server responds with one of these statuses if it no longer has
+      // the upload. Otherwise, it may only be unreachable for now.
+      const int status = http_transport->response_status_code();
+      if (status != 403 && status != 404 && status != 410) {
+        return UploadResult::kRetry;
       }
+      upload_url.clear();
+    }
+  }
+
+  if (upload_url.empty()) {
+    // Create an upload, and record its URL before sending anything to it.
+    if (!reader->SeekSet(minidump_offset)) {
+      return UploadResult::kPermanentFailure;
+    }
+    std::map<std::string, std::string> metadata = parameters;
+    metadata["filename"] = report->uuid.ToString() + ".dmp";
+    if (IsGzipCompressed(reader)) {
+      metadata["content_encoding"] = "gzip";
     }
+
+    http_transport->ClearHeaders();
+    http_transport->SetMethod("POST");
+    http_transport->SetURL(
+        ClientIdentifyingURL(options_.resumable_upload_url, parameters));
+    http_transport->SetHeader(kTusResumable, kTusVersion);
+    http_transport->SetHeader(
+        "Upload-Length",
+        base::StringPrintf("%" PRId64, static_cast<int64_t>(minidump_size)));
+    http_transport->SetHeader("Upload-Metadata", TusUploadMetadata(metadata));
+    http_transport->SetHeader(kContentLength, "0");
+    http_transport->SetBodyStream(
+        std::make_unique<StringHTTPBodyStream>(std::string()));
+    std::string location;
+    if (!http_transport->ExecuteSynchronously(&response_body)) {
+      return UploadResult::kRetry;
+    }
+    if (!http_transport->GetResponseHeader("Location", &location) ||
+        location.empty()) {
+      LOG(ERROR) << "no upload Location";
+      return UploadResult::kRetry;
+    }
+    upload_url = ResolveURL(options_.resumable_upload_url, location);
+
+    // If the URL can’t be recorded, this attempt can proceed, but a later one
+    // won’t be able to resume it.
+    upload->resumption_url =
+        database_->SetUploadResumptionURL(report, upload_url) ==
+                CrashReportDatabase::kNoError
+            ? upload_url
+            : std::string();
   }
-  http_transport->SetURL(url);
 
-  if (!http_transport->ExecuteSynchronously(response_body)) {
-    return UploadResult::kRetry;
+  if (!reader->SeekSet(minidump_offset + upload_offset)) {
+    return UploadResult::kPermanentFailure;
   }
 
+  http_transport->ClearHeaders();
+  http_transport->SetMethod("PATCH");
+  http_transport->SetURL(upload_url);
+  http_transport->SetHeader(kTusResumable, kTusVersion);
+  http_transport->SetHeader(
+      "Upload-Offset",
+      base::StringPrintf("%" PRId64, static_cast<int64_t>(upload_offset)));
+  http_transport->SetHeader(kContentType, "application/offset+octet-stream");
+  http_transport->SetHeader(
+      kContentLength,
+      base::StringPrintf("%" PRId64,
+                         static_cast<int64_t>(minidump_size - upload_offset)));
+  std::unique_ptr<HTTPBodyStream> body_stream =
+      std::make_unique<FileReaderHTTPBodyStream>(reader);
+  if (upload_throttle_) {
+    body_stream = std::make_unique<ThrottledHTTPBodyStream>(
+        std::move(body_stream), upload_throttle_.get());
+  }
+  http_transport->SetBodyStream(std::move(body_stream));
+
   return UploadResult::kSuccess;
 }
 
+std::unique_ptr<HTTPTransport> CrashReportUploadThread::GetTransport() {
+  std::unique_ptr<HTTPTransport> http_transport;
+  {
+    base::AutoLock lock(idle_transports_lock_);
+    if (!idle_transports_.empty()) {
+      http_transport = std::move(idle_transports_.back());
+      idle_transports_.pop_back();
+    }
+  }
+  if (http_transport) {
+    // Discard what was set for the transport’s previous request.
+    http_transport->ClearHeaders();
+    http_transport->SetMethod("POST");
+  } else {
+    http_transport = HTTPTransport::Create();
+    if (!http_transport) {
+      return nullptr;
+    }
+  }
+
+  // TODO(mark): The timeout should be configurable by the client.
+  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  return http_transport;
+}
+
+std::string CrashReportUploadThread::ClientIdentifyingURL(
+    const std::string& url,
+    const std::map<std::string, std::string>& parameters) const {
+  if (!options_.identify_client_via_url) {
+    return url;
+  }
+
+  // Add parameters to the URL which identify the client to the server.
+  static constexpr struct {
+    const char* key;
+    const char* url_field_name;
+  } kURLParameterMappings[] = {
+      {"prod", "product"},
+      {"ver", "version"},
+      {"guid", "guid"},
+  };
+
+  std::string identifying_url = url;
+  for (const auto& parameter_mapping : kURLParameterMappings) {
+    const auto it = parameters.find(parameter_mapping.key);
+    if (it != parameters.end()) {
+      identifying_url.append(base::StringPrintf(
+          "%c%s=%s",
+          identifying_url.find('?') == std::string::npos ? '?' : '&',
+          parameter_mapping.url_field_name,
+          URLEncode(it->second).c_str()));
+    }
+  }
+  return identifying_url;
+}
+
 void CrashReportUploadThread::DoWork(const WorkerThread* thread) {
   ProcessPendingReports();
+
+  if (prune_condition_ && ClockMonotonicNanoseconds() >= next_prune_time_ns_) {
+    PruneCrashReportThread::PruneDatabase(database_, prune_condition_.get());
+    next_prune_time_ns_ =
+        ClockMonotonicNanoseconds() +
+        PruneCrashReportThread::kIntervalSeconds * kNanosecondsPerSecond;
+  }
 }
 
 bool CrashReportUploadThread::ShouldRateLimitUpload(
@@ -388,11 +1473,14 @@ bool CrashReportUploadThread::ShouldRateLimitUpload(
     if (now >= last_upload_attempt_time) {
       // If the most recent upload attempt occurred within the past hour,
       // don’t attempt to upload the new report. If it happened longer ago,
-      // attempt to upload the report.
+      // attempt to upload the report. A report whose upload can be resumed
+      // is left pending until then, instead of being retired.
       constexpr int kUploadAttemptIntervalSeconds = 60 * 60;  // 1 hour
       if (now - last_upload_attempt_time < kUploadAttemptIntervalSeconds) {
-        database_->SkipReportUpload(
-            report.uuid, Metrics::CrashSkippedReason::kUploadThrottled);
+        if (report.upload_resumption_url.empty()) {
+          database_->SkipReportUpload(
+              report.uuid, Metrics::CrashSkippedReason::kUploadThrottled);
+        }
         return true;
       }
     } else {
@@ -415,6 +1503,7 @@ bool CrashReportUploadThread::ShouldRateLimitUpload(
 #if BUILDFLAG(IS_IOS)
 bool CrashReportUploadThread::ShouldRateLimitRetry(
     const CrashReportDatabase::Report& report) {
+  base::AutoLock lock(retry_uuid_time_map_lock_);
   if (retry_uuid_time_map_.find(report.uuid) != retry_uuid_time_map_.end()) {
     time_t now = time(nullptr);
     if (now < retry_uuid_time_map_[report.uuid]) {
@@ -15,20 +15,43 @@
 #ifndef CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 #define CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
+#include "handler/dump_sampler.h"
+#include "handler/report_deduplicator.h"
+#include "handler/upload_scheduler.h"
+#include "util/file/file_io.h"
 #include "util/misc/uuid.h"
+#include "util/net/http_body_throttled.h"
+#include "util/net/http_multi_transport.h"
+#include "util/net/http_transport.h"
 #include "util/stdlib/thread_safe_vector.h"
 #include "util/thread/stoppable.h"
+#include "util/thread/thread_priority.h"
 #include "util/thread/worker_thread.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "util/linux/directory_watcher.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
+class HTTPMultipartBuilder;
+class PruneCondition;
+
 //! \brief A thread that processes pending crash reports in a
 //!     CrashReportDatabase by uploading them or marking them as completed
 //!     without upload, as desired.
@@ -41,7 +64,9 @@ namespace crashpad {
 //! failed upload attempts for reports left in the pending state to be retried.
 //! It also catches reports that are added without a ReportPending() signal
 //! being caught. This may happen if crash reports are added to the database by
-//! other processes.
+//! other processes. Where the database’s pending reports directory can be
+//! watched, such reports are instead noticed as soon as they’re added, and the
+//! periodic examination is made less often.
 class CrashReportUploadThread : public WorkerThread::Delegate,
                                 public Stoppable {
  public:
@@ -51,17 +76,172 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
     //! should be added to the URL.
     bool identify_client_via_url;
 
+    //! The maximum number of reports to upload at the same time. Values of
+    //! `0` and `1` both cause reports to be uploaded one at a time. When
+    //! \a rate_limit is `true`, reports are always uploaded one at a time,
+    //! because the rate limit permits only one upload attempt per hour.
+    //!
+    //! All uploads are made to the same URL, so this also limits the number of
+    //! connections made to the upload server at once. Where the upload server
+    //! supports HTTP/2, concurrent uploads are multiplexed over one connection
+    //! instead.
+    //!
+    //! Where HTTPMultiTransport is supported, concurrent uploads are all made
+    //! from the upload thread without blocking on one another. Elsewhere, an
+    //! additional thread is used for each concurrent upload.
+    unsigned int max_concurrent_uploads = 1;
+
+    //! The maximum combined rate, in bytes per second, at which report data is
+    //! sent to the upload server by all concurrent uploads. `0` means that the
+    //! rate is not limited.
+    uint64_t max_upload_bytes_per_second = 0;
+
     //! Whether uploads should be throttled to a (currently hardcoded) rate.
     bool rate_limit;
 
+    //! The maximum number of reports with the same crash signature to upload
+    //! within \a signature_window_seconds. Further reports with that
+    //! signature are not uploaded, and their number is sent along with the
+    //! next report with the signature that is. Reports whose upload was
+    //! explicitly requested are always uploaded. `0` disables deduplication.
+    //!
+    //! \sa CrashSignatureFromSnapshot()
+    unsigned int max_uploads_per_signature = 0;
+
+    //! The length of the window, in seconds, used with
+    //! \a max_uploads_per_signature.
+    time_t signature_window_seconds = 60 * 60;
+
+    //! The scheduler that orders uploads and defers them when the upload
+    //! server is overloaded. This object does not take ownership of it, and it
+    //! must outlive this object. If `nullptr`, a default UploadScheduler is
+    //! used.
+    UploadScheduler* scheduler = nullptr;
+
+    //! The sampler to give the upload server’s full dump percentage to, when a
+    //! response carries DumpSampler::kFullDumpPercentageHeader. This object
+    //! does not take ownership of it, and it must outlive this object. If
+    //! `nullptr`, the header is ignored.
+    DumpSampler* dump_sampler = nullptr;
+
     //! Whether uploads should use `gzip` compression.
     bool upload_gzip;
 
+    //! The maximum number of threads that `gzip` compression of each upload
+    //! may use. Larger values shorten the time taken to prepare uploads of
+    //! large minidumps.
+    size_t compression_threads = 1;
+
+    //! Whether uploads should use Zstandard compression, with
+    //! `Content-Encoding: zstd`. This takes precedence over \a upload_gzip,
+    //! and is only honored when Crashpad is built with Zstandard support.
+    bool upload_zstd = false;
+
+    //! The Zstandard compression level used when \a upload_zstd is `true`.
+    //! `0` selects the Zstandard library’s default.
+    int upload_zstd_level = 0;
+
+    //! Whether Zstandard compression should use long-distance matching when
+    //! \a upload_zstd is `true`.
+    bool upload_zstd_long_distance_matching = false;
+
+    //! The URL at which to create uploads made with the tus resumable upload
+    //! protocol, version 1.0.0, instead of uploading reports to the upload
+    //! URL. An interrupted upload made this way is resumed from where it left
+    //! off when it’s retried, instead of being made again from the start.
+    //!
+    //! Only reports without attachments whose minidumps are at least
+    //! \a resumable_upload_minimum_size bytes are uploaded this way, and only
+    //! with a database that supports
+    //! CrashReportDatabase::SetUploadResumptionURL(). Other reports are
+    //! uploaded to the upload URL as usual. If empty, no uploads are made this
+    //! way.
+    std::string resumable_upload_url;
+
+    //! The minimum size of a report’s minidump, in bytes, for the report to be
+    //! uploaded to \a resumable_upload_url.
+    uint64_t resumable_upload_minimum_size = 1024 * 1024;
+
+    //! Whether to cache the prepared body of each report’s upload in the
+    //! database, at CrashReportDatabase::UploadBodyPath(), until the report is
+    //! uploaded. The body is compressed once, instead of on each attempt, and
+    //! is sent with a `Content-Length` instead of chunked. A cached body is
+    //! sent as it was prepared, even if the compression options have changed
+    //! since. This doesn’t apply to uploads to \a resumable_upload_url.
+    bool cache_upload_bodies = false;
+
+    //! The URL at which to upload small reports in batches, several in each
+    //! request, instead of uploading each to the upload URL on its own.
+    //!
+    //! Reports whose Report::total_size is at most
+    //! \a batch_upload_maximum_size bytes are uploaded this way, up to
+    //! \a max_reports_per_batch in each `multipart/form-data` request. Each
+    //! report’s parameters, attachments, and minidump are sent as the fields
+    //! they would be sent as on their own, with names prefixed by the report’s
+    //! UUID and a `.`, such as `<uuid>.upload_file_minidump`. The server’s
+    //! response body is expected to have a line of the form `<uuid>=<id>`, with
+    //! the ID that it assigned to the report, for each report that it
+    //! accepted. A report without one is treated as though its upload had
+    //! failed. Client-identifying parameters aren’t added to this URL, and
+    //! bodies aren’t cached for these uploads. Reports aren’t batched when
+    //! \a rate_limit is `true`. If empty, no uploads are made this way.
+    std::string batch_upload_url;
+
+    //! The maximum size of a report, in bytes, for the report to be uploaded
+    //! to \a batch_upload_url.
+    uint64_t batch_upload_maximum_size = 64 * 1024;
+
+    //! The maximum number of reports to upload in each request to
+    //! \a batch_upload_url.
+    unsigned int max_reports_per_batch = 16;
+
     //! Whether to periodically check for new pending reports not already known
-    //! to exist. When `false`, only an initial upload attempt will be made for
-    //! reports known to exist by having been added by the ReportPending()
-    //! method. No scans for new pending reports will be conducted.
+    //! to exist, and to watch for them where supported. When `false`, only an
+    //! initial upload attempt will be made for reports known to exist by
+    //! having been added by the ReportPending() method. No scans for new
+    //! pending reports will be conducted.
     bool watch_pending_reports;
+
+    //! Whether to defer starting the upload thread until a report is pending.
+    //! When `true`, Start() only starts the thread if the database already
+    //! has pending reports, and the thread is otherwise started by the first
+    //! call to ReportPending(). Once started, the thread runs until Stop().
+    //! Until then, reports added to the database by other processes aren’t
+    //! noticed.
+    bool start_on_demand = false;
+
+    //! Whether the upload thread should also prune the database, as a
+    //! PruneCrashReportThread using PruneCondition::GetDefault() would, so
+    //! that a separate pruning thread isn’t needed. The database is pruned
+    //! when the thread makes its periodic check for pending reports, so this
+    //! has no effect unless \a watch_pending_reports is `true`.
+    bool prune_database = false;
+
+    //! The stack size, in bytes, of the upload thread and of any additional
+    //! threads used for concurrent uploads. `0` uses the platform’s default.
+    //!
+    //! \sa Thread::SetStackSize()
+    size_t thread_stack_size = 0;
+
+    //! The priority of the upload thread and of any additional threads used
+    //! for concurrent uploads.
+    //!
+    //! \sa Thread::SetPriority()
+    ThreadPriority thread_priority = ThreadPriority::kDefault;
+
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    //! If not empty, reports aren’t uploaded from this process. Instead, a
+    //! process is started with this argument vector each time a report is
+    //! pending, and at Start() if the database already has pending reports,
+    //! to upload the database’s pending reports and exit. `argv[0]` must be
+    //! the absolute path of the executable. No upload thread is started, and
+    //! the other options only affect the process started.
+    //!
+    //! Failed uploads are retried when the next such process is started.
+    std::vector<std::string> upload_process_argv;
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   };
 
   //! \brief Observation callback invoked each time the in-process handler
@@ -107,6 +287,9 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
 
   //! \brief Starts a dedicated upload thread, which executes ThreadMain().
   //!
+  //! With Options::start_on_demand, the thread may instead be started later by
+  //! ReportPending().
+  //!
   //! This method may only be be called on a newly-constructed object or after
   //! a call to Stop().
   void Start() override;
@@ -115,8 +298,9 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //!
   //! The upload thread will terminate after completing whatever task it is
   //! performing. If it is not performing any task, it will terminate
-  //! immediately. This method blocks while waiting for the upload thread to
-  //! terminate.
+  //! immediately. Uploads in progress through HTTPMultiTransport are abandoned,
+  //! leaving their reports pending so that they can be uploaded later. This
+  //! method blocks while waiting for the upload thread to terminate.
   //!
   //! This method must only be called after Start(). If Start() has been called,
   //! this method must be called before destroying an object of this class.
@@ -147,8 +331,40 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
     //! may arrange to call UploadReport() for the report again in the future,
     //! after a suitable delay.
     kRetry,
+
+    //! \brief The crash report upload failed because the server asked for
+    //!     uploads to be deferred.
+    //!
+    //! The report remains pending, so that its upload will be retried once
+    //! UploadScheduler permits.
+    kDeferred,
+
+    //! \brief The crash report upload was abandoned because Stop() was called.
+    //!
+    //! The report remains pending.
+    kCancelled,
+
+    //! \brief The crash report was not uploaded because too many reports with
+    //!     the same signature were uploaded recently.
+    //!
+    //! No further upload attempts should be made for the report.
+    kDuplicate,
   };
 
+  struct PendingUpload;
+
+  //! \brief Starts the upload thread, for Start() or, with
+  //!     Options::start_on_demand, ReportPending().
+  void StartThread();
+
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  //! \brief Starts a process to upload pending reports, with
+  //!     Options::upload_process_argv.
+  void StartUploadProcess();
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   //! \brief Calls ProcessPendingReport() on pending reports.
   //!
   //! Assuming Stop() has not been called, this will process reports that the
@@ -158,34 +374,148 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! well.
   void ProcessPendingReports();
 
+  //! \brief Calls ProcessPendingReport() on each of \a pending_reports, on up
+  //!     to Options::max_concurrent_uploads threads, or uploads up to that
+  //!     many of \a pending_reports at once with multi_transport_ where it is
+  //!     available. With Options::batch_upload_url, small reports are instead
+  //!     uploaded in batches by ProcessReportBatches().
+  //!
+  //! \return `false` if Stop() was called before all of \a pending_reports
+  //!     were processed, and `true` otherwise.
+  bool ProcessReports(
+      const std::vector<CrashReportDatabase::Report>& pending_reports);
+
   //! \brief Processes a single pending report from the database.
   //!
   //! \param[in] report The crash report to process.
   //!
   //! If report upload is enabled, this method attempts to upload \a report by
-  //! calling UplaodReport(). If the upload is successful, the report will be
-  //! marked as “completed” in the database. If the upload fails and more
-  //! retries are desired, the report’s upload-attempt count and
-  //! last-upload-attempt time will be updated in the database and it will
-  //! remain in the “pending” state. If the upload fails and no more retries are
-  //! desired, or report upload is disabled, it will be marked as “completed” in
-  //! the database without ever having been uploaded.
+  //! calling BeginReportUpload() and FinishReportUpload(). If the upload is
+  //! successful, the report will be marked as “completed” in the database. If
+  //! the upload fails and more retries are desired, the report’s
+  //! upload-attempt count and last-upload-attempt time will be updated in the
+  //! database and it will remain in the “pending” state. If the upload fails
+  //! and no more retries are desired, or report upload is disabled, it will be
+  //! marked as “completed” in the database without ever having been uploaded.
   void ProcessPendingReport(const CrashReportDatabase::Report& report);
 
-  //! \brief Attempts to upload a crash report.
+  //! \brief Uploads those of \a reports that are small enough, and that have
+  //!     no resumable upload in progress, to Options::batch_upload_url, in
+  //!     batches of up to Options::max_reports_per_batch.
+  //!
+  //! \param[in] reports The crash reports to process.
+  //! \param[out] unbatched_reports Those of \a reports that weren’t eligible
+  //!     to be batched, to be processed individually.
+  //!
+  //! \return `false` if Stop() was called before all of the eligible reports
+  //!     were processed, and `true` otherwise.
+  bool ProcessReportBatches(
+      const std::vector<CrashReportDatabase::Report>& reports,
+      std::vector<CrashReportDatabase::Report>* unbatched_reports);
+
+  //! \brief Uploads \a reports to Options::batch_upload_url in one request.
+  //!
+  //! Each report is processed as ProcessPendingReport() would, with its result
+  //! taken from the server’s response to the batch.
+  //!
+  //! \param[in] reports The crash reports to process.
+  void ProcessReportBatch(
+      const std::vector<CrashReportDatabase::Report>& reports);
+
+  //! \brief Begins processing a single pending report, as
+  //!     ProcessPendingReport() does, up to the point of sending it.
+  //!
+  //! \param[in] report The crash report to process.
+  //! \param[in] batch_builder If not `nullptr`, the report is added to this
+  //!     body of a batch upload to Options::batch_upload_url, instead of being
+  //!     given a transport of its own.
+  //!
+  //! \return An upload ready to be made with its PendingUpload::transport, or
+  //!     as part of \a batch_builder, to be passed to FinishReportUpload() when
+  //!     it’s done. `nullptr` if no upload should be made, in which case
+  //!     processing of \a report is complete.
+  std::unique_ptr<PendingUpload> BeginReportUpload(
+      const CrashReportDatabase::Report& report,
+      HTTPMultipartBuilder* batch_builder);
+
+  //! \brief Records the result of an upload started by BeginReportUpload() in
+  //!     the database.
+  //!
+  //! \param[in] upload The upload. Its transport is kept for reuse. An upload
+  //!     made as part of a batch has no transport, and the server’s response
+  //!     to the batch must already have been given to the scheduler.
+  //! \param[in] upload_result The result of the upload attempt.
+  void FinishReportUpload(PendingUpload* upload, UploadResult upload_result);
+
+  //! \brief Gives the server’s response to an upload to Options::dump_sampler
+  //!     and the scheduler.
+  //!
+  //! \param[in] transport The transport that made the upload.
+  //!
+  //! \return `true` if the scheduler deferred further uploads, in which case
+  //!     a failed upload should be left pending.
+  bool HandleUploadResponse(HTTPTransport* transport);
+
+  //! \brief Configures compression of \a http_multipart_builder’s body as
+  //!     Options::upload_gzip and Options::upload_zstd require.
+  void SetMultipartCompression(
+      HTTPMultipartBuilder* http_multipart_builder) const;
+
+  //! \brief Prepares to upload a crash report.
+  //!
+  //! \param[in,out] upload The upload, whose PendingUpload::upload_report has
+  //!     been obtained from CrashReportDatabase::GetReportForUploading(). On
+  //!     success, PendingUpload::transport is configured to upload it, or, for
+  //!     a batched upload, the report is added to
+  //!     PendingUpload::batch_builder. The
+  //!     server’s response body is to be placed in
+  //!     PendingUpload::response_body. Breakpad-type servers provide the crash
+  //!     ID assigned by the server in the response body.
+  //!
+  //! \return UploadResult::kSuccess if the upload is ready to be made.
+  //!     Otherwise, a member of UploadResult indicating why not.
+  UploadResult PrepareUpload(PendingUpload* upload);
+
+  //! \brief Prepares to upload a crash report to
+  //!     Options::resumable_upload_url, as PrepareUpload() does.
+  //!
+  //! An upload is created unless one was created for the report by an earlier
+  //! attempt, in which case the server is asked how much of it was received.
+  //! PendingUpload::transport is then configured to send the rest. The report
+  //! remains pending if the upload fails, so that it’s resumed by a later
+  //! attempt.
   //!
-  //! \param[in] report The report to upload. The caller is responsible for
-  //!     calling CrashReportDatabase::GetReportForUploading() before calling
-  //!     this method, and for calling
-  //!     CrashReportDatabase::RecordUploadComplete() after calling this method.
-  //! \param[out] response_body If the upload attempt is successful, this will
-  //!     be set to the response body sent by the server. Breakpad-type servers
-  //!     provide the crash ID assigned by the server in the response body.
+  //! \param[in,out] upload The upload.
+  //! \param[in] parameters The parameters that would accompany the minidump
+  //!     in a `multipart/form-data` upload, which are sent as the upload’s
+  //!     metadata.
+  //! \param[in] minidump_offset The offset of the minidump in the report’s
+  //!     reader.
+  //! \param[in] minidump_size The size of the minidump.
   //!
-  //! \return A member of UploadResult indicating the result of the upload
-  //!    attempt.
-  UploadResult UploadReport(const CrashReportDatabase::UploadReport* report,
-                            std::string* response_body);
+  //! \return As PrepareUpload() does.
+  UploadResult PrepareResumableUpload(
+      PendingUpload* upload,
+      const std::map<std::string, std::string>& parameters,
+      FileOffset minidump_offset,
+      FileOffset minidump_size);
+
+  //! \brief Obtains a transport kept for reuse, or creates a new one.
+  //!
+  //! \return The transport, with no header fields set, or `nullptr` on
+  //!     failure.
+  std::unique_ptr<HTTPTransport> GetTransport();
+
+  //! \brief Adds parameters that identify the client to \a url, if
+  //!     Options::identify_client_via_url is set.
+  //!
+  //! \param[in] url The URL to add the parameters to.
+  //! \param[in] parameters The upload parameters to take their values from.
+  //!
+  //! \return The URL, with any parameters added.
+  std::string ClientIdentifyingURL(
+      const std::string& url,
+      const std::map<std::string, std::string>& parameters) const;
 
   // WorkerThread::Delegate:
   //! \brief Calls ProcessPendingReports() in response to ReportPending() having
@@ -223,14 +553,56 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   bool ShouldRateLimitRetry(const CrashReportDatabase::Report& report);
 #endif
 
+  class UploadWorker;
+
+  bool StopRequested() const {
+    return stop_requested_.load(std::memory_order_acquire);
+  }
+
   const Options options_;
   const ProcessPendingReportsObservationCallback callback_;
   const std::string url_;
   WorkerThread thread_;
+
+  // Set by Stop() and cleared when the upload thread is started. Checked
+  // between uploads by the upload thread and any UploadWorker threads, which
+  // can’t safely ask thread_ whether it’s running.
+  std::atomic<bool> stop_requested_;
+
+  // Set by Start() when Options::start_on_demand left the upload thread
+  // unstarted, and cleared when ReportPending() starts it or Stop() is called.
+  base::Lock start_lock_;
+  bool awaiting_pending_report_;
+
+  // Used on the upload thread with Options::prune_database.
+  std::unique_ptr<PruneCondition> prune_condition_;
+  uint64_t next_prune_time_ns_;
   ThreadSafeVector<UUID> known_pending_report_uuids_;
+  std::unique_ptr<HTTPBodyStreamThrottle> upload_throttle_;
+  std::unique_ptr<UploadScheduler> default_scheduler_;
+  UploadScheduler* scheduler_;  // weak, options_.scheduler or
+                                // default_scheduler_
+  ReportDeduplicator deduplicator_;
+
+  // Transports not currently in use by an upload, kept so that their
+  // connections to the upload server can be reused.
+  base::Lock idle_transports_lock_;
+  std::vector<std::unique_ptr<HTTPTransport>> idle_transports_;
+
+  // Created by Start() where supported, used only by the upload thread, and
+  // cancelled by Stop().
+  std::unique_ptr<HTTPMultiTransport> multi_transport_;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Started by Start() when watching for pending reports, and stopped by
+  // Stop().
+  DirectoryWatcher pending_reports_watcher_;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_IOS)
-  // This is not thread-safe, and only used by the worker thread.
+  // This is only used by the worker thread and UploadWorker threads, which
+  // access it under retry_uuid_time_map_lock_.
   std::map<UUID, time_t> retry_uuid_time_map_;
+  base::Lock retry_uuid_time_map_lock_;
 #endif
   CrashReportDatabase* database_;  // weak
 };
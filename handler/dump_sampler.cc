@@ -0,0 +1,93 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/dump_sampler.h"
+
+#include "base/rand_util.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+
+namespace {
+
+// Signatures whose window has ended are forgotten once more than this many
+// are tracked.
+constexpr size_t kMaxSignatures = 256;
+
+}  // namespace
+
+DumpSampler::DumpSampler(unsigned int full_dumps_per_signature,
+                         time_t window_seconds,
+                         unsigned int full_dump_percentage)
+    : lock_(),
+      signatures_(),
+      full_dumps_per_signature_(full_dumps_per_signature),
+      window_seconds_(window_seconds),
+      full_dump_percentage_(full_dump_percentage) {}
+
+DumpSampler::~DumpSampler() {}
+
+bool DumpSampler::ShouldWriteFullDump(const std::string& signature,
+                                      time_t now) {
+  if (full_dumps_per_signature_ != 0 && !signature.empty()) {
+    base::AutoLock lock(lock_);
+
+    auto it = signatures_.find(signature);
+    if (it == signatures_.end()) {
+      if (signatures_.size() >= kMaxSignatures) {
+        for (auto expired = signatures_.begin();
+             expired != signatures_.end();) {
+          if (now - expired->second.window_start >= window_seconds_) {
+            expired = signatures_.erase(expired);
+          } else {
+            ++expired;
+          }
+        }
+      }
+      // If every tracked signature is still within its window, this one goes
+      // untracked, and is sampled like any crash past its allowance.
+      if (signatures_.size() < kMaxSignatures) {
+        signatures_[signature] = {now, 1};
+        return true;
+      }
+    } else {
+      SignatureState& state = it->second;
+      if (now - state.window_start >= window_seconds_ ||
+          now < state.window_start) {
+        state = {now, 1};
+        return true;
+      }
+      if (state.full_dumps < full_dumps_per_signature_) {
+        ++state.full_dumps;
+        return true;
+      }
+    }
+  }
+
+  const unsigned int percentage = full_dump_percentage();
+  return percentage >= 100 ||
+         (percentage > 0 &&
+          static_cast<unsigned int>(base::RandInt(0, 99)) < percentage);
+}
+
+bool DumpSampler::SetServerFullDumpPercentage(const std::string& value) {
+  unsigned int percentage;
+  if (!StringToNumber(value, &percentage) || percentage > 100) {
+    return false;
+  }
+  full_dump_percentage_.store(percentage, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace crashpad
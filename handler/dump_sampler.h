@@ -0,0 +1,111 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_DUMP_SAMPLER_H_
+#define CRASHPAD_HANDLER_DUMP_SAMPLER_H_
+
+#include <time.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "base/synchronization/lock.h"
+
+namespace crashpad {
+
+//! \brief Decides which crashes get a full dump and which a reduced one.
+//!
+//! A full dump carries everything the handler was configured to capture,
+//! including memory referenced from the stacks, extra memory ranges the client
+//! registered, and full memory. A reduced dump carries the threads, their
+//! stacks, the modules, and the annotations, but none of that extra memory, so
+//! it costs far less to capture and store.
+//!
+//! Within a window that begins with the first crash with a given signature, the
+//! first few crashes with that signature get full dumps. Beyond those, each
+//! crash gets a full dump with a fixed probability. This keeps rich dumps of
+//! rare crashes, while a frequent crash doesn’t have every instance of it
+//! captured in full.
+//!
+//! The probability may be replaced by one received from the upload server, so
+//! that the server can adjust how much it receives without a client update.
+//!
+//! Methods may be called from multiple threads at once.
+class DumpSampler {
+ public:
+  //! \brief The name of the HTTP response header field by which the upload
+  //!     server may replace the full dump percentage.
+  //!
+  //! Its value is a number from `0` to `100`.
+  static constexpr char kFullDumpPercentageHeader[] =
+      "Crashpad-Full-Dump-Percentage";
+
+  //! \param[in] full_dumps_per_signature The number of crashes with the same
+  //!     signature to write full dumps of per window, regardless of \a
+  //!     full_dump_percentage.
+  //! \param[in] window_seconds The length of the window, in seconds.
+  //! \param[in] full_dump_percentage The percentage of other crashes, chosen
+  //!     at random, to write full dumps of.
+  DumpSampler(unsigned int full_dumps_per_signature,
+              time_t window_seconds,
+              unsigned int full_dump_percentage);
+
+  DumpSampler(const DumpSampler&) = delete;
+  DumpSampler& operator=(const DumpSampler&) = delete;
+
+  ~DumpSampler();
+
+  //! \brief Determines whether a crash should get a full dump.
+  //!
+  //! \param[in] signature The crash’s signature, as returned by
+  //!     CrashSignatureFromSnapshot(). Crashes with an empty signature are
+  //!     only subject to the full dump percentage.
+  //! \param[in] now The current time.
+  //!
+  //! \return `true` if a full dump should be written, `false` if a reduced
+  //!     one should be.
+  bool ShouldWriteFullDump(const std::string& signature, time_t now);
+
+  //! \brief Replaces the full dump percentage given to the constructor with
+  //!     one received from the upload server.
+  //!
+  //! \param[in] value The value of a #kFullDumpPercentageHeader response
+  //!     header field.
+  //!
+  //! \return `true` if \a value was a valid percentage and is now in effect.
+  //!     `false` if it wasn’t, in which case the percentage is unchanged.
+  bool SetServerFullDumpPercentage(const std::string& value);
+
+  //! \return The full dump percentage currently in effect.
+  unsigned int full_dump_percentage() const {
+    return full_dump_percentage_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct SignatureState {
+    time_t window_start;
+    unsigned int full_dumps;
+  };
+
+  base::Lock lock_;
+  std::map<std::string, SignatureState> signatures_;  // Protected by lock_.
+  const unsigned int full_dumps_per_signature_;
+  const time_t window_seconds_;
+  std::atomic<unsigned int> full_dump_percentage_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_DUMP_SAMPLER_H_
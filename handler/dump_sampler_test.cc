@@ -0,0 +1,93 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/dump_sampler.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr time_t kWindow = 24 * 60 * 60;
+
+TEST(DumpSampler, AllFull) {
+  DumpSampler sampler(0, kWindow, 100);
+  for (time_t now = 0; now < 10; ++now) {
+    EXPECT_TRUE(sampler.ShouldWriteFullDump("a", now));
+    EXPECT_TRUE(sampler.ShouldWriteFullDump(std::string(), now));
+  }
+}
+
+TEST(DumpSampler, PerSignature) {
+  DumpSampler sampler(2, kWindow, 0);
+
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", 0));
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("b", 1));
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", 2));
+  EXPECT_FALSE(sampler.ShouldWriteFullDump("a", 3));
+  EXPECT_FALSE(sampler.ShouldWriteFullDump("a", kWindow - 1));
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("b", kWindow - 1));
+  EXPECT_FALSE(sampler.ShouldWriteFullDump("b", kWindow));
+
+  // A crash without a signature can’t be counted against an allowance.
+  EXPECT_FALSE(sampler.ShouldWriteFullDump(std::string(), 4));
+
+  // The window restarts once it has ended.
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", kWindow));
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", kWindow + 1));
+  EXPECT_FALSE(sampler.ShouldWriteFullDump("a", kWindow + 2));
+}
+
+TEST(DumpSampler, Percentage) {
+  DumpSampler sampler(0, kWindow, 50);
+
+  constexpr int kCrashes = 1000;
+  int full_dumps = 0;
+  for (int crash = 0; crash < kCrashes; ++crash) {
+    if (sampler.ShouldWriteFullDump("a", crash)) {
+      ++full_dumps;
+    }
+  }
+
+  // This fails with a probability of less than one in a billion.
+  EXPECT_GT(full_dumps, kCrashes * 4 / 10);
+  EXPECT_LT(full_dumps, kCrashes * 6 / 10);
+}
+
+TEST(DumpSampler, ServerPercentage) {
+  DumpSampler sampler(1, kWindow, 100);
+  EXPECT_EQ(sampler.full_dump_percentage(), 100u);
+
+  EXPECT_FALSE(sampler.SetServerFullDumpPercentage("101"));
+  EXPECT_FALSE(sampler.SetServerFullDumpPercentage("-1"));
+  EXPECT_FALSE(sampler.SetServerFullDumpPercentage("half"));
+  EXPECT_EQ(sampler.full_dump_percentage(), 100u);
+
+  ASSERT_TRUE(sampler.SetServerFullDumpPercentage("0"));
+  EXPECT_EQ(sampler.full_dump_percentage(), 0u);
+
+  // The per-signature allowance still applies.
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", 0));
+  EXPECT_FALSE(sampler.ShouldWriteFullDump("a", 1));
+
+  ASSERT_TRUE(sampler.SetServerFullDumpPercentage("100"));
+  EXPECT_TRUE(sampler.ShouldWriteFullDump("a", 2));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -16,12 +16,15 @@
 
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -44,31 +47,44 @@
 #include "client/crashpad_info.h"
 #include "client/prune_crash_reports.h"
 #include "client/simple_string_dictionary.h"
+#include "client/settings.h"
+#include "handler/crash_loop_detector.h"
 #include "handler/crash_report_upload_thread.h"
+#include "handler/dump_sampler.h"
 #include "handler/prune_crash_reports_thread.h"
+#include "handler/stats_writer_thread.h"
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
 #include "util/misc/address_types.h"
+#include "util/misc/local_stats.h"
 #include "util/misc/metrics.h"
 #include "util/misc/paths.h"
+#include "util/misc/trace_events.h"
 #include "util/numeric/in_range_cast.h"
 #include "util/stdlib/map_insert.h"
 #include "util/stdlib/string_number_conversion.h"
 #include "util/string/split_string.h"
 #include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+#include "util/thread/thread_priority.h"
 
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
 #include "handler/linux/cros_crash_report_exception_handler.h"
 #endif
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <malloc.h>
 #include <unistd.h>
 
 #include "handler/linux/crash_report_exception_handler.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/linux/handler_pool.h"
+#include "snapshot/shallow_module_filter.h"
+#include "util/linux/socket.h"
 #include "util/posix/signals.h"
 #elif BUILDFLAG(IS_APPLE)
 #include <libgen.h>
+#include <malloc/malloc.h>
 #include <signal.h>
 
 #include "base/apple/scoped_mach_port.h"
@@ -80,12 +96,14 @@
 #include "util/posix/close_stdio.h"
 #include "util/posix/signals.h"
 #elif BUILDFLAG(IS_WIN)
+#include <malloc.h>
 #include <windows.h>
 
 #include "handler/win/crash_report_exception_handler.h"
 #include "util/win/exception_handler_server.h"
 #include "util/win/handle.h"
 #include "util/win/initial_client_data.h"
+#include "util/win/process_info.h"
 #include "util/win/session_end_watcher.h"
 #endif  // BUILDFLAG(IS_APPLE)
 
@@ -93,6 +111,11 @@ namespace crashpad {
 
 namespace {
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+constexpr uint64_t kNanosecondsPerMillisecond = 1000000;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 #if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
     BUILDFLAG(IS_ANDROID)
 #define ATTACHMENTS_SUPPORTED 1
@@ -114,8 +137,87 @@ void Usage(const base::FilePath& me) {
   // clang-format on
 #endif  // ATTACHMENTS_SUPPORTED
       // clang-format off
+"      --background-tasks      upload and prune the database at background CPU\n"
+"                              and I/O priority\n"
+"      --batch-upload-url=URL  upload small reports to URL several at a time\n"
+"      --cache-upload-bodies   keep prepared upload bodies for retries\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --capture-time-limit=MILLISECONDS\n"
+"                              write a partial snapshot if capture takes longer\n"
+"      --client-annotation=PRODUCT:KEY=VALUE\n"
+"                              set a process annotation in PRODUCT's reports\n"
+"      --client-database=PRODUCT=PATH\n"
+"                              store PRODUCT's crash reports at PATH\n"
+"      --client-url=PRODUCT=URL\n"
+"                              upload PRODUCT's crash reports to URL\n"
+"      --compress-minidumps    gzip-compress minidumps in the database\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --compact-memory-info   merge like regions of the memory info stream, and\n"
+"                              leave out free, reserved, and guard regions\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --compression-threads=N gzip-compress on up to N threads\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --crash-loop-captures=N capture only the first N crashes of a crash loop\n"
+"      --crash-loop-interval=SECONDS\n"
+"                              treat crashes this close together as a loop\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --database=PATH         store the crash report database at PATH\n"
   // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --database-durability=none|data|full\n"
+"                              flush reports to storage as they are written\n"
+"      --deduplicate-thread-stacks\n"
+"                              store identical thread stacks only once\n"
+"      --defer-report-writing  release the client before writing the report\n"
+"      --full-dump-percentage=PERCENT\n"
+"                              write a full dump for only PERCENT of crashes,\n"
+"                              and a reduced dump for the rest\n"
+"      --full-dumps-per-signature=N\n"
+"                              write full dumps of the first N crashes with the\n"
+"                              same signature each day\n"
+"      --full-memory           capture all of the client's readable memory\n"
+"      --full-memory-exclude=KINDS\n"
+"                              leave mappings of the comma-separated KINDS out\n"
+"                              of --full-memory: file-backed, anonymous,\n"
+"                              read-only, executable, non-resident\n"
+"      --full-report-percentage=PERCENT\n"
+"                              write a full report for only PERCENT of crashes\n"
+"                              that get a --micro-dump-database report\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --elevated-capture-priority\n"
+"                              capture crashes at elevated CPU and I/O priority\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --exclude-handle-type=TYPE\n"
+"                              don't record the client's handles of TYPE\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --fast-start            finish initializing after becoming ready for\n"
+"                              crashes\n"
+  // clang-format on
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --handshake-fd=FD       establish communication with the client over FD\n"
@@ -137,21 +239,82 @@ void Usage(const base::FilePath& me) {
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
       // clang-format off
 "      --initial-client-fd=FD  a socket connected to a client.\n"
+"      --listen-socket=PATH    serve every client that connects to PATH\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+      // clang-format off
+"      --low-idle-memory       use less memory while waiting for crashes\n"
+  // clang-format on
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --mach-service=SERVICE  register SERVICE with the bootstrap server\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || \
+    BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --max-concurrent-crash-dumps=N\n"
+"                              handle up to N crash dump requests at once\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --max-concurrent-uploads=N\n"
+"                              upload up to N crash reports at once\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --max-exception-thread-stack-size=BYTES\n"
+"                              capture up to BYTES of the crashing thread stack\n"
+"      --max-listed-threads=N  list up to N threads in the standard thread list,\n"
+"                              and describe all threads compactly\n"
+"      --max-thread-stack-size=BYTES\n"
+"                              capture up to BYTES of other threads' stacks\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --max-handles=N         record up to N of the client's handles\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
       // clang-format off
+"      --max-upload-bytes-per-second=N\n"
+"                              limit the combined upload rate to N bytes/second\n"
+"      --max-uploads-per-signature=N\n"
+"                              upload up to N reports of the same crash in each\n"
+"                              --signature-window\n"
 "      --metrics-dir=DIR       store metrics files in DIR (only in Chromium)\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --micro-dump-database=PATH\n"
+"                              also write a small report of the crashing thread\n"
+"                              to the database at PATH\n"
+"      --micro-dump-stack-size=BYTES\n"
+"                              keep up to BYTES of the stack in a micro dump\n"
+"      --micro-dump-url=URL    upload micro dumps to URL as they are written\n"
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+"      --minidump-consumer-socket=PATH\n"
+"                              hand each minidump off in memory to the socket\n"
+"                              at PATH\n"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+"      --module-initialization-threads=N\n"
+"                              initialize module snapshots on up to N threads\n"
+"      --module-memory-cache-pages=N\n"
+"                              cache up to N pages of module memory per dump\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --monitor-self          run a second handler to catch crashes in the first\n"
 "      --monitor-self-annotation=KEY=VALUE\n"
 "                              set a module annotation in the handler\n"
 "      --monitor-self-argument=ARGUMENT\n"
 "                              provide additional arguments to the second handler\n"
+"      --monitor-self-minimal  run the --monitor-self handler without uploading\n"
+"                              or pruning, leaving its reports to this handler\n"
 "      --no-identify-client-via-url\n"
 "                              when uploading crash report, don't add\n"
 "                              client-identifying arguments to URL\n"
@@ -159,36 +322,96 @@ void Usage(const base::FilePath& me) {
 "      --no-rate-limit         don't rate limit crash uploads\n"
 "      --no-upload-gzip        don't use gzip compression when uploading\n"
   // clang-format on
-#if BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --no-write-minidump-to-database\n"
 "                              don't write minidump to database\n"
   // clang-format on
-#endif  // BUILDFLAG(IS_ANDROID)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --pack-reports          store a report and its attachments in one file\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
       // clang-format off
 "      --pipe-name=PIPE        communicate with the client over PIPE\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --pool-size=N           keep N idle handlers ready for --pool-socket\n"
+"      --pool-socket=PATH      hand each client connecting to PATH to one of a\n"
+"                              pool of started handlers\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --reset-own-crash-exception-port-to-system-default\n"
 "                              reset the server's exception handler to default\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
+      // clang-format off
+"      --resumable-upload-url=URL\n"
+"                              upload large reports to URL with the tus\n"
+"                              resumable upload protocol\n"
+"      --signature-window=SECONDS\n"
+"                              the period over which reports of the same crash\n"
+"                              are limited by --max-uploads-per-signature\n"
+  // clang-format on
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --sanitization-information=SANITIZATION_INFORMATION_ADDRESS\n"
 "                              the address of a SanitizationInformation struct.\n"
+"      --server-dump-sampling  let the upload server set --full-dump-percentage\n"
+"      --shallow-module-build-id=BUILD_ID\n"
+"                              capture only the identity of the module with\n"
+"                              BUILD_ID, in hexadecimal\n"
+"      --shallow-module-path-prefix=PREFIX\n"
+"                              capture only the identity of modules whose path\n"
+"                              begins with PREFIX\n"
 "      --shared-client-connection the file descriptor provided by\n"
 "                              --initial-client-fd is shared among multiple\n"
 "                              clients\n"
+"      --skip-idle-thread-stacks\n"
+"                              don't capture the stacks of idle threads\n"
+"      --skip-thread-floating-point\n"
+"                              don't capture the floating-point registers of\n"
+"                              threads other than the exception's context\n"
 "      --trace-parent-with-exception=EXCEPTION_INFORMATION_ADDRESS\n"
 "                              request a dump for the handler's parent process\n"
+"      --unwind-stacks         unwind each thread's stack using the call frame\n"
+"                              information of its modules\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
       // clang-format off
+"      --upload-on-demand      start the upload thread once a report is pending\n"
+  // clang-format on
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-pending-reports\n"
+"                              upload the database's pending reports and exit\n"
+"      --upload-process        upload from a short-lived process started when\n"
+"                              reports are pending, not from a thread\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_USE_ZSTD)
+      // clang-format off
+"      --upload-zstd           use zstd compression instead of gzip when\n"
+"                              uploading\n"
+"      --upload-zstd-level=LEVEL\n"
+"                              the zstd compression level for --upload-zstd\n"
+"      --upload-zstd-long-distance-matching\n"
+"                              use zstd long-distance matching for uploads\n"
+  // clang-format on
+#endif  // CRASHPAD_USE_ZSTD
+      // clang-format off
 "      --url=URL               send crash reports to this Breakpad server URL,\n"
 "                              only if uploads are enabled for the database\n"
   // clang-format on
@@ -206,12 +429,30 @@ void Usage(const base::FilePath& me) {
 "                              checks\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --user-stream-threads=N\n"
+"                              call user stream data sources on up to N threads\n"
+"      --user-stream-time-limit=MILLISECONDS\n"
+"                              leave out a user stream that takes longer\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --use-pss-snapshot      resume the client before its memory is read\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --write-minidump-to-log write minidump to log\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_ANDROID)
       // clang-format off
+"      --write-stats           write capture and upload counts and latencies to\n"
+"                              --metrics-dir every minute\n"
+"      --write-trace-events    write a Chrome JSON trace of dump capture and\n"
+"                              report uploads to --metrics-dir\n"
 "      --help                  display this help and exit\n"
 "      --version               output version information and exit\n",
           me.value().c_str());
@@ -219,35 +460,115 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Where the reports of one product’s clients go when --listen-socket serves
+// several products.
+struct ClientProfileOptions {
+  base::FilePath database;
+  std::string url;
+  std::map<std::string, std::string> annotations;
+};
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 struct Options {
   std::map<std::string, std::string> annotations;
   std::map<std::string, std::string> monitor_self_annotations;
   std::string url;
+  std::string resumable_upload_url;
+  std::string batch_upload_url;
   base::FilePath database;
   base::FilePath metrics_dir;
   std::vector<std::string> monitor_self_arguments;
+  uint64_t max_upload_bytes_per_second;
+  unsigned int compression_threads;
+  unsigned int max_concurrent_uploads;
+  unsigned int max_uploads_per_signature;
+  unsigned int signature_window_seconds;
 #if BUILDFLAG(IS_APPLE)
   std::string mach_service;
   int handshake_fd;
+  unsigned int max_concurrent_crash_dumps;
   bool reset_own_crash_exception_port_to_system_default;
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   VMAddress exception_information_address;
   VMAddress sanitization_information_address;
+  base::FilePath pool_socket;
+  base::FilePath listen_socket;
+  std::map<std::string, ClientProfileOptions> client_profiles;
   int initial_client_fd;
+  unsigned int max_concurrent_crash_dumps;
+  unsigned int module_initialization_threads;
+  unsigned int module_memory_cache_pages;
+  unsigned int capture_time_limit_ms;
+  unsigned int crash_loop_captures;
+  unsigned int crash_loop_interval_seconds;
+  unsigned int user_stream_threads;
+  unsigned int user_stream_time_limit_ms;
+  unsigned int max_exception_thread_stack_size;
+  unsigned int max_listed_threads;
+  unsigned int max_thread_stack_size;
+  base::FilePath micro_dump_database;
+  std::string micro_dump_url;
+  unsigned int micro_dump_stack_size;
+  base::FilePath minidump_consumer_socket;
+  unsigned int full_report_percentage;
+  unsigned int full_dump_percentage;
+  unsigned int full_dumps_per_signature;
+  unsigned int pool_size;
+  CrashReportDatabase::Durability database_durability;
+  ShallowModuleFilter shallow_modules;
+  ProcessSnapshotLinux::FullMemoryOptions full_memory;
+  bool compress_minidumps;
+  bool deduplicate_thread_stacks;
+  bool defer_report_writing;
+  bool pack_reports;
+  bool server_dump_sampling;
   bool shared_client_connection;
+  bool skip_idle_thread_stacks;
+  bool skip_thread_floating_point;
+  bool unwind_stacks;
+  bool write_minidump_to_database;
 #if BUILDFLAG(IS_ANDROID)
   bool write_minidump_to_log;
-  bool write_minidump_to_database;
 #endif  // BUILDFLAG(IS_ANDROID)
 #elif BUILDFLAG(IS_WIN)
   std::string pipe_name;
   InitialClientData initial_client_data;
+  unsigned int max_concurrent_crash_dumps;
+  ProcessInfo::HandleOptions handle_options;
+  bool compact_memory_info;
+  bool use_pss_snapshot;
 #endif  // BUILDFLAG(IS_APPLE)
+  bool background_tasks;
+  bool cache_upload_bodies;
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  bool elevated_capture_priority;
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  bool fast_start;
   bool identify_client_via_url;
+  bool low_idle_memory;
   bool monitor_self;
+  bool monitor_self_minimal;
   bool periodic_tasks;
   bool rate_limit;
   bool upload_gzip;
+  bool upload_on_demand;
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  bool upload_pending_reports;
+  bool upload_process;
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  bool write_stats;
+  bool write_trace_events;
+#if defined(CRASHPAD_USE_ZSTD)
+  int upload_zstd_level;
+  bool upload_zstd;
+  bool upload_zstd_long_distance_matching;
+#endif  // CRASHPAD_USE_ZSTD
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
   bool use_cros_crash_reporter = false;
   base::FilePath minidump_dir_for_tests;
@@ -480,15 +801,41 @@ void MonitorSelf(const Options& options) {
     return;
   }
   std::vector<std::string> extra_arguments(options.monitor_self_arguments);
-  if (!options.identify_client_via_url) {
-    extra_arguments.push_back("--no-identify-client-via-url");
-  }
   extra_arguments.push_back("--no-periodic-tasks");
-  if (!options.rate_limit) {
-    extra_arguments.push_back("--no-rate-limit");
-  }
-  if (!options.upload_gzip) {
-    extra_arguments.push_back("--no-upload-gzip");
+  if (options.monitor_self_minimal) {
+    LOG_IF(WARNING, !options.periodic_tasks)
+        << "--monitor-self-minimal reports won't be uploaded with "
+           "--no-periodic-tasks";
+
+    // Without a URL, the second instance starts no upload thread, and with
+    // --no-periodic-tasks, no pruning thread. Its reports are left pending in
+    // the database for this instance to find and upload when it next scans
+    // for them.
+    extra_arguments.push_back("--low-idle-memory");
+  } else {
+    if (!options.identify_client_via_url) {
+      extra_arguments.push_back("--no-identify-client-via-url");
+    }
+    if (!options.rate_limit) {
+      extra_arguments.push_back("--no-rate-limit");
+    }
+    if (!options.upload_gzip) {
+      extra_arguments.push_back("--no-upload-gzip");
+    }
+    if (options.compression_threads > 1) {
+      extra_arguments.push_back(base::StringPrintf(
+          "--compression-threads=%u", options.compression_threads));
+    }
+#if defined(CRASHPAD_USE_ZSTD)
+    if (options.upload_zstd) {
+      extra_arguments.push_back("--upload-zstd");
+      extra_arguments.push_back(base::StringPrintf(
+          "--upload-zstd-level=%d", options.upload_zstd_level));
+      if (options.upload_zstd_long_distance_matching) {
+        extra_arguments.push_back("--upload-zstd-long-distance-matching");
+      }
+    }
+#endif  // CRASHPAD_USE_ZSTD
   }
   for (const auto& iterator : options.monitor_self_annotations) {
     extra_arguments.push_back(
@@ -500,12 +847,14 @@ void MonitorSelf(const Options& options) {
   // Don’t use options.metrics_dir. The current implementation only allows one
   // instance of crashpad_handler to be writing metrics at a time, and it should
   // be the primary instance.
+  const std::string url =
+      options.monitor_self_minimal ? std::string() : options.url;
   CrashpadClient crashpad_client;
 #if BUILDFLAG(IS_ANDROID)
   if (!crashpad_client.StartHandlerAtCrash(executable_path,
                                            options.database,
                                            base::FilePath(),
-                                           options.url,
+                                           url,
                                            options.annotations,
                                            extra_arguments)) {
     return;
@@ -514,7 +863,7 @@ void MonitorSelf(const Options& options) {
   if (!crashpad_client.StartHandler(executable_path,
                                     options.database,
                                     base::FilePath(),
-                                    options.url,
+                                    url,
                                     options.annotations,
                                     extra_arguments,
                                     true,
@@ -528,6 +877,158 @@ void MonitorSelf(const Options& options) {
   ReinstallCrashHandler();
 }
 
+// Runs the initialization that --fast-start defers.
+class DeferredInitializationThread final : public Thread {
+ public:
+  explicit DeferredInitializationThread(std::function<void()> initialize)
+      : Thread(), initialize_(std::move(initialize)) {}
+
+  DeferredInitializationThread(const DeferredInitializationThread&) = delete;
+  DeferredInitializationThread& operator=(
+      const DeferredInitializationThread&) = delete;
+
+  ~DeferredInitializationThread() override {}
+
+ private:
+  void ThreadMain() override { initialize_(); }
+
+  std::function<void()> initialize_;
+};
+
+// The stack size of the handler’s background threads with --low-idle-memory.
+// They don’t recurse deeply or keep large buffers on the stack.
+constexpr size_t kLowIdleMemoryThreadStackSize = 256 * 1024;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// --full-dumps-per-signature counts full dumps per day.
+constexpr time_t kFullDumpSignatureWindowSeconds = 24 * 60 * 60;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+// Returns memory freed since the handler started to the system, so that an
+// idle handler doesn’t keep the peak of its initialization resident.
+void TrimHeap() {
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#elif BUILDFLAG(IS_APPLE)
+  malloc_zone_pressure_relief(nullptr, 0);
+#elif BUILDFLAG(IS_WIN)
+  _heapmin();
+#endif
+}
+
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+// The file in the database directory that --upload-pending-reports processes
+// lock while they upload, so that they take turns.
+constexpr char kUploadLockFileName[] = "upload.lock";
+
+// Builds the arguments for a --upload-pending-reports process, which uploads
+// the reports in database to url with this handler’s upload options.
+std::vector<std::string> UploadProcessArguments(
+    const base::FilePath& executable_path,
+    const Options& options,
+    const base::FilePath& database,
+    const std::string& url) {
+  std::vector<std::string> argv;
+  argv.push_back(ToolSupport::FilePathToCommandLineArgument(executable_path));
+  argv.push_back("--upload-pending-reports");
+  argv.push_back("--database=" +
+                 ToolSupport::FilePathToCommandLineArgument(database));
+  argv.push_back("--url=" + url);
+  if (options.cache_upload_bodies) {
+    argv.push_back("--cache-upload-bodies");
+  }
+  argv.push_back(base::StringPrintf("--compression-threads=%u",
+                                    options.compression_threads));
+  if (!options.identify_client_via_url) {
+    argv.push_back("--no-identify-client-via-url");
+  }
+  argv.push_back(base::StringPrintf("--max-concurrent-uploads=%u",
+                                    options.max_concurrent_uploads));
+  argv.push_back(
+      base::StringPrintf("--max-upload-bytes-per-second=%" PRIu64,
+                         options.max_upload_bytes_per_second));
+  argv.push_back(base::StringPrintf("--max-uploads-per-signature=%u",
+                                    options.max_uploads_per_signature));
+  if (!options.rate_limit) {
+    argv.push_back("--no-rate-limit");
+  }
+  if (!options.resumable_upload_url.empty()) {
+    argv.push_back("--resumable-upload-url=" + options.resumable_upload_url);
+  }
+  if (!options.batch_upload_url.empty()) {
+    argv.push_back("--batch-upload-url=" + options.batch_upload_url);
+  }
+  argv.push_back(base::StringPrintf("--signature-window=%u",
+                                    options.signature_window_seconds));
+  if (!options.upload_gzip) {
+    argv.push_back("--no-upload-gzip");
+  }
+#if defined(CRASHPAD_USE_ZSTD)
+  if (options.upload_zstd) {
+    argv.push_back("--upload-zstd");
+  }
+  argv.push_back(
+      base::StringPrintf("--upload-zstd-level=%d", options.upload_zstd_level));
+  if (options.upload_zstd_long_distance_matching) {
+    argv.push_back("--upload-zstd-long-distance-matching");
+  }
+#endif  // CRASHPAD_USE_ZSTD
+#if !BUILDFLAG(IS_MAC)
+  switch (options.database_durability) {
+    case CrashReportDatabase::Durability::kNone:
+      argv.push_back("--database-durability=none");
+      break;
+    case CrashReportDatabase::Durability::kData:
+      argv.push_back("--database-durability=data");
+      break;
+    case CrashReportDatabase::Durability::kFull:
+      argv.push_back("--database-durability=full");
+      break;
+  }
+#endif  // !BUILDFLAG(IS_MAC)
+  return argv;
+}
+
+// Makes one pass over the database’s pending reports for
+// --upload-pending-reports. A report made pending while another process is
+// partway through its pass is left to the process started for it, which waits
+// its turn and then makes its own pass.
+int UploadPendingReports(CrashReportDatabase* database,
+                         const Options& options,
+                         CrashReportUploadThread::Options upload_options) {
+  ScopedFileHandle lock_file(
+      LoggingOpenFileForWrite(options.database.Append(kUploadLockFileName),
+                              FileWriteMode::kReuseOrCreate,
+                              FilePermissions::kOwnerOnly));
+  if (!lock_file.is_valid() ||
+      LoggingLockFile(lock_file.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) !=
+          FileLockingResult::kSuccess) {
+    return ExitFailure();
+  }
+
+  // Scanning the database on starting the upload thread makes the pass.
+  upload_options.watch_pending_reports = true;
+  upload_options.start_on_demand = false;
+  upload_options.prune_database = false;
+  upload_options.upload_process_argv.clear();
+
+  Semaphore pass_complete(0);
+  CrashReportUploadThread upload_thread(
+      database, options.url, upload_options, [&pass_complete]() {
+        pass_complete.Signal();
+      });
+  upload_thread.Start();
+  pass_complete.Wait();
+  upload_thread.Stop();
+  return EXIT_SUCCESS;
+}
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 class ScopedStoppable {
  public:
   ScopedStoppable() = default;
@@ -585,7 +1086,47 @@ int HandlerMain(int argc,
     BUILDFLAG(IS_ANDROID)
     kOptionAttachment,
 #endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX)
+    kOptionBackgroundTasks,
+    kOptionBatchUploadURL,
+    kOptionCacheUploadBodies,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionCaptureTimeLimit,
+    kOptionClientAnnotation,
+    kOptionClientDatabase,
+    kOptionClientURL,
+    kOptionCompressMinidumps,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    kOptionCompactMemoryInfo,
+#endif  // BUILDFLAG(IS_WIN)
+    kOptionCompressionThreads,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionCrashLoopCaptures,
+    kOptionCrashLoopInterval,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionDatabase,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionDatabaseDurability,
+    kOptionDeduplicateThreadStacks,
+    kOptionDeferReportWriting,
+    kOptionFullDumpPercentage,
+    kOptionFullDumpsPerSignature,
+    kOptionFullMemory,
+    kOptionFullMemoryExclude,
+    kOptionFullReportPercentage,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    kOptionElevatedCapturePriority,
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    kOptionExcludeHandleType,
+#endif  // BUILDFLAG(IS_WIN)
+    kOptionFastStart,
 #if BUILDFLAG(IS_APPLE)
     kOptionHandshakeFD,
 #endif  // BUILDFLAG(IS_APPLE)
@@ -594,42 +1135,113 @@ int HandlerMain(int argc,
 #endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
     kOptionInitialClientFD,
+    kOptionListenSocket,
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+    kOptionLowIdleMemory,
 #if BUILDFLAG(IS_APPLE)
     kOptionMachService,
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || \
+    BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMaxConcurrentCrashDumps,
+#endif  // BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMaxConcurrentUploads,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMaxExceptionThreadStackSize,
+    kOptionMaxListedThreads,
+    kOptionMaxThreadStackSize,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    kOptionMaxHandles,
+#endif  // BUILDFLAG(IS_WIN)
+    kOptionMaxUploadBytesPerSecond,
+    kOptionMaxUploadsPerSignature,
     kOptionMetrics,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMicroDumpDatabase,
+    kOptionMicroDumpStackSize,
+    kOptionMicroDumpURL,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    kOptionMinidumpConsumerSocket,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    kOptionModuleInitializationThreads,
+    kOptionModuleMemoryCachePages,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionMonitorSelf,
     kOptionMonitorSelfAnnotation,
     kOptionMonitorSelfArgument,
+    kOptionMonitorSelfMinimal,
     kOptionNoIdentifyClientViaUrl,
     kOptionNoPeriodicTasks,
     kOptionNoRateLimit,
     kOptionNoUploadGzip,
-#if BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     kOptionNoWriteMinidumpToDatabase,
-#endif  // BUILDFLAG(IS_ANDROID)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionPackReports,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
     kOptionPipeName,
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionPoolSize,
+    kOptionPoolSocket,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     kOptionResetOwnCrashExceptionPortToSystemDefault,
 #endif  // BUILDFLAG(IS_APPLE)
+    kOptionResumableUploadURL,
+    kOptionSignatureWindow,
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     kOptionSanitizationInformation,
+    kOptionServerDumpSampling,
+    kOptionShallowModuleBuildID,
+    kOptionShallowModulePathPrefix,
     kOptionSharedClientConnection,
+    kOptionSkipIdleThreadStacks,
+    kOptionSkipThreadFloatingPoint,
     kOptionTraceParentWithException,
+    kOptionUnwindStacks,
 #endif
+    kOptionUploadOnDemand,
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    kOptionUploadPendingReports,
+    kOptionUploadProcess,
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_USE_ZSTD)
+    kOptionUploadZstd,
+    kOptionUploadZstdLevel,
+    kOptionUploadZstdLongDistanceMatching,
+#endif  // CRASHPAD_USE_ZSTD
     kOptionURL,
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
     kOptionUseCrosCrashReporter,
     kOptionMinidumpDirForTests,
     kOptionAlwaysAllowFeedback,
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUserStreamThreads,
+    kOptionUserStreamTimeLimit,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    kOptionUsePssSnapshot,
+#endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_ANDROID)
     kOptionWriteMinidumpToLog,
 #endif  // BUILDFLAG(IS_ANDROID)
+    kOptionWriteStats,
+    kOptionWriteTraceEvents,
 
     // Standard options.
     kOptionHelp = -2,
@@ -641,7 +1253,83 @@ int HandlerMain(int argc,
 #if defined(ATTACHMENTS_SUPPORTED)
     {"attachment", required_argument, nullptr, kOptionAttachment},
 #endif  // ATTACHMENTS_SUPPORTED
+    {"background-tasks", no_argument, nullptr, kOptionBackgroundTasks},
+    {"batch-upload-url", required_argument, nullptr, kOptionBatchUploadURL},
+    {"cache-upload-bodies", no_argument, nullptr, kOptionCacheUploadBodies},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"capture-time-limit",
+     required_argument,
+     nullptr,
+     kOptionCaptureTimeLimit},
+    {"client-annotation", required_argument, nullptr, kOptionClientAnnotation},
+    {"client-database", required_argument, nullptr, kOptionClientDatabase},
+    {"client-url", required_argument, nullptr, kOptionClientURL},
+    {"compress-minidumps", no_argument, nullptr, kOptionCompressMinidumps},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    {"compact-memory-info", no_argument, nullptr, kOptionCompactMemoryInfo},
+#endif  // BUILDFLAG(IS_WIN)
+    {"compression-threads",
+     required_argument,
+     nullptr,
+     kOptionCompressionThreads},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"crash-loop-captures",
+     required_argument,
+     nullptr,
+     kOptionCrashLoopCaptures},
+    {"crash-loop-interval",
+     required_argument,
+     nullptr,
+     kOptionCrashLoopInterval},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     {"database", required_argument, nullptr, kOptionDatabase},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"database-durability",
+     required_argument,
+     nullptr,
+     kOptionDatabaseDurability},
+    {"deduplicate-thread-stacks",
+     no_argument,
+     nullptr,
+     kOptionDeduplicateThreadStacks},
+    {"defer-report-writing", no_argument, nullptr, kOptionDeferReportWriting},
+    {"full-dump-percentage",
+     required_argument,
+     nullptr,
+     kOptionFullDumpPercentage},
+    {"full-dumps-per-signature",
+     required_argument,
+     nullptr,
+     kOptionFullDumpsPerSignature},
+    {"full-memory", no_argument, nullptr, kOptionFullMemory},
+    {"full-memory-exclude",
+     required_argument,
+     nullptr,
+     kOptionFullMemoryExclude},
+    {"full-report-percentage",
+     required_argument,
+     nullptr,
+     kOptionFullReportPercentage},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    {"elevated-capture-priority",
+     no_argument,
+     nullptr,
+     kOptionElevatedCapturePriority},
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    {"exclude-handle-type",
+     required_argument,
+     nullptr,
+     kOptionExcludeHandleType},
+#endif  // BUILDFLAG(IS_WIN)
+    {"fast-start", no_argument, nullptr, kOptionFastStart},
 #if BUILDFLAG(IS_APPLE)
     {"handshake-fd", required_argument, nullptr, kOptionHandshakeFD},
 #endif  // BUILDFLAG(IS_APPLE)
@@ -653,58 +1341,173 @@ int HandlerMain(int argc,
 #endif  // BUILDFLAG(IS_APPLE)
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
     {"initial-client-fd", required_argument, nullptr, kOptionInitialClientFD},
+    {"listen-socket", required_argument, nullptr, kOptionListenSocket},
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+    {"low-idle-memory", no_argument, nullptr, kOptionLowIdleMemory},
 #if BUILDFLAG(IS_APPLE)
     {"mach-service", required_argument, nullptr, kOptionMachService},
 #endif  // BUILDFLAG(IS_APPLE)
-    {"metrics-dir", required_argument, nullptr, kOptionMetrics},
-    {"monitor-self", no_argument, nullptr, kOptionMonitorSelf},
-    {"monitor-self-annotation",
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || \
+    BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"max-concurrent-crash-dumps",
      required_argument,
      nullptr,
-     kOptionMonitorSelfAnnotation},
-    {"monitor-self-argument",
+     kOptionMaxConcurrentCrashDumps},
+#endif  // BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"max-concurrent-uploads",
      required_argument,
      nullptr,
-     kOptionMonitorSelfArgument},
-    {"no-identify-client-via-url",
-     no_argument,
+     kOptionMaxConcurrentUploads},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"max-exception-thread-stack-size",
+     required_argument,
      nullptr,
-     kOptionNoIdentifyClientViaUrl},
-    {"no-periodic-tasks", no_argument, nullptr, kOptionNoPeriodicTasks},
-    {"no-rate-limit", no_argument, nullptr, kOptionNoRateLimit},
-    {"no-upload-gzip", no_argument, nullptr, kOptionNoUploadGzip},
-#if BUILDFLAG(IS_ANDROID)
-    {"no-write-minidump-to-database",
-     no_argument,
+     kOptionMaxExceptionThreadStackSize},
+    {"max-listed-threads", required_argument, nullptr, kOptionMaxListedThreads},
+    {"max-thread-stack-size",
+     required_argument,
+     nullptr,
+     kOptionMaxThreadStackSize},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    {"max-handles", required_argument, nullptr, kOptionMaxHandles},
+#endif  // BUILDFLAG(IS_WIN)
+    {"max-upload-bytes-per-second",
+     required_argument,
+     nullptr,
+     kOptionMaxUploadBytesPerSecond},
+    {"max-uploads-per-signature",
+     required_argument,
+     nullptr,
+     kOptionMaxUploadsPerSignature},
+    {"metrics-dir", required_argument, nullptr, kOptionMetrics},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"micro-dump-database",
+     required_argument,
+     nullptr,
+     kOptionMicroDumpDatabase},
+    {"micro-dump-stack-size",
+     required_argument,
+     nullptr,
+     kOptionMicroDumpStackSize},
+    {"micro-dump-url", required_argument, nullptr, kOptionMicroDumpURL},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    {"minidump-consumer-socket",
+     required_argument,
+     nullptr,
+     kOptionMinidumpConsumerSocket},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    {"module-initialization-threads",
+     required_argument,
+     nullptr,
+     kOptionModuleInitializationThreads},
+    {"module-memory-cache-pages",
+     required_argument,
+     nullptr,
+     kOptionModuleMemoryCachePages},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"monitor-self", no_argument, nullptr, kOptionMonitorSelf},
+    {"monitor-self-annotation",
+     required_argument,
+     nullptr,
+     kOptionMonitorSelfAnnotation},
+    {"monitor-self-argument",
+     required_argument,
+     nullptr,
+     kOptionMonitorSelfArgument},
+    {"monitor-self-minimal", no_argument, nullptr, kOptionMonitorSelfMinimal},
+    {"no-identify-client-via-url",
+     no_argument,
+     nullptr,
+     kOptionNoIdentifyClientViaUrl},
+    {"no-periodic-tasks", no_argument, nullptr, kOptionNoPeriodicTasks},
+    {"no-rate-limit", no_argument, nullptr, kOptionNoRateLimit},
+    {"no-upload-gzip", no_argument, nullptr, kOptionNoUploadGzip},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"no-write-minidump-to-database",
+     no_argument,
      nullptr,
      kOptionNoWriteMinidumpToDatabase},
-#endif  // BUILDFLAG(IS_ANDROID)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"pack-reports", no_argument, nullptr, kOptionPackReports},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
     {"pipe-name", required_argument, nullptr, kOptionPipeName},
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"pool-size", required_argument, nullptr, kOptionPoolSize},
+    {"pool-socket", required_argument, nullptr, kOptionPoolSocket},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     {"reset-own-crash-exception-port-to-system-default",
      no_argument,
      nullptr,
      kOptionResetOwnCrashExceptionPortToSystemDefault},
 #endif  // BUILDFLAG(IS_APPLE)
+    {"resumable-upload-url",
+     required_argument,
+     nullptr,
+     kOptionResumableUploadURL},
+    {"signature-window", required_argument, nullptr, kOptionSignatureWindow},
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     {"sanitization-information",
      required_argument,
      nullptr,
      kOptionSanitizationInformation},
+    {"server-dump-sampling", no_argument, nullptr, kOptionServerDumpSampling},
+    {"shallow-module-build-id",
+     required_argument,
+     nullptr,
+     kOptionShallowModuleBuildID},
+    {"shallow-module-path-prefix",
+     required_argument,
+     nullptr,
+     kOptionShallowModulePathPrefix},
     {"shared-client-connection",
      no_argument,
      nullptr,
      kOptionSharedClientConnection},
+    {"skip-idle-thread-stacks",
+     no_argument,
+     nullptr,
+     kOptionSkipIdleThreadStacks},
+    {"skip-thread-floating-point",
+     no_argument,
+     nullptr,
+     kOptionSkipThreadFloatingPoint},
     {"trace-parent-with-exception",
      required_argument,
      nullptr,
      kOptionTraceParentWithException},
+    {"unwind-stacks", no_argument, nullptr, kOptionUnwindStacks},
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
+    {"upload-on-demand", no_argument, nullptr, kOptionUploadOnDemand},
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    {"upload-pending-reports",
+     no_argument,
+     nullptr,
+     kOptionUploadPendingReports},
+    {"upload-process", no_argument, nullptr, kOptionUploadProcess},
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_USE_ZSTD)
+    {"upload-zstd", no_argument, nullptr, kOptionUploadZstd},
+    {"upload-zstd-level", required_argument, nullptr, kOptionUploadZstdLevel},
+    {"upload-zstd-long-distance-matching",
+     no_argument,
+     nullptr,
+     kOptionUploadZstdLongDistanceMatching},
+#endif  // CRASHPAD_USE_ZSTD
     {"url", required_argument, nullptr, kOptionURL},
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
     {"use-cros-crash-reporter",
@@ -717,9 +1520,25 @@ int HandlerMain(int argc,
      kOptionMinidumpDirForTests},
     {"always-allow-feedback", no_argument, nullptr, kOptionAlwaysAllowFeedback},
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"user-stream-threads",
+     required_argument,
+     nullptr,
+     kOptionUserStreamThreads},
+    {"user-stream-time-limit",
+     required_argument,
+     nullptr,
+     kOptionUserStreamTimeLimit},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    {"use-pss-snapshot", no_argument, nullptr, kOptionUsePssSnapshot},
+#endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_ANDROID)
     {"write-minidump-to-log", no_argument, nullptr, kOptionWriteMinidumpToLog},
 #endif  // BUILDFLAG(IS_ANDROID)
+    {"write-stats", no_argument, nullptr, kOptionWriteStats},
+    {"write-trace-events", no_argument, nullptr, kOptionWriteTraceEvents},
     {"help", no_argument, nullptr, kOptionHelp},
     {"version", no_argument, nullptr, kOptionVersion},
     {nullptr, 0, nullptr, 0},
@@ -729,14 +1548,27 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_APPLE)
   options.handshake_fd = -1;
 #endif
+  options.cache_upload_bodies = false;
+  options.compression_threads = 1;
   options.identify_client_via_url = true;
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  options.crash_loop_interval_seconds = 60;
   options.initial_client_fd = kInvalidFileHandle;
+  options.micro_dump_stack_size = 16 * 1024;
+  options.full_report_percentage = 100;
+  options.full_dump_percentage = 100;
+  options.pool_size = 2;
 #endif
   options.periodic_tasks = true;
   options.rate_limit = true;
+  options.signature_window_seconds = 60 * 60;
   options.upload_gzip = true;
-#if BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_USE_ZSTD)
+  options.upload_zstd_level = 0;
+  options.upload_zstd = false;
+  options.upload_zstd_long_distance_matching = false;
+#endif  // CRASHPAD_USE_ZSTD
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   options.write_minidump_to_database = true;
 #endif
 
@@ -756,11 +1588,202 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // ATTACHMENTS_SUPPORTED
+      case kOptionBackgroundTasks: {
+        options.background_tasks = true;
+        break;
+      }
+      case kOptionBatchUploadURL: {
+        options.batch_upload_url = optarg;
+        break;
+      }
+      case kOptionCacheUploadBodies: {
+        options.cache_upload_bodies = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionCaptureTimeLimit: {
+        if (!StringToNumber(optarg, &options.capture_time_limit_ms)) {
+          ToolSupport::UsageHint(me, "failed to parse --capture-time-limit");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionClientAnnotation: {
+        std::string product;
+        std::string key_value;
+        if (!SplitStringFirst(optarg, ':', &product, &key_value) ||
+            product.empty()) {
+          ToolSupport::UsageHint(me, "failed to parse --client-annotation");
+          return ExitFailure();
+        }
+        if (!AddKeyValueToMap(&options.client_profiles[product].annotations,
+                              key_value,
+                              "--client-annotation")) {
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionClientDatabase: {
+        std::string product;
+        std::string path;
+        if (!SplitStringFirst(optarg, '=', &product, &path) ||
+            product.empty()) {
+          ToolSupport::UsageHint(me, "failed to parse --client-database");
+          return ExitFailure();
+        }
+        options.client_profiles[product].database = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(path));
+        break;
+      }
+      case kOptionClientURL: {
+        std::string product;
+        std::string url;
+        if (!SplitStringFirst(optarg, '=', &product, &url) || product.empty()) {
+          ToolSupport::UsageHint(me, "failed to parse --client-url");
+          return ExitFailure();
+        }
+        options.client_profiles[product].url = url;
+        break;
+      }
+      case kOptionCompressMinidumps: {
+        options.compress_minidumps = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      case kOptionCompactMemoryInfo: {
+        options.compact_memory_info = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+      case kOptionCompressionThreads: {
+        if (!StringToNumber(optarg, &options.compression_threads) ||
+            options.compression_threads < 1) {
+          ToolSupport::UsageHint(me, "failed to parse --compression-threads");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionCrashLoopCaptures: {
+        if (!StringToNumber(optarg, &options.crash_loop_captures) ||
+            options.crash_loop_captures < 1) {
+          ToolSupport::UsageHint(me, "failed to parse --crash-loop-captures");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionCrashLoopInterval: {
+        if (!StringToNumber(optarg, &options.crash_loop_interval_seconds) ||
+            options.crash_loop_interval_seconds < 1) {
+          ToolSupport::UsageHint(me, "failed to parse --crash-loop-interval");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionDatabase: {
         options.database = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionDatabaseDurability: {
+        if (strcmp(optarg, "none") == 0) {
+          options.database_durability = CrashReportDatabase::Durability::kNone;
+        } else if (strcmp(optarg, "data") == 0) {
+          options.database_durability = CrashReportDatabase::Durability::kData;
+        } else if (strcmp(optarg, "full") == 0) {
+          options.database_durability = CrashReportDatabase::Durability::kFull;
+        } else {
+          ToolSupport::UsageHint(
+              me, "--database-durability requires none, data, or full");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionDeduplicateThreadStacks: {
+        options.deduplicate_thread_stacks = true;
+        break;
+      }
+      case kOptionDeferReportWriting: {
+        options.defer_report_writing = true;
+        break;
+      }
+      case kOptionFullDumpPercentage: {
+        if (!StringToNumber(optarg, &options.full_dump_percentage) ||
+            options.full_dump_percentage > 100) {
+          ToolSupport::UsageHint(
+              me, "--full-dump-percentage requires a number from 0 to 100");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionFullDumpsPerSignature: {
+        if (!StringToNumber(optarg, &options.full_dumps_per_signature)) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --full-dumps-per-signature");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionFullMemory: {
+        options.full_memory.enabled = true;
+        break;
+      }
+      case kOptionFullMemoryExclude: {
+        for (const std::string& kind : SplitString(optarg, ',')) {
+          if (kind == "file-backed") {
+            options.full_memory.skip_file_backed = true;
+          } else if (kind == "anonymous") {
+            options.full_memory.skip_anonymous = true;
+          } else if (kind == "read-only") {
+            options.full_memory.skip_read_only = true;
+          } else if (kind == "executable") {
+            options.full_memory.skip_executable = true;
+          } else if (kind == "non-resident") {
+            options.full_memory.skip_non_resident = true;
+          } else {
+            ToolSupport::UsageHint(
+                me,
+                "--full-memory-exclude requires file-backed, anonymous, "
+                "read-only, executable, or non-resident");
+            return ExitFailure();
+          }
+        }
+        break;
+      }
+      case kOptionFullReportPercentage: {
+        if (!StringToNumber(optarg, &options.full_report_percentage) ||
+            options.full_report_percentage > 100) {
+          ToolSupport::UsageHint(
+              me, "--full-report-percentage requires a number from 0 to 100");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+      case kOptionElevatedCapturePriority: {
+        options.elevated_capture_priority = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      case kOptionExcludeHandleType: {
+        options.handle_options.excluded_types.insert(base::UTF8ToWide(optarg));
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+      case kOptionFastStart: {
+        options.fast_start = true;
+        break;
+      }
 #if BUILDFLAG(IS_APPLE)
       case kOptionHandshakeFD: {
         if (!StringToNumber(optarg, &options.handshake_fd) ||
@@ -794,13 +1817,136 @@ int HandlerMain(int argc,
         }
         break;
       }
+      case kOptionListenSocket: {
+        options.listen_socket = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+      case kOptionLowIdleMemory: {
+        options.low_idle_memory = true;
+        break;
+      }
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || \
+    BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMaxConcurrentCrashDumps: {
+        if (!StringToNumber(optarg, &options.max_concurrent_crash_dumps)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --max-concurrent-crash-dumps");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMaxConcurrentUploads: {
+        if (!StringToNumber(optarg, &options.max_concurrent_uploads)) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --max-concurrent-uploads");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMaxExceptionThreadStackSize: {
+        if (!StringToNumber(optarg,
+                            &options.max_exception_thread_stack_size)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --max-exception-thread-stack-size");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxListedThreads: {
+        if (!StringToNumber(optarg, &options.max_listed_threads) ||
+            options.max_listed_threads < 1) {
+          ToolSupport::UsageHint(me, "failed to parse --max-listed-threads");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxThreadStackSize: {
+        if (!StringToNumber(optarg, &options.max_thread_stack_size)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-thread-stack-size");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      case kOptionMaxHandles: {
+        if (!StringToNumber(optarg, &options.handle_options.max_handles)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-handles");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+      case kOptionMaxUploadBytesPerSecond: {
+        if (!StringToNumber(optarg, &options.max_upload_bytes_per_second)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --max-upload-bytes-per-second");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxUploadsPerSignature: {
+        if (!StringToNumber(optarg, &options.max_uploads_per_signature)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --max-uploads-per-signature");
+          return ExitFailure();
+        }
+        break;
+      }
       case kOptionMetrics: {
         options.metrics_dir = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMicroDumpDatabase: {
+        options.micro_dump_database = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionMicroDumpStackSize: {
+        if (!StringToNumber(optarg, &options.micro_dump_stack_size)) {
+          ToolSupport::UsageHint(me, "failed to parse --micro-dump-stack-size");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMicroDumpURL: {
+        options.micro_dump_url = optarg;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+      case kOptionMinidumpConsumerSocket: {
+        options.minidump_consumer_socket = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+      case kOptionModuleInitializationThreads: {
+        if (!StringToNumber(optarg, &options.module_initialization_threads)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --module-initialization-threads");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionModuleMemoryCachePages: {
+        if (!StringToNumber(optarg, &options.module_memory_cache_pages)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --module-memory-cache-pages");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionMonitorSelf: {
         options.monitor_self = true;
         break;
@@ -817,6 +1963,10 @@ int HandlerMain(int argc,
         options.monitor_self_arguments.push_back(optarg);
         break;
       }
+      case kOptionMonitorSelfMinimal: {
+        options.monitor_self_minimal = true;
+        break;
+      }
       case kOptionNoIdentifyClientViaUrl: {
         options.identify_client_via_url = false;
         break;
@@ -833,24 +1983,60 @@ int HandlerMain(int argc,
         options.upload_gzip = false;
         break;
       }
-#if BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       case kOptionNoWriteMinidumpToDatabase: {
         options.write_minidump_to_database = false;
         break;
       }
-#endif  // BUILDFLAG(IS_ANDROID)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionPackReports: {
+        options.pack_reports = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
       case kOptionPipeName: {
         options.pipe_name = optarg;
         break;
       }
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionPoolSize: {
+        if (!StringToNumber(optarg, &options.pool_size) ||
+            options.pool_size < 1) {
+          ToolSupport::UsageHint(me, "failed to parse --pool-size");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionPoolSocket: {
+        options.pool_socket = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       case kOptionResetOwnCrashExceptionPortToSystemDefault: {
         options.reset_own_crash_exception_port_to_system_default = true;
         break;
       }
 #endif  // BUILDFLAG(IS_APPLE)
+      case kOptionResumableUploadURL: {
+        options.resumable_upload_url = optarg;
+        break;
+      }
+      case kOptionSignatureWindow: {
+        if (!StringToNumber(optarg, &options.signature_window_seconds) ||
+            options.signature_window_seconds == 0) {
+          ToolSupport::UsageHint(me, "failed to parse --signature-window");
+          return ExitFailure();
+        }
+        break;
+      }
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       case kOptionSanitizationInformation: {
         if (!StringToNumber(optarg,
@@ -861,10 +2047,39 @@ int HandlerMain(int argc,
         }
         break;
       }
+      case kOptionServerDumpSampling: {
+        options.server_dump_sampling = true;
+        break;
+      }
+      case kOptionShallowModuleBuildID: {
+        if (!options.shallow_modules.AddBuildIDString(optarg)) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --shallow-module-build-id");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionShallowModulePathPrefix: {
+        if (!optarg[0]) {
+          ToolSupport::UsageHint(
+              me, "--shallow-module-path-prefix requires a PREFIX");
+          return ExitFailure();
+        }
+        options.shallow_modules.AddPathPrefix(optarg);
+        break;
+      }
       case kOptionSharedClientConnection: {
         options.shared_client_connection = true;
         break;
       }
+      case kOptionSkipIdleThreadStacks: {
+        options.skip_idle_thread_stacks = true;
+        break;
+      }
+      case kOptionSkipThreadFloatingPoint: {
+        options.skip_thread_floating_point = true;
+        break;
+      }
       case kOptionTraceParentWithException: {
         if (!StringToNumber(optarg, &options.exception_information_address)) {
           ToolSupport::UsageHint(
@@ -873,8 +2088,45 @@ int HandlerMain(int argc,
         }
         break;
       }
+      case kOptionUnwindStacks: {
+        options.unwind_stacks = true;
+        break;
+      }
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
+      case kOptionUploadOnDemand: {
+        options.upload_on_demand = true;
+        break;
+      }
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+      case kOptionUploadPendingReports: {
+        options.upload_pending_reports = true;
+        break;
+      }
+      case kOptionUploadProcess: {
+        options.upload_process = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_USE_ZSTD)
+      case kOptionUploadZstd: {
+        options.upload_zstd = true;
+        break;
+      }
+      case kOptionUploadZstdLevel: {
+        if (!StringToNumber(optarg, &options.upload_zstd_level)) {
+          ToolSupport::UsageHint(me, "failed to parse --upload-zstd-level");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadZstdLongDistanceMatching: {
+        options.upload_zstd_long_distance_matching = true;
+        break;
+      }
+#endif  // CRASHPAD_USE_ZSTD
       case kOptionURL: {
         options.url = optarg;
         break;
@@ -894,12 +2146,44 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUserStreamThreads: {
+        if (!StringToNumber(optarg, &options.user_stream_threads)) {
+          ToolSupport::UsageHint(me, "failed to parse --user-stream-threads");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUserStreamTimeLimit: {
+        if (!StringToNumber(optarg, &options.user_stream_time_limit_ms)) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --user-stream-time-limit");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+      case kOptionUsePssSnapshot: {
+        options.use_pss_snapshot = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_ANDROID)
       case kOptionWriteMinidumpToLog: {
         options.write_minidump_to_log = true;
         break;
       }
 #endif  // BUILDFLAG(IS_ANDROID)
+      case kOptionWriteStats: {
+        options.write_stats = true;
+        break;
+      }
+      case kOptionWriteTraceEvents: {
+        options.write_trace_events = true;
+        break;
+      }
       case kOptionHelp: {
         Usage(me);
         MetricsRecordExit(Metrics::LifetimeMilestone::kExitedEarly);
@@ -920,7 +2204,8 @@ int HandlerMain(int argc,
   argv += optind;
 
 #if BUILDFLAG(IS_APPLE)
-  if (options.handshake_fd < 0 && options.mach_service.empty()) {
+  if (options.handshake_fd < 0 && options.mach_service.empty() &&
+      !options.upload_pending_reports) {
     ToolSupport::UsageHint(me, "--handshake-fd or --mach-service is required");
     return ExitFailure();
   }
@@ -942,9 +2227,63 @@ int HandlerMain(int argc,
   }
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   if (!options.exception_information_address &&
-      options.initial_client_fd == kInvalidFileHandle) {
+      options.initial_client_fd == kInvalidFileHandle &&
+      options.pool_socket.empty() && options.listen_socket.empty() &&
+      !options.upload_pending_reports) {
+    ToolSupport::UsageHint(me,
+                           "--trace-parent-with-exception, --initial-client-fd,"
+                           " --pool-socket, or --listen-socket is required");
+    return ExitFailure();
+  }
+  if (!options.listen_socket.empty() &&
+      (options.exception_information_address ||
+       options.initial_client_fd != kInvalidFileHandle ||
+       !options.pool_socket.empty())) {
+    ToolSupport::UsageHint(me,
+                           "--listen-socket is incompatible with "
+                           "--trace-parent-with-exception, --initial-client-fd,"
+                           " and --pool-socket");
+    return ExitFailure();
+  }
+  for (const auto& [product, profile] : options.client_profiles) {
+    if (profile.database.empty()) {
+      ToolSupport::UsageHint(me,
+                             "--client-url and --client-annotation require "
+                             "--client-database for the same product");
+      return ExitFailure();
+    }
+  }
+  if (options.full_dumps_per_signature && options.full_dump_percentage == 100 &&
+      !options.server_dump_sampling) {
+    ToolSupport::UsageHint(me,
+                           "--full-dumps-per-signature requires "
+                           "--full-dump-percentage or --server-dump-sampling");
+    return ExitFailure();
+  }
+  if (options.micro_dump_database.empty() &&
+      (!options.micro_dump_url.empty() ||
+       options.full_report_percentage < 100)) {
+    ToolSupport::UsageHint(me,
+                           "--micro-dump-url and --full-report-percentage "
+                           "require --micro-dump-database");
+    return ExitFailure();
+  }
+#if !BUILDFLAG(IS_ANDROID)
+  if (!options.write_minidump_to_database &&
+      options.minidump_consumer_socket.empty()) {
     ToolSupport::UsageHint(
-        me, "--trace-parent-with-exception or --initial-client-fd is required");
+        me,
+        "--no-write-minidump-to-database requires --minidump-consumer-socket");
+    return ExitFailure();
+  }
+#endif  // !BUILDFLAG(IS_ANDROID)
+  if (!options.pool_socket.empty() &&
+      (options.exception_information_address ||
+       options.initial_client_fd != kInvalidFileHandle)) {
+    ToolSupport::UsageHint(me,
+                           "--pool-socket is incompatible with "
+                           "--trace-parent-with-exception and "
+                           "--initial-client-fd");
     return ExitFailure();
   }
   if (options.sanitization_information_address &&
@@ -975,11 +2314,42 @@ int HandlerMain(int argc,
     return ExitFailure();
   }
 
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  if (options.upload_pending_reports && options.url.empty()) {
+    ToolSupport::UsageHint(me, "--upload-pending-reports requires --url");
+    return ExitFailure();
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (options.write_trace_events && options.metrics_dir.empty()) {
+    ToolSupport::UsageHint(me, "--write-trace-events requires --metrics-dir");
+    return ExitFailure();
+  }
+
+  if (options.write_stats && options.metrics_dir.empty()) {
+    ToolSupport::UsageHint(me, "--write-stats requires --metrics-dir");
+    return ExitFailure();
+  }
+
   if (argc) {
     ToolSupport::UsageHint(me, nullptr);
     return ExitFailure();
   }
 
+  if (options.write_trace_events) {
+    // Failure has already been logged, and shouldn’t prevent the handler from
+    // running.
+    TraceEvents::EnableInDirectory(options.metrics_dir);
+  }
+
+  // Stats are recorded from here on, but written only once the database is
+  // open, so that its size can be included.
+  if (options.write_stats) {
+    LocalStats::EnableInDirectory(options.metrics_dir);
+  }
+
 #if BUILDFLAG(IS_APPLE)
   if (options.reset_own_crash_exception_port_to_system_default) {
     CrashpadClient::UseSystemDefaultHandler();
@@ -1016,28 +2386,229 @@ int HandlerMain(int argc,
     return ExitFailure();
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options.pack_reports && !database->SetReportPackingEnabled(true)) {
+    LOG(ERROR) << "--pack-reports is not supported by this database";
+    return ExitFailure();
+  }
+  if (!database->SetDurability(options.database_durability)) {
+    LOG(ERROR) << "--database-durability is not supported by this database";
+    return ExitFailure();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // The pool supervisor forks its workers, so it must run before any threads
+  // are started. Each worker returns here to finish initializing before it is
+  // given a client.
+  ScopedFileHandle pool_client_channel;
+  if (!options.pool_socket.empty()) {
+    HandlerPool handler_pool;
+    if (!handler_pool.Initialize(options.pool_socket, options.pool_size) ||
+        !handler_pool.Run(&pool_client_channel)) {
+      return ExitFailure();
+    }
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  // TODO(scottmg): options.rate_limit should be removed when we have a
+  // configurable database setting to control upload limiting.
+  // See https://crashpad.chromium.org/bug/23.
+  CrashReportUploadThread::Options upload_thread_options;
+  upload_thread_options.cache_upload_bodies = options.cache_upload_bodies;
+  upload_thread_options.identify_client_via_url =
+      options.identify_client_via_url;
+  upload_thread_options.max_concurrent_uploads = options.max_concurrent_uploads;
+  upload_thread_options.max_upload_bytes_per_second =
+      options.max_upload_bytes_per_second;
+  upload_thread_options.rate_limit = options.rate_limit;
+  upload_thread_options.max_uploads_per_signature =
+      options.max_uploads_per_signature;
+  upload_thread_options.signature_window_seconds =
+      options.signature_window_seconds;
+  upload_thread_options.resumable_upload_url = options.resumable_upload_url;
+  upload_thread_options.batch_upload_url = options.batch_upload_url;
+  upload_thread_options.upload_gzip = options.upload_gzip;
+  upload_thread_options.compression_threads = options.compression_threads;
+#if defined(CRASHPAD_USE_ZSTD)
+  upload_thread_options.upload_zstd = options.upload_zstd;
+  upload_thread_options.upload_zstd_level = options.upload_zstd_level;
+  upload_thread_options.upload_zstd_long_distance_matching =
+      options.upload_zstd_long_distance_matching;
+#endif  // CRASHPAD_USE_ZSTD
+  upload_thread_options.watch_pending_reports = options.periodic_tasks;
+  upload_thread_options.start_on_demand = options.upload_on_demand;
+  if (options.low_idle_memory) {
+    // Each upload thread prunes its own database, instead of a separate thread
+    // waking up to do it.
+    upload_thread_options.prune_database = options.periodic_tasks;
+    upload_thread_options.thread_stack_size = kLowIdleMemoryThreadStackSize;
+  }
+  if (options.background_tasks) {
+    upload_thread_options.thread_priority = ThreadPriority::kBackground;
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // This outlives the upload threads, which may hand it the server’s
+  // percentage until they stop, and exception_handler, which consults it.
+  std::unique_ptr<DumpSampler> dump_sampler;
+  if (options.full_dump_percentage < 100 || options.server_dump_sampling) {
+    dump_sampler =
+        std::make_unique<DumpSampler>(options.full_dumps_per_signature,
+                                      kFullDumpSignatureWindowSeconds,
+                                      options.full_dump_percentage);
+    if (options.server_dump_sampling) {
+      upload_thread_options.dump_sampler = dump_sampler.get();
+    }
+  }
+
+  // exception_handler consults this before capturing each crash.
+  CrashLoopDetector crash_loop_detector(options.crash_loop_captures,
+                                        options.crash_loop_interval_seconds);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  if (options.upload_pending_reports) {
+    return UploadPendingReports(database.get(), options, upload_thread_options);
+  }
+
+  base::FilePath executable_path;
+  if (options.upload_process) {
+    if (!Paths::Executable(&executable_path)) {
+      return ExitFailure();
+    }
+    // Without an upload thread, the prune thread is still needed.
+    upload_thread_options.prune_database = false;
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  auto upload_options_for = [&](const base::FilePath& database_path,
+                                const std::string& url) {
+    CrashReportUploadThread::Options upload_options = upload_thread_options;
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+    if (options.upload_process) {
+      upload_options.upload_process_argv = UploadProcessArguments(
+          executable_path, options, database_path, url);
+    }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    return upload_options;
+  };
+
   ScopedStoppable upload_thread;
   if (!options.url.empty()) {
-    // TODO(scottmg): options.rate_limit should be removed when we have a
-    // configurable database setting to control upload limiting.
-    // See https://crashpad.chromium.org/bug/23.
-    CrashReportUploadThread::Options upload_thread_options;
-    upload_thread_options.identify_client_via_url =
-        options.identify_client_via_url;
-    upload_thread_options.rate_limit = options.rate_limit;
-    upload_thread_options.upload_gzip = options.upload_gzip;
-    upload_thread_options.watch_pending_reports = options.periodic_tasks;
-
     upload_thread.Reset(new CrashReportUploadThread(
         database.get(),
         options.url,
-        upload_thread_options,
+        upload_options_for(options.database, options.url),
         CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
     upload_thread.Get()->Start();
   }
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Each product served from --listen-socket keeps its reports apart from the
+  // others’, in its own database with its own upload thread. These outlive
+  // exception_handler, which may still be writing reports into them as it is
+  // destroyed.
+  std::vector<std::unique_ptr<CrashReportDatabase>> client_databases;
+  std::vector<std::unique_ptr<ScopedStoppable>> client_upload_threads;
+  std::map<std::string, CrashReportExceptionHandler::ClientProfile>
+      client_profiles;
+  for (const auto& [product, profile_options] : options.client_profiles) {
+    std::unique_ptr<CrashReportDatabase> client_database(
+        CrashReportDatabase::Initialize(profile_options.database));
+    if (!client_database) {
+      return ExitFailure();
+    }
+    if ((options.pack_reports &&
+         !client_database->SetReportPackingEnabled(true)) ||
+        !client_database->SetDurability(options.database_durability)) {
+      LOG(ERROR) << "unsupported options for --client-database " << product;
+      return ExitFailure();
+    }
+
+    CrashReportExceptionHandler::ClientProfile& profile =
+        client_profiles[product];
+    profile.database = client_database.get();
+    profile.upload_thread = nullptr;
+    profile.process_annotations = profile_options.annotations;
+
+    if (!profile_options.url.empty()) {
+      auto client_upload_thread = std::make_unique<CrashReportUploadThread>(
+          client_database.get(),
+          profile_options.url,
+          upload_options_for(profile_options.database, profile_options.url),
+          CrashReportUploadThread::ProcessPendingReportsObservationCallback());
+      client_upload_thread->Start();
+      profile.upload_thread = client_upload_thread.get();
+      client_upload_threads.push_back(std::make_unique<ScopedStoppable>());
+      client_upload_threads.back()->Reset(client_upload_thread.release());
+    }
+
+    client_databases.push_back(std::move(client_database));
+  }
+
+  // Micro dumps have a database of their own, so that they can be uploaded
+  // right away without waiting behind, or being pruned with, full reports.
+  // Their upload thread doesn’t rate limit, because the point of a micro dump
+  // is that every crash is counted.
+  std::unique_ptr<CrashReportDatabase> micro_dump_database;
+  ScopedStoppable micro_dump_upload_thread;
+  CrashReportExceptionHandler::MicroDumpOptions micro_dump_options;
+  if (!options.micro_dump_database.empty()) {
+    micro_dump_database =
+        CrashReportDatabase::Initialize(options.micro_dump_database);
+    if (!micro_dump_database) {
+      return ExitFailure();
+    }
+    if ((options.pack_reports &&
+         !micro_dump_database->SetReportPackingEnabled(true)) ||
+        !micro_dump_database->SetDurability(options.database_durability)) {
+      LOG(ERROR) << "unsupported options for --micro-dump-database";
+      return ExitFailure();
+    }
+
+    if (!options.micro_dump_url.empty()) {
+      CrashReportUploadThread::Options micro_dump_upload_options =
+          upload_options_for(options.micro_dump_database,
+                             options.micro_dump_url);
+      micro_dump_upload_options.rate_limit = false;
+      micro_dump_upload_thread.Reset(new CrashReportUploadThread(
+          micro_dump_database.get(),
+          options.micro_dump_url,
+          micro_dump_upload_options,
+          CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
+      micro_dump_upload_thread.Get()->Start();
+    }
+
+    micro_dump_options.database = micro_dump_database.get();
+    micro_dump_options.upload_thread = static_cast<CrashReportUploadThread*>(
+        micro_dump_upload_thread.Get());
+    micro_dump_options.max_stack_size = options.micro_dump_stack_size;
+    micro_dump_options.full_report_percentage = options.full_report_percentage;
+  }
+
   std::unique_ptr<ExceptionHandlerServer::Delegate> exception_handler;
+
+  ProcessSnapshotLinux::StackCaptureOptions stack_capture_options;
+  stack_capture_options.max_thread_stack_size = options.max_thread_stack_size;
+  stack_capture_options.max_exception_thread_stack_size =
+      options.max_exception_thread_stack_size;
+  stack_capture_options.skip_idle_thread_stacks =
+      options.skip_idle_thread_stacks;
+  stack_capture_options.skip_thread_floating_point =
+      options.skip_thread_floating_point;
+  stack_capture_options.unwind_stacks = options.unwind_stacks;
+
+  UserStreamDataSourceOptions user_stream_data_source_options;
+  user_stream_data_source_options.threads = options.user_stream_threads;
+  user_stream_data_source_options.time_limit_ns =
+      options.user_stream_time_limit_ms * kNanosecondsPerMillisecond;
 #else
   std::unique_ptr<CrashReportExceptionHandler> exception_handler;
 #endif
@@ -1057,19 +2628,57 @@ int HandlerMain(int argc,
       cros_handler->SetAlwaysAllowFeedback();
     }
 
+    cros_handler->SetModuleInitializationThreads(
+        options.module_initialization_threads);
+    cros_handler->SetModuleMemoryCachePages(options.module_memory_cache_pages);
+    cros_handler->SetCaptureTimeLimit(options.capture_time_limit_ms *
+                                      kNanosecondsPerMillisecond);
+    cros_handler->SetStackCaptureOptions(stack_capture_options);
+    cros_handler->SetUserStreamDataSourceOptions(
+        user_stream_data_source_options);
+    cros_handler->SetShallowModuleFilter(&options.shallow_modules);
+    cros_handler->SetFullMemoryOptions(options.full_memory);
+    cros_handler->SetDeduplicateThreadStacks(options.deduplicate_thread_stacks);
+
     exception_handler = std::move(cros_handler);
   } else {
-    exception_handler = std::make_unique<CrashReportExceptionHandler>(
+    auto crash_report_handler = std::make_unique<CrashReportExceptionHandler>(
         database.get(),
         static_cast<CrashReportUploadThread*>(upload_thread.Get()),
         &options.annotations,
         &options.attachments,
-        true,
+        options.write_minidump_to_database,
         false,
         user_stream_sources);
+    crash_report_handler->SetModuleInitializationThreads(
+        options.module_initialization_threads);
+    crash_report_handler->SetModuleMemoryCachePages(
+        options.module_memory_cache_pages);
+    crash_report_handler->SetCaptureTimeLimit(options.capture_time_limit_ms *
+                                              kNanosecondsPerMillisecond);
+    crash_report_handler->SetStackCaptureOptions(stack_capture_options);
+    crash_report_handler->SetUserStreamDataSourceOptions(
+        user_stream_data_source_options);
+    crash_report_handler->SetShallowModuleFilter(&options.shallow_modules);
+    crash_report_handler->SetFullMemoryOptions(options.full_memory);
+    crash_report_handler->SetCompressMinidumps(options.compress_minidumps);
+    crash_report_handler->SetCompressionThreads(options.compression_threads);
+    crash_report_handler->SetDeduplicateThreadStacks(
+        options.deduplicate_thread_stacks);
+    crash_report_handler->SetMaxListedThreads(options.max_listed_threads);
+    crash_report_handler->SetDeferReportWriting(options.defer_report_writing);
+    crash_report_handler->SetClientProfiles(&client_profiles);
+    crash_report_handler->SetMicroDumpOptions(micro_dump_options);
+    crash_report_handler->SetDumpSampler(dump_sampler.get());
+    crash_report_handler->SetCrashLoopDetector(&crash_loop_detector);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    crash_report_handler->SetMinidumpConsumerSocket(
+        options.minidump_consumer_socket);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    exception_handler = std::move(crash_report_handler);
   }
 #else
-  exception_handler = std::make_unique<CrashReportExceptionHandler>(
+  auto crash_report_handler = std::make_unique<CrashReportExceptionHandler>(
       database.get(),
       static_cast<CrashReportUploadThread*>(upload_thread.Get()),
       &options.annotations,
@@ -1081,10 +2690,43 @@ int HandlerMain(int argc,
       options.write_minidump_to_log,
 #endif  // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_LINUX)
-      true,
+      options.write_minidump_to_database,
       false,
 #endif  // BUILDFLAG(IS_LINUX)
       user_stream_sources);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID)
+  crash_report_handler->SetModuleInitializationThreads(
+      options.module_initialization_threads);
+  crash_report_handler->SetModuleMemoryCachePages(
+      options.module_memory_cache_pages);
+  crash_report_handler->SetCaptureTimeLimit(options.capture_time_limit_ms *
+                                            kNanosecondsPerMillisecond);
+  crash_report_handler->SetStackCaptureOptions(stack_capture_options);
+  crash_report_handler->SetUserStreamDataSourceOptions(
+      user_stream_data_source_options);
+  crash_report_handler->SetShallowModuleFilter(&options.shallow_modules);
+  crash_report_handler->SetFullMemoryOptions(options.full_memory);
+  crash_report_handler->SetCompressMinidumps(options.compress_minidumps);
+  crash_report_handler->SetCompressionThreads(options.compression_threads);
+  crash_report_handler->SetDeduplicateThreadStacks(
+      options.deduplicate_thread_stacks);
+  crash_report_handler->SetMaxListedThreads(options.max_listed_threads);
+  crash_report_handler->SetDeferReportWriting(options.defer_report_writing);
+  crash_report_handler->SetClientProfiles(&client_profiles);
+  crash_report_handler->SetMicroDumpOptions(micro_dump_options);
+  crash_report_handler->SetDumpSampler(dump_sampler.get());
+  crash_report_handler->SetCrashLoopDetector(&crash_loop_detector);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  crash_report_handler->SetMinidumpConsumerSocket(
+      options.minidump_consumer_socket);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+  crash_report_handler->SetUsePssSnapshot(options.use_pss_snapshot);
+  crash_report_handler->SetCompactMemoryInfo(options.compact_memory_info);
+  crash_report_handler->SetHandleOptions(options.handle_options);
+#endif  // BUILDFLAG(IS_WIN)
+  exception_handler = std::move(crash_report_handler);
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
@@ -1100,11 +2742,88 @@ int HandlerMain(int argc,
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
+  // Crash handling doesn’t depend on the rest of initialization. With
+  // --fast-start, it’s finished on DeferredInitializationThread once the
+  // exception handler server is ready, rather than before the client is told
+  // that the handler is ready.
   ScopedStoppable prune_thread;
-  if (options.periodic_tasks) {
-    prune_thread.Reset(new PruneCrashReportThread(
-        database.get(), PruneCondition::GetDefault()));
-    prune_thread.Get()->Start();
+  ScopedStoppable stats_writer_thread;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  std::vector<std::unique_ptr<ScopedStoppable>> client_prune_threads;
+  ScopedStoppable micro_dump_prune_thread;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  auto finish_initialization = [&]() {
+    // The handler reads the settings for every report it uploads, so avoid
+    // rereading the file when it hasn’t changed. This is also the first use of
+    // the settings file, which is created if it doesn’t exist yet.
+    database->GetSettings()->SetCachingEnabled(true);
+
+    auto start_prune_thread = [&options](CrashReportDatabase* database,
+                                         ScopedStoppable* thread) {
+      auto prune_thread = std::make_unique<PruneCrashReportThread>(
+          database, PruneCondition::GetDefault());
+      if (options.low_idle_memory) {
+        prune_thread->SetStackSize(kLowIdleMemoryThreadStackSize);
+      }
+      if (options.background_tasks) {
+        prune_thread->SetPriority(ThreadPriority::kBackground);
+      }
+      prune_thread->Start();
+      thread->Reset(prune_thread.release());
+    };
+
+    if (options.periodic_tasks &&
+        !(upload_thread.Get() && upload_thread_options.prune_database)) {
+      start_prune_thread(database.get(), &prune_thread);
+    }
+
+    if (options.write_stats) {
+      auto stats_thread = std::make_unique<StatsWriterThread>(database.get());
+      stats_thread->Start();
+      stats_writer_thread.Reset(stats_thread.release());
+    }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    for (const auto& [product, profile] : client_profiles) {
+      profile.database->GetSettings()->SetCachingEnabled(true);
+      if (options.periodic_tasks &&
+          !(profile.upload_thread && upload_thread_options.prune_database)) {
+        client_prune_threads.push_back(std::make_unique<ScopedStoppable>());
+        start_prune_thread(profile.database,
+                           client_prune_threads.back().get());
+      }
+    }
+    if (micro_dump_database) {
+      micro_dump_database->GetSettings()->SetCachingEnabled(true);
+      if (options.periodic_tasks &&
+          !(micro_dump_upload_thread.Get() &&
+            upload_thread_options.prune_database)) {
+        start_prune_thread(micro_dump_database.get(),
+                           &micro_dump_prune_thread);
+      }
+    }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+    if (!options.metrics_dir.empty()) {
+      static constexpr char kMetricsName[] = "CrashpadMetrics";
+      constexpr size_t kMetricsFileSize = 1 << 20;
+      if (base::GlobalHistogramAllocator::CreateWithActiveFileInDir(
+              options.metrics_dir, kMetricsFileSize, 0, kMetricsName)) {
+        base::GlobalHistogramAllocator::Get()->CreateTrackingHistograms(
+            kMetricsName);
+      }
+    }
+
+    Metrics::HandlerLifetimeMilestone(Metrics::LifetimeMilestone::kStarted);
+
+    if (options.low_idle_memory) {
+      TrimHeap();
+    }
+  };
+  if (!options.fast_start) {
+    finish_initialization();
   }
 
 #if BUILDFLAG(IS_APPLE)
@@ -1130,6 +2849,8 @@ int HandlerMain(int argc,
 
   ExceptionHandlerServer exception_handler_server(
       std::move(receive_right), !options.mach_service.empty());
+  exception_handler_server.SetConcurrentDumpLimit(
+      options.max_concurrent_crash_dumps);
   base::AutoReset<ExceptionHandlerServer*> reset_g_exception_handler_server(
       &g_exception_handler_server, &exception_handler_server);
 
@@ -1160,39 +2881,69 @@ int HandlerMain(int argc,
   if (!options.pipe_name.empty()) {
     exception_handler_server.SetPipeName(base::UTF8ToWide(options.pipe_name));
   }
+  exception_handler_server.SetConcurrentDumpLimit(
+      options.max_concurrent_crash_dumps);
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   ExceptionHandlerServer exception_handler_server;
+  exception_handler_server.SetConcurrentDumpLimit(
+      options.max_concurrent_crash_dumps);
 #endif  // BUILDFLAG(IS_APPLE)
 
-  base::GlobalHistogramAllocator* histogram_allocator = nullptr;
-  if (!options.metrics_dir.empty()) {
-    static constexpr char kMetricsName[] = "CrashpadMetrics";
-    constexpr size_t kMetricsFileSize = 1 << 20;
-    if (base::GlobalHistogramAllocator::CreateWithActiveFileInDir(
-            options.metrics_dir, kMetricsFileSize, 0, kMetricsName)) {
-      histogram_allocator = base::GlobalHistogramAllocator::Get();
-      histogram_allocator->CreateTrackingHistograms(kMetricsName);
-    }
-  }
-
-  Metrics::HandlerLifetimeMilestone(Metrics::LifetimeMilestone::kStarted);
-
 #if BUILDFLAG(IS_WIN)
   if (options.initial_client_data.IsValid()) {
     exception_handler_server.InitializeWithInheritedDataForInitialClient(
         options.initial_client_data, exception_handler.get());
   }
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
-  if (options.initial_client_fd == kInvalidFileHandle ||
-      !exception_handler_server.InitializeWithClient(
-          ScopedFileHandle(options.initial_client_fd),
-          options.shared_client_connection)) {
+  if (pool_client_channel.is_valid()) {
+    options.initial_client_fd =
+        HandlerPool::WaitForClient(pool_client_channel.get()).release();
+    if (options.initial_client_fd == kInvalidFileHandle) {
+      // The supervisor exited without assigning this worker a client.
+      return EXIT_SUCCESS;
+    }
+  }
+  if (!options.listen_socket.empty()) {
+    ScopedFileHandle listen_socket(
+        UnixCredentialSocket::CreateListeningSocket(options.listen_socket));
+    if (!listen_socket.is_valid() ||
+        !exception_handler_server.InitializeWithListeningSocket(
+            std::move(listen_socket))) {
+      return ExitFailure();
+    }
+  } else if (options.initial_client_fd == kInvalidFileHandle ||
+             !exception_handler_server.InitializeWithClient(
+                 ScopedFileHandle(options.initial_client_fd),
+                 options.shared_client_connection)) {
     return ExitFailure();
   }
 #endif  // BUILDFLAG(IS_WIN)
 
+  // The client may already be using the handler at this point. The deferred
+  // initialization must finish before the objects it uses are destroyed.
+  std::unique_ptr<DeferredInitializationThread> deferred_initialization;
+  if (options.fast_start) {
+    deferred_initialization =
+        std::make_unique<DeferredInitializationThread>(finish_initialization);
+    deferred_initialization->Start();
+  }
+
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
+  // Crashes are captured on this thread, or on threads it starts, which
+  // inherit its priority. Everything else was started above, so isn’t raised.
+  if (options.elevated_capture_priority) {
+    SetCurrentThreadPriority(ThreadPriority::kElevated);
+  }
+#endif  // BUILDFLAG(IS_MAC) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   exception_handler_server.Run(exception_handler.get());
 
+  if (deferred_initialization) {
+    deferred_initialization->Join();
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -14,12 +14,23 @@
 
 #include "handler/linux/capture_snapshot.h"
 
+#include <inttypes.h>
+
 #include <utility>
 
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "snapshot/cpu_context.h"
 #include "snapshot/crashpad_info_client_options.h"
+#include "snapshot/linux/exception_snapshot_linux.h"
+#include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/sanitized/sanitization_information.h"
+#include "util/linux/exception_information.h"
+#include "util/linux/memory_map.h"
+#include "util/misc/deadline.h"
 #include "util/misc/metrics.h"
 #include "util/misc/tri_state.h"
+#include "util/posix/signals.h"
 
 namespace crashpad {
 
@@ -30,11 +41,26 @@ bool CaptureSnapshot(
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
+    size_t module_initialization_threads,
+    size_t module_memory_cache_pages,
+    uint64_t capture_time_limit_ns,
+    const ProcessSnapshotLinux::StackCaptureOptions& stack_capture_options,
+    ModuleMetadataCache* module_metadata_cache,
+    const ShallowModuleFilter* shallow_module_filter,
+    const ProcessSnapshotLinux::FullMemoryOptions& full_memory_options,
     std::unique_ptr<ProcessSnapshotLinux>* snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot) {
+  const Deadline deadline = Deadline::FromNow(capture_time_limit_ns);
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot(
       new ProcessSnapshotLinux());
-  if (!process_snapshot->Initialize(connection)) {
+  process_snapshot->SetStackCaptureOptions(stack_capture_options);
+  process_snapshot->SetShallowModuleFilter(shallow_module_filter);
+  process_snapshot->SetFullMemoryOptions(full_memory_options);
+  if (!process_snapshot->Initialize(connection,
+                                    module_memory_cache_pages,
+                                    module_initialization_threads,
+                                    deadline,
+                                    module_metadata_cache)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return false;
   }
@@ -115,4 +141,56 @@ bool CaptureSnapshot(
   return true;
 }
 
+std::string CrashLoopSignature(
+    PtraceConnection* connection,
+    const ExceptionHandlerProtocol::ClientInformation& info) {
+  ProcessReaderLinux process_reader;
+  if (!process_reader.Initialize(connection, 0)) {
+    return std::string();
+  }
+
+  ExceptionInformation exception_information;
+  if (!process_reader.Memory()->Read(info.exception_information_address,
+                                     sizeof(exception_information),
+                                     &exception_information)) {
+    LOG(ERROR) << "Couldn't read exception info";
+    return std::string();
+  }
+
+  internal::ExceptionSnapshotLinux exception;
+  if (!exception.InitializeSignalOnly(&process_reader,
+                                      exception_information.siginfo_address,
+                                      exception_information.context_address,
+                                      exception_information.thread_id)) {
+    return std::string();
+  }
+
+  // A dump requested by DumpWithoutCrash() isn’t a crash, and the client
+  // limits how often it requests them itself.
+  if (exception.Exception() ==
+      static_cast<uint32_t>(Signals::kSimulatedSigno)) {
+    return std::string();
+  }
+
+  // The exception address is where a fault was, which for a bad heap pointer
+  // varies from one crash to the next. The instruction pointer doesn’t.
+  const uint64_t instruction_pointer =
+      exception.Context()->InstructionPointer();
+  const MemoryMap::Mapping* mapping =
+      process_reader.GetMemoryMap()->FindMapping(instruction_pointer);
+  if (!mapping || mapping->inode == 0) {
+    return base::StringPrintf("%x:%x:%" PRIx64,
+                              exception.Exception(),
+                              exception.ExceptionInfo(),
+                              instruction_pointer);
+  }
+  return base::StringPrintf(
+      "%x:%x:%" PRIx64 ":%" PRIx64 ":%" PRIx64,
+      exception.Exception(),
+      exception.ExceptionInfo(),
+      static_cast<uint64_t>(mapping->device),
+      static_cast<uint64_t>(mapping->inode),
+      instruction_pointer - mapping->range.Base() + mapping->offset);
+}
+
 }  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
 #define CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <map>
@@ -44,6 +45,24 @@ namespace crashpad {
 //! \param[out] requesting_thread_id The thread ID of the thread corresponding
 //!     to \a requesting_thread_stack_address. Set to -1 if the thread ID could
 //!     not be determined. Optional.
+//! \param[in] module_initialization_threads The maximum number of threads to
+//!     use to initialize module snapshots. See
+//!     ProcessSnapshotLinux::Initialize().
+//! \param[in] module_memory_cache_pages The number of pages of module memory
+//!     to cache while capturing the snapshot, or `0` to disable the cache. See
+//!     ProcessSnapshotLinux::Initialize().
+//! \param[in] capture_time_limit_ns If nonzero, the time limit for capturing
+//!     the snapshot, after which capture is cut short. See
+//!     ProcessSnapshotLinux::Initialize().
+//! \param[in] stack_capture_options Limits on the thread stacks captured. See
+//!     ProcessSnapshotLinux::SetStackCaptureOptions().
+//! \param[in] module_metadata_cache If not `nullptr`, a cache of module
+//!     metadata to reuse across snapshots. See
+//!     ProcessSnapshotLinux::Initialize().
+//! \param[in] shallow_module_filter If not `nullptr`, selects modules to
+//!     capture shallowly. See ProcessSnapshotLinux::SetShallowModuleFilter().
+//! \param[in] full_memory_options The memory to capture in full-memory mode.
+//!     See ProcessSnapshotLinux::SetFullMemoryOptions().
 //! \param[out] process_snapshot A snapshot of the client process, valid if this
 //!     function returns `true`.
 //! \param[out] sanitized_snapshot A sanitized snapshot of the client process,
@@ -59,9 +78,37 @@ bool CaptureSnapshot(
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
+    size_t module_initialization_threads,
+    size_t module_memory_cache_pages,
+    uint64_t capture_time_limit_ns,
+    const ProcessSnapshotLinux::StackCaptureOptions& stack_capture_options,
+    ModuleMetadataCache* module_metadata_cache,
+    const ShallowModuleFilter* shallow_module_filter,
+    const ProcessSnapshotLinux::FullMemoryOptions& full_memory_options,
     std::unique_ptr<ProcessSnapshotLinux>* process_snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot);
 
+//! \brief Computes a signature identifying a client’s crash without capturing
+//!     a snapshot, for CrashLoopDetector.
+//!
+//! The signature is made of the signal number and code, and the address of the
+//! instruction that crashed. If that address is in a mapping of a file, it is
+//! taken as an offset into the file, which is identified by its device and
+//! inode numbers. These identify a build of a module as reliably as its build
+//! ID does on one host, without reading the module. Only the signal and the
+//! context it was received in, and the client’s mappings, are read.
+//!
+//! Dumps requested by CrashpadClient::DumpWithoutCrash() aren’t crashes, so
+//! they have no signature and are never treated as part of a crash loop.
+//!
+//! \param[in] connection A PtraceConnection to the client.
+//! \param[in] info Information about the client’s crash.
+//! \return The signature, or an empty string for a dump requested without a
+//!     crash, or if the signature couldn’t be computed, with a message logged.
+std::string CrashLoopSignature(
+    PtraceConnection* connection,
+    const ExceptionHandlerProtocol::ClientInformation& info);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
@@ -0,0 +1,167 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/capture_snapshot.h"
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "test/multiprocess.h"
+#include "util/file/file_io.h"
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/exception_information.h"
+#include "util/misc/capture_context.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/posix/signals.h"
+#include "util/process/process_memory_caching.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class CrashLoopSignatureTest : public testing::Test {
+ protected:
+  // Returns the signature of a signal signo received on this thread.
+  std::string Signature(int signo) {
+    FakePtraceConnection connection;
+    EXPECT_TRUE(connection.Initialize(getpid()));
+
+    siginfo_ = {};
+    siginfo_.si_signo = signo;
+    CaptureContext(&context_);
+
+    exception_information_.siginfo_address =
+        FromPointerCast<LinuxVMAddress>(&siginfo_);
+    exception_information_.context_address =
+        FromPointerCast<LinuxVMAddress>(&context_);
+    exception_information_.thread_id = gettid();
+
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.exception_information_address =
+        FromPointerCast<VMAddress>(&exception_information_);
+    return CrashLoopSignature(&connection, info);
+  }
+
+ private:
+  siginfo_t siginfo_;
+  NativeCPUContext context_;
+  ExceptionInformation exception_information_;
+};
+
+TEST_F(CrashLoopSignatureTest, Crash) {
+  EXPECT_FALSE(Signature(SIGSEGV).empty());
+}
+
+TEST_F(CrashLoopSignatureTest, DumpWithoutCrash) {
+  EXPECT_TRUE(Signature(Signals::kSimulatedSigno).empty());
+}
+
+// Captures a snapshot of a child process, as the handler does, and checks the
+// use of the module memory cache.
+class ModuleMemoryCacheTest : public Multiprocess {
+ public:
+  explicit ModuleMemoryCacheTest(size_t module_memory_cache_pages)
+      : Multiprocess(), module_memory_cache_pages_(module_memory_cache_pages) {}
+
+  ModuleMemoryCacheTest(const ModuleMemoryCacheTest&) = delete;
+  ModuleMemoryCacheTest& operator=(const ModuleMemoryCacheTest&) = delete;
+
+  ~ModuleMemoryCacheTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    VMAddress exception_information_address;
+    CheckedReadFileExactly(ReadPipeHandle(),
+                           &exception_information_address,
+                           sizeof(exception_information_address));
+
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.exception_information_address = exception_information_address;
+    std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
+    std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
+    ASSERT_TRUE(CaptureSnapshot(&connection,
+                                info,
+                                std::map<std::string, std::string>(),
+                                getuid(),
+                                0,
+                                nullptr,
+                                0,
+                                module_memory_cache_pages_,
+                                0,
+                                ProcessSnapshotLinux::StackCaptureOptions(),
+                                nullptr,
+                                nullptr,
+                                ProcessSnapshotLinux::FullMemoryOptions(),
+                                &process_snapshot,
+                                &sanitized_snapshot));
+
+    const ProcessMemoryCaching* cache = process_snapshot->ModuleMemoryCache();
+    if (module_memory_cache_pages_ == 0) {
+      EXPECT_FALSE(cache);
+      return;
+    }
+
+    // Module headers, notes, and annotations are read in many small pieces,
+    // most of which are satisfied from pages already cached.
+    ASSERT_TRUE(cache);
+    EXPECT_GT(cache->CacheMisses(), 0u);
+    EXPECT_GT(cache->CacheHits(), cache->CacheMisses());
+  }
+
+  void MultiprocessChild() override {
+    siginfo_t siginfo = {};
+    siginfo.si_signo = SIGSEGV;
+    NativeCPUContext context;
+    CaptureContext(&context);
+
+    ExceptionInformation exception_information;
+    exception_information.siginfo_address =
+        FromPointerCast<LinuxVMAddress>(&siginfo);
+    exception_information.context_address =
+        FromPointerCast<LinuxVMAddress>(&context);
+    exception_information.thread_id = gettid();
+
+    const VMAddress exception_information_address =
+        FromPointerCast<VMAddress>(&exception_information);
+    CheckedWriteFile(WritePipeHandle(),
+                     &exception_information_address,
+                     sizeof(exception_information_address));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  size_t module_memory_cache_pages_;
+};
+
+TEST(CaptureSnapshot, ModuleMemoryCacheDisabled) {
+  ModuleMemoryCacheTest test(0);
+  test.Run();
+}
+
+TEST(CaptureSnapshot, ModuleMemoryCache) {
+  ModuleMemoryCacheTest test(64);
+  test.Run();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,27 +14,54 @@
 
 #include "handler/linux/crash_report_exception_handler.h"
 
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/rand_util.h"
 #include "build/build_config.h"
+#include "client/annotation.h"
 #include "client/settings.h"
 #include "handler/linux/capture_snapshot.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_deduplicator.h"
+#include "minidump/minidump_capture_timings_writer.h"
 #include "minidump/minidump_file_writer.h"
+#include "snapshot/annotation_snapshot.h"
 #include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/module_snapshot.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
-#include "util/file/file_helper.h"
 #include "util/file/file_reader.h"
 #include "util/file/output_stream_file_writer.h"
+#include "util/file/pipelined_file_writer.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/ptrace_client.h"
+#include "util/linux/socket.h"
+#include "util/misc/clock.h"
+#include "util/misc/deadline.h"
 #include "util/misc/implicit_cast.h"
 #include "util/misc/metrics.h"
+#include "util/misc/time.h"
 #include "util/misc/uuid.h"
+#include "util/misc/zlib.h"
 #include "util/stream/base94_output_stream.h"
+#include "util/stream/file_output_stream.h"
 #include "util/stream/log_output_stream.h"
+#include "util/stream/pipelined_output_stream.h"
 #include "util/stream/zlib_output_stream.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include <android/log.h>
@@ -66,9 +93,18 @@ class Logger final : public LogOutputStream::Delegate {
 
   size_t LineWidth() override {
     // From Android NDK r20 <android/log.h>, log message text may be truncated
-    // to less than an implementation-specific limit (1023 bytes), for sake of
-    // safe and being easy to read in logcat, choose 512.
-    return 512;
+    // to less than an implementation-specific limit (1023 bytes). Lines are
+    // kept short to be easy to read in logcat, and LinesPerMessage() of them
+    // still fit in a message.
+    return 320;
+  }
+
+  size_t LinesPerMessage() override { return 3; }
+
+  size_t MaxBytesPerSecond() override {
+    // logd prunes the crash buffer when it’s written faster than it’s read, so
+    // a large minidump is paced rather than logged all at once.
+    return 64 * 1024;
   }
 #else
   // TODO(jperaza): Log to an appropriate location on Linux.
@@ -78,27 +114,170 @@ class Logger final : public LogOutputStream::Delegate {
 #endif
 };
 
-bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader) {
-  ZlibOutputStream stream(
-      ZlibOutputStream::Mode::kCompress,
-      std::make_unique<Base94OutputStream>(
-          Base94OutputStream::Mode::kEncode,
-          std::make_unique<LogOutputStream>(std::make_unique<Logger>())));
-  FileOperationResult read_result;
-  do {
-    uint8_t buffer[4096];
-    read_result = file_reader->Read(buffer, sizeof(buffer));
-    if (read_result < 0)
+bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader,
+                              bool gzip_compressed) {
+  // Output cut short by the output cap is continued from where it stopped, in
+  // a limited number of emissions in all.
+  static constexpr int kMaxEmissions = 4;
+  size_t resume_offset = 0;
+  for (int emission = 1;; ++emission) {
+    if (emission > 1 && !file_reader->SeekSet(0)) {
+      return false;
+    }
+
+    auto log_output_stream =
+        std::make_unique<LogOutputStream>(std::make_unique<Logger>(),
+                                          resume_offset);
+    const LogOutputStream* log_output_stream_weak = log_output_stream.get();
+    std::unique_ptr<OutputStreamInterface> stream =
+        std::make_unique<ZlibOutputStream>(
+            ZlibOutputStream::Mode::kCompress,
+            std::make_unique<Base94OutputStream>(
+                Base94OutputStream::Mode::kEncode,
+                std::move(log_output_stream)));
+    if (gzip_compressed) {
+      stream = std::make_unique<ZlibOutputStream>(
+          ZlibOutputStream::Mode::kDecompress,
+          ZlibOutputStream::Format::kGzip,
+          std::move(stream));
+    }
+    bool written = true;
+    FileOperationResult read_result;
+    do {
+      uint8_t buffer[4096];
+      read_result = file_reader->Read(buffer, sizeof(buffer));
+      if (read_result < 0)
+        return false;
+
+      if (read_result > 0 && (!stream->Write(buffer, read_result))) {
+        written = false;
+        break;
+      }
+    } while (read_result > 0);
+    if (written && stream->Flush()) {
+      return true;
+    }
+
+    // Compression is deterministic, so the same data is logged each time,
+    // and a later emission can pick up where this one stopped.
+    const size_t next_resume_offset = log_output_stream_weak->ResumeOffset();
+    if (emission == kMaxEmissions || next_resume_offset <= resume_offset) {
+      return false;
+    }
+    resume_offset = next_resume_offset;
+  }
+}
+
+// Adds the phases timed so far to minidump. Phases that end after the minidump
+// is written, such as writing it, are only reported to Metrics.
+void AddCaptureTimingsStream(const CaptureTimings& capture_timings,
+                             MinidumpFileWriter* minidump) {
+  auto capture_timings_writer =
+      std::make_unique<MinidumpCaptureTimingsWriter>();
+  capture_timings_writer->InitializeFromCaptureTimings(capture_timings);
+  if (capture_timings_writer->IsUseful()) {
+    minidump->AddStream(std::move(capture_timings_writer));
+  }
+}
+
+// Adds the full memory captured in process_snapshot to minidump, unless the
+// report is sanitized. Returns true if any was added.
+bool AddFullMemory(const ProcessSnapshotLinux& process_snapshot,
+                   bool sanitized,
+                   MinidumpFileWriter* minidump) {
+  if (sanitized) {
+    return false;
+  }
+  std::vector<const MemorySnapshot*> full_memory =
+      process_snapshot.FullMemory();
+  return !full_memory.empty() &&
+         minidump->AddFullMemory(full_memory,
+                                 process_snapshot.FullMemoryZeroRanges());
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+constexpr uint64_t kNanosecondsPerMillisecond = kNanosecondsPerSecond / 1000;
+
+// The crashing client waits on the handler while its minidump is handed off,
+// so a consumer that doesn't accept the minidump promptly is given up on.
+constexpr uint64_t kMinidumpHandoffTimeoutNs = 2 * kNanosecondsPerSecond;
+
+// How long to wait before retrying a connection to a consumer whose listen
+// backlog is full.
+constexpr uint64_t kMinidumpHandoffRetryNs = 10 * kNanosecondsPerMillisecond;
+
+// Converts the time remaining before deadline to a poll() timeout, rounding up
+// so that a deadline less than a millisecond away isn't treated as expired.
+int PollTimeout(const Deadline& deadline) {
+  const uint64_t remaining_ms =
+      (deadline.RemainingNanoseconds() + kNanosecondsPerMillisecond - 1) /
+      kNanosecondsPerMillisecond;
+  return static_cast<int>(
+      std::min(remaining_ms, uint64_t{std::numeric_limits<int>::max()}));
+}
+
+// Connects the non-blocking socket sock to address. A local socket whose
+// listen backlog is full refuses the connection with EAGAIN instead of
+// queuing it, so the connection is retried until deadline.
+bool ConnectWithDeadline(int sock,
+                         const sockaddr_un& address,
+                         const Deadline& deadline) {
+  while (true) {
+    if (HANDLE_EINTR(connect(sock,
+                             reinterpret_cast<const sockaddr*>(&address),
+                             sizeof(address))) == 0) {
+      return true;
+    }
+    if (errno != EAGAIN || deadline.Expired()) {
+      PLOG(ERROR) << "connect";
       return false;
+    }
+    SleepNanoseconds(
+        std::min(kMinidumpHandoffRetryNs, deadline.RemainingNanoseconds()));
+  }
+}
 
-    if (read_result > 0 && (!stream.Write(buffer, read_result)))
+// Waits until the connected socket sock can be written to without blocking, or
+// until deadline.
+bool WaitForWritable(int sock, const Deadline& deadline) {
+  pollfd poll_fd = {};
+  poll_fd.fd = sock;
+  poll_fd.events = POLLOUT;
+  while (true) {
+    const int result = poll(&poll_fd, 1, PollTimeout(deadline));
+    if (result > 0) {
+      return (poll_fd.revents & POLLOUT) != 0;
+    }
+    if (result == 0) {
+      LOG(ERROR) << "poll timed out";
       return false;
-  } while (read_result > 0);
-  return stream.Flush();
+    }
+    if (errno != EINTR) {
+      PLOG(ERROR) << "poll";
+      return false;
+    }
+  }
 }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 
 }  // namespace
 
+class CrashReportExceptionHandler::ReportWriterThread final : public Thread {
+ public:
+  explicit ReportWriterThread(CrashReportExceptionHandler* handler)
+      : handler_(handler) {}
+
+  ReportWriterThread(const ReportWriterThread&) = delete;
+  ReportWriterThread& operator=(const ReportWriterThread&) = delete;
+
+  ~ReportWriterThread() override {}
+
+ private:
+  void ThreadMain() override { handler_->RunReportWriterThread(); }
+
+  CrashReportExceptionHandler* handler_;  // weak
+};
+
 CrashReportExceptionHandler::CrashReportExceptionHandler(
     CrashReportDatabase* database,
     CrashReportUploadThread* upload_thread,
@@ -107,17 +286,64 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
     bool write_minidump_to_database,
     bool write_minidump_to_log,
     const UserStreamDataSources* user_stream_data_sources)
-    : database_(database),
-      upload_thread_(upload_thread),
+    : default_profile_{database, upload_thread, {}},
+      client_profiles_(nullptr),
       process_annotations_(process_annotations),
       attachments_(attachments),
       write_minidump_to_database_(write_minidump_to_database),
       write_minidump_to_log_(write_minidump_to_log),
-      user_stream_data_sources_(user_stream_data_sources) {
+      user_stream_data_sources_(user_stream_data_sources),
+      user_stream_data_source_options_(),
+      module_initialization_threads_(0),
+      module_memory_cache_pages_(0),
+      capture_time_limit_ns_(0),
+      shallow_module_filter_(nullptr),
+      full_memory_options_(),
+      compression_threads_(1),
+      compress_minidumps_(false),
+      deduplicate_thread_stacks_(false),
+      max_listed_threads_(0),
+      micro_dump_options_(),
+      dump_sampler_(nullptr),
+      crash_loop_detector_(nullptr),
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+      minidump_consumer_socket_(),
+#endif
+      module_metadata_cache_(),
+      report_writer_thread_(),
+      deferred_reports_semaphore_(0),
+      deferred_reports_lock_(),
+      deferred_reports_(),
+      report_writer_stopping_(false) {
   DCHECK(write_minidump_to_database_ | write_minidump_to_log_);
 }
 
-CrashReportExceptionHandler::~CrashReportExceptionHandler() = default;
+CrashReportExceptionHandler::~CrashReportExceptionHandler() {
+  SetDeferReportWriting(false);
+}
+
+void CrashReportExceptionHandler::SetDeferReportWriting(
+    bool defer_report_writing) {
+  if (defer_report_writing == !!report_writer_thread_) {
+    return;
+  }
+
+  if (defer_report_writing) {
+    report_writer_stopping_ = false;
+    report_writer_thread_ = std::make_unique<ReportWriterThread>(this);
+    report_writer_thread_->Start();
+    return;
+  }
+
+  // Reports that are still pending are finished before the thread exits.
+  {
+    base::AutoLock lock(deferred_reports_lock_);
+    report_writer_stopping_ = true;
+  }
+  deferred_reports_semaphore_.Signal();
+  report_writer_thread_->Join();
+  report_writer_thread_.reset();
+}
 
 bool CrashReportExceptionHandler::HandleException(
     pid_t client_process_id,
@@ -125,22 +351,38 @@ bool CrashReportExceptionHandler::HandleException(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const CrashContextRegion* crash_context) {
   Metrics::ExceptionEncountered();
 
-  DirectPtraceConnection connection;
-  if (!connection.Initialize(client_process_id)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kDirectPtraceFailed);
-    return false;
-  }
+  CaptureTimings capture_timings;
+  bool result;
+  {
+    // The client waits for this method to return before it resumes.
+    CaptureTimings::ScopedPhase suspended(&capture_timings,
+                                          CaptureTimings::Phase::kSuspended);
+
+    DirectPtraceConnection connection;
+    if (!connection.Initialize(client_process_id)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kDirectPtraceFailed);
+      return false;
+    }
+    if (crash_context) {
+      crash_context->AddToMemory(connection.Memory());
+      crash_context->AddThreadContexts(&connection);
+    }
 
-  return HandleExceptionWithConnection(&connection,
-                                       info,
-                                       client_uid,
-                                       requesting_thread_stack_address,
-                                       requesting_thread_id,
-                                       local_report_id);
+    result = HandleExceptionWithConnection(&connection,
+                                           info,
+                                           client_uid,
+                                           requesting_thread_stack_address,
+                                           requesting_thread_id,
+                                           &capture_timings,
+                                           local_report_id);
+  }
+  capture_timings.ReportMetrics();
+  return result;
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithBroker(
@@ -148,18 +390,38 @@ bool CrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const CrashContextRegion* crash_context) {
   Metrics::ExceptionEncountered();
 
-  PtraceClient client;
-  if (!client.Initialize(broker_sock, client_process_id)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kBrokeredPtraceFailed);
-    return false;
-  }
+  CaptureTimings capture_timings;
+  bool result;
+  {
+    // The client waits for this method to return before it resumes.
+    CaptureTimings::ScopedPhase suspended(&capture_timings,
+                                          CaptureTimings::Phase::kSuspended);
+
+    PtraceClient client;
+    if (!client.Initialize(broker_sock, client_process_id)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kBrokeredPtraceFailed);
+      return false;
+    }
+    if (crash_context) {
+      crash_context->AddToMemory(client.Memory());
+      crash_context->AddThreadContexts(&client);
+    }
 
-  return HandleExceptionWithConnection(
-      &client, info, client_uid, 0, nullptr, local_report_id);
+    result = HandleExceptionWithConnection(&client,
+                                           info,
+                                           client_uid,
+                                           0,
+                                           nullptr,
+                                           &capture_timings,
+                                           local_report_id);
+  }
+  capture_timings.ReportMetrics();
+  return result;
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithConnection(
@@ -168,7 +430,24 @@ bool CrashReportExceptionHandler::HandleExceptionWithConnection(
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
+    CaptureTimings* capture_timings,
     UUID* local_report_id) {
+  // A crash loop is recognized before the client is captured, so that a crash
+  // skipped costs next to nothing.
+  bool crash_loop = false;
+  unsigned int crash_loop_skipped = 0;
+  if (crash_loop_detector_ && crash_loop_detector_->enabled()) {
+    crash_loop = !crash_loop_detector_->ShouldCapture(
+        CrashLoopSignature(connection, info),
+        time(nullptr),
+        &crash_loop_skipped);
+    if (crash_loop && !micro_dump_options_.database) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kSkippedDueToCrashLoop);
+      return false;
+    }
+  }
+
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
   std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
   if (!CaptureSnapshot(connection,
@@ -177,34 +456,156 @@ bool CrashReportExceptionHandler::HandleExceptionWithConnection(
                        client_uid,
                        requesting_thread_stack_address,
                        requesting_thread_id,
+                       module_initialization_threads_,
+                       module_memory_cache_pages_,
+                       capture_time_limit_ns_,
+                       stack_capture_options_,
+                       &module_metadata_cache_,
+                       shallow_module_filter_,
+                       crash_loop ? ProcessSnapshotLinux::FullMemoryOptions()
+                                  : full_memory_options_,
                        &process_snapshot,
                        &sanitized_snapshot)) {
     return false;
   }
+  capture_timings->Merge(process_snapshot->Timings());
+  if (crash_loop_skipped) {
+    process_snapshot->AddAnnotation(kCrashLoopSkippedAnnotation,
+                                    std::to_string(crash_loop_skipped));
+  }
+  process_snapshot->GetRemoteReads(capture_timings);
+
+  const ClientProfile& profile = ProfileForClient(*process_snapshot);
+  for (const auto& annotation : profile.process_annotations) {
+    process_snapshot->AddAnnotation(annotation.first, annotation.second);
+  }
 
   UUID client_id;
-  Settings* const settings = database_->GetSettings();
+  Settings* const settings = profile.database->GetSettings();
   if (settings && settings->GetClientID(&client_id)) {
     process_snapshot->SetClientID(client_id);
   }
 
-  return write_minidump_to_database_
-             ? WriteMinidumpToDatabase(process_snapshot.get(),
-                                       sanitized_snapshot.get(),
-                                       write_minidump_to_log_,
-                                       local_report_id)
-             : WriteMinidumpToLog(process_snapshot.get(),
-                                  sanitized_snapshot.get());
+  if (micro_dump_options_.database) {
+    const bool micro_dump_written = WriteMicroDumpToDatabase(
+        process_snapshot.get(), sanitized_snapshot.get(), local_report_id);
+
+    // A crash that isn’t sampled for a full report still gets one if its micro
+    // dump couldn’t be written, so that it isn’t lost entirely. A crash loop
+    // doesn’t, as it wouldn’t have without micro dumps.
+    if (crash_loop ||
+        (micro_dump_written &&
+         base::RandInt(0, 99) >= micro_dump_options_.full_report_percentage)) {
+      if (micro_dump_written) {
+        Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSuccess);
+      }
+      process_snapshot->GetRemoteReads(capture_timings);
+      return micro_dump_written;
+    }
+  }
+
+  // The stacks have been captured by now regardless. Leaving out the memory
+  // they refer to, the client’s extra memory ranges, and full memory is what
+  // makes a reduced dump cheaper, because that memory is only read from the
+  // client as the minidump is written.
+  bool full_dump = true;
+  if (dump_sampler_) {
+    full_dump = dump_sampler_->ShouldWriteFullDump(
+        CrashSignatureFromSnapshot(
+            sanitized_snapshot
+                ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot.get())
+                : implicit_cast<ProcessSnapshot*>(process_snapshot.get())),
+        time(nullptr));
+    if (!full_dump) {
+      process_snapshot->AddAnnotation(kReducedDumpAnnotation, "1");
+    }
+  }
+
+  bool hand_off_minidump = false;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  hand_off_minidump = !minidump_consumer_socket_.empty();
+#endif
+
+  bool written = true;
+  if (write_minidump_to_database_) {
+    written = WriteMinidumpToDatabase(process_snapshot.get(),
+                                      sanitized_snapshot.get(),
+                                      profile,
+                                      write_minidump_to_log_,
+                                      full_dump,
+                                      capture_timings,
+                                      local_report_id);
+  } else if (write_minidump_to_log_ || !hand_off_minidump) {
+    written = WriteMinidumpToLog(process_snapshot.get(),
+                                 sanitized_snapshot.get(),
+                                 full_dump,
+                                 capture_timings);
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  if (hand_off_minidump) {
+    written = HandOffMinidump(process_snapshot.get(),
+                              sanitized_snapshot.get(),
+                              write_minidump_to_database_ && written,
+                              full_dump,
+                              capture_timings) &&
+              written;
+  }
+#endif
+
+  // Stacks and other memory are read while the minidump is written, after the
+  // capture timings stream was built, so update the totals for metrics.
+  process_snapshot->GetRemoteReads(capture_timings);
+  return written;
+}
+
+const CrashReportExceptionHandler::ClientProfile&
+CrashReportExceptionHandler::ProfileForClient(
+    const ProcessSnapshotLinux& process_snapshot) const {
+  if (!client_profiles_ || client_profiles_->empty()) {
+    return default_profile_;
+  }
+
+  // The process annotations are the handler’s own, so only the client’s
+  // modules can say which product it belongs to.
+  for (const ModuleSnapshot* module : process_snapshot.Modules()) {
+    std::string product;
+    const auto& simple_annotations = module->AnnotationsSimpleMap();
+    auto simple_annotation = simple_annotations.find(kProductAnnotation);
+    if (simple_annotation != simple_annotations.end()) {
+      product = simple_annotation->second;
+    } else {
+      for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
+        if (annotation.name == kProductAnnotation &&
+            annotation.type ==
+                static_cast<uint16_t>(Annotation::Type::kString)) {
+          product.assign(reinterpret_cast<const char*>(annotation.value.data()),
+                         annotation.value.size());
+          break;
+        }
+      }
+    }
+
+    if (!product.empty()) {
+      auto profile = client_profiles_->find(product);
+      return profile != client_profiles_->end() ? profile->second
+                                                : default_profile_;
+    }
+  }
+  return default_profile_;
 }
 
 bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
     ProcessSnapshotLinux* process_snapshot,
     ProcessSnapshotSanitized* sanitized_snapshot,
+    const ClientProfile& profile,
     bool write_minidump_to_log,
+    bool full_dump,
+    CaptureTimings* capture_timings,
     UUID* local_report_id) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   CrashReportDatabase::OperationStatus database_status =
-      database_->PrepareNewCrashReport(&new_report);
+      profile.database->PrepareNewCrashReport(&new_report);
   if (database_status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "PrepareNewCrashReport failed";
     Metrics::ExceptionCaptureResult(
@@ -219,20 +620,158 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
 
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.SetMaxListedThreads(max_listed_threads_);
+  minidump.InitializeFromSnapshot(snapshot, full_dump);
+  minidump.SetDeduplicateThreadStacks(deduplicate_thread_stacks_);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_data_source_options_);
+  AddCaptureTimingsStream(*capture_timings, &minidump);
+  const bool full_memory =
+      full_dump &&
+      AddFullMemory(*process_snapshot, !!sanitized_snapshot, &minidump);
+
+  // The upload parameters are derived while the snapshot is at hand, so that
+  // the minidump needn’t be interpreted to recover them when it’s uploaded.
+  if (!new_report->SetUploadParameters(
+          BreakpadHTTPFormParametersFromMinidump(snapshot),
+          CrashSignatureFromSnapshot(snapshot))) {
+    LOG(WARNING) << "couldn't store upload parameters";
+  }
 
-  if (!minidump.WriteEverything(new_report->Writer())) {
+  if (report_writer_thread_ && !full_memory) {
+    // Everything read from the client is read here, so that the client can be
+    // released before any of the report is written to the database.
+    auto deferred_report = std::make_unique<DeferredReport>();
+    bool minidump_written;
+    {
+      CaptureTimings::ScopedPhase phase(capture_timings,
+                                        CaptureTimings::Phase::kMinidumpWrite);
+      minidump_written = minidump.WriteEverything(&deferred_report->minidump);
+    }
+    if (!minidump_written) {
+      LOG(ERROR) << "WriteEverything failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kMinidumpWriteFailed);
+      return false;
+    }
+
+    if (local_report_id != nullptr) {
+      *local_report_id = new_report->ReportID();
+    }
+
+    deferred_report->new_report = std::move(new_report);
+    deferred_report->profile = &profile;
+    deferred_report->write_minidump_to_log = write_minidump_to_log;
+    {
+      base::AutoLock lock(deferred_reports_lock_);
+      deferred_reports_.push_back(std::move(deferred_report));
+    }
+    deferred_reports_semaphore_.Signal();
+    return true;
+  }
+
+  bool minidump_written;
+  {
+    CaptureTimings::ScopedPhase phase(capture_timings,
+                                      CaptureTimings::Phase::kMinidumpWrite);
+    if (compress_minidumps_) {
+      // Compression requires the minidump to be written without seeking.
+      // Reading the client’s memory, compressing, and writing to the database
+      // each run on their own thread.
+      auto zlib_output_stream = std::make_unique<ZlibOutputStream>(
+          ZlibOutputStream::Mode::kCompress,
+          ZlibOutputStream::Format::kGzip,
+          std::make_unique<PipelinedOutputStream>(
+              std::make_unique<FileOutputStream>(new_report->Writer())));
+      zlib_output_stream->SetCompressionThreads(compression_threads_);
+      OutputStreamFileWriter writer(
+          std::make_unique<PipelinedOutputStream>(
+              std::move(zlib_output_stream)));
+      minidump_written =
+          minidump.WriteMinidump(&writer, false /* allow_seek */) &&
+          writer.Flush();
+    } else {
+      // Writing on another thread lets reads of the client’s memory for the
+      // next block proceed while the previous one goes to disk.
+      PipelinedFileWriter writer(new_report->Writer());
+      minidump_written =
+          minidump.WriteEverything(&writer) && writer.Flush();
+    }
+  }
+  if (!minidump_written) {
     LOG(ERROR) << "WriteEverything failed";
     Metrics::ExceptionCaptureResult(
         Metrics::CaptureResult::kMinidumpWriteFailed);
     return false;
   }
 
+  CaptureTimings::ScopedPhase phase(capture_timings,
+                                    CaptureTimings::Phase::kDatabaseCommit);
+  return FinishReport(
+      std::move(new_report), profile, write_minidump_to_log, local_report_id);
+}
+
+bool CrashReportExceptionHandler::WriteMicroDumpToDatabase(
+    ProcessSnapshotLinux* process_snapshot,
+    ProcessSnapshotSanitized* sanitized_snapshot,
+    UUID* local_report_id) {
+  CrashReportDatabase* const database = micro_dump_options_.database;
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  if (database->PrepareNewCrashReport(&new_report) !=
+      CrashReportDatabase::kNoError) {
+    LOG(ERROR) << "PrepareNewCrashReport failed for micro dump";
+    return false;
+  }
+
+  // A full report written afterwards replaces this with its own ID.
+  process_snapshot->SetReportID(new_report->ReportID());
+
+  ProcessSnapshot* snapshot =
+      sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
+                         : implicit_cast<ProcessSnapshot*>(process_snapshot);
+
+  MinidumpFileWriter minidump;
+  minidump.InitializeMicroDumpFromSnapshot(snapshot,
+                                           micro_dump_options_.max_stack_size);
+  if (!new_report->SetUploadParameters(
+          BreakpadHTTPFormParametersFromMinidump(snapshot),
+          CrashSignatureFromSnapshot(snapshot))) {
+    LOG(WARNING) << "couldn't store upload parameters";
+  }
+
+  if (!minidump.WriteEverything(new_report->Writer())) {
+    LOG(ERROR) << "WriteEverything failed for micro dump";
+    return false;
+  }
+
+  UUID uuid;
+  if (database->FinishedWritingCrashReport(std::move(new_report), &uuid) !=
+      CrashReportDatabase::kNoError) {
+    LOG(ERROR) << "FinishedWritingCrashReport failed for micro dump";
+    return false;
+  }
+
+  if (micro_dump_options_.upload_thread) {
+    micro_dump_options_.upload_thread->ReportPending(uuid);
+  }
+
+  if (local_report_id != nullptr) {
+    *local_report_id = uuid;
+  }
+  return true;
+}
+
+bool CrashReportExceptionHandler::FinishReport(
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+    const ClientProfile& profile,
+    bool write_minidump_to_log,
+    UUID* local_report_id) {
   bool write_minidump_to_log_succeed = false;
   if (write_minidump_to_log) {
     if (auto* file_reader = new_report->Reader()) {
-      if (WriteMinidumpLogFromFile(file_reader))
+      if (WriteMinidumpLogFromFile(file_reader, compress_minidumps_))
         write_minidump_to_log_succeed = true;
       else
         LOG(ERROR) << "WriteMinidumpLogFromFile failed";
@@ -240,27 +779,17 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
   }
 
   for (const auto& attachment : (*attachments_)) {
-    FileReader file_reader;
-    if (!file_reader.Open(attachment)) {
+    if (!new_report->AddAttachmentFromFile(attachment.BaseName().value(),
+                                           attachment)) {
       LOG(ERROR) << "attachment " << attachment.value().c_str()
-                 << " couldn't be opened, skipping";
-      continue;
-    }
-
-    base::FilePath filename = attachment.BaseName();
-    FileWriter* file_writer = new_report->AddAttachment(filename.value());
-    if (file_writer == nullptr) {
-      LOG(ERROR) << "attachment " << filename.value().c_str()
-                 << " couldn't be created, skipping";
-      continue;
+                 << " couldn't be added, skipping";
     }
-
-    CopyFileContent(&file_reader, file_writer);
   }
 
   UUID uuid;
-  database_status =
-      database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+  CrashReportDatabase::OperationStatus database_status =
+      profile.database->FinishedWritingCrashReport(std::move(new_report),
+                                                   &uuid);
   if (database_status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "FinishedWritingCrashReport failed";
     Metrics::ExceptionCaptureResult(
@@ -268,8 +797,8 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
     return false;
   }
 
-  if (upload_thread_) {
-    upload_thread_->ReportPending(uuid);
+  if (profile.upload_thread) {
+    profile.upload_thread->ReportPending(uuid);
   }
 
   if (local_report_id != nullptr) {
@@ -281,16 +810,188 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
   return write_minidump_to_log ? write_minidump_to_log_succeed : true;
 }
 
+void CrashReportExceptionHandler::RunReportWriterThread() {
+  while (true) {
+    deferred_reports_semaphore_.Wait();
+
+    std::unique_ptr<DeferredReport> deferred_report;
+    {
+      base::AutoLock lock(deferred_reports_lock_);
+      if (deferred_reports_.empty()) {
+        DCHECK(report_writer_stopping_);
+        return;
+      }
+      deferred_report = std::move(deferred_reports_.front());
+      deferred_reports_.pop_front();
+    }
+
+    // Writing the serialized minidump to the database is part of committing
+    // the report, which happens after the client's capture was reported.
+    const uint64_t commit_start_ns = ClockMonotonicNanoseconds();
+
+    const std::string& minidump = deferred_report->minidump.string();
+    FileWriter* file_writer = deferred_report->new_report->Writer();
+    bool minidump_written;
+    if (compress_minidumps_ && compression_threads_ > 1) {
+      auto zlib_output_stream = std::make_unique<ZlibOutputStream>(
+          ZlibOutputStream::Mode::kCompress,
+          ZlibOutputStream::Format::kGzip,
+          std::make_unique<FileOutputStream>(file_writer));
+      zlib_output_stream->SetCompressionThreads(compression_threads_);
+      OutputStreamFileWriter writer(std::move(zlib_output_stream));
+      minidump_written =
+          writer.Write(minidump.data(), minidump.size()) && writer.Flush();
+    } else if (compress_minidumps_) {
+      // The whole minidump is already in memory, so it can be compressed in
+      // one call, which is faster with some zlib backends.
+      std::vector<uint8_t> compressed;
+      minidump_written =
+          GzipCompressBuffer(minidump.data(), minidump.size(), &compressed) &&
+          file_writer->Write(compressed.data(), compressed.size());
+    } else {
+      minidump_written = file_writer->Write(minidump.data(), minidump.size());
+    }
+    if (!minidump_written) {
+      LOG(ERROR) << "Write failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kMinidumpWriteFailed);
+      continue;
+    }
+
+    FinishReport(std::move(deferred_report->new_report),
+                 *deferred_report->profile,
+                 deferred_report->write_minidump_to_log,
+                 nullptr);
+    Metrics::CapturePhaseDuration(
+        Metrics::CapturePhase::kDatabaseCommit,
+        ClockMonotonicNanoseconds() - commit_start_ns);
+  }
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+bool CrashReportExceptionHandler::HandOffMinidump(
+    ProcessSnapshotLinux* process_snapshot,
+    ProcessSnapshotSanitized* sanitized_snapshot,
+    bool written_to_database,
+    bool full_dump,
+    CaptureTimings* capture_timings) {
+  ExceptionHandlerProtocol::MinidumpHandoffMessage message = {};
+  message.version = ExceptionHandlerProtocol::MinidumpHandoffMessage::kVersion;
+  message.client_pid = process_snapshot->ProcessID();
+
+  // Without a database report to share an ID with, the minidump gets one of
+  // its own, so that the consumer can still tell reports apart.
+  if (written_to_database) {
+    process_snapshot->ReportID(&message.report_id);
+  } else {
+    if (!message.report_id.InitializeWithNew()) {
+      return false;
+    }
+    process_snapshot->SetReportID(message.report_id);
+  }
+
+  FileWriter file_writer;
+  if (!file_writer.OpenMemfd(base::FilePath("minidump"))) {
+    Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kOpenMemfdFailed);
+    return false;
+  }
+
+  ProcessSnapshot* snapshot =
+      sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
+                         : implicit_cast<ProcessSnapshot*>(process_snapshot);
+  MinidumpFileWriter minidump;
+  minidump.SetMaxListedThreads(max_listed_threads_);
+  minidump.InitializeFromSnapshot(snapshot, full_dump);
+  minidump.SetDeduplicateThreadStacks(deduplicate_thread_stacks_);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_data_source_options_);
+  AddCaptureTimingsStream(*capture_timings, &minidump);
+  if (full_dump) {
+    AddFullMemory(*process_snapshot, !!sanitized_snapshot, &minidump);
+  }
+
+  {
+    CaptureTimings::ScopedPhase phase(capture_timings,
+                                      CaptureTimings::Phase::kMinidumpWrite);
+    PipelinedFileWriter writer(&file_writer);
+    if (!minidump.WriteEverything(&writer) || !writer.Flush()) {
+      LOG(ERROR) << "WriteEverything failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kMinidumpWriteFailed);
+      return false;
+    }
+  }
+
+  const FileOffset minidump_size = file_writer.Seek(0, SEEK_END);
+  if (minidump_size < 0) {
+    return false;
+  }
+  message.minidump_size = minidump_size;
+
+  ScopedFileHandle sock(
+      socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+  if (!sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return false;
+  }
+
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  const std::string& path = minidump_consumer_socket_.value();
+  if (path.size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "minidump consumer socket path too long";
+    return false;
+  }
+  memcpy(address.sun_path, path.c_str(), path.size());
+
+  const Deadline deadline = Deadline::FromNow(kMinidumpHandoffTimeoutNs);
+  if (!ConnectWithDeadline(sock.get(), address, deadline)) {
+    LOG(ERROR) << "couldn't connect to minidump consumer " << path;
+    return false;
+  }
+
+  // The socket is non-blocking, so wait for room for the message before
+  // sending it.
+  if (!WaitForWritable(sock.get(), deadline)) {
+    LOG(ERROR) << "minidump consumer " << path << " isn't receiving";
+    return false;
+  }
+
+  const int memfd = file_writer.fd();
+  if (UnixCredentialSocket::SendMsg(
+          sock.get(), &message, sizeof(message), &memfd, 1) != 0) {
+    LOG(ERROR) << "couldn't hand off minidump to " << path;
+    return false;
+  }
+  return true;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 bool CrashReportExceptionHandler::WriteMinidumpToLog(
     ProcessSnapshotLinux* process_snapshot,
-    ProcessSnapshotSanitized* sanitized_snapshot) {
+    ProcessSnapshotSanitized* sanitized_snapshot,
+    bool full_dump,
+    CaptureTimings* capture_timings) {
   ProcessSnapshot* snapshot =
       sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.SetMaxListedThreads(max_listed_threads_);
+  minidump.InitializeFromSnapshot(snapshot, full_dump);
+  minidump.SetDeduplicateThreadStacks(deduplicate_thread_stacks_);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_data_source_options_);
+  AddCaptureTimingsStream(*capture_timings, &minidump);
+  if (full_dump) {
+    AddFullMemory(*process_snapshot, !!sanitized_snapshot, &minidump);
+  }
 
+  CaptureTimings::ScopedPhase phase(capture_timings,
+                                    CaptureTimings::Phase::kMinidumpWrite);
   OutputStreamFileWriter writer(std::make_unique<ZlibOutputStream>(
       ZlibOutputStream::Mode::kCompress,
       std::make_unique<Base94OutputStream>(
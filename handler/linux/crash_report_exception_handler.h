@@ -15,17 +15,31 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 #define CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 
+#include <stdint.h>
+
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
 
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
 #include "client/crash_report_database.h"
+#include "handler/crash_loop_detector.h"
 #include "handler/crash_report_upload_thread.h"
+#include "handler/dump_sampler.h"
 #include "handler/linux/exception_handler_server.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/module_metadata_cache.h"
+#include "util/file/string_file.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
+#include "util/misc/capture_timings.h"
 #include "util/misc/uuid.h"
+#include "util/synchronization/semaphore.h"
 
 namespace crashpad {
 
@@ -77,6 +91,52 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
 
   ~CrashReportExceptionHandler() override;
 
+  //! \brief Where the crash reports of the clients of one product go.
+  struct ClientProfile {
+    //! \brief The database to store crash reports in. Weak.
+    CrashReportDatabase* database;
+
+    //! \brief The upload thread to notify when a new crash report is written
+    //!     into #database, or `nullptr` to skip upload. Weak.
+    CrashReportUploadThread* upload_thread;
+
+    //! \brief Process annotations that are added to the handler’s own
+    //!     process annotations, replacing any with the same keys.
+    std::map<std::string, std::string> process_annotations;
+  };
+
+  //! \brief The module annotation that names a client’s product.
+  static constexpr char kProductAnnotation[] = "prod";
+
+  //! \brief The process annotation added to reports whose minidump was
+  //!     reduced by the DumpSampler given to SetDumpSampler().
+  static constexpr char kReducedDumpAnnotation[] = "crashpad_reduced_dump";
+
+  //! \brief The process annotation giving the number of crashes with the same
+  //!     signature that were skipped by the CrashLoopDetector given to
+  //!     SetCrashLoopDetector() since the last one captured.
+  static constexpr char kCrashLoopSkippedAnnotation[] =
+      "crashpad_crash_loop_skipped";
+
+  //! \brief Routes crash reports to per-product databases.
+  //!
+  //! When a single handler serves many unrelated clients, each client’s
+  //! product is taken from the #kProductAnnotation annotation set by one of
+  //! its own modules, either in CrashpadInfo::simple_annotations() or as a
+  //! string Annotation. If \a client_profiles has an entry for that product,
+  //! the client’s crash report is written to that entry’s database, uploaded
+  //! by its upload thread, and given its process annotations. Reports from
+  //! other clients go to the database and upload thread that this object was
+  //! constructed with.
+  //!
+  //! \param[in] client_profiles Profiles keyed by product, or `nullptr` to
+  //!     handle all clients alike. Weak. Must not be modified while this
+  //!     object is handling exceptions.
+  void SetClientProfiles(
+      const std::map<std::string, ClientProfile>* client_profiles) {
+    client_profiles_ = client_profiles;
+  }
+
   // ExceptionHandlerServer::Delegate:
 
   bool HandleException(pid_t client_process_id,
@@ -84,38 +144,296 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const CrashContextRegion* crash_context =
+                           nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override;
+      UUID* local_report_id = nullptr,
+      const CrashContextRegion* crash_context = nullptr) override;
+
+  //! \brief Sets the maximum number of threads used to initialize module
+  //!     snapshots. See ProcessSnapshotLinux::Initialize().
+  void SetModuleInitializationThreads(size_t threads) {
+    module_initialization_threads_ = threads;
+  }
+
+  //! \brief Sets the number of pages of module memory to cache while capturing
+  //!     a snapshot. `0`, the default, disables the cache. See
+  //!     ProcessSnapshotLinux::Initialize().
+  void SetModuleMemoryCachePages(size_t pages) {
+    module_memory_cache_pages_ = pages;
+  }
+
+  //! \brief Sets the time limit for capturing a snapshot, after which a
+  //!     partial snapshot is written. `0`, the default, means no limit. See
+  //!     ProcessSnapshotLinux::Initialize().
+  void SetCaptureTimeLimit(uint64_t time_limit_ns) {
+    capture_time_limit_ns_ = time_limit_ns;
+  }
+
+  //! \brief Sets how the user stream data sources given to the constructor
+  //!     are called. See AddUserExtensionStreams().
+  void SetUserStreamDataSourceOptions(
+      const UserStreamDataSourceOptions& options) {
+    user_stream_data_source_options_ = options;
+  }
+
+  //! \brief Sets limits on the thread stacks captured. See
+  //!     ProcessSnapshotLinux::SetStackCaptureOptions().
+  void SetStackCaptureOptions(
+      const ProcessSnapshotLinux::StackCaptureOptions& options) {
+    stack_capture_options_ = options;
+  }
+
+  //! \brief Sets a filter selecting modules to capture shallowly. See
+  //!     ProcessSnapshotLinux::SetShallowModuleFilter().
+  //!
+  //! This object does not take ownership of \a filter, which must outlive it.
+  void SetShallowModuleFilter(const ShallowModuleFilter* filter) {
+    shallow_module_filter_ = filter;
+  }
+
+  //! \brief Sets the memory captured in full-memory mode. See
+  //!     ProcessSnapshotLinux::SetFullMemoryOptions().
+  //!
+  //! Full memory is left out of sanitized reports. Reports with full memory
+  //! are written while the client is suspended even if report writing is
+  //! deferred by SetDeferReportWriting(), because they are too large to hold
+  //! in memory.
+  void SetFullMemoryOptions(
+      const ProcessSnapshotLinux::FullMemoryOptions& options) {
+    full_memory_options_ = options;
+  }
+
+  //! \brief Sets whether minidumps written to the database are
+  //!     `gzip`-compressed as they are written.
+  //!
+  //! Compressed reports take less space in the database, and
+  //! CrashReportUploadThread uploads them without compressing them again.
+  void SetCompressMinidumps(bool compress_minidumps) {
+    compress_minidumps_ = compress_minidumps;
+  }
+
+  //! \brief Sets the maximum number of threads that compress each minidump
+  //!     when SetCompressMinidumps() is in effect.
+  void SetCompressionThreads(size_t compression_threads) {
+    compression_threads_ = compression_threads;
+  }
+
+  //! \brief Sets whether thread stacks with identical contents are stored once
+  //!     in minidumps. See MinidumpThreadListWriter::SetDeduplicateStacks().
+  void SetDeduplicateThreadStacks(bool deduplicate_thread_stacks) {
+    deduplicate_thread_stacks_ = deduplicate_thread_stacks;
+  }
+
+  //! \brief Sets the number of threads listed in the standard thread list of
+  //!     minidumps. See MinidumpFileWriter::SetMaxListedThreads().
+  void SetMaxListedThreads(size_t max_listed_threads) {
+    max_listed_threads_ = max_listed_threads;
+  }
+
+  //! \brief Sets whether reports are finished after the client is released.
+  //!
+  //! When enabled, each minidump is serialized into memory while the client
+  //! is stopped, and HandleException() returns as soon as that is done,
+  //! allowing the client to continue or terminate. Writing the minidump and its
+  //! attachments to the database and to the log, and notifying the upload
+  //! thread, then happen on a separate thread. \a local_report_id is still
+  //! set by HandleException(), but the report may not be complete in the
+  //! database yet. Reports that are pending when this object is destroyed are
+  //! finished before its destructor returns.
+  //!
+  //! This has no effect when minidumps are not written to the database.
+  void SetDeferReportWriting(bool defer_report_writing);
+
+  //! \brief Where micro dumps go, and how many crashes get a full report.
+  //!
+  //! A micro dump is a minidump holding only the exception, the thread it
+  //! occurred on with the lowest part of its stack, the modules, and the
+  //! annotations. See MinidumpFileWriter::InitializeMicroDumpFromSnapshot().
+  struct MicroDumpOptions {
+    //! \brief The database to write a micro dump of each crash to, or
+    //!     `nullptr` to write none. Weak.
+    CrashReportDatabase* database = nullptr;
+
+    //! \brief The upload thread to notify when a micro dump is written into
+    //!     #database, or `nullptr` to skip upload. Weak.
+    CrashReportUploadThread* upload_thread = nullptr;
+
+    //! \brief The most of the crashing thread’s stack to store.
+    size_t max_stack_size = 16 * 1024;
+
+    //! \brief The percentage of crashes, chosen at random, that a full report
+    //!     is written for in addition to a micro dump. A full report is
+    //!     written for every crash when #database is `nullptr`.
+    int full_report_percentage = 100;
+  };
+
+  //! \brief Sets whether micro dumps are written, and how full reports are
+  //!     sampled when they are.
+  //!
+  //! Micro dumps are written and committed while the client is suspended,
+  //! before any full report, even if report writing is deferred by
+  //! SetDeferReportWriting(). They’re small enough that this doesn’t hold the
+  //! client for long, and it lets every crash be counted as soon as possible.
+  //! When no full report is written for a crash, \a local_report_id given to
+  //! HandleException() is set to the micro dump’s ID.
+  void SetMicroDumpOptions(const MicroDumpOptions& options) {
+    micro_dump_options_ = options;
+  }
+
+  //! \brief Sets the sampler that decides which full reports carry a full
+  //!     dump.
+  //!
+  //! A crash that the sampler doesn’t choose for a full dump still gets a
+  //! report, in all of the places that it otherwise would, but its minidump
+  //! leaves out indirectly referenced memory, extra memory ranges, and full
+  //! memory, and the report carries a #kReducedDumpAnnotation process
+  //! annotation. Micro dumps are unaffected, and sampling applies only to
+  //! crashes that get a full report after SetMicroDumpOptions() sampling.
+  //!
+  //! \param[in] dump_sampler The sampler, or `nullptr` to write a full dump
+  //!     for every report. Weak.
+  void SetDumpSampler(DumpSampler* dump_sampler) {
+    dump_sampler_ = dump_sampler;
+  }
+
+  //! \brief Sets the detector that recognizes crash loops before a crash is
+  //!     captured.
+  //!
+  //! Each crash’s signature is computed by CrashLoopSignature() before the
+  //! client is captured, which reads little more than the signal and the
+  //! client’s mappings. Dumps requested without a crash are never skipped. A
+  //! crash that the detector skips gets no full report. If
+  //! SetMicroDumpOptions() enabled micro dumps, it still gets one, captured
+  //! without full memory. Otherwise, nothing more is read from the client. The
+  //! reports of the next crash with the signature that is captured carry a
+  //! #kCrashLoopSkippedAnnotation process annotation counting the crashes
+  //! skipped.
+  //!
+  //! \param[in] crash_loop_detector The detector, or `nullptr` to capture every
+  //!     crash. Weak.
+  void SetCrashLoopDetector(CrashLoopDetector* crash_loop_detector) {
+    crash_loop_detector_ = crash_loop_detector;
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  //! \brief Sets a socket that minidumps are handed off to in memory.
+  //!
+  //! For each full report, the minidump is written to a memfd, and the memfd
+  //! is sent to the `AF_UNIX` `SOCK_SEQPACKET` socket bound to \a socket_path
+  //! with an ExceptionHandlerProtocol::MinidumpHandoffMessage. The minidump is
+  //! written uncompressed, and the connection is made anew for each report, so
+  //! the consumer may be restarted while the handler runs.
+  //!
+  //! The crashing client waits while its minidump is handed off, so a consumer
+  //! that doesn’t accept the connection and the message within a short time
+  //! is skipped for that report.
+  //!
+  //! This is in addition to writing the minidump to the database or the log
+  //! if either was requested at construction. To keep minidumps off the disk
+  //! entirely, construct this object with neither.
+  //!
+  //! \param[in] socket_path The consumer’s socket, or an empty path to stop
+  //!     handing minidumps off.
+  void SetMinidumpConsumerSocket(const base::FilePath& socket_path) {
+    minidump_consumer_socket_ = socket_path;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 
  private:
+  // A report whose minidump has been serialized, but not written to the
+  // database.
+  struct DeferredReport {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    StringFile minidump;
+    const ClientProfile* profile;  // weak
+    bool write_minidump_to_log;
+  };
+
+  class ReportWriterThread;
+
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
       const ExceptionHandlerProtocol::ClientInformation& info,
       uid_t client_uid,
       VMAddress requesting_thread_stack_address,
       pid_t* requesting_thread_id,
+      CaptureTimings* capture_timings,
       UUID* local_report_id = nullptr);
 
+  const ClientProfile& ProfileForClient(
+      const ProcessSnapshotLinux& process_snapshot) const;
   bool WriteMinidumpToDatabase(ProcessSnapshotLinux* process_snapshot,
                                ProcessSnapshotSanitized* sanitized_snapshot,
+                               const ClientProfile& profile,
                                bool write_minidump_to_log,
+                               bool full_dump,
+                               CaptureTimings* capture_timings,
                                UUID* local_report_id);
+  bool WriteMicroDumpToDatabase(ProcessSnapshotLinux* process_snapshot,
+                                ProcessSnapshotSanitized* sanitized_snapshot,
+                                UUID* local_report_id);
+  bool FinishReport(std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+                    const ClientProfile& profile,
+                    bool write_minidump_to_log,
+                    UUID* local_report_id);
+  void RunReportWriterThread();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  bool HandOffMinidump(ProcessSnapshotLinux* process_snapshot,
+                       ProcessSnapshotSanitized* sanitized_snapshot,
+                       bool written_to_database,
+                       bool full_dump,
+                       CaptureTimings* capture_timings);
+#endif
   bool WriteMinidumpToLog(ProcessSnapshotLinux* process_snapshot,
-                          ProcessSnapshotSanitized* sanitized_snapshot);
+                          ProcessSnapshotSanitized* sanitized_snapshot,
+                          bool full_dump,
+                          CaptureTimings* capture_timings);
 
-  CrashReportDatabase* database_;  // weak
-  CrashReportUploadThread* upload_thread_;  // weak
+  // The database and upload thread given to the constructor, for clients
+  // without a profile of their own.
+  ClientProfile default_profile_;
+  const std::map<std::string, ClientProfile>* client_profiles_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const std::vector<base::FilePath>* attachments_;  // weak
   bool write_minidump_to_database_;
   bool write_minidump_to_log_;
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  UserStreamDataSourceOptions user_stream_data_source_options_;
+  size_t module_initialization_threads_;
+  size_t module_memory_cache_pages_;
+  uint64_t capture_time_limit_ns_;
+  ProcessSnapshotLinux::StackCaptureOptions stack_capture_options_;
+  const ShallowModuleFilter* shallow_module_filter_;  // weak
+  ProcessSnapshotLinux::FullMemoryOptions full_memory_options_;
+  size_t compression_threads_;
+  bool compress_minidumps_;
+  bool deduplicate_thread_stacks_;
+  size_t max_listed_threads_;
+  MicroDumpOptions micro_dump_options_;
+  DumpSampler* dump_sampler_;  // weak
+  CrashLoopDetector* crash_loop_detector_;  // weak
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  base::FilePath minidump_consumer_socket_;
+#endif
+
+  // Reused across snapshots of different clients.
+  ModuleMetadataCache module_metadata_cache_;
+
+  // Used when report writing is deferred.
+  std::unique_ptr<ReportWriterThread> report_writer_thread_;
+  Semaphore deferred_reports_semaphore_;
+
+  // Guards deferred_reports_ and report_writer_stopping_.
+  base::Lock deferred_reports_lock_;
+  std::deque<std::unique_ptr<DeferredReport>> deferred_reports_;
+  bool report_writer_stopping_;
 };
 
 }  // namespace crashpad
@@ -29,6 +29,7 @@
 #include "snapshot/minidump/process_snapshot_minidump.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
 #include "util/file/file_writer.h"
+#include "util/file/pipelined_file_writer.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/ptrace_client.h"
 #include "util/misc/metrics.h"
@@ -107,8 +108,20 @@ bool WriteAnnotationsAndMinidump(
     LOG(ERROR) << "Failed to get minidump start offset";
     return false;
   }
-  if (!minidump.WriteEverything(&file_writer)) {
-    return false;
+  {
+    // The memfd is filled on another thread, so that reading the client’s
+    // memory for one block overlaps with copying the previous block into the
+    // memfd. crash_reporter reads the memfd as a whole once it is spawned, and
+    // needs the minidump’s length before its data, so the minidump can’t be
+    // streamed to it while crash_reporter is already running. Smaller blocks
+    // than the default keep the extra memory small on low-memory devices,
+    // where the memfd already holds the whole minidump.
+    constexpr size_t kPipelineBlockSize = 256 * 1024;
+    PipelinedFileWriter pipelined_writer(&file_writer, kPipelineBlockSize);
+    if (!minidump.WriteEverything(&pipelined_writer) ||
+        !pipelined_writer.Flush()) {
+      return false;
+    }
   }
   crashpad::FileOffset dump_end_offset = file_writer.Seek(0, SEEK_CUR);
   if (dump_end_offset < 0) {
@@ -137,7 +150,16 @@ CrosCrashReportExceptionHandler::CrosCrashReportExceptionHandler(
     : database_(database),
       process_annotations_(process_annotations),
       user_stream_data_sources_(user_stream_data_sources),
-      always_allow_feedback_(false) {}
+      user_stream_data_source_options_(),
+      always_allow_feedback_(false),
+      module_initialization_threads_(0),
+      module_memory_cache_pages_(0),
+      capture_time_limit_ns_(0),
+      stack_capture_options_(),
+      shallow_module_filter_(nullptr),
+      full_memory_options_(),
+      deduplicate_thread_stacks_(false),
+      module_metadata_cache_() {}
 
 CrosCrashReportExceptionHandler::~CrosCrashReportExceptionHandler() = default;
 
@@ -147,7 +169,8 @@ bool CrosCrashReportExceptionHandler::HandleException(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const CrashContextRegion* crash_context) {
   Metrics::ExceptionEncountered();
 
   DirectPtraceConnection connection;
@@ -156,6 +179,10 @@ bool CrosCrashReportExceptionHandler::HandleException(
         Metrics::CaptureResult::kDirectPtraceFailed);
     return false;
   }
+  if (crash_context) {
+    crash_context->AddToMemory(connection.Memory());
+    crash_context->AddThreadContexts(&connection);
+  }
 
   return HandleExceptionWithConnection(&connection,
                                        info,
@@ -170,7 +197,8 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const CrashContextRegion* crash_context) {
   Metrics::ExceptionEncountered();
 
   PtraceClient client;
@@ -179,6 +207,10 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
         Metrics::CaptureResult::kBrokeredPtraceFailed);
     return false;
   }
+  if (crash_context) {
+    crash_context->AddToMemory(client.Memory());
+    crash_context->AddThreadContexts(&client);
+  }
 
   return HandleExceptionWithConnection(
       &client, info, client_uid, 0, nullptr, local_report_id);
@@ -199,6 +231,13 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
                        client_uid,
                        requesting_thread_stack_address,
                        requesting_thread_id,
+                       module_initialization_threads_,
+                       module_memory_cache_pages_,
+                       capture_time_limit_ns_,
+                       stack_capture_options_,
+                       &module_metadata_cache_,
+                       shallow_module_filter_,
+                       full_memory_options_,
                        &process_snapshot,
                        &sanitized_snapshot)) {
     return false;
@@ -225,7 +264,19 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
 
   MinidumpFileWriter minidump;
   minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.SetDeduplicateThreadStacks(deduplicate_thread_stacks_);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_data_source_options_);
+  if (!sanitized_snapshot) {
+    std::vector<const MemorySnapshot*> full_memory =
+        process_snapshot->FullMemory();
+    if (!full_memory.empty()) {
+      minidump.AddFullMemory(full_memory,
+                             process_snapshot->FullMemoryZeroRanges());
+    }
+  }
 
   FileWriter file_writer;
   if (!file_writer.OpenMemfd(base::FilePath("minidump"))) {
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CROS_CRASH_REPORT_EXCEPTION_HANDLER_H_
 #define CRASHPAD_HANDLER_LINUX_CROS_CRASH_REPORT_EXCEPTION_HANDLER_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <map>
@@ -23,6 +24,8 @@
 #include "client/crash_report_database.h"
 #include "handler/linux/exception_handler_server.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/module_metadata_cache.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
@@ -73,17 +76,52 @@ class CrosCrashReportExceptionHandler
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const CrashContextRegion* crash_context =
+                           nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override;
+      UUID* local_report_id = nullptr,
+      const CrashContextRegion* crash_context = nullptr) override;
 
   void SetDumpDir(const base::FilePath& dump_dir) { dump_dir_ = dump_dir; }
   void SetAlwaysAllowFeedback() { always_allow_feedback_ = true; }
+  void SetModuleInitializationThreads(size_t threads) {
+    module_initialization_threads_ = threads;
+  }
+  void SetModuleMemoryCachePages(size_t pages) {
+    module_memory_cache_pages_ = pages;
+  }
+  void SetCaptureTimeLimit(uint64_t time_limit_ns) {
+    capture_time_limit_ns_ = time_limit_ns;
+  }
+  void SetUserStreamDataSourceOptions(
+      const UserStreamDataSourceOptions& options) {
+    user_stream_data_source_options_ = options;
+  }
+  void SetStackCaptureOptions(
+      const ProcessSnapshotLinux::StackCaptureOptions& options) {
+    stack_capture_options_ = options;
+  }
+
+  //! \brief Sets a filter selecting modules to capture shallowly. See
+  //!     ProcessSnapshotLinux::SetShallowModuleFilter().
+  //!
+  //! This object does not take ownership of \a filter, which must outlive it.
+  void SetShallowModuleFilter(const ShallowModuleFilter* filter) {
+    shallow_module_filter_ = filter;
+  }
+  void SetFullMemoryOptions(
+      const ProcessSnapshotLinux::FullMemoryOptions& options) {
+    full_memory_options_ = options;
+  }
+  void SetDeduplicateThreadStacks(bool deduplicate_thread_stacks) {
+    deduplicate_thread_stacks_ = deduplicate_thread_stacks;
+  }
  private:
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
@@ -96,8 +134,19 @@ class CrosCrashReportExceptionHandler
   CrashReportDatabase* database_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  UserStreamDataSourceOptions user_stream_data_source_options_;
   base::FilePath dump_dir_;
   bool always_allow_feedback_;
+  size_t module_initialization_threads_;
+  size_t module_memory_cache_pages_;
+  uint64_t capture_time_limit_ns_;
+  ProcessSnapshotLinux::StackCaptureOptions stack_capture_options_;
+  const ShallowModuleFilter* shallow_module_filter_;  // weak
+  ProcessSnapshotLinux::FullMemoryOptions full_memory_options_;
+  bool deduplicate_thread_stacks_;
+
+  // Reused across snapshots of different clients.
+  ModuleMetadataCache module_metadata_cache_;
 };
 
 }  // namespace crashpad
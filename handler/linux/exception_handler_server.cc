@@ -15,7 +15,9 @@
 #include "handler/linux/exception_handler_server.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <linux/capability.h>
+#include <poll.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/socket.h>
@@ -23,6 +25,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "base/check_op.h"
@@ -36,6 +39,7 @@
 #include "util/linux/proc_task_reader.h"
 #include "util/linux/socket.h"
 #include "util/misc/as_underlying_type.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -126,22 +130,101 @@ int tgkill(pid_t pid, pid_t tid, int signo) {
   return syscall(SYS_tgkill, pid, tid, signo);
 }
 
-void SendSIGCONT(pid_t pid, pid_t tid) {
-  if (tid > 0) {
-    if (tgkill(pid, tid, ExceptionHandlerProtocol::kDumpDoneSignal) != 0) {
-      PLOG(ERROR) << "tgkill";
+// Returns a pidfd referring to the client process pid, or an invalid handle if
+// the kernel doesn’t support pidfds (before Linux 5.3) or the process has
+// already exited.
+ScopedFileHandle OpenClientPidfd(pid_t pid) {
+#if defined(__NR_pidfd_open)
+  ScopedFileHandle pidfd(syscall(__NR_pidfd_open, pid, 0));
+  if (!pidfd.is_valid() && errno != ENOSYS && errno != ESRCH) {
+    PLOG(WARNING) << "pidfd_open";
+  }
+  return pidfd;
+#else
+  return ScopedFileHandle();
+#endif
+}
+
+// Returns true if pidfd refers to a process that has exited. An invalid pidfd
+// is treated as referring to a live process, so that callers fall back to
+// signaling by pid.
+bool ClientHasExited(int pidfd) {
+  if (pidfd < 0) {
+    return false;
+  }
+  pollfd poll_fd = {};
+  poll_fd.fd = pidfd;
+  poll_fd.events = POLLIN;
+  return HANDLE_EINTR(poll(&poll_fd, 1, 0)) == 1 &&
+         (poll_fd.revents & POLLIN) != 0;
+}
+
+// Sends kDumpDoneSignal to thread tid of the client process pid.
+//
+// When pidfd refers to the client, the thread is signaled through a pidfd of
+// its own, opened while the client is known to be running, with
+// pidfd_send_signal(). The requesting thread waits for the signal, so it only
+// exits along with the rest of the client, and the signal can’t reach a
+// process that has reused pid or tid after the client exited. Without a pidfd
+// for the client, or before Linux 6.9 where thread pidfds aren’t supported,
+// the thread is signaled with tgkill(), which can’t rule that out.
+void SignalClientThread(int pidfd, pid_t pid, pid_t tid) {
+#if defined(__NR_pidfd_open) && defined(__NR_pidfd_send_signal)
+  if (pidfd >= 0) {
+    // PIDFD_THREAD, which may not be defined in older headers.
+    constexpr unsigned int kPidfdThread = O_EXCL;
+    ScopedFileHandle thread_pidfd(
+        syscall(__NR_pidfd_open, tid, kPidfdThread));
+    if (thread_pidfd.is_valid()) {
+      if (ClientHasExited(pidfd)) {
+        return;
+      }
+      if (syscall(__NR_pidfd_send_signal,
+                  thread_pidfd.get(),
+                  ExceptionHandlerProtocol::kDumpDoneSignal,
+                  nullptr,
+                  0) != 0) {
+        PLOG(ERROR) << "pidfd_send_signal";
+      }
+      return;
+    }
+    if (errno == ESRCH) {
+      // The thread has already exited.
+      return;
     }
+    if (errno != EINVAL && errno != ENOSYS) {
+      PLOG(WARNING) << "pidfd_open";
+    }
+  }
+#endif  // __NR_pidfd_open && __NR_pidfd_send_signal
+
+  if (tgkill(pid, tid, ExceptionHandlerProtocol::kDumpDoneSignal) != 0) {
+    PLOG(ERROR) << "tgkill";
+  }
+}
+
+void SendSIGCONT(int pidfd, pid_t pid, pid_t tid) {
+  // An exited client has nothing left to wake, and its pid may already have
+  // been reused by an unrelated process.
+  if (ClientHasExited(pidfd)) {
     return;
   }
 
+  if (tid > 0) {
+    SignalClientThread(pidfd, pid, tid);
+    return;
+  }
+
+  // The requesting thread blocks kDumpDoneSignal while it waits for it, so a
+  // process-directed signal may be consumed by one of its other threads
+  // instead. Without the requesting thread’s ID, every thread must be
+  // signaled.
   std::vector<pid_t> threads;
   if (!ReadThreadIDs(pid, &threads)) {
     return;
   }
   for (const auto& thread : threads) {
-    if (tgkill(pid, thread, ExceptionHandlerProtocol::kDumpDoneSignal) != 0) {
-      PLOG(ERROR) << "tgkill";
-    }
+    SignalClientThread(pidfd, pid, thread);
   }
 }
 
@@ -237,13 +320,38 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
 
 }  // namespace
 
+class ExceptionHandlerServer::DumpThread : public Thread {
+ public:
+  explicit DumpThread(ExceptionHandlerServer* server) : server_(server) {}
+
+  DumpThread(const DumpThread&) = delete;
+  DumpThread& operator=(const DumpThread&) = delete;
+
+  ~DumpThread() override {}
+
+ private:
+  void ThreadMain() override { server_->RunDumpThread(); }
+
+  ExceptionHandlerServer* server_;  // weak
+};
+
 ExceptionHandlerServer::ExceptionHandlerServer()
     : clients_(),
+      next_event_generation_(1),
       shutdown_event_(),
+      listen_event_(),
       strategy_decider_(new PtraceStrategyDeciderImpl()),
       delegate_(nullptr),
       pollfd_(),
-      keep_running_(true) {}
+      keep_running_(true),
+      dump_threads_(),
+      dump_complete_event_(),
+      pending_dumps_semaphore_(0),
+      dumps_lock_(),
+      pending_dumps_(),
+      completed_dumps_(),
+      dump_threads_stopping_(false),
+      concurrent_dump_limit_(1) {}
 
 ExceptionHandlerServer::~ExceptionHandlerServer() = default;
 
@@ -252,41 +360,52 @@ void ExceptionHandlerServer::SetPtraceStrategyDecider(
   strategy_decider_ = std::move(decider);
 }
 
+void ExceptionHandlerServer::SetConcurrentDumpLimit(size_t limit) {
+  DCHECK(!delegate_);
+  concurrent_dump_limit_ = std::max(limit, size_t{1});
+}
+
 bool ExceptionHandlerServer::InitializeWithClient(ScopedFileHandle sock,
                                                   bool multiple_clients) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  pollfd_.reset(epoll_create1(EPOLL_CLOEXEC));
-  if (!pollfd_.is_valid()) {
-    PLOG(ERROR) << "epoll_create1";
+  if (!InitializeEventLoop()) {
     return false;
   }
 
-  shutdown_event_ = std::make_unique<Event>();
-  shutdown_event_->type = Event::Type::kShutdown;
-  shutdown_event_->fd.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
-  if (!shutdown_event_->fd.is_valid()) {
-    PLOG(ERROR) << "eventfd";
+  if (!InstallClientSocket(std::move(sock),
+                           multiple_clients ? Event::Type::kSharedSocketMessage
+                                            : Event::Type::kClientMessage)) {
     return false;
   }
 
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ExceptionHandlerServer::InitializeWithListeningSocket(
+    ScopedFileHandle listen_sock) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!InitializeEventLoop()) {
+    return false;
+  }
+
+  listen_event_ = std::make_unique<Event>();
+  listen_event_->type = Event::Type::kListenSocket;
+  listen_event_->fd = std::move(listen_sock);
+
   epoll_event poll_event;
   poll_event.events = EPOLLIN;
-  poll_event.data.ptr = shutdown_event_.get();
+  poll_event.data.ptr = listen_event_.get();
   if (epoll_ctl(pollfd_.get(),
                 EPOLL_CTL_ADD,
-                shutdown_event_->fd.get(),
+                listen_event_->fd.get(),
                 &poll_event) != 0) {
     PLOG(ERROR) << "epoll_ctl";
     return false;
   }
 
-  if (!InstallClientSocket(std::move(sock),
-                           multiple_clients ? Event::Type::kSharedSocketMessage
-                                            : Event::Type::kClientMessage)) {
-    return false;
-  }
-
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -295,12 +414,19 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   delegate_ = delegate;
 
-  while (keep_running_ && clients_.size() > 0) {
+  if (concurrent_dump_limit_ > 1 && !StartDumpThreads()) {
+    LOG(WARNING) << "handling crash dump requests serially";
+    concurrent_dump_limit_ = 1;
+  }
+
+  // A server with a listening socket keeps running after its last client
+  // disconnects, to serve clients that have yet to connect.
+  while (keep_running_ && (clients_.size() > 0 || listen_event_)) {
     epoll_event poll_event;
     int res = HANDLE_EINTR(epoll_wait(pollfd_.get(), &poll_event, 1, -1));
     if (res < 0) {
       PLOG(ERROR) << "epoll_wait";
-      return;
+      break;
     }
     DCHECK_EQ(res, 1);
 
@@ -310,10 +436,18 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
         LogSocketError(eventp->fd.get());
       }
       keep_running_ = false;
+    } else if (eventp->type == Event::Type::kDumpComplete) {
+      uint64_t value;
+      LoggingReadFileExactly(eventp->fd.get(), &value, sizeof(value));
+      HandleCompletedDumps();
+    } else if (eventp->type == Event::Type::kListenSocket) {
+      AcceptClient();
     } else {
       HandleEvent(eventp, poll_event.events);
     }
   }
+
+  StopDumpThreads();
 }
 
 void ExceptionHandlerServer::Stop() {
@@ -327,6 +461,8 @@ void ExceptionHandlerServer::Stop() {
 void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   DCHECK_NE(AsUnderlyingType(event->type),
             AsUnderlyingType(Event::Type::kShutdown));
+  DCHECK_NE(AsUnderlyingType(event->type),
+            AsUnderlyingType(Event::Type::kDumpComplete));
 
   if (event_type & EPOLLERR) {
     LogSocketError(event->fd.get());
@@ -350,6 +486,49 @@ void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   return;
 }
 
+bool ExceptionHandlerServer::InitializeEventLoop() {
+  pollfd_.reset(epoll_create1(EPOLL_CLOEXEC));
+  if (!pollfd_.is_valid()) {
+    PLOG(ERROR) << "epoll_create1";
+    return false;
+  }
+
+  shutdown_event_ = std::make_unique<Event>();
+  shutdown_event_->type = Event::Type::kShutdown;
+  shutdown_event_->fd.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (!shutdown_event_->fd.is_valid()) {
+    PLOG(ERROR) << "eventfd";
+    return false;
+  }
+
+  epoll_event poll_event;
+  poll_event.events = EPOLLIN;
+  poll_event.data.ptr = shutdown_event_.get();
+  if (epoll_ctl(pollfd_.get(),
+                EPOLL_CTL_ADD,
+                shutdown_event_->fd.get(),
+                &poll_event) != 0) {
+    PLOG(ERROR) << "epoll_ctl";
+    return false;
+  }
+
+  return true;
+}
+
+void ExceptionHandlerServer::AcceptClient() {
+  ScopedFileHandle client(HANDLE_EINTR(
+      accept4(listen_event_->fd.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+  if (!client.is_valid()) {
+    // A failure to accept one client, such as one that disconnected while
+    // waiting to be accepted, shouldn’t stop the server from serving others.
+    PLOG(ERROR) << "accept4";
+    return;
+  }
+
+  // Each connection is private to the client that made it.
+  InstallClientSocket(std::move(client), Event::Type::kClientMessage);
+}
+
 bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
                                                  Event::Type type) {
   // The handler may not have permission to set SO_PASSCRED on the socket, but
@@ -375,6 +554,7 @@ bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
   auto event = std::make_unique<Event>();
   event->type = type;
   event->fd.reset(socket.release());
+  event->generation = next_event_generation_++;
 
   Event* eventp = event.get();
 
@@ -415,22 +595,62 @@ bool ExceptionHandlerServer::UninstallClientSocket(Event* event) {
 bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
   ExceptionHandlerProtocol::ClientToServerMessage message;
   ucred creds;
+  std::vector<ScopedFileHandle> fds;
   if (!UnixCredentialSocket::RecvMsg(
-          event->fd.get(), &message, sizeof(message), &creds)) {
+          event->fd.get(), &message, sizeof(message), &creds, &fds)) {
     return false;
   }
 
+  std::unique_ptr<CrashContextRegion> crash_context;
+  if (message.type ==
+          ExceptionHandlerProtocol::ClientToServerMessage::
+              kTypeCrashDumpRequest &&
+      fds.size() == 1) {
+    // Without a valid region, the client is read as usual.
+    crash_context = std::make_unique<CrashContextRegion>();
+    if (!crash_context->InitializeFromFD(std::move(fds[0]))) {
+      crash_context.reset();
+    }
+  }
+
+  // Clients sharing a socket are woken by signal rather than by a reply, so
+  // hold a pidfd that keeps referring to the requesting process even if it
+  // exits and its pid is reused while the request is handled.
+  const bool multiple_clients =
+      event->type == Event::Type::kSharedSocketMessage;
+  ScopedFileHandle client_pidfd;
+  if (message.type == ExceptionHandlerProtocol::ClientToServerMessage::
+                          kTypeCrashDumpRequest &&
+      multiple_clients) {
+    client_pidfd = OpenClientPidfd(creds.pid);
+  }
+
   switch (message.type) {
     case ExceptionHandlerProtocol::ClientToServerMessage::kTypeCheckCredentials:
       return SendCredentials(event->fd.get());
 
     case ExceptionHandlerProtocol::ClientToServerMessage::kTypeCrashDumpRequest:
-      return HandleCrashDumpRequest(
-          creds,
-          message.client_info,
-          message.requesting_thread_stack_address,
-          event->fd.get(),
-          event->type == Event::Type::kSharedSocketMessage);
+      if (concurrent_dump_limit_ > 1) {
+        auto request = std::make_unique<DumpRequest>();
+        request->creds = creds;
+        request->client_info = message.client_info;
+        request->requesting_thread_stack_address =
+            message.requesting_thread_stack_address;
+        request->crash_context = std::move(crash_context);
+        request->client_sock = event->fd.get();
+        request->event_generation = event->generation;
+        request->client_pidfd = std::move(client_pidfd);
+        request->multiple_clients = multiple_clients;
+        request->result = false;
+        return DispatchCrashDumpRequest(std::move(request));
+      }
+      return HandleCrashDumpRequest(creds,
+                                    message.client_info,
+                                    message.requesting_thread_stack_address,
+                                    event->fd.get(),
+                                    client_pidfd.get(),
+                                    multiple_clients,
+                                    crash_context.get());
   }
 
   DCHECK(false);
@@ -443,22 +663,30 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
     const ExceptionHandlerProtocol::ClientInformation& client_info,
     VMAddress requesting_thread_stack_address,
     int client_sock,
-    bool multiple_clients) {
+    int client_pidfd,
+    bool multiple_clients,
+    const CrashContextRegion* crash_context) {
   pid_t client_process_id = creds.pid;
   pid_t requesting_thread_id = -1;
   uid_t client_uid = creds.uid;
 
+  // A client that exited while its request was waiting can neither be dumped
+  // nor woken.
+  if (multiple_clients && ClientHasExited(client_pidfd)) {
+    return true;
+  }
+
   switch (
       strategy_decider_->ChooseStrategy(client_sock, multiple_clients, creds)) {
     case PtraceStrategyDecider::Strategy::kError:
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        SendSIGCONT(client_pidfd, client_process_id, requesting_thread_id);
       }
       return false;
 
     case PtraceStrategyDecider::Strategy::kNoPtrace:
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        SendSIGCONT(client_pidfd, client_process_id, requesting_thread_id);
         return true;
       }
       return SendMessageToClient(
@@ -471,9 +699,11 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
                                  client_uid,
                                  client_info,
                                  requesting_thread_stack_address,
-                                 &requesting_thread_id);
+                                 &requesting_thread_id,
+                                 nullptr,
+                                 crash_context);
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        SendSIGCONT(client_pidfd, client_process_id, requesting_thread_id);
         return true;
       }
       break;
@@ -481,8 +711,12 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
 
     case PtraceStrategyDecider::Strategy::kUseBroker:
       DCHECK(!multiple_clients);
-      delegate_->HandleExceptionWithBroker(
-          client_process_id, client_uid, client_info, client_sock);
+      delegate_->HandleExceptionWithBroker(client_process_id,
+                                           client_uid,
+                                           client_info,
+                                           client_sock,
+                                           nullptr,
+                                           crash_context);
       break;
   }
 
@@ -491,4 +725,166 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
       ExceptionHandlerProtocol::ServerToClientMessage::kTypeCrashDumpComplete);
 }
 
+bool ExceptionHandlerServer::StartDumpThreads() {
+  DCHECK(dump_threads_.empty());
+
+  dump_complete_event_ = std::make_unique<Event>();
+  dump_complete_event_->type = Event::Type::kDumpComplete;
+  dump_complete_event_->fd.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (!dump_complete_event_->fd.is_valid()) {
+    PLOG(ERROR) << "eventfd";
+    dump_complete_event_.reset();
+    return false;
+  }
+
+  epoll_event poll_event;
+  poll_event.events = EPOLLIN;
+  poll_event.data.ptr = dump_complete_event_.get();
+  if (epoll_ctl(pollfd_.get(),
+                EPOLL_CTL_ADD,
+                dump_complete_event_->fd.get(),
+                &poll_event) != 0) {
+    PLOG(ERROR) << "epoll_ctl";
+    dump_complete_event_.reset();
+    return false;
+  }
+
+  dump_threads_.reserve(concurrent_dump_limit_);
+  for (size_t index = 0; index < concurrent_dump_limit_; ++index) {
+    dump_threads_.push_back(std::make_unique<DumpThread>(this));
+    dump_threads_.back()->Start();
+  }
+  return true;
+}
+
+void ExceptionHandlerServer::StopDumpThreads() {
+  if (dump_threads_.empty()) {
+    return;
+  }
+
+  // Requests that are still pending are handled before the threads exit.
+  {
+    base::AutoLock lock(dumps_lock_);
+    dump_threads_stopping_ = true;
+  }
+  for (size_t index = 0; index < dump_threads_.size(); ++index) {
+    pending_dumps_semaphore_.Signal();
+  }
+  for (auto& thread : dump_threads_) {
+    thread->Join();
+  }
+  dump_threads_.clear();
+
+  HandleCompletedDumps();
+}
+
+bool ExceptionHandlerServer::DispatchCrashDumpRequest(
+    std::unique_ptr<DumpRequest> request) {
+  // A client with a private socket waits for a reply before sending anything
+  // else, so stop watching its socket until the request has been handled. This
+  // also ensures that the socket stays open while a DumpThread is using it.
+  // Shared sockets continue to be watched so that other clients can be
+  // serviced, so the DumpThread is given its own descriptor for the socket,
+  // which stays open if the shared socket is uninstalled. The main loop never
+  // writes to a shared socket, and the DumpThread only hands it to the
+  // PtraceStrategyDecider, which doesn’t read from it.
+  if (request->multiple_clients) {
+    request->shared_sock.reset(
+        fcntl(request->client_sock, F_DUPFD_CLOEXEC, 0));
+    if (!request->shared_sock.is_valid()) {
+      PLOG(ERROR) << "fcntl";
+      return false;
+    }
+  } else if (epoll_ctl(
+                 pollfd_.get(), EPOLL_CTL_DEL, request->client_sock, nullptr) !=
+             0) {
+    PLOG(ERROR) << "epoll_ctl";
+    return false;
+  }
+
+  {
+    base::AutoLock lock(dumps_lock_);
+    pending_dumps_.push_back(std::move(request));
+  }
+  pending_dumps_semaphore_.Signal();
+  return true;
+}
+
+void ExceptionHandlerServer::RunDumpThread() {
+  while (true) {
+    pending_dumps_semaphore_.Wait();
+
+    std::unique_ptr<DumpRequest> request;
+    {
+      base::AutoLock lock(dumps_lock_);
+      if (pending_dumps_.empty()) {
+        DCHECK(dump_threads_stopping_);
+        return;
+      }
+      request = std::move(pending_dumps_.front());
+      pending_dumps_.pop_front();
+    }
+
+    request->result =
+        HandleCrashDumpRequest(request->creds,
+                               request->client_info,
+                               request->requesting_thread_stack_address,
+                               request->multiple_clients
+                                   ? request->shared_sock.get()
+                                   : request->client_sock,
+                               request->client_pidfd.get(),
+                               request->multiple_clients,
+                               request->crash_context.get());
+
+    {
+      base::AutoLock lock(dumps_lock_);
+      completed_dumps_.push_back(std::move(request));
+    }
+    uint64_t value = 1;
+    LoggingWriteFile(dump_complete_event_->fd.get(), &value, sizeof(value));
+  }
+}
+
+void ExceptionHandlerServer::HandleCompletedDumps() {
+  std::vector<std::unique_ptr<DumpRequest>> completed_dumps;
+  {
+    base::AutoLock lock(dumps_lock_);
+    std::swap(completed_dumps, completed_dumps_);
+  }
+
+  for (const auto& request : completed_dumps) {
+    // A shared socket may have been uninstalled while the request was being
+    // handled, and its descriptor given to a new client. Only a socket from
+    // the same generation is the one the request came from.
+    auto iterator = clients_.find(request->client_sock);
+    if (iterator == clients_.end() ||
+        iterator->second->generation != request->event_generation) {
+      DCHECK(request->multiple_clients);
+      continue;
+    }
+    Event* event = iterator->second.get();
+
+    if (request->multiple_clients) {
+      if (!request->result) {
+        UninstallClientSocket(event);
+      }
+      continue;
+    }
+
+    if (request->result) {
+      epoll_event poll_event;
+      poll_event.events = EPOLLIN | EPOLLRDHUP;
+      poll_event.data.ptr = event;
+      if (epoll_ctl(pollfd_.get(),
+                    EPOLL_CTL_ADD,
+                    request->client_sock,
+                    &poll_event) == 0) {
+        continue;
+      }
+      PLOG(ERROR) << "epoll_ctl";
+    }
+    clients_.erase(iterator);
+  }
+}
+
 }  // namespace crashpad
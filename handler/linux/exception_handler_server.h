@@ -19,14 +19,19 @@
 #include <sys/socket.h>
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
+#include "base/synchronization/lock.h"
 #include "util/file/file_io.h"
+#include "util/linux/crash_context_region.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
+#include "util/synchronization/semaphore.h"
 
 namespace crashpad {
 
@@ -85,6 +90,9 @@ class ExceptionHandlerServer {
     //!     ID could not be determined. Optional.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] crash_context Memory the client copied at the time of the
+    //!     crash, from which reads of the client should be served where
+    //!     possible. Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleException(
         pid_t client_process_id,
@@ -92,7 +100,8 @@ class ExceptionHandlerServer {
         const ExceptionHandlerProtocol::ClientInformation& info,
         VMAddress requesting_thread_stack_address = 0,
         pid_t* requesting_thread_id = nullptr,
-        UUID* local_report_id = nullptr) = 0;
+        UUID* local_report_id = nullptr,
+        const CrashContextRegion* crash_context = nullptr) = 0;
 
     //! \brief Called on the receipt of a crash dump request from a client for a
     //!     crash that should be mediated by a PtraceBroker.
@@ -103,13 +112,17 @@ class ExceptionHandlerServer {
     //! \param[in] broker_sock A socket connected to the PtraceBroker.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] crash_context Memory the client copied at the time of the
+    //!     crash, from which reads of the client should be served where
+    //!     possible. Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleExceptionWithBroker(
         pid_t client_process_id,
         uid_t client_uid,
         const ExceptionHandlerProtocol::ClientInformation& info,
         int broker_sock,
-        UUID* local_report_id = nullptr) = 0;
+        UUID* local_report_id = nullptr,
+        const CrashContextRegion* crash_context = nullptr) = 0;
 
     virtual ~Delegate() {}
   };
@@ -127,9 +140,24 @@ class ExceptionHandlerServer {
   //! used.
   void SetPtraceStrategyDecider(std::unique_ptr<PtraceStrategyDecider> decider);
 
+  //! \brief Sets the maximum number of crash dump requests to handle at once.
+  //!
+  //! By default, crash dump requests are handled one at a time on the thread
+  //! that calls Run(). If \a limit is greater than 1, Run() instead hands
+  //! requests to up to \a limit worker threads, so that several clients can
+  //! be captured concurrently. A client that shares its socket with other
+  //! clients doesn’t prevent requests from those clients from being handled.
+  //! The Delegate and PtraceStrategyDecider must then tolerate being called
+  //! from several threads at once. Run() doesn’t return until every request
+  //! it has received has been handled.
+  //!
+  //! This method must not be called after Run().
+  void SetConcurrentDumpLimit(size_t limit);
+
   //! \brief Initializes this object.
   //!
-  //! This method must be successfully called before Run().
+  //! Either this method or InitializeWithListeningSocket() must be
+  //! successfully called before Run().
   //!
   //! \param[in] sock A socket on which to receive client requests.
   //! \param[in] multiple_clients `true` if this socket is used by multiple
@@ -138,11 +166,27 @@ class ExceptionHandlerServer {
   //! \return `true` on success. `false` on failure with a message logged.
   bool InitializeWithClient(ScopedFileHandle sock, bool multiple_clients);
 
+  //! \brief Initializes this object to accept connections from clients.
+  //!
+  //! Each client that connects to \a listen_sock is served on its own
+  //! connection, as though it had been passed to InitializeWithClient(). This
+  //! allows a single handler to serve any number of unrelated clients. Clients
+  //! connect with CrashpadClient::SetHandlerPoolSocket().
+  //!
+  //! Either this method or InitializeWithClient() must be successfully called
+  //! before Run().
+  //!
+  //! \param[in] listen_sock A listening socket, such as one created by
+  //!     UnixCredentialSocket::CreateListeningSocket().
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool InitializeWithListeningSocket(ScopedFileHandle listen_sock);
+
   //! \brief Runs the exception-handling server.
   //!
   //! This method must only be called once on an ExceptionHandlerServer object.
   //! This method returns when there are no more client connections or Stop()
-  //! has been called.
+  //! has been called. A server initialized with
+  //! InitializeWithListeningSocket() runs until Stop() is called.
   //!
   //! \param[in] delegate An object to send exceptions to.
   void Run(Delegate* delegate);
@@ -165,13 +209,53 @@ class ExceptionHandlerServer {
       kClientMessage,
 
       // A message from a client on a shared socket connection.
-      kSharedSocketMessage
+      kSharedSocketMessage,
+
+      // A crash dump request handled on a worker thread has completed.
+      kDumpComplete,
+
+      // A client is connecting to the listening socket.
+      kListenSocket
     };
 
     Type type;
     ScopedFileHandle fd;
+
+    // Distinguishes a client socket from any earlier one that was given the
+    // same descriptor. Zero for events that aren't client sockets.
+    uint64_t generation;
   };
 
+  // A crash dump request handed to a worker thread.
+  struct DumpRequest {
+    ucred creds;
+    ExceptionHandlerProtocol::ClientInformation client_info;
+    VMAddress requesting_thread_stack_address;
+    std::unique_ptr<CrashContextRegion> crash_context;
+
+    // The client’s socket, identified by its descriptor and by the
+    // generation of its Event, which may be uninstalled while a request on a
+    // shared socket is handled.
+    int client_sock;
+    uint64_t event_generation;
+
+    // For a client on a shared socket, a duplicate of client_sock for the
+    // worker thread to use, which stays open if the shared socket is
+    // uninstalled.
+    ScopedFileHandle shared_sock;
+
+    // For a client on a shared socket, a pidfd referring to the requesting
+    // process, if the kernel supports them.
+    ScopedFileHandle client_pidfd;
+
+    bool multiple_clients;
+    bool result;
+  };
+
+  class DumpThread;
+
+  bool InitializeEventLoop();
+  void AcceptClient();
   void HandleEvent(Event* event, uint32_t event_type);
   bool InstallClientSocket(ScopedFileHandle socket, Event::Type type);
   bool UninstallClientSocket(Event* event);
@@ -181,14 +265,36 @@ class ExceptionHandlerServer {
       const ExceptionHandlerProtocol::ClientInformation& client_info,
       VMAddress requesting_thread_stack_address,
       int client_sock,
-      bool multiple_clients);
+      int client_pidfd,
+      bool multiple_clients,
+      const CrashContextRegion* crash_context);
+  bool StartDumpThreads();
+  void StopDumpThreads();
+  bool DispatchCrashDumpRequest(std::unique_ptr<DumpRequest> request);
+  void RunDumpThread();
+  void HandleCompletedDumps();
 
   std::unordered_map<int, std::unique_ptr<Event>> clients_;
+  uint64_t next_event_generation_;
   std::unique_ptr<Event> shutdown_event_;
+  std::unique_ptr<Event> listen_event_;
   std::unique_ptr<PtraceStrategyDecider> strategy_decider_;
   Delegate* delegate_;
   ScopedFileHandle pollfd_;
   std::atomic<bool> keep_running_;
+
+  // Used when concurrent_dump_limit_ is greater than 1.
+  std::vector<std::unique_ptr<DumpThread>> dump_threads_;
+  std::unique_ptr<Event> dump_complete_event_;
+  Semaphore pending_dumps_semaphore_;
+
+  // Guards pending_dumps_, completed_dumps_, and dump_threads_stopping_.
+  base::Lock dumps_lock_;
+  std::deque<std::unique_ptr<DumpRequest>> pending_dumps_;
+  std::vector<std::unique_ptr<DumpRequest>> completed_dumps_;
+  bool dump_threads_stopping_;
+
+  size_t concurrent_dump_limit_;
   InitializationStateDcheck initialized_;
 };
 
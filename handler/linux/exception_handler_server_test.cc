@@ -14,7 +14,10 @@
 
 #include "handler/linux/exception_handler_server.h"
 
+#include <string.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include "build/build_config.h"
@@ -22,10 +25,12 @@
 #include "snapshot/linux/process_snapshot_linux.h"
 #include "test/errors.h"
 #include "test/multiprocess.h"
+#include "test/scoped_temp_dir.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/exception_handler_client.h"
 #include "util/linux/ptrace_client.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
+#include "util/linux/socket.h"
 #include "util/misc/uuid.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
@@ -117,7 +122,9 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override {
+                       UUID* local_report_id = nullptr,
+                       const CrashContextRegion* crash_context =
+                           nullptr) override {
     DirectPtraceConnection connection;
     bool connected = connection.Initialize(client_process_id);
     EXPECT_TRUE(connected);
@@ -150,7 +157,8 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override {
+      UUID* local_report_id = nullptr,
+      const CrashContextRegion* crash_context = nullptr) override {
     PtraceClient client;
     bool connected = client.Initialize(broker_sock, client_process_id);
     EXPECT_TRUE(connected);
@@ -376,6 +384,108 @@ TEST_P(ExceptionHandlerServerTest, RequestCrashDumpError) {
   ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kError, false);
 }
 
+TEST_P(ExceptionHandlerServerTest, StopWithClientsConcurrent) {
+  Server()->SetConcurrentDumpLimit(4);
+  ServerThread()->Start();
+  Server()->Stop();
+  ASSERT_TRUE(ServerThread()->JoinWithTimeout(5.0));
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpConcurrent) {
+  Server()->SetConcurrentDumpLimit(4);
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  // The client’s socket must continue to be serviced after the first request
+  // is handled on a worker thread.
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    SCOPED_TRACE(iteration);
+    CrashDumpTest test(this, true);
+    test.Run();
+  }
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpConcurrentError) {
+  Server()->SetConcurrentDumpLimit(4);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kError, false);
+}
+
+class ListeningSocketCrashDumpTest : public Multiprocess {
+ public:
+  ListeningSocketCrashDumpTest(const base::FilePath& socket_path,
+                               TestDelegate* delegate)
+      : Multiprocess(), socket_path_(socket_path), delegate_(delegate) {}
+
+  ListeningSocketCrashDumpTest(const ListeningSocketCrashDumpTest&) = delete;
+  ListeningSocketCrashDumpTest& operator=(const ListeningSocketCrashDumpTest&) =
+      delete;
+
+  ~ListeningSocketCrashDumpTest() = default;
+
+ private:
+  void MultiprocessParent() override {
+    ExceptionHandlerProtocol::ClientInformation info;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &info, sizeof(info)));
+
+    VMAddress last_address;
+    pid_t last_client;
+    ASSERT_TRUE(delegate_->WaitForException(5.0, &last_client, &last_address));
+    EXPECT_EQ(last_address, VMAddress{info.exception_information_address});
+    EXPECT_EQ(last_client, ChildPID());
+  }
+
+  void MultiprocessChild() override {
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.exception_information_address = 42 + getpid();
+    ASSERT_TRUE(LoggingWriteFile(WritePipeHandle(), &info, sizeof(info)));
+
+    ScopedFileHandle sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+    ASSERT_TRUE(sock.is_valid()) << ErrnoMessage("socket");
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    ASSERT_LT(socket_path_.value().size(), sizeof(address.sun_path));
+    strcpy(address.sun_path, socket_path_.value().c_str());
+    ASSERT_EQ(connect(sock.get(),
+                      reinterpret_cast<sockaddr*>(&address),
+                      sizeof(address)),
+              0)
+        << ErrnoMessage("connect");
+
+    ScopedPrSetPtracer set_ptracer(getpid(), /* may_log= */ true);
+
+    ExceptionHandlerClient client(sock.get(), false);
+    ASSERT_EQ(client.RequestCrashDump(info), 0);
+  }
+
+  base::FilePath socket_path_;
+  TestDelegate* delegate_;
+};
+
+TEST(ExceptionHandlerServer, ListeningSocket) {
+  ScopedTempDir temp_dir;
+  const base::FilePath socket_path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("handler"));
+
+  ExceptionHandlerServer server;
+  server.SetPtraceStrategyDecider(std::make_unique<MockPtraceStrategyDecider>(
+      PtraceStrategyDecider::Strategy::kDirectPtrace));
+  ASSERT_TRUE(server.InitializeWithListeningSocket(
+      UnixCredentialSocket::CreateListeningSocket(socket_path)));
+
+  TestDelegate delegate;
+  RunServerThread server_thread(&server, &delegate);
+  ScopedStopServerAndJoinThread stop_server(&server, &server_thread);
+  server_thread.Start();
+
+  // Unrelated clients connect one after another, and the server keeps
+  // listening after each of them has disconnected.
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    SCOPED_TRACE(iteration);
+    ListeningSocketCrashDumpTest test(socket_path, &delegate);
+    test.Run();
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ExceptionHandlerServerTestSuite,
                          ExceptionHandlerServerTest,
                          testing::Bool()
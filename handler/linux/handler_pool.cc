@@ -0,0 +1,179 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/handler_pool.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "util/linux/socket.h"
+
+namespace crashpad {
+
+namespace {
+
+// How often the supervisor checks for exited workers while no clients are
+// connecting.
+constexpr int kReapIntervalMs = 1000;
+
+}  // namespace
+
+HandlerPool::HandlerPool() : idle_workers_(), listen_socket_(), size_(0) {}
+
+HandlerPool::~HandlerPool() = default;
+
+bool HandlerPool::Initialize(const base::FilePath& socket_path,
+                             unsigned int size) {
+  DCHECK_GT(size, 0u);
+
+  // Accepted connections inherit SO_PASSCRED, so a client's credentials are
+  // available with its first message, before a worker has seen the socket.
+  ScopedFileHandle sock(
+      UnixCredentialSocket::CreateListeningSocket(socket_path));
+  if (!sock.is_valid()) {
+    return false;
+  }
+
+  listen_socket_ = std::move(sock);
+  size_ = size;
+  return true;
+}
+
+bool HandlerPool::Run(ScopedFileHandle* client_channel) {
+  DCHECK(listen_socket_.is_valid());
+
+  while (true) {
+    while (idle_workers_.size() < size_) {
+      pid_t pid = ForkWorker(client_channel);
+      if (pid == 0) {
+        return true;
+      }
+      if (pid < 0) {
+        if (idle_workers_.empty()) {
+          return false;
+        }
+        break;
+      }
+    }
+
+    pollfd poll_fd = {};
+    poll_fd.fd = listen_socket_.get();
+    poll_fd.events = POLLIN;
+    int result = HANDLE_EINTR(poll(&poll_fd, 1, kReapIntervalMs));
+    ReapWorkers();
+    if (result < 0) {
+      PLOG(ERROR) << "poll";
+      return false;
+    }
+    if (result == 0) {
+      continue;
+    }
+
+    ScopedFileHandle client(HANDLE_EINTR(
+        accept4(listen_socket_.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+    if (!client.is_valid()) {
+      PLOG(ERROR) << "accept4";
+      continue;
+    }
+    PassClient(client.get());
+  }
+}
+
+// static
+ScopedFileHandle HandlerPool::WaitForClient(int client_channel) {
+  char message;
+  ucred creds;
+  std::vector<ScopedFileHandle> fds;
+  if (!UnixCredentialSocket::RecvMsg(
+          client_channel, &message, sizeof(message), &creds, &fds)) {
+    return ScopedFileHandle();
+  }
+
+  if (fds.size() != 1) {
+    LOG(ERROR) << "unexpected fd count " << fds.size();
+    return ScopedFileHandle();
+  }
+  return std::move(fds[0]);
+}
+
+pid_t HandlerPool::ForkWorker(ScopedFileHandle* client_channel) {
+  ScopedFileHandle supervisor_end;
+  ScopedFileHandle worker_end;
+  if (!UnixCredentialSocket::CreateCredentialSocketpair(&supervisor_end,
+                                                        &worker_end)) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return -1;
+  }
+
+  if (pid == 0) {
+    // Only the supervisor may hold these, so that an idle worker sees its
+    // channel close when the supervisor exits.
+    supervisor_end.reset();
+    idle_workers_.clear();
+    listen_socket_.reset();
+    *client_channel = std::move(worker_end);
+    return 0;
+  }
+
+  idle_workers_.push_back({pid, std::move(supervisor_end)});
+  return pid;
+}
+
+void HandlerPool::PassClient(int client) {
+  // Workers are forked in order, so the front of the list has had the longest
+  // to finish initializing.
+  while (!idle_workers_.empty()) {
+    Worker worker = std::move(idle_workers_.front());
+    idle_workers_.erase(idle_workers_.begin());
+
+    // A worker that exited before it could be reaped fails here, and the
+    // client goes to the next one.
+    const char message = 0;
+    if (UnixCredentialSocket::SendMsg(
+            worker.channel.get(), &message, sizeof(message), &client, 1) == 0) {
+      return;
+    }
+  }
+  LOG(ERROR) << "no idle worker for client";
+}
+
+void HandlerPool::ReapWorkers() {
+  pid_t pid;
+  int status;
+  while ((pid = HANDLE_EINTR(waitpid(-1, &status, WNOHANG))) > 0) {
+    auto worker = std::find_if(
+        idle_workers_.begin(), idle_workers_.end(), [pid](const Worker& w) {
+          return w.pid == pid;
+        });
+    if (worker != idle_workers_.end()) {
+      LOG(WARNING) << "idle worker " << pid << " exited";
+      idle_workers_.erase(worker);
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_HANDLER_POOL_H_
+#define CRASHPAD_HANDLER_LINUX_HANDLER_POOL_H_
+
+#include <sys/types.h>
+
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+
+//! \brief Keeps a pool of pre-started handler processes, each of which serves
+//!     a single client that connects to a listening socket.
+//!
+//! Starting a handler when a client crashes costs an `exec()` and the
+//! handler's full initialization while the client waits. A pool avoids that by
+//! forking workers ahead of time. Each worker finishes initializing and then
+//! waits in WaitForClient(). When a client connects to the pool's socket, the
+//! supervisor passes the connection to an idle worker and forks a replacement.
+//!
+//! Clients connect with CrashpadClient::SetHandlerPoolSocket().
+class HandlerPool {
+ public:
+  HandlerPool();
+
+  HandlerPool(const HandlerPool&) = delete;
+  HandlerPool& operator=(const HandlerPool&) = delete;
+
+  ~HandlerPool();
+
+  //! \brief Creates the socket that clients connect to.
+  //!
+  //! Any existing file at \a socket_path is replaced.
+  //!
+  //! \param[in] socket_path The path to bind the `SOCK_SEQPACKET` socket to.
+  //! \param[in] size The number of idle workers to keep. Must be at least 1.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool Initialize(const base::FilePath& socket_path, unsigned int size);
+
+  //! \brief Runs the supervisor, forking workers and passing client
+  //!     connections to them.
+  //!
+  //! The calling process becomes the supervisor, and must be single-threaded.
+  //! This method returns in each worker, which should finish initializing and
+  //! then call WaitForClient() with \a client_channel. The supervisor only
+  //! returns if it is unable to continue.
+  //!
+  //! \param[out] client_channel In a worker, the socket on which the
+  //!     supervisor will pass the worker a client connection.
+  //! \return `true` in a worker. `false` in the supervisor, with a message
+  //!     logged.
+  bool Run(ScopedFileHandle* client_channel);
+
+  //! \brief Waits in a worker for the supervisor to pass it a client
+  //!     connection.
+  //!
+  //! \param[in] client_channel The socket returned by Run().
+  //! \return The socket connected to the client. An invalid handle if the
+  //!     supervisor exited, or if an error occurred, in which case a message
+  //!     will be logged.
+  static ScopedFileHandle WaitForClient(int client_channel);
+
+ private:
+  struct Worker {
+    pid_t pid;
+    ScopedFileHandle channel;
+  };
+
+  // Forks a new idle worker. Returns the worker's process ID in the
+  // supervisor, 0 in the worker with client_channel set, or -1 on failure with
+  // a message logged.
+  pid_t ForkWorker(ScopedFileHandle* client_channel);
+
+  // Passes client to the longest-idle worker that accepts it.
+  void PassClient(int client);
+
+  // Collects exited workers, removing any that were still idle.
+  void ReapWorkers();
+
+  std::vector<Worker> idle_workers_;
+  ScopedFileHandle listen_socket_;
+  unsigned int size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_HANDLER_POOL_H_
@@ -0,0 +1,153 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/handler_pool.h"
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/scoped_temp_dir.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Connects to the pool and returns the process ID reported by the worker it
+// was passed to, or -1 on failure.
+pid_t ConnectAndGetWorkerPid(const base::FilePath& socket_path) {
+  ScopedFileHandle sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+  EXPECT_TRUE(sock.is_valid()) << ErrnoMessage("socket");
+
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path,
+          socket_path.value().c_str(),
+          sizeof(address.sun_path) - 1);
+  if (HANDLE_EINTR(connect(sock.get(),
+                           reinterpret_cast<sockaddr*>(&address),
+                           sizeof(address))) != 0) {
+    ADD_FAILURE() << ErrnoMessage("connect");
+    return -1;
+  }
+
+  pid_t worker_pid;
+  if (!LoggingReadFileExactly(sock.get(), &worker_pid, sizeof(worker_pid))) {
+    return -1;
+  }
+  return worker_pid;
+}
+
+TEST(HandlerPool, PassesEachClientToANewWorker) {
+  ScopedTempDir temp_dir;
+  base::FilePath socket_path = temp_dir.path().Append("pool");
+
+  HandlerPool pool;
+  ASSERT_TRUE(pool.Initialize(socket_path, 2));
+
+  pid_t supervisor = fork();
+  ASSERT_GE(supervisor, 0) << ErrnoMessage("fork");
+  if (supervisor == 0) {
+    ScopedFileHandle client_channel;
+    if (!pool.Run(&client_channel)) {
+      _exit(EXIT_FAILURE);
+    }
+
+    ScopedFileHandle client(HandlerPool::WaitForClient(client_channel.get()));
+    if (!client.is_valid()) {
+      _exit(EXIT_SUCCESS);
+    }
+    pid_t pid = getpid();
+    _exit(WriteFile(client.get(), &pid, sizeof(pid)) ? EXIT_SUCCESS
+                                                     : EXIT_FAILURE);
+  }
+
+  pid_t first_worker = ConnectAndGetWorkerPid(socket_path);
+  pid_t second_worker = ConnectAndGetWorkerPid(socket_path);
+  pid_t third_worker = ConnectAndGetWorkerPid(socket_path);
+  EXPECT_GT(first_worker, 0);
+  EXPECT_GT(second_worker, 0);
+  EXPECT_GT(third_worker, 0);
+  EXPECT_NE(first_worker, second_worker);
+  EXPECT_NE(second_worker, third_worker);
+  EXPECT_NE(first_worker, third_worker);
+  EXPECT_NE(first_worker, supervisor);
+
+  ASSERT_EQ(kill(supervisor, SIGKILL), 0) << ErrnoMessage("kill");
+  int status;
+  ASSERT_EQ(HANDLE_EINTR(waitpid(supervisor, &status, 0)), supervisor)
+      << ErrnoMessage("waitpid");
+  EXPECT_TRUE(WIFSIGNALED(status));
+}
+
+TEST(HandlerPool, IdleWorkerExitsWithSupervisor) {
+  ScopedTempDir temp_dir;
+  base::FilePath socket_path = temp_dir.path().Append("pool");
+
+  HandlerPool pool;
+  ASSERT_TRUE(pool.Initialize(socket_path, 1));
+
+  // The worker reports back over this pipe whether WaitForClient() returned
+  // without a client once the supervisor was gone.
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0) << ErrnoMessage("pipe");
+  ScopedFileHandle read_end(pipe_fds[0]);
+  ScopedFileHandle write_end(pipe_fds[1]);
+
+  pid_t supervisor = fork();
+  ASSERT_GE(supervisor, 0) << ErrnoMessage("fork");
+  if (supervisor == 0) {
+    read_end.reset();
+    ScopedFileHandle client_channel;
+    if (!pool.Run(&client_channel)) {
+      _exit(EXIT_FAILURE);
+    }
+
+    pid_t pid = getpid();
+    if (!WriteFile(write_end.get(), &pid, sizeof(pid))) {
+      _exit(EXIT_FAILURE);
+    }
+    bool no_client =
+        !HandlerPool::WaitForClient(client_channel.get()).is_valid();
+    _exit(WriteFile(write_end.get(), &no_client, sizeof(no_client))
+              ? EXIT_SUCCESS
+              : EXIT_FAILURE);
+  }
+  write_end.reset();
+
+  pid_t worker;
+  ASSERT_TRUE(LoggingReadFileExactly(read_end.get(), &worker, sizeof(worker)));
+  EXPECT_NE(worker, supervisor);
+
+  ASSERT_EQ(kill(supervisor, SIGKILL), 0) << ErrnoMessage("kill");
+  int status;
+  ASSERT_EQ(HANDLE_EINTR(waitpid(supervisor, &status, 0)), supervisor)
+      << ErrnoMessage("waitpid");
+
+  bool no_client;
+  ASSERT_TRUE(
+      LoggingReadFileExactly(read_end.get(), &no_client, sizeof(no_client)));
+  EXPECT_TRUE(no_client);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,577 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <alloca.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/annotation.h"
+#include "client/crash_report_database.h"
+#include "handler/linux/capture_snapshot.h"
+#include "handler/linux/crash_report_exception_handler.h"
+#include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/sanitized/process_snapshot_sanitized.h"
+#include "test/benchmark_phase.h"
+#include "test/scoped_temp_dir.h"
+#include "tools/tool_support.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/linux/exception_information.h"
+#include "util/misc/capture_context.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/clock.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of capturing a snapshot of a live target process.\n"
+"\n"
+"      --threads=N                 start N extra threads in the target\n"
+"      --stack-size=BYTES          use BYTES of stack in each extra thread\n"
+"      --modules=N                 load N copies of the --module object\n"
+"      --module=PATH               the shared object to copy for --modules\n"
+"      --annotations=N             register N annotations in the target\n"
+"      --module-initialization-threads=N\n"
+"                                  initialize modules on up to N threads\n"
+"      --module-memory-cache-pages=N\n"
+"                                  cache up to N pages of module memory\n"
+"      --iterations=N              capture the target N times\n"
+"      --help                      display this help and exit\n"
+"      --version                   output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+struct Options {
+  unsigned int threads;
+  unsigned long long stack_size;
+  unsigned int modules;
+  base::FilePath module;
+  unsigned int annotations;
+  unsigned int module_initialization_threads;
+  unsigned int module_memory_cache_pages;
+  unsigned int iterations;
+};
+
+// The parameters of a target thread. The target has forked and runs no other
+// code, so these are leaked.
+struct TargetThread {
+  size_t stack_size;
+  Semaphore* ready;
+  FileHandle wait_handle;
+};
+
+void* TargetThreadMain(void* argument) {
+  const TargetThread* thread = static_cast<const TargetThread*>(argument);
+
+  // Fill the stack below the frame with pointer-sized values, so that the
+  // captured stack is as large as requested and has candidates for indirectly
+  // referenced memory.
+  uintptr_t* stack = static_cast<uintptr_t*>(alloca(thread->stack_size));
+  for (size_t index = 0; index < thread->stack_size / sizeof(*stack);
+       ++index) {
+    stack[index] = FromPointerCast<uintptr_t>(&stack[index]);
+  }
+  thread->ready->Signal();
+
+  // Block until the parent closes its end of the pipe.
+  char c;
+  ReadFile(thread->wait_handle, &c, sizeof(c));
+  return reinterpret_cast<void*>(stack[0]);
+}
+
+// Runs in the forked target. Reports the address of an ExceptionInformation
+// to the parent over write_handle, and exits when wait_handle reaches EOF.
+[[noreturn]] void TargetMain(const Options& options,
+                             const std::vector<base::FilePath>& module_copies,
+                             FileHandle write_handle,
+                             FileHandle wait_handle) {
+  for (const base::FilePath& module_copy : module_copies) {
+    if (!dlopen(module_copy.value().c_str(), RTLD_NOW | RTLD_LOCAL)) {
+      LOG(ERROR) << "dlopen " << module_copy.value() << ": " << dlerror();
+      _exit(EXIT_FAILURE);
+    }
+  }
+
+  for (unsigned int index = 0; index < options.annotations; ++index) {
+    const std::string* name =
+        new std::string(base::StringPrintf("benchmark_annotation_%u", index));
+    auto* annotation = new StringAnnotation<64>(name->c_str());
+    annotation->Set(base::StringPrintf("value %u", index));
+  }
+
+  Semaphore ready(0);
+  const size_t thread_stack_size =
+      std::max(static_cast<size_t>(PTHREAD_STACK_MIN),
+               static_cast<size_t>(options.stack_size) + 64 * 1024);
+  for (unsigned int index = 0; index < options.threads; ++index) {
+    auto* thread = new TargetThread();
+    thread->stack_size = options.stack_size;
+    thread->ready = &ready;
+    thread->wait_handle = wait_handle;
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, thread_stack_size);
+    pthread_t pthread;
+    errno = pthread_create(&pthread, &attributes, TargetThreadMain, thread);
+    pthread_attr_destroy(&attributes);
+    if (errno != 0) {
+      PLOG(ERROR) << "pthread_create";
+      _exit(EXIT_FAILURE);
+    }
+  }
+  for (unsigned int index = 0; index < options.threads; ++index) {
+    ready.Wait();
+  }
+
+  // Describe a simulated exception on this thread, as
+  // CrashpadClient::DumpWithoutCrash() does.
+  static NativeCPUContext context;
+  CaptureContext(&context);
+#if defined(ARCH_CPU_ARMEL)
+  memset(context.uc_regspace, 0, sizeof(context.uc_regspace));
+#elif defined(ARCH_CPU_ARM64)
+  memset(context.uc_mcontext.__reserved,
+         0,
+         sizeof(context.uc_mcontext.__reserved));
+#endif
+
+  static siginfo_t siginfo;
+  siginfo.si_signo = SIGUSR1;
+  siginfo.si_errno = 0;
+  siginfo.si_code = SI_USER;
+
+  static ExceptionInformation exception_information;
+  exception_information.siginfo_address =
+      FromPointerCast<LinuxVMAddress>(&siginfo);
+  exception_information.context_address =
+      FromPointerCast<LinuxVMAddress>(&context);
+  exception_information.thread_id = getpid();
+
+  const VMAddress exception_information_address =
+      FromPointerCast<VMAddress>(&exception_information);
+  if (!LoggingWriteFile(write_handle,
+                        &exception_information_address,
+                        sizeof(exception_information_address))) {
+    _exit(EXIT_FAILURE);
+  }
+
+  char c;
+  ReadFile(wait_handle, &c, sizeof(c));
+  _exit(EXIT_SUCCESS);
+}
+
+// Copies options.module into directory options.modules times. Each copy has a
+// distinct name and inode, so that the dynamic loader maps each separately.
+bool CopyModules(const Options& options,
+                 const base::FilePath& directory,
+                 std::vector<base::FilePath>* module_copies) {
+  if (options.modules == 0) {
+    return true;
+  }
+
+  std::string contents;
+  if (!LoggingReadEntireFile(options.module, &contents)) {
+    return false;
+  }
+
+  for (unsigned int index = 0; index < options.modules; ++index) {
+    const base::FilePath path = directory.Append(
+        base::StringPrintf("libbenchmark_module_%u.so", index));
+    FileWriter writer;
+    if (!writer.Open(path,
+                     FileWriteMode::kCreateOrFail,
+                     FilePermissions::kOwnerOnly) ||
+        !writer.Write(contents.data(), contents.size())) {
+      return false;
+    }
+    module_copies->push_back(path);
+  }
+  return true;
+}
+
+struct Sample {
+  uint64_t attach_ns;
+  uint64_t initialize_ns;
+  uint64_t thread_enumeration_ns;
+  uint64_t module_parsing_ns;
+  uint64_t capture_snapshot_ns;
+  uint64_t handler_ns;
+};
+
+// Measures one iteration against the target pid. Each measurement attaches to
+// the target anew, as the handler does for each crash.
+bool MeasureIteration(pid_t pid,
+                      const ExceptionHandlerProtocol::ClientInformation& info,
+                      const Options& options,
+                      CrashReportExceptionHandler* handler,
+                      Sample* sample) {
+  {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    DirectPtraceConnection connection;
+    if (!connection.Initialize(pid)) {
+      return false;
+    }
+    const uint64_t attached_ns = ClockMonotonicNanoseconds();
+
+    ProcessSnapshotLinux process_snapshot;
+    if (!process_snapshot.Initialize(&connection,
+                                     options.module_memory_cache_pages,
+                                     options.module_initialization_threads)) {
+      LOG(ERROR) << "ProcessSnapshotLinux::Initialize failed";
+      return false;
+    }
+    const uint64_t initialized_ns = ClockMonotonicNanoseconds();
+
+    sample->attach_ns = attached_ns - start_ns;
+    sample->initialize_ns = initialized_ns - attached_ns;
+    sample->thread_enumeration_ns = process_snapshot.Timings().Duration(
+        CaptureTimings::Phase::kThreadEnumeration);
+    sample->module_parsing_ns = process_snapshot.Timings().Duration(
+        CaptureTimings::Phase::kModuleParsing);
+  }
+
+  {
+    DirectPtraceConnection connection;
+    if (!connection.Initialize(pid)) {
+      return false;
+    }
+
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
+    std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
+    if (!CaptureSnapshot(&connection,
+                         info,
+                         std::map<std::string, std::string>(),
+                         getuid(),
+                         0,
+                         nullptr,
+                         options.module_initialization_threads,
+                         options.module_memory_cache_pages,
+                         0,
+                         ProcessSnapshotLinux::StackCaptureOptions(),
+                         nullptr,
+                         nullptr,
+                         ProcessSnapshotLinux::FullMemoryOptions(),
+                         &process_snapshot,
+                         &sanitized_snapshot)) {
+      LOG(ERROR) << "CaptureSnapshot failed";
+      return false;
+    }
+    sample->capture_snapshot_ns = ClockMonotonicNanoseconds() - start_ns;
+  }
+
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  if (!handler->HandleException(pid, getuid(), info)) {
+    LOG(ERROR) << "HandleException failed";
+    return false;
+  }
+  sample->handler_ns = ClockMonotonicNanoseconds() - start_ns;
+
+  return true;
+}
+
+int SnapshotCaptureBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionThreads,
+    kOptionStackSize,
+    kOptionModules,
+    kOptionModule,
+    kOptionAnnotations,
+    kOptionModuleInitializationThreads,
+    kOptionModuleMemoryCachePages,
+    kOptionIterations,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"stack-size", required_argument, nullptr, kOptionStackSize},
+      {"modules", required_argument, nullptr, kOptionModules},
+      {"module", required_argument, nullptr, kOptionModule},
+      {"annotations", required_argument, nullptr, kOptionAnnotations},
+      {"module-initialization-threads",
+       required_argument,
+       nullptr,
+       kOptionModuleInitializationThreads},
+      {"module-memory-cache-pages",
+       required_argument,
+       nullptr,
+       kOptionModuleMemoryCachePages},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  Options options = {};
+  options.threads = 32;
+  options.stack_size = 64 * 1024;
+  options.modules = 0;
+  options.annotations = 16;
+  options.module_initialization_threads = 0;
+  options.module_memory_cache_pages = 0;
+  options.iterations = 10;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionThreads: {
+        if (!StringToNumber(optarg, &options.threads)) {
+          ToolSupport::UsageHint(me, "--threads requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionStackSize: {
+        if (!StringToNumber(optarg, &options.stack_size) ||
+            options.stack_size > std::numeric_limits<size_t>::max() / 2) {
+          ToolSupport::UsageHint(me, "--stack-size requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionModules: {
+        if (!StringToNumber(optarg, &options.modules)) {
+          ToolSupport::UsageHint(me, "--modules requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionModule: {
+        options.module = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionAnnotations: {
+        if (!StringToNumber(optarg, &options.annotations)) {
+          ToolSupport::UsageHint(me, "--annotations requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionModuleInitializationThreads: {
+        if (!StringToNumber(optarg, &options.module_initialization_threads)) {
+          ToolSupport::UsageHint(
+              me, "--module-initialization-threads requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionModuleMemoryCachePages: {
+        if (!StringToNumber(optarg, &options.module_memory_cache_pages)) {
+          ToolSupport::UsageHint(
+              me, "--module-memory-cache-pages requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionIterations: {
+        if (!StringToNumber(optarg, &options.iterations) ||
+            options.iterations == 0) {
+          ToolSupport::UsageHint(me,
+                                 "--iterations requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  if (options.modules > 0 && options.module.empty()) {
+    ToolSupport::UsageHint(me, "--modules requires --module");
+    return EXIT_FAILURE;
+  }
+
+  ScopedTempDir temp_dir;
+  std::vector<base::FilePath> module_copies;
+  if (!CopyModules(options, temp_dir.path(), &module_copies)) {
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<CrashReportDatabase> database(
+      CrashReportDatabase::Initialize(temp_dir.path().Append("database")));
+  if (!database) {
+    return EXIT_FAILURE;
+  }
+
+  int report_pipe[2];
+  int wait_pipe[2];
+  if (pipe(report_pipe) != 0 || pipe(wait_pipe) != 0) {
+    PLOG(ERROR) << "pipe";
+    return EXIT_FAILURE;
+  }
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return EXIT_FAILURE;
+  }
+  if (pid == 0) {
+    close(report_pipe[0]);
+    close(wait_pipe[1]);
+    TargetMain(options, module_copies, report_pipe[1], wait_pipe[0]);
+  }
+  close(report_pipe[1]);
+  close(wait_pipe[0]);
+
+  ExceptionHandlerProtocol::ClientInformation info;
+  bool ok = LoggingReadFileExactly(report_pipe[0],
+                                   &info.exception_information_address,
+                                   sizeof(info.exception_information_address));
+
+  std::vector<Sample> samples;
+  if (ok) {
+    const std::map<std::string, std::string> process_annotations;
+    const std::vector<base::FilePath> attachments;
+    CrashReportExceptionHandler handler(database.get(),
+                                        nullptr,
+                                        &process_annotations,
+                                        &attachments,
+                                        true,
+                                        false,
+                                        nullptr);
+    handler.SetModuleInitializationThreads(
+        options.module_initialization_threads);
+    handler.SetModuleMemoryCachePages(options.module_memory_cache_pages);
+
+    for (unsigned int iteration = 0; ok && iteration < options.iterations;
+         ++iteration) {
+      Sample sample;
+      ok = MeasureIteration(pid, info, options, &handler, &sample);
+      if (ok) {
+        samples.push_back(sample);
+      }
+    }
+  }
+
+  close(wait_pipe[1]);
+  close(report_pipe[0]);
+  int status;
+  if (HANDLE_EINTR(waitpid(pid, &status, 0)) != pid) {
+    PLOG(ERROR) << "waitpid";
+    return EXIT_FAILURE;
+  }
+  if (!ok) {
+    return EXIT_FAILURE;
+  }
+
+  printf("threads %u, stack size %llu, modules %u, annotations %u, "
+         "module initialization threads %u, module memory cache pages %u, "
+         "iterations %u\n",
+         options.threads,
+         options.stack_size,
+         options.modules,
+         options.annotations,
+         options.module_initialization_threads,
+         options.module_memory_cache_pages,
+         options.iterations);
+  constexpr int kNameWidth = 32;
+  PrintPhaseHeading(kNameWidth);
+  PrintPhase("attach", kNameWidth, samples, [](const Sample& sample) {
+    return sample.attach_ns;
+  });
+  PrintPhase("ProcessSnapshotLinux::Initialize",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.initialize_ns; });
+  PrintPhase("  thread enumeration",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.thread_enumeration_ns; });
+  PrintPhase("  module parsing",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.module_parsing_ns; });
+  PrintPhase("CaptureSnapshot",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.capture_snapshot_ns; });
+  PrintPhase("HandleException",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.handler_ns; });
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::test::SnapshotCaptureBenchmarkMain(argc, argv);
+}
@@ -23,6 +23,8 @@
 #include "base/strings/stringprintf.h"
 #include "client/settings.h"
 #include "handler/mac/file_limit_annotation.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_deduplicator.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/crashpad_info_client_options.h"
@@ -42,6 +44,21 @@
 
 namespace crashpad {
 
+namespace {
+
+// The number of ProcessMemoryMac::kCachedMappingSize mappings of the crashed
+// task’s memory to keep while taking its snapshot. The task is suspended, so
+// its memory will not change while cached. 512 mappings covers 32MB, enough
+// for the load commands and dyld structures of hundreds of images.
+constexpr size_t kSnapshotMemoryCacheMappings = 512;
+
+// The maximum number of dyld shared cache images whose headers are kept for
+// use by later snapshots. A shared cache contains a few thousand images, only
+// some of which are loaded by any one process.
+constexpr size_t kMaxSharedCacheImageHeaders = 4096;
+
+}  // namespace
+
 CrashReportExceptionHandler::CrashReportExceptionHandler(
     CrashReportDatabase* database,
     CrashReportUploadThread* upload_thread,
@@ -50,7 +67,8 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
     : database_(database),
       upload_thread_(upload_thread),
       process_annotations_(process_annotations),
-      user_stream_data_sources_(user_stream_data_sources) {}
+      user_stream_data_sources_(user_stream_data_sources),
+      shared_cache_image_headers_(kMaxSharedCacheImageHeaders) {}
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() {
 }
@@ -103,7 +121,9 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
   ScopedTaskSuspend suspend(task);
 
   ProcessSnapshotMac process_snapshot;
-  if (!process_snapshot.Initialize(task)) {
+  if (!process_snapshot.Initialize(task,
+                                   kSnapshotMemoryCacheMappings,
+                                   &shared_cache_image_headers_)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return KERN_FAILURE;
   }
@@ -168,6 +188,13 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
     AddUserExtensionStreams(
         user_stream_data_sources_, &process_snapshot, &minidump);
 
+    // These spare the upload thread from interpreting the minidump.
+    if (!new_report->SetUploadParameters(
+            BreakpadHTTPFormParametersFromMinidump(&process_snapshot),
+            CrashSignatureFromSnapshot(&process_snapshot))) {
+      LOG(WARNING) << "couldn't store upload parameters";
+    }
+
     if (!minidump.WriteEverything(new_report->Writer())) {
       Metrics::ExceptionCaptureResult(
           Metrics::CaptureResult::kMinidumpWriteFailed);
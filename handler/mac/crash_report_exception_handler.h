@@ -23,6 +23,7 @@
 #include "client/crash_report_database.h"
 #include "handler/crash_report_upload_thread.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/mac/shared_cache_image_header_cache.h"
 #include "util/mach/exc_server_variants.h"
 
 namespace crashpad {
@@ -89,6 +90,10 @@ class CrashReportExceptionHandler final
   CrashReportUploadThread* upload_thread_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+
+  // Reused across snapshots of different processes. See
+  // ProcessReaderMac::Initialize().
+  SharedCacheImageHeaderCache shared_cache_image_headers_;
 };
 
 }  // namespace crashpad
@@ -14,7 +14,11 @@
 
 #include "handler/mac/exception_handler_server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/apple/mach_logging.h"
 #include "base/check.h"
@@ -24,17 +28,49 @@
 #include "util/mach/mach_message.h"
 #include "util/mach/mach_message_server.h"
 #include "util/mach/notify_server.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
 namespace {
 
+// Sends a synthesized no-senders notification to |notify_port|. This is how
+// Stop() asks a running server to stop, and how each of the server’s threads
+// passes that request on to the next.
+void SendNoSendersNotification(mach_port_t notify_port) {
+  // mach_no_senders_notification_t defines the receive side of this structure,
+  // with a trailer element that’s undesirable for the send side.
+  struct {
+    mach_msg_header_t header;
+    NDR_record_t ndr;
+    mach_msg_type_number_t mscount;
+  } no_senders_notification = {};
+  no_senders_notification.header.msgh_bits =
+      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
+  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
+  no_senders_notification.header.msgh_remote_port = notify_port;
+  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
+  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
+  no_senders_notification.ndr = NDR_record;
+  no_senders_notification.mscount = 0;
+
+  kern_return_t kr = mach_msg(&no_senders_notification.header,
+                              MACH_SEND_MSG,
+                              sizeof(no_senders_notification),
+                              0,
+                              MACH_PORT_NULL,
+                              MACH_MSG_TIMEOUT_NONE,
+                              MACH_PORT_NULL);
+  MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_msg";
+}
+
 class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
                                   public NotifyServer::DefaultInterface {
  public:
   ExceptionHandlerServerRun(
       mach_port_t exception_port,
       mach_port_t notify_port,
+      size_t concurrent_dump_limit,
       bool launchd,
       UniversalMachExcServer::Interface* exception_interface)
       : UniversalMachExcServer::Interface(),
@@ -45,6 +81,9 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
         exception_interface_(exception_interface),
         exception_port_(exception_port),
         notify_port_(notify_port),
+        server_port_set_(),
+        concurrent_dump_limit_(concurrent_dump_limit),
+        active_receivers_(0),
         running_(true),
         launchd_(launchd) {
     composite_mach_message_server_.AddHandler(&mach_exc_server_);
@@ -85,39 +124,33 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
     // from ever existing. Using distinct receive rights also allows the handler
     // methods to ensure that the messages they process were sent by a holder of
     // the proper send right.
-    base::apple::ScopedMachPortSet server_port_set(
-        NewMachPort(MACH_PORT_RIGHT_PORT_SET));
-    CHECK(server_port_set.is_valid());
+    server_port_set_.reset(NewMachPort(MACH_PORT_RIGHT_PORT_SET));
+    CHECK(server_port_set_.is_valid());
 
     kr = mach_port_insert_member(
-        mach_task_self(), exception_port_, server_port_set.get());
+        mach_task_self(), exception_port_, server_port_set_.get());
     MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_port_insert_member";
 
     kr = mach_port_insert_member(
-        mach_task_self(), notify_port_, server_port_set.get());
+        mach_task_self(), notify_port_, server_port_set_.get());
     MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_port_insert_member";
 
-    // Run the server in kOneShot mode so that running_ can be reevaluated after
-    // each message. Receipt of a valid no-senders notification causes it to be
-    // set to false.
-    while (running_) {
-      // This will result in a call to CatchMachException() or
-      // DoMachNotifyNoSenders() as appropriate.
-      mach_msg_return_t mr =
-          MachMessageServer::Run(&composite_mach_message_server_,
-                                 server_port_set.get(),
-                                 kMachMessageReceiveAuditTrailer,
-                                 MachMessageServer::kOneShot,
-                                 MachMessageServer::kReceiveLargeIgnore,
-                                 kMachMessageTimeoutWaitIndefinitely);
+    // Each additional thread receives from the same port set. The kernel
+    // delivers each message to exactly one of the threads waiting on it, so
+    // exceptions from different clients are handled concurrently while
+    // messages are never handled twice.
+    active_receivers_ = concurrent_dump_limit_;
+    std::vector<std::unique_ptr<ReceiveThread>> threads;
+    threads.reserve(concurrent_dump_limit_ - 1);
+    for (size_t index = 1; index < concurrent_dump_limit_; ++index) {
+      threads.push_back(std::make_unique<ReceiveThread>(this));
+      threads.back()->Start();
+    }
 
-      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
-      // This can happen if a mach_exc or exc client disappears before a reply
-      // can be sent to it. That’s unusal for kernel-generated requests, but can
-      // easily happen if a task sends its own exception request (as
-      // SimulateCrash() does) and dies before the reply is sent.
-      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
-          << "MachMessageServer::Run";
+    ReceiveLoop();
+
+    for (auto& thread : threads) {
+      thread->Join();
     }
   }
 
@@ -180,13 +213,64 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
   }
 
  private:
+  class ReceiveThread : public Thread {
+   public:
+    explicit ReceiveThread(ExceptionHandlerServerRun* run) : run_(run) {}
+
+    ReceiveThread(const ReceiveThread&) = delete;
+    ReceiveThread& operator=(const ReceiveThread&) = delete;
+
+    ~ReceiveThread() override {}
+
+   private:
+    void ThreadMain() override { run_->ReceiveLoop(); }
+
+    ExceptionHandlerServerRun* run_;  // weak
+  };
+
+  void ReceiveLoop() {
+    // Run the server in kOneShot mode so that running_ can be reevaluated after
+    // each message. Receipt of a valid no-senders notification causes it to be
+    // set to false.
+    while (running_) {
+      // This will result in a call to CatchMachException() or
+      // DoMachNotifyNoSenders() as appropriate.
+      mach_msg_return_t mr =
+          MachMessageServer::Run(&composite_mach_message_server_,
+                                 server_port_set_.get(),
+                                 kMachMessageReceiveAuditTrailer,
+                                 MachMessageServer::kOneShot,
+                                 MachMessageServer::kReceiveLargeIgnore,
+                                 kMachMessageTimeoutWaitIndefinitely);
+
+      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
+      // This can happen if a mach_exc or exc client disappears before a reply
+      // can be sent to it. That’s unusal for kernel-generated requests, but can
+      // easily happen if a task sends its own exception request (as
+      // SimulateCrash() does) and dies before the reply is sent.
+      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
+          << "MachMessageServer::Run";
+    }
+
+    // Only one thread receives the no-senders notification that stops the
+    // server. The others may be blocked waiting for a message that will never
+    // arrive, so wake one of them. It will do the same in turn until every
+    // thread has stopped.
+    if (--active_receivers_ > 0) {
+      SendNoSendersNotification(notify_port_);
+    }
+  }
+
   UniversalMachExcServer mach_exc_server_;
   NotifyServer notify_server_;
   CompositeMachMessageServer composite_mach_message_server_;
   UniversalMachExcServer::Interface* exception_interface_;  // weak
   mach_port_t exception_port_;  // weak
   mach_port_t notify_port_;  // weak
-  bool running_;
+  base::apple::ScopedMachPortSet server_port_set_;
+  const size_t concurrent_dump_limit_;
+  std::atomic<size_t> active_receivers_;
+  std::atomic<bool> running_;
   bool launchd_;
 };
 
@@ -197,6 +281,7 @@ ExceptionHandlerServer::ExceptionHandlerServer(
     bool launchd)
     : receive_port_(std::move(receive_port)),
       notify_port_(NewMachPort(MACH_PORT_RIGHT_RECEIVE)),
+      concurrent_dump_limit_(1),
       launchd_(launchd) {
   CHECK(receive_port_.is_valid());
   CHECK(notify_port_.is_valid());
@@ -205,41 +290,24 @@ ExceptionHandlerServer::ExceptionHandlerServer(
 ExceptionHandlerServer::~ExceptionHandlerServer() {
 }
 
+void ExceptionHandlerServer::SetConcurrentDumpLimit(size_t limit) {
+  concurrent_dump_limit_ = std::max(limit, size_t{1});
+}
+
 void ExceptionHandlerServer::Run(
     UniversalMachExcServer::Interface* exception_interface) {
-  ExceptionHandlerServerRun run(
-      receive_port_.get(), notify_port_.get(), launchd_, exception_interface);
+  ExceptionHandlerServerRun run(receive_port_.get(),
+                                notify_port_.get(),
+                                concurrent_dump_limit_,
+                                launchd_,
+                                exception_interface);
   run.Run();
 }
 
 void ExceptionHandlerServer::Stop() {
   // Cause the exception handler server to stop running by sending it a
   // synthesized no-senders notification.
-  //
-  // mach_no_senders_notification_t defines the receive side of this structure,
-  // with a trailer element that’s undesirable for the send side.
-  struct {
-    mach_msg_header_t header;
-    NDR_record_t ndr;
-    mach_msg_type_number_t mscount;
-  } no_senders_notification = {};
-  no_senders_notification.header.msgh_bits =
-      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
-  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
-  no_senders_notification.header.msgh_remote_port = notify_port_.get();
-  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
-  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
-  no_senders_notification.ndr = NDR_record;
-  no_senders_notification.mscount = 0;
-
-  kern_return_t kr = mach_msg(&no_senders_notification.header,
-                              MACH_SEND_MSG,
-                              sizeof(no_senders_notification),
-                              0,
-                              MACH_PORT_NULL,
-                              MACH_MSG_TIMEOUT_NONE,
-                              MACH_PORT_NULL);
-  MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_msg";
+  SendNoSendersNotification(notify_port_.get());
 }
 
 }  // namespace crashpad
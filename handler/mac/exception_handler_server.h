@@ -16,6 +16,7 @@
 #define CRASHPAD_HANDLER_MAC_EXCEPTION_HANDLER_SERVER_H_
 
 #include <mach/mach.h>
+#include <stddef.h>
 
 #include "base/apple/scoped_mach_port.h"
 #include "util/mach/exc_server_variants.h"
@@ -42,6 +43,19 @@ class ExceptionHandlerServer {
 
   ~ExceptionHandlerServer();
 
+  //! \brief Sets the maximum number of exception messages to handle at once.
+  //!
+  //! By default, exception messages are handled one at a time on the thread
+  //! that calls Run(). If \a limit is greater than 1, Run() also starts
+  //! `limit - 1` additional threads, each of which receives from the same
+  //! port, so that an exception from one client can be handled while another
+  //! client’s is still being captured. The `exception_interface` passed to
+  //! Run() must then tolerate being called from several threads at once.
+  //! Run() doesn’t return until all of these threads have stopped.
+  //!
+  //! This method must not be called after Run().
+  void SetConcurrentDumpLimit(size_t limit);
+
   //! \brief Runs the exception-handling server.
   //!
   //! \param[in] exception_interface An object to send exception messages to.
@@ -75,6 +89,7 @@ class ExceptionHandlerServer {
  private:
   base::apple::ScopedMachReceiveRight receive_port_;
   base::apple::ScopedMachReceiveRight notify_port_;
+  size_t concurrent_dump_limit_;
   bool launchd_;
 };
 
@@ -15,7 +15,7 @@
 #include "handler/minidump_to_upload_parameters.h"
 
 #include "base/logging.h"
-#include "client/annotation.h"
+#include "snapshot/annotation_snapshot.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "util/stdlib/map_insert.h"
@@ -56,12 +56,11 @@ std::map<std::string, std::string> BreakpadHTTPFormParametersFromMinidump(
     }
 
     for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
-      if (annotation.type != static_cast<uint16_t>(Annotation::Type::kString)) {
+      std::string value;
+      if (!annotation.ValueToString(&value)) {
         continue;
       }
 
-      std::string value(reinterpret_cast<const char*>(annotation.value.data()),
-                        annotation.value.size());
       std::pair<std::string, std::string> entry(annotation.name, value);
       if (!parameters.insert(entry).second) {
         LOG(WARNING) << "duplicate annotation name " << annotation.name
@@ -35,8 +35,8 @@ class ProcessSnapshot;
 //! reserved keys discussed below, process simple annotations, module simple
 //! annotations, and module annotation objects.
 //!
-//! For annotation objects, only ones of that are Annotation::Type::kString are
-//! included.
+//! For annotation objects, only ones of a type with a textual representation,
+//! as determined by AnnotationSnapshot::ValueToString(), are included.
 //!
 //! Each module’s annotations vector is also examined and built into a single
 //! string value, with distinct elements separated by newlines, and stored at
@@ -14,6 +14,9 @@
 
 #include "handler/minidump_to_upload_parameters.h"
 
+#include <string.h>
+
+#include "client/annotation.h"
 #include "gtest/gtest.h"
 #include "snapshot/test/test_module_snapshot.h"
 #include "snapshot/test/test_process_snapshot.h"
@@ -94,6 +97,54 @@ TEST(MinidumpToUploadParameters, PrecedenceRules) {
   EXPECT_EQ(upload_parameters["guid"], guid);
 }
 
+template <typename T>
+std::vector<uint8_t> ValueBytes(const T& value) {
+  std::vector<uint8_t> bytes(sizeof(value));
+  memcpy(bytes.data(), &value, sizeof(value));
+  return bytes;
+}
+
+TEST(MinidumpToUploadParameters, TypedAnnotationObjects) {
+  UUID uuid;
+  ASSERT_TRUE(
+      uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+
+  auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+  module_snapshot->SetAnnotationObjects({
+      {"int64",
+       static_cast<uint16_t>(Annotation::Type::kInt64),
+       ValueBytes(int64_t{-42})},
+      {"uint64",
+       static_cast<uint16_t>(Annotation::Type::kUint64),
+       ValueBytes(uint64_t{0xffffffffffffffff})},
+      {"double",
+       static_cast<uint16_t>(Annotation::Type::kDouble),
+       ValueBytes(0.5)},
+      {"uuid",
+       static_cast<uint16_t>(Annotation::Type::kUUID),
+       ValueBytes(uuid)},
+      {"truncated",
+       static_cast<uint16_t>(Annotation::Type::kInt64),
+       ValueBytes(int32_t{1})},
+      {"user-defined",
+       static_cast<uint16_t>(Annotation::UserDefinedType(1)),
+       ValueBytes(int64_t{1})},
+  });
+
+  TestProcessSnapshot process_snapshot;
+  process_snapshot.AddModule(std::move(module_snapshot));
+
+  auto upload_parameters =
+      BreakpadHTTPFormParametersFromMinidump(&process_snapshot);
+
+  EXPECT_EQ(upload_parameters["int64"], "-42");
+  EXPECT_EQ(upload_parameters["uint64"], "18446744073709551615");
+  EXPECT_EQ(upload_parameters["double"], "0.5");
+  EXPECT_EQ(upload_parameters["uuid"], "00112233-4455-6677-8899-aabbccddeeff");
+  EXPECT_EQ(upload_parameters.count("truncated"), 0u);
+  EXPECT_EQ(upload_parameters.count("user-defined"), 0u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
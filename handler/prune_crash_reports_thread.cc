@@ -17,20 +17,39 @@
 #include <utility>
 
 #include "client/prune_crash_reports.h"
+#include "util/misc/clock.h"
+#include "util/misc/metrics.h"
 
 namespace crashpad {
 
 PruneCrashReportThread::PruneCrashReportThread(
     CrashReportDatabase* database,
     std::unique_ptr<PruneCondition> condition)
-    : thread_(60 * 60 * 24, this),
+    : thread_(kIntervalSeconds, this),
       condition_(std::move(condition)),
       database_(database) {}
 
 PruneCrashReportThread::~PruneCrashReportThread() {}
 
+// static
+void PruneCrashReportThread::PruneDatabase(CrashReportDatabase* database,
+                                           PruneCondition* condition) {
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  database->CleanDatabase(60 * 60 * 24 * 3);
+  PruneCrashReportDatabase(database, condition);
+  Metrics::DatabasePruneDuration(ClockMonotonicNanoseconds() - start_ns);
+}
+
+void PruneCrashReportThread::SetStackSize(size_t stack_size) {
+  thread_.SetStackSize(stack_size);
+}
+
+void PruneCrashReportThread::SetPriority(ThreadPriority priority) {
+  thread_.SetPriority(priority);
+}
+
 void PruneCrashReportThread::Start() {
-  thread_.Start(60 * 10);
+  thread_.Start(kInitialDelaySeconds);
 }
 
 void PruneCrashReportThread::Stop() {
@@ -38,8 +57,7 @@ void PruneCrashReportThread::Stop() {
 }
 
 void PruneCrashReportThread::DoWork(const WorkerThread* thread) {
-  database_->CleanDatabase(60 * 60 * 24 * 3);
-  PruneCrashReportDatabase(database_, condition_.get());
+  PruneDatabase(database_, condition_.get());
 }
 
 }  // namespace crashpad
@@ -15,9 +15,12 @@
 #ifndef CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 #define CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "util/thread/stoppable.h"
+#include "util/thread/thread_priority.h"
 #include "util/thread/worker_thread.h"
 
 namespace crashpad {
@@ -46,6 +49,32 @@ class PruneCrashReportThread : public WorkerThread::Delegate, public Stoppable {
 
   ~PruneCrashReportThread();
 
+  //! \brief The number of seconds that Start() waits before the initial prune.
+  static constexpr int kInitialDelaySeconds = 60 * 10;
+
+  //! \brief The number of seconds between prune operations.
+  static constexpr int kIntervalSeconds = 60 * 60 * 24;
+
+  //! \brief Cleans \a database and prunes it using \a condition, as each of
+  //!     this thread’s periodic prune operations does.
+  //!
+  //! This allows another thread that already wakes periodically to prune the
+  //! database in place of an object of this class.
+  static void PruneDatabase(CrashReportDatabase* database,
+                            PruneCondition* condition);
+
+  //! \brief Sets the stack size of the pruning thread, as
+  //!     Thread::SetStackSize() does.
+  //!
+  //! This must be called before Start().
+  void SetStackSize(size_t stack_size);
+
+  //! \brief Sets the priority of the pruning thread, as
+  //!     Thread::SetPriority() does.
+  //!
+  //! This must be called before Start().
+  void SetPriority(ThreadPriority priority);
+
   // Stoppable:
 
   //! \brief Starts a dedicated pruning thread.
@@ -0,0 +1,260 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/report_deduplicator.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/process_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+namespace {
+
+// The number of return addresses from the crashing thread’s stack that
+// contribute to the signature.
+constexpr size_t kMaxStackFrames = 8;
+
+// The amount of the crashing thread’s stack, from its lowest address, that is
+// searched for return addresses.
+constexpr size_t kMaxStackScanBytes = 16 * 1024;
+
+// Signatures whose window has ended with no reports suppressed are forgotten
+// once more than this many are tracked.
+constexpr size_t kMaxIdleSignatures = 256;
+
+// A 64-bit FNV-1a hash.
+class SignatureHash {
+ public:
+  SignatureHash() : hash_(UINT64_C(0xcbf29ce484222325)) {}
+
+  SignatureHash(const SignatureHash&) = delete;
+  SignatureHash& operator=(const SignatureHash&) = delete;
+
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t index = 0; index < size; ++index) {
+      hash_ = (hash_ ^ bytes[index]) * UINT64_C(0x100000001b3);
+    }
+  }
+
+  void Update(uint64_t value) { Update(&value, sizeof(value)); }
+
+  uint64_t hash() const { return hash_; }
+
+ private:
+  uint64_t hash_;
+};
+
+// Finds the modules containing addresses in a process.
+class ModuleIndex {
+ public:
+  explicit ModuleIndex(const ProcessSnapshot* process_snapshot) : modules_() {
+    for (const ModuleSnapshot* module : process_snapshot->Modules()) {
+      if (module->Size() != 0) {
+        modules_.push_back(module);
+      }
+    }
+    std::sort(modules_.begin(),
+              modules_.end(),
+              [](const ModuleSnapshot* a, const ModuleSnapshot* b) {
+                return a->Address() < b->Address();
+              });
+  }
+
+  ModuleIndex(const ModuleIndex&) = delete;
+  ModuleIndex& operator=(const ModuleIndex&) = delete;
+
+  // Returns the module containing address, or nullptr if there is none.
+  const ModuleSnapshot* Find(uint64_t address) const {
+    auto it = std::upper_bound(
+        modules_.begin(),
+        modules_.end(),
+        address,
+        [](uint64_t address, const ModuleSnapshot* module) {
+          return address < module->Address();
+        });
+    if (it == modules_.begin()) {
+      return nullptr;
+    }
+    const ModuleSnapshot* module = *--it;
+    return address - module->Address() < module->Size() ? module : nullptr;
+  }
+
+ private:
+  std::vector<const ModuleSnapshot*> modules_;
+};
+
+// Adds address to hash as an offset into the module identified by its build
+// ID, returning false if no module contains it.
+bool UpdateWithModuleAddress(SignatureHash* hash,
+                             const ModuleIndex& modules,
+                             uint64_t address) {
+  const ModuleSnapshot* module = modules.Find(address);
+  if (!module) {
+    return false;
+  }
+
+  const std::vector<uint8_t> build_id = module->BuildID();
+  if (!build_id.empty()) {
+    hash->Update(build_id.data(), build_id.size());
+  } else {
+    UUID uuid;
+    uint32_t age;
+    module->UUIDAndAge(&uuid, &age);
+    hash->Update(&uuid, sizeof(uuid));
+    hash->Update(age);
+  }
+  hash->Update(address - module->Address());
+  return true;
+}
+
+size_t PointerSize(const CPUContext* context) {
+  switch (context->architecture) {
+    case kCPUArchitectureX86:
+    case kCPUArchitectureARM:
+    case kCPUArchitectureMIPSEL:
+      return sizeof(uint32_t);
+    default:
+      return sizeof(uint64_t);
+  }
+}
+
+void UpdateWithStack(SignatureHash* hash,
+                     const ModuleIndex& modules,
+                     const MemorySnapshot* stack,
+                     size_t pointer_size) {
+  std::vector<uint8_t> data(stack->Size());
+  if (!stack->ReadInto(data.data())) {
+    return;
+  }
+
+  const size_t scan_size = std::min(data.size(), kMaxStackScanBytes);
+  size_t frames = 0;
+  for (size_t offset = 0;
+       offset + pointer_size <= scan_size && frames < kMaxStackFrames;
+       offset += pointer_size) {
+    uint64_t value = 0;
+    if (pointer_size == sizeof(uint32_t)) {
+      uint32_t value32;
+      memcpy(&value32, &data[offset], sizeof(value32));
+      value = value32;
+    } else {
+      memcpy(&value, &data[offset], sizeof(value));
+    }
+    if (UpdateWithModuleAddress(hash, modules, value)) {
+      ++frames;
+    }
+  }
+}
+
+}  // namespace
+
+std::string CrashSignatureFromSnapshot(
+    const ProcessSnapshot* process_snapshot) {
+  const ExceptionSnapshot* exception = process_snapshot->Exception();
+  if (!exception) {
+    return std::string();
+  }
+
+  const ModuleIndex modules(process_snapshot);
+
+  SignatureHash hash;
+  hash.Update(exception->Exception());
+  hash.Update(exception->ExceptionInfo());
+  if (!UpdateWithModuleAddress(&hash, modules, exception->ExceptionAddress())) {
+    hash.Update(exception->ExceptionAddress());
+  }
+
+  for (const ThreadSnapshot* thread : process_snapshot->Threads()) {
+    if (thread->ThreadID() == exception->ThreadID()) {
+      const MemorySnapshot* stack = thread->Stack();
+      if (stack) {
+        UpdateWithStack(
+            &hash, modules, stack, PointerSize(exception->Context()));
+      }
+      break;
+    }
+  }
+
+  return base::StringPrintf("%016" PRIx64, hash.hash());
+}
+
+ReportDeduplicator::ReportDeduplicator(unsigned int max_reports_per_signature,
+                                       time_t window_seconds)
+    : lock_(),
+      signatures_(),
+      max_reports_per_signature_(max_reports_per_signature),
+      window_seconds_(window_seconds) {}
+
+ReportDeduplicator::~ReportDeduplicator() {}
+
+bool ReportDeduplicator::ShouldUpload(const std::string& signature,
+                                      time_t now,
+                                      unsigned int* suppressed_count) {
+  if (!enabled() || signature.empty()) {
+    *suppressed_count = 0;
+    return true;
+  }
+
+  base::AutoLock lock(lock_);
+
+  auto it = signatures_.find(signature);
+  if (it == signatures_.end()) {
+    if (signatures_.size() >= kMaxIdleSignatures) {
+      for (auto idle = signatures_.begin(); idle != signatures_.end();) {
+        if (idle->second.suppressed == 0 &&
+            now - idle->second.window_start >= window_seconds_) {
+          idle = signatures_.erase(idle);
+        } else {
+          ++idle;
+        }
+      }
+    }
+    signatures_[signature] = {now, 1, 0};
+    *suppressed_count = 0;
+    return true;
+  }
+
+  SignatureState& state = it->second;
+  if (now - state.window_start >= window_seconds_ || now < state.window_start) {
+    *suppressed_count = state.suppressed;
+    state = {now, 1, 0};
+    return true;
+  }
+
+  if (state.uploaded < max_reports_per_signature_) {
+    ++state.uploaded;
+    *suppressed_count = state.suppressed;
+    state.suppressed = 0;
+    return true;
+  }
+
+  ++state.suppressed;
+  return false;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,103 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_REPORT_DEDUPLICATOR_H_
+#define CRASHPAD_HANDLER_REPORT_DEDUPLICATOR_H_
+
+#include <time.h>
+
+#include <map>
+#include <string>
+
+#include "base/synchronization/lock.h"
+
+namespace crashpad {
+
+class ProcessSnapshot;
+
+//! \brief Computes a signature identifying the crash captured in a process
+//!     snapshot, so that repeated reports of the same crash can be recognized.
+//!
+//! The signature is a hash of the exception code and information, the
+//! exception address, and the first few values on the crashing thread’s stack
+//! that point into a module, which are taken to be return addresses. Addresses
+//! are made relative to the module containing them, and the module is
+//! identified by its build ID (or UUID and age), so that the signature doesn’t
+//! vary with the load address of each module.
+//!
+//! \param[in] process_snapshot The process snapshot of the crash.
+//!
+//! \return The signature as a string of hexadecimal digits, or an empty string
+//!     if \a process_snapshot has no exception.
+std::string CrashSignatureFromSnapshot(const ProcessSnapshot* process_snapshot);
+
+//! \brief Decides whether crash reports should be uploaded based on how many
+//!     reports with the same signature have already been uploaded recently.
+//!
+//! Within a window that begins with the first upload of a report with a given
+//! signature, up to a fixed number of reports with that signature are uploaded,
+//! and the rest are suppressed. The number of reports suppressed is passed
+//! along with the first report with the signature uploaded after the window
+//! ends, so that the server can account for them.
+//!
+//! Methods may be called from multiple threads at once.
+class ReportDeduplicator {
+ public:
+  //! \param[in] max_reports_per_signature The number of reports with the same
+  //!     signature to upload per window. `0` disables deduplication.
+  //! \param[in] window_seconds The length of the window, in seconds.
+  ReportDeduplicator(unsigned int max_reports_per_signature,
+                     time_t window_seconds);
+
+  ReportDeduplicator(const ReportDeduplicator&) = delete;
+  ReportDeduplicator& operator=(const ReportDeduplicator&) = delete;
+
+  ~ReportDeduplicator();
+
+  //! \return `true` if reports may be suppressed, in which case signatures
+  //!     are needed.
+  bool enabled() const { return max_reports_per_signature_ != 0; }
+
+  //! \brief Determines whether a report should be uploaded.
+  //!
+  //! \param[in] signature The report’s signature, as returned by
+  //!     CrashSignatureFromSnapshot(). Reports with an empty signature are
+  //!     always uploaded.
+  //! \param[in] now The current time.
+  //! \param[out] suppressed_count The number of reports with \a signature that
+  //!     were suppressed since the last one uploaded, to be sent with this
+  //!     report. Only set if this method returns `true`.
+  //!
+  //! \return `true` if the report should be uploaded. `false` if it should be
+  //!     suppressed.
+  bool ShouldUpload(const std::string& signature,
+                    time_t now,
+                    unsigned int* suppressed_count);
+
+ private:
+  struct SignatureState {
+    time_t window_start;
+    unsigned int uploaded;
+    unsigned int suppressed;
+  };
+
+  base::Lock lock_;
+  std::map<std::string, SignatureState> signatures_;  // Protected by lock_.
+  const unsigned int max_reports_per_signature_;
+  const time_t window_seconds_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_REPORT_DEDUPLICATOR_H_
@@ -0,0 +1,154 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/report_deduplicator.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kThreadID = 7;
+
+// Builds a snapshot of a crash in a module loaded at module_address, with the
+// crashing thread’s stack filled with stack_value.
+void InitializeSnapshot(TestProcessSnapshot* process_snapshot,
+                        uint64_t module_address,
+                        const std::vector<uint8_t>& build_id,
+                        uint64_t exception_offset,
+                        char stack_value) {
+  auto module = std::make_unique<TestModuleSnapshot>();
+  module->SetAddressAndSize(module_address, 0x10000);
+  module->SetBuildID(build_id);
+  process_snapshot->AddModule(std::move(module));
+
+  auto exception = std::make_unique<TestExceptionSnapshot>();
+  exception->MutableContext()->architecture = kCPUArchitectureX86_64;
+  exception->SetThreadID(kThreadID);
+  exception->SetException(11);
+  exception->SetExceptionAddress(module_address + exception_offset);
+  process_snapshot->SetException(std::move(exception));
+
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(0x7fff0000);
+  stack->SetSize(256);
+  stack->SetValue(stack_value);
+  auto thread = std::make_unique<TestThreadSnapshot>();
+  thread->SetThreadID(kThreadID);
+  thread->SetStack(std::move(stack));
+  process_snapshot->AddThread(std::move(thread));
+}
+
+TEST(CrashSignature, NoException) {
+  TestProcessSnapshot process_snapshot;
+  EXPECT_TRUE(CrashSignatureFromSnapshot(&process_snapshot).empty());
+}
+
+TEST(CrashSignature, ModuleRelative) {
+  const std::vector<uint8_t> build_id = {0x01, 0x02, 0x03, 0x04};
+
+  TestProcessSnapshot snapshot_1;
+  InitializeSnapshot(&snapshot_1, 0x10000000, build_id, 0x123, 0);
+  const std::string signature = CrashSignatureFromSnapshot(&snapshot_1);
+  EXPECT_EQ(signature.size(), 16u);
+
+  // The same crash in a module loaded elsewhere has the same signature.
+  TestProcessSnapshot snapshot_2;
+  InitializeSnapshot(&snapshot_2, 0x20000000, build_id, 0x123, 0);
+  EXPECT_EQ(CrashSignatureFromSnapshot(&snapshot_2), signature);
+
+  // A crash elsewhere in the module doesn’t.
+  TestProcessSnapshot snapshot_3;
+  InitializeSnapshot(&snapshot_3, 0x10000000, build_id, 0x456, 0);
+  EXPECT_NE(CrashSignatureFromSnapshot(&snapshot_3), signature);
+
+  // Nor does a crash in a different build of the module.
+  TestProcessSnapshot snapshot_4;
+  InitializeSnapshot(&snapshot_4, 0x10000000, {0x05, 0x06}, 0x123, 0);
+  EXPECT_NE(CrashSignatureFromSnapshot(&snapshot_4), signature);
+}
+
+TEST(CrashSignature, StackFrames) {
+  const std::vector<uint8_t> build_id = {0x01, 0x02, 0x03, 0x04};
+
+  // A stack full of 0x1111111111111111 points into a module loaded at
+  // 0x1111111111110000.
+  TestProcessSnapshot snapshot_1;
+  InitializeSnapshot(&snapshot_1, 0x1111111111110000, build_id, 0x123, 0x11);
+  TestProcessSnapshot snapshot_2;
+  InitializeSnapshot(&snapshot_2, 0x1111111111110000, build_id, 0x123, 0x22);
+  TestProcessSnapshot snapshot_3;
+  InitializeSnapshot(&snapshot_3, 0x1111111111110000, build_id, 0x123, 0x33);
+
+  // Stack values that don’t point into a module don’t contribute to the
+  // signature.
+  EXPECT_EQ(CrashSignatureFromSnapshot(&snapshot_2),
+            CrashSignatureFromSnapshot(&snapshot_3));
+  EXPECT_NE(CrashSignatureFromSnapshot(&snapshot_1),
+            CrashSignatureFromSnapshot(&snapshot_2));
+}
+
+TEST(ReportDeduplicator, Disabled) {
+  ReportDeduplicator deduplicator(0, 60);
+  EXPECT_FALSE(deduplicator.enabled());
+  unsigned int suppressed_count;
+  for (time_t now = 0; now < 10; ++now) {
+    EXPECT_TRUE(deduplicator.ShouldUpload("a", now, &suppressed_count));
+    EXPECT_EQ(suppressed_count, 0u);
+  }
+}
+
+TEST(ReportDeduplicator, Window) {
+  ReportDeduplicator deduplicator(2, 60);
+  EXPECT_TRUE(deduplicator.enabled());
+
+  unsigned int suppressed_count;
+  EXPECT_TRUE(deduplicator.ShouldUpload("a", 0, &suppressed_count));
+  EXPECT_EQ(suppressed_count, 0u);
+  EXPECT_TRUE(deduplicator.ShouldUpload("a", 1, &suppressed_count));
+  EXPECT_EQ(suppressed_count, 0u);
+  EXPECT_FALSE(deduplicator.ShouldUpload("a", 2, &suppressed_count));
+  EXPECT_FALSE(deduplicator.ShouldUpload("a", 3, &suppressed_count));
+  EXPECT_FALSE(deduplicator.ShouldUpload("a", 59, &suppressed_count));
+
+  // Other signatures and reports without signatures are unaffected.
+  EXPECT_TRUE(deduplicator.ShouldUpload("b", 4, &suppressed_count));
+  EXPECT_EQ(suppressed_count, 0u);
+  for (time_t now = 5; now < 10; ++now) {
+    EXPECT_TRUE(deduplicator.ShouldUpload(std::string(), now,
+                                          &suppressed_count));
+    EXPECT_EQ(suppressed_count, 0u);
+  }
+
+  // Once the window ends, the next report carries the count of those that
+  // were suppressed.
+  EXPECT_TRUE(deduplicator.ShouldUpload("a", 60, &suppressed_count));
+  EXPECT_EQ(suppressed_count, 3u);
+  EXPECT_TRUE(deduplicator.ShouldUpload("a", 61, &suppressed_count));
+  EXPECT_EQ(suppressed_count, 0u);
+  EXPECT_FALSE(deduplicator.ShouldUpload("a", 62, &suppressed_count));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
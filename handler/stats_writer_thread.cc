@@ -0,0 +1,58 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/stats_writer_thread.h"
+
+#include <vector>
+
+#include "client/crash_report_database.h"
+#include "util/misc/local_stats.h"
+
+namespace crashpad {
+
+StatsWriterThread::StatsWriterThread(CrashReportDatabase* database)
+    : thread_(kIntervalSeconds, this), database_(database) {}
+
+StatsWriterThread::~StatsWriterThread() {}
+
+void StatsWriterThread::Start() {
+  thread_.Start(0);
+}
+
+void StatsWriterThread::Stop() {
+  thread_.Stop();
+  DoWork(&thread_);
+}
+
+void StatsWriterThread::DoWork(const WorkerThread* thread) {
+  // Not every database implementation can summarize itself, in which case the
+  // gauges are left as they were.
+  CrashReportDatabase::ReportsSummary summary;
+  if (database_->GetReportsSummary(&summary)) {
+    LocalStats::SetGauge(LocalStats::Gauge::kDatabaseReports,
+                         summary.report_count);
+    LocalStats::SetGauge(LocalStats::Gauge::kDatabaseBytes, summary.total_size);
+  }
+
+  std::vector<CrashReportDatabase::Report> pending_reports;
+  if (database_->GetPendingReports(&pending_reports) ==
+      CrashReportDatabase::kNoError) {
+    LocalStats::SetGauge(LocalStats::Gauge::kPendingReports,
+                         pending_reports.size());
+  }
+
+  LocalStats::Write();
+}
+
+}  // namespace crashpad
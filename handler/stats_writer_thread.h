@@ -0,0 +1,66 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_STATS_WRITER_THREAD_H_
+#define CRASHPAD_HANDLER_STATS_WRITER_THREAD_H_
+
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class CrashReportDatabase;
+
+//! \brief A thread that periodically writes LocalStats to its file.
+//!
+//! Before each write, the database’s size and number of pending reports are
+//! sampled into LocalStats gauges. LocalStats must already be enabled.
+class StatsWriterThread : public WorkerThread::Delegate, public Stoppable {
+ public:
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] database The database to sample.
+  explicit StatsWriterThread(CrashReportDatabase* database);
+
+  StatsWriterThread(const StatsWriterThread&) = delete;
+  StatsWriterThread& operator=(const StatsWriterThread&) = delete;
+
+  ~StatsWriterThread();
+
+  //! \brief The number of seconds between writes.
+  static constexpr int kIntervalSeconds = 60;
+
+  // Stoppable:
+
+  //! \brief Starts the thread, which writes the stats immediately and then
+  //!     every #kIntervalSeconds.
+  void Start() override;
+
+  //! \brief Stops the thread, and writes the stats a final time so that the
+  //!     file reflects everything recorded before the handler exited.
+  //!
+  //! This method must only be called after Start().
+  void Stop() override;
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  WorkerThread thread_;
+  CrashReportDatabase* database_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_STATS_WRITER_THREAD_H_
@@ -0,0 +1,95 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_scheduler.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/rand_util.h"
+#include "util/net/http_retry_after.h"
+
+namespace crashpad {
+
+UploadScheduler::UploadScheduler()
+    : lock_(), deferred_until_(0), consecutive_deferrals_(0) {}
+
+UploadScheduler::~UploadScheduler() {}
+
+// static
+UploadScheduler::Priority UploadScheduler::GetPriority(
+    const CrashReportDatabase::Report& report) {
+  if (report.upload_explicitly_requested) {
+    return Priority::kUserRequested;
+  }
+  return report.upload_attempts == 0 ? Priority::kNew : Priority::kRetry;
+}
+
+void UploadScheduler::OrderReports(
+    std::vector<CrashReportDatabase::Report>* reports) {
+  std::stable_sort(reports->begin(),
+                   reports->end(),
+                   [](const CrashReportDatabase::Report& lhs,
+                      const CrashReportDatabase::Report& rhs) {
+                     return GetPriority(lhs) < GetPriority(rhs);
+                   });
+}
+
+bool UploadScheduler::MayUpload(const CrashReportDatabase::Report& report,
+                                time_t now) {
+  if (report.upload_explicitly_requested) {
+    return true;
+  }
+
+  base::AutoLock lock(lock_);
+  return now >= deferred_until_;
+}
+
+bool UploadScheduler::UploadAttempted(int http_status,
+                                      const std::string& retry_after,
+                                      time_t now) {
+  // 429 Too Many Requests (RFC 6585 §4) and 503 Service Unavailable (RFC 9110
+  // §15.6.4) both indicate that the server is overloaded, not that anything is
+  // wrong with the report.
+  if (http_status != 429 && http_status != 503) {
+    if (http_status >= 200 && http_status <= 203) {
+      base::AutoLock lock(lock_);
+      consecutive_deferrals_ = 0;
+    }
+    return false;
+  }
+
+  base::AutoLock lock(lock_);
+  ++consecutive_deferrals_;
+
+  time_t delay;
+  time_t retry_time;
+  if (ParseHTTPRetryAfter(retry_after, now, &retry_time)) {
+    delay = retry_time > now ? retry_time - now : 0;
+  } else {
+    // Double the delay for each consecutive deferral, and pick a random
+    // point in its second half.
+    const int shift = std::min(consecutive_deferrals_ - 1, 16);
+    delay = std::min(kInitialBackoffSeconds << shift, kMaximumBackoffSeconds);
+    delay = base::RandInt(static_cast<int>(delay / 2), static_cast<int>(delay));
+  }
+  delay = std::min(delay, kMaximumBackoffSeconds);
+
+  LOG(WARNING) << "HTTP status " << http_status << ", deferring uploads for "
+               << delay << " seconds";
+  deferred_until_ = std::max(deferred_until_, now + delay);
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_UPLOAD_SCHEDULER_H_
+#define CRASHPAD_HANDLER_UPLOAD_SCHEDULER_H_
+
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "client/crash_report_database.h"
+
+namespace crashpad {
+
+//! \brief Decides the order in which CrashReportUploadThread uploads pending
+//!     crash reports, and when uploads may be attempted.
+//!
+//! Reports are uploaded in order of priority: those whose upload was requested
+//! by the user first, then new ones, and finally those for which an upload has
+//! already been attempted.
+//!
+//! When the upload server responds with HTTP status 429 (Too Many Requests) or
+//! 503 (Service Unavailable), further uploads are deferred for the time given
+//! by its `Retry-After` header field. In the absence of that, the delay grows
+//! exponentially with each consecutive such response, with random jitter so
+//! that clients don’t all return to the server at once. Reports are left
+//! pending while uploads are deferred. Uploads explicitly requested by the user
+//! are never deferred.
+//!
+//! This behavior may be changed by subclassing. Methods may be called from
+//! multiple threads at once, so implementations must be thread-safe.
+class UploadScheduler {
+ public:
+  //! \brief The priority of a report’s upload. Lower values take precedence.
+  enum class Priority {
+    //! \brief The user explicitly requested upload.
+    kUserRequested = 0,
+
+    //! \brief No upload has been attempted yet.
+    kNew,
+
+    //! \brief A previous upload attempt failed.
+    kRetry,
+  };
+
+  //! \brief The delay following the first 429 or 503 response without a valid
+  //!     `Retry-After` field, in seconds.
+  static constexpr time_t kInitialBackoffSeconds = 60;
+
+  //! \brief The longest that uploads will be deferred, in seconds, whether by
+  //!     exponential backoff or by `Retry-After`.
+  static constexpr time_t kMaximumBackoffSeconds = 24 * 60 * 60;
+
+  UploadScheduler();
+
+  UploadScheduler(const UploadScheduler&) = delete;
+  UploadScheduler& operator=(const UploadScheduler&) = delete;
+
+  virtual ~UploadScheduler();
+
+  //! \return The priority of \a report’s upload.
+  static Priority GetPriority(const CrashReportDatabase::Report& report);
+
+  //! \brief Sorts \a reports into the order in which they should be uploaded.
+  //!
+  //! The default implementation orders them by GetPriority(), and otherwise
+  //! keeps their existing order.
+  virtual void OrderReports(std::vector<CrashReportDatabase::Report>* reports);
+
+  //! \brief Determines whether an upload of \a report may be attempted.
+  //!
+  //! \param[in] report The report to be uploaded.
+  //! \param[in] now The current time.
+  //!
+  //! \return `true` if the upload may proceed. `false` if it must be deferred,
+  //!     in which case \a report is left pending.
+  virtual bool MayUpload(const CrashReportDatabase::Report& report, time_t now);
+
+  //! \brief Informs the scheduler of the result of an upload attempt.
+  //!
+  //! \param[in] http_status The HTTP status code of the server’s response, or
+  //!     `0` if no response was received.
+  //! \param[in] retry_after The value of the response’s `Retry-After` header
+  //!     field, or an empty string if it had none.
+  //! \param[in] now The time at which the response was received.
+  //!
+  //! \return `true` if the server asked for uploads to be deferred, in which
+  //!     case the report should be left pending so that its upload will be
+  //!     retried. `false` otherwise.
+  virtual bool UploadAttempted(int http_status,
+                               const std::string& retry_after,
+                               time_t now);
+
+ private:
+  base::Lock lock_;
+  time_t deferred_until_;  // Protected by lock_.
+  int consecutive_deferrals_;  // Protected by lock_.
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_UPLOAD_SCHEDULER_H_
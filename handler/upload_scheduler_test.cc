@@ -0,0 +1,114 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_scheduler.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+CrashReportDatabase::Report MakeReport(const std::string& id,
+                                       bool upload_explicitly_requested,
+                                       int upload_attempts) {
+  CrashReportDatabase::Report report;
+  report.id = id;
+  report.upload_explicitly_requested = upload_explicitly_requested;
+  report.upload_attempts = upload_attempts;
+  return report;
+}
+
+TEST(UploadScheduler, OrderReports) {
+  std::vector<CrashReportDatabase::Report> reports = {
+      MakeReport("retry 1", false, 1),
+      MakeReport("new 1", false, 0),
+      MakeReport("user 1", true, 2),
+      MakeReport("retry 2", false, 3),
+      MakeReport("new 2", false, 0),
+      MakeReport("user 2", true, 0),
+  };
+
+  UploadScheduler scheduler;
+  scheduler.OrderReports(&reports);
+
+  static constexpr const char* kExpected[] = {
+      "user 1", "user 2", "new 1", "new 2", "retry 1", "retry 2"};
+  ASSERT_EQ(reports.size(), std::size(kExpected));
+  for (size_t index = 0; index < reports.size(); ++index) {
+    EXPECT_EQ(reports[index].id, kExpected[index]);
+  }
+}
+
+TEST(UploadScheduler, RetryAfter) {
+  constexpr time_t kNow = 1000000000;
+  const CrashReportDatabase::Report report = MakeReport("new", false, 0);
+  const CrashReportDatabase::Report user_report = MakeReport("user", true, 0);
+
+  UploadScheduler scheduler;
+  EXPECT_TRUE(scheduler.MayUpload(report, kNow));
+
+  // Other failures don’t defer uploads.
+  EXPECT_FALSE(scheduler.UploadAttempted(0, std::string(), kNow));
+  EXPECT_FALSE(scheduler.UploadAttempted(500, "120", kNow));
+  EXPECT_TRUE(scheduler.MayUpload(report, kNow));
+
+  EXPECT_TRUE(scheduler.UploadAttempted(503, "120", kNow));
+  EXPECT_FALSE(scheduler.MayUpload(report, kNow));
+  EXPECT_FALSE(scheduler.MayUpload(report, kNow + 119));
+  EXPECT_TRUE(scheduler.MayUpload(report, kNow + 120));
+
+  // Uploads requested by the user aren’t deferred.
+  EXPECT_TRUE(scheduler.MayUpload(user_report, kNow));
+
+  // Retry-After is capped.
+  EXPECT_TRUE(scheduler.UploadAttempted(429, "999999999", kNow));
+  EXPECT_FALSE(scheduler.MayUpload(
+      report, kNow + UploadScheduler::kMaximumBackoffSeconds - 1));
+  EXPECT_TRUE(scheduler.MayUpload(
+      report, kNow + UploadScheduler::kMaximumBackoffSeconds));
+}
+
+TEST(UploadScheduler, ExponentialBackoff) {
+  const CrashReportDatabase::Report report = MakeReport("new", false, 0);
+
+  UploadScheduler scheduler;
+  time_t now = 1000000000;
+  time_t expected_delay = UploadScheduler::kInitialBackoffSeconds;
+  for (int deferral = 0; deferral < 20; ++deferral) {
+    SCOPED_TRACE(deferral);
+    EXPECT_TRUE(scheduler.UploadAttempted(429, "soon", now));
+
+    // The delay is in the second half of the expected delay.
+    EXPECT_FALSE(scheduler.MayUpload(report, now + expected_delay / 2 - 1));
+    EXPECT_TRUE(scheduler.MayUpload(report, now + expected_delay));
+
+    now += expected_delay;
+    expected_delay = std::min(expected_delay * 2,
+                              UploadScheduler::kMaximumBackoffSeconds);
+  }
+
+  // A success resets the backoff.
+  EXPECT_FALSE(scheduler.UploadAttempted(200, std::string(), now));
+  EXPECT_TRUE(scheduler.UploadAttempted(503, std::string(), now));
+  EXPECT_TRUE(scheduler.MayUpload(
+      report, now + UploadScheduler::kInitialBackoffSeconds));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
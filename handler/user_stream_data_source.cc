@@ -14,30 +14,137 @@
 
 #include "handler/user_stream_data_source.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "base/logging.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/process_snapshot.h"
+#include "util/misc/clock.h"
+#include "util/misc/deadline.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
-void AddUserExtensionStreams(
+namespace {
+
+constexpr uint64_t kNanosecondsPerMillisecond = 1000000;
+
+struct ProducedStream {
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source;
+  uint64_t duration_ns = 0;
+  bool timed_out = false;
+};
+
+// Calls data sources, each taking the next one that no thread has started,
+// until none remain.
+class UserStreamDataSourceThread : public Thread {
+ public:
+  UserStreamDataSourceThread(const UserStreamDataSources* sources,
+                             ProcessSnapshot* process_snapshot,
+                             uint64_t time_limit_ns,
+                             std::atomic<size_t>* next_index,
+                             std::vector<ProducedStream>* streams)
+      : Thread(),
+        sources_(sources),
+        process_snapshot_(process_snapshot),
+        time_limit_ns_(time_limit_ns),
+        next_index_(next_index),
+        streams_(streams) {}
+
+  UserStreamDataSourceThread(const UserStreamDataSourceThread&) = delete;
+  UserStreamDataSourceThread& operator=(const UserStreamDataSourceThread&) =
+      delete;
+
+  ~UserStreamDataSourceThread() override {}
+
+  void ThreadMain() override {
+    size_t index;
+    while ((index = next_index_->fetch_add(1)) < sources_->size()) {
+      ProducedStream& stream = (*streams_)[index];
+      const uint64_t start_ns = ClockMonotonicNanoseconds();
+      const Deadline deadline = Deadline::FromNow(time_limit_ns_);
+      stream.data_source =
+          (*sources_)[index]->ProduceStreamDataWithDeadline(process_snapshot_,
+                                                            deadline);
+      stream.duration_ns = ClockMonotonicNanoseconds() - start_ns;
+      if (deadline.Expired()) {
+        stream.data_source.reset();
+        stream.timed_out = true;
+      }
+    }
+  }
+
+ private:
+  const UserStreamDataSources* sources_;  // weak
+  ProcessSnapshot* process_snapshot_;  // weak
+  uint64_t time_limit_ns_;
+  std::atomic<size_t>* next_index_;  // weak
+  std::vector<ProducedStream>* streams_;  // weak
+};
+
+}  // namespace
+
+std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+UserStreamDataSource::ProduceStreamDataWithDeadline(
+    ProcessSnapshot* process_snapshot,
+    const Deadline& deadline) {
+  return ProduceStreamData(process_snapshot);
+}
+
+size_t AddUserExtensionStreams(
     const UserStreamDataSources* user_stream_data_sources,
     ProcessSnapshot* process_snapshot,
-    MinidumpFileWriter* minidump_file_writer) {
+    MinidumpFileWriter* minidump_file_writer,
+    const UserStreamDataSourceOptions& options) {
   if (!user_stream_data_sources)
-    return;
-  for (const auto& source : *user_stream_data_sources) {
-    std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source(
-        source->ProduceStreamData(process_snapshot));
-    if (data_source &&
-        !minidump_file_writer->AddUserExtensionStream(std::move(data_source))) {
+    return 0;
+
+  // The calling thread calls data sources alongside any additional threads.
+  std::vector<ProducedStream> streams(user_stream_data_sources->size());
+  std::atomic<size_t> next_index(0);
+  std::vector<std::unique_ptr<UserStreamDataSourceThread>> workers;
+  for (size_t index = 1;
+       index < std::min(options.threads, user_stream_data_sources->size());
+       ++index) {
+    workers.push_back(std::make_unique<UserStreamDataSourceThread>(
+        user_stream_data_sources,
+        process_snapshot,
+        options.time_limit_ns,
+        &next_index,
+        &streams));
+    workers.back()->Start();
+  }
+  UserStreamDataSourceThread(user_stream_data_sources,
+                             process_snapshot,
+                             options.time_limit_ns,
+                             &next_index,
+                             &streams)
+      .ThreadMain();
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  size_t timed_out = 0;
+  for (size_t index = 0; index < streams.size(); ++index) {
+    ProducedStream& stream = streams[index];
+    if (stream.timed_out) {
+      LOG(WARNING) << "user stream data source " << index << " took "
+                   << stream.duration_ns / kNanosecondsPerMillisecond
+                   << " ms, leaving its stream out";
+      ++timed_out;
+      continue;
+    }
+    if (stream.data_source && !minidump_file_writer->AddUserExtensionStream(
+                                  std::move(stream.data_source))) {
       // This should only happen if multiple user stream sources yield the
       // same stream type. It's the user's responsibility to make sure
       // sources don't collide on the same stream type.
       LOG(ERROR) << "AddUserExtensionStream failed";
     }
   }
+  return timed_out;
 }
 
 }  // namespace crashpad
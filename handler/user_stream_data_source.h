@@ -15,11 +15,15 @@
 #ifndef CRASHPAD_HANDLER_USER_STREAM_DATA_SOURCE_H_
 #define CRASHPAD_HANDLER_USER_STREAM_DATA_SOURCE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <vector>
 
 namespace crashpad {
 
+class Deadline;
 class MinidumpFileWriter;
 class MinidumpUserExtensionStreamDataSource;
 class ProcessSnapshot;
@@ -39,29 +43,77 @@ class UserStreamDataSource {
   //! \param[in] process_snapshot An initialized snapshot for the crashed
   //!     process.
   //!
+  //! The returned data source’s ReadStreamData() isn’t called until the
+  //! minidump is written, after every data source has produced its stream.
+  //! Only its size must be known when it is returned, so a large stream can be
+  //! generated piece by piece as it is written rather than held in memory.
+  //!
   //! \return A new data source for the stream to add to the minidump or
   //!      `nullptr` on failure or to opt out of adding a stream.
   virtual std::unique_ptr<MinidumpUserExtensionStreamDataSource>
   ProduceStreamData(ProcessSnapshot* process_snapshot) = 0;
+
+  //! \brief Produce the contents for an extension stream for a crashed
+  //!     program, giving up once \a deadline expires.
+  //!
+  //! This is what AddUserExtensionStreams() calls. Its default implementation
+  //! calls ProduceStreamData() and ignores \a deadline. Data sources that
+  //! can take a long time should override it to check the deadline as they
+  //! work, and return early once it has expired. A stream returned after the
+  //! deadline is left out of the minidump.
+  //!
+  //! \param[in] process_snapshot An initialized snapshot for the crashed
+  //!     process.
+  //! \param[in] deadline The time by which the stream must be produced.
+  //!
+  //! \return A new data source for the stream to add to the minidump or
+  //!      `nullptr` on failure or to opt out of adding a stream.
+  virtual std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+  ProduceStreamDataWithDeadline(ProcessSnapshot* process_snapshot,
+                                const Deadline& deadline);
 };
 
 using UserStreamDataSources =
     std::vector<std::unique_ptr<UserStreamDataSource>>;
 
+//! \brief Options controlling how AddUserExtensionStreams() calls data
+//!     sources.
+struct UserStreamDataSourceOptions {
+  //! \brief The number of threads, including the caller’s, on which to call
+  //!     data sources at once. `0` and `1` call them one at a time.
+  //!
+  //! With more than one thread, data sources are called concurrently with the
+  //! same ProcessSnapshot, and must be safe to call that way.
+  size_t threads = 1;
+
+  //! \brief The time each data source is given to produce its stream, in
+  //!     nanoseconds, or `0` for no limit.
+  //!
+  //! A data source’s time starts when it is called, not when
+  //! AddUserExtensionStreams() is.
+  uint64_t time_limit_ns = 0;
+};
+
 //! \brief Adds user extension streams to a minidump.
 //!
 //! Dispatches to each source in \a user_stream_data_sources and adds returned
-//! extension streams to \a minidump_file_writer.
+//! extension streams to \a minidump_file_writer, in the order of the sources
+//! regardless of the order in which they finish.
 //!
 //! \param[in] user_stream_data_sources A pointer to the data sources, or
 //!     `nullptr`.
 //! \param[in] process_snapshot An initialized snapshot to the crashing process.
 //! \param[in] minidump_file_writer Any extension streams will be added to this
 //!     minidump.
-void AddUserExtensionStreams(
+//! \param[in] options How to call the data sources.
+//!
+//! \return The number of data sources whose streams were left out because they
+//!     took longer than \a options.time_limit_ns. Each is logged.
+size_t AddUserExtensionStreams(
     const UserStreamDataSources* user_stream_data_sources,
     ProcessSnapshot* process_snapshot,
-    MinidumpFileWriter* minidump_file_writer);
+    MinidumpFileWriter* minidump_file_writer,
+    const UserStreamDataSourceOptions& options = UserStreamDataSourceOptions());
 
 }  // namespace crashpad
 
@@ -0,0 +1,189 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/user_stream_data_source.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_user_extension_stream_util.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+#include "util/misc/deadline.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint32_t kStreamType = 0x4d000000;
+
+class TestUserStreamDataSource : public UserStreamDataSource {
+ public:
+  explicit TestUserStreamDataSource(uint32_t stream_type)
+      : stream_type_(stream_type) {}
+
+  TestUserStreamDataSource(const TestUserStreamDataSource&) = delete;
+  TestUserStreamDataSource& operator=(const TestUserStreamDataSource&) =
+      delete;
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> ProduceStreamData(
+      ProcessSnapshot* process_snapshot) override {
+    return std::make_unique<BufferExtensionStreamDataSource>(
+        stream_type_, &stream_type_, sizeof(stream_type_));
+  }
+
+ private:
+  uint32_t stream_type_;
+};
+
+// Signals one semaphore and waits for another, so that a pair of these can
+// only both produce streams if they are called at the same time.
+class RendezvousUserStreamDataSource final : public TestUserStreamDataSource {
+ public:
+  RendezvousUserStreamDataSource(uint32_t stream_type,
+                                 Semaphore* arrived,
+                                 Semaphore* other_arrived)
+      : TestUserStreamDataSource(stream_type),
+        arrived_(arrived),
+        other_arrived_(other_arrived) {}
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> ProduceStreamData(
+      ProcessSnapshot* process_snapshot) override {
+    arrived_->Signal();
+    if (!other_arrived_->TimedWait(10)) {
+      return nullptr;
+    }
+    return TestUserStreamDataSource::ProduceStreamData(process_snapshot);
+  }
+
+ private:
+  Semaphore* arrived_;  // weak
+  Semaphore* other_arrived_;  // weak
+};
+
+// Waits for its deadline to pass before producing a stream.
+class SlowUserStreamDataSource final : public TestUserStreamDataSource {
+ public:
+  explicit SlowUserStreamDataSource(uint32_t stream_type)
+      : TestUserStreamDataSource(stream_type), deadline_set_(false) {}
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+  ProduceStreamDataWithDeadline(ProcessSnapshot* process_snapshot,
+                                const Deadline& deadline) override {
+    deadline_set_ = deadline.IsSet();
+    while (deadline.IsSet() && !deadline.Expired()) {
+      SleepNanoseconds(1000 * 1000);
+    }
+    return ProduceStreamData(process_snapshot);
+  }
+
+  bool deadline_set() const { return deadline_set_; }
+
+ private:
+  bool deadline_set_;
+};
+
+// Writes the minidump and returns the types of its streams, in order.
+std::vector<uint32_t> StreamTypes(MinidumpFileWriter* minidump) {
+  StringFile string_file;
+  EXPECT_TRUE(minidump->WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  std::vector<uint32_t> types;
+  if (!header) {
+    return types;
+  }
+  for (uint32_t index = 0; index < header->NumberOfStreams; ++index) {
+    types.push_back(directory[index].StreamType);
+  }
+  return types;
+}
+
+TEST(UserStreamDataSource, NoSources) {
+  MinidumpFileWriter minidump;
+  EXPECT_EQ(AddUserExtensionStreams(nullptr, nullptr, &minidump), 0u);
+  EXPECT_TRUE(StreamTypes(&minidump).empty());
+}
+
+TEST(UserStreamDataSource, Serial) {
+  UserStreamDataSources sources;
+  for (uint32_t index = 0; index < 3; ++index) {
+    sources.push_back(
+        std::make_unique<TestUserStreamDataSource>(kStreamType + index));
+  }
+
+  MinidumpFileWriter minidump;
+  EXPECT_EQ(AddUserExtensionStreams(&sources, nullptr, &minidump), 0u);
+  EXPECT_EQ(
+      StreamTypes(&minidump),
+      (std::vector<uint32_t>{kStreamType, kStreamType + 1, kStreamType + 2}));
+}
+
+TEST(UserStreamDataSource, Concurrent) {
+  Semaphore first_arrived(0);
+  Semaphore second_arrived(0);
+  UserStreamDataSources sources;
+  sources.push_back(std::make_unique<RendezvousUserStreamDataSource>(
+      kStreamType, &first_arrived, &second_arrived));
+  sources.push_back(
+      std::make_unique<TestUserStreamDataSource>(kStreamType + 1));
+  sources.push_back(std::make_unique<RendezvousUserStreamDataSource>(
+      kStreamType + 2, &second_arrived, &first_arrived));
+
+  UserStreamDataSourceOptions options;
+  options.threads = 3;
+  MinidumpFileWriter minidump;
+  EXPECT_EQ(AddUserExtensionStreams(&sources, nullptr, &minidump, options),
+            0u);
+
+  // Both halves of the rendezvous produced their streams, and the streams are
+  // in the order of their sources.
+  EXPECT_EQ(
+      StreamTypes(&minidump),
+      (std::vector<uint32_t>{kStreamType, kStreamType + 1, kStreamType + 2}));
+}
+
+TEST(UserStreamDataSource, TimeLimit) {
+  UserStreamDataSources sources;
+  sources.push_back(std::make_unique<TestUserStreamDataSource>(kStreamType));
+  auto slow_source =
+      std::make_unique<SlowUserStreamDataSource>(kStreamType + 1);
+  SlowUserStreamDataSource* slow = slow_source.get();
+  sources.push_back(std::move(slow_source));
+  sources.push_back(
+      std::make_unique<TestUserStreamDataSource>(kStreamType + 2));
+
+  UserStreamDataSourceOptions options;
+  options.threads = 2;
+  options.time_limit_ns = 10 * 1000 * 1000;
+  MinidumpFileWriter minidump;
+  EXPECT_EQ(AddUserExtensionStreams(&sources, nullptr, &minidump, options),
+            1u);
+  EXPECT_TRUE(slow->deadline_set());
+  EXPECT_EQ(StreamTypes(&minidump),
+            (std::vector<uint32_t>{kStreamType, kStreamType + 2}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
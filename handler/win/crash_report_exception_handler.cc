@@ -14,6 +14,7 @@
 
 #include "handler/win/crash_report_exception_handler.h"
 
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -21,12 +22,14 @@
 #include "client/crash_report_database.h"
 #include "client/settings.h"
 #include "handler/crash_report_upload_thread.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_deduplicator.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/win/process_snapshot_win.h"
-#include "util/file/file_helper.h"
 #include "util/file/file_writer.h"
 #include "util/misc/metrics.h"
+#include "util/win/pss_snapshot.h"
 #include "util/win/registration_protocol_win.h"
 #include "util/win/scoped_process_suspend.h"
 #include "util/win/termination_codes.h"
@@ -43,7 +46,11 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       upload_thread_(upload_thread),
       process_annotations_(process_annotations),
       attachments_(attachments),
-      user_stream_data_sources_(user_stream_data_sources) {}
+      user_stream_data_sources_(user_stream_data_sources),
+      use_pss_snapshot_(false),
+      handle_options_(),
+      compact_memory_info_(false),
+      module_metadata_cache_() {}
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() {}
 
@@ -55,16 +62,31 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     WinVMAddress debug_critical_section_address) {
   Metrics::ExceptionEncountered();
 
-  ScopedProcessSuspend suspend(process);
+  auto suspend = std::make_unique<ScopedProcessSuspend>(process);
+
+  // The PssSnapshot must outlive process_snapshot, which reads from it.
+  std::unique_ptr<PssSnapshot> pss_snapshot;
+  BOOL is_wow64;
+  if (use_pss_snapshot_ && IsWow64Process(process, &is_wow64) && !is_wow64) {
+    pss_snapshot = std::make_unique<PssSnapshot>();
+    if (pss_snapshot->Initialize(process)) {
+      suspend.reset();
+    } else {
+      pss_snapshot.reset();
+    }
+  }
 
   ProcessSnapshotWin process_snapshot;
   if (!process_snapshot.Initialize(process,
                                    ProcessSuspensionState::kSuspended,
                                    exception_information_address,
-                                   debug_critical_section_address)) {
+                                   debug_critical_section_address,
+                                   pss_snapshot.get(),
+                                   &module_metadata_cache_)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return kTerminationCodeSnapshotFailed;
   }
+  process_snapshot.SetHandleOptions(handle_options_);
 
   // Now that we have the exception information, even if something else fails we
   // can terminate the process with the correct exit code.
@@ -102,9 +124,17 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
 
     MinidumpFileWriter minidump;
     minidump.InitializeFromSnapshot(&process_snapshot);
+    minidump.SetCompactMemoryInfo(compact_memory_info_, compact_memory_info_);
     AddUserExtensionStreams(
         user_stream_data_sources_, &process_snapshot, &minidump);
 
+    // Stored so that uploading the report doesn’t require parsing the minidump.
+    if (!new_report->SetUploadParameters(
+            BreakpadHTTPFormParametersFromMinidump(&process_snapshot),
+            CrashSignatureFromSnapshot(&process_snapshot))) {
+      LOG(WARNING) << "couldn't store upload parameters";
+    }
+
     if (!minidump.WriteEverything(new_report->Writer())) {
       LOG(ERROR) << "WriteEverything failed";
       Metrics::ExceptionCaptureResult(
@@ -113,23 +143,11 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     }
 
     for (const auto& attachment : (*attachments_)) {
-      FileReader file_reader;
-      if (!file_reader.Open(attachment)) {
+      if (!new_report->AddAttachmentFromFile(
+              base::WideToUTF8(attachment.BaseName().value()), attachment)) {
         LOG(ERROR) << "attachment " << attachment
-                   << " couldn't be opened, skipping";
-        continue;
+                   << " couldn't be added, skipping";
       }
-
-      base::FilePath filename = attachment.BaseName();
-      FileWriter* file_writer =
-          new_report->AddAttachment(base::WideToUTF8(filename.value()));
-      if (file_writer == nullptr) {
-        LOG(ERROR) << "attachment " << filename
-                   << " couldn't be created, skipping";
-        continue;
-      }
-
-      CopyFileContent(&file_reader, file_writer);
     }
 
     UUID uuid;
@@ -21,7 +21,9 @@
 #include <string>
 
 #include "handler/user_stream_data_source.h"
+#include "snapshot/module_metadata_cache.h"
 #include "util/win/exception_handler_server.h"
+#include "util/win/process_info.h"
 
 namespace crashpad {
 
@@ -78,12 +80,45 @@ class CrashReportExceptionHandler final
       WinVMAddress exception_information_address,
       WinVMAddress debug_critical_section_address) override;
 
+  //! \brief Sets whether crashing processes are captured with a PssSnapshot.
+  //!
+  //! When enabled, a crashing process is suspended only while a PssSnapshot
+  //! of it is captured, and its crash report is written from the snapshot
+  //! after it has been resumed. If the snapshot can’t be captured, the
+  //! process remains suspended while it is read directly.
+  void SetUsePssSnapshot(bool use_pss_snapshot) {
+    use_pss_snapshot_ = use_pss_snapshot;
+  }
+
+  //! \brief Limits the handles recorded in crash reports.
+  //!
+  //! \sa ProcessInfo::HandleOptions
+  void SetHandleOptions(const ProcessInfo::HandleOptions& handle_options) {
+    handle_options_ = handle_options;
+  }
+
+  //! \brief Sets whether the memory info stream is compacted.
+  //!
+  //! When enabled, adjacent regions that differ only in their allocation are
+  //! merged, and free, reserved, and guard regions are left out.
+  //!
+  //! \sa MinidumpFileWriter::SetCompactMemoryInfo()
+  void SetCompactMemoryInfo(bool compact_memory_info) {
+    compact_memory_info_ = compact_memory_info;
+  }
+
  private:
   CrashReportDatabase* database_;  // weak
   CrashReportUploadThread* upload_thread_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const std::vector<base::FilePath>* attachments_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  bool use_pss_snapshot_;
+  ProcessInfo::HandleOptions handle_options_;
+  bool compact_memory_info_;
+
+  // Reused across snapshots of different clients.
+  ModuleMetadataCache module_metadata_cache_;
 };
 
 }  // namespace crashpad
@@ -21,6 +21,8 @@
 #include "util/win/registration_protocol_win_structs.h"
 
 #include <Windows.h>
+#include <dbghelp.h>
+#include <stdio.h>
 #include <werapi.h>
 
 namespace crashpad::wer {
@@ -73,10 +75,83 @@ ScopedHandle DuplicateFromTarget(HANDLE target_process, HANDLE target_handle) {
   return ScopedHandle(hTmp);
 }
 
-bool ProcessException(const DWORD* handled_exceptions,
-                      size_t num_handled_exceptions,
-                      const PVOID pContext,
-                      const PWER_RUNTIME_EXCEPTION_INFORMATION e_info) {
+// Excludes every thread except the crashing one, whose ID is |param|, from a
+// triage minidump.
+BOOL CALLBACK TriageDumpCallback(PVOID param,
+                                 PMINIDUMP_CALLBACK_INPUT input,
+                                 PMINIDUMP_CALLBACK_OUTPUT output) {
+  if (input->CallbackType == IncludeThreadCallback) {
+    return input->IncludeThread.ThreadId == *static_cast<const DWORD*>(param);
+  }
+  return TRUE;
+}
+
+// Writes a minidump of the target holding just enough to triage the crash to a
+// new file in |directory|. This only uses data WerFault has already collected
+// and the process handle it provides, so it doesn’t depend on the crashpad
+// handler being responsive.
+bool WriteTriageDump(const PWER_RUNTIME_EXCEPTION_INFORMATION e_info,
+                     const wchar_t* directory) {
+  DWORD process_id = GetProcessId(e_info->hProcess);
+  DWORD thread_id = GetThreadId(e_info->hThread);
+  if (!process_id || !thread_id)
+    return false;
+
+  wchar_t path[MAX_PATH];
+  if (swprintf_s(path,
+                 L"%ls\\crashpad_wer_triage_%lu_%llu.dmp",
+                 directory,
+                 process_id,
+                 GetTickCount64()) < 0) {
+    return false;
+  }
+
+  // WerFault has already copied the exception record and context into this
+  // process, so point the minidump writer at these local copies.
+  EXCEPTION_RECORD exception_record = e_info->exceptionRecord;
+  CONTEXT context = e_info->context;
+  EXCEPTION_POINTERS pointers = {&exception_record, &context};
+  MINIDUMP_EXCEPTION_INFORMATION exception_information = {};
+  exception_information.ThreadId = thread_id;
+  exception_information.ExceptionPointers = &pointers;
+  exception_information.ClientPointers = FALSE;
+
+  MINIDUMP_CALLBACK_INFORMATION callback_information = {};
+  callback_information.CallbackRoutine = TriageDumpCallback;
+  callback_information.CallbackParam = &thread_id;
+
+  BOOL written;
+  {
+    ScopedHandle file(CreateFileW(path,
+                                  GENERIC_WRITE,
+                                  0,
+                                  nullptr,
+                                  CREATE_NEW,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr));
+    if (!file.IsValid())
+      return false;
+
+    written = MiniDumpWriteDump(e_info->hProcess,
+                                process_id,
+                                file.Get(),
+                                MiniDumpNormal,
+                                &exception_information,
+                                nullptr,
+                                &callback_information);
+  }
+
+  if (!written) {
+    DeleteFileW(path);
+    return false;
+  }
+  return true;
+}
+
+bool ShouldProcessException(const DWORD* handled_exceptions,
+                            size_t num_handled_exceptions,
+                            const PVOID pContext,
+                            const PWER_RUNTIME_EXCEPTION_INFORMATION e_info) {
   // Need to have been given a context.
   if (!pContext)
     return false;
@@ -106,6 +181,13 @@ bool ProcessException(const DWORD* handled_exceptions,
   if (!found && num_handled_exceptions != 0)
     return false;
 
+  return true;
+}
+
+// Asks the crashpad handler registered by the target to dump it, returning
+// true if it signals that it has done so.
+bool RequestHandlerDump(const PVOID pContext,
+                        const PWER_RUNTIME_EXCEPTION_INFORMATION e_info) {
   // Grab out the handles to the crashpad server.
   WerRegistration target_registration = {};
   if (!ReadProcessMemory(e_info->hProcess,
@@ -182,14 +264,34 @@ bool ProcessException(const DWORD* handled_exceptions,
   constexpr DWORD kTenSecondsInMs = 10 * 1000;
   DWORD result = WaitForSingleObject(dump_done.Get(), kTenSecondsInMs);
 
-  if (result == WAIT_OBJECT_0) {
-    // The handler signalled that it has written a dump, so we can terminate the
-    // target - this takes over from WER, sorry WER.
-    TerminateProcess(e_info->hProcess, e_info->exceptionRecord.ExceptionCode);
-    return true;
+  return result == WAIT_OBJECT_0;
+}
+
+bool ProcessException(const DWORD* handled_exceptions,
+                      size_t num_handled_exceptions,
+                      const PVOID pContext,
+                      const PWER_RUNTIME_EXCEPTION_INFORMATION e_info,
+                      const ExceptionEventOptions& options) {
+  if (!ShouldProcessException(
+          handled_exceptions, num_handled_exceptions, pContext, e_info)) {
+    return false;
+  }
+
+  // The triage dump is written first, so that it exists even if the handler
+  // later fails or times out.
+  const bool triage_dump_written =
+      options.triage_dump_directory &&
+      WriteTriageDump(e_info, options.triage_dump_directory);
+
+  if (!RequestHandlerDump(pContext, e_info) && !triage_dump_written) {
+    // Maybe some other handler can have a go.
+    return false;
   }
-  // Maybe some other handler can have a go.
-  return false;
+
+  // A dump has been written, so we can terminate the target - this takes over
+  // from WER, sorry WER.
+  TerminateProcess(e_info->hProcess, e_info->exceptionRecord.ExceptionCode);
+  return true;
 }
 }  // namespace
 
@@ -201,7 +303,21 @@ bool ExceptionEvent(
   return ProcessException(handled_exceptions,
                           num_handled_exceptions,
                           pContext,
-                          pExceptionInformation);
+                          pExceptionInformation,
+                          ExceptionEventOptions());
+}
+
+bool ExceptionEvent(
+    const DWORD* handled_exceptions,
+    size_t num_handled_exceptions,
+    const PVOID pContext,
+    const PWER_RUNTIME_EXCEPTION_INFORMATION pExceptionInformation,
+    const ExceptionEventOptions& options) {
+  return ProcessException(handled_exceptions,
+                          num_handled_exceptions,
+                          pContext,
+                          pExceptionInformation,
+                          options);
 }
 
 }  // namespace crashpad::wer
@@ -19,6 +19,22 @@
 #include <werapi.h>
 
 namespace crashpad::wer {
+
+//! \brief Options for ExceptionEvent().
+struct ExceptionEventOptions {
+  //! \brief A directory to write a triage minidump to, or `nullptr`.
+  //!
+  //! When set, the helper writes a small minidump of the target to this
+  //! directory itself, using the process handle provided by WerFault, before
+  //! asking the crashpad handler for its full dump. The triage minidump
+  //! contains the exception record, the crashing thread’s context and stack,
+  //! and the module list. Because that data is then already saved, the target
+  //! is terminated and the exception claimed even if the crashpad handler can’t
+  //! be reached or doesn’t finish its dump in time. Otherwise, the exception
+  //! would be left for the rest of WER to handle.
+  const wchar_t* triage_dump_directory = nullptr;
+};
+
 //! \brief Embedder calls this from OutOfProcessExceptionEventCallback().
 //!
 //! In the embedder's WER runtime exception helper, call this during
@@ -42,6 +58,20 @@ bool ExceptionEvent(
     const PVOID pContext,
     const PWER_RUNTIME_EXCEPTION_INFORMATION pExceptionInformation);
 
+//! \brief Embedder calls this from OutOfProcessExceptionEventCallback().
+//!
+//! This is the same as the other overload, with additional \a options.
+//!
+//! \return `true` if the target process was dumped by the crashpad handler or,
+//! if requested by \a options, a triage minidump was written, and the target
+//! process was then terminated. `false` otherwise.
+bool ExceptionEvent(
+    const DWORD* handled_exceptions,
+    size_t num_handled_exceptions,
+    const PVOID pContext,
+    const PWER_RUNTIME_EXCEPTION_INFORMATION pExceptionInformation,
+    const ExceptionEventOptions& options);
+
 }  // namespace crashpad::wer
 
 #endif  // CRASHPAD_HANDLER_WIN_WER_CRASHPAD_WER_H_
@@ -49,6 +49,13 @@ void MinidumpAnnotationWriter::InitializeWithData(
   value_.set_data(data);
 }
 
+void MinidumpAnnotationWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  table->Add(&name_);
+}
+
 bool MinidumpAnnotationWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -110,6 +117,15 @@ bool MinidumpAnnotationListWriter::IsUseful() const {
   return !objects_.empty();
 }
 
+void MinidumpAnnotationListWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const auto& object : objects_) {
+    object->AddStringsToTable(table);
+  }
+}
+
 bool MinidumpAnnotationListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -54,6 +54,13 @@ class MinidumpAnnotationWriter final : public internal::MinidumpWritable {
   //! \brief Returns the MinidumpAnnotation referencing this object’s data.
   const MinidumpAnnotation* minidump_annotation() const { return &annotation_; }
 
+
+  //! \brief Adds the annotation’s name to \a table, so that a name used by
+  //!     several annotations is only written once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
 
@@ -96,6 +103,12 @@ class MinidumpAnnotationListWriter final : public internal::MinidumpWritable {
   //! \return `true` if the object is useful, `false` otherwise.
   bool IsUseful() const;
 
+
+  //! \brief Adds the names of all annotations in the list to \a table.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
 
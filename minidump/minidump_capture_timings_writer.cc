@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_capture_timings_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/misc/capture_timings.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpCaptureTimingsWriter::MinidumpCaptureTimingsWriter()
+    : MinidumpStreamWriter(),
+      entries_(),
+      remote_reads_(),
+      timings_(),
+      remote_reads_list_() {
+  timings_.version = MinidumpCaptureTimings::kVersion;
+}
+
+MinidumpCaptureTimingsWriter::~MinidumpCaptureTimingsWriter() = default;
+
+void MinidumpCaptureTimingsWriter::InitializeFromCaptureTimings(
+    const CaptureTimings& capture_timings) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(entries_.empty());
+  DCHECK(remote_reads_.empty());
+
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CaptureTimings::Phase::kMaxValue);
+       ++index) {
+    const auto phase = static_cast<CaptureTimings::Phase>(index);
+    if (capture_timings.HasDuration(phase)) {
+      AddTiming(index, capture_timings.Duration(phase));
+    }
+  }
+
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CaptureTimings::ReadCategory::kMaxValue);
+       ++index) {
+    const CaptureTimings::RemoteReads& reads = capture_timings.GetRemoteReads(
+        static_cast<CaptureTimings::ReadCategory>(index));
+    if (reads.reads) {
+      AddRemoteReads(
+          index, reads.reads, reads.bytes, reads.failures, reads.duration_ns);
+    }
+  }
+}
+
+void MinidumpCaptureTimingsWriter::AddTiming(uint32_t phase,
+                                             uint64_t duration_ns) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  MinidumpCaptureTiming& entry = entries_.emplace_back();
+  entry.phase = phase;
+  entry.reserved = 0;
+  entry.duration_ns = duration_ns;
+}
+
+void MinidumpCaptureTimingsWriter::AddRemoteReads(uint32_t category,
+                                                  uint64_t reads,
+                                                  uint64_t bytes,
+                                                  uint64_t failures,
+                                                  uint64_t duration_ns) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  MinidumpRemoteReads& entry = remote_reads_.emplace_back();
+  entry.category = category;
+  entry.reserved = 0;
+  entry.reads = reads;
+  entry.bytes = bytes;
+  entry.failures = failures;
+  entry.duration_ns = duration_ns;
+}
+
+bool MinidumpCaptureTimingsWriter::IsUseful() const {
+  return !entries_.empty() || !remote_reads_.empty();
+}
+
+bool MinidumpCaptureTimingsWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&timings_.count, entries_.size())) {
+    LOG(ERROR) << "capture timings count " << entries_.size()
+               << " out of range";
+    return false;
+  }
+
+  if (!AssignIfInRange(&remote_reads_list_.count, remote_reads_.size())) {
+    LOG(ERROR) << "remote reads count " << remote_reads_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpCaptureTimingsWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(timings_) + entries_.size() * sizeof(MinidumpCaptureTiming) +
+         sizeof(remote_reads_list_) +
+         remote_reads_.size() * sizeof(MinidumpRemoteReads);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpCaptureTimingsWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return {};
+}
+
+bool MinidumpCaptureTimingsWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &timings_;
+  iov.iov_len = sizeof(timings_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!entries_.empty()) {
+    iov.iov_base = &entries_[0];
+    iov.iov_len = entries_.size() * sizeof(MinidumpCaptureTiming);
+    iovecs.push_back(iov);
+  }
+
+  iov.iov_base = &remote_reads_list_;
+  iov.iov_len = sizeof(remote_reads_list_);
+  iovecs.push_back(iov);
+
+  if (!remote_reads_.empty()) {
+    iov.iov_base = &remote_reads_[0];
+    iov.iov_len = remote_reads_.size() * sizeof(MinidumpRemoteReads);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpCaptureTimingsWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadCaptureTimings;
+}
+
+}  // namespace crashpad
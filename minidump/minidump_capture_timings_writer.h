@@ -0,0 +1,91 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMINGS_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMINGS_WRITER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class CaptureTimings;
+
+//! \brief The writer for a MinidumpCaptureTimings stream in a minidump file.
+class MinidumpCaptureTimingsWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpCaptureTimingsWriter();
+
+  MinidumpCaptureTimingsWriter(const MinidumpCaptureTimingsWriter&) = delete;
+  MinidumpCaptureTimingsWriter& operator=(const MinidumpCaptureTimingsWriter&) =
+      delete;
+
+  ~MinidumpCaptureTimingsWriter() override;
+
+  //! \brief Adds a MinidumpCaptureTiming for each phase recorded in \a
+  //!     capture_timings, and a MinidumpRemoteReads for each category of reads
+  //!     recorded in it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromCaptureTimings(const CaptureTimings& capture_timings);
+
+  //! \brief Adds a MinidumpCaptureTiming to the MinidumpCaptureTimings.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddTiming(uint32_t phase, uint64_t duration_ns);
+
+  //! \brief Adds a MinidumpRemoteReads to the MinidumpRemoteReadsList that
+  //!     follows the MinidumpCaptureTimings entries.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddRemoteReads(uint32_t category,
+                      uint64_t reads,
+                      uint64_t bytes,
+                      uint64_t failures,
+                      uint64_t duration_ns);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying entries would be
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ private:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<MinidumpCaptureTiming> entries_;
+  std::vector<MinidumpRemoteReads> remote_reads_;
+  MinidumpCaptureTimings timings_;
+  MinidumpRemoteReadsList remote_reads_list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMINGS_WRITER_H_
@@ -0,0 +1,170 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_capture_timings_writer.h"
+
+#include <memory>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "util/file/string_file.h"
+#include "util/misc/capture_timings.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns the MinidumpRemoteReadsList following the entries in |timings|.
+const MinidumpRemoteReadsList* RemoteReadsList(
+    const MinidumpCaptureTimings* timings) {
+  return reinterpret_cast<const MinidumpRemoteReadsList*>(
+      &timings->entries[timings->count]);
+}
+
+// This returns the MinidumpCaptureTimings stream in |timings|.
+void GetCaptureTimingsStream(const std::string& file_contents,
+                             const MinidumpCaptureTimings** timings) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr uint32_t kExpectedStreams = 1;
+  constexpr size_t kTimingsStreamOffset =
+      kDirectoryOffset + kExpectedStreams * sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(),
+            kTimingsStreamOffset + sizeof(MinidumpCaptureTimings));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, kExpectedStreams, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType, kMinidumpStreamTypeCrashpadCaptureTimings);
+  EXPECT_EQ(directory[0].Location.Rva, kTimingsStreamOffset);
+
+  *timings = MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimings>(
+      file_contents, directory[0].Location);
+  ASSERT_TRUE(*timings);
+}
+
+TEST(MinidumpCaptureTimingsWriter, Empty) {
+  auto timings_writer = std::make_unique<MinidumpCaptureTimingsWriter>();
+  timings_writer->InitializeFromCaptureTimings(CaptureTimings());
+  EXPECT_FALSE(timings_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(timings_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpCaptureTimings) +
+                sizeof(MinidumpRemoteReadsList));
+
+  const MinidumpCaptureTimings* timings = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetCaptureTimingsStream(string_file.string(), &timings));
+  EXPECT_EQ(timings->version, MinidumpCaptureTimings::kVersion);
+  EXPECT_EQ(timings->count, 0u);
+  EXPECT_EQ(RemoteReadsList(timings)->count, 0u);
+}
+
+TEST(MinidumpCaptureTimingsWriter, FromCaptureTimings) {
+  constexpr uint64_t kModuleParsingNs = 0x123456789;
+  constexpr uint64_t kMemoryCaptureNs = 42;
+
+  CaptureTimings capture_timings;
+  capture_timings.AddDuration(CaptureTimings::Phase::kMemoryCapture,
+                              kMemoryCaptureNs);
+  capture_timings.AddDuration(CaptureTimings::Phase::kModuleParsing,
+                              kModuleParsingNs);
+
+  auto timings_writer = std::make_unique<MinidumpCaptureTimingsWriter>();
+  timings_writer->InitializeFromCaptureTimings(capture_timings);
+  EXPECT_TRUE(timings_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(timings_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpCaptureTimings* timings = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetCaptureTimingsStream(string_file.string(), &timings));
+  EXPECT_EQ(timings->version, MinidumpCaptureTimings::kVersion);
+  ASSERT_EQ(timings->count, 2u);
+
+  // Entries appear in phase order.
+  EXPECT_EQ(timings->entries[0].phase,
+            static_cast<uint32_t>(CaptureTimings::Phase::kModuleParsing));
+  EXPECT_EQ(timings->entries[0].reserved, 0u);
+  EXPECT_EQ(timings->entries[0].duration_ns, kModuleParsingNs);
+  EXPECT_EQ(timings->entries[1].phase,
+            static_cast<uint32_t>(CaptureTimings::Phase::kMemoryCapture));
+  EXPECT_EQ(timings->entries[1].reserved, 0u);
+  EXPECT_EQ(timings->entries[1].duration_ns, kMemoryCaptureNs);
+  EXPECT_EQ(RemoteReadsList(timings)->count, 0u);
+}
+
+TEST(MinidumpCaptureTimingsWriter, RemoteReads) {
+  CaptureTimings capture_timings;
+  capture_timings.SetRemoteReads(CaptureTimings::ReadCategory::kAnnotations,
+                                 {3, 96, 0, 1000});
+  capture_timings.SetRemoteReads(CaptureTimings::ReadCategory::kModuleHeaders,
+                                 {100, 0x12345678, 2, 0x123456789});
+
+  auto timings_writer = std::make_unique<MinidumpCaptureTimingsWriter>();
+  timings_writer->InitializeFromCaptureTimings(capture_timings);
+  EXPECT_TRUE(timings_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(timings_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpCaptureTimings* timings = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetCaptureTimingsStream(string_file.string(), &timings));
+  EXPECT_EQ(timings->count, 0u);
+
+  // Entries appear in category order.
+  const MinidumpRemoteReadsList* remote_reads = RemoteReadsList(timings);
+  ASSERT_EQ(remote_reads->count, 2u);
+  EXPECT_EQ(remote_reads->reserved, 0u);
+  EXPECT_EQ(
+      remote_reads->entries[0].category,
+      static_cast<uint32_t>(CaptureTimings::ReadCategory::kModuleHeaders));
+  EXPECT_EQ(remote_reads->entries[0].reserved, 0u);
+  EXPECT_EQ(remote_reads->entries[0].reads, 100u);
+  EXPECT_EQ(remote_reads->entries[0].bytes, 0x12345678u);
+  EXPECT_EQ(remote_reads->entries[0].failures, 2u);
+  EXPECT_EQ(remote_reads->entries[0].duration_ns, 0x123456789u);
+  EXPECT_EQ(remote_reads->entries[1].category,
+            static_cast<uint32_t>(CaptureTimings::ReadCategory::kAnnotations));
+  EXPECT_EQ(remote_reads->entries[1].reads, 3u);
+  EXPECT_EQ(remote_reads->entries[1].bytes, 96u);
+  EXPECT_EQ(remote_reads->entries[1].failures, 0u);
+  EXPECT_EQ(remote_reads->entries[1].duration_ns, 1000u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
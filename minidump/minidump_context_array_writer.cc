@@ -0,0 +1,228 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_context_array_writer.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "minidump/minidump_context_writer.h"
+#include "snapshot/cpu_context.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+// Holds contexts of the type written by ContextWriter, one of the
+// MinidumpContextWriter subclasses.
+template <typename ContextWriter>
+class ContextArrayWriter final : public MinidumpContextArrayWriter {
+ public:
+  using Context = std::remove_pointer_t<
+      decltype(std::declval<ContextWriter&>().context())>;
+
+  explicit ContextArrayWriter(size_t context_count)
+      : MinidumpContextArrayWriter(sizeof(Context),
+                                   alignof(Context),
+                                   context_count),
+        contexts_(context_count) {}
+
+  ContextArrayWriter(const ContextArrayWriter&) = delete;
+  ContextArrayWriter& operator=(const ContextArrayWriter&) = delete;
+
+  ~ContextArrayWriter() override = default;
+
+  // Converts |context_snapshot| into the context at |index|. The conversion
+  // is the one that ContextWriter performs, done in a temporary on the stack.
+  // Returns false if the context needs more space than the fixed structure.
+  template <typename ContextSnapshot>
+  bool InitializeContext(size_t index,
+                         const ContextSnapshot* context_snapshot) {
+    ContextWriter context_writer;
+    context_writer.InitializeFromSnapshot(context_snapshot);
+    if (context_writer.FreezeAndGetSizeOfObject() != sizeof(Context)) {
+      return false;
+    }
+    contexts_[index] = *context_writer.context();
+    return true;
+  }
+
+ private:
+  const void* ContextData() const override { return contexts_.data(); }
+
+  std::vector<Context> contexts_;
+};
+
+template <typename ContextWriter, typename GetContextSnapshot>
+std::unique_ptr<MinidumpContextArrayWriter> CreateArray(
+    const std::vector<const CPUContext*>& context_snapshots,
+    GetContextSnapshot get_context_snapshot) {
+  auto context_array =
+      std::make_unique<ContextArrayWriter<ContextWriter>>(
+          context_snapshots.size());
+  for (size_t index = 0; index < context_snapshots.size(); ++index) {
+    if (!context_array->InitializeContext(
+            index, get_context_snapshot(context_snapshots[index]))) {
+      return nullptr;
+    }
+  }
+  return context_array;
+}
+
+}  // namespace
+
+MinidumpContextArrayWriter::MinidumpContextArrayWriter(
+    size_t context_size,
+    size_t context_alignment,
+    size_t context_count)
+    : MinidumpWritable(),
+      location_descriptors_(context_count),
+      array_location_descriptor_(nullptr),
+      context_size_(context_size),
+      context_alignment_(context_alignment) {}
+
+MinidumpContextArrayWriter::~MinidumpContextArrayWriter() {}
+
+// static
+std::unique_ptr<MinidumpContextArrayWriter>
+MinidumpContextArrayWriter::CreateFromSnapshots(
+    const std::vector<const CPUContext*>& context_snapshots) {
+  if (context_snapshots.empty()) {
+    return nullptr;
+  }
+
+  const CPUArchitecture architecture = context_snapshots[0]->architecture;
+  for (const CPUContext* context_snapshot : context_snapshots) {
+    if (context_snapshot->architecture != architecture) {
+      return nullptr;
+    }
+  }
+
+  switch (architecture) {
+    case kCPUArchitectureX86:
+      return CreateArray<MinidumpContextX86Writer>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->x86; });
+    case kCPUArchitectureX86_64:
+      return CreateArray<MinidumpContextAMD64Writer>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->x86_64; });
+    case kCPUArchitectureARM:
+      return CreateArray<MinidumpContextARMWriter>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->arm; });
+    case kCPUArchitectureARM64:
+      return CreateArray<MinidumpContextARM64Writer>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->arm64; });
+    case kCPUArchitectureMIPSEL:
+      return CreateArray<MinidumpContextMIPSWriter>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->mipsel; });
+    case kCPUArchitectureMIPS64EL:
+      return CreateArray<MinidumpContextMIPS64Writer>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->mips64; });
+    case kCPUArchitectureRISCV64:
+      return CreateArray<MinidumpContextRISCV64Writer>(
+          context_snapshots,
+          [](const CPUContext* context) { return context->riscv64; });
+    default:
+      // MinidumpContextWriter::CreateFromSnapshot() logs this.
+      return nullptr;
+  }
+}
+
+void MinidumpContextArrayWriter::RegisterContextLocationDescriptor(
+    size_t index,
+    MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor) {
+  DCHECK_LE(state(), kStateFrozen);
+  DCHECK_LT(index, location_descriptors_.size());
+  DCHECK(!location_descriptors_[index]);
+
+  location_descriptors_[index] = location_descriptor;
+}
+
+void MinidumpContextArrayWriter::RegisterArrayLocationDescriptor(
+    MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor) {
+  DCHECK_LE(state(), kStateFrozen);
+  DCHECK(!array_location_descriptor_);
+
+  array_location_descriptor_ = location_descriptor;
+}
+
+size_t MinidumpContextArrayWriter::Alignment() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::max(context_alignment_, MinidumpWritable::Alignment());
+}
+
+size_t MinidumpContextArrayWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return context_size_ * location_descriptors_.size();
+}
+
+bool MinidumpContextArrayWriter::WillWriteAtOffsetImpl(FileOffset offset) {
+  DCHECK_EQ(state(), kStateFrozen);
+
+  decltype(MINIDUMP_LOCATION_DESCRIPTOR::DataSize) data_size;
+  if (!AssignIfInRange(&data_size, context_size_)) {
+    LOG(ERROR) << "context_size " << context_size_ << " out of range";
+    return false;
+  }
+
+  for (size_t index = 0; index < location_descriptors_.size(); ++index) {
+    MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor =
+        location_descriptors_[index];
+    if (!location_descriptor) {
+      continue;
+    }
+
+    const FileOffset context_offset = offset + index * context_size_;
+    if (!AssignIfInRange(&location_descriptor->Rva, context_offset)) {
+      LOG(ERROR) << "offset " << context_offset << " out of range";
+      return false;
+    }
+    location_descriptor->DataSize = data_size;
+  }
+
+  if (array_location_descriptor_) {
+    if (!AssignIfInRange(&array_location_descriptor_->Rva, offset)) {
+      LOG(ERROR) << "offset " << offset << " out of range";
+      return false;
+    }
+    if (!AssignIfInRange(&array_location_descriptor_->DataSize,
+                         SizeOfObject())) {
+      LOG(ERROR) << "size " << SizeOfObject() << " out of range";
+      return false;
+    }
+  }
+
+  return MinidumpWritable::WillWriteAtOffsetImpl(offset);
+}
+
+bool MinidumpContextArrayWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  return file_writer->Write(ContextData(), SizeOfObject());
+}
+
+}  // namespace crashpad
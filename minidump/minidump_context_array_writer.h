@@ -0,0 +1,117 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_CONTEXT_ARRAY_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_CONTEXT_ARRAY_WRITER_H_
+
+#include <windows.h>
+#include <dbghelp.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+struct CPUContext;
+
+//! \brief The writer for the CPU context structures of many threads, stored
+//!     as one contiguous array in a minidump file.
+//!
+//! MinidumpContextWriter writes one context per object, which costs an
+//! allocation and a write for every thread. This class holds every context
+//! of one architecture in a single array, and writes the array in one
+//! piece. Each MINIDUMP_THREAD still points to its own element of the array
+//! through its MINIDUMP_THREAD::ThreadContext location descriptor, so the
+//! minidump file is indistinguishable to readers.
+//!
+//! Only fixed-size contexts can be placed in an array. Contexts carrying
+//! extended state, such as x86-64 contexts with CET state, must be written
+//! by a MinidumpContextWriter.
+class MinidumpContextArrayWriter : public internal::MinidumpWritable {
+ public:
+  MinidumpContextArrayWriter(const MinidumpContextArrayWriter&) = delete;
+  MinidumpContextArrayWriter& operator=(const MinidumpContextArrayWriter&) =
+      delete;
+
+  ~MinidumpContextArrayWriter() override;
+
+  //! \brief Creates a MinidumpContextArrayWriter holding a context for each
+  //!     element of \a context_snapshots.
+  //!
+  //! \param[in] context_snapshots The context snapshots to use as source data.
+  //!
+  //! \return A MinidumpContextArrayWriter initialized from \a
+  //!     context_snapshots, with contexts in the same order. `nullptr` if \a
+  //!     context_snapshots is empty, if its contexts are not all of the same
+  //!     architecture, or if any of them can’t be written as a fixed-size
+  //!     context. In that case, each context should instead be written by its
+  //!     own MinidumpContextWriter.
+  static std::unique_ptr<MinidumpContextArrayWriter> CreateFromSnapshots(
+      const std::vector<const CPUContext*>& context_snapshots);
+
+  //! \brief Returns the number of contexts in the array.
+  size_t ContextCount() const { return location_descriptors_.size(); }
+
+  //! \brief Registers \a location_descriptor to point to the context at \a
+  //!     index in the array.
+  //!
+  //! Only one location descriptor may be registered for each context.
+  //!
+  //! \note Valid in #kStateFrozen or any preceding state.
+  void RegisterContextLocationDescriptor(
+      size_t index,
+      MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor);
+
+  //! \brief Registers \a location_descriptor to point to the entire array.
+  //!
+  //! Only one such location descriptor may be registered.
+  //!
+  //! \note Valid in #kStateFrozen or any preceding state.
+  void RegisterArrayLocationDescriptor(
+      MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor);
+
+  //! \brief Returns the size of each context in the array.
+  size_t ContextSize() const { return context_size_; }
+
+ protected:
+  //! \param[in] context_size The size of each context structure.
+  //! \param[in] context_alignment The alignment required by each context
+  //!     structure.
+  //! \param[in] context_count The number of contexts in the array.
+  MinidumpContextArrayWriter(size_t context_size,
+                             size_t context_alignment,
+                             size_t context_count);
+
+  //! \brief Returns the contexts, stored contiguously.
+  virtual const void* ContextData() const = 0;
+
+  // MinidumpWritable:
+  size_t Alignment() override;
+  size_t SizeOfObject() override;
+  bool WillWriteAtOffsetImpl(FileOffset offset) override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+ private:
+  std::vector<MINIDUMP_LOCATION_DESCRIPTOR*> location_descriptors_;
+  MINIDUMP_LOCATION_DESCRIPTOR* array_location_descriptor_;  // weak
+  size_t context_size_;
+  size_t context_alignment_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_CONTEXT_ARRAY_WRITER_H_
@@ -0,0 +1,109 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_context_array_writer.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_context.h"
+#include "minidump/test/minidump_context_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(MinidumpContextArrayWriter, Empty) {
+  EXPECT_FALSE(MinidumpContextArrayWriter::CreateFromSnapshots({}));
+}
+
+TEST(MinidumpContextArrayWriter, AMD64) {
+  constexpr size_t kContextCount = 3;
+  constexpr uint32_t kSeed = 64;
+  CPUContextX86_64 contexts_x86_64[kContextCount];
+  CPUContext contexts[kContextCount];
+  std::vector<const CPUContext*> context_snapshots;
+  for (size_t index = 0; index < kContextCount; ++index) {
+    contexts[index].x86_64 = &contexts_x86_64[index];
+    InitializeCPUContextX86_64(&contexts[index], kSeed + index);
+    context_snapshots.push_back(&contexts[index]);
+  }
+
+  std::unique_ptr<MinidumpContextArrayWriter> context_array_writer =
+      MinidumpContextArrayWriter::CreateFromSnapshots(context_snapshots);
+  ASSERT_TRUE(context_array_writer);
+  EXPECT_EQ(context_array_writer->ContextCount(), kContextCount);
+
+  MINIDUMP_LOCATION_DESCRIPTOR location_descriptors[kContextCount] = {};
+  for (size_t index = 0; index < kContextCount; ++index) {
+    context_array_writer->RegisterContextLocationDescriptor(
+        index, &location_descriptors[index]);
+  }
+
+  StringFile string_file;
+  ASSERT_TRUE(context_array_writer->WriteEverything(&string_file));
+  ASSERT_EQ(string_file.string().size(),
+            kContextCount * sizeof(MinidumpContextAMD64));
+
+  for (size_t index = 0; index < kContextCount; ++index) {
+    SCOPED_TRACE(index);
+    EXPECT_EQ(location_descriptors[index].DataSize,
+              sizeof(MinidumpContextAMD64));
+    EXPECT_EQ(location_descriptors[index].Rva,
+              index * sizeof(MinidumpContextAMD64));
+
+    const MinidumpContextAMD64* observed =
+        MinidumpWritableAtLocationDescriptor<MinidumpContextAMD64>(
+            string_file.string(), location_descriptors[index]);
+    ASSERT_TRUE(observed);
+    ExpectMinidumpContextAMD64(kSeed + index, observed, true);
+  }
+}
+
+TEST(MinidumpContextArrayWriter, MixedArchitectures) {
+  CPUContextX86 context_x86;
+  CPUContext context_0;
+  context_0.x86 = &context_x86;
+  InitializeCPUContextX86(&context_0, 32);
+
+  CPUContextX86_64 context_x86_64;
+  CPUContext context_1;
+  context_1.x86_64 = &context_x86_64;
+  InitializeCPUContextX86_64(&context_1, 64);
+
+  EXPECT_FALSE(MinidumpContextArrayWriter::CreateFromSnapshots(
+      {&context_0, &context_1}));
+}
+
+TEST(MinidumpContextArrayWriter, AMD64_Cet) {
+  CPUContextX86_64 context_x86_64;
+  CPUContext context;
+  context.x86_64 = &context_x86_64;
+  InitializeCPUContextX86_64(&context, 77);
+  context_x86_64.xstate.enabled_features |= XSTATE_MASK_CET_U;
+  context_x86_64.xstate.cet_u.cetmsr = 1;
+
+  // Extended state doesn’t fit in a fixed-size array element.
+  EXPECT_FALSE(MinidumpContextArrayWriter::CreateFromSnapshots({&context}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -49,6 +49,16 @@ static_assert(sizeof(MinidumpContextAMD64) == sizeof(CONTEXT), "CONTEXT size");
 #endif  // ARCH_CPU_X86_FAMILY
 #endif  // BUILDFLAG(IS_WIN)
 
+// Marks the registers selected by register_flags as not present in a context
+// that was captured without them. register_flags includes the architecture
+// bit, which must stay set.
+template <typename ContextFlags>
+void ClearContextFlags(ContextFlags* context_flags,
+                       uint32_t architecture_flag,
+                       uint32_t register_flags) {
+  *context_flags &= ~ContextFlags{register_flags & ~architecture_flag};
+}
+
 }  // namespace
 
 MinidumpContextWriter::~MinidumpContextWriter() {
@@ -64,6 +74,12 @@ MinidumpContextWriter::CreateFromSnapshot(const CPUContext* context_snapshot) {
       MinidumpContextX86Writer* context_x86 = new MinidumpContextX86Writer();
       context.reset(context_x86);
       context_x86->InitializeFromSnapshot(context_snapshot->x86);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_x86->context()->context_flags,
+                          kMinidumpContextX86,
+                          kMinidumpContextX86FloatingPoint |
+                              kMinidumpContextX86Extended);
+      }
       break;
     }
 
@@ -72,41 +88,71 @@ MinidumpContextWriter::CreateFromSnapshot(const CPUContext* context_snapshot) {
           new MinidumpContextAMD64Writer();
       context.reset(context_amd64);
       context_amd64->InitializeFromSnapshot(context_snapshot->x86_64);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_amd64->context()->context_flags,
+                          kMinidumpContextAMD64,
+                          kMinidumpContextAMD64FloatingPoint);
+      }
       break;
     }
 
     case kCPUArchitectureARM: {
-      context = std::make_unique<MinidumpContextARMWriter>();
-      reinterpret_cast<MinidumpContextARMWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm);
+      auto context_arm = std::make_unique<MinidumpContextARMWriter>();
+      context_arm->InitializeFromSnapshot(context_snapshot->arm);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_arm->context()->context_flags,
+                          kMinidumpContextARM,
+                          kMinidumpContextARMVFP);
+      }
+      context = std::move(context_arm);
       break;
     }
 
     case kCPUArchitectureARM64: {
-      context = std::make_unique<MinidumpContextARM64Writer>();
-      reinterpret_cast<MinidumpContextARM64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm64);
+      auto context_arm64 = std::make_unique<MinidumpContextARM64Writer>();
+      context_arm64->InitializeFromSnapshot(context_snapshot->arm64);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_arm64->context()->context_flags,
+                          kMinidumpContextARM64,
+                          kMinidumpContextARM64Fpsimd);
+      }
+      context = std::move(context_arm64);
       break;
     }
 
     case kCPUArchitectureMIPSEL: {
-      context = std::make_unique<MinidumpContextMIPSWriter>();
-      reinterpret_cast<MinidumpContextMIPSWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mipsel);
+      auto context_mips = std::make_unique<MinidumpContextMIPSWriter>();
+      context_mips->InitializeFromSnapshot(context_snapshot->mipsel);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_mips->context()->context_flags,
+                          kMinidumpContextMIPS,
+                          kMinidumpContextMIPSFloatingPoint);
+      }
+      context = std::move(context_mips);
       break;
     }
 
     case kCPUArchitectureMIPS64EL: {
-      context = std::make_unique<MinidumpContextMIPS64Writer>();
-      reinterpret_cast<MinidumpContextMIPS64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mips64);
+      auto context_mips64 = std::make_unique<MinidumpContextMIPS64Writer>();
+      context_mips64->InitializeFromSnapshot(context_snapshot->mips64);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_mips64->context()->context_flags,
+                          kMinidumpContextMIPS64,
+                          kMinidumpContextMIPS64FloatingPoint);
+      }
+      context = std::move(context_mips64);
       break;
     }
 
     case kCPUArchitectureRISCV64: {
-      context = std::make_unique<MinidumpContextRISCV64Writer>();
-      reinterpret_cast<MinidumpContextRISCV64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->riscv64);
+      auto context_riscv64 = std::make_unique<MinidumpContextRISCV64Writer>();
+      context_riscv64->InitializeFromSnapshot(context_snapshot->riscv64);
+      if (!context_snapshot->has_floating_point) {
+        ClearContextFlags(&context_riscv64->context()->context_flags,
+                          kMinidumpContextRISCV64,
+                          kMinidumpContextRISCV64FloatingPoint);
+      }
+      context = std::move(context_riscv64);
       break;
     }
 
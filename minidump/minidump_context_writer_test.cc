@@ -218,6 +218,31 @@ TYPED_TEST(MinidumpContextWriter, AMD64_FromSnapshot) {
       context, ExpectMinidumpContextAMD64, kSeed);
 }
 
+TYPED_TEST(MinidumpContextWriter, AMD64_FromSnapshotWithoutFloatingPoint) {
+  constexpr uint32_t kSeed = 64;
+  CPUContextX86_64 context_x86_64;
+  CPUContext context;
+  context.x86_64 = &context_x86_64;
+  InitializeCPUContextX86_64(&context, kSeed);
+  context.has_floating_point = false;
+
+  std::unique_ptr<::crashpad::MinidumpContextWriter> context_writer =
+      ::crashpad::MinidumpContextWriter::CreateFromSnapshot(&context);
+  ASSERT_TRUE(context_writer);
+
+  StringFile string_file;
+  ASSERT_TRUE(context_writer->WriteEverything(&string_file));
+
+  const MinidumpContextAMD64* observed =
+      MinidumpWritableAtRVA<MinidumpContextAMD64>(string_file.string(),
+                                                  TypeParam(0));
+  ASSERT_TRUE(observed);
+  EXPECT_EQ(observed->context_flags,
+            kMinidumpContextAMD64Control | kMinidumpContextAMD64Integer |
+                kMinidumpContextAMD64Segment | kMinidumpContextAMD64Debug);
+  EXPECT_EQ(observed->rip, context_x86_64.rip);
+}
+
 TYPED_TEST(MinidumpContextWriter, AMD64_CetFromSnapshot) {
   constexpr uint32_t kSeed = 77;
   CPUContextX86_64 context_x86_64;
@@ -273,6 +298,30 @@ TYPED_TEST(MinidumpContextWriter, ARM64_FromSnapshot) {
       context, ExpectMinidumpContextARM64, kSeed);
 }
 
+TYPED_TEST(MinidumpContextWriter, ARM64_FromSnapshotWithoutFloatingPoint) {
+  constexpr uint32_t kSeed = 64;
+  CPUContextARM64 context_arm64;
+  CPUContext context;
+  context.arm64 = &context_arm64;
+  InitializeCPUContextARM64(&context, kSeed);
+  context.has_floating_point = false;
+
+  std::unique_ptr<::crashpad::MinidumpContextWriter> context_writer =
+      ::crashpad::MinidumpContextWriter::CreateFromSnapshot(&context);
+  ASSERT_TRUE(context_writer);
+
+  StringFile string_file;
+  ASSERT_TRUE(context_writer->WriteEverything(&string_file));
+
+  const MinidumpContextARM64* observed =
+      MinidumpWritableAtRVA<MinidumpContextARM64>(string_file.string(),
+                                                  TypeParam(0));
+  ASSERT_TRUE(observed);
+  EXPECT_EQ(observed->context_flags,
+            kMinidumpContextARM64Control | kMinidumpContextARM64Integer);
+  EXPECT_EQ(observed->pc, context_arm64.pc);
+}
+
 TYPED_TEST(MinidumpContextWriter, MIPS_Zeros) {
   EmptyContextTest<MinidumpContextMIPSWriter, MinidumpContextMIPS, TypeParam>(
       ExpectMinidumpContextMIPS);
@@ -103,6 +103,20 @@ void MinidumpCrashpadInfoWriter::SetAddressMask(uint64_t mask) {
 bool MinidumpCrashpadInfoWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
+  // Modules built from the same code tend to carry the same annotation names,
+  // and often the same values. Write each distinct string once. This must
+  // happen before the children are frozen, because that is when they register
+  // RVAs with their strings.
+  {
+    internal::MinidumpUTF8StringTable table;
+    if (simple_annotations_) {
+      simple_annotations_->AddStringsToTable(&table);
+    }
+    if (module_list_) {
+      module_list_->AddStringsToTable(&table);
+    }
+  }
+
   if (!MinidumpStreamWriter::Freeze()) {
     return false;
   }
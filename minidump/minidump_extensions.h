@@ -72,6 +72,11 @@ enum MinidumpStreamType : uint32_t {
   //! \sa SystemInfoStream
   kMinidumpStreamTypeSystemInfo = SystemInfoStream,
 
+  //! \brief The stream type for MINIDUMP_MEMORY64_LIST.
+  //!
+  //! \sa Memory64ListStream
+  kMinidumpStreamTypeMemory64List = Memory64ListStream,
+
   //! \brief The stream type for MINIDUMP_HANDLE_DATA_STREAM.
   //!
   //! \sa HandleDataStream
@@ -108,6 +113,24 @@ enum MinidumpStreamType : uint32_t {
   //! \brief The stream type for MinidumpCrashpadInfo.
   kMinidumpStreamTypeCrashpadInfo = 0x43500001,
 
+  //! \brief The stream type for MinidumpThreadBreadcrumbsList.
+  kMinidumpStreamTypeCrashpadThreadBreadcrumbs = 0x43500002,
+
+  //! \brief The stream type for MinidumpCaptureTimings.
+  kMinidumpStreamTypeCrashpadCaptureTimings = 0x43500003,
+
+  //! \brief The stream type for MinidumpZeroMemoryList.
+  kMinidumpStreamTypeCrashpadZeroMemory = 0x43500004,
+
+  //! \brief The stream type for MinidumpUnwoundFramesList.
+  kMinidumpStreamTypeCrashpadUnwoundFrames = 0x43500005,
+
+  //! \brief The stream type for MinidumpModuleIdentityList.
+  kMinidumpStreamTypeCrashpadModuleIdentities = 0x43500006,
+
+  //! \brief The stream type for MinidumpThreadGroupList.
+  kMinidumpStreamTypeCrashpadThreadGroups = 0x43500007,
+
   //! \brief The last reserved crashpad stream.
   kMinidumpStreamTypeCrashpadLastReservedStream = 0x4350ffff,
 };
@@ -327,6 +350,320 @@ struct alignas(4) PACKED MinidumpAnnotationList {
   MinidumpAnnotation objects[0];
 };
 
+//! \brief The breadcrumbs recorded by a single thread.
+struct alignas(4) PACKED MinidumpThreadBreadcrumbs {
+  //! \brief The ID of the thread, matching MINIDUMP_THREAD::ThreadId of an
+  //!     entry in the thread list stream.
+  uint32_t thread_id;
+
+  //! \brief ::RVA of a MinidumpByteArray containing the serialized
+  //!     RingBufferData of the thread’s breadcrumb buffer.
+  RVA breadcrumbs;
+};
+
+//! \brief A list of the breadcrumbs recorded by each thread.
+//!
+//! This structure is the contents of a
+//! ::kMinidumpStreamTypeCrashpadThreadBreadcrumbs stream.
+struct alignas(4) PACKED MinidumpThreadBreadcrumbsList {
+  //! \brief The number of threads present.
+  uint32_t count;
+
+  //! \brief A list of MinidumpThreadBreadcrumbs entries.
+  MinidumpThreadBreadcrumbs entries[0];
+};
+
+//! \brief The time taken by one phase of capturing the snapshot that a
+//!     minidump file was written from.
+struct alignas(4) PACKED MinidumpCaptureTiming {
+  //! \brief The phase, a Metrics::CapturePhase value.
+  uint32_t phase;
+
+  //! \brief Unused, and set to `0`.
+  uint32_t reserved;
+
+  //! \brief The duration of the phase, in nanoseconds.
+  uint64_t duration_ns;
+};
+
+//! \brief The reads made from a client process’ memory in one category while
+//!     capturing the snapshot that a minidump file was written from.
+struct alignas(4) PACKED MinidumpRemoteReads {
+  //! \brief The category of the reads, a Metrics::RemoteReadCategory value.
+  uint32_t category;
+
+  //! \brief Unused, and set to `0`.
+  uint32_t reserved;
+
+  //! \brief The number of reads.
+  uint64_t reads;
+
+  //! \brief The number of bytes read successfully.
+  uint64_t bytes;
+
+  //! \brief The number of reads that failed.
+  uint64_t failures;
+
+  //! \brief The total time spent reading, in nanoseconds.
+  uint64_t duration_ns;
+};
+
+//! \brief A list of MinidumpRemoteReads entries.
+struct alignas(4) PACKED MinidumpRemoteReadsList {
+  //! \brief The number of entries present.
+  uint32_t count;
+
+  //! \brief Unused, and set to `0`.
+  uint32_t reserved;
+
+  //! \brief A list of MinidumpRemoteReads entries.
+  MinidumpRemoteReads entries[0];
+};
+
+//! \brief The time taken by each phase of capture that completed before a
+//!     minidump file was written.
+//!
+//! This structure is the contents of a
+//! ::kMinidumpStreamTypeCrashpadCaptureTimings stream. Phases that were not
+//! timed, and phases such as writing the minidump file itself that end after
+//! the file is written, are not present.
+//!
+//! In version 2 and later, the #count entries are followed by a
+//! MinidumpRemoteReadsList of the reads made from the client process’ memory
+//! in each category before the minidump file was written. Reads made while
+//! writing it, such as of thread stacks, are not included.
+struct alignas(4) PACKED MinidumpCaptureTimings {
+  //! \brief The structure’s currently-defined version number.
+  static constexpr uint32_t kVersion = 2;
+
+  //! \brief The structure’s version number.
+  uint32_t version;
+
+  //! \brief The number of entries present.
+  uint32_t count;
+
+  //! \brief A list of MinidumpCaptureTiming entries.
+  MinidumpCaptureTiming entries[0];
+};
+
+//! \brief A range of a process’ memory that was zero-filled when it was
+//!     captured.
+struct alignas(4) PACKED MinidumpZeroMemoryRange {
+  //! \brief The address of the start of the range.
+  uint64_t base;
+
+  //! \brief The size of the range, in bytes.
+  uint64_t size;
+};
+
+//! \brief Ranges of a process’ memory that were captured but not stored
+//!     because they were zero-filled.
+//!
+//! This structure is the contents of a ::kMinidumpStreamTypeCrashpadZeroMemory
+//! stream. It accompanies a MINIDUMP_MEMORY64_LIST stream, whose ranges leave
+//! gaps where these ranges are, so that readers unaware of this stream see the
+//! memory as missing rather than as wrong. The ranges are sorted by address and
+//! don’t overlap each other or any range of the MINIDUMP_MEMORY64_LIST.
+struct alignas(4) PACKED MinidumpZeroMemoryList {
+  //! \brief The number of entries present.
+  uint32_t count;
+
+  //! \brief Unused, and set to `0`.
+  uint32_t reserved;
+
+  //! \brief A list of MinidumpZeroMemoryRange entries.
+  MinidumpZeroMemoryRange entries[0];
+};
+
+//! \brief A stack frame found by unwinding a thread’s stack while it was
+//!     captured.
+struct alignas(4) PACKED MinidumpUnwoundFrame {
+  //! \brief The instruction pointer in the frame. For every frame but the
+  //!     innermost, this is the return address into the frame.
+  uint64_t instruction_pointer;
+
+  //! \brief The stack pointer in the frame.
+  uint64_t stack_pointer;
+};
+
+//! \brief The stack frames found for a single thread.
+struct alignas(4) PACKED MinidumpThreadUnwoundFrames {
+  //! \brief The ID of the thread, matching MINIDUMP_THREAD::ThreadId of an
+  //!     entry in the thread list stream.
+  uint32_t thread_id;
+
+  //! \brief The index in MinidumpUnwoundFramesList of the thread’s innermost
+  //!     frame.
+  uint32_t first_frame;
+
+  //! \brief The number of frames found for the thread, innermost first.
+  uint32_t frame_count;
+
+  //! \brief Unused, and set to `0`.
+  uint32_t reserved;
+};
+
+//! \brief The stack frames found by unwinding each thread’s stack while the
+//!     minidump file was written.
+//!
+//! This structure is the contents of a
+//! ::kMinidumpStreamTypeCrashpadUnwoundFrames stream. It is followed by
+//! \a thread_count MinidumpThreadUnwoundFrames entries, and then by
+//! \a frame_count MinidumpUnwoundFrame entries that they refer to.
+//!
+//! A thread’s frames may stop short of its outermost frame, if unwinding
+//! failed. If they reach it, the thread’s stack in the thread list stream may
+//! hold only the memory that the frames occupy.
+struct alignas(4) PACKED MinidumpUnwoundFramesList {
+  //! \brief The number of MinidumpThreadUnwoundFrames entries present.
+  uint32_t thread_count;
+
+  //! \brief The number of MinidumpUnwoundFrame entries present.
+  uint32_t frame_count;
+
+  //! \brief A list of MinidumpThreadUnwoundFrames entries.
+  MinidumpThreadUnwoundFrames threads[0];
+};
+
+//! \brief The identifiers that a symbol server uses to look up a module’s
+//!     files, in their text form.
+//!
+//! Each string is empty if the corresponding identifier is not known.
+struct alignas(4) PACKED MinidumpModuleIdentity {
+  //! \brief The module’s base address, matching MINIDUMP_MODULE::BaseOfImage
+  //!     of an entry in the module list stream.
+  uint64_t base_of_image;
+
+  //! \brief The size of the module’s image, matching
+  //!     MINIDUMP_MODULE::SizeOfImage.
+  uint32_t size_of_image;
+
+  //! \brief ::RVA of a MinidumpUTF8String containing the module’s code ID.
+  //!
+  //! For an ELF module with a build ID, this is the build ID in lowercase
+  //! hexadecimal. For a PE module, it is its timestamp as eight uppercase
+  //! hexadecimal digits followed by its image size in lowercase hexadecimal.
+  //! Otherwise, it is the module’s UUID in uppercase hexadecimal.
+  RVA code_id;
+
+  //! \brief ::RVA of a MinidumpUTF8String containing the module’s debug ID:
+  //!     its UUID followed by its age, in uppercase hexadecimal.
+  //!
+  //! For an ELF module, the UUID is the first 16 bytes of the build ID with
+  //! its first three fields byte-swapped, as Breakpad computes it, and the
+  //! age is `0`.
+  RVA debug_id;
+
+  //! \brief ::RVA of a MinidumpUTF8String containing the module’s debug file
+  //!     name, such as the name of its `.pdb` file.
+  RVA debug_file_name;
+};
+
+//! \brief The symbol server identifiers of each module, computed once while
+//!     the minidump file was written.
+//!
+//! This structure is the contents of a
+//! ::kMinidumpStreamTypeCrashpadModuleIdentities stream. It carries the same
+//! identifiers that can be derived from each module’s CodeView record, so that
+//! tools that only need to find symbols do not have to parse those records.
+//! Entries appear in the same order as in the module list stream, but modules
+//! without any identifiers may be omitted.
+struct alignas(4) PACKED MinidumpModuleIdentityList {
+  //! \brief The number of MinidumpModuleIdentity entries present.
+  uint32_t count;
+
+  //! \brief A list of MinidumpModuleIdentity entries.
+  MinidumpModuleIdentity entries[0];
+};
+
+//! \brief A group of threads in a MinidumpThreadGroupList that share a name
+//!     and a stack size.
+struct alignas(4) PACKED MinidumpThreadGroup {
+  //! \brief ::RVA of a MinidumpUTF8String containing the name shared by the
+  //!     threads in the group, or `0` if the threads have no name.
+  RVA name;
+
+  //! \brief ::RVA of a MinidumpByteArray containing the encoded threads.
+  //!
+  //! Each thread is encoded as six values, each written as an unsigned
+  //! LEB128 number:
+  //!  - the change in its MINIDUMP_THREAD::ThreadId
+  //!  - its MINIDUMP_THREAD::SuspendCount
+  //!  - its MINIDUMP_THREAD::Priority, zigzag-encoded
+  //!  - the change in its MINIDUMP_THREAD::Teb
+  //!  - the change in the address of its stack
+  //!  - the change in the index of its context in
+  //!    MinidumpThreadGroupList::contexts
+  //!
+  //! Each change is the difference from the same value of the previous thread
+  //! in the group, or from `0` for the first thread, taken modulo
+  //! 2<sup>64</sup> as a signed number, zigzag-encoded. Zigzag encoding maps
+  //! signed numbers to unsigned ones so that numbers close to zero have small
+  //! encodings: `0`, `-1`, `1`, `-2`, … become `0`, `1`, `2`, `3`, ….
+  RVA threads;
+
+  //! \brief The number of threads in the group.
+  uint32_t thread_count;
+
+  //! \brief The size of each thread’s stack, or `0` if the threads have no
+  //!     stack.
+  uint64_t stack_size;
+};
+
+//! \brief A compact description of every thread in the process.
+//!
+//! This structure is the contents of a
+//! ::kMinidumpStreamTypeCrashpadThreadGroups stream. It describes the same
+//! threads as the thread list stream, grouped by name and stack size, with the
+//! addresses that differ between threads delta-encoded. For processes with many
+//! similar threads, this is a fraction of the size of the thread list and
+//! thread name list streams.
+//!
+//! When this stream is present, the thread list and thread name list streams
+//! may have been limited to a subset of the threads, which always includes the
+//! thread named by the exception stream, if any. Every thread appears in this
+//! stream. The stacks of all threads remain in the memory list stream.
+//!
+//! This structure is versioned. When changing this structure, leave the
+//! existing structure intact so that earlier parsers will be able to understand
+//! the fields they are aware of, and make additions at the end of the
+//! structure. Revise #kVersion and document each field’s validity based on
+//! #version, so that newer parsers will be able to determine whether the added
+//! fields are valid or not.
+struct alignas(4) PACKED MinidumpThreadGroupList {
+  //! \brief The structure’s currently-defined version number.
+  //!
+  //! \sa version
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief The structure’s version number.
+  //!
+  //! Readers can use this field to determine which other fields in the
+  //! structure are valid. Upon encountering a value greater than #kVersion, a
+  //! reader should assume that the structure’s layout is compatible with the
+  //! structure defined as having value #kVersion.
+  //!
+  //! Writers may produce values less than #kVersion in this field if there is
+  //! no need for any fields present in later versions.
+  uint32_t version;
+
+  //! \brief The size of each CPU context in #contexts.
+  uint32_t context_size;
+
+  //! \brief The CPU contexts of all threads, stored contiguously, with each
+  //!     context #context_size bytes long.
+  //!
+  //! The context of the thread whose encoded context index is `i` begins at
+  //! `contexts.Rva + i * context_size`.
+  MINIDUMP_LOCATION_DESCRIPTOR contexts;
+
+  //! \brief The number of MinidumpThreadGroup entries present.
+  uint32_t count;
+
+  //! \brief A list of MinidumpThreadGroup entries.
+  MinidumpThreadGroup groups[0];
+};
+
 //! \brief Additional Crashpad-specific information about a module carried
 //!     within a minidump file.
 //!
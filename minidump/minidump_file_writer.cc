@@ -14,6 +14,7 @@
 
 #include "minidump/minidump_file_writer.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/check_op.h"
@@ -22,19 +23,26 @@
 #include "minidump/minidump_crashpad_info_writer.h"
 #include "minidump/minidump_exception_writer.h"
 #include "minidump/minidump_handle_writer.h"
+#include "minidump/minidump_memory64_list_writer.h"
 #include "minidump/minidump_memory_info_writer.h"
 #include "minidump/minidump_memory_writer.h"
 #include "minidump/minidump_misc_info_writer.h"
+#include "minidump/minidump_module_identity_writer.h"
 #include "minidump/minidump_module_writer.h"
 #include "minidump/minidump_system_info_writer.h"
+#include "minidump/minidump_thread_breadcrumbs_writer.h"
+#include "minidump/minidump_thread_group_writer.h"
 #include "minidump/minidump_thread_id_map.h"
 #include "minidump/minidump_thread_name_list_writer.h"
 #include "minidump/minidump_thread_writer.h"
 #include "minidump/minidump_unloaded_module_writer.h"
+#include "minidump/minidump_unwound_frames_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "minidump/minidump_user_stream_writer.h"
 #include "minidump/minidump_writer_util.h"
+#include "minidump/minidump_zero_memory_writer.h"
 #include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/thread_snapshot.h"
@@ -43,8 +51,109 @@
 
 namespace crashpad {
 
+namespace {
+
+// The lowest bytes of another MemorySnapshot.
+class MemorySnapshotPrefix final : public MemorySnapshot {
+ public:
+  MemorySnapshotPrefix(const MemorySnapshot* snapshot, size_t size)
+      : snapshot_(snapshot), size_(std::min(size, snapshot->Size())) {}
+
+  MemorySnapshotPrefix(const MemorySnapshotPrefix&) = delete;
+  MemorySnapshotPrefix& operator=(const MemorySnapshotPrefix&) = delete;
+
+  ~MemorySnapshotPrefix() override = default;
+
+  // MemorySnapshot:
+
+  uint64_t Address() const override { return snapshot_->Address(); }
+
+  size_t Size() const override { return size_; }
+
+  bool Read(Delegate* delegate) const override {
+    if (size_ == 0) {
+      return delegate->MemorySnapshotDelegateRead(nullptr, 0);
+    }
+
+    // Reading the underlying snapshot in pieces of this size means that only
+    // the first piece is read from the process, and reading stops after it.
+    // Snapshots that can’t read in pieces provide all of their data at once,
+    // and only the beginning of it is passed on.
+    class PrefixDelegate final : public Delegate {
+     public:
+      PrefixDelegate(Delegate* delegate, size_t size)
+          : delegate_(delegate), size_(size), result_(false), read_(false) {}
+
+      bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+        DCHECK_GE(size, size_);
+        result_ = delegate_->MemorySnapshotDelegateRead(data, size_);
+        read_ = true;
+        return false;
+      }
+
+      bool result() const { return read_ && result_; }
+
+     private:
+      Delegate* delegate_;
+      size_t size_;
+      bool result_;
+      bool read_;
+    } prefix_delegate(delegate, size_);
+
+    snapshot_->ReadChunked(&prefix_delegate, size_);
+    return prefix_delegate.result();
+  }
+
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    return nullptr;
+  }
+
+ private:
+  const MemorySnapshot* snapshot_;  // weak
+  size_t size_;
+};
+
+// Returns the indices of the first max_listed_threads threads, with the thread
+// whose ID is exception_thread_id, if any, in place of the last of them if it
+// would not otherwise be among them.
+std::vector<size_t> ListedThreadIndices(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const ExceptionSnapshot* exception_snapshot,
+    size_t max_listed_threads) {
+  DCHECK_GT(max_listed_threads, 0u);
+  DCHECK_GT(thread_snapshots.size(), max_listed_threads);
+
+  std::vector<size_t> indices;
+  for (size_t index = 0; index < max_listed_threads; ++index) {
+    indices.push_back(index);
+  }
+
+  if (exception_snapshot) {
+    for (size_t index = max_listed_threads; index < thread_snapshots.size();
+         ++index) {
+      if (thread_snapshots[index]->ThreadID() ==
+          exception_snapshot->ThreadID()) {
+        indices.back() = index;
+        break;
+      }
+    }
+  }
+
+  return indices;
+}
+
+}  // namespace
+
 MinidumpFileWriter::MinidumpFileWriter()
-    : MinidumpWritable(), header_(), streams_(), stream_types_() {
+    : MinidumpWritable(),
+      header_(),
+      streams_(),
+      thread_list_(nullptr),
+      memory_info_list_(nullptr),
+      max_listed_threads_(0),
+      micro_dump_stack_(),
+      stream_types_() {
   // Don’t set the signature field right away. Leave it set to 0, so that a
   // partially-written minidump file isn’t confused for a complete and valid
   // one. The header will be rewritten in WriteToFile().
@@ -59,7 +168,8 @@ MinidumpFileWriter::~MinidumpFileWriter() {
 }
 
 void MinidumpFileWriter::InitializeFromSnapshot(
-    const ProcessSnapshot* process_snapshot) {
+    const ProcessSnapshot* process_snapshot,
+    bool include_extra_memory) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK_EQ(header_.Signature, 0u);
   DCHECK_EQ(header_.TimeDateStamp, 0u);
@@ -89,17 +199,49 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   add_stream_result = AddStream(std::move(misc_info));
   DCHECK(add_stream_result);
 
+  const ExceptionSnapshot* exception_snapshot = process_snapshot->Exception();
+  const std::vector<const ThreadSnapshot*> thread_snapshots =
+      process_snapshot->Threads();
+
   auto memory_list = std::make_unique<MinidumpMemoryListWriter>();
   auto thread_list = std::make_unique<MinidumpThreadListWriter>();
   thread_list->SetMemoryListWriter(memory_list.get());
   MinidumpThreadIDMap thread_id_map;
-  thread_list->InitializeFromSnapshot(process_snapshot->Threads(),
-                                      &thread_id_map);
+  thread_list->InitializeFromSnapshot(
+      thread_snapshots, &thread_id_map, include_extra_memory);
+
+  // Threads left out of the thread list are still described by the thread
+  // groups, which refer to their contexts in the thread list’s array.
+  std::unique_ptr<MinidumpThreadGroupListWriter> thread_groups;
+  std::vector<const ThreadSnapshot*> listed_thread_snapshots;
+  if (max_listed_threads_ > 0 &&
+      thread_snapshots.size() > max_listed_threads_ &&
+      thread_list->ContextArray()) {
+    const std::vector<size_t> listed_indices = ListedThreadIndices(
+        thread_snapshots, exception_snapshot, max_listed_threads_);
+    thread_list->SetListedThreads(listed_indices);
+    for (size_t index : listed_indices) {
+      listed_thread_snapshots.push_back(thread_snapshots[index]);
+    }
+
+    thread_groups = std::make_unique<MinidumpThreadGroupListWriter>();
+    thread_groups->InitializeFromSnapshot(thread_snapshots, thread_id_map);
+    thread_groups->SetContextArray(thread_list->ContextArray());
+  } else {
+    listed_thread_snapshots = thread_snapshots;
+  }
+
+  thread_list_ = thread_list.get();
   add_stream_result = AddStream(std::move(thread_list));
   DCHECK(add_stream_result);
 
+  if (thread_groups) {
+    add_stream_result = AddStream(std::move(thread_groups));
+    DCHECK(add_stream_result);
+  }
+
   bool has_thread_name = false;
-  for (const ThreadSnapshot* thread_snapshot : process_snapshot->Threads()) {
+  for (const ThreadSnapshot* thread_snapshot : listed_thread_snapshots) {
     if (!thread_snapshot->ThreadName().empty()) {
       has_thread_name = true;
       break;
@@ -107,13 +249,28 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   }
   if (has_thread_name) {
     auto thread_name_list = std::make_unique<MinidumpThreadNameListWriter>();
-    thread_name_list->InitializeFromSnapshot(process_snapshot->Threads(),
+    thread_name_list->InitializeFromSnapshot(listed_thread_snapshots,
                                              thread_id_map);
     add_stream_result = AddStream(std::move(thread_name_list));
     DCHECK(add_stream_result);
   }
 
-  const ExceptionSnapshot* exception_snapshot = process_snapshot->Exception();
+  auto thread_breadcrumbs_list =
+      std::make_unique<MinidumpThreadBreadcrumbsListWriter>();
+  thread_breadcrumbs_list->InitializeFromSnapshot(thread_snapshots,
+                                                  thread_id_map);
+  if (thread_breadcrumbs_list->IsUseful()) {
+    add_stream_result = AddStream(std::move(thread_breadcrumbs_list));
+    DCHECK(add_stream_result);
+  }
+
+  auto unwound_frames = std::make_unique<MinidumpUnwoundFramesWriter>();
+  unwound_frames->InitializeFromSnapshot(thread_snapshots, thread_id_map);
+  if (unwound_frames->IsUseful()) {
+    add_stream_result = AddStream(std::move(unwound_frames));
+    DCHECK(add_stream_result);
+  }
+
   if (exception_snapshot) {
     auto exception = std::make_unique<MinidumpExceptionWriter>();
 #if BUILDFLAG(IS_IOS)
@@ -131,10 +288,23 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   }
 
   auto module_list = std::make_unique<MinidumpModuleListWriter>();
-  module_list->InitializeFromSnapshot(process_snapshot->Modules());
+  const std::vector<const ModuleSnapshot*> module_snapshots =
+      process_snapshot->Modules();
+  module_list->InitializeFromSnapshot(module_snapshots);
   add_stream_result = AddStream(std::move(module_list));
   DCHECK(add_stream_result);
 
+  // Symbol server identifiers are computed here, once, so that tools that
+  // only need to find a module’s symbols don’t have to derive them again from
+  // its CodeView record.
+  auto module_identities =
+      std::make_unique<MinidumpModuleIdentityListWriter>();
+  module_identities->InitializeFromSnapshot(module_snapshots);
+  if (module_identities->IsUseful()) {
+    add_stream_result = AddStream(std::move(module_identities));
+    DCHECK(add_stream_result);
+  }
+
   auto unloaded_modules = process_snapshot->UnloadedModules();
   if (!unloaded_modules.empty()) {
     auto unloaded_module_list =
@@ -159,6 +329,7 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   if (!memory_map_snapshot.empty()) {
     auto memory_info_list = std::make_unique<MinidumpMemoryInfoListWriter>();
     memory_info_list->InitializeFromSnapshot(memory_map_snapshot);
+    memory_info_list_ = memory_info_list.get();
     add_stream_result = AddStream(std::move(memory_info_list));
     DCHECK(add_stream_result);
   }
@@ -171,9 +342,11 @@ void MinidumpFileWriter::InitializeFromSnapshot(
     DCHECK(add_stream_result);
   }
 
-  memory_list->AddFromSnapshot(process_snapshot->ExtraMemory());
-  if (exception_snapshot) {
-    memory_list->AddFromSnapshot(exception_snapshot->ExtraMemory());
+  if (include_extra_memory) {
+    memory_list->AddFromSnapshot(process_snapshot->ExtraMemory());
+    if (exception_snapshot) {
+      memory_list->AddFromSnapshot(exception_snapshot->ExtraMemory());
+    }
   }
 
   // These user streams must be added last. Otherwise, a user stream with the
@@ -205,12 +378,147 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   DCHECK(add_stream_result);
 }
 
+void MinidumpFileWriter::InitializeMicroDumpFromSnapshot(
+    const ProcessSnapshot* process_snapshot,
+    size_t max_stack_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_EQ(header_.Signature, 0u);
+  DCHECK_EQ(header_.TimeDateStamp, 0u);
+  DCHECK(streams_.empty());
+
+  timeval snapshot_time;
+  process_snapshot->SnapshotTime(&snapshot_time);
+  SetTimestamp(snapshot_time.tv_sec);
+
+  auto system_info = std::make_unique<MinidumpSystemInfoWriter>();
+  system_info->InitializeFromSnapshot(process_snapshot->System());
+  bool add_stream_result = AddStream(std::move(system_info));
+  DCHECK(add_stream_result);
+
+  const ExceptionSnapshot* exception_snapshot = process_snapshot->Exception();
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  if (exception_snapshot) {
+    for (const ThreadSnapshot* thread_snapshot : process_snapshot->Threads()) {
+      if (thread_snapshot->ThreadID() == exception_snapshot->ThreadID()) {
+        thread_snapshots.push_back(thread_snapshot);
+        break;
+      }
+    }
+  }
+
+  auto memory_list = std::make_unique<MinidumpMemoryListWriter>();
+  auto thread_list = std::make_unique<MinidumpThreadListWriter>();
+  thread_list->SetMemoryListWriter(memory_list.get());
+  MinidumpThreadIDMap thread_id_map;
+  BuildMinidumpThreadIDMap(thread_snapshots, &thread_id_map);
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    auto thread = std::make_unique<MinidumpThreadWriter>();
+    thread->InitializeFromSnapshot(thread_snapshot, &thread_id_map);
+    const MemorySnapshot* stack_snapshot = thread_snapshot->Stack();
+    if (stack_snapshot && stack_snapshot->Size() > max_stack_size) {
+      micro_dump_stack_ = std::make_unique<MemorySnapshotPrefix>(
+          stack_snapshot, max_stack_size);
+      thread->SetStack(std::make_unique<SnapshotMinidumpMemoryWriter>(
+          micro_dump_stack_.get()));
+    }
+    thread_list->AddThread(std::move(thread));
+  }
+  thread_list_ = thread_list.get();
+  add_stream_result = AddStream(std::move(thread_list));
+  DCHECK(add_stream_result);
+
+  if (exception_snapshot) {
+    // The thread that the exception occurred on may not have been captured,
+    // in which case the thread list is empty.
+    constexpr bool allow_missing_thread_id_from_map = true;
+    auto exception = std::make_unique<MinidumpExceptionWriter>();
+    exception->InitializeFromSnapshot(
+        exception_snapshot, thread_id_map, allow_missing_thread_id_from_map);
+    add_stream_result = AddStream(std::move(exception));
+    DCHECK(add_stream_result);
+  }
+
+  // The module list is kept whole, because MinidumpCrashpadInfo refers to
+  // modules by their index in it, and the client’s crash keys are kept as
+  // module annotations.
+  const std::vector<const ModuleSnapshot*> module_snapshots =
+      process_snapshot->Modules();
+  auto module_list = std::make_unique<MinidumpModuleListWriter>();
+  module_list->InitializeFromSnapshot(module_snapshots);
+  add_stream_result = AddStream(std::move(module_list));
+  DCHECK(add_stream_result);
+
+  auto module_identities =
+      std::make_unique<MinidumpModuleIdentityListWriter>();
+  module_identities->InitializeFromSnapshot(module_snapshots);
+  if (module_identities->IsUseful()) {
+    add_stream_result = AddStream(std::move(module_identities));
+    DCHECK(add_stream_result);
+  }
+
+  auto crashpad_info = std::make_unique<MinidumpCrashpadInfoWriter>();
+  crashpad_info->InitializeFromSnapshot(process_snapshot);
+  if (crashpad_info->IsUseful()) {
+    add_stream_result = AddStream(std::move(crashpad_info));
+    DCHECK(add_stream_result);
+  }
+
+  add_stream_result = AddStream(std::move(memory_list));
+  DCHECK(add_stream_result);
+}
+
+void MinidumpFileWriter::SetMaxListedThreads(size_t max_listed_threads) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+
+  max_listed_threads_ = max_listed_threads;
+}
+
 void MinidumpFileWriter::SetTimestamp(time_t timestamp) {
   DCHECK_EQ(state(), kStateMutable);
 
   internal::MinidumpWriterUtil::AssignTimeT(&header_.TimeDateStamp, timestamp);
 }
 
+void MinidumpFileWriter::SetDeduplicateThreadStacks(
+    bool deduplicate_thread_stacks) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(thread_list_);
+
+  thread_list_->SetDeduplicateStacks(deduplicate_thread_stacks);
+}
+
+void MinidumpFileWriter::SetCompactMemoryInfo(bool merge_adjacent_regions,
+                                              bool omit_unusable_regions) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (memory_info_list_) {
+    memory_info_list_->SetMergeAdjacentRegions(merge_adjacent_regions);
+    memory_info_list_->SetOmitUnusableRegions(omit_unusable_regions);
+  }
+}
+
+bool MinidumpFileWriter::AddFullMemory(
+    const std::vector<const MemorySnapshot*>& memory_snapshots,
+    const std::vector<CheckedRange<uint64_t>>& zero_ranges) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  auto memory64_list = std::make_unique<MinidumpMemory64ListWriter>();
+  memory64_list->AddFromSnapshot(memory_snapshots);
+  if (!AddStream(std::move(memory64_list))) {
+    return false;
+  }
+
+  auto zero_memory = std::make_unique<MinidumpZeroMemoryWriter>();
+  zero_memory->AddRanges(zero_ranges);
+  if (zero_memory->IsUseful()) {
+    AddStream(std::move(zero_memory));
+  }
+
+  header_.Flags = header_.Flags | MiniDumpWithFullMemory;
+  return true;
+}
+
 bool MinidumpFileWriter::AddStream(
     std::unique_ptr<internal::MinidumpStreamWriter> stream) {
   DCHECK_EQ(state(), kStateMutable);
@@ -17,6 +17,7 @@
 
 #include <windows.h>
 #include <dbghelp.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <memory>
@@ -27,10 +28,14 @@
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_writable.h"
 #include "util/file/file_io.h"
+#include "util/numeric/checked_range.h"
 
 namespace crashpad {
 
+class MemorySnapshot;
 class ProcessSnapshot;
+class MinidumpMemoryInfoListWriter;
+class MinidumpThreadListWriter;
 class MinidumpUserExtensionStreamDataSource;
 
 //! \brief The root-level object in a minidump file.
@@ -62,8 +67,11 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!  - kMinidumpStreamTypeSystemInfo
   //!  - kMinidumpStreamTypeMiscInfo
   //!  - kMinidumpStreamTypeThreadList
+  //!  - kMinidumpStreamTypeCrashpadThreadGroups (if SetMaxListedThreads()
+  //!    limited the thread list)
   //!  - kMinidumpStreamTypeException (if present)
   //!  - kMinidumpStreamTypeModuleList
+  //!  - kMinidumpStreamTypeCrashpadModuleIdentities (if present)
   //!  - kMinidumpStreamTypeUnloadedModuleList (if present)
   //!  - kMinidumpStreamTypeCrashpadInfo (if present)
   //!  - kMinidumpStreamTypeMemoryInfoList (if present)
@@ -72,17 +80,104 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!  - kMinidumpStreamTypeMemoryList
   //!
   //! \param[in] process_snapshot The process snapshot to use as source data.
+  //! \param[in] include_extra_memory Whether the ExtraMemory() of the process,
+  //!     its exception, and its threads is added to the memory list. Without
+  //!     it, the memory list carries only thread stacks, which makes for a
+  //!     reduced dump that is cheaper to write.
+  //!
+  //! \note Valid in #kStateMutable. No mutator methods other than
+  //!     SetMaxListedThreads() may be called before this method, and it is not
+  //!     normally necessary to call any mutator methods after this method.
+  void InitializeFromSnapshot(const ProcessSnapshot* process_snapshot,
+                              bool include_extra_memory = true);
+
+  //! \brief Initializes the MinidumpFileWriter as a micro dump of \a
+  //!     process_snapshot, carrying only what is needed to count a crash and
+  //!     find where it happened.
+  //!
+  //! A micro dump is an ordinary minidump file with most of its streams left
+  //! out. These streams are added, in this order:
+  //!  - kMinidumpStreamTypeSystemInfo
+  //!  - kMinidumpStreamTypeThreadList, holding only the thread that the
+  //!    exception occurred on, or no thread if there was no exception
+  //!  - kMinidumpStreamTypeException (if present)
+  //!  - kMinidumpStreamTypeModuleList
+  //!  - kMinidumpStreamTypeCrashpadModuleIdentities (if present)
+  //!  - kMinidumpStreamTypeCrashpadInfo (if present)
+  //!  - kMinidumpStreamTypeMemoryList, holding only that thread’s stack
+  //!
+  //! The thread’s stack is cut down to its lowest \a max_stack_size bytes,
+  //! which begin at or just below its stack pointer.
+  //!
+  //! \param[in] process_snapshot The process snapshot to use as source data.
+  //! \param[in] max_stack_size The maximum size of the stack to store.
   //!
   //! \note Valid in #kStateMutable. No mutator methods may be called before
-  //!     this method, and it is not normally necessary to call any mutator
-  //!     methods after this method.
-  void InitializeFromSnapshot(const ProcessSnapshot* process_snapshot);
+  //!     this method.
+  void InitializeMicroDumpFromSnapshot(const ProcessSnapshot* process_snapshot,
+                                       size_t max_stack_size);
+
+  //! \brief Limits the thread list and thread name list streams that
+  //!     InitializeFromSnapshot() adds to \a max_listed_threads threads.
+  //!
+  //! When the process has more threads than this, the thread list and thread
+  //! name list streams carry only the first \a max_listed_threads threads,
+  //! one of which is always the thread that the exception occurred on, if
+  //! any. Every thread is described by a MinidumpThreadGroupList stream
+  //! instead, which takes far less space per thread. The stacks and contexts
+  //! of all threads are still written. The limit is not applied if the
+  //! threads’ contexts can’t be stored in a single array, which the
+  //! MinidumpThreadGroupList stream needs to refer to them. The default, `0`,
+  //! lists every thread.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot().
+  void SetMaxListedThreads(size_t max_listed_threads);
 
   //! \brief Sets MINIDUMP_HEADER::Timestamp.
   //!
   //! \note Valid in #kStateMutable.
   void SetTimestamp(time_t timestamp);
 
+  //! \brief Sets whether thread stacks with identical contents are stored once
+  //!     in the minidump file. See
+  //!     MinidumpThreadListWriter::SetDeduplicateStacks().
+  //!
+  //! \note Valid in #kStateMutable, after InitializeFromSnapshot().
+  void SetDeduplicateThreadStacks(bool deduplicate_thread_stacks);
+
+  //! \brief Sets how the MINIDUMP_MEMORY_INFO_LIST stream is compacted. See
+  //!     MinidumpMemoryInfoListWriter::SetMergeAdjacentRegions() and
+  //!     MinidumpMemoryInfoListWriter::SetOmitUnusableRegions().
+  //!
+  //! This has no effect if InitializeFromSnapshot() added no such stream.
+  //!
+  //! \note Valid in #kStateMutable, after InitializeFromSnapshot().
+  void SetCompactMemoryInfo(bool merge_adjacent_regions,
+                            bool omit_unusable_regions);
+
+  //! \brief Adds a MINIDUMP_MEMORY64_LIST stream containing \a
+  //!     memory_snapshots, and marks the minidump file as
+  //!     ::MiniDumpWithFullMemory.
+  //!
+  //! The memory is written after all other memory in the minidump file, and
+  //! may extend beyond 4 GB into it. This must be called after any other stream
+  //! carrying memory has been added, such as by InitializeFromSnapshot(). This
+  //! object does not take ownership of the memory snapshots, which must outlive
+  //! WriteEverything(). See MinidumpMemory64ListWriter.
+  //!
+  //! If \a zero_ranges is not empty, it is written as a
+  //! MinidumpZeroMemoryList, recording the memory left out of
+  //! \a memory_snapshots because it was zero-filled.
+  //!
+  //! \note Valid in #kStateMutable.
+  //!
+  //! \return `true` on success. `false` on failure, as occurs when a
+  //!     MINIDUMP_MEMORY64_LIST stream has already been added, with a message
+  //!     logged.
+  bool AddFullMemory(
+      const std::vector<const MemorySnapshot*>& memory_snapshots,
+      const std::vector<CheckedRange<uint64_t>>& zero_ranges = {});
+
   //! \brief Adds a stream to the minidump file and arranges for a
   //!     MINIDUMP_DIRECTORY entry to point to it.
   //!
@@ -163,6 +258,12 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
  private:
   MINIDUMP_HEADER header_;
   std::vector<std::unique_ptr<internal::MinidumpStreamWriter>> streams_;
+  MinidumpThreadListWriter* thread_list_;  // weak
+  MinidumpMemoryInfoListWriter* memory_info_list_;  // weak
+  size_t max_listed_threads_;
+
+  // The part of a thread’s stack stored in a micro dump.
+  std::unique_ptr<MemorySnapshot> micro_dump_stack_;
 
   // Protects against multiple streams with the same ID being added.
   std::set<MinidumpStreamType> stream_types_;
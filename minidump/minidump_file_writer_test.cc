@@ -554,6 +554,181 @@ TEST(MinidumpFileWriter, InitializeFromSnapshot_CrashpadInfo) {
                   string_file.string(), directory[6].Location));
 }
 
+TEST(MinidumpFileWriter, InitializeFromSnapshot_WithoutExtraMemory) {
+  TestProcessSnapshot process_snapshot;
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+  thread_snapshot->SetThreadID(10);
+  InitializeCPUContextX86_64(thread_snapshot->MutableContext(), 10);
+  constexpr uint64_t kStackAddress = 0x7fff0000;
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(kStackAddress);
+  stack->SetSize(0x1000);
+  stack->SetValue('s');
+  thread_snapshot->SetStack(std::move(stack));
+  auto thread_extra_memory = std::make_unique<TestMemorySnapshot>();
+  thread_extra_memory->SetAddress(0x20000);
+  thread_extra_memory->SetSize(0x100);
+  thread_snapshot->AddExtraMemory(std::move(thread_extra_memory));
+  process_snapshot.AddThread(std::move(thread_snapshot));
+
+  auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+  exception_snapshot->SetThreadID(10);
+  InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 10);
+  auto exception_extra_memory = std::make_unique<TestMemorySnapshot>();
+  exception_extra_memory->SetAddress(0x30000);
+  exception_extra_memory->SetSize(0x100);
+  exception_snapshot->AddExtraMemory(std::move(exception_extra_memory));
+  process_snapshot.SetException(std::move(exception_snapshot));
+
+  auto extra_memory = std::make_unique<TestMemorySnapshot>();
+  extra_memory->SetAddress(0x10000);
+  extra_memory->SetSize(0x100);
+  process_snapshot.AddExtraMemory(std::move(extra_memory));
+
+  for (bool include_extra_memory : {true, false}) {
+    SCOPED_TRACE(include_extra_memory);
+
+    MinidumpFileWriter minidump_file_writer;
+    minidump_file_writer.InitializeFromSnapshot(&process_snapshot,
+                                                include_extra_memory);
+
+    StringFile string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+    const MINIDUMP_DIRECTORY* directory;
+    const MINIDUMP_HEADER* header =
+        MinidumpHeaderAtStart(string_file.string(), &directory);
+    ASSERT_TRUE(header);
+    ASSERT_TRUE(directory);
+
+    const MINIDUMP_DIRECTORY& last_stream =
+        directory[header->NumberOfStreams - 1];
+    EXPECT_EQ(last_stream.StreamType, kMinidumpStreamTypeMemoryList);
+    const MINIDUMP_MEMORY_LIST* memory_list =
+        MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+            string_file.string(), last_stream.Location);
+    ASSERT_TRUE(memory_list);
+
+    // The stack is always kept.
+    if (include_extra_memory) {
+      EXPECT_EQ(memory_list->NumberOfMemoryRanges, 4u);
+    } else {
+      ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+      EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange,
+                kStackAddress);
+    }
+  }
+}
+
+TEST(MinidumpFileWriter, InitializeMicroDumpFromSnapshot) {
+  constexpr uint32_t kSnapshotTime = 0x4976043c;
+  constexpr timeval kSnapshotTimeval = {static_cast<time_t>(kSnapshotTime), 0};
+
+  TestProcessSnapshot process_snapshot;
+  process_snapshot.SetSnapshotTime(kSnapshotTimeval);
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  constexpr size_t kMaxStackSize = 0x1000;
+  for (uint64_t thread_id : {10, 11, 12}) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    thread_snapshot->SetThreadID(thread_id);
+    InitializeCPUContextX86_64(thread_snapshot->MutableContext(),
+                               static_cast<uint32_t>(thread_id));
+    auto stack = std::make_unique<TestMemorySnapshot>();
+    stack->SetAddress(0x7fff0000 + thread_id * 0x100000);
+    stack->SetSize(kMaxStackSize * 4);
+    stack->SetValue('s');
+    thread_snapshot->SetStack(std::move(stack));
+    process_snapshot.AddThread(std::move(thread_snapshot));
+  }
+
+  auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+  exception_snapshot->SetThreadID(11);
+  InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 11);
+  process_snapshot.SetException(std::move(exception_snapshot));
+
+  auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+  module_snapshot->SetBuildID({0x01, 0x02, 0x03, 0x04});
+  module_snapshot->SetAnnotationsVector({"crash key"});
+  process_snapshot.AddModule(std::move(module_snapshot));
+
+  // Left out of a micro dump.
+  auto extra_memory = std::make_unique<TestMemorySnapshot>();
+  extra_memory->SetAddress(0x10000);
+  extra_memory->SetSize(0x100);
+  process_snapshot.AddExtraMemory(std::move(extra_memory));
+
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.InitializeMicroDumpFromSnapshot(&process_snapshot,
+                                                       kMaxStackSize);
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 7, kSnapshotTime));
+  ASSERT_TRUE(directory);
+
+  EXPECT_EQ(directory[0].StreamType, kMinidumpStreamTypeSystemInfo);
+  EXPECT_TRUE(MinidumpWritableAtLocationDescriptor<MINIDUMP_SYSTEM_INFO>(
+                  string_file.string(), directory[0].Location));
+
+  EXPECT_EQ(directory[1].StreamType, kMinidumpStreamTypeThreadList);
+  const MINIDUMP_THREAD_LIST* thread_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_THREAD_LIST>(
+          string_file.string(), directory[1].Location);
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(thread_list->NumberOfThreads, 1u);
+  const MINIDUMP_THREAD& thread = thread_list->Threads[0];
+  EXPECT_EQ(thread.Stack.StartOfMemoryRange, 0x7fff0000u + 11 * 0x100000);
+  EXPECT_EQ(thread.Stack.Memory.DataSize, kMaxStackSize);
+  const std::string& contents = string_file.string();
+  ASSERT_LE(thread.Stack.Memory.Rva + kMaxStackSize, contents.size());
+  EXPECT_EQ(contents.substr(thread.Stack.Memory.Rva, kMaxStackSize),
+            std::string(kMaxStackSize, 's'));
+
+  EXPECT_EQ(directory[2].StreamType, kMinidumpStreamTypeException);
+  const MINIDUMP_EXCEPTION_STREAM* exception =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_EXCEPTION_STREAM>(
+          string_file.string(), directory[2].Location);
+  ASSERT_TRUE(exception);
+  EXPECT_EQ(exception->ThreadId, thread.ThreadId);
+
+  EXPECT_EQ(directory[3].StreamType, kMinidumpStreamTypeModuleList);
+  EXPECT_TRUE(MinidumpWritableAtLocationDescriptor<MINIDUMP_MODULE_LIST>(
+                  string_file.string(), directory[3].Location));
+
+  EXPECT_EQ(directory[4].StreamType,
+            kMinidumpStreamTypeCrashpadModuleIdentities);
+
+  EXPECT_EQ(directory[5].StreamType, kMinidumpStreamTypeCrashpadInfo);
+  EXPECT_TRUE(MinidumpWritableAtLocationDescriptor<MinidumpCrashpadInfo>(
+                  string_file.string(), directory[5].Location));
+
+  // Only the stack is in the memory list.
+  EXPECT_EQ(directory[6].StreamType, kMinidumpStreamTypeMemoryList);
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          string_file.string(), directory[6].Location);
+  ASSERT_TRUE(memory_list);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange,
+            thread.Stack.StartOfMemoryRange);
+  EXPECT_EQ(memory_list->MemoryRanges[0].Memory.Rva, thread.Stack.Memory.Rva);
+}
+
 TEST(MinidumpFileWriter, SameStreamType) {
   MinidumpFileWriter minidump_file;
 
@@ -0,0 +1,193 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_memory64_list_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/auto_reset.h"
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+// The largest piece of a memory region to hold in memory while writing it.
+constexpr size_t kMaxChunkSize = 1024 * 1024;
+
+}  // namespace
+
+// Writes the contents of every memory region in the list, one after another.
+class MinidumpMemory64ListWriter::DataWriter final
+    : public internal::MinidumpWritable,
+      public MemorySnapshot::Delegate {
+ public:
+  explicit DataWriter(const std::vector<const MemorySnapshot*>* snapshots)
+      : internal::MinidumpWritable(),
+        MemorySnapshot::Delegate(),
+        snapshots_(snapshots),
+        file_writer_(nullptr),
+        bytes_remaining_(0) {}
+
+  DataWriter(const DataWriter&) = delete;
+  DataWriter& operator=(const DataWriter&) = delete;
+
+  ~DataWriter() override {}
+
+ private:
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    DCHECK_LE(size, bytes_remaining_);
+    if (!file_writer_->Write(data, size)) {
+      return false;
+    }
+    bytes_remaining_ -= size;
+    return true;
+  }
+
+  // MinidumpWritable:
+  size_t Alignment() override { return 16; }
+
+  size_t SizeOfObject() override {
+    DCHECK_GE(state(), kStateFrozen);
+    size_t size = 0;
+    for (const MemorySnapshot* snapshot : *snapshots_) {
+      size += snapshot->Size();
+    }
+    return size;
+  }
+
+  bool WriteObject(FileWriterInterface* file_writer) override {
+    DCHECK_EQ(state(), kStateWritable);
+    base::AutoReset<FileWriterInterface*> file_writer_reset(&file_writer_,
+                                                            file_writer);
+
+    std::vector<uint8_t> empty;
+    for (const MemorySnapshot* snapshot : *snapshots_) {
+      bytes_remaining_ = snapshot->Size();
+      if (snapshot->ReadChunked(this, kMaxChunkSize)) {
+        continue;
+      }
+
+      // The layout is fixed by now, so a region that can no longer be read is
+      // filled, as SnapshotMinidumpMemoryWriter does.
+      if (empty.empty()) {
+        empty.resize(kMaxChunkSize, 0xfe);
+      }
+      while (bytes_remaining_) {
+        if (!MemorySnapshotDelegateRead(
+                empty.data(), std::min(bytes_remaining_, empty.size()))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  Phase WritePhase() override {
+    // After everything else, including other memory, so that the rest of the
+    // file stays within reach of a 32-bit RVA.
+    return kPhaseLate;
+  }
+
+  const std::vector<const MemorySnapshot*>* snapshots_;  // weak
+  FileWriterInterface* file_writer_;  // weak
+
+  // The number of bytes of the current snapshot not yet written.
+  size_t bytes_remaining_;
+};
+
+MinidumpMemory64ListWriter::MinidumpMemory64ListWriter()
+    : MinidumpStreamWriter(),
+      memory_snapshots_(),
+      memory_descriptors_(),
+      data_writer_(new DataWriter(&memory_snapshots_)),
+      memory64_list_base_() {}
+
+MinidumpMemory64ListWriter::~MinidumpMemory64ListWriter() {}
+
+void MinidumpMemory64ListWriter::AddFromSnapshot(
+    const std::vector<const MemorySnapshot*>& memory_snapshots) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const MemorySnapshot* memory_snapshot : memory_snapshots) {
+    if (memory_snapshot->Size() != 0) {
+      memory_snapshots_.push_back(memory_snapshot);
+    }
+  }
+}
+
+bool MinidumpMemory64ListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  data_writer_->RegisterRVA(&memory64_list_base_.BaseRva);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  memory64_list_base_.NumberOfMemoryRanges = memory_snapshots_.size();
+  memory_descriptors_.reserve(memory_snapshots_.size());
+  for (const MemorySnapshot* memory_snapshot : memory_snapshots_) {
+    MINIDUMP_MEMORY_DESCRIPTOR64 descriptor;
+    descriptor.StartOfMemoryRange = memory_snapshot->Address();
+    descriptor.DataSize = memory_snapshot->Size();
+    memory_descriptors_.push_back(descriptor);
+  }
+
+  return true;
+}
+
+size_t MinidumpMemory64ListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(memory64_list_base_) +
+         memory_descriptors_.size() * sizeof(MINIDUMP_MEMORY_DESCRIPTOR64);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpMemory64ListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::vector<MinidumpWritable*>(1, data_writer_.get());
+}
+
+bool MinidumpMemory64ListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &memory64_list_base_;
+  iov.iov_len = sizeof(memory64_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!memory_descriptors_.empty()) {
+    iov.iov_base = memory_descriptors_.data();
+    iov.iov_len =
+        memory_descriptors_.size() * sizeof(MINIDUMP_MEMORY_DESCRIPTOR64);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpMemory64ListWriter::StreamType() const {
+  return kMinidumpStreamTypeMemory64List;
+}
+
+}  // namespace crashpad
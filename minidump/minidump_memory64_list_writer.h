@@ -0,0 +1,90 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
+
+#include <windows.h>
+#include <dbghelp.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+#include "snapshot/memory_snapshot.h"
+
+namespace crashpad {
+
+//! \brief The writer for a MINIDUMP_MEMORY64_LIST stream in a minidump file,
+//!     used to store large amounts of a process’ memory.
+//!
+//! Unlike MinidumpMemoryListWriter, which gives each memory region its own
+//! location in the file, this writer stores the contents of all of its regions
+//! consecutively, so that only 16 bytes of list entry are needed for each
+//! region, and the contents may extend beyond 4 GB into the file. The contents
+//! are read from their memory snapshots and written to the file piece by
+//! piece, so the amount of memory needed to write them doesn’t depend on their
+//! size.
+//!
+//! Because the contents may extend beyond the range of a 32-bit ::RVA, this
+//! stream must be the last object containing memory written to the file. See
+//! MinidumpFileWriter::AddFullMemory().
+class MinidumpMemory64ListWriter final : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpMemory64ListWriter();
+
+  MinidumpMemory64ListWriter(const MinidumpMemory64ListWriter&) = delete;
+  MinidumpMemory64ListWriter& operator=(const MinidumpMemory64ListWriter&) =
+      delete;
+
+  ~MinidumpMemory64ListWriter() override;
+
+  //! \brief Adds each memory snapshot in \a memory_snapshots to the list, in
+  //!     order.
+  //!
+  //! This object does not take ownership of the memory snapshots, which must
+  //! outlive it. Empty snapshots are ignored.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddFromSnapshot(
+      const std::vector<const MemorySnapshot*>& memory_snapshots);
+
+  //! \return The number of memory regions added.
+  size_t MemoryRangeCount() const { return memory_snapshots_.size(); }
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  class DataWriter;
+
+  std::vector<const MemorySnapshot*> memory_snapshots_;  // weak
+  std::vector<MINIDUMP_MEMORY_DESCRIPTOR64> memory_descriptors_;
+  std::unique_ptr<DataWriter> data_writer_;
+  MINIDUMP_MEMORY64_LIST memory64_list_base_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
@@ -0,0 +1,193 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_memory64_list_writer.h"
+
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The memory list must be the only stream in the file.
+void GetMemory64ListStream(const std::string& file_contents,
+                           const MINIDUMP_MEMORY64_LIST** memory64_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kMemory64ListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(),
+            kMemory64ListStreamOffset + sizeof(MINIDUMP_MEMORY64_LIST));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_TRUE(header);
+  ASSERT_TRUE(directory);
+  ASSERT_EQ(header->NumberOfStreams, 1u);
+
+  ASSERT_EQ(directory[0].StreamType, kMinidumpStreamTypeMemory64List);
+  EXPECT_EQ(directory[0].Location.Rva, kMemory64ListStreamOffset);
+
+  *memory64_list = reinterpret_cast<const MINIDUMP_MEMORY64_LIST*>(
+      &file_contents[kMemory64ListStreamOffset]);
+  ASSERT_EQ(directory[0].Location.DataSize,
+            sizeof(MINIDUMP_MEMORY64_LIST) +
+                (*memory64_list)->NumberOfMemoryRanges *
+                    sizeof(MINIDUMP_MEMORY_DESCRIPTOR64));
+}
+
+void ExpectRegionContents(const std::string& file_contents,
+                          uint64_t rva,
+                          uint64_t size,
+                          char value) {
+  ASSERT_LE(rva + size, file_contents.size());
+  EXPECT_EQ(file_contents.substr(rva, size), std::string(size, value));
+}
+
+TEST(MinidumpMemory64ListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto memory64_list_writer = std::make_unique<MinidumpMemory64ListWriter>();
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory64_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY64_LIST* memory64_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemory64ListStream(string_file.string(), &memory64_list));
+
+  EXPECT_EQ(memory64_list->NumberOfMemoryRanges, 0u);
+}
+
+TEST(MinidumpMemory64ListWriter, Regions) {
+  constexpr uint64_t kBaseAddress0 = 0x7fff00001000;
+  constexpr size_t kSize0 = 0x3000;
+  constexpr char kValue0 = 'a';
+  constexpr uint64_t kBaseAddress1 = 0x7fff00100000;
+  constexpr size_t kSize1 = 0x123;
+  constexpr char kValue1 = 'b';
+
+  TestMemorySnapshot memory_snapshot_0;
+  memory_snapshot_0.SetAddress(kBaseAddress0);
+  memory_snapshot_0.SetSize(kSize0);
+  memory_snapshot_0.SetValue(kValue0);
+
+  TestMemorySnapshot memory_snapshot_empty;
+  memory_snapshot_empty.SetAddress(0x1000);
+  memory_snapshot_empty.SetSize(0);
+
+  TestMemorySnapshot memory_snapshot_1;
+  memory_snapshot_1.SetAddress(kBaseAddress1);
+  memory_snapshot_1.SetSize(kSize1);
+  memory_snapshot_1.SetValue(kValue1);
+
+  auto memory64_list_writer = std::make_unique<MinidumpMemory64ListWriter>();
+  memory64_list_writer->AddFromSnapshot(
+      {&memory_snapshot_0, &memory_snapshot_empty, &memory_snapshot_1});
+  EXPECT_EQ(memory64_list_writer->MemoryRangeCount(), 2u);
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory64_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY64_LIST* memory64_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemory64ListStream(string_file.string(), &memory64_list));
+
+  ASSERT_EQ(memory64_list->NumberOfMemoryRanges, 2u);
+  EXPECT_EQ(memory64_list->MemoryRanges[0].StartOfMemoryRange, kBaseAddress0);
+  EXPECT_EQ(memory64_list->MemoryRanges[0].DataSize, kSize0);
+  EXPECT_EQ(memory64_list->MemoryRanges[1].StartOfMemoryRange, kBaseAddress1);
+  EXPECT_EQ(memory64_list->MemoryRanges[1].DataSize, kSize1);
+
+  // The contents of the regions are stored consecutively at the end of the
+  // file.
+  const uint64_t base_rva = memory64_list->BaseRva;
+  EXPECT_EQ(base_rva % 16, 0u);
+  EXPECT_EQ(string_file.string().size(), base_rva + kSize0 + kSize1);
+  ExpectRegionContents(string_file.string(), base_rva, kSize0, kValue0);
+  ExpectRegionContents(
+      string_file.string(), base_rva + kSize0, kSize1, kValue1);
+}
+
+TEST(MinidumpMemory64ListWriter, RegionReadFails) {
+  constexpr size_t kSize = 0x2000;
+
+  TestMemorySnapshot memory_snapshot;
+  memory_snapshot.SetAddress(0x10000);
+  memory_snapshot.SetSize(kSize);
+  memory_snapshot.SetValue('c');
+  memory_snapshot.SetShouldFailRead(true);
+
+  auto memory64_list_writer = std::make_unique<MinidumpMemory64ListWriter>();
+  memory64_list_writer->AddFromSnapshot({&memory_snapshot});
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory64_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY64_LIST* memory64_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemory64ListStream(string_file.string(), &memory64_list));
+
+  ASSERT_EQ(memory64_list->NumberOfMemoryRanges, 1u);
+  EXPECT_EQ(memory64_list->MemoryRanges[0].DataSize, kSize);
+  ExpectRegionContents(
+      string_file.string(), memory64_list->BaseRva, kSize, '\xfe');
+}
+
+TEST(MinidumpMemory64ListWriter, AddFullMemory) {
+  TestMemorySnapshot memory_snapshot;
+  memory_snapshot.SetAddress(0x20000);
+  memory_snapshot.SetSize(0x1000);
+  memory_snapshot.SetValue('d');
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddFullMemory({&memory_snapshot}));
+  EXPECT_FALSE(minidump_file_writer.AddFullMemory({&memory_snapshot}));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(header->Flags & MiniDumpWithFullMemory,
+            static_cast<uint64_t>(MiniDumpWithFullMemory));
+
+  const MINIDUMP_MEMORY64_LIST* memory64_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemory64ListStream(string_file.string(), &memory64_list));
+  ASSERT_EQ(memory64_list->NumberOfMemoryRanges, 1u);
+  ExpectRegionContents(
+      string_file.string(), memory64_list->BaseRva, 0x1000, 'd');
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -20,8 +20,28 @@
 
 namespace crashpad {
 
+namespace {
+
+bool IsUnusableRegion(const MINIDUMP_MEMORY_INFO& memory_info) {
+  return memory_info.State == MEM_FREE || memory_info.State == MEM_RESERVE ||
+         (memory_info.Protect & PAGE_GUARD) != 0;
+}
+
+bool CanMergeRegions(const MINIDUMP_MEMORY_INFO& first,
+                     const MINIDUMP_MEMORY_INFO& second) {
+  return first.BaseAddress + first.RegionSize == second.BaseAddress &&
+         first.State == second.State && first.Protect == second.Protect &&
+         first.Type == second.Type &&
+         first.AllocationProtect == second.AllocationProtect;
+}
+
+}  // namespace
+
 MinidumpMemoryInfoListWriter::MinidumpMemoryInfoListWriter()
-    : memory_info_list_base_(), items_() {
+    : memory_info_list_base_(),
+      items_(),
+      merge_adjacent_regions_(false),
+      omit_unusable_regions_(false) {
 }
 
 MinidumpMemoryInfoListWriter::~MinidumpMemoryInfoListWriter() {
@@ -42,6 +62,24 @@ bool MinidumpMemoryInfoListWriter::Freeze() {
   if (!MinidumpStreamWriter::Freeze())
     return false;
 
+  if (merge_adjacent_regions_ || omit_unusable_regions_) {
+    // The items are compacted in place. kept is the number of items retained
+    // so far, each of which may have absorbed later ones.
+    size_t kept = 0;
+    for (const MINIDUMP_MEMORY_INFO& memory_info : items_) {
+      if (omit_unusable_regions_ && IsUnusableRegion(memory_info)) {
+        continue;
+      }
+      if (merge_adjacent_regions_ && kept > 0 &&
+          CanMergeRegions(items_[kept - 1], memory_info)) {
+        items_[kept - 1].RegionSize += memory_info.RegionSize;
+        continue;
+      }
+      items_[kept++] = memory_info;
+    }
+    items_.resize(kept);
+  }
+
   memory_info_list_base_.SizeOfHeader = sizeof(MINIDUMP_MEMORY_INFO_LIST);
   memory_info_list_base_.SizeOfEntry = sizeof(MINIDUMP_MEMORY_INFO);
   memory_info_list_base_.NumberOfEntries = items_.size();
@@ -69,9 +107,11 @@ bool MinidumpMemoryInfoListWriter::WriteObject(
   iov.iov_len = sizeof(memory_info_list_base_);
   std::vector<WritableIoVec> iovecs(1, iov);
 
-  for (const auto& minidump_memory_info : items_) {
-    iov.iov_base = &minidump_memory_info;
-    iov.iov_len = sizeof(minidump_memory_info);
+  // The items are contiguous, so they’re written with one iovec rather than
+  // one apiece.
+  if (!items_.empty()) {
+    iov.iov_base = items_.data();
+    iov.iov_len = sizeof(items_[0]) * items_.size();
     iovecs.push_back(iov);
   }
 
@@ -54,6 +54,32 @@ class MinidumpMemoryInfoListWriter final
   void InitializeFromSnapshot(
       const std::vector<const MemoryMapRegionSnapshot*>& memory_map);
 
+  //! \brief Sets whether adjacent regions are merged when they have the same
+  //!     state, protection, type, and allocation protection.
+  //!
+  //! A merged region takes its AllocationBase from the first of the regions
+  //! it replaces, so the boundaries between allocations within it are lost.
+  //! How a process’ memory may be accessed is all that most readers of the
+  //! stream look for, and a process with many mappings may have several
+  //! megabytes of them that differ only in where they begin.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetMergeAdjacentRegions(bool merge_adjacent_regions) {
+    merge_adjacent_regions_ = merge_adjacent_regions;
+  }
+
+  //! \brief Sets whether regions that hold no accessible memory are left out.
+  //!
+  //! These are regions that are free, that are reserved but not committed, or
+  //! whose pages are guard pages. Leaving out guard pages prevents readers
+  //! from recognizing a thread stack’s guard page, so a stack overflow may be
+  //! harder to diagnose.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetOmitUnusableRegions(bool omit_unusable_regions) {
+    omit_unusable_regions_ = omit_unusable_regions;
+  }
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -67,6 +93,8 @@ class MinidumpMemoryInfoListWriter final
  private:
   MINIDUMP_MEMORY_INFO_LIST memory_info_list_base_;
   std::vector<MINIDUMP_MEMORY_INFO> items_;
+  bool merge_adjacent_regions_;
+  bool omit_unusable_regions_;
 };
 
 }  // namespace crashpad
@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "minidump/minidump_file_writer.h"
@@ -136,6 +137,128 @@ TEST(MinidumpMemoryInfoWriter, OneRegion) {
   EXPECT_EQ(memory_info.Type, mmi.Type);
 }
 
+MINIDUMP_MEMORY_INFO MakeMemoryInfo(uint64_t base_address,
+                                    uint64_t region_size,
+                                    uint32_t state,
+                                    uint32_t protect,
+                                    uint32_t type) {
+  MINIDUMP_MEMORY_INFO mmi = {};
+  mmi.BaseAddress = base_address;
+  mmi.AllocationBase = base_address;
+  mmi.AllocationProtect = PAGE_READWRITE;
+  mmi.RegionSize = region_size;
+  mmi.State = state;
+  mmi.Protect = protect;
+  mmi.Type = type;
+  return mmi;
+}
+
+TEST(MinidumpMemoryInfoWriter, Compact) {
+  const MINIDUMP_MEMORY_INFO regions[] = {
+      MakeMemoryInfo(0x10000, 0x1000, MEM_COMMIT, PAGE_READWRITE, MEM_PRIVATE),
+      MakeMemoryInfo(0x11000, 0x2000, MEM_COMMIT, PAGE_READWRITE, MEM_PRIVATE),
+      MakeMemoryInfo(0x13000,
+                     0x1000,
+                     MEM_COMMIT,
+                     PAGE_READWRITE | PAGE_GUARD,
+                     MEM_PRIVATE),
+      MakeMemoryInfo(0x14000, 0x1000, MEM_COMMIT, PAGE_READWRITE, MEM_PRIVATE),
+      MakeMemoryInfo(0x15000, 0x3000, MEM_RESERVE, 0, MEM_PRIVATE),
+      MakeMemoryInfo(0x18000, 0x1000, MEM_COMMIT, PAGE_READONLY, MEM_MAPPED),
+      MakeMemoryInfo(0x19000, 0x7000, MEM_FREE, PAGE_NOACCESS, 0),
+  };
+  std::vector<std::unique_ptr<TestMemoryMapRegionSnapshot>> region_snapshots;
+  std::vector<const MemoryMapRegionSnapshot*> memory_map;
+  for (const MINIDUMP_MEMORY_INFO& region : regions) {
+    region_snapshots.push_back(std::make_unique<TestMemoryMapRegionSnapshot>());
+    region_snapshots.back()->SetMindumpMemoryInfo(region);
+    memory_map.push_back(region_snapshots.back().get());
+  }
+
+  struct {
+    bool merge_adjacent_regions;
+    bool omit_unusable_regions;
+    std::vector<std::pair<uint64_t, uint64_t>> expected_ranges;
+  } const kTestCases[] = {
+      {false,
+       false,
+       {{0x10000, 0x1000},
+        {0x11000, 0x2000},
+        {0x13000, 0x1000},
+        {0x14000, 0x1000},
+        {0x15000, 0x3000},
+        {0x18000, 0x1000},
+        {0x19000, 0x7000}}},
+      // The guard page keeps the region after it from being merged.
+      {true,
+       false,
+       {{0x10000, 0x3000},
+        {0x13000, 0x1000},
+        {0x14000, 0x1000},
+        {0x15000, 0x3000},
+        {0x18000, 0x1000},
+        {0x19000, 0x7000}}},
+      {false,
+       true,
+       {{0x10000, 0x1000},
+        {0x11000, 0x2000},
+        {0x14000, 0x1000},
+        {0x18000, 0x1000}}},
+      // Regions separated by one that was left out aren’t adjacent.
+      {true, true, {{0x10000, 0x3000}, {0x14000, 0x1000}, {0x18000, 0x1000}}},
+  };
+
+  for (const auto& test_case : kTestCases) {
+    SCOPED_TRACE(testing::Message()
+                 << "merge " << test_case.merge_adjacent_regions << ", omit "
+                 << test_case.omit_unusable_regions);
+
+    auto memory_info_list_writer =
+        std::make_unique<MinidumpMemoryInfoListWriter>();
+    memory_info_list_writer->InitializeFromSnapshot(memory_map);
+    memory_info_list_writer->SetMergeAdjacentRegions(
+        test_case.merge_adjacent_regions);
+    memory_info_list_writer->SetOmitUnusableRegions(
+        test_case.omit_unusable_regions);
+
+    MinidumpFileWriter minidump_file_writer;
+    ASSERT_TRUE(
+        minidump_file_writer.AddStream(std::move(memory_info_list_writer)));
+
+    StringFile string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+    const size_t expected_count = test_case.expected_ranges.size();
+    ASSERT_EQ(string_file.string().size(),
+              sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                  sizeof(MINIDUMP_MEMORY_INFO_LIST) +
+                  sizeof(MINIDUMP_MEMORY_INFO) * expected_count);
+
+    const MINIDUMP_MEMORY_INFO_LIST* memory_info_list = nullptr;
+    ASSERT_NO_FATAL_FAILURE(
+        GetMemoryInfoListStream(string_file.string(), &memory_info_list));
+
+    uint64_t number_of_entries;
+    memcpy(&number_of_entries,
+           &memory_info_list->NumberOfEntries,
+           sizeof(number_of_entries));
+    ASSERT_EQ(number_of_entries, expected_count);
+
+    const char* entries = reinterpret_cast<const char*>(memory_info_list + 1);
+    for (size_t index = 0; index < expected_count; ++index) {
+      MINIDUMP_MEMORY_INFO memory_info;
+      memcpy(&memory_info,
+             entries + index * sizeof(memory_info),
+             sizeof(memory_info));
+      EXPECT_EQ(memory_info.BaseAddress,
+                test_case.expected_ranges[index].first);
+      EXPECT_EQ(memory_info.RegionSize,
+                test_case.expected_ranges[index].second);
+      EXPECT_EQ(memory_info.AllocationBase, memory_info.BaseAddress);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -21,11 +21,87 @@
 #include "base/auto_reset.h"
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "build/build_config.h"
 #include "util/file/file_writer.h"
+#include "util/misc/range_set.h"
+#include "util/numeric/checked_range.h"
 #include "util/numeric/safe_assignment.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#include "util/posix/scoped_mmap.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
+namespace {
+
+// The largest piece of a memory region to hold in memory while writing it.
+constexpr size_t kMaxChunkSize = 1024 * 1024;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Writes |memory_snapshot| at the current position of |file_writer| by mapping
+// that part of the file and reading the snapshot directly into the mapping,
+// without staging the data in a separate buffer. Returns false, leaving the
+// file position unchanged, if the file can’t be written this way.
+bool WriteMapped(FileWriterInterface* file_writer,
+                 const MemorySnapshot* memory_snapshot) {
+  const FileHandle handle = file_writer->UnderlyingFileHandle();
+  if (handle == kInvalidFileHandle) {
+    return false;
+  }
+
+  // Mapping a file for writing requires it to be open for reading too.
+  const int flags = fcntl(handle, F_GETFL);
+  if (flags < 0 || (flags & O_ACCMODE) != O_RDWR) {
+    return false;
+  }
+
+  const FileOffset offset = file_writer->Seek(0, SEEK_CUR);
+  if (offset < 0) {
+    return false;
+  }
+
+  const size_t size = memory_snapshot->Size();
+  const FileOffset map_offset = offset & ~FileOffset{getpagesize() - 1};
+  const size_t map_delta = static_cast<size_t>(offset - map_offset);
+
+  // Allocate the file’s blocks before storing to the mapping, so that running
+  // out of space results in an error here instead of SIGBUS later.
+  if (HANDLE_EINTR(fallocate(handle, 0, offset, size)) != 0) {
+    return false;
+  }
+
+  ScopedMmap mapping(/* can_log= */ false);
+  if (!mapping.ResetMmap(nullptr,
+                         map_delta + size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED,
+                         handle,
+                         map_offset)) {
+    return false;
+  }
+
+  char* data = mapping.addr_as<char*>() + map_delta;
+  if (!memory_snapshot->ReadInto(data)) {
+    // As in SnapshotMinidumpMemoryWriter::WriteObject().
+    memset(data, 0xfe, size);
+  }
+  mapping.Reset();
+
+  return file_writer->Seek(offset + size, SEEK_SET) >= 0;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+}  // namespace
+
 SnapshotMinidumpMemoryWriter::SnapshotMinidumpMemoryWriter(
     const MemorySnapshot* memory_snapshot)
     : internal::MinidumpWritable(),
@@ -33,15 +109,21 @@ SnapshotMinidumpMemoryWriter::SnapshotMinidumpMemoryWriter(
       memory_descriptor_(),
       registered_memory_descriptors_(),
       memory_snapshot_(memory_snapshot),
-      file_writer_(nullptr) {}
+      shared_data_source_(nullptr),
+      file_writer_(nullptr),
+      bytes_written_(0) {}
 
 SnapshotMinidumpMemoryWriter::~SnapshotMinidumpMemoryWriter() {}
 
 bool SnapshotMinidumpMemoryWriter::MemorySnapshotDelegateRead(void* data,
                                                               size_t size) {
   DCHECK_EQ(state(), kStateWritable);
-  DCHECK_EQ(size, UnderlyingSnapshot()->Size());
-  return file_writer_->Write(data, size);
+  DCHECK_LE(size, UnderlyingSnapshot()->Size() - bytes_written_);
+  if (!file_writer_->Write(data, size)) {
+    return false;
+  }
+  bytes_written_ += size;
+  return true;
 }
 
 bool SnapshotMinidumpMemoryWriter::WriteObject(
@@ -49,18 +131,40 @@ bool SnapshotMinidumpMemoryWriter::WriteObject(
   DCHECK_EQ(state(), kStateWritable);
   DCHECK(!file_writer_);
 
+  if (shared_data_source_) {
+    return true;
+  }
+
   base::AutoReset<FileWriterInterface*> file_writer_reset(&file_writer_,
                                                           file_writer);
+  bytes_written_ = 0;
 
-  // This will result in MemorySnapshotDelegateRead() being called.
-  if (!memory_snapshot_->Read(this)) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (memory_snapshot_->Size() > kMaxChunkSize &&
+      WriteMapped(file_writer, memory_snapshot_)) {
+    return true;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  // This will result in MemorySnapshotDelegateRead() being called, possibly
+  // several times, so that large regions aren’t held in memory all at once.
+  if (!memory_snapshot_->ReadChunked(this, kMaxChunkSize)) {
     // If the Read() fails (perhaps because the process' memory map has changed
-    // since it the range was captured), write an empty block of memory. It
-    // would be nice to instead not include this memory, but at this point in
-    // the writing process, it would be difficult to amend the minidump's
-    // structure. See https://crashpad.chromium.org/234 for background.
-    std::vector<uint8_t> empty(memory_snapshot_->Size(), 0xfe);
-    MemorySnapshotDelegateRead(empty.data(), empty.size());
+    // since it the range was captured), write an empty block of memory in
+    // place of whatever wasn’t written. It would be nice to instead not include
+    // this memory, but at this point in the writing process, it would be
+    // difficult to amend the minidump's structure. See
+    // https://crashpad.chromium.org/234 for background.
+    const size_t size = memory_snapshot_->Size();
+    std::vector<uint8_t> empty(std::min(size - bytes_written_, kMaxChunkSize),
+                               0xfe);
+    while (bytes_written_ < size) {
+      if (!MemorySnapshotDelegateRead(
+              empty.data(), std::min(size - bytes_written_, empty.size()))) {
+        return false;
+      }
+    }
   }
 
   return true;
@@ -78,7 +182,23 @@ void SnapshotMinidumpMemoryWriter::RegisterMemoryDescriptor(
   DCHECK_LE(state(), kStateFrozen);
 
   registered_memory_descriptors_.push_back(memory_descriptor);
-  RegisterLocationDescriptor(&memory_descriptor->Memory);
+  if (shared_data_source_) {
+    shared_data_source_->RegisterLocationDescriptor(&memory_descriptor->Memory);
+  } else {
+    RegisterLocationDescriptor(&memory_descriptor->Memory);
+  }
+}
+
+void SnapshotMinidumpMemoryWriter::ShareDataWith(
+    SnapshotMinidumpMemoryWriter* original) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(registered_memory_descriptors_.empty());
+  DCHECK_NE(original, this);
+  DCHECK(!original->SharedDataSource());
+  DCHECK_EQ(original->UnderlyingSnapshot()->Size(),
+            UnderlyingSnapshot()->Size());
+
+  shared_data_source_ = original;
 }
 
 bool SnapshotMinidumpMemoryWriter::Freeze() {
@@ -102,7 +222,7 @@ size_t SnapshotMinidumpMemoryWriter::Alignment() {
 size_t SnapshotMinidumpMemoryWriter::SizeOfObject() {
   DCHECK_GE(state(), kStateFrozen);
 
-  return UnderlyingSnapshot()->Size();
+  return shared_data_source_ ? 0 : UnderlyingSnapshot()->Size();
 }
 
 bool SnapshotMinidumpMemoryWriter::WillWriteAtOffsetImpl(FileOffset offset) {
@@ -204,10 +324,17 @@ void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
   for (size_t i = 1; i < children_.size(); ++i) {
     SnapshotMinidumpMemoryWriter* top = all_merged.back().get();
     auto& child = children_[i];
-    if (!DetermineMergedRange(
-            child->UnderlyingSnapshot(), top->UnderlyingSnapshot(), nullptr)) {
+    CheckedRange<uint64_t, size_t> merged_range(0, 0);
+    if (!DetermineMergedRange(child->UnderlyingSnapshot(),
+                              top->UnderlyingSnapshot(),
+                              &merged_range)) {
       // If it doesn't overlap with the current range, push it.
       all_merged.push_back(std::move(child));
+    } else if (merged_range.base() == top->UnderlyingSnapshot()->Address() &&
+               merged_range.size() == top->UnderlyingSnapshot()->Size()) {
+      // The current range already covers it, so there's no need for another
+      // snapshot. Repeated ranges are common, and would otherwise each cost a
+      // merged snapshot.
     } else {
       // Otherwise, merge and update the current element.
       std::unique_ptr<const MemorySnapshot> merged(
@@ -291,22 +418,35 @@ MinidumpStreamType MinidumpMemoryListWriter::StreamType() const {
 }
 
 void MinidumpMemoryListWriter::DropRangesThatOverlapNonOwned() {
-  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> non_overlapping;
-  non_overlapping.reserve(children_.size());
-  for (auto& child_ptr : children_) {
-    bool overlaps = false;
-    for (const auto* non_owned : non_owned_memory_writers_) {
-      if (DetermineMergedRange(child_ptr->UnderlyingSnapshot(),
-                               non_owned->UnderlyingSnapshot(),
-                               nullptr)) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (!overlaps)
-      non_overlapping.push_back(std::move(child_ptr));
+  if (non_owned_memory_writers_.empty()) {
+    return;
   }
-  std::swap(children_, non_overlapping);
+
+  RangeSet non_owned_ranges;
+  for (const auto* non_owned : non_owned_memory_writers_) {
+    const MemorySnapshot* snapshot = non_owned->UnderlyingSnapshot();
+    non_owned_ranges.Insert(snapshot->Address(), snapshot->Size());
+  }
+
+  children_.erase(
+      std::remove_if(
+          children_.begin(),
+          children_.end(),
+          [&non_owned_ranges](const auto& child) {
+            const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+            if (snapshot->Size() == 0) {
+              return false;
+            }
+
+            // As with DetermineMergedRange(), a range that only abuts a
+            // non-owned range is dropped too, so widen it by a byte on each
+            // side.
+            const VMAddress base =
+                snapshot->Address() == 0 ? 0 : snapshot->Address() - 1;
+            const VMAddress end = snapshot->Address() + snapshot->Size();
+            return non_owned_ranges.Overlaps(base, end - base + 1);
+          }),
+      children_.end());
 }
 
 }  // namespace crashpad
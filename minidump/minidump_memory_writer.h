@@ -70,6 +70,32 @@ class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
     memory_snapshot_ = memory_snapshot;
   }
 
+  //! \brief Gets the underlying memory snapshot that the memory writer will
+  //!     write to the minidump.
+  const MemorySnapshot* UnderlyingSnapshot() const { return memory_snapshot_; }
+
+  //! \brief Arranges for the memory descriptors of this object to point to the
+  //!     data written by \a original instead of to a copy of their own.
+  //!
+  //! This is used when the contents of this object’s memory snapshot are
+  //! known to be identical to those of \a original’s, so that the data is only
+  //! stored once in the minidump file. Memory descriptors registered with this
+  //! object retain their own StartOfMemoryRange, but share \a original’s
+  //! MINIDUMP_LOCATION_DESCRIPTOR. This object writes no data of its own.
+  //!
+  //! \a original must be of the same size as this object, must not itself
+  //! share another object’s data, and must be written to the same minidump
+  //! file. This object does not take ownership of \a original.
+  //!
+  //! \note Valid in #kStateMutable.
+  void ShareDataWith(SnapshotMinidumpMemoryWriter* original);
+
+  //! \brief Returns the object whose data this object shares, as set by
+  //!     ShareDataWith(), or `nullptr` if it writes its own data.
+  SnapshotMinidumpMemoryWriter* SharedDataSource() const {
+    return shared_data_source_;
+  }
+
  private:
   friend class MinidumpMemoryListWriter;
 
@@ -105,16 +131,16 @@ class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
   //! \note Valid in any state.
   Phase WritePhase() final;
 
-  //! \brief Gets the underlying memory snapshot that the memory writer will
-  //!     write to the minidump.
-  const MemorySnapshot* UnderlyingSnapshot() const { return memory_snapshot_; }
-
   MINIDUMP_MEMORY_DESCRIPTOR memory_descriptor_;
 
   // weak
   std::vector<MINIDUMP_MEMORY_DESCRIPTOR*> registered_memory_descriptors_;
   const MemorySnapshot* memory_snapshot_;
+  SnapshotMinidumpMemoryWriter* shared_data_source_;  // weak
   FileWriterInterface* file_writer_;
+
+  // The number of bytes of memory_snapshot_ written so far by WriteObject().
+  size_t bytes_written_;
 };
 
 //! \brief The writer for a MINIDUMP_MEMORY_LIST stream in a minidump file,
@@ -19,6 +19,7 @@
 
 #include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
+#include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "minidump/minidump_extensions.h"
 #include "minidump/minidump_file_writer.h"
@@ -28,6 +29,13 @@
 #include "snapshot/test/test_memory_snapshot.h"
 #include "util/file/string_file.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 namespace test {
 namespace {
@@ -687,6 +695,48 @@ TEST(MinidumpMemoryWriter, CoalescePairsVariousCases) {
   // clang-format on
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Large regions written to a file open for reading and writing are read
+// directly into a mapping of the file. The result must match a minidump
+// written the ordinary way.
+TEST(MinidumpMemoryWriter, LargeRegionsToMappableFile) {
+  auto build_minidump = [](MinidumpFileWriter* minidump_file_writer) {
+    auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+    memory_list_writer->AddMemory(std::make_unique<TestMinidumpMemoryWriter>(
+        0x1000, 3 * 1024 * 1024 + 5, 'a'));
+    memory_list_writer->AddMemory(
+        std::make_unique<TestMinidumpMemoryWriter>(0x10000000, 0x100, 'b'));
+    memory_list_writer->AddMemory(std::make_unique<TestMinidumpMemoryWriter>(
+        0x20000000, 2 * 1024 * 1024 + 3, 'c'));
+    return minidump_file_writer->AddStream(std::move(memory_list_writer));
+  };
+
+  MinidumpFileWriter expected_writer;
+  ASSERT_TRUE(build_minidump(&expected_writer));
+  StringFile string_file;
+  ASSERT_TRUE(expected_writer.WriteEverything(&string_file));
+
+  ScopedTempDir temp_dir;
+  const base::FilePath path(temp_dir.path().Append("minidump"));
+  {
+    ScopedFileHandle handle(LoggingOpenFileForReadAndWrite(
+        path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(handle.is_valid());
+    WeakFileHandleFileWriter file_writer(handle.get());
+
+    MinidumpFileWriter minidump_file_writer;
+    ASSERT_TRUE(build_minidump(&minidump_file_writer));
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&file_writer));
+  }
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &contents));
+  EXPECT_EQ(contents.size(), string_file.string().size());
+  EXPECT_TRUE(contents == string_file.string());
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
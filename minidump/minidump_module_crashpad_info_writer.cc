@@ -90,6 +90,18 @@ bool MinidumpModuleCrashpadInfoWriter::IsUseful() const {
   return list_annotations_ || simple_annotations_ || annotation_objects_;
 }
 
+void MinidumpModuleCrashpadInfoWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (simple_annotations_) {
+    simple_annotations_->AddStringsToTable(table);
+  }
+  if (annotation_objects_) {
+    annotation_objects_->AddStringsToTable(table);
+  }
+}
+
 bool MinidumpModuleCrashpadInfoWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -196,6 +208,15 @@ bool MinidumpModuleCrashpadInfoListWriter::IsUseful() const {
   return !module_crashpad_infos_.empty();
 }
 
+void MinidumpModuleCrashpadInfoListWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const auto& module : module_crashpad_infos_) {
+    module->AddStringsToTable(table);
+  }
+}
+
 bool MinidumpModuleCrashpadInfoListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
   CHECK_EQ(module_crashpad_infos_.size(), module_crashpad_info_links_.size());
@@ -100,6 +100,16 @@ class MinidumpModuleCrashpadInfoWriter final
   //! \return `true` if the object is useful, `false` otherwise.
   bool IsUseful() const;
 
+
+  //! \brief Adds the strings in the module’s simple annotations and
+  //!     annotation objects to \a table.
+  //!
+  //! List annotations are not added. They are written by a
+  //! MinidumpUTF8StringListWriter, which can’t refer to shared strings.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -168,6 +178,13 @@ class MinidumpModuleCrashpadInfoListWriter final
   //! \return `true` if the object is useful, `false` otherwise.
   bool IsUseful() const;
 
+
+  //! \brief Adds the annotation strings of every module in the list to
+  //!     \a table, so that strings shared by modules are only written once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -0,0 +1,209 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_module_identity_writer.h"
+
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "util/file/file_writer.h"
+#include "util/misc/uuid.h"
+#include "util/numeric/in_range_cast.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+std::string UUIDToSymbolServerString(const UUID& uuid) {
+  return base::StringPrintf("%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X",
+                            uuid.data_1,
+                            uuid.data_2,
+                            uuid.data_3,
+                            uuid.data_4[0],
+                            uuid.data_4[1],
+                            uuid.data_5[0],
+                            uuid.data_5[1],
+                            uuid.data_5[2],
+                            uuid.data_5[3],
+                            uuid.data_5[4],
+                            uuid.data_5[5]);
+}
+
+}  // namespace
+
+MinidumpModuleIdentityListWriter::MinidumpModuleIdentityListWriter()
+    : MinidumpStreamWriter(), entries_(), strings_(), list_() {}
+
+MinidumpModuleIdentityListWriter::~MinidumpModuleIdentityListWriter() =
+    default;
+
+// static
+std::string MinidumpModuleIdentityListWriter::CodeID(
+    const ModuleSnapshot* module_snapshot) {
+  const std::vector<uint8_t> build_id = module_snapshot->BuildID();
+  if (!build_id.empty()) {
+    std::string code_id;
+    code_id.reserve(build_id.size() * 2);
+    for (uint8_t byte : build_id) {
+      base::StringAppendF(&code_id, "%02x", byte);
+    }
+    return code_id;
+  }
+
+  // This is the form that Microsoft’s symbol server uses to look up a PE
+  // image, which has a timestamp. Mach-O images don’t, and are found by their
+  // UUID instead.
+  const time_t timestamp = module_snapshot->Timestamp();
+  if (timestamp != 0) {
+    return base::StringPrintf(
+        "%08X%x",
+        static_cast<uint32_t>(timestamp),
+        InRangeCast<uint32_t>(module_snapshot->Size(),
+                              std::numeric_limits<uint32_t>::max()));
+  }
+
+  UUID uuid;
+  uint32_t age;
+  module_snapshot->UUIDAndAge(&uuid, &age);
+  if (uuid == UUID()) {
+    return std::string();
+  }
+  return UUIDToSymbolServerString(uuid);
+}
+
+// static
+std::string MinidumpModuleIdentityListWriter::DebugID(
+    const ModuleSnapshot* module_snapshot) {
+  UUID uuid;
+  uint32_t age;
+  module_snapshot->UUIDAndAge(&uuid, &age);
+  if (uuid == UUID() && age == 0) {
+    return std::string();
+  }
+  return UUIDToSymbolServerString(uuid) + base::StringPrintf("%X", age);
+}
+
+void MinidumpModuleIdentityListWriter::InitializeFromSnapshot(
+    const std::vector<const ModuleSnapshot*>& module_snapshots) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(entries_.empty());
+
+  for (const ModuleSnapshot* module_snapshot : module_snapshots) {
+    const std::string code_id = CodeID(module_snapshot);
+    const std::string debug_id = DebugID(module_snapshot);
+    if (code_id.empty() && debug_id.empty()) {
+      continue;
+    }
+    AddModuleIdentity(
+        module_snapshot->Address(),
+        InRangeCast<uint32_t>(module_snapshot->Size(),
+                              std::numeric_limits<uint32_t>::max()),
+        code_id,
+        debug_id,
+        module_snapshot->DebugFileName());
+  }
+}
+
+void MinidumpModuleIdentityListWriter::AddModuleIdentity(
+    uint64_t base_of_image,
+    uint32_t size_of_image,
+    const std::string& code_id,
+    const std::string& debug_id,
+    const std::string& debug_file_name) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  MinidumpModuleIdentity& entry = entries_.emplace_back();
+  entry.base_of_image = base_of_image;
+  entry.size_of_image = size_of_image;
+
+  for (const std::string* string : {&code_id, &debug_id, &debug_file_name}) {
+    auto string_writer = std::make_unique<internal::MinidumpUTF8StringWriter>();
+    string_writer->SetUTF8(*string);
+    strings_.push_back(std::move(string_writer));
+  }
+}
+
+bool MinidumpModuleIdentityListWriter::IsUseful() const {
+  return !entries_.empty();
+}
+
+bool MinidumpModuleIdentityListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&list_.count, entries_.size())) {
+    LOG(ERROR) << "module identity count " << entries_.size()
+               << " out of range";
+    return false;
+  }
+
+  // entries_ no longer changes size, so the RVAs registered here stay put.
+  DCHECK_EQ(strings_.size(), entries_.size() * 3);
+  for (size_t index = 0; index < entries_.size(); ++index) {
+    MinidumpModuleIdentity& entry = entries_[index];
+    strings_[index * 3]->RegisterRVA(&entry.code_id);
+    strings_[index * 3 + 1]->RegisterRVA(&entry.debug_id);
+    strings_[index * 3 + 2]->RegisterRVA(&entry.debug_file_name);
+  }
+
+  return true;
+}
+
+size_t MinidumpModuleIdentityListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(list_) + entries_.size() * sizeof(entries_[0]);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpModuleIdentityListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  std::vector<MinidumpWritable*> children;
+  children.reserve(strings_.size());
+  for (const auto& string : strings_) {
+    children.push_back(string.get());
+  }
+  return children;
+}
+
+bool MinidumpModuleIdentityListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &list_;
+  iov.iov_len = sizeof(list_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!entries_.empty()) {
+    iov.iov_base = entries_.data();
+    iov.iov_len = entries_.size() * sizeof(entries_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpModuleIdentityListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadModuleIdentities;
+}
+
+}  // namespace crashpad
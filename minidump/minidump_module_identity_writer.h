@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_MODULE_IDENTITY_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_MODULE_IDENTITY_WRITER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_string_writer.h"
+#include "minidump/minidump_writable.h"
+#include "snapshot/module_snapshot.h"
+
+namespace crashpad {
+
+//! \brief The writer for a MinidumpModuleIdentityList stream in a minidump
+//!     file.
+class MinidumpModuleIdentityListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpModuleIdentityListWriter();
+
+  MinidumpModuleIdentityListWriter(const MinidumpModuleIdentityListWriter&) =
+      delete;
+  MinidumpModuleIdentityListWriter& operator=(
+      const MinidumpModuleIdentityListWriter&) = delete;
+
+  ~MinidumpModuleIdentityListWriter() override;
+
+  //! \brief Adds a MinidumpModuleIdentity for each module in
+  //!     \a module_snapshots that has a code ID or a debug ID.
+  //!
+  //! \param[in] module_snapshots The module snapshots to use as source data.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ModuleSnapshot*>& module_snapshots);
+
+  //! \brief Adds a MinidumpModuleIdentity for a module.
+  //!
+  //! \param[in] base_of_image The module’s base address.
+  //! \param[in] size_of_image The size of the module’s image.
+  //! \param[in] code_id The module’s code ID.
+  //! \param[in] debug_id The module’s debug ID.
+  //! \param[in] debug_file_name The module’s debug file name.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddModuleIdentity(uint64_t base_of_image,
+                         uint32_t size_of_image,
+                         const std::string& code_id,
+                         const std::string& debug_id,
+                         const std::string& debug_file_name);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying entries would be
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+  //! \brief Returns the code ID that a symbol server would use for the module
+  //!     in \a module_snapshot, or an empty string if it has none.
+  static std::string CodeID(const ModuleSnapshot* module_snapshot);
+
+  //! \brief Returns the debug ID that a symbol server would use for the module
+  //!     in \a module_snapshot, or an empty string if it has none.
+  static std::string DebugID(const ModuleSnapshot* module_snapshot);
+
+ private:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<MinidumpModuleIdentity> entries_;
+
+  // Three strings for each entry: its code ID, debug ID, and debug file name.
+  std::vector<std::unique_ptr<internal::MinidumpUTF8StringWriter>> strings_;
+
+  MinidumpModuleIdentityList list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_MODULE_IDENTITY_WRITER_H_
@@ -0,0 +1,161 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_module_identity_writer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_string_writer_test_util.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "util/file/string_file.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns the MinidumpModuleIdentityList stream, which must be the only
+// stream, in file_contents.
+void GetModuleIdentityStream(const std::string& file_contents,
+                             const MinidumpModuleIdentityList** list) {
+  constexpr size_t kListOffset =
+      sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(),
+            kListOffset + sizeof(MinidumpModuleIdentityList));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType,
+            kMinidumpStreamTypeCrashpadModuleIdentities);
+  EXPECT_EQ(directory[0].Location.Rva, kListOffset);
+
+  *list = reinterpret_cast<const MinidumpModuleIdentityList*>(
+      &file_contents[kListOffset]);
+  ASSERT_EQ(directory[0].Location.DataSize,
+            sizeof(MinidumpModuleIdentityList) +
+                (*list)->count * sizeof(MinidumpModuleIdentity));
+}
+
+TEST(MinidumpModuleIdentityListWriter, Empty) {
+  auto identity_writer = std::make_unique<MinidumpModuleIdentityListWriter>();
+  TestModuleSnapshot module;
+  identity_writer->InitializeFromSnapshot({&module});
+  EXPECT_FALSE(identity_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(identity_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpModuleIdentityList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetModuleIdentityStream(string_file.string(), &list));
+  EXPECT_EQ(list->count, 0u);
+}
+
+TEST(MinidumpModuleIdentityListWriter, FromSnapshot) {
+  // An ELF module, identified by its build ID.
+  TestModuleSnapshot elf_module;
+  elf_module.SetAddressAndSize(0x7f0000000000, 0x4000);
+  elf_module.SetBuildID({0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                         0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+                         0xaa, 0xbb, 0xcc, 0xdd});
+  UUID elf_uuid;
+  ASSERT_TRUE(
+      elf_uuid.InitializeFromString("67452301-ab89-efcd-fedc-ba9876543210"));
+  elf_module.SetUUIDAndAge(elf_uuid, 0);
+  elf_module.SetDebugFileName("libfoo.so");
+
+  // A module with no identifiers is left out.
+  TestModuleSnapshot anonymous_module;
+  anonymous_module.SetAddressAndSize(0x10000, 0x1000);
+
+  // A PE module, identified by its timestamp, size, and PDB.
+  TestModuleSnapshot pe_module;
+  pe_module.SetAddressAndSize(0x140000000, 0x21000);
+  pe_module.SetTimestamp(0x5e8a1b2c);
+  UUID pe_uuid;
+  ASSERT_TRUE(
+      pe_uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  pe_module.SetUUIDAndAge(pe_uuid, 0x1a);
+  pe_module.SetDebugFileName("foo.pdb");
+
+  auto identity_writer = std::make_unique<MinidumpModuleIdentityListWriter>();
+  identity_writer->InitializeFromSnapshot(
+      {&elf_module, &anonymous_module, &pe_module});
+  EXPECT_TRUE(identity_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(identity_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpModuleIdentityList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetModuleIdentityStream(string_file.string(), &list));
+  ASSERT_EQ(list->count, 2u);
+
+  const std::string& contents = string_file.string();
+  const MinidumpModuleIdentity& elf_entry = list->entries[0];
+  EXPECT_EQ(elf_entry.base_of_image, 0x7f0000000000u);
+  EXPECT_EQ(elf_entry.size_of_image, 0x4000u);
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(contents, elf_entry.code_id),
+            "0123456789abcdeffedcba9876543210aabbccdd");
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(contents, elf_entry.debug_id),
+            "67452301AB89EFCDFEDCBA98765432100");
+  EXPECT_EQ(
+      MinidumpUTF8StringAtRVAAsString(contents, elf_entry.debug_file_name),
+      "libfoo.so");
+
+  const MinidumpModuleIdentity& pe_entry = list->entries[1];
+  EXPECT_EQ(pe_entry.base_of_image, 0x140000000u);
+  EXPECT_EQ(pe_entry.size_of_image, 0x21000u);
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(contents, pe_entry.code_id),
+            "5E8A1B2C21000");
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(contents, pe_entry.debug_id),
+            "00112233445566778899AABBCCDDEEFF1A");
+  EXPECT_EQ(
+      MinidumpUTF8StringAtRVAAsString(contents, pe_entry.debug_file_name),
+      "foo.pdb");
+}
+
+TEST(MinidumpModuleIdentityListWriter, MachOCodeID) {
+  // Without a build ID or a timestamp, the UUID stands in for the code ID.
+  TestModuleSnapshot module;
+  UUID uuid;
+  ASSERT_TRUE(
+      uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  module.SetUUIDAndAge(uuid, 0);
+  EXPECT_EQ(MinidumpModuleIdentityListWriter::CodeID(&module),
+            "00112233445566778899AABBCCDDEEFF");
+  EXPECT_EQ(MinidumpModuleIdentityListWriter::DebugID(&module),
+            "00112233445566778899AABBCCDDEEFF0");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -361,6 +361,15 @@ void MinidumpModuleWriter::SetFileFlagsAndMask(uint32_t file_flags,
   module_.VersionInfo.dwFileFlagsMask = file_flags_mask;
 }
 
+void MinidumpModuleWriter::AddStringsToTable(
+    internal::MinidumpUTF16StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (name_) {
+    table->Add(name_.get());
+  }
+}
+
 bool MinidumpModuleWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
   CHECK(name_);
@@ -443,6 +452,15 @@ void MinidumpModuleListWriter::AddModule(
 bool MinidumpModuleListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
+  // Modules register RVAs with their names while they are frozen, so names
+  // must be shared before that.
+  {
+    internal::MinidumpUTF16StringTable table;
+    for (const auto& module : modules_) {
+      module->AddStringsToTable(&table);
+    }
+  }
+
   if (!MinidumpStreamWriter::Freeze()) {
     return false;
   }
@@ -27,6 +27,7 @@
 
 #include "minidump/minidump_extensions.h"
 #include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_string_writer.h"
 #include "minidump/minidump_writable.h"
 
 namespace crashpad {
@@ -328,6 +329,14 @@ class MinidumpModuleWriter final : public internal::MinidumpWritable {
     module_.VersionInfo.dwFileSubtype = file_subtype;
   }
 
+
+  //! \brief Adds the module’s name to \a table, so that a name used by
+  //!     several modules, such as a file mapped more than once, is only
+  //!     written once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF16StringTable* table);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -49,6 +49,14 @@ void MinidumpSimpleStringDictionaryEntryWriter::SetKeyValue(
   value_.SetUTF8(value);
 }
 
+void MinidumpSimpleStringDictionaryEntryWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  table->Add(&key_);
+  table->Add(&value_);
+}
+
 bool MinidumpSimpleStringDictionaryEntryWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -133,6 +141,15 @@ bool MinidumpSimpleStringDictionaryWriter::IsUseful() const {
   return !entries_.empty();
 }
 
+void MinidumpSimpleStringDictionaryWriter::AddStringsToTable(
+    internal::MinidumpUTF8StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const auto& key_entry : entries_) {
+    key_entry.second->AddStringsToTable(table);
+  }
+}
+
 bool MinidumpSimpleStringDictionaryWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -69,6 +69,13 @@ class MinidumpSimpleStringDictionaryEntryWriter final
   //! \note Valid in any state.
   const std::string& Key() const { return key_.UTF8(); }
 
+
+  //! \brief Adds the entry’s key and value to \a table, so that strings
+  //!     repeated elsewhere in the minidump file are only written once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
 
@@ -133,6 +140,12 @@ class MinidumpSimpleStringDictionaryWriter final
   //! \return `true` if the object is useful, `false` otherwise.
   bool IsUseful() const;
 
+
+  //! \brief Adds the keys and values of all entries to \a table.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF8StringTable* table);
+
  protected:
   // MinidumpWritable:
 
@@ -27,13 +27,44 @@ namespace internal {
 
 template <typename Traits>
 MinidumpStringWriter<Traits>::MinidumpStringWriter()
-    : MinidumpWritable(), string_base_(new MinidumpStringType()), string_() {
-}
+    : MinidumpWritable(),
+      string_base_(new MinidumpStringType()),
+      string_(),
+      shared_data_source_(nullptr) {}
 
 template <typename Traits>
 MinidumpStringWriter<Traits>::~MinidumpStringWriter() {
 }
 
+template <typename Traits>
+void MinidumpStringWriter<Traits>::ShareDataWith(
+    MinidumpStringWriter* original) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_NE(original, this);
+  DCHECK(!original->SharedDataSource());
+  DCHECK(original->string() == string());
+
+  shared_data_source_ = original;
+}
+
+template <typename Traits>
+void MinidumpStringWriter<Traits>::RegisterRVA(RVA* rva) {
+  if (shared_data_source_) {
+    shared_data_source_->RegisterRVA(rva);
+    return;
+  }
+  MinidumpWritable::RegisterRVA(rva);
+}
+
+template <typename Traits>
+void MinidumpStringWriter<Traits>::RegisterRVA(RVA64* rva64) {
+  if (shared_data_source_) {
+    shared_data_source_->RegisterRVA(rva64);
+    return;
+  }
+  MinidumpWritable::RegisterRVA(rva64);
+}
+
 template <typename Traits>
 bool MinidumpStringWriter<Traits>::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
@@ -55,6 +86,10 @@ template <typename Traits>
 size_t MinidumpStringWriter<Traits>::SizeOfObject() {
   DCHECK_GE(state(), kStateFrozen);
 
+  if (shared_data_source_) {
+    return 0;
+  }
+
   // Include the NUL terminator.
   return sizeof(*string_base_) + (string_.size() + 1) * sizeof(string_[0]);
 }
@@ -64,6 +99,10 @@ bool MinidumpStringWriter<Traits>::WriteObject(
     FileWriterInterface* file_writer) {
   DCHECK_EQ(state(), kStateWritable);
 
+  if (shared_data_source_) {
+    return true;
+  }
+
   // The string’s length is stored in string_base_, and its data is stored in
   // string_. Write them both.
   WritableIoVec iov;
@@ -84,6 +123,19 @@ bool MinidumpStringWriter<Traits>::WriteObject(
 template class MinidumpStringWriter<MinidumpStringWriterUTF16Traits>;
 template class MinidumpStringWriter<MinidumpStringWriterUTF8Traits>;
 
+template <typename Traits>
+void MinidumpStringTable<Traits>::Add(MinidumpStringWriter<Traits>* writer) {
+  DCHECK(!writer->SharedDataSource());
+
+  auto [it, inserted] = strings_.emplace(writer->string(), writer);
+  if (!inserted && it->second != writer) {
+    writer->ShareDataWith(it->second);
+  }
+}
+
+template class MinidumpStringTable<MinidumpStringWriterUTF16Traits>;
+template class MinidumpStringTable<MinidumpStringWriterUTF8Traits>;
+
 MinidumpUTF16StringWriter::~MinidumpUTF16StringWriter() {
 }
 
@@ -19,6 +19,7 @@
 #include <dbghelp.h>
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -60,6 +61,36 @@ class MinidumpStringWriter : public MinidumpWritable {
 
   ~MinidumpStringWriter() override;
 
+  //! \brief Arranges for this object to refer to the copy of its string
+  //!     written by \a original instead of writing a copy of its own.
+  //!
+  //! Once this is called, this object occupies no space in the minidump file,
+  //! and RVAs registered with it point to \a original. \a original must hold
+  //! the same string, must not itself share another object’s data, and must
+  //! be written to the same minidump file.
+  //!
+  //! \note Valid in #kStateMutable.
+  void ShareDataWith(MinidumpStringWriter* original);
+
+  //! \brief Returns the object whose data this object refers to, or `nullptr`
+  //!     if ShareDataWith() has not been called.
+  MinidumpStringWriter* SharedDataSource() const {
+    return shared_data_source_;
+  }
+
+  //! \brief Registers \a rva to point to this string.
+  //!
+  //! If ShareDataWith() was called, the registration is made with the object
+  //! that this object shares data with. This is only done when called through
+  //! a pointer or reference to a string writer, because
+  //! MinidumpWritable::RegisterRVA() is not virtual.
+  //!
+  //! \note Valid in #kStateFrozen or any preceding state.
+  void RegisterRVA(RVA* rva);
+
+  //! \copydoc RegisterRVA(RVA*)
+  void RegisterRVA(RVA64* rva64);
+
  protected:
   using MinidumpStringType = typename Traits::MinidumpStringType;
   using StringType = typename Traits::StringType;
@@ -79,10 +110,50 @@ class MinidumpStringWriter : public MinidumpWritable {
   const StringType& string() const { return string_; }
 
  private:
+  template <typename>
+  friend class MinidumpStringTable;
+
   std::unique_ptr<MinidumpStringType> string_base_;
   StringType string_;
+  MinidumpStringWriter* shared_data_source_;  // weak
 };
 
+//! \brief Finds string writers with identical contents so that each string is
+//!     only written to a minidump file once.
+//!
+//! Each writer passed to Add() whose string matches that of a writer added
+//! earlier is made to share that writer’s data with
+//! MinidumpStringWriter::ShareDataWith(). A table is only needed while the
+//! writers are collected, and may be destroyed before they are written.
+//!
+//! Writers must only be added if they will be written as part of the same
+//! minidump file, and only if the objects that point to them register their
+//! RVAs through MinidumpStringWriter::RegisterRVA().
+template <typename Traits>
+class MinidumpStringTable {
+ public:
+  MinidumpStringTable() : strings_() {}
+
+  MinidumpStringTable(const MinidumpStringTable&) = delete;
+  MinidumpStringTable& operator=(const MinidumpStringTable&) = delete;
+
+  ~MinidumpStringTable() {}
+
+  //! \brief Adds \a writer to the table.
+  //!
+  //! \note Valid while \a writer is in #kStateMutable.
+  void Add(MinidumpStringWriter<Traits>* writer);
+
+ private:
+  std::map<typename Traits::StringType, MinidumpStringWriter<Traits>*>
+      strings_;
+};
+
+using MinidumpUTF16StringTable =
+    MinidumpStringTable<MinidumpStringWriterUTF16Traits>;
+using MinidumpUTF8StringTable =
+    MinidumpStringTable<MinidumpStringWriterUTF8Traits>;
+
 //! \brief Writes a variable-length UTF-16-encoded MINIDUMP_STRING to a minidump
 //!     file.
 //!
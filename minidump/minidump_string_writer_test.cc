@@ -15,8 +15,10 @@
 #include "minidump/minidump_string_writer.h"
 
 #include <iterator>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "base/format_macros.h"
 #include "base/notreached.h"
@@ -272,6 +274,95 @@ TYPED_TEST(MinidumpStringWriter, MinidumpUTF8StringList) {
   MinidumpStringListTest<MinidumpUTF8StringListWriterTraits>();
 }
 
+// Writes an array of RVAs, each pointing to one of its child strings.
+class StringRVAArrayWriter final : public crashpad::internal::MinidumpWritable {
+ public:
+  explicit StringRVAArrayWriter(const std::vector<std::string>& strings)
+      : MinidumpWritable(), rvas_(strings.size()), strings_() {
+    for (const std::string& string : strings) {
+      strings_.push_back(
+          std::make_unique<crashpad::internal::MinidumpUTF8StringWriter>());
+      strings_.back()->SetUTF8(string);
+    }
+  }
+
+  StringRVAArrayWriter(const StringRVAArrayWriter&) = delete;
+  StringRVAArrayWriter& operator=(const StringRVAArrayWriter&) = delete;
+
+  ~StringRVAArrayWriter() override = default;
+
+  void AddStringsToTable(crashpad::internal::MinidumpUTF8StringTable* table) {
+    for (const auto& string : strings_) {
+      table->Add(string.get());
+    }
+  }
+
+ private:
+  bool Freeze() override {
+    if (!MinidumpWritable::Freeze()) {
+      return false;
+    }
+    for (size_t index = 0; index < strings_.size(); ++index) {
+      strings_[index]->RegisterRVA(&rvas_[index]);
+    }
+    return true;
+  }
+
+  size_t SizeOfObject() override { return rvas_.size() * sizeof(rvas_[0]); }
+
+  std::vector<MinidumpWritable*> Children() override {
+    std::vector<MinidumpWritable*> children;
+    for (const auto& string : strings_) {
+      children.push_back(string.get());
+    }
+    return children;
+  }
+
+  bool WriteObject(FileWriterInterface* file_writer) override {
+    return file_writer->Write(rvas_.data(), SizeOfObject());
+  }
+
+  std::vector<RVA> rvas_;
+  std::vector<std::unique_ptr<crashpad::internal::MinidumpUTF8StringWriter>>
+      strings_;
+};
+
+TEST(MinidumpStringTable, SharesIdenticalStrings) {
+  const std::vector<std::string> strings = {"one", "two", "one", "", "two", ""};
+
+  StringFile unshared_file;
+  {
+    StringRVAArrayWriter writer(strings);
+    ASSERT_TRUE(writer.WriteEverything(&unshared_file));
+  }
+
+  StringFile shared_file;
+  {
+    StringRVAArrayWriter writer(strings);
+    crashpad::internal::MinidumpUTF8StringTable table;
+    writer.AddStringsToTable(&table);
+    ASSERT_TRUE(writer.WriteEverything(&shared_file));
+  }
+
+  // Three of the six strings are written, and each takes up eight bytes: four
+  // for the length, up to three for the data, and one for the NUL terminator.
+  EXPECT_EQ(unshared_file.string().size() - shared_file.string().size(),
+            3 * (sizeof(MinidumpUTF8String) + 4));
+
+  const RVA* rvas = reinterpret_cast<const RVA*>(shared_file.string().data());
+  EXPECT_EQ(rvas[2], rvas[0]);
+  EXPECT_EQ(rvas[4], rvas[1]);
+  EXPECT_EQ(rvas[5], rvas[3]);
+  EXPECT_NE(rvas[1], rvas[0]);
+  EXPECT_NE(rvas[3], rvas[0]);
+
+  for (size_t index = 0; index < strings.size(); ++index) {
+    EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(shared_file.string(),
+                                              rvas[index]),
+              strings[index]);
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,177 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_breadcrumbs_writer.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpThreadBreadcrumbsWriter::MinidumpThreadBreadcrumbsWriter()
+    : MinidumpWritable(), breadcrumbs_(), data_() {}
+
+MinidumpThreadBreadcrumbsWriter::~MinidumpThreadBreadcrumbsWriter() = default;
+
+void MinidumpThreadBreadcrumbsWriter::InitializeFromSnapshot(
+    const ThreadSnapshot* thread_snapshot,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+  DCHECK(it != thread_id_map.end());
+  SetThreadID(it->second);
+  SetBreadcrumbs(thread_snapshot->Breadcrumbs());
+}
+
+void MinidumpThreadBreadcrumbsWriter::SetBreadcrumbs(
+    const std::vector<uint8_t>& breadcrumbs) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  data_.set_data(breadcrumbs);
+}
+
+bool MinidumpThreadBreadcrumbsWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpWritable::Freeze()) {
+    return false;
+  }
+
+  data_.RegisterRVA(&breadcrumbs_.breadcrumbs);
+
+  return true;
+}
+
+size_t MinidumpThreadBreadcrumbsWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  // This object is written by the MinidumpThreadBreadcrumbsListWriter, and its
+  // children write themselves.
+  return 0;
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpThreadBreadcrumbsWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return {&data_};
+}
+
+bool MinidumpThreadBreadcrumbsWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  // This object is written by the MinidumpThreadBreadcrumbsListWriter, and its
+  // children write themselves.
+  return true;
+}
+
+MinidumpThreadBreadcrumbsListWriter::MinidumpThreadBreadcrumbsListWriter()
+    : MinidumpStreamWriter(), thread_breadcrumbs_(), list_() {}
+
+MinidumpThreadBreadcrumbsListWriter::~MinidumpThreadBreadcrumbsListWriter() =
+    default;
+
+void MinidumpThreadBreadcrumbsListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(thread_breadcrumbs_.empty());
+
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    if (thread_snapshot->Breadcrumbs().empty()) {
+      continue;
+    }
+    auto thread_breadcrumbs =
+        std::make_unique<MinidumpThreadBreadcrumbsWriter>();
+    thread_breadcrumbs->InitializeFromSnapshot(thread_snapshot, thread_id_map);
+    AddThreadBreadcrumbs(std::move(thread_breadcrumbs));
+  }
+}
+
+void MinidumpThreadBreadcrumbsListWriter::AddThreadBreadcrumbs(
+    std::unique_ptr<MinidumpThreadBreadcrumbsWriter> thread_breadcrumbs) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  thread_breadcrumbs_.push_back(std::move(thread_breadcrumbs));
+}
+
+bool MinidumpThreadBreadcrumbsListWriter::IsUseful() const {
+  return !thread_breadcrumbs_.empty();
+}
+
+bool MinidumpThreadBreadcrumbsListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&list_.count, thread_breadcrumbs_.size())) {
+    LOG(ERROR) << "thread breadcrumbs count " << thread_breadcrumbs_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpThreadBreadcrumbsListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(list_) +
+         thread_breadcrumbs_.size() * sizeof(MinidumpThreadBreadcrumbs);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpThreadBreadcrumbsListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  std::vector<MinidumpWritable*> children;
+  children.reserve(thread_breadcrumbs_.size());
+  for (const auto& thread_breadcrumbs : thread_breadcrumbs_) {
+    children.push_back(thread_breadcrumbs.get());
+  }
+
+  return children;
+}
+
+bool MinidumpThreadBreadcrumbsListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  std::vector<WritableIoVec> iov;
+  iov.reserve(1 + thread_breadcrumbs_.size());
+  iov.emplace_back(WritableIoVec{&list_, sizeof(list_)});
+
+  for (const auto& thread_breadcrumbs : thread_breadcrumbs_) {
+    iov.emplace_back(
+        WritableIoVec{thread_breadcrumbs->minidump_thread_breadcrumbs(),
+                      sizeof(MinidumpThreadBreadcrumbs)});
+  }
+
+  return file_writer->WriteIoVec(&iov);
+}
+
+MinidumpStreamType MinidumpThreadBreadcrumbsListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadThreadBreadcrumbs;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,155 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_THREAD_BREADCRUMBS_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_THREAD_BREADCRUMBS_WRITER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_byte_array_writer.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpThreadBreadcrumbs object in a minidump
+//!     file.
+//!
+//! Because MinidumpThreadBreadcrumbs objects only appear as elements of
+//! MinidumpThreadBreadcrumbsList objects, this class does not write any data on
+//! its own. It makes its MinidumpThreadBreadcrumbs data available to its
+//! MinidumpThreadBreadcrumbsListWriter parent, which writes it as part of a
+//! MinidumpThreadBreadcrumbsList.
+class MinidumpThreadBreadcrumbsWriter final
+    : public internal::MinidumpWritable {
+ public:
+  MinidumpThreadBreadcrumbsWriter();
+
+  MinidumpThreadBreadcrumbsWriter(const MinidumpThreadBreadcrumbsWriter&) =
+      delete;
+  MinidumpThreadBreadcrumbsWriter& operator=(
+      const MinidumpThreadBreadcrumbsWriter&) = delete;
+
+  ~MinidumpThreadBreadcrumbsWriter() override;
+
+  //! \brief Initializes the MinidumpThreadBreadcrumbs based on \a
+  //!     thread_snapshot.
+  //!
+  //! \param[in] thread_snapshot The thread snapshot to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap to be consulted to
+  //!     determine the 32-bit minidump thread ID to use for \a thread_snapshot.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(const ThreadSnapshot* thread_snapshot,
+                              const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Sets MinidumpThreadBreadcrumbs::thread_id.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetThreadID(uint32_t thread_id) { breadcrumbs_.thread_id = thread_id; }
+
+  //! \brief Sets the data referenced by MinidumpThreadBreadcrumbs::breadcrumbs.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetBreadcrumbs(const std::vector<uint8_t>& breadcrumbs);
+
+  //! \brief Returns the MinidumpThreadBreadcrumbs referencing this object’s
+  //!     data.
+  const MinidumpThreadBreadcrumbs* minidump_thread_breadcrumbs() const {
+    return &breadcrumbs_;
+  }
+
+ protected:
+  // MinidumpWritable:
+
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+ private:
+  MinidumpThreadBreadcrumbs breadcrumbs_;
+  MinidumpByteArrayWriter data_;
+};
+
+//! \brief The writer for a MinidumpThreadBreadcrumbsList stream in a minidump
+//!     file, containing a list of MinidumpThreadBreadcrumbs objects.
+class MinidumpThreadBreadcrumbsListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpThreadBreadcrumbsListWriter();
+
+  MinidumpThreadBreadcrumbsListWriter(
+      const MinidumpThreadBreadcrumbsListWriter&) = delete;
+  MinidumpThreadBreadcrumbsListWriter& operator=(
+      const MinidumpThreadBreadcrumbsListWriter&) = delete;
+
+  ~MinidumpThreadBreadcrumbsListWriter() override;
+
+  //! \brief Adds an initialized MinidumpThreadBreadcrumbs for each thread in \a
+  //!     thread_snapshots that has breadcrumbs.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds a MinidumpThreadBreadcrumbsWriter to the
+  //!     MinidumpThreadBreadcrumbsList.
+  //!
+  //! This object takes ownership of \a thread_breadcrumbs and becomes its
+  //! parent in the overall tree of internal::MinidumpWritable objects.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddThreadBreadcrumbs(
+      std::unique_ptr<MinidumpThreadBreadcrumbsWriter> thread_breadcrumbs);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying entries would be
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ private:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<std::unique_ptr<MinidumpThreadBreadcrumbsWriter>>
+      thread_breadcrumbs_;
+  MinidumpThreadBreadcrumbsList list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_THREAD_BREADCRUMBS_WRITER_H_
@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_breadcrumbs_writer.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_byte_array_writer_test_util.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// This returns the MinidumpThreadBreadcrumbsList stream in |list|.
+void GetThreadBreadcrumbsListStream(
+    const std::string& file_contents,
+    const MinidumpThreadBreadcrumbsList** list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr uint32_t kExpectedStreams = 1;
+  constexpr size_t kListStreamOffset =
+      kDirectoryOffset + kExpectedStreams * sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(),
+            kListStreamOffset + sizeof(MinidumpThreadBreadcrumbsList));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, kExpectedStreams, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType,
+            kMinidumpStreamTypeCrashpadThreadBreadcrumbs);
+  EXPECT_EQ(directory[0].Location.Rva, kListStreamOffset);
+
+  *list = MinidumpWritableAtLocationDescriptor<MinidumpThreadBreadcrumbsList>(
+      file_contents, directory[0].Location);
+  ASSERT_TRUE(*list);
+}
+
+TEST(MinidumpThreadBreadcrumbsListWriter, Empty) {
+  auto list_writer = std::make_unique<MinidumpThreadBreadcrumbsListWriter>();
+  EXPECT_FALSE(list_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpThreadBreadcrumbsList));
+
+  const MinidumpThreadBreadcrumbsList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadBreadcrumbsListStream(string_file.string(), &list));
+  EXPECT_EQ(list->count, 0u);
+}
+
+TEST(MinidumpThreadBreadcrumbsListWriter, TwoThreads) {
+  constexpr uint32_t kThreadID0 = 0x11111111;
+  const std::vector<uint8_t> kBreadcrumbs0 = {1, 2, 3, 4, 5};
+  constexpr uint32_t kThreadID1 = 0x22222222;
+  const std::vector<uint8_t> kBreadcrumbs1 = {6, 7, 8};
+
+  auto list_writer = std::make_unique<MinidumpThreadBreadcrumbsListWriter>();
+
+  auto breadcrumbs_writer = std::make_unique<MinidumpThreadBreadcrumbsWriter>();
+  breadcrumbs_writer->SetThreadID(kThreadID0);
+  breadcrumbs_writer->SetBreadcrumbs(kBreadcrumbs0);
+  list_writer->AddThreadBreadcrumbs(std::move(breadcrumbs_writer));
+
+  breadcrumbs_writer = std::make_unique<MinidumpThreadBreadcrumbsWriter>();
+  breadcrumbs_writer->SetThreadID(kThreadID1);
+  breadcrumbs_writer->SetBreadcrumbs(kBreadcrumbs1);
+  list_writer->AddThreadBreadcrumbs(std::move(breadcrumbs_writer));
+
+  EXPECT_TRUE(list_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpThreadBreadcrumbsList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadBreadcrumbsListStream(string_file.string(), &list));
+  ASSERT_EQ(list->count, 2u);
+
+  EXPECT_EQ(list->entries[0].thread_id, kThreadID0);
+  EXPECT_EQ(MinidumpByteArrayAtRVA(string_file.string(),
+                                   list->entries[0].breadcrumbs),
+            kBreadcrumbs0);
+  EXPECT_EQ(list->entries[1].thread_id, kThreadID1);
+  EXPECT_EQ(MinidumpByteArrayAtRVA(string_file.string(),
+                                   list->entries[1].breadcrumbs),
+            kBreadcrumbs1);
+}
+
+TEST(MinidumpThreadBreadcrumbsListWriter, InitializeFromSnapshot) {
+  constexpr uint64_t kThreadID0 = 0x0123456789abcdef;
+  const std::vector<uint8_t> kBreadcrumbs0 = {0xde, 0xad, 0xbe, 0xef};
+  constexpr uint64_t kThreadID1 = 0x1111111111111111;
+
+  TestThreadSnapshot thread_snapshot_0;
+  thread_snapshot_0.SetThreadID(kThreadID0);
+  thread_snapshot_0.SetBreadcrumbs(kBreadcrumbs0);
+
+  // This thread has no breadcrumbs, and is not included in the list.
+  TestThreadSnapshot thread_snapshot_1;
+  thread_snapshot_1.SetThreadID(kThreadID1);
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[kThreadID0] = 0x89abcdef;
+  thread_id_map[kThreadID1] = 0x11111111;
+
+  auto list_writer = std::make_unique<MinidumpThreadBreadcrumbsListWriter>();
+  list_writer->InitializeFromSnapshot({&thread_snapshot_0, &thread_snapshot_1},
+                                      thread_id_map);
+  EXPECT_TRUE(list_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpThreadBreadcrumbsList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadBreadcrumbsListStream(string_file.string(), &list));
+  ASSERT_EQ(list->count, 1u);
+  EXPECT_EQ(list->entries[0].thread_id, 0x89abcdefu);
+  EXPECT_EQ(MinidumpByteArrayAtRVA(string_file.string(),
+                                   list->entries[0].breadcrumbs),
+            kBreadcrumbs0);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,228 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_group_writer.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "minidump/minidump_context_array_writer.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+void AppendLEB128(uint64_t value, std::vector<uint8_t>* data) {
+  while (value >= 0x80) {
+    data->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  data->push_back(static_cast<uint8_t>(value));
+}
+
+// Appends value, zigzag-encoded so that small numbers of either sign stay
+// small.
+void AppendSigned(int64_t value, std::vector<uint8_t>* data) {
+  AppendLEB128((static_cast<uint64_t>(value) << 1) ^
+                   static_cast<uint64_t>(value >> 63),
+               data);
+}
+
+// Appends the change from previous to value, taken modulo 2^64 as a signed
+// number.
+void AppendDelta(uint64_t value,
+                 uint64_t previous,
+                 std::vector<uint8_t>* data) {
+  AppendSigned(static_cast<int64_t>(value - previous), data);
+}
+
+// The values of the previous thread added to a group, which the next thread’s
+// values are encoded relative to.
+struct PreviousThread {
+  uint64_t thread_id = 0;
+  uint64_t teb = 0;
+  uint64_t stack_address = 0;
+  uint64_t context_index = 0;
+};
+
+}  // namespace
+
+MinidumpThreadGroupListWriter::Group::Group() : group(), name(), threads() {}
+
+MinidumpThreadGroupListWriter::Group::~Group() = default;
+
+MinidumpThreadGroupListWriter::MinidumpThreadGroupListWriter()
+    : MinidumpStreamWriter(), groups_(), context_array_(nullptr), list_() {}
+
+MinidumpThreadGroupListWriter::~MinidumpThreadGroupListWriter() = default;
+
+void MinidumpThreadGroupListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(groups_.empty());
+
+  std::map<std::pair<std::string, uint64_t>, size_t> group_indices;
+  std::vector<PreviousThread> previous_threads;
+  std::vector<std::vector<uint8_t>> group_data;
+
+  for (size_t index = 0; index < thread_snapshots.size(); ++index) {
+    const ThreadSnapshot* thread_snapshot = thread_snapshots[index];
+
+    uint64_t stack_address = 0;
+    uint64_t stack_size = 0;
+    const MemorySnapshot* stack_snapshot = thread_snapshot->Stack();
+    if (stack_snapshot && stack_snapshot->Size() > 0) {
+      stack_address = stack_snapshot->Address();
+      stack_size = stack_snapshot->Size();
+    }
+
+    std::string name = thread_snapshot->ThreadName();
+    auto [group_it, inserted] = group_indices.insert(
+        std::make_pair(std::make_pair(name, stack_size), groups_.size()));
+    if (inserted) {
+      auto group = std::make_unique<Group>();
+      group->group.stack_size = stack_size;
+      if (!name.empty()) {
+        group->name = std::make_unique<internal::MinidumpUTF8StringWriter>();
+        group->name->SetUTF8(name);
+      }
+      groups_.push_back(std::move(group));
+      previous_threads.emplace_back();
+      group_data.emplace_back();
+    }
+
+    const size_t group_index = group_it->second;
+    ++groups_[group_index]->group.thread_count;
+
+    const auto thread_id_it = thread_id_map.find(thread_snapshot->ThreadID());
+    DCHECK(thread_id_it != thread_id_map.end());
+    const uint64_t thread_id = thread_id_it->second;
+    const uint64_t teb = thread_snapshot->ThreadSpecificDataAddress();
+
+    PreviousThread& previous = previous_threads[group_index];
+    std::vector<uint8_t>* data = &group_data[group_index];
+    AppendDelta(thread_id, previous.thread_id, data);
+    AppendLEB128(static_cast<uint32_t>(thread_snapshot->SuspendCount()), data);
+    AppendSigned(thread_snapshot->Priority(), data);
+    AppendDelta(teb, previous.teb, data);
+    AppendDelta(stack_address, previous.stack_address, data);
+    AppendDelta(index, previous.context_index, data);
+
+    previous.thread_id = thread_id;
+    previous.teb = teb;
+    previous.stack_address = stack_address;
+    previous.context_index = index;
+  }
+
+  for (size_t group_index = 0; group_index < groups_.size(); ++group_index) {
+    groups_[group_index]->threads.set_data(group_data[group_index]);
+  }
+}
+
+void MinidumpThreadGroupListWriter::SetContextArray(
+    MinidumpContextArrayWriter* context_array) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  context_array_ = context_array;
+}
+
+bool MinidumpThreadGroupListWriter::IsUseful() const {
+  return !groups_.empty();
+}
+
+bool MinidumpThreadGroupListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  list_.version = MinidumpThreadGroupList::kVersion;
+
+  if (!AssignIfInRange(&list_.count, groups_.size())) {
+    LOG(ERROR) << "thread group count " << groups_.size() << " out of range";
+    return false;
+  }
+
+  if (context_array_) {
+    if (!AssignIfInRange(&list_.context_size, context_array_->ContextSize())) {
+      LOG(ERROR) << "context size " << context_array_->ContextSize()
+                 << " out of range";
+      return false;
+    }
+    context_array_->RegisterArrayLocationDescriptor(&list_.contexts);
+  }
+
+  for (const auto& group : groups_) {
+    if (group->name) {
+      group->name->RegisterRVA(&group->group.name);
+    }
+    group->threads.RegisterRVA(&group->group.threads);
+  }
+
+  return true;
+}
+
+size_t MinidumpThreadGroupListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(list_) + groups_.size() * sizeof(MinidumpThreadGroup);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpThreadGroupListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  std::vector<MinidumpWritable*> children;
+  children.reserve(groups_.size() * 2);
+  for (const auto& group : groups_) {
+    if (group->name) {
+      children.push_back(group->name.get());
+    }
+    children.push_back(&group->threads);
+  }
+  return children;
+}
+
+bool MinidumpThreadGroupListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &list_;
+  iov.iov_len = sizeof(list_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  for (const auto& group : groups_) {
+    iov.iov_base = &group->group;
+    iov.iov_len = sizeof(group->group);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpThreadGroupListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadThreadGroups;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,117 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_THREAD_GROUP_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_THREAD_GROUP_WRITER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_byte_array_writer.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_string_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class MinidumpContextArrayWriter;
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpThreadGroupList stream in a minidump file.
+//!
+//! Every thread is described in roughly a dozen bytes, instead of the
+//! MINIDUMP_THREAD and thread name that the standard streams need. This is
+//! meant for processes with so many threads that those streams become large,
+//! in which case MinidumpThreadListWriter::SetListedThreads() can limit the
+//! standard streams to the threads most likely to be of interest.
+class MinidumpThreadGroupListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpThreadGroupListWriter();
+
+  MinidumpThreadGroupListWriter(const MinidumpThreadGroupListWriter&) = delete;
+  MinidumpThreadGroupListWriter& operator=(
+      const MinidumpThreadGroupListWriter&) = delete;
+
+  ~MinidumpThreadGroupListWriter() override;
+
+  //! \brief Groups the threads in \a thread_snapshots by name and stack size,
+  //!     and encodes each group.
+  //!
+  //! Groups appear in the order of their first thread in \a thread_snapshots,
+  //! and threads appear in each group in the same order as in \a
+  //! thread_snapshots. A thread’s position in \a thread_snapshots is taken as
+  //! the index of its context in the array set by SetContextArray().
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap to be consulted to
+  //!     determine the 32-bit minidump thread ID to use for each thread.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Arranges for MinidumpThreadGroupList::contexts to point to the
+  //!     contexts written by \a context_array.
+  //!
+  //! This object does not take ownership of \a context_array, which must be
+  //! written as part of the same minidump file, normally by a
+  //! MinidumpThreadListWriter.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetContextArray(MinidumpContextArrayWriter* context_array);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying at least one thread
+  //! would be considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ private:
+  // A MinidumpThreadGroup and the objects it refers to.
+  struct Group {
+    Group();
+    ~Group();
+
+    MinidumpThreadGroup group;
+    std::unique_ptr<internal::MinidumpUTF8StringWriter> name;
+    MinidumpByteArrayWriter threads;
+  };
+
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<std::unique_ptr<Group>> groups_;
+
+  MinidumpContextArrayWriter* context_array_;  // weak
+  MinidumpThreadGroupList list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_THREAD_GROUP_WRITER_H_
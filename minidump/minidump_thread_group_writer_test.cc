@@ -0,0 +1,325 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_group_writer.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_byte_array_writer_test_util.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_string_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+struct DecodedThread {
+  uint64_t thread_id;
+  uint64_t suspend_count;
+  int64_t priority;
+  uint64_t teb;
+  uint64_t stack_address;
+  uint64_t context_index;
+};
+
+uint64_t ReadLEB128(const std::vector<uint8_t>& data, size_t* offset) {
+  uint64_t value = 0;
+  for (int shift = 0; *offset < data.size(); shift += 7) {
+    const uint8_t byte = data[(*offset)++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  return value;
+}
+
+int64_t ReadSigned(const std::vector<uint8_t>& data, size_t* offset) {
+  const uint64_t value = ReadLEB128(data, offset);
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Decodes the threads of group from the minidump file file_contents.
+std::vector<DecodedThread> DecodeThreads(const std::string& file_contents,
+                                         const MinidumpThreadGroup& group) {
+  const std::vector<uint8_t> data =
+      MinidumpByteArrayAtRVA(file_contents, group.threads);
+
+  std::vector<DecodedThread> threads;
+  DecodedThread previous = {};
+  size_t offset = 0;
+  for (uint32_t index = 0; index < group.thread_count; ++index) {
+    DecodedThread thread;
+    thread.thread_id = previous.thread_id + ReadSigned(data, &offset);
+    thread.suspend_count = ReadLEB128(data, &offset);
+    thread.priority = ReadSigned(data, &offset);
+    thread.teb = previous.teb + ReadSigned(data, &offset);
+    thread.stack_address = previous.stack_address + ReadSigned(data, &offset);
+    thread.context_index = previous.context_index + ReadSigned(data, &offset);
+    threads.push_back(thread);
+    previous = thread;
+  }
+  EXPECT_EQ(offset, data.size());
+  return threads;
+}
+
+const MINIDUMP_DIRECTORY* FindStream(const std::string& file_contents,
+                                     MinidumpStreamType stream_type) {
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  if (!header || !directory) {
+    return nullptr;
+  }
+  for (uint32_t index = 0; index < header->NumberOfStreams; ++index) {
+    if (directory[index].StreamType == stream_type) {
+      return &directory[index];
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<TestThreadSnapshot> MakeThread(uint64_t thread_id,
+                                               const std::string& name,
+                                               uint64_t stack_address,
+                                               size_t stack_size) {
+  auto thread = std::make_unique<TestThreadSnapshot>();
+  thread->SetThreadID(thread_id);
+  thread->SetThreadName(name);
+  thread->SetThreadSpecificDataAddress(stack_address + stack_size);
+  thread->SetPriority(-static_cast<int>(thread_id % 3));
+  thread->SetSuspendCount(static_cast<int>(thread_id % 2));
+  InitializeCPUContextX86_64(thread->MutableContext(),
+                             static_cast<uint32_t>(thread_id));
+  if (stack_size) {
+    auto stack = std::make_unique<TestMemorySnapshot>();
+    stack->SetAddress(stack_address);
+    stack->SetSize(stack_size);
+    thread->SetStack(std::move(stack));
+  }
+  return thread;
+}
+
+TEST(MinidumpThreadGroupListWriter, Empty) {
+  auto thread_groups = std::make_unique<MinidumpThreadGroupListWriter>();
+  MinidumpThreadIDMap thread_id_map;
+  thread_groups->InitializeFromSnapshot({}, thread_id_map);
+  EXPECT_FALSE(thread_groups->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(thread_groups)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory = FindStream(
+      string_file.string(), kMinidumpStreamTypeCrashpadThreadGroups);
+  ASSERT_TRUE(directory);
+  const MinidumpThreadGroupList* list =
+      MinidumpWritableAtLocationDescriptor<MinidumpThreadGroupList>(
+          string_file.string(), directory->Location);
+  ASSERT_TRUE(list);
+  EXPECT_EQ(list->version, MinidumpThreadGroupList::kVersion);
+  EXPECT_EQ(list->count, 0u);
+  EXPECT_EQ(list->context_size, 0u);
+  EXPECT_EQ(list->contexts.Rva, 0u);
+}
+
+TEST(MinidumpThreadGroupListWriter, Groups) {
+  std::vector<std::unique_ptr<TestThreadSnapshot>> threads;
+  threads.push_back(MakeThread(10, "worker", 0x70000000, 0x8000));
+  threads.push_back(MakeThread(12, "main", 0x10000000, 0x8000));
+  threads.push_back(MakeThread(11, "worker", 0x70010000, 0x8000));
+  threads.push_back(MakeThread(13, "worker", 0x70008000, 0x4000));
+  threads.push_back(MakeThread(14, std::string(), 0, 0));
+  threads.push_back(MakeThread(15, "worker", 0x70020000, 0x8000));
+
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  for (const auto& thread : threads) {
+    thread_snapshots.push_back(thread.get());
+  }
+  MinidumpThreadIDMap thread_id_map;
+  BuildMinidumpThreadIDMap(thread_snapshots, &thread_id_map);
+
+  auto thread_groups = std::make_unique<MinidumpThreadGroupListWriter>();
+  thread_groups->InitializeFromSnapshot(thread_snapshots, thread_id_map);
+  EXPECT_TRUE(thread_groups->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(thread_groups)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory = FindStream(
+      string_file.string(), kMinidumpStreamTypeCrashpadThreadGroups);
+  ASSERT_TRUE(directory);
+  const MinidumpThreadGroupList* list =
+      MinidumpWritableAtLocationDescriptor<MinidumpThreadGroupList>(
+          string_file.string(), directory->Location);
+  ASSERT_TRUE(list);
+  ASSERT_EQ(list->count, 4u);
+  EXPECT_EQ(directory->Location.DataSize,
+            sizeof(MinidumpThreadGroupList) + 4 * sizeof(MinidumpThreadGroup));
+
+  // Groups appear in the order of their first thread.
+  const MinidumpThreadGroup& workers = list->groups[0];
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(string_file.string(), workers.name),
+            "worker");
+  EXPECT_EQ(workers.stack_size, 0x8000u);
+  ASSERT_EQ(workers.thread_count, 3u);
+  std::vector<DecodedThread> decoded =
+      DecodeThreads(string_file.string(), workers);
+  ASSERT_EQ(decoded.size(), 3u);
+  constexpr size_t kWorkerIndices[] = {0, 2, 5};
+  for (size_t index = 0; index < decoded.size(); ++index) {
+    SCOPED_TRACE(index);
+    const ThreadSnapshot* thread = thread_snapshots[kWorkerIndices[index]];
+    EXPECT_EQ(decoded[index].thread_id, thread->ThreadID());
+    EXPECT_EQ(decoded[index].suspend_count,
+              static_cast<uint64_t>(thread->SuspendCount()));
+    EXPECT_EQ(decoded[index].priority, thread->Priority());
+    EXPECT_EQ(decoded[index].teb, thread->ThreadSpecificDataAddress());
+    EXPECT_EQ(decoded[index].stack_address, thread->Stack()->Address());
+    EXPECT_EQ(decoded[index].context_index, kWorkerIndices[index]);
+  }
+
+  const MinidumpThreadGroup& main = list->groups[1];
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(string_file.string(), main.name),
+            "main");
+  ASSERT_EQ(main.thread_count, 1u);
+  decoded = DecodeThreads(string_file.string(), main);
+  ASSERT_EQ(decoded.size(), 1u);
+  EXPECT_EQ(decoded[0].thread_id, 12u);
+  EXPECT_EQ(decoded[0].stack_address, 0x10000000u);
+  EXPECT_EQ(decoded[0].context_index, 1u);
+
+  // A worker with a different stack size is in a group of its own.
+  const MinidumpThreadGroup& small_worker = list->groups[2];
+  EXPECT_EQ(MinidumpUTF8StringAtRVAAsString(string_file.string(),
+                                            small_worker.name),
+            "worker");
+  EXPECT_EQ(small_worker.stack_size, 0x4000u);
+  EXPECT_EQ(small_worker.thread_count, 1u);
+
+  const MinidumpThreadGroup& unnamed = list->groups[3];
+  EXPECT_EQ(unnamed.name, 0u);
+  EXPECT_EQ(unnamed.stack_size, 0u);
+  ASSERT_EQ(unnamed.thread_count, 1u);
+  decoded = DecodeThreads(string_file.string(), unnamed);
+  ASSERT_EQ(decoded.size(), 1u);
+  EXPECT_EQ(decoded[0].thread_id, 14u);
+  EXPECT_EQ(decoded[0].stack_address, 0u);
+  EXPECT_EQ(decoded[0].context_index, 4u);
+}
+
+TEST(MinidumpThreadGroupListWriter, MaxListedThreads) {
+  TestProcessSnapshot process_snapshot;
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  constexpr size_t kThreadCount = 5;
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    process_snapshot.AddThread(
+        MakeThread(20 + index, "worker", 0x70000000 + index * 0x10000, 0x100));
+  }
+
+  auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+  exception_snapshot->SetThreadID(23);
+  InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 11);
+  process_snapshot.SetException(std::move(exception_snapshot));
+
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.SetMaxListedThreads(2);
+  minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+  const std::string& file_contents = string_file.string();
+
+  // The thread list carries the first thread and the exception thread.
+  const MINIDUMP_DIRECTORY* directory =
+      FindStream(file_contents, kMinidumpStreamTypeThreadList);
+  ASSERT_TRUE(directory);
+  const MINIDUMP_THREAD_LIST* thread_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_THREAD_LIST>(
+          file_contents, directory->Location);
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(thread_list->NumberOfThreads, 2u);
+  EXPECT_EQ(thread_list->Threads[0].ThreadId, 20u);
+  EXPECT_EQ(thread_list->Threads[1].ThreadId, 23u);
+
+  directory = FindStream(file_contents, kMinidumpStreamTypeThreadNameList);
+  ASSERT_TRUE(directory);
+  const MINIDUMP_THREAD_NAME_LIST* thread_name_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_THREAD_NAME_LIST>(
+          file_contents, directory->Location);
+  ASSERT_TRUE(thread_name_list);
+  EXPECT_EQ(thread_name_list->NumberOfThreadNames, 2u);
+
+  directory =
+      FindStream(file_contents, kMinidumpStreamTypeCrashpadThreadGroups);
+  ASSERT_TRUE(directory);
+  const MinidumpThreadGroupList* list =
+      MinidumpWritableAtLocationDescriptor<MinidumpThreadGroupList>(
+          file_contents, directory->Location);
+  ASSERT_TRUE(list);
+  ASSERT_EQ(list->count, 1u);
+  ASSERT_EQ(list->groups[0].thread_count, kThreadCount);
+
+  // The contexts of listed threads are found in the same place through either
+  // stream.
+  EXPECT_EQ(list->context_size, thread_list->Threads[0].ThreadContext.DataSize);
+  EXPECT_EQ(list->contexts.DataSize, kThreadCount * list->context_size);
+  const std::vector<DecodedThread> decoded =
+      DecodeThreads(file_contents, list->groups[0]);
+  ASSERT_EQ(decoded.size(), kThreadCount);
+  EXPECT_EQ(decoded[3].thread_id, 23u);
+  EXPECT_EQ(list->contexts.Rva + decoded[0].context_index * list->context_size,
+            thread_list->Threads[0].ThreadContext.Rva);
+  EXPECT_EQ(list->contexts.Rva + decoded[3].context_index * list->context_size,
+            thread_list->Threads[1].ThreadContext.Rva);
+
+  // Every thread’s stack is still in the memory list.
+  directory = FindStream(file_contents, kMinidumpStreamTypeMemoryList);
+  ASSERT_TRUE(directory);
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          file_contents, directory->Location);
+  ASSERT_TRUE(memory_list);
+  EXPECT_EQ(memory_list->NumberOfMemoryRanges, kThreadCount);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
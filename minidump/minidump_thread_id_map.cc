@@ -14,9 +14,8 @@
 
 #include "minidump/minidump_thread_id_map.h"
 
+#include <algorithm>
 #include <limits>
-#include <set>
-#include <utility>
 
 #include "base/check_op.h"
 #include "base/numerics/safe_conversions.h"
@@ -24,43 +23,108 @@
 
 namespace crashpad {
 
+namespace {
+
+bool EntryLess(const MinidumpThreadIDMap::value_type& entry,
+               uint64_t thread_id_64) {
+  return entry.first < thread_id_64;
+}
+
+}  // namespace
+
+MinidumpThreadIDMap::MinidumpThreadIDMap() : entries_() {}
+
+MinidumpThreadIDMap::~MinidumpThreadIDMap() {}
+
+MinidumpThreadIDMap::const_iterator MinidumpThreadIDMap::find(
+    uint64_t thread_id_64) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), thread_id_64, EntryLess);
+  if (it == entries_.end() || it->first != thread_id_64) {
+    return entries_.end();
+  }
+  return it;
+}
+
+uint32_t& MinidumpThreadIDMap::operator[](uint64_t thread_id_64) {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), thread_id_64, EntryLess);
+  if (it == entries_.end() || it->first != thread_id_64) {
+    it = entries_.insert(it, value_type(thread_id_64, 0));
+  }
+  return it->second;
+}
+
 void BuildMinidumpThreadIDMap(
     const std::vector<const ThreadSnapshot*>& thread_snapshots,
     MinidumpThreadIDMap* thread_id_map) {
   DCHECK(thread_id_map->empty());
 
+  // Collect each unique 64-bit thread ID along with the index of the thread
+  // where it first appears. A stable sort keeps the first appearance ahead of
+  // any duplicates, which std::unique() then discards.
+  struct ThreadID {
+    uint64_t id_64;
+    size_t first_index;
+  };
+  std::vector<ThreadID> thread_ids;
+  thread_ids.reserve(thread_snapshots.size());
+  for (size_t index = 0; index < thread_snapshots.size(); ++index) {
+    thread_ids.push_back({thread_snapshots[index]->ThreadID(), index});
+  }
+  std::stable_sort(thread_ids.begin(),
+                   thread_ids.end(),
+                   [](const ThreadID& lhs, const ThreadID& rhs) {
+                     return lhs.id_64 < rhs.id_64;
+                   });
+  thread_ids.erase(std::unique(thread_ids.begin(),
+                               thread_ids.end(),
+                               [](const ThreadID& lhs, const ThreadID& rhs) {
+                                 return lhs.id_64 == rhs.id_64;
+                               }),
+                   thread_ids.end());
+
   // First, try truncating each 64-bit thread ID to 32 bits. If that’s possible
   // for each unique 64-bit thread ID, then this will be used as the mapping.
   // This preserves as much of the original thread ID as possible when feasible.
-  bool collision = false;
-  std::set<uint32_t> thread_ids_32;
-  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-    uint64_t thread_id_64 = thread_snapshot->ThreadID();
-    if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-      uint32_t thread_id_32 = static_cast<uint32_t>(thread_id_64);
-      if (!thread_ids_32.insert(thread_id_32).second) {
-        collision = true;
-        break;
-      }
-      thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
-    }
+  std::vector<uint32_t> thread_ids_32;
+  thread_ids_32.reserve(thread_ids.size());
+  for (const ThreadID& thread_id : thread_ids) {
+    thread_ids_32.push_back(static_cast<uint32_t>(thread_id.id_64));
   }
+  std::sort(thread_ids_32.begin(), thread_ids_32.end());
+  const bool collision =
+      std::adjacent_find(thread_ids_32.begin(), thread_ids_32.end()) !=
+      thread_ids_32.end();
 
-  if (collision) {
-    // Since there was a collision, go back and assign each unique 64-bit thread
-    // ID its own sequential 32-bit equivalent. The 32-bit thread IDs will not
-    // bear any resemblance to the original 64-bit thread IDs.
-    thread_id_map->clear();
-    for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-      uint64_t thread_id_64 = thread_snapshot->ThreadID();
-      if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-        uint32_t thread_id_32 =
-            base::checked_cast<uint32_t>(thread_id_map->size());
-        thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
-      }
+  std::vector<MinidumpThreadIDMap::value_type>& entries =
+      thread_id_map->entries_;
+  entries.reserve(thread_ids.size());
+  if (!collision) {
+    for (const ThreadID& thread_id : thread_ids) {
+      entries.emplace_back(thread_id.id_64,
+                           static_cast<uint32_t>(thread_id.id_64));
     }
+    return;
+  }
 
-    DCHECK_LE(thread_id_map->size(), std::numeric_limits<uint32_t>::max());
+  // Since there was a collision, go back and assign each unique 64-bit thread
+  // ID its own sequential 32-bit equivalent, in the order that the threads
+  // first appear. The 32-bit thread IDs will not bear any resemblance to the
+  // original 64-bit thread IDs.
+  DCHECK_LE(thread_ids.size(), std::numeric_limits<uint32_t>::max());
+  std::vector<size_t> order(thread_ids.size());
+  for (size_t index = 0; index < order.size(); ++index) {
+    order[index] = index;
+  }
+  std::sort(order.begin(), order.end(), [&thread_ids](size_t lhs, size_t rhs) {
+    return thread_ids[lhs].first_index < thread_ids[rhs].first_index;
+  });
+  entries.resize(thread_ids.size());
+  for (size_t sequence = 0; sequence < order.size(); ++sequence) {
+    const size_t index = order[sequence];
+    entries[index] = MinidumpThreadIDMap::value_type(
+        thread_ids[index].id_64, base::checked_cast<uint32_t>(sequence));
   }
 }
 
@@ -17,7 +17,7 @@
 
 #include <stdint.h>
 
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace crashpad {
@@ -32,7 +32,45 @@ class ThreadSnapshot;
 //!
 //! A ThreadIDMap ensures that there are no collisions among the set of 32-bit
 //! minidump thread IDs.
-using MinidumpThreadIDMap = std::map<uint64_t, uint32_t>;
+//!
+//! The map is consulted once per thread by several writers, so it’s stored as
+//! a vector sorted by 64-bit thread ID rather than as a node-based tree. This
+//! keeps lookups to a binary search over contiguous memory. The interface is
+//! the subset of `std::map<uint64_t, uint32_t>` that its users need.
+class MinidumpThreadIDMap {
+ public:
+  using value_type = std::pair<uint64_t, uint32_t>;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  MinidumpThreadIDMap();
+
+  MinidumpThreadIDMap(const MinidumpThreadIDMap&) = delete;
+  MinidumpThreadIDMap& operator=(const MinidumpThreadIDMap&) = delete;
+
+  ~MinidumpThreadIDMap();
+
+  //! \brief Returns an iterator to the entry for \a thread_id_64, or end() if
+  //!     there is none.
+  const_iterator find(uint64_t thread_id_64) const;
+
+  //! \brief Returns a reference to the 32-bit thread ID mapped to \a
+  //!     thread_id_64, inserting an entry mapped to `0` if there is none.
+  uint32_t& operator[](uint64_t thread_id_64);
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear() { entries_.clear(); }
+
+ private:
+  friend void BuildMinidumpThreadIDMap(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      MinidumpThreadIDMap* thread_id_map);
+
+  // Sorted by the 64-bit thread ID, with no duplicate keys.
+  std::vector<value_type> entries_;
+};
 
 //! \brief Builds a MinidumpThreadIDMap for a group of ThreadSnapshot objects.
 //!
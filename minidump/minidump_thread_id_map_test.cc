@@ -16,6 +16,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <iterator>
 #include <vector>
 
@@ -188,6 +189,32 @@ TEST_F(MinidumpThreadIDMapTest, AllDuplicates) {
   EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 6, 6);
 }
 
+TEST(MinidumpThreadIDMap, ManyThreads) {
+  // Enough threads, in an order unrelated to their IDs, that the map must sort
+  // them. Every ID collides in its low 32 bits, so they’re renumbered in the
+  // order that they first appear.
+  constexpr size_t kThreadCount = 1000;
+  std::vector<TestThreadSnapshot> test_thread_snapshots(kThreadCount);
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    const uint64_t high = (index * 7919) % kThreadCount + 1;
+    test_thread_snapshots[index].SetThreadID((high << 32) | 0x1234);
+    thread_snapshots.push_back(&test_thread_snapshots[index]);
+  }
+
+  MinidumpThreadIDMap thread_id_map;
+  BuildMinidumpThreadIDMap(thread_snapshots, &thread_id_map);
+
+  ASSERT_EQ(thread_id_map.size(), kThreadCount);
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    auto it = thread_id_map.find(test_thread_snapshots[index].ThreadID());
+    ASSERT_NE(it, thread_id_map.end());
+    EXPECT_EQ(it->second, index);
+  }
+  EXPECT_EQ(thread_id_map.find(0x1234), thread_id_map.end());
+  EXPECT_TRUE(std::is_sorted(thread_id_map.begin(), thread_id_map.end()));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
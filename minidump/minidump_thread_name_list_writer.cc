@@ -53,6 +53,15 @@ uint32_t MinidumpThreadNameWriter::ThreadId() const {
   return thread_id_;
 }
 
+void MinidumpThreadNameWriter::AddStringsToTable(
+    internal::MinidumpUTF16StringTable* table) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (name_) {
+    table->Add(name_.get());
+  }
+}
+
 bool MinidumpThreadNameWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -127,6 +136,14 @@ void MinidumpThreadNameListWriter::AddThreadName(
 bool MinidumpThreadNameListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
+  // Threads in a pool often share a name. Store each distinct name once.
+  {
+    internal::MinidumpUTF16StringTable table;
+    for (const auto& thread_name : thread_names_) {
+      thread_name->AddStringsToTable(&table);
+    }
+  }
+
   if (!MinidumpStreamWriter::Freeze()) {
     return false;
   }
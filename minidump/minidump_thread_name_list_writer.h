@@ -76,6 +76,12 @@ class MinidumpThreadNameWriter final : public internal::MinidumpWritable {
   //! \note Valid in #kStateWritable.
   RVA64 RvaOfThreadName() const;
 
+  //! \brief Adds the thread’s name to \a table, so that a name shared by
+  //!     several threads is only written once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStringsToTable(internal::MinidumpUTF16StringTable* table);
+
  private:
   // MinidumpWritable:
   bool Freeze() override;
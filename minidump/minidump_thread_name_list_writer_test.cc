@@ -312,6 +312,17 @@ TEST(MinidumpThreadNameListWriter, TwoThreads_SameNames) {
                                            &thread_name_list->ThreadNames[1],
                                            string_file.string(),
                                            kThreadName));
+
+  // The name is only written once, and both threads refer to it.
+  RVA64 first_rva;
+  memcpy(&first_rva,
+         &thread_name_list->ThreadNames[0].RvaOfThreadName,
+         sizeof(first_rva));
+  RVA64 second_rva;
+  memcpy(&second_rva,
+         &thread_name_list->ThreadNames[1].RvaOfThreadName,
+         sizeof(second_rva));
+  EXPECT_EQ(second_rva, first_rva);
 }
 
 }  // namespace
@@ -14,12 +14,20 @@
 
 #include "minidump/minidump_thread_writer.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "minidump/minidump_context_array_writer.h"
 #include "minidump/minidump_context_writer.h"
 #include "minidump/minidump_memory_writer.h"
+#include "snapshot/cpu_context.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/thread_snapshot.h"
 #include "util/file/file_writer.h"
@@ -28,8 +36,12 @@
 namespace crashpad {
 
 MinidumpThreadWriter::MinidumpThreadWriter()
-    : MinidumpWritable(), thread_(), stack_(nullptr), context_(nullptr) {
-}
+    : MinidumpWritable(),
+      thread_(),
+      stack_(nullptr),
+      context_(nullptr),
+      context_array_(nullptr),
+      context_index_(0) {}
 
 MinidumpThreadWriter::~MinidumpThreadWriter() {
 }
@@ -37,9 +49,18 @@ MinidumpThreadWriter::~MinidumpThreadWriter() {
 void MinidumpThreadWriter::InitializeFromSnapshot(
     const ThreadSnapshot* thread_snapshot,
     const MinidumpThreadIDMap* thread_id_map) {
+  InitializeFromSnapshot(thread_snapshot, thread_id_map, nullptr, 0);
+}
+
+void MinidumpThreadWriter::InitializeFromSnapshot(
+    const ThreadSnapshot* thread_snapshot,
+    const MinidumpThreadIDMap* thread_id_map,
+    MinidumpContextArrayWriter* context_array,
+    size_t context_index) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK(!stack_);
   DCHECK(!context_);
+  DCHECK(!context_array_);
 
   auto thread_id_it = thread_id_map->find(thread_snapshot->ThreadID());
   DCHECK(thread_id_it != thread_id_map->end());
@@ -56,6 +77,11 @@ void MinidumpThreadWriter::InitializeFromSnapshot(
     SetStack(std::move(stack));
   }
 
+  if (context_array) {
+    SetContextInArray(context_array, context_index);
+    return;
+  }
+
   std::unique_ptr<MinidumpContextWriter> context =
       MinidumpContextWriter::CreateFromSnapshot(thread_snapshot->Context());
   SetContext(std::move(context));
@@ -81,9 +107,19 @@ void MinidumpThreadWriter::SetContext(
   context_ = std::move(context);
 }
 
+void MinidumpThreadWriter::SetContextInArray(
+    MinidumpContextArrayWriter* context_array,
+    size_t context_index) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_LT(context_index, context_array->ContextCount());
+
+  context_array_ = context_array;
+  context_index_ = context_index;
+}
+
 bool MinidumpThreadWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
-  CHECK(context_);
+  CHECK(context_ || context_array_);
 
   if (!MinidumpWritable::Freeze()) {
     return false;
@@ -93,7 +129,12 @@ bool MinidumpThreadWriter::Freeze() {
     stack_->RegisterMemoryDescriptor(&thread_.Stack);
   }
 
-  context_->RegisterLocationDescriptor(&thread_.ThreadContext);
+  if (context_) {
+    context_->RegisterLocationDescriptor(&thread_.ThreadContext);
+  } else {
+    context_array_->RegisterContextLocationDescriptor(context_index_,
+                                                      &thread_.ThreadContext);
+  }
 
   return true;
 }
@@ -109,13 +150,15 @@ size_t MinidumpThreadWriter::SizeOfObject() {
 
 std::vector<internal::MinidumpWritable*> MinidumpThreadWriter::Children() {
   DCHECK_GE(state(), kStateFrozen);
-  DCHECK(context_);
+  DCHECK(context_ || context_array_);
 
   std::vector<MinidumpWritable*> children;
   if (stack_) {
     children.push_back(stack_.get());
   }
-  children.push_back(context_.get());
+  if (context_) {
+    children.push_back(context_.get());
+  }
 
   return children;
 }
@@ -132,8 +175,12 @@ bool MinidumpThreadWriter::WriteObject(FileWriterInterface* file_writer) {
 MinidumpThreadListWriter::MinidumpThreadListWriter()
     : MinidumpStreamWriter(),
       threads_(),
+      context_array_(),
+      listed_threads_(),
+      listed_thread_indices_(),
       memory_list_writer_(nullptr),
-      thread_list_base_() {
+      thread_list_base_(),
+      deduplicate_stacks_(false) {
 }
 
 MinidumpThreadListWriter::~MinidumpThreadListWriter() {
@@ -141,22 +188,36 @@ MinidumpThreadListWriter::~MinidumpThreadListWriter() {
 
 void MinidumpThreadListWriter::InitializeFromSnapshot(
     const std::vector<const ThreadSnapshot*>& thread_snapshots,
-    MinidumpThreadIDMap* thread_id_map) {
+    MinidumpThreadIDMap* thread_id_map,
+    bool include_extra_memory) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK(threads_.empty());
 
   BuildMinidumpThreadIDMap(thread_snapshots, thread_id_map);
 
+  // Converting every context into a single array avoids an allocation and a
+  // write per thread.
+  std::vector<const CPUContext*> context_snapshots;
+  context_snapshots.reserve(thread_snapshots.size());
   for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    context_snapshots.push_back(thread_snapshot->Context());
+  }
+  context_array_ =
+      MinidumpContextArrayWriter::CreateFromSnapshots(context_snapshots);
+
+  for (size_t index = 0; index < thread_snapshots.size(); ++index) {
     auto thread = std::make_unique<MinidumpThreadWriter>();
-    thread->InitializeFromSnapshot(thread_snapshot, thread_id_map);
+    thread->InitializeFromSnapshot(
+        thread_snapshots[index], thread_id_map, context_array_.get(), index);
     AddThread(std::move(thread));
   }
 
   // Do this in a separate loop to keep the thread stacks earlier in the dump,
   // and together.
-  for (const ThreadSnapshot* thread_snapshot : thread_snapshots)
-    memory_list_writer_->AddFromSnapshot(thread_snapshot->ExtraMemory());
+  if (include_extra_memory) {
+    for (const ThreadSnapshot* thread_snapshot : thread_snapshots)
+      memory_list_writer_->AddFromSnapshot(thread_snapshot->ExtraMemory());
+  }
 }
 
 void MinidumpThreadListWriter::SetMemoryListWriter(
@@ -181,14 +242,46 @@ void MinidumpThreadListWriter::AddThread(
   threads_.push_back(std::move(thread));
 }
 
+void MinidumpThreadListWriter::SetListedThreads(
+    const std::vector<size_t>& indices) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(!indices.empty());
+  DCHECK(std::is_sorted(indices.begin(), indices.end()));
+
+  listed_thread_indices_ = indices;
+}
+
 bool MinidumpThreadListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
+  // This must happen before the stacks are frozen, which is when the memory
+  // descriptors pointing to them are registered.
+  if (deduplicate_stacks_) {
+    DeduplicateStacks();
+  }
+
   if (!MinidumpStreamWriter::Freeze()) {
     return false;
   }
 
-  size_t thread_count = threads_.size();
+  listed_threads_.clear();
+  if (listed_thread_indices_.empty()) {
+    listed_threads_.reserve(threads_.size());
+    for (const auto& thread : threads_) {
+      listed_threads_.push_back(thread.get());
+    }
+  } else {
+    listed_threads_.reserve(listed_thread_indices_.size());
+    for (size_t index : listed_thread_indices_) {
+      if (index >= threads_.size()) {
+        LOG(ERROR) << "listed thread " << index << " out of range";
+        return false;
+      }
+      listed_threads_.push_back(threads_[index].get());
+    }
+  }
+
+  size_t thread_count = listed_threads_.size();
   if (!AssignIfInRange(&thread_list_base_.NumberOfThreads, thread_count)) {
     LOG(ERROR) << "thread_count " << thread_count << " out of range";
     return false;
@@ -200,7 +293,8 @@ bool MinidumpThreadListWriter::Freeze() {
 size_t MinidumpThreadListWriter::SizeOfObject() {
   DCHECK_GE(state(), kStateFrozen);
 
-  return sizeof(thread_list_base_) + threads_.size() * sizeof(MINIDUMP_THREAD);
+  return sizeof(thread_list_base_) +
+         listed_threads_.size() * sizeof(MINIDUMP_THREAD);
 }
 
 std::vector<internal::MinidumpWritable*> MinidumpThreadListWriter::Children() {
@@ -210,6 +304,9 @@ std::vector<internal::MinidumpWritable*> MinidumpThreadListWriter::Children() {
   for (const auto& thread : threads_) {
     children.push_back(thread.get());
   }
+  if (context_array_) {
+    children.push_back(context_array_.get());
+  }
 
   return children;
 }
@@ -222,7 +319,7 @@ bool MinidumpThreadListWriter::WriteObject(FileWriterInterface* file_writer) {
   iov.iov_len = sizeof(thread_list_base_);
   std::vector<WritableIoVec> iovecs(1, iov);
 
-  for (const auto& thread : threads_) {
+  for (const MinidumpThreadWriter* thread : listed_threads_) {
     iov.iov_base = thread->MinidumpThread();
     iov.iov_len = sizeof(MINIDUMP_THREAD);
     iovecs.push_back(iov);
@@ -235,4 +332,52 @@ MinidumpStreamType MinidumpThreadListWriter::StreamType() const {
   return kMinidumpStreamTypeThreadList;
 }
 
+void MinidumpThreadListWriter::DeduplicateStacks() {
+  // Only stacks of the same size can be identical, so group them by size to
+  // avoid reading stacks that can’t have duplicates.
+  std::map<size_t, std::vector<SnapshotMinidumpMemoryWriter*>> stacks_by_size;
+  for (const auto& thread : threads_) {
+    SnapshotMinidumpMemoryWriter* stack = thread->Stack();
+    if (stack && !stack->SharedDataSource()) {
+      stacks_by_size[stack->UnderlyingSnapshot()->Size()].push_back(stack);
+    }
+  }
+
+  for (const auto& [size, stacks] : stacks_by_size) {
+    if (stacks.size() < 2) {
+      continue;
+    }
+
+    // Stacks whose data will be stored, keyed by a hash of their contents.
+    // Matching hashes are confirmed by comparing the contents, so only two
+    // stacks need to be held in memory at a time.
+    std::unordered_map<size_t, std::vector<SnapshotMinidumpMemoryWriter*>>
+        originals_by_hash;
+    std::vector<char> contents(size);
+    std::vector<char> original_contents(size);
+    for (SnapshotMinidumpMemoryWriter* stack : stacks) {
+      if (!stack->UnderlyingSnapshot()->ReadInto(contents.data())) {
+        continue;
+      }
+
+      std::vector<SnapshotMinidumpMemoryWriter*>& originals =
+          originals_by_hash[std::hash<std::string_view>()(
+              std::string_view(contents.data(), size))];
+      bool shared = false;
+      for (SnapshotMinidumpMemoryWriter* original : originals) {
+        if (original->UnderlyingSnapshot()->ReadInto(
+                original_contents.data()) &&
+            memcmp(original_contents.data(), contents.data(), size) == 0) {
+          stack->ShareDataWith(original);
+          shared = true;
+          break;
+        }
+      }
+      if (!shared) {
+        originals.push_back(stack);
+      }
+    }
+  }
+}
+
 }  // namespace crashpad
@@ -29,6 +29,7 @@
 
 namespace crashpad {
 
+class MinidumpContextArrayWriter;
 class MinidumpContextWriter;
 class MinidumpMemoryListWriter;
 class SnapshotMinidumpMemoryWriter;
@@ -61,6 +62,19 @@ class MinidumpThreadWriter final : public internal::MinidumpWritable {
   void InitializeFromSnapshot(const ThreadSnapshot* thread_snapshot,
                               const MinidumpThreadIDMap* thread_id_map);
 
+  //! \brief Initializes the MINIDUMP_THREAD based on \a thread_snapshot, with
+  //!     its context stored in \a context_array.
+  //!
+  //! This behaves like the two-argument form, except that the thread’s context
+  //! is taken from \a context_array, as if by SetContextInArray(), instead of
+  //! being converted from \a thread_snapshot.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(const ThreadSnapshot* thread_snapshot,
+                              const MinidumpThreadIDMap* thread_id_map,
+                              MinidumpContextArrayWriter* context_array,
+                              size_t context_index);
+
   //! \brief Returns a MINIDUMP_THREAD referencing this object’s data.
   //!
   //! This method is expected to be called by a MinidumpThreadListWriter in
@@ -104,6 +118,18 @@ class MinidumpThreadWriter final : public internal::MinidumpWritable {
   //! \note Valid in #kStateMutable.
   void SetContext(std::unique_ptr<MinidumpContextWriter> context);
 
+  //! \brief Arranges for MINIDUMP_THREAD::ThreadContext to point to the CPU
+  //!     context at \a context_index in \a context_array.
+  //!
+  //! This is an alternative to SetContext(). This object does not take
+  //! ownership of \a context_array, which must be written as part of the same
+  //! minidump file, normally by the MinidumpThreadListWriter that is this
+  //! object’s parent.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetContextInArray(MinidumpContextArrayWriter* context_array,
+                         size_t context_index);
+
   //! \brief Sets MINIDUMP_THREAD::ThreadId.
   void SetThreadID(uint32_t thread_id) { thread_.ThreadId = thread_id; }
 
@@ -134,6 +160,8 @@ class MinidumpThreadWriter final : public internal::MinidumpWritable {
   MINIDUMP_THREAD thread_;
   std::unique_ptr<SnapshotMinidumpMemoryWriter> stack_;
   std::unique_ptr<MinidumpContextWriter> context_;
+  MinidumpContextArrayWriter* context_array_;  // weak
+  size_t context_index_;
 };
 
 //! \brief The writer for a MINIDUMP_THREAD_LIST stream in a minidump file,
@@ -153,13 +181,17 @@ class MinidumpThreadListWriter final : public internal::MinidumpStreamWriter {
   //! \param[in] thread_snapshots The thread snapshots to use as source data.
   //! \param[out] thread_id_map A MinidumpThreadIDMap to be built by this
   //!     method. This map must be empty when this method is called.
+  //! \param[in] include_extra_memory Whether each thread’s
+  //!     ThreadSnapshot::ExtraMemory() is added to the memory list set by
+  //!     SetMemoryListWriter(). Stacks are added regardless.
   //!
   //! \note Valid in #kStateMutable. AddThread() may not be called before this
   //!     method, and it is not normally necessary to call AddThread() after
   //!     this method.
   void InitializeFromSnapshot(
       const std::vector<const ThreadSnapshot*>& thread_snapshots,
-      MinidumpThreadIDMap* thread_id_map);
+      MinidumpThreadIDMap* thread_id_map,
+      bool include_extra_memory = true);
 
   //! \brief Sets the MinidumpMemoryListWriter that each thread’s stack memory
   //!     region should be added to as extra memory.
@@ -196,6 +228,46 @@ class MinidumpThreadListWriter final : public internal::MinidumpStreamWriter {
   //! \note Valid in #kStateMutable.
   void AddThread(std::unique_ptr<MinidumpThreadWriter> thread);
 
+  //! \brief Sets whether thread stacks with identical contents are stored once.
+  //!
+  //! Thread pools of identical workers often have stacks that are
+  //! byte-for-byte the same. When enabled, the contents of each thread’s stack
+  //! are compared with those of the other threads’ stacks when this object is
+  //! frozen, and each duplicate stack’s MINIDUMP_MEMORY_DESCRIPTOR, in both its
+  //! MINIDUMP_THREAD and the MINIDUMP_MEMORY_LIST, points to the data of the
+  //! first stack found with the same contents. See
+  //! SnapshotMinidumpMemoryWriter::ShareDataWith(). Each descriptor retains its
+  //! own StartOfMemoryRange, so the minidump remains readable by any consumer.
+  //!
+  //! This requires reading each stack that is of the same size as another
+  //! stack an additional time. The default is not to deduplicate stacks.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetDeduplicateStacks(bool deduplicate_stacks) {
+    deduplicate_stacks_ = deduplicate_stacks;
+  }
+
+  //! \brief Limits the MINIDUMP_THREAD_LIST to the threads at \a indices.
+  //!
+  //! \a indices are positions in the order that threads were added, and must
+  //! be in increasing order. Threads that are not listed are still written as
+  //! children of this object, so their stacks remain in the
+  //! MINIDUMP_MEMORY_LIST and their contexts remain in the array returned by
+  //! ContextArray(). This is meant to be used along with a
+  //! MinidumpThreadGroupListWriter, which describes every thread. The default
+  //! is to list every thread.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetListedThreads(const std::vector<size_t>& indices);
+
+  //! \brief Returns the array holding every thread’s context, or `nullptr` if
+  //!     InitializeFromSnapshot() could not store the contexts in an array.
+  //!
+  //! \note Valid in any state.
+  MinidumpContextArrayWriter* ContextArray() const {
+    return context_array_.get();
+  }
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -207,9 +279,25 @@ class MinidumpThreadListWriter final : public internal::MinidumpStreamWriter {
   MinidumpStreamType StreamType() const override;
 
  private:
+  //! \brief Arranges for stacks whose contents duplicate those of an earlier
+  //!     thread’s stack to share that stack’s data.
+  void DeduplicateStacks();
+
   std::vector<std::unique_ptr<MinidumpThreadWriter>> threads_;
+
+  // Set by InitializeFromSnapshot() when all threads’ contexts can be written
+  // together.
+  std::unique_ptr<MinidumpContextArrayWriter> context_array_;
+
+  // The threads written in the MINIDUMP_THREAD_LIST, set in Freeze().
+  std::vector<MinidumpThreadWriter*> listed_threads_;  // weak
+
+  // Set by SetListedThreads(). Empty if every thread is listed.
+  std::vector<size_t> listed_thread_indices_;
+
   MinidumpMemoryListWriter* memory_list_writer_;  // weak
   MINIDUMP_THREAD_LIST thread_list_base_;
+  bool deduplicate_stacks_;
 };
 
 }  // namespace crashpad
@@ -527,6 +527,89 @@ struct InitializeFromSnapshotNoContextTraits {
   }
 };
 
+// Writes a minidump with three threads, the first and last of which have stacks
+// with identical contents at different addresses.
+void WriteThreadsWithIdenticalStacks(bool deduplicate_stacks,
+                                     StringFile* string_file) {
+  MinidumpFileWriter minidump_file_writer;
+  auto thread_list_writer = std::make_unique<MinidumpThreadListWriter>();
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  thread_list_writer->SetMemoryListWriter(memory_list_writer.get());
+  thread_list_writer->SetDeduplicateStacks(deduplicate_stacks);
+
+  constexpr struct {
+    uint64_t memory_base;
+    uint8_t memory_value;
+  } kThreads[] = {
+      {0x1110, 11},
+      {0x2220, 22},
+      {0x3330, 11},
+  };
+  for (size_t index = 0; index < std::size(kThreads); ++index) {
+    auto thread_writer = std::make_unique<MinidumpThreadWriter>();
+    thread_writer->SetThreadID(static_cast<uint32_t>(index));
+    thread_writer->SetStack(std::make_unique<TestMinidumpMemoryWriter>(
+        kThreads[index].memory_base, 32, kThreads[index].memory_value));
+    auto context_x86_writer = std::make_unique<MinidumpContextX86Writer>();
+    InitializeMinidumpContextX86(context_x86_writer->context(),
+                                 static_cast<uint32_t>(index));
+    thread_writer->SetContext(std::move(context_x86_writer));
+    thread_list_writer->AddThread(std::move(thread_writer));
+  }
+
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(thread_list_writer)));
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(string_file));
+}
+
+TEST(MinidumpThreadWriter, DeduplicateStacks) {
+  StringFile duplicated_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteThreadsWithIdenticalStacks(false, &duplicated_file));
+
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteThreadsWithIdenticalStacks(true, &string_file));
+
+  // The third thread’s stack isn’t stored.
+  EXPECT_EQ(string_file.string().size(), duplicated_file.string().size() - 32);
+
+  const MINIDUMP_THREAD_LIST* thread_list = nullptr;
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadListStream(string_file.string(), &thread_list, &memory_list));
+
+  ASSERT_EQ(thread_list->NumberOfThreads, 3u);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 3u);
+
+  const MINIDUMP_MEMORY_DESCRIPTOR* stacks[] = {
+      &thread_list->Threads[0].Stack,
+      &thread_list->Threads[1].Stack,
+      &thread_list->Threads[2].Stack,
+  };
+  EXPECT_EQ(stacks[0]->StartOfMemoryRange, 0x1110u);
+  EXPECT_EQ(stacks[1]->StartOfMemoryRange, 0x2220u);
+  EXPECT_EQ(stacks[2]->StartOfMemoryRange, 0x3330u);
+  EXPECT_EQ(stacks[2]->Memory.Rva, stacks[0]->Memory.Rva);
+  EXPECT_EQ(stacks[2]->Memory.DataSize, stacks[0]->Memory.DataSize);
+  EXPECT_NE(stacks[1]->Memory.Rva, stacks[0]->Memory.Rva);
+
+  for (size_t index = 0; index < std::size(stacks); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+
+    MINIDUMP_MEMORY_DESCRIPTOR expected = {};
+    expected.StartOfMemoryRange = stacks[index]->StartOfMemoryRange;
+    expected.Memory.DataSize = 32;
+    ASSERT_NO_FATAL_FAILURE(
+        ExpectMinidumpMemoryDescriptorAndContents(&expected,
+                                                  stacks[index],
+                                                  string_file.string(),
+                                                  index == 1 ? 22 : 11,
+                                                  index == 1));
+    ASSERT_NO_FATAL_FAILURE(ExpectMinidumpMemoryDescriptor(
+        stacks[index], &memory_list->MemoryRanges[index]));
+  }
+}
+
 template <typename Traits>
 void RunInitializeFromSnapshotTest(bool thread_id_collision) {
   using MinidumpContextType = typename Traits::MinidumpContextType;
@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_unwound_frames_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpUnwoundFramesWriter::MinidumpUnwoundFramesWriter()
+    : MinidumpStreamWriter(), threads_(), frames_(), list_() {}
+
+MinidumpUnwoundFramesWriter::~MinidumpUnwoundFramesWriter() = default;
+
+void MinidumpUnwoundFramesWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(threads_.empty());
+
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const std::vector<UnwoundStackFrame> frames =
+        thread_snapshot->UnwoundFrames();
+    if (frames.empty()) {
+      continue;
+    }
+    const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+    DCHECK(it != thread_id_map.end());
+    AddThreadFrames(it->second, frames);
+  }
+}
+
+void MinidumpUnwoundFramesWriter::AddThreadFrames(
+    uint32_t thread_id,
+    const std::vector<UnwoundStackFrame>& frames) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (frames.empty()) {
+    return;
+  }
+
+  MinidumpThreadUnwoundFrames& thread = threads_.emplace_back();
+  thread.thread_id = thread_id;
+  thread.first_frame = static_cast<uint32_t>(frames_.size());
+  thread.frame_count = static_cast<uint32_t>(frames.size());
+  thread.reserved = 0;
+  for (const UnwoundStackFrame& frame : frames) {
+    MinidumpUnwoundFrame& entry = frames_.emplace_back();
+    entry.instruction_pointer = frame.instruction_pointer;
+    entry.stack_pointer = frame.stack_pointer;
+  }
+}
+
+bool MinidumpUnwoundFramesWriter::IsUseful() const {
+  return !threads_.empty();
+}
+
+bool MinidumpUnwoundFramesWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&list_.thread_count, threads_.size()) ||
+      !AssignIfInRange(&list_.frame_count, frames_.size())) {
+    LOG(ERROR) << "unwound frame count " << frames_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpUnwoundFramesWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(list_) + threads_.size() * sizeof(threads_[0]) +
+         frames_.size() * sizeof(frames_[0]);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpUnwoundFramesWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return {};
+}
+
+bool MinidumpUnwoundFramesWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &list_;
+  iov.iov_len = sizeof(list_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!threads_.empty()) {
+    iov.iov_base = threads_.data();
+    iov.iov_len = threads_.size() * sizeof(threads_[0]);
+    iovecs.push_back(iov);
+
+    iov.iov_base = frames_.data();
+    iov.iov_len = frames_.size() * sizeof(frames_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpUnwoundFramesWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadUnwoundFrames;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,91 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_FRAMES_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_FRAMES_WRITER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+#include "snapshot/thread_snapshot.h"
+
+namespace crashpad {
+
+//! \brief The writer for a MinidumpUnwoundFramesList stream in a minidump
+//!     file.
+class MinidumpUnwoundFramesWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpUnwoundFramesWriter();
+
+  MinidumpUnwoundFramesWriter(const MinidumpUnwoundFramesWriter&) = delete;
+  MinidumpUnwoundFramesWriter& operator=(const MinidumpUnwoundFramesWriter&) =
+      delete;
+
+  ~MinidumpUnwoundFramesWriter() override;
+
+  //! \brief Adds the frames of each thread in \a thread_snapshots whose stack
+  //!     was unwound.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds a MinidumpThreadUnwoundFrames for a thread.
+  //!
+  //! \param[in] thread_id The thread’s minidump thread ID.
+  //! \param[in] frames The thread’s frames, innermost first. Threads without
+  //!     frames are ignored.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddThreadFrames(uint32_t thread_id,
+                       const std::vector<UnwoundStackFrame>& frames);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying entries would be
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ private:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<MinidumpThreadUnwoundFrames> threads_;
+  std::vector<MinidumpUnwoundFrame> frames_;
+  MinidumpUnwoundFramesList list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_FRAMES_WRITER_H_
@@ -0,0 +1,137 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_unwound_frames_writer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns the MinidumpUnwoundFramesList stream, which must be the only stream,
+// in file_contents.
+void GetUnwoundFramesStream(const std::string& file_contents,
+                            const MinidumpUnwoundFramesList** list) {
+  constexpr size_t kListOffset =
+      sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(),
+            kListOffset + sizeof(MinidumpUnwoundFramesList));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType, kMinidumpStreamTypeCrashpadUnwoundFrames);
+  EXPECT_EQ(directory[0].Location.Rva, kListOffset);
+
+  *list = reinterpret_cast<const MinidumpUnwoundFramesList*>(
+      &file_contents[kListOffset]);
+  ASSERT_EQ(directory[0].Location.DataSize,
+            sizeof(MinidumpUnwoundFramesList) +
+                (*list)->thread_count * sizeof(MinidumpThreadUnwoundFrames) +
+                (*list)->frame_count * sizeof(MinidumpUnwoundFrame));
+  ASSERT_EQ(file_contents.size(), kListOffset + directory[0].Location.DataSize);
+}
+
+const MinidumpUnwoundFrame* FramesInList(
+    const MinidumpUnwoundFramesList* list) {
+  return reinterpret_cast<const MinidumpUnwoundFrame*>(&list->threads[0] +
+                                                       list->thread_count);
+}
+
+TEST(MinidumpUnwoundFramesWriter, Empty) {
+  auto frames_writer = std::make_unique<MinidumpUnwoundFramesWriter>();
+  frames_writer->AddThreadFrames(1, {});
+  EXPECT_FALSE(frames_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(frames_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpUnwoundFramesList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetUnwoundFramesStream(string_file.string(), &list));
+  EXPECT_EQ(list->thread_count, 0u);
+  EXPECT_EQ(list->frame_count, 0u);
+}
+
+TEST(MinidumpUnwoundFramesWriter, FromSnapshot) {
+  TestThreadSnapshot thread_0;
+  thread_0.SetThreadID(100);
+  thread_0.SetUnwoundFrames({{0x1000, 0x7000}, {0x2000, 0x7040}});
+
+  TestThreadSnapshot thread_1;
+  thread_1.SetThreadID(101);
+
+  TestThreadSnapshot thread_2;
+  thread_2.SetThreadID(102);
+  thread_2.SetUnwoundFrames({{0x3000, 0x9000}});
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[100] = 0;
+  thread_id_map[101] = 1;
+  thread_id_map[102] = 2;
+
+  auto frames_writer = std::make_unique<MinidumpUnwoundFramesWriter>();
+  frames_writer->InitializeFromSnapshot({&thread_0, &thread_1, &thread_2},
+                                        thread_id_map);
+  EXPECT_TRUE(frames_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(frames_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpUnwoundFramesList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetUnwoundFramesStream(string_file.string(), &list));
+
+  // The thread without frames is left out.
+  ASSERT_EQ(list->thread_count, 2u);
+  ASSERT_EQ(list->frame_count, 3u);
+  EXPECT_EQ(list->threads[0].thread_id, 0u);
+  EXPECT_EQ(list->threads[0].first_frame, 0u);
+  EXPECT_EQ(list->threads[0].frame_count, 2u);
+  EXPECT_EQ(list->threads[1].thread_id, 2u);
+  EXPECT_EQ(list->threads[1].first_frame, 2u);
+  EXPECT_EQ(list->threads[1].frame_count, 1u);
+
+  const MinidumpUnwoundFrame* frames = FramesInList(list);
+  EXPECT_EQ(frames[0].instruction_pointer, 0x1000u);
+  EXPECT_EQ(frames[0].stack_pointer, 0x7000u);
+  EXPECT_EQ(frames[1].instruction_pointer, 0x2000u);
+  EXPECT_EQ(frames[1].stack_pointer, 0x7040u);
+  EXPECT_EQ(frames[2].instruction_pointer, 0x3000u);
+  EXPECT_EQ(frames[2].stack_pointer, 0x9000u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
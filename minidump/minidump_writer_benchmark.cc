@@ -0,0 +1,429 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "build/build_config.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/test/synthetic_process_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "test/benchmark_phase.h"
+#include "tools/tool_support.h"
+#include "util/file/file_writer.h"
+#include "util/misc/clock.h"
+#include "util/stdlib/string_number_conversion.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+
+#include <psapi.h>
+#elif BUILDFLAG(IS_POSIX)
+#include <sys/resource.h>
+#endif
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of writing a minidump from a synthetic process snapshot.\n"
+"\n"
+"      --threads=N                 include N threads\n"
+"      --stack-size=BYTES          capture BYTES of stack for each thread\n"
+"      --colliding-thread-ids      give threads 64-bit IDs whose low 32 bits\n"
+"                                  collide, so that they must be renumbered\n"
+"      --modules=N                 include N modules\n"
+"      --annotations=N             give each module N simple annotations\n"
+"      --extra-memory=N            include N extra memory regions\n"
+"      --extra-memory-size=BYTES   make each extra memory region BYTES long\n"
+"      --iterations=N              write the minidump N times\n"
+"      --output=FILE               write to FILE instead of discarding output\n"
+"      --help                      display this help and exit\n"
+"      --version                   output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+struct Options {
+  SyntheticProcessSnapshotShape shape;
+  unsigned int iterations;
+  base::FilePath output;
+};
+
+// Passes writes through to another FileWriterInterface, or discards them if
+// there is none, recording when the first byte of the minidump is written.
+// MinidumpFileWriter::WriteEverything() freezes and lays out the whole tree
+// before it writes anything, so that time divides its cost between computing
+// the layout and writing.
+class BenchmarkFileWriter : public FileWriterInterface {
+ public:
+  explicit BenchmarkFileWriter(FileWriterInterface* file_writer)
+      : file_writer_(file_writer), first_write_ns_(0), offset_(0), size_(0) {}
+
+  BenchmarkFileWriter(const BenchmarkFileWriter&) = delete;
+  BenchmarkFileWriter& operator=(const BenchmarkFileWriter&) = delete;
+
+  ~BenchmarkFileWriter() override {}
+
+  // The ClockMonotonicNanoseconds() value at the first Write() or WriteIoVec()
+  // call, or 0 if there hasn't been one.
+  uint64_t first_write_ns() const { return first_write_ns_; }
+
+  // The size of the output, in bytes.
+  FileOffset size() const { return size_; }
+
+  // FileWriterInterface:
+
+  bool Write(const void* data, size_t size) override {
+    RecordWrite();
+    if (file_writer_ && !file_writer_->Write(data, size)) {
+      return false;
+    }
+    Advance(size);
+    return true;
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    RecordWrite();
+    size_t size = 0;
+    for (const WritableIoVec& iovec : *iovecs) {
+      size += iovec.iov_len;
+    }
+    if (file_writer_ && !file_writer_->WriteIoVec(iovecs)) {
+      return false;
+    }
+    Advance(size);
+    return true;
+  }
+
+  // FileSeekerInterface:
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    if (file_writer_) {
+      offset_ = file_writer_->Seek(offset, whence);
+      return offset_;
+    }
+    switch (whence) {
+      case SEEK_SET:
+        offset_ = offset;
+        break;
+      case SEEK_CUR:
+        offset_ += offset;
+        break;
+      case SEEK_END:
+        offset_ = size_ + offset;
+        break;
+      default:
+        LOG(ERROR) << "whence " << whence << " invalid";
+        return -1;
+    }
+    return offset_;
+  }
+
+ private:
+  void RecordWrite() {
+    if (first_write_ns_ == 0) {
+      first_write_ns_ = ClockMonotonicNanoseconds();
+    }
+  }
+
+  void Advance(size_t size) {
+    offset_ += size;
+    size_ = std::max(size_, offset_);
+  }
+
+  FileWriterInterface* file_writer_;  // weak
+  uint64_t first_write_ns_;
+  FileOffset offset_;
+  FileOffset size_;
+};
+
+// Returns the peak resident set size of this process, in bytes, or 0 if it
+// isn't available.
+uint64_t PeakResidentBytes() {
+#if BUILDFLAG(IS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    PLOG(ERROR) << "GetProcessMemoryInfo";
+    return 0;
+  }
+  return counters.PeakWorkingSetSize;
+#elif BUILDFLAG(IS_POSIX) && !BUILDFLAG(IS_FUCHSIA)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    PLOG(ERROR) << "getrusage";
+    return 0;
+  }
+#if BUILDFLAG(IS_APPLE)
+  return usage.ru_maxrss;
+#else
+  // Everywhere else, ru_maxrss is in kilobytes.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+struct Sample {
+  uint64_t initialize_ns;
+  uint64_t layout_ns;
+  uint64_t write_ns;
+};
+
+int MinidumpWriterBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionThreads,
+    kOptionStackSize,
+    kOptionCollidingThreadIDs,
+    kOptionModules,
+    kOptionAnnotations,
+    kOptionExtraMemory,
+    kOptionExtraMemorySize,
+    kOptionIterations,
+    kOptionOutput,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"stack-size", required_argument, nullptr, kOptionStackSize},
+      {"colliding-thread-ids",
+       no_argument,
+       nullptr,
+       kOptionCollidingThreadIDs},
+      {"modules", required_argument, nullptr, kOptionModules},
+      {"annotations", required_argument, nullptr, kOptionAnnotations},
+      {"extra-memory", required_argument, nullptr, kOptionExtraMemory},
+      {"extra-memory-size",
+       required_argument,
+       nullptr,
+       kOptionExtraMemorySize},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"output", required_argument, nullptr, kOptionOutput},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  Options options = {};
+  options.shape.threads = 64;
+  options.shape.stack_size = 16 * 1024;
+  options.shape.colliding_thread_ids = false;
+  options.shape.modules = 256;
+  options.shape.simple_annotations = 8;
+  options.shape.annotation_objects = 0;
+  options.shape.extra_memory = 0;
+  options.shape.extra_memory_size = 4096;
+  options.shape.memory_map_regions = 0;
+  options.iterations = 10;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionThreads: {
+        if (!StringToNumber(optarg, &options.shape.threads)) {
+          ToolSupport::UsageHint(me, "--threads requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionStackSize: {
+        if (!StringToNumber(optarg, &options.shape.stack_size)) {
+          ToolSupport::UsageHint(me, "--stack-size requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionCollidingThreadIDs: {
+        options.shape.colliding_thread_ids = true;
+        break;
+      }
+      case kOptionModules: {
+        if (!StringToNumber(optarg, &options.shape.modules)) {
+          ToolSupport::UsageHint(me, "--modules requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionAnnotations: {
+        if (!StringToNumber(optarg, &options.shape.simple_annotations)) {
+          ToolSupport::UsageHint(me, "--annotations requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionExtraMemory: {
+        if (!StringToNumber(optarg, &options.shape.extra_memory)) {
+          ToolSupport::UsageHint(me, "--extra-memory requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionExtraMemorySize: {
+        if (!StringToNumber(optarg, &options.shape.extra_memory_size)) {
+          ToolSupport::UsageHint(me,
+                                 "--extra-memory-size requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionIterations: {
+        if (!StringToNumber(optarg, &options.iterations) ||
+            options.iterations == 0) {
+          ToolSupport::UsageHint(me,
+                                 "--iterations requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionOutput: {
+        options.output = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<TestProcessSnapshot> process_snapshot =
+      BuildSyntheticProcessSnapshot(options.shape);
+  const uint64_t baseline_resident_bytes = PeakResidentBytes();
+
+  std::vector<Sample> samples;
+  FileOffset minidump_size = 0;
+  for (unsigned int iteration = 0; iteration < options.iterations;
+       ++iteration) {
+    FileWriter file_writer;
+    if (!options.output.empty() &&
+        !file_writer.Open(options.output,
+                          FileWriteMode::kTruncateOrCreate,
+                          FilePermissions::kOwnerOnly)) {
+      return EXIT_FAILURE;
+    }
+    BenchmarkFileWriter benchmark_writer(
+        options.output.empty() ? nullptr : &file_writer);
+
+    Sample sample;
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    MinidumpFileWriter minidump_file_writer;
+    minidump_file_writer.InitializeFromSnapshot(process_snapshot.get());
+    const uint64_t initialized_ns = ClockMonotonicNanoseconds();
+    if (!minidump_file_writer.WriteEverything(&benchmark_writer)) {
+      LOG(ERROR) << "WriteEverything failed";
+      return EXIT_FAILURE;
+    }
+    const uint64_t written_ns = ClockMonotonicNanoseconds();
+
+    sample.initialize_ns = initialized_ns - start_ns;
+    sample.layout_ns = benchmark_writer.first_write_ns() - initialized_ns;
+    sample.write_ns = written_ns - benchmark_writer.first_write_ns();
+    samples.push_back(sample);
+    minidump_size = benchmark_writer.size();
+  }
+
+  printf("threads %u%s, stack size %zu, modules %u, annotations %u, "
+         "extra memory %u x %zu, iterations %u\n",
+         options.shape.threads,
+         options.shape.colliding_thread_ids ? " (colliding IDs)" : "",
+         options.shape.stack_size,
+         options.shape.modules,
+         options.shape.simple_annotations,
+         options.shape.extra_memory,
+         options.shape.extra_memory_size,
+         options.iterations);
+  printf("minidump size            %12" PRId64 " bytes\n",
+         static_cast<int64_t>(minidump_size));
+  constexpr int kNameWidth = 24;
+  PrintPhaseHeading(kNameWidth);
+  PrintPhase("InitializeFromSnapshot",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.initialize_ns; });
+  PrintPhase("Freeze and layout",
+             kNameWidth,
+             samples,
+             [](const Sample& sample) { return sample.layout_ns; });
+  PrintPhase("write", kNameWidth, samples, [](const Sample& sample) {
+    return sample.write_ns;
+  });
+  PrintPhase("total", kNameWidth, samples, [](const Sample& sample) {
+    return sample.initialize_ns + sample.layout_ns + sample.write_ns;
+  });
+
+  const uint64_t peak_resident_bytes = PeakResidentBytes();
+  if (peak_resident_bytes) {
+    printf("peak resident size       %12" PRIu64 " KiB (%" PRIu64
+           " KiB after building the snapshot)\n",
+           peak_resident_bytes / 1024,
+           baseline_resident_bytes / 1024);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::test::MinidumpWriterBenchmarkMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::test::MinidumpWriterBenchmarkMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
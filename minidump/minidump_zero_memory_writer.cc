@@ -0,0 +1,101 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_zero_memory_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpZeroMemoryWriter::MinidumpZeroMemoryWriter()
+    : MinidumpStreamWriter(), entries_(), list_() {}
+
+MinidumpZeroMemoryWriter::~MinidumpZeroMemoryWriter() = default;
+
+void MinidumpZeroMemoryWriter::AddRanges(
+    const std::vector<CheckedRange<uint64_t>>& ranges) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const CheckedRange<uint64_t>& range : ranges) {
+    if (range.size() == 0) {
+      continue;
+    }
+    if (!entries_.empty() &&
+        entries_.back().base + entries_.back().size == range.base()) {
+      entries_.back().size += range.size();
+      continue;
+    }
+    MinidumpZeroMemoryRange& entry = entries_.emplace_back();
+    entry.base = range.base();
+    entry.size = range.size();
+  }
+}
+
+bool MinidumpZeroMemoryWriter::IsUseful() const {
+  return !entries_.empty();
+}
+
+bool MinidumpZeroMemoryWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&list_.count, entries_.size())) {
+    LOG(ERROR) << "zero memory range count " << entries_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpZeroMemoryWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(list_) + entries_.size() * sizeof(MinidumpZeroMemoryRange);
+}
+
+std::vector<internal::MinidumpWritable*> MinidumpZeroMemoryWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return {};
+}
+
+bool MinidumpZeroMemoryWriter::WriteObject(FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &list_;
+  iov.iov_len = sizeof(list_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!entries_.empty()) {
+    iov.iov_base = entries_.data();
+    iov.iov_len = entries_.size() * sizeof(MinidumpZeroMemoryRange);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpZeroMemoryWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadZeroMemory;
+}
+
+}  // namespace crashpad
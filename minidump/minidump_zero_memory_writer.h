@@ -0,0 +1,73 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_WRITER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+//! \brief The writer for a MinidumpZeroMemoryList stream in a minidump file.
+class MinidumpZeroMemoryWriter final : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpZeroMemoryWriter();
+
+  MinidumpZeroMemoryWriter(const MinidumpZeroMemoryWriter&) = delete;
+  MinidumpZeroMemoryWriter& operator=(const MinidumpZeroMemoryWriter&) =
+      delete;
+
+  ~MinidumpZeroMemoryWriter() override;
+
+  //! \brief Adds a MinidumpZeroMemoryRange for each range in \a ranges.
+  //!
+  //! Empty ranges are ignored. Ranges that adjoin the range added before them
+  //! are combined with it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddRanges(const std::vector<CheckedRange<uint64_t>>& ranges);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying entries would be
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ private:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+  std::vector<MinidumpZeroMemoryRange> entries_;
+  MinidumpZeroMemoryList list_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_WRITER_H_
@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_zero_memory_writer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns the MinidumpZeroMemoryList stream, which must be the only stream, in
+// file_contents.
+void GetZeroMemoryStream(const std::string& file_contents,
+                         const MinidumpZeroMemoryList** list) {
+  constexpr size_t kListOffset =
+      sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY);
+
+  ASSERT_GE(file_contents.size(), kListOffset + sizeof(MinidumpZeroMemoryList));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType, kMinidumpStreamTypeCrashpadZeroMemory);
+  EXPECT_EQ(directory[0].Location.Rva, kListOffset);
+
+  *list = reinterpret_cast<const MinidumpZeroMemoryList*>(
+      &file_contents[kListOffset]);
+  ASSERT_EQ(directory[0].Location.DataSize,
+            sizeof(MinidumpZeroMemoryList) +
+                (*list)->count * sizeof(MinidumpZeroMemoryRange));
+  ASSERT_EQ(file_contents.size(), kListOffset + directory[0].Location.DataSize);
+}
+
+TEST(MinidumpZeroMemoryWriter, Empty) {
+  auto zero_memory_writer = std::make_unique<MinidumpZeroMemoryWriter>();
+  zero_memory_writer->AddRanges({CheckedRange<uint64_t>(0x1000, 0)});
+  EXPECT_FALSE(zero_memory_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(zero_memory_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpZeroMemoryList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetZeroMemoryStream(string_file.string(), &list));
+  EXPECT_EQ(list->count, 0u);
+  EXPECT_EQ(list->reserved, 0u);
+}
+
+TEST(MinidumpZeroMemoryWriter, Ranges) {
+  auto zero_memory_writer = std::make_unique<MinidumpZeroMemoryWriter>();
+  zero_memory_writer->AddRanges({CheckedRange<uint64_t>(0x10000, 0x1000),
+                                 CheckedRange<uint64_t>(0x11000, 0x3000),
+                                 CheckedRange<uint64_t>(0x20000, 0)});
+  zero_memory_writer->AddRanges(
+      {CheckedRange<uint64_t>(0x7fff00000000, 0x100000)});
+  EXPECT_TRUE(zero_memory_writer->IsUseful());
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(zero_memory_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpZeroMemoryList* list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetZeroMemoryStream(string_file.string(), &list));
+
+  // The adjoining ranges are combined.
+  ASSERT_EQ(list->count, 2u);
+  EXPECT_EQ(list->entries[0].base, 0x10000u);
+  EXPECT_EQ(list->entries[0].size, 0x4000u);
+  EXPECT_EQ(list->entries[1].base, 0x7fff00000000u);
+  EXPECT_EQ(list->entries[1].size, 0x100000u);
+}
+
+TEST(MinidumpZeroMemoryWriter, AddFullMemory) {
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddFullMemory(
+      {}, {CheckedRange<uint64_t>(0x10000, 0x1000)}));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(header);
+  ASSERT_TRUE(directory);
+  ASSERT_EQ(header->NumberOfStreams, 2u);
+  EXPECT_EQ(directory[0].StreamType, kMinidumpStreamTypeMemory64List);
+  EXPECT_EQ(directory[1].StreamType, kMinidumpStreamTypeCrashpadZeroMemory);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
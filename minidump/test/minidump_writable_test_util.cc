@@ -258,6 +258,12 @@ struct MinidumpAnnotationListObjectsTraits {
   static size_t ElementCount(const ListType* list) { return list->count; }
 };
 
+struct MinidumpThreadBreadcrumbsListTraits {
+  using ListType = MinidumpThreadBreadcrumbsList;
+  enum : size_t { kElementSize = sizeof(MinidumpThreadBreadcrumbs) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
 template <typename T>
 const typename T::ListType* MinidumpListAtLocationDescriptor(
     const std::string& file_contents,
@@ -371,6 +377,50 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
       file_contents, location);
 }
 
+template <>
+const MinidumpThreadBreadcrumbsList*
+MinidumpWritableAtLocationDescriptor<MinidumpThreadBreadcrumbsList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpThreadBreadcrumbsListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpCaptureTimings*
+MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimings>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  const MinidumpCaptureTimings* timings =
+      TMinidumpWritableAtLocationDescriptor<MinidumpCaptureTimings>(
+          file_contents, location);
+  if (!timings) {
+    return nullptr;
+  }
+
+  size_t expected_size = sizeof(MinidumpCaptureTimings) +
+                         timings->count * sizeof(MinidumpCaptureTiming);
+  if (timings->version >= 2) {
+    // The entries are followed by a MinidumpRemoteReadsList.
+    if (location.DataSize < expected_size + sizeof(MinidumpRemoteReadsList)) {
+      EXPECT_GE(location.DataSize,
+                expected_size + sizeof(MinidumpRemoteReadsList));
+      return nullptr;
+    }
+    const MinidumpRemoteReadsList* remote_reads =
+        reinterpret_cast<const MinidumpRemoteReadsList*>(
+            &file_contents[location.Rva + expected_size]);
+    expected_size += sizeof(MinidumpRemoteReadsList) +
+                     remote_reads->count * sizeof(MinidumpRemoteReads);
+  }
+  if (location.DataSize != expected_size) {
+    EXPECT_EQ(location.DataSize, expected_size);
+    return nullptr;
+  }
+
+  return timings;
+}
+
 namespace {
 
 template <typename T>
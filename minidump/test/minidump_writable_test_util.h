@@ -108,6 +108,9 @@ MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpModuleCrashpadInfoList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpRVAList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpSimpleStringDictionary);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpAnnotationList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpThreadBreadcrumbsList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpCaptureTimings);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpThreadGroupList);
 
 // These types have final fields carrying variable-sized data (typically string
 // data).
@@ -171,8 +174,9 @@ const T* TMinidumpWritableAtLocationDescriptor(
 //!    ensures that the structure’s magic number and version fields are correct.
 //!  - With a MINIDUMP_MEMORY_LIST, MINIDUMP_THREAD_LIST,
 //!    MINIDUMP_THREAD_NAME_LIST, MINIDUMP_MODULE_LIST,
-//!    MINIDUMP_MEMORY_INFO_LIST, MinidumpSimpleStringDictionary, or
-//!    MinidumpAnnotationList template parameter, template specializations
+//!    MINIDUMP_MEMORY_INFO_LIST, MinidumpSimpleStringDictionary,
+//!    MinidumpAnnotationList, MinidumpThreadBreadcrumbsList, or
+//!    MinidumpCaptureTimings template parameter, template specializations
 //!    ensure that the size given by \a location matches the size expected of a
 //!    stream containing the number of elements it claims to have.
 //!  - With an IMAGE_DEBUG_MISC, CodeViewRecordPDB20, or CodeViewRecordPDB70
@@ -293,6 +297,18 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
     const std::string& file_contents,
     const MINIDUMP_LOCATION_DESCRIPTOR& location);
 
+template <>
+const MinidumpThreadBreadcrumbsList*
+MinidumpWritableAtLocationDescriptor<MinidumpThreadBreadcrumbsList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpCaptureTimings*
+MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimings>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
 //! \brief Returns a typed minidump object located within a minidump file’s
 //!     contents, where the offset of the object is known.
 //!
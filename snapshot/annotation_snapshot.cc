@@ -14,6 +14,13 @@
 
 #include "snapshot/annotation_snapshot.h"
 
+#include <inttypes.h>
+#include <string.h>
+
+#include "base/strings/stringprintf.h"
+#include "client/annotation.h"
+#include "util/misc/uuid.h"
+
 namespace crashpad {
 
 AnnotationSnapshot::AnnotationSnapshot() : name(), type(0), value() {}
@@ -29,4 +36,66 @@ bool AnnotationSnapshot::operator==(const AnnotationSnapshot& other) const {
   return name == other.name && type == other.type && value == other.value;
 }
 
+namespace {
+
+// Copies |value| into |object|, which must be exactly the same size.
+template <typename T>
+bool ValueAs(const std::vector<uint8_t>& value, T* object) {
+  if (value.size() != sizeof(*object)) {
+    return false;
+  }
+  memcpy(object, value.data(), sizeof(*object));
+  return true;
+}
+
+}  // namespace
+
+bool AnnotationSnapshot::ValueToString(std::string* string) const {
+  switch (static_cast<Annotation::Type>(type)) {
+    case Annotation::Type::kString:
+      string->assign(reinterpret_cast<const char*>(value.data()), value.size());
+      return true;
+
+    case Annotation::Type::kInt64: {
+      int64_t number;
+      if (!ValueAs(value, &number)) {
+        return false;
+      }
+      *string = base::StringPrintf("%" PRId64, number);
+      return true;
+    }
+
+    case Annotation::Type::kUint64: {
+      uint64_t number;
+      if (!ValueAs(value, &number)) {
+        return false;
+      }
+      *string = base::StringPrintf("%" PRIu64, number);
+      return true;
+    }
+
+    case Annotation::Type::kDouble: {
+      double number;
+      if (!ValueAs(value, &number)) {
+        return false;
+      }
+      // 17 significant digits are enough to represent any double exactly.
+      *string = base::StringPrintf("%.17g", number);
+      return true;
+    }
+
+    case Annotation::Type::kUUID: {
+      UUID uuid;
+      if (!ValueAs(value, &uuid)) {
+        return false;
+      }
+      *string = uuid.ToString();
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
 }  // namespace crashpad
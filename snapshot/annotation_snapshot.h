@@ -35,6 +35,19 @@ struct AnnotationSnapshot {
     return !(*this == other);
   }
 
+  //! \brief Formats the value as a string, if it is of a type defined by
+  //!     Crashpad that has a textual representation.
+  //!
+  //! Annotation::Type::kString values are returned as-is. Numeric values are
+  //! formatted in decimal, and Annotation::Type::kUUID values in the form
+  //! produced by UUID::ToString().
+  //!
+  //! \param[out] string The formatted value.
+  //!
+  //! \return `true` on success. `false` if \a #type is user-defined or unknown,
+  //!     or if \a #value is not the size that \a #type requires.
+  bool ValueToString(std::string* string) const;
+
   //! \brief A non-unique name by which this annotation can be identified.
   std::string name;
 
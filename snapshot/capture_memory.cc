@@ -20,137 +20,475 @@
 // dbghelp must be after windows.h.
 #include <dbghelp.h>
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
+#include <set>
+#include <utility>
 
 #include "base/containers/heap_array.h"
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "snapshot/memory_snapshot.h"
+#include "snapshot/memory_snapshot_generic.h"
+#include "util/misc/clock.h"
+
+#if defined(ARCH_CPU_ARM64) && \
+    (BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID))
+#include "util/linux/pac_helper.h"
+#endif
 
 namespace crashpad {
 namespace internal {
 
 namespace {
 
-void MaybeCaptureMemoryAround(CaptureMemory::Delegate* delegate,
-                              uint64_t address) {
-  constexpr uint64_t non_address_offset = 0x10000;
-  if (address < non_address_offset)
-    return;
+constexpr uint64_t kNonAddressOffset = 0x10000;
+
+// Memory is captured from kRegisterByteOffset bytes below a pointer to
+// kCaptureSize - kRegisterByteOffset bytes above it.
+constexpr uint64_t kRegisterByteOffset = 128;
+constexpr uint64_t kCaptureSize = 512;
+static_assert(kRegisterByteOffset <= kCaptureSize / 2,
+              "negative offset too large");
+
+// Returns true if address is not too close to zero (signed or unsigned) to be
+// a pointer.
+bool IsPointerLike(const CaptureMemory::Delegate& delegate, uint64_t address) {
+  if (address < kNonAddressOffset)
+    return false;
 
-  const uint64_t max_address = delegate->Is64Bit() ?
+  const uint64_t max_address = delegate.Is64Bit() ?
       std::numeric_limits<uint64_t>::max() :
       std::numeric_limits<uint32_t>::max();
-  if (address > max_address - non_address_offset)
+  return address <= max_address - kNonAddressOffset;
+}
+
+// Return addresses and function pointers signed with pointer authentication
+// carry an authentication code in their upper bits, which must be removed
+// before they are recognized as addresses. The mask is fetched once per scan,
+// so that stripping each word is only a few instructions.
+#if defined(ARCH_CPU_ARM64) && \
+    (BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID))
+uint64_t PointerAuthenticationMask() {
+  return PACAddressMask();
+}
+
+uint64_t StripPointerAuthentication(uint64_t value, uint64_t mask) {
+  return StripPACBitsWithMask(value, mask);
+}
+#else
+constexpr uint64_t PointerAuthenticationMask() {
+  return std::numeric_limits<uint64_t>::max();
+}
+
+constexpr uint64_t StripPointerAuthentication(uint64_t value, uint64_t mask) {
+  return value;
+}
+#endif
+
+void MaybeCaptureMemoryAround(CaptureMemory::Delegate* delegate,
+                              uint64_t address) {
+  if (!IsPointerLike(*delegate, address))
     return;
 
-  constexpr uint64_t kRegisterByteOffset = 128;
   const uint64_t target = address - kRegisterByteOffset;
-  constexpr uint64_t size = 512;
-  static_assert(kRegisterByteOffset <= size / 2,
-                "negative offset too large");
   auto ranges =
-      delegate->GetReadableRanges(CheckedRange<uint64_t>(target, size));
+      delegate->GetReadableRanges(CheckedRange<uint64_t>(target, kCaptureSize));
   for (const auto& range : ranges) {
     delegate->AddNewMemorySnapshot(range);
   }
 }
 
-template <class T>
-void CaptureAtPointersInRange(uint8_t* buffer,
-                              uint64_t buffer_size,
-                              CaptureMemory::Delegate* delegate) {
-  for (uint64_t address_offset = 0; address_offset < buffer_size;
-       address_offset += sizeof(T)) {
-    uint64_t target_address = *reinterpret_cast<T*>(&buffer[address_offset]);
-    MaybeCaptureMemoryAround(delegate, target_address);
+// The values that are pointer-like and close enough to the delegate's address
+// bounds for memory to be captured around them, as the half-open interval
+// [low, low + span). Values are tested after stripping any pointer
+// authentication code.
+class PointerFilter {
+ public:
+  explicit PointerFilter(const CaptureMemory::Delegate& delegate)
+      : pac_mask_(PointerAuthenticationMask()) {
+    const uint64_t max_address = delegate.Is64Bit()
+                                     ? std::numeric_limits<uint64_t>::max()
+                                     : std::numeric_limits<uint32_t>::max();
+    uint64_t low = kNonAddressOffset;
+    uint64_t high = max_address - kNonAddressOffset + 1;
+
+    uint64_t bounds_low;
+    uint64_t bounds_high;
+    if (delegate.GetAddressBounds(&bounds_low, &bounds_high)) {
+      // The range captured around a value must overlap the bounds.
+      constexpr uint64_t kBelow = kCaptureSize - kRegisterByteOffset - 1;
+      if (bounds_low > kBelow) {
+        low = std::max(low, bounds_low - kBelow);
+      }
+      if (bounds_high < high - kRegisterByteOffset) {
+        high = bounds_high + kRegisterByteOffset;
+      }
+    }
+
+    low_ = low;
+    span_ = high > low ? high - low : 0;
+  }
+
+  bool Contains(uint64_t value) const { return value - low_ < span_; }
+
+  uint64_t Strip(uint64_t value) const {
+    return StripPointerAuthentication(value, pac_mask_);
+  }
+
+ private:
+  uint64_t pac_mask_;
+  uint64_t low_;
+  uint64_t span_;
+};
+
+// Calls function with the offset and stripped value of each pointer-sized word
+// in buffer that filter contains.
+template <class T, typename Function>
+void ForEachCandidatePointer(const uint8_t* buffer,
+                             size_t buffer_size,
+                             const PointerFilter& filter,
+                             Function function) {
+  const T* const words = reinterpret_cast<const T*>(buffer);
+  const size_t count = buffer_size / sizeof(T);
+
+  // Most words in memory aren't candidates. Words are tested a block at a time
+  // without branching, which compilers vectorize, and only the words in blocks
+  // with a candidate are examined individually.
+  constexpr size_t kBlockSize = 8;
+  size_t index = 0;
+  for (; index + kBlockSize <= count; index += kBlockSize) {
+    bool any = false;
+    for (size_t block_index = 0; block_index < kBlockSize; ++block_index) {
+      any |= filter.Contains(filter.Strip(words[index + block_index]));
+    }
+    if (!any) {
+      continue;
+    }
+    for (size_t block_index = 0; block_index < kBlockSize; ++block_index) {
+      const uint64_t value = filter.Strip(words[index + block_index]);
+      if (filter.Contains(value)) {
+        function((index + block_index) * sizeof(T), value);
+      }
+    }
+  }
+  for (; index < count; ++index) {
+    const uint64_t value = filter.Strip(words[index]);
+    if (filter.Contains(value)) {
+      function(index * sizeof(T), value);
+    }
   }
 }
 
-}  // namespace
+void ChargeBudget(uint64_t size, uint32_t* budget_remaining) {
+  *budget_remaining =
+      size >= *budget_remaining
+          ? 0
+          : *budget_remaining - static_cast<uint32_t>(size);
+}
 
-// static
-void CaptureMemory::PointedToByContext(const CPUContext& context,
-                                       Delegate* delegate) {
+// Returns true if the ranges [a_base, a_end) and [b_base, b_end) overlap or are
+// separated by at most max_gap bytes.
+bool RangesAreWithin(uint64_t a_base,
+                     uint64_t a_end,
+                     uint64_t b_base,
+                     uint64_t b_end,
+                     uint64_t max_gap) {
+  if (a_end < b_base) {
+    return b_base - a_end <= max_gap;
+  }
+  if (b_end < a_base) {
+    return a_base - b_end <= max_gap;
+  }
+  return true;
+}
+
+// Calls function with the value of each register in context that may hold a
+// pointer, starting with the instruction pointer.
+template <typename Function>
+void ForEachRegister(const CPUContext& context, Function function) {
 #if defined(ARCH_CPU_X86_FAMILY)
   if (context.architecture == kCPUArchitectureX86_64) {
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rip);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rax);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rbx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rcx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rdx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rdi);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rsi);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rbp);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r8);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r9);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r10);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r11);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r12);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r13);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r14);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r15);
+    function(context.x86_64->rip);
+    function(context.x86_64->rax);
+    function(context.x86_64->rbx);
+    function(context.x86_64->rcx);
+    function(context.x86_64->rdx);
+    function(context.x86_64->rdi);
+    function(context.x86_64->rsi);
+    function(context.x86_64->rbp);
+    function(context.x86_64->r8);
+    function(context.x86_64->r9);
+    function(context.x86_64->r10);
+    function(context.x86_64->r11);
+    function(context.x86_64->r12);
+    function(context.x86_64->r13);
+    function(context.x86_64->r14);
+    function(context.x86_64->r15);
     // Note: Shadow stack region is directly captured.
   } else {
-    MaybeCaptureMemoryAround(delegate, context.x86->eip);
-    MaybeCaptureMemoryAround(delegate, context.x86->eax);
-    MaybeCaptureMemoryAround(delegate, context.x86->ebx);
-    MaybeCaptureMemoryAround(delegate, context.x86->ecx);
-    MaybeCaptureMemoryAround(delegate, context.x86->edx);
-    MaybeCaptureMemoryAround(delegate, context.x86->edi);
-    MaybeCaptureMemoryAround(delegate, context.x86->esi);
-    MaybeCaptureMemoryAround(delegate, context.x86->ebp);
+    function(context.x86->eip);
+    function(context.x86->eax);
+    function(context.x86->ebx);
+    function(context.x86->ecx);
+    function(context.x86->edx);
+    function(context.x86->edi);
+    function(context.x86->esi);
+    function(context.x86->ebp);
   }
 #elif defined(ARCH_CPU_ARM_FAMILY)
   if (context.architecture == kCPUArchitectureARM64) {
-    MaybeCaptureMemoryAround(delegate, context.arm64->pc);
+    function(context.arm64->pc);
     for (size_t i = 0; i < std::size(context.arm64->regs); ++i) {
-      MaybeCaptureMemoryAround(delegate, context.arm64->regs[i]);
+      function(context.arm64->regs[i]);
     }
   } else {
-    MaybeCaptureMemoryAround(delegate, context.arm->pc);
+    function(context.arm->pc);
     for (size_t i = 0; i < std::size(context.arm->regs); ++i) {
-      MaybeCaptureMemoryAround(delegate, context.arm->regs[i]);
+      function(context.arm->regs[i]);
     }
   }
 #elif defined(ARCH_CPU_MIPS_FAMILY)
   for (size_t i = 0; i < std::size(context.mipsel->regs); ++i) {
-    MaybeCaptureMemoryAround(delegate, context.mipsel->regs[i]);
+    function(context.mipsel->regs[i]);
   }
 #elif defined(ARCH_CPU_RISCV64)
-  MaybeCaptureMemoryAround(delegate, context.riscv64->pc);
+  function(context.riscv64->pc);
   for (size_t i = 0; i < std::size(context.riscv64->regs); ++i) {
-    MaybeCaptureMemoryAround(delegate, context.riscv64->regs[i]);
+    function(context.riscv64->regs[i]);
   }
 #else
 #error Port.
 #endif
 }
 
+// Memory scanned for pointers is read this many bytes at a time, so that
+// scanning a large region doesn't need a buffer as large as the region. This
+// is a multiple of every pointer size.
+constexpr size_t kReadChunkSize = 256 * 1024;
+
+// Reads memory, which must be pointer-aligned and an integral number of
+// pointers long, in pieces no larger than kReadChunkSize, and calls
+// ForEachCandidatePointer() on each piece. function is called with the offset
+// of each candidate from the start of memory, and its value.
+template <class T, typename Function>
+void ForEachCandidatePointerInRange(const MemorySnapshot& memory,
+                                    const CaptureMemory::Delegate& delegate,
+                                    Function function) {
+  if (memory.Address() % sizeof(T) != 0 || memory.Size() % sizeof(T) != 0) {
+    LOG(ERROR) << "unaligned range";
+    return;
+  }
+
+  const PointerFilter filter(delegate);
+  auto buffer = base::HeapArray<uint8_t>::Uninit(
+      std::min(memory.Size(), kReadChunkSize));
+  for (size_t chunk_offset = 0; chunk_offset < memory.Size();) {
+    const size_t chunk_size =
+        std::min(memory.Size() - chunk_offset, buffer.size());
+    if (!delegate.ReadMemory(
+            memory.Address() + chunk_offset, chunk_size, buffer.data())) {
+      LOG(ERROR) << "ReadMemory";
+      return;
+    }
+    ForEachCandidatePointer<T>(
+        buffer.data(),
+        chunk_size,
+        filter,
+        [chunk_offset, &function](size_t offset, uint64_t value) {
+          function(chunk_offset + offset, value);
+        });
+    chunk_offset += chunk_size;
+  }
+}
+
+}  // namespace
+
+// static
+void CaptureMemory::PointedToByContext(const CPUContext& context,
+                                       Delegate* delegate) {
+  const uint64_t pac_mask = PointerAuthenticationMask();
+  ForEachRegister(context, [delegate, pac_mask](uint64_t value) {
+    MaybeCaptureMemoryAround(delegate,
+                             StripPointerAuthentication(value, pac_mask));
+  });
+}
+
 // static
 void CaptureMemory::PointedToByMemoryRange(const MemorySnapshot& memory,
                                            Delegate* delegate) {
   if (memory.Size() == 0)
     return;
 
-  const size_t alignment =
-      delegate->Is64Bit() ? sizeof(uint64_t) : sizeof(uint32_t);
-  if (memory.Address() % alignment != 0 || memory.Size() % alignment != 0) {
-    LOG(ERROR) << "unaligned range";
-    return;
+  auto capture = [delegate](size_t offset, uint64_t value) {
+    MaybeCaptureMemoryAround(delegate, value);
+  };
+  if (delegate->Is64Bit())
+    ForEachCandidatePointerInRange<uint64_t>(memory, *delegate, capture);
+  else
+    ForEachCandidatePointerInRange<uint32_t>(memory, *delegate, capture);
+}
+
+// static
+MemorySnapshotGeneric* CaptureMemory::AddCoalescedMemorySnapshot(
+    const ProcessMemory* process_memory,
+    const CheckedRange<uint64_t, uint64_t>& range,
+    uint64_t max_gap,
+    const Delegate& delegate,
+    std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
+    uint32_t* budget_remaining) {
+  if (range.size() == 0)
+    return nullptr;
+  if (!budget_remaining || *budget_remaining == 0)
+    return nullptr;
+
+  // snapshots is kept sorted by address, so the snapshots that range is most
+  // likely to merge with are found by a binary search: the last one starting
+  // before range, and the first one starting at or after it.
+  auto next = std::lower_bound(
+      snapshots->begin(),
+      snapshots->end(),
+      range.base(),
+      [](const std::unique_ptr<MemorySnapshotGeneric>& snapshot,
+         uint64_t address) { return snapshot->Address() < address; });
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>>::iterator candidates[2];
+  size_t candidate_count = 0;
+  if (next != snapshots->begin()) {
+    candidates[candidate_count++] = std::prev(next);
+  }
+  if (next != snapshots->end()) {
+    candidates[candidate_count++] = next;
+  }
+
+  for (size_t index = 0; index < candidate_count; ++index) {
+    std::unique_ptr<MemorySnapshotGeneric>& snapshot = *candidates[index];
+    const uint64_t snapshot_base = snapshot->Address();
+    const uint64_t snapshot_end = snapshot_base + snapshot->Size();
+    if (!RangesAreWithin(
+            range.base(), range.end(), snapshot_base, snapshot_end, max_gap)) {
+      continue;
+    }
+
+    const uint64_t merged_base = std::min(range.base(), snapshot_base);
+    const CheckedRange<uint64_t, uint64_t> merged(
+        merged_base, std::max(range.end(), snapshot_end) - merged_base);
+    if (merged.size() == snapshot->Size()) {
+      // Already captured.
+      return nullptr;
+    }
+
+    // Only fill in a gap between the ranges if all of it can be read.
+    if (!RangesAreWithin(
+            range.base(), range.end(), snapshot_base, snapshot_end, 0)) {
+      const std::vector<CheckedRange<uint64_t>> readable =
+          delegate.GetReadableRanges(merged);
+      if (readable.size() != 1 || readable[0].base() != merged.base() ||
+          readable[0].size() != merged.size()) {
+        continue;
+      }
+    }
+
+    // The merged snapshot starts at the lower of the two bases, which keeps
+    // snapshots sorted.
+    ChargeBudget(merged.size() - snapshot->Size(), budget_remaining);
+    snapshot = std::make_unique<MemorySnapshotGeneric>();
+    snapshot->Initialize(process_memory, merged.base(), merged.size());
+    return snapshot.get();
   }
 
-  auto buffer = base::HeapArray<uint8_t>::Uninit(memory.Size());
-  if (!delegate->ReadMemory(memory.Address(), memory.Size(), buffer.data())) {
-    LOG(ERROR) << "ReadMemory";
+  auto snapshot =
+      snapshots->insert(next, std::make_unique<MemorySnapshotGeneric>());
+  (*snapshot)->Initialize(process_memory, range.base(), range.size());
+  ChargeBudget(range.size(), budget_remaining);
+  return snapshot->get();
+}
+
+bool PrioritizedCaptureMemory::CandidateAfter::operator()(
+    const Candidate& a,
+    const Candidate& b) const {
+  if (a.tier != b.tier) {
+    return a.tier > b.tier;
+  }
+  if (a.distance != b.distance) {
+    return a.distance > b.distance;
+  }
+  return a.sequence > b.sequence;
+}
+
+PrioritizedCaptureMemory::PrioritizedCaptureMemory()
+    : candidates_(), next_sequence_(0) {}
+
+PrioritizedCaptureMemory::~PrioritizedCaptureMemory() {}
+
+void PrioritizedCaptureMemory::AddContext(const CPUContext& context,
+                                          bool is_exception_thread,
+                                          CaptureMemory::Delegate* delegate) {
+  const Tier tier = is_exception_thread ? Tier::kExceptionThreadRegisters
+                                        : Tier::kRegisters;
+  const uint64_t pac_mask = PointerAuthenticationMask();
+  ForEachRegister(context, [this, tier, delegate, pac_mask](uint64_t value) {
+    value = StripPointerAuthentication(value, pac_mask);
+    if (IsPointerLike(*delegate, value)) {
+      AddCandidate(tier, 0, value, delegate);
+    }
+  });
+}
+
+void PrioritizedCaptureMemory::AddStack(const MemorySnapshot& stack,
+                                        uint64_t stack_pointer,
+                                        bool is_exception_thread,
+                                        CaptureMemory::Delegate* delegate) {
+  if (stack.Size() == 0)
     return;
+
+  const Tier tier =
+      is_exception_thread ? Tier::kExceptionThreadStack : Tier::kStack;
+  auto add_candidate = [this, &stack, stack_pointer, tier, delegate](
+                           size_t offset, uint64_t value) {
+    // Slots below the stack pointer are usually stale, but may hold a red
+    // zone, so rank them by distance like any other slot.
+    const uint64_t slot = stack.Address() + offset;
+    const uint64_t distance =
+        slot >= stack_pointer ? slot - stack_pointer : stack_pointer - slot;
+    AddCandidate(tier, distance, value, delegate);
+  };
+  if (delegate->Is64Bit()) {
+    ForEachCandidatePointerInRange<uint64_t>(stack, *delegate, add_candidate);
+  } else {
+    ForEachCandidatePointerInRange<uint32_t>(stack, *delegate, add_candidate);
   }
+}
 
-  if (delegate->Is64Bit())
-    CaptureAtPointersInRange<uint64_t>(buffer.data(), buffer.size(), delegate);
-  else
-    CaptureAtPointersInRange<uint32_t>(buffer.data(), buffer.size(), delegate);
+bool PrioritizedCaptureMemory::Capture(const uint32_t* budget_remaining,
+                                       uint64_t time_limit_ns) {
+  if (!budget_remaining) {
+    return true;
+  }
+
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  std::set<std::pair<const CaptureMemory::Delegate*, uint64_t>> visited;
+  while (!candidates_.empty() && *budget_remaining != 0) {
+    if (ClockMonotonicNanoseconds() - start_ns >= time_limit_ns) {
+      LOG(WARNING) << "time limit reached with " << candidates_.size()
+                   << " candidates remaining";
+      return false;
+    }
+
+    const Candidate candidate = candidates_.top();
+    candidates_.pop();
+    if (visited.emplace(candidate.delegate, candidate.address).second) {
+      MaybeCaptureMemoryAround(candidate.delegate, candidate.address);
+    }
+  }
+  return true;
+}
+
+void PrioritizedCaptureMemory::AddCandidate(Tier tier,
+                                            uint64_t distance,
+                                            uint64_t address,
+                                            CaptureMemory::Delegate* delegate) {
+  candidates_.push({tier, distance, next_sequence_++, address, delegate});
 }
 
 }  // namespace internal
@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 
+#include <memory>
+#include <queue>
 #include <vector>
 
 #include "snapshot/cpu_context.h"
@@ -25,9 +27,12 @@
 namespace crashpad {
 
 class MemorySnapshot;
+class ProcessMemory;
 
 namespace internal {
 
+class MemorySnapshotGeneric;
+
 class CaptureMemory {
  public:
   //! \brief An interface to a platform-specific process reader.
@@ -62,6 +67,20 @@ class CaptureMemory {
     //!     process to the result.
     virtual void AddNewMemorySnapshot(
         const CheckedRange<uint64_t, uint64_t>& range) = 0;
+
+    //! \brief Returns bounds outside of which GetReadableRanges() never
+    //!     returns anything.
+    //!
+    //! Scans for pointers use these bounds to discard values that can't point
+    //! to readable memory without examining them individually.
+    //!
+    //! \param[out] low The lowest address that may be readable.
+    //! \param[out] high The end of the highest range that may be readable.
+    //! \return `true` if the bounds are known. The default implementation
+    //!     returns `false`.
+    virtual bool GetAddressBounds(uint64_t* low, uint64_t* high) const {
+      return false;
+    }
   };
 
   CaptureMemory() = delete;
@@ -91,6 +110,156 @@ class CaptureMemory {
   //!     process and adding new ranges.
   static void PointedToByMemoryRange(const MemorySnapshot& memory,
                                      Delegate* delegate);
+
+  //! \brief The largest distance, in bytes, between two captured ranges that
+  //!     AddCoalescedMemorySnapshot() will fill in to merge them.
+  //!
+  //! Ranges captured around nearby pointers are commonly close together but
+  //! not adjacent. Capturing the gap between them costs at most this many
+  //! extra bytes, and saves a read and a MINIDUMP_MEMORY_DESCRIPTOR.
+  static constexpr uint64_t kCoalescingDistance = 256;
+
+  //! \brief Adds a snapshot of \a range to \a snapshots, merging it into an
+  //!     existing snapshot where possible.
+  //!
+  //! If \a range overlaps a neighboring snapshot in \a snapshots, or lies
+  //! within \a max_gap bytes of one and the memory in between is readable,
+  //! that snapshot is replaced by one covering both. Neighbors are found by
+  //! binary search, so this takes logarithmic time to find them. Otherwise a
+  //! new snapshot is added. Only bytes not already covered by \a snapshots are
+  //! charged against \a budget_remaining.
+  //!
+  //! This is intended to be called by Delegate::AddNewMemorySnapshot()
+  //! implementations.
+  //!
+  //! \param[in] process_memory A reader for the process being snapshotted.
+  //! \param[in] range The range to capture.
+  //! \param[in] max_gap The largest gap to fill in order to merge ranges.
+  //! \param[in] delegate The delegate, used to determine whether a gap is
+  //!     readable.
+  //! \param[in,out] snapshots The snapshots captured so far, sorted by
+  //!     address. Any snapshot added or replaced keeps them sorted, so a
+  //!     vector only ever modified through this function remains sorted.
+  //! \param[in,out] budget_remaining If non-null, a pointer to the remaining
+  //!     number of bytes to capture. If this is `nullptr` or `0`, no further
+  //!     memory will be captured.
+  //!
+  //! \return The snapshot that was added or that replaced an existing one, or
+  //!     `nullptr` if \a snapshots was left unchanged.
+  static MemorySnapshotGeneric* AddCoalescedMemorySnapshot(
+      const ProcessMemory* process_memory,
+      const CheckedRange<uint64_t, uint64_t>& range,
+      uint64_t max_gap,
+      const Delegate& delegate,
+      std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
+      uint32_t* budget_remaining);
+};
+
+//! \brief Captures memory around pointer-like values found in thread contexts
+//!     and stacks, most promising candidates first.
+//!
+//! CaptureMemory::PointedToByContext() and
+//! CaptureMemory::PointedToByMemoryRange() capture memory in the order that
+//! they are called, so a budget can be used up by the first threads
+//! inspected. Instead, this class collects candidate pointers from any number
+//! of threads with AddContext() and AddStack(), and Capture() visits them in
+//! order of:
+//!  1. registers of the thread that raised the exception,
+//!  2. stack slots of the thread that raised the exception,
+//!  3. registers of other threads,
+//!  4. stack slots of other threads.
+//!
+//! Stack slots within a tier are visited in order of increasing distance from
+//! their thread's stack pointer. Candidates that tie are visited in the order
+//! that they were added.
+class PrioritizedCaptureMemory {
+ public:
+  //! \brief The default time limit for Capture(), in nanoseconds.
+  static constexpr uint64_t kDefaultTimeLimitNanoseconds = 500'000'000;
+
+  PrioritizedCaptureMemory();
+
+  PrioritizedCaptureMemory(const PrioritizedCaptureMemory&) = delete;
+  PrioritizedCaptureMemory& operator=(const PrioritizedCaptureMemory&) =
+      delete;
+
+  ~PrioritizedCaptureMemory();
+
+  //! \brief Adds the pointer-like registers in \a context as candidates.
+  //!
+  //! \param[in] context The context to inspect.
+  //! \param[in] is_exception_thread `true` if \a context belongs to the thread
+  //!     that raised the exception being captured.
+  //! \param[in] delegate A Delegate that handles reading from the target
+  //!     process and adding new ranges for this thread. It must outlive the
+  //!     call to Capture().
+  void AddContext(const CPUContext& context,
+                  bool is_exception_thread,
+                  CaptureMemory::Delegate* delegate);
+
+  //! \brief Adds the pointer-like values in \a stack as candidates.
+  //!
+  //! \param[in] stack A MemorySnapshot of the thread's stack. The base address
+  //!     and size must be pointer-aligned and an integral number of pointers
+  //!     long.
+  //! \param[in] stack_pointer The thread's stack pointer.
+  //! \param[in] is_exception_thread `true` if \a stack belongs to the thread
+  //!     that raised the exception being captured.
+  //! \param[in] delegate A Delegate that handles reading from the target
+  //!     process and adding new ranges for this thread. It must outlive the
+  //!     call to Capture().
+  void AddStack(const MemorySnapshot& stack,
+                uint64_t stack_pointer,
+                bool is_exception_thread,
+                CaptureMemory::Delegate* delegate);
+
+  //! \brief Captures memory around candidates in priority order.
+  //!
+  //! Capture stops when every candidate has been visited, when \a
+  //! budget_remaining reaches `0`, or when \a time_limit_ns has elapsed,
+  //! whichever happens first. Candidates are consumed, so calling this again
+  //! only visits candidates added since.
+  //!
+  //! \param[in] budget_remaining A pointer to the remaining number of bytes to
+  //!     capture, charged by the delegates as memory is captured. If this is
+  //!     `nullptr`, nothing is captured.
+  //! \param[in] time_limit_ns The longest time to spend capturing memory.
+  //!
+  //! \return `false` if capture stopped because the time limit elapsed, with
+  //!     a message logged. `true` otherwise.
+  bool Capture(const uint32_t* budget_remaining, uint64_t time_limit_ns);
+
+  //! \return The number of candidates not yet visited.
+  size_t size() const { return candidates_.size(); }
+
+ private:
+  enum class Tier : uint8_t {
+    kExceptionThreadRegisters = 0,
+    kExceptionThreadStack,
+    kRegisters,
+    kStack,
+  };
+
+  struct Candidate {
+    Tier tier;
+    uint64_t distance;
+    uint64_t sequence;
+    uint64_t address;
+    CaptureMemory::Delegate* delegate;
+  };
+
+  struct CandidateAfter {
+    bool operator()(const Candidate& a, const Candidate& b) const;
+  };
+
+  void AddCandidate(Tier tier,
+                    uint64_t distance,
+                    uint64_t address,
+                    CaptureMemory::Delegate* delegate);
+
+  std::priority_queue<Candidate, std::vector<Candidate>, CandidateAfter>
+      candidates_;
+  uint64_t next_sequence_;
 };
 
 }  // namespace internal
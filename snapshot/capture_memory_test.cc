@@ -0,0 +1,403 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/capture_memory.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/memory_snapshot_generic.h"
+#include "snapshot/test/test_memory_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::CaptureMemory;
+using internal::MemorySnapshotGeneric;
+using internal::PrioritizedCaptureMemory;
+
+// A delegate for which everything but a single range is readable.
+class TestDelegate : public CaptureMemory::Delegate {
+ public:
+  explicit TestDelegate(const CheckedRange<uint64_t>& unreadable)
+      : unreadable_(unreadable) {}
+
+  bool Is64Bit() const override { return true; }
+
+  bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override {
+    return false;
+  }
+
+  std::vector<CheckedRange<uint64_t>> GetReadableRanges(
+      const CheckedRange<uint64_t, uint64_t>& range) const override {
+    if (!range.OverlapsRange(unreadable_)) {
+      return {range};
+    }
+    std::vector<CheckedRange<uint64_t>> ranges;
+    if (range.base() < unreadable_.base()) {
+      ranges.emplace_back(range.base(), unreadable_.base() - range.base());
+    }
+    if (range.end() > unreadable_.end()) {
+      ranges.emplace_back(unreadable_.end(), range.end() - unreadable_.end());
+    }
+    return ranges;
+  }
+
+  void AddNewMemorySnapshot(
+      const CheckedRange<uint64_t, uint64_t>& range) override {
+    CaptureMemory::AddCoalescedMemorySnapshot(
+        nullptr, range, kMaxGap, *this, &snapshots, &budget_remaining);
+  }
+
+  static constexpr uint64_t kMaxGap = 64;
+
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> snapshots;
+  uint32_t budget_remaining = 0x10000;
+
+ private:
+  CheckedRange<uint64_t> unreadable_;
+};
+
+TEST(CaptureMemory, AddCoalescedMemorySnapshot) {
+  TestDelegate delegate(CheckedRange<uint64_t>(0x9000, 0x100));
+
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1000, 0x100));
+  ASSERT_EQ(delegate.snapshots.size(), 1u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x100);
+
+  // A range already captured is neither added nor charged.
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1010, 0x20));
+  ASSERT_EQ(delegate.snapshots.size(), 1u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x100);
+
+  // An overlapping range extends the existing snapshot.
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x10f0, 0x20));
+  ASSERT_EQ(delegate.snapshots.size(), 1u);
+  EXPECT_EQ(delegate.snapshots[0]->Address(), 0x1000u);
+  EXPECT_EQ(delegate.snapshots[0]->Size(), 0x110u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x110);
+
+  // A nearby range is merged, including the gap.
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x0f00, 0xe0));
+  ASSERT_EQ(delegate.snapshots.size(), 1u);
+  EXPECT_EQ(delegate.snapshots[0]->Address(), 0x0f00u);
+  EXPECT_EQ(delegate.snapshots[0]->Size(), 0x210u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x210);
+
+  // A range farther away than max_gap gets its own snapshot.
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1200, 0x100));
+  ASSERT_EQ(delegate.snapshots.size(), 2u);
+  EXPECT_EQ(delegate.snapshots[1]->Address(), 0x1200u);
+  EXPECT_EQ(delegate.snapshots[1]->Size(), 0x100u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x310);
+}
+
+TEST(CaptureMemory, AddCoalescedMemorySnapshotSorted) {
+  TestDelegate delegate(CheckedRange<uint64_t>(0, 0));
+
+  // Snapshots are kept in address order however ranges arrive, and a range is
+  // merged with its neighbor on either side.
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x5000, 0x100));
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1000, 0x100));
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x3000, 0x100));
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x3120, 0x20));
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x4f00, 0xe0));
+  ASSERT_EQ(delegate.snapshots.size(), 3u);
+  EXPECT_EQ(delegate.snapshots[0]->Address(), 0x1000u);
+  EXPECT_EQ(delegate.snapshots[1]->Address(), 0x3000u);
+  EXPECT_EQ(delegate.snapshots[1]->Size(), 0x140u);
+  EXPECT_EQ(delegate.snapshots[2]->Address(), 0x4f00u);
+  EXPECT_EQ(delegate.snapshots[2]->Size(), 0x200u);
+
+  // Nothing new is returned for a range that's already captured.
+  EXPECT_FALSE(CaptureMemory::AddCoalescedMemorySnapshot(
+      nullptr,
+      CheckedRange<uint64_t>(0x3010, 0x10),
+      TestDelegate::kMaxGap,
+      delegate,
+      &delegate.snapshots,
+      &delegate.budget_remaining));
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x440);
+}
+
+TEST(CaptureMemory, AddCoalescedMemorySnapshotUnreadableGap) {
+  TestDelegate delegate(CheckedRange<uint64_t>(0x1100, 0x10));
+
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1000, 0x100));
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1110, 0x100));
+  ASSERT_EQ(delegate.snapshots.size(), 2u);
+  EXPECT_EQ(delegate.snapshots[0]->Size(), 0x100u);
+  EXPECT_EQ(delegate.snapshots[1]->Address(), 0x1110u);
+  EXPECT_EQ(delegate.budget_remaining, 0x10000u - 0x200);
+}
+
+TEST(CaptureMemory, AddCoalescedMemorySnapshotBudget) {
+  TestDelegate delegate(CheckedRange<uint64_t>(0, 0));
+  delegate.budget_remaining = 0x80;
+
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x1000, 0x100));
+  ASSERT_EQ(delegate.snapshots.size(), 1u);
+  EXPECT_EQ(delegate.budget_remaining, 0u);
+
+  delegate.AddNewMemorySnapshot(CheckedRange<uint64_t>(0x2000, 0x100));
+  EXPECT_EQ(delegate.snapshots.size(), 1u);
+}
+
+// A delegate for a thread with a stack of pointer-sized words at stack_base.
+// Everything is readable, and captured ranges are appended to a log shared
+// with other threads' delegates.
+class StackDelegate : public CaptureMemory::Delegate {
+ public:
+  StackDelegate(uint64_t stack_base,
+                const std::vector<uint64_t>& stack,
+                std::vector<uint64_t>* captured,
+                uint32_t* budget_remaining)
+      : stack_base_(stack_base),
+        stack_(stack),
+        captured_(captured),
+        budget_remaining_(budget_remaining),
+        bounds_low_(0),
+        bounds_high_(0),
+        largest_read_(0) {}
+
+  bool Is64Bit() const override { return true; }
+
+  bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override {
+    if (at < stack_base_ ||
+        at + num_bytes > stack_base_ + stack_.size() * sizeof(uint64_t)) {
+      return false;
+    }
+    largest_read_ = std::max(largest_read_, num_bytes);
+    memcpy(into,
+           reinterpret_cast<const uint8_t*>(stack_.data()) + (at - stack_base_),
+           num_bytes);
+    return true;
+  }
+
+  std::vector<CheckedRange<uint64_t>> GetReadableRanges(
+      const CheckedRange<uint64_t, uint64_t>& range) const override {
+    return {range};
+  }
+
+  void AddNewMemorySnapshot(
+      const CheckedRange<uint64_t, uint64_t>& range) override {
+    // Record the pointer that the range was captured around.
+    captured_->push_back(range.base() + 128);
+    *budget_remaining_ -= std::min(*budget_remaining_,
+                                   static_cast<uint32_t>(range.size()));
+  }
+
+  bool GetAddressBounds(uint64_t* low, uint64_t* high) const override {
+    if (bounds_low_ >= bounds_high_) {
+      return false;
+    }
+    *low = bounds_low_;
+    *high = bounds_high_;
+    return true;
+  }
+
+  void SetAddressBounds(uint64_t low, uint64_t high) {
+    bounds_low_ = low;
+    bounds_high_ = high;
+  }
+
+  uint64_t largest_read() const { return largest_read_; }
+
+  test::TestMemorySnapshot* stack_snapshot() {
+    stack_snapshot_.SetAddress(stack_base_);
+    stack_snapshot_.SetSize(stack_.size() * sizeof(uint64_t));
+    return &stack_snapshot_;
+  }
+
+ private:
+  test::TestMemorySnapshot stack_snapshot_;
+  uint64_t stack_base_;
+  std::vector<uint64_t> stack_;
+  std::vector<uint64_t>* captured_;
+  uint32_t* budget_remaining_;
+  uint64_t bounds_low_;
+  uint64_t bounds_high_;
+  mutable uint64_t largest_read_;
+};
+
+TEST(CaptureMemory, PointedToByMemoryRangeAddressBounds) {
+  constexpr uint64_t kLow = 0x100000;
+  constexpr uint64_t kHigh = 0x200000;
+
+  // Enough words for a few blocks of them to be tested together, with
+  // candidates in some blocks, none in others, and in the trailing words.
+  std::vector<uint64_t> stack(8 * 3 + 3, 0x4142434445464748);
+  stack[0] = kLow;
+  stack[3] = kLow - 384;
+  stack[4] = kLow - 383;
+  stack[5] = 5;
+  stack[20] = kHigh + 127;
+  stack[21] = kHigh + 128;
+  stack[25] = kHigh - 1;
+
+  std::vector<uint64_t> captured;
+  uint32_t budget_remaining = 0x10000;
+  constexpr uint64_t kStack = 0x10000000;
+  StackDelegate thread(kStack, stack, &captured, &budget_remaining);
+
+  // Without bounds, every pointer-like value is captured around.
+  CaptureMemory::PointedToByMemoryRange(*thread.stack_snapshot(), &thread);
+  EXPECT_EQ(captured.size(), stack.size() - 1);
+
+  // With bounds, only values whose captured range would overlap them are.
+  captured.clear();
+  thread.SetAddressBounds(kLow, kHigh);
+  CaptureMemory::PointedToByMemoryRange(*thread.stack_snapshot(), &thread);
+  const std::vector<uint64_t> expected = {
+      kLow, kLow - 383, kHigh + 127, kHigh - 1};
+  EXPECT_EQ(captured, expected);
+}
+
+TEST(CaptureMemory, PointedToByMemoryRangeLarge) {
+  // A range several times larger than the size read at once, with pointers on
+  // either side of the boundaries between reads.
+  constexpr size_t kWords = 4 * 256 * 1024 / sizeof(uint64_t) + 5;
+  std::vector<uint64_t> stack(kWords, 0x4142434445464748);
+  const std::vector<size_t> pointer_indices = {
+      0, 32767, 32768, 65535, 65536, kWords - 1};
+  std::vector<uint64_t> expected;
+  for (size_t index : pointer_indices) {
+    stack[index] = 0x100000 + index * 0x1000;
+    expected.push_back(stack[index]);
+  }
+
+  std::vector<uint64_t> captured;
+  uint32_t budget_remaining = 0x10000;
+  StackDelegate thread(0x10000000, stack, &captured, &budget_remaining);
+  thread.SetAddressBounds(0x100000, 0x100000 + kWords * 0x1000);
+  CaptureMemory::PointedToByMemoryRange(*thread.stack_snapshot(), &thread);
+
+  EXPECT_EQ(captured, expected);
+  EXPECT_LE(thread.largest_read(), 256u * 1024);
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+TEST(PrioritizedCaptureMemory, CapturesInPriorityOrder) {
+  std::vector<uint64_t> captured;
+  uint32_t budget_remaining = 0x10000;
+
+  constexpr uint64_t kOtherStack = 0x10000000;
+  StackDelegate other_thread(kOtherStack,
+                             {0x300000, 5, 0x310000, 0x300000},
+                             &captured,
+                             &budget_remaining);
+  CPUContextX86_64 other_context_x86_64 = {};
+  other_context_x86_64.rip = 0x200000;
+  other_context_x86_64.rsp = kOtherStack;
+  CPUContext other_context;
+  other_context.architecture = kCPUArchitectureX86_64;
+  other_context.x86_64 = &other_context_x86_64;
+
+  constexpr uint64_t kExceptionStack = 0x20000000;
+  StackDelegate exception_thread(kExceptionStack,
+                                 {0x100000, 0x110000},
+                                 &captured,
+                                 &budget_remaining);
+  CPUContextX86_64 exception_context_x86_64 = {};
+  exception_context_x86_64.rip = 0x120000;
+  exception_context_x86_64.rsp = kExceptionStack + sizeof(uint64_t);
+  CPUContext exception_context;
+  exception_context.architecture = kCPUArchitectureX86_64;
+  exception_context.x86_64 = &exception_context_x86_64;
+
+  // Candidates from other threads are added first, but captured last.
+  PrioritizedCaptureMemory capture;
+  capture.AddContext(other_context, false, &other_thread);
+  capture.AddStack(*other_thread.stack_snapshot(),
+                   other_context.StackPointer(),
+                   false,
+                   &other_thread);
+  capture.AddStack(*exception_thread.stack_snapshot(),
+                   exception_context.StackPointer(),
+                   true,
+                   &exception_thread);
+  capture.AddContext(exception_context, true, &exception_thread);
+
+  EXPECT_EQ(capture.size(), 7u);
+  EXPECT_TRUE(capture.Capture(
+      &budget_remaining,
+      PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds));
+  EXPECT_EQ(capture.size(), 0u);
+
+  // Each address is captured once per thread.
+  const std::vector<uint64_t> expected = {
+      0x120000, 0x110000, 0x100000, 0x200000, 0x300000, 0x310000};
+  EXPECT_EQ(captured, expected);
+}
+#endif  // ARCH_CPU_X86_FAMILY
+
+TEST(PrioritizedCaptureMemory, StopsAtBudget) {
+  std::vector<uint64_t> captured;
+  uint32_t budget_remaining = 1024;
+
+  constexpr uint64_t kStack = 0x10000000;
+  StackDelegate thread(kStack,
+                       {0x100000, 0x200000, 0x300000, 0x400000},
+                       &captured,
+                       &budget_remaining);
+
+  PrioritizedCaptureMemory capture;
+  capture.AddStack(*thread.stack_snapshot(), kStack, false, &thread);
+  EXPECT_TRUE(capture.Capture(
+      &budget_remaining,
+      PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds));
+
+  // Each capture costs 512 bytes.
+  const std::vector<uint64_t> expected = {0x100000, 0x200000};
+  EXPECT_EQ(captured, expected);
+  EXPECT_EQ(budget_remaining, 0u);
+  EXPECT_EQ(capture.size(), 2u);
+}
+
+TEST(PrioritizedCaptureMemory, StopsAtTimeLimit) {
+  std::vector<uint64_t> captured;
+  uint32_t budget_remaining = 0x10000;
+
+  constexpr uint64_t kStack = 0x10000000;
+  StackDelegate thread(
+      kStack, {0x100000, 0x200000}, &captured, &budget_remaining);
+
+  PrioritizedCaptureMemory capture;
+  capture.AddStack(*thread.stack_snapshot(), kStack, false, &thread);
+  EXPECT_FALSE(capture.Capture(&budget_remaining, 0));
+  EXPECT_TRUE(captured.empty());
+  EXPECT_EQ(capture.size(), 2u);
+
+  // The remaining candidates can still be captured.
+  EXPECT_TRUE(
+      capture.Capture(&budget_remaining, std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ(captured.size(), 2u);
+
+  // Nothing is captured without a budget.
+  capture.AddStack(*thread.stack_snapshot(), kStack, false, &thread);
+  EXPECT_TRUE(capture.Capture(
+      nullptr, PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds));
+  EXPECT_EQ(captured.size(), 2u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -413,6 +413,13 @@ struct CPUContext {
     CPUContextMIPS64* mips64;
     CPUContextRISCV64* riscv64;
   };
+
+  //! \brief Whether the floating-point and vector registers in the context
+  //!     structure were captured.
+  //!
+  //! When `false`, those registers are zero, and reports mark them as missing
+  //! rather than recording their values.
+  bool has_floating_point = true;
 };
 
 }  // namespace crashpad
@@ -53,6 +53,10 @@ struct TestCrashpadInfo {
 #if !defined(CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL)
   void* user_data_minidump_stream_head_;
   void* annotations_list_;
+  void* thread_breadcrumbs_;
+  void* indexed_simple_annotations_;
+  void* capture_hints_;
+  void* indexed_extra_memory_ranges_;
 #endif  // CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL
 #if defined(CRASHPAD_INFO_SIZE_TEST_MODULE_LARGE)
   uint8_t trailer_[64 * 1024];
@@ -95,6 +99,10 @@ TestCrashpadInfo g_test_crashpad_info = {'CPad',
 #if !defined(CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL)
                                          nullptr,
                                          nullptr,
+                                         nullptr,
+                                         nullptr,
+                                         nullptr,
+                                         nullptr,
 #endif  // CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL
 #if defined(CRASHPAD_INFO_SIZE_TEST_MODULE_LARGE)
                                          {}
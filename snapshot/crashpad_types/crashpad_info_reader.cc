@@ -114,6 +114,10 @@ class CrashpadInfoReader::InfoContainerSpecific : public InfoContainer {
     typename Traits::Address simple_annotations;
     typename Traits::Address user_data_minidump_stream_head;
     typename Traits::Address annotations_list;
+    typename Traits::Address thread_breadcrumbs;
+    typename Traits::Address indexed_simple_annotations;
+    typename Traits::Address capture_hints;
+    typename Traits::Address indexed_extra_memory_ranges;
   } info;
 
 #if defined(ARCH_CPU_64_BITS)
@@ -187,6 +191,18 @@ DEFINE_GETTER(VMAddress, SimpleAnnotations, simple_annotations)
 
 DEFINE_GETTER(VMAddress, AnnotationsList, annotations_list)
 
+DEFINE_GETTER(VMAddress, ThreadBreadcrumbs, thread_breadcrumbs)
+
+DEFINE_GETTER(VMAddress,
+              IndexedSimpleAnnotations,
+              indexed_simple_annotations)
+
+DEFINE_GETTER(VMAddress, CaptureHints, capture_hints)
+
+DEFINE_GETTER(VMAddress,
+              IndexedExtraMemoryRanges,
+              indexed_extra_memory_ranges)
+
 DEFINE_GETTER(VMAddress,
               UserDataMinidumpStreamHead,
               user_data_minidump_stream_head)
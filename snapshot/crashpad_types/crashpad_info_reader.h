@@ -57,6 +57,10 @@ class CrashpadInfoReader {
   VMAddress ExtraMemoryRanges();
   VMAddress SimpleAnnotations();
   VMAddress AnnotationsList();
+  VMAddress ThreadBreadcrumbs();
+  VMAddress IndexedSimpleAnnotations();
+  VMAddress CaptureHints();
+  VMAddress IndexedExtraMemoryRanges();
   VMAddress UserDataMinidumpStreamHead();
   //! \}
 
@@ -21,6 +21,7 @@
 #include "build/build_config.h"
 #include "client/annotation_list.h"
 #include "client/crashpad_info.h"
+#include "client/indexed_address_range_bag.h"
 #include "client/simple_address_range_bag.h"
 #include "client/simple_string_dictionary.h"
 #include "gtest/gtest.h"
@@ -60,6 +61,9 @@ class ScopedUnsetCrashpadInfo {
     crashpad_info_->set_extra_memory_ranges(nullptr);
     crashpad_info_->set_simple_annotations(nullptr);
     crashpad_info_->set_annotations_list(nullptr);
+    crashpad_info_->set_capture_hints(nullptr);
+    crashpad_info_->set_indexed_extra_memory_ranges(
+        static_cast<IndexedAddressRangeBag*>(nullptr));
   }
 
  private:
@@ -228,6 +232,97 @@ TEST(CrashpadInfoReader, ReadFromChild) {
   test.Run();
 }
 
+TEST(CrashpadInfoReader, CaptureHints) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  static const char kCopy[] = "copy";
+  static const char kSkip[] = "skip";
+  CaptureHints hints;
+  ASSERT_TRUE(hints.AddCopyRange(kCopy, sizeof(kCopy)));
+  ASSERT_TRUE(hints.AddSkipRange(kSkip, sizeof(kSkip)));
+  hints.set_skip_annotations(true);
+  hints.set_max_stack_bytes_per_thread(4096);
+
+  CrashpadInfo* info = CrashpadInfo::GetCrashpadInfo();
+  ScopedUnsetCrashpadInfo unset(info);
+  info->set_capture_hints(&hints);
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  CrashpadInfoReader reader;
+  ASSERT_TRUE(reader.Initialize(&range, FromPointerCast<VMAddress>(info)));
+  ASSERT_EQ(reader.CaptureHints(), FromPointerCast<VMAddress>(&hints));
+
+  CaptureHints read_hints;
+  ASSERT_TRUE(
+      range.Read(reader.CaptureHints(), sizeof(read_hints), &read_hints));
+  ASSERT_TRUE(read_hints.IsValid());
+  EXPECT_TRUE(read_hints.skip_annotations());
+  EXPECT_EQ(read_hints.max_stack_bytes_per_thread(), 4096u);
+  ASSERT_EQ(read_hints.copy_range_count(), 1u);
+  EXPECT_EQ(read_hints.copy_range(0).base, FromPointerCast<uint64_t>(kCopy));
+  EXPECT_EQ(read_hints.copy_range(0).size, sizeof(kCopy));
+  ASSERT_EQ(read_hints.skip_range_count(), 1u);
+  EXPECT_EQ(read_hints.skip_range(0).base, FromPointerCast<uint64_t>(kSkip));
+  EXPECT_EQ(read_hints.skip_range(0).size, sizeof(kSkip));
+}
+
+TEST(CrashpadInfoReader, IndexedExtraMemoryRanges) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  TIndexedAddressRangeBag<4096> bag;
+  for (uint64_t index = 0; index < 3000; ++index) {
+    ASSERT_TRUE(bag.Insert(CheckedRange<uint64_t>(index * 0x1000, 0x100)));
+  }
+
+  CrashpadInfo* info = CrashpadInfo::GetCrashpadInfo();
+  ScopedUnsetCrashpadInfo unset(info);
+  info->set_indexed_extra_memory_ranges(&bag);
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  CrashpadInfoReader reader;
+  ASSERT_TRUE(reader.Initialize(&range, FromPointerCast<VMAddress>(info)));
+  ASSERT_EQ(reader.IndexedExtraMemoryRanges(),
+            FromPointerCast<VMAddress>(bag.header()));
+
+  crashpad::internal::IndexedAddressRangeBagHeader header;
+  ASSERT_TRUE(range.Read(
+      reader.IndexedExtraMemoryRanges(), sizeof(header), &header));
+  EXPECT_EQ(header.magic,
+            crashpad::internal::IndexedAddressRangeBagHeader::kMagic);
+  EXPECT_EQ(header.num_entries, 4096u);
+  EXPECT_EQ(header.used_entries, 3000u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
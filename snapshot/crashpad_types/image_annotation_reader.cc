@@ -17,6 +17,8 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <stddef.h>
+
 #include <algorithm>
 #include <utility>
 
@@ -24,8 +26,10 @@
 #include "build/build_config.h"
 #include "client/annotation.h"
 #include "client/annotation_list.h"
+#include "client/indexed_simple_string_dictionary.h"
 #include "client/simple_string_dictionary.h"
 #include "snapshot/snapshot_constants.h"
+#include "util/synchronization/seqlock.h"
 #if BUILDFLAG(IS_FUCHSIA)
 #include "util/fuchsia/traits.h"
 #else
@@ -44,9 +48,14 @@ struct Annotation {
   uint32_t size;
   uint16_t type;
   crashpad::Annotation::ConcurrentAccessGuardMode concurrent_access_guard_mode;
-  bool spin_guard_state;
+  // The SpinGuardState or SeqlockState, depending on
+  // concurrent_access_guard_mode.
+  uint8_t guard_state;
 };
 
+// The leading members of AnnotationList, which are common to every version of
+// the client. When head.value is not 0, it is the address of the first
+// AnnotationListBlock.
 template <class Traits>
 struct AnnotationList {
   typename Traits::Address tail_pointer;
@@ -54,6 +63,14 @@ struct AnnotationList {
   Annotation<Traits> tail;
 };
 
+template <class Traits>
+struct AnnotationListBlock {
+  typename Traits::Address next;
+  typename Traits::Address
+      annotations[crashpad::AnnotationList::Block::kCapacity];
+  uint32_t used;
+};
+
 }  // namespace process_types
 
 #if defined(ARCH_CPU_64_BITS)
@@ -66,12 +83,157 @@ static_assert(sizeof(process_types::Annotation<NATIVE_TRAITS>) ==
                   sizeof(Annotation),
               "Annotation size mismatch");
 
-static_assert(sizeof(process_types::AnnotationList<NATIVE_TRAITS>) ==
-                  sizeof(AnnotationList),
-              "AnnotationList size mismatch");
+static_assert(sizeof(process_types::AnnotationListBlock<NATIVE_TRAITS>) ==
+                  sizeof(AnnotationList::Block),
+              "AnnotationList::Block size mismatch");
+
+// AnnotationList is followed by its first block and the current block pointer.
+static_assert(
+    sizeof(process_types::AnnotationList<NATIVE_TRAITS>) +
+            sizeof(process_types::AnnotationListBlock<NATIVE_TRAITS>) +
+            sizeof(NATIVE_TRAITS::Address) ==
+        sizeof(AnnotationList),
+    "AnnotationList size mismatch");
 
 #undef NATIVE_TRAITS
 
+namespace {
+
+// Annotation names are read in a batch with a fixed size, clipped so that the
+// read never extends into a following page, which may not be mapped.
+constexpr VMSize kNameReadPageSize = 4096;
+
+VMSize NameReadSize(VMAddress address) {
+  return std::min(VMSize{Annotation::kNameMaxLength},
+                  kNameReadPageSize - address % kNameReadPageSize);
+}
+
+// The number of times to re-read a seqlock-guarded annotation whose sequence
+// changed while its value was being read. The target is normally suspended, so
+// this only matters for a writer that was running when the process was read.
+constexpr int kSeqlockReadAttempts = 3;
+
+// Checks that the value read into |snapshot| for the seqlock-guarded |object|
+// at |address| is consistent, re-reading it if the sequence shows that it was
+// being written. Returns false if no consistent value could be read, including
+// when the process stopped in the middle of a write.
+template <class Traits>
+bool ValidateSeqlockAnnotation(const ProcessMemoryRange* memory,
+                               VMAddress address,
+                               const process_types::Annotation<Traits>& object,
+                               AnnotationSnapshot* snapshot) {
+  using AnnotationType = process_types::Annotation<Traits>;
+  uint8_t sequence = object.guard_state;
+  for (int attempt = 0; attempt < kSeqlockReadAttempts; ++attempt) {
+    uint8_t current_sequence;
+    if (!memory->Read(address + offsetof(AnnotationType, guard_state),
+                      sizeof(current_sequence),
+                      &current_sequence)) {
+      return false;
+    }
+    if (current_sequence == sequence && SeqlockState::IsStable(sequence)) {
+      return true;
+    }
+
+    AnnotationType current;
+    if (!memory->Read(address, sizeof(current), &current)) {
+      return false;
+    }
+    sequence = current.guard_state;
+    if (!SeqlockState::IsStable(sequence)) {
+      continue;
+    }
+    if (current.size == 0) {
+      return false;
+    }
+    snapshot->value.resize(
+        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize));
+    if (!memory->Read(
+            current.value, snapshot->value.size(), snapshot->value.data())) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// Reads the names and values of those of |objects|, which were read from
+// |addresses|, that are set, issuing all of the reads as one batch.
+template <class Traits>
+void ReadAnnotationContents(
+    const ProcessMemoryRange* memory,
+    const std::vector<process_types::Annotation<Traits>>& objects,
+    const std::vector<VMAddress>& addresses,
+    std::vector<AnnotationSnapshot>* annotations) {
+  std::vector<AnnotationSnapshot> snapshots;
+  std::vector<const process_types::Annotation<Traits>*> set_objects;
+  std::vector<VMAddress> set_addresses;
+  for (size_t index = 0; index < objects.size(); ++index) {
+    const process_types::Annotation<Traits>& object = objects[index];
+    if (object.size == 0) {
+      continue;
+    }
+
+    AnnotationSnapshot snapshot;
+    snapshot.type = object.type;
+    snapshot.name.resize(NameReadSize(object.name));
+    snapshot.value.resize(
+        std::min(static_cast<size_t>(object.size), Annotation::kValueMaxSize));
+    snapshots.push_back(std::move(snapshot));
+    set_objects.push_back(&object);
+    set_addresses.push_back(addresses[index]);
+  }
+
+  std::vector<ProcessMemory::ReadRequest> requests;
+  requests.reserve(snapshots.size() * 2);
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    AnnotationSnapshot& snapshot = snapshots[index];
+    requests.push_back(
+        {set_objects[index]->name, snapshot.name.size(), snapshot.name.data()});
+    requests.push_back({set_objects[index]->value,
+                        snapshot.value.size(),
+                        snapshot.value.data()});
+  }
+  const bool batch_read = memory->ReadBatch(requests);
+
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    AnnotationSnapshot& snapshot = snapshots[index];
+    const process_types::Annotation<Traits>& object = *set_objects[index];
+
+    size_t name_length = batch_read ? strnlen(snapshot.name.data(),
+                                              snapshot.name.size())
+                                    : snapshot.name.size();
+    if (name_length < snapshot.name.size()) {
+      snapshot.name.resize(name_length);
+    } else if (!memory->ReadCStringSizeLimited(
+                   object.name, Annotation::kNameMaxLength, &snapshot.name)) {
+      // The name was not terminated within the batched read, either because it
+      // was clipped at a page boundary or because the batch failed.
+      LOG(WARNING) << "could not read annotation name";
+      continue;
+    }
+
+    if (!batch_read && !memory->Read(object.value,
+                                     snapshot.value.size(),
+                                     snapshot.value.data())) {
+      LOG(WARNING) << "could not read annotation value";
+      continue;
+    }
+
+    if (object.concurrent_access_guard_mode ==
+            Annotation::ConcurrentAccessGuardMode::kSeqlock &&
+        !ValidateSeqlockAnnotation(
+            memory, set_addresses[index], object, &snapshot)) {
+      LOG(WARNING) << "annotation " << snapshot.name
+                   << " was being written, skipping";
+      continue;
+    }
+
+    annotations->push_back(std::move(snapshot));
+  }
+}
+
+}  // namespace
+
 ImageAnnotationReader::ImageAnnotationReader(const ProcessMemoryRange* memory)
     : memory_(memory) {}
 
@@ -102,6 +264,58 @@ bool ImageAnnotationReader::SimpleMap(
   return true;
 }
 
+bool ImageAnnotationReader::IndexedSimpleMap(
+    VMAddress address,
+    std::map<std::string, std::string>* annotations) const {
+  // Limits on the layout of a dictionary that will be read, chosen to be
+  // generous for any reasonable instantiation of
+  // TIndexedSimpleStringDictionary.
+  constexpr uint32_t kMaxStringSize = 64 * 1024;
+  constexpr size_t kMaxEntriesSize = 4 * 1024 * 1024;
+
+  internal::IndexedSimpleStringDictionaryHeader header;
+  if (!memory_->Read(address, sizeof(header), &header)) {
+    LOG(ERROR) << "could not read indexed simple annotations";
+    return false;
+  }
+
+  if (header.magic !=
+          internal::IndexedSimpleStringDictionaryHeader::kMagic ||
+      header.version !=
+          internal::IndexedSimpleStringDictionaryHeader::kVersion) {
+    LOG(ERROR) << "unexpected indexed simple annotations header";
+    return false;
+  }
+
+  const size_t entry_size = size_t{header.key_size} + header.value_size;
+  if (header.key_size == 0 || header.key_size > kMaxStringSize ||
+      header.value_size == 0 || header.value_size > kMaxStringSize ||
+      header.used_entries > header.num_entries ||
+      header.used_entries > kMaxEntriesSize / entry_size) {
+    LOG(ERROR) << "invalid indexed simple annotations layout";
+    return false;
+  }
+
+  std::vector<char> entries(header.used_entries * entry_size);
+  if (!memory_->Read(
+          address + sizeof(header), entries.size(), entries.data())) {
+    LOG(ERROR) << "could not read indexed simple annotation entries";
+    return false;
+  }
+
+  for (size_t index = 0; index < header.used_entries; ++index) {
+    const char* key = &entries[index * entry_size];
+    const char* value = key + header.key_size;
+    size_t key_length = strnlen(key, header.key_size);
+    if (key_length) {
+      annotations->insert(std::make_pair(
+          std::string(key, key_length),
+          std::string(value, strnlen(value, header.value_size))));
+    }
+  }
+  return true;
+}
+
 bool ImageAnnotationReader::AnnotationsList(
     VMAddress address,
     std::vector<AnnotationSnapshot>* annotations) const {
@@ -120,39 +334,90 @@ bool ImageAnnotationReader::ReadAnnotationList(
     return false;
   }
 
+  // Gather the annotation objects first, so that their names and values can
+  // all be read together.
+  std::vector<process_types::Annotation<Traits>> objects;
+
+  if (annotation_list.head.value) {
+    std::vector<VMAddress> annotation_addresses;
+    if (ReadAnnotationRegistry<Traits>(annotation_list.head.value,
+                                       &annotation_addresses)) {
+      objects.resize(annotation_addresses.size());
+      std::vector<ProcessMemory::ReadRequest> requests;
+      requests.reserve(annotation_addresses.size());
+      for (size_t index = 0; index < annotation_addresses.size(); ++index) {
+        requests.push_back({annotation_addresses[index],
+                            sizeof(objects[index]),
+                            &objects[index]});
+      }
+      if (!memory_->ReadBatch(requests)) {
+        LOG(ERROR) << "could not read annotations";
+        return false;
+      }
+
+      ReadAnnotationContents(
+          memory_, objects, annotation_addresses, annotations);
+      return true;
+    }
+    LOG(WARNING) << "falling back to annotation list traversal";
+  }
+
+  bool success = true;
+  std::vector<VMAddress> addresses;
   process_types::Annotation<Traits> current = annotation_list.head;
   for (size_t index = 0; current.link_node != annotation_list.tail_pointer &&
                          index < kMaxNumberOfAnnotations;
        ++index) {
-    if (!memory_->Read(current.link_node, sizeof(current), &current)) {
+    const VMAddress address = current.link_node;
+    if (!memory_->Read(address, sizeof(current), &current)) {
       LOG(ERROR) << "could not read annotation at index " << index;
-      return false;
+      success = false;
+      break;
     }
+    objects.push_back(current);
+    addresses.push_back(address);
+  }
 
-    if (current.size == 0) {
-      continue;
-    }
+  ReadAnnotationContents(memory_, objects, addresses, annotations);
+  return success;
+}
 
-    AnnotationSnapshot snapshot;
-    snapshot.type = current.type;
+template <class Traits>
+bool ImageAnnotationReader::ReadAnnotationRegistry(
+    VMAddress address,
+    std::vector<VMAddress>* annotation_addresses) const {
+  constexpr size_t kCapacity = AnnotationList::Block::kCapacity;
+  constexpr size_t kMaxBlocks =
+      (kMaxNumberOfAnnotations + kCapacity - 1) / kCapacity;
 
-    if (!memory_->ReadCStringSizeLimited(
-            current.name, Annotation::kNameMaxLength, &snapshot.name)) {
-      LOG(WARNING) << "could not read annotation name at index " << index;
-      continue;
+  VMAddress block_address = address;
+  for (size_t block_index = 0;
+       block_address && block_index < kMaxBlocks &&
+       annotation_addresses->size() < kMaxNumberOfAnnotations;
+       ++block_index) {
+    process_types::AnnotationListBlock<Traits> block;
+    if (!memory_->Read(block_address, sizeof(block), &block)) {
+      LOG(ERROR) << "could not read annotation block " << block_index;
+      return false;
     }
 
-    size_t value_length =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
-    snapshot.value.resize(value_length);
-    if (!memory_->Read(current.value, value_length, snapshot.value.data())) {
-      LOG(WARNING) << "could not read annotation value at index " << index;
-      continue;
+    size_t used = std::min(static_cast<size_t>(block.used), kCapacity);
+    for (size_t slot = 0;
+         slot < used && annotation_addresses->size() < kMaxNumberOfAnnotations;
+         ++slot) {
+      // A slot may have been claimed by a thread that had not yet stored its
+      // annotation.
+      if (block.annotations[slot]) {
+        annotation_addresses->push_back(block.annotations[slot]);
+      }
     }
 
-    annotations->push_back(std::move(snapshot));
+    block_address = block.next;
   }
 
+  // The registry is in the order in which annotations were added. Report them
+  // most recent first, as the linked list does.
+  std::reverse(annotation_addresses->begin(), annotation_addresses->end());
   return true;
 }
 
@@ -52,6 +52,22 @@ class ImageAnnotationReader {
   bool SimpleMap(VMAddress address,
                  std::map<std::string, std::string>* annotations) const;
 
+  //! \brief Reads annotations that are organized as key-value pairs in a
+  //!     TIndexedSimpleStringDictionary, where all keys and values are
+  //!     strings.
+  //!
+  //! Only the populated entries of the dictionary are read.
+  //!
+  //! \param[in] address The address in the target process' address space of
+  //!     the IndexedSimpleStringDictionaryHeader of the dictionary containing
+  //!     the annotations to read.
+  //! \param[out] annotations The annotations read, valid if this method
+  //!     returns `true`. Keys already present in \a annotations are not
+  //!     replaced.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool IndexedSimpleMap(VMAddress address,
+                        std::map<std::string, std::string>* annotations) const;
+
   //! \brief Reads the module's annotations that are organized as a list of
   //!     typed annotation objects.
   //!
@@ -68,6 +84,13 @@ class ImageAnnotationReader {
   bool ReadAnnotationList(VMAddress address,
                           std::vector<AnnotationSnapshot>* annotations) const;
 
+  // Collects the addresses of the annotations in the registry whose first
+  // block is at |address|, most recently added first.
+  template <class Traits>
+  bool ReadAnnotationRegistry(
+      VMAddress address,
+      std::vector<VMAddress>* annotation_addresses) const;
+
   const ProcessMemoryRange* memory_;  // weak
 };
 
@@ -19,10 +19,13 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <set>
+#include <string>
 
 #include "build/build_config.h"
 #include "client/annotation.h"
 #include "client/annotation_list.h"
+#include "client/indexed_simple_string_dictionary.h"
 #include "client/simple_string_dictionary.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
@@ -31,6 +34,8 @@
 #include "util/misc/as_underlying_type.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/process/process_memory_native.h"
+#include "util/synchronization/seqlock.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 #include "test/linux/fake_ptrace_connection.h"
@@ -141,6 +146,207 @@ TEST(ImageAnnotationReader, ReadFromSelf) {
                     FromPointerCast<VMAddress>(&annotations));
 }
 
+class AddAnnotationsThread : public Thread {
+ public:
+  static constexpr Annotation::ValueSizeType kValueSize = 6;
+
+  AddAnnotationsThread(std::vector<std::unique_ptr<Annotation>>* annotations,
+                       AnnotationList* list)
+      : Thread(), annotations_(annotations), list_(list) {}
+
+ private:
+  void ThreadMain() override {
+    for (const auto& annotation : *annotations_) {
+      // Add the annotation before setting its size, which would otherwise add
+      // it to the global list instead of |list_|.
+      list_->Add(annotation.get());
+      annotation->SetSize(kValueSize);
+    }
+  }
+
+  std::vector<std::unique_ptr<Annotation>>* annotations_;
+  AnnotationList* list_;
+};
+
+TEST(ImageAnnotationReader, ReadManyFromSelf) {
+  // Enough annotations to span more than one block of the registry, added
+  // concurrently.
+  constexpr size_t kThreads = 4;
+  constexpr size_t kAnnotationsPerThread = 75;
+  static_assert(kThreads * kAnnotationsPerThread >
+                AnnotationList::Block::kCapacity);
+
+  static constexpr char kValue[] = "value";
+  static_assert(sizeof(kValue) == AddAnnotationsThread::kValueSize);
+  std::vector<std::string> names;
+  for (size_t index = 0; index < kThreads * kAnnotationsPerThread; ++index) {
+    names.push_back("annotation " + std::to_string(index));
+  }
+
+  AnnotationList annotations;
+  std::vector<std::vector<std::unique_ptr<Annotation>>> storage(kThreads);
+  std::vector<std::unique_ptr<AddAnnotationsThread>> threads;
+  for (size_t thread = 0; thread < kThreads; ++thread) {
+    for (size_t index = 0; index < kAnnotationsPerThread; ++index) {
+      storage[thread].push_back(std::make_unique<Annotation>(
+          Annotation::Type::kString,
+          names[thread * kAnnotationsPerThread + index].c_str(),
+          reinterpret_cast<void*>(const_cast<char*>(kValue))));
+    }
+    threads.push_back(
+        std::make_unique<AddAnnotationsThread>(&storage[thread], &annotations));
+  }
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  // A cleared annotation is excluded from the snapshot.
+  storage[0][0]->Clear();
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotation_list;
+  ASSERT_TRUE(reader.AnnotationsList(FromPointerCast<VMAddress>(&annotations),
+                                     &annotation_list));
+  ASSERT_EQ(annotation_list.size(), names.size() - 1);
+
+  std::set<std::string> read_names;
+  for (const AnnotationSnapshot& annotation : annotation_list) {
+    EXPECT_EQ(annotation.type, AsUnderlyingType(Annotation::Type::kString));
+    EXPECT_EQ(annotation.value.size(), sizeof(kValue));
+    read_names.insert(annotation.name);
+  }
+  EXPECT_EQ(read_names.size(), names.size() - 1);
+  EXPECT_EQ(read_names.count(names[0]), 0u);
+  EXPECT_EQ(read_names.count(names.back()), 1u);
+}
+
+class SeqlockAnnotation final : public Annotation {
+ public:
+  explicit SeqlockAnnotation(const char name[])
+      : Annotation(Type::kString, name, value_, SeqlockTag()), value_() {}
+
+  void Set(const char* value) {
+    ScopedSeqlockWrite write = CreateScopedSeqlockWrite();
+    SetValue(value);
+  }
+
+  void SetValue(const char* value) {
+    strncpy(value_, value, sizeof(value_));
+    SetSize(static_cast<ValueSizeType>(strnlen(value_, sizeof(value_))));
+  }
+
+ private:
+  char value_[16];
+};
+
+TEST(ImageAnnotationReader, ReadSeqlockAnnotationsFromSelf) {
+  AnnotationList annotations;
+  // Add the annotations before setting them, which would otherwise add them to
+  // the global list.
+  SeqlockAnnotation stable("stable");
+  annotations.Add(&stable);
+  stable.Set("first");
+  stable.Set("second");
+
+  // An annotation captured in the middle of a write is left out.
+  SeqlockAnnotation writing("writing");
+  annotations.Add(&writing);
+  writing.Set("old");
+  ScopedSeqlockWrite write = writing.CreateScopedSeqlockWrite();
+  writing.SetValue("new");
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotation_list;
+  ASSERT_TRUE(reader.AnnotationsList(FromPointerCast<VMAddress>(&annotations),
+                                     &annotation_list));
+  ASSERT_EQ(annotation_list.size(), 1u);
+  EXPECT_EQ(annotation_list[0].name, "stable");
+  EXPECT_EQ(std::string(annotation_list[0].value.begin(),
+                        annotation_list[0].value.end()),
+            "second");
+}
+
+TEST(ImageAnnotationReader, ReadIndexedSimpleMapFromSelf) {
+  TIndexedSimpleStringDictionary<8, 16, 10> map;
+  map.SetKeyValue("key1", "value1");
+  map.SetKeyValue("key2", "value2");
+  map.SetKeyValue("key3", "value3");
+  map.SetKeyValue("a long key", "truncated key");
+  map.RemoveKey("key1");
+
+  // An unrelated structure is rejected.
+  SimpleStringDictionary simple_map;
+  simple_map.SetKeyValue("key", "value");
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::map<std::string, std::string> annotations;
+  ASSERT_TRUE(reader.IndexedSimpleMap(FromPointerCast<VMAddress>(map.header()),
+                                      &annotations));
+  const std::map<std::string, std::string> expected = {
+      {"key2", "value2"}, {"key3", "value3"}, {"a long ", "truncated key"}};
+  EXPECT_EQ(annotations, expected);
+
+  EXPECT_FALSE(reader.IndexedSimpleMap(FromPointerCast<VMAddress>(&simple_map),
+                                       &annotations));
+}
+
 CRASHPAD_CHILD_TEST_MAIN(ReadAnnotationsFromChildTestMain) {
   SimpleStringDictionary map;
   std::vector<std::unique_ptr<Annotation>> storage;
@@ -0,0 +1,183 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/crashpad_types/thread_breadcrumb_reader.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "build/build_config.h"
+#include "client/length_delimited_ring_buffer.h"
+#include "client/thread_breadcrumbs.h"
+#include "snapshot/snapshot_constants.h"
+#if BUILDFLAG(IS_FUCHSIA)
+#include "util/fuchsia/traits.h"
+#else
+#include "util/linux/traits.h"
+#endif
+
+namespace crashpad {
+
+namespace {
+
+// Every RingBufferData shares the same header, whatever its capacity.
+using BufferData = RingBufferData<ThreadBreadcrumbList::kBufferCapacity>;
+
+}  // namespace
+
+namespace process_types {
+
+template <class Traits>
+struct ThreadBreadcrumbList {
+  typename Traits::Address head;
+};
+
+// The leading members of ThreadBreadcrumbList::Buffer. The buffer’s
+// RingBufferData immediately follows |capacity|, which is not necessarily at
+// sizeof(ThreadBreadcrumbBuffer) because of trailing padding.
+template <class Traits>
+struct ThreadBreadcrumbBuffer {
+  uint64_t thread_id;
+  typename Traits::Address next;
+  uint32_t busy;
+  uint32_t capacity;
+};
+
+template <class Traits>
+constexpr size_t ThreadBreadcrumbBufferDataOffset() {
+  return offsetof(ThreadBreadcrumbBuffer<Traits>, capacity) +
+         sizeof(ThreadBreadcrumbBuffer<Traits>::capacity);
+}
+
+// The leading members of RingBufferData.
+struct RingBufferDataHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t offset;
+  uint32_t length;
+};
+
+}  // namespace process_types
+
+#if defined(ARCH_CPU_64_BITS)
+#define NATIVE_TRAITS Traits64
+#else
+#define NATIVE_TRAITS Traits32
+#endif  // ARCH_CPU_64_BITS
+
+static_assert(sizeof(process_types::ThreadBreadcrumbList<NATIVE_TRAITS>) ==
+                  sizeof(ThreadBreadcrumbList),
+              "ThreadBreadcrumbList size mismatch");
+
+static_assert(
+    process_types::ThreadBreadcrumbBufferDataOffset<NATIVE_TRAITS>() ==
+        offsetof(ThreadBreadcrumbList::Buffer, data),
+    "ThreadBreadcrumbList::Buffer layout mismatch");
+
+#undef NATIVE_TRAITS
+
+static_assert(sizeof(process_types::RingBufferDataHeader) ==
+                  sizeof(BufferData::Header),
+              "RingBufferData::Header size mismatch");
+
+ThreadBreadcrumbReader::ThreadBreadcrumbReader(
+    const ProcessMemoryRange* memory)
+    : memory_(memory) {}
+
+ThreadBreadcrumbReader::~ThreadBreadcrumbReader() = default;
+
+bool ThreadBreadcrumbReader::ThreadBreadcrumbs(
+    VMAddress address,
+    std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const {
+  return memory_->Is64Bit()
+             ? ReadThreadBreadcrumbs<Traits64>(address, breadcrumbs)
+             : ReadThreadBreadcrumbs<Traits32>(address, breadcrumbs);
+}
+
+template <class Traits>
+bool ThreadBreadcrumbReader::ReadThreadBreadcrumbs(
+    VMAddress address,
+    std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const {
+  process_types::ThreadBreadcrumbList<Traits> list;
+  if (!memory_->Read(address, sizeof(list), &list)) {
+    LOG(ERROR) << "could not read thread breadcrumb list";
+    return false;
+  }
+
+  // Walk the list first, so that the contents of all of the buffers can be
+  // read in one batch.
+  constexpr size_t kDataOffset =
+      process_types::ThreadBreadcrumbBufferDataOffset<Traits>();
+  std::vector<std::pair<uint64_t, std::vector<uint8_t>>> contents;
+  std::vector<ProcessMemory::ReadRequest> requests;
+  bool success = true;
+  VMAddress buffer_address = list.head;
+  for (size_t index = 0;
+       buffer_address && index < kMaxNumberOfThreadBreadcrumbBuffers;
+       ++index) {
+    process_types::ThreadBreadcrumbBuffer<Traits> buffer;
+    if (!memory_->Read(buffer_address, kDataOffset, &buffer)) {
+      LOG(ERROR) << "could not read thread breadcrumb buffer " << index;
+      success = false;
+      break;
+    }
+
+    if (buffer.thread_id != 0 && !buffer.busy &&
+        buffer.capacity <= kMaxThreadBreadcrumbBufferCapacity &&
+        !breadcrumbs->count(buffer.thread_id)) {
+      std::vector<uint8_t> data(sizeof(process_types::RingBufferDataHeader) +
+                                buffer.capacity);
+      requests.push_back({buffer_address + kDataOffset, data.size(), nullptr});
+      contents.emplace_back(buffer.thread_id, std::move(data));
+    }
+
+    buffer_address = buffer.next;
+  }
+
+  for (size_t index = 0; index < requests.size(); ++index) {
+    requests[index].buffer = contents[index].second.data();
+  }
+  if (!memory_->ReadBatch(requests)) {
+    LOG(ERROR) << "could not read thread breadcrumbs";
+    return false;
+  }
+
+  for (auto& [thread_id, data] : contents) {
+    process_types::RingBufferDataHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != BufferData::kMagic ||
+        header.version != BufferData::kVersion) {
+      LOG(WARNING) << "unexpected thread breadcrumb buffer for thread "
+                   << thread_id;
+      continue;
+    }
+
+    // Trim the unused tail of the ring buffer, as
+    // RingBufferData::GetRingBufferLength() does.
+    const size_t capacity = data.size() - sizeof(header);
+    const uint64_t end = uint64_t{header.offset} + header.length;
+    if (end == 0) {
+      continue;
+    }
+    data.resize(sizeof(header) + std::min(uint64_t{capacity}, end));
+    breadcrumbs->insert(std::make_pair(thread_id, std::move(data)));
+  }
+
+  return success;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,71 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_CRASHPAD_TYPES_THREAD_BREADCRUMB_READER_H_
+#define CRASHPAD_SNAPSHOT_CRASHPAD_TYPES_THREAD_BREADCRUMB_READER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "util/misc/address_types.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+
+//! \brief Reads per-thread breadcrumb buffers from another process via a
+//!     ProcessMemoryRange.
+//!
+//! \sa ThreadBreadcrumbList
+class ThreadBreadcrumbReader {
+ public:
+  //! \brief Constructs the object.
+  //!
+  //! \param[in] memory A memory reader for the remote process.
+  explicit ThreadBreadcrumbReader(const ProcessMemoryRange* memory);
+
+  ThreadBreadcrumbReader(const ThreadBreadcrumbReader&) = delete;
+  ThreadBreadcrumbReader& operator=(const ThreadBreadcrumbReader&) = delete;
+
+  ~ThreadBreadcrumbReader();
+
+  //! \brief Reads the breadcrumb buffers of the threads that own one.
+  //!
+  //! Buffers that are not owned by a thread, or that were being modified when
+  //! the process was suspended, are skipped.
+  //!
+  //! \param[in] address The address in the target process' address space of a
+  //!     ThreadBreadcrumbList.
+  //! \param[out] breadcrumbs The serialized RingBufferData of each buffer read,
+  //!     keyed by the ID of the thread that owns it. Buffers are added to any
+  //!     already present, and a thread already present is not replaced. Valid
+  //!     if this method returns `true`.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool ThreadBreadcrumbs(
+      VMAddress address,
+      std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const;
+
+ private:
+  template <class Traits>
+  bool ReadThreadBreadcrumbs(
+      VMAddress address,
+      std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const;
+
+  const ProcessMemoryRange* memory_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_CRASHPAD_TYPES_THREAD_BREADCRUMB_READER_H_
@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/crashpad_types/thread_breadcrumb_reader.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "build/build_config.h"
+#include "client/thread_breadcrumbs.h"
+#include "gtest/gtest.h"
+#include "snapshot/test/test_thread_breadcrumbs.h"
+#include "test/process_type.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory_native.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+#include "test/linux/fake_ptrace_connection.h"
+#endif
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Pushes |item| to |list|, then signals |pushed| and waits for |release| before
+// exiting.
+class PushThread final : public Thread {
+ public:
+  PushThread(ThreadBreadcrumbList* list,
+             const std::string& item,
+             Semaphore* pushed,
+             Semaphore* release)
+      : list_(list), item_(item), pushed_(pushed), release_(release) {}
+
+ private:
+  void ThreadMain() override {
+    EXPECT_TRUE(list_->Push(item_.data(), item_.size()));
+    pushed_->Signal();
+    release_->Wait();
+  }
+
+  ThreadBreadcrumbList* list_;
+  std::string item_;
+  Semaphore* pushed_;
+  Semaphore* release_;
+};
+
+TEST(ThreadBreadcrumbReader, ReadFromSelf) {
+  constexpr size_t kThreads = 3;
+  ThreadBreadcrumbList list;
+  Semaphore pushed(0);
+  Semaphore release(0);
+
+  // A thread that has exited has released its buffer. Its breadcrumbs are
+  // discarded when the buffer is reused.
+  PushThread exited(&list, "exited", &pushed, &release);
+  exited.Start();
+  pushed.Wait();
+  release.Signal();
+  exited.Join();
+
+  std::vector<std::unique_ptr<PushThread>> threads;
+  for (size_t index = 0; index < kThreads + 1; ++index) {
+    threads.push_back(std::make_unique<PushThread>(
+        &list, "thread " + std::to_string(index), &pushed, &release));
+    threads.back()->Start();
+    pushed.Wait();
+  }
+
+  // The buffer of the thread started last, at the head of the list, is marked
+  // as being modified, and is skipped.
+  auto busy_buffer = const_cast<ThreadBreadcrumbList::Buffer*>(list.head());
+  busy_buffer->busy.store(1);
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ThreadBreadcrumbReader reader(&range);
+  std::map<uint64_t, std::vector<uint8_t>> breadcrumbs;
+  ASSERT_TRUE(reader.ThreadBreadcrumbs(FromPointerCast<VMAddress>(&list),
+                                       &breadcrumbs));
+  EXPECT_EQ(breadcrumbs.size(), kThreads);
+
+  for (const ThreadBreadcrumbList::Buffer* buffer = list.head(); buffer;
+       buffer = buffer->next.load()) {
+    const auto it = breadcrumbs.find(buffer->thread_id.load());
+    if (buffer == busy_buffer) {
+      EXPECT_EQ(it, breadcrumbs.end());
+      continue;
+    }
+    ASSERT_NE(it, breadcrumbs.end());
+    std::vector<std::string> items;
+    ASSERT_TRUE(DecodeThreadBreadcrumbs(
+        it->second.data(), it->second.size(), &items));
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_NE(items[0], "exited");
+  }
+
+  busy_buffer->busy.store(0);
+  for (size_t index = 0; index < threads.size(); ++index) {
+    release.Signal();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
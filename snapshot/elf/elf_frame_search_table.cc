@@ -0,0 +1,290 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_frame_search_table.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+// Pointer encodings, from the Linux Standard Base Core Specification.
+constexpr uint8_t kEncodingOmit = 0xff;
+constexpr uint8_t kEncodingFormatMask = 0x0f;
+constexpr uint8_t kEncodingAbsolute = 0x00;
+constexpr uint8_t kEncodingUData2 = 0x02;
+constexpr uint8_t kEncodingUData4 = 0x03;
+constexpr uint8_t kEncodingUData8 = 0x04;
+constexpr uint8_t kEncodingSData2 = 0x0a;
+constexpr uint8_t kEncodingSData4 = 0x0b;
+constexpr uint8_t kEncodingSData8 = 0x0c;
+constexpr uint8_t kEncodingDataRelative = 0x30;
+
+// The most memory that cached tables may use. A large shared library’s table
+// is a few megabytes, so this holds the tables of the modules that most
+// clients have in common.
+constexpr size_t kCacheCapacity = 32 * 1024 * 1024;
+
+// Returns the size of a value in the fixed-size pointer encoding encoding, or
+// 0 if the encoding is variable-length or unknown.
+size_t EncodedSize(uint8_t encoding, bool is_64_bit) {
+  switch (encoding & kEncodingFormatMask) {
+    case kEncodingAbsolute:
+      return is_64_bit ? 8 : 4;
+    case kEncodingUData2:
+    case kEncodingSData2:
+      return 2;
+    case kEncodingUData4:
+    case kEncodingSData4:
+      return 4;
+    case kEncodingUData8:
+    case kEncodingSData8:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Reads a little-endian value of size bytes, which must be 2, 4, or 8.
+uint64_t ReadUnsigned(const uint8_t* data, size_t size) {
+  switch (size) {
+    case 2: {
+      uint16_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+    case 4: {
+      uint32_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+    default: {
+      uint64_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+  }
+}
+
+// Identifies a table. The build ID alone would be enough for a well-formed
+// image, but the table’s position and size are also checked, as they’re known
+// before it’s read.
+struct CacheKey {
+  std::string build_id;
+  VMSize table_offset;
+  uint64_t entry_count;
+
+  bool operator<(const CacheKey& other) const {
+    return std::tie(build_id, table_offset, entry_count) <
+           std::tie(other.build_id, other.table_offset, other.entry_count);
+  }
+};
+
+using Entries = std::vector<ElfFrameSearchTable::Entry>;
+
+// The tables shared across captures. When the cache is full, the tables used
+// least recently are evicted.
+class TableCache {
+ public:
+  TableCache() : lock_(), tables_(), size_(0), uses_(0) {}
+
+  TableCache(const TableCache&) = delete;
+  TableCache& operator=(const TableCache&) = delete;
+
+  static TableCache* Get() {
+    static TableCache* cache = new TableCache();
+    return cache;
+  }
+
+  std::shared_ptr<const Entries> Find(const CacheKey& key) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = tables_.find(key);
+    if (it == tables_.end()) {
+      return nullptr;
+    }
+    it->second.last_use = ++uses_;
+    return it->second.entries;
+  }
+
+  void Insert(const CacheKey& key, std::shared_ptr<const Entries> entries) {
+    const size_t size = entries->size() * sizeof(ElfFrameSearchTable::Entry);
+    if (size > kCacheCapacity) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(lock_);
+    while (size_ + size > kCacheCapacity) {
+      auto oldest = std::min_element(
+          tables_.begin(), tables_.end(), [](const auto& a, const auto& b) {
+            return a.second.last_use < b.second.last_use;
+          });
+      size_ -= oldest->second.entries->size() *
+               sizeof(ElfFrameSearchTable::Entry);
+      tables_.erase(oldest);
+    }
+
+    CachedTable& table = tables_[key];
+    if (table.entries) {
+      // Another capture read the same table concurrently.
+      size_ -= table.entries->size() * sizeof(ElfFrameSearchTable::Entry);
+    }
+    table.entries = std::move(entries);
+    table.last_use = ++uses_;
+    size_ += size;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(lock_);
+    tables_.clear();
+    size_ = 0;
+  }
+
+ private:
+  struct CachedTable {
+    std::shared_ptr<const Entries> entries;
+    uint64_t last_use;
+  };
+
+  std::mutex lock_;
+  std::map<CacheKey, CachedTable> tables_;
+  size_t size_;
+  uint64_t uses_;
+};
+
+}  // namespace
+
+ElfFrameSearchTable::ElfFrameSearchTable()
+    : entries_(), header_address_(0), initialized_() {}
+
+ElfFrameSearchTable::~ElfFrameSearchTable() = default;
+
+bool ElfFrameSearchTable::Initialize(const ProcessMemoryRange* memory,
+                                     VMAddress header_address,
+                                     VMSize header_size,
+                                     const std::string& build_id) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  header_address_ = header_address;
+
+  struct {
+    uint8_t version;
+    uint8_t eh_frame_ptr_encoding;
+    uint8_t fde_count_encoding;
+    uint8_t table_encoding;
+  } header;
+  // The header is followed by the encoded .eh_frame pointer and entry count,
+  // which are at most 8 bytes each.
+  uint8_t data[sizeof(header) + 16];
+  const size_t data_size =
+      static_cast<size_t>(std::min<VMSize>(header_size, sizeof(data)));
+  if (data_size < sizeof(header) ||
+      !memory->Read(header_address, data_size, data)) {
+    LOG(ERROR) << "couldn't read .eh_frame_hdr";
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.version != 1) {
+    LOG(ERROR) << "unexpected .eh_frame_hdr version "
+               << static_cast<int>(header.version);
+    return false;
+  }
+
+  // Only the table encoding that linkers produce is supported: 4-byte signed
+  // offsets from the start of .eh_frame_hdr.
+  if (header.fde_count_encoding == kEncodingOmit ||
+      header.table_encoding != (kEncodingDataRelative | kEncodingSData4)) {
+    VLOG(1) << ".eh_frame_hdr has no usable search table";
+    return false;
+  }
+
+  const size_t pointer_size =
+      EncodedSize(header.eh_frame_ptr_encoding, memory->Is64Bit());
+  const size_t count_size =
+      EncodedSize(header.fde_count_encoding, memory->Is64Bit());
+  const size_t table_offset = sizeof(header) + pointer_size + count_size;
+  if (pointer_size == 0 || count_size == 0 || table_offset > data_size) {
+    LOG(ERROR) << "unsupported .eh_frame_hdr encoding";
+    return false;
+  }
+
+  const uint64_t entry_count =
+      ReadUnsigned(data + sizeof(header) + pointer_size, count_size);
+  if (entry_count > (header_size - table_offset) / sizeof(Entry)) {
+    LOG(ERROR) << ".eh_frame_hdr entry count " << entry_count << " too large";
+    return false;
+  }
+
+  const CacheKey key{build_id, table_offset, entry_count};
+  if (!build_id.empty()) {
+    entries_ = TableCache::Get()->Find(key);
+  }
+  if (!entries_) {
+    auto entries = std::make_shared<Entries>(static_cast<size_t>(entry_count));
+    if (!entries->empty() &&
+        !memory->Read(header_address + table_offset,
+                      entries->size() * sizeof(Entry),
+                      entries->data())) {
+      LOG(ERROR) << "couldn't read .eh_frame_hdr search table";
+      return false;
+    }
+    entries_ = std::move(entries);
+    if (!build_id.empty()) {
+      TableCache::Get()->Insert(key, entries_);
+    }
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ElfFrameSearchTable::FindEntry(VMAddress address,
+                                    VMAddress* fde_address) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const int64_t relative_address =
+      static_cast<int64_t>(address - header_address_);
+  auto entry = std::upper_bound(
+      entries_->begin(),
+      entries_->end(),
+      relative_address,
+      [](int64_t value, const Entry& entry) {
+        return value < entry.initial_location;
+      });
+  if (entry == entries_->begin()) {
+    return false;
+  }
+  --entry;
+
+  *fde_address = header_address_ + static_cast<int64_t>(entry->fde_offset);
+  return true;
+}
+
+size_t ElfFrameSearchTable::EntryCount() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return entries_->size();
+}
+
+// static
+void ElfFrameSearchTable::ClearCache() {
+  TableCache::Get()->Clear();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,100 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_ELF_ELF_FRAME_SEARCH_TABLE_H_
+#define CRASHPAD_SNAPSHOT_ELF_ELF_FRAME_SEARCH_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+
+//! \brief The binary search table in an ELF image’s `.eh_frame_hdr` section,
+//!     which locates the frame description entry for an instruction.
+//!
+//! The table is read with a single read of the target’s memory. Its entries
+//! are stored relative to the start of `.eh_frame_hdr`, so they don’t depend
+//! on where an image is loaded. Tables read from images with a build ID are
+//! kept in a cache shared by every ElfFrameSearchTable in the process, and a
+//! later capture of an image with the same build ID reuses the cached table
+//! instead of reading it again.
+class ElfFrameSearchTable {
+ public:
+  //! \brief One entry of the search table, as stored in the image.
+  struct Entry {
+    //! \brief The initial location of the entry’s function, relative to the
+    //!     start of `.eh_frame_hdr`.
+    int32_t initial_location;
+
+    //! \brief The address of the frame description entry, relative to the
+    //!     start of `.eh_frame_hdr`.
+    int32_t fde_offset;
+  };
+
+  ElfFrameSearchTable();
+
+  ElfFrameSearchTable(const ElfFrameSearchTable&) = delete;
+  ElfFrameSearchTable& operator=(const ElfFrameSearchTable&) = delete;
+
+  ~ElfFrameSearchTable();
+
+  //! \brief Reads the table, or finds it in the cache.
+  //!
+  //! \param[in] memory A memory reader for the target process.
+  //! \param[in] header_address The address of the `.eh_frame_hdr` section.
+  //! \param[in] header_size The size of the `.eh_frame_hdr` section.
+  //! \param[in] build_id The build ID of the image containing the section, or
+  //!     an empty string if it has none, in which case the cache isn’t used.
+  //! \return `true` on success. `false` if the section has no search table in
+  //!     a supported encoding, with a message logged if the section could not
+  //!     be read.
+  bool Initialize(const ProcessMemoryRange* memory,
+                  VMAddress header_address,
+                  VMSize header_size,
+                  const std::string& build_id);
+
+  //! \brief Finds the frame description entry that may describe the
+  //!     instruction at \a address.
+  //!
+  //! \param[in] address The address of an instruction.
+  //! \param[out] fde_address The address of the frame description entry with
+  //!     the greatest initial location at or below \a address. The entry may
+  //!     end before \a address, so the caller must check its range.
+  //! \return `true` if an entry was found. `false` if \a address lies before
+  //!     every entry in the table.
+  bool FindEntry(VMAddress address, VMAddress* fde_address) const;
+
+  //! \brief Returns the number of entries in the table.
+  size_t EntryCount() const;
+
+  //! \brief Discards every cached table.
+  static void ClearCache();
+
+ private:
+  std::shared_ptr<const std::vector<Entry>> entries_;
+  VMAddress header_address_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_ELF_ELF_FRAME_SEARCH_TABLE_H_
@@ -0,0 +1,172 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_frame_search_table.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A ProcessMemory holding a synthetic .eh_frame_hdr section at base, which
+// counts the reads made of it.
+class HeaderMemory : public ProcessMemory {
+ public:
+  explicit HeaderMemory(VMAddress base) : data_(), base_(base), reads_(0) {
+    // Version 1, a PC-relative sdata4 .eh_frame pointer, a udata4 entry count,
+    // and a table of data-relative sdata4 values.
+    const uint8_t header[] = {1, 0x1b, 0x03, 0x3b};
+    Append(header, sizeof(header));
+    const int32_t eh_frame_pointer = 0x1000;
+    Append(&eh_frame_pointer, sizeof(eh_frame_pointer));
+    const uint32_t count = 3;
+    Append(&count, sizeof(count));
+    const ElfFrameSearchTable::Entry entries[] = {
+        {0x100, 0x1000}, {0x200, 0x1010}, {0x300, 0x1020}};
+    Append(entries, sizeof(entries));
+  }
+
+  HeaderMemory(const HeaderMemory&) = delete;
+  HeaderMemory& operator=(const HeaderMemory&) = delete;
+
+  void set_table_encoding(uint8_t encoding) { data_[3] = encoding; }
+
+  VMAddress base() const { return base_; }
+  VMSize size() const { return data_.size(); }
+  size_t reads() const { return reads_; }
+
+ private:
+  void Append(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+  }
+
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++reads_;
+    if (address < base_ || address >= base_ + data_.size()) {
+      return -1;
+    }
+    size_t offset = address - base_;
+    size_t read_size = std::min(size, data_.size() - offset);
+    memcpy(buffer, &data_[offset], read_size);
+    return read_size;
+  }
+
+  std::vector<uint8_t> data_;
+  VMAddress base_;
+  mutable size_t reads_;
+};
+
+class ElfFrameSearchTableTest : public testing::Test {
+ public:
+  void SetUp() override { ElfFrameSearchTable::ClearCache(); }
+  void TearDown() override { ElfFrameSearchTable::ClearCache(); }
+};
+
+TEST_F(ElfFrameSearchTableTest, FindEntry) {
+  HeaderMemory memory(0x10000);
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, true));
+
+  ElfFrameSearchTable table;
+  ASSERT_TRUE(table.Initialize(&range, memory.base(), memory.size(), ""));
+  EXPECT_EQ(table.EntryCount(), 3u);
+
+  VMAddress fde_address;
+  EXPECT_FALSE(table.FindEntry(0x10050, &fde_address));
+  ASSERT_TRUE(table.FindEntry(0x10100, &fde_address));
+  EXPECT_EQ(fde_address, 0x11000u);
+  ASSERT_TRUE(table.FindEntry(0x10250, &fde_address));
+  EXPECT_EQ(fde_address, 0x11010u);
+
+  // The last entry is returned for any address beyond it, and the caller
+  // checks its range.
+  ASSERT_TRUE(table.FindEntry(0x15000, &fde_address));
+  EXPECT_EQ(fde_address, 0x11020u);
+}
+
+TEST_F(ElfFrameSearchTableTest, CachedByBuildID) {
+  HeaderMemory memory(0x10000);
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, true));
+
+  ElfFrameSearchTable table;
+  ASSERT_TRUE(
+      table.Initialize(&range, memory.base(), memory.size(), "build id"));
+  EXPECT_EQ(memory.reads(), 2u);
+
+  // The same image loaded elsewhere only has its header read, and its entries
+  // are found relative to its own address.
+  HeaderMemory moved_memory(0x40000);
+  ProcessMemoryRange moved_range;
+  ASSERT_TRUE(moved_range.Initialize(&moved_memory, true));
+
+  ElfFrameSearchTable moved_table;
+  ASSERT_TRUE(moved_table.Initialize(
+      &moved_range, moved_memory.base(), moved_memory.size(), "build id"));
+  EXPECT_EQ(moved_memory.reads(), 1u);
+  EXPECT_EQ(moved_table.EntryCount(), 3u);
+
+  VMAddress fde_address;
+  ASSERT_TRUE(moved_table.FindEntry(0x40200, &fde_address));
+  EXPECT_EQ(fde_address, 0x41010u);
+
+  // A different build ID, or none at all, is read again.
+  ElfFrameSearchTable other_table;
+  ASSERT_TRUE(other_table.Initialize(
+      &moved_range, moved_memory.base(), moved_memory.size(), "other"));
+  EXPECT_EQ(moved_memory.reads(), 3u);
+
+  ElfFrameSearchTable uncached_table;
+  ASSERT_TRUE(
+      uncached_table.Initialize(&range, memory.base(), memory.size(), ""));
+  ElfFrameSearchTable uncached_table_again;
+  ASSERT_TRUE(uncached_table_again.Initialize(
+      &range, memory.base(), memory.size(), ""));
+  EXPECT_EQ(memory.reads(), 6u);
+}
+
+TEST_F(ElfFrameSearchTableTest, UnsupportedEncoding) {
+  HeaderMemory memory(0x10000);
+  memory.set_table_encoding(0x03);
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, true));
+
+  ElfFrameSearchTable table;
+  EXPECT_FALSE(table.Initialize(&range, memory.base(), memory.size(), "id"));
+}
+
+TEST_F(ElfFrameSearchTableTest, TruncatedTable) {
+  HeaderMemory memory(0x10000);
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, true));
+
+  // The section is too small to hold the entry count that it claims.
+  ElfFrameSearchTable table;
+  EXPECT_FALSE(
+      table.Initialize(&range, memory.base(), memory.size() - 1, "id"));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -36,6 +36,8 @@ class ElfImageReader::ProgramHeaderTable {
   virtual bool VerifyLoadSegments(bool verbose) const = 0;
   virtual size_t Size() const = 0;
   virtual bool GetDynamicSegment(VMAddress* address, VMSize* size) const = 0;
+  virtual bool GetEhFrameHeaderSegment(VMAddress* address,
+                                       VMSize* size) const = 0;
   virtual bool GetPreferredElfHeaderAddress(VMAddress* address,
                                             bool verbose) const = 0;
   virtual bool GetPreferredLoadedMemoryRange(VMAddress* address,
@@ -161,6 +163,18 @@ class ElfImageReader::ProgramHeaderTableSpecific
     return true;
   }
 
+  bool GetEhFrameHeaderSegment(VMAddress* address,
+                               VMSize* size) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    const PhdrType* phdr;
+    if (!GetProgramHeader(PT_GNU_EH_FRAME, &phdr)) {
+      return false;
+    }
+    *address = phdr->p_vaddr;
+    *size = phdr->p_memsz;
+    return true;
+  }
+
   bool GetProgramHeader(uint32_t type, const PhdrType** header_out) const {
     INITIALIZATION_STATE_DCHECK_VALID(initialized_);
     for (const auto& header : table_) {
@@ -335,9 +349,19 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
     return Result::kError;
   }
 
+  // When filtering by name, read the name alone so that the descriptor of a
+  // non-matching note isn’t read needlessly. Otherwise, read the name and the
+  // descriptor together.
   std::string local_name(note_info.n_namesz, '\0');
-  if (!segment_range_->Read(
-          current_address_, note_info.n_namesz, &local_name[0])) {
+  std::string local_desc(note_info.n_descsz, '\0');
+  const VMAddress local_desc_address = current_address_ + padded_namesz;
+  std::vector<ProcessMemory::ReadRequest> requests;
+  requests.push_back({current_address_, note_info.n_namesz, &local_name[0]});
+  if (!use_filter_) {
+    requests.push_back(
+        {local_desc_address, note_info.n_descsz, &local_desc[0]});
+  }
+  if (!segment_range_->ReadBatch(requests)) {
     return Result::kError;
   }
   if (!local_name.empty()) {
@@ -354,10 +378,10 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
     return Result::kError;
   }
 
-  current_address_ += padded_namesz;
+  current_address_ = local_desc_address;
 
-  std::string local_desc(note_info.n_descsz, '\0');
-  if (!segment_range_->Read(
+  if (use_filter_ &&
+      !segment_range_->Read(
           current_address_, note_info.n_descsz, &local_desc[0])) {
     return Result::kError;
   }
@@ -383,9 +407,11 @@ ElfImageReader::ElfImageReader()
       program_headers_(),
       dynamic_array_(),
       symbol_table_(),
+      frame_search_table_(),
       initialized_(),
       dynamic_array_initialized_(),
-      symbol_table_initialized_() {}
+      symbol_table_initialized_(),
+      frame_search_table_initialized_() {}
 
 ElfImageReader::~ElfImageReader() {}
 
@@ -398,10 +424,18 @@ bool ElfImageReader::Initialize(const ProcessMemoryRange& memory,
     return false;
   }
 
-  uint8_t e_ident[EI_NIDENT];
-  if (!memory_.Read(ehdr_address_, EI_NIDENT, e_ident)) {
+  // The bitness of the image is already known from the memory range, so read
+  // the entire header at once and verify its identification bytes afterwards.
+  if (!(memory_.Is64Bit()
+            ? memory_.Read(ehdr_address_, sizeof(header_64_), &header_64_)
+            : memory_.Read(ehdr_address_, sizeof(header_32_), &header_32_))) {
     return false;
   }
+  static_assert(sizeof(header_64_.e_ident) == EI_NIDENT &&
+                    sizeof(header_32_.e_ident) == EI_NIDENT,
+                "e_ident size mismatch");
+  const unsigned char* e_ident =
+      memory_.Is64Bit() ? header_64_.e_ident : header_32_.e_ident;
 
   if (e_ident[EI_MAG0] != ELFMAG0 || e_ident[EI_MAG1] != ELFMAG1 ||
       e_ident[EI_MAG2] != ELFMAG2 || e_ident[EI_MAG3] != ELFMAG3) {
@@ -430,12 +464,6 @@ bool ElfImageReader::Initialize(const ProcessMemoryRange& memory,
     return false;
   }
 
-  if (!(memory_.Is64Bit()
-            ? memory_.Read(ehdr_address_, sizeof(header_64_), &header_64_)
-            : memory_.Read(ehdr_address_, sizeof(header_32_), &header_32_))) {
-    return false;
-  }
-
 #define VERIFY_HEADER(header)                                  \
   do {                                                         \
     if (header.e_type != ET_EXEC && header.e_type != ET_DYN) { \
@@ -631,6 +659,30 @@ bool ElfImageReader::GetDynamicArrayAddress(VMAddress* address) {
   return true;
 }
 
+bool ElfImageReader::GetEhFrameHeaderAddress(VMAddress* address,
+                                             VMSize* size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  VMAddress segment_address;
+  if (!program_headers_.get()->GetEhFrameHeaderSegment(&segment_address,
+                                                       size)) {
+    return false;
+  }
+  *address = segment_address + GetLoadBias();
+  return true;
+}
+
+bool ElfImageReader::HasFrameSearchTable() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return InitializeFrameSearchTable();
+}
+
+bool ElfImageReader::FindFrameDescriptionEntry(VMAddress address,
+                                               VMAddress* fde_address) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return InitializeFrameSearchTable() &&
+         frame_search_table_->FindEntry(address, fde_address);
+}
+
 VMAddress ElfImageReader::GetProgramHeaderTableAddress() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return ehdr_address_ +
@@ -689,6 +741,41 @@ bool ElfImageReader::InitializeDynamicArray() {
   return true;
 }
 
+bool ElfImageReader::InitializeFrameSearchTable() {
+  if (frame_search_table_initialized_.is_valid()) {
+    return true;
+  }
+  if (!frame_search_table_initialized_.is_uninitialized()) {
+    return false;
+  }
+  frame_search_table_initialized_.set_invalid();
+
+  VMAddress header_address;
+  VMSize header_size;
+  if (!GetEhFrameHeaderAddress(&header_address, &header_size)) {
+    return false;
+  }
+
+  // The build ID keys the cache of tables shared across captures. An image
+  // without one has its table read every time.
+  std::string build_id;
+  VMAddress build_id_address;
+  std::unique_ptr<NoteReader> notes =
+      NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
+  if (notes->NextNote(nullptr, nullptr, &build_id, &build_id_address) !=
+      NoteReader::Result::kSuccess) {
+    build_id.clear();
+  }
+
+  frame_search_table_.reset(new ElfFrameSearchTable());
+  if (!frame_search_table_->Initialize(
+          &memory_, header_address, header_size, build_id)) {
+    return false;
+  }
+  frame_search_table_initialized_.set_valid();
+  return true;
+}
+
 bool ElfImageReader::InitializeDynamicSymbolTable() {
   if (symbol_table_initialized_.is_valid()) {
     return true;
@@ -722,8 +809,23 @@ bool ElfImageReader::InitializeDynamicSymbolTable() {
     return false;
   }
 
-  symbol_table_.reset(new ElfSymbolTableReader(
-      &memory_, this, symbol_table_address, number_of_symbol_table_entries));
+  // Either hash table makes looking symbols up much cheaper than reading the
+  // whole symbol table, which can hold many thousands of entries.
+  VMAddress gnu_hash_address;
+  if (!GetAddressFromDynamicArray(DT_GNU_HASH, false, &gnu_hash_address)) {
+    gnu_hash_address = 0;
+  }
+  VMAddress hash_address;
+  if (!GetAddressFromDynamicArray(DT_HASH, false, &hash_address)) {
+    hash_address = 0;
+  }
+
+  symbol_table_.reset(new ElfSymbolTableReader(&memory_,
+                                               this,
+                                               symbol_table_address,
+                                               number_of_symbol_table_entries,
+                                               gnu_hash_address,
+                                               hash_address));
   symbol_table_initialized_.set_valid();
   return true;
 }
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "snapshot/elf/elf_dynamic_array_reader.h"
+#include "snapshot/elf/elf_frame_search_table.h"
 #include "snapshot/elf/elf_symbol_table_reader.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state.h"
@@ -204,6 +205,38 @@ class ElfImageReader {
   //! \return `true` on success. Otherwise `false` with a message logged.
   bool GetDynamicArrayAddress(VMAddress* address);
 
+  //! \brief Determine the address and size of the `PT_GNU_EH_FRAME` segment,
+  //!     which holds the `.eh_frame_hdr` section.
+  //!
+  //! \param[out] address The address of the segment, valid if this method
+  //!     returns `true`.
+  //! \param[out] size The size of the segment, valid if this method returns
+  //!     `true`.
+  //! \return `true` if the image has the segment. No message is logged if it
+  //!     doesn’t.
+  bool GetEhFrameHeaderAddress(VMAddress* address, VMSize* size);
+
+  //! \brief Determines whether the image has a usable `.eh_frame_hdr` binary
+  //!     search table, reading the table if it hasn’t been read.
+  //!
+  //! The table is read in one piece, and shared with other ElfImageReader
+  //! objects for images with the same build ID, including those of later
+  //! captures. See ElfFrameSearchTable.
+  //!
+  //! \return `true` if the table was read or found in the cache.
+  bool HasFrameSearchTable();
+
+  //! \brief Finds the frame description entry in the image’s `.eh_frame`
+  //!     section that may describe the instruction at \a address.
+  //!
+  //! \param[in] address The address of an instruction in the image.
+  //! \param[out] fde_address The address of the entry with the greatest
+  //!     initial location at or below \a address. The caller must check that
+  //!     the entry’s range covers \a address.
+  //! \return `true` if an entry was found. `false` if the image has no usable
+  //!     search table, or \a address lies before every entry in it.
+  bool FindFrameDescriptionEntry(VMAddress address, VMAddress* fde_address);
+
   //! \brief Return the address of the program header table.
   VMAddress GetProgramHeaderTableAddress();
 
@@ -274,6 +307,7 @@ class ElfImageReader {
   bool InitializeProgramHeaders(bool verbose);
   bool InitializeDynamicArray();
   bool InitializeDynamicSymbolTable();
+  bool InitializeFrameSearchTable();
   bool GetAddressFromDynamicArray(uint64_t tag, bool log, VMAddress* address);
 
   union {
@@ -286,9 +320,11 @@ class ElfImageReader {
   std::unique_ptr<ProgramHeaderTable> program_headers_;
   std::unique_ptr<ElfDynamicArrayReader> dynamic_array_;
   std::unique_ptr<ElfSymbolTableReader> symbol_table_;
+  std::unique_ptr<ElfFrameSearchTable> frame_search_table_;
   InitializationStateDcheck initialized_;
   InitializationState dynamic_array_initialized_;
   InitializationState symbol_table_initialized_;
+  InitializationState frame_search_table_initialized_;
 };
 
 }  // namespace crashpad
@@ -259,6 +259,56 @@ TEST(ElfImageReader, OneModuleSelf) {
       GetSelfProcess(), elf_address, FromPointerCast<VMAddress>(getpid));
 }
 
+TEST(ElfImageReader, OneModuleManySymbolsSelf) {
+  // libc has thousands of dynamic symbols, so these are found through its hash
+  // table rather than by reading the symbol table.
+  Dl_info info;
+  ASSERT_TRUE(dladdr(reinterpret_cast<void*>(getpid), &info)) << "dladdr:"
+                                                              << dlerror();
+  ScopedModuleHandle libc(dlopen(info.dli_fname, RTLD_LAZY | RTLD_NOLOAD));
+  ASSERT_TRUE(libc.valid()) << "dlopen " << info.dli_fname << ": "
+                            << dlerror();
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ElfImageReader reader;
+  ASSERT_TRUE(
+      reader.Initialize(range, FromPointerCast<VMAddress>(info.dli_fbase)));
+
+  for (const char* name :
+       {"getpid", "malloc", "free", "abort", "qsort", "getenv", "close"}) {
+    SCOPED_TRACE(name);
+    void* address = dlsym(libc.get(), name);
+    ASSERT_TRUE(address) << "dlsym: " << dlerror();
+
+    VMAddress symbol_address;
+    VMSize symbol_size;
+    ASSERT_TRUE(reader.GetDynamicSymbol(name, &symbol_address, &symbol_size));
+    EXPECT_EQ(symbol_address, FromPointerCast<VMAddress>(address));
+  }
+
+  VMAddress symbol_address;
+  VMSize symbol_size;
+  EXPECT_FALSE(reader.GetDynamicSymbol(
+      "ElfImageReaderTestExportedSymbol", &symbol_address, &symbol_size));
+  EXPECT_FALSE(reader.GetDynamicSymbol("", &symbol_address, &symbol_size));
+}
+
 CRASHPAD_CHILD_TEST_MAIN(ReadLibcChild) {
   // Get the address of libc (by using getpid() as a representative member),
   // and also the address of getpid() itself, and write them to the parent, so
@@ -16,6 +16,7 @@
 
 #include <elf.h>
 
+#include "base/logging.h"
 #include "snapshot/elf/elf_image_reader.h"
 
 namespace crashpad {
@@ -46,23 +47,248 @@ uint8_t GetVisibility(const Elf64_Sym& sym) {
   return ELF64_ST_VISIBILITY(sym.st_other);
 }
 
+// The hash function used by DT_GNU_HASH, from
+// https://sourceware.org/ml/binutils/2006-10/msg00377.html.
+uint32_t GnuHash(const std::string& name) {
+  uint32_t hash = 5381;
+  for (unsigned char c : name) {
+    hash = hash * 33 + c;
+  }
+  return hash;
+}
+
+// The hash function used by DT_HASH, from the System V ABI.
+uint32_t ElfHash(const std::string& name) {
+  uint32_t hash = 0;
+  for (unsigned char c : name) {
+    hash = (hash << 4) + c;
+    uint32_t high = hash & 0xf0000000;
+    if (high) {
+      hash ^= high >> 24;
+    }
+    hash &= ~high;
+  }
+  return hash;
+}
+
 }  // namespace
 
 ElfSymbolTableReader::ElfSymbolTableReader(const ProcessMemoryRange* memory,
                                            ElfImageReader* elf_reader,
                                            VMAddress address,
-                                           VMSize num_entries)
+                                           VMSize num_entries,
+                                           VMAddress gnu_hash_address,
+                                           VMAddress hash_address)
     : memory_(memory),
       elf_reader_(elf_reader),
       base_address_(address),
-      num_entries_(num_entries) {}
+      num_entries_(num_entries),
+      gnu_hash_address_(gnu_hash_address),
+      hash_address_(hash_address) {}
 
 ElfSymbolTableReader::~ElfSymbolTableReader() {}
 
 bool ElfSymbolTableReader::GetSymbol(const std::string& name,
                                      SymbolInformation* info) {
-  return memory_->Is64Bit() ? ScanSymbolTable<Elf64_Sym>(name, info)
-                            : ScanSymbolTable<Elf32_Sym>(name, info);
+  return memory_->Is64Bit() ? LookUpSymbol<Elf64_Sym>(name, info)
+                            : LookUpSymbol<Elf32_Sym>(name, info);
+}
+
+template <typename SymEnt>
+bool ElfSymbolTableReader::LookUpSymbol(const std::string& name,
+                                        SymbolInformation* info) {
+  // A hash table that can't be read, perhaps because it isn't mapped, doesn't
+  // prevent the symbol from being found the slow way.
+  if (gnu_hash_address_) {
+    LookupResult result = LookUpGnuHash<SymEnt>(name, info);
+    if (result != LookupResult::kError) {
+      return result == LookupResult::kFound;
+    }
+  }
+  if (hash_address_) {
+    LookupResult result = LookUpHash<SymEnt>(name, info);
+    if (result != LookupResult::kError) {
+      return result == LookupResult::kFound;
+    }
+  }
+  return ScanSymbolTable<SymEnt>(name, info);
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::ReadSymbol(
+    size_t index,
+    const std::string& name,
+    SymbolInformation* info_out) {
+  if (index >= num_entries_) {
+    LOG(ERROR) << "symbol index " << index << " out of range";
+    return LookupResult::kError;
+  }
+
+  SymEnt entry;
+  if (!memory_->Read(
+          base_address_ + index * sizeof(entry), sizeof(entry), &entry)) {
+    return LookupResult::kError;
+  }
+
+  std::string string;
+  if (!elf_reader_->ReadDynamicStringTableAtOffset(entry.st_name, &string) ||
+      string != name) {
+    return LookupResult::kNotFound;
+  }
+
+  info_out->address = entry.st_value;
+  info_out->size = entry.st_size;
+  info_out->shndx = entry.st_shndx;
+  info_out->binding = GetBinding(entry);
+  info_out->type = GetType(entry);
+  info_out->visibility = GetVisibility(entry);
+  return LookupResult::kFound;
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookUpGnuHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  // The table is laid out as this header, followed by bloom_size Bloom filter
+  // words of the image's native word size, nbuckets bucket words, and then a
+  // chain word for each symbol from symoffset on. See
+  // https://flapenguin.me/2017/05/10/elf-lookup-dt-gnu-hash/.
+  struct {
+    uint32_t nbuckets;
+    uint32_t symoffset;
+    uint32_t bloom_size;
+    uint32_t bloom_shift;
+  } header;
+  if (!memory_->Read(gnu_hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+  if (header.nbuckets == 0 || header.bloom_size == 0) {
+    LOG(ERROR) << "malformed DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+
+  const uint32_t hash = GnuHash(name);
+
+  // Most absent symbols are rejected by the Bloom filter, which has two bits
+  // set for each symbol present.
+  using BloomWord = decltype(SymEnt::st_value);
+  constexpr uint32_t kBloomWordBits = sizeof(BloomWord) * 8;
+  const VMAddress bloom_address = gnu_hash_address_ + sizeof(header);
+  BloomWord bloom_word;
+  if (!memory_->Read(bloom_address + ((hash / kBloomWordBits) %
+                                      header.bloom_size) *
+                                         sizeof(bloom_word),
+                     sizeof(bloom_word),
+                     &bloom_word)) {
+    LOG(ERROR) << "failed to read DT_GNU_HASH Bloom filter";
+    return LookupResult::kError;
+  }
+  const BloomWord bloom_mask =
+      (BloomWord{1} << (hash % kBloomWordBits)) |
+      (BloomWord{1} << ((hash >> header.bloom_shift) % kBloomWordBits));
+  if ((bloom_word & bloom_mask) != bloom_mask) {
+    return LookupResult::kNotFound;
+  }
+
+  const VMAddress buckets_address =
+      bloom_address + header.bloom_size * sizeof(bloom_word);
+  uint32_t index;
+  if (!memory_->Read(buckets_address + (hash % header.nbuckets) * sizeof(index),
+                     sizeof(index),
+                     &index)) {
+    LOG(ERROR) << "failed to read DT_GNU_HASH bucket";
+    return LookupResult::kError;
+  }
+  if (index < header.symoffset) {
+    return LookupResult::kNotFound;
+  }
+
+  // Each chain word holds its symbol's hash with the low bit replaced by a
+  // flag marking the end of the chain.
+  const VMAddress chains_address =
+      buckets_address + header.nbuckets * sizeof(index);
+  for (; index < num_entries_; ++index) {
+    uint32_t chain_hash;
+    if (!memory_->Read(
+            chains_address + (index - header.symoffset) * sizeof(chain_hash),
+            sizeof(chain_hash),
+            &chain_hash)) {
+      LOG(ERROR) << "failed to read DT_GNU_HASH chain";
+      return LookupResult::kError;
+    }
+
+    if ((chain_hash | 1) == (hash | 1)) {
+      LookupResult result = ReadSymbol<SymEnt>(index, name, info);
+      if (result != LookupResult::kNotFound) {
+        return result;
+      }
+    }
+
+    if (chain_hash & 1) {
+      return LookupResult::kNotFound;
+    }
+  }
+
+  LOG(ERROR) << "unterminated DT_GNU_HASH chain";
+  return LookupResult::kError;
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookUpHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  // The table is laid out as nbucket and nchain, followed by nbucket bucket
+  // words and nchain chain words, each 32 bits wide in both ELF classes.
+  struct {
+    uint32_t nbucket;
+    uint32_t nchain;
+  } header;
+  if (!memory_->Read(hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_HASH header";
+    return LookupResult::kError;
+  }
+  if (header.nbucket == 0) {
+    LOG(ERROR) << "malformed DT_HASH header";
+    return LookupResult::kError;
+  }
+
+  const uint32_t hash = ElfHash(name);
+  const VMAddress buckets_address = hash_address_ + sizeof(header);
+  const VMAddress chains_address =
+      buckets_address + header.nbucket * sizeof(uint32_t);
+
+  uint32_t index;
+  if (!memory_->Read(buckets_address + (hash % header.nbucket) * sizeof(index),
+                     sizeof(index),
+                     &index)) {
+    LOG(ERROR) << "failed to read DT_HASH bucket";
+    return LookupResult::kError;
+  }
+
+  // A chain can't be longer than the number of symbols, so a longer one must
+  // loop.
+  for (uint32_t steps = 0; steps < header.nchain; ++steps) {
+    if (index == STN_UNDEF) {
+      return LookupResult::kNotFound;
+    }
+
+    LookupResult result = ReadSymbol<SymEnt>(index, name, info);
+    if (result != LookupResult::kNotFound) {
+      return result;
+    }
+
+    if (index >= header.nchain ||
+        !memory_->Read(chains_address + index * sizeof(index),
+                       sizeof(index),
+                       &index)) {
+      LOG(ERROR) << "failed to read DT_HASH chain";
+      return LookupResult::kError;
+    }
+  }
+
+  LOG(ERROR) << "DT_HASH chain loops";
+  return LookupResult::kError;
 }
 
 template <typename SymEnt>
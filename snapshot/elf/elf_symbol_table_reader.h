@@ -56,12 +56,26 @@ class ElfSymbolTableReader {
     uint8_t visibility;
   };
 
-  // TODO(jperaza): Support using .hash and .gnu.hash sections to improve symbol
-  // lookup.
+  //! \param[in] memory A memory reader for the remote process.
+  //! \param[in] elf_reader The image that contains the symbol table, used to
+  //!     read symbol names from its dynamic string table.
+  //! \param[in] address The address of the symbol table, `DT_SYMTAB`.
+  //! \param[in] num_entries The number of entries in the symbol table.
+  //! \param[in] gnu_hash_address The address of the `DT_GNU_HASH` table, or
+  //!     `0` if the image doesn’t have one.
+  //! \param[in] hash_address The address of the `DT_HASH` table, or `0` if the
+  //!     image doesn’t have one.
+  //!
+  //! Symbols are found with a hash table lookup, using `DT_GNU_HASH` in
+  //! preference to `DT_HASH`, which only reads the symbols in one hash chain.
+  //! Without either table, or if the table can’t be read, every symbol is
+  //! read in turn instead.
   ElfSymbolTableReader(const ProcessMemoryRange* memory,
                        ElfImageReader* elf_reader,
                        VMAddress address,
-                       VMSize num_entries);
+                       VMSize num_entries,
+                       VMAddress gnu_hash_address = 0,
+                       VMAddress hash_address = 0);
 
   ElfSymbolTableReader(const ElfSymbolTableReader&) = delete;
   ElfSymbolTableReader& operator=(const ElfSymbolTableReader&) = delete;
@@ -76,6 +90,27 @@ class ElfSymbolTableReader {
   bool GetSymbol(const std::string& name, SymbolInformation* info);
 
  private:
+  enum class LookupResult {
+    kFound,
+    kNotFound,
+    kError,
+  };
+
+  // Reads symbol |index| and fills |info| from it if it's named |name|.
+  template <typename SymEnt>
+  LookupResult ReadSymbol(size_t index,
+                          const std::string& name,
+                          SymbolInformation* info);
+
+  template <typename SymEnt>
+  LookupResult LookUpGnuHash(const std::string& name, SymbolInformation* info);
+
+  template <typename SymEnt>
+  LookupResult LookUpHash(const std::string& name, SymbolInformation* info);
+
+  template <typename SymEnt>
+  bool LookUpSymbol(const std::string& name, SymbolInformation* info);
+
   template <typename SymEnt>
   bool ScanSymbolTable(const std::string& name, SymbolInformation* info);
 
@@ -83,6 +118,8 @@ class ElfSymbolTableReader {
   ElfImageReader* const elf_reader_;  // weak
   const VMAddress base_address_;
   const VMSize num_entries_;
+  const VMAddress gnu_hash_address_;
+  const VMAddress hash_address_;
 };
 
 }  // namespace crashpad
@@ -0,0 +1,768 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_unwind_table.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "snapshot/elf/elf_image_reader.h"
+
+namespace crashpad {
+
+namespace {
+
+// Pointer encodings, from the Linux Standard Base Core Specification.
+constexpr uint8_t kEncodingFormatMask = 0x0f;
+constexpr uint8_t kEncodingAbsolute = 0x00;
+constexpr uint8_t kEncodingULEB128 = 0x01;
+constexpr uint8_t kEncodingUData2 = 0x02;
+constexpr uint8_t kEncodingUData4 = 0x03;
+constexpr uint8_t kEncodingUData8 = 0x04;
+constexpr uint8_t kEncodingSLEB128 = 0x09;
+constexpr uint8_t kEncodingSData2 = 0x0a;
+constexpr uint8_t kEncodingSData4 = 0x0b;
+constexpr uint8_t kEncodingSData8 = 0x0c;
+constexpr uint8_t kEncodingApplicationMask = 0x70;
+constexpr uint8_t kEncodingPCRelative = 0x10;
+constexpr uint8_t kEncodingIndirect = 0x80;
+
+// Call frame instructions, from the DWARF 5 specification and GNU extensions.
+// The first three carry an operand in their low six bits.
+constexpr uint8_t kCFAAdvanceLoc = 0x40;
+constexpr uint8_t kCFAOffset = 0x80;
+constexpr uint8_t kCFARestore = 0xc0;
+constexpr uint8_t kCFANop = 0x00;
+constexpr uint8_t kCFASetLoc = 0x01;
+constexpr uint8_t kCFAAdvanceLoc1 = 0x02;
+constexpr uint8_t kCFAAdvanceLoc2 = 0x03;
+constexpr uint8_t kCFAAdvanceLoc4 = 0x04;
+constexpr uint8_t kCFAOffsetExtended = 0x05;
+constexpr uint8_t kCFARestoreExtended = 0x06;
+constexpr uint8_t kCFAUndefined = 0x07;
+constexpr uint8_t kCFASameValue = 0x08;
+constexpr uint8_t kCFARegister = 0x09;
+constexpr uint8_t kCFARememberState = 0x0a;
+constexpr uint8_t kCFARestoreState = 0x0b;
+constexpr uint8_t kCFADefCFA = 0x0c;
+constexpr uint8_t kCFADefCFARegister = 0x0d;
+constexpr uint8_t kCFADefCFAOffset = 0x0e;
+constexpr uint8_t kCFADefCFAExpression = 0x0f;
+constexpr uint8_t kCFAExpression = 0x10;
+constexpr uint8_t kCFAOffsetExtendedSF = 0x11;
+constexpr uint8_t kCFADefCFASF = 0x12;
+constexpr uint8_t kCFADefCFAOffsetSF = 0x13;
+constexpr uint8_t kCFAValOffset = 0x14;
+constexpr uint8_t kCFAValOffsetSF = 0x15;
+constexpr uint8_t kCFAValExpression = 0x16;
+constexpr uint8_t kCFAAArch64NegateRAState = 0x2d;
+constexpr uint8_t kCFAGNUArgsSize = 0x2e;
+constexpr uint8_t kCFAGNUNegativeOffsetExtended = 0x2f;
+
+// Records larger than this are assumed to be corrupt. Real entries are rarely
+// more than a few hundred bytes.
+constexpr uint64_t kMaxRecordSize = 64 * 1024;
+
+// The deepest DW_CFA_remember_state nesting accepted.
+constexpr size_t kMaxRememberedStates = 16;
+
+// Reads values from a record that was copied out of the target process,
+// tracking the address in the target that each value came from, which
+// PC-relative pointers are relative to.
+class RecordReader {
+ public:
+  RecordReader(const uint8_t* data,
+               size_t size,
+               VMAddress address,
+               bool is_64_bit)
+      : data_(data),
+        size_(size),
+        offset_(0),
+        address_(address),
+        is_64_bit_(is_64_bit) {}
+
+  RecordReader(const RecordReader&) = delete;
+  RecordReader& operator=(const RecordReader&) = delete;
+
+  VMAddress Address() const { return address_ + offset_; }
+  bool AtEnd() const { return offset_ >= size_; }
+
+  template <typename T>
+  bool Read(T* value) {
+    if (size_ - offset_ < sizeof(*value)) {
+      return false;
+    }
+    memcpy(value, data_ + offset_, sizeof(*value));
+    offset_ += sizeof(*value);
+    return true;
+  }
+
+  bool Skip(uint64_t size) {
+    if (size_ - offset_ < size) {
+      return false;
+    }
+    offset_ += static_cast<size_t>(size);
+    return true;
+  }
+
+  bool ReadCString(const char** string) {
+    const void* end = memchr(data_ + offset_, '\0', size_ - offset_);
+    if (!end) {
+      return false;
+    }
+    *string = reinterpret_cast<const char*>(data_ + offset_);
+    offset_ = static_cast<const uint8_t*>(end) - data_ + 1;
+    return true;
+  }
+
+  bool ReadULEB128(uint64_t* value) {
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+    do {
+      if (!Read(&byte)) {
+        return false;
+      }
+      if (shift < 64) {
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      }
+      shift += 7;
+    } while (byte & 0x80);
+    *value = result;
+    return true;
+  }
+
+  bool ReadSLEB128(int64_t* value) {
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+    do {
+      if (!Read(&byte)) {
+        return false;
+      }
+      if (shift < 64) {
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      }
+      shift += 7;
+    } while (byte & 0x80);
+    if (shift < 64 && (byte & 0x40)) {
+      result |= ~uint64_t{0} << shift;
+    }
+    *value = static_cast<int64_t>(result);
+    return true;
+  }
+
+  // Reads a pointer encoded with encoding. Indirect pointers are not followed,
+  // because nothing needed for unwinding is stored indirectly.
+  bool ReadEncoded(uint8_t encoding, uint64_t* value) {
+    const VMAddress field_address = Address();
+    uint64_t result;
+    switch (encoding & kEncodingFormatMask) {
+      case kEncodingAbsolute:
+        if (is_64_bit_) {
+          if (!Read(&result)) {
+            return false;
+          }
+        } else {
+          uint32_t value32;
+          if (!Read(&value32)) {
+            return false;
+          }
+          result = value32;
+        }
+        break;
+      case kEncodingULEB128:
+        if (!ReadULEB128(&result)) {
+          return false;
+        }
+        break;
+      case kEncodingUData2:
+        if (!ReadExtended<uint16_t>(&result)) {
+          return false;
+        }
+        break;
+      case kEncodingUData4:
+        if (!ReadExtended<uint32_t>(&result)) {
+          return false;
+        }
+        break;
+      case kEncodingUData8:
+      case kEncodingSData8:
+        if (!Read(&result)) {
+          return false;
+        }
+        break;
+      case kEncodingSLEB128: {
+        int64_t signed_result;
+        if (!ReadSLEB128(&signed_result)) {
+          return false;
+        }
+        result = static_cast<uint64_t>(signed_result);
+        break;
+      }
+      case kEncodingSData2:
+        if (!ReadExtended<int16_t>(&result)) {
+          return false;
+        }
+        break;
+      case kEncodingSData4:
+        if (!ReadExtended<int32_t>(&result)) {
+          return false;
+        }
+        break;
+      default:
+        LOG(ERROR) << "unsupported pointer encoding " << std::hex
+                   << static_cast<int>(encoding);
+        return false;
+    }
+
+    switch (encoding & kEncodingApplicationMask) {
+      case 0:
+        break;
+      case kEncodingPCRelative:
+        result += field_address;
+        break;
+      default:
+        LOG(ERROR) << "unsupported pointer application " << std::hex
+                   << static_cast<int>(encoding);
+        return false;
+    }
+
+    if (!is_64_bit_) {
+      result &= 0xffffffff;
+    }
+    *value = result;
+    return true;
+  }
+
+ private:
+  // Reads a T and sign- or zero-extends it to 64 bits.
+  template <typename T>
+  bool ReadExtended(uint64_t* value) {
+    T narrow;
+    if (!Read(&narrow)) {
+      return false;
+    }
+    *value = static_cast<uint64_t>(static_cast<int64_t>(narrow));
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+  VMAddress address_;
+  bool is_64_bit_;
+};
+
+void SetRule(ElfUnwindTable::Row* row,
+             uint64_t reg,
+             ElfUnwindTable::RuleType type,
+             int64_t value) {
+  if (reg < ElfUnwindTable::kRegisterCount) {
+    row->registers[reg] = {type, value};
+  }
+}
+
+// Executes call frame instructions, updating row, until the location passes
+// target. location is the address that the instructions start describing.
+// initial_row holds the rules after the common information entry’s
+// instructions, which DW_CFA_restore returns to, and is nullptr while those
+// instructions are executed.
+bool ExecuteInstructions(RecordReader* reader,
+                         uint64_t code_alignment,
+                         int64_t data_alignment,
+                         uint8_t fde_encoding,
+                         VMAddress location,
+                         VMAddress target,
+                         const ElfUnwindTable::Row* initial_row,
+                         ElfUnwindTable::Row* row) {
+  using RuleType = ElfUnwindTable::RuleType;
+
+  std::vector<ElfUnwindTable::Row> remembered;
+  while (!reader->AtEnd()) {
+    uint8_t opcode;
+    if (!reader->Read(&opcode)) {
+      return false;
+    }
+
+    uint64_t advance = 0;
+    const uint8_t operand = opcode & 0x3f;
+    if ((opcode & 0xc0) == kCFAOffset) {
+      uint64_t offset;
+      if (!reader->ReadULEB128(&offset)) {
+        return false;
+      }
+      SetRule(row,
+              operand,
+              RuleType::kOffset,
+              static_cast<int64_t>(offset) * data_alignment);
+    } else if ((opcode & 0xc0) == kCFARestore) {
+      SetRule(row, operand, RuleType::kUnspecified, 0);
+      if (initial_row && operand < ElfUnwindTable::kRegisterCount) {
+        row->registers[operand] = initial_row->registers[operand];
+      }
+    } else if ((opcode & 0xc0) == kCFAAdvanceLoc) {
+      advance = operand;
+    } else {
+      uint64_t reg = 0;
+      uint64_t unsigned_operand = 0;
+      int64_t signed_operand = 0;
+      switch (opcode) {
+        case kCFANop:
+          break;
+        case kCFASetLoc: {
+          uint64_t new_location;
+          if (!reader->ReadEncoded(fde_encoding, &new_location)) {
+            return false;
+          }
+          if (new_location > target) {
+            return true;
+          }
+          location = new_location;
+          break;
+        }
+        case kCFAAdvanceLoc1: {
+          uint8_t delta;
+          if (!reader->Read(&delta)) {
+            return false;
+          }
+          advance = delta;
+          break;
+        }
+        case kCFAAdvanceLoc2: {
+          uint16_t delta;
+          if (!reader->Read(&delta)) {
+            return false;
+          }
+          advance = delta;
+          break;
+        }
+        case kCFAAdvanceLoc4: {
+          uint32_t delta;
+          if (!reader->Read(&delta)) {
+            return false;
+          }
+          advance = delta;
+          break;
+        }
+        case kCFAOffsetExtended:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          SetRule(row,
+                  reg,
+                  RuleType::kOffset,
+                  static_cast<int64_t>(unsigned_operand) * data_alignment);
+          break;
+        case kCFARestoreExtended:
+          if (!reader->ReadULEB128(&reg)) {
+            return false;
+          }
+          SetRule(row, reg, RuleType::kUnspecified, 0);
+          if (initial_row && reg < ElfUnwindTable::kRegisterCount) {
+            row->registers[reg] = initial_row->registers[reg];
+          }
+          break;
+        case kCFAUndefined:
+          if (!reader->ReadULEB128(&reg)) {
+            return false;
+          }
+          SetRule(row, reg, RuleType::kUndefined, 0);
+          break;
+        case kCFASameValue:
+          if (!reader->ReadULEB128(&reg)) {
+            return false;
+          }
+          SetRule(row, reg, RuleType::kSameValue, 0);
+          break;
+        case kCFARegister:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          SetRule(row,
+                  reg,
+                  RuleType::kRegister,
+                  static_cast<int64_t>(unsigned_operand));
+          break;
+        case kCFARememberState:
+          if (remembered.size() >= kMaxRememberedStates) {
+            LOG(ERROR) << "remembered states nested too deeply";
+            return false;
+          }
+          remembered.push_back(*row);
+          break;
+        case kCFARestoreState:
+          if (remembered.empty()) {
+            LOG(ERROR) << "no remembered state";
+            return false;
+          }
+          *row = remembered.back();
+          remembered.pop_back();
+          break;
+        case kCFADefCFA:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          row->cfa_register = static_cast<uint32_t>(
+              std::min<uint64_t>(reg, ElfUnwindTable::kRegisterCount));
+          row->cfa_offset = static_cast<int64_t>(unsigned_operand);
+          break;
+        case kCFADefCFARegister:
+          if (!reader->ReadULEB128(&reg)) {
+            return false;
+          }
+          row->cfa_register = static_cast<uint32_t>(
+              std::min<uint64_t>(reg, ElfUnwindTable::kRegisterCount));
+          break;
+        case kCFADefCFAOffset:
+          if (!reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          row->cfa_offset = static_cast<int64_t>(unsigned_operand);
+          break;
+        case kCFADefCFAExpression:
+          if (!reader->ReadULEB128(&unsigned_operand) ||
+              !reader->Skip(unsigned_operand)) {
+            return false;
+          }
+          row->cfa_register = ElfUnwindTable::kRegisterCount;
+          break;
+        case kCFAExpression:
+        case kCFAValExpression:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand) ||
+              !reader->Skip(unsigned_operand)) {
+            return false;
+          }
+          SetRule(row, reg, RuleType::kExpression, 0);
+          break;
+        case kCFAOffsetExtendedSF:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadSLEB128(&signed_operand)) {
+            return false;
+          }
+          SetRule(row, reg, RuleType::kOffset, signed_operand * data_alignment);
+          break;
+        case kCFADefCFASF:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadSLEB128(&signed_operand)) {
+            return false;
+          }
+          row->cfa_register = static_cast<uint32_t>(
+              std::min<uint64_t>(reg, ElfUnwindTable::kRegisterCount));
+          row->cfa_offset = signed_operand * data_alignment;
+          break;
+        case kCFADefCFAOffsetSF:
+          if (!reader->ReadSLEB128(&signed_operand)) {
+            return false;
+          }
+          row->cfa_offset = signed_operand * data_alignment;
+          break;
+        case kCFAValOffset:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          SetRule(row,
+                  reg,
+                  RuleType::kValueOffset,
+                  static_cast<int64_t>(unsigned_operand) * data_alignment);
+          break;
+        case kCFAValOffsetSF:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadSLEB128(&signed_operand)) {
+            return false;
+          }
+          SetRule(row,
+                  reg,
+                  RuleType::kValueOffset,
+                  signed_operand * data_alignment);
+          break;
+        case kCFAAArch64NegateRAState:
+          row->return_address_signed = !row->return_address_signed;
+          break;
+        case kCFAGNUArgsSize:
+          if (!reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          break;
+        case kCFAGNUNegativeOffsetExtended:
+          if (!reader->ReadULEB128(&reg) ||
+              !reader->ReadULEB128(&unsigned_operand)) {
+            return false;
+          }
+          SetRule(row,
+                  reg,
+                  RuleType::kOffset,
+                  -static_cast<int64_t>(unsigned_operand) * data_alignment);
+          break;
+        default:
+          LOG(ERROR) << "unsupported call frame instruction " << std::hex
+                     << static_cast<int>(opcode);
+          return false;
+      }
+    }
+
+    if (advance != 0) {
+      const VMAddress new_location = location + advance * code_alignment;
+      if (new_location > target) {
+        return true;
+      }
+      location = new_location;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+ElfUnwindTable::ElfUnwindTable()
+    : common_information_(),
+      image_reader_(nullptr),
+      memory_(nullptr),
+      initialized_() {}
+
+ElfUnwindTable::~ElfUnwindTable() = default;
+
+bool ElfUnwindTable::Initialize(ElfImageReader* image_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  image_reader_ = image_reader;
+  memory_ = image_reader->Memory();
+
+  if (!image_reader_->HasFrameSearchTable()) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ElfUnwindTable::FindRow(VMAddress address, Row* row) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  VMAddress entry_address;
+  if (!image_reader_->FindFrameDescriptionEntry(address, &entry_address)) {
+    return false;
+  }
+
+  std::vector<uint8_t> fde;
+  VMAddress fde_address;
+  if (!ReadRecord(entry_address, &fde, &fde_address)) {
+    return false;
+  }
+  RecordReader reader(fde.data(), fde.size(), fde_address, memory_->Is64Bit());
+
+  uint32_t cie_pointer;
+  if (!reader.Read(&cie_pointer) || cie_pointer == 0) {
+    LOG(ERROR) << "expected FDE";
+    return false;
+  }
+  const CommonInformation* cie = GetCommonInformation(fde_address -
+                                                      cie_pointer);
+  if (!cie) {
+    return false;
+  }
+
+  uint64_t initial_location;
+  uint64_t range;
+  if (!reader.ReadEncoded(cie->fde_encoding, &initial_location) ||
+      !reader.ReadEncoded(cie->fde_encoding & kEncodingFormatMask, &range)) {
+    LOG(ERROR) << "couldn't read FDE range";
+    return false;
+  }
+  if (address < initial_location || address - initial_location >= range) {
+    return false;
+  }
+  if (cie->has_augmentation_data) {
+    uint64_t augmentation_size;
+    if (!reader.ReadULEB128(&augmentation_size) ||
+        !reader.Skip(augmentation_size)) {
+      LOG(ERROR) << "couldn't read FDE augmentation data";
+      return false;
+    }
+  }
+
+  memset(row, 0, sizeof(*row));
+  row->cfa_register = kRegisterCount;
+  row->return_address_register = cie->return_address_register;
+  row->signal_frame = cie->signal_frame;
+
+  RecordReader initial_reader(cie->initial_instructions.data(),
+                              cie->initial_instructions.size(),
+                              0,
+                              memory_->Is64Bit());
+  if (!ExecuteInstructions(&initial_reader,
+                           cie->code_alignment,
+                           cie->data_alignment,
+                           cie->fde_encoding,
+                           initial_location,
+                           address,
+                           nullptr,
+                           row)) {
+    return false;
+  }
+  const Row initial_row = *row;
+  return ExecuteInstructions(&reader,
+                             cie->code_alignment,
+                             cie->data_alignment,
+                             cie->fde_encoding,
+                             initial_location,
+                             address,
+                             &initial_row,
+                             row);
+}
+
+bool ElfUnwindTable::ReadRecord(VMAddress address,
+                                std::vector<uint8_t>* contents,
+                                VMAddress* contents_address) {
+  uint32_t length32;
+  if (!memory_->Read(address, sizeof(length32), &length32)) {
+    return false;
+  }
+  uint64_t length = length32;
+  VMAddress start = address + sizeof(length32);
+  if (length32 == 0xffffffff) {
+    if (!memory_->Read(start, sizeof(length), &length)) {
+      return false;
+    }
+    start += sizeof(length);
+  }
+  if (length == 0 || length > kMaxRecordSize) {
+    LOG(ERROR) << "unexpected call frame information record length "
+               << length;
+    return false;
+  }
+
+  contents->resize(static_cast<size_t>(length));
+  if (!memory_->Read(start, contents->size(), contents->data())) {
+    return false;
+  }
+  *contents_address = start;
+  return true;
+}
+
+const ElfUnwindTable::CommonInformation* ElfUnwindTable::GetCommonInformation(
+    VMAddress address) {
+  auto cached = common_information_.find(address);
+  if (cached != common_information_.end()) {
+    return &cached->second;
+  }
+
+  std::vector<uint8_t> record;
+  VMAddress record_address;
+  if (!ReadRecord(address, &record, &record_address)) {
+    return nullptr;
+  }
+  RecordReader reader(
+      record.data(), record.size(), record_address, memory_->Is64Bit());
+
+  uint32_t id;
+  uint8_t version;
+  const char* augmentation;
+  if (!reader.Read(&id) || id != 0 || !reader.Read(&version) ||
+      (version != 1 && version != 3) || !reader.ReadCString(&augmentation)) {
+    LOG(ERROR) << "unexpected CIE";
+    return nullptr;
+  }
+
+  CommonInformation cie = {};
+  cie.fde_encoding = kEncodingAbsolute;
+  uint64_t return_address_register;
+  if (!reader.ReadULEB128(&cie.code_alignment) ||
+      !reader.ReadSLEB128(&cie.data_alignment)) {
+    LOG(ERROR) << "couldn't read CIE alignment";
+    return nullptr;
+  }
+  if (version == 1) {
+    uint8_t register8;
+    if (!reader.Read(&register8)) {
+      return nullptr;
+    }
+    return_address_register = register8;
+  } else if (!reader.ReadULEB128(&return_address_register)) {
+    return nullptr;
+  }
+  if (return_address_register >= kRegisterCount) {
+    LOG(ERROR) << "unexpected return address register "
+               << return_address_register;
+    return nullptr;
+  }
+  cie.return_address_register =
+      static_cast<uint32_t>(return_address_register);
+
+  if (augmentation[0] == 'z') {
+    cie.has_augmentation_data = true;
+    uint64_t augmentation_size;
+    if (!reader.ReadULEB128(&augmentation_size)) {
+      return nullptr;
+    }
+    const VMAddress augmentation_end = reader.Address() + augmentation_size;
+    for (const char* character = augmentation + 1; *character; ++character) {
+      switch (*character) {
+        case 'L': {
+          uint8_t lsda_encoding;
+          if (!reader.Read(&lsda_encoding)) {
+            return nullptr;
+          }
+          break;
+        }
+        case 'P': {
+          uint8_t personality_encoding;
+          uint64_t personality;
+          if (!reader.Read(&personality_encoding) ||
+              !reader.ReadEncoded(personality_encoding & ~kEncodingIndirect,
+                                  &personality)) {
+            return nullptr;
+          }
+          break;
+        }
+        case 'R':
+          if (!reader.Read(&cie.fde_encoding)) {
+            return nullptr;
+          }
+          break;
+        case 'S':
+          cie.signal_frame = true;
+          break;
+        default:
+          // Other augmentations, such as 'B' and 'G' on ARM64, don’t affect
+          // unwinding, and the augmentation size allows them to be skipped.
+          break;
+      }
+    }
+    if (reader.Address() > augmentation_end ||
+        !reader.Skip(augmentation_end - reader.Address())) {
+      LOG(ERROR) << "couldn't read CIE augmentation data";
+      return nullptr;
+    }
+  } else if (augmentation[0] != '\0') {
+    LOG(ERROR) << "unsupported CIE augmentation " << augmentation;
+    return nullptr;
+  }
+
+  const size_t instructions_offset =
+      static_cast<size_t>(reader.Address() - record_address);
+  cie.initial_instructions.assign(record.begin() + instructions_offset,
+                                  record.end());
+
+  return &common_information_.emplace(address, std::move(cie)).first->second;
+}
+
+}  // namespace crashpad
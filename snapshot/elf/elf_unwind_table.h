@@ -0,0 +1,165 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_ELF_ELF_UNWIND_TABLE_H_
+#define CRASHPAD_SNAPSHOT_ELF_ELF_UNWIND_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+
+class ElfImageReader;
+
+//! \brief A reader for the DWARF call frame information in an ELF image’s
+//!     `.eh_frame` section, mapped into another process.
+//!
+//! Frame description entries are found with
+//! ElfImageReader::FindFrameDescriptionEntry(), which searches the table in the
+//! image’s `.eh_frame_hdr` section. The common information entries that they
+//! refer to are cached as they’re read, so finding the rules for an address
+//! after the first costs a binary search and a read of a single frame
+//! description entry.
+class ElfUnwindTable {
+ public:
+  //! \brief The number of DWARF registers tracked, which covers the general
+  //!     purpose registers on x86-64 and ARM64. Rules for higher-numbered
+  //!     registers, such as vector registers, are ignored.
+  static constexpr uint32_t kRegisterCount = 33;
+
+  //! \brief How a caller’s register is recovered from a frame.
+  enum class RuleType : uint8_t {
+    //! \brief No rule was given. The register is treated as unchanged.
+    kUnspecified = 0,
+
+    //! \brief The register’s value can’t be recovered.
+    kUndefined,
+
+    //! \brief The register is unchanged.
+    kSameValue,
+
+    //! \brief The register is saved at the canonical frame address plus
+    //!     Rule::value.
+    kOffset,
+
+    //! \brief The register’s value is the canonical frame address plus
+    //!     Rule::value.
+    kValueOffset,
+
+    //! \brief The register is saved in the register numbered Rule::value.
+    kRegister,
+
+    //! \brief The register is described by a DWARF expression, which isn’t
+    //!     evaluated.
+    kExpression,
+  };
+
+  //! \brief A rule for recovering a caller’s register.
+  struct Rule {
+    //! \brief How the register is recovered.
+    RuleType type;
+
+    //! \brief An offset or register number, depending on \a type.
+    int64_t value;
+  };
+
+  //! \brief The rules for recovering the caller’s registers at an address.
+  struct Row {
+    //! \brief The register that the canonical frame address is computed from,
+    //!     or #kRegisterCount if it is described by a DWARF expression, which
+    //!     isn’t evaluated.
+    uint32_t cfa_register;
+
+    //! \brief The offset added to \a cfa_register to compute the canonical
+    //!     frame address.
+    int64_t cfa_offset;
+
+    //! \brief The register holding the return address.
+    uint32_t return_address_register;
+
+    //! \brief Whether the frame is a signal handler trampoline, whose
+    //!     return address is the interrupted instruction rather than the one
+    //!     following a call.
+    bool signal_frame;
+
+    //! \brief Whether the return address is signed with an ARM64 pointer
+    //!     authentication code at this address.
+    bool return_address_signed;
+
+    //! \brief The rules for each register, indexed by DWARF register number.
+    Rule registers[kRegisterCount];
+  };
+
+  ElfUnwindTable();
+
+  ElfUnwindTable(const ElfUnwindTable&) = delete;
+  ElfUnwindTable& operator=(const ElfUnwindTable&) = delete;
+
+  ~ElfUnwindTable();
+
+  //! \brief Prepares to read the call frame information of an image.
+  //!
+  //! \param[in] image_reader The image to read. This object does not take
+  //!     ownership of \a image_reader, which must outlive it.
+  //! \return `true` on success. `false` if the image has no usable search
+  //!     table, with a message logged if the table could not be read.
+  bool Initialize(ElfImageReader* image_reader);
+
+  //! \brief Finds the rules for recovering the caller’s registers while \a
+  //!     address is executing.
+  //!
+  //! \param[in] address The address of an instruction in the image.
+  //! \param[out] row The rules in effect at \a address.
+  //! \return `true` on success. `false` if the image has no call frame
+  //!     information for \a address, or it could not be read or interpreted.
+  bool FindRow(VMAddress address, Row* row);
+
+ private:
+  // A common information entry, shared by many frame description entries.
+  struct CommonInformation {
+    uint64_t code_alignment;
+    int64_t data_alignment;
+    uint32_t return_address_register;
+    uint8_t fde_encoding;
+    bool has_augmentation_data;
+    bool signal_frame;
+    std::vector<uint8_t> initial_instructions;
+  };
+
+  // Reads the length-prefixed record at address into contents, and sets
+  // contents_address to the address of the byte after its length.
+  bool ReadRecord(VMAddress address,
+                  std::vector<uint8_t>* contents,
+                  VMAddress* contents_address);
+
+  // Returns the common information entry at address, reading it if necessary,
+  // or nullptr on failure.
+  const CommonInformation* GetCommonInformation(VMAddress address);
+
+  std::map<VMAddress, CommonInformation> common_information_;
+  ElfImageReader* image_reader_;  // weak
+  const ProcessMemoryRange* memory_;  // weak
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_ELF_ELF_UNWIND_TABLE_H_
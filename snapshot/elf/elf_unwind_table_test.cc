@@ -0,0 +1,98 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_unwind_table.h"
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/elf/elf_image_reader.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory_linux.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+__attribute__((noinline)) int UnwindTableTestFunction(int value) {
+  return value * 3 + 1;
+}
+
+class ElfUnwindTableTest : public testing::Test {
+ public:
+  void SetUp() override {
+    Dl_info info;
+    ASSERT_NE(dladdr(reinterpret_cast<void*>(&UnwindTableTestFunction), &info),
+              0);
+
+    ASSERT_TRUE(connection_.Initialize(getpid()));
+    memory_ = std::make_unique<ProcessMemoryLinux>(&connection_);
+    ASSERT_TRUE(range_.Initialize(memory_.get(), connection_.Is64Bit()));
+    ASSERT_TRUE(image_reader_.Initialize(
+        range_, FromPointerCast<VMAddress>(info.dli_fbase)));
+  }
+
+ protected:
+  FakePtraceConnection connection_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  ProcessMemoryRange range_;
+  ElfImageReader image_reader_;
+};
+
+TEST_F(ElfUnwindTableTest, FunctionEntry) {
+  ElfUnwindTable table;
+  ASSERT_TRUE(table.Initialize(&image_reader_));
+
+  const VMAddress function =
+      FromPointerCast<VMAddress>(&UnwindTableTestFunction);
+  ElfUnwindTable::Row row;
+  ASSERT_TRUE(table.FindRow(function, &row));
+  EXPECT_FALSE(row.signal_frame);
+  EXPECT_FALSE(row.return_address_signed);
+
+  // Before a function’s prologue has run, the canonical frame address is the
+  // caller’s stack pointer.
+#if defined(ARCH_CPU_X86_64)
+  EXPECT_EQ(row.cfa_register, 7u);
+  EXPECT_EQ(row.cfa_offset, 8);
+  ASSERT_EQ(row.return_address_register, 16u);
+  EXPECT_EQ(row.registers[16].type, ElfUnwindTable::RuleType::kOffset);
+  EXPECT_EQ(row.registers[16].value, -8);
+#elif defined(ARCH_CPU_ARM64)
+  EXPECT_EQ(row.cfa_register, 31u);
+  EXPECT_EQ(row.cfa_offset, 0);
+  ASSERT_EQ(row.return_address_register, 30u);
+  EXPECT_EQ(row.registers[30].type, ElfUnwindTable::RuleType::kUnspecified);
+#endif
+
+  EXPECT_EQ(UnwindTableTestFunction(1), 4);
+}
+
+TEST_F(ElfUnwindTableTest, OutsideImage) {
+  ElfUnwindTable table;
+  ASSERT_TRUE(table.Initialize(&image_reader_));
+
+  ElfUnwindTable::Row row;
+  EXPECT_FALSE(table.FindRow(image_reader_.Address() - 1, &row));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
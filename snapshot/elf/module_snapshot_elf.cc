@@ -17,15 +17,69 @@
 #include <endian.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "base/files/file_path.h"
+#include "client/indexed_address_range_bag.h"
 #include "snapshot/crashpad_types/image_annotation_reader.h"
+#include "snapshot/crashpad_types/thread_breadcrumb_reader.h"
 #include "snapshot/memory_snapshot_generic.h"
 #include "util/misc/elf_note_types.h"
+#include "util/process/process_memory_accounting.h"
 
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// Reads the populated entries of a TIndexedAddressRangeBag at |address| into
+// |ranges|.
+bool ReadIndexedAddressRanges(const ProcessMemoryRange* memory,
+                              VMAddress address,
+                              std::set<CheckedRange<uint64_t>>* ranges) {
+  // Generous for any reasonable instantiation, while keeping a corrupt header
+  // from causing an enormous read.
+  constexpr uint32_t kMaxEntries = 1024 * 1024;
+
+  IndexedAddressRangeBagHeader header;
+  if (!memory->Read(address, sizeof(header), &header)) {
+    LOG(ERROR) << "could not read indexed extra memory ranges";
+    return false;
+  }
+
+  if (header.magic != IndexedAddressRangeBagHeader::kMagic ||
+      header.version != IndexedAddressRangeBagHeader::kVersion ||
+      header.used_entries > header.num_entries ||
+      header.used_entries > kMaxEntries) {
+    LOG(ERROR) << "invalid indexed extra memory ranges header";
+    return false;
+  }
+
+  // TIndexedAddressRangeBag::Entry is a 64-bit base followed by a 64-bit
+  // size, regardless of the bitness of the process.
+  struct Entry {
+    uint64_t base;
+    uint64_t size;
+  };
+  std::vector<Entry> entries(header.used_entries);
+  if (!entries.empty() &&
+      !memory->Read(address + sizeof(header),
+                    entries.size() * sizeof(entries[0]),
+                    entries.data())) {
+    LOG(ERROR) << "could not read indexed extra memory range entries";
+    return false;
+  }
+
+  for (const Entry& entry : entries) {
+    if (entry.size != 0) {
+      ranges->insert(CheckedRange<uint64_t>(entry.base, entry.size));
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 ModuleSnapshotElf::ModuleSnapshotElf(const std::string& name,
                                      ElfImageReader* elf_reader,
                                      ModuleSnapshot::ModuleType type,
@@ -33,17 +87,24 @@ ModuleSnapshotElf::ModuleSnapshotElf(const std::string& name,
                                      const ProcessMemory* process_memory)
     : ModuleSnapshot(),
       name_(name),
+      build_id_(),
+      build_id_initialized_(false),
       elf_reader_(elf_reader),
+      shallow_module_filter_(nullptr),
       process_memory_range_(process_memory_range),
       process_memory_(process_memory),
       crashpad_info_(),
+      capture_hints_(),
       type_(type),
+      shallow_(false),
       initialized_(),
       streams_() {}
 
 ModuleSnapshotElf::~ModuleSnapshotElf() = default;
 
-bool ModuleSnapshotElf::Initialize() {
+bool ModuleSnapshotElf::Initialize(
+    ModuleMetadataCache* metadata_cache,
+    const ModuleMetadataCache::Key& metadata_key) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (!elf_reader_) {
@@ -51,27 +112,65 @@ bool ModuleSnapshotElf::Initialize() {
     return false;
   }
 
-  // The data payload is only sizeof(VMAddress) in the note, but add a bit to
-  // account for the name, header, and padding.
-  constexpr ssize_t kMaxNoteSize = 256;
-  std::unique_ptr<ElfImageReader::NoteReader> notes =
-      elf_reader_->NotesWithNameAndType(CRASHPAD_ELF_NOTE_NAME,
-                                        CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO,
-                                        kMaxNoteSize);
-  std::string desc;
-  VMAddress info_address;
-  VMAddress desc_address;
-  if (notes->NextNote(nullptr, nullptr, &desc, &desc_address) ==
-      ElfImageReader::NoteReader::Result::kSuccess) {
-    VMOffset offset;
-    if (elf_reader_->Memory()->Is64Bit()) {
-      offset = *reinterpret_cast<VMOffset*>(&desc[0]);
+  // Searching a module’s notes means reading each of its note segments. Most
+  // modules don’t have a CrashpadInfo note, so whether each one does is cached
+  // along with its build ID.
+  VMAddress info_address = 0;
+  bool has_crashpad_info = false;
+  bool crashpad_info_known = false;
+  if (metadata_cache) {
+    std::shared_ptr<const ModuleMetadataCache::Metadata> metadata =
+        metadata_cache->Lookup(metadata_key);
+    if (metadata) {
+      build_id_ = metadata->build_id;
+      has_crashpad_info = metadata->has_crashpad_info;
+      info_address =
+          metadata->crashpad_info_address + elf_reader_->GetLoadBias();
     } else {
-      int32_t offset32 = *reinterpret_cast<int32_t*>(&desc[0]);
-      offset = offset32;
+      build_id_ = ReadBuildID();
+      const ElfImageReader::NoteReader::Result result =
+          FindCrashpadInfoAddress(&info_address);
+      has_crashpad_info =
+          result == ElfImageReader::NoteReader::Result::kSuccess;
+
+      // A module whose notes couldn’t be read is looked at again next time,
+      // rather than taken not to have a CrashpadInfo.
+      if (result != ElfImageReader::NoteReader::Result::kError) {
+        ModuleMetadataCache::Metadata new_metadata;
+        new_metadata.build_id = build_id_;
+        new_metadata.has_crashpad_info = has_crashpad_info;
+        if (has_crashpad_info) {
+          new_metadata.crashpad_info_address =
+              info_address - elf_reader_->GetLoadBias();
+        }
+        metadata_cache->Insert(metadata_key, new_metadata);
+      }
     }
-    info_address = desc_address + offset;
+    build_id_initialized_ = true;
+    crashpad_info_known = true;
+  }
+
+  // A cached entry always records whether the module has a CrashpadInfo, even
+  // for shallow modules, so that the cache doesn’t depend on the filter. A path
+  // match avoids reading the build ID when there’s no cache.
+  if (shallow_module_filter_ && !shallow_module_filter_->empty()) {
+    if (shallow_module_filter_->MatchesPath(name_)) {
+      shallow_ = true;
+    } else if (shallow_module_filter_->HasBuildIDs()) {
+      if (!build_id_initialized_) {
+        build_id_ = ReadBuildID();
+        build_id_initialized_ = true;
+      }
+      shallow_ = shallow_module_filter_->Matches(name_, build_id_);
+    }
+  }
+
+  if (!shallow_ && !crashpad_info_known) {
+    has_crashpad_info = FindCrashpadInfoAddress(&info_address) ==
+                        ElfImageReader::NoteReader::Result::kSuccess;
+  }
 
+  if (!shallow_ && has_crashpad_info) {
     ProcessMemoryRange range;
     if (range.Initialize(*elf_reader_->Memory())) {
       auto info = std::make_unique<CrashpadInfoReader>();
@@ -81,10 +180,67 @@ bool ModuleSnapshotElf::Initialize() {
     }
   }
 
+  // The hints are self-contained, so all of them are read at once.
+  if (crashpad_info_ && crashpad_info_->CaptureHints()) {
+    auto hints = std::make_unique<CaptureHints>();
+    if (process_memory_range_->Read(
+            crashpad_info_->CaptureHints(), sizeof(*hints), hints.get()) &&
+        hints->IsValid()) {
+      capture_hints_ = std::move(hints);
+    } else {
+      LOG(WARNING) << "invalid capture hints in " << name_;
+    }
+  }
+
+  // A module can only ask to be captured shallowly once its CrashpadInfo has
+  // been read, but nothing else from it is used.
+  if (capture_hints_ && capture_hints_->shallow()) {
+    shallow_ = true;
+    capture_hints_.reset();
+    crashpad_info_.reset();
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+ElfImageReader::NoteReader::Result ModuleSnapshotElf::FindCrashpadInfoAddress(
+    VMAddress* address) const {
+  // The data payload is only sizeof(VMAddress) in the note, but add a bit to
+  // account for the name, header, and padding.
+  constexpr ssize_t kMaxNoteSize = 256;
+  std::unique_ptr<ElfImageReader::NoteReader> notes =
+      elf_reader_->NotesWithNameAndType(CRASHPAD_ELF_NOTE_NAME,
+                                        CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO,
+                                        kMaxNoteSize);
+  std::string desc;
+  VMAddress desc_address;
+  const ElfImageReader::NoteReader::Result result =
+      notes->NextNote(nullptr, nullptr, &desc, &desc_address);
+  if (result != ElfImageReader::NoteReader::Result::kSuccess) {
+    return result;
+  }
+
+  VMOffset offset;
+  if (elf_reader_->Memory()->Is64Bit()) {
+    if (desc.size() < sizeof(offset)) {
+      LOG(WARNING) << "CrashpadInfo note too small in " << name_;
+      return ElfImageReader::NoteReader::Result::kNoMoreNotes;
+    }
+    offset = *reinterpret_cast<VMOffset*>(&desc[0]);
+  } else {
+    int32_t offset32;
+    if (desc.size() < sizeof(offset32)) {
+      LOG(WARNING) << "CrashpadInfo note too small in " << name_;
+      return ElfImageReader::NoteReader::Result::kNoMoreNotes;
+    }
+    offset32 = *reinterpret_cast<int32_t*>(&desc[0]);
+    offset = offset32;
+  }
+  *address = desc_address + offset;
+  return ElfImageReader::NoteReader::Result::kSuccess;
+}
+
 bool ModuleSnapshotElf::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
@@ -103,6 +259,15 @@ bool ModuleSnapshotElf::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
   return true;
 }
 
+void ModuleSnapshotElf::GetThreadBreadcrumbs(
+    std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (crashpad_info_ && crashpad_info_->ThreadBreadcrumbs()) {
+    ThreadBreadcrumbReader reader(process_memory_range_);
+    reader.ThreadBreadcrumbs(crashpad_info_->ThreadBreadcrumbs(), breadcrumbs);
+  }
+}
+
 std::string ModuleSnapshotElf::Name() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return name_;
@@ -174,7 +339,10 @@ std::string ModuleSnapshotElf::DebugFileName() const {
 
 std::vector<uint8_t> ModuleSnapshotElf::BuildID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return build_id_initialized_ ? build_id_ : ReadBuildID();
+}
 
+std::vector<uint8_t> ModuleSnapshotElf::ReadBuildID() const {
   std::unique_ptr<ElfImageReader::NoteReader> notes =
       elf_reader_->NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
   std::string desc;
@@ -195,17 +363,32 @@ std::vector<std::string> ModuleSnapshotElf::AnnotationsVector() const {
 std::map<std::string, std::string> ModuleSnapshotElf::AnnotationsSimpleMap()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  ProcessMemoryAccounting::ScopedCategory read_category(
+      ProcessMemoryAccounting::ReadCategory::kAnnotations);
   std::map<std::string, std::string> annotations;
+  if (capture_hints_ && capture_hints_->skip_annotations()) {
+    return annotations;
+  }
   if (crashpad_info_ && crashpad_info_->SimpleAnnotations()) {
     ImageAnnotationReader reader(process_memory_range_);
     reader.SimpleMap(crashpad_info_->SimpleAnnotations(), &annotations);
   }
+  if (crashpad_info_ && crashpad_info_->IndexedSimpleAnnotations()) {
+    ImageAnnotationReader reader(process_memory_range_);
+    reader.IndexedSimpleMap(crashpad_info_->IndexedSimpleAnnotations(),
+                            &annotations);
+  }
   return annotations;
 }
 
 std::vector<AnnotationSnapshot> ModuleSnapshotElf::AnnotationObjects() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  ProcessMemoryAccounting::ScopedCategory read_category(
+      ProcessMemoryAccounting::ReadCategory::kAnnotations);
   std::vector<AnnotationSnapshot> annotations;
+  if (capture_hints_ && capture_hints_->skip_annotations()) {
+    return annotations;
+  }
   if (crashpad_info_ && crashpad_info_->AnnotationsList()) {
     ImageAnnotationReader reader(process_memory_range_);
     reader.AnnotationsList(crashpad_info_->AnnotationsList(), &annotations);
@@ -215,7 +398,22 @@ std::vector<AnnotationSnapshot> ModuleSnapshotElf::AnnotationObjects() const {
 
 std::set<CheckedRange<uint64_t>> ModuleSnapshotElf::ExtraMemoryRanges() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return std::set<CheckedRange<uint64_t>>();
+  std::set<CheckedRange<uint64_t>> ranges;
+  if (capture_hints_) {
+    for (size_t index = 0; index < capture_hints_->copy_range_count();
+         ++index) {
+      const CaptureHints::Range& range = capture_hints_->copy_range(index);
+      if (range.size != 0) {
+        ranges.insert(CheckedRange<uint64_t>(range.base, range.size));
+      }
+    }
+  }
+  if (crashpad_info_ && crashpad_info_->IndexedExtraMemoryRanges()) {
+    ReadIndexedAddressRanges(process_memory_range_,
+                             crashpad_info_->IndexedExtraMemoryRanges(),
+                             &ranges);
+  }
+  return ranges;
 }
 
 std::vector<const UserMinidumpStream*>
@@ -26,7 +26,9 @@
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/crashpad_types/crashpad_info_reader.h"
 #include "snapshot/elf/elf_image_reader.h"
+#include "snapshot/module_metadata_cache.h"
 #include "snapshot/module_snapshot.h"
+#include "snapshot/shallow_module_filter.h"
 #include "util/misc/initialization_state_dcheck.h"
 
 namespace crashpad {
@@ -55,11 +57,32 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
 
   ~ModuleSnapshotElf() override;
 
+  //! \brief Sets a filter selecting modules to capture shallowly.
+  //!
+  //! A module that \a filter selects, or whose CaptureHints request it, is
+  //! captured shallowly: nothing is read from its CrashpadInfo structure, so it
+  //! has no annotations, extra memory ranges, custom streams, breadcrumbs, or
+  //! options. Its name, address range, and build ID are captured as usual.
+  //!
+  //! This must be called before Initialize() to have an effect. This object
+  //! does not take ownership of \a filter, which must outlive Initialize().
+  void SetShallowModuleFilter(const ShallowModuleFilter* filter) {
+    shallow_module_filter_ = filter;
+  }
+
   //! \brief Initializes the object.
   //!
+  //! \param[in] metadata_cache If not `nullptr`, a cache to consult for, and
+  //!     add to, the metadata that this object would otherwise derive from the
+  //!     module’s image.
+  //! \param[in] metadata_key The key identifying this module’s file in \a
+  //!     metadata_cache. Unused if \a metadata_cache is `nullptr`.
+  //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize();
+  bool Initialize(ModuleMetadataCache* metadata_cache = nullptr,
+                  const ModuleMetadataCache::Key& metadata_key =
+                      ModuleMetadataCache::Key());
 
   //! \brief Returns options from the module’s CrashpadInfo structure.
   //!
@@ -67,6 +90,22 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   //! \return `true` if there were options returned. Otherwise `false`.
   bool GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Reads the per-thread breadcrumb buffers registered in the module’s
+  //!     CrashpadInfo structure.
+  //!
+  //! \param[in,out] breadcrumbs The serialized RingBufferData of each buffer
+  //!     read, keyed by thread ID. Threads already present are not replaced.
+  void GetThreadBreadcrumbs(
+      std::map<uint64_t, std::vector<uint8_t>>* breadcrumbs) const;
+
+  //! \brief Returns the CaptureHints registered in the module’s CrashpadInfo
+  //!     structure, or `nullptr` if there are none.
+  const CaptureHints* GetCaptureHints() const { return capture_hints_.get(); }
+
+  //! \return `true` if the module was captured shallowly. See
+  //!     SetShallowModuleFilter().
+  bool IsShallow() const { return shallow_; }
+
   // ModuleSnapshot:
 
   std::string Name() const override;
@@ -92,12 +131,30 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   std::vector<const UserMinidumpStream*> CustomMinidumpStreams() const override;
 
  private:
+  // Reads the build ID from the module’s notes.
+  std::vector<uint8_t> ReadBuildID() const;
+
+  // Finds the address of the module’s CrashpadInfo from its notes. Returns
+  // kSuccess with |address| set if it has one, kNoMoreNotes if it doesn’t, or
+  // kError if its notes couldn’t be read.
+  ElfImageReader::NoteReader::Result FindCrashpadInfoAddress(
+      VMAddress* address) const;
+
   std::string name_;
+
+  // Set by Initialize() when a ModuleMetadataCache is used, otherwise the build
+  // ID is read each time it’s needed.
+  std::vector<uint8_t> build_id_;
+  bool build_id_initialized_;
+
   ElfImageReader* elf_reader_;
+  const ShallowModuleFilter* shallow_module_filter_;  // weak
   ProcessMemoryRange* process_memory_range_;
   const ProcessMemory* process_memory_;
   std::unique_ptr<CrashpadInfoReader> crashpad_info_;
+  std::unique_ptr<CaptureHints> capture_hints_;
   ModuleType type_;
+  bool shallow_;
   InitializationStateDcheck initialized_;
   // Too const-y: https://crashpad.chromium.org/bug/9.
   mutable std::vector<std::unique_ptr<const UserMinidumpStream>> streams_;
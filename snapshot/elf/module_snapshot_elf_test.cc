@@ -0,0 +1,183 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/module_snapshot_elf.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "build/build_config.h"
+#include "client/capture_hints.h"
+#include "client/crashpad_info.h"
+#include "client/simple_string_dictionary.h"
+#include "gtest/gtest.h"
+#include "snapshot/shallow_module_filter.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "test/process_type.h"
+#include "util/linux/auxiliary_vector.h"
+#include "util/linux/memory_map.h"
+#include "util/process/process_memory_linux.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr char kModuleName[] = "/test/module_snapshot_elf_test";
+constexpr char kAnnotationKey[] = "module_snapshot_elf_test";
+
+// Reads this test’s executable, whose CrashpadInfo is set up by the test.
+class SelfModule {
+ public:
+  SelfModule() = default;
+
+  SelfModule(const SelfModule&) = delete;
+  SelfModule& operator=(const SelfModule&) = delete;
+
+  void Initialize() {
+    ASSERT_TRUE(connection_.Initialize(GetSelfProcess()));
+    memory_ = std::make_unique<ProcessMemoryLinux>(&connection_);
+
+    AuxiliaryVector aux;
+    ASSERT_TRUE(aux.Initialize(&connection_));
+    VMAddress phdrs;
+    ASSERT_TRUE(aux.GetValue(AT_PHDR, &phdrs));
+    MemoryMap memory_map;
+    ASSERT_TRUE(memory_map.Initialize(&connection_));
+    const MemoryMap::Mapping* phdr_mapping = memory_map.FindMapping(phdrs);
+    ASSERT_TRUE(phdr_mapping);
+    auto possible_mappings =
+        memory_map.FindFilePossibleMmapStarts(*phdr_mapping);
+    ASSERT_EQ(possible_mappings->Count(), 1u);
+    const VMAddress elf_address = possible_mappings->Next()->range.Base();
+
+#if defined(ARCH_CPU_64_BITS)
+    constexpr bool am_64_bit = true;
+#else
+    constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+    ASSERT_TRUE(range_.Initialize(memory_.get(), am_64_bit));
+    ASSERT_TRUE(reader_.Initialize(range_, elf_address));
+  }
+
+  std::unique_ptr<internal::ModuleSnapshotElf> Snapshot(
+      const ShallowModuleFilter* filter) {
+    auto module = std::make_unique<internal::ModuleSnapshotElf>(
+        kModuleName,
+        &reader_,
+        ModuleSnapshot::kModuleTypeExecutable,
+        &range_,
+        memory_.get());
+    module->SetShallowModuleFilter(filter);
+    EXPECT_TRUE(module->Initialize());
+    return module;
+  }
+
+ private:
+  FakePtraceConnection connection_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  ProcessMemoryRange range_;
+  ElfImageReader reader_;
+};
+
+// Sets an annotation in this module’s CrashpadInfo while in scope.
+class ScopedSelfAnnotation {
+ public:
+  ScopedSelfAnnotation() : annotations_() {
+    annotations_.SetKeyValue(kAnnotationKey, "value");
+    CrashpadInfo::GetCrashpadInfo()->set_simple_annotations(&annotations_);
+  }
+
+  ScopedSelfAnnotation(const ScopedSelfAnnotation&) = delete;
+  ScopedSelfAnnotation& operator=(const ScopedSelfAnnotation&) = delete;
+
+  ~ScopedSelfAnnotation() {
+    CrashpadInfo::GetCrashpadInfo()->set_simple_annotations(nullptr);
+  }
+
+ private:
+  SimpleStringDictionary annotations_;
+};
+
+TEST(ModuleSnapshotElf, ShallowModuleFilter) {
+  ScopedSelfAnnotation annotation;
+  SelfModule self;
+  ASSERT_NO_FATAL_FAILURE(self.Initialize());
+
+  // Without a filter, or with one that doesn’t select the module, the module
+  // is captured fully.
+  std::unique_ptr<internal::ModuleSnapshotElf> module = self.Snapshot(nullptr);
+  EXPECT_FALSE(module->IsShallow());
+  EXPECT_EQ(module->AnnotationsSimpleMap().count(kAnnotationKey), 1u);
+  const std::vector<uint8_t> build_id = module->BuildID();
+
+  ShallowModuleFilter other_filter;
+  other_filter.AddPathPrefix("/usr/lib");
+  other_filter.AddBuildID({0x01, 0x02, 0x03});
+  module = self.Snapshot(&other_filter);
+  EXPECT_FALSE(module->IsShallow());
+  EXPECT_EQ(module->AnnotationsSimpleMap().count(kAnnotationKey), 1u);
+  EXPECT_EQ(module->BuildID(), build_id);
+
+  ShallowModuleFilter path_filter;
+  path_filter.AddPathPrefix("/test/");
+  module = self.Snapshot(&path_filter);
+  EXPECT_TRUE(module->IsShallow());
+  EXPECT_TRUE(module->AnnotationsSimpleMap().empty());
+  EXPECT_FALSE(module->GetCaptureHints());
+  CrashpadInfoClientOptions options;
+  EXPECT_FALSE(module->GetCrashpadOptions(&options));
+  EXPECT_EQ(module->Name(), kModuleName);
+  EXPECT_EQ(module->BuildID(), build_id);
+
+  if (!build_id.empty()) {
+    ShallowModuleFilter build_id_filter;
+    build_id_filter.AddBuildID(build_id);
+    module = self.Snapshot(&build_id_filter);
+    EXPECT_TRUE(module->IsShallow());
+    EXPECT_TRUE(module->AnnotationsSimpleMap().empty());
+    EXPECT_EQ(module->BuildID(), build_id);
+  }
+}
+
+TEST(ModuleSnapshotElf, ShallowCaptureHints) {
+  ScopedSelfAnnotation annotation;
+  SelfModule self;
+  ASSERT_NO_FATAL_FAILURE(self.Initialize());
+
+  CaptureHints hints;
+  char buffer[16];
+  ASSERT_TRUE(hints.AddCopyRange(buffer, sizeof(buffer)));
+  CrashpadInfo* crashpad_info = CrashpadInfo::GetCrashpadInfo();
+  crashpad_info->set_capture_hints(&hints);
+
+  std::unique_ptr<internal::ModuleSnapshotElf> module = self.Snapshot(nullptr);
+  EXPECT_FALSE(module->IsShallow());
+  EXPECT_EQ(module->ExtraMemoryRanges().size(), 1u);
+  EXPECT_EQ(module->AnnotationsSimpleMap().count(kAnnotationKey), 1u);
+
+  hints.set_shallow(true);
+  module = self.Snapshot(nullptr);
+  EXPECT_TRUE(module->IsShallow());
+  EXPECT_TRUE(module->ExtraMemoryRanges().empty());
+  EXPECT_TRUE(module->AnnotationsSimpleMap().empty());
+  EXPECT_FALSE(module->GetCaptureHints());
+
+  crashpad_info->set_capture_hints(nullptr);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
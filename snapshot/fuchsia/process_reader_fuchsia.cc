@@ -18,10 +18,14 @@
 #include <link.h>
 #include <zircon/syscalls.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include "base/check_op.h"
 #include "base/fuchsia/fuchsia_logging.h"
 #include "base/logging.h"
 #include "util/fuchsia/koid_utilities.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -100,6 +104,102 @@ void GetStackRegions(
   // unsafe part of the stack too.
 }
 
+// Reads the name, state, and registers of the thread at handle into thread.
+void ReadThread(const zx::thread& handle,
+                const MemoryMapFuchsia* memory_map,
+                ProcessReaderFuchsia::Thread* thread) {
+  if (!handle.is_valid()) {
+    return;
+  }
+
+  char name[ZX_MAX_NAME_LEN] = {0};
+  zx_status_t status = handle.get_property(ZX_PROP_NAME, &name, sizeof(name));
+  if (status != ZX_OK) {
+    ZX_LOG(WARNING, status) << "zx_object_get_property ZX_PROP_NAME";
+  } else {
+    thread->name.assign(name);
+  }
+
+  zx_info_thread_t thread_info;
+  status = handle.get_info(
+      ZX_INFO_THREAD, &thread_info, sizeof(thread_info), nullptr, nullptr);
+  if (status != ZX_OK) {
+    ZX_LOG(WARNING, status) << "zx_object_get_info ZX_INFO_THREAD";
+  } else {
+    thread->state = thread_info.state;
+  }
+
+  zx_thread_state_general_regs_t general_regs;
+  status = handle.read_state(
+      ZX_THREAD_STATE_GENERAL_REGS, &general_regs, sizeof(general_regs));
+  if (status != ZX_OK) {
+    ZX_LOG(WARNING, status)
+        << "zx_thread_read_state(ZX_THREAD_STATE_GENERAL_REGS)";
+  } else {
+    thread->general_registers = general_regs;
+
+    if (memory_map) {
+      // Attempt to retrive stack regions if a memory map was retrieved.
+      GetStackRegions(general_regs, *memory_map, &thread->stack_regions);
+    }
+  }
+
+// Floating point registers are in the vector context for ARM.
+#if !defined(ARCH_CPU_ARM64)
+  zx_thread_state_fp_regs_t fp_regs;
+  status =
+      handle.read_state(ZX_THREAD_STATE_FP_REGS, &fp_regs, sizeof(fp_regs));
+  if (status != ZX_OK) {
+    ZX_LOG(WARNING, status) << "zx_thread_read_state(ZX_THREAD_STATE_FP_REGS)";
+  } else {
+    thread->fp_registers = fp_regs;
+  }
+#endif
+
+  zx_thread_state_vector_regs_t vector_regs;
+  status = handle.read_state(
+      ZX_THREAD_STATE_VECTOR_REGS, &vector_regs, sizeof(vector_regs));
+  if (status != ZX_OK) {
+    ZX_LOG(WARNING, status)
+        << "zx_thread_read_state(ZX_THREAD_STATE_VECTOR_REGS)";
+  } else {
+    thread->vector_registers = vector_regs;
+  }
+}
+
+// Reads the threads in a shared list, claiming each by index, until none are
+// left.
+class ThreadCaptureWorker : public Thread {
+ public:
+  ThreadCaptureWorker(const std::vector<zx::thread>* handles,
+                      const MemoryMapFuchsia* memory_map,
+                      std::vector<ProcessReaderFuchsia::Thread>* threads,
+                      std::atomic<size_t>* next_index)
+      : Thread(),
+        handles_(handles),
+        memory_map_(memory_map),
+        threads_(threads),
+        next_index_(next_index) {}
+
+  ThreadCaptureWorker(const ThreadCaptureWorker&) = delete;
+  ThreadCaptureWorker& operator=(const ThreadCaptureWorker&) = delete;
+
+  ~ThreadCaptureWorker() override {}
+
+  void ThreadMain() override {
+    size_t index;
+    while ((index = next_index_->fetch_add(1)) < handles_->size()) {
+      ReadThread((*handles_)[index], memory_map_, &(*threads_)[index]);
+    }
+  }
+
+ private:
+  const std::vector<zx::thread>* handles_;
+  const MemoryMapFuchsia* memory_map_;
+  std::vector<ProcessReaderFuchsia::Thread>* threads_;
+  std::atomic<size_t>* next_index_;
+};
+
 }  // namespace
 
 ProcessReaderFuchsia::Module::Module() = default;
@@ -114,10 +214,12 @@ ProcessReaderFuchsia::ProcessReaderFuchsia() = default;
 
 ProcessReaderFuchsia::~ProcessReaderFuchsia() = default;
 
-bool ProcessReaderFuchsia::Initialize(const zx::process& process) {
+bool ProcessReaderFuchsia::Initialize(const zx::process& process,
+                                      size_t thread_capture_threads) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_ = zx::unowned_process(process);
+  thread_capture_threads_ = thread_capture_threads;
 
   process_memory_.reset(new ProcessMemoryFuchsia());
   process_memory_->Initialize(*process_);
@@ -305,72 +407,30 @@ void ProcessReaderFuchsia::InitializeThreads() {
       GetHandlesForThreadKoids(*process_, thread_koids);
   DCHECK_EQ(thread_koids.size(), thread_handles.size());
 
-  for (size_t i = 0; i < thread_handles.size(); ++i) {
-    Thread thread;
-    thread.id = thread_koids[i];
-
-    if (thread_handles[i].is_valid()) {
-      char name[ZX_MAX_NAME_LEN] = {0};
-      zx_status_t status =
-          thread_handles[i].get_property(ZX_PROP_NAME, &name, sizeof(name));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status) << "zx_object_get_property ZX_PROP_NAME";
-      } else {
-        thread.name.assign(name);
-      }
-
-      zx_info_thread_t thread_info;
-      status = thread_handles[i].get_info(
-          ZX_INFO_THREAD, &thread_info, sizeof(thread_info), nullptr, nullptr);
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status) << "zx_object_get_info ZX_INFO_THREAD";
-      } else {
-        thread.state = thread_info.state;
-      }
+  // MemoryMap() is initialized lazily, so retrieve it before any workers
+  // start. It may be null when operating on the current process, where the
+  // memory map can't be retrieved.
+  const MemoryMapFuchsia* memory_map = MemoryMap();
 
-      zx_thread_state_general_regs_t general_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_GENERAL_REGS, &general_regs, sizeof(general_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_GENERAL_REGS)";
-      } else {
-        thread.general_registers = general_regs;
-
-        const MemoryMapFuchsia* memory_map = MemoryMap();
-        if (memory_map) {
-          // Attempt to retrive stack regions if a memory map was retrieved. In
-          // particular, this may be null when operating on the current process
-          // where the memory map will not be able to be retrieved.
-          GetStackRegions(general_regs, *memory_map, &thread.stack_regions);
-        }
-      }
-
-// Floating point registers are in the vector context for ARM.
-#if !defined(ARCH_CPU_ARM64)
-      zx_thread_state_fp_regs_t fp_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_FP_REGS, &fp_regs, sizeof(fp_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_FP_REGS)";
-      } else {
-        thread.fp_registers = fp_regs;
-      }
-#endif
-
-      zx_thread_state_vector_regs_t vector_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_VECTOR_REGS, &vector_regs, sizeof(vector_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_VECTOR_REGS)";
-      } else {
-        thread.vector_registers = vector_regs;
-      }
-    }
+  threads_.resize(thread_handles.size());
+  for (size_t i = 0; i < thread_handles.size(); ++i) {
+    threads_[i].id = thread_koids[i];
+  }
 
-    threads_.push_back(thread);
+  // The calling thread reads threads alongside any additional workers.
+  std::atomic<size_t> next_index(0);
+  std::vector<std::unique_ptr<ThreadCaptureWorker>> workers;
+  for (size_t index = 1;
+       index < std::min(thread_capture_threads_, thread_handles.size());
+       ++index) {
+    workers.push_back(std::make_unique<ThreadCaptureWorker>(
+        &thread_handles, memory_map, &threads_, &next_index));
+    workers.back()->Start();
+  }
+  ThreadCaptureWorker(&thread_handles, memory_map, &threads_, &next_index)
+      .ThreadMain();
+  for (const auto& worker : workers) {
+    worker->Join();
   }
 }
 
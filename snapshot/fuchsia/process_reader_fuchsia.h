@@ -102,11 +102,16 @@ class ProcessReaderFuchsia {
   //!
   //! \param[in] process A process handle with permissions to read properties
   //!     and memory from the target process.
+  //! \param[in] thread_capture_threads The maximum number of threads to use
+  //!     to read the name, state, and registers of the target's threads.
+  //!     Values of 0 or 1 read them on the calling thread. The order of
+  //!     Threads() doesn't depend on this value.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
-  bool Initialize(const zx::process& process);
+  bool Initialize(const zx::process& process,
+                  size_t thread_capture_threads = 0);
 
   //! \return The modules loaded in the process. The first element (at index
   //!     `0`) corresponds to the main executable.
@@ -141,6 +146,7 @@ class ProcessReaderFuchsia {
   std::unique_ptr<ProcessMemoryFuchsia> process_memory_;
   std::unique_ptr<MemoryMapFuchsia> memory_map_;
   zx::unowned_process process_;
+  size_t thread_capture_threads_ = 0;
   bool initialized_modules_ = false;
   bool initialized_threads_ = false;
   bool initialized_memory_map_ = false;
@@ -82,6 +82,27 @@ TEST(ProcessReaderFuchsia, SelfBasic) {
   EXPECT_EQ(threads[0].name, "SelfBasic");
 }
 
+TEST(ProcessReaderFuchsia, SelfThreadCaptureThreads) {
+  const ScopedSetThreadName scoped_set_thread_name("SelfThreadCapture");
+
+  ProcessReaderFuchsia serial_reader;
+  ASSERT_TRUE(serial_reader.Initialize(*zx::process::self()));
+  const auto& serial_threads = serial_reader.Threads();
+
+  ProcessReaderFuchsia parallel_reader;
+  ASSERT_TRUE(parallel_reader.Initialize(*zx::process::self(), 4));
+  const auto& parallel_threads = parallel_reader.Threads();
+
+  // Worker threads are started and joined within Threads(), so they aren't
+  // part of either list, and the results are in the same order.
+  ASSERT_EQ(parallel_threads.size(), serial_threads.size());
+  for (size_t index = 0; index < serial_threads.size(); ++index) {
+    EXPECT_EQ(parallel_threads[index].id, serial_threads[index].id);
+    EXPECT_EQ(parallel_threads[index].name, serial_threads[index].name);
+  }
+  EXPECT_EQ(parallel_threads[0].name, "SelfThreadCapture");
+}
+
 constexpr char kTestMemory[] = "Read me from another process";
 
 CRASHPAD_CHILD_TEST_MAIN(ProcessReaderBasicChildTestMain) {
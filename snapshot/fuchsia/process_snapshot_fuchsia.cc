@@ -23,7 +23,8 @@ ProcessSnapshotFuchsia::ProcessSnapshotFuchsia() = default;
 
 ProcessSnapshotFuchsia::~ProcessSnapshotFuchsia() = default;
 
-bool ProcessSnapshotFuchsia::Initialize(const zx::process& process) {
+bool ProcessSnapshotFuchsia::Initialize(const zx::process& process,
+                                        size_t thread_capture_threads) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
@@ -31,7 +32,7 @@ bool ProcessSnapshotFuchsia::Initialize(const zx::process& process) {
     return false;
   }
 
-  if (!process_reader_.Initialize(process) ||
+  if (!process_reader_.Initialize(process, thread_capture_threads) ||
       !memory_range_.Initialize(process_reader_.Memory(), true)) {
     return false;
   }
@@ -53,10 +53,14 @@ class ProcessSnapshotFuchsia : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] process The process handle to create a snapshot from.
+  //! \param[in] thread_capture_threads The maximum number of threads to use
+  //!     to read the target's per-thread state. See
+  //!     ProcessReaderFuchsia::Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(const zx::process& process);
+  bool Initialize(const zx::process& process,
+                  size_t thread_capture_threads = 0);
 
   //! \brief Initializes the object's exception.
   //!
@@ -114,5 +114,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotFuchsia::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+std::vector<uint8_t> ThreadSnapshotFuchsia::Breadcrumbs() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotFuchsia::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<UnwoundStackFrame>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
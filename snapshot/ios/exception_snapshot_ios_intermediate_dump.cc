@@ -14,6 +14,10 @@
 
 #include "snapshot/ios/exception_snapshot_ios_intermediate_dump.h"
 
+#include <string.h>
+
+#include <vector>
+
 #include "base/apple/mach_logging.h"
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -160,7 +164,7 @@ bool ExceptionSnapshotIOSIntermediateDump::InitializeFromSignal(
         continue;
       if (GetDataValueFromMap(
               region.get(), Key::kThreadContextMemoryRegionAddress, &address)) {
-        const std::vector<uint8_t>& bytes = region_data->bytes();
+        const base::span<const uint8_t> bytes = region_data->bytes();
         vm_size_t data_size = bytes.size();
         if (data_size == 0)
           continue;
@@ -200,15 +204,17 @@ bool ExceptionSnapshotIOSIntermediateDump::InitializeFromMachException(
   const IOSIntermediateDumpData* code_dump =
       GetDataFromMap(exception_data, Key::kCodes);
   if (code_dump) {
-    const std::vector<uint8_t>& bytes = code_dump->bytes();
-    const mach_exception_data_type_t* code =
-        reinterpret_cast<const mach_exception_data_type_t*>(bytes.data());
+    const base::span<const uint8_t> bytes = code_dump->bytes();
     if (bytes.size() == 0 ||
-        bytes.size() % sizeof(mach_exception_data_type_t) != 0 || !code) {
+        bytes.size() % sizeof(mach_exception_data_type_t) != 0 ||
+        !bytes.data()) {
       LOG(ERROR) << "Invalid mach exception code.";
     } else {
       mach_msg_type_number_t code_count =
           bytes.size() / sizeof(mach_exception_data_type_t);
+      // Copy the codes out, as the data may not be suitably aligned for them.
+      std::vector<mach_exception_data_type_t> code(code_count);
+      memcpy(code.data(), bytes.data(), bytes.size());
       for (mach_msg_type_number_t code_index = 0; code_index < code_count;
            ++code_index) {
         codes_.push_back(code[code_index]);
@@ -340,7 +346,8 @@ void ExceptionSnapshotIOSIntermediateDump::LoadContextFromThread(
     const IOSIntermediateDumpData* state_dump =
         GetDataFromMap(exception_data, Key::kState);
     if (state_dump) {
-      std::vector<uint8_t> bytes = state_dump->bytes();
+      const base::span<const uint8_t> state_bytes = state_dump->bytes();
+      std::vector<uint8_t> bytes(state_bytes.begin(), state_bytes.end());
       size_t actual_length = bytes.size();
       size_t expected_length = ThreadStateLengthForFlavor(flavor);
       if (actual_length < expected_length) {
@@ -412,13 +419,16 @@ void ExceptionSnapshotIOSIntermediateDump::
     LoadContextFromUncaughtNSExceptionFrames(
         const IOSIntermediateDumpData* frames_dump,
         const IOSIntermediateDumpMap* other_thread) {
-  const std::vector<uint8_t>& bytes = frames_dump->bytes();
-  const uint64_t* frames = reinterpret_cast<const uint64_t*>(bytes.data());
+  const base::span<const uint8_t> bytes = frames_dump->bytes();
   size_t num_frames = bytes.size() / sizeof(uint64_t);
   if (num_frames < 2) {
     return;
   }
 
+  // Copy the frames out, as the data may not be suitably aligned for them.
+  std::vector<uint64_t> frames(num_frames);
+  memcpy(frames.data(), bytes.data(), num_frames * sizeof(frames[0]));
+
 #if defined(ARCH_CPU_X86_64)
   context_x86_64_.rip = frames[0];  // instruction pointer
   context_x86_64_.rsp = frames[1];
@@ -70,7 +70,7 @@ bool ModuleSnapshotIOSIntermediateDump::Initialize(
   const IOSIntermediateDumpData* uuid_dump =
       GetDataFromMap(image_data, IntermediateDumpKey::kUUID);
   if (uuid_dump) {
-    const std::vector<uint8_t>& bytes = uuid_dump->bytes();
+    const base::span<const uint8_t> bytes = uuid_dump->bytes();
     if (!bytes.data() || bytes.size() != 16) {
       LOG(ERROR) << "Invalid module uuid.";
     } else {
@@ -99,7 +99,7 @@ bool ModuleSnapshotIOSIntermediateDump::Initialize(
       const IOSIntermediateDumpData* value_dump =
           annotation->GetAsData(IntermediateDumpKey::kAnnotationValue);
       if (type_dump && value_dump && type_dump->GetValue<uint16_t>(&type)) {
-        const std::vector<uint8_t>& bytes = value_dump->bytes();
+        const base::span<const uint8_t> bytes = value_dump->bytes();
         uint64_t length = bytes.size();
         if (!bytes.data() || length > Annotation::kValueMaxSize) {
           LOG(ERROR) << "Invalid annotation value, size=" << length
@@ -107,7 +107,8 @@ bool ModuleSnapshotIOSIntermediateDump::Initialize(
                      << ", discarding annotation.";
           continue;
         }
-        annotation_objects_.push_back(AnnotationSnapshot(name, type, bytes));
+        annotation_objects_.push_back(AnnotationSnapshot(
+            name, type, std::vector<uint8_t>(bytes.begin(), bytes.end())));
       }
     }
   }
@@ -130,18 +130,21 @@ bool ThreadSnapshotIOSIntermediateDump::Initialize(
     GetDataValueFromMap(
         thread_data, Key::kStackRegionAddress, &stack_region_address);
 
-    const std::vector<uint8_t>& bytes = thread_stack_data_dump->bytes();
+    const base::span<const uint8_t> bytes = thread_stack_data_dump->bytes();
     const vm_address_t stack_region_data =
         reinterpret_cast<const vm_address_t>(bytes.data());
     vm_size_t stack_region_size = bytes.size();
     stack_.Initialize(
         stack_region_address, stack_region_data, stack_region_size);
   } else if (nsexception_frames) {
-    const std::vector<uint8_t>& bytes = nsexception_frames->bytes();
-    const uint64_t* frames = reinterpret_cast<const uint64_t*>(bytes.data());
-    size_t frame_count = bytes.size() / sizeof(uint64_t);
+    const base::span<const uint8_t> bytes = nsexception_frames->bytes();
+    // Copy the frames out, as the data may not be suitably aligned for them.
+    std::vector<uint64_t> frames(bytes.size() / sizeof(uint64_t));
+    if (!frames.empty()) {
+      memcpy(frames.data(), bytes.data(), frames.size() * sizeof(frames[0]));
+    }
     exception_stack_memory_ =
-        GenerateStackMemoryFromFrames(frames, frame_count);
+        GenerateStackMemoryFromFrames(frames.data(), frames.size());
     vm_address_t stack_memory_addr =
         !exception_stack_memory_.empty()
             ? reinterpret_cast<vm_address_t>(&exception_stack_memory_[0])
@@ -186,7 +189,7 @@ bool ThreadSnapshotIOSIntermediateDump::Initialize(
         continue;
       if (GetDataValueFromMap(
               region.get(), Key::kThreadContextMemoryRegionAddress, &address)) {
-        const std::vector<uint8_t>& bytes = region_data->bytes();
+        const base::span<const uint8_t> bytes = region_data->bytes();
         vm_size_t data_size = bytes.size();
         if (data_size == 0)
           continue;
@@ -249,5 +252,14 @@ ThreadSnapshotIOSIntermediateDump::ExtraMemory() const {
   return extra_memory;
 }
 
+std::vector<uint8_t> ThreadSnapshotIOSIntermediateDump::Breadcrumbs() const {
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame>
+ThreadSnapshotIOSIntermediateDump::UnwoundFrames() const {
+  return std::vector<UnwoundStackFrame>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
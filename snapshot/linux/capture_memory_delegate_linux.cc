@@ -18,6 +18,7 @@
 
 #include "base/numerics/safe_conversions.h"
 #include "snapshot/memory_snapshot_generic.h"
+#include "util/process/process_memory_accounting.h"
 
 namespace crashpad {
 namespace internal {
@@ -40,8 +41,22 @@ bool CaptureMemoryDelegateLinux::Is64Bit() const {
 bool CaptureMemoryDelegateLinux::ReadMemory(uint64_t at,
                                             uint64_t num_bytes,
                                             void* into) const {
-  return process_reader_->Memory()->Read(
-      at, base::checked_cast<size_t>(num_bytes), into);
+  const size_t size = base::checked_cast<size_t>(num_bytes);
+  internal::MemoryReadCache* read_cache = process_reader_->ReadCache();
+  if (read_cache->Read(at, size, into)) {
+    return true;
+  }
+
+  ProcessMemoryAccounting::ScopedCategory read_category(
+      ProcessMemoryAccounting::ReadCategory::kIndirectMemory);
+  if (!process_reader_->Memory()->Read(at, size, into)) {
+    return false;
+  }
+
+  // Memory is only read here to be scanned for pointers. It’s usually a stack,
+  // which will be read again when it’s written.
+  read_cache->Retain(at, into, size);
+  return true;
 }
 
 std::vector<CheckedRange<uint64_t>>
@@ -55,21 +70,26 @@ void CaptureMemoryDelegateLinux::AddNewMemorySnapshot(
   // Don't bother storing this memory if it points back into the stack.
   if (stack_.ContainsRange(range))
     return;
-  if (range.size() == 0)
+  if (process_reader_->IsSkippedMemoryRange(range))
     return;
-  if (!budget_remaining_ || *budget_remaining_ == 0)
-    return;
-  snapshots_->push_back(std::make_unique<internal::MemorySnapshotGeneric>());
-  internal::MemorySnapshotGeneric* snapshot = snapshots_->back().get();
-  snapshot->Initialize(process_reader_->Memory(), range.base(), range.size());
-  if (!base::IsValueInRangeForNumericType<int64_t>(range.size())) {
-    *budget_remaining_ = 0;
-  } else {
-    int64_t temp = *budget_remaining_;
-    temp -= range.size();
-    *budget_remaining_ = base::saturated_cast<uint32_t>(temp);
+  MemorySnapshotGeneric* snapshot = CaptureMemory::AddCoalescedMemorySnapshot(
+      process_reader_->Memory(),
+      range,
+      CaptureMemory::kCoalescingDistance,
+      *this,
+      snapshots_,
+      budget_remaining_);
+  if (snapshot) {
+    snapshot->set_read_category(
+        ProcessMemoryAccounting::ReadCategory::kIndirectMemory);
+    snapshot->set_read_cache(process_reader_->ReadCache());
   }
 }
 
+bool CaptureMemoryDelegateLinux::GetAddressBounds(uint64_t* low,
+                                                  uint64_t* high) const {
+  return process_reader_->GetMemoryMap()->GetAddressBounds(low, high);
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -56,6 +56,7 @@ class CaptureMemoryDelegateLinux : public CaptureMemory::Delegate {
       const CheckedRange<uint64_t, uint64_t>& range) const override;
   void AddNewMemorySnapshot(
       const CheckedRange<uint64_t, uint64_t>& range) override;
+  bool GetAddressBounds(uint64_t* low, uint64_t* high) const override;
 
  private:
   CheckedRange<uint64_t, uint64_t> stack_;
@@ -57,6 +57,8 @@ struct LinkEntrySpecific {
   typename Traits::Address l_prev;
 };
 
+// Reads the entry at *address, except for its name, and advances *address to
+// the next entry.
 template <typename Traits>
 bool ReadLinkEntry(const ProcessMemoryRange& memory,
                    LinuxVMAddress* address,
@@ -66,34 +68,44 @@ bool ReadLinkEntry(const ProcessMemoryRange& memory,
     return false;
   }
 
-  std::string name;
-  if (!memory.ReadCStringSizeLimited(entry.l_name, 4096, &name)) {
-    name.clear();
-  }
-
+  entry_out->name.clear();
+  entry_out->name_address = entry.l_name;
   entry_out->load_bias = entry.l_addr;
   entry_out->dynamic_array = entry.l_ld;
-  entry_out->name.swap(name);
 
   *address = entry.l_next;
   return true;
 }
 
+void ReadLinkEntryName(const ProcessMemoryRange& memory,
+                       DebugRendezvous::LinkEntry* entry) {
+  if (!memory.ReadCStringSizeLimited(entry->name_address, 4096, &entry->name)) {
+    entry->name.clear();
+  }
+}
+
 }  // namespace
 
 DebugRendezvous::LinkEntry::LinkEntry()
-    : name(), load_bias(0), dynamic_array(0) {}
+    : name(), name_address(0), load_bias(0), dynamic_array(0) {}
 
 DebugRendezvous::DebugRendezvous()
-    : modules_(), executable_(), initialized_() {}
+    : executable_(),
+      pending_module_(),
+      has_pending_module_(false),
+      visited_(),
+      next_address_(0),
+      memory_(nullptr),
+      initialized_() {}
 
 DebugRendezvous::~DebugRendezvous() {}
 
 bool DebugRendezvous::Initialize(const ProcessMemoryRange& memory,
                                  LinuxVMAddress address) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
-  if (!(memory.Is64Bit() ? InitializeSpecific<Traits64>(memory, address)
-                         : InitializeSpecific<Traits32>(memory, address))) {
+  memory_ = &memory;
+  if (!(memory.Is64Bit() ? InitializeSpecific<Traits64>(address)
+                         : InitializeSpecific<Traits32>(address))) {
     return false;
   }
   INITIALIZATION_STATE_SET_VALID(initialized_);
@@ -105,17 +117,27 @@ const DebugRendezvous::LinkEntry* DebugRendezvous::Executable() const {
   return &executable_;
 }
 
-const std::vector<DebugRendezvous::LinkEntry>& DebugRendezvous::Modules()
-    const {
+bool DebugRendezvous::NextModule(LinkEntry* entry) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (has_pending_module_) {
+    *entry = pending_module_;
+    entry->name.clear();
+    has_pending_module_ = false;
+    return true;
+  }
+  return memory_->Is64Bit() ? NextModuleSpecific<Traits64>(entry)
+                            : NextModuleSpecific<Traits32>(entry);
+}
+
+void DebugRendezvous::ReadName(LinkEntry* entry) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return modules_;
+  ReadLinkEntryName(*memory_, entry);
 }
 
 template <typename Traits>
-bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
-                                         LinuxVMAddress address) {
+bool DebugRendezvous::InitializeSpecific(LinuxVMAddress address) {
   DebugRendezvousSpecific<Traits> debug;
-  if (!memory.Read(address, sizeof(debug), &debug)) {
+  if (!memory_->Read(address, sizeof(debug), &debug)) {
     return false;
   }
   if (debug.r_version != 1) {
@@ -123,37 +145,47 @@ bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
     return false;
   }
 
-  LinuxVMAddress link_entry_address = debug.r_map;
-  if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &executable_)) {
+  next_address_ = debug.r_map;
+  if (!ReadLinkEntry<Traits>(*memory_, &next_address_, &executable_)) {
     return false;
   }
-
-  std::set<LinuxVMAddress> visited;
-  while (link_entry_address) {
-    if (!visited.insert(link_entry_address).second) {
-      LOG(ERROR) << "cycle at address 0x" << std::hex << link_entry_address;
-      return false;
-    }
-
-    LinkEntry entry;
-    if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &entry)) {
-      return false;
-    }
-    modules_.push_back(entry);
-  }
+  ReadLinkEntryName(*memory_, &executable_);
 
 #if BUILDFLAG(IS_ANDROID)
   // Android P (API 28) mistakenly places the vdso in the first entry in the
   // link map.
   const int android_runtime_api = android_get_device_api_level();
   if (android_runtime_api == 28 && executable_.name == "[vdso]") {
-    LinkEntry executable = modules_[0];
-    modules_[0] = executable_;
-    executable_ = executable;
+    LinkEntry executable;
+    if (NextModuleSpecific<Traits>(&executable)) {
+      ReadLinkEntryName(*memory_, &executable);
+      pending_module_ = executable_;
+      has_pending_module_ = true;
+      executable_ = executable;
+    }
   }
 #endif  // BUILDFLAG(IS_ANDROID)
 
   return true;
 }
 
+template <typename Traits>
+bool DebugRendezvous::NextModuleSpecific(LinkEntry* entry) {
+  if (!next_address_) {
+    return false;
+  }
+
+  if (!visited_.insert(next_address_).second) {
+    LOG(ERROR) << "cycle at address 0x" << std::hex << next_address_;
+    next_address_ = 0;
+    return false;
+  }
+
+  if (!ReadLinkEntry<Traits>(*memory_, &next_address_, entry)) {
+    next_address_ = 0;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace crashpad
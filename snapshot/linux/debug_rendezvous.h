@@ -15,8 +15,8 @@
 #ifndef CRASHPAD_SNAPSHOT_LINUX_DEBUG_RENDEZVOUS_H_
 #define CRASHPAD_SNAPSHOT_LINUX_DEBUG_RENDEZVOUS_H_
 
+#include <set>
 #include <string>
-#include <vector>
 
 #include "util/linux/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -26,6 +26,10 @@ namespace crashpad {
 
 //! \brief Reads an `r_debug` struct defined in `<link.h>` via
 //!     ProcessMemoryRange.
+//!
+//! The entries of the link map are read one at a time as they are asked for,
+//! so that a caller that finds what it needs, or runs out of time, doesn’t pay
+//! for the rest of the list. Module names are only read on request.
 class DebugRendezvous {
  public:
   //! \brief An entry in the dynamic linker's list of loaded objects.
@@ -36,8 +40,14 @@ class DebugRendezvous {
     LinkEntry();
 
     //! \brief A filename identifying the object.
+    //!
+    //! This is only populated for entries returned by NextModule() once
+    //! ReadName() is called for them.
     std::string name;
 
+    //! \brief The address of the object’s filename in the target process.
+    LinuxVMAddress name_address;
+
     //! \brief The difference between the preferred load address in the ELF file
     //!     and the actual loaded address in memory.
     VMAddress load_bias;
@@ -53,34 +63,55 @@ class DebugRendezvous {
 
   ~DebugRendezvous();
 
-  //! \brief Initializes this object by reading an `r_debug` struct from a
-  //!     target process.
+  //! \brief Initializes this object by reading an `r_debug` struct and the
+  //!     executable’s link map entry from a target process.
   //!
   //! This method must be called successfully prior to calling any other method
   //! in this class.
   //!
-  //! \param[in] memory A memory reader for the remote process.
+  //! \param[in] memory A memory reader for the remote process. It must outlive
+  //!     this object.
   //! \param[in] address The address of an `r_debug` struct in the remote
   //!     process.
   //! \return `true` on success. `false` on failure with a message logged.
   bool Initialize(const ProcessMemoryRange& memory, LinuxVMAddress address);
 
-  //! \brief Returns the LinkEntry for the main executable.
+  //! \brief Returns the LinkEntry for the main executable, including its name.
   const LinkEntry* Executable() const;
 
-  //! \brief Returns a vector of modules found in the link map.
+  //! \brief Reads the next module in the link map.
+  //!
+  //! The modules exclude the entry for the executable and may include entries
+  //! for the VDSO and loader. LinkEntry::name is left empty. Call ReadName()
+  //! for the entries that need it.
   //!
-  //! This list excludes the entry for the executable and may include entries
-  //! for the VDSO and loader.
-  const std::vector<LinkEntry>& Modules() const;
+  //! \param[out] entry The next module.
+  //! \return `true` on success. `false` at the end of the link map, or on
+  //!     failure with a message logged. Once this returns `false`, it continues
+  //!     to do so.
+  bool NextModule(LinkEntry* entry);
+
+  //! \brief Reads \a entry’s name into LinkEntry::name, leaving it empty if
+  //!     the name can’t be read.
+  void ReadName(LinkEntry* entry) const;
 
  private:
   template <typename Traits>
-  bool InitializeSpecific(const ProcessMemoryRange& memory,
-                          LinuxVMAddress address);
+  bool InitializeSpecific(LinuxVMAddress address);
+
+  template <typename Traits>
+  bool NextModuleSpecific(LinkEntry* entry);
 
-  std::vector<LinkEntry> modules_;
   LinkEntry executable_;
+
+  // On Android P, the link map’s first module is the real executable, so it
+  // takes the place of the first entry, which becomes this pending module.
+  LinkEntry pending_module_;
+  bool has_pending_module_;
+
+  std::set<LinuxVMAddress> visited_;
+  LinuxVMAddress next_address_;
+  const ProcessMemoryRange* memory_;  // weak
   InitializationStateDcheck initialized_;
 };
 
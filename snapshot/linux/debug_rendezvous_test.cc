@@ -136,7 +136,11 @@ void TestAgainstTarget(PtraceConnection* connection) {
     EXPECT_EQ(debug.Executable()->load_bias, 0u);
   }
 
-  for (const DebugRendezvous::LinkEntry& module : debug.Modules()) {
+  DebugRendezvous::LinkEntry module;
+  while (debug.NextModule(&module)) {
+    EXPECT_TRUE(module.name.empty());
+    debug.ReadName(&module);
+
     SCOPED_TRACE(base::StringPrintf("name %s, load_bias 0x%" PRIx64
                                     ", dynamic_array 0x%" PRIx64,
                                     module.name.c_str(),
@@ -223,6 +227,9 @@ void TestAgainstTarget(PtraceConnection* connection) {
         connection->Is64Bit(), module_reader->Address(), module_reader->Size());
     EXPECT_TRUE(module_range.ContainsValue(module.dynamic_array));
   }
+
+  // The end of the link map stays the end.
+  EXPECT_FALSE(debug.NextModule(&module));
 }
 
 TEST(DebugRendezvous, Self) {
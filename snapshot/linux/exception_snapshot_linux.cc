@@ -391,18 +391,8 @@ bool ExceptionSnapshotLinux::Initialize(
     LOG(WARNING) << "thread ID " << thread_id << " not found in process";
   }
 
-  if (process_reader->Is64Bit()) {
-    if (!ReadContext<ContextTraits64>(process_reader, context_address) ||
-        !ReadSiginfo<Traits64>(process_reader, siginfo_address)) {
-      return false;
-    }
-  } else {
-#if !defined(ARCH_CPU_RISCV64)
-    if (!ReadContext<ContextTraits32>(process_reader, context_address) ||
-        !ReadSiginfo<Traits32>(process_reader, siginfo_address)) {
-      return false;
-    }
-#endif
+  if (!ReadSignal(process_reader, siginfo_address, context_address)) {
+    return false;
   }
 
   CaptureMemoryDelegateLinux capture_memory_delegate(
@@ -416,6 +406,37 @@ bool ExceptionSnapshotLinux::Initialize(
   return true;
 }
 
+bool ExceptionSnapshotLinux::InitializeSignalOnly(
+    ProcessReaderLinux* process_reader,
+    LinuxVMAddress siginfo_address,
+    LinuxVMAddress context_address,
+    pid_t thread_id) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  thread_id_ = thread_id;
+  if (!ReadSignal(process_reader, siginfo_address, context_address)) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ExceptionSnapshotLinux::ReadSignal(ProcessReaderLinux* process_reader,
+                                        LinuxVMAddress siginfo_address,
+                                        LinuxVMAddress context_address) {
+  if (process_reader->Is64Bit()) {
+    return ReadContext<ContextTraits64>(process_reader, context_address) &&
+           ReadSiginfo<Traits64>(process_reader, siginfo_address);
+  }
+#if !defined(ARCH_CPU_RISCV64)
+  return ReadContext<ContextTraits32>(process_reader, context_address) &&
+         ReadSiginfo<Traits32>(process_reader, siginfo_address);
+#else
+  return true;
+#endif
+}
+
 template <typename Traits>
 bool ExceptionSnapshotLinux::ReadSiginfo(ProcessReaderLinux* reader,
                                          LinuxVMAddress siginfo_address) {
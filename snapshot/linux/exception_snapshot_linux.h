@@ -62,6 +62,29 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
                   pid_t thread_id,
                   uint32_t* gather_indirectly_referenced_memory_cap);
 
+  //! \brief Initializes the object with only the signal and the context it was
+  //!     received in.
+  //!
+  //! Unlike Initialize(), this doesn’t look up the thread that received the
+  //! signal among \a process_reader’s threads, so the threads aren’t read, and
+  //! ExtraMemory() is empty. This is enough to identify the crash before the
+  //! rest of the process is captured.
+  //!
+  //! \param[in] process_reader A ProcessReaderLinux for the process that
+  //!     received the signal.
+  //! \param[in] siginfo_address The address in the target process' address
+  //!     space of the siginfo_t passed to the signal handler.
+  //! \param[in] context_address The address in the target process' address
+  //!     space of the ucontext_t passed to the signal handler.
+  //! \param[in] thread_id The thread ID of the thread that received the signal.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeSignalOnly(ProcessReaderLinux* process_reader,
+                            LinuxVMAddress siginfo_address,
+                            LinuxVMAddress context_address,
+                            pid_t thread_id);
+
   // ExceptionSnapshot:
 
   const CPUContext* Context() const override;
@@ -73,6 +96,11 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const override;
 
  private:
+  // Reads the siginfo and context for Initialize() or InitializeSignalOnly().
+  bool ReadSignal(ProcessReaderLinux* process_reader,
+                  LinuxVMAddress siginfo_address,
+                  LinuxVMAddress context_address);
+
   template <typename Traits>
   bool ReadSiginfo(ProcessReaderLinux* reader, LinuxVMAddress siginfo_address);
 
@@ -359,6 +359,37 @@ TEST(ExceptionSnapshotLinux, SelfBasic) {
   ExpectContext(*exception.Context(), context);
 }
 
+TEST(ExceptionSnapshotLinux, SelfSignalOnly) {
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+
+  siginfo_t siginfo;
+  siginfo.si_signo = SIGSEGV;
+  siginfo.si_errno = 42;
+  siginfo.si_code = SEGV_MAPERR;
+  siginfo.si_addr = reinterpret_cast<void*>(0xdeadbeef);
+
+  NativeCPUContext context;
+  InitializeContext(&context);
+
+  internal::ExceptionSnapshotLinux exception;
+  ASSERT_TRUE(
+      exception.InitializeSignalOnly(&process_reader,
+                                     FromPointerCast<LinuxVMAddress>(&siginfo),
+                                     FromPointerCast<LinuxVMAddress>(&context),
+                                     gettid()));
+  EXPECT_EQ(exception.ThreadID(), static_cast<uint64_t>(gettid()));
+  EXPECT_EQ(exception.Exception(), static_cast<uint32_t>(siginfo.si_signo));
+  EXPECT_EQ(exception.ExceptionInfo(), static_cast<uint32_t>(siginfo.si_code));
+  EXPECT_EQ(exception.ExceptionAddress(),
+            FromPointerCast<uint64_t>(siginfo.si_addr));
+  ExpectContext(*exception.Context(), context);
+  EXPECT_TRUE(exception.ExtraMemory().empty());
+}
+
 class ScopedSigactionRestore {
  public:
   ScopedSigactionRestore() : old_action_(), signo_(-1), valid_(false) {}
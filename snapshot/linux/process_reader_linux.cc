@@ -19,6 +19,7 @@
 #include <sched.h>
 #include <string.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -29,6 +30,8 @@
 #include "snapshot/linux/debug_rendezvous.h"
 #include "util/linux/auxiliary_vector.h"
 #include "util/linux/proc_stat_reader.h"
+#include "util/linux/proc_task_reader.h"
+#include "util/stdlib/string_number_conversion.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include <android/api-level.h>
@@ -38,6 +41,10 @@ namespace crashpad {
 
 namespace {
 
+// Stacks scanned for pointers are kept, up to this total size, so that they
+// needn't be read from the target process again when they're written.
+constexpr size_t kMaxRetainedMemoryBytes = 16 * 1024 * 1024;
+
 bool ShouldMergeStackMappings(const MemoryMap::Mapping& stack_mapping,
                               const MemoryMap::Mapping& adj_mapping) {
   DCHECK(stack_mapping.readable);
@@ -47,6 +54,35 @@ bool ShouldMergeStackMappings(const MemoryMap::Mapping& stack_mapping,
           stack_mapping.name.empty() || adj_mapping.name.empty());
 }
 
+// Returns true if syscall_number is a system call that threads wait in when
+// they have nothing to do.
+bool IsIdleSyscall(int syscall_number) {
+  switch (syscall_number) {
+    case __NR_futex:
+    case __NR_epoll_pwait:
+    case __NR_ppoll:
+    case __NR_pselect6:
+    case __NR_nanosleep:
+    case __NR_clock_nanosleep:
+    case __NR_rt_sigtimedwait:
+#if defined(__NR_epoll_wait)
+    case __NR_epoll_wait:
+#endif
+#if defined(__NR_poll)
+    case __NR_poll:
+#endif
+#if defined(__NR_select)
+    case __NR_select:
+#endif
+#if defined(__NR_pause)
+    case __NR_pause:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 ProcessReaderLinux::Thread::Thread()
@@ -56,14 +92,26 @@ ProcessReaderLinux::Thread::Thread()
       name(),
       tid(-1),
       static_priority(-1),
-      nice_value(-1) {}
+      nice_value(-1),
+      have_floating_point(false) {}
 
 ProcessReaderLinux::Thread::~Thread() {}
 
-bool ProcessReaderLinux::Thread::InitializePtrace(
-    PtraceConnection* connection) {
-  if (!connection->GetThreadInfo(tid, &thread_info)) {
-    return false;
+bool ProcessReaderLinux::Thread::InitializePtrace(PtraceConnection* connection,
+                                                  bool floating_point) {
+  if (const ThreadInfo* captured = connection->CapturedThreadInfo(tid)) {
+    thread_info = *captured;
+    have_floating_point = true;
+  } else if (floating_point) {
+    if (!connection->GetThreadInfo(tid, &thread_info)) {
+      return false;
+    }
+    have_floating_point = true;
+  } else {
+    if (!connection->GetThreadInfoWithoutFloatingPoint(tid, &thread_info)) {
+      return false;
+    }
+    have_floating_point = false;
   }
 
   // From man proc(5):
@@ -208,29 +256,56 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
 }
 
 ProcessReaderLinux::Module::Module()
-    : name(), elf_reader(nullptr), type(ModuleSnapshot::kModuleTypeUnknown) {}
+    : name(),
+      elf_reader(nullptr),
+      type(ModuleSnapshot::kModuleTypeUnknown),
+      device(0),
+      inode(0) {}
 
 ProcessReaderLinux::Module::~Module() = default;
 
 ProcessReaderLinux::ProcessReaderLinux()
     : connection_(),
+      task_directory_(),
+      task_file_contents_(),
       process_info_(),
       memory_map_(),
       threads_(),
       modules_(),
       elf_readers_(),
+      module_memory_cache_(),
+      read_cache_(kMaxRetainedMemoryBytes),
+      memory_accounting_(nullptr),
+      deadline_(),
+      skipped_memory_ranges_(),
       is_64_bit_(false),
       initialized_threads_(false),
       initialized_modules_(false),
+      threads_truncated_(false),
+      modules_truncated_(false),
+      read_thread_floating_point_(true),
       initialized_() {}
 
-ProcessReaderLinux::~ProcessReaderLinux() {}
+ProcessReaderLinux::~ProcessReaderLinux() {
+  if (memory_accounting_) {
+    SetMemoryAccounting(nullptr);
+  }
+}
 
-bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
+bool ProcessReaderLinux::Initialize(PtraceConnection* connection,
+                                    size_t module_memory_cache_pages) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   DCHECK(connection);
   connection_ = connection;
 
+  if (module_memory_cache_pages > 0) {
+    module_memory_cache_ = std::make_unique<ProcessMemoryCaching>();
+    if (!module_memory_cache_->Initialize(connection_->Memory(),
+                                          module_memory_cache_pages)) {
+      return false;
+    }
+  }
+
   if (!process_info_.InitializeWithPtrace(connection_)) {
     return false;
   }
@@ -241,10 +316,70 @@ bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
 
   is_64_bit_ = process_info_.Is64Bit();
 
+  // Files for each thread are read relative to this directory when possible.
+  task_directory_ = connection_->OpenTaskDirectory();
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+void ProcessReaderLinux::SetMemoryAccounting(
+    ProcessMemoryAccounting* accounting) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  memory_accounting_ = accounting;
+  connection_->Memory()->SetAccounting(accounting);
+  if (module_memory_cache_) {
+    module_memory_cache_->SetAccounting(accounting);
+  }
+}
+
+bool ProcessReaderLinux::IsSkippedMemoryRange(
+    const CheckedRange<uint64_t>& range) const {
+  for (const CheckedRange<uint64_t>& skipped : skipped_memory_ranges_) {
+    if (skipped.OverlapsRange(range)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ProcessReaderLinux::ThreadIsIdle(const Thread& thread) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // System call numbers differ between 32-bit and 64-bit processes, and only
+  // this process' own numbers are known.
+  if (is_64_bit_ != (sizeof(void*) == 8)) {
+    return false;
+  }
+
+  // A thread that captured its own state is blocked in a signal handler, so
+  // what it was doing before can't be determined from /proc.
+  if (connection_->CapturedThreadInfo(thread.tid)) {
+    return false;
+  }
+
+  // From man proc(5), /proc/[pid]/syscall contains the number of the system
+  // call that the thread is blocked in, followed by its arguments, or "-1" or
+  // "running" if it isn't blocked in a system call.
+  std::string& contents = task_file_contents_;
+  if (task_directory_.is_valid()) {
+    if (!ReadTaskFile(
+            task_directory_.get(), thread.tid, "syscall", &contents)) {
+      return false;
+    }
+  } else {
+    const std::string path = base::StringPrintf(
+        "/proc/%d/task/%d/syscall", ProcessID(), thread.tid);
+    if (!connection_->ReadFileContents(base::FilePath(path), &contents)) {
+      return false;
+    }
+  }
+  int syscall_number;
+  return StringToNumber(contents.substr(0, contents.find(' ')),
+                        &syscall_number) &&
+         IsIdleSyscall(syscall_number);
+}
+
 bool ProcessReaderLinux::StartTime(timeval* start_time) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return process_info_.StartTime(start_time);
@@ -263,7 +398,9 @@ bool ProcessReaderLinux::CPUTimes(timeval* user_time,
 
   for (const Thread& thread : threads_) {
     ProcStatReader stat;
-    if (!stat.Initialize(connection_, thread.tid)) {
+    if (!(task_directory_.is_valid()
+              ? stat.Initialize(task_directory_.get(), thread.tid)
+              : stat.Initialize(connection_, thread.tid))) {
       return false;
     }
 
@@ -294,6 +431,24 @@ const std::vector<ProcessReaderLinux::Thread>& ProcessReaderLinux::Threads() {
   return threads_;
 }
 
+const ProcessReaderLinux::Thread* ProcessReaderLinux::AddThread(pid_t tid) {
+  for (const Thread& thread : Threads()) {
+    if (thread.tid == tid) {
+      return &thread;
+    }
+  }
+
+  Thread thread;
+  thread.tid = tid;
+  if (!connection_->Attach(tid) ||
+      !thread.InitializePtrace(connection_, true)) {
+    return nullptr;
+  }
+  thread.InitializeStack(this);
+  threads_.push_back(thread);
+  return &threads_.back();
+}
+
 const std::vector<ProcessReaderLinux::Module>& ProcessReaderLinux::Modules() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (!initialized_modules_) {
@@ -393,7 +548,7 @@ void ProcessReaderLinux::InitializeThreads() {
 
   Thread main_thread;
   main_thread.tid = pid;
-  if (main_thread.InitializePtrace(connection_)) {
+  if (main_thread.InitializePtrace(connection_, read_thread_floating_point_)) {
     main_thread.InitializeStack(this);
     threads_.push_back(main_thread);
   } else {
@@ -404,21 +559,52 @@ void ProcessReaderLinux::InitializeThreads() {
   std::vector<pid_t> thread_ids;
   bool result = connection_->Threads(&thread_ids);
   DCHECK(result);
-  for (pid_t tid : thread_ids) {
-    if (tid == pid) {
-      DCHECK(!main_thread_found);
-      main_thread_found = true;
-      continue;
+  threads_.reserve(thread_ids.size());
+
+  // Attach to threads in batches, so that the threads in a batch stop
+  // concurrently rather than one at a time, and then read each attached
+  // thread’s registers. The deadline is checked between batches. Threads that
+  // captured their own state aren't attached to.
+  static constexpr size_t kAttachBatchSize = 64;
+  std::vector<pid_t> batch;
+  std::vector<pid_t> attached;
+  auto thread_id = thread_ids.begin();
+  while (thread_id != thread_ids.end()) {
+    if (deadline_.Expired()) {
+      LOG(WARNING) << "deadline expired, skipping threads";
+      threads_truncated_ = true;
+      break;
     }
 
-    Thread thread;
-    thread.tid = tid;
-    if (connection_->Attach(tid) && thread.InitializePtrace(connection_)) {
-      thread.InitializeStack(this);
-      threads_.push_back(thread);
+    batch.clear();
+    for (; thread_id != thread_ids.end() && batch.size() < kAttachBatchSize;
+         ++thread_id) {
+      if (*thread_id == pid) {
+        DCHECK(!main_thread_found);
+        main_thread_found = true;
+        continue;
+      }
+      batch.push_back(*thread_id);
+    }
+
+    attached.clear();
+    auto captured = std::stable_partition(
+        batch.begin(), batch.end(), [this](pid_t tid) {
+          return connection_->CapturedThreadInfo(tid) == nullptr;
+        });
+    attached.insert(attached.end(), captured, batch.end());
+    batch.erase(captured, batch.end());
+    connection_->AttachThreads(batch, &attached);
+    for (pid_t tid : attached) {
+      Thread thread;
+      thread.tid = tid;
+      if (thread.InitializePtrace(connection_, read_thread_floating_point_)) {
+        thread.InitializeStack(this);
+        threads_.push_back(thread);
+      }
     }
   }
-  DCHECK(main_thread_found);
+  DCHECK(main_thread_found || threads_truncated_);
 }
 
 void ProcessReaderLinux::InitializeModules() {
@@ -436,7 +622,11 @@ void ProcessReaderLinux::InitializeModules() {
   }
 
   ProcessMemoryRange range;
-  if (!range.Initialize(Memory(), is_64_bit_)) {
+  if (!range.Initialize(module_memory_cache_
+                            ? static_cast<const ProcessMemory*>(
+                                  module_memory_cache_.get())
+                            : Memory(),
+                        is_64_bit_)) {
     return;
   }
 
@@ -490,6 +680,8 @@ void ProcessReaderLinux::InitializeModules() {
                                                : exe_mapping->name;
   exe.elf_reader = exe_reader.get();
   exe.type = ModuleSnapshot::ModuleType::kModuleTypeExecutable;
+  exe.device = exe_mapping->device;
+  exe.inode = exe_mapping->inode;
 
   modules_.push_back(exe);
   elf_readers_.push_back(std::move(exe_reader));
@@ -497,7 +689,16 @@ void ProcessReaderLinux::InitializeModules() {
   LinuxVMAddress loader_base = 0;
   aux.GetValue(AT_BASE, &loader_base);
 
-  for (const DebugRendezvous::LinkEntry& entry : debug.Modules()) {
+  // The link map is walked as modules are added, so that nothing more of it is
+  // read once the deadline expires.
+  DebugRendezvous::LinkEntry entry;
+  while (debug.NextModule(&entry)) {
+    if (deadline_.Expired()) {
+      LOG(WARNING) << "deadline expired, skipping modules";
+      modules_truncated_ = true;
+      break;
+    }
+
     const MemoryMap::Mapping* module_mapping = nullptr;
     std::unique_ptr<ElfImageReader> elf_reader;
     {
@@ -550,12 +751,17 @@ void ProcessReaderLinux::InitializeModules() {
     if (elf_reader->SoName(&soname) && !soname.empty()) {
       module.name = soname;
     } else {
+      // The link map’s name is only needed without a soname, which most
+      // shared libraries have.
+      debug.ReadName(&entry);
       module.name = !entry.name.empty() ? entry.name : module_mapping->name;
     }
     module.elf_reader = elf_reader.get();
     module.type = loader_base && elf_reader->Address() == loader_base
                       ? ModuleSnapshot::kModuleTypeDynamicLoader
                       : ModuleSnapshot::kModuleTypeSharedLibrary;
+    module.device = module_mapping->device;
+    module.inode = module_mapping->inode;
     modules_.push_back(module);
     elf_readers_.push_back(std::move(elf_reader));
   }
@@ -20,17 +20,24 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "snapshot/elf/elf_image_reader.h"
+#include "snapshot/memory_read_cache.h"
 #include "snapshot/module_snapshot.h"
+#include "util/file/file_io.h"
 #include "util/linux/address_types.h"
 #include "util/linux/memory_map.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/linux/thread_info.h"
+#include "util/misc/deadline.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/numeric/checked_range.h"
 #include "util/posix/process_info.h"
 #include "util/process/process_memory.h"
+#include "util/process/process_memory_accounting.h"
+#include "util/process/process_memory_caching.h"
 
 namespace crashpad {
 
@@ -70,10 +77,14 @@ class ProcessReaderLinux {
     //!     all valid.
     bool have_priorities;
 
+    //! \brief `true` if the floating-point registers in `thread_info` were
+    //!     read. Otherwise, they are zero.
+    bool have_floating_point;
+
    private:
     friend class ProcessReaderLinux;
 
-    bool InitializePtrace(PtraceConnection* connection);
+    bool InitializePtrace(PtraceConnection* connection, bool floating_point);
     void InitializeStack(ProcessReaderLinux* reader);
   };
 
@@ -96,6 +107,12 @@ class ProcessReaderLinux {
 
     //! \brief The module's type.
     ModuleSnapshot::ModuleType type;
+
+    //! \brief The device and inode of the file that the module was mapped
+    //!     from, as reported in the target process’ memory map. \a inode is 0
+    //!     if the module was not mapped from a file.
+    dev_t device;
+    ino_t inode;
   };
 
   ProcessReaderLinux();
@@ -111,8 +128,15 @@ class ProcessReaderLinux {
   //! this class and may only be called once.
   //!
   //! \param[in] connection A PtraceConnection to the target process.
+  //! \param[in] module_memory_cache_pages If nonzero, the ELF images of loaded
+  //!     modules are read through a cache of up to this many pages of the
+  //!     target process’ memory, retained for the lifetime of this object.
+  //!     This avoids repeatedly reading the same headers, dynamic arrays, and
+  //!     symbol tables, but must only be used while the target process is
+  //!     suspended.
   //! \return `true` on success. `false` on failure with a message logged.
-  bool Initialize(PtraceConnection* connection);
+  bool Initialize(PtraceConnection* connection,
+                  size_t module_memory_cache_pages = 0);
 
   //! \brief Return `true` if the target task is a 64-bit process.
   bool Is64Bit() const { return is_64_bit_; }
@@ -126,6 +150,25 @@ class ProcessReaderLinux {
   //! \brief Return a memory reader for the target process.
   const ProcessMemoryLinux* Memory() const { return connection_->Memory(); }
 
+  //! \brief Return the cache used by readers of module images, or `nullptr`
+  //!     if module memory is not cached.
+  const ProcessMemoryCaching* ModuleMemoryCache() const {
+    return module_memory_cache_.get();
+  }
+
+  //! \brief Return the cache shared by this process’ memory snapshots, which
+  //!     pools their staging buffers and retains memory scanned for pointers.
+  internal::MemoryReadCache* ReadCache() { return &read_cache_; }
+
+  //! \brief Counts the reads made through Memory() and ModuleMemoryCache().
+  //!
+  //! See ProcessMemory::SetAccounting(). Reads stop being counted when this
+  //! object is destroyed.
+  //!
+  //! \param[in] accounting The object to record reads in, or `nullptr` to stop
+  //!     counting reads.
+  void SetMemoryAccounting(ProcessMemoryAccounting* accounting);
+
   //! \brief Return a memory map of the target process.
   MemoryMap* GetMemoryMap() { return &memory_map_; }
 
@@ -148,15 +191,82 @@ class ProcessReaderLinux {
   //!     time spent executing code in user or system mode.
   bool CPUTimes(timeval* user_time, timeval* system_time) const;
 
+  //! \brief Sets a deadline after which Threads() and Modules() stop
+  //!     enumerating.
+  //!
+  //! Threads and modules found before the deadline expires are returned as
+  //! usual. Threads not yet found are not attached to, and so are not
+  //! suspended. This must be called before Threads() or Modules() to have an
+  //! effect.
+  //!
+  //! \param[in] deadline The deadline.
+  void SetDeadline(const Deadline& deadline) { deadline_ = deadline; }
+
+  //! \brief Sets whether Threads() reads the floating-point and vector
+  //!     registers of threads that didn’t capture their own state.
+  //!
+  //! Leaving those registers out saves a system call for each thread. Threads
+  //! added by AddThread() and threads whose state was supplied by
+  //! PtraceConnection::SetCapturedThreadInfo() always have them. This must be
+  //! called before Threads() to have an effect.
+  //!
+  //! \param[in] read `true`, the default, to read the registers.
+  void SetReadThreadFloatingPoint(bool read) {
+    read_thread_floating_point_ = read;
+  }
+
+  //! \brief Sets ranges of the target process’ memory that snapshots mustn’t
+  //!     capture, other than as part of a thread’s stack.
+  //!
+  //! \param[in] ranges The ranges to skip.
+  void SetSkippedMemoryRanges(std::vector<CheckedRange<uint64_t>> ranges) {
+    skipped_memory_ranges_ = std::move(ranges);
+  }
+
+  //! \return `true` if \a range overlaps a range set by
+  //!     SetSkippedMemoryRanges().
+  bool IsSkippedMemoryRange(const CheckedRange<uint64_t>& range) const;
+
+  //! \brief Determines whether a thread appears to be idle.
+  //!
+  //! A thread is considered idle if it is blocked in a system call that
+  //! threads wait in when they have nothing to do, such as `futex()`,
+  //! `epoll_wait()`, or `nanosleep()`. This reads a file from `/proc` for the
+  //! thread.
+  //!
+  //! \param[in] thread A thread returned by Threads().
+  //! \return `true` if \a thread appears to be idle. `false` if it doesn’t,
+  //!     or if this couldn’t be determined.
+  bool ThreadIsIdle(const Thread& thread);
+
   //! \brief Return a vector of threads that are in the task process. If the
   //!     main thread is able to be identified and traced, it will be placed at
   //!     index `0`.
   const std::vector<Thread>& Threads();
 
+  //! \return `true` if Threads() stopped enumerating threads because the
+  //!     deadline set by SetDeadline() expired.
+  bool ThreadsTruncated() const { return threads_truncated_; }
+
+  //! \brief Adds a thread that Threads() did not return because enumeration
+  //!     was truncated.
+  //!
+  //! This invalidates references to elements of the vector returned by
+  //! Threads().
+  //!
+  //! \param[in] tid The thread ID of the thread to add.
+  //! \return The thread, or `nullptr` if it could not be attached to. If the
+  //!     thread had already been found, the existing thread is returned.
+  const Thread* AddThread(pid_t tid);
+
   //! \return The modules loaded in the process. The first element (at index
   //!     `0`) corresponds to the main executable.
   const std::vector<Module>& Modules();
 
+  //! \return `true` if Modules() stopped enumerating modules because the
+  //!     deadline set by SetDeadline() expired.
+  bool ModulesTruncated() const { return modules_truncated_; }
+
   //! \return On Android, the abort message that was passed to
   //!     android_set_abort_message(). This is only available on Q or later.
   const std::string& AbortMessage();
@@ -169,15 +279,25 @@ class ProcessReaderLinux {
   void ReadAbortMessage(const MemoryMap::Mapping* mapping);
 
   PtraceConnection* connection_;  // weak
+  ScopedFileHandle task_directory_;
+  std::string task_file_contents_;
   ProcessInfo process_info_;
   MemoryMap memory_map_;
   std::vector<Thread> threads_;
   std::vector<Module> modules_;
   std::string abort_message_;
   std::vector<std::unique_ptr<ElfImageReader>> elf_readers_;
+  std::unique_ptr<ProcessMemoryCaching> module_memory_cache_;
+  internal::MemoryReadCache read_cache_;
+  ProcessMemoryAccounting* memory_accounting_;  // weak
+  Deadline deadline_;
+  std::vector<CheckedRange<uint64_t>> skipped_memory_ranges_;
   bool is_64_bit_;
   bool initialized_threads_;
   bool initialized_modules_;
+  bool threads_truncated_;
+  bool modules_truncated_;
+  bool read_thread_floating_point_;
   InitializationStateDcheck initialized_;
 };
 
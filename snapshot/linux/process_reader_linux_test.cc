@@ -30,7 +30,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "base/format_macros.h"
 #include "base/memory/free_deleter.h"
@@ -50,6 +52,8 @@
 #include "util/file/filesystem.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/misc/address_sanitizer.h"
+#include "util/misc/clock.h"
+#include "util/misc/deadline.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/misc/memory_sanitizer.h"
 #include "util/posix/scoped_mmap.h"
@@ -336,8 +340,10 @@ void ExpectThreads(const ThreadMap& thread_map,
 
 class ChildThreadTest : public Multiprocess {
  public:
-  ChildThreadTest(size_t stack_size = 0)
-      : Multiprocess(), stack_size_(stack_size) {}
+  ChildThreadTest(size_t stack_size = 0, bool expired_deadline = false)
+      : Multiprocess(),
+        stack_size_(stack_size),
+        expired_deadline_(expired_deadline) {}
 
   ChildThreadTest(const ChildThreadTest&) = delete;
   ChildThreadTest& operator=(const ChildThreadTest&) = delete;
@@ -372,6 +378,30 @@ class ChildThreadTest : public Multiprocess {
 
     ProcessReaderLinux process_reader;
     ASSERT_TRUE(process_reader.Initialize(&connection));
+    if (expired_deadline_) {
+      const Deadline deadline = Deadline::FromNow(1);
+      SleepNanoseconds(1000);
+      process_reader.SetDeadline(deadline);
+
+      // Only the main thread is found, but other threads can be added.
+      ASSERT_EQ(process_reader.Threads().size(), 1u);
+      EXPECT_EQ(process_reader.Threads()[0].tid, ChildPID());
+      EXPECT_TRUE(process_reader.ThreadsTruncated());
+      for (const auto& thread : thread_map) {
+        const ProcessReaderLinux::Thread* added =
+            process_reader.AddThread(thread.first);
+        ASSERT_TRUE(added);
+        EXPECT_EQ(added->tid, thread.first);
+      }
+
+      // Only the executable is found.
+      ASSERT_EQ(process_reader.Modules().size(), 1u);
+      EXPECT_EQ(process_reader.Modules()[0].type,
+                ModuleSnapshot::kModuleTypeExecutable);
+      EXPECT_TRUE(process_reader.ModulesTruncated());
+    } else {
+      EXPECT_FALSE(process_reader.ThreadsTruncated());
+    }
     const std::vector<ProcessReaderLinux::Thread>& threads =
         process_reader.Threads();
     ExpectThreads(thread_map, thread_name_map, threads, &connection);
@@ -439,6 +469,7 @@ class ChildThreadTest : public Multiprocess {
 
   static constexpr size_t kThreadCount = 3;
   const size_t stack_size_;
+  const bool expired_deadline_;
 };
 
 TEST(ProcessReaderLinux, ChildWithThreads) {
@@ -446,6 +477,11 @@ TEST(ProcessReaderLinux, ChildWithThreads) {
   test.Run();
 }
 
+TEST(ProcessReaderLinux, ChildWithThreadsAfterDeadline) {
+  ChildThreadTest test(/* stack_size= */ 0, /* expired_deadline= */ true);
+  test.Run();
+}
+
 TEST(ProcessReaderLinux, ChildThreadsWithSmallUserStacks) {
   ChildThreadTest test(PTHREAD_STACK_MIN);
   test.Run();
@@ -611,6 +647,7 @@ void ExpectTestModule(ProcessReaderLinux* reader,
   for (const auto& module : reader->Modules()) {
     if (module.name.find(module_name) != std::string::npos) {
       ASSERT_TRUE(module.elf_reader);
+      EXPECT_NE(module.inode, 0u);
 
       VMAddress dynamic_addr;
       ASSERT_TRUE(module.elf_reader->GetDynamicArrayAddress(&dynamic_addr));
@@ -694,6 +731,66 @@ TEST(ProcessReaderLinux, ChildModules) {
   test.Run();
 }
 
+class IdleThreadTest : public Multiprocess {
+ public:
+  IdleThreadTest() : Multiprocess() {}
+
+  IdleThreadTest(const IdleThreadTest&) = delete;
+  IdleThreadTest& operator=(const IdleThreadTest&) = delete;
+
+  ~IdleThreadTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    pid_t idle_tid;
+    CheckedReadFileExactly(ReadPipeHandle(), &idle_tid, sizeof(idle_tid));
+
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ProcessReaderLinux process_reader;
+    ASSERT_TRUE(process_reader.Initialize(&connection));
+
+    const std::vector<ProcessReaderLinux::Thread>& threads =
+        process_reader.Threads();
+    ASSERT_EQ(threads.size(), 2u);
+    for (const ProcessReaderLinux::Thread& thread : threads) {
+      if (thread.tid == idle_tid) {
+        EXPECT_TRUE(process_reader.ThreadIsIdle(thread));
+      } else {
+        // The main thread is blocked reading the pipe, which doesn't count as
+        // waiting for work.
+        EXPECT_EQ(thread.tid, ChildPID());
+        EXPECT_FALSE(process_reader.ThreadIsIdle(thread));
+      }
+    }
+  }
+
+  void MultiprocessChild() override {
+    Semaphore started(0);
+    pid_t idle_tid = -1;
+    std::thread idle_thread([&started, &idle_tid]() {
+      idle_tid = gettid();
+      started.Signal();
+      while (true) {
+        pause();
+      }
+    });
+    started.Wait();
+
+    // Give the thread a chance to block in pause().
+    SleepNanoseconds(100 * 1000 * 1000);
+    CheckedWriteFile(WritePipeHandle(), &idle_tid, sizeof(idle_tid));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+    idle_thread.detach();
+  }
+};
+
+TEST(ProcessReaderLinux, ChildIdleThread) {
+  IdleThreadTest test;
+  test.Run();
+}
+
 #if BUILDFLAG(IS_ANDROID)
 const char kTestAbortMessage[] = "test abort message";
 
@@ -14,39 +14,238 @@
 
 #include "snapshot/linux/process_snapshot_linux.h"
 
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
 #include <utility>
 
+#include "base/files/scoped_file.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
 #include "build/build_config.h"
+#include "snapshot/capture_memory.h"
+#include "snapshot/memory_read_cache.h"
 #include "util/linux/exception_information.h"
+#include "util/linux/memory_map.h"
+#include "util/misc/range_set.h"
+#include "util/string/split_string.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
+namespace {
+
+// Initializes the modules in a shared list, claiming each by index, until none
+// are left. Modules that fail to initialize are released.
+class ModuleInitializationThread : public Thread {
+ public:
+  // metadata_cache is optional. If given, metadata_keys is parallel to
+  // modules, and modules whose key has an empty file_identity don’t use the
+  // cache.
+  ModuleInitializationThread(
+      std::vector<ArenaPtr<internal::ModuleSnapshotElf>>* modules,
+      ModuleMetadataCache* metadata_cache,
+      const std::vector<ModuleMetadataCache::Key>* metadata_keys,
+      std::atomic<size_t>* next_index,
+      const Deadline* deadline,
+      std::atomic<bool>* truncated)
+      : Thread(),
+        modules_(modules),
+        metadata_cache_(metadata_cache),
+        metadata_keys_(metadata_keys),
+        next_index_(next_index),
+        deadline_(deadline),
+        truncated_(truncated) {}
+
+  ModuleInitializationThread(const ModuleInitializationThread&) = delete;
+  ModuleInitializationThread& operator=(const ModuleInitializationThread&) =
+      delete;
+
+  ~ModuleInitializationThread() override {}
+
+  void ThreadMain() override {
+    ProcessMemoryAccounting::ScopedCategory read_category(
+        ProcessMemoryAccounting::ReadCategory::kModuleHeaders);
+    size_t index;
+    while ((index = next_index_->fetch_add(1)) < modules_->size()) {
+      ArenaPtr<internal::ModuleSnapshotElf>& module = (*modules_)[index];
+      // The executable is always captured.
+      if (index != 0 && deadline_->Expired()) {
+        *truncated_ = true;
+        module.reset();
+      } else if (metadata_cache_ &&
+                 !(*metadata_keys_)[index].file_identity.empty()) {
+        if (!module->Initialize(metadata_cache_, (*metadata_keys_)[index])) {
+          module.reset();
+        }
+      } else if (!module->Initialize()) {
+        module.reset();
+      }
+    }
+  }
+
+ private:
+  std::vector<ArenaPtr<internal::ModuleSnapshotElf>>* modules_;
+  ModuleMetadataCache* metadata_cache_;
+  const std::vector<ModuleMetadataCache::Key>* metadata_keys_;
+  std::atomic<size_t>* next_index_;
+  const Deadline* deadline_;
+  std::atomic<bool>* truncated_;
+};
+
+// Memory above the outermost frame of an unwound stack is kept this far, as
+// it may hold the arguments or environment that a thread was started with.
+constexpr VMSize kUnwoundStackMargin = 256;
+
+// The most memory read at once while looking for zero-filled pages.
+constexpr size_t kFullMemoryScanChunkSize = 1024 * 1024;
+
+// Bits of a /proc/pid/pagemap entry. See the kernel’s
+// Documentation/admin-guide/mm/pagemap.rst.
+constexpr uint64_t kPagemapPresent = uint64_t{1} << 63;
+constexpr uint64_t kPagemapSwapped = uint64_t{1} << 62;
+
+// Whether size bytes at data are all zero. size must be a multiple of the word
+// size, which page sizes always are. OR-ing whole words without an early exit
+// keeps the loop simple enough for the compiler to vectorize, which matters
+// because nearly every captured page passes through here.
+bool IsZeroFilled(const uint8_t* data, size_t size) {
+  uintptr_t accumulator = 0;
+  for (size_t offset = 0; offset < size; offset += sizeof(accumulator)) {
+    uintptr_t word;
+    memcpy(&word, data + offset, sizeof(word));
+    accumulator |= word;
+  }
+  return accumulator == 0;
+}
+
+// Whether full-memory mode captures mapping under options.
+bool FullMemoryIncludesMapping(
+    const ProcessSnapshotLinux::FullMemoryOptions& options,
+    const MemoryMap::Mapping& mapping) {
+  // Reading device memory can have side effects, or hang. /dev/zero and ashmem
+  // mappings are ordinary memory. The kernel’s [vvar] pages, including
+  // [vvar_vclock], claim to be readable but aren’t.
+  const std::string& name = mapping.name;
+  if ((name.compare(0, 5, "/dev/") == 0 &&
+       name.compare(0, 9, "/dev/zero") != 0 &&
+       name.compare(0, 11, "/dev/ashmem") != 0) ||
+      (mapping.inode == 0 && name.compare(0, 5, "[vvar") == 0)) {
+    return false;
+  }
+
+  const bool file_backed = mapping.inode != 0;
+  return !(options.skip_file_backed && file_backed) &&
+         !(options.skip_anonymous && !file_backed) &&
+         !(options.skip_read_only && !mapping.writable) &&
+         !(options.skip_executable && mapping.executable);
+}
+
+// Whether pages of mapping that have never been touched are supplied as
+// zero-filled pages when they are. The kernel’s other special mappings, such
+// as [vdso], are left to be read.
+bool MappingIsZeroFillOnDemand(const MemoryMap::Mapping& mapping) {
+  const std::string& name = mapping.name;
+  return mapping.inode == 0 &&
+         (name.empty() || name == "[heap]" ||
+          name.compare(0, 6, "[stack") == 0 ||
+          name.compare(0, 6, "[anon:") == 0);
+}
+
+// Returns the ModuleMetadataCache file identity of the file that module was
+// mapped from in the process pid: its device, inode, and change time. A file
+// rewritten in place keeps its inode, so the change time is what tells the
+// new contents from the old. The file is found through the process’ root
+// directory, so that it’s looked up in the process’ mount namespace. Returns
+// an empty string if the file can’t be found, or is no longer the one mapped.
+std::string ModuleFileIdentity(pid_t pid,
+                               const ProcessReaderLinux::Module& module) {
+  if (module.name.empty() || module.name[0] != '/') {
+    return std::string();
+  }
+
+  struct stat st;
+  const std::string path =
+      base::StringPrintf("/proc/%d/root", pid) + module.name;
+  if (stat(path.c_str(), &st) != 0 || st.st_dev != module.device ||
+      st.st_ino != module.inode) {
+    return std::string();
+  }
+  return base::StringPrintf("%llx:%llx:%llx.%lx",
+                            static_cast<unsigned long long>(module.device),
+                            static_cast<unsigned long long>(module.inode),
+                            static_cast<unsigned long long>(st.st_ctim.tv_sec),
+                            static_cast<long>(st.st_ctim.tv_nsec));
+}
+
+}  // namespace
+
 ProcessSnapshotLinux::ProcessSnapshotLinux() = default;
 
 ProcessSnapshotLinux::~ProcessSnapshotLinux() = default;
 
-bool ProcessSnapshotLinux::Initialize(PtraceConnection* connection) {
+bool ProcessSnapshotLinux::Initialize(
+    PtraceConnection* connection,
+    size_t module_memory_cache_pages,
+    size_t module_initialization_threads,
+    const Deadline& deadline,
+    ModuleMetadataCache* module_metadata_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  deadline_ = deadline;
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
     PLOG(ERROR) << "gettimeofday";
     return false;
   }
 
-  if (!process_reader_.Initialize(connection) ||
+  if (!process_reader_.Initialize(connection, module_memory_cache_pages) ||
       !memory_range_.Initialize(process_reader_.Memory(),
                                 process_reader_.Is64Bit())) {
     return false;
   }
+  process_reader_.SetDeadline(deadline_);
+  process_reader_.SetReadThreadFloatingPoint(
+      !stack_capture_options_.skip_thread_floating_point);
+  process_reader_.SetMemoryAccounting(&memory_accounting_);
 
   client_id_.InitializeToZero();
   system_.Initialize(&process_reader_, &snapshot_time_);
 
-  InitializeModules();
+  {
+    CaptureTimings::ScopedPhase phase(&capture_timings_,
+                                      CaptureTimings::Phase::kModuleParsing);
+    ProcessMemoryAccounting::ScopedCategory read_category(
+        ProcessMemoryAccounting::ReadCategory::kModuleHeaders);
+    InitializeModules(connection->Memory()->SupportsConcurrentReads()
+                          ? module_initialization_threads
+                          : 1,
+                      module_metadata_cache);
+  }
+  if (stack_capture_options_.unwind_stacks) {
+    stack_unwinder_.Initialize(&process_reader_);
+  }
   GetCrashpadOptionsInternal((&options_));
-  InitializeThreads();
+  InitializeCaptureHints();
+  {
+    CaptureTimings::ScopedPhase phase(
+        &capture_timings_, CaptureTimings::Phase::kThreadEnumeration);
+    InitializeThreads();
+  }
   InitializeAnnotations();
+  InitializeExtraMemory();
+  InitializeFullMemory();
+
+  if (const ProcessMemoryCaching* cache = process_reader_.ModuleMemoryCache()) {
+    VLOG(1) << "module memory cache hits " << cache->CacheHits() << " misses "
+            << cache->CacheMisses();
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -88,7 +287,14 @@ bool ProcessSnapshotLinux::InitializeException(
           ? &options_.indirectly_referenced_memory_cap
           : nullptr;
 
-  exception_.reset(new internal::ExceptionSnapshotLinux());
+  // The exception thread may have been skipped if the deadline expired while
+  // enumerating threads, but it's the one thread that must be captured.
+  if (process_reader_.ThreadsTruncated() &&
+      !process_reader_.AddThread(info.thread_id)) {
+    LOG(WARNING) << "couldn't add exception thread " << info.thread_id;
+  }
+
+  exception_ = arena_.New<internal::ExceptionSnapshotLinux>();
   if (!exception_->Initialize(&process_reader_,
                               info.siginfo_address,
                               info.context_address,
@@ -106,23 +312,33 @@ bool ProcessSnapshotLinux::InitializeException(
       ProcessReaderLinux::Thread thread = reader_thread;
       thread.InitializeStackFromSP(&process_reader_,
                                    exception_->Context()->StackPointer());
+      LimitStackSize(&thread,
+                     stack_capture_options_.max_exception_thread_stack_size);
 
-      auto exc_thread_snapshot =
-          std::make_unique<internal::ThreadSnapshotLinux>();
-      if (!exc_thread_snapshot->Initialize(&process_reader_, thread, nullptr)) {
+      auto exc_thread_snapshot = arena_.New<internal::ThreadSnapshotLinux>();
+      if (!exc_thread_snapshot->Initialize(
+              &process_reader_, thread, budget_remaining_pointer)) {
         return false;
       }
 
+      UnwindThreadStack(exc_thread_snapshot.get(), *exception_->Context());
+
       for (auto& thread_snapshot : threads_) {
         if (thread_snapshot->ThreadID() ==
             static_cast<uint64_t>(info.thread_id)) {
+          exc_thread_snapshot->SetBreadcrumbs(thread_snapshot->Breadcrumbs());
           thread_snapshot.reset(exc_thread_snapshot.release());
+          CaptureIndirectlyReferencedMemory();
           return true;
         }
       }
 
-      LOG(ERROR) << "thread not found " << info.thread_id;
-      return false;
+      // InitializeThreads() may have stopped at the deadline before reaching
+      // this thread, or the thread was added above. Either way, it must still
+      // be captured.
+      threads_.push_back(std::move(exc_thread_snapshot));
+      CaptureIndirectlyReferencedMemory();
+      return true;
     }
   }
 
@@ -130,6 +346,85 @@ bool ProcessSnapshotLinux::InitializeException(
   return false;
 }
 
+void ProcessSnapshotLinux::CaptureIndirectlyReferencedMemory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (indirectly_referenced_memory_captured_) {
+    return;
+  }
+  indirectly_referenced_memory_captured_ = true;
+
+  if (deadline_.Expired()) {
+    if (options_.gather_indirectly_referenced_memory == TriState::kEnabled) {
+      RecordTruncatedPhase("extra_memory");
+    }
+    return;
+  }
+
+  CaptureTimings::ScopedPhase phase(&capture_timings_,
+                                    CaptureTimings::Phase::kMemoryCapture);
+
+  // Each stack would otherwise be read from the target process on its own,
+  // once to be scanned for pointers and again when it’s written. Read them all
+  // in one batch, which is a single request when reads go through a
+  // PtraceBroker, and keep them to be scanned and written from the cache.
+  std::vector<CheckedRange<VMAddress, size_t>> stacks;
+  for (const auto& thread : threads_) {
+    const MemorySnapshot* stack = thread->Stack();
+    stacks.emplace_back(stack->Address(), stack->Size());
+  }
+  {
+    ProcessMemoryAccounting::ScopedCategory read_category(
+        ProcessMemoryAccounting::ReadCategory::kStack);
+    process_reader_.ReadCache()->Prefetch(process_reader_.Memory(),
+                                          std::move(stacks));
+  }
+
+  if (options_.gather_indirectly_referenced_memory != TriState::kEnabled) {
+    return;
+  }
+
+  internal::PrioritizedCaptureMemory capture;
+  for (const auto& thread : threads_) {
+    thread->AddIndirectlyReferencedMemoryCandidates(
+        exception_ && thread->ThreadID() == exception_->ThreadID(), &capture);
+  }
+  if (!capture.Capture(
+          &options_.indirectly_referenced_memory_cap,
+          std::min(
+              internal::PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds,
+              deadline_.RemainingNanoseconds()))) {
+    RecordTruncatedPhase("extra_memory");
+  }
+
+  // The memory captured around the pointers in each thread’s context and
+  // stack is many small regions, which are likewise read in one batch.
+  std::vector<CheckedRange<VMAddress, size_t>> extra_memory;
+  for (const auto& thread : threads_) {
+    for (const MemorySnapshot* memory : thread->ExtraMemory()) {
+      extra_memory.emplace_back(memory->Address(), memory->Size());
+    }
+  }
+  ProcessMemoryAccounting::ScopedCategory read_category(
+      ProcessMemoryAccounting::ReadCategory::kIndirectMemory);
+  process_reader_.ReadCache()->Prefetch(process_reader_.Memory(),
+                                        std::move(extra_memory));
+}
+
+void ProcessSnapshotLinux::RecordTruncatedPhase(const char* phase) {
+  std::string& phases = annotations_simple_map_[kTruncatedPhasesAnnotation];
+  for (const std::string& recorded : SplitString(phases, ',')) {
+    if (recorded == phase) {
+      return;
+    }
+  }
+
+  LOG(WARNING) << "capture deadline expired, truncating " << phase;
+  if (!phases.empty()) {
+    phases.push_back(',');
+  }
+  phases.append(phase);
+}
+
 void ProcessSnapshotLinux::GetCrashpadOptions(
     CrashpadInfoClientOptions* options) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
@@ -264,7 +559,27 @@ std::vector<HandleSnapshot> ProcessSnapshotLinux::Handles() const {
 
 std::vector<const MemorySnapshot*> ProcessSnapshotLinux::ExtraMemory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return std::vector<const MemorySnapshot*>();
+  std::vector<const MemorySnapshot*> extra_memory;
+  for (const auto& em : extra_memory_) {
+    extra_memory.push_back(em.get());
+  }
+  return extra_memory;
+}
+
+std::vector<const MemorySnapshot*> ProcessSnapshotLinux::FullMemory() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  std::vector<const MemorySnapshot*> full_memory;
+  full_memory.reserve(full_memory_.size());
+  for (const auto& memory : full_memory_) {
+    full_memory.push_back(memory.get());
+  }
+  return full_memory;
+}
+
+const std::vector<CheckedRange<uint64_t>>&
+ProcessSnapshotLinux::FullMemoryZeroRanges() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return full_memory_zero_ranges_;
 }
 
 const ProcessMemory* ProcessSnapshotLinux::Memory() const {
@@ -280,33 +595,388 @@ void ProcessSnapshotLinux::InitializeThreads() {
           ? &options_.indirectly_referenced_memory_cap
           : nullptr;
 
+  std::map<uint64_t, std::vector<uint8_t>> breadcrumbs;
+  for (const auto& module : modules_) {
+    module->GetThreadBreadcrumbs(&breadcrumbs);
+  }
+
+  if (process_reader_.ThreadsTruncated()) {
+    RecordTruncatedPhase("threads");
+  }
+
   for (const ProcessReaderLinux::Thread& process_reader_thread :
        process_reader_threads) {
-    auto thread = std::make_unique<internal::ThreadSnapshotLinux>();
-    if (thread->Initialize(&process_reader_,
-                           process_reader_thread,
-                           budget_remaining_pointer)) {
+    if (!threads_.empty() && deadline_.Expired()) {
+      RecordTruncatedPhase("threads");
+      break;
+    }
+
+    ProcessReaderLinux::Thread reader_thread = process_reader_thread;
+    if (stack_capture_options_.skip_idle_thread_stacks &&
+        process_reader_.ThreadIsIdle(reader_thread)) {
+      reader_thread.stack_region_size = 0;
+    }
+    LimitStackSize(&reader_thread,
+                   stack_capture_options_.max_thread_stack_size);
+
+    auto thread = arena_.New<internal::ThreadSnapshotLinux>();
+    if (thread->Initialize(
+            &process_reader_, reader_thread, budget_remaining_pointer)) {
+      const auto breadcrumbs_it = breadcrumbs.find(thread->ThreadID());
+      if (breadcrumbs_it != breadcrumbs.end()) {
+        thread->SetBreadcrumbs(std::move(breadcrumbs_it->second));
+      }
+      UnwindThreadStack(thread.get(), *thread->Context());
       threads_.push_back(std::move(thread));
     }
   }
 }
 
-void ProcessSnapshotLinux::InitializeModules() {
+void ProcessSnapshotLinux::InitializeModules(
+    size_t threads,
+    ModuleMetadataCache* module_metadata_cache) {
+  std::vector<ArenaPtr<internal::ModuleSnapshotElf>> modules;
+  std::vector<ModuleMetadataCache::Key> metadata_keys;
   for (const ProcessReaderLinux::Module& reader_module :
        process_reader_.Modules()) {
-    auto module =
-        std::make_unique<internal::ModuleSnapshotElf>(reader_module.name,
-                                                      reader_module.elf_reader,
-                                                      reader_module.type,
-                                                      &memory_range_,
-                                                      process_reader_.Memory());
-    if (module->Initialize()) {
+    modules.push_back(
+        arena_.New<internal::ModuleSnapshotElf>(reader_module.name,
+                                                reader_module.elf_reader,
+                                                reader_module.type,
+                                                &memory_range_,
+                                                process_reader_.Memory()));
+    modules.back()->SetShallowModuleFilter(shallow_module_filter_);
+
+    // Modules that weren’t mapped from a file, or whose file can’t be
+    // identified, are left with an empty file_identity, and don’t use the
+    // cache.
+    ModuleMetadataCache::Key key = {};
+    if (module_metadata_cache && reader_module.elf_reader &&
+        reader_module.inode) {
+      key.file_identity =
+          ModuleFileIdentity(process_reader_.ProcessID(), reader_module);
+      if (!key.file_identity.empty()) {
+        key.path = reader_module.name;
+        key.size = reader_module.elf_reader->Size();
+      }
+    }
+    metadata_keys.push_back(std::move(key));
+  }
+
+  if (process_reader_.ModulesTruncated()) {
+    RecordTruncatedPhase("modules");
+  }
+
+  // The calling thread initializes modules alongside any additional threads.
+  std::atomic<size_t> next_index(0);
+  std::atomic<bool> truncated(false);
+  std::vector<std::unique_ptr<ModuleInitializationThread>> workers;
+  for (size_t index = 1; index < std::min(threads, modules.size()); ++index) {
+    workers.push_back(std::make_unique<ModuleInitializationThread>(
+        &modules,
+        module_metadata_cache,
+        &metadata_keys,
+        &next_index,
+        &deadline_,
+        &truncated));
+    workers.back()->Start();
+  }
+  ModuleInitializationThread(&modules,
+                             module_metadata_cache,
+                             &metadata_keys,
+                             &next_index,
+                             &deadline_,
+                             &truncated)
+      .ThreadMain();
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+  if (truncated) {
+    RecordTruncatedPhase("modules");
+  }
+
+  for (auto& module : modules) {
+    if (module) {
       modules_.push_back(std::move(module));
     }
   }
 }
 
+void ProcessSnapshotLinux::InitializeCaptureHints() {
+  std::vector<CheckedRange<uint64_t>> skipped_ranges;
+  for (const auto& module : modules_) {
+    const CaptureHints* hints = module->GetCaptureHints();
+    if (!hints) {
+      continue;
+    }
+
+    // The smallest limit set by any module applies, rounded down so that
+    // stacks remain pointer-aligned.
+    const uint32_t max_stack_bytes = hints->max_stack_bytes_per_thread();
+    if (max_stack_bytes != 0 &&
+        (max_stack_bytes_per_thread_ == 0 ||
+         max_stack_bytes < max_stack_bytes_per_thread_)) {
+      max_stack_bytes_per_thread_ =
+          std::max(max_stack_bytes & ~uint32_t{15}, uint32_t{16});
+    }
+
+    for (size_t index = 0; index < hints->skip_range_count(); ++index) {
+      const CaptureHints::Range& range = hints->skip_range(index);
+      if (range.size != 0) {
+        skipped_ranges.emplace_back(range.base, range.size);
+      }
+    }
+  }
+  process_reader_.SetSkippedMemoryRanges(std::move(skipped_ranges));
+}
+
+void ProcessSnapshotLinux::InitializeExtraMemory() {
+  // Modules may register thousands of ranges, often overlapping or repeated.
+  // They're merged as they're collected, so that only one snapshot is created
+  // for each distinct range, and the minidump writer has less to coalesce.
+  RangeSet ranges;
+  for (const auto& module : modules_) {
+    for (const auto& range : module->ExtraMemoryRanges()) {
+      if (process_reader_.IsSkippedMemoryRange(range)) {
+        continue;
+      }
+      ranges.Insert(range.base(), range.size());
+    }
+  }
+
+  for (const auto& range : ranges.Ranges()) {
+    auto memory = arena_.New<internal::MemorySnapshotGeneric>();
+    memory->Initialize(process_reader_.Memory(), range.base(), range.size());
+    extra_memory_.push_back(std::move(memory));
+  }
+}
+
+void ProcessSnapshotLinux::InitializeFullMemory() {
+  if (!full_memory_options_.enabled) {
+    return;
+  }
+
+  const auto* memory_map = process_reader_.GetMemoryMap();
+  LinuxVMAddress low;
+  LinuxVMAddress high;
+  if (!memory_map->GetAddressBounds(&low, &high)) {
+    return;
+  }
+
+  base::ScopedFD pagemap_fd;
+  if (full_memory_options_.skip_non_resident) {
+    char path[32];
+    snprintf(
+        path, sizeof(path), "/proc/%d/pagemap", process_reader_.ProcessID());
+    pagemap_fd.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+    PLOG_IF(WARNING, !pagemap_fd.is_valid())
+        << "open " << path << ", reading non-resident memory";
+  }
+
+  // Each readable range may span several mappings, which the options judge
+  // separately.
+  for (const auto& range : memory_map->GetReadableRanges(
+           CheckedRange<LinuxVMAddress, LinuxVMSize>(low, high - low))) {
+    LinuxVMAddress address = range.base();
+    while (address < range.end()) {
+      const auto* mapping = memory_map->FindMapping(address);
+      if (!mapping) {
+        break;
+      }
+      const LinuxVMAddress end = std::min(range.end(), mapping->range.End());
+      const AbsentPages absent_pages =
+          mapping->inode != 0                  ? AbsentPages::kSkip
+          : MappingIsZeroFillOnDemand(*mapping) ? AbsentPages::kZero
+                                               : AbsentPages::kRead;
+      if (FullMemoryIncludesMapping(full_memory_options_, *mapping) &&
+          !AddFullMemoryRange(
+              address, end - address, pagemap_fd.get(), absent_pages)) {
+        RecordTruncatedPhase("full_memory");
+        return;
+      }
+      address = end;
+    }
+  }
+}
+
+bool ProcessSnapshotLinux::AddFullMemoryRange(LinuxVMAddress address,
+                                              LinuxVMSize size,
+                                              int pagemap_fd,
+                                              AbsentPages absent_pages) {
+  const ProcessMemory* memory = process_reader_.Memory();
+  const size_t page_size = getpagesize();
+  std::vector<uint8_t> buffer(
+      std::min(size, LinuxVMSize{kFullMemoryScanChunkSize}));
+  std::vector<uint64_t> pagemap;
+  if (pagemap_fd >= 0) {
+    pagemap.resize(buffer.size() / page_size);
+  }
+
+  // The run being built starts at run_base and ends with the nonzero page that
+  // ends at run_end. Zero-filled pages after run_end join the run only if
+  // another nonzero page follows them closely enough. Memory from zero_base up
+  // to the next run or unreadable page has been found to be zero-filled and is
+  // not yet accounted for.
+  bool in_run = false;
+  LinuxVMAddress run_base = 0;
+  LinuxVMAddress run_end = 0;
+  LinuxVMAddress zero_base = address;
+  auto add_zero = [&](LinuxVMAddress zero_end) {
+    if (zero_end > zero_base) {
+      full_memory_zero_ranges_.emplace_back(zero_base, zero_end - zero_base);
+    }
+    zero_base = zero_end;
+  };
+  auto end_run = [&]() {
+    if (in_run) {
+      add_zero(run_base);
+      auto snapshot = arena_.New<internal::MemorySnapshotGeneric>();
+      snapshot->Initialize(memory, run_base, run_end - run_base);
+      full_memory_.push_back(std::move(snapshot));
+      zero_base = run_end;
+      in_run = false;
+    }
+  };
+  auto add_page = [&](LinuxVMAddress page, const uint8_t* data) {
+    if (IsZeroFilled(data, page_size)) {
+      return;
+    }
+    if (in_run && page - run_end >= kFullMemoryMinimumHoleSize) {
+      end_run();
+    }
+    if (!in_run) {
+      in_run = true;
+      run_base = page;
+    }
+    run_end = page + page_size;
+  };
+  auto read_pages = [&](LinuxVMAddress pages, size_t pages_size) {
+    if (memory->Read(pages, pages_size, buffer.data())) {
+      for (size_t offset = 0; offset < pages_size; offset += page_size) {
+        add_page(pages + offset, &buffer[offset]);
+      }
+      return;
+    }
+
+    // Some of the pages may be readable even though the mapping claims all of
+    // them are. Unreadable pages split the memory around them, and are neither
+    // captured nor reported as zero-filled.
+    for (size_t offset = 0; offset < pages_size; offset += page_size) {
+      const LinuxVMAddress page = pages + offset;
+      if (memory->Read(page, page_size, buffer.data())) {
+        add_page(page, buffer.data());
+      } else {
+        end_run();
+        add_zero(page);
+        zero_base = page + page_size;
+      }
+    }
+  };
+
+  const LinuxVMAddress end = address + size;
+  while (address < end) {
+    if (deadline_.Expired()) {
+      end_run();
+      add_zero(address);
+      return false;
+    }
+
+    const size_t chunk_size = static_cast<size_t>(
+        std::min(end - address, LinuxVMSize{buffer.size()}));
+    const size_t chunk_pages = chunk_size / page_size;
+    const size_t pagemap_size = chunk_pages * sizeof(pagemap[0]);
+    if (pagemap.empty() ||
+        HANDLE_EINTR(pread64(pagemap_fd,
+                             pagemap.data(),
+                             pagemap_size,
+                             address / page_size * sizeof(pagemap[0]))) !=
+            static_cast<ssize_t>(pagemap_size)) {
+      read_pages(address, chunk_size);
+      address += chunk_size;
+      continue;
+    }
+
+    // Pages of the same kind are handled together, so that resident memory
+    // is still read in as few reads as possible.
+    auto page_kind = [&](size_t index) {
+      const uint64_t entry = pagemap[index];
+      if (entry & kPagemapPresent) {
+        return AbsentPages::kRead;
+      }
+      return entry & kPagemapSwapped ? AbsentPages::kSkip : absent_pages;
+    };
+    size_t index = 0;
+    while (index < chunk_pages) {
+      const AbsentPages kind = page_kind(index);
+      size_t next = index + 1;
+      while (next < chunk_pages && page_kind(next) == kind) {
+        ++next;
+      }
+      const LinuxVMAddress pages = address + index * page_size;
+      switch (kind) {
+        case AbsentPages::kRead:
+          read_pages(pages, (next - index) * page_size);
+          break;
+        case AbsentPages::kZero:
+          // These would read as zeroes, which add_page() would pass over.
+          break;
+        case AbsentPages::kSkip:
+          end_run();
+          add_zero(pages);
+          zero_base = address + next * page_size;
+          break;
+      }
+      index = next;
+    }
+    address += chunk_size;
+  }
+
+  end_run();
+  add_zero(end);
+  return true;
+}
+
+void ProcessSnapshotLinux::LimitStackSize(ProcessReaderLinux::Thread* thread,
+                                          uint32_t max_stack_size) const {
+  // Limits are rounded down so that stacks remain pointer-aligned.
+  if (max_stack_size != 0) {
+    max_stack_size = std::max(max_stack_size & ~uint32_t{15}, uint32_t{16});
+  }
+  for (uint32_t limit : {max_stack_size, max_stack_bytes_per_thread_}) {
+    if (limit != 0 && thread->stack_region_size > limit) {
+      thread->stack_region_size = limit;
+    }
+  }
+}
+
+void ProcessSnapshotLinux::UnwindThreadStack(
+    internal::ThreadSnapshotLinux* thread,
+    const CPUContext& context) {
+  if (!stack_capture_options_.unwind_stacks) {
+    return;
+  }
+
+  const MemorySnapshot* stack = thread->Stack();
+  std::vector<UnwoundStackFrame> frames;
+  VMAddress frames_end;
+  VMSize stack_size = stack->Size();
+  if (stack_unwinder_.Unwind(
+          context, stack->Address(), stack->Size(), &frames, &frames_end)) {
+    // Rounded up so that the stack remains pointer-aligned.
+    const VMSize used_size =
+        (frames_end - stack->Address() + kUnwoundStackMargin + 15) &
+        ~VMSize{15};
+    stack_size = std::min(stack_size, used_size);
+  }
+  thread->SetUnwoundFrames(std::move(frames), stack_size);
+}
+
 void ProcessSnapshotLinux::InitializeAnnotations() {
+  if (deadline_.Expired()) {
+    RecordTruncatedPhase("annotations");
+    return;
+  }
+
 #if BUILDFLAG(IS_ANDROID)
   const std::string& abort_message = process_reader_.AbortMessage();
   if (!abort_message.empty()) {
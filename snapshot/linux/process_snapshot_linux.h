@@ -27,19 +27,28 @@
 #include "snapshot/elf/module_snapshot_elf.h"
 #include "snapshot/linux/exception_snapshot_linux.h"
 #include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/linux/stack_unwinder_linux.h"
 #include "snapshot/linux/system_snapshot_linux.h"
 #include "snapshot/linux/thread_snapshot_linux.h"
 #include "snapshot/memory_map_region_snapshot.h"
+#include "snapshot/memory_snapshot_generic.h"
+#include "snapshot/module_metadata_cache.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
+#include "snapshot/shallow_module_filter.h"
 #include "snapshot/system_snapshot.h"
 #include "snapshot/thread_snapshot.h"
 #include "snapshot/unloaded_module_snapshot.h"
 #include "util/linux/ptrace_connection.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/deadline.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
+#include "util/numeric/checked_range.h"
 #include "util/process/process_id.h"
+#include "util/process/process_memory_accounting.h"
 #include "util/process/process_memory_range.h"
+#include "util/stdlib/arena.h"
 
 namespace crashpad {
 
@@ -54,13 +63,171 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
 
   ~ProcessSnapshotLinux() override;
 
+  //! \brief Limits on the thread stacks and registers that a snapshot
+  //!     captures.
+  //!
+  //! A limit of `0` means no limit. When a module’s CaptureHints also limit
+  //! stacks, the smaller limit applies.
+  struct StackCaptureOptions {
+    //! \brief The most bytes of each thread’s stack to capture, starting from
+    //!     its stack pointer.
+    uint32_t max_thread_stack_size = 0;
+
+    //! \brief The most bytes of the exception thread’s stack to capture,
+    //!     instead of \a max_thread_stack_size.
+    //!
+    //! The exception thread is the crashing thread, or the thread that
+    //! requested a dump without crashing.
+    uint32_t max_exception_thread_stack_size = 0;
+
+    //! \brief Whether to capture no stack for threads other than the
+    //!     exception thread that appear to be idle. See
+    //!     ProcessReaderLinux::ThreadIsIdle().
+    bool skip_idle_thread_stacks = false;
+
+    //! \brief Whether to leave out the floating-point and vector registers of
+    //!     threads, other than those that captured their own state.
+    //!
+    //! The exception’s context is captured by the client when it crashes or
+    //! requests a dump, and always includes these registers, so the state of
+    //! the exception thread at the time of the exception remains complete.
+    //! See ProcessReaderLinux::SetReadThreadFloatingPoint().
+    bool skip_thread_floating_point = false;
+
+    //! \brief Whether to unwind thread stacks using the call frame
+    //!     information in the process’ modules, recording the frames found
+    //!     and capturing only the part of each stack that they occupy.
+    //!
+    //! A stack that can’t be unwound to its outermost frame is captured as it
+    //! would be otherwise. See internal::StackUnwinderLinux.
+    bool unwind_stacks = false;
+  };
+
+  //! \brief Sets limits on the thread stacks and registers captured.
+  //!
+  //! This must be called before Initialize() to have an effect.
+  void SetStackCaptureOptions(const StackCaptureOptions& options) {
+    stack_capture_options_ = options;
+  }
+
+  //! \brief Sets a filter selecting modules to capture shallowly. See
+  //!     internal::ModuleSnapshotElf::SetShallowModuleFilter().
+  //!
+  //! This must be called before Initialize() to have an effect. This object
+  //! does not take ownership of \a filter, which must outlive Initialize().
+  void SetShallowModuleFilter(const ShallowModuleFilter* filter) {
+    shallow_module_filter_ = filter;
+  }
+
+  //! \brief Selects the memory captured in full-memory mode.
+  //!
+  //! In full-memory mode, the contents of every readable mapping in the
+  //! process are captured, except those excluded by the options below.
+  //! Zero-filled pages at either end of a mapping, and runs of at least
+  //! kFullMemoryMinimumHoleSize zero-filled bytes within one, are left out so
+  //! that untouched anonymous memory doesn’t take space in the report.
+  struct FullMemoryOptions {
+    //! \brief Whether to capture full memory at all.
+    bool enabled = false;
+
+    //! \brief Whether to leave out mappings of files.
+    bool skip_file_backed = false;
+
+    //! \brief Whether to leave out mappings not backed by a file, such as the
+    //!     heap and thread stacks.
+    bool skip_anonymous = false;
+
+    //! \brief Whether to leave out mappings that aren’t writable.
+    bool skip_read_only = false;
+
+    //! \brief Whether to leave out executable mappings.
+    bool skip_executable = false;
+
+    //! \brief Whether to leave out pages that aren’t resident in memory.
+    //!
+    //! Reading a page that has been swapped out, or a page of a file that the
+    //! process hasn’t touched, makes the kernel read it from storage. On a host
+    //! short of memory, reading many of them can make the capture slow and push
+    //! other memory out. With this set, `/proc/pid/pagemap` is consulted, and
+    //! such pages are left out as if they were unreadable, so that the minidump
+    //! shows them as unavailable. Anonymous pages that have never been touched
+    //! are known to be zero-filled without reading them. If `/proc/pid/pagemap`
+    //! can’t be opened, every page is read as it would be without this option.
+    bool skip_non_resident = false;
+  };
+
+  //! \brief The smallest run of zero-filled memory left out of full memory.
+  //!
+  //! Each run of captured memory costs a list entry in the minidump and an
+  //! object in the handler, so shorter runs of zeroes are captured rather than
+  //! splitting the memory around them.
+  static constexpr size_t kFullMemoryMinimumHoleSize = 64 * 1024;
+
+  //! \brief Sets the memory captured in full-memory mode.
+  //!
+  //! This must be called before Initialize() to have an effect.
+  void SetFullMemoryOptions(const FullMemoryOptions& options) {
+    full_memory_options_ = options;
+  }
+
+  //! \brief Returns the memory captured in full-memory mode, in order of
+  //!     increasing address.
+  //!
+  //! This is empty if full-memory mode was not enabled by
+  //! SetFullMemoryOptions(). The contents of the process’ memory are read
+  //! again when these snapshots are read, so the process must remain
+  //! suspended until then. See MinidumpFileWriter::AddFullMemory().
+  std::vector<const MemorySnapshot*> FullMemory() const;
+
+  //! \brief Returns the zero-filled memory that was left out of FullMemory(),
+  //!     in order of increasing address.
+  //!
+  //! Together with FullMemory(), these ranges cover all of the readable memory
+  //! selected by SetFullMemoryOptions(), so that a reader of the minidump can
+  //! tell zero-filled memory apart from memory that wasn’t captured.
+  const std::vector<CheckedRange<uint64_t>>& FullMemoryZeroRanges() const;
+
   //! \brief Initializes the object.
   //!
   //! \param[in] connection A connection to the process to snapshot.
+  //! \param[in] module_memory_cache_pages If nonzero, the maximum number of
+  //!     pages of module images to cache while parsing them. The cache is
+  //!     retained for the lifetime of this object. See
+  //!     ProcessReaderLinux::Initialize().
+  //! \param[in] module_initialization_threads The maximum number of threads
+  //!     to use to initialize module snapshots. Values of 0 or 1 initialize
+  //!     modules on the calling thread. Additional threads are only used if
+  //!     the memory of the process can be read concurrently, as determined by
+  //!     ProcessMemoryLinux::SupportsConcurrentReads(). The order of Modules()
+  //!     doesn't depend on this value.
+  //! \param[in] deadline A deadline for capturing the snapshot, including
+  //!     InitializeException() and CaptureIndirectlyReferencedMemory(). Once
+  //!     it expires, threads, modules, annotations, and indirectly-referenced
+  //!     memory not yet captured are left out of the snapshot, and the phases
+  //!     that were cut short are listed in the annotation named by
+  //!     kTruncatedPhasesAnnotation. The main thread, the executable, and the
+  //!     exception thread are always captured.
+  //! \param[in] module_metadata_cache If not `nullptr`, a cache of module
+  //!     metadata, consulted and added to by module snapshots for modules
+  //!     mapped from files. This object does not take ownership of the cache.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(PtraceConnection* connection);
+  bool Initialize(PtraceConnection* connection,
+                  size_t module_memory_cache_pages = 0,
+                  size_t module_initialization_threads = 0,
+                  const Deadline& deadline = Deadline(),
+                  ModuleMetadataCache* module_metadata_cache = nullptr);
+
+  //! \brief The key of the annotation in AnnotationsSimpleMap() that lists,
+  //!     separated by commas, the phases of capture that were cut short by the
+  //!     deadline passed to Initialize().
+  //!
+  //! The phases are `"threads"`, `"modules"`, `"annotations"`,
+  //! `"extra_memory"`, and `"full_memory"`. The annotation is absent if nothing
+  //! was cut short.
+  static constexpr char kTruncatedPhasesAnnotation[] =
+      "crashpad_truncated_phases";
 
   //! \brief Finds the thread whose stack contains \a stack_address.
   //!
@@ -80,6 +247,23 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   bool InitializeException(LinuxVMAddress exception_info,
                            pid_t exception_thread_id = -1);
 
+  //! \brief Captures memory pointed to by the registers and stacks of the
+  //!     process' threads, if enabled by the process' CrashpadInfo options.
+  //!
+  //! Candidates from the exception thread, if any, are captured first. Capture
+  //! stops when the `indirectly_referenced_memory_cap` budget is used up, or
+  //! after PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds.
+  //!
+  //! The threads’ stacks, and then the memory captured, are read from the
+  //! process in bulk and kept, so that they needn’t be read again one region
+  //! at a time when they’re scanned and written. Stacks are read this way even
+  //! if capturing indirectly referenced memory isn’t enabled.
+  //!
+  //! InitializeException() calls this once the exception is known. A caller
+  //! that does not call InitializeException() should call this after
+  //! Initialize(). Only the first call has an effect.
+  void CaptureIndirectlyReferencedMemory();
+
   //! \brief Sets the value to be returned by ReportID().
   //!
   //! The crash report ID is under the control of the snapshot
@@ -113,6 +297,31 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   //!     the process.
   void GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Returns the time taken by the phases of capture performed by this
+  //!     object.
+  //!
+  //! Initialize() records Metrics::CapturePhase::kModuleParsing and
+  //! Metrics::CapturePhase::kThreadEnumeration, and
+  //! CaptureIndirectlyReferencedMemory() records
+  //! Metrics::CapturePhase::kMemoryCapture.
+  const CaptureTimings& Timings() const { return capture_timings_; }
+
+  //! \brief Records the reads made from the process’ memory so far in
+  //!     \a capture_timings, as with CaptureTimings::SetRemoteReads().
+  //!
+  //! Reads are counted from Initialize() until this object is destroyed, so
+  //! they include the reads made while writing a minidump from this snapshot
+  //! if this method is called afterwards.
+  void GetRemoteReads(CaptureTimings* capture_timings) const {
+    memory_accounting_.GetRemoteReads(capture_timings);
+  }
+
+  //! \brief Returns the cache that module memory was read through, or
+  //!     `nullptr` if Initialize() was called without a module memory cache.
+  const ProcessMemoryCaching* ModuleMemoryCache() const {
+    return process_reader_.ModuleMemoryCache();
+  }
+
   // ProcessSnapshot:
 
   crashpad::ProcessID ProcessID() const override;
@@ -136,9 +345,56 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
 
  private:
   void InitializeThreads();
-  void InitializeModules();
+  void InitializeModules(size_t threads,
+                         ModuleMetadataCache* module_metadata_cache);
   void InitializeAnnotations();
 
+  // Applies the CaptureHints of every module that has them.
+  void InitializeCaptureHints();
+
+  // Captures the ranges that modules' CaptureHints ask to always copy.
+  void InitializeExtraMemory();
+
+  // What AddFullMemoryRange() makes of a page that is neither resident nor
+  // swapped out.
+  enum class AbsentPages {
+    // The page is read as usual. It is provided by the kernel without I/O.
+    kRead,
+
+    // The page has never been touched, and is zero-filled.
+    kZero,
+
+    // Reading the page would read it from a file, so it is left out.
+    kSkip,
+  };
+
+  // Captures the memory selected by full_memory_options_.
+  void InitializeFullMemory();
+
+  // Adds the nonzero parts of [address, address + size), which must be
+  // readable, to full_memory_, and the zero-filled parts left out to
+  // full_memory_zero_ranges_. Returns false if the deadline expired. If
+  // pagemap_fd is valid, it is the process’ /proc/pid/pagemap, and pages that
+  // aren’t resident are skipped, or taken to be zero-filled, according to it
+  // and absent_pages.
+  bool AddFullMemoryRange(LinuxVMAddress address,
+                          LinuxVMSize size,
+                          int pagemap_fd,
+                          AbsentPages absent_pages);
+
+  // Limits thread's stack to the smaller of max_stack_size and
+  // max_stack_bytes_per_thread_, ignoring either that's 0.
+  void LimitStackSize(ProcessReaderLinux::Thread* thread,
+                      uint32_t max_stack_size) const;
+
+  // Unwinds thread's stack from context if stack_capture_options_ asks for
+  // it, and limits the stack captured to the frames found.
+  void UnwindThreadStack(internal::ThreadSnapshotLinux* thread,
+                         const CPUContext& context);
+
+  // Adds phase to the kTruncatedPhasesAnnotation annotation.
+  void RecordTruncatedPhase(const char* phase);
+
   // Initializes options_ on behalf of Initialize().
   void GetCrashpadOptionsInternal(CrashpadInfoClientOptions* options);
 
@@ -146,13 +402,28 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   timeval snapshot_time_;
   UUID report_id_;
   UUID client_id_;
-  std::vector<std::unique_ptr<internal::ThreadSnapshotLinux>> threads_;
-  std::vector<std::unique_ptr<internal::ModuleSnapshotElf>> modules_;
-  std::unique_ptr<internal::ExceptionSnapshotLinux> exception_;
+  // The thread, module, memory, and exception snapshots are allocated here so
+  // that they are released together, and must be declared after it.
+  Arena arena_;
+  std::vector<ArenaPtr<internal::ThreadSnapshotLinux>> threads_;
+  std::vector<ArenaPtr<internal::ModuleSnapshotElf>> modules_;
+  std::vector<ArenaPtr<internal::MemorySnapshotGeneric>> extra_memory_;
+  std::vector<ArenaPtr<internal::MemorySnapshotGeneric>> full_memory_;
+  std::vector<CheckedRange<uint64_t>> full_memory_zero_ranges_;
+  ArenaPtr<internal::ExceptionSnapshotLinux> exception_;
   internal::SystemSnapshotLinux system_;
+  ProcessMemoryAccounting memory_accounting_;
   ProcessReaderLinux process_reader_;
+  internal::StackUnwinderLinux stack_unwinder_;
   ProcessMemoryRange memory_range_;
   CrashpadInfoClientOptions options_;
+  Deadline deadline_;
+  CaptureTimings capture_timings_;
+  bool indirectly_referenced_memory_captured_ = false;
+  uint32_t max_stack_bytes_per_thread_ = 0;
+  StackCaptureOptions stack_capture_options_;
+  const ShallowModuleFilter* shallow_module_filter_ = nullptr;  // weak
+  FullMemoryOptions full_memory_options_;
   InitializationStateDcheck initialized_;
 };
 
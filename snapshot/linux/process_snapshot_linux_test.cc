@@ -0,0 +1,423 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/process_snapshot_linux.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "test/multiprocess.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/numeric/checked_range.h"
+#include "util/posix/scoped_mmap.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The child inherits a mapping set up before it is forked. Its first and last
+// pages are zero. Between them, kShortHolePages zero-filled pages lie between
+// the first two nonzero pages, and kLongHolePages lie between the second and
+// the third. With pages of 4 to 16 kB, only the long hole is at least the
+// minimum hole size. Inaccessible guard pages on either side keep the mapping
+// from running together with its neighbors.
+constexpr size_t kShortHolePages = 3;
+constexpr size_t kLongHolePages =
+    ProcessSnapshotLinux::kFullMemoryMinimumHoleSize / 4096 + 1;
+constexpr size_t kMappingPages = 1 + 1 + kShortHolePages + 1 + kLongHolePages +
+                                 1 + 1;
+
+class FullMemoryTest : public Multiprocess {
+ public:
+  explicit FullMemoryTest(
+      const ProcessSnapshotLinux::FullMemoryOptions& options)
+      : Multiprocess(), options_(options), page_size_(getpagesize()) {}
+
+  FullMemoryTest(const FullMemoryTest&) = delete;
+  FullMemoryTest& operator=(const FullMemoryTest&) = delete;
+
+  ~FullMemoryTest() {}
+
+  bool SetUp() {
+    if (!mapping_.ResetMmap(nullptr,
+                            (1 + kMappingPages + 1) * page_size_,
+                            PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0) ||
+        mprotect(Base(), kMappingPages * page_size_, PROT_READ | PROT_WRITE) !=
+            0) {
+      return false;
+    }
+    for (size_t page : {size_t{1},
+                        1 + 1 + kShortHolePages,
+                        1 + 1 + kShortHolePages + 1 + kLongHolePages}) {
+      memset(Base() + page * page_size_, 'f', page_size_);
+    }
+    return true;
+  }
+
+ private:
+  void MultiprocessParent() override {
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ProcessSnapshotLinux snapshot;
+    snapshot.SetFullMemoryOptions(options_);
+    ASSERT_TRUE(snapshot.Initialize(&connection));
+
+    const VMAddress base = FromPointerCast<VMAddress>(Base());
+    const VMAddress end = base + kMappingPages * page_size_;
+    std::vector<const MemorySnapshot*> in_mapping;
+    VMAddress previous_end = 0;
+    for (const MemorySnapshot* memory : snapshot.FullMemory()) {
+      EXPECT_GE(memory->Address(), previous_end);
+      previous_end = memory->Address() + memory->Size();
+      if (memory->Address() < end && previous_end > base) {
+        in_mapping.push_back(memory);
+      }
+    }
+
+    // Zero-filled ranges are clipped to the mapping, since they may continue
+    // into neighboring zero-filled memory.
+    std::vector<CheckedRange<uint64_t>> zero_in_mapping;
+    previous_end = 0;
+    for (const CheckedRange<uint64_t>& range :
+         snapshot.FullMemoryZeroRanges()) {
+      EXPECT_GE(range.base(), previous_end);
+      previous_end = range.end();
+      if (range.base() < end && range.end() > base) {
+        const VMAddress clipped_base = std::max(range.base(), base);
+        zero_in_mapping.emplace_back(
+            clipped_base, std::min(range.end(), end) - clipped_base);
+      }
+    }
+
+    if (!options_.enabled || options_.skip_anonymous) {
+      EXPECT_TRUE(in_mapping.empty());
+      EXPECT_TRUE(zero_in_mapping.empty());
+      return;
+    }
+
+    // The short hole is captured along with the pages around it, and the long
+    // one is left out.
+    ASSERT_EQ(in_mapping.size(), 2u);
+    EXPECT_EQ(in_mapping[0]->Address(), base + page_size_);
+    EXPECT_EQ(in_mapping[0]->Size(), (1 + kShortHolePages + 1) * page_size_);
+    EXPECT_EQ(in_mapping[1]->Address(),
+              base + (1 + 1 + kShortHolePages + 1 + kLongHolePages) *
+                         page_size_);
+    EXPECT_EQ(in_mapping[1]->Size(), page_size_);
+
+    // The pages left out are reported as zero-filled.
+    ASSERT_EQ(zero_in_mapping.size(), 3u);
+    EXPECT_EQ(zero_in_mapping[0].base(), base);
+    EXPECT_EQ(zero_in_mapping[0].size(), page_size_);
+    EXPECT_EQ(zero_in_mapping[1].base(),
+              base + (1 + 1 + kShortHolePages + 1) * page_size_);
+    EXPECT_EQ(zero_in_mapping[1].size(), kLongHolePages * page_size_);
+    EXPECT_EQ(zero_in_mapping[2].base(), end - page_size_);
+    EXPECT_EQ(zero_in_mapping[2].size(), page_size_);
+  }
+
+  void MultiprocessChild() override { CheckedReadFileAtEOF(ReadPipeHandle()); }
+
+  // The first page after the leading guard page.
+  char* Base() const { return mapping_.addr_as<char*>() + page_size_; }
+
+  ProcessSnapshotLinux::FullMemoryOptions options_;
+  ScopedMmap mapping_;
+  const size_t page_size_;
+};
+
+TEST(ProcessSnapshotLinux, FullMemoryDisabled) {
+  FullMemoryTest test((ProcessSnapshotLinux::FullMemoryOptions()));
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+TEST(ProcessSnapshotLinux, FullMemory) {
+  ProcessSnapshotLinux::FullMemoryOptions options;
+  options.enabled = true;
+  FullMemoryTest test(options);
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+TEST(ProcessSnapshotLinux, FullMemorySkipAnonymous) {
+  ProcessSnapshotLinux::FullMemoryOptions options;
+  options.enabled = true;
+  options.skip_anonymous = true;
+  FullMemoryTest test(options);
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+// The mapping's zero-filled pages have never been touched, so they aren't
+// resident, but they are still known to be zero-filled.
+TEST(ProcessSnapshotLinux, FullMemorySkipNonResident) {
+  ProcessSnapshotLinux::FullMemoryOptions options;
+  options.enabled = true;
+  options.skip_non_resident = true;
+  FullMemoryTest test(options);
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+// The child inherits a private mapping of a file of nonzero pages, set up
+// before it is forked, and touches only its first page. The kernel may map
+// neighbors of a touched page along with it, but not as far as the last page.
+constexpr size_t kFilePages = 64;
+
+class FullMemoryNonResidentFileTest : public Multiprocess {
+ public:
+  explicit FullMemoryNonResidentFileTest(bool skip_non_resident)
+      : Multiprocess(),
+        skip_non_resident_(skip_non_resident),
+        page_size_(getpagesize()) {}
+
+  FullMemoryNonResidentFileTest(const FullMemoryNonResidentFileTest&) = delete;
+  FullMemoryNonResidentFileTest& operator=(
+      const FullMemoryNonResidentFileTest&) = delete;
+
+  ~FullMemoryNonResidentFileTest() {}
+
+  bool SetUp() {
+    const base::FilePath path = temp_dir_.path().Append("file");
+    ScopedFileHandle file(LoggingOpenFileForReadAndWrite(
+        path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    if (!file.is_valid()) {
+      return false;
+    }
+    const std::vector<char> contents(kFilePages * page_size_, 'f');
+    return LoggingWriteFile(file.get(), contents.data(), contents.size()) &&
+           mapping_.ResetMmap(nullptr,
+                              contents.size(),
+                              PROT_READ,
+                              MAP_PRIVATE,
+                              file.get(),
+                              0);
+  }
+
+ private:
+  void MultiprocessParent() override {
+    char c;
+    CheckedReadFileExactly(ReadPipeHandle(), &c, sizeof(c));
+
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ProcessSnapshotLinux::FullMemoryOptions options;
+    options.enabled = true;
+    options.skip_non_resident = skip_non_resident_;
+    ProcessSnapshotLinux snapshot;
+    snapshot.SetFullMemoryOptions(options);
+    ASSERT_TRUE(snapshot.Initialize(&connection));
+
+    const VMAddress base = mapping_.addr_as<VMAddress>();
+    const VMAddress end = base + kFilePages * page_size_;
+    std::vector<const MemorySnapshot*> in_mapping;
+    for (const MemorySnapshot* memory : snapshot.FullMemory()) {
+      if (memory->Address() < end &&
+          memory->Address() + memory->Size() > base) {
+        in_mapping.push_back(memory);
+      }
+    }
+    for (const CheckedRange<uint64_t>& range :
+         snapshot.FullMemoryZeroRanges()) {
+      EXPECT_FALSE(range.base() < end && range.end() > base);
+    }
+
+    ASSERT_EQ(in_mapping.size(), 1u);
+    EXPECT_EQ(in_mapping[0]->Address(), base);
+    if (skip_non_resident_) {
+      EXPECT_LT(in_mapping[0]->Address() + in_mapping[0]->Size(),
+                end - page_size_);
+    } else {
+      EXPECT_EQ(in_mapping[0]->Size(), kFilePages * page_size_);
+    }
+  }
+
+  void MultiprocessChild() override {
+    const volatile char* first_page = mapping_.addr_as<const char*>();
+    const char c = *first_page;
+    CheckedWriteFile(WritePipeHandle(), &c, sizeof(c));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  ScopedTempDir temp_dir_;
+  ScopedMmap mapping_;
+  const bool skip_non_resident_;
+  const size_t page_size_;
+};
+
+TEST(ProcessSnapshotLinux, FullMemoryFile) {
+  FullMemoryNonResidentFileTest test(false);
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+TEST(ProcessSnapshotLinux, FullMemorySkipNonResidentFile) {
+  FullMemoryNonResidentFileTest test(true);
+  ASSERT_TRUE(test.SetUp());
+  test.Run();
+}
+
+class UnwindStacksTest : public Multiprocess {
+ public:
+  UnwindStacksTest() : Multiprocess() {}
+
+  UnwindStacksTest(const UnwindStacksTest&) = delete;
+  UnwindStacksTest& operator=(const UnwindStacksTest&) = delete;
+
+  ~UnwindStacksTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ProcessSnapshotLinux::StackCaptureOptions options;
+    options.unwind_stacks = true;
+    ProcessSnapshotLinux snapshot;
+    snapshot.SetStackCaptureOptions(options);
+    ASSERT_TRUE(snapshot.Initialize(&connection));
+
+    const ThreadSnapshot* main_thread = nullptr;
+    for (const ThreadSnapshot* thread : snapshot.Threads()) {
+      if (thread->ThreadID() == static_cast<uint64_t>(ChildPID())) {
+        main_thread = thread;
+      }
+    }
+    ASSERT_TRUE(main_thread);
+
+    // The child is blocked reading from the pipe, a few calls below main(),
+    // so its stack unwinds through more than one frame.
+    const std::vector<UnwoundStackFrame> frames = main_thread->UnwoundFrames();
+    ASSERT_GT(frames.size(), 1u);
+    EXPECT_EQ(frames[0].instruction_pointer,
+              main_thread->Context()->InstructionPointer());
+    EXPECT_EQ(frames[0].stack_pointer, main_thread->Context()->StackPointer());
+
+    const MemorySnapshot* stack = main_thread->Stack();
+    ASSERT_TRUE(stack);
+    for (size_t index = 1; index < frames.size(); ++index) {
+      EXPECT_GT(frames[index].stack_pointer, frames[index - 1].stack_pointer);
+      EXPECT_NE(frames[index].instruction_pointer, 0u);
+      EXPECT_LE(frames[index].stack_pointer,
+                stack->Address() + stack->Size());
+    }
+  }
+
+  void MultiprocessChild() override { CheckedReadFileAtEOF(ReadPipeHandle()); }
+};
+
+TEST(ProcessSnapshotLinux, UnwindStacks) {
+  UnwindStacksTest test;
+  test.Run();
+}
+
+// A thread in the child that waits for the parent to finish.
+class BlockedThread : public Thread {
+ public:
+  explicit BlockedThread(FileHandle pipe) : Thread(), pipe_(pipe) {}
+
+  BlockedThread(const BlockedThread&) = delete;
+  BlockedThread& operator=(const BlockedThread&) = delete;
+
+  ~BlockedThread() override {}
+
+ private:
+  void ThreadMain() override { CheckedReadFileAtEOF(pipe_); }
+
+  FileHandle pipe_;
+};
+
+class BatchedStackReadsTest : public Multiprocess {
+ public:
+  BatchedStackReadsTest() : Multiprocess() {}
+
+  BatchedStackReadsTest(const BatchedStackReadsTest&) = delete;
+  BatchedStackReadsTest& operator=(const BatchedStackReadsTest&) = delete;
+
+  ~BatchedStackReadsTest() {}
+
+ private:
+  static constexpr size_t kExtraThreads = 3;
+
+  void MultiprocessParent() override {
+    char c;
+    CheckedReadFileExactly(ReadPipeHandle(), &c, sizeof(c));
+
+    DirectPtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(ChildPID()));
+
+    ProcessSnapshotLinux snapshot;
+    ASSERT_TRUE(snapshot.Initialize(&connection));
+    snapshot.CaptureIndirectlyReferencedMemory();
+
+    const std::vector<const ThreadSnapshot*> threads = snapshot.Threads();
+    ASSERT_EQ(threads.size(), kExtraThreads + 1);
+    for (const ThreadSnapshot* thread : threads) {
+      const MemorySnapshot* stack = thread->Stack();
+      ASSERT_GT(stack->Size(), 0u);
+      std::vector<uint8_t> contents(stack->Size());
+      EXPECT_TRUE(stack->ReadInto(contents.data()));
+    }
+
+    // Every stack was read in one batch, and written from the cache.
+    CaptureTimings timings;
+    snapshot.GetRemoteReads(&timings);
+    EXPECT_EQ(timings.GetRemoteReads(CaptureTimings::ReadCategory::kStack).reads,
+              1u);
+  }
+
+  void MultiprocessChild() override {
+    std::vector<std::unique_ptr<BlockedThread>> threads;
+    for (size_t index = 0; index < kExtraThreads; ++index) {
+      threads.push_back(std::make_unique<BlockedThread>(ReadPipeHandle()));
+      threads.back()->Start();
+    }
+
+    char c = '\0';
+    CheckedWriteFile(WritePipeHandle(), &c, sizeof(c));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+
+    for (const auto& thread : threads) {
+      thread->Join();
+    }
+  }
+};
+
+TEST(ProcessSnapshotLinux, BatchedStackReads) {
+  BatchedStackReadsTest test;
+  test.Run();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,319 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/stack_unwinder_linux.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/logging.h"
+#include "build/build_config.h"
+#include "snapshot/elf/elf_image_reader.h"
+
+#if defined(ARCH_CPU_ARM64)
+#include "util/linux/pac_helper.h"
+#endif
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+using RuleType = ElfUnwindTable::RuleType;
+
+// The DWARF numbers of the stack pointer and the general purpose registers
+// tracked on each architecture.
+constexpr uint32_t kX86_64StackPointer = 7;
+constexpr uint32_t kX86_64RegisterCount = 17;
+constexpr uint32_t kARM64StackPointer = 31;
+constexpr uint32_t kARM64RegisterCount = 32;
+
+// The values of the registers in a frame, by DWARF register number.
+struct Registers {
+  uint64_t values[ElfUnwindTable::kRegisterCount];
+  bool valid[ElfUnwindTable::kRegisterCount];
+};
+
+// Returns false if context’s architecture isn’t supported.
+bool InitializeRegisters(const CPUContext& context,
+                         Registers* registers,
+                         uint32_t* stack_pointer_register) {
+  memset(registers, 0, sizeof(*registers));
+  switch (context.architecture) {
+    case kCPUArchitectureX86_64: {
+      const CPUContextX86_64& x86_64 = *context.x86_64;
+      const uint64_t values[kX86_64RegisterCount] = {x86_64.rax,
+                                                     x86_64.rdx,
+                                                     x86_64.rcx,
+                                                     x86_64.rbx,
+                                                     x86_64.rsi,
+                                                     x86_64.rdi,
+                                                     x86_64.rbp,
+                                                     x86_64.rsp,
+                                                     x86_64.r8,
+                                                     x86_64.r9,
+                                                     x86_64.r10,
+                                                     x86_64.r11,
+                                                     x86_64.r12,
+                                                     x86_64.r13,
+                                                     x86_64.r14,
+                                                     x86_64.r15,
+                                                     x86_64.rip};
+      std::copy(std::begin(values), std::end(values), registers->values);
+      std::fill(
+          registers->valid, registers->valid + kX86_64RegisterCount, true);
+      *stack_pointer_register = kX86_64StackPointer;
+      return true;
+    }
+    case kCPUArchitectureARM64: {
+      const CPUContextARM64& arm64 = *context.arm64;
+      std::copy(
+          std::begin(arm64.regs), std::end(arm64.regs), registers->values);
+      registers->values[kARM64StackPointer] = arm64.sp;
+      std::fill(registers->valid, registers->valid + kARM64RegisterCount, true);
+      *stack_pointer_register = kARM64StackPointer;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Reads saved registers from a thread’s stack. Saved registers are close
+// together, so a page is read at a time and kept for the reads that follow.
+class StackReader {
+ public:
+  StackReader(const ProcessMemory* memory,
+              VMAddress stack_address,
+              VMSize stack_size)
+      : memory_(memory),
+        stack_address_(stack_address),
+        stack_end_(stack_address + stack_size),
+        page_address_(0),
+        page_size_(0) {}
+
+  StackReader(const StackReader&) = delete;
+  StackReader& operator=(const StackReader&) = delete;
+
+  bool Contains(VMAddress address) const {
+    return address >= stack_address_ && address <= stack_end_;
+  }
+
+  bool ReadWord(VMAddress address, uint64_t* value) {
+    if (address < stack_address_ || address >= stack_end_ ||
+        stack_end_ - address < sizeof(*value)) {
+      return false;
+    }
+    if (address < page_address_ ||
+        address + sizeof(*value) > page_address_ + page_size_) {
+      page_address_ = std::max(address & ~VMAddress{sizeof(page_) - 1},
+                               stack_address_);
+      page_size_ = static_cast<size_t>(
+          std::min<VMSize>(sizeof(page_), stack_end_ - page_address_));
+      if (address + sizeof(*value) > page_address_ + page_size_ ||
+          !memory_->Read(page_address_, page_size_, page_)) {
+        page_size_ = 0;
+        return false;
+      }
+    }
+    memcpy(value, page_ + (address - page_address_), sizeof(*value));
+    return true;
+  }
+
+ private:
+  const ProcessMemory* memory_;  // weak
+  VMAddress stack_address_;
+  VMAddress stack_end_;
+  VMAddress page_address_;
+  size_t page_size_;
+  uint8_t page_[4096];
+};
+
+}  // namespace
+
+StackUnwinderLinux::StackUnwinderLinux()
+    : modules_(), process_reader_(nullptr) {}
+
+StackUnwinderLinux::~StackUnwinderLinux() = default;
+
+void StackUnwinderLinux::Initialize(ProcessReaderLinux* process_reader) {
+  process_reader_ = process_reader;
+  for (const ProcessReaderLinux::Module& module : process_reader->Modules()) {
+    if (!module.elf_reader) {
+      continue;
+    }
+    modules_.push_back({module.elf_reader->Address(),
+                        module.elf_reader->Address() +
+                            module.elf_reader->Size(),
+                        module.elf_reader,
+                        nullptr,
+                        false});
+  }
+  std::sort(modules_.begin(),
+            modules_.end(),
+            [](const Module& a, const Module& b) {
+              return a.address < b.address;
+            });
+}
+
+bool StackUnwinderLinux::Unwind(const CPUContext& context,
+                                VMAddress stack_address,
+                                VMSize stack_size,
+                                std::vector<UnwoundStackFrame>* frames,
+                                VMAddress* frames_end) {
+  DCHECK(process_reader_);
+  frames->clear();
+
+  uint64_t pc = context.InstructionPointer();
+  uint64_t sp = context.StackPointer();
+  frames->push_back({pc, sp});
+
+  Registers registers;
+  uint32_t sp_register;
+  if (!InitializeRegisters(context, &registers, &sp_register)) {
+    return false;
+  }
+
+#if defined(ARCH_CPU_ARM64)
+  const VMAddress pac_mask = PACAddressMask();
+#endif
+
+  StackReader stack(process_reader_->Memory(), stack_address, stack_size);
+
+  // The innermost frame, and the frame interrupted by a signal, are executing
+  // the instruction at pc. Other frames are executing the call before their
+  // return address, which may be the last instruction of a function, so the
+  // rules for the instruction before the return address are used.
+  bool pc_is_return_address = false;
+  ElfUnwindTable::Row row;
+  while (true) {
+    const VMAddress lookup_address = pc_is_return_address ? pc - 1 : pc;
+    ElfUnwindTable* unwind_table = UnwindTableForAddress(lookup_address);
+    if (!unwind_table || !unwind_table->FindRow(lookup_address, &row)) {
+      return false;
+    }
+
+    if (row.cfa_register >= ElfUnwindTable::kRegisterCount ||
+        !registers.valid[row.cfa_register]) {
+      return false;
+    }
+    const uint64_t cfa =
+        registers.values[row.cfa_register] + row.cfa_offset;
+    if (cfa < sp || !stack.Contains(cfa)) {
+      return false;
+    }
+
+    Registers caller = registers;
+    for (uint32_t reg = 0; reg < ElfUnwindTable::kRegisterCount; ++reg) {
+      const ElfUnwindTable::Rule& rule = row.registers[reg];
+      switch (rule.type) {
+        case RuleType::kUnspecified:
+        case RuleType::kSameValue:
+          break;
+        case RuleType::kUndefined:
+        case RuleType::kExpression:
+          caller.valid[reg] = false;
+          break;
+        case RuleType::kOffset:
+          caller.valid[reg] =
+              stack.ReadWord(cfa + rule.value, &caller.values[reg]);
+          break;
+        case RuleType::kValueOffset:
+          caller.values[reg] = cfa + rule.value;
+          caller.valid[reg] = true;
+          break;
+        case RuleType::kRegister: {
+          const uint64_t source = static_cast<uint64_t>(rule.value);
+          caller.valid[reg] = source < ElfUnwindTable::kRegisterCount &&
+                              registers.valid[source];
+          if (caller.valid[reg]) {
+            caller.values[reg] = registers.values[source];
+          }
+          break;
+        }
+      }
+    }
+
+    // An undefined return address marks the outermost frame, as set up by a
+    // process’ or thread’s entry point.
+    const uint32_t ra_register = row.return_address_register;
+    if (row.registers[ra_register].type == RuleType::kUndefined) {
+      *frames_end = cfa;
+      return true;
+    }
+    if (!caller.valid[ra_register]) {
+      return false;
+    }
+
+    uint64_t return_address = caller.values[ra_register];
+#if defined(ARCH_CPU_ARM64)
+    if (context.architecture == kCPUArchitectureARM64) {
+      return_address = StripPACBitsWithMask(return_address, pac_mask);
+    }
+#endif
+    if (return_address == 0) {
+      *frames_end = cfa;
+      return true;
+    }
+
+    // Each frame must move up the stack, or keep the stack pointer but return
+    // somewhere else, so that a corrupt rule can’t loop forever.
+    if (cfa == sp && return_address == pc) {
+      return false;
+    }
+
+    if (frames->size() >= kMaxFrames) {
+      return false;
+    }
+
+    caller.values[sp_register] = cfa;
+    caller.valid[sp_register] = true;
+    registers = caller;
+    pc = return_address;
+    sp = cfa;
+    pc_is_return_address = !row.signal_frame;
+    frames->push_back({pc, sp});
+  }
+}
+
+ElfUnwindTable* StackUnwinderLinux::UnwindTableForAddress(VMAddress address) {
+  auto module = std::upper_bound(
+      modules_.begin(),
+      modules_.end(),
+      address,
+      [](VMAddress address, const Module& module) {
+        return address < module.address;
+      });
+  if (module == modules_.begin()) {
+    return nullptr;
+  }
+  --module;
+  if (address >= module->end) {
+    return nullptr;
+  }
+
+  if (!module->unwind_table_read) {
+    module->unwind_table_read = true;
+    auto unwind_table = std::make_unique<ElfUnwindTable>();
+    if (unwind_table->Initialize(module->image_reader)) {
+      module->unwind_table = std::move(unwind_table);
+    }
+  }
+  return module->unwind_table.get();
+}
+
+}  // namespace internal
+}  // namespace crashpad
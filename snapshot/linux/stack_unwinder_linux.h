@@ -0,0 +1,99 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
+#define CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "snapshot/cpu_context.h"
+#include "snapshot/elf/elf_unwind_table.h"
+#include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/misc/address_types.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Unwinds the stacks of threads in a process captured by a
+//!     ProcessReaderLinux, using the `.eh_frame` call frame information in
+//!     its modules.
+//!
+//! Unwinding is supported for x86-64 and ARM64 processes. Each module’s
+//! ElfUnwindTable is read the first time a frame is found in the module, and
+//! reused for later frames and threads.
+class StackUnwinderLinux {
+ public:
+  //! \brief The most frames that Unwind() finds in a stack.
+  static constexpr size_t kMaxFrames = 1024;
+
+  StackUnwinderLinux();
+
+  StackUnwinderLinux(const StackUnwinderLinux&) = delete;
+  StackUnwinderLinux& operator=(const StackUnwinderLinux&) = delete;
+
+  ~StackUnwinderLinux();
+
+  //! \brief Prepares to unwind stacks in the process read by \a
+  //!     process_reader.
+  //!
+  //! \param[in] process_reader The reader for the process. This object does
+  //!     not take ownership of \a process_reader, which must outlive it.
+  void Initialize(ProcessReaderLinux* process_reader);
+
+  //! \brief Unwinds a thread’s stack.
+  //!
+  //! \param[in] context The thread’s registers.
+  //! \param[in] stack_address The lowest address of the thread’s stack that
+  //!     may be read.
+  //! \param[in] stack_size The size of the thread’s stack that may be read.
+  //!     Frames beyond it are not followed.
+  //! \param[out] frames The frames found, innermost first. If unwinding
+  //!     stops early, these are the frames found before it stopped, which is
+  //!     only the innermost frame if the process’ architecture isn’t
+  //!     supported.
+  //! \param[out] frames_end The highest canonical frame address computed, one
+  //!     past the highest stack address that the frames occupy. Valid only if
+  //!     this method returns `true`.
+  //! \return `true` if the outermost frame was reached. `false` otherwise.
+  bool Unwind(const CPUContext& context,
+              VMAddress stack_address,
+              VMSize stack_size,
+              std::vector<UnwoundStackFrame>* frames,
+              VMAddress* frames_end);
+
+ private:
+  struct Module {
+    VMAddress address;
+    VMAddress end;
+    ElfImageReader* image_reader;  // weak
+    std::unique_ptr<ElfUnwindTable> unwind_table;
+    bool unwind_table_read;
+  };
+
+  // Returns the unwind table for the module containing address, reading it if
+  // necessary, or nullptr if there isn’t one.
+  ElfUnwindTable* UnwindTableForAddress(VMAddress address);
+
+  std::vector<Module> modules_;
+  ProcessReaderLinux* process_reader_;  // weak
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
@@ -133,6 +133,103 @@ bool ReadProperty(const char* property, std::string* value) {
 }
 #endif  // BUILDFLAG(IS_ANDROID)
 
+// The parts of a system snapshot that can’t change without a reboot. A handler
+// that captures a crash loop would otherwise reread them for every dump.
+struct SystemInfo {
+  std::string os_version_full;
+  std::string os_version_build;
+  std::string machine_description;
+  int os_version_major = -1;
+  int os_version_minor = -1;
+  int os_version_bugfix = -1;
+};
+
+void ReadKernelVersion(const std::string& version_string, SystemInfo* info) {
+  std::vector<std::string> versions = SplitString(version_string, '.');
+  if (versions.size() < 3) {
+    LOG(WARNING) << "format error";
+    return;
+  }
+
+  if (!base::StringToInt(base::StringPiece(versions[0]),
+                         &info->os_version_major)) {
+    LOG(WARNING) << "no kernel version";
+    return;
+  }
+  DCHECK_GE(info->os_version_major, 3);
+
+  if (!base::StringToInt(base::StringPiece(versions[1]),
+                         &info->os_version_minor)) {
+    LOG(WARNING) << "no major revision";
+    return;
+  }
+  DCHECK_GE(info->os_version_minor, 0);
+
+  size_t minor_rev_end = versions[2].find_first_not_of("0123456789");
+  if (minor_rev_end == std::string::npos) {
+    minor_rev_end = versions[2].size();
+  }
+  if (!base::StringToInt(base::StringPiece(versions[2].c_str(), minor_rev_end),
+                         &info->os_version_bugfix)) {
+    LOG(WARNING) << "no minor revision";
+    return;
+  }
+  DCHECK_GE(info->os_version_bugfix, 0);
+
+  if (!info->os_version_build.empty()) {
+    info->os_version_build.push_back(' ');
+  }
+  info->os_version_build += versions[2].substr(minor_rev_end);
+}
+
+SystemInfo* ReadSystemInfo() {
+  SystemInfo* info = new SystemInfo();
+
+#if BUILDFLAG(IS_ANDROID)
+  std::string build_string;
+  if (ReadProperty("ro.build.fingerprint", &build_string)) {
+    info->os_version_build = build_string;
+    info->os_version_full = build_string;
+  }
+
+  std::string prop;
+  if (ReadProperty("ro.product.model", &prop)) {
+    info->machine_description += prop;
+  }
+  if (ReadProperty("ro.product.board", &prop)) {
+    if (!info->machine_description.empty()) {
+      info->machine_description.push_back(' ');
+    }
+    info->machine_description += prop;
+  }
+#endif  // BUILDFLAG(IS_ANDROID)
+
+  utsname uts;
+  if (uname(&uts) != 0) {
+    PLOG(WARNING) << "uname";
+    return info;
+  }
+  if (!info->os_version_full.empty()) {
+    info->os_version_full.push_back(' ');
+  }
+  info->os_version_full += base::StringPrintf(
+      "%s %s %s %s", uts.sysname, uts.release, uts.version, uts.machine);
+  ReadKernelVersion(uts.release, info);
+
+  if (!info->os_version_build.empty()) {
+    info->os_version_build.push_back(' ');
+  }
+  info->os_version_build += uts.version;
+  info->os_version_build.push_back(' ');
+  info->os_version_build += uts.machine;
+  return info;
+}
+
+const SystemInfo& GetSystemInfo() {
+  static const SystemInfo* info = ReadSystemInfo();
+  return *info;
+}
+
 }  // namespace
 
 SystemSnapshotLinux::SystemSnapshotLinux()
@@ -160,32 +257,12 @@ void SystemSnapshotLinux::Initialize(ProcessReaderLinux* process_reader,
   process_reader_ = process_reader;
   snapshot_time_ = snapshot_time;
 
-#if BUILDFLAG(IS_ANDROID)
-  std::string build_string;
-  if (ReadProperty("ro.build.fingerprint", &build_string)) {
-    os_version_build_ = build_string;
-    os_version_full_ = build_string;
-  }
-#endif  // BUILDFLAG(IS_ANDROID)
-
-  utsname uts;
-  if (uname(&uts) != 0) {
-    PLOG(WARNING) << "uname";
-  } else {
-    if (!os_version_full_.empty()) {
-      os_version_full_.push_back(' ');
-    }
-    os_version_full_ += base::StringPrintf(
-        "%s %s %s %s", uts.sysname, uts.release, uts.version, uts.machine);
-  }
-  ReadKernelVersion(uts.release);
-
-  if (!os_version_build_.empty()) {
-    os_version_build_.push_back(' ');
-  }
-  os_version_build_ += uts.version;
-  os_version_build_.push_back(' ');
-  os_version_build_ += uts.machine;
+  const SystemInfo& system_info = GetSystemInfo();
+  os_version_full_ = system_info.os_version_full;
+  os_version_build_ = system_info.os_version_build;
+  os_version_major_ = system_info.os_version_major;
+  os_version_minor_ = system_info.os_version_minor;
+  os_version_bugfix_ = system_info.os_version_bugfix;
 
   if (!ReadCPUsOnline(&target_cpu_, &cpu_count_)) {
     target_cpu_ = 0;
@@ -265,6 +342,8 @@ void SystemSnapshotLinux::CPUFrequency(uint64_t* current_hz,
                    target_cpu_),
                current_hz);
 
+  // scaling_max_freq is changed at runtime by thermal and power management,
+  // and is missing while the CPU is offline, so it isn't cached.
   ReadFreqFile(base::StringPrintf(
                    "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_max_freq",
                    target_cpu_),
@@ -350,18 +429,7 @@ std::string SystemSnapshotLinux::OSVersionFull() const {
 std::string SystemSnapshotLinux::MachineDescription() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if BUILDFLAG(IS_ANDROID)
-  std::string description;
-  std::string prop;
-  if (ReadProperty("ro.product.model", &prop)) {
-    description += prop;
-  }
-  if (ReadProperty("ro.product.board", &prop)) {
-    if (!description.empty()) {
-      description.push_back(' ');
-    }
-    description += prop;
-  }
-  return description;
+  return GetSystemInfo().machine_description;
 #else
   return std::string();
 #endif  // BUILDFLAG(IS_ANDROID)
@@ -399,41 +467,5 @@ void SystemSnapshotLinux::TimeZone(DaylightSavingTimeStatus* dst_status,
                      daylight_name);
 }
 
-void SystemSnapshotLinux::ReadKernelVersion(const std::string& version_string) {
-  std::vector<std::string> versions = SplitString(version_string, '.');
-  if (versions.size() < 3) {
-    LOG(WARNING) << "format error";
-    return;
-  }
-
-  if (!base::StringToInt(base::StringPiece(versions[0]), &os_version_major_)) {
-    LOG(WARNING) << "no kernel version";
-    return;
-  }
-  DCHECK_GE(os_version_major_, 3);
-
-  if (!base::StringToInt(base::StringPiece(versions[1]), &os_version_minor_)) {
-    LOG(WARNING) << "no major revision";
-    return;
-  }
-  DCHECK_GE(os_version_minor_, 0);
-
-  size_t minor_rev_end = versions[2].find_first_not_of("0123456789");
-  if (minor_rev_end == std::string::npos) {
-    minor_rev_end = versions[2].size();
-  }
-  if (!base::StringToInt(base::StringPiece(versions[2].c_str(), minor_rev_end),
-                         &os_version_bugfix_)) {
-    LOG(WARNING) << "no minor revision";
-    return;
-  }
-  DCHECK_GE(os_version_bugfix_, 0);
-
-  if (!os_version_build_.empty()) {
-    os_version_build_.push_back(' ');
-  }
-  os_version_build_ += versions[2].substr(minor_rev_end);
-}
-
 }  // namespace internal
 }  // namespace crashpad
@@ -92,8 +92,6 @@ class SystemSnapshotLinux final : public SystemSnapshot {
   uint64_t AddressMask() const override { return 0; }
 
  private:
-  void ReadKernelVersion(const std::string& version_string);
-
   std::string os_version_full_;
   std::string os_version_build_;
   ProcessReaderLinux* process_reader_;  // weak
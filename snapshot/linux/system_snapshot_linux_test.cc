@@ -88,6 +88,38 @@ TEST(SystemSnapshotLinux, Basic) {
 #endif  // ARCH_CPU_X86_FAMILY
 }
 
+TEST(SystemSnapshotLinux, RepeatedSnapshotsAgree) {
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+
+  timeval snapshot_time;
+  ASSERT_EQ(gettimeofday(&snapshot_time, nullptr), 0)
+      << ErrnoMessage("gettimeofday");
+
+  // The second snapshot’s fixed information comes from what the first read.
+  internal::SystemSnapshotLinux first;
+  first.Initialize(&process_reader, &snapshot_time);
+  internal::SystemSnapshotLinux second;
+  second.Initialize(&process_reader, &snapshot_time);
+
+  int first_major, first_minor, first_bugfix;
+  std::string first_build;
+  first.OSVersion(&first_major, &first_minor, &first_bugfix, &first_build);
+  int second_major, second_minor, second_bugfix;
+  std::string second_build;
+  second.OSVersion(
+      &second_major, &second_minor, &second_bugfix, &second_build);
+  EXPECT_EQ(second_major, first_major);
+  EXPECT_EQ(second_minor, first_minor);
+  EXPECT_EQ(second_bugfix, first_bugfix);
+  EXPECT_EQ(second_build, first_build);
+  EXPECT_EQ(second.OSVersionFull(), first.OSVersionFull());
+  EXPECT_EQ(second.MachineDescription(), first.MachineDescription());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
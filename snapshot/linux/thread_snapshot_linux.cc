@@ -16,10 +16,13 @@
 
 #include <sched.h>
 
+#include <utility>
+
 #include "base/logging.h"
 #include "snapshot/linux/capture_memory_delegate_linux.h"
 #include "snapshot/linux/cpu_context_linux.h"
 #include "util/misc/reinterpret_bytes.h"
+#include "util/process/process_memory_accounting.h"
 
 namespace crashpad {
 namespace internal {
@@ -199,10 +202,13 @@ bool ThreadSnapshotLinux::Initialize(
 #else
 #error Port.
 #endif
+  context_.has_floating_point = thread.have_floating_point;
 
   stack_.Initialize(process_reader->Memory(),
                     thread.stack_region_address,
                     thread.stack_region_size);
+  stack_.set_read_category(ProcessMemoryAccounting::ReadCategory::kStack);
+  stack_.set_read_cache(process_reader->ReadCache());
 
   thread_specific_data_address_ =
       thread.thread_info.thread_specific_data_address;
@@ -216,17 +222,35 @@ bool ThreadSnapshotLinux::Initialize(
                 thread.static_priority, thread.sched_policy, thread.nice_value)
           : -1;
 
-  CaptureMemoryDelegateLinux capture_memory_delegate(
-      process_reader,
-      &thread,
-      &pointed_to_memory_,
-      gather_indirectly_referenced_memory_bytes_remaining);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  if (gather_indirectly_referenced_memory_bytes_remaining) {
+    capture_memory_delegate_ = std::make_unique<CaptureMemoryDelegateLinux>(
+        process_reader,
+        &thread,
+        &pointed_to_memory_,
+        gather_indirectly_referenced_memory_bytes_remaining);
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+void ThreadSnapshotLinux::AddIndirectlyReferencedMemoryCandidates(
+    bool is_exception_thread,
+    PrioritizedCaptureMemory* capture) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!capture_memory_delegate_) {
+    return;
+  }
+
+  if (!is_exception_thread) {
+    capture->AddContext(context_, false, capture_memory_delegate_.get());
+  }
+  capture->AddStack(stack_,
+                    context_.StackPointer(),
+                    is_exception_thread,
+                    capture_memory_delegate_.get());
+}
+
 const CPUContext* ThreadSnapshotLinux::Context() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return &context_;
@@ -272,5 +296,30 @@ std::vector<const MemorySnapshot*> ThreadSnapshotLinux::ExtraMemory() const {
   return result;
 }
 
+std::vector<uint8_t> ThreadSnapshotLinux::Breadcrumbs() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return breadcrumbs_;
+}
+
+void ThreadSnapshotLinux::SetBreadcrumbs(std::vector<uint8_t> breadcrumbs) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  breadcrumbs_ = std::move(breadcrumbs);
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotLinux::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return unwound_frames_;
+}
+
+void ThreadSnapshotLinux::SetUnwoundFrames(
+    std::vector<UnwoundStackFrame> frames,
+    VMSize stack_size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  unwound_frames_ = std::move(frames);
+  if (stack_size < stack_.Size()) {
+    stack_.Shrink(stack_size);
+  }
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -17,8 +17,13 @@
 
 #include <stdint.h>
 
+#include <memory>
+#include <vector>
+
 #include "build/build_config.h"
+#include "snapshot/capture_memory.h"
 #include "snapshot/cpu_context.h"
+#include "snapshot/linux/capture_memory_delegate_linux.h"
 #include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
@@ -44,6 +49,12 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   //!     the thread.
   //! \param[in] thread The thread within the ProcessReaderLinux for
   //!     which the snapshot should be created.
+  //! \param[in,out] gather_indirectly_referenced_memory_bytes_remaining If
+  //!     non-null, memory pointed to by the thread's registers and stack may be
+  //!     added to the snapshot by
+  //!     AddIndirectlyReferencedMemoryCandidates(). The size of the regions
+  //!     added is subtracted from the count, and when it's `0`, no more
+  //!     regions will be added.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     a message logged.
@@ -52,6 +63,44 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
       const ProcessReaderLinux::Thread& thread,
       uint32_t* gather_indirectly_referenced_memory_bytes_remaining);
 
+  //! \brief Sets the contents of the thread’s breadcrumb buffer, to be
+  //!     returned by Breadcrumbs().
+  //!
+  //! Initialize() must be called before this method.
+  //!
+  //! \param[in] breadcrumbs The serialized RingBufferData of the thread’s
+  //!     breadcrumb buffer.
+  void SetBreadcrumbs(std::vector<uint8_t> breadcrumbs);
+
+  //! \brief Sets the frames found by unwinding the thread’s stack, to be
+  //!     returned by UnwoundFrames(), and limits the stack captured to the
+  //!     memory they occupy.
+  //!
+  //! Initialize() must be called before this method.
+  //!
+  //! \param[in] frames The frames, innermost first.
+  //! \param[in] stack_size The number of bytes of the stack to capture, from
+  //!     the start of Stack(). The stack is never enlarged.
+  void SetUnwoundFrames(std::vector<UnwoundStackFrame> frames,
+                        VMSize stack_size);
+
+  //! \brief Adds the pointer-like values in this thread's registers and stack
+  //!     to \a capture.
+  //!
+  //! Memory captured for them by PrioritizedCaptureMemory::Capture() is
+  //! returned by ExtraMemory(). This does nothing if Initialize() was called
+  //! without a budget.
+  //!
+  //! Initialize() must be called before this method.
+  //!
+  //! \param[in] is_exception_thread `true` if this thread raised the exception
+  //!     being captured. Its registers are not added, as the
+  //!     ExceptionSnapshotLinux captures memory around them.
+  //! \param[in] capture The PrioritizedCaptureMemory to add candidates to.
+  void AddIndirectlyReferencedMemoryCandidates(
+      bool is_exception_thread,
+      PrioritizedCaptureMemory* capture);
+
   // ThreadSnapshot:
 
   const CPUContext* Context() const override;
@@ -62,6 +111,8 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  std::vector<uint8_t> Breadcrumbs() const override;
+  std::vector<UnwoundStackFrame> UnwoundFrames() const override;
 
  private:
   union {
@@ -88,6 +139,9 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   int priority_;
   InitializationStateDcheck initialized_;
   std::vector<std::unique_ptr<MemorySnapshotGeneric>> pointed_to_memory_;
+  std::unique_ptr<CaptureMemoryDelegateLinux> capture_memory_delegate_;
+  std::vector<uint8_t> breadcrumbs_;
+  std::vector<UnwoundStackFrame> unwound_frames_;
 };
 
 }  // namespace internal
@@ -18,6 +18,7 @@
 #include <mach/mach.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "base/logging.h"
@@ -27,9 +28,23 @@
 #include "snapshot/mac/process_reader_mac.h"
 #include "snapshot/snapshot_constants.h"
 #include "util/stdlib/strnlen.h"
+#include "util/synchronization/seqlock.h"
 
 namespace crashpad {
 
+namespace {
+
+// Annotation names are read in a batch with a fixed size, clipped so that the
+// read never extends into a following page, which may not be mapped.
+constexpr mach_vm_size_t kNameReadPageSize = 4096;
+
+mach_vm_size_t NameReadSize(mach_vm_address_t address) {
+  return std::min(mach_vm_size_t{Annotation::kNameMaxLength},
+                  kNameReadPageSize - address % kNameReadPageSize);
+}
+
+}  // namespace
+
 MachOImageAnnotationsReader::MachOImageAnnotationsReader(
     ProcessReaderMac* process_reader,
     const MachOImageReader* image_reader,
@@ -203,6 +218,9 @@ void MachOImageAnnotationsReader::ReadCrashpadAnnotationsList(
     return;
   }
 
+  // Gather the set annotations first, so that their names and values can all
+  // be read together.
+  std::vector<process_types::Annotation> objects;
   process_types::Annotation current = annotation_list_object.head;
   for (size_t index = 0;
        current.link_node != annotation_list_object.tail_pointer &&
@@ -211,28 +229,59 @@ void MachOImageAnnotationsReader::ReadCrashpadAnnotationsList(
     if (!current.Read(process_reader_, current.link_node)) {
       LOG(WARNING) << "could not read annotation at index " << index << " in "
                    << name_;
-      return;
+      break;
     }
 
-    if (current.size == 0) {
+    // The process is suspended, so a seqlock-guarded annotation with an odd
+    // sequence was stopped partway through an update.
+    if (current.concurrent_access_guard_mode ==
+            static_cast<uint8_t>(
+                Annotation::ConcurrentAccessGuardMode::kSeqlock) &&
+        !SeqlockState::IsStable(current.guard_state)) {
+      LOG(WARNING) << "skipping annotation at index " << index
+                   << " being written in " << name_;
       continue;
     }
 
-    AnnotationSnapshot snapshot;
-    snapshot.type = current.type;
-    snapshot.value.resize(current.size);
+    if (current.size != 0) {
+      objects.push_back(current);
+    }
+  }
 
-    if (!process_reader_->Memory()->ReadCStringSizeLimited(
-            current.name, Annotation::kNameMaxLength, &snapshot.name)) {
+  std::vector<AnnotationSnapshot> snapshots(objects.size());
+  std::vector<ProcessMemory::ReadRequest> requests;
+  for (size_t index = 0; index < objects.size(); ++index) {
+    AnnotationSnapshot& snapshot = snapshots[index];
+    snapshot.type = objects[index].type;
+    snapshot.name.resize(NameReadSize(objects[index].name));
+    snapshot.value.resize(std::min(static_cast<size_t>(objects[index].size),
+                                   Annotation::kValueMaxSize));
+    requests.push_back(
+        {objects[index].name, snapshot.name.size(), snapshot.name.data()});
+    requests.push_back(
+        {objects[index].value, snapshot.value.size(), snapshot.value.data()});
+  }
+  const bool batch_read = process_reader_->Memory()->ReadBatch(requests);
+
+  for (size_t index = 0; index < objects.size(); ++index) {
+    AnnotationSnapshot& snapshot = snapshots[index];
+    const process_types::Annotation& object = objects[index];
+
+    size_t name_length =
+        batch_read ? strnlen(snapshot.name.data(), snapshot.name.size())
+                   : snapshot.name.size();
+    if (name_length < snapshot.name.size()) {
+      snapshot.name.resize(name_length);
+    } else if (!process_reader_->Memory()->ReadCStringSizeLimited(
+                   object.name, Annotation::kNameMaxLength, &snapshot.name)) {
       LOG(WARNING) << "could not read annotation name at index " << index
                    << " in " << name_;
       continue;
     }
 
-    size_t size =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
-    if (!process_reader_->Memory()->Read(
-            current.value, size, snapshot.value.data())) {
+    if (!batch_read &&
+        !process_reader_->Memory()->Read(
+            object.value, snapshot.value.size(), snapshot.value.data())) {
       LOG(WARNING) << "could not read annotation value at index " << index
                    << " in " << name_;
       continue;
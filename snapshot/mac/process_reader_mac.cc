@@ -29,10 +29,15 @@
 #include "base/strings/stringprintf.h"
 #include "snapshot/mac/mach_o_image_reader.h"
 #include "snapshot/mac/process_types.h"
+#include "snapshot/mac/shared_cache_image_header_cache.h"
 #include "util/misc/scoped_forbid_return.h"
 
 namespace {
 
+// Images’ headers and load commands are usually a few kilobytes. Anything much
+// larger is more likely to be a corrupt mach_header than real load commands.
+constexpr size_t kMaxPrefetchedHeadersSize = 1024 * 1024;
+
 void MachTimeValueToTimeval(const time_value& mach, timeval* tv) {
   tv->tv_sec = mach.seconds;
   tv->tv_usec = mach.microseconds;
@@ -95,6 +100,10 @@ ProcessReaderMac::ProcessReaderMac()
       modules_(),
       module_readers_(),
       process_memory_(),
+      shared_cache_image_headers_(nullptr),
+      vm_regions_(),
+      shared_cache_uuid_(),
+      shared_cache_base_address_(0),
       task_(TASK_NULL),
       initialized_(),
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT)
@@ -111,14 +120,17 @@ ProcessReaderMac::~ProcessReaderMac() {
   }
 }
 
-bool ProcessReaderMac::Initialize(task_t task) {
+bool ProcessReaderMac::Initialize(
+    task_t task,
+    size_t memory_cache_mappings,
+    SharedCacheImageHeaderCache* shared_cache_image_headers) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (!process_info_.InitializeWithTask(task)) {
     return false;
   }
 
-  if (!process_memory_.Initialize(task)) {
+  if (!process_memory_.Initialize(task, memory_cache_mappings)) {
     return false;
   }
 
@@ -129,6 +141,7 @@ bool ProcessReaderMac::Initialize(task_t task) {
 #endif  // CRASHPAD_MAC_32_BIT_SUPPORT
 
   task_ = task;
+  shared_cache_image_headers_ = shared_cache_image_headers;
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -410,6 +423,10 @@ void ProcessReaderMac::InitializeThreads() {
     threads_.push_back(thread);
   }
 
+  // The map may change once the task is no longer being examined, so don’t
+  // keep regions found for thread stacks any longer than necessary.
+  vm_regions_.clear();
+
   threads_need_owners.Disarm();
 }
 
@@ -456,6 +473,12 @@ void ProcessReaderMac::InitializeModules() {
   // Continue along when this situation is detected, because even without any
   // images in infoArray, dyldImageLoadAddress may be set, and it may be
   // possible to recover some information from dyld.
+  if (shared_cache_image_headers_ && all_image_infos.version >= 15 &&
+      all_image_infos.sharedCacheBaseAddress) {
+    shared_cache_uuid_.InitializeFromBytes(all_image_infos.sharedCacheUUID);
+    shared_cache_base_address_ = all_image_infos.sharedCacheBaseAddress;
+  }
+
   if (all_image_infos.infoArrayCount == 0) {
     LOG(WARNING) << "all_image_infos.infoArrayCount is zero";
   } else if (!all_image_infos.infoArray) {
@@ -485,7 +508,8 @@ void ProcessReaderMac::InitializeModules() {
     }
 
     std::unique_ptr<MachOImageReader> reader(new MachOImageReader());
-    if (!reader->Initialize(this, image_info.imageLoadAddress, module.name)) {
+    if (!InitializeModuleReader(
+            reader.get(), image_info.imageLoadAddress, module.name)) {
       reader.reset();
     }
 
@@ -599,6 +623,86 @@ void ProcessReaderMac::InitializeModules() {
   }
 }
 
+bool ProcessReaderMac::InitializeModuleReader(MachOImageReader* reader,
+                                              mach_vm_address_t address,
+                                              const std::string& name) {
+  process_types::mach_header mach_header;
+  if (!mach_header.Read(this, address)) {
+    return reader->Initialize(this, address, name);
+  }
+
+  // The headers of an image in the shared cache are the same in every process
+  // using that shared cache, so they can be used from a previous snapshot
+  // instead of being read from this task. The size check guards against a
+  // cached entry that doesn’t correspond to this image.
+  const bool in_shared_cache = shared_cache_base_address_ &&
+                               address >= shared_cache_base_address_ &&
+                               (mach_header.flags & MH_DYLIB_IN_CACHE);
+  const uint64_t image_offset =
+      in_shared_cache ? address - shared_cache_base_address_ : 0;
+  const size_t headers_size = mach_header.Size() + mach_header.sizeofcmds;
+  if (in_shared_cache) {
+    std::shared_ptr<const std::vector<uint8_t>> headers =
+        shared_cache_image_headers_->Lookup(shared_cache_uuid_, image_offset);
+    if (headers && headers->size() == headers_size) {
+      process_memory_.AddKnownRange(address, std::move(headers));
+      return reader->Initialize(this, address, name);
+    }
+  }
+
+  // MachOImageReader reads each load command, and then each command’s own
+  // structure, separately. Reading all of them at once lets those reads be
+  // served locally, rather than making two trips to the task per command. A
+  // header claiming an implausible size is left for the reader to reject.
+  if (headers_size > kMaxPrefetchedHeadersSize) {
+    return reader->Initialize(this, address, name);
+  }
+  auto headers = std::make_shared<std::vector<uint8_t>>(headers_size);
+  if (!process_memory_.Read(address, headers_size, headers->data())) {
+    return reader->Initialize(this, address, name);
+  }
+  process_memory_.AddKnownRange(address, headers);
+
+  if (!reader->Initialize(this, address, name)) {
+    return false;
+  }
+
+  if (in_shared_cache) {
+    shared_cache_image_headers_->Insert(
+        shared_cache_uuid_, image_offset, *headers);
+  }
+  return true;
+}
+
+kern_return_t ProcessReaderMac::RegionRecurseDeepest(
+    mach_vm_address_t* address,
+    mach_vm_size_t* size,
+    natural_t* depth,
+    vm_prot_t* protection,
+    unsigned int* user_tag) {
+  // Find the last known region that begins at or below |address|, and use it
+  // if it contains |address|.
+  auto it = vm_regions_.upper_bound(*address);
+  if (it != vm_regions_.begin()) {
+    --it;
+    if (*address - it->first < it->second.size) {
+      *address = it->first;
+      *size = it->second.size;
+      *depth = it->second.depth;
+      *protection = it->second.protection;
+      *user_tag = it->second.user_tag;
+      return KERN_SUCCESS;
+    }
+  }
+
+  kern_return_t kr = MachVMRegionRecurseDeepest(
+      task_, address, size, depth, protection, user_tag);
+  if (kr == KERN_SUCCESS) {
+    vm_regions_[*address] = {*size, *depth, *protection, *user_tag};
+  }
+  return kr;
+}
+
 mach_vm_address_t ProcessReaderMac::CalculateStackRegion(
     mach_vm_address_t stack_pointer,
     mach_vm_size_t* stack_region_size) {
@@ -613,8 +717,8 @@ mach_vm_address_t ProcessReaderMac::CalculateStackRegion(
   natural_t depth = 0;
   vm_prot_t protection;
   unsigned int user_tag;
-  kern_return_t kr = MachVMRegionRecurseDeepest(
-      task_, &region_base, &region_size, &depth, &protection, &user_tag);
+  kern_return_t kr = RegionRecurseDeepest(
+      &region_base, &region_size, &depth, &protection, &user_tag);
   if (kr != KERN_SUCCESS) {
     MACH_LOG(INFO, kr) << "mach_vm_region_recurse";
     *stack_region_size = 0;
@@ -688,12 +792,11 @@ mach_vm_address_t ProcessReaderMac::CalculateStackRegion(
 
     while (try_address += region_size,
            original_try_address = try_address,
-           (kr = MachVMRegionRecurseDeepest(task_,
-                                            &try_address,
-                                            &region_size,
-                                            &depth,
-                                            &protection,
-                                            &user_tag) == KERN_SUCCESS) &&
+           (kr = RegionRecurseDeepest(&try_address,
+                                      &region_size,
+                                      &depth,
+                                      &protection,
+                                      &user_tag) == KERN_SUCCESS) &&
                try_address == original_try_address &&
                (protection & VM_PROT_READ) != 0 &&
                user_tag == VM_MEMORY_STACK) {
@@ -735,12 +838,11 @@ void ProcessReaderMac::LocateRedZone(mach_vm_address_t* const start_address,
       natural_t red_zone_depth = 0;
       vm_prot_t red_zone_protection;
       unsigned int red_zone_user_tag;
-      kern_return_t kr = MachVMRegionRecurseDeepest(task_,
-                                                    &red_zone_region_base,
-                                                    &red_zone_region_size,
-                                                    &red_zone_depth,
-                                                    &red_zone_protection,
-                                                    &red_zone_user_tag);
+      kern_return_t kr = RegionRecurseDeepest(&red_zone_region_base,
+                                              &red_zone_region_size,
+                                              &red_zone_depth,
+                                              &red_zone_protection,
+                                              &red_zone_user_tag);
       if (kr != KERN_SUCCESS) {
         MACH_LOG(INFO, kr) << "mach_vm_region_recurse";
         *start_address = *region_base;
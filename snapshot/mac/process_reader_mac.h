@@ -22,12 +22,14 @@
 #include <sys/types.h>
 #include <time.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "build/build_config.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/misc/uuid.h"
 #include "util/posix/process_info.h"
 #include "util/process/process_memory_mac.h"
 
@@ -42,6 +44,7 @@
 namespace crashpad {
 
 class MachOImageReader;
+class SharedCacheImageHeaderCache;
 
 //! \brief Accesses information about another process, identified by a Mach
 //!     task.
@@ -122,11 +125,23 @@ class ProcessReaderMac {
   //!
   //! \param[in] task A send right to the target task’s task port. This object
   //!     does not take ownership of the send right.
+  //! \param[in] memory_cache_mappings If nonzero, the maximum number of
+  //!     mappings of the target task’s memory that Memory() will cache. See
+  //!     ProcessMemoryMac::Initialize(). This should only be used when the
+  //!     target task is suspended.
+  //! \param[in] shared_cache_image_headers If not `nullptr`, a cache of the
+  //!     headers of images in the dyld shared cache. Headers found in the cache
+  //!     will not be read from the target task, and headers read from the
+  //!     target task will be added to the cache. This object does not take
+  //!     ownership of the cache, which must outlive it.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
-  bool Initialize(task_t task);
+  bool Initialize(
+      task_t task,
+      size_t memory_cache_mappings = 0,
+      SharedCacheImageHeaderCache* shared_cache_image_headers = nullptr);
 
   //! \return `true` if the target task is a 64-bit process.
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT) || DOXYGEN
@@ -194,6 +209,18 @@ class ProcessReaderMac {
   //! Modules().
   void InitializeModules();
 
+  //! \brief Initializes \a reader for the image at \a address on behalf of
+  //!     InitializeModules(), using shared_cache_image_headers_ if possible.
+  //!
+  //! The image’s `mach_header` and load commands are read from the task in a
+  //! single read, and given to process_memory_ as a known range, so that \a
+  //! reader parses them locally.
+  //!
+  //! \return The result of MachOImageReader::Initialize().
+  bool InitializeModuleReader(MachOImageReader* reader,
+                              mach_vm_address_t address,
+                              const std::string& name);
+
   //! \brief Calculates the base address and size of the region used as a
   //!     thread’s stack.
   //!
@@ -249,11 +276,56 @@ class ProcessReaderMac {
                      mach_vm_address_t* region_size,
                      unsigned int user_tag);
 
+  //! \brief Looks up the deepest region of the task’s memory map at or above
+  //!     an address.
+  //!
+  //! This is `mach_vm_region_recurse()`, descending into submaps until a
+  //! non-submap region is found. Regions that have already been found are
+  //! remembered until InitializeThreads() finishes, so that the walks over
+  //! adjacent stack regions that CalculateStackRegion() and LocateRedZone()
+  //! perform for each thread don’t look up the same regions repeatedly.
+  //!
+  //! \param[in,out] address On entry, the address to look up. On return, the
+  //!     base address of the region found.
+  //! \param[out] size The size of the region found.
+  //! \param[in,out] depth The submap depth to begin the lookup at. On return,
+  //!     the depth of the region found.
+  //! \param[out] protection The region’s protection.
+  //! \param[out] user_tag The region’s user tag.
+  //!
+  //! \return The result of `mach_vm_region_recurse()`.
+  kern_return_t RegionRecurseDeepest(mach_vm_address_t* address,
+                                     mach_vm_size_t* size,
+                                     natural_t* depth,
+                                     vm_prot_t* protection,
+                                     unsigned int* user_tag);
+
+  // A region found by RegionRecurseDeepest(), keyed in vm_regions_ by its base
+  // address.
+  struct VMRegion {
+    mach_vm_size_t size;
+    natural_t depth;
+    vm_prot_t protection;
+    unsigned int user_tag;
+  };
+
   ProcessInfo process_info_;
   std::vector<Thread> threads_;  // owns send rights
   std::vector<Module> modules_;
   std::vector<std::unique_ptr<MachOImageReader>> module_readers_;
   ProcessMemoryMac process_memory_;
+  SharedCacheImageHeaderCache* shared_cache_image_headers_;  // weak
+
+  // Populated by RegionRecurseDeepest(), and cleared when InitializeThreads()
+  // finishes.
+  std::map<mach_vm_address_t, VMRegion> vm_regions_;
+
+  // The dyld shared cache’s UUID and base address, set by InitializeModules()
+  // when shared_cache_image_headers_ can be used. The base address is 0
+  // otherwise.
+  UUID shared_cache_uuid_;
+  mach_vm_address_t shared_cache_base_address_;
+
   task_t task_;  // weak
   InitializationStateDcheck initialized_;
 
@@ -38,7 +38,10 @@ ProcessSnapshotMac::ProcessSnapshotMac()
 ProcessSnapshotMac::~ProcessSnapshotMac() {
 }
 
-bool ProcessSnapshotMac::Initialize(task_t task) {
+bool ProcessSnapshotMac::Initialize(
+    task_t task,
+    size_t memory_cache_mappings,
+    SharedCacheImageHeaderCache* shared_cache_image_headers) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
@@ -46,7 +49,8 @@ bool ProcessSnapshotMac::Initialize(task_t task) {
     return false;
   }
 
-  if (!process_reader_.Initialize(task)) {
+  if (!process_reader_.Initialize(
+          task, memory_cache_mappings, shared_cache_image_headers)) {
     return false;
   }
 
@@ -56,6 +60,11 @@ bool ProcessSnapshotMac::Initialize(task_t task) {
   InitializeThreads();
   InitializeModules();
 
+  if (memory_cache_mappings > 0) {
+    VLOG(1) << "memory cache hits " << process_reader_.Memory()->CacheHits()
+            << " misses " << process_reader_.Memory()->CacheMisses();
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
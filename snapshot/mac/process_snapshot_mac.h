@@ -30,6 +30,7 @@
 #include "snapshot/mac/exception_snapshot_mac.h"
 #include "snapshot/mac/module_snapshot_mac.h"
 #include "snapshot/mac/process_reader_mac.h"
+#include "snapshot/mac/shared_cache_image_header_cache.h"
 #include "snapshot/mac/system_snapshot_mac.h"
 #include "snapshot/mac/thread_snapshot_mac.h"
 #include "snapshot/memory_map_region_snapshot.h"
@@ -58,10 +59,20 @@ class ProcessSnapshotMac final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] task The task to create a snapshot from.
+  //! \param[in] memory_cache_mappings If nonzero, the maximum number of
+  //!     mappings of the task’s memory to cache while reading it. This should
+  //!     only be used when \a task is suspended. See
+  //!     ProcessReaderMac::Initialize().
+  //! \param[in] shared_cache_image_headers If not `nullptr`, a cache of the
+  //!     headers of images in the dyld shared cache to use and add to. See
+  //!     ProcessReaderMac::Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(task_t task);
+  bool Initialize(
+      task_t task,
+      size_t memory_cache_mappings = 0,
+      SharedCacheImageHeaderCache* shared_cache_image_headers = nullptr);
 
   //! \brief Initializes the object’s exception.
   //!
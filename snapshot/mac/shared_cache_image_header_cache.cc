@@ -0,0 +1,47 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/mac/shared_cache_image_header_cache.h"
+
+namespace crashpad {
+
+SharedCacheImageHeaderCache::SharedCacheImageHeaderCache(size_t max_images)
+    : images_(), lock_(), max_images_(max_images) {}
+
+SharedCacheImageHeaderCache::~SharedCacheImageHeaderCache() {}
+
+std::shared_ptr<const std::vector<uint8_t>>
+SharedCacheImageHeaderCache::Lookup(const UUID& shared_cache_uuid,
+                                    uint64_t image_offset) const {
+  base::AutoLock lock_owner(lock_);
+  const auto iterator = images_.find(Key(shared_cache_uuid, image_offset));
+  if (iterator == images_.end()) {
+    return nullptr;
+  }
+  return iterator->second;
+}
+
+void SharedCacheImageHeaderCache::Insert(const UUID& shared_cache_uuid,
+                                         uint64_t image_offset,
+                                         std::vector<uint8_t> headers) {
+  base::AutoLock lock_owner(lock_);
+  if (images_.size() >= max_images_) {
+    return;
+  }
+  images_.emplace(
+      Key(shared_cache_uuid, image_offset),
+      std::make_shared<const std::vector<uint8_t>>(std::move(headers)));
+}
+
+}  // namespace crashpad
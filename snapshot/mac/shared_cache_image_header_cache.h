@@ -0,0 +1,89 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MAC_SHARED_CACHE_IMAGE_HEADER_CACHE_H_
+#define CRASHPAD_SNAPSHOT_MAC_SHARED_CACHE_IMAGE_HEADER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief A cache of the Mach-O headers and load commands of images in the
+//!     dyld shared cache, shared by snapshots of different processes.
+//!
+//! Every process using the same dyld shared cache, identified by its UUID,
+//! sees the same read-only headers for an image at a given offset in the
+//! shared cache. A long-lived owner, such as a handler that captures many
+//! processes, can keep one of these objects to avoid rereading the headers of
+//! hundreds of system libraries for every snapshot. See
+//! ProcessReaderMac::Initialize().
+//!
+//! This class is thread-safe.
+class SharedCacheImageHeaderCache {
+ public:
+  //! \param[in] max_images The maximum number of images whose headers will be
+  //!     cached. Once this many have been cached, Insert() has no effect.
+  explicit SharedCacheImageHeaderCache(size_t max_images);
+
+  SharedCacheImageHeaderCache(const SharedCacheImageHeaderCache&) = delete;
+  SharedCacheImageHeaderCache& operator=(const SharedCacheImageHeaderCache&) =
+      delete;
+
+  ~SharedCacheImageHeaderCache();
+
+  //! \brief Returns the cached headers of an image.
+  //!
+  //! \param[in] shared_cache_uuid The UUID of the dyld shared cache containing
+  //!     the image.
+  //! \param[in] image_offset The offset of the image’s `mach_header` from the
+  //!     base address of the shared cache.
+  //!
+  //! \return The image’s `mach_header` followed by its load commands, or
+  //!     `nullptr` if they have not been cached.
+  std::shared_ptr<const std::vector<uint8_t>> Lookup(
+      const UUID& shared_cache_uuid,
+      uint64_t image_offset) const;
+
+  //! \brief Caches the headers of an image.
+  //!
+  //! \param[in] shared_cache_uuid The UUID of the dyld shared cache containing
+  //!     the image.
+  //! \param[in] image_offset The offset of the image’s `mach_header` from the
+  //!     base address of the shared cache.
+  //! \param[in] headers The image’s `mach_header` followed by its load
+  //!     commands.
+  void Insert(const UUID& shared_cache_uuid,
+              uint64_t image_offset,
+              std::vector<uint8_t> headers);
+
+ private:
+  using Key = std::pair<UUID, uint64_t>;
+
+  std::map<Key, std::shared_ptr<const std::vector<uint8_t>>> images_;
+  mutable base::Lock lock_;
+  const size_t max_images_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MAC_SHARED_CACHE_IMAGE_HEADER_CACHE_H_
@@ -0,0 +1,58 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/mac/shared_cache_image_header_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SharedCacheImageHeaderCache, LookupAndInsert) {
+  UUID uuid_1;
+  ASSERT_TRUE(uuid_1.InitializeFromString(
+      "00112233-4455-6677-8899-aabbccddeeff"));
+  UUID uuid_2;
+  ASSERT_TRUE(uuid_2.InitializeFromString(
+      "ffeeddcc-bbaa-9988-7766-554433221100"));
+
+  SharedCacheImageHeaderCache cache(2);
+  EXPECT_FALSE(cache.Lookup(uuid_1, 0x1000));
+
+  cache.Insert(uuid_1, 0x1000, {1, 2, 3});
+  auto headers = cache.Lookup(uuid_1, 0x1000);
+  ASSERT_TRUE(headers);
+  EXPECT_EQ(*headers, std::vector<uint8_t>({1, 2, 3}));
+
+  // The same offset in a different shared cache is a different image.
+  EXPECT_FALSE(cache.Lookup(uuid_2, 0x1000));
+  EXPECT_FALSE(cache.Lookup(uuid_1, 0x2000));
+
+  // Inserting an image that’s already cached doesn’t replace it.
+  cache.Insert(uuid_1, 0x1000, {4, 5, 6});
+  headers = cache.Lookup(uuid_1, 0x1000);
+  ASSERT_TRUE(headers);
+  EXPECT_EQ(*headers, std::vector<uint8_t>({1, 2, 3}));
+
+  // Insertions beyond the maximum are ignored.
+  cache.Insert(uuid_2, 0x1000, {7});
+  cache.Insert(uuid_2, 0x2000, {8});
+  EXPECT_TRUE(cache.Lookup(uuid_2, 0x1000));
+  EXPECT_FALSE(cache.Lookup(uuid_2, 0x2000));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
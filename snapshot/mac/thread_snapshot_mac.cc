@@ -133,5 +133,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMac::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+std::vector<uint8_t> ThreadSnapshotMac::Breadcrumbs() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotMac::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<UnwoundStackFrame>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
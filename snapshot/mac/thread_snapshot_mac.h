@@ -67,6 +67,8 @@ class ThreadSnapshotMac final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  std::vector<uint8_t> Breadcrumbs() const override;
+  std::vector<UnwoundStackFrame> UnwoundFrames() const override;
 
  private:
   union {
@@ -0,0 +1,247 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/memory_read_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// Only this many buffers are kept for reuse, and buffers larger than
+// kMaxPooledBufferSize are freed when they’re returned. Reads are staged a
+// chunk at a time, so a small pool of chunk-sized buffers serves most reads.
+constexpr size_t kMaxPooledBuffers = 4;
+constexpr size_t kMaxPooledBufferSize = 1024 * 1024;
+
+}  // namespace
+
+MemoryReadCache::Buffer::Buffer(MemoryReadCache* cache, size_t size)
+    : cache_(cache),
+      buffer_(cache ? cache->TakeBuffer(size)
+                    : base::HeapArray<uint8_t>::Uninit(size)) {}
+
+MemoryReadCache::Buffer::~Buffer() {
+  if (cache_) {
+    cache_->ReturnBuffer(std::move(buffer_));
+  }
+}
+
+MemoryReadCache::MemoryReadCache(size_t max_retained_bytes)
+    : retained_(),
+      free_buffers_(),
+      retained_bytes_(0),
+      max_retained_bytes_(max_retained_bytes),
+      lock_() {}
+
+MemoryReadCache::~MemoryReadCache() {}
+
+void MemoryReadCache::Retain(VMAddress address, const void* data, size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  base::AutoLock lock_owner(lock_);
+  if (size > max_retained_bytes_ - retained_bytes_) {
+    return;
+  }
+
+  auto next = retained_.lower_bound(address);
+  if (next != retained_.end() && next->first - address < size) {
+    return;
+  }
+
+  const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+  if (next != retained_.begin()) {
+    auto previous = std::prev(next);
+    const VMAddress previous_end = previous->first + previous->second.size();
+    if (previous_end > address) {
+      return;
+    }
+    if (previous_end == address) {
+      previous->second.insert(previous->second.end(), bytes, bytes + size);
+      retained_bytes_ += size;
+      return;
+    }
+  }
+
+  retained_.emplace_hint(
+      next, address, std::vector<uint8_t>(bytes, bytes + size));
+  retained_bytes_ += size;
+}
+
+bool MemoryReadCache::Read(VMAddress address,
+                           size_t size,
+                           void* buffer) const {
+  base::AutoLock lock_owner(lock_);
+  uint8_t* out = static_cast<uint8_t*>(buffer);
+  while (size > 0) {
+    auto piece = retained_.upper_bound(address);
+    if (piece == retained_.begin()) {
+      return false;
+    }
+    --piece;
+    const size_t piece_offset = address - piece->first;
+    if (piece_offset >= piece->second.size()) {
+      return false;
+    }
+    const size_t copy_size =
+        std::min(size, piece->second.size() - piece_offset);
+    memcpy(out, piece->second.data() + piece_offset, copy_size);
+    out += copy_size;
+    address += copy_size;
+    size -= copy_size;
+  }
+  return true;
+}
+
+bool MemoryReadCache::Prefetch(
+    const ProcessMemory* memory,
+    std::vector<CheckedRange<VMAddress, size_t>> ranges) {
+  std::sort(ranges.begin(),
+            ranges.end(),
+            [](const CheckedRange<VMAddress, size_t>& lhs,
+               const CheckedRange<VMAddress, size_t>& rhs) {
+              return lhs.base() < rhs.base();
+            });
+
+  // Retain() refuses data that overlaps what it already holds, so ranges that
+  // overlap each other are merged before they're read.
+  std::vector<CheckedRange<VMAddress, size_t>> merged;
+  for (const auto& range : ranges) {
+    if (range.size() == 0 || !range.IsValid()) {
+      continue;
+    }
+    if (!merged.empty() && range.base() <= merged.back().end()) {
+      if (range.end() > merged.back().end()) {
+        merged.back().SetRange(merged.back().base(),
+                               range.end() - merged.back().base());
+      }
+      continue;
+    }
+    merged.push_back(range);
+  }
+
+  std::vector<CheckedRange<VMAddress, size_t>> to_read;
+  size_t total_size = 0;
+  {
+    base::AutoLock lock_owner(lock_);
+    const size_t available = max_retained_bytes_ - retained_bytes_;
+    for (const auto& range : merged) {
+      if (range.size() > available - total_size ||
+          OverlapsRetainedLocked(range.base(), range.size())) {
+        continue;
+      }
+      to_read.push_back(range);
+      total_size += range.size();
+    }
+  }
+  if (to_read.empty()) {
+    return true;
+  }
+
+  std::vector<uint8_t> data(total_size);
+  std::vector<ProcessMemory::ReadRequest> requests;
+  requests.reserve(to_read.size());
+  size_t offset = 0;
+  for (const auto& range : to_read) {
+    requests.push_back({range.base(), range.size(), &data[offset]});
+    offset += range.size();
+  }
+  if (!memory->ReadBatch(requests)) {
+    return false;
+  }
+
+  offset = 0;
+  for (const auto& range : to_read) {
+    Retain(range.base(), &data[offset], range.size());
+    offset += range.size();
+  }
+  return true;
+}
+
+size_t MemoryReadCache::RetainedBytes() const {
+  base::AutoLock lock_owner(lock_);
+  return retained_bytes_;
+}
+
+bool MemoryReadCache::OverlapsRetainedLocked(VMAddress address,
+                                             size_t size) const {
+  lock_.AssertAcquired();
+  auto next = retained_.lower_bound(address);
+  if (next != retained_.end() && next->first - address < size) {
+    return true;
+  }
+  if (next != retained_.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second.size() > address) {
+      return true;
+    }
+  }
+  return false;
+}
+
+base::HeapArray<uint8_t> MemoryReadCache::TakeBuffer(size_t size) {
+  {
+    base::AutoLock lock_owner(lock_);
+    auto best = free_buffers_.end();
+    for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+      if (it->size() >= size &&
+          (best == free_buffers_.end() || it->size() < best->size())) {
+        best = it;
+      }
+    }
+    if (best != free_buffers_.end()) {
+      base::HeapArray<uint8_t> buffer = std::move(*best);
+      free_buffers_.erase(best);
+      return buffer;
+    }
+  }
+  return base::HeapArray<uint8_t>::Uninit(size);
+}
+
+void MemoryReadCache::ReturnBuffer(base::HeapArray<uint8_t> buffer) {
+  if (buffer.size() > kMaxPooledBufferSize) {
+    return;
+  }
+
+  base::AutoLock lock_owner(lock_);
+  if (free_buffers_.size() < kMaxPooledBuffers) {
+    free_buffers_.push_back(std::move(buffer));
+    return;
+  }
+
+  // Keep the largest buffers, which can serve any request a smaller one can.
+  auto smallest = std::min_element(
+      free_buffers_.begin(),
+      free_buffers_.end(),
+      [](const base::HeapArray<uint8_t>& lhs,
+         const base::HeapArray<uint8_t>& rhs) {
+        return lhs.size() < rhs.size();
+      });
+  if (smallest->size() < buffer.size()) {
+    *smallest = std::move(buffer);
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
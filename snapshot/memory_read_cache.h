@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MEMORY_READ_CACHE_H_
+#define CRASHPAD_SNAPSHOT_MEMORY_READ_CACHE_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <vector>
+
+#include "base/containers/heap_array.h"
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+class ProcessMemory;
+
+namespace internal {
+
+//! \brief Staging buffers and retained data shared by the memory snapshots of
+//!     one capture.
+//!
+//! Reading a memory snapshot stages its data in a buffer before passing it to
+//! a delegate. Buffers obtained through Buffer are returned to this object
+//! when they go out of scope, and are reused by later reads rather than being
+//! allocated anew.
+//!
+//! Memory that’s read from the target process while scanning it for pointers
+//! can be passed to Retain(). When the same memory is read again, such as when
+//! a stack is written to a minidump after having been scanned, Read() provides
+//! the retained copy instead of reading it from the target process again. The
+//! total size of retained data is bounded.
+//!
+//! This is only appropriate while the target process’ memory will not change,
+//! such as while a crashed process is suspended for a snapshot.
+class MemoryReadCache {
+ public:
+  //! \brief A staging buffer borrowed from a MemoryReadCache.
+  class Buffer {
+   public:
+    //! \param[in] cache The cache to borrow a buffer from and return it to. May
+    //!     be `nullptr`, in which case a new buffer is allocated.
+    //! \param[in] size The required size of the buffer.
+    Buffer(MemoryReadCache* cache, size_t size);
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    ~Buffer();
+
+    //! \brief The buffer, of at least the size requested of the constructor.
+    uint8_t* data() { return buffer_.data(); }
+
+   private:
+    MemoryReadCache* cache_;  // weak
+    base::HeapArray<uint8_t> buffer_;
+  };
+
+  //! \param[in] max_retained_bytes The most data that Retain() will keep at
+  //!     once.
+  explicit MemoryReadCache(size_t max_retained_bytes);
+
+  MemoryReadCache(const MemoryReadCache&) = delete;
+  MemoryReadCache& operator=(const MemoryReadCache&) = delete;
+
+  ~MemoryReadCache();
+
+  //! \brief Keeps a copy of target process memory for later calls to Read().
+  //!
+  //! Data is not retained if doing so would exceed the limit given to the
+  //! constructor, or if it overlaps data that is already retained.
+  //!
+  //! \param[in] address The address of the memory in the target process.
+  //! \param[in] data The memory’s contents.
+  //! \param[in] size The size of \a data.
+  void Retain(VMAddress address, const void* data, size_t size);
+
+  //! \brief Reads several ranges of target process memory and retains them.
+  //!
+  //! The ranges are read with a single ProcessMemory::ReadBatch() call, which
+  //! may read nearby ranges together. Ranges that overlap or adjoin each other
+  //! are merged first. Ranges that overlap data that is already retained, or
+  //! that would exceed the limit given to the constructor, are not read.
+  //!
+  //! This is intended for memory that will be read later in many small pieces,
+  //! such as memory captured around pointers, so that it can be read once in
+  //! bulk instead.
+  //!
+  //! \param[in] memory A reader for the target process.
+  //! \param[in] ranges The ranges to read.
+  //!
+  //! \return `true` on success. `false` if the ranges could not be read, with
+  //!     a message logged, in which case nothing is retained.
+  bool Prefetch(const ProcessMemory* memory,
+                std::vector<CheckedRange<VMAddress, size_t>> ranges);
+
+  //! \brief Copies retained memory into \a buffer.
+  //!
+  //! \return `true` if the entire range was retained and has been copied.
+  //!     `false` otherwise, in which case the contents of \a buffer are
+  //!     unspecified and the memory must be read from the target process.
+  bool Read(VMAddress address, size_t size, void* buffer) const;
+
+  //! \brief Returns the total size of the data currently retained.
+  size_t RetainedBytes() const;
+
+ private:
+  // Whether any retained data overlaps the range. lock_ must be held.
+  bool OverlapsRetainedLocked(VMAddress address, size_t size) const;
+
+  base::HeapArray<uint8_t> TakeBuffer(size_t size);
+  void ReturnBuffer(base::HeapArray<uint8_t> buffer);
+
+  // Keyed by the address of the first byte of each piece. Pieces never
+  // overlap, and a piece that immediately follows another is appended to it.
+  std::map<VMAddress, std::vector<uint8_t>> retained_;
+  std::vector<base::HeapArray<uint8_t>> free_buffers_;
+  size_t retained_bytes_;
+  size_t max_retained_bytes_;
+  mutable base::Lock lock_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MEMORY_READ_CACHE_H_
@@ -0,0 +1,173 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/memory_read_cache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::MemoryReadCache;
+
+// Reads this process' memory and counts the reads.
+class CountingProcessMemory : public ProcessMemory {
+ public:
+  CountingProcessMemory() = default;
+
+  CountingProcessMemory(const CountingProcessMemory&) = delete;
+  CountingProcessMemory& operator=(const CountingProcessMemory&) = delete;
+
+  int reads() const { return reads_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++reads_;
+    memcpy(buffer, reinterpret_cast<const void*>(address), size);
+    return size;
+  }
+
+  mutable int reads_ = 0;
+};
+
+std::vector<uint8_t> Pattern(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t index = 0; index < size; ++index) {
+    data[index] = static_cast<uint8_t>(seed + index);
+  }
+  return data;
+}
+
+TEST(MemoryReadCache, RetainAndRead) {
+  MemoryReadCache cache(1024);
+  const std::vector<uint8_t> data = Pattern(256, 1);
+
+  std::vector<uint8_t> out(256);
+  EXPECT_FALSE(cache.Read(0x1000, out.size(), out.data()));
+
+  // Two abutting pieces are read back as one.
+  cache.Retain(0x1000, data.data(), 128);
+  cache.Retain(0x1080, data.data() + 128, 128);
+  EXPECT_EQ(cache.RetainedBytes(), 256u);
+  ASSERT_TRUE(cache.Read(0x1000, out.size(), out.data()));
+  EXPECT_EQ(out, data);
+
+  std::vector<uint8_t> middle(16);
+  ASSERT_TRUE(cache.Read(0x1078, middle.size(), middle.data()));
+  EXPECT_EQ(middle,
+            std::vector<uint8_t>(data.begin() + 0x78, data.begin() + 0x88));
+
+  // Ranges that aren't entirely retained must be read from elsewhere.
+  EXPECT_FALSE(cache.Read(0xff0, 32, out.data()));
+  EXPECT_FALSE(cache.Read(0x10f0, 32, out.data()));
+}
+
+TEST(MemoryReadCache, Gap) {
+  MemoryReadCache cache(1024);
+  const std::vector<uint8_t> data = Pattern(64, 2);
+  cache.Retain(0x1000, data.data(), 32);
+  cache.Retain(0x1040, data.data() + 32, 32);
+
+  std::vector<uint8_t> out(0x60);
+  EXPECT_FALSE(cache.Read(0x1000, out.size(), out.data()));
+  EXPECT_TRUE(cache.Read(0x1040, 32, out.data()));
+}
+
+TEST(MemoryReadCache, OverlapAndLimit) {
+  MemoryReadCache cache(100);
+  const std::vector<uint8_t> data = Pattern(128, 3);
+
+  // Too large to retain at all.
+  cache.Retain(0x1000, data.data(), data.size());
+  EXPECT_EQ(cache.RetainedBytes(), 0u);
+
+  cache.Retain(0x1000, data.data(), 64);
+  EXPECT_EQ(cache.RetainedBytes(), 64u);
+
+  // Overlapping data isn't retained, from either side.
+  cache.Retain(0xfe0, data.data(), 64);
+  cache.Retain(0x1020, data.data(), 64);
+  EXPECT_EQ(cache.RetainedBytes(), 64u);
+
+  // Whatever fits within the limit is still retained.
+  cache.Retain(0x2000, data.data(), 36);
+  EXPECT_EQ(cache.RetainedBytes(), 100u);
+  cache.Retain(0x3000, data.data(), 1);
+  EXPECT_EQ(cache.RetainedBytes(), 100u);
+}
+
+TEST(MemoryReadCache, Prefetch) {
+  const std::vector<uint8_t> data = Pattern(256, 4);
+  const VMAddress address = FromPointerCast<VMAddress>(data.data());
+  CountingProcessMemory memory;
+  MemoryReadCache cache(160);
+  cache.Retain(address + 192, data.data() + 192, 16);
+
+  // Overlapping and adjoining ranges are merged and read at once. The range
+  // overlapping retained data is skipped, and the last doesn't fit.
+  ASSERT_TRUE(cache.Prefetch(&memory,
+                             {{address + 32, 64},
+                              {address, 48},
+                              {address + 96, 32},
+                              {address + 184, 16},
+                              {address + 208, 48}}));
+  EXPECT_EQ(memory.reads(), 1);
+  EXPECT_EQ(cache.RetainedBytes(), 144u);
+
+  std::vector<uint8_t> out(128);
+  EXPECT_TRUE(cache.Read(address, out.size(), out.data()));
+  EXPECT_EQ(memcmp(out.data(), data.data(), out.size()), 0);
+  EXPECT_FALSE(cache.Read(address + 184, 16, out.data()));
+  EXPECT_FALSE(cache.Read(address + 208, 48, out.data()));
+
+  // Nothing is read again once it's retained.
+  ASSERT_TRUE(cache.Prefetch(&memory, {{address + 16, 16}}));
+  EXPECT_EQ(memory.reads(), 1);
+}
+
+TEST(MemoryReadCache, BufferReuse) {
+  MemoryReadCache cache(0);
+  uint8_t* first;
+  {
+    MemoryReadCache::Buffer buffer(&cache, 4096);
+    first = buffer.data();
+  }
+  {
+    // A smaller request may be served by the returned buffer.
+    MemoryReadCache::Buffer buffer(&cache, 1024);
+    EXPECT_EQ(buffer.data(), first);
+
+    // While it's in use, another buffer is needed.
+    MemoryReadCache::Buffer other(&cache, 1024);
+    EXPECT_NE(other.data(), first);
+  }
+
+  // Without a cache, buffers are simply allocated.
+  MemoryReadCache::Buffer buffer(nullptr, 16);
+  EXPECT_TRUE(buffer.data());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,6 +14,8 @@
 
 #include "snapshot/memory_snapshot.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/format_macros.h"
@@ -81,6 +83,34 @@ bool DetermineMergedRangeImpl(bool log,
 
 }  // namespace
 
+bool MemorySnapshot::ReadChunked(Delegate* delegate,
+                                 size_t max_chunk_size) const {
+  return Read(delegate);
+}
+
+bool MemorySnapshot::ReadInto(void* buffer) const {
+  class CopyingDelegate : public Delegate {
+   public:
+    explicit CopyingDelegate(void* buffer) : buffer_(buffer) {}
+    ~CopyingDelegate() override {}
+
+    bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+      memcpy(buffer_, data, size);
+      return true;
+    }
+
+   private:
+    void* buffer_;
+  };
+
+  if (Size() == 0) {
+    return true;
+  }
+
+  CopyingDelegate delegate(buffer);
+  return Read(&delegate);
+}
+
 bool LoggingDetermineMergedRange(const MemorySnapshot* a,
                                  const MemorySnapshot* b,
                                  CheckedRange<uint64_t, size_t>* merged) {
@@ -75,6 +75,37 @@ class MemorySnapshot {
   //!     success and `false` on failure.
   virtual bool Read(Delegate* delegate) const = 0;
 
+  //! \brief Calls Delegate::MemorySnapshotDelegateRead() one or more times,
+  //!     providing it with consecutive pieces of the memory snapshot’s data.
+  //!
+  //! This allows large memory snapshots to be consumed without holding all of
+  //! their data at once. The pieces are provided in order, and together cover
+  //! the entire memory snapshot. Each piece is no larger than \a
+  //! max_chunk_size, unless the implementation doesn’t support reading in
+  //! pieces, in which case the entire memory snapshot is provided in a single
+  //! call, as Read() does. The default implementation calls Read().
+  //!
+  //! \param[in] delegate The delegate to provide data to.
+  //! \param[in] max_chunk_size The preferred maximum size of each piece. Must
+  //!     be nonzero.
+  //!
+  //! \return `false` on failure, otherwise, `true` if every call to
+  //!     Delegate::MemorySnapshotDelegateRead() returned `true`. On failure,
+  //!     the delegate may already have been provided with a part of the data.
+  virtual bool ReadChunked(Delegate* delegate, size_t max_chunk_size) const;
+
+  //! \brief Copies the memory snapshot’s data into a caller-provided buffer.
+  //!
+  //! Implementations able to read directly into \a buffer do so without
+  //! staging the data elsewhere. The default implementation calls Read() and
+  //! copies the data it provides.
+  //!
+  //! \param[out] buffer A buffer of at least Size() bytes. Its contents are
+  //!     unspecified on failure.
+  //!
+  //! \return `true` on success, `false` on failure.
+  virtual bool ReadInto(void* buffer) const;
+
   //! \brief Creates a new MemorySnapshot based on merging this one with \a
   //!     other.
   //!
@@ -18,13 +18,17 @@
 #include <stdint.h>
 #include <sys/types.h>
 
-#include "base/containers/heap_array.h"
+#include <algorithm>
+
+#include "base/check_op.h"
 #include "base/logging.h"
 #include "base/numerics/safe_math.h"
+#include "snapshot/memory_read_cache.h"
 #include "snapshot/memory_snapshot.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
+#include "util/process/process_memory_accounting.h"
 
 namespace crashpad {
 namespace internal {
@@ -61,6 +65,30 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
     INITIALIZATION_STATE_SET_VALID(initialized_);
   }
 
+  //! \brief Reduces the size of the memory region, keeping its base address.
+  //!
+  //! \param[in] size The new size, which must not be larger than the current
+  //!     size.
+  void Shrink(VMSize size) {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    DCHECK_LE(size, size_);
+    size_ = std::min(size_, base::checked_cast<size_t>(size));
+  }
+
+  //! \brief Sets the category that reads of this memory are attributed to by
+  //!     ProcessMemoryAccounting. The default is
+  //!     ProcessMemoryAccounting::ReadCategory::kOther.
+  void set_read_category(ProcessMemoryAccounting::ReadCategory read_category) {
+    read_category_ = read_category;
+  }
+
+  //! \brief Sets a cache to stage reads of this memory in, and to consult for
+  //!     a retained copy of it before reading from the target process.
+  //!
+  //! \param[in] read_cache The cache to use, or `nullptr` to allocate a buffer
+  //!     for each read and always read from the target process.
+  void set_read_cache(MemoryReadCache* read_cache) { read_cache_ = read_cache; }
+
   // MemorySnapshot:
 
   uint64_t Address() const override {
@@ -80,11 +108,35 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
       return delegate->MemorySnapshotDelegateRead(nullptr, size_);
     }
 
-    auto buffer = base::HeapArray<uint8_t>::Uninit(size_);
-    if (!process_memory_->Read(address_, buffer.size(), buffer.data())) {
+    MemoryReadCache::Buffer buffer(read_cache_, size_);
+    if (!ReadRange(address_, size_, buffer.data())) {
       return false;
     }
-    return delegate->MemorySnapshotDelegateRead(buffer.data(), buffer.size());
+    return delegate->MemorySnapshotDelegateRead(buffer.data(), size_);
+  }
+
+  bool ReadChunked(Delegate* delegate, size_t max_chunk_size) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    DCHECK_GT(max_chunk_size, 0u);
+
+    if (size_ <= max_chunk_size) {
+      return Read(delegate);
+    }
+
+    MemoryReadCache::Buffer buffer(read_cache_, max_chunk_size);
+    for (size_t offset = 0; offset < size_; offset += max_chunk_size) {
+      const size_t chunk_size = std::min(size_ - offset, max_chunk_size);
+      if (!ReadRange(address_ + offset, chunk_size, buffer.data()) ||
+          !delegate->MemorySnapshotDelegateRead(buffer.data(), chunk_size)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ReadInto(void* buffer) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    return size_ == 0 || ReadRange(address_, size_, buffer);
   }
 
   const MemorySnapshot* MergeWithOtherSnapshot(
@@ -101,6 +153,8 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
 
     auto result = std::make_unique<MemorySnapshotGeneric>();
     result->Initialize(process_memory_, merged.base(), merged.size());
+    result->set_read_category(read_category_);
+    result->set_read_cache(read_cache_);
     return result.release();
   }
 
@@ -110,9 +164,20 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
       const T* self,
       const MemorySnapshot* other);
 
+  bool ReadRange(VMAddress address, size_t size, void* buffer) const {
+    if (read_cache_ && read_cache_->Read(address, size, buffer)) {
+      return true;
+    }
+    ProcessMemoryAccounting::ScopedCategory read_category(read_category_);
+    return process_memory_->Read(address, size, buffer);
+  }
+
   const ProcessMemory* process_memory_;  // weak
   VMAddress address_;
   size_t size_;
+  ProcessMemoryAccounting::ReadCategory read_category_ =
+      ProcessMemoryAccounting::ReadCategory::kOther;
+  MemoryReadCache* read_cache_ = nullptr;  // weak
   InitializationStateDcheck initialized_;
 };
 
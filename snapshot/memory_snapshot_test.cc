@@ -14,13 +14,112 @@
 
 #include "snapshot/memory_snapshot.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/test/test_memory_snapshot.h"
+#include "util/misc/from_pointer_cast.h"
 
 namespace crashpad {
 namespace test {
 namespace {
 
+// Reads memory from the current process, failing at and beyond |limit|.
+class LocalProcessMemory : public ProcessMemory {
+ public:
+  explicit LocalProcessMemory(VMAddress limit) : limit_(limit) {}
+
+  LocalProcessMemory(const LocalProcessMemory&) = delete;
+  LocalProcessMemory& operator=(const LocalProcessMemory&) = delete;
+
+  ~LocalProcessMemory() override = default;
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    if (address >= limit_) {
+      return -1;
+    }
+    size = std::min(size, static_cast<size_t>(limit_ - address));
+    memcpy(buffer, reinterpret_cast<const void*>(address), size);
+    return size;
+  }
+
+  VMAddress limit_;
+};
+
+class CollectingDelegate : public MemorySnapshot::Delegate {
+ public:
+  CollectingDelegate() = default;
+
+  CollectingDelegate(const CollectingDelegate&) = delete;
+  CollectingDelegate& operator=(const CollectingDelegate&) = delete;
+
+  ~CollectingDelegate() override = default;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const char* data_c = static_cast<const char*>(data);
+    contents.insert(contents.end(), data_c, data_c + size);
+    chunk_sizes.push_back(size);
+    return true;
+  }
+
+  std::vector<char> contents;
+  std::vector<size_t> chunk_sizes;
+};
+
+TEST(MemorySnapshotGeneric, ReadChunked) {
+  std::vector<char> buffer(10000);
+  for (size_t index = 0; index < buffer.size(); ++index) {
+    buffer[index] = static_cast<char>(index % 251);
+  }
+  const VMAddress address = FromPointerCast<VMAddress>(buffer.data());
+
+  LocalProcessMemory memory(address + buffer.size());
+  internal::MemorySnapshotGeneric snapshot;
+  snapshot.Initialize(&memory, address, buffer.size());
+
+  {
+    CollectingDelegate delegate;
+    ASSERT_TRUE(snapshot.Read(&delegate));
+    EXPECT_EQ(delegate.chunk_sizes, std::vector<size_t>({10000}));
+    EXPECT_EQ(delegate.contents, buffer);
+  }
+
+  {
+    CollectingDelegate delegate;
+    ASSERT_TRUE(snapshot.ReadChunked(&delegate, 4096));
+    EXPECT_EQ(delegate.chunk_sizes,
+              std::vector<size_t>({4096, 4096, 10000 - 2 * 4096}));
+    EXPECT_EQ(delegate.contents, buffer);
+  }
+
+  {
+    CollectingDelegate delegate;
+    ASSERT_TRUE(snapshot.ReadChunked(&delegate, buffer.size()));
+    EXPECT_EQ(delegate.chunk_sizes, std::vector<size_t>({10000}));
+    EXPECT_EQ(delegate.contents, buffer);
+  }
+
+  {
+    // The data before the unreadable part of the region is still provided.
+    LocalProcessMemory short_memory(address + 5000);
+    internal::MemorySnapshotGeneric short_snapshot;
+    short_snapshot.Initialize(&short_memory, address, buffer.size());
+
+    CollectingDelegate delegate;
+    EXPECT_FALSE(short_snapshot.ReadChunked(&delegate, 4096));
+    EXPECT_EQ(delegate.chunk_sizes, std::vector<size_t>({4096}));
+    EXPECT_EQ(delegate.contents,
+              std::vector<char>(buffer.begin(), buffer.begin() + 4096));
+  }
+}
+
 TEST(DetermineMergedRange, NonOverlapping) {
   TestMemorySnapshot a;
   TestMemorySnapshot b;
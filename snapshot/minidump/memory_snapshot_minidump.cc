@@ -14,8 +14,12 @@
 
 #include "snapshot/minidump/memory_snapshot_minidump.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <memory>
 
+#include "base/logging.h"
 #include "base/numerics/safe_math.h"
 
 namespace crashpad {
@@ -25,14 +29,19 @@ MemorySnapshotMinidump::MemorySnapshotMinidump()
     : MemorySnapshot(),
       address_(0),
       data_(),
+      view_(nullptr),
+      view_size_(0),
+      file_reader_(nullptr),
+      file_offset_(0),
+      zero_filled_(false),
       initialized_() {}
 
 MemorySnapshotMinidump::~MemorySnapshotMinidump() {}
 
-bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
-                                        RVA location) {
-  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
-
+bool MemorySnapshotMinidump::Initialize(
+    FileReaderInterface* file_reader,
+    RVA location,
+    const MemoryFileReader* memory_reader) {
   MINIDUMP_MEMORY_DESCRIPTOR descriptor;
 
   if (!file_reader->SeekSet(location)) {
@@ -43,6 +52,16 @@ bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
     return false;
   }
 
+  if (memory_reader) {
+    return InitializeWithContents(file_reader,
+                                  descriptor.StartOfMemoryRange,
+                                  descriptor.Memory.Rva,
+                                  descriptor.Memory.DataSize,
+                                  memory_reader);
+  }
+
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
   address_ = descriptor.StartOfMemoryRange;
   data_.resize(descriptor.Memory.DataSize);
 
@@ -58,6 +77,58 @@ bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
   return true;
 }
 
+bool MemorySnapshotMinidump::InitializeWithContents(
+    FileReaderInterface* file_reader,
+    uint64_t address,
+    FileOffset offset,
+    uint64_t size,
+    const MemoryFileReader* memory_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!base::IsValueInRangeForNumericType<size_t>(size)) {
+    LOG(ERROR) << "memory range too large";
+    return false;
+  }
+  const size_t data_size = static_cast<size_t>(size);
+
+  address_ = address;
+
+  if (memory_reader) {
+    view_ = memory_reader->View(offset, data_size);
+    if (!view_) {
+      return false;
+    }
+    view_size_ = data_size;
+
+    INITIALIZATION_STATE_SET_VALID(initialized_);
+    return true;
+  }
+
+  file_reader_ = file_reader;
+  file_offset_ = offset;
+  view_size_ = data_size;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool MemorySnapshotMinidump::InitializeZeroFilled(uint64_t address,
+                                                  uint64_t size) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!base::IsValueInRangeForNumericType<size_t>(size)) {
+    LOG(ERROR) << "memory range too large";
+    return false;
+  }
+
+  address_ = address;
+  view_size_ = static_cast<size_t>(size);
+  zero_filled_ = true;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
 uint64_t MemorySnapshotMinidump::Address() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return address_;
@@ -65,13 +136,69 @@ uint64_t MemorySnapshotMinidump::Address() const {
 
 size_t MemorySnapshotMinidump::Size() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return data_.size();
+  return view_ || file_reader_ || zero_filled_ ? view_size_ : data_.size();
 }
 
 bool MemorySnapshotMinidump::Read(Delegate* delegate) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return delegate->MemorySnapshotDelegateRead(
-      const_cast<uint8_t*>(data_.data()), data_.size());
+  if (zero_filled_) {
+    std::vector<uint8_t> zeroes(view_size_);
+    return delegate->MemorySnapshotDelegateRead(zeroes.data(), zeroes.size());
+  }
+  if (file_reader_) {
+    std::vector<uint8_t> contents(view_size_);
+    return ReadFromFile(0, contents.data(), contents.size()) &&
+           delegate->MemorySnapshotDelegateRead(contents.data(),
+                                                contents.size());
+  }
+  return delegate->MemorySnapshotDelegateRead(const_cast<uint8_t*>(Data()),
+                                              Size());
+}
+
+bool MemorySnapshotMinidump::ReadChunked(Delegate* delegate,
+                                         size_t max_chunk_size) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (file_reader_) {
+    std::vector<uint8_t> chunk(std::min(view_size_, max_chunk_size));
+    for (size_t offset = 0; offset < view_size_; offset += chunk.size()) {
+      const size_t chunk_size = std::min(view_size_ - offset, chunk.size());
+      if (!ReadFromFile(offset, chunk.data(), chunk_size) ||
+          !delegate->MemorySnapshotDelegateRead(chunk.data(), chunk_size)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  if (!zero_filled_) {
+    // The contents are already in memory, so there’s nothing to save by
+    // providing them in pieces.
+    return Read(delegate);
+  }
+
+  // A single buffer serves every piece. It’s cleared again before each one in
+  // case the delegate wrote to it.
+  std::vector<uint8_t> zeroes(std::min(view_size_, max_chunk_size));
+  for (size_t offset = 0; offset < view_size_; offset += zeroes.size()) {
+    const size_t chunk_size = std::min(view_size_ - offset, zeroes.size());
+    memset(zeroes.data(), 0, chunk_size);
+    if (!delegate->MemorySnapshotDelegateRead(zeroes.data(), chunk_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MemorySnapshotMinidump::ReadInto(void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (zero_filled_) {
+    memset(buffer, 0, view_size_);
+  } else if (file_reader_) {
+    return ReadFromFile(0, buffer, view_size_);
+  } else if (Size() != 0) {
+    memcpy(buffer, Data(), Size());
+  }
+  return true;
 }
 
 const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
@@ -92,9 +219,13 @@ const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
     return nullptr;
   }
 
+  // The result always owns its contents, even when this snapshot or other is
+  // zero-filled or references a mapped minidump.
   auto result = std::make_unique<MemorySnapshotMinidump>();
   result->address_ = merged.base();
-  result->data_ = data_;
+  if (!AppendContents(&result->data_)) {
+    return nullptr;
+  }
 
   if (result->data_.size() == merged.size()) {
     return result.release();
@@ -102,10 +233,42 @@ const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
 
   result->data_.resize(
       base::checked_cast<size_t>(other_cast->address_ - address_));
-  result->data_.insert(result->data_.end(), other_cast->data_.begin(),
-                       other_cast->data_.end());
+  if (!other_cast->AppendContents(&result->data_)) {
+    return nullptr;
+  }
   return result.release();
 }
 
+const uint8_t* MemorySnapshotMinidump::Data() const {
+  return view_ ? view_ : data_.data();
+}
+
+bool MemorySnapshotMinidump::ReadFromFile(size_t offset,
+                                         void* buffer,
+                                         size_t size) const {
+  base::CheckedNumeric<FileOffset> position = file_offset_;
+  position += offset;
+  if (!position.IsValid()) {
+    LOG(ERROR) << "memory range out of bounds";
+    return false;
+  }
+  return size == 0 ||
+         (file_reader_->SeekSet(position.ValueOrDie()) &&
+          file_reader_->ReadExactly(buffer, size));
+}
+
+bool MemorySnapshotMinidump::AppendContents(std::vector<uint8_t>* data) const {
+  if (zero_filled_) {
+    data->resize(data->size() + view_size_);
+  } else if (file_reader_) {
+    const size_t start = data->size();
+    data->resize(start + view_size_);
+    return ReadFromFile(0, data->data() + start, view_size_);
+  } else {
+    data->insert(data->end(), Data(), Data() + Size());
+  }
+  return true;
+}
+
 } // namespace internal
 } // namespace crashpad
@@ -18,10 +18,13 @@
 #include <windows.h>
 #include <dbghelp.h>
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "snapshot/memory_snapshot.h"
 #include "util/file/file_reader.h"
+#include "util/file/memory_file_reader.h"
 #include "util/misc/initialization_state_dcheck.h"
 
 namespace crashpad {
@@ -41,20 +44,88 @@ class MemorySnapshotMinidump : public MemorySnapshot {
   //!     The file reader must support seeking.
   //! \param[in] location The location within the file where we will find a
   //!     MINIDUMP_MEMORY_DESCRIPTOR from which to initialize this object.
+  //! \param[in] memory_reader If not `nullptr`, the in-memory view of the same
+  //!     minidump file that \a file_reader reads. The memory contents are then
+  //!     referenced in place rather than copied, and \a memory_reader’s buffer
+  //!     must outlive this object.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool Initialize(FileReaderInterface* file_reader,
+                  RVA location,
+                  const MemoryFileReader* memory_reader = nullptr);
+
+  //! \brief Initializes the object from contents at a known location, such
+  //!     as a range of a MINIDUMP_MEMORY64_LIST.
+  //!
+  //! Unless \a memory_reader is provided, the contents aren’t copied. They’re
+  //! read from \a file_reader each time the snapshot is read, so that a large
+  //! range doesn’t have to be held in memory. The caller must ensure that the
+  //! range lies within the file.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file.
+  //!     The file reader must support seeking, and must outlive this object.
+  //! \param[in] address The address of the memory in the snapshotted process.
+  //! \param[in] offset The offset of the contents within the file, which may
+  //!     lie beyond the range of an ::RVA.
+  //! \param[in] size The size of the contents.
+  //! \param[in] memory_reader As in Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(FileReaderInterface* file_reader, RVA location);
+  bool InitializeWithContents(FileReaderInterface* file_reader,
+                              uint64_t address,
+                              FileOffset offset,
+                              uint64_t size,
+                              const MemoryFileReader* memory_reader = nullptr);
+
+  //! \brief Initializes the object as zero-filled memory with no contents in
+  //!     the file, such as a range listed in a
+  //!     ::kMinidumpStreamTypeCrashpadZeroMemory stream.
+  //!
+  //! No buffer of \a size bytes is held by the object. One is produced only
+  //! when the contents are read, and ReadChunked() and ReadInto() avoid even
+  //! that.
+  //!
+  //! \param[in] address The address of the memory in the snapshotted process.
+  //! \param[in] size The size of the memory.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeZeroFilled(uint64_t address, uint64_t size);
 
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool ReadChunked(Delegate* delegate, size_t max_chunk_size) const override;
+  bool ReadInto(void* buffer) const override;
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override;
 
  private:
+  const uint8_t* Data() const;
+
+  // Reads size bytes of the contents from file_reader_, starting offset bytes
+  // into them.
+  bool ReadFromFile(size_t offset, void* buffer, size_t size) const;
+
+  // Appends the contents of the snapshot to data.
+  bool AppendContents(std::vector<uint8_t>* data) const;
+
   uint64_t address_;
   std::vector<uint8_t> data_;
+
+  // When the snapshot references a mapped minidump rather than owning a copy
+  // of its contents, these describe the referenced range and data_ is empty.
+  // When the contents are read from the file on demand, file_reader_ and
+  // file_offset_ locate them instead. Zero-filled snapshots have no contents
+  // at all. In each of these cases, view_size_ gives the size.
+  const uint8_t* view_;  // weak
+  size_t view_size_;
+  FileReaderInterface* file_reader_;  // weak
+  FileOffset file_offset_;
+  bool zero_filled_;
+
   InitializationStateDcheck initialized_;
 };
 
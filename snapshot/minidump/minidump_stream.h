@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 
+#include <utility>
 #include <vector>
 
 
@@ -26,7 +27,7 @@ namespace crashpad {
 class MinidumpStream {
  public:
   MinidumpStream(uint32_t stream_type, std::vector<uint8_t> data)
-      : stream_type_(stream_type), data_(data) {}
+      : stream_type_(stream_type), data_(std::move(data)) {}
 
   MinidumpStream(const MinidumpStream&) = delete;
   MinidumpStream& operator=(const MinidumpStream&) = delete;
@@ -85,6 +85,22 @@ class ModuleSnapshotMinidump final : public ModuleSnapshot {
   std::set<CheckedRange<uint64_t>> ExtraMemoryRanges() const override;
   std::vector<const UserMinidumpStream*> CustomMinidumpStreams() const override;
 
+  //! \brief Returns the same list as AnnotationsVector(), without copying it.
+  const std::vector<std::string>& annotations_vector() const {
+    return annotations_vector_;
+  }
+
+  //! \brief Returns the same map as AnnotationsSimpleMap(), without copying
+  //!     it.
+  const std::map<std::string, std::string>& annotations_simple_map() const {
+    return annotations_simple_map_;
+  }
+
+  //! \brief Returns the same list as AnnotationObjects(), without copying it.
+  const std::vector<AnnotationSnapshot>& annotation_objects() const {
+    return annotation_objects_;
+  }
+
  private:
   // Initializes data carried in a MinidumpModuleCrashpadInfo structure on
   // behalf of Initialize().
@@ -14,10 +14,12 @@
 
 #include "snapshot/minidump/process_snapshot_minidump.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/logging.h"
 #include "base/notreached.h"
+#include "base/numerics/safe_math.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "minidump/minidump_extensions.h"
@@ -51,17 +53,34 @@ ProcessSnapshotMinidump::ProcessSnapshotMinidump()
       stream_directory_(),
       stream_map_(),
       modules_(),
+      modules_exposed_(),
       threads_(),
+      threads_exposed_(),
       unloaded_modules_(),
       mem_regions_(),
       mem_regions_exposed_(),
+      extra_memory_(),
+      extra_memory_exposed_(),
+      full_memory_(),
+      full_memory_exposed_(),
       custom_streams_(),
+      custom_streams_exposed_(),
+      module_identities_(),
       crashpad_info_(),
       system_snapshot_(),
       exception_snapshot_(),
       arch_(CPUArchitecture::kCPUArchitectureUnknown),
       annotations_simple_map_(),
       file_reader_(nullptr),
+      memory_reader_(),
+      modules_initialized_(false),
+      threads_initialized_(false),
+      memory_info_initialized_(false),
+      extra_memory_initialized_(false),
+      full_memory_initialized_(false),
+      custom_streams_initialized_(false),
+      module_identities_initialized_(false),
+      exception_initialized_(false),
       process_id_(kInvalidProcessID),
       create_time_(0),
       user_time_(0),
@@ -116,11 +135,9 @@ bool ProcessSnapshotMinidump::Initialize(FileReaderInterface* file_reader) {
     stream_map_[stream_type] = &directory.Location;
   }
 
+  // The remaining streams are read on demand by InitializeLazily().
   if (!InitializeCrashpadInfo() || !InitializeMiscInfo() ||
-      !InitializeModules() || !InitializeSystemSnapshot() ||
-      !InitializeMemoryInfo() || !InitializeExtraMemory() ||
-      !InitializeThreads() || !InitializeCustomMinidumpStreams() ||
-      !InitializeExceptionSnapshot()) {
+      !InitializeSystemSnapshot()) {
     return false;
   }
 
@@ -128,6 +145,12 @@ bool ProcessSnapshotMinidump::Initialize(FileReaderInterface* file_reader) {
   return true;
 }
 
+bool ProcessSnapshotMinidump::InitializeFromMemory(const void* data,
+                                                   size_t size) {
+  memory_reader_ = std::make_unique<MemoryFileReader>(data, size);
+  return Initialize(memory_reader_.get());
+}
+
 crashpad::ProcessID ProcessSnapshotMinidump::ProcessID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return process_id_;
@@ -187,21 +210,14 @@ const SystemSnapshot* ProcessSnapshotMinidump::System() const {
 }
 
 std::vector<const ThreadSnapshot*> ProcessSnapshotMinidump::Threads() const {
-  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  std::vector<const ThreadSnapshot*> threads;
-  for (const auto& thread : threads_) {
-    threads.push_back(thread.get());
-  }
-  return threads;
+  base::span<const ThreadSnapshot* const> threads = ThreadsView();
+  return std::vector<const ThreadSnapshot*>(threads.begin(), threads.end());
 }
 
 std::vector<const ModuleSnapshot*> ProcessSnapshotMinidump::Modules() const {
-  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  std::vector<const ModuleSnapshot*> modules;
-  for (const auto& module : modules_) {
-    modules.push_back(module.get());
-  }
-  return modules;
+  base::span<const internal::ModuleSnapshotMinidump* const> modules =
+      ModulesView();
+  return std::vector<const ModuleSnapshot*>(modules.begin(), modules.end());
 }
 
 std::vector<UnloadedModuleSnapshot> ProcessSnapshotMinidump::UnloadedModules()
@@ -212,6 +228,9 @@ std::vector<UnloadedModuleSnapshot> ProcessSnapshotMinidump::UnloadedModules()
 
 const ExceptionSnapshot* ProcessSnapshotMinidump::Exception() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&exception_initialized_,
+                   &ProcessSnapshotMinidump::InitializeExceptionSnapshot,
+                   "exception");
   if (exception_snapshot_.IsValid()) {
     return &exception_snapshot_;
   }
@@ -221,8 +240,9 @@ const ExceptionSnapshot* ProcessSnapshotMinidump::Exception() const {
 
 std::vector<const MemoryMapRegionSnapshot*> ProcessSnapshotMinidump::MemoryMap()
     const {
-  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return mem_regions_exposed_;
+  base::span<const MemoryMapRegionSnapshot* const> regions = MemoryMapView();
+  return std::vector<const MemoryMapRegionSnapshot*>(regions.begin(),
+                                                     regions.end());
 }
 
 std::vector<HandleSnapshot> ProcessSnapshotMinidump::Handles() const {
@@ -232,12 +252,17 @@ std::vector<HandleSnapshot> ProcessSnapshotMinidump::Handles() const {
 
 std::vector<const MemorySnapshot*> ProcessSnapshotMinidump::ExtraMemory()
     const {
+  base::span<const MemorySnapshot* const> chunks = ExtraMemoryView();
+  return std::vector<const MemorySnapshot*>(chunks.begin(), chunks.end());
+}
+
+const std::vector<const MemorySnapshot*>&
+ProcessSnapshotMinidump::FullMemory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  std::vector<const MemorySnapshot*> chunks;
-  for (const auto& chunk : extra_memory_) {
-    chunks.push_back(chunk.get());
-  }
-  return chunks;
+  InitializeLazily(&full_memory_initialized_,
+                   &ProcessSnapshotMinidump::InitializeFullMemory,
+                   "memory64_list");
+  return full_memory_exposed_;
 }
 
 const ProcessMemory* ProcessSnapshotMinidump::Memory() const {
@@ -245,16 +270,75 @@ const ProcessMemory* ProcessSnapshotMinidump::Memory() const {
   return nullptr;
 }
 
-std::vector<const MinidumpStream*>
+const std::vector<const MinidumpStream*>&
 ProcessSnapshotMinidump::CustomMinidumpStreams() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&custom_streams_initialized_,
+                   &ProcessSnapshotMinidump::InitializeCustomMinidumpStreams,
+                   "custom streams");
+  return custom_streams_exposed_;
+}
+
+const std::vector<ProcessSnapshotMinidump::ModuleIdentity>&
+ProcessSnapshotMinidump::ModuleIdentities() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&module_identities_initialized_,
+                   &ProcessSnapshotMinidump::InitializeModuleIdentities,
+                   "module_identities");
+  return module_identities_;
+}
+
+base::span<const ThreadSnapshot* const> ProcessSnapshotMinidump::ThreadsView()
+    const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&threads_initialized_,
+                   &ProcessSnapshotMinidump::InitializeThreads,
+                   "thread_list");
+  return threads_exposed_;
+}
+
+base::span<const internal::ModuleSnapshotMinidump* const>
+ProcessSnapshotMinidump::ModulesView() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&modules_initialized_,
+                   &ProcessSnapshotMinidump::InitializeModules,
+                   "module_list");
+  return modules_exposed_;
+}
+
+base::span<const MemoryMapRegionSnapshot* const>
+ProcessSnapshotMinidump::MemoryMapView() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&memory_info_initialized_,
+                   &ProcessSnapshotMinidump::InitializeMemoryInfo,
+                   "memory_info_list");
+  return mem_regions_exposed_;
+}
+
+base::span<const MemorySnapshot* const>
+ProcessSnapshotMinidump::ExtraMemoryView() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeLazily(&extra_memory_initialized_,
+                   &ProcessSnapshotMinidump::InitializeExtraMemory,
+                   "memory_list");
+  return extra_memory_exposed_;
+}
 
-  std::vector<const MinidumpStream*> result;
-  result.reserve(custom_streams_.size());
-  for (const auto& custom_stream : custom_streams_) {
-    result.push_back(custom_stream.get());
+void ProcessSnapshotMinidump::InitializeLazily(
+    bool* initialized,
+    bool (ProcessSnapshotMinidump::*initialize)(),
+    const char* stream_name) const {
+  if (*initialized) {
+    return;
+  }
+  *initialized = true;
+
+  // TODO(mark): The const accessors that call this should not be const. See
+  // AnnotationsSimpleMap(). https://crashpad.chromium.org/bug/9
+  ProcessSnapshotMinidump* self = const_cast<ProcessSnapshotMinidump*>(this);
+  if (!(self->*initialize)()) {
+    LOG(ERROR) << "failed to read " << stream_name;
   }
-  return result;
 }
 
 bool ProcessSnapshotMinidump::InitializeCrashpadInfo() {
@@ -395,6 +479,7 @@ bool ProcessSnapshotMinidump::InitializeModules() {
     return false;
   }
 
+  modules_exposed_.reserve(module_count);
   for (uint32_t module_index = 0; module_index < module_count; ++module_index) {
     const RVA module_rva = stream_it->second->Rva + sizeof(module_count) +
                            module_index * sizeof(MINIDUMP_MODULE);
@@ -412,6 +497,7 @@ bool ProcessSnapshotMinidump::InitializeModules() {
       return false;
     }
 
+    modules_exposed_.push_back(module.get());
     modules_.push_back(std::move(module));
   }
 
@@ -423,6 +509,12 @@ bool ProcessSnapshotMinidump::InitializeModulesCrashpadInfo(
         module_crashpad_info_links) {
   module_crashpad_info_links->clear();
 
+  // Minidumps not written by Crashpad have no MinidumpCrashpadInfo stream, and
+  // so no module links.
+  if (stream_map_.find(kMinidumpStreamTypeCrashpadInfo) == stream_map_.end()) {
+    return true;
+  }
+
   if (crashpad_info_.version != MinidumpCrashpadInfo::kVersion) {
     return false;
   }
@@ -563,19 +655,200 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
   // contiguous list of MINIDUMP_MEMORY_DESCRIPTORs, because the Initialize()
   // function jumps around the file to find the contents of each snapshot.
   FileOffset location = file_reader_->SeekGet();
+  extra_memory_exposed_.reserve(num_ranges);
   for (uint32_t i = 0; i < num_ranges; i++) {
-    extra_memory_.emplace_back(
-        std::make_unique<internal::MemorySnapshotMinidump>());
-    if (!extra_memory_.back()->Initialize(file_reader_,
-                                          static_cast<RVA>(location))) {
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->Initialize(
+            file_reader_, static_cast<RVA>(location), memory_reader_.get())) {
       return false;
     }
+    extra_memory_exposed_.push_back(memory.get());
+    extra_memory_.push_back(std::move(memory));
     location += sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
   }
 
   return true;
 }
 
+bool ProcessSnapshotMinidump::InitializeFullMemory() {
+  // Whatever was read before a failure is still kept in order.
+  const bool success = InitializeMemory64List() && InitializeZeroMemoryList();
+
+  std::stable_sort(full_memory_.begin(),
+                   full_memory_.end(),
+                   [](const auto& a, const auto& b) {
+                     return a->Address() < b->Address();
+                   });
+  full_memory_exposed_.reserve(full_memory_.size());
+  for (const auto& chunk : full_memory_) {
+    full_memory_exposed_.push_back(chunk.get());
+  }
+  return success;
+}
+
+bool ProcessSnapshotMinidump::InitializeMemory64List() {
+  const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMemory64List);
+  if (stream_it == stream_map_.end()) {
+    return true;
+  }
+
+  // Only the fixed fields are read, as with MINIDUMP_MEMORY_LIST.
+  struct {
+    uint64_t number_of_memory_ranges;
+    RVA64 base_rva;
+  } list;
+  static_assert(sizeof(list) == sizeof(MINIDUMP_MEMORY64_LIST),
+                "MINIDUMP_MEMORY64_LIST's fixed fields");
+  if (stream_it->second->DataSize < sizeof(list)) {
+    LOG(ERROR) << "memory64_list size mismatch";
+    return false;
+  }
+
+  if (!file_reader_->SeekSet(stream_it->second->Rva) ||
+      !file_reader_->ReadExactly(&list, sizeof(list))) {
+    return false;
+  }
+
+  if (list.number_of_memory_ranges >
+      (stream_it->second->DataSize - sizeof(list)) /
+          sizeof(MINIDUMP_MEMORY_DESCRIPTOR64)) {
+    LOG(ERROR) << "memory64_list size mismatch";
+    return false;
+  }
+
+  std::vector<MINIDUMP_MEMORY_DESCRIPTOR64> descriptors(
+      static_cast<size_t>(list.number_of_memory_ranges));
+  if (!descriptors.empty() &&
+      !file_reader_->ReadExactly(
+          descriptors.data(),
+          descriptors.size() * sizeof(MINIDUMP_MEMORY_DESCRIPTOR64))) {
+    return false;
+  }
+
+  // The contents of the ranges are stored one after another from base_rva.
+  // They aren’t read until they’re used, so their sizes, which come from the
+  // file, are checked against the file’s size now.
+  const FileOffset file_size = file_reader_->Seek(0, SEEK_END);
+  if (file_size < 0) {
+    return false;
+  }
+  base::CheckedNumeric<FileOffset> offset = list.base_rva;
+  for (const MINIDUMP_MEMORY_DESCRIPTOR64& descriptor : descriptors) {
+    const base::CheckedNumeric<FileOffset> end = offset + descriptor.DataSize;
+    if (!end.IsValid() || end.ValueOrDie() > file_size) {
+      LOG(ERROR) << "memory64_list range out of bounds";
+      return false;
+    }
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->InitializeWithContents(file_reader_,
+                                        descriptor.StartOfMemoryRange,
+                                        offset.ValueOrDie(),
+                                        descriptor.DataSize,
+                                        memory_reader_.get())) {
+      return false;
+    }
+    full_memory_.push_back(std::move(memory));
+    offset += descriptor.DataSize;
+  }
+
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeZeroMemoryList() {
+  const auto& stream_it =
+      stream_map_.find(kMinidumpStreamTypeCrashpadZeroMemory);
+  if (stream_it == stream_map_.end()) {
+    return true;
+  }
+
+  MinidumpZeroMemoryList list;
+  if (stream_it->second->DataSize < sizeof(list)) {
+    LOG(ERROR) << "zero_memory size mismatch";
+    return false;
+  }
+
+  if (!file_reader_->SeekSet(stream_it->second->Rva) ||
+      !file_reader_->ReadExactly(&list, sizeof(list))) {
+    return false;
+  }
+
+  if (list.count > (stream_it->second->DataSize - sizeof(list)) /
+                       sizeof(MinidumpZeroMemoryRange)) {
+    LOG(ERROR) << "zero_memory size mismatch";
+    return false;
+  }
+
+  std::vector<MinidumpZeroMemoryRange> ranges(list.count);
+  if (!ranges.empty() &&
+      !file_reader_->ReadExactly(
+          ranges.data(), ranges.size() * sizeof(MinidumpZeroMemoryRange))) {
+    return false;
+  }
+
+  for (const MinidumpZeroMemoryRange& range : ranges) {
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->InitializeZeroFilled(range.base, range.size)) {
+      return false;
+    }
+    full_memory_.push_back(std::move(memory));
+  }
+
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeModuleIdentities() {
+  const auto& stream_it =
+      stream_map_.find(kMinidumpStreamTypeCrashpadModuleIdentities);
+  if (stream_it == stream_map_.end()) {
+    return true;
+  }
+
+  MinidumpModuleIdentityList list;
+  if (stream_it->second->DataSize < sizeof(list)) {
+    LOG(ERROR) << "module_identities size mismatch";
+    return false;
+  }
+
+  if (!file_reader_->SeekSet(stream_it->second->Rva) ||
+      !file_reader_->ReadExactly(&list, sizeof(list))) {
+    return false;
+  }
+
+  if (list.count > (stream_it->second->DataSize - sizeof(list)) /
+                       sizeof(MinidumpModuleIdentity)) {
+    LOG(ERROR) << "module_identities size mismatch";
+    return false;
+  }
+
+  // The entries are read together before the strings they refer to, which
+  // would otherwise move the file position between entries.
+  std::vector<MinidumpModuleIdentity> entries(list.count);
+  if (!entries.empty() &&
+      !file_reader_->ReadExactly(
+          entries.data(), entries.size() * sizeof(MinidumpModuleIdentity))) {
+    return false;
+  }
+
+  std::vector<ModuleIdentity> identities(entries.size());
+  for (size_t index = 0; index < entries.size(); ++index) {
+    const MinidumpModuleIdentity& entry = entries[index];
+    ModuleIdentity& identity = identities[index];
+    identity.address = entry.base_of_image;
+    identity.size = entry.size_of_image;
+    if (!internal::ReadMinidumpUTF8String(
+            file_reader_, entry.code_id, &identity.code_id) ||
+        !internal::ReadMinidumpUTF8String(
+            file_reader_, entry.debug_id, &identity.debug_id) ||
+        !internal::ReadMinidumpUTF8String(
+            file_reader_, entry.debug_file_name, &identity.debug_file_name)) {
+      return false;
+    }
+  }
+
+  module_identities_ = std::move(identities);
+  return true;
+}
+
 bool ProcessSnapshotMinidump::InitializeThreads() {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeThreadList);
   if (stream_it == stream_map_.end()) {
@@ -606,15 +879,21 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
     return false;
   }
 
+  threads_exposed_.reserve(thread_count);
   for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
     const RVA thread_rva = stream_it->second->Rva + sizeof(thread_count) +
                            thread_index * sizeof(MINIDUMP_THREAD);
 
     auto thread = std::make_unique<internal::ThreadSnapshotMinidump>();
-    if (!thread->Initialize(file_reader_, thread_rva, arch_, thread_names_)) {
+    if (!thread->Initialize(file_reader_,
+                            thread_rva,
+                            arch_,
+                            thread_names_,
+                            memory_reader_.get())) {
       return false;
     }
 
+    threads_exposed_.push_back(thread.get());
     threads_.push_back(std::move(thread));
   }
 
@@ -720,6 +999,7 @@ bool ProcessSnapshotMinidump::InitializeCustomMinidumpStreams() {
 
     custom_streams_.push_back(
         std::make_unique<MinidumpStream>(stream_type, std::move(data)));
+    custom_streams_exposed_.push_back(custom_streams_.back().get());
   }
 
   return true;
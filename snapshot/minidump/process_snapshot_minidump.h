@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "minidump/minidump_extensions.h"
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/memory_snapshot.h"
@@ -39,6 +40,7 @@
 #include "snapshot/thread_snapshot.h"
 #include "snapshot/unloaded_module_snapshot.h"
 #include "util/file/file_reader.h"
+#include "util/file/memory_file_reader.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
 #include "util/process/process_id.h"
@@ -50,6 +52,16 @@ class MemoryMapRegionSnapshotMinidump;
 }  // namespace internal
 
 //! \brief A ProcessSnapshot based on a minidump file.
+//!
+//! Initialize() reads only the minidump header, its stream directory, and the
+//! small streams that describe the process as a whole. The module, thread,
+//! memory, custom, and exception streams are each read the first time an
+//! accessor that needs them is called, so that callers pay only for the
+//! streams they use. Because of this, the file reader must outlive this
+//! object, and this object must not be used from multiple threads at once.
+//!
+//! If a lazily-read stream is malformed, an error is logged and its accessor
+//! returns whatever was read successfully before the error.
 class ProcessSnapshotMinidump final : public ProcessSnapshot {
  public:
   ProcessSnapshotMinidump();
@@ -68,6 +80,20 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader);
 
+  //! \brief Initializes the object from a minidump file already present in
+  //!     memory, such as one that has been memory-mapped.
+  //!
+  //! Memory snapshots obtained from ExtraMemory() and thread stacks reference
+  //! their contents in \a data directly instead of holding copies of them.
+  //!
+  //! \param[in] data The contents of a minidump file. This buffer is not owned
+  //!     by this object and must outlive it.
+  //! \param[in] size The size of \a data.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeFromMemory(const void* data, size_t size);
+
   // ProcessSnapshot:
 
   crashpad::ProcessID ProcessID() const override;
@@ -97,33 +123,111 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   //! \return The caller does not take ownership of the returned objects, they
   //!     are scoped to the lifetime of the ProcessSnapshotMinidump object that
   //!     they were obtained from.
-  std::vector<const MinidumpStream*> CustomMinidumpStreams() const;
+  const std::vector<const MinidumpStream*>& CustomMinidumpStreams() const;
+
+  //! \brief Returns the memory carried in a MINIDUMP_MEMORY64_LIST stream, as
+  //!     written for full-memory dumps.
+  //!
+  //! This memory is separate from ExtraMemory(), and typically overlaps it and
+  //! thread stacks. Zero-filled memory that the writer listed in a
+  //! ::kMinidumpStreamTypeCrashpadZeroMemory stream instead of storing it is
+  //! included too, so that the returned objects are in order of increasing
+  //! address with the gaps of the original full-memory capture.
+  //!
+  //! \return The caller does not take ownership of the returned objects, they
+  //!     are scoped to the lifetime of the ProcessSnapshotMinidump object that
+  //!     they were obtained from.
+  const std::vector<const MemorySnapshot*>& FullMemory() const;
+
+  //! \brief A module’s symbol server identifiers, as written by
+  //!     MinidumpModuleIdentityListWriter.
+  struct ModuleIdentity {
+    //! \brief The module’s base address.
+    uint64_t address;
+
+    //! \brief The size of the module’s image.
+    uint32_t size;
+
+    //! \brief The module’s code ID. See MinidumpModuleIdentity::code_id.
+    std::string code_id;
+
+    //! \brief The module’s debug ID. See MinidumpModuleIdentity::debug_id.
+    std::string debug_id;
+
+    //! \brief The module’s debug file name.
+    std::string debug_file_name;
+  };
+
+  //! \brief Returns the contents of a
+  //!     ::kMinidumpStreamTypeCrashpadModuleIdentities stream.
+  //!
+  //! Reading these doesn’t require reading the module list stream or any
+  //! module’s CodeView record, so this is the cheaper way to find the
+  //! identifiers needed to look up a module’s symbols.
+  //!
+  //! \return The identities, in the order of the module list stream. This is
+  //!     empty if the minidump has no such stream, in which case the
+  //!     identifiers must be taken from Modules() instead.
+  const std::vector<ModuleIdentity>& ModuleIdentities() const;
+
+  //! \name Views
+  //!
+  //! The ProcessSnapshot interface returns its lists by value. These return
+  //! the same objects as the accessors of the same names without the `View`
+  //! suffix, in lists that this object keeps, so that callers that know they
+  //! are reading a minidump can avoid a copy on every call. The spans remain
+  //! valid for the lifetime of this object.
+  //! \{
+  base::span<const ThreadSnapshot* const> ThreadsView() const;
+  base::span<const internal::ModuleSnapshotMinidump* const> ModulesView()
+      const;
+  base::span<const MemoryMapRegionSnapshot* const> MemoryMapView() const;
+  base::span<const MemorySnapshot* const> ExtraMemoryView() const;
+  //! \}
 
  private:
+  // Calls initialize the first time it is called for initialized, logging an
+  // error naming stream_name if initialize fails.
+  void InitializeLazily(bool* initialized,
+                        bool (ProcessSnapshotMinidump::*initialize)(),
+                        const char* stream_name) const;
+
   // Initializes data carried in a MinidumpCrashpadInfo stream on behalf of
   // Initialize().
   bool InitializeCrashpadInfo();
 
-  // Initializes data carried in a MINIDUMP_MODULE_LIST stream on behalf of
-  // Initialize().
+  // Initializes data carried in a MINIDUMP_MODULE_LIST stream the first time
+  // it is needed.
   bool InitializeModules();
 
-  // Initializes data carried in a MINIDUMP_THREAD_LIST stream on behalf of
-  // Initialize().
+  // Initializes data carried in a MINIDUMP_THREAD_LIST stream the first time
+  // it is needed.
   bool InitializeThreads();
 
   // Initializes data carried in a MINIDUMP_THREAD_NAME_LIST stream on behalf of
-  // Initialize().
+  // InitializeThreads().
   bool InitializeThreadNames();
 
-  // Initializes data carried in a MINIDUMP_MEMORY_INFO_LIST stream on behalf of
-  // Initialize().
+  // Initializes data carried in a MINIDUMP_MEMORY_INFO_LIST stream the first
+  // time it is needed.
   bool InitializeMemoryInfo();
 
-  // Initializes data carried in a MINIDUMP_MEMORY_LIST stream on behalf of
-  // Initialize().
+  // Initializes data carried in a MINIDUMP_MEMORY_LIST stream the first time
+  // it is needed.
   bool InitializeExtraMemory();
 
+  // Initializes data carried in MINIDUMP_MEMORY64_LIST and
+  // MinidumpZeroMemoryList streams the first time it is needed.
+  bool InitializeFullMemory();
+
+  // Adds the ranges of a MINIDUMP_MEMORY64_LIST stream to full_memory_ on
+  // behalf of InitializeFullMemory().
+  bool InitializeMemory64List();
+
+  // Adds the ranges of a MinidumpZeroMemoryList stream to full_memory_ on
+  // behalf of InitializeFullMemory().
+  bool InitializeZeroMemoryList();
+
   // Initializes data carried in a MINIDUMP_SYSTEM_INFO stream on behalf of
   // Initialize().
   bool InitializeSystemSnapshot();
@@ -139,25 +243,36 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   // Initialize().
   bool InitializeMiscInfo();
 
-  // Initializes custom minidump streams.
+  // Initializes custom minidump streams the first time they are needed.
   bool InitializeCustomMinidumpStreams();
 
-  // Initializes data carried in a MINIDUMP_EXCEPTION_STREAM stream on behalf of
-  // Initialize().
+  // Initializes data carried in a kMinidumpStreamTypeCrashpadModuleIdentities
+  // stream the first time it is needed.
+  bool InitializeModuleIdentities();
+
+  // Initializes data carried in a MINIDUMP_EXCEPTION_STREAM stream the first
+  // time it is needed.
   bool InitializeExceptionSnapshot();
 
   MINIDUMP_HEADER header_;
   std::vector<MINIDUMP_DIRECTORY> stream_directory_;
   std::map<MinidumpStreamType, const MINIDUMP_LOCATION_DESCRIPTOR*> stream_map_;
   std::vector<std::unique_ptr<internal::ModuleSnapshotMinidump>> modules_;
+  std::vector<const internal::ModuleSnapshotMinidump*> modules_exposed_;
   std::vector<std::unique_ptr<internal::ThreadSnapshotMinidump>> threads_;
+  std::vector<const ThreadSnapshot*> threads_exposed_;
   std::map<uint32_t, std::string> thread_names_;
   std::vector<UnloadedModuleSnapshot> unloaded_modules_;
   std::vector<std::unique_ptr<internal::MemoryMapRegionSnapshotMinidump>>
       mem_regions_;
   std::vector<const MemoryMapRegionSnapshot*> mem_regions_exposed_;
   std::vector<std::unique_ptr<internal::MemorySnapshotMinidump>> extra_memory_;
+  std::vector<const MemorySnapshot*> extra_memory_exposed_;
+  std::vector<std::unique_ptr<internal::MemorySnapshotMinidump>> full_memory_;
+  std::vector<const MemorySnapshot*> full_memory_exposed_;
   std::vector<std::unique_ptr<MinidumpStream>> custom_streams_;
+  std::vector<const MinidumpStream*> custom_streams_exposed_;
+  std::vector<ModuleIdentity> module_identities_;
   MinidumpCrashpadInfo crashpad_info_;
   internal::SystemSnapshotMinidump system_snapshot_;
   internal::ExceptionSnapshotMinidump exception_snapshot_;
@@ -165,6 +280,15 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   std::map<std::string, std::string> annotations_simple_map_;
   std::string full_version_;
   FileReaderInterface* file_reader_;  // weak
+  std::unique_ptr<MemoryFileReader> memory_reader_;
+  mutable bool modules_initialized_;
+  mutable bool threads_initialized_;
+  mutable bool memory_info_initialized_;
+  mutable bool extra_memory_initialized_;
+  mutable bool full_memory_initialized_;
+  mutable bool custom_streams_initialized_;
+  mutable bool module_identities_initialized_;
+  mutable bool exception_initialized_;
   crashpad::ProcessID process_id_;
   uint32_t create_time_;
   uint32_t user_time_;
@@ -0,0 +1,670 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/test/synthetic_process_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "test/benchmark_phase.h"
+#include "tools/tool_support.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+#include "util/stdlib/string_number_conversion.h"
+
+#if defined(CRASHPAD_COUNT_ALLOCATIONS)
+
+// Every allocation made through operator new is counted, so that changes to
+// the reader that allocate more show up even when they don’t cost measurable
+// time on the machine running the benchmark. The build only defines
+// CRASHPAD_COUNT_ALLOCATIONS where nothing else replaces these operators.
+
+namespace {
+
+std::atomic<uint64_t> g_allocations;
+std::atomic<uint64_t> g_allocated_bytes;
+
+void* CountedAllocation(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  return malloc(size ? size : 1);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  void* memory = CountedAllocation(size);
+  if (!memory) {
+    abort();
+  }
+  return memory;
+}
+
+void* operator new[](size_t size) {
+  void* memory = CountedAllocation(size);
+  if (!memory) {
+    abort();
+  }
+  return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocation(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocation(size);
+}
+
+void operator delete(void* memory) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+  free(memory);
+}
+
+#endif  // CRASHPAD_COUNT_ALLOCATIONS
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of reading minidumps with ProcessSnapshotMinidump.\n"
+"\n"
+"      --corpus=DIR             also read every file in DIR, such as a fuzzer\n"
+"                               corpus or a collection of real minidumps\n"
+"      --no-synthetic           don’t read the built-in synthetic minidumps\n"
+"      --write-corpus=DIR       write the synthetic minidumps to DIR and exit\n"
+"      --file-reader            read through a FileReaderInterface instead of\n"
+"                               from memory\n"
+"      --iterations=N           read each minidump N times\n"
+"      --baseline=FILE          compare against results that --write-baseline\n"
+"                               wrote to FILE with the same options, and fail\n"
+"                               if any minidump got slower or allocated more\n"
+"      --tolerance=PERCENT      allow read times PERCENT over the baseline\n"
+"      --write-baseline=FILE    write the results to FILE\n"
+"      --help                   display this help and exit\n"
+"      --version                output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+// The shape of a synthetic minidump. Each one exaggerates a part of the
+// minidump that real crash reports can have a lot of.
+struct Shape {
+  const char* name;
+  SyntheticProcessSnapshotShape snapshot;
+};
+
+constexpr Shape kShapes[] = {
+    {"typical", {64, 16 * 1024, false, 256, 4, 4, 32, 4096, 2048}},
+    {"many-threads", {4096, 8 * 1024, false, 128, 0, 0, 0, 0, 4096}},
+    {"many-modules", {32, 16 * 1024, false, 8192, 0, 0, 0, 0, 32768}},
+    {"big-memory-list", {32, 16 * 1024, false, 128, 0, 0, 32768, 256, 2048}},
+    {"many-annotations", {32, 16 * 1024, false, 256, 128, 128, 0, 0, 2048}},
+};
+
+bool WriteSyntheticMinidump(const Shape& shape, std::string* contents) {
+  std::unique_ptr<TestProcessSnapshot> process_snapshot =
+      BuildSyntheticProcessSnapshot(shape.snapshot);
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.InitializeFromSnapshot(process_snapshot.get());
+  StringFile string_file;
+  if (!minidump_file_writer.WriteEverything(&string_file)) {
+    LOG(ERROR) << "WriteEverything failed for " << shape.name;
+    return false;
+  }
+  *contents = string_file.string();
+  return true;
+}
+
+struct CorpusEntry {
+  std::string name;
+  std::string contents;
+
+  // Whether the entry is expected to be read successfully. Entries from a
+  // fuzzer corpus are often malformed, which is still worth measuring.
+  bool must_succeed;
+};
+
+bool ReadCorpusDirectory(const base::FilePath& directory,
+                         std::vector<CorpusEntry>* corpus) {
+  DirectoryReader reader;
+  if (!reader.Open(directory)) {
+    return false;
+  }
+
+  // Sort the entries, so that the output and any baseline are in the same
+  // order from run to run.
+  std::vector<base::FilePath> filenames;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename, &type)) ==
+         DirectoryReader::Result::kSuccess) {
+    if (type == DirectoryReader::FileType::kRegularFile) {
+      filenames.push_back(filename);
+    }
+  }
+  if (result != DirectoryReader::Result::kNoMoreFiles) {
+    return false;
+  }
+  std::sort(filenames.begin(), filenames.end());
+
+  for (const base::FilePath& name : filenames) {
+    CorpusEntry entry;
+    entry.name = ToolSupport::FilePathToCommandLineArgument(name);
+    entry.must_succeed = false;
+    if (!LoggingReadEntireFile(directory.Append(name), &entry.contents)) {
+      return false;
+    }
+    corpus->push_back(std::move(entry));
+  }
+  return true;
+}
+
+// Reads memory into a buffer that’s reused, the way a consumer that
+// symbolizes stacks would, without keeping it.
+class DiscardingDelegate final : public MemorySnapshot::Delegate {
+ public:
+  DiscardingDelegate() : bytes_(0) {}
+
+  DiscardingDelegate(const DiscardingDelegate&) = delete;
+  DiscardingDelegate& operator=(const DiscardingDelegate&) = delete;
+
+  ~DiscardingDelegate() {}
+
+  size_t bytes() const { return bytes_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    bytes_ += size;
+    return true;
+  }
+
+ private:
+  size_t bytes_;
+};
+
+// Reads everything that ProcessSnapshotMinidump exposes, so that every lazily
+// read stream is parsed. Like a consumer that knows it’s reading a minidump,
+// this uses the views that avoid copying lists.
+void ReadEverything(const ProcessSnapshotMinidump& process_snapshot) {
+  DiscardingDelegate delegate;
+  process_snapshot.AnnotationsSimpleMap();
+  process_snapshot.System();
+  for (const ThreadSnapshot* thread : process_snapshot.ThreadsView()) {
+    thread->Context();
+    thread->ThreadName();
+    const MemorySnapshot* stack = thread->Stack();
+    if (stack) {
+      stack->Read(&delegate);
+    }
+  }
+  for (const internal::ModuleSnapshotMinidump* module :
+       process_snapshot.ModulesView()) {
+    module->Name();
+    module->BuildID();
+    module->annotations_vector();
+    module->annotations_simple_map();
+    module->annotation_objects();
+  }
+  process_snapshot.Exception();
+  process_snapshot.MemoryMapView();
+  for (const MemorySnapshot* memory : process_snapshot.ExtraMemoryView()) {
+    memory->Read(&delegate);
+  }
+  for (const MemorySnapshot* memory : process_snapshot.FullMemory()) {
+    memory->Read(&delegate);
+  }
+  process_snapshot.CustomMinidumpStreams();
+}
+
+uint64_t Allocations() {
+#if defined(CRASHPAD_COUNT_ALLOCATIONS)
+  return g_allocations.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
+
+uint64_t AllocatedBytes() {
+#if defined(CRASHPAD_COUNT_ALLOCATIONS)
+  return g_allocated_bytes.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
+
+struct Sample {
+  uint64_t initialize_ns;
+  uint64_t read_ns;
+  uint64_t allocations;
+  uint64_t allocated_bytes;
+  bool initialized;
+};
+
+Sample ReadMinidump(const CorpusEntry& entry, bool use_file_reader) {
+  // Copying the minidump into the StringFile isn’t part of reading it, so
+  // do that before anything is measured.
+  StringFile string_file;
+  if (use_file_reader) {
+    string_file.SetString(entry.contents);
+  }
+
+  Sample sample;
+  const uint64_t start_allocations = Allocations();
+  const uint64_t start_allocated_bytes = AllocatedBytes();
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  {
+    ProcessSnapshotMinidump process_snapshot;
+    sample.initialized =
+        use_file_reader ? process_snapshot.Initialize(&string_file)
+                        : process_snapshot.InitializeFromMemory(
+                              entry.contents.data(), entry.contents.size());
+    const uint64_t initialized_ns = ClockMonotonicNanoseconds();
+    if (sample.initialized) {
+      ReadEverything(process_snapshot);
+    }
+    sample.initialize_ns = initialized_ns - start_ns;
+    sample.read_ns = ClockMonotonicNanoseconds() - initialized_ns;
+  }
+  sample.allocations = Allocations() - start_allocations;
+  sample.allocated_bytes = AllocatedBytes() - start_allocated_bytes;
+  return sample;
+}
+
+// The medians of the samples taken for one corpus entry. Allocation counts
+// don’t vary between iterations, but taking their median too keeps a stray
+// iteration from deciding the result.
+struct Result {
+  uint64_t initialize_ns;
+  uint64_t read_ns;
+  uint64_t total_ns;
+  uint64_t allocations;
+  uint64_t allocated_bytes;
+  bool initialized;
+};
+
+Result Summarize(const std::vector<Sample>& samples) {
+  Result result;
+  result.initialize_ns = Median(
+      samples, [](const Sample& sample) { return sample.initialize_ns; });
+  result.read_ns =
+      Median(samples, [](const Sample& sample) { return sample.read_ns; });
+  result.total_ns = Median(samples, [](const Sample& sample) {
+    return sample.initialize_ns + sample.read_ns;
+  });
+  result.allocations =
+      Median(samples, [](const Sample& sample) { return sample.allocations; });
+  result.allocated_bytes = Median(
+      samples, [](const Sample& sample) { return sample.allocated_bytes; });
+  result.initialized = samples.front().initialized;
+  return result;
+}
+
+// A baseline file has a line for each corpus entry, holding its name and the
+// median total time in nanoseconds, allocations, and allocated bytes, separated
+// by spaces. Names can’t contain spaces, which is true of the synthetic
+// entries and of the hash-named files in fuzzer corpora.
+struct BaselineEntry {
+  uint64_t total_ns;
+  uint64_t allocations;
+  uint64_t allocated_bytes;
+};
+
+bool ReadBaseline(const base::FilePath& path,
+                  std::map<std::string, BaselineEntry>* baseline) {
+  std::string contents;
+  if (!LoggingReadEntireFile(path, &contents)) {
+    return false;
+  }
+
+  size_t line_start = 0;
+  while (line_start < contents.size()) {
+    size_t line_end = contents.find('\n', line_start);
+    if (line_end == std::string::npos) {
+      line_end = contents.size();
+    }
+    const std::string line(contents, line_start, line_end - line_start);
+    line_start = line_end + 1;
+    if (line.empty()) {
+      continue;
+    }
+
+    char name[256];
+    BaselineEntry entry;
+    if (sscanf(line.c_str(),
+               "%255s %" SCNu64 " %" SCNu64 " %" SCNu64,
+               name,
+               &entry.total_ns,
+               &entry.allocations,
+               &entry.allocated_bytes) != 4) {
+      LOG(ERROR) << "malformed baseline line: " << line;
+      return false;
+    }
+    (*baseline)[name] = entry;
+  }
+  return true;
+}
+
+int ProcessSnapshotMinidumpBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionCorpus,
+    kOptionNoSynthetic,
+    kOptionWriteCorpus,
+    kOptionFileReader,
+    kOptionIterations,
+    kOptionBaseline,
+    kOptionTolerance,
+    kOptionWriteBaseline,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"corpus", required_argument, nullptr, kOptionCorpus},
+      {"no-synthetic", no_argument, nullptr, kOptionNoSynthetic},
+      {"write-corpus", required_argument, nullptr, kOptionWriteCorpus},
+      {"file-reader", no_argument, nullptr, kOptionFileReader},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"baseline", required_argument, nullptr, kOptionBaseline},
+      {"tolerance", required_argument, nullptr, kOptionTolerance},
+      {"write-baseline", required_argument, nullptr, kOptionWriteBaseline},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  struct {
+    std::vector<base::FilePath> corpus_directories;
+    base::FilePath write_corpus;
+    base::FilePath baseline;
+    base::FilePath write_baseline;
+    unsigned int iterations;
+    unsigned int tolerance;
+    bool synthetic;
+    bool file_reader;
+  } options = {};
+  options.iterations = 10;
+  options.tolerance = 10;
+  options.synthetic = true;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionCorpus: {
+        options.corpus_directories.push_back(base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg)));
+        break;
+      }
+      case kOptionNoSynthetic: {
+        options.synthetic = false;
+        break;
+      }
+      case kOptionWriteCorpus: {
+        options.write_corpus = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionFileReader: {
+        options.file_reader = true;
+        break;
+      }
+      case kOptionIterations: {
+        if (!StringToNumber(optarg, &options.iterations) ||
+            options.iterations == 0) {
+          ToolSupport::UsageHint(me,
+                                 "--iterations requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionBaseline: {
+        options.baseline = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionTolerance: {
+        if (!StringToNumber(optarg, &options.tolerance)) {
+          ToolSupport::UsageHint(me, "--tolerance requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionWriteBaseline: {
+        options.write_baseline = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<CorpusEntry> corpus;
+  if (options.synthetic || !options.write_corpus.empty()) {
+    for (const Shape& shape : kShapes) {
+      CorpusEntry entry;
+      entry.name = shape.name;
+      entry.must_succeed = true;
+      if (!WriteSyntheticMinidump(shape, &entry.contents)) {
+        return EXIT_FAILURE;
+      }
+      corpus.push_back(std::move(entry));
+    }
+  }
+
+  if (!options.write_corpus.empty()) {
+    for (const CorpusEntry& entry : corpus) {
+      const base::FilePath path(options.write_corpus.Append(
+          ToolSupport::CommandLineArgumentToFilePathStringType(entry.name +
+                                                               ".dmp")));
+      FileWriter file_writer;
+      if (!file_writer.Open(path,
+                            FileWriteMode::kTruncateOrCreate,
+                            FilePermissions::kWorldReadable) ||
+          !file_writer.Write(entry.contents.data(), entry.contents.size())) {
+        return EXIT_FAILURE;
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+
+  for (const base::FilePath& directory : options.corpus_directories) {
+    if (!ReadCorpusDirectory(directory, &corpus)) {
+      return EXIT_FAILURE;
+    }
+  }
+  if (corpus.empty()) {
+    ToolSupport::UsageHint(me, "nothing to read");
+    return EXIT_FAILURE;
+  }
+
+  std::map<std::string, BaselineEntry> baseline;
+  if (!options.baseline.empty() && !ReadBaseline(options.baseline, &baseline)) {
+    return EXIT_FAILURE;
+  }
+
+#if defined(CRASHPAD_COUNT_ALLOCATIONS)
+  constexpr bool kCountingAllocations = true;
+#else
+  constexpr bool kCountingAllocations = false;
+#endif
+
+  printf("%s, iterations %u%s\n",
+         options.file_reader ? "file reader" : "memory",
+         options.iterations,
+         kCountingAllocations ? "" : ", allocations not counted");
+  printf("%-24s %10s %10s %10s %10s %12s %12s\n",
+         "minidump",
+         "size KiB",
+         "init ms",
+         "read ms",
+         "total ms",
+         "allocations",
+         "alloc KiB");
+
+  bool success = true;
+  std::string baseline_output;
+  for (const CorpusEntry& entry : corpus) {
+    std::vector<Sample> samples;
+    for (unsigned int iteration = 0; iteration < options.iterations;
+         ++iteration) {
+      samples.push_back(ReadMinidump(entry, options.file_reader));
+    }
+    const Result result = Summarize(samples);
+
+    printf("%-24s %10zu %10.3f %10.3f %10.3f %12" PRIu64 " %12" PRIu64 "%s\n",
+           entry.name.c_str(),
+           entry.contents.size() / 1024,
+           result.initialize_ns / 1e6,
+           result.read_ns / 1e6,
+           result.total_ns / 1e6,
+           result.allocations,
+           result.allocated_bytes / 1024,
+           result.initialized ? "" : " (invalid)");
+    if (!result.initialized && entry.must_succeed) {
+      LOG(ERROR) << entry.name << " could not be read";
+      success = false;
+    }
+
+    baseline_output += base::StringPrintf("%s %" PRIu64 " %" PRIu64
+                                          " %" PRIu64 "\n",
+                                          entry.name.c_str(),
+                                          result.total_ns,
+                                          result.allocations,
+                                          result.allocated_bytes);
+
+    const auto it = baseline.find(entry.name);
+    if (it == baseline.end()) {
+      continue;
+    }
+    const BaselineEntry& expected = it->second;
+    if (result.total_ns >
+        expected.total_ns + expected.total_ns * options.tolerance / 100) {
+      printf("  regression: %.3f ms, baseline %.3f ms\n",
+             result.total_ns / 1e6,
+             expected.total_ns / 1e6);
+      success = false;
+    }
+    // Allocation counts are the same from run to run of one build, so any
+    // increase is a regression.
+    if (kCountingAllocations && expected.allocations &&
+        (result.allocations > expected.allocations ||
+         result.allocated_bytes > expected.allocated_bytes)) {
+      printf("  regression: %" PRIu64 " allocations of %" PRIu64
+             " bytes, baseline %" PRIu64 " of %" PRIu64 " bytes\n",
+             result.allocations,
+             result.allocated_bytes,
+             expected.allocations,
+             expected.allocated_bytes);
+      success = false;
+    }
+  }
+
+  if (!options.write_baseline.empty()) {
+    FileWriter file_writer;
+    if (!file_writer.Open(options.write_baseline,
+                          FileWriteMode::kTruncateOrCreate,
+                          FilePermissions::kWorldReadable) ||
+        !file_writer.Write(baseline_output.data(), baseline_output.size())) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::test::ProcessSnapshotMinidumpBenchmarkMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::test::ProcessSnapshotMinidumpBenchmarkMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
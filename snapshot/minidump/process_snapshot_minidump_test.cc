@@ -22,6 +22,7 @@
 #include <iterator>
 #include <memory>
 
+#include "base/containers/span.h"
 #include "base/numerics/safe_math.h"
 #include "base/strings/utf_string_conversions.h"
 #include "gtest/gtest.h"
@@ -619,6 +620,20 @@ TEST(ProcessSnapshotMinidump, Modules) {
 
   auto annotation_objects = modules[3]->AnnotationObjects();
   EXPECT_EQ(annotation_objects, annotations_4);
+
+  // The views return the same modules, and their annotations without copies.
+  base::span<const internal::ModuleSnapshotMinidump* const> modules_view =
+      process_snapshot.ModulesView();
+  ASSERT_EQ(modules_view.size(), modules.size());
+  for (size_t i = 0; i < modules.size(); ++i) {
+    EXPECT_EQ(modules_view[i], modules[i]);
+  }
+  EXPECT_EQ(process_snapshot.ModulesView().data(), modules_view.data());
+  EXPECT_EQ(modules_view[0]->annotations_simple_map(), dictionary_0);
+  EXPECT_EQ(modules_view[2]->annotations_vector(), list_annotations_2);
+  EXPECT_EQ(modules_view[3]->annotation_objects(), annotations_4);
+  EXPECT_EQ(&modules_view[3]->annotation_objects(),
+            &modules_view[3]->annotation_objects());
 }
 
 TEST(ProcessSnapshotMinidump, ProcessID) {
@@ -1314,6 +1329,12 @@ TEST(ProcessSnapshotMinidump, MemoryMap) {
                    &minidump_memory_info_2,
                    sizeof(minidump_memory_info_2)),
             0);
+
+  base::span<const MemoryMapRegionSnapshot* const> map_view =
+      process_snapshot.MemoryMapView();
+  ASSERT_EQ(map_view.size(), map.size());
+  EXPECT_EQ(map_view[0], map[0]);
+  EXPECT_EQ(map_view[1], map[1]);
 }
 
 TEST(ProcessSnapshotMinidump, Stacks) {
@@ -1385,6 +1406,459 @@ TEST(ProcessSnapshotMinidump, Stacks) {
   EXPECT_EQ(delegate.result, minidump_stack);
 }
 
+class ReadToPointer : public crashpad::MemorySnapshot::Delegate {
+ public:
+  const void* data = nullptr;
+  size_t size = 0;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    this->data = data;
+    this->size = size;
+    return true;
+  }
+};
+
+TEST(ProcessSnapshotMinidump, InitializeFromMemory) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  static constexpr char kStack[] = "stack contents";
+  static constexpr char kExtraMemory[] = "extra memory contents";
+
+  MINIDUMP_THREAD minidump_thread = {};
+  uint32_t minidump_thread_count = 1;
+  minidump_thread.ThreadId = 42;
+  minidump_thread.Stack.StartOfMemoryRange = 0xbeefd00d;
+  minidump_thread.Stack.Memory.DataSize = sizeof(kStack);
+  minidump_thread.Stack.Memory.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(kStack, sizeof(kStack)));
+
+  MINIDUMP_MEMORY_DESCRIPTOR memory_descriptor = {};
+  uint32_t memory_count = 1;
+  memory_descriptor.StartOfMemoryRange = 0xfeedf00d;
+  memory_descriptor.Memory.DataSize = sizeof(kExtraMemory);
+  memory_descriptor.Memory.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(kExtraMemory, sizeof(kExtraMemory)));
+
+  MINIDUMP_DIRECTORY minidump_directories[2] = {};
+  minidump_directories[0].StreamType = kMinidumpStreamTypeThreadList;
+  minidump_directories[0].Location.DataSize =
+      sizeof(MINIDUMP_THREAD_LIST) +
+      minidump_thread_count * sizeof(MINIDUMP_THREAD);
+  minidump_directories[0].Location.Rva =
+      static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(
+      string_file.Write(&minidump_thread_count, sizeof(minidump_thread_count)));
+  EXPECT_TRUE(string_file.Write(&minidump_thread, sizeof(minidump_thread)));
+
+  minidump_directories[1].StreamType = kMinidumpStreamTypeMemoryList;
+  minidump_directories[1].Location.DataSize =
+      sizeof(MINIDUMP_MEMORY_LIST) +
+      memory_count * sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
+  minidump_directories[1].Location.Rva =
+      static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(&memory_count, sizeof(memory_count)));
+  EXPECT_TRUE(string_file.Write(&memory_descriptor, sizeof(memory_descriptor)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(minidump_directories,
+                                sizeof(minidump_directories)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 2;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  const std::string& contents = string_file.string();
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(
+      process_snapshot.InitializeFromMemory(contents.data(), contents.size()));
+
+  // Memory contents are referenced in place rather than copied.
+  std::vector<const ThreadSnapshot*> threads = process_snapshot.Threads();
+  ASSERT_EQ(threads.size(), 1u);
+  ReadToPointer stack_delegate;
+  ASSERT_TRUE(threads[0]->Stack()->Read(&stack_delegate));
+  EXPECT_EQ(stack_delegate.data,
+            contents.data() + minidump_thread.Stack.Memory.Rva);
+  EXPECT_EQ(stack_delegate.size, sizeof(kStack));
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 1u);
+  EXPECT_EQ(extra_memory[0]->Address(), 0xfeedf00du);
+  EXPECT_EQ(extra_memory[0]->Size(), sizeof(kExtraMemory));
+  ReadToPointer memory_delegate;
+  ASSERT_TRUE(extra_memory[0]->Read(&memory_delegate));
+  EXPECT_EQ(memory_delegate.data,
+            contents.data() + memory_descriptor.Memory.Rva);
+  EXPECT_STREQ(reinterpret_cast<const char*>(memory_delegate.data),
+               kExtraMemory);
+
+  base::span<const ThreadSnapshot* const> threads_view =
+      process_snapshot.ThreadsView();
+  ASSERT_EQ(threads_view.size(), 1u);
+  EXPECT_EQ(threads_view[0], threads[0]);
+  base::span<const MemorySnapshot* const> extra_memory_view =
+      process_snapshot.ExtraMemoryView();
+  ASSERT_EQ(extra_memory_view.size(), 1u);
+  EXPECT_EQ(extra_memory_view[0], extra_memory[0]);
+
+  // A memory range extending past the end of the file is rejected, without
+  // affecting the other streams.
+  memory_descriptor.Memory.DataSize = 0x10000;
+  ASSERT_TRUE(string_file.SeekSet(minidump_directories[1].Location.Rva +
+                                  sizeof(memory_count)));
+  ASSERT_TRUE(string_file.Write(&memory_descriptor, sizeof(memory_descriptor)));
+  ProcessSnapshotMinidump bad_snapshot;
+  ASSERT_TRUE(bad_snapshot.InitializeFromMemory(string_file.string().data(),
+                                                string_file.string().size()));
+  EXPECT_TRUE(bad_snapshot.ExtraMemory().empty());
+  EXPECT_EQ(bad_snapshot.Threads().size(), 1u);
+}
+
+TEST(ProcessSnapshotMinidump, FullMemory) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  static constexpr char kRange0[] = "first range";
+  static constexpr char kRange1[] = "second range, contiguous with the first";
+
+  MINIDUMP_DIRECTORY minidump_directory = {};
+  minidump_directory.StreamType = kMinidumpStreamTypeMemory64List;
+  minidump_directory.Location.DataSize =
+      sizeof(MINIDUMP_MEMORY64_LIST) + 2 * sizeof(MINIDUMP_MEMORY_DESCRIPTOR64);
+  minidump_directory.Location.Rva = static_cast<RVA>(string_file.SeekGet());
+
+  const uint64_t range_count = 2;
+  const RVA64 base_rva = minidump_directory.Location.Rva +
+                         minidump_directory.Location.DataSize;
+  MINIDUMP_MEMORY_DESCRIPTOR64 descriptors[2] = {};
+  descriptors[0].StartOfMemoryRange = 0x7fff0000;
+  descriptors[0].DataSize = sizeof(kRange0);
+  descriptors[1].StartOfMemoryRange = 0x100000000;
+  descriptors[1].DataSize = sizeof(kRange1);
+  EXPECT_TRUE(string_file.Write(&range_count, sizeof(range_count)));
+  EXPECT_TRUE(string_file.Write(&base_rva, sizeof(base_rva)));
+  EXPECT_TRUE(string_file.Write(descriptors, sizeof(descriptors)));
+  EXPECT_TRUE(string_file.Write(kRange0, sizeof(kRange0)));
+  EXPECT_TRUE(string_file.Write(kRange1, sizeof(kRange1)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(
+      string_file.Write(&minidump_directory, sizeof(minidump_directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  const std::string contents = string_file.string();
+
+  {
+    SCOPED_TRACE("file");
+    ProcessSnapshotMinidump process_snapshot;
+    ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+    EXPECT_TRUE(process_snapshot.ExtraMemory().empty());
+
+    std::vector<const MemorySnapshot*> full_memory =
+        process_snapshot.FullMemory();
+    ASSERT_EQ(full_memory.size(), 2u);
+    EXPECT_EQ(full_memory[0]->Address(), descriptors[0].StartOfMemoryRange);
+    EXPECT_EQ(full_memory[1]->Address(), descriptors[1].StartOfMemoryRange);
+
+    ReadToVector delegate;
+    ASSERT_TRUE(full_memory[0]->Read(&delegate));
+    EXPECT_EQ(delegate.result,
+              std::vector<uint8_t>(kRange0, kRange0 + sizeof(kRange0)));
+    ASSERT_TRUE(full_memory[1]->Read(&delegate));
+    EXPECT_EQ(delegate.result,
+              std::vector<uint8_t>(kRange1, kRange1 + sizeof(kRange1)));
+
+    // The contents are read from the file when they’re used.
+    std::vector<char> buffer(sizeof(kRange1));
+    ASSERT_TRUE(full_memory[1]->ReadInto(buffer.data()));
+    EXPECT_STREQ(buffer.data(), kRange1);
+  }
+
+  {
+    SCOPED_TRACE("memory");
+    ProcessSnapshotMinidump process_snapshot;
+    ASSERT_TRUE(process_snapshot.InitializeFromMemory(contents.data(),
+                                                      contents.size()));
+
+    std::vector<const MemorySnapshot*> full_memory =
+        process_snapshot.FullMemory();
+    ASSERT_EQ(full_memory.size(), 2u);
+    ReadToPointer delegate;
+    ASSERT_TRUE(full_memory[1]->Read(&delegate));
+    EXPECT_EQ(delegate.data, contents.data() + base_rva + sizeof(kRange0));
+    EXPECT_EQ(delegate.size, sizeof(kRange1));
+  }
+
+  // More ranges than the stream has room for are rejected.
+  const uint64_t bad_range_count = 3;
+  ASSERT_TRUE(string_file.SeekSet(minidump_directory.Location.Rva));
+  ASSERT_TRUE(string_file.Write(&bad_range_count, sizeof(bad_range_count)));
+  ProcessSnapshotMinidump bad_snapshot;
+  ASSERT_TRUE(bad_snapshot.Initialize(&string_file));
+  EXPECT_TRUE(bad_snapshot.FullMemory().empty());
+
+  // So is a range that extends past the end of the file. The ranges before it
+  // are kept.
+  ASSERT_TRUE(string_file.SeekSet(minidump_directory.Location.Rva));
+  ASSERT_TRUE(string_file.Write(&range_count, sizeof(range_count)));
+  MINIDUMP_MEMORY_DESCRIPTOR64 oversized_descriptor = descriptors[1];
+  oversized_descriptor.DataSize = uint64_t{1} << 60;
+  ASSERT_TRUE(string_file.SeekSet(minidump_directory.Location.Rva +
+                                  sizeof(MINIDUMP_MEMORY64_LIST) +
+                                  sizeof(MINIDUMP_MEMORY_DESCRIPTOR64)));
+  ASSERT_TRUE(string_file.Write(&oversized_descriptor,
+                                sizeof(oversized_descriptor)));
+  ProcessSnapshotMinidump oversized_snapshot;
+  ASSERT_TRUE(oversized_snapshot.Initialize(&string_file));
+  ASSERT_EQ(oversized_snapshot.FullMemory().size(), 1u);
+  EXPECT_EQ(oversized_snapshot.FullMemory()[0]->Address(),
+            descriptors[0].StartOfMemoryRange);
+}
+
+TEST(ProcessSnapshotMinidump, FullMemoryZeroRanges) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  static constexpr char kRange[] = "nonzero";
+
+  MINIDUMP_DIRECTORY directories[2] = {};
+  directories[0].StreamType = kMinidumpStreamTypeMemory64List;
+  directories[0].Location.DataSize =
+      sizeof(MINIDUMP_MEMORY64_LIST) + sizeof(MINIDUMP_MEMORY_DESCRIPTOR64);
+  directories[0].Location.Rva = static_cast<RVA>(string_file.SeekGet());
+
+  const uint64_t range_count = 1;
+  const RVA64 base_rva =
+      directories[0].Location.Rva + directories[0].Location.DataSize;
+  MINIDUMP_MEMORY_DESCRIPTOR64 descriptor = {};
+  descriptor.StartOfMemoryRange = 0x10000;
+  descriptor.DataSize = sizeof(kRange);
+  EXPECT_TRUE(string_file.Write(&range_count, sizeof(range_count)));
+  EXPECT_TRUE(string_file.Write(&base_rva, sizeof(base_rva)));
+  EXPECT_TRUE(string_file.Write(&descriptor, sizeof(descriptor)));
+  EXPECT_TRUE(string_file.Write(kRange, sizeof(kRange)));
+
+  // The zero-filled ranges surround the stored one.
+  MinidumpZeroMemoryList zero_list = {};
+  zero_list.count = 2;
+  MinidumpZeroMemoryRange zero_ranges[2] = {};
+  zero_ranges[0].base = 0x20000;
+  zero_ranges[0].size = 0x210000;
+  zero_ranges[1].base = 0x1000;
+  zero_ranges[1].size = 0x100;
+  directories[1].StreamType = kMinidumpStreamTypeCrashpadZeroMemory;
+  directories[1].Location.DataSize = sizeof(zero_list) + sizeof(zero_ranges);
+  directories[1].Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(&zero_list, sizeof(zero_list)));
+  EXPECT_TRUE(string_file.Write(zero_ranges, sizeof(zero_ranges)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(directories, sizeof(directories)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 2;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  std::vector<const MemorySnapshot*> full_memory =
+      process_snapshot.FullMemory();
+  ASSERT_EQ(full_memory.size(), 3u);
+  EXPECT_EQ(full_memory[0]->Address(), zero_ranges[1].base);
+  EXPECT_EQ(full_memory[0]->Size(), zero_ranges[1].size);
+  EXPECT_EQ(full_memory[1]->Address(), descriptor.StartOfMemoryRange);
+  EXPECT_EQ(full_memory[2]->Address(), zero_ranges[0].base);
+  EXPECT_EQ(full_memory[2]->Size(), zero_ranges[0].size);
+
+  ReadToVector delegate;
+  ASSERT_TRUE(full_memory[0]->Read(&delegate));
+  EXPECT_EQ(delegate.result,
+            std::vector<uint8_t>(static_cast<size_t>(zero_ranges[1].size)));
+
+  std::vector<uint8_t> buffer(static_cast<size_t>(zero_ranges[0].size), 0xff);
+  ASSERT_TRUE(full_memory[2]->ReadInto(buffer.data()));
+  EXPECT_EQ(buffer,
+            std::vector<uint8_t>(static_cast<size_t>(zero_ranges[0].size)));
+
+  // Zero-filled memory is provided in pieces no larger than asked for.
+  class ChunkDelegate : public MemorySnapshot::Delegate {
+   public:
+    bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      all_zero = all_zero && std::all_of(bytes, bytes + size, [](uint8_t b) {
+                   return b == 0;
+                 });
+      largest = std::max(largest, size);
+      total += size;
+      return true;
+    }
+
+    size_t largest = 0;
+    size_t total = 0;
+    bool all_zero = true;
+  } chunk_delegate;
+  ASSERT_TRUE(full_memory[2]->ReadChunked(&chunk_delegate, 0x100000));
+  EXPECT_EQ(chunk_delegate.largest, 0x100000u);
+  EXPECT_EQ(chunk_delegate.total, zero_ranges[0].size);
+  EXPECT_TRUE(chunk_delegate.all_zero);
+}
+
+TEST(ProcessSnapshotMinidump, ModuleIdentities) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  static constexpr char kDebugID[] = "67452301AB89EFCD01234567890ABCDE0";
+
+  MinidumpModuleIdentity entries[2] = {};
+  entries[0].base_of_image = 0x7f0000000000;
+  entries[0].size_of_image = 0x4000;
+  entries[0].code_id = WriteString(&string_file, "0123456789abcdef");
+  entries[0].debug_id = WriteString(&string_file, kDebugID);
+  entries[0].debug_file_name = WriteString(&string_file, "libfoo.so");
+  entries[1].base_of_image = 0x140000000;
+  entries[1].size_of_image = 0x21000;
+  entries[1].code_id = WriteString(&string_file, "5E8A1B2C21000");
+  entries[1].debug_id = WriteString(&string_file, "");
+  entries[1].debug_file_name = WriteString(&string_file, "");
+
+  MinidumpModuleIdentityList list = {};
+  list.count = std::size(entries);
+
+  MINIDUMP_DIRECTORY directory = {};
+  directory.StreamType = kMinidumpStreamTypeCrashpadModuleIdentities;
+  directory.Location.DataSize = sizeof(list) + sizeof(entries);
+  directory.Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(&list, sizeof(list)));
+  EXPECT_TRUE(string_file.Write(entries, sizeof(entries)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(&directory, sizeof(directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  // No module list is needed to read these.
+  EXPECT_TRUE(process_snapshot.Modules().empty());
+
+  const std::vector<ProcessSnapshotMinidump::ModuleIdentity>& identities =
+      process_snapshot.ModuleIdentities();
+  ASSERT_EQ(identities.size(), 2u);
+  EXPECT_EQ(identities[0].address, entries[0].base_of_image);
+  EXPECT_EQ(identities[0].size, entries[0].size_of_image);
+  EXPECT_EQ(identities[0].code_id, "0123456789abcdef");
+  EXPECT_EQ(identities[0].debug_id, kDebugID);
+  EXPECT_EQ(identities[0].debug_file_name, "libfoo.so");
+  EXPECT_EQ(identities[1].address, entries[1].base_of_image);
+  EXPECT_EQ(identities[1].size, entries[1].size_of_image);
+  EXPECT_EQ(identities[1].code_id, "5E8A1B2C21000");
+  EXPECT_TRUE(identities[1].debug_id.empty());
+  EXPECT_TRUE(identities[1].debug_file_name.empty());
+}
+
+TEST(ProcessSnapshotMinidump, ModuleIdentitiesTruncated) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  // The list claims more entries than the stream has room for.
+  MinidumpModuleIdentityList list = {};
+  list.count = 2;
+  MinidumpModuleIdentity entry = {};
+
+  MINIDUMP_DIRECTORY directory = {};
+  directory.StreamType = kMinidumpStreamTypeCrashpadModuleIdentities;
+  directory.Location.DataSize = sizeof(list) + sizeof(entry);
+  directory.Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(&list, sizeof(list)));
+  EXPECT_TRUE(string_file.Write(&entry, sizeof(entry)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(&directory, sizeof(directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+  EXPECT_TRUE(process_snapshot.ModuleIdentities().empty());
+}
+
+TEST(ProcessSnapshotMinidump, StreamsAreReadOnDemand) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  // A thread list whose size doesn’t match its thread count.
+  MINIDUMP_DIRECTORY minidump_thread_list_directory = {};
+  minidump_thread_list_directory.StreamType = kMinidumpStreamTypeThreadList;
+  minidump_thread_list_directory.Location.DataSize =
+      sizeof(MINIDUMP_THREAD_LIST) + sizeof(MINIDUMP_THREAD);
+  minidump_thread_list_directory.Location.Rva =
+      static_cast<RVA>(string_file.SeekGet());
+  uint32_t minidump_thread_count = 2;
+  EXPECT_TRUE(
+      string_file.Write(&minidump_thread_count, sizeof(minidump_thread_count)));
+  MINIDUMP_THREAD minidump_thread = {};
+  EXPECT_TRUE(string_file.Write(&minidump_thread, sizeof(minidump_thread)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(&minidump_thread_list_directory,
+                                sizeof(minidump_thread_list_directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  // Initialize() doesn’t read the thread list, so it leaves the file position
+  // just past the stream directory.
+  EXPECT_EQ(
+      string_file.SeekGet(),
+      header.StreamDirectoryRva +
+          static_cast<FileOffset>(sizeof(minidump_thread_list_directory)));
+  EXPECT_TRUE(process_snapshot.AnnotationsSimpleMap().empty());
+
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+  EXPECT_FALSE(process_snapshot.Exception());
+}
+
 TEST(ProcessSnapshotMinidump, CustomMinidumpStreams) {
   StringFile string_file;
 
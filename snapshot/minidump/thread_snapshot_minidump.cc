@@ -38,7 +38,8 @@ bool ThreadSnapshotMinidump::Initialize(
     FileReaderInterface* file_reader,
     RVA minidump_thread_rva,
     CPUArchitecture arch,
-    const std::map<uint32_t, std::string>& thread_names) {
+    const std::map<uint32_t, std::string>& thread_names,
+    const MemoryFileReader* memory_reader) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   std::vector<unsigned char> minidump_context;
 
@@ -68,7 +69,7 @@ bool ThreadSnapshotMinidump::Initialize(
   RVA stack_info_location =
       minidump_thread_rva + offsetof(MINIDUMP_THREAD, Stack);
 
-  if (!stack_.Initialize(file_reader, stack_info_location)) {
+  if (!stack_.Initialize(file_reader, stack_info_location, memory_reader)) {
     return false;
   }
   const auto thread_name_iter = thread_names.find(minidump_thread_.ThreadId);
@@ -123,5 +124,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMinidump::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+std::vector<uint8_t> ThreadSnapshotMinidump::Breadcrumbs() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotMinidump::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<UnwoundStackFrame>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -50,13 +50,18 @@ class ThreadSnapshotMinidump : public ThreadSnapshot {
   //!     Used to decode CPU Context.
   //! \param[in] thread_names Map from thread ID to thread name previously read
   //!     from the minidump's MINIDUMP_THREAD_NAME_LIST.
+  //! \param[in] memory_reader If not `nullptr`, the in-memory view of the same
+  //!     minidump file that \a file_reader reads, from which the thread’s
+  //!     stack is referenced in place. See
+  //!     MemorySnapshotMinidump::Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader,
                   RVA minidump_thread_rva,
                   CPUArchitecture arch,
-                  const std::map<uint32_t, std::string>& thread_names);
+                  const std::map<uint32_t, std::string>& thread_names,
+                  const MemoryFileReader* memory_reader = nullptr);
 
   const CPUContext* Context() const override;
   const MemorySnapshot* Stack() const override;
@@ -66,6 +71,8 @@ class ThreadSnapshotMinidump : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  std::vector<uint8_t> Breadcrumbs() const override;
+  std::vector<UnwoundStackFrame> UnwoundFrames() const override;
 
  private:
   //! \brief Initializes the CPU Context
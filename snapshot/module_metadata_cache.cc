@@ -0,0 +1,60 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/module_metadata_cache.h"
+
+#include <tuple>
+
+namespace crashpad {
+
+bool ModuleMetadataCache::Key::operator<(const Key& that) const {
+  return std::tie(path, file_identity, size) <
+         std::tie(that.path, that.file_identity, that.size);
+}
+
+ModuleMetadataCache::Metadata::Metadata()
+    : uuid(),
+      age(0),
+      debug_file_name(),
+      build_id(),
+      version_info(),
+      has_crashpad_info(false),
+      crashpad_info_address(0) {}
+
+ModuleMetadataCache::Metadata::~Metadata() {}
+
+ModuleMetadataCache::ModuleMetadataCache(size_t max_modules)
+    : modules_(), lock_(), max_modules_(max_modules) {}
+
+ModuleMetadataCache::~ModuleMetadataCache() {}
+
+std::shared_ptr<const ModuleMetadataCache::Metadata>
+ModuleMetadataCache::Lookup(const Key& key) const {
+  base::AutoLock lock_owner(lock_);
+  const auto iterator = modules_.find(key);
+  if (iterator == modules_.end()) {
+    return nullptr;
+  }
+  return iterator->second;
+}
+
+void ModuleMetadataCache::Insert(const Key& key, const Metadata& metadata) {
+  base::AutoLock lock_owner(lock_);
+  if (modules_.size() >= max_modules_) {
+    return;
+  }
+  modules_.emplace(key, std::make_shared<const Metadata>(metadata));
+}
+
+}  // namespace crashpad
@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MODULE_METADATA_CACHE_H_
+#define CRASHPAD_SNAPSHOT_MODULE_METADATA_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief A cache of metadata derived from module images, shared by snapshots
+//!     of different processes.
+//!
+//! Module snapshots derive identifying information, such as build IDs and
+//! debug file records, from the module’s image in the target process. When the
+//! same module file is loaded by many processes, or the same process crashes
+//! repeatedly, a long-lived owner such as a handler can keep one of these
+//! objects so that module snapshots derive that information once per file
+//! rather than once per capture.
+//!
+//! This class is thread-safe.
+class ModuleMetadataCache {
+ public:
+  //! \brief Identifies a module file.
+  struct Key {
+    //! \brief The module’s path or name.
+    std::string path;
+
+    //! \brief A platform-specific value that distinguishes different files that
+    //!     have been found at \a path, and different contents of the same
+    //!     file, such as a device and inode number with a change time, or a
+    //!     link timestamp.
+    std::string file_identity;
+
+    //! \brief The size of the module’s image in memory.
+    uint64_t size;
+
+    bool operator<(const Key& that) const;
+  };
+
+  //! \brief Metadata derived from a module’s image.
+  //!
+  //! Module snapshots only fill in and consult the fields that they would
+  //! otherwise derive from the image.
+  struct Metadata {
+    Metadata();
+    ~Metadata();
+
+    //! \brief See ModuleSnapshot::UUIDAndAge().
+    UUID uuid;
+
+    //! \brief See ModuleSnapshot::UUIDAndAge().
+    uint32_t age;
+
+    //! \brief See ModuleSnapshot::DebugFileName().
+    std::string debug_file_name;
+
+    //! \brief See ModuleSnapshot::BuildID().
+    std::vector<uint8_t> build_id;
+
+    //! \brief Platform-specific version information, such as a
+    //!     `VS_FIXEDFILEINFO` on Windows, or empty if the module doesn’t have
+    //!     any.
+    std::vector<uint8_t> version_info;
+
+    //! \brief Whether the module’s image has a note locating its
+    //!     CrashpadInfo structure. Most modules, such as system libraries,
+    //!     don’t, and their notes needn’t be searched again.
+    //!
+    //! Only used for ELF modules.
+    bool has_crashpad_info;
+
+    //! \brief The address of the module’s CrashpadInfo structure less its
+    //!     load bias, when \a has_crashpad_info is `true`.
+    //!
+    //! Only used for ELF modules.
+    uint64_t crashpad_info_address;
+  };
+
+  //! \brief A default for the maximum number of modules to cache, suitable
+  //!     for handlers.
+  static constexpr size_t kDefaultMaxModules = 4096;
+
+  //! \param[in] max_modules The maximum number of modules whose metadata will
+  //!     be cached. Once this many have been cached, Insert() has no effect.
+  explicit ModuleMetadataCache(size_t max_modules = kDefaultMaxModules);
+
+  ModuleMetadataCache(const ModuleMetadataCache&) = delete;
+  ModuleMetadataCache& operator=(const ModuleMetadataCache&) = delete;
+
+  ~ModuleMetadataCache();
+
+  //! \brief Returns the cached metadata for the module identified by \a key,
+  //!     or `nullptr` if none has been cached.
+  std::shared_ptr<const Metadata> Lookup(const Key& key) const;
+
+  //! \brief Caches \a metadata for the module identified by \a key.
+  //!
+  //! If metadata has already been cached for \a key, it is not replaced.
+  void Insert(const Key& key, const Metadata& metadata);
+
+ private:
+  std::map<Key, std::shared_ptr<const Metadata>> modules_;
+  mutable base::Lock lock_;
+  const size_t max_modules_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MODULE_METADATA_CACHE_H_
@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/module_metadata_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ModuleMetadataCache, LookupAndInsert) {
+  ModuleMetadataCache cache(2);
+
+  const ModuleMetadataCache::Key key = {"/lib/libc.so.6", "803:1234", 0x200000};
+  EXPECT_FALSE(cache.Lookup(key));
+
+  ModuleMetadataCache::Metadata metadata;
+  EXPECT_FALSE(metadata.has_crashpad_info);
+  EXPECT_EQ(metadata.crashpad_info_address, 0u);
+  metadata.build_id = {0xde, 0xad, 0xbe, 0xef};
+  metadata.debug_file_name = "libc.so.6";
+  metadata.has_crashpad_info = true;
+  metadata.crashpad_info_address = 0x1234;
+  cache.Insert(key, metadata);
+
+  auto cached = cache.Lookup(key);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(cached->build_id, metadata.build_id);
+  EXPECT_EQ(cached->debug_file_name, metadata.debug_file_name);
+  EXPECT_TRUE(cached->has_crashpad_info);
+  EXPECT_EQ(cached->crashpad_info_address, metadata.crashpad_info_address);
+
+  // Each part of the key distinguishes modules.
+  ModuleMetadataCache::Key other_key = key;
+  other_key.path = "/lib/libm.so.6";
+  EXPECT_FALSE(cache.Lookup(other_key));
+  other_key = key;
+  other_key.file_identity = "803:5678";
+  EXPECT_FALSE(cache.Lookup(other_key));
+  other_key = key;
+  other_key.size = 0x100000;
+  EXPECT_FALSE(cache.Lookup(other_key));
+
+  // Metadata already cached isn’t replaced.
+  ModuleMetadataCache::Metadata other_metadata;
+  other_metadata.build_id = {1, 2, 3};
+  cache.Insert(key, other_metadata);
+  cached = cache.Lookup(key);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(cached->build_id, metadata.build_id);
+
+  // Insertions beyond the maximum are ignored.
+  cache.Insert(other_key, other_metadata);
+  ModuleMetadataCache::Key third_key = key;
+  third_key.path = "/lib/libpthread.so.0";
+  cache.Insert(third_key, other_metadata);
+  EXPECT_TRUE(cache.Lookup(other_key));
+  EXPECT_FALSE(cache.Lookup(third_key));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
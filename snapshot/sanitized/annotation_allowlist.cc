@@ -0,0 +1,74 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/annotation_allowlist.h"
+
+#include <algorithm>
+
+#include "base/strings/pattern.h"
+
+namespace crashpad {
+namespace internal {
+
+AnnotationAllowlist::AnnotationAllowlist(
+    const std::vector<std::string>& patterns)
+    : names_(), patterns_(), allow_all_(false) {
+  for (const auto& pattern : patterns) {
+    // base::MatchPattern() treats a backslash as escaping the next character.
+    const size_t special = pattern.find_first_of("*?\\");
+    if (special == std::string::npos) {
+      names_.push_back(pattern);
+    } else if (pattern.find_first_not_of('*') == std::string::npos) {
+      allow_all_ = true;
+    } else {
+      patterns_.push_back({pattern.substr(0, special), pattern});
+    }
+  }
+
+  std::sort(names_.begin(), names_.end());
+  names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+  std::sort(patterns_.begin(),
+            patterns_.end(),
+            [](const Pattern& lhs, const Pattern& rhs) {
+              return lhs.prefix < rhs.prefix;
+            });
+}
+
+AnnotationAllowlist::~AnnotationAllowlist() = default;
+
+bool AnnotationAllowlist::Allows(const std::string& name) const {
+  if (allow_all_ || std::binary_search(names_.begin(), names_.end(), name)) {
+    return true;
+  }
+
+  // Every pattern that can match name has a prefix that is also a prefix of
+  // name, and so sorts no later than name.
+  const auto end = std::upper_bound(
+      patterns_.begin(),
+      patterns_.end(),
+      name,
+      [](const std::string& name, const Pattern& pattern) {
+        return name < pattern.prefix;
+      });
+  for (auto pattern = patterns_.begin(); pattern != end; ++pattern) {
+    if (name.compare(0, pattern->prefix.size(), pattern->prefix) == 0 &&
+        base::MatchPattern(name, pattern->pattern)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,61 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
+#define CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
+
+#include <string>
+#include <vector>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Matches annotation names against a list of allowed names, prepared
+//!     once so that each lookup is cheap.
+//!
+//! Entries in the list are patterns as accepted by `base::MatchPattern()`.
+//! Entries without wildcards are looked up with a binary search. Entries with
+//! wildcards are only matched against names that begin with the literal text
+//! preceding their first wildcard.
+class AnnotationAllowlist {
+ public:
+  //! \brief Constructs this object.
+  //!
+  //! \param[in] patterns The names, or patterns of names, to allow.
+  explicit AnnotationAllowlist(const std::vector<std::string>& patterns);
+
+  AnnotationAllowlist(const AnnotationAllowlist&) = delete;
+  AnnotationAllowlist& operator=(const AnnotationAllowlist&) = delete;
+
+  ~AnnotationAllowlist();
+
+  //! \brief Returns `true` if \a name matches any entry in the list.
+  bool Allows(const std::string& name) const;
+
+ private:
+  struct Pattern {
+    // The literal text preceding the first wildcard or escape in pattern.
+    std::string prefix;
+    std::string pattern;
+  };
+
+  std::vector<std::string> names_;  // Sorted.
+  std::vector<Pattern> patterns_;  // Sorted by prefix.
+  bool allow_all_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
@@ -0,0 +1,82 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/annotation_allowlist.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(AnnotationAllowlist, Empty) {
+  internal::AnnotationAllowlist allowlist({});
+  EXPECT_FALSE(allowlist.Allows(""));
+  EXPECT_FALSE(allowlist.Allows("name"));
+}
+
+TEST(AnnotationAllowlist, Names) {
+  internal::AnnotationAllowlist allowlist({"ptype", "pid", "ver", "pid"});
+  EXPECT_TRUE(allowlist.Allows("ptype"));
+  EXPECT_TRUE(allowlist.Allows("pid"));
+  EXPECT_TRUE(allowlist.Allows("ver"));
+  EXPECT_FALSE(allowlist.Allows("pi"));
+  EXPECT_FALSE(allowlist.Allows("pids"));
+  EXPECT_FALSE(allowlist.Allows(""));
+}
+
+TEST(AnnotationAllowlist, Patterns) {
+  internal::AnnotationAllowlist allowlist(
+      {"switch-*", "gpu-?", "*-suffix", "exact"});
+  EXPECT_TRUE(allowlist.Allows("switch-"));
+  EXPECT_TRUE(allowlist.Allows("switch-1"));
+  EXPECT_TRUE(allowlist.Allows("switch-123"));
+  EXPECT_FALSE(allowlist.Allows("switch"));
+  EXPECT_TRUE(allowlist.Allows("gpu-a"));
+  EXPECT_FALSE(allowlist.Allows("gpu-"));
+  EXPECT_FALSE(allowlist.Allows("gpu-ab"));
+  EXPECT_TRUE(allowlist.Allows("name-suffix"));
+  EXPECT_TRUE(allowlist.Allows("-suffix"));
+  EXPECT_FALSE(allowlist.Allows("name-suffixes"));
+  EXPECT_TRUE(allowlist.Allows("exact"));
+  EXPECT_FALSE(allowlist.Allows("exact1"));
+  EXPECT_FALSE(allowlist.Allows("zzz"));
+}
+
+TEST(AnnotationAllowlist, PatternsSharingPrefixes) {
+  internal::AnnotationAllowlist allowlist({"a*z", "ab*y", "abc*x"});
+  EXPECT_TRUE(allowlist.Allows("az"));
+  EXPECT_TRUE(allowlist.Allows("abcz"));
+  EXPECT_TRUE(allowlist.Allows("aby"));
+  EXPECT_TRUE(allowlist.Allows("abcdy"));
+  EXPECT_TRUE(allowlist.Allows("abcx"));
+  EXPECT_FALSE(allowlist.Allows("abx"));
+  EXPECT_FALSE(allowlist.Allows("bz"));
+}
+
+TEST(AnnotationAllowlist, Escapes) {
+  internal::AnnotationAllowlist allowlist({"star\\*"});
+  EXPECT_TRUE(allowlist.Allows("star*"));
+  EXPECT_FALSE(allowlist.Allows("stars"));
+}
+
+TEST(AnnotationAllowlist, AllowAll) {
+  internal::AnnotationAllowlist allowlist({"name", "*"});
+  EXPECT_TRUE(allowlist.Allows(""));
+  EXPECT_TRUE(allowlist.Allows("anything"));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -16,6 +16,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "util/linux/pac_helper.h"
 
 namespace crashpad {
@@ -45,6 +47,9 @@ class MemorySanitizer : public MemorySnapshot::Delegate {
     } else {
       Sanitize<uint32_t>(data, size);
     }
+
+    // When reading in chunks, the next call continues where this one left off.
+    address_ += size;
     return delegate_->MemorySnapshotDelegateRead(data, size);
   }
 
@@ -63,10 +68,18 @@ class MemorySanitizer : public MemorySnapshot::Delegate {
     size_t word_count = (size - aligned_offset) / sizeof(Pointer);
     auto words =
         reinterpret_cast<Pointer*>(static_cast<char*>(data) + aligned_offset);
+    // Pointers found in memory tend to cluster in a few ranges, so the most
+    // recently found range is tested before searching the set.
+    VMAddress range_base = 1;
+    VMAddress range_last = 0;
+    const VMAddress pac_mask = PACAddressMask();
     for (size_t index = 0; index < word_count; ++index) {
-      auto word = StripPACBits(words[index]);
-      if (word > MemorySnapshotSanitized::kSmallWordMax &&
-          !ranges_->Contains(word)) {
+      auto word = StripPACBitsWithMask(words[index], pac_mask);
+      if (word <= MemorySnapshotSanitized::kSmallWordMax ||
+          (word >= range_base && word <= range_last)) {
+        continue;
+      }
+      if (!ranges_->Find(word, &range_base, &range_last)) {
         words[index] = defaced;
       }
     }
@@ -107,5 +120,21 @@ bool MemorySnapshotSanitized::Read(Delegate* delegate) const {
   return snapshot_->Read(&sanitizer);
 }
 
+bool MemorySnapshotSanitized::ReadChunked(Delegate* delegate,
+                                          size_t max_chunk_size) const {
+  // Each chunk is sanitized on its own, so a pointer spanning two chunks
+  // would be redacted even if it’s allowed. Chunks are kept to a multiple of
+  // the pointer size, which is only enough when the region itself is aligned.
+  const size_t pointer_size = is_64_bit_ ? sizeof(uint64_t) : sizeof(uint32_t);
+  if (Address() % pointer_size != 0) {
+    return Read(delegate);
+  }
+
+  MemorySanitizer sanitizer(delegate, ranges_, Address(), is_64_bit_);
+  return snapshot_->ReadChunked(
+      &sanitizer,
+      std::max(max_chunk_size - max_chunk_size % pointer_size, pointer_size));
+}
+
 }  // namespace internal
 }  // namespace crashpad
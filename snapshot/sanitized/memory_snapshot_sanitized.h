@@ -57,6 +57,7 @@ class MemorySnapshotSanitized final : public MemorySnapshot {
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool ReadChunked(Delegate* delegate, size_t max_chunk_size) const override;
 
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override {
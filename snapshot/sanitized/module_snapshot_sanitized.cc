@@ -14,28 +14,12 @@
 
 #include "snapshot/sanitized/module_snapshot_sanitized.h"
 
-#include "base/strings/pattern.h"
-
 namespace crashpad {
 namespace internal {
 
-namespace {
-
-bool KeyIsAllowed(const std::string& name,
-                  const std::vector<std::string>& allowed_keys) {
-  for (const auto& key : allowed_keys) {
-    if (base::MatchPattern(name, key)) {
-      return true;
-    }
-  }
-  return false;
-}
-
-}  // namespace
-
 ModuleSnapshotSanitized::ModuleSnapshotSanitized(
     const ModuleSnapshot* snapshot,
-    const std::vector<std::string>* allowed_annotations)
+    const AnnotationAllowlist* allowed_annotations)
     : snapshot_(snapshot), allowed_annotations_(allowed_annotations) {}
 
 ModuleSnapshotSanitized::~ModuleSnapshotSanitized() = default;
@@ -100,7 +84,7 @@ ModuleSnapshotSanitized::AnnotationsSimpleMap() const {
       snapshot_->AnnotationsSimpleMap();
   if (allowed_annotations_) {
     for (auto kv = annotations.begin(); kv != annotations.end();) {
-      if (KeyIsAllowed(kv->first, *allowed_annotations_)) {
+      if (allowed_annotations_->Allows(kv->first)) {
         ++kv;
       } else {
         kv = annotations.erase(kv);
@@ -116,7 +100,7 @@ std::vector<AnnotationSnapshot> ModuleSnapshotSanitized::AnnotationObjects()
   if (allowed_annotations_) {
     std::vector<AnnotationSnapshot> allowed;
     for (const auto& anno : annotations) {
-      if (KeyIsAllowed(anno.name, *allowed_annotations_)) {
+      if (allowed_annotations_->Allows(anno.name)) {
         allowed.push_back(anno);
       }
     }
@@ -127,7 +111,9 @@ std::vector<AnnotationSnapshot> ModuleSnapshotSanitized::AnnotationObjects()
 
 std::set<CheckedRange<uint64_t>> ModuleSnapshotSanitized::ExtraMemoryRanges()
     const {
-  DCHECK(snapshot_->ExtraMemoryRanges().empty());
+  // Process snapshots capture these ranges in their ExtraMemory(), and
+  // ProcessSnapshotSanitized::ExtraMemory() filters them against the memory
+  // allowlist. They aren't reported again here, unsanitized.
   return std::set<CheckedRange<uint64_t>>();
 }
 
@@ -61,8 +61,9 @@ class StackReferencesAddressRange : public MemorySnapshot::Delegate {
     auto words = reinterpret_cast<Pointer*>(static_cast<char*>(data) +
                                             aligned_sp_offset);
     size_t word_count = (size - aligned_sp_offset) / sizeof(Pointer);
+    const VMAddress pac_mask = PACAddressMask();
     for (size_t index = 0; index < word_count; ++index) {
-      auto word = StripPACBits(words[index]);
+      auto word = StripPACBitsWithMask(words[index], pac_mask);
       if (word >= low_ && word < high_) {
         return true;
       }
@@ -142,9 +143,11 @@ bool ProcessSnapshotSanitized::Initialize(
   }
 
   if (allowed_annotations_) {
+    annotation_allowlist_ =
+        std::make_unique<internal::AnnotationAllowlist>(*allowed_annotations_);
     for (const auto module : snapshot_->Modules()) {
       modules_.emplace_back(std::make_unique<internal::ModuleSnapshotSanitized>(
-          module, allowed_annotations_.get()));
+          module, annotation_allowlist_.get()));
     }
   }
 
@@ -265,7 +268,15 @@ std::vector<HandleSnapshot> ProcessSnapshotSanitized::Handles() const {
 std::vector<const MemorySnapshot*> ProcessSnapshotSanitized::ExtraMemory()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return snapshot_->ExtraMemory();
+  // The wrapped snapshot reads this memory without sanitization, so only
+  // regions that the memory allowlist covers entirely are kept.
+  std::vector<const MemorySnapshot*> extra_memory;
+  for (const MemorySnapshot* memory : snapshot_->ExtraMemory()) {
+    if (process_memory_.IsAllowed(memory->Address(), memory->Size())) {
+      extra_memory.push_back(memory);
+    }
+  }
+  return extra_memory;
 }
 
 const ProcessMemory* ProcessSnapshotSanitized::Memory() const {
@@ -21,6 +21,7 @@
 
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/process_snapshot.h"
+#include "snapshot/sanitized/annotation_allowlist.h"
 #include "snapshot/sanitized/module_snapshot_sanitized.h"
 #include "snapshot/sanitized/thread_snapshot_sanitized.h"
 #include "snapshot/thread_snapshot.h"
@@ -107,6 +108,7 @@ class ProcessSnapshotSanitized final : public ProcessSnapshot {
   const ProcessSnapshot* snapshot_;
   ProcessMemorySanitized process_memory_;
   std::unique_ptr<const std::vector<std::string>> allowed_annotations_;
+  std::unique_ptr<internal::AnnotationAllowlist> annotation_allowlist_;
   bool sanitize_stacks_;
   InitializationStateDcheck initialized_;
 };
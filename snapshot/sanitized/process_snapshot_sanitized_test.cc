@@ -17,10 +17,15 @@
 #include <string.h>
 
 #include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/notreached.h"
 #include "build/build_config.h"
 #include "gtest/gtest.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
 #include "test/multiprocess_exec.h"
 #include "util/file/file_io.h"
 #include "util/misc/address_sanitizer.h"
@@ -322,6 +327,42 @@ TEST(ProcessSnapshotSanitized, Sanitize) {
   test.Run();
 }
 
+TEST(ProcessSnapshotSanitized, ExtraMemory) {
+  TestProcessSnapshot snapshot;
+  auto allowed = std::make_unique<TestMemorySnapshot>();
+  allowed->SetAddress(0x1000);
+  allowed->SetSize(0x100);
+  const MemorySnapshot* allowed_memory = allowed.get();
+  snapshot.AddExtraMemory(std::move(allowed));
+  auto straddling = std::make_unique<TestMemorySnapshot>();
+  straddling->SetAddress(0x1f80);
+  straddling->SetSize(0x100);
+  snapshot.AddExtraMemory(std::move(straddling));
+  auto disallowed = std::make_unique<TestMemorySnapshot>();
+  disallowed->SetAddress(0x3000);
+  disallowed->SetSize(0x100);
+  snapshot.AddExtraMemory(std::move(disallowed));
+
+  // Only memory that lies entirely within an allowed range is kept.
+  auto allowed_memory_ranges =
+      std::make_unique<std::vector<std::pair<VMAddress, VMAddress>>>();
+  allowed_memory_ranges->push_back({0x1000, 0x2000});
+  ProcessSnapshotSanitized sanitized;
+  ASSERT_TRUE(sanitized.Initialize(&snapshot,
+                                   nullptr,
+                                   std::move(allowed_memory_ranges),
+                                   0,
+                                   false));
+  std::vector<const MemorySnapshot*> extra_memory = sanitized.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 1u);
+  EXPECT_EQ(extra_memory[0], allowed_memory);
+
+  // Without an allowlist, none is.
+  ProcessSnapshotSanitized unlisted;
+  ASSERT_TRUE(unlisted.Initialize(&snapshot, nullptr, nullptr, 0, false));
+  EXPECT_TRUE(unlisted.ExtraMemory().empty());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -63,5 +63,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotSanitized::ExtraMemory()
   return std::vector<const MemorySnapshot*>();
 }
 
+std::vector<uint8_t> ThreadSnapshotSanitized::Breadcrumbs() const {
+  // Breadcrumbs are arbitrary client data, which can't be sanitized.
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotSanitized::UnwoundFrames() const {
+  // Like the context, the frames only hold register values.
+  return snapshot_->UnwoundFrames();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -0,0 +1,91 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/shallow_module_filter.h"
+
+#include <utility>
+
+namespace crashpad {
+
+namespace {
+
+bool HexDigitValue(char c, uint8_t* value) {
+  if (c >= '0' && c <= '9') {
+    *value = c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    *value = c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    *value = c - 'A' + 10;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+ShallowModuleFilter::ShallowModuleFilter() : build_ids_(), path_prefixes_() {}
+
+ShallowModuleFilter::~ShallowModuleFilter() = default;
+
+void ShallowModuleFilter::AddBuildID(const std::vector<uint8_t>& build_id) {
+  if (!build_id.empty()) {
+    build_ids_.insert(build_id);
+  }
+}
+
+bool ShallowModuleFilter::AddBuildIDString(const std::string& build_id_hex) {
+  if (build_id_hex.empty() || build_id_hex.size() % 2 != 0) {
+    return false;
+  }
+
+  std::vector<uint8_t> build_id;
+  build_id.reserve(build_id_hex.size() / 2);
+  for (size_t index = 0; index < build_id_hex.size(); index += 2) {
+    uint8_t high;
+    uint8_t low;
+    if (!HexDigitValue(build_id_hex[index], &high) ||
+        !HexDigitValue(build_id_hex[index + 1], &low)) {
+      return false;
+    }
+    build_id.push_back((high << 4) | low);
+  }
+
+  build_ids_.insert(std::move(build_id));
+  return true;
+}
+
+void ShallowModuleFilter::AddPathPrefix(const std::string& path_prefix) {
+  // An empty prefix would select every module, which is never what was meant.
+  if (!path_prefix.empty()) {
+    path_prefixes_.push_back(path_prefix);
+  }
+}
+
+bool ShallowModuleFilter::MatchesPath(const std::string& path) const {
+  for (const std::string& prefix : path_prefixes_) {
+    if (path.compare(0, prefix.size(), prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ShallowModuleFilter::Matches(const std::string& path,
+                                  const std::vector<uint8_t>& build_id) const {
+  return MatchesPath(path) ||
+         (!build_id.empty() && build_ids_.find(build_id) != build_ids_.end());
+}
+
+}  // namespace crashpad
@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_SHALLOW_MODULE_FILTER_H_
+#define CRASHPAD_SNAPSHOT_SHALLOW_MODULE_FILTER_H_
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Selects modules that snapshots capture shallowly.
+//!
+//! A shallow module snapshot records only the module’s identity: its name,
+//! address range, and build ID or debug record. Its annotations, CrashpadInfo
+//! structure, version information, and extra memory ranges aren’t read.
+//! System libraries usually make up most of a process’ modules and have none
+//! of these, so treating them as shallow saves searching each of them at
+//! capture time.
+//!
+//! Modules are selected by exact build ID or by a prefix of their path. This
+//! class isn’t thread-safe while being modified, but may be shared by
+//! concurrent snapshots once populated.
+class ShallowModuleFilter {
+ public:
+  ShallowModuleFilter();
+
+  ShallowModuleFilter(const ShallowModuleFilter&) = delete;
+  ShallowModuleFilter& operator=(const ShallowModuleFilter&) = delete;
+
+  ~ShallowModuleFilter();
+
+  //! \brief Selects the module with build ID \a build_id.
+  void AddBuildID(const std::vector<uint8_t>& build_id);
+
+  //! \brief Selects the module with a build ID given as a string of
+  //!     hexadecimal digits, such as is printed by `readelf -n`.
+  //!
+  //! \return `true` on success. `false` if \a build_id_hex is empty or not an
+  //!     even number of hexadecimal digits, with nothing added.
+  bool AddBuildIDString(const std::string& build_id_hex);
+
+  //! \brief Selects modules whose path begins with \a path_prefix.
+  //!
+  //! The comparison is case-sensitive, and matches strings rather than path
+  //! components, so that `/usr/lib` selects `/usr/lib64/libc.so.6` as well.
+  void AddPathPrefix(const std::string& path_prefix);
+
+  //! \return `true` if no module is selected.
+  bool empty() const { return build_ids_.empty() && path_prefixes_.empty(); }
+
+  //! \return `true` if any build IDs have been added. When `false`,
+  //!     MatchesPath() alone decides whether a module is selected, so callers
+  //!     needn’t read its build ID.
+  bool HasBuildIDs() const { return !build_ids_.empty(); }
+
+  //! \return `true` if \a path begins with any added path prefix.
+  bool MatchesPath(const std::string& path) const;
+
+  //! \return `true` if the module at \a path with build ID \a build_id is
+  //!     selected. An empty \a build_id never matches an added build ID.
+  bool Matches(const std::string& path,
+               const std::vector<uint8_t>& build_id) const;
+
+ private:
+  std::set<std::vector<uint8_t>> build_ids_;
+  std::vector<std::string> path_prefixes_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_SHALLOW_MODULE_FILTER_H_
@@ -0,0 +1,80 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/shallow_module_filter.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ShallowModuleFilter, Empty) {
+  ShallowModuleFilter filter;
+  EXPECT_TRUE(filter.empty());
+  EXPECT_FALSE(filter.HasBuildIDs());
+  EXPECT_FALSE(filter.Matches("/lib/libc.so.6", {0xde, 0xad}));
+  EXPECT_FALSE(filter.Matches("", {}));
+
+  // Empty values aren’t added.
+  filter.AddPathPrefix("");
+  filter.AddBuildID({});
+  EXPECT_TRUE(filter.empty());
+}
+
+TEST(ShallowModuleFilter, PathPrefix) {
+  ShallowModuleFilter filter;
+  filter.AddPathPrefix("/usr/lib");
+  filter.AddPathPrefix("/system/");
+  EXPECT_FALSE(filter.empty());
+  EXPECT_FALSE(filter.HasBuildIDs());
+
+  EXPECT_TRUE(filter.MatchesPath("/usr/lib/libc.so.6"));
+  EXPECT_TRUE(filter.MatchesPath("/usr/lib64/libm.so.6"));
+  EXPECT_TRUE(filter.MatchesPath("/system/lib64/libc.so"));
+  EXPECT_FALSE(filter.MatchesPath("/system"));
+  EXPECT_FALSE(filter.MatchesPath("/usr/li"));
+  EXPECT_FALSE(filter.MatchesPath("/opt/app/libapp.so"));
+  EXPECT_FALSE(filter.MatchesPath("/USR/LIB/libc.so.6"));
+  EXPECT_TRUE(filter.Matches("/usr/lib/libc.so.6", {}));
+  EXPECT_FALSE(filter.Matches("/opt/app/libapp.so", {0x01}));
+}
+
+TEST(ShallowModuleFilter, BuildID) {
+  ShallowModuleFilter filter;
+  filter.AddBuildID({0x01, 0x02, 0x03});
+  EXPECT_TRUE(filter.HasBuildIDs());
+
+  EXPECT_TRUE(filter.Matches("/opt/app/libapp.so", {0x01, 0x02, 0x03}));
+  EXPECT_FALSE(filter.Matches("/opt/app/libapp.so", {0x01, 0x02}));
+  EXPECT_FALSE(filter.Matches("/opt/app/libapp.so", {0x01, 0x02, 0x03, 0x04}));
+  EXPECT_FALSE(filter.Matches("/opt/app/libapp.so", {}));
+  EXPECT_FALSE(filter.MatchesPath("/opt/app/libapp.so"));
+}
+
+TEST(ShallowModuleFilter, BuildIDString) {
+  ShallowModuleFilter filter;
+  EXPECT_TRUE(filter.AddBuildIDString("0aFf10"));
+  EXPECT_TRUE(filter.Matches("", {0x0a, 0xff, 0x10}));
+
+  EXPECT_FALSE(filter.AddBuildIDString(""));
+  EXPECT_FALSE(filter.AddBuildIDString("abc"));
+  EXPECT_FALSE(filter.AddBuildIDString("0g"));
+  EXPECT_FALSE(filter.AddBuildIDString("0x01"));
+  EXPECT_FALSE(filter.Matches("", {0x01}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
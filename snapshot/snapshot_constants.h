@@ -23,6 +23,18 @@ namespace crashpad {
 //! \note This maximum was chosen arbitrarily and may change in the future.
 constexpr size_t kMaxNumberOfAnnotations = 400;
 
+//! \brief The maximum number of per-thread breadcrumb buffers that will be read
+//!     from a client process.
+//!
+//! \note This maximum was chosen arbitrarily and may change in the future.
+constexpr size_t kMaxNumberOfThreadBreadcrumbBuffers = 1024;
+
+//! \brief The maximum capacity, in bytes, of a per-thread breadcrumb buffer
+//!     that will be read from a client process.
+//!
+//! \note This maximum was chosen arbitrarily and may change in the future.
+constexpr size_t kMaxThreadBreadcrumbBufferCapacity = 64 * 1024;
+
 }  // namespace crashpad
 
 #endif  // SNAPSHOT_SNAPSHOT_CONSTANTS_H_
@@ -0,0 +1,150 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/test/synthetic_process_snapshot.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "snapshot/annotation_snapshot.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_map_region_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+
+namespace crashpad {
+namespace test {
+
+namespace {
+
+// Returns the distance between the starts of consecutive regions of size
+// bytes, leaving at least a page between them.
+uint64_t RegionStride(uint64_t size) {
+  return (size + 2 * 0x1000 - 1) & ~uint64_t{0xfff};
+}
+
+}  // namespace
+
+std::unique_ptr<TestProcessSnapshot> BuildSyntheticProcessSnapshot(
+    const SyntheticProcessSnapshotShape& shape) {
+  auto process_snapshot = std::make_unique<TestProcessSnapshot>();
+  process_snapshot->SetProcessID(1234);
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot->SetSystem(std::move(system_snapshot));
+
+  constexpr uint64_t kStackBase = 0x7f0000000000;
+  const uint64_t stack_stride = RegionStride(shape.stack_size);
+  auto thread_id = [&shape](unsigned int index) {
+    return shape.colliding_thread_ids ? (uint64_t{index} << 32) | 1
+                                      : uint64_t{index} + 1;
+  };
+  for (unsigned int index = 0; index < shape.threads; ++index) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    InitializeCPUContextX86_64(thread_snapshot->MutableContext(), index);
+    thread_snapshot->SetThreadID(thread_id(index));
+    thread_snapshot->SetThreadName(base::StringPrintf("thread %u", index));
+
+    auto stack = std::make_unique<TestMemorySnapshot>();
+    stack->SetAddress(kStackBase + index * stack_stride);
+    stack->SetSize(shape.stack_size);
+    stack->SetValue('s');
+    thread_snapshot->SetStack(std::move(stack));
+    process_snapshot->AddThread(std::move(thread_snapshot));
+  }
+
+  if (shape.threads > 0) {
+    auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+    InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 0);
+    exception_snapshot->SetThreadID(thread_id(0));
+    exception_snapshot->SetException(11);
+    process_snapshot->SetException(std::move(exception_snapshot));
+  }
+
+  constexpr uint64_t kModuleBase = 0x550000000000;
+  constexpr uint64_t kModuleSize = 0x100000;
+  for (unsigned int index = 0; index < shape.modules; ++index) {
+    auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+    module_snapshot->SetName(
+        base::StringPrintf("/system/lib/libbenchmark_%u.so", index));
+    module_snapshot->SetAddressAndSize(kModuleBase + index * kModuleSize,
+                                       kModuleSize);
+    module_snapshot->SetModuleType(ModuleSnapshot::kModuleTypeSharedLibrary);
+    std::vector<uint8_t> build_id(20);
+    for (size_t byte = 0; byte < build_id.size(); ++byte) {
+      build_id[byte] = static_cast<uint8_t>(index + byte);
+    }
+    module_snapshot->SetBuildID(build_id);
+
+    std::map<std::string, std::string> simple_annotations;
+    for (unsigned int annotation = 0; annotation < shape.simple_annotations;
+         ++annotation) {
+      simple_annotations[base::StringPrintf("key %u", annotation)] =
+          base::StringPrintf("value %u of module %u", annotation, index);
+    }
+    module_snapshot->SetAnnotationsSimpleMap(simple_annotations);
+
+    std::vector<AnnotationSnapshot> annotation_objects;
+    for (unsigned int annotation = 0; annotation < shape.annotation_objects;
+         ++annotation) {
+      const std::string value(
+          base::StringPrintf("object %u of module %u", annotation, index));
+      // 1 is Annotation::Type::kString.
+      annotation_objects.emplace_back(
+          base::StringPrintf("object %u", annotation),
+          1,
+          std::vector<uint8_t>(value.begin(), value.end()));
+    }
+    module_snapshot->SetAnnotationObjects(annotation_objects);
+    process_snapshot->AddModule(std::move(module_snapshot));
+  }
+
+  constexpr uint64_t kExtraMemoryBase = 0x100000000;
+  const uint64_t extra_memory_stride = RegionStride(shape.extra_memory_size);
+  for (unsigned int index = 0; index < shape.extra_memory; ++index) {
+    auto extra_memory = std::make_unique<TestMemorySnapshot>();
+    extra_memory->SetAddress(kExtraMemoryBase + index * extra_memory_stride);
+    extra_memory->SetSize(shape.extra_memory_size);
+    extra_memory->SetValue('m');
+    process_snapshot->AddExtraMemory(std::move(extra_memory));
+  }
+
+  constexpr uint64_t kMemoryMapBase = 0x200000000000;
+  for (unsigned int index = 0; index < shape.memory_map_regions; ++index) {
+    MINIDUMP_MEMORY_INFO memory_info = {};
+    memory_info.BaseAddress = kMemoryMapBase + index * uint64_t{0x10000};
+    memory_info.AllocationBase = memory_info.BaseAddress;
+    memory_info.AllocationProtect = PAGE_READWRITE;
+    memory_info.RegionSize = 0x10000;
+    memory_info.State = MEM_COMMIT;
+    memory_info.Protect = PAGE_READWRITE;
+    memory_info.Type = MEM_PRIVATE;
+    auto region = std::make_unique<TestMemoryMapRegionSnapshot>();
+    region->SetMindumpMemoryInfo(memory_info);
+    process_snapshot->AddMemoryMapRegion(std::move(region));
+  }
+
+  return process_snapshot;
+}
+
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,72 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_TEST_SYNTHETIC_PROCESS_SNAPSHOT_H_
+#define CRASHPAD_SNAPSHOT_TEST_SYNTHETIC_PROCESS_SNAPSHOT_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "snapshot/test/test_process_snapshot.h"
+
+namespace crashpad {
+namespace test {
+
+//! \brief The shape of a process snapshot built by
+//!     BuildSyntheticProcessSnapshot().
+struct SyntheticProcessSnapshotShape {
+  //! \brief The number of threads. If there are any, the first has an
+  //!     exception.
+  unsigned int threads;
+
+  //! \brief The size of each thread’s stack, in bytes.
+  size_t stack_size;
+
+  //! \brief Whether to give threads 64-bit IDs whose low 32 bits collide, so
+  //!     that a minidump writer must renumber them.
+  bool colliding_thread_ids;
+
+  //! \brief The number of modules.
+  unsigned int modules;
+
+  //! \brief The number of simple annotations given to each module.
+  unsigned int simple_annotations;
+
+  //! \brief The number of annotation objects given to each module.
+  unsigned int annotation_objects;
+
+  //! \brief The number of extra memory regions.
+  unsigned int extra_memory;
+
+  //! \brief The size of each extra memory region, in bytes.
+  size_t extra_memory_size;
+
+  //! \brief The number of memory map regions.
+  unsigned int memory_map_regions;
+};
+
+//! \brief Builds an x86_64 Linux process snapshot of the given shape, for
+//!     benchmarks that measure how the cost of handling a snapshot grows with
+//!     its parts.
+//!
+//! No two memory regions in the snapshot are adjacent, so that none are
+//! merged when the snapshot is written as a minidump.
+std::unique_ptr<TestProcessSnapshot> BuildSyntheticProcessSnapshot(
+    const SyntheticProcessSnapshotShape& shape);
+
+}  // namespace test
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_TEST_SYNTHETIC_PROCESS_SNAPSHOT_H_
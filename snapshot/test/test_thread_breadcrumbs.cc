@@ -0,0 +1,39 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/test/test_thread_breadcrumbs.h"
+
+#include "client/length_delimited_ring_buffer.h"
+
+namespace crashpad {
+namespace test {
+
+bool DecodeThreadBreadcrumbs(const void* data,
+                             size_t size,
+                             std::vector<std::string>* breadcrumbs) {
+  breadcrumbs->clear();
+  LengthDelimitedRingBufferContents contents;
+  if (!contents.Initialize(data, size)) {
+    return false;
+  }
+  breadcrumbs->reserve(contents.size());
+  for (size_t index = 0; index < contents.size(); ++index) {
+    const base::span<const uint8_t> item = contents[index];
+    breadcrumbs->emplace_back(item.begin(), item.end());
+  }
+  return true;
+}
+
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,42 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_TEST_TEST_THREAD_BREADCRUMBS_H_
+#define CRASHPAD_SNAPSHOT_TEST_TEST_THREAD_BREADCRUMBS_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+namespace crashpad {
+namespace test {
+
+//! \brief Decodes the breadcrumbs in a serialized ThreadBreadcrumbList buffer.
+//!
+//! \param[in] data The serialized `RingBufferData` of a buffer, as in a
+//!     ThreadBreadcrumbList::Buffer or as read by ThreadBreadcrumbReader.
+//! \param[in] size The length in bytes of \a data.
+//! \param[out] breadcrumbs The breadcrumbs, oldest first.
+//!
+//! \return `true` if \a data holds a valid `RingBufferData`, `false`
+//!     otherwise.
+bool DecodeThreadBreadcrumbs(const void* data,
+                             size_t size,
+                             std::vector<std::string>* breadcrumbs);
+
+}  // namespace test
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_TEST_TEST_THREAD_BREADCRUMBS_H_
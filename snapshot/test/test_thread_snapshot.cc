@@ -67,5 +67,13 @@ std::vector<const MemorySnapshot*> TestThreadSnapshot::ExtraMemory() const {
   return extra_memory;
 }
 
+std::vector<uint8_t> TestThreadSnapshot::Breadcrumbs() const {
+  return breadcrumbs_;
+}
+
+std::vector<UnwoundStackFrame> TestThreadSnapshot::UnwoundFrames() const {
+  return unwound_frames_;
+}
+
 }  // namespace test
 }  // namespace crashpad
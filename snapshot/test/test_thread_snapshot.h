@@ -82,6 +82,14 @@ class TestThreadSnapshot final : public ThreadSnapshot {
     extra_memory_.push_back(std::move(extra_memory));
   }
 
+  void SetBreadcrumbs(const std::vector<uint8_t>& breadcrumbs) {
+    breadcrumbs_ = breadcrumbs;
+  }
+
+  void SetUnwoundFrames(const std::vector<UnwoundStackFrame>& frames) {
+    unwound_frames_ = frames;
+  }
+
   // ThreadSnapshot:
 
   const CPUContext* Context() const override;
@@ -92,6 +100,8 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  std::vector<uint8_t> Breadcrumbs() const override;
+  std::vector<UnwoundStackFrame> UnwoundFrames() const override;
 
  private:
   union {
@@ -106,6 +116,8 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int priority_;
   uint64_t thread_specific_data_address_;
   std::vector<std::unique_ptr<MemorySnapshot>> extra_memory_;
+  std::vector<uint8_t> breadcrumbs_;
+  std::vector<UnwoundStackFrame> unwound_frames_;
 };
 
 }  // namespace test
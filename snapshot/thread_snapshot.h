@@ -25,6 +25,17 @@ namespace crashpad {
 struct CPUContext;
 class MemorySnapshot;
 
+//! \brief A stack frame found by unwinding a thread’s stack while capturing
+//!     it.
+struct UnwoundStackFrame {
+  //! \brief The instruction pointer in the frame. For every frame but the
+  //!     innermost, this is the return address into the frame.
+  uint64_t instruction_pointer;
+
+  //! \brief The stack pointer in the frame.
+  uint64_t stack_pointer;
+};
+
 //! \brief An abstract interface to a snapshot representing a thread
 //!     (lightweight process) present in a snapshot process.
 class ThreadSnapshot {
@@ -77,6 +88,22 @@ class ThreadSnapshot {
   //!     are scoped to the lifetime of the ThreadSnapshot object that they
   //!     were obtained from.
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const = 0;
+
+  //! \brief Returns the contents of the thread’s breadcrumb buffer.
+  //!
+  //! \return The serialized RingBufferData of the ThreadBreadcrumbList buffer
+  //!     owned by the thread, suitable for reading with
+  //!     LengthDelimitedRingBufferReader, or an empty vector if the thread did
+  //!     not own a buffer.
+  virtual std::vector<uint8_t> Breadcrumbs() const = 0;
+
+  //! \brief Returns the frames found by unwinding the thread’s stack while
+  //!     it was captured.
+  //!
+  //! \return The frames, innermost first, or an empty vector if the stack was
+  //!     not unwound. The frames may stop short of the outermost frame if
+  //!     unwinding failed.
+  virtual std::vector<UnwoundStackFrame> UnwoundFrames() const = 0;
 };
 
 }  // namespace crashpad
@@ -14,8 +14,11 @@
 
 #include "snapshot/win/module_snapshot_win.h"
 
+#include <string.h>
+
 #include <utility>
 
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "client/crashpad_info.h"
 #include "client/simple_address_range_bag.h"
@@ -48,7 +51,8 @@ ModuleSnapshotWin::~ModuleSnapshotWin() {}
 
 bool ModuleSnapshotWin::Initialize(
     ProcessReaderWin* process_reader,
-    const ProcessInfo::Module& process_reader_module) {
+    const ProcessInfo::Module& process_reader_module,
+    ModuleMetadataCache* metadata_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_reader_ = process_reader;
@@ -62,18 +66,49 @@ bool ModuleSnapshotWin::Initialize(
     return false;
   }
 
-  DWORD age_dword;
-  if (pe_image_reader_->DebugDirectoryInformation(
-          &uuid_, &age_dword, &pdb_name_)) {
-    static_assert(sizeof(DWORD) == sizeof(uint32_t), "unexpected age size");
-    age_ = age_dword;
+  if (metadata_cache) {
+    ModuleMetadataCache::Key key;
+    key.path = base::WideToUTF8(name_);
+    key.file_identity = base::StringPrintf(
+        "%llx", static_cast<unsigned long long>(timestamp_));
+    key.size = process_reader_module.size;
+
+    std::shared_ptr<const ModuleMetadataCache::Metadata> metadata =
+        metadata_cache->Lookup(key);
+    if (metadata) {
+      uuid_ = metadata->uuid;
+      age_ = metadata->age;
+      pdb_name_ = metadata->debug_file_name;
+      initialized_vs_fixed_file_info_.set_invalid();
+      if (metadata->version_info.size() == sizeof(vs_fixed_file_info_)) {
+        memcpy(&vs_fixed_file_info_,
+               metadata->version_info.data(),
+               sizeof(vs_fixed_file_info_));
+        initialized_vs_fixed_file_info_.set_valid();
+      }
+    } else {
+      ReadDebugDirectoryInformation();
+
+      ModuleMetadataCache::Metadata new_metadata;
+      new_metadata.uuid = uuid_;
+      new_metadata.age = age_;
+      new_metadata.debug_file_name = pdb_name_;
+
+      // The version resource is otherwise read lazily, but it’s read here so
+      // that later snapshots of this module don’t need to read it at all.
+      initialized_vs_fixed_file_info_.set_invalid();
+      if (pe_image_reader_->VSFixedFileInfo(&vs_fixed_file_info_)) {
+        initialized_vs_fixed_file_info_.set_valid();
+        const uint8_t* version_info =
+            reinterpret_cast<const uint8_t*>(&vs_fixed_file_info_);
+        new_metadata.version_info.assign(
+            version_info, version_info + sizeof(vs_fixed_file_info_));
+      }
+
+      metadata_cache->Insert(key, new_metadata);
+    }
   } else {
-    // If we fully supported all old debugging formats, we would want to extract
-    // and emit a different type of CodeView record here (as old Microsoft tools
-    // would do). As we don't expect to ever encounter a module that wouldn't be
-    // using .PDB that we actually have symbols for, we simply set a plausible
-    // name here, but this will never correspond to symbols that we have.
-    pdb_name_ = base::WideToUTF8(name_);
+    ReadDebugDirectoryInformation();
   }
 
   if (!memory_range_.Initialize(process_reader_->Memory(),
@@ -100,6 +135,22 @@ bool ModuleSnapshotWin::Initialize(
   return true;
 }
 
+void ModuleSnapshotWin::ReadDebugDirectoryInformation() {
+  DWORD age_dword;
+  if (pe_image_reader_->DebugDirectoryInformation(
+          &uuid_, &age_dword, &pdb_name_)) {
+    static_assert(sizeof(DWORD) == sizeof(uint32_t), "unexpected age size");
+    age_ = age_dword;
+  } else {
+    // If we fully supported all old debugging formats, we would want to extract
+    // and emit a different type of CodeView record here (as old Microsoft tools
+    // would do). As we don't expect to ever encounter a module that wouldn't be
+    // using .PDB that we actually have symbols for, we simply set a plausible
+    // name here, but this will never correspond to symbols that we have.
+    pdb_name_ = base::WideToUTF8(name_);
+  }
+}
+
 void ModuleSnapshotWin::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (process_reader_->Is64Bit())
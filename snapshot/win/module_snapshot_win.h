@@ -25,6 +25,7 @@
 
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/crashpad_types/crashpad_info_reader.h"
+#include "snapshot/module_metadata_cache.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/win/process_reader_win.h"
 #include "util/misc/initialization_state.h"
@@ -55,11 +56,15 @@ class ModuleSnapshotWin final : public ModuleSnapshot {
   //!     the module.
   //! \param[in] process_reader_module The module within the ProcessReaderWin
   //!     for which the snapshot should be created.
+  //! \param[in] metadata_cache An optional cache consulted for, and updated
+  //!     with, the module’s debug directory and version information, keyed by
+  //!     the module’s name, timestamp, and size.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(ProcessReaderWin* process_reader,
-                  const ProcessInfo::Module& process_reader_module);
+                  const ProcessInfo::Module& process_reader_module,
+                  ModuleMetadataCache* metadata_cache = nullptr);
 
   //! \brief Returns options from the module's CrashpadInfo structure.
   //!
@@ -111,6 +116,9 @@ class ModuleSnapshotWin final : public ModuleSnapshot {
   // on the first call.
   const VS_FIXEDFILEINFO* VSFixedFileInfo() const;
 
+  // Initializes uuid_, age_, and pdb_name_ from the image’s debug directory.
+  void ReadDebugDirectoryInformation();
+
   std::wstring name_;
   std::string pdb_name_;
   UUID uuid_;
@@ -17,15 +17,18 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <iterator>
 
 #include "base/logging.h"
 #include "base/strings/utf_string_conversions.h"
 #include "client/annotation.h"
+#include "client/annotation_list.h"
 #include "client/simple_string_dictionary.h"
 #include "snapshot/snapshot_constants.h"
 #include "snapshot/win/pe_image_reader.h"
 #include "snapshot/win/process_reader_win.h"
+#include "util/synchronization/seqlock.h"
 #include "util/win/process_structs.h"
 
 namespace crashpad {
@@ -39,6 +42,8 @@ struct Annotation {
   typename Traits::Pointer value;
   uint32_t size;
   uint16_t type;
+  uint8_t concurrent_access_guard_mode;
+  uint8_t guard_state;
 };
 
 template <class Traits>
@@ -48,8 +53,56 @@ struct AnnotationList {
   Annotation<Traits> tail;
 };
 
+template <class Traits>
+struct AnnotationListBlock {
+  typename Traits::Pointer next;
+  typename Traits::Pointer
+      annotations[crashpad::AnnotationList::Block::kCapacity];
+  uint32_t used;
+};
+
 }  // namespace process_types
 
+namespace {
+
+// Collects the addresses of the annotations in the registry whose first block
+// is at |address|, most recently added first.
+template <class Traits>
+bool ReadAnnotationRegistry(const ProcessMemoryWin* memory,
+                            WinVMAddress address,
+                            std::vector<WinVMAddress>* annotation_addresses) {
+  constexpr size_t kCapacity = AnnotationList::Block::kCapacity;
+  constexpr size_t kMaxBlocks =
+      (kMaxNumberOfAnnotations + kCapacity - 1) / kCapacity;
+
+  WinVMAddress block_address = address;
+  for (size_t block_index = 0;
+       block_address && block_index < kMaxBlocks &&
+       annotation_addresses->size() < kMaxNumberOfAnnotations;
+       ++block_index) {
+    process_types::AnnotationListBlock<Traits> block;
+    if (!memory->Read(block_address, sizeof(block), &block)) {
+      return false;
+    }
+
+    size_t used = std::min(static_cast<size_t>(block.used), kCapacity);
+    for (size_t slot = 0;
+         slot < used && annotation_addresses->size() < kMaxNumberOfAnnotations;
+         ++slot) {
+      if (block.annotations[slot]) {
+        annotation_addresses->push_back(block.annotations[slot]);
+      }
+    }
+
+    block_address = block.next;
+  }
+
+  std::reverse(annotation_addresses->begin(), annotation_addresses->end());
+  return true;
+}
+
+}  // namespace
+
 PEImageAnnotationsReader::PEImageAnnotationsReader(
     ProcessReaderWin* process_reader,
     const PEImageReader* pe_image_reader,
@@ -138,42 +191,112 @@ void PEImageAnnotationsReader::ReadCrashpadAnnotationsList(
     return;
   }
 
-  process_types::Annotation<Traits> current = annotation_list_object.head;
-  for (size_t index = 0;
-       current.link_node != annotation_list_object.tail_pointer &&
-       index < kMaxNumberOfAnnotations;
-       ++index) {
-    if (!process_reader_->Memory()->Read(
-            current.link_node, sizeof(current), &current)) {
-      LOG(WARNING) << "could not read annotation at index " << index << " in "
+  // Gather the annotation objects first, so that their names and values can
+  // all be read together.
+  std::vector<process_types::Annotation<Traits>> objects;
+  std::vector<WinVMAddress> annotation_addresses;
+  if (annotation_list_object.head.value &&
+      ReadAnnotationRegistry<Traits>(process_reader_->Memory(),
+                                     annotation_list_object.head.value,
+                                     &annotation_addresses)) {
+    objects.resize(annotation_addresses.size());
+    std::vector<ProcessMemory::ReadRequest> requests;
+    for (size_t index = 0; index < annotation_addresses.size(); ++index) {
+      requests.push_back({annotation_addresses[index],
+                          sizeof(objects[index]),
+                          &objects[index]});
+    }
+    if (!process_reader_->Memory()->ReadBatch(requests)) {
+      LOG(WARNING) << "could not read annotations in "
                    << base::WideToUTF8(name_);
       return;
     }
+  } else {
+    process_types::Annotation<Traits> current = annotation_list_object.head;
+    for (size_t index = 0;
+         current.link_node != annotation_list_object.tail_pointer &&
+         index < kMaxNumberOfAnnotations;
+         ++index) {
+      if (!process_reader_->Memory()->Read(
+              current.link_node, sizeof(current), &current)) {
+        LOG(WARNING) << "could not read annotation at index " << index
+                     << " in " << base::WideToUTF8(name_);
+        break;
+      }
+      objects.push_back(current);
+    }
+  }
 
-    if (current.size == 0) {
+  struct NameBuffer {
+    char name[Annotation::kNameMaxLength];
+  };
+  std::vector<NameBuffer> names;
+  std::vector<AnnotationSnapshot> snapshots;
+  std::vector<const process_types::Annotation<Traits>*> set_objects;
+  for (const auto& object : objects) {
+    if (object.size == 0) {
+      continue;
+    }
+
+    // A seqlock-guarded annotation whose sequence is odd in the suspended
+    // process has a partially written value, so leave it out.
+    if (object.concurrent_access_guard_mode ==
+            static_cast<uint8_t>(
+                Annotation::ConcurrentAccessGuardMode::kSeqlock) &&
+        !SeqlockState::IsStable(object.guard_state)) {
+      LOG(WARNING) << "skipping annotation being written in "
+                   << base::WideToUTF8(name_);
       continue;
     }
 
     AnnotationSnapshot snapshot;
-    snapshot.type = current.type;
+    snapshot.type = object.type;
+    snapshot.value.resize(
+        std::min(static_cast<size_t>(object.size), Annotation::kValueMaxSize));
+    snapshots.push_back(std::move(snapshot));
+    set_objects.push_back(&object);
+  }
+  names.resize(snapshots.size());
+
+  std::vector<ProcessMemory::ReadRequest> requests;
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    requests.push_back({set_objects[index]->name,
+                        sizeof(names[index].name),
+                        names[index].name});
+    requests.push_back({set_objects[index]->value,
+                        snapshots[index].value.size(),
+                        snapshots[index].value.data()});
+  }
+  if (process_reader_->Memory()->ReadBatch(requests)) {
+    for (size_t index = 0; index < snapshots.size(); ++index) {
+      const char* name = names[index].name;
+      snapshots[index].name =
+          std::string(name, strnlen(name, Annotation::kNameMaxLength));
+      vector_annotations->push_back(std::move(snapshots[index]));
+    }
+    return;
+  }
+
+  // Some name or value could not be read. Read each individually to salvage
+  // the rest.
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    AnnotationSnapshot& snapshot = snapshots[index];
+    const process_types::Annotation<Traits>& object = *set_objects[index];
 
     char name[Annotation::kNameMaxLength];
-    if (!process_reader_->Memory()->Read(current.name, std::size(name), name)) {
-      LOG(WARNING) << "could not read annotation name at index " << index
-                   << " in " << base::WideToUTF8(name_);
+    if (!process_reader_->Memory()->Read(object.name, std::size(name), name)) {
+      LOG(WARNING) << "could not read annotation name in "
+                   << base::WideToUTF8(name_);
       continue;
     }
 
     size_t name_length = strnlen(name, Annotation::kNameMaxLength);
     snapshot.name = std::string(name, name_length);
 
-    size_t value_length =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
-    snapshot.value.resize(value_length);
     if (!process_reader_->Memory()->Read(
-            current.value, value_length, snapshot.value.data())) {
-      LOG(WARNING) << "could not read annotation value at index " << index
-                   << " in " << base::WideToUTF8(name_);
+            object.value, snapshot.value.size(), snapshot.value.data())) {
+      LOG(WARNING) << "could not read annotation value in "
+                   << base::WideToUTF8(name_);
       continue;
     }
 
@@ -31,27 +31,13 @@
 
 namespace crashpad {
 
-namespace {
-
-// Map from Traits to an IMAGE_NT_HEADERSxx.
-template <class Traits>
-struct NtHeadersForTraits;
-
-template <>
-struct NtHeadersForTraits<process_types::internal::Traits32> {
-  using type = IMAGE_NT_HEADERS32;
-};
-
-template <>
-struct NtHeadersForTraits<process_types::internal::Traits64> {
-  using type = IMAGE_NT_HEADERS64;
-};
-
-}  // namespace
-
 PEImageReader::PEImageReader()
     : module_subrange_reader_(),
-      initialized_() {
+      sections_(),
+      section_indices_(),
+      data_directories_(),
+      initialized_(),
+      headers_initialized_() {
 }
 
 PEImageReader::~PEImageReader() {
@@ -90,8 +76,7 @@ bool PEImageReader::GetCrashpadInfo(
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   IMAGE_SECTION_HEADER section;
-  if (!GetSectionByName<typename NtHeadersForTraits<Traits>::type>("CPADinfo",
-                                                                   &section)) {
+  if (!GetSectionByName("CPADinfo", &section)) {
     return false;
   }
 
@@ -310,8 +295,7 @@ template <class Traits>
 bool PEImageReader::GetCrashpadInfoSectionInternal(WinVMAddress* address,
                                                    WinVMSize* size) const {
   IMAGE_SECTION_HEADER section;
-  if (!GetSectionByName<typename NtHeadersForTraits<Traits>::type>("CPADinfo",
-                                                                   &section)) {
+  if (!GetSectionByName("CPADinfo", &section)) {
     return false;
   }
 
@@ -368,73 +352,115 @@ bool PEImageReader::ReadNtHeaders(NtHeadersType* nt_headers,
   return true;
 }
 
-template <class NtHeadersType>
-bool PEImageReader::GetSectionByName(const std::string& name,
-                                     IMAGE_SECTION_HEADER* section) const {
-  if (name.size() > sizeof(section->Name)) {
-    LOG(WARNING) << "supplied section name too long " << name;
-    return false;
+void PEImageReader::InitializeHeaders() const {
+  DCHECK(headers_initialized_.is_uninitialized());
+  headers_initialized_.set_invalid();
+
+  bool rv;
+  if (module_subrange_reader_.Is64Bit()) {
+    rv = InitializeHeadersT<IMAGE_NT_HEADERS64>();
+  } else {
+    rv = InitializeHeadersT<IMAGE_NT_HEADERS32>();
+  }
+
+  if (!rv) {
+    sections_.clear();
+    section_indices_.clear();
+    data_directories_.clear();
+    return;
   }
 
+  headers_initialized_.set_valid();
+}
+
+template <class NtHeadersType>
+bool PEImageReader::InitializeHeadersT() const {
   NtHeadersType nt_headers;
   WinVMAddress nt_headers_address;
-  if (!ReadNtHeaders(&nt_headers, &nt_headers_address))
+  if (!ReadNtHeaders(&nt_headers, &nt_headers_address)) {
     return false;
+  }
+
+  // Only keep the data directory entries that fit within both the optional
+  // header and its declared NumberOfRvaAndSizes.
+  const size_t max_data_directories = std::min<size_t>(
+      nt_headers.OptionalHeader.NumberOfRvaAndSizes,
+      std::size(nt_headers.OptionalHeader.DataDirectory));
+  for (size_t index = 0; index < max_data_directories; ++index) {
+    if (nt_headers.FileHeader.SizeOfOptionalHeader <
+        offsetof(decltype(nt_headers.OptionalHeader), DataDirectory) +
+            sizeof(IMAGE_DATA_DIRECTORY) * (index + 1)) {
+      break;
+    }
+    data_directories_.push_back(nt_headers.OptionalHeader.DataDirectory[index]);
+  }
 
-  WinVMAddress first_section_address =
-      nt_headers_address + offsetof(NtHeadersType, OptionalHeader) +
-      nt_headers.FileHeader.SizeOfOptionalHeader;
-  for (DWORD i = 0; i < nt_headers.FileHeader.NumberOfSections; ++i) {
-    WinVMAddress section_address =
-        first_section_address + sizeof(IMAGE_SECTION_HEADER) * i;
+  // The section table is read with a single ReadMemory() call rather than one
+  // per section.
+  sections_.resize(nt_headers.FileHeader.NumberOfSections);
+  if (!sections_.empty()) {
+    const WinVMAddress first_section_address =
+        nt_headers_address + offsetof(NtHeadersType, OptionalHeader) +
+        nt_headers.FileHeader.SizeOfOptionalHeader;
     if (!module_subrange_reader_.ReadMemory(
-            section_address, sizeof(IMAGE_SECTION_HEADER), section)) {
-      LOG(WARNING) << "could not read section " << i << " from "
+            first_section_address,
+            sizeof(IMAGE_SECTION_HEADER) * sections_.size(),
+            sections_.data())) {
+      LOG(WARNING) << "could not read section table from "
                    << module_subrange_reader_.name();
       return false;
     }
-    if (strncmp(reinterpret_cast<const char*>(section->Name),
-                name.c_str(),
-                sizeof(section->Name)) == 0) {
-      return true;
-    }
   }
 
-  return false;
-}
-
-bool PEImageReader::ImageDataDirectoryEntry(size_t index,
-                                            IMAGE_DATA_DIRECTORY* entry) const {
-  bool rv;
-  if (module_subrange_reader_.Is64Bit()) {
-    rv = ImageDataDirectoryEntryT<IMAGE_NT_HEADERS64>(index, entry);
-  } else {
-    rv = ImageDataDirectoryEntryT<IMAGE_NT_HEADERS32>(index, entry);
+  for (size_t index = 0; index < sections_.size(); ++index) {
+    const char* name = reinterpret_cast<const char*>(sections_[index].Name);
+    // Section names are NUL-padded but not necessarily NUL-terminated.
+    // emplace() won’t replace an existing entry, so the first section with a
+    // given name wins.
+    section_indices_.emplace(
+        std::string(name, strnlen(name, sizeof(sections_[index].Name))),
+        index);
   }
 
-  return rv && entry->VirtualAddress != 0 && entry->Size != 0;
+  return true;
 }
 
-template <class NtHeadersType>
-bool PEImageReader::ImageDataDirectoryEntryT(
-    size_t index,
-    IMAGE_DATA_DIRECTORY* entry) const {
-  NtHeadersType nt_headers;
-  if (!ReadNtHeaders(&nt_headers, nullptr)) {
+bool PEImageReader::GetSectionByName(const std::string& name,
+                                     IMAGE_SECTION_HEADER* section) const {
+  if (name.size() > sizeof(section->Name)) {
+    LOG(WARNING) << "supplied section name too long " << name;
     return false;
   }
 
-  if (nt_headers.FileHeader.SizeOfOptionalHeader <
-          offsetof(decltype(nt_headers.OptionalHeader), DataDirectory[index]) +
-              sizeof(nt_headers.OptionalHeader.DataDirectory[index]) ||
-      nt_headers.OptionalHeader.NumberOfRvaAndSizes <= index) {
+  if (headers_initialized_.is_uninitialized()) {
+    InitializeHeaders();
+  }
+  if (!headers_initialized_.is_valid()) {
     return false;
   }
 
-  *entry = nt_headers.OptionalHeader.DataDirectory[index];
+  const auto iterator = section_indices_.find(name);
+  if (iterator == section_indices_.end()) {
+    return false;
+  }
+
+  *section = sections_[iterator->second];
   return true;
 }
 
+bool PEImageReader::ImageDataDirectoryEntry(size_t index,
+                                            IMAGE_DATA_DIRECTORY* entry) const {
+  if (headers_initialized_.is_uninitialized()) {
+    InitializeHeaders();
+  }
+  if (!headers_initialized_.is_valid() || index >= data_directories_.size()) {
+    return false;
+  }
+
+  *entry = data_directories_[index];
+  return entry->VirtualAddress != 0 && entry->Size != 0;
+}
+
 // Explicit instantiations with the only 2 valid template arguments to avoid
 // putting the body of the function in the header.
 template bool PEImageReader::GetCrashpadInfo<process_types::internal::Traits32>(
@@ -19,9 +19,12 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "snapshot/win/process_subrange_reader.h"
+#include "util/misc/initialization_state.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
 #include "util/win/address_types.h"
@@ -48,6 +51,10 @@ struct CrashpadInfo {
   typename Traits::Pointer simple_annotations;
   typename Traits::Pointer user_data_minidump_stream_head;
   typename Traits::Pointer annotations_list;
+  typename Traits::Pointer thread_breadcrumbs;
+  typename Traits::Pointer indexed_simple_annotations;
+  typename Traits::Pointer capture_hints;
+  typename Traits::Pointer indexed_extra_memory_ranges;
 };
 
 }  // namespace process_types
@@ -172,8 +179,23 @@ class PEImageReader {
   bool ReadNtHeaders(NtHeadersType* nt_headers,
                      WinVMAddress* nt_headers_address) const;
 
-  //! \brief Finds a given section by name in the image.
+  //! \brief Reads the image’s section table and data directories into
+  //!     sections_, section_indices_, and data_directories_.
+  //!
+  //! This is called at most once, by the first method that needs any of this
+  //! data. headers_initialized_ records the result.
+  void InitializeHeaders() const;
+
+  //! \brief A templatized helper for InitializeHeaders() to account for
+  //!     differences in \a NtHeadersType.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
   template <class NtHeadersType>
+  bool InitializeHeadersT() const;
+
+  //! \brief Finds a given section by name in the image.
+  //!
+  //! If more than one section has the same name, the first is returned.
   bool GetSectionByName(const std::string& name,
                         IMAGE_SECTION_HEADER* section) const;
 
@@ -189,14 +211,23 @@ class PEImageReader {
   //!     message. `false` on failure, with a message logged.
   bool ImageDataDirectoryEntry(size_t index, IMAGE_DATA_DIRECTORY* entry) const;
 
-  //! \brief A templatized helper for ImageDataDirectoryEntry() to account for
-  //!     differences in \a NtHeadersType.
-  template <class NtHeadersType>
-  bool ImageDataDirectoryEntryT(size_t index,
-                                IMAGE_DATA_DIRECTORY* entry) const;
-
   ProcessSubrangeReader module_subrange_reader_;
+
+  // The header data below is mutable in order to maintain the const interface
+  // of this class while allowing it to be read lazily, once, by
+  // InitializeHeaders(). This is logical const-ness, not physical const-ness.
+  // It may only be used when headers_initialized_ is valid.
+  mutable std::vector<IMAGE_SECTION_HEADER> sections_;
+
+  // Maps section names to indices in sections_.
+  mutable std::map<std::string, size_t> section_indices_;
+
+  // The entries of IMAGE_OPTIONAL_HEADER::DataDirectory that are present in the
+  // image.
+  mutable std::vector<IMAGE_DATA_DIRECTORY> data_directories_;
+
   InitializationStateDcheck initialized_;
+  mutable InitializationState headers_initialized_;
 };
 
 }  // namespace crashpad
@@ -75,6 +75,17 @@ TEST(PEImageReader, DebugDirectory) {
   EXPECT_EQ(
       pdbname.compare(pdbname.size() - suffix.size(), suffix.size(), suffix),
       0);
+
+  // The image’s headers are only read once. Later queries must see the same
+  // data.
+  UUID uuid_again;
+  DWORD age_again;
+  std::string pdbname_again;
+  ASSERT_TRUE(pe_image_reader.DebugDirectoryInformation(
+      &uuid_again, &age_again, &pdbname_again));
+  EXPECT_EQ(uuid_again, uuid);
+  EXPECT_EQ(age_again, age);
+  EXPECT_EQ(pdbname_again, pdbname);
 }
 
 void TestVSFixedFileInfo(ProcessReaderWin* process_reader,
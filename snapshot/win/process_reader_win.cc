@@ -17,6 +17,9 @@
 #include <string.h>
 #include <winternl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
 
 #include "base/check_op.h"
@@ -26,6 +29,7 @@
 #include "snapshot/win/cpu_context_win.h"
 #include "util/misc/capture_context.h"
 #include "util/misc/time.h"
+#include "util/thread/thread.h"
 #include "util/win/get_function.h"
 #include "util/win/nt_internals.h"
 #include "util/win/ntstatus_logging.h"
@@ -37,6 +41,11 @@ namespace crashpad {
 
 namespace {
 
+// Memory scanned for pointers or read ahead of time is kept, up to this total
+// size, so that it needn't be read from the target process again when it's
+// written.
+constexpr size_t kMaxRetainedMemoryBytes = 16 * 1024 * 1024;
+
 // Gets a pointer to the process information structure after a given one, or
 // null when iteration is complete, assuming they've been retrieved in a block
 // via NtQuerySystemInformation().
@@ -197,6 +206,39 @@ bool FillThreadContextAndSuspendCount(HANDLE thread_handle,
   return true;
 }
 
+// Runs |work| on a new thread, for ReadThreadData().
+class ThreadDataReader : public Thread {
+ public:
+  explicit ThreadDataReader(const std::function<void()>& work) : work_(work) {}
+
+  ThreadDataReader(const ThreadDataReader&) = delete;
+  ThreadDataReader& operator=(const ThreadDataReader&) = delete;
+
+  ~ThreadDataReader() override {}
+
+  void ThreadMain() override { work_(); }
+
+ private:
+  std::function<void()> work_;
+};
+
+// On Windows 10 build 1607 and later, reads the thread name.
+void ReadThreadName(HANDLE thread_handle, ProcessReaderWin::Thread* thread) {
+  static const auto get_thread_description =
+      GET_FUNCTION(L"kernel32.dll", ::GetThreadDescription);
+  if (get_thread_description) {
+    wchar_t* thread_description;
+    HRESULT hr = get_thread_description(thread_handle, &thread_description);
+    if (SUCCEEDED(hr)) {
+      ScopedLocalAlloc thread_description_owner(thread_description);
+      thread->name = base::WideToUTF8(thread_description);
+    } else {
+      LOG(WARNING) << "GetThreadDescription: "
+                   << logging::SystemErrorCodeToString(hr);
+    }
+  }
+}
+
 }  // namespace
 
 ProcessReaderWin::ThreadContext::ThreadContext()
@@ -219,6 +261,19 @@ bool ProcessReaderWin::ThreadContext::InitializeNative(HANDLE thread_handle) {
   return true;
 }
 
+bool ProcessReaderWin::ThreadContext::InitializeFromPssSnapshot(
+    const PssSnapshot::Thread& thread) {
+  if (thread.context.size() < sizeof(CONTEXT)) {
+    LOG(ERROR) << "thread " << thread.id << " context size "
+               << thread.context.size();
+    return false;
+  }
+  data_.assign(thread.context.begin(),
+               thread.context.begin() + sizeof(CONTEXT));
+  initialized_ = true;
+  return true;
+}
+
 #if defined(ARCH_CPU_64_BITS)
 bool ProcessReaderWin::ThreadContext::InitializeWow64(HANDLE thread_handle) {
   data_.resize(sizeof(WOW64_CONTEXT));
@@ -289,8 +344,10 @@ ProcessReaderWin::Thread::Thread()
 
 ProcessReaderWin::ProcessReaderWin()
     : process_(INVALID_HANDLE_VALUE),
+      pss_snapshot_(nullptr),
       process_info_(),
       process_memory_(),
+      read_cache_(kMaxRetainedMemoryBytes),
       threads_(),
       modules_(),
       suspension_state_(),
@@ -302,14 +359,24 @@ ProcessReaderWin::~ProcessReaderWin() {
 }
 
 bool ProcessReaderWin::Initialize(HANDLE process,
-                                  ProcessSuspensionState suspension_state) {
+                                  ProcessSuspensionState suspension_state,
+                                  const PssSnapshot* pss_snapshot) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_ = process;
   suspension_state_ = suspension_state;
-  if (!process_info_.Initialize(process))
+  pss_snapshot_ = pss_snapshot;
+  HANDLE memory_process =
+      pss_snapshot ? pss_snapshot->VaCloneProcess() : process;
+  if (!process_info_.Initialize(process, memory_process))
     return false;
-  if (!process_memory_.Initialize(process))
+  if (pss_snapshot && process_info_.IsWow64()) {
+    // PssCaptureSnapshot() captures the native context of WOW64 threads, not
+    // the context that they run with.
+    LOG(ERROR) << "reading WOW64 process from PssSnapshot not supported";
+    return false;
+  }
+  if (!process_memory_.Initialize(memory_process))
     return false;
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
@@ -346,6 +413,11 @@ const std::vector<ProcessReaderWin::Thread>& ProcessReaderWin::Threads() {
 
   initialized_threads_ = true;
 
+  if (pss_snapshot_) {
+    ReadPssThreadData();
+    return threads_;
+  }
+
 #if defined(ARCH_CPU_64_BITS)
   ReadThreadData<process_types::internal::Traits64>(process_info_.IsWow64());
 #else
@@ -370,6 +442,12 @@ const ProcessInfo& ProcessReaderWin::GetProcessInfo() const {
   return process_info_;
 }
 
+void ProcessReaderWin::SetHandleOptions(
+    const ProcessInfo::HandleOptions& options) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  process_info_.SetHandleOptions(options);
+}
+
 void ProcessReaderWin::DecrementThreadSuspendCounts(uint64_t except_thread_id) {
   Threads();
   for (auto& thread : threads_) {
@@ -390,95 +468,181 @@ void ProcessReaderWin::ReadThreadData(bool is_64_reading_32) {
   if (!process_information)
     return;
 
-  for (unsigned long i = 0; i < process_information->NumberOfThreads; ++i) {
-    const process_types::SYSTEM_THREAD_INFORMATION<Traits>& thread_info =
-        process_information->Threads[i];
-    ProcessReaderWin::Thread thread;
-    thread.id = thread_info.ClientId.UniqueThread;
+  const size_t thread_count = process_information->NumberOfThreads;
+  std::vector<Thread> threads(thread_count);
+  std::unique_ptr<bool[]> thread_valid(new bool[thread_count]());
+
+  // Each thread is opened, suspended, and queried independently, which for a
+  // process with many threads is dominated by round trips to the kernel. Spread
+  // that across a few threads of this process once there are enough threads to
+  // make it worthwhile. This isn’t done when reading this process, because
+  // suspending one of its threads from another could leave a lock needed by the
+  // reader held.
+  constexpr size_t kMinThreadsPerReader = 128;
+  constexpr size_t kMaxReaders = 4;
+  const size_t readers =
+      GetProcessId(process_) == GetCurrentProcessId()
+          ? 1
+          : std::clamp(thread_count / kMinThreadsPerReader,
+                       size_t{1},
+                       kMaxReaders);
+
+  std::atomic<size_t> next_index(0);
+  auto read_threads = [&]() {
+    size_t index;
+    while ((index = next_index.fetch_add(1)) < thread_count) {
+      thread_valid[index] =
+          ReadThread<Traits>(process_information->Threads[index],
+                             is_64_reading_32,
+                             &threads[index]);
+    }
+  };
 
-    ScopedKernelHANDLE thread_handle(OpenThread(thread_info));
-    if (!thread_handle.is_valid())
-      continue;
+  // The calling thread reads threads alongside any additional readers.
+  std::vector<std::unique_ptr<ThreadDataReader>> workers;
+  for (size_t index = 1; index < readers; ++index) {
+    workers.push_back(std::make_unique<ThreadDataReader>(read_threads));
+    workers.back()->Start();
+  }
+  read_threads();
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
 
-    if (!FillThreadContextAndSuspendCount<Traits>(thread_handle.get(),
-                                                  &thread,
-                                                  suspension_state_,
-                                                  is_64_reading_32)) {
-      continue;
+  // Keep the order of the system’s thread list, so that the main thread stays
+  // first.
+  for (size_t index = 0; index < thread_count; ++index) {
+    if (thread_valid[index]) {
+      threads_.push_back(std::move(threads[index]));
     }
+  }
+}
 
-    // TODO(scottmg): I believe we could reverse engineer the PriorityClass from
-    // the Priority, BasePriority, and
-    // https://msdn.microsoft.com/library/ms685100.aspx. MinidumpThreadWriter
-    // doesn't handle it yet in any case, so investigate both of those at the
-    // same time if it's useful.
-    thread.priority_class = NORMAL_PRIORITY_CLASS;
+template <class Traits>
+bool ProcessReaderWin::ReadThread(
+    const process_types::SYSTEM_THREAD_INFORMATION<Traits>& thread_info,
+    bool is_64_reading_32,
+    Thread* thread) {
+  thread->id = thread_info.ClientId.UniqueThread;
+
+  ScopedKernelHANDLE thread_handle(OpenThread(thread_info));
+  if (!thread_handle.is_valid())
+    return false;
+
+  if (!FillThreadContextAndSuspendCount<Traits>(thread_handle.get(),
+                                                thread,
+                                                suspension_state_,
+                                                is_64_reading_32)) {
+    return false;
+  }
+
+  // TODO(scottmg): I believe we could reverse engineer the PriorityClass from
+  // the Priority, BasePriority, and
+  // https://msdn.microsoft.com/library/ms685100.aspx. MinidumpThreadWriter
+  // doesn't handle it yet in any case, so investigate both of those at the
+  // same time if it's useful.
+  thread->priority_class = NORMAL_PRIORITY_CLASS;
+
+  thread->priority = thread_info.Priority;
+
+  process_types::THREAD_BASIC_INFORMATION<Traits> thread_basic_info;
+  NTSTATUS status = crashpad::NtQueryInformationThread(
+      thread_handle.get(),
+      static_cast<THREADINFOCLASS>(ThreadBasicInformation),
+      &thread_basic_info,
+      sizeof(thread_basic_info),
+      nullptr);
+  if (!NT_SUCCESS(status)) {
+    NTSTATUS_LOG(ERROR, status) << "NtQueryInformationThread";
+    return false;
+  }
+
+  thread->teb_address = thread_basic_info.TebBaseAddress;
+  ReadThreadStack<Traits>(is_64_reading_32, thread);
+  ReadThreadName(thread_handle.get(), thread);
+  return true;
+}
 
-    thread.priority = thread_info.Priority;
-
-    process_types::THREAD_BASIC_INFORMATION<Traits> thread_basic_info;
-    NTSTATUS status = crashpad::NtQueryInformationThread(
-        thread_handle.get(),
-        static_cast<THREADINFOCLASS>(ThreadBasicInformation),
-        &thread_basic_info,
-        sizeof(thread_basic_info),
-        nullptr);
-    if (!NT_SUCCESS(status)) {
-      NTSTATUS_LOG(ERROR, status) << "NtQueryInformationThread";
+void ProcessReaderWin::ReadPssThreadData() {
+  DCHECK(threads_.empty());
+
+  for (const PssSnapshot::Thread& pss_thread : pss_snapshot_->Threads()) {
+    ProcessReaderWin::Thread thread;
+    thread.id = pss_thread.id;
+    if (!thread.context.InitializeFromPssSnapshot(pss_thread)) {
       continue;
     }
 
-    // Read the TIB (Thread Information Block) which is the first element of the
-    // TEB, for its stack fields.
-    process_types::NT_TIB<Traits> tib;
-    thread.teb_address = thread_basic_info.TebBaseAddress;
-    thread.teb_size = sizeof(process_types::TEB<Traits>);
-    if (process_memory_.Read(thread.teb_address, sizeof(tib), &tib)) {
-      WinVMAddress base = 0;
-      WinVMAddress limit = 0;
-      // If we're reading a WOW64 process, then the TIB we just retrieved is the
-      // x64 one. The first word of the x64 TIB points at the x86 TIB. See
-      // https://msdn.microsoft.com/library/dn424783.aspx.
-      if (is_64_reading_32) {
-        process_types::NT_TIB<process_types::internal::Traits32> tib32;
-        thread.teb_address = tib.Wow64Teb;
-        thread.teb_size =
-            sizeof(process_types::TEB<process_types::internal::Traits32>);
-        if (process_memory_.Read(thread.teb_address, sizeof(tib32), &tib32)) {
-          base = tib32.StackBase;
-          limit = tib32.StackLimit;
-        }
-      } else {
-        base = tib.StackBase;
-        limit = tib.StackLimit;
-      }
-
-      // Note, "backwards" because of direction of stack growth.
-      thread.stack_region_address = limit;
-      if (limit > base) {
-        LOG(ERROR) << "invalid stack range: " << base << " - " << limit;
-        thread.stack_region_size = 0;
-      } else {
-        thread.stack_region_size = base - limit;
-      }
+    if (pss_thread.suspend_count == 0 &&
+        suspension_state_ == ProcessSuspensionState::kSuspended) {
+      LOG(WARNING) << "Thread " << thread.id
+                   << " should be suspended, but suspend count is 0";
+      thread.suspend_count = 0;
+    } else {
+      thread.suspend_count =
+          pss_thread.suspend_count -
+          (suspension_state_ == ProcessSuspensionState::kSuspended ? 1 : 0);
     }
-    // On Windows 10 build 1607 and later, read the thread name.
-    static const auto get_thread_description =
-        GET_FUNCTION(L"kernel32.dll", ::GetThreadDescription);
-    if (get_thread_description) {
-      wchar_t* thread_description;
-      HRESULT hr =
-          get_thread_description(thread_handle.get(), &thread_description);
-      if (SUCCEEDED(hr)) {
-        ScopedLocalAlloc thread_description_owner(thread_description);
-        thread.name = base::WideToUTF8(thread_description);
-      } else {
-        LOG(WARNING) << "GetThreadDescription: "
-                     << logging::SystemErrorCodeToString(hr);
-      }
+
+    thread.priority_class = NORMAL_PRIORITY_CLASS;
+    thread.priority = pss_thread.priority;
+
+    thread.teb_address = pss_thread.teb_address;
+#if defined(ARCH_CPU_64_BITS)
+    ReadThreadStack<process_types::internal::Traits64>(false, &thread);
+#else
+    ReadThreadStack<process_types::internal::Traits32>(false, &thread);
+#endif
+
+    // The thread may have exited since the snapshot was captured, in which
+    // case it has no name.
+    ScopedKernelHANDLE thread_handle(
+        ::OpenThread(THREAD_QUERY_LIMITED_INFORMATION, false, thread.id));
+    if (thread_handle.is_valid()) {
+      ReadThreadName(thread_handle.get(), &thread);
     }
+
     threads_.push_back(thread);
   }
 }
 
+template <class Traits>
+void ProcessReaderWin::ReadThreadStack(bool is_64_reading_32, Thread* thread) {
+  // Read the TIB (Thread Information Block) which is the first element of the
+  // TEB, for its stack fields.
+  process_types::NT_TIB<Traits> tib;
+  thread->teb_size = sizeof(process_types::TEB<Traits>);
+  if (!process_memory_.Read(thread->teb_address, sizeof(tib), &tib)) {
+    return;
+  }
+
+  WinVMAddress base = 0;
+  WinVMAddress limit = 0;
+  // If we're reading a WOW64 process, then the TIB we just retrieved is the
+  // x64 one. The first word of the x64 TIB points at the x86 TIB. See
+  // https://msdn.microsoft.com/library/dn424783.aspx.
+  if (is_64_reading_32) {
+    process_types::NT_TIB<process_types::internal::Traits32> tib32;
+    thread->teb_address = tib.Wow64Teb;
+    thread->teb_size =
+        sizeof(process_types::TEB<process_types::internal::Traits32>);
+    if (process_memory_.Read(thread->teb_address, sizeof(tib32), &tib32)) {
+      base = tib32.StackBase;
+      limit = tib32.StackLimit;
+    }
+  } else {
+    base = tib.StackBase;
+    limit = tib.StackLimit;
+  }
+
+  // Note, "backwards" because of direction of stack growth.
+  thread->stack_region_address = limit;
+  if (limit > base) {
+    LOG(ERROR) << "invalid stack range: " << base << " - " << limit;
+    thread->stack_region_size = 0;
+  } else {
+    thread->stack_region_size = base - limit;
+  }
+}
+
 }  // namespace crashpad
@@ -22,10 +22,13 @@
 #include <vector>
 
 #include "build/build_config.h"
+#include "snapshot/memory_read_cache.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory_win.h"
 #include "util/win/address_types.h"
 #include "util/win/process_info.h"
+#include "util/win/process_structs.h"
+#include "util/win/pss_snapshot.h"
 
 namespace crashpad {
 
@@ -62,6 +65,7 @@ class ProcessReaderWin {
 #endif  // ARCH_CPU_X86_64
     void InitializeFromCurrentThread();
     bool InitializeNative(HANDLE thread_handle);
+    bool InitializeFromPssSnapshot(const PssSnapshot::Thread& thread);
 
    private:
     // This is usually 0 but Windows might cause it to be positive when
@@ -106,12 +110,20 @@ class ProcessReaderWin {
   //!     ProcessSuspensionState::kSuspended, except for testing uses and where
   //!     the reader is reading itself.
   //!
+  //! \param[in] pss_snapshot If not `nullptr`, a snapshot of \a process to read
+  //!     memory and threads from instead of \a process, which then need not
+  //!     remain suspended. \a suspension_state describes \a process at the
+  //!     time that \a pss_snapshot was captured. WOW64 processes are not
+  //!     supported. Weak, and must outlive this object.
+  //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
   //!
   //! \sa ScopedProcessSuspend
-  bool Initialize(HANDLE process, ProcessSuspensionState suspension_state);
+  bool Initialize(HANDLE process,
+                  ProcessSuspensionState suspension_state,
+                  const PssSnapshot* pss_snapshot = nullptr);
 
   //! \return `true` if the target task is a 64-bit process.
   bool Is64Bit() const { return process_info_.Is64Bit(); }
@@ -119,6 +131,11 @@ class ProcessReaderWin {
   //! \brief Return a memory reader for the target process.
   const ProcessMemoryWin* Memory() const { return &process_memory_; }
 
+  //! \brief Return the cache shared by this process' memory snapshots, which
+  //!     pools their staging buffers and retains memory that has been read
+  //!     ahead of time.
+  internal::MemoryReadCache* ReadCache() { return &read_cache_; }
+
   //! \brief Determines the target process' start time.
   //!
   //! \param[out] start_time The time that the process started.
@@ -147,6 +164,11 @@ class ProcessReaderWin {
   //! \return A ProcessInfo object for the process being read.
   const ProcessInfo& GetProcessInfo() const;
 
+  //! \brief Limits the handles reported by GetProcessInfo().
+  //!
+  //! \sa ProcessInfo::SetHandleOptions()
+  void SetHandleOptions(const ProcessInfo::HandleOptions& options);
+
   //! \brief Decrements the thread suspend counts for all thread ids other than
   //!     \a except_thread_id.
   //!
@@ -157,10 +179,20 @@ class ProcessReaderWin {
  private:
   template <class Traits>
   void ReadThreadData(bool is_64_reading_32);
+  template <class Traits>
+  bool ReadThread(
+      const process_types::SYSTEM_THREAD_INFORMATION<Traits>& thread_info,
+      bool is_64_reading_32,
+      Thread* thread);
+  void ReadPssThreadData();
+  template <class Traits>
+  void ReadThreadStack(bool is_64_reading_32, Thread* thread);
 
   HANDLE process_;
+  const PssSnapshot* pss_snapshot_;  // weak
   ProcessInfo process_info_;
   ProcessMemoryWin process_memory_;
+  internal::MemoryReadCache read_cache_;
   std::vector<Thread> threads_;
   std::vector<ProcessInfo::Module> modules_;
   ProcessSuspensionState suspension_state_;
@@ -26,8 +26,10 @@
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
+#include "snapshot/capture_memory.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/misc/time.h"
+#include "util/numeric/checked_range.h"
 #include "util/win/nt_internals.h"
 #include "util/win/registration_protocol_win.h"
 
@@ -55,12 +57,14 @@ bool ProcessSnapshotWin::Initialize(
     HANDLE process,
     ProcessSuspensionState suspension_state,
     WinVMAddress exception_information_address,
-    WinVMAddress debug_critical_section_address) {
+    WinVMAddress debug_critical_section_address,
+    const PssSnapshot* pss_snapshot,
+    ModuleMetadataCache* module_metadata_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   GetTimeOfDay(&snapshot_time_);
 
-  if (!process_reader_.Initialize(process, suspension_state))
+  if (!process_reader_.Initialize(process, suspension_state, pss_snapshot))
     return false;
 
   client_id_.InitializeToZero();
@@ -74,7 +78,7 @@ bool ProcessSnapshotWin::Initialize(
         debug_critical_section_address);
   }
 
-  InitializeModules();
+  InitializeModules(module_metadata_cache);
   InitializeUnloadedModules();
 
   GetCrashpadOptionsInternal(&options_);
@@ -254,15 +258,44 @@ void ProcessSnapshotWin::InitializeThreads(uint32_t* budget_remaining_pointer) {
       threads_.push_back(std::move(thread));
     }
   }
+
+  if (budget_remaining_pointer) {
+    // The exception context was captured by exception_->Initialize(). Capture
+    // threads' memory in priority order, so that uninteresting threads don't
+    // use up the budget or time limit first.
+    internal::PrioritizedCaptureMemory capture;
+    for (const auto& thread : threads_) {
+      thread->AddIndirectlyReferencedMemoryCandidates(
+          exception_ && thread->ThreadID() == exception_->ThreadID(), &capture);
+    }
+    capture.Capture(
+        budget_remaining_pointer,
+        internal::PrioritizedCaptureMemory::kDefaultTimeLimitNanoseconds);
+  }
+
+  // The TEBs and the memory captured around pointers are many small regions,
+  // which would otherwise each take a ReadProcessMemory() call when they're
+  // written. Read them in bulk now, so that they're written from the cache.
+  // Stacks are larger, and each is already read in a single call.
+  std::vector<CheckedRange<VMAddress, size_t>> extra_memory;
+  for (const auto& thread : threads_) {
+    for (const MemorySnapshot* memory : thread->ExtraMemory()) {
+      extra_memory.emplace_back(memory->Address(), memory->Size());
+    }
+  }
+  process_reader_.ReadCache()->Prefetch(process_reader_.Memory(),
+                                        std::move(extra_memory));
 }
 
-void ProcessSnapshotWin::InitializeModules() {
+void ProcessSnapshotWin::InitializeModules(
+    ModuleMetadataCache* module_metadata_cache) {
   const std::vector<ProcessInfo::Module>& process_reader_modules =
       process_reader_.Modules();
   for (const ProcessInfo::Module& process_reader_module :
        process_reader_modules) {
     auto module = std::make_unique<internal::ModuleSnapshotWin>();
-    if (module->Initialize(&process_reader_, process_reader_module)) {
+    if (module->Initialize(
+            &process_reader_, process_reader_module, module_metadata_cache)) {
       modules_.push_back(std::move(module));
     }
   }
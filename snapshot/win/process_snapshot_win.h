@@ -31,6 +31,7 @@
 #include "snapshot/memory_map_region_snapshot.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
+#include "snapshot/module_metadata_cache.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/system_snapshot.h"
@@ -45,7 +46,9 @@
 #include "util/misc/uuid.h"
 #include "util/process/process_id.h"
 #include "util/win/address_types.h"
+#include "util/win/process_info.h"
 #include "util/win/process_structs.h"
+#include "util/win/pss_snapshot.h"
 
 namespace crashpad {
 
@@ -72,6 +75,12 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   //!     process's address space of a `CRITICAL_SECTION` allocated with valid
   //!     `.DebugInfo`. Used as a starting point to walk the process's locks.
   //!     May be `0`.
+  //! \param[in] pss_snapshot If not `nullptr`, a snapshot of \a process to
+  //!     read from instead of \a process. See ProcessReaderWin::Initialize().
+  //!     Weak, and must outlive this object.
+  //! \param[in] module_metadata_cache If not `nullptr`, a cache of module
+  //!     metadata that may be shared with other snapshots. See
+  //!     ModuleSnapshotWin::Initialize(). Weak, and must outlive this object.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
@@ -80,7 +89,9 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   bool Initialize(HANDLE process,
                   ProcessSuspensionState suspension_state,
                   WinVMAddress exception_information_address,
-                  WinVMAddress debug_critical_section_address);
+                  WinVMAddress debug_critical_section_address,
+                  const PssSnapshot* pss_snapshot = nullptr,
+                  ModuleMetadataCache* module_metadata_cache = nullptr);
 
   //! \brief Sets the value to be returned by ReportID().
   //!
@@ -107,6 +118,14 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
     annotations_simple_map_ = annotations_simple_map;
   }
 
+  //! \brief Limits the handles returned by Handles().
+  //!
+  //! This must be called before Handles() is first called, which normally
+  //! happens when a minidump is written from this snapshot.
+  void SetHandleOptions(const ProcessInfo::HandleOptions& options) {
+    process_reader_.SetHandleOptions(options);
+  }
+
   //! \brief Returns options from CrashpadInfo structures found in modules in
   //!     the process.
   //!
@@ -140,7 +159,7 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   void InitializeThreads(uint32_t* indirectly_referenced_memory_cap);
 
   // Initializes modules_ on behalf of Initialize().
-  void InitializeModules();
+  void InitializeModules(ModuleMetadataCache* module_metadata_cache);
 
   // Initializes unloaded_modules_ on behalf of Initialize().
   void InitializeUnloadedModules();
@@ -85,6 +85,8 @@ bool ThreadSnapshotWin::Initialize(
   } else {
     teb_.Initialize(process_reader->Memory(), 0, 0);
   }
+  stack_.set_read_cache(process_reader->ReadCache());
+  teb_.set_read_cache(process_reader->ReadCache());
 
 #if defined(ARCH_CPU_X86)
   context_.architecture = kCPUArchitectureX86;
@@ -131,25 +133,40 @@ bool ThreadSnapshotWin::Initialize(
             CheckedRange<WinVMAddress, WinVMSize>(ssp_base, page_size))) {
       auto region = std::make_unique<MemorySnapshotGeneric>();
       region->Initialize(process_reader->Memory(), ssp_base, page_size);
+      region->set_read_cache(process_reader->ReadCache());
       pointed_to_memory_.push_back(std::move(region));
     }
   }
 #endif  // ARCH_CPU_X86_64
 
-  CaptureMemoryDelegateWin capture_memory_delegate(
-      process_reader,
-      thread_,
-      &pointed_to_memory_,
-      gather_indirectly_referenced_memory_bytes_remaining);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
   if (gather_indirectly_referenced_memory_bytes_remaining) {
-    CaptureMemory::PointedToByMemoryRange(stack_, &capture_memory_delegate);
+    capture_memory_delegate_ = std::make_unique<CaptureMemoryDelegateWin>(
+        process_reader,
+        thread_,
+        &pointed_to_memory_,
+        gather_indirectly_referenced_memory_bytes_remaining);
   }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+void ThreadSnapshotWin::AddIndirectlyReferencedMemoryCandidates(
+    bool is_exception_thread,
+    PrioritizedCaptureMemory* capture) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!capture_memory_delegate_) {
+    return;
+  }
+
+  capture->AddContext(
+      context_, is_exception_thread, capture_memory_delegate_.get());
+  capture->AddStack(stack_,
+                    context_.StackPointer(),
+                    is_exception_thread,
+                    capture_memory_delegate_.get());
+}
+
 const CPUContext* ThreadSnapshotWin::Context() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return &context_;
@@ -196,5 +213,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotWin::ExtraMemory() const {
   return result;
 }
 
+std::vector<uint8_t> ThreadSnapshotWin::Breadcrumbs() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint8_t>();
+}
+
+std::vector<UnwoundStackFrame> ThreadSnapshotWin::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<UnwoundStackFrame>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -21,10 +21,12 @@
 #include <vector>
 
 #include "build/build_config.h"
+#include "snapshot/capture_memory.h"
 #include "snapshot/cpu_context.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/thread_snapshot.h"
+#include "snapshot/win/capture_memory_delegate_win.h"
 #include "snapshot/win/process_reader_win.h"
 #include "util/misc/initialization_state_dcheck.h"
 
@@ -52,9 +54,11 @@ class ThreadSnapshotWin final : public ThreadSnapshot {
   //! \param[in] process_reader_thread The thread within the ProcessReaderWin
   //!     for which the snapshot should be created.
   //! \param[in,out] gather_indirectly_referenced_memory_bytes_remaining If
-  //!     non-null, add extra memory regions to the snapshot pointed to by the
-  //!     thread's stack. The size of the regions added is subtracted from the
-  //!     count, and when it's `0`, no more regions will be added.
+  //!     non-null, memory pointed to by the thread's registers and stack may be
+  //!     added to the snapshot by
+  //!     AddIndirectlyReferencedMemoryCandidates(). The size of the regions
+  //!     added is subtracted from the count, and when it's `0`, no more
+  //!     regions will be added.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
@@ -63,6 +67,22 @@ class ThreadSnapshotWin final : public ThreadSnapshot {
       const ProcessReaderWin::Thread& process_reader_thread,
       uint32_t* gather_indirectly_referenced_memory_bytes_remaining);
 
+  //! \brief Adds the pointer-like values in this thread's registers and stack
+  //!     to \a capture.
+  //!
+  //! Memory captured for them by PrioritizedCaptureMemory::Capture() is
+  //! returned by ExtraMemory(). This does nothing if Initialize() was called
+  //! without a budget.
+  //!
+  //! Initialize() must be called before this method.
+  //!
+  //! \param[in] is_exception_thread `true` if this thread raised the exception
+  //!     being captured.
+  //! \param[in] capture The PrioritizedCaptureMemory to add candidates to.
+  void AddIndirectlyReferencedMemoryCandidates(
+      bool is_exception_thread,
+      PrioritizedCaptureMemory* capture);
+
   // ThreadSnapshot:
 
   const CPUContext* Context() const override;
@@ -73,6 +93,8 @@ class ThreadSnapshotWin final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  std::vector<uint8_t> Breadcrumbs() const override;
+  std::vector<UnwoundStackFrame> UnwoundFrames() const override;
 
  private:
   union {
@@ -91,6 +113,7 @@ class ThreadSnapshotWin final : public ThreadSnapshot {
   ProcessReaderWin::Thread thread_;
   InitializationStateDcheck initialized_;
   std::vector<std::unique_ptr<MemorySnapshotGeneric>> pointed_to_memory_;
+  std::unique_ptr<CaptureMemoryDelegateWin> capture_memory_delegate_;
 };
 
 }  // namespace internal
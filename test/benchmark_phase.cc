@@ -0,0 +1,56 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/benchmark_phase.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "base/check.h"
+
+namespace crashpad {
+namespace test {
+
+uint64_t Median(std::vector<uint64_t> values) {
+  DCHECK(!values.empty());
+  std::nth_element(
+      values.begin(), values.begin() + values.size() / 2, values.end());
+  return values[values.size() / 2];
+}
+
+void PrintPhaseHeading(int name_width) {
+  printf("%-*s %12s %12s %12s\n",
+         name_width,
+         "phase (ms)",
+         "min",
+         "median",
+         "max");
+}
+
+void PrintPhase(const char* name,
+                int name_width,
+                std::vector<uint64_t> durations_ns) {
+  DCHECK(!durations_ns.empty());
+  std::sort(durations_ns.begin(), durations_ns.end());
+  printf("%-*s %12.3f %12.3f %12.3f\n",
+         name_width,
+         name,
+         durations_ns.front() / 1e6,
+         durations_ns[durations_ns.size() / 2] / 1e6,
+         durations_ns.back() / 1e6);
+}
+
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_TEST_BENCHMARK_PHASE_H_
+#define CRASHPAD_TEST_BENCHMARK_PHASE_H_
+
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+namespace crashpad {
+namespace test {
+
+//! \brief Returns the median of \a values, which must not be empty.
+uint64_t Median(std::vector<uint64_t> values);
+
+//! \brief Returns the median of the values that \a get returns for each of
+//!     \a samples, which must not be empty.
+template <typename Sample, typename Get>
+uint64_t Median(const std::vector<Sample>& samples, Get get) {
+  std::vector<uint64_t> values;
+  values.reserve(samples.size());
+  for (const Sample& sample : samples) {
+    values.push_back(get(sample));
+  }
+  return Median(std::move(values));
+}
+
+//! \brief Prints the heading for the lines that PrintPhase() prints.
+//!
+//! \param[in] name_width The width of the column holding the phase names.
+void PrintPhaseHeading(int name_width);
+
+//! \brief Prints a line giving the shortest, median, and longest durations of
+//!     a phase of a benchmark, in milliseconds.
+//!
+//! \param[in] name The name of the phase.
+//! \param[in] name_width The width of the column holding the phase names.
+//! \param[in] durations_ns The duration of each iteration of the phase, in
+//!     nanoseconds. This must not be empty.
+void PrintPhase(const char* name,
+                int name_width,
+                std::vector<uint64_t> durations_ns);
+
+//! \brief Calls PrintPhase() with the duration that \a get returns for each of
+//!     \a samples.
+template <typename Sample, typename Get>
+void PrintPhase(const char* name,
+                int name_width,
+                const std::vector<Sample>& samples,
+                Get get) {
+  std::vector<uint64_t> durations_ns;
+  durations_ns.reserve(samples.size());
+  for (const Sample& sample : samples) {
+    durations_ns.push_back(get(sample));
+  }
+  PrintPhase(name, name_width, std::move(durations_ns));
+}
+
+}  // namespace test
+}  // namespace crashpad
+
+#endif  // CRASHPAD_TEST_BENCHMARK_PHASE_H_
@@ -0,0 +1,30 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_THIRD_PARTY_LIBDEFLATE_LIBDEFLATE_CRASHPAD_H_
+#define CRASHPAD_THIRD_PARTY_LIBDEFLATE_LIBDEFLATE_CRASHPAD_H_
+
+// #include this file instead of the system version of <libdeflate.h> or
+// equivalent available at any other location in the source tree. It will
+// #include the proper <libdeflate.h> depending on how the build has been
+// configured.
+
+#if defined(CRASHPAD_LIBDEFLATE_SOURCE_SYSTEM) || \
+    defined(CRASHPAD_LIBDEFLATE_SOURCE_EXTERNAL)
+#include <libdeflate.h>
+#else
+#error Unknown libdeflate source
+#endif
+
+#endif  // CRASHPAD_THIRD_PARTY_LIBDEFLATE_LIBDEFLATE_CRASHPAD_H_
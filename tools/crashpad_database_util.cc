@@ -18,9 +18,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <inttypes.h>
 #include <sys/types.h>
 #include <time.h>
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -30,6 +32,7 @@
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
@@ -37,6 +40,7 @@
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
 #include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
 #include "util/misc/uuid.h"
 #include "util/stdlib/string_number_conversion.h"
 
@@ -59,10 +63,33 @@ void Usage(const base::FilePath& me) {
 "      --show-completed-reports    show reports not eligible for upload\n"
 "      --show-all-report-info      with --show-*-reports, show more information\n"
 "      --show-report=UUID          show report stored under UUID\n"
+"      --created-after=TIME        with --show-*-reports, show only reports\n"
+"                                  created at or after TIME\n"
+"      --created-before=TIME       with --show-*-reports, show only reports\n"
+"                                  created before TIME\n"
+"      --min-size=BYTES            with --show-*-reports, show only reports of\n"
+"                                  at least BYTES\n"
+"      --max-size=BYTES            with --show-*-reports, show only reports of\n"
+"                                  at most BYTES\n"
+"      --uploaded=BOOL             with --show-*-reports, show only reports\n"
+"                                  that were or were not uploaded\n"
+"      --sort=KEY                  with --show-*-reports, sort by KEY:\n"
+"                                  creation-time, last-upload-attempt-time,\n"
+"                                  size, or upload-attempts\n"
+"      --reverse                   with --sort, sort in descending order\n"
+"      --limit=N                   with --show-*-reports, show at most N\n"
+"                                  reports of each state\n"
+"      --json                      show information as JSON, one object per\n"
+"                                  line\n"
 "      --set-uploads-enabled=BOOL  enable or disable uploads\n"
 "      --set-last-upload-attempt-time=TIME\n"
 "                                  set the last-upload-attempt time to TIME\n"
 "      --new-report=PATH           submit a new report at PATH, or - for stdin\n"
+"      --export=PATH               write the reports selected by\n"
+"                                  --show-*-report* to an archive at PATH, or\n"
+"                                  - for stdout, instead of showing them\n"
+"      --import=PATH               submit the reports in the archive at PATH,\n"
+"                                  or - for stdin\n"
 "      --utc                       show and set UTC times instead of local\n"
 "      --help                      display this help and exit\n"
 "      --version                   output version information and exit\n",
@@ -71,12 +98,36 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+enum class SortKey {
+  kNone = 0,
+  kCreationTime,
+  kLastUploadAttemptTime,
+  kSize,
+  kUploadAttempts,
+};
+
 struct Options {
   std::vector<UUID> show_reports;
   std::vector<base::FilePath> new_report_paths;
   const char* database;
   const char* set_last_upload_attempt_time_string;
+  const char* created_after_string;
+  const char* created_before_string;
+  const char* export_path;
+  const char* import_path;
   time_t set_last_upload_attempt_time;
+  time_t created_after;
+  time_t created_before;
+  uint64_t min_size;
+  uint64_t max_size;
+  size_t limit;
+  SortKey sort_key;
+  bool has_max_size;
+  bool has_limit;
+  bool uploaded;
+  bool has_uploaded;
+  bool reverse;
+  bool json;
   bool create;
   bool show_client_id;
   bool show_uploads_enabled;
@@ -222,6 +273,128 @@ std::string TimeToString(time_t out_time, bool utc) {
   return std::string(string);
 }
 
+// Converts |path| to a UTF-8 string.
+std::string FilePathToUTF8(const base::FilePath& path) {
+#if BUILDFLAG(IS_WIN)
+  return base::WideToUTF8(path.value());
+#else
+  return path.value();
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+// Returns |string| as a quoted JSON string. |string| is expected to be UTF-8,
+// and only the characters that JSON requires to be escaped are escaped.
+std::string JSONString(const std::string& string) {
+  std::string json("\"");
+  for (char c : string) {
+    switch (c) {
+      case '"':
+        json.append("\\\"");
+        break;
+      case '\\':
+        json.append("\\\\");
+        break;
+      case '\n':
+        json.append("\\n");
+        break;
+      case '\r':
+        json.append("\\r");
+        break;
+      case '\t':
+        json.append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          json.append(base::StringPrintf("\\u%04x", c));
+        } else {
+          json.push_back(c);
+        }
+        break;
+    }
+  }
+  json.push_back('"');
+  return json;
+}
+
+// Shows a single |report| as a JSON object on one line. |state| is the
+// report’s state, "pending" or "completed", or nullptr if it isn’t known.
+// Times are shown as numeric time_t values, which don’t depend on the time
+// zone.
+void ShowReportJSON(const CrashReportDatabase::Report& report,
+                    const char* state) {
+  std::string state_field;
+  if (state) {
+    state_field = base::StringPrintf(",\"state\":\"%s\"", state);
+  }
+  printf("{\"uuid\":\"%s\"%s,\"path\":%s,\"remote_id\":%s,"
+         "\"creation_time\":%" PRId64 ",\"uploaded\":%s,"
+         "\"last_upload_attempt_time\":%" PRId64 ",\"upload_attempts\":%d,"
+         "\"upload_explicitly_requested\":%s,\"total_size\":%" PRIu64 "}\n",
+         report.uuid.ToString().c_str(),
+         state_field.c_str(),
+         JSONString(FilePathToUTF8(report.file_path)).c_str(),
+         JSONString(report.id).c_str(),
+         static_cast<int64_t>(report.creation_time),
+         BoolToString(report.uploaded).c_str(),
+         static_cast<int64_t>(report.last_upload_attempt_time),
+         report.upload_attempts,
+         BoolToString(report.upload_explicitly_requested).c_str(),
+         report.total_size);
+}
+
+// Removes the reports that |options| filters out from |reports|, sorts the
+// rest as |options| requests, and then applies the limit in |options|.
+void SelectReports(const Options& options,
+                   std::vector<CrashReportDatabase::Report>* reports) {
+  reports->erase(
+      std::remove_if(reports->begin(),
+                     reports->end(),
+                     [&options](const CrashReportDatabase::Report& report) {
+                       return (options.created_after_string &&
+                               report.creation_time < options.created_after) ||
+                              (options.created_before_string &&
+                               report.creation_time >=
+                                   options.created_before) ||
+                              report.total_size < options.min_size ||
+                              (options.has_max_size &&
+                               report.total_size > options.max_size) ||
+                              (options.has_uploaded &&
+                               report.uploaded != options.uploaded);
+                     }),
+      reports->end());
+
+  if (options.sort_key != SortKey::kNone) {
+    auto key = [&options](const CrashReportDatabase::Report& report) {
+      switch (options.sort_key) {
+        case SortKey::kCreationTime:
+          return static_cast<uint64_t>(report.creation_time);
+        case SortKey::kLastUploadAttemptTime:
+          return static_cast<uint64_t>(report.last_upload_attempt_time);
+        case SortKey::kSize:
+          return report.total_size;
+        case SortKey::kUploadAttempts:
+          return static_cast<uint64_t>(report.upload_attempts);
+        case SortKey::kNone:
+          break;
+      }
+      return uint64_t{0};
+    };
+    // A stable sort keeps reports with equal keys in the database’s order,
+    // which --reverse doesn’t change.
+    std::stable_sort(reports->begin(),
+                     reports->end(),
+                     [&options, &key](const CrashReportDatabase::Report& a,
+                                      const CrashReportDatabase::Report& b) {
+                       return options.reverse ? key(a) > key(b)
+                                              : key(a) < key(b);
+                     });
+  }
+
+  if (options.has_limit && reports->size() > options.limit) {
+    reports->resize(options.limit);
+  }
+}
+
 // Shows information about a single |report|. |space_count| is the number of
 // spaces to print before each line that is printed. |utc| determines whether
 // times should be shown in UTC or the local time zone.
@@ -254,8 +427,16 @@ void ShowReport(const CrashReportDatabase::Report& report,
 // (options.show_all_report_info) and what time zone to use when showing
 // expanded information (options.utc).
 void ShowReports(const std::vector<CrashReportDatabase::Report>& reports,
+                 const char* state,
                  size_t space_count,
                  const Options& options) {
+  if (options.json) {
+    for (const CrashReportDatabase::Report& report : reports) {
+      ShowReportJSON(report, state);
+    }
+    return;
+  }
+
   std::string spaces(space_count, ' ');
   const char* colon = options.show_all_report_info ? ":" : "";
 
@@ -286,9 +467,20 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     kOptionShowCompletedReports,
     kOptionShowAllReportInfo,
     kOptionShowReport,
+    kOptionCreatedAfter,
+    kOptionCreatedBefore,
+    kOptionMinSize,
+    kOptionMaxSize,
+    kOptionUploaded,
+    kOptionSort,
+    kOptionReverse,
+    kOptionLimit,
+    kOptionJSON,
     kOptionSetUploadsEnabled,
     kOptionSetLastUploadAttemptTime,
     kOptionNewReport,
+    kOptionExport,
+    kOptionImport,
     kOptionUTC,
 
     // Standard options.
@@ -312,6 +504,15 @@ int DatabaseUtilMain(int argc, char* argv[]) {
        kOptionShowCompletedReports},
       {"show-all-report-info", no_argument, nullptr, kOptionShowAllReportInfo},
       {"show-report", required_argument, nullptr, kOptionShowReport},
+      {"created-after", required_argument, nullptr, kOptionCreatedAfter},
+      {"created-before", required_argument, nullptr, kOptionCreatedBefore},
+      {"min-size", required_argument, nullptr, kOptionMinSize},
+      {"max-size", required_argument, nullptr, kOptionMaxSize},
+      {"uploaded", required_argument, nullptr, kOptionUploaded},
+      {"sort", required_argument, nullptr, kOptionSort},
+      {"reverse", no_argument, nullptr, kOptionReverse},
+      {"limit", required_argument, nullptr, kOptionLimit},
+      {"json", no_argument, nullptr, kOptionJSON},
       {"set-uploads-enabled",
        required_argument,
        nullptr,
@@ -321,6 +522,8 @@ int DatabaseUtilMain(int argc, char* argv[]) {
        nullptr,
        kOptionSetLastUploadAttemptTime},
       {"new-report", required_argument, nullptr, kOptionNewReport},
+      {"export", required_argument, nullptr, kOptionExport},
+      {"import", required_argument, nullptr, kOptionImport},
       {"utc", no_argument, nullptr, kOptionUTC},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
@@ -373,6 +576,76 @@ int DatabaseUtilMain(int argc, char* argv[]) {
         options.show_reports.push_back(uuid);
         break;
       }
+      case kOptionCreatedAfter: {
+        options.created_after_string = optarg;
+        break;
+      }
+      case kOptionCreatedBefore: {
+        options.created_before_string = optarg;
+        break;
+      }
+      case kOptionMinSize: {
+        if (!StringToNumber(optarg, &options.min_size)) {
+          ToolSupport::UsageHint(me, "--min-size requires a BYTES count");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionMaxSize: {
+        if (!StringToNumber(optarg, &options.max_size)) {
+          ToolSupport::UsageHint(me, "--max-size requires a BYTES count");
+          return EXIT_FAILURE;
+        }
+        options.has_max_size = true;
+        break;
+      }
+      case kOptionUploaded: {
+        if (!StringToBool(optarg, &options.uploaded)) {
+          ToolSupport::UsageHint(me, "--uploaded requires a BOOL");
+          return EXIT_FAILURE;
+        }
+        options.has_uploaded = true;
+        break;
+      }
+      case kOptionSort: {
+        static constexpr struct {
+          const char* name;
+          SortKey key;
+        } kSortKeys[] = {
+            {"creation-time", SortKey::kCreationTime},
+            {"last-upload-attempt-time", SortKey::kLastUploadAttemptTime},
+            {"size", SortKey::kSize},
+            {"upload-attempts", SortKey::kUploadAttempts},
+        };
+        options.sort_key = SortKey::kNone;
+        for (const auto& sort_key : kSortKeys) {
+          if (strcmp(optarg, sort_key.name) == 0) {
+            options.sort_key = sort_key.key;
+            break;
+          }
+        }
+        if (options.sort_key == SortKey::kNone) {
+          ToolSupport::UsageHint(me, "--sort requires a KEY");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionReverse: {
+        options.reverse = true;
+        break;
+      }
+      case kOptionLimit: {
+        if (!StringToNumber(optarg, &options.limit)) {
+          ToolSupport::UsageHint(me, "--limit requires a number");
+          return EXIT_FAILURE;
+        }
+        options.has_limit = true;
+        break;
+      }
+      case kOptionJSON: {
+        options.json = true;
+        break;
+      }
       case kOptionSetUploadsEnabled: {
         if (!StringToBool(optarg, &options.set_uploads_enabled)) {
           ToolSupport::UsageHint(me, "--set-uploads-enabled requires a BOOL");
@@ -390,6 +663,14 @@ int DatabaseUtilMain(int argc, char* argv[]) {
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg)));
         break;
       }
+      case kOptionExport: {
+        options.export_path = optarg;
+        break;
+      }
+      case kOptionImport: {
+        options.import_path = optarg;
+        break;
+      }
       case kOptionUTC: {
         options.utc = true;
         break;
@@ -429,23 +710,56 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     }
   }
 
-  // --new-report is treated as a show operation because it produces output.
-  const size_t show_operations = options.show_client_id +
-                                 options.show_uploads_enabled +
-                                 options.show_last_upload_attempt_time +
-                                 options.show_pending_reports +
-                                 options.show_completed_reports +
-                                 options.show_reports.size() +
-                                 options.new_report_paths.size();
+  // Likewise, these filters depend on options.utc.
+  if (options.created_after_string &&
+      !StringToTime(
+          options.created_after_string, &options.created_after, options.utc)) {
+    ToolSupport::UsageHint(me, "--created-after requires a TIME");
+    return EXIT_FAILURE;
+  }
+  if (options.created_before_string &&
+      !StringToTime(options.created_before_string,
+                    &options.created_before,
+                    options.utc)) {
+    ToolSupport::UsageHint(me, "--created-before requires a TIME");
+    return EXIT_FAILURE;
+  }
+
+  // With --export, the options that show reports select them for export
+  // instead, and produce no output of their own.
+  const size_t report_selections = options.show_pending_reports +
+                                   options.show_completed_reports +
+                                   options.show_reports.size();
+
+  // --new-report and --import are treated as show operations because they
+  // produce output.
+  const size_t show_operations =
+      options.show_client_id + options.show_uploads_enabled +
+      options.show_last_upload_attempt_time +
+      (options.export_path ? 0 : report_selections) +
+      options.new_report_paths.size() + (options.import_path != nullptr);
   const size_t set_operations =
       options.has_set_uploads_enabled +
       (options.set_last_upload_attempt_time_string != nullptr);
 
-  if ((options.create ? 1 : 0) + show_operations + set_operations == 0) {
+  if ((options.create ? 1 : 0) + show_operations + set_operations +
+          (options.export_path != nullptr) ==
+      0) {
     ToolSupport::UsageHint(me, "nothing to do");
     return EXIT_FAILURE;
   }
 
+  if (options.export_path) {
+    if (report_selections == 0) {
+      ToolSupport::UsageHint(me, "--export requires reports to export");
+      return EXIT_FAILURE;
+    }
+    if (strcmp(options.export_path, "-") == 0 && show_operations > 0) {
+      ToolSupport::UsageHint(me, "--export=- can't be combined with output");
+      return EXIT_FAILURE;
+    }
+  }
+
   std::unique_ptr<CrashReportDatabase> database;
   base::FilePath database_path = base::FilePath(
       ToolSupport::CommandLineArgumentToFilePathStringType(options.database));
@@ -469,9 +783,13 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    const char* prefix = (show_operations > 1) ? "Client ID: " : "";
+    if (options.json) {
+      printf("{\"client_id\":\"%s\"}\n", client_id.ToString().c_str());
+    } else {
+      const char* prefix = (show_operations > 1) ? "Client ID: " : "";
 
-    printf("%s%s\n", prefix, client_id.ToString().c_str());
+      printf("%s%s\n", prefix, client_id.ToString().c_str());
+    }
   }
 
   if (options.show_uploads_enabled) {
@@ -480,9 +798,14 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    const char* prefix = (show_operations > 1) ? "Uploads enabled: " : "";
+    if (options.json) {
+      printf("{\"uploads_enabled\":%s}\n",
+             BoolToString(uploads_enabled).c_str());
+    } else {
+      const char* prefix = (show_operations > 1) ? "Uploads enabled: " : "";
 
-    printf("%s%s\n", prefix, BoolToString(uploads_enabled).c_str());
+      printf("%s%s\n", prefix, BoolToString(uploads_enabled).c_str());
+    }
   }
 
   if (options.show_last_upload_attempt_time) {
@@ -491,15 +814,21 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    const char* prefix =
-        (show_operations > 1) ? "Last upload attempt time: " : "";
+    if (options.json) {
+      printf("{\"last_upload_attempt_time\":%" PRId64 "}\n",
+             static_cast<int64_t>(last_upload_attempt_time));
+    } else {
+      const char* prefix =
+          (show_operations > 1) ? "Last upload attempt time: " : "";
 
-    printf("%s%s (%ld)\n",
-           prefix,
-           TimeToString(last_upload_attempt_time, options.utc).c_str(),
-           static_cast<long>(last_upload_attempt_time));
+      printf("%s%s (%ld)\n",
+             prefix,
+             TimeToString(last_upload_attempt_time, options.utc).c_str(),
+             static_cast<long>(last_upload_attempt_time));
+    }
   }
 
+  std::vector<UUID> export_uuids;
   if (options.show_pending_reports) {
     std::vector<CrashReportDatabase::Report> pending_reports;
     if (database->GetPendingReports(&pending_reports) !=
@@ -507,11 +836,20 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    if (show_operations > 1) {
-      printf("Pending reports:\n");
-    }
+    SelectReports(options, &pending_reports);
+
+    if (options.export_path) {
+      for (const CrashReportDatabase::Report& report : pending_reports) {
+        export_uuids.push_back(report.uuid);
+      }
+    } else {
+      if (show_operations > 1 && !options.json) {
+        printf("Pending reports:\n");
+      }
 
-    ShowReports(pending_reports, show_operations > 1 ? 2 : 0, options);
+      ShowReports(
+          pending_reports, "pending", show_operations > 1 ? 2 : 0, options);
+    }
   }
 
   if (options.show_completed_reports) {
@@ -521,36 +859,87 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    if (show_operations > 1) {
-      printf("Completed reports:\n");
-    }
+    SelectReports(options, &completed_reports);
+
+    if (options.export_path) {
+      for (const CrashReportDatabase::Report& report : completed_reports) {
+        export_uuids.push_back(report.uuid);
+      }
+    } else {
+      if (show_operations > 1 && !options.json) {
+        printf("Completed reports:\n");
+      }
 
-    ShowReports(completed_reports, show_operations > 1 ? 2 : 0, options);
+      ShowReports(completed_reports,
+                  "completed",
+                  show_operations > 1 ? 2 : 0,
+                  options);
+    }
   }
 
-  for (const UUID& uuid : options.show_reports) {
-    CrashReportDatabase::Report report;
-    CrashReportDatabase::OperationStatus status =
-        database->LookUpCrashReport(uuid, &report);
-    if (status == CrashReportDatabase::kNoError) {
-      if (show_operations > 1) {
-        printf("Report %s:\n", uuid.ToString().c_str());
-      }
-      ShowReport(report, show_operations > 1 ? 2 : 0, options.utc);
-    } else if (status == CrashReportDatabase::kReportNotFound) {
-      // If only asked to do one thing, a failure to find the single requested
-      // report should result in a failure exit status.
-      if (show_operations + set_operations == 1) {
-        fprintf(
-            stderr, "%" PRFilePath ": Report not found\n", me.value().c_str());
+  if (options.export_path) {
+    export_uuids.insert(export_uuids.end(),
+                        options.show_reports.begin(),
+                        options.show_reports.end());
+
+    std::unique_ptr<FileWriterInterface> file_writer;
+    if (strcmp(options.export_path, "-") == 0) {
+      file_writer.reset(new WeakFileHandleFileWriter(
+          StdioFileHandle(StdioStream::kStandardOutput)));
+    } else {
+      std::unique_ptr<FileWriter> file_path_writer(new FileWriter());
+      if (!file_path_writer->Open(
+              base::FilePath(
+                  ToolSupport::CommandLineArgumentToFilePathStringType(
+                      options.export_path)),
+              FileWriteMode::kTruncateOrCreate,
+              FilePermissions::kOwnerOnly)) {
         return EXIT_FAILURE;
       }
-      printf("Report %s not found\n", uuid.ToString().c_str());
-    } else {
+      file_writer = std::move(file_path_writer);
+    }
+
+    if (database->ExportReports(export_uuids, file_writer.get()) !=
+        CrashReportDatabase::kNoError) {
       return EXIT_FAILURE;
     }
   }
 
+  if (!options.export_path) {
+    for (const UUID& uuid : options.show_reports) {
+      CrashReportDatabase::Report report;
+      CrashReportDatabase::OperationStatus status =
+          database->LookUpCrashReport(uuid, &report);
+      if (status == CrashReportDatabase::kNoError) {
+        if (options.json) {
+          ShowReportJSON(report, nullptr);
+        } else {
+          if (show_operations > 1) {
+            printf("Report %s:\n", uuid.ToString().c_str());
+          }
+          ShowReport(report, show_operations > 1 ? 2 : 0, options.utc);
+        }
+      } else if (status == CrashReportDatabase::kReportNotFound) {
+        // If only asked to do one thing, a failure to find the single requested
+        // report should result in a failure exit status.
+        if (show_operations + set_operations == 1) {
+          fprintf(stderr,
+                  "%" PRFilePath ": Report not found\n",
+                  me.value().c_str());
+          return EXIT_FAILURE;
+        }
+        if (options.json) {
+          printf("{\"uuid\":\"%s\",\"error\":\"not found\"}\n",
+                 uuid.ToString().c_str());
+        } else {
+          printf("Report %s not found\n", uuid.ToString().c_str());
+        }
+      } else {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
   if (options.has_set_uploads_enabled &&
       !settings->SetUploadsEnabled(options.set_uploads_enabled)) {
     return EXIT_FAILURE;
@@ -611,8 +1000,58 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
-    const char* prefix = (show_operations > 1) ? "New report ID: " : "";
-    printf("%s%s\n", prefix, uuid.ToString().c_str());
+    if (options.json) {
+      printf("{\"new_report\":\"%s\"}\n", uuid.ToString().c_str());
+    } else {
+      const char* prefix = (show_operations > 1) ? "New report ID: " : "";
+      printf("%s%s\n", prefix, uuid.ToString().c_str());
+    }
+  }
+
+  if (options.import_path) {
+    std::unique_ptr<FileReaderInterface> file_reader;
+
+    if (strcmp(options.import_path, "-") == 0) {
+      if (used_stdin) {
+        fprintf(stderr,
+                "%" PRFilePath
+                ": Only one --new-report or --import may be read from "
+                "standard input\n",
+                me.value().c_str());
+        return EXIT_FAILURE;
+      }
+      file_reader.reset(new WeakFileHandleFileReader(
+          StdioFileHandle(StdioStream::kStandardInput)));
+    } else {
+      std::unique_ptr<FileReader> file_path_reader(new FileReader());
+      if (!file_path_reader->Open(base::FilePath(
+              ToolSupport::CommandLineArgumentToFilePathStringType(
+                  options.import_path)))) {
+        return EXIT_FAILURE;
+      }
+
+      file_reader = std::move(file_path_reader);
+    }
+
+    // Reports imported before a failure are shown too, since they remain in
+    // the database.
+    std::vector<std::pair<UUID, UUID>> uuids;
+    CrashReportDatabase::OperationStatus status =
+        database->ImportReports(file_reader.get(), &uuids);
+    for (const auto& [exported_uuid, uuid] : uuids) {
+      if (options.json) {
+        printf("{\"imported_report\":\"%s\",\"exported_report\":\"%s\"}\n",
+               uuid.ToString().c_str(),
+               exported_uuid.ToString().c_str());
+      } else {
+        const char* prefix =
+            (show_operations > 1) ? "Imported report ID: " : "";
+        printf("%s%s\n", prefix, uuid.ToString().c_str());
+      }
+    }
+    if (status != CrashReportDatabase::kNoError) {
+      return EXIT_FAILURE;
+    }
   }
 
   return EXIT_SUCCESS;
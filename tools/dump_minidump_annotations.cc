@@ -13,11 +13,18 @@
 // limitations under the License.
 
 #include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
-#include "client/annotation.h"
+#include "client/length_delimited_ring_buffer.h"
 #include "util/file/file_reader.h"
+#include "snapshot/annotation_snapshot.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/thread_snapshot.h"
 #include "tools/tool_support.h"
 
 namespace crashpad {
@@ -40,6 +47,30 @@ struct Options {
   const char* minidump;
 };
 
+// Prints each item of a serialized RingBufferData on a line of its own,
+// escaping bytes that aren’t printable. Returns false if value isn’t a ring
+// buffer.
+bool PrintRingBuffer(const std::vector<uint8_t>& value, const char* indent) {
+  LengthDelimitedRingBufferContents contents;
+  if (!contents.Initialize(value.data(), value.size())) {
+    return false;
+  }
+
+  printf("<ring buffer of %zu items>\n", contents.size());
+  for (size_t index = 0; index < contents.size(); ++index) {
+    printf("%s[%zu] = ", indent, index);
+    for (uint8_t byte : contents[index]) {
+      if (byte >= 0x20 && byte < 0x7f && byte != '\\') {
+        putchar(byte);
+      } else {
+        printf("\\x%02x", byte);
+      }
+    }
+    putchar('\n');
+  }
+  return true;
+}
+
 int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   const base::FilePath argv0(
       ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
@@ -123,19 +154,30 @@ int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
     printf("  Annotation Objects\n");
     for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
       printf("    annotation_objects[\"%s\"] = ", annotation.name.c_str());
-      if (annotation.type != static_cast<uint16_t>(Annotation::Type::kString)) {
-
-        printf("<non-string value, not printing>\n");
+      std::string value;
+      if (!annotation.ValueToString(&value)) {
+        if (!PrintRingBuffer(annotation.value, "      ")) {
+          printf("<value of type 0x%x, not printing>\n", annotation.type);
+        }
         continue;
       }
 
-      std::string value(reinterpret_cast<const char*>(annotation.value.data()),
-                        annotation.value.size());
-
       printf("%s\n", value.c_str());
     }
   }
 
+  for (const ThreadSnapshot* thread : snapshot.Threads()) {
+    const std::vector<uint8_t> breadcrumbs = thread->Breadcrumbs();
+    if (breadcrumbs.empty()) {
+      continue;
+    }
+    printf("Thread: %" PRIu64 "\n", thread->ThreadID());
+    printf("  Breadcrumbs = ");
+    if (!PrintRingBuffer(breadcrumbs, "    ")) {
+      printf("<invalid ring buffer, not printing>\n");
+    }
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,432 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "build/build_config.h"
+#include "snapshot/annotation_snapshot.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/module_snapshot.h"
+#include "tools/tool_support.h"
+#include "util/file/delimited_file_reader.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_reader.h"
+#include "util/file/filesystem.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]... [PATH]...\n"
+"Dump annotations, modules, and exceptions from minidumps as JSON.\n"
+"\n"
+"Each PATH may be a minidump file or a directory of minidump files.\n"
+"\n"
+"  -j, --jobs=N                    process N minidumps at a time\n"
+"  -m, --manifest=FILE             also process each path listed in FILE\n"
+"      --help                      display this help and exit\n"
+"      --version                   output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+struct Options {
+  std::vector<base::FilePath> paths;
+  const char* manifest;
+  unsigned int jobs;
+};
+
+std::string PathToUTF8(const base::FilePath& path) {
+#if BUILDFLAG(IS_WIN)
+  return base::WideToUTF8(path.value());
+#else
+  return path.value();
+#endif
+}
+
+// Appends |string| to |json| as a quoted JSON string.
+void AppendJSONString(std::string* json, const std::string& string) {
+  json->push_back('"');
+  for (const char c : string) {
+    switch (c) {
+      case '"':
+        json->append("\\\"");
+        break;
+      case '\\':
+        json->append("\\\\");
+        break;
+      case '\n':
+        json->append("\\n");
+        break;
+      case '\r':
+        json->append("\\r");
+        break;
+      case '\t':
+        json->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          base::StringAppendF(json, "\\u%04x", c);
+        } else {
+          json->push_back(c);
+        }
+        break;
+    }
+  }
+  json->push_back('"');
+}
+
+void AppendJSONStringMap(std::string* json,
+                         const std::map<std::string, std::string>& map) {
+  json->push_back('{');
+  bool first = true;
+  for (const auto& [key, value] : map) {
+    if (!first) {
+      json->push_back(',');
+    }
+    first = false;
+    AppendJSONString(json, key);
+    json->push_back(':');
+    AppendJSONString(json, value);
+  }
+  json->push_back('}');
+}
+
+// identity is null if the minidump has no identity for the module.
+void AppendJSONModule(std::string* json,
+                      const ModuleSnapshot* module,
+                      const ProcessSnapshotMinidump::ModuleIdentity* identity) {
+  json->append("{\"name\":");
+  AppendJSONString(json, module->Name());
+  base::StringAppendF(json,
+                      ",\"address\":%" PRIu64 ",\"size\":%" PRIu64,
+                      module->Address(),
+                      module->Size());
+
+  if (identity) {
+    json->append(",\"code_id\":");
+    AppendJSONString(json, identity->code_id);
+    json->append(",\"debug_id\":");
+    AppendJSONString(json, identity->debug_id);
+    json->append(",\"debug_file_name\":");
+    AppendJSONString(json, identity->debug_file_name);
+  }
+
+  json->append(",\"simple_annotations\":");
+  AppendJSONStringMap(json, module->AnnotationsSimpleMap());
+
+  json->append(",\"vectored_annotations\":[");
+  bool first = true;
+  for (const std::string& annotation : module->AnnotationsVector()) {
+    if (!first) {
+      json->push_back(',');
+    }
+    first = false;
+    AppendJSONString(json, annotation);
+  }
+  json->push_back(']');
+
+  // As with dump_minidump_annotations, only annotation objects with a textual
+  // representation are emitted.
+  std::map<std::string, std::string> annotation_objects;
+  for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
+    std::string value;
+    if (annotation.ValueToString(&value)) {
+      annotation_objects[annotation.name] = value;
+    }
+  }
+  json->append(",\"annotation_objects\":");
+  AppendJSONStringMap(json, annotation_objects);
+  json->push_back('}');
+}
+
+// Sets |json| to a single line of JSON describing the minidump at |path|.
+// Returns false if the minidump could not be read, in which case |json|
+// describes the error.
+bool DumpMinidump(const base::FilePath& path, std::string* json) {
+  json->assign("{\"path\":");
+  AppendJSONString(json, PathToUTF8(path));
+
+  FileReader reader;
+  ProcessSnapshotMinidump snapshot;
+  if (!reader.Open(path) || !snapshot.Initialize(&reader)) {
+    json->append(",\"error\":\"could not read minidump\"}\n");
+    return false;
+  }
+
+  json->append(",\"annotations\":");
+  AppendJSONStringMap(json, snapshot.AnnotationsSimpleMap());
+
+  std::map<uint64_t, const ProcessSnapshotMinidump::ModuleIdentity*>
+      identities;
+  for (const ProcessSnapshotMinidump::ModuleIdentity& identity :
+       snapshot.ModuleIdentities()) {
+    identities[identity.address] = &identity;
+  }
+
+  json->append(",\"modules\":[");
+  bool first = true;
+  for (const ModuleSnapshot* module : snapshot.Modules()) {
+    if (!first) {
+      json->push_back(',');
+    }
+    first = false;
+    const auto it = identities.find(module->Address());
+    AppendJSONModule(
+        json, module, it != identities.end() ? it->second : nullptr);
+  }
+  json->push_back(']');
+
+  json->append(",\"exception\":");
+  const ExceptionSnapshot* exception = snapshot.Exception();
+  if (exception) {
+    base::StringAppendF(json,
+                        "{\"thread_id\":%" PRIu64
+                        ",\"code\":%u,\"info\":%u,\"address\":%" PRIu64 "}",
+                        exception->ThreadID(),
+                        exception->Exception(),
+                        exception->ExceptionInfo(),
+                        exception->ExceptionAddress());
+  } else {
+    json->append("null");
+  }
+
+  json->append("}\n");
+  return true;
+}
+
+// Shared between the worker threads, each of which claims the next path in
+// turn and writes its result to stdout as a whole line.
+struct WorkQueue {
+  const std::vector<base::FilePath>* paths;
+  std::atomic<size_t> next_index;
+  std::atomic<bool> failed;
+  std::mutex output_mutex;
+};
+
+class DumpThread : public Thread {
+ public:
+  explicit DumpThread(WorkQueue* queue) : queue_(queue) {}
+
+  DumpThread(const DumpThread&) = delete;
+  DumpThread& operator=(const DumpThread&) = delete;
+
+  ~DumpThread() override {}
+
+ private:
+  void ThreadMain() override {
+    size_t index;
+    while ((index = queue_->next_index.fetch_add(1)) <
+           queue_->paths->size()) {
+      std::string json;
+      if (!DumpMinidump((*queue_->paths)[index], &json)) {
+        queue_->failed = true;
+      }
+
+      std::lock_guard<std::mutex> lock(queue_->output_mutex);
+      fwrite(json.data(), 1, json.size(), stdout);
+    }
+  }
+
+  WorkQueue* queue_;  // weak
+};
+
+// Appends |path| to |minidumps|, or the files directly within it if it is a
+// directory.
+bool AddMinidumpPath(const base::FilePath& path,
+                     std::vector<base::FilePath>* minidumps) {
+  if (!IsDirectory(path, true)) {
+    minidumps->push_back(path);
+    return true;
+  }
+
+  DirectoryReader reader;
+  if (!reader.Open(path)) {
+    return false;
+  }
+
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    const base::FilePath filepath(path.Append(filename));
+    if (IsRegularFile(filepath)) {
+      minidumps->push_back(filepath);
+    }
+  }
+  return result == DirectoryReader::Result::kNoMoreFiles;
+}
+
+bool AddManifestPaths(const base::FilePath& manifest,
+                      std::vector<base::FilePath>* minidumps) {
+  FileReader file_reader;
+  if (!file_reader.Open(manifest)) {
+    return false;
+  }
+
+  DelimitedFileReader delimited_reader(&file_reader);
+  std::string line;
+  DelimitedFileReader::Result result;
+  while ((result = delimited_reader.GetLine(&line)) ==
+         DelimitedFileReader::Result::kSuccess) {
+    if (!line.empty() && line.back() == '\n') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      continue;
+    }
+#if BUILDFLAG(IS_WIN)
+    const base::FilePath path(base::UTF8ToWide(line));
+#else
+    const base::FilePath path(line);
+#endif
+    if (!AddMinidumpPath(path, minidumps)) {
+      return false;
+    }
+  }
+  return result == DelimitedFileReader::Result::kEndOfFile;
+}
+
+int DumpMinidumpsMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Short options.
+    kOptionJobs = 'j',
+    kOptionManifest = 'm',
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"jobs", required_argument, nullptr, kOptionJobs},
+      {"manifest", required_argument, nullptr, kOptionManifest},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  Options options = {};
+  options.jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "j:m:", long_options, nullptr)) !=
+         -1) {
+    switch (opt) {
+      case kOptionJobs: {
+        if (!StringToNumber(optarg, &options.jobs) || options.jobs == 0) {
+          ToolSupport::UsageHint(me, "--jobs requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionManifest: {
+        options.manifest = optarg;
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc == 0 && !options.manifest) {
+    ToolSupport::UsageHint(me, "PATH or --manifest is required");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<base::FilePath> minidumps;
+  for (int index = 0; index < argc; ++index) {
+    if (!AddMinidumpPath(
+            base::FilePath(ToolSupport::CommandLineArgumentToFilePathStringType(
+                argv[index])),
+            &minidumps)) {
+      return EXIT_FAILURE;
+    }
+  }
+  if (options.manifest &&
+      !AddManifestPaths(
+          base::FilePath(ToolSupport::CommandLineArgumentToFilePathStringType(
+              options.manifest)),
+          &minidumps)) {
+    return EXIT_FAILURE;
+  }
+
+  WorkQueue queue;
+  queue.paths = &minidumps;
+  queue.next_index = 0;
+  queue.failed = false;
+
+  std::vector<std::unique_ptr<DumpThread>> threads;
+  const size_t thread_count =
+      std::min(static_cast<size_t>(options.jobs), minidumps.size());
+  for (size_t index = 0; index < thread_count; ++index) {
+    threads.push_back(std::make_unique<DumpThread>(&queue));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  return queue.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::DumpMinidumpsMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(argc, argv, crashpad::DumpMinidumpsMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
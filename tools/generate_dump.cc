@@ -17,17 +17,26 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "build/build_config.h"
 #include "minidump/minidump_file_writer.h"
+#include "snapshot/module_metadata_cache.h"
 #include "tools/tool_support.h"
 #include "util/file/file_writer.h"
 #include "util/process/process_id.h"
 #include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_POSIX)
 #include <unistd.h>
@@ -45,11 +54,17 @@
 #elif BUILDFLAG(IS_WIN)
 #include "base/strings/utf_string_conversions.h"
 #include "snapshot/win/process_snapshot_win.h"
+#include "util/win/scoped_handle.h"
 #include "util/win/scoped_process_suspend.h"
 #include "util/win/xp_compat.h"
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/linux/thread_snapshot_linux.h"
 #include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/proc_task_reader.h"
+#include "util/misc/clock.h"
+#include "util/misc/deadline.h"
 #endif  // BUILDFLAG(IS_APPLE)
 
 namespace crashpad {
@@ -58,11 +73,21 @@ namespace {
 void Usage(const base::FilePath& me) {
   // clang-format off
   fprintf(stderr,
-"Usage: %" PRFilePath " [OPTION]... PID\n"
-"Generate a minidump file containing a snapshot of a running process.\n"
+"Usage: %" PRFilePath " [OPTION]... PID...\n"
+"Generate a minidump file containing a snapshot of each running process.\n"
 "\n"
+"  -j, --jobs=N       generate N minidumps at a time\n"
 "  -r, --no-suspend   don't suspend the target process during dump generation\n"
-"  -o, --output=FILE  write the minidump to FILE instead of minidump.PID\n"
+"  -o, --output=FILE  write the minidump to FILE instead of minidump.PID, or\n"
+"                     to FILE.PID if more than one process is dumped\n"
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+"  -t, --tree         also dump the descendants of each PID\n"
+"      --samples=N    after the minidump, sample the threads N times and\n"
+"                     write the samples to the minidump's name + .samples\n"
+"      --sample-interval=MS\n"
+"                     take a sample every MS milliseconds (default 100)\n"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 "      --help         display this help and exit\n"
 "      --version      output version information and exit\n",
           me.value().c_str());
@@ -70,6 +95,343 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+struct Options {
+  std::string dump_path;
+  unsigned int jobs;
+  unsigned int samples;
+  unsigned int sample_interval_ms;
+  bool suspend;
+  bool tree;
+};
+
+// A process to dump. On macOS, the task port of every target is obtained
+// before privileges are dropped, so it’s held here. On Windows, the process is
+// opened up front too, so that a target that can’t be opened is reported
+// before any dump is generated.
+struct Target {
+  ProcessID pid;
+  std::string dump_path;
+#if BUILDFLAG(IS_APPLE)
+  base::apple::ScopedMachSendRight task;
+#elif BUILDFLAG(IS_WIN)
+  ScopedKernelHANDLE process;
+#endif  // BUILDFLAG(IS_APPLE)
+};
+
+// Suspends, snapshots, and writes a minidump for a single target. The target
+// is suspended once, for the whole of its own capture, and doesn’t wait on
+// any other target.
+bool GenerateDump(const Options& options,
+                  const Target& target,
+                  ModuleMetadataCache* module_metadata_cache) {
+#if BUILDFLAG(IS_APPLE)
+  const task_t task = target.task.get();
+  std::unique_ptr<ScopedTaskSuspend> suspend;
+  if (options.suspend) {
+    suspend.reset(new ScopedTaskSuspend(task));
+  }
+
+  ProcessSnapshotMac process_snapshot;
+  if (!process_snapshot.Initialize(task)) {
+    return false;
+  }
+#elif BUILDFLAG(IS_WIN)
+  std::unique_ptr<ScopedProcessSuspend> suspend;
+  if (options.suspend) {
+    suspend.reset(new ScopedProcessSuspend(target.process.get()));
+  }
+
+  ProcessSnapshotWin process_snapshot;
+  if (!process_snapshot.Initialize(target.process.get(),
+                                   options.suspend
+                                       ? ProcessSuspensionState::kSuspended
+                                       : ProcessSuspensionState::kRunning,
+                                   0,
+                                   0,
+                                   nullptr,
+                                   module_metadata_cache)) {
+    return false;
+  }
+#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // TODO(jperaza): https://crashpad.chromium.org/bug/30.
+  DirectPtraceConnection task;
+  if (!task.Initialize(target.pid)) {
+    return false;
+  }
+  ProcessSnapshotLinux process_snapshot;
+  if (!process_snapshot.Initialize(
+          &task, 0, 0, Deadline(), module_metadata_cache)) {
+    return false;
+  }
+  process_snapshot.CaptureIndirectlyReferencedMemory();
+#endif  // BUILDFLAG(IS_APPLE)
+
+  FileWriter file_writer;
+  base::FilePath dump_path(
+      ToolSupport::CommandLineArgumentToFilePathStringType(target.dump_path));
+  if (!file_writer.Open(dump_path,
+                        FileWriteMode::kTruncateOrCreate,
+                        FilePermissions::kWorldReadable)) {
+    return false;
+  }
+
+  MinidumpFileWriter minidump;
+  minidump.InitializeFromSnapshot(&process_snapshot);
+  if (!minidump.WriteEverything(&file_writer)) {
+    file_writer.Close();
+    if (unlink(target.dump_path.c_str()) != 0) {
+      PLOG(ERROR) << "unlink";
+    }
+    return false;
+  }
+  return true;
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The layout of a series file written by --samples. All fields are in the
+// byte order of the system that wrote the file. The file begins with a
+// SeriesHeader, followed by a SampleHeader for each sample. Each SampleHeader
+// is followed by a ThreadSampleHeader for each of the sample’s threads, and
+// each ThreadSampleHeader by its stack_size bytes of stack, padded to a
+// multiple of 8 bytes.
+struct SeriesHeader {
+  static constexpr uint32_t kSignature = 'CPss';
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t signature;
+  uint32_t version;
+  uint32_t pid;
+  uint32_t sample_interval_ms;
+};
+
+struct SampleHeader {
+  // The time of the sample relative to the start of the minidump’s capture.
+  uint64_t time_ns;
+  uint32_t thread_count;
+  uint32_t reserved;
+};
+
+struct ThreadSampleHeader {
+  // The thread’s registers and stack are the same as in its previous sample,
+  // so they aren’t repeated. stack_size is 0.
+  static constexpr uint32_t kFlagUnchanged = 1 << 0;
+
+  uint32_t tid;
+  uint32_t flags;
+  uint64_t instruction_pointer;
+  uint64_t stack_pointer;
+  uint64_t stack_address;
+  uint32_t stack_size;
+  uint32_t reserved;
+};
+
+// The most stack bytes recorded for a thread in each sample, enough to scan
+// for the return addresses of the innermost frames.
+constexpr size_t kMaxSampleStackSize = 16 * 1024;
+
+struct ThreadSample {
+  uint64_t instruction_pointer;
+  uint64_t stack_pointer;
+  uint64_t stack_address;
+  std::vector<uint8_t> stack;
+};
+
+// Takes a single sample of the target’s threads. The target is stopped only
+// while its registers and stacks are read, and no modules are read at all:
+// those are in the minidump that precedes the series.
+bool SampleThreads(pid_t pid, std::map<pid_t, ThreadSample>* threads) {
+  threads->clear();
+
+  DirectPtraceConnection connection;
+  if (!connection.Initialize(pid)) {
+    return false;
+  }
+  ProcessReaderLinux process_reader;
+  if (!process_reader.Initialize(&connection, 0)) {
+    return false;
+  }
+  process_reader.SetReadThreadFloatingPoint(false);
+
+  for (const ProcessReaderLinux::Thread& thread : process_reader.Threads()) {
+    internal::ThreadSnapshotLinux thread_snapshot;
+    if (!thread_snapshot.Initialize(&process_reader, thread, nullptr)) {
+      continue;
+    }
+
+    ThreadSample& sample = (*threads)[thread.tid];
+    sample.instruction_pointer =
+        thread_snapshot.Context()->InstructionPointer();
+    sample.stack_pointer = thread_snapshot.Context()->StackPointer();
+    sample.stack_address = thread.stack_region_address;
+    sample.stack.resize(
+        std::min(static_cast<size_t>(thread.stack_region_size),
+                 kMaxSampleStackSize));
+    if (!sample.stack.empty() &&
+        !process_reader.Memory()->Read(
+            sample.stack_address, sample.stack.size(), sample.stack.data())) {
+      sample.stack.clear();
+    }
+  }
+  return true;
+}
+
+bool WriteThreadSamples(FileWriterInterface* file_writer,
+                        uint64_t time_ns,
+                        const std::map<pid_t, ThreadSample>& threads,
+                        const std::map<pid_t, ThreadSample>& previous) {
+  SampleHeader sample_header = {};
+  sample_header.time_ns = time_ns;
+  sample_header.thread_count = static_cast<uint32_t>(threads.size());
+  if (!file_writer->Write(&sample_header, sizeof(sample_header))) {
+    return false;
+  }
+
+  static constexpr uint8_t kPadding[8] = {};
+  for (const auto& [tid, sample] : threads) {
+    ThreadSampleHeader thread_header = {};
+    thread_header.tid = tid;
+
+    const auto it = previous.find(tid);
+    if (it != previous.end() &&
+        it->second.instruction_pointer == sample.instruction_pointer &&
+        it->second.stack_pointer == sample.stack_pointer &&
+        it->second.stack_address == sample.stack_address &&
+        it->second.stack == sample.stack) {
+      // A hung thread usually looks the same in every sample.
+      thread_header.flags = ThreadSampleHeader::kFlagUnchanged;
+      if (!file_writer->Write(&thread_header, sizeof(thread_header))) {
+        return false;
+      }
+      continue;
+    }
+
+    thread_header.instruction_pointer = sample.instruction_pointer;
+    thread_header.stack_pointer = sample.stack_pointer;
+    thread_header.stack_address = sample.stack_address;
+    thread_header.stack_size = static_cast<uint32_t>(sample.stack.size());
+    std::vector<WritableIoVec> iov;
+    iov.push_back({&thread_header, sizeof(thread_header)});
+    if (!sample.stack.empty()) {
+      iov.push_back({sample.stack.data(), sample.stack.size()});
+    }
+    const size_t padding = (8 - sample.stack.size() % 8) % 8;
+    if (padding) {
+      iov.push_back({kPadding, padding});
+    }
+    if (!file_writer->WriteIoVec(&iov)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Samples the target’s threads at the interval given by the options, after
+// its minidump has been written. start_ns is when the minidump’s capture
+// began. Sampling stops early, without failing, if the target exits.
+bool GenerateSeries(const Options& options,
+                    const Target& target,
+                    uint64_t start_ns) {
+  const std::string series_path = target.dump_path + ".samples";
+  FileWriter file_writer;
+  if (!file_writer.Open(
+          base::FilePath(
+              ToolSupport::CommandLineArgumentToFilePathStringType(
+                  series_path)),
+          FileWriteMode::kTruncateOrCreate,
+          FilePermissions::kWorldReadable)) {
+    return false;
+  }
+
+  SeriesHeader series_header = {};
+  series_header.signature = SeriesHeader::kSignature;
+  series_header.version = SeriesHeader::kVersion;
+  series_header.pid = target.pid;
+  series_header.sample_interval_ms = options.sample_interval_ms;
+  if (!file_writer.Write(&series_header, sizeof(series_header))) {
+    return false;
+  }
+
+  const uint64_t interval_ns =
+      static_cast<uint64_t>(options.sample_interval_ms) * 1000000;
+  uint64_t next_ns = start_ns;
+  std::map<pid_t, ThreadSample> previous;
+  std::map<pid_t, ThreadSample> threads;
+  for (unsigned int index = 0; index < options.samples; ++index) {
+    // Samples are spaced from when each was due rather than from when the
+    // last one finished, so that slow samples don’t stretch the series.
+    next_ns += interval_ns;
+    const uint64_t now_ns = ClockMonotonicNanoseconds();
+    if (next_ns > now_ns) {
+      SleepNanoseconds(next_ns - now_ns);
+    }
+
+    const uint64_t time_ns = ClockMonotonicNanoseconds() - start_ns;
+    if (!SampleThreads(target.pid, &threads)) {
+      LOG(WARNING) << "process " << target.pid << " stopped after " << index
+                   << " samples";
+      break;
+    }
+    if (!WriteThreadSamples(&file_writer, time_ns, threads, previous)) {
+      return false;
+    }
+    std::swap(previous, threads);
+  }
+  return true;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+// Shared between the worker threads, each of which claims the next target in
+// turn. Module metadata derived from one target’s images is reused for every
+// other target that maps the same files.
+struct WorkQueue {
+  const Options* options;
+  const std::vector<Target>* targets;
+  ModuleMetadataCache module_metadata_cache;
+  std::atomic<size_t> next_index;
+  std::atomic<bool> failed;
+};
+
+class DumpThread : public Thread {
+ public:
+  explicit DumpThread(WorkQueue* queue) : queue_(queue) {}
+
+  DumpThread(const DumpThread&) = delete;
+  DumpThread& operator=(const DumpThread&) = delete;
+
+  ~DumpThread() override {}
+
+ private:
+  void ThreadMain() override {
+    size_t index;
+    while ((index = queue_->next_index.fetch_add(1)) <
+           queue_->targets->size()) {
+      const Target& target = (*queue_->targets)[index];
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      const uint64_t start_ns = ClockMonotonicNanoseconds();
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      if (!GenerateDump(
+              *queue_->options, target, &queue_->module_metadata_cache)) {
+        LOG(ERROR) << "failed to generate a minidump for process "
+                   << target.pid;
+        queue_->failed = true;
+        continue;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      if (queue_->options->samples > 0 &&
+          !GenerateSeries(*queue_->options, target, start_ns)) {
+        LOG(ERROR) << "failed to sample process " << target.pid;
+        queue_->failed = true;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    }
+  }
+
+  WorkQueue* queue_;  // weak
+};
+
 int GenerateDumpMain(int argc, char* argv[]) {
   const base::FilePath argv0(
       ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
@@ -77,41 +439,80 @@ int GenerateDumpMain(int argc, char* argv[]) {
 
   enum OptionFlags {
     // “Short” (single-character) options.
+    kOptionJobs = 'j',
     kOptionOutput = 'o',
     kOptionNoSuspend = 'r',
+    kOptionTree = 't',
 
     // Long options without short equivalents.
     kOptionLastChar = 255,
+    kOptionSamples,
+    kOptionSampleInterval,
 
     // Standard options.
     kOptionHelp = -2,
     kOptionVersion = -3,
   };
 
-  struct {
-    std::string dump_path;
-    ProcessID pid;
-    bool suspend;
-  } options = {};
+  Options options = {};
+  options.jobs = std::max(1u, std::thread::hardware_concurrency());
+  options.sample_interval_ms = 100;
   options.suspend = true;
 
   static constexpr option long_options[] = {
+      {"jobs", required_argument, nullptr, kOptionJobs},
       {"no-suspend", no_argument, nullptr, kOptionNoSuspend},
       {"output", required_argument, nullptr, kOptionOutput},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      {"tree", no_argument, nullptr, kOptionTree},
+      {"samples", required_argument, nullptr, kOptionSamples},
+      {"sample-interval", required_argument, nullptr, kOptionSampleInterval},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
       {nullptr, 0, nullptr, 0},
   };
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  static constexpr char kShortOptions[] = "j:o:rt";
+#else
+  static constexpr char kShortOptions[] = "j:o:r";
+#endif
+
   int opt;
-  while ((opt = getopt_long(argc, argv, "o:r", long_options, nullptr)) != -1) {
+  while ((opt = getopt_long(
+              argc, argv, kShortOptions, long_options, nullptr)) != -1) {
     switch (opt) {
+      case kOptionJobs:
+        if (!StringToNumber(optarg, &options.jobs) || options.jobs == 0) {
+          ToolSupport::UsageHint(me, "--jobs requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
       case kOptionOutput:
         options.dump_path = optarg;
         break;
       case kOptionNoSuspend:
         options.suspend = false;
         break;
+      case kOptionTree:
+        options.tree = true;
+        break;
+      case kOptionSamples:
+        if (!StringToNumber(optarg, &options.samples)) {
+          ToolSupport::UsageHint(me, "--samples requires an integer");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionSampleInterval:
+        if (!StringToNumber(optarg, &options.sample_interval_ms) ||
+            options.sample_interval_ms == 0) {
+          ToolSupport::UsageHint(
+              me, "--sample-interval requires a positive integer");
+          return EXIT_FAILURE;
+        }
+        break;
       case kOptionHelp:
         Usage(me);
         return EXIT_SUCCESS;
@@ -126,113 +527,108 @@ int GenerateDumpMain(int argc, char* argv[]) {
   argc -= optind;
   argv += optind;
 
-  if (argc != 1) {
+  if (argc < 1) {
     ToolSupport::UsageHint(me, "PID is required");
     return EXIT_FAILURE;
   }
 
-  if (!StringToNumber(argv[0], &options.pid) || options.pid <= 0) {
-    fprintf(stderr,
-            "%" PRFilePath ": invalid PID: %s\n",
-            me.value().c_str(),
-            argv[0]);
-    return EXIT_FAILURE;
-  }
-
-#if BUILDFLAG(IS_APPLE)
-  task_t task = TaskForPID(options.pid);
-  if (task == TASK_NULL) {
-    return EXIT_FAILURE;
-  }
-  base::apple::ScopedMachSendRight task_owner(task);
-
-  // This tool may have been installed as a setuid binary so that TaskForPID()
-  // could succeed. Drop any privileges now that they’re no longer necessary.
-  DropPrivileges();
-
-  if (options.pid == getpid()) {
-    if (options.suspend) {
-      LOG(ERROR) << "cannot suspend myself";
+  std::vector<ProcessID> pids;
+  std::set<ProcessID> seen_pids;
+  for (int index = 0; index < argc; ++index) {
+    ProcessID pid;
+    if (!StringToNumber(argv[index], &pid) || pid <= 0) {
+      fprintf(stderr,
+              "%" PRFilePath ": invalid PID: %s\n",
+              me.value().c_str(),
+              argv[index]);
       return EXIT_FAILURE;
     }
-    LOG(WARNING) << "operating on myself";
-  }
-#elif BUILDFLAG(IS_WIN)
-  ScopedKernelHANDLE process(
-      OpenProcess(kXPProcessAllAccess, false, options.pid));
-  if (!process.is_valid()) {
-    PLOG(ERROR) << "could not open process " << options.pid;
-    return EXIT_FAILURE;
-  }
-#endif  // BUILDFLAG(IS_APPLE)
+    if (seen_pids.insert(pid).second) {
+      pids.push_back(pid);
+    }
 
-  if (options.dump_path.empty()) {
-    options.dump_path = base::StringPrintf("minidump.%" PRI_PROCESS_ID,
-                                           options.pid);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    if (options.tree) {
+      std::vector<pid_t> descendants;
+      if (!ReadDescendantProcessIDs(pid, &descendants)) {
+        return EXIT_FAILURE;
+      }
+      for (pid_t descendant : descendants) {
+        if (descendant != getpid() && seen_pids.insert(descendant).second) {
+          pids.push_back(descendant);
+        }
+      }
+    }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   }
 
-  {
+  bool failed = false;
+  std::vector<Target> targets;
+  for (ProcessID pid : pids) {
+    Target target;
+    target.pid = pid;
+    if (options.dump_path.empty()) {
+      target.dump_path = base::StringPrintf("minidump.%" PRI_PROCESS_ID, pid);
+    } else if (pids.size() == 1) {
+      target.dump_path = options.dump_path;
+    } else {
+      target.dump_path =
+          base::StringPrintf("%s.%" PRI_PROCESS_ID, options.dump_path.c_str(),
+                             pid);
+    }
+
 #if BUILDFLAG(IS_APPLE)
-    std::unique_ptr<ScopedTaskSuspend> suspend;
-    if (options.suspend) {
-      suspend.reset(new ScopedTaskSuspend(task));
+    if (pid == getpid()) {
+      if (options.suspend) {
+        LOG(ERROR) << "cannot suspend myself";
+        failed = true;
+        continue;
+      }
+      LOG(WARNING) << "operating on myself";
+    }
+
+    target.task.reset(TaskForPID(pid));
+    if (target.task.get() == TASK_NULL) {
+      failed = true;
+      continue;
     }
 #elif BUILDFLAG(IS_WIN)
-    std::unique_ptr<ScopedProcessSuspend> suspend;
-    if (options.suspend) {
-      suspend.reset(new ScopedProcessSuspend(process.get()));
+    target.process.reset(OpenProcess(kXPProcessAllAccess, false, pid));
+    if (!target.process.is_valid()) {
+      PLOG(ERROR) << "could not open process " << pid;
+      failed = true;
+      continue;
     }
 #endif  // BUILDFLAG(IS_APPLE)
 
+    targets.push_back(std::move(target));
+  }
+
 #if BUILDFLAG(IS_APPLE)
-    ProcessSnapshotMac process_snapshot;
-    if (!process_snapshot.Initialize(task)) {
-      return EXIT_FAILURE;
-    }
-#elif BUILDFLAG(IS_WIN)
-    ProcessSnapshotWin process_snapshot;
-    if (!process_snapshot.Initialize(process.get(),
-                                     options.suspend
-                                         ? ProcessSuspensionState::kSuspended
-                                         : ProcessSuspensionState::kRunning,
-                                     0,
-                                     0)) {
-      return EXIT_FAILURE;
-    }
-#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
-    // TODO(jperaza): https://crashpad.chromium.org/bug/30.
-    DirectPtraceConnection task;
-    if (!task.Initialize(options.pid)) {
-      return EXIT_FAILURE;
-    }
-    ProcessSnapshotLinux process_snapshot;
-    if (!process_snapshot.Initialize(&task)) {
-      return EXIT_FAILURE;
-    }
+  // This tool may have been installed as a setuid binary so that TaskForPID()
+  // could succeed. Drop any privileges now that they’re no longer necessary.
+  DropPrivileges();
 #endif  // BUILDFLAG(IS_APPLE)
 
-    FileWriter file_writer;
-    base::FilePath dump_path(
-        ToolSupport::CommandLineArgumentToFilePathStringType(
-            options.dump_path));
-    if (!file_writer.Open(dump_path,
-                          FileWriteMode::kTruncateOrCreate,
-                          FilePermissions::kWorldReadable)) {
-      return EXIT_FAILURE;
-    }
+  WorkQueue queue;
+  queue.options = &options;
+  queue.targets = &targets;
+  queue.next_index = 0;
+  queue.failed = false;
 
-    MinidumpFileWriter minidump;
-    minidump.InitializeFromSnapshot(&process_snapshot);
-    if (!minidump.WriteEverything(&file_writer)) {
-      file_writer.Close();
-      if (unlink(options.dump_path.c_str()) != 0) {
-        PLOG(ERROR) << "unlink";
-      }
-      return EXIT_FAILURE;
-    }
+  std::vector<std::unique_ptr<DumpThread>> threads;
+  const size_t thread_count =
+      std::min(static_cast<size_t>(options.jobs), targets.size());
+  for (size_t index = 0; index < thread_count; ++index) {
+    threads.push_back(std::make_unique<DumpThread>(&queue));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
   }
 
-  return EXIT_SUCCESS;
+  return failed || queue.failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 }  // namespace
@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+BufferedFileWriter::BufferedFileWriter(FileWriterInterface* underlying,
+                                       size_t capacity)
+    : buffer_(),
+      underlying_(underlying),
+      buffer_offset_(-1),
+      capacity_(capacity),
+      failed_(false) {
+  DCHECK(underlying_);
+  DCHECK_GT(capacity_, 0u);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  Flush();
+}
+
+bool BufferedFileWriter::Flush() {
+  if (failed_) {
+    return false;
+  }
+  if (buffer_.empty()) {
+    return true;
+  }
+
+  if (!underlying_->Write(buffer_.data(), buffer_.size())) {
+    // Nothing more can be written coherently after a lost block.
+    failed_ = true;
+    buffer_.clear();
+    return false;
+  }
+
+  if (buffer_offset_ >= 0) {
+    buffer_offset_ += buffer_.size();
+  }
+  buffer_.clear();
+  return true;
+}
+
+bool BufferedFileWriter::Write(const void* data, size_t size) {
+  if (failed_) {
+    return false;
+  }
+
+  if (size >= capacity_) {
+    if (!Flush()) {
+      return false;
+    }
+    if (!underlying_->Write(data, size)) {
+      failed_ = true;
+      return false;
+    }
+    if (buffer_offset_ >= 0) {
+      buffer_offset_ += size;
+    }
+    return true;
+  }
+
+  if (buffer_.size() + size > capacity_ && !Flush()) {
+    return false;
+  }
+
+  if (buffer_.capacity() < capacity_) {
+    buffer_.reserve(capacity_);
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+  return true;
+}
+
+bool BufferedFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "no iovecs";
+    return false;
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FileHandle BufferedFileWriter::UnderlyingFileHandle() {
+  if (!Flush()) {
+    return kInvalidFileHandle;
+  }
+
+  // The caller may move the file position by writing through the handle, so
+  // the next position query must go to the wrapped writer.
+  buffer_offset_ = -1;
+  return underlying_->UnderlyingFileHandle();
+}
+
+FileOffset BufferedFileWriter::Seek(FileOffset offset, int whence) {
+  if (whence == SEEK_CUR && offset == 0 && buffer_offset_ >= 0) {
+    return buffer_offset_ + buffer_.size();
+  }
+
+  if (!Flush()) {
+    return -1;
+  }
+
+  buffer_offset_ = underlying_->Seek(offset, whence);
+  return buffer_offset_;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,98 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
+#define CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file writer that gathers small writes into large blocks before
+//!     passing them to another FileWriterInterface.
+//!
+//! Minidump writing produces a long run of small pieces: headers, directory
+//! entries, strings, and individual stack or memory ranges. Writing each of
+//! these with its own system call is costly for large dumps. This class
+//! holds pieces in a buffer of fixed capacity and hands them to the wrapped
+//! writer in one call when the buffer fills, when Flush() is called, or when
+//! an operation needs the wrapped writer to be current.
+//!
+//! Pieces at least as large as the buffer are written to the wrapped writer
+//! directly, after any buffered data, without being copied.
+//!
+//! Seek() is supported. Asking for the current position is answered without
+//! flushing. Any other seek flushes buffered data first.
+class BufferedFileWriter : public FileWriterInterface {
+ public:
+  //! \brief The buffer capacity used when none is specified.
+  static constexpr size_t kDefaultCapacity = 1024 * 1024;
+
+  //! \param[in] underlying The writer that receives the coalesced data. This
+  //!     object does not take ownership of \a underlying, which must outlive
+  //!     it.
+  //! \param[in] capacity The size of the buffer, in bytes.
+  explicit BufferedFileWriter(FileWriterInterface* underlying,
+                              size_t capacity = kDefaultCapacity);
+
+  BufferedFileWriter(const BufferedFileWriter&) = delete;
+  BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+  //! \brief Flushes any remaining buffered data.
+  //!
+  //! Callers that need to know whether the data reached the wrapped writer
+  //! should call Flush() themselves before destruction.
+  ~BufferedFileWriter() override;
+
+  //! \brief Writes all buffered data to the wrapped writer.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged by
+  //!     the wrapped writer. Once a write has failed, this method continues
+  //!     to return `false`.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  //! \copydoc FileWriterInterface::UnderlyingFileHandle()
+  //!
+  //! Buffered data is flushed first so that the file position reported by
+  //! the handle accounts for everything written through this object. If the
+  //! flush fails, kInvalidFileHandle is returned.
+  FileHandle UnderlyingFileHandle() override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  std::vector<uint8_t> buffer_;
+  FileWriterInterface* underlying_;  // weak
+
+  // The offset in the wrapped writer at which buffer_ begins, or -1 if not
+  // yet known.
+  FileOffset buffer_offset_;
+
+  size_t capacity_;
+  bool failed_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
@@ -0,0 +1,172 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A StringFile that counts the writes that reach it.
+class CountingStringFile : public StringFile {
+ public:
+  CountingStringFile() : StringFile(), writes_(0) {}
+
+  CountingStringFile(const CountingStringFile&) = delete;
+  CountingStringFile& operator=(const CountingStringFile&) = delete;
+
+  ~CountingStringFile() override = default;
+
+  bool Write(const void* data, size_t size) override {
+    ++writes_;
+    return StringFile::Write(data, size);
+  }
+
+  size_t writes() const { return writes_; }
+
+ private:
+  size_t writes_;
+};
+
+TEST(BufferedFileWriter, CoalescesSmallWrites) {
+  CountingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 16);
+
+  EXPECT_TRUE(writer.Write("abc", 3));
+  EXPECT_TRUE(writer.Write("defg", 4));
+  EXPECT_EQ(string_file.writes(), 0u);
+  EXPECT_TRUE(string_file.string().empty());
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.writes(), 1u);
+  EXPECT_EQ(string_file.string(), "abcdefg");
+
+  // Flushing with nothing buffered does not write.
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.writes(), 1u);
+}
+
+TEST(BufferedFileWriter, FlushesWhenFull) {
+  CountingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 8);
+
+  EXPECT_TRUE(writer.Write("01234", 5));
+  EXPECT_TRUE(writer.Write("567", 3));
+  EXPECT_EQ(string_file.writes(), 0u);
+
+  // This doesn’t fit behind the eight buffered bytes.
+  EXPECT_TRUE(writer.Write("89", 2));
+  EXPECT_EQ(string_file.writes(), 1u);
+  EXPECT_EQ(string_file.string(), "01234567");
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.writes(), 2u);
+  EXPECT_EQ(string_file.string(), "0123456789");
+}
+
+TEST(BufferedFileWriter, LargeWritePassesThrough) {
+  CountingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 4);
+
+  EXPECT_TRUE(writer.Write("ab", 2));
+  const std::string large(10, 'x');
+  EXPECT_TRUE(writer.Write(large.data(), large.size()));
+  EXPECT_EQ(string_file.writes(), 2u);
+  EXPECT_EQ(string_file.string(), "ab" + large);
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.writes(), 2u);
+}
+
+TEST(BufferedFileWriter, WriteIoVec) {
+  CountingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 64);
+
+  std::vector<WritableIoVec> iovecs;
+  EXPECT_FALSE(writer.WriteIoVec(&iovecs));
+
+  WritableIoVec iov;
+  iov.iov_base = "Hello, ";
+  iov.iov_len = 7;
+  iovecs.push_back(iov);
+  iov.iov_base = "world";
+  iov.iov_len = 5;
+  iovecs.push_back(iov);
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+  EXPECT_EQ(string_file.writes(), 0u);
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.writes(), 1u);
+  EXPECT_EQ(string_file.string(), "Hello, world");
+}
+
+TEST(BufferedFileWriter, Seek) {
+  CountingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 64);
+
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 0);
+  EXPECT_TRUE(writer.Write("header", 6));
+  EXPECT_TRUE(writer.Write("body", 4));
+
+  // Querying the position does not flush.
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 10);
+  EXPECT_EQ(string_file.writes(), 0u);
+
+  // Seeking elsewhere does, so that a header can be rewritten in place.
+  EXPECT_EQ(writer.Seek(0, SEEK_SET), 0);
+  EXPECT_EQ(string_file.writes(), 1u);
+  EXPECT_TRUE(writer.Write("HEADER", 6));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 6);
+  EXPECT_EQ(writer.Seek(0, SEEK_END), 10);
+  EXPECT_EQ(string_file.string(), "HEADERbody");
+
+  EXPECT_TRUE(writer.Write("tail", 4));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 14);
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "HEADERbodytail");
+}
+
+TEST(BufferedFileWriter, FlushesOnDestruction) {
+  StringFile string_file;
+  {
+    BufferedFileWriter writer(&string_file);
+    EXPECT_TRUE(writer.Write("pending", 7));
+    EXPECT_TRUE(string_file.string().empty());
+  }
+  EXPECT_EQ(string_file.string(), "pending");
+}
+
+TEST(BufferedFileWriter, UnderlyingFileHandle) {
+  StringFile string_file;
+  BufferedFileWriter writer(&string_file);
+
+  EXPECT_TRUE(writer.Write("data", 4));
+  EXPECT_EQ(writer.UnderlyingFileHandle(), kInvalidFileHandle);
+
+  // Buffered data was flushed before the handle was requested.
+  EXPECT_EQ(string_file.string(), "data");
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 4);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
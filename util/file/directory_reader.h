@@ -15,10 +15,16 @@
 #ifndef CRASHPAD_UTIL_FILE_DIRECTORY_READER_H_
 #define CRASHPAD_UTIL_FILE_DIRECTORY_READER_H_
 
+#include <stdint.h>
+
+#include <memory>
+
 #include "base/files/file_path.h"
 #include "build/build_config.h"
 
-#if BUILDFLAG(IS_POSIX)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "util/file/file_io.h"
+#elif BUILDFLAG(IS_POSIX)
 #include "util/posix/scoped_dir.h"
 #elif BUILDFLAG(IS_WIN)
 #include <windows.h>
@@ -46,6 +52,21 @@ class DirectoryReader {
     kNoMoreFiles,
   };
 
+  //! \brief The type of a file found by NextFile().
+  enum class FileType {
+    //! \brief A regular file.
+    kRegularFile,
+
+    //! \brief A directory.
+    kDirectory,
+
+    //! \brief A symbolic link, which is not followed.
+    kSymbolicLink,
+
+    //! \brief Anything else, such as a socket or device.
+    kOther,
+  };
+
   DirectoryReader();
 
   DirectoryReader(const DirectoryReader&) = delete;
@@ -67,7 +88,37 @@ class DirectoryReader {
   //!     logged.
   Result NextFile(base::FilePath* filename);
 
+  //! \brief Advances the reader to the next file in the directory, and
+  //!     determines its type.
+  //!
+  //! The type is usually known from the directory entry itself, so this is
+  //! cheaper than examining each file by name. On POSIX, where the file
+  //! system doesn’t record the type in directory entries, the file is
+  //! examined with `fstatat()` relative to the directory.
+  //!
+  //! \param[out] filename The filename of the next file.
+  //! \param[out] type The type of the next file.
+  //! \return a #Result value. \a filename and \a type are only valid when
+  //!     Result::kSuccess is returned. If Result::kError is returned, a
+  //!     message will be logged.
+  Result NextFile(base::FilePath* filename, FileType* type);
+
 #if BUILDFLAG(IS_POSIX) || DOXYGEN
+  //! \brief Advances the reader to the next file in the directory, and
+  //!     determines its type and inode number.
+  //!
+  //! The inode number is taken from the directory entry. For a file that is a
+  //! mount point, it is the number of the directory that the file system was
+  //! mounted on, not of the root of the mounted file system.
+  //!
+  //! \param[out] filename The filename of the next file.
+  //! \param[out] type The type of the next file.
+  //! \param[out] inode The inode number of the next file.
+  //! \return a #Result value. The out parameters are only valid when
+  //!     Result::kSuccess is returned. If Result::kError is returned, a
+  //!     message will be logged.
+  Result NextFile(base::FilePath* filename, FileType* type, uint64_t* inode);
+
   //! \brief Returns the file descriptor associated with this reader, logging a
   //!     message and returning -1 on error.
   int DirectoryFD();
@@ -75,7 +126,24 @@ class DirectoryReader {
 
  private:
 #if BUILDFLAG(IS_POSIX)
+  // Reads the next entry other than "." and "..", returning its name in
+  // filename, its dirent::d_type in d_type, and its dirent::d_ino in inode.
+  Result NextEntry(base::FilePath* filename,
+                   unsigned char* d_type,
+                   uint64_t* inode);
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Entries are read directly with getdents64(), into a buffer that holds
+  // many more of them than the C library’s readdir() buffer does. buffer_ is
+  // allocated by the first read, and buffer_offset_ and buffer_size_ delimit
+  // the entries in it that haven’t been returned yet.
+  ScopedFileHandle fd_;
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_offset_;
+  size_t buffer_size_;
+#else
   ScopedDIR dir_;
+#endif
 #elif BUILDFLAG(IS_WIN)
   WIN32_FIND_DATA find_data_;
   ScopedSearchHANDLE handle_;
@@ -16,11 +16,19 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace crashpad {
 
@@ -33,6 +41,45 @@ namespace crashpad {
     eintr_wrapper_result;                                      \
   })
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+namespace {
+
+// The record returned by the getdents64 system call. This is declared here
+// because not all C libraries expose it, or a wrapper for the system call.
+struct LinuxDirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+// Large enough to read most directories, including those in /proc, in a
+// single system call.
+constexpr size_t kDirentBufferSize = 64 * 1024;
+
+}  // namespace
+
+DirectoryReader::DirectoryReader()
+    : fd_(), buffer_(), buffer_offset_(0), buffer_size_(0) {}
+
+DirectoryReader::~DirectoryReader() {}
+
+bool DirectoryReader::Open(const base::FilePath& path) {
+  fd_.reset(HANDLE_EINTR(
+      open(path.value().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  if (!fd_.is_valid()) {
+    PLOG(ERROR) << "open " << path.value();
+    return false;
+  }
+  buffer_offset_ = 0;
+  buffer_size_ = 0;
+  return true;
+}
+
+#else
+
 DirectoryReader::DirectoryReader() : dir_() {}
 
 DirectoryReader::~DirectoryReader() {}
@@ -46,25 +93,144 @@ bool DirectoryReader::Open(const base::FilePath& path) {
   return true;
 }
 
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+namespace {
+
+DirectoryReader::FileType FileTypeFromMode(mode_t mode) {
+  if (S_ISREG(mode)) {
+    return DirectoryReader::FileType::kRegularFile;
+  }
+  if (S_ISDIR(mode)) {
+    return DirectoryReader::FileType::kDirectory;
+  }
+  if (S_ISLNK(mode)) {
+    return DirectoryReader::FileType::kSymbolicLink;
+  }
+  return DirectoryReader::FileType::kOther;
+}
+
+}  // namespace
+
 DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
-  DCHECK(dir_.is_valid());
+  unsigned char d_type;
+  uint64_t inode;
+  return NextEntry(filename, &d_type, &inode);
+}
 
-  errno = 0;
-  dirent* entry = HANDLE_EINTR_IF_EQ(readdir(dir_.get()), nullptr);
-  if (!entry) {
-    if (errno) {
-      PLOG(ERROR) << "readdir " << filename->value();
-      return Result::kError;
-    } else {
-      return Result::kNoMoreFiles;
-    }
+DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename,
+                                                  FileType* type) {
+  uint64_t inode;
+  return NextFile(filename, type, &inode);
+}
+
+DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename,
+                                                  FileType* type,
+                                                  uint64_t* inode) {
+  unsigned char d_type;
+  Result result = NextEntry(filename, &d_type, inode);
+  if (result != Result::kSuccess) {
+    return result;
   }
 
-  if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-    return NextFile(filename);
+  switch (d_type) {
+    case DT_REG:
+      *type = FileType::kRegularFile;
+      return Result::kSuccess;
+    case DT_DIR:
+      *type = FileType::kDirectory;
+      return Result::kSuccess;
+    case DT_LNK:
+      *type = FileType::kSymbolicLink;
+      return Result::kSuccess;
+    case DT_UNKNOWN:
+      break;
+    default:
+      *type = FileType::kOther;
+      return Result::kSuccess;
   }
 
+  struct stat st;
+  if (fstatat(DirectoryFD(),
+              filename->value().c_str(),
+              &st,
+              AT_SYMLINK_NOFOLLOW) != 0) {
+    PLOG(ERROR) << "fstatat " << filename->value();
+    return Result::kError;
+  }
+  *type = FileTypeFromMode(st.st_mode);
+  return Result::kSuccess;
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+DirectoryReader::Result DirectoryReader::NextEntry(base::FilePath* filename,
+                                                   unsigned char* d_type,
+                                                   uint64_t* inode) {
+  DCHECK(fd_.is_valid());
+
+  while (true) {
+    if (buffer_offset_ >= buffer_size_) {
+      if (!buffer_) {
+        buffer_.reset(new char[kDirentBufferSize]);
+      }
+      long rv = HANDLE_EINTR(syscall(
+          SYS_getdents64, fd_.get(), buffer_.get(), kDirentBufferSize));
+      if (rv < 0) {
+        PLOG(ERROR) << "getdents64";
+        return Result::kError;
+      }
+      if (rv == 0) {
+        return Result::kNoMoreFiles;
+      }
+      buffer_offset_ = 0;
+      buffer_size_ = rv;
+    }
+
+    const LinuxDirent64* entry =
+        reinterpret_cast<const LinuxDirent64*>(&buffer_[buffer_offset_]);
+    buffer_offset_ += entry->d_reclen;
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+
+    *filename = base::FilePath(entry->d_name);
+    *d_type = entry->d_type;
+    *inode = entry->d_ino;
+    return Result::kSuccess;
+  }
+}
+
+int DirectoryReader::DirectoryFD() {
+  DCHECK(fd_.is_valid());
+  return fd_.get();
+}
+
+#else
+
+DirectoryReader::Result DirectoryReader::NextEntry(base::FilePath* filename,
+                                                   unsigned char* d_type,
+                                                   uint64_t* inode) {
+  DCHECK(dir_.is_valid());
+
+  dirent* entry;
+  do {
+    errno = 0;
+    entry = HANDLE_EINTR_IF_EQ(readdir(dir_.get()), nullptr);
+    if (!entry) {
+      if (errno) {
+        PLOG(ERROR) << "readdir " << filename->value();
+        return Result::kError;
+      } else {
+        return Result::kNoMoreFiles;
+      }
+    }
+  } while (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0);
+
   *filename = base::FilePath(entry->d_name);
+  *d_type = entry->d_type;
+  *inode = entry->d_ino;
   return Result::kSuccess;
 }
 
@@ -77,4 +243,7 @@ int DirectoryReader::DirectoryFD() {
   return rv;
 }
 
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 }  // namespace crashpad
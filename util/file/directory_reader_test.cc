@@ -14,6 +14,7 @@
 
 #include "util/file/directory_reader.h"
 
+#include <map>
 #include <set>
 
 #include "base/files/file_path.h"
@@ -26,6 +27,12 @@
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
 
+#if BUILDFLAG(IS_POSIX)
+#include <sys/stat.h>
+
+#include "test/errors.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
 namespace crashpad {
 namespace test {
 namespace {
@@ -133,6 +140,28 @@ void TestFilesAndDirectories(bool symbolic_links) {
   EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
   EXPECT_EQ(reader.NextFile(&filename), DirectoryReader::Result::kNoMoreFiles);
   ExpectFiles(files, expected_files);
+
+  std::map<base::FilePath, DirectoryReader::FileType> types;
+  DirectoryReader type_reader;
+  ASSERT_TRUE(type_reader.Open(temp_dir.path()));
+  DirectoryReader::FileType type;
+  while ((result = type_reader.NextFile(&filename, &type)) ==
+         DirectoryReader::Result::kSuccess) {
+    EXPECT_TRUE(types.emplace(filename, type).second);
+  }
+  EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
+  EXPECT_EQ(types.size(), expected_files.size());
+  for (const auto& [name, actual_type] : types) {
+    SCOPED_TRACE(
+        base::StringPrintf("Filename: %" PRFilePath, name.value().c_str()));
+    if (name == file) {
+      EXPECT_EQ(actual_type, DirectoryReader::FileType::kRegularFile);
+    } else if (name == directory) {
+      EXPECT_EQ(actual_type, DirectoryReader::FileType::kDirectory);
+    } else {
+      EXPECT_EQ(actual_type, DirectoryReader::FileType::kSymbolicLink);
+    }
+  }
 }
 
 TEST(DirectoryReader, FilesAndDirectories) {
@@ -151,6 +180,72 @@ TEST(DirectoryReader, FilesAndDirectories_SymbolicLinks) {
 
 #endif  // !BUILDFLAG(IS_FUCHSIA)
 
+#if BUILDFLAG(IS_POSIX)
+
+TEST(DirectoryReader, ManyFiles) {
+  // Enough files, with long enough names, that their entries can’t all be
+  // retrieved by a single read of the directory.
+  constexpr int kFileCount = 1500;
+  constexpr char kPrefix[] = "a_file_with_a_long_name_to_fill_the_buffer_";
+
+  ScopedTempDir temp_dir;
+  std::set<base::FilePath> expected_files;
+  for (int index = 0; index < kFileCount; ++index) {
+    base::FilePath file(base::StringPrintf("%s%d", kPrefix, index));
+    ASSERT_TRUE(CreateFile(temp_dir.path().Append(file)));
+    expected_files.insert(file);
+  }
+
+  std::set<base::FilePath> files;
+  DirectoryReader reader;
+  ASSERT_TRUE(reader.Open(temp_dir.path()));
+  DirectoryReader::Result result;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  while ((result = reader.NextFile(&filename, &type)) ==
+         DirectoryReader::Result::kSuccess) {
+    EXPECT_EQ(type, DirectoryReader::FileType::kRegularFile);
+    EXPECT_TRUE(files.insert(filename).second);
+  }
+  EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
+  ExpectFiles(files, expected_files);
+}
+
+TEST(DirectoryReader, Inodes) {
+  ScopedTempDir temp_dir;
+  base::FilePath file(FILE_PATH_LITERAL("file"));
+  ASSERT_TRUE(CreateFile(temp_dir.path().Append(file)));
+  base::FilePath directory(FILE_PATH_LITERAL("directory"));
+  ASSERT_TRUE(LoggingCreateDirectory(temp_dir.path().Append(directory),
+                                     FilePermissions::kWorldReadable,
+                                     false));
+
+  DirectoryReader reader;
+  ASSERT_TRUE(reader.Open(temp_dir.path()));
+  DirectoryReader::Result result;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  uint64_t inode;
+  size_t count = 0;
+  while ((result = reader.NextFile(&filename, &type, &inode)) ==
+         DirectoryReader::Result::kSuccess) {
+    SCOPED_TRACE(
+        base::StringPrintf("Filename: %" PRFilePath, filename.value().c_str()));
+    struct stat st;
+    ASSERT_EQ(lstat(temp_dir.path().Append(filename).value().c_str(), &st), 0)
+        << ErrnoMessage("lstat");
+    EXPECT_EQ(inode, st.st_ino);
+    EXPECT_EQ(type,
+              filename == file ? DirectoryReader::FileType::kRegularFile
+                               : DirectoryReader::FileType::kDirectory);
+    ++count;
+  }
+  EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
+  EXPECT_EQ(count, 2u);
+}
+
+#endif  // BUILDFLAG(IS_POSIX)
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -74,4 +74,24 @@ DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
   return Result::kSuccess;
 }
 
+DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename,
+                                                  FileType* type) {
+  Result result = NextFile(filename);
+  if (result != Result::kSuccess) {
+    return result;
+  }
+
+  if ((find_data_.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) &&
+      find_data_.dwReserved0 == IO_REPARSE_TAG_SYMLINK) {
+    *type = FileType::kSymbolicLink;
+  } else if (find_data_.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+    *type = FileType::kDirectory;
+  } else if (find_data_.dwFileAttributes & FILE_ATTRIBUTE_DEVICE) {
+    *type = FileType::kOther;
+  } else {
+    *type = FileType::kRegularFile;
+  }
+  return Result::kSuccess;
+}
+
 }  // namespace crashpad
@@ -163,17 +163,29 @@ void CheckedReadFileAtEOF(FileHandle file) {
 }
 
 bool LoggingReadToEOF(FileHandle file, std::string* contents) {
-  char buffer[4096];
+  // Read directly into the string, growing the space available for each read
+  // geometrically. Large files, such as the /proc/pid/maps files of processes
+  // with many mappings, are read in few large reads, which also shortens the
+  // time over which the contents of such generated files can change.
+  constexpr size_t kMinReadSize = 4096;
+  std::string local_contents(kMinReadSize, '\0');
+  size_t size = 0;
   FileOperationResult rv;
-  std::string local_contents;
-  while ((rv = ReadFile(file, buffer, sizeof(buffer))) > 0) {
-    DCHECK_LE(static_cast<size_t>(rv), sizeof(buffer));
-    local_contents.append(buffer, rv);
-  }
+  do {
+    if (local_contents.size() - size < kMinReadSize) {
+      local_contents.resize(local_contents.size() * 2);
+    }
+    rv = ReadFile(file, &local_contents[size], local_contents.size() - size);
+    if (rv > 0) {
+      DCHECK_LE(static_cast<size_t>(rv), local_contents.size() - size);
+      size += rv;
+    }
+  } while (rv > 0);
   if (rv < 0) {
     PLOG(ERROR) << internal::kNativeReadFunctionName;
     return false;
   }
+  local_contents.resize(size);
   contents->swap(local_contents);
   return true;
 }
@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/file_section_reader.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+FileSectionReader::FileSectionReader(FileReaderInterface* file,
+                                     FileOffset offset,
+                                     FileOffset size)
+    : file_(file), offset_(offset), size_(size), position_(0) {
+  CHECK(file_);
+  CHECK_GE(offset_, 0);
+  CHECK_GE(size_, 0);
+}
+
+FileSectionReader::~FileSectionReader() {}
+
+FileOperationResult FileSectionReader::Read(void* data, size_t size) {
+  if (position_ >= size_) {
+    return 0;
+  }
+
+  if (!file_->SeekSet(offset_ + position_)) {
+    return -1;
+  }
+
+  const size_t remaining = static_cast<size_t>(size_ - position_);
+  const FileOperationResult nread =
+      file_->Read(data, std::min(size, remaining));
+  if (nread > 0) {
+    position_ += nread;
+  }
+  return nread;
+}
+
+FileOffset FileSectionReader::Seek(FileOffset offset, int whence) {
+  FileOffset base_offset;
+
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = position_;
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  if (offset < -base_offset) {
+    LOG(ERROR) << "Seek(): new offset " << base_offset << " + " << offset
+               << " invalid";
+    return -1;
+  }
+
+  position_ = base_offset + offset;
+  return position_;
+}
+
+}  // namespace crashpad
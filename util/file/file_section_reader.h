@@ -0,0 +1,63 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_FILE_SECTION_READER_H_
+#define CRASHPAD_UTIL_FILE_FILE_SECTION_READER_H_
+
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader for a range of bytes of another file reader.
+//!
+//! The section appears as a file of its own: offsets are relative to the start
+//! of the section, and reads stop at its end. The underlying file is
+//! positioned before every read, so several sections of one file may be read
+//! in turn, such as by an HTTPMultipartBuilder body stream, without copying
+//! them. They must not be read concurrently.
+//!
+//! The underlying file is not owned by this object and must outlive it.
+class FileSectionReader : public FileReaderInterface {
+ public:
+  //! \brief Constructs a reader for the \a size bytes of \a file beginning at
+  //!     \a offset.
+  FileSectionReader(FileReaderInterface* file,
+                    FileOffset offset,
+                    FileOffset size);
+
+  FileSectionReader(const FileSectionReader&) = delete;
+  FileSectionReader& operator=(const FileSectionReader&) = delete;
+
+  ~FileSectionReader() override;
+
+  //! \brief The size of the section.
+  FileOffset size() const { return size_; }
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  FileReaderInterface* file_;  // weak
+  FileOffset offset_;
+  FileOffset size_;
+  FileOffset position_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_FILE_SECTION_READER_H_
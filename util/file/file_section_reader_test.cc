@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/file_section_reader.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(FileSectionReader, ReadAndSeek) {
+  StringFile file;
+  file.SetString("0123abcdefgh4567");
+  FileSectionReader reader(&file, 4, 8);
+  EXPECT_EQ(reader.size(), 8);
+
+  char buffer[16];
+  ASSERT_TRUE(reader.ReadExactly(buffer, 3));
+  EXPECT_EQ(std::string(buffer, 3), "abc");
+  EXPECT_EQ(reader.SeekGet(), 3);
+
+  EXPECT_EQ(reader.Seek(2, SEEK_CUR), 5);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 3);
+  EXPECT_EQ(std::string(buffer, 3), "fgh");
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  EXPECT_EQ(reader.Seek(-2, SEEK_END), 6);
+  EXPECT_EQ(reader.Read(buffer, 1), 1);
+  EXPECT_EQ(buffer[0], 'g');
+
+  EXPECT_EQ(reader.Seek(-1, SEEK_SET), -1);
+  EXPECT_EQ(reader.SeekGet(), 7);
+
+  // Seeking beyond the end is allowed, but nothing can be read there.
+  EXPECT_EQ(reader.Seek(20, SEEK_SET), 20);
+  EXPECT_EQ(reader.Read(buffer, 1), 0);
+}
+
+TEST(FileSectionReader, Interleaved) {
+  StringFile file;
+  file.SetString("aaaabbbb");
+  FileSectionReader first(&file, 0, 4);
+  FileSectionReader second(&file, 4, 4);
+
+  // Each section reads from its own position regardless of the other.
+  char buffer[4];
+  ASSERT_TRUE(first.ReadExactly(buffer, 2));
+  EXPECT_EQ(std::string(buffer, 2), "aa");
+  ASSERT_TRUE(second.ReadExactly(buffer, 4));
+  EXPECT_EQ(std::string(buffer, 4), "bbbb");
+  EXPECT_EQ(first.Read(buffer, sizeof(buffer)), 2);
+  EXPECT_EQ(std::string(buffer, 2), "aa");
+  EXPECT_EQ(second.Read(buffer, sizeof(buffer)), 0);
+}
+
+TEST(FileSectionReader, Truncated) {
+  StringFile file;
+  file.SetString("abc");
+  FileSectionReader reader(&file, 1, 8);
+
+  char buffer[8];
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 2);
+  EXPECT_EQ(std::string(buffer, 2), "bc");
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -43,6 +43,10 @@ static_assert(offsetof(WritableIoVec, iov_len) == offsetof(iovec, iov_len),
               "WritableIoVec len offset");
 #endif  // BUILDFLAG(IS_POSIX)
 
+FileHandle FileWriterInterface::UnderlyingFileHandle() {
+  return kInvalidFileHandle;
+}
+
 WeakFileHandleFileWriter::WeakFileHandleFileWriter(FileHandle file_handle)
     : file_handle_(file_handle) {
 }
@@ -146,6 +150,10 @@ bool WeakFileHandleFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return true;
 }
 
+FileHandle WeakFileHandleFileWriter::UnderlyingFileHandle() {
+  return file_handle_;
+}
+
 FileOffset WeakFileHandleFileWriter::Seek(FileOffset offset, int whence) {
   DCHECK_NE(file_handle_, kInvalidFileHandle);
   return LoggingSeekFile(file_handle_, offset, whence);
@@ -206,6 +214,11 @@ bool FileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return weak_file_handle_file_writer_.WriteIoVec(iovecs);
 }
 
+FileHandle FileWriter::UnderlyingFileHandle() {
+  DCHECK(file_.is_valid());
+  return weak_file_handle_file_writer_.UnderlyingFileHandle();
+}
+
 FileOffset FileWriter::Seek(FileOffset offset, int whence) {
   DCHECK(file_.is_valid());
   return weak_file_handle_file_writer_.Seek(offset, whence);
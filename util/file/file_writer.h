@@ -63,6 +63,15 @@ class FileWriterInterface : public virtual FileSeekerInterface {
   //!
   //! \note The contents of \a iovecs are undefined when this method returns.
   virtual bool WriteIoVec(std::vector<WritableIoVec>* iovecs) = 0;
+
+  //! \brief Returns the file handle that Write() writes to.
+  //!
+  //! Callers may use the handle to place data into the file by other means,
+  //! provided that they leave the file position immediately after that data.
+  //!
+  //! \return The file handle, or kInvalidFileHandle if this object doesn’t
+  //!     write directly to one. This is the default implementation.
+  virtual FileHandle UnderlyingFileHandle();
 };
 
 //! \brief A file writer backed by a FileHandle.
@@ -91,6 +100,7 @@ class WeakFileHandleFileWriter : public FileWriterInterface {
   // FileWriterInterface:
   bool Write(const void* data, size_t size) override;
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+  FileHandle UnderlyingFileHandle() override;
 
   // FileSeekerInterface:
 
@@ -174,6 +184,12 @@ class FileWriter : public FileWriterInterface {
   //!     a Close().
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
 
+  //! \copydoc FileWriterInterface::UnderlyingFileHandle()
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  FileHandle UnderlyingFileHandle() override;
+
   // FileSeekerInterface:
 
   //! \copydoc FileWriterInterface::Seek()
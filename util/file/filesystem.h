@@ -69,6 +69,24 @@ bool LoggingCreateDirectory(const base::FilePath& path,
 bool MoveFileOrDirectory(const base::FilePath& source,
                          const base::FilePath& dest);
 
+//! \brief Copies a file, logging a message on failure.
+//!
+//! Where the file system supports it, the copy shares storage with \a source
+//! copy-on-write, so that copying a large file takes neither time nor disk
+//! space until either file is modified. This uses `FICLONE` on Linux and
+//! Android, `clonefile()` on macOS, and `CopyFile()`, which clones blocks on
+//! supporting volumes, on Windows. Otherwise, the contents are copied.
+//!
+//! \param[in] source The path to the file to be copied.
+//! \param[in] dest The path to create the copy at. This must not exist.
+//! \param[in] permissions The permissions to use for \a dest. Ignored on
+//!     Windows.
+//! \return `true` on success. `false` on failure with a message logged, in
+//!     which case \a dest will not have been created.
+bool LoggingCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions);
+
 //! \brief Determines if a path refers to a regular file, logging a message on
 //!     failure.
 //!
@@ -20,12 +20,54 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <memory>
+
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+
+#if BUILDFLAG(IS_APPLE)
+#include <sys/clonefile.h>
+#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+
+#if !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
 
 namespace crashpad {
 
+namespace {
+
+bool CopyFileContents(FileHandle source, FileHandle dest) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // On file systems that support reflinks, such as Btrfs and XFS, this shares
+  // the source’s extents with the destination instead of copying them.
+  if (ioctl(dest, FICLONE, source) == 0) {
+    return true;
+  }
+#endif
+
+  constexpr size_t kBufferSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  FileOperationResult read_result;
+  while ((read_result = ReadFile(source, buffer.get(), kBufferSize)) > 0) {
+    if (!LoggingWriteFile(dest, buffer.get(), read_result)) {
+      return false;
+    }
+  }
+  if (read_result < 0) {
+    PLOG(ERROR) << "read";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 bool FileModificationTime(const base::FilePath& path, timespec* mtime) {
   struct stat st;
   if (lstat(path.value().c_str(), &st) != 0) {
@@ -74,6 +116,49 @@ bool MoveFileOrDirectory(const base::FilePath& source,
   return true;
 }
 
+bool LoggingCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions) {
+#if BUILDFLAG(IS_APPLE)
+  // On APFS, clonefile() creates a copy-on-write clone. It’s unsupported on
+  // other file systems and across volumes, in which case the file is copied.
+  if (__builtin_available(macOS 10.12, iOS 10.0, *)) {
+    if (clonefile(source.value().c_str(), dest.value().c_str(), 0) == 0) {
+      if (chmod(dest.value().c_str(),
+                permissions == FilePermissions::kWorldReadable ? 0644
+                                                               : 0600) != 0) {
+        PLOG(ERROR) << "chmod " << dest.value();
+        LoggingRemoveFile(dest);
+        return false;
+      }
+      return true;
+    }
+    if (errno != ENOTSUP && errno != EXDEV) {
+      PLOG(ERROR) << "clonefile " << source.value() << ", " << dest.value();
+      return false;
+    }
+  }
+#endif
+
+  ScopedFileHandle source_handle(LoggingOpenFileForRead(source));
+  if (!source_handle.is_valid()) {
+    return false;
+  }
+
+  ScopedFileHandle dest_handle(LoggingOpenFileForWrite(
+      dest, FileWriteMode::kCreateOrFail, permissions));
+  if (!dest_handle.is_valid()) {
+    return false;
+  }
+
+  if (!CopyFileContents(source_handle.get(), dest_handle.get())) {
+    dest_handle.reset();
+    LoggingRemoveFile(dest);
+    return false;
+  }
+  return true;
+}
+
 bool IsRegularFile(const base::FilePath& path) {
   struct stat st;
   if (lstat(path.value().c_str(), &st) != 0) {
@@ -21,6 +21,7 @@
 #include "test/errors.h"
 #include "test/filesystem.h"
 #include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
 #include "util/file/file_writer.h"
 #include "util/misc/time.h"
 
@@ -286,6 +287,44 @@ TEST(Filesystem, MoveFileOrDirectory_SymbolicLinks) {
 
 #endif  // !BUILDFLAG(IS_FUCHSIA)
 
+TEST(Filesystem, CopyFile) {
+  ScopedTempDir temp_dir;
+
+  base::FilePath source(temp_dir.path().Append(FILE_PATH_LITERAL("source")));
+  base::FilePath dest(temp_dir.path().Append(FILE_PATH_LITERAL("dest")));
+  EXPECT_FALSE(LoggingCopyFile(source, dest, FilePermissions::kOwnerOnly));
+  EXPECT_FALSE(PathExists(dest));
+
+  // Large enough to need more than one read when the contents are copied.
+  const std::string contents(256 * 1024 + 1, 'c');
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(contents.data(), contents.size()));
+  }
+
+  EXPECT_TRUE(LoggingCopyFile(source, dest, FilePermissions::kOwnerOnly));
+  std::string actual;
+  ASSERT_TRUE(LoggingReadEntireFile(dest, &actual));
+  EXPECT_EQ(actual, contents);
+
+  // The copy is unaffected by changes to the source.
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write("x", 1));
+  }
+  ASSERT_TRUE(LoggingReadEntireFile(dest, &actual));
+  EXPECT_EQ(actual, contents);
+
+  // An existing destination isn’t overwritten.
+  EXPECT_FALSE(LoggingCopyFile(source, dest, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(LoggingReadEntireFile(dest, &actual));
+  EXPECT_EQ(actual, contents);
+}
+
 TEST(Filesystem, IsRegularFile) {
   EXPECT_FALSE(IsRegularFile(base::FilePath()));
 
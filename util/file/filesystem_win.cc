@@ -109,6 +109,20 @@ bool MoveFileOrDirectory(const base::FilePath& source,
   return true;
 }
 
+bool LoggingCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions) {
+  // CopyFile() clones blocks instead of copying them on volumes that support
+  // it, such as ReFS.
+  if (!CopyFile(source.value().c_str(),
+                dest.value().c_str(),
+                /*bFailIfExists=*/TRUE)) {
+    PLOG(ERROR) << "CopyFile " << source << ", " << dest;
+    return false;
+  }
+  return true;
+}
+
 bool IsRegularFile(const base::FilePath& path) {
   DWORD fileattr = GetFileAttributes(path.value().c_str());
   if (fileattr == INVALID_FILE_ATTRIBUTES) {
@@ -0,0 +1,101 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/memory_file_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+#include "util/misc/implicit_cast.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MemoryFileReader::MemoryFileReader(const void* data, size_t size)
+    : data_(reinterpret_cast<const uint8_t*>(data)), size_(size), offset_(0) {
+  CHECK(data_ || !size_);
+  CHECK_LE(
+      size_,
+      implicit_cast<size_t>(std::numeric_limits<FileOperationResult>::max()));
+}
+
+MemoryFileReader::~MemoryFileReader() {}
+
+const uint8_t* MemoryFileReader::View(FileOffset offset, size_t size) const {
+  size_t offset_sizet;
+  if (offset < 0 || !AssignIfInRange(&offset_sizet, offset) ||
+      offset_sizet > size_ || size > size_ - offset_sizet) {
+    LOG(ERROR) << "View(): range " << offset << " + " << size
+               << " outside of buffer of size " << size_;
+    return nullptr;
+  }
+  return data_ + offset_sizet;
+}
+
+FileOperationResult MemoryFileReader::Read(void* data, size_t size) {
+  if (offset_ >= size_) {
+    return 0;
+  }
+
+  const size_t nread = std::min(size, size_ - offset_);
+  memcpy(data, data_ + offset_, nread);
+  offset_ += nread;
+  return nread;
+}
+
+FileOffset MemoryFileReader::Seek(FileOffset offset, int whence) {
+  size_t base_offset;
+
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = offset_;
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  FileOffset base_offset_fileoffset;
+  if (!AssignIfInRange(&base_offset_fileoffset, base_offset)) {
+    LOG(ERROR) << "Seek(): base_offset " << base_offset
+               << " invalid for FileOffset";
+    return -1;
+  }
+  base::CheckedNumeric<FileOffset> new_offset(base_offset_fileoffset);
+  new_offset += offset;
+  size_t new_offset_sizet;
+  if (!new_offset.AssignIfValid(&new_offset_sizet)) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+
+  offset_ = new_offset_sizet;
+  return base::checked_cast<FileOffset>(offset_);
+}
+
+}  // namespace crashpad
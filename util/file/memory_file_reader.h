@@ -0,0 +1,69 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
+#define CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader backed by a caller-owned buffer in memory, such as a
+//!     memory-mapped file.
+//!
+//! In addition to FileReaderInterface, this class offers View(), which
+//! provides direct access to a range of the buffer so that callers able to
+//! take advantage of it can avoid copying file contents.
+//!
+//! The buffer is not owned by this object and must outlive it and any views
+//! obtained from it.
+class MemoryFileReader : public FileReaderInterface {
+ public:
+  //! \brief Constructs a reader for the \a size bytes at \a data.
+  MemoryFileReader(const void* data, size_t size);
+
+  MemoryFileReader(const MemoryFileReader&) = delete;
+  MemoryFileReader& operator=(const MemoryFileReader&) = delete;
+
+  ~MemoryFileReader() override;
+
+  //! \brief Returns a pointer to \a size bytes of the buffer beginning at
+  //!     \a offset, or `nullptr` if that range is not entirely within the
+  //!     buffer.
+  //!
+  //! The file position is not affected.
+  const uint8_t* View(FileOffset offset, size_t size) const;
+
+  //! \brief The size of the underlying buffer.
+  size_t size() const { return size_; }
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  const uint8_t* data_;  // weak
+  size_t size_;
+  size_t offset_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
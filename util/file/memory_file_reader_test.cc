@@ -0,0 +1,84 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/memory_file_reader.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(MemoryFileReader, EmptyBuffer) {
+  MemoryFileReader reader(nullptr, 0);
+  EXPECT_EQ(reader.size(), 0u);
+  EXPECT_EQ(reader.Seek(0, SEEK_CUR), 0);
+
+  char c = '6';
+  EXPECT_EQ(reader.Read(&c, 1), 0);
+  EXPECT_EQ(c, '6');
+  EXPECT_FALSE(reader.View(0, 1));
+}
+
+TEST(MemoryFileReader, ReadAndSeek) {
+  static constexpr char kData[] = "abcdefgh";
+  MemoryFileReader reader(kData, sizeof(kData) - 1);
+
+  char buffer[4];
+  ASSERT_TRUE(reader.ReadExactly(buffer, 3));
+  EXPECT_EQ(std::string(buffer, 3), "abc");
+  EXPECT_EQ(reader.SeekGet(), 3);
+
+  EXPECT_EQ(reader.Seek(2, SEEK_CUR), 5);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 3);
+  EXPECT_EQ(std::string(buffer, 3), "fgh");
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  EXPECT_EQ(reader.Seek(-2, SEEK_END), 6);
+  EXPECT_EQ(reader.Read(buffer, 1), 1);
+  EXPECT_EQ(buffer[0], 'g');
+
+  EXPECT_EQ(reader.Seek(-1, SEEK_SET), -1);
+  EXPECT_EQ(reader.SeekGet(), 7);
+
+  // Seeking beyond the end is allowed, but nothing can be read there.
+  EXPECT_EQ(reader.Seek(20, SEEK_SET), 20);
+  EXPECT_EQ(reader.Read(buffer, 1), 0);
+}
+
+TEST(MemoryFileReader, View) {
+  static constexpr char kData[] = "abcdefgh";
+  MemoryFileReader reader(kData, sizeof(kData) - 1);
+
+  const uint8_t* view = reader.View(2, 4);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(reinterpret_cast<const char*>(view), kData + 2);
+  EXPECT_EQ(reader.SeekGet(), 0);
+
+  EXPECT_TRUE(reader.View(0, 8));
+  EXPECT_TRUE(reader.View(8, 0));
+  EXPECT_FALSE(reader.View(0, 9));
+  EXPECT_FALSE(reader.View(7, 2));
+  EXPECT_FALSE(reader.View(9, 0));
+  EXPECT_FALSE(reader.View(-1, 1));
+  EXPECT_FALSE(reader.View(1, static_cast<size_t>(-1)));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
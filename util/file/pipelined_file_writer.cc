@@ -0,0 +1,187 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/pipelined_file_writer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class PipelinedFileWriter::WriterThread final : public Thread {
+ public:
+  explicit WriterThread(PipelinedFileWriter* writer)
+      : Thread(), writer_(writer) {}
+
+  WriterThread(const WriterThread&) = delete;
+  WriterThread& operator=(const WriterThread&) = delete;
+
+  ~WriterThread() override = default;
+
+ private:
+  void ThreadMain() override { writer_->WritePending(); }
+
+  PipelinedFileWriter* writer_;  // weak
+};
+
+PipelinedFileWriter::PipelinedFileWriter(FileWriterInterface* underlying,
+                                         size_t capacity)
+    : active_(),
+      pending_(),
+      thread_(),
+      underlying_(underlying),
+      block_ready_(0),
+      writer_idle_(1),
+      position_(-1),
+      capacity_(capacity),
+      pending_failed_(false),
+      failed_(false) {
+  DCHECK(underlying_);
+  DCHECK_GT(capacity_, 0u);
+  thread_ = std::make_unique<WriterThread>(this);
+  thread_->Start();
+}
+
+PipelinedFileWriter::~PipelinedFileWriter() {
+  Flush();
+
+  // An empty block tells the writer thread to exit.
+  writer_idle_.Wait();
+  pending_.clear();
+  block_ready_.Signal();
+  thread_->Join();
+}
+
+bool PipelinedFileWriter::Flush() {
+  if (!active_.empty() && !SubmitActive()) {
+    return false;
+  }
+  return WaitForPending();
+}
+
+bool PipelinedFileWriter::Write(const void* data, size_t size) {
+  if (failed_) {
+    return false;
+  }
+
+  // Large writes are copied in block-sized slices, so that writing one slice
+  // overlaps with copying the next instead of stalling the caller for the
+  // whole write.
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  size_t remaining = size;
+  while (remaining > 0) {
+    if (active_.size() == capacity_ && !SubmitActive()) {
+      return false;
+    }
+    if (active_.capacity() < capacity_) {
+      active_.reserve(capacity_);
+    }
+    const size_t slice = std::min(remaining, capacity_ - active_.size());
+    active_.insert(active_.end(), bytes, bytes + slice);
+    bytes += slice;
+    remaining -= slice;
+  }
+
+  if (position_ >= 0) {
+    position_ += size;
+  }
+  return true;
+}
+
+bool PipelinedFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "no iovecs";
+    return false;
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FileHandle PipelinedFileWriter::UnderlyingFileHandle() {
+  if (!Flush()) {
+    return kInvalidFileHandle;
+  }
+
+  // Writes made through the handle move the file position without this
+  // object seeing them.
+  position_ = -1;
+  return underlying_->UnderlyingFileHandle();
+}
+
+FileOffset PipelinedFileWriter::Seek(FileOffset offset, int whence) {
+  if (whence == SEEK_CUR && offset == 0 && position_ >= 0) {
+    return position_;
+  }
+
+  if (!Flush()) {
+    return -1;
+  }
+
+  position_ = underlying_->Seek(offset, whence);
+  return position_;
+}
+
+bool PipelinedFileWriter::SubmitActive() {
+  writer_idle_.Wait();
+  if (pending_failed_) {
+    failed_ = true;
+    writer_idle_.Signal();
+    return false;
+  }
+
+  // pending_ was cleared by the writer thread, so after the swap, active_ is
+  // empty but keeps the storage that pending_ had.
+  std::swap(active_, pending_);
+  block_ready_.Signal();
+  return true;
+}
+
+bool PipelinedFileWriter::WaitForPending() {
+  writer_idle_.Wait();
+  if (pending_failed_) {
+    failed_ = true;
+  }
+  writer_idle_.Signal();
+  return !failed_;
+}
+
+void PipelinedFileWriter::WritePending() {
+  while (true) {
+    block_ready_.Wait();
+    if (pending_.empty()) {
+      return;
+    }
+
+    // After a failure, later blocks are dropped rather than written out of
+    // place.
+    if (!pending_failed_ &&
+        !underlying_->Write(pending_.data(), pending_.size())) {
+      pending_failed_ = true;
+    }
+    pending_.clear();
+    writer_idle_.Signal();
+  }
+}
+
+}  // namespace crashpad
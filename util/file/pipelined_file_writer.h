@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_PIPELINED_FILE_WRITER_H_
+#define CRASHPAD_UTIL_FILE_PIPELINED_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "util/file/file_writer.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+
+//! \brief A file writer that passes data to another FileWriterInterface on a
+//!     background thread.
+//!
+//! Data is gathered into a block of fixed capacity. When the block fills, it
+//! is handed to a writer thread, and the caller continues filling a second
+//! block while the first is written. This lets the caller overlap producing
+//! data, such as reading another process’ memory, with writing the previous
+//! block to disk. The caller blocks only when both blocks are full.
+//!
+//! Because writes complete later, a failure in the wrapped writer is reported
+//! by a subsequent call to Write(), WriteIoVec(), Seek(), or Flush(). Once a
+//! write has failed, all further operations fail.
+//!
+//! Asking Seek() for the current position is answered without waiting. Any
+//! other seek, and UnderlyingFileHandle(), wait for all data to be written
+//! first, so that the wrapped writer is current when it is used directly.
+class PipelinedFileWriter : public FileWriterInterface {
+ public:
+  //! \brief The block capacity used when none is specified.
+  static constexpr size_t kDefaultCapacity = 1024 * 1024;
+
+  //! \param[in] underlying The writer that receives the data. This object
+  //!     does not take ownership of \a underlying, which must outlive it. It
+  //!     is only used from the writer thread while a block is being written.
+  //! \param[in] capacity The size of each block, in bytes.
+  explicit PipelinedFileWriter(FileWriterInterface* underlying,
+                               size_t capacity = kDefaultCapacity);
+
+  PipelinedFileWriter(const PipelinedFileWriter&) = delete;
+  PipelinedFileWriter& operator=(const PipelinedFileWriter&) = delete;
+
+  //! \brief Writes any remaining data and stops the writer thread.
+  //!
+  //! Callers that need to know whether the data reached the wrapped writer
+  //! should call Flush() themselves before destruction.
+  ~PipelinedFileWriter() override;
+
+  //! \brief Writes all data given to this object to the wrapped writer, and
+  //!     waits for the writes to complete.
+  //!
+  //! \return `true` on success. `false` if this or any earlier write failed,
+  //!     with a message logged by the wrapped writer.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  //! \copydoc FileWriterInterface::UnderlyingFileHandle()
+  //!
+  //! All data is flushed first. If that fails, kInvalidFileHandle is
+  //! returned.
+  FileHandle UnderlyingFileHandle() override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  class WriterThread;
+
+  // Hands the active block to the writer thread, after waiting for it to
+  // finish the previous one.
+  bool SubmitActive();
+
+  // Waits for the writer thread to finish its block, if any.
+  bool WaitForPending();
+
+  // Called on the writer thread.
+  void WritePending();
+
+  std::vector<uint8_t> active_;
+  std::vector<uint8_t> pending_;
+  std::unique_ptr<WriterThread> thread_;
+  FileWriterInterface* underlying_;  // weak
+
+  // Signaled when pending_ holds a block to write, or when it is empty and
+  // the writer thread should exit.
+  Semaphore block_ready_;
+
+  // Signaled when the writer thread is done with pending_. Starts signaled.
+  // The caller must wait on this before it touches pending_ or underlying_.
+  Semaphore writer_idle_;
+
+  // The logical position of the next byte written, or -1 if not yet known.
+  FileOffset position_;
+
+  size_t capacity_;
+
+  // Set by the writer thread before signaling writer_idle_, and read by the
+  // caller after waiting for it.
+  bool pending_failed_;
+  bool failed_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_PIPELINED_FILE_WRITER_H_
@@ -0,0 +1,163 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/pipelined_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A StringFile that records the size of each write that reaches it, and that
+// can be made to fail.
+class RecordingStringFile : public StringFile {
+ public:
+  RecordingStringFile() : StringFile(), write_sizes_(), fail_(false) {}
+
+  RecordingStringFile(const RecordingStringFile&) = delete;
+  RecordingStringFile& operator=(const RecordingStringFile&) = delete;
+
+  ~RecordingStringFile() override = default;
+
+  bool Write(const void* data, size_t size) override {
+    write_sizes_.push_back(size);
+    return !fail_ && StringFile::Write(data, size);
+  }
+
+  void set_fail(bool fail) { fail_ = fail; }
+  const std::vector<size_t>& write_sizes() const { return write_sizes_; }
+
+ private:
+  std::vector<size_t> write_sizes_;
+  bool fail_;
+};
+
+TEST(PipelinedFileWriter, WritesInOrder) {
+  RecordingStringFile string_file;
+  std::string expected;
+  {
+    PipelinedFileWriter writer(&string_file, 8);
+    for (int index = 0; index < 100; ++index) {
+      const std::string piece(index % 13 + 1, 'a' + index % 26);
+      EXPECT_TRUE(writer.Write(piece.data(), piece.size()));
+      expected += piece;
+    }
+    EXPECT_TRUE(writer.Flush());
+  }
+  EXPECT_EQ(string_file.string(), expected);
+
+  // Everything but the last block was written in full blocks.
+  ASSERT_FALSE(string_file.write_sizes().empty());
+  for (size_t index = 0; index < string_file.write_sizes().size() - 1;
+       ++index) {
+    EXPECT_EQ(string_file.write_sizes()[index], 8u);
+  }
+}
+
+TEST(PipelinedFileWriter, LargeWrite) {
+  RecordingStringFile string_file;
+  PipelinedFileWriter writer(&string_file, 4);
+
+  EXPECT_TRUE(writer.Write("ab", 2));
+  EXPECT_TRUE(writer.Write("cdefghij", 8));
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abcdefghij");
+  EXPECT_EQ(string_file.write_sizes(), (std::vector<size_t>{4, 4, 2}));
+}
+
+TEST(PipelinedFileWriter, WriteIoVec) {
+  StringFile string_file;
+  PipelinedFileWriter writer(&string_file, 5);
+
+  std::vector<WritableIoVec> iovecs;
+  EXPECT_FALSE(writer.WriteIoVec(&iovecs));
+
+  WritableIoVec iov;
+  iov.iov_base = "Hello, ";
+  iov.iov_len = 7;
+  iovecs.push_back(iov);
+  iov.iov_base = "world";
+  iov.iov_len = 5;
+  iovecs.push_back(iov);
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "Hello, world");
+}
+
+TEST(PipelinedFileWriter, Seek) {
+  StringFile string_file;
+  PipelinedFileWriter writer(&string_file, 4);
+
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 0);
+  EXPECT_TRUE(writer.Write("header", 6));
+  EXPECT_TRUE(writer.Write("body", 4));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 10);
+
+  EXPECT_EQ(writer.Seek(0, SEEK_SET), 0);
+  EXPECT_EQ(string_file.string(), "headerbody");
+  EXPECT_TRUE(writer.Write("HEADER", 6));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 6);
+  EXPECT_EQ(writer.Seek(0, SEEK_END), 10);
+  EXPECT_EQ(string_file.string(), "HEADERbody");
+
+  EXPECT_TRUE(writer.Write("tail", 4));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 14);
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "HEADERbodytail");
+}
+
+TEST(PipelinedFileWriter, UnderlyingFileHandle) {
+  StringFile string_file;
+  PipelinedFileWriter writer(&string_file);
+
+  EXPECT_TRUE(writer.Write("data", 4));
+  EXPECT_EQ(writer.UnderlyingFileHandle(), kInvalidFileHandle);
+  EXPECT_EQ(string_file.string(), "data");
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 4);
+}
+
+TEST(PipelinedFileWriter, FlushesOnDestruction) {
+  StringFile string_file;
+  {
+    PipelinedFileWriter writer(&string_file);
+    EXPECT_TRUE(writer.Write("pending", 7));
+  }
+  EXPECT_EQ(string_file.string(), "pending");
+}
+
+TEST(PipelinedFileWriter, Failure) {
+  RecordingStringFile string_file;
+  string_file.set_fail(true);
+  PipelinedFileWriter writer(&string_file, 4);
+
+  // The first block is accepted before the writer thread finds that it
+  // can’t be written.
+  EXPECT_TRUE(writer.Write("abcd", 4));
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_FALSE(writer.Write("e", 1));
+  EXPECT_EQ(writer.Seek(0, SEEK_SET), -1);
+  EXPECT_EQ(writer.UnderlyingFileHandle(), kInvalidFileHandle);
+  EXPECT_EQ(string_file.write_sizes(), (std::vector<size_t>{4}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -17,7 +17,7 @@
 namespace crashpad {
 namespace internal {
 
-IOSIntermediateDumpData::IOSIntermediateDumpData() : data_() {}
+IOSIntermediateDumpData::IOSIntermediateDumpData() : data_(), bytes_() {}
 
 IOSIntermediateDumpData::~IOSIntermediateDumpData() {}
 
@@ -26,13 +26,14 @@ IOSIntermediateDumpObject::Type IOSIntermediateDumpData::GetType() const {
 }
 
 std::string IOSIntermediateDumpData::GetString() const {
-  return std::string(reinterpret_cast<const char*>(data_.data()), data_.size());
+  return std::string(reinterpret_cast<const char*>(bytes_.data()),
+                     bytes_.size());
 }
 
 bool IOSIntermediateDumpData::GetValueInternal(void* value,
                                                size_t value_size) const {
-  if (value_size == data_.size()) {
-    memcpy(value, data_.data(), data_.size());
+  if (value_size == bytes_.size()) {
+    memcpy(value, bytes_.data(), bytes_.size());
     return true;
   }
   return false;
@@ -18,12 +18,14 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "util/ios/ios_intermediate_dump_object.h"
 
 namespace crashpad {
 namespace internal {
 
-//! \brief A data object, consisting of a std::vector<uint8_t>.
+//! \brief A data object, consisting of bytes that are either owned by the
+//!     object, or that refer to a memory-mapped intermediate dump.
 class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
  public:
   IOSIntermediateDumpData();
@@ -36,8 +38,15 @@ class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
   //! \brief Constructs a new data object which owns a std::vector<uint8_t>.
   //!
   //! \param[in] data An array of uint8_t.
-  //! \param[in] length The length of \a data.
-  IOSIntermediateDumpData(std::vector<uint8_t> data) : data_(std::move(data)) {}
+  IOSIntermediateDumpData(std::vector<uint8_t> data)
+      : data_(std::move(data)), bytes_(data_.data(), data_.size()) {}
+
+  //! \brief Constructs a new data object which refers to \a bytes without
+  //!     copying them.
+  //!
+  //! \param[in] bytes The object’s data, which must outlive it.
+  explicit IOSIntermediateDumpData(base::span<const uint8_t> bytes)
+      : data_(), bytes_(bytes) {}
 
   // IOSIntermediateDumpObject:
   Type GetType() const override;
@@ -55,12 +64,13 @@ class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
     return GetValueInternal(reinterpret_cast<void*>(value), sizeof(*value));
   }
 
-  const std::vector<uint8_t>& bytes() const { return data_; }
+  base::span<const uint8_t> bytes() const { return bytes_; }
 
  private:
   bool GetValueInternal(void* value, size_t value_size) const;
 
   std::vector<uint8_t> data_;
+  base::span<const uint8_t> bytes_;
 };
 
 }  // namespace internal
@@ -41,6 +41,11 @@ FileOffset IOSIntermediateDumpFilePath::Size() const {
   return LoggingFileSizeByHandle(handle_.get());
 }
 
+FileHandle IOSIntermediateDumpFilePath::MappableFileHandle() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return handle_.get();
+}
+
 IOSIntermediateDumpByteArray::IOSIntermediateDumpByteArray(const void* data,
                                                            size_t size) {
   string_file_ = std::make_unique<StringFile>();
@@ -56,5 +61,9 @@ FileOffset IOSIntermediateDumpByteArray::Size() const {
   return string_file_->string().size();
 }
 
+FileHandle IOSIntermediateDumpByteArray::MappableFileHandle() const {
+  return kInvalidFileHandle;
+}
+
 }  // namespace internal
 }  // namespace crashpad
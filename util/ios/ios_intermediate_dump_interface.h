@@ -29,6 +29,11 @@ class IOSIntermediateDumpInterface {
  public:
   virtual FileReaderInterface* FileReader() const = 0;
   virtual FileOffset Size() const = 0;
+
+  //! \brief Returns a handle to the file backing the intermediate dump, which
+  //!     may be memory-mapped instead of being read through FileReader(), or
+  //!     kInvalidFileHandle if there is no such file.
+  virtual FileHandle MappableFileHandle() const = 0;
 };
 
 //! \brief An intermediate dump backed by a FilePath. FilePath is unlinked
@@ -41,6 +46,7 @@ class IOSIntermediateDumpFilePath : public IOSIntermediateDumpInterface {
   // IOSIntermediateDumpInterface:
   FileReaderInterface* FileReader() const override;
   FileOffset Size() const override;
+  FileHandle MappableFileHandle() const override;
 
  private:
   ScopedFileHandle handle_;
@@ -56,6 +62,7 @@ class IOSIntermediateDumpByteArray : public IOSIntermediateDumpInterface {
   // IOSIntermediateDumpInterface
   FileReaderInterface* FileReader() const override;
   FileOffset Size() const override;
+  FileHandle MappableFileHandle() const override;
 
  private:
   std::unique_ptr<StringFile> string_file_;
@@ -14,10 +14,18 @@
 
 #include "util/ios/ios_intermediate_dump_reader.h"
 
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <stack>
+#include <type_traits>
 #include <vector>
 
+#include "base/check.h"
 #include "base/logging.h"
 #include "util/file/filesystem.h"
 #include "util/ios/ios_intermediate_dump_data.h"
@@ -29,6 +37,156 @@
 namespace crashpad {
 namespace internal {
 
+// Reads a memory-mapped intermediate dump, or reads from a FileReaderInterface
+// through a buffer, so that the many small reads made while parsing don’t each
+// result in a read from the file. Also decodes the fields whose width depends
+// on the dump’s encoding.
+class IntermediateDumpParseReader {
+ public:
+  explicit IntermediateDumpParseReader(FileReaderInterface* reader)
+      : reader_(reader),
+        mapping_(nullptr),
+        mapping_size_(0),
+        start_(reader->Seek(0, SEEK_CUR)),
+        consumed_(0),
+        buffer_offset_(0),
+        buffer_size_(0),
+        compact_(false) {}
+
+  IntermediateDumpParseReader(const uint8_t* mapping, size_t mapping_size)
+      : reader_(nullptr),
+        mapping_(mapping),
+        mapping_size_(mapping_size),
+        start_(0),
+        consumed_(0),
+        buffer_offset_(0),
+        buffer_size_(0),
+        compact_(false) {}
+
+  IntermediateDumpParseReader(const IntermediateDumpParseReader&) = delete;
+  IntermediateDumpParseReader& operator=(const IntermediateDumpParseReader&) =
+      delete;
+
+  void SetCompact(bool compact) { compact_ = compact; }
+
+  bool is_mapped() const { return mapping_ != nullptr; }
+
+  bool ReadExactly(void* data, size_t size) {
+    if (is_mapped()) {
+      base::span<const uint8_t> bytes;
+      if (!ReadMapped(size, &bytes)) {
+        return false;
+      }
+      memcpy(data, bytes.data(), size);
+      return true;
+    }
+
+    char* data_char = static_cast<char*>(data);
+    while (size > 0) {
+      if (buffer_offset_ == buffer_size_) {
+        if (size >= sizeof(buffer_)) {
+          if (!reader_->ReadExactly(data_char, size)) {
+            return false;
+          }
+          consumed_ += size;
+          return true;
+        }
+        FileOperationResult rv = reader_->Read(buffer_, sizeof(buffer_));
+        if (rv <= 0) {
+          return false;
+        }
+        buffer_offset_ = 0;
+        buffer_size_ = rv;
+      }
+
+      size_t size_to_copy = std::min(size, buffer_size_ - buffer_offset_);
+      memcpy(data_char, buffer_ + buffer_offset_, size_to_copy);
+      buffer_offset_ += size_to_copy;
+      consumed_ += size_to_copy;
+      data_char += size_to_copy;
+      size -= size_to_copy;
+    }
+    return true;
+  }
+
+  bool ReadKey(IntermediateDumpKey* key) {
+    if (!compact_) {
+      return ReadExactly(key, sizeof(*key));
+    }
+    uint64_t value;
+    if (!ReadVarint(&value) ||
+        value > std::numeric_limits<std::underlying_type_t<
+                    IntermediateDumpKey>>::max()) {
+      return false;
+    }
+    *key = static_cast<IntermediateDumpKey>(value);
+    return true;
+  }
+
+  bool ReadLength(size_t* length) {
+    if (!compact_) {
+      return ReadExactly(length, sizeof(*length));
+    }
+    uint64_t value;
+    if (!ReadVarint(&value) || value > std::numeric_limits<size_t>::max()) {
+      return false;
+    }
+    *length = static_cast<size_t>(value);
+    return true;
+  }
+
+  // Sets bytes to refer to the next size bytes of the mapping, without copying
+  // them. Only valid if is_mapped().
+  bool ReadMapped(size_t size, base::span<const uint8_t>* bytes) {
+    DCHECK(is_mapped());
+    if (size > mapping_size_ - static_cast<size_t>(consumed_)) {
+      return false;
+    }
+    *bytes = base::span<const uint8_t>(mapping_ + consumed_, size);
+    consumed_ += size;
+    return true;
+  }
+
+  // The position in the file of the next byte to be parsed.
+  FileOffset Position() const { return start_ + consumed_; }
+
+ private:
+  // Reads an unsigned LEB128 varint.
+  bool ReadVarint(uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadExactly(&byte, sizeof(byte))) {
+        return false;
+      }
+      if (shift == 63 && byte > 1) {
+        return false;
+      }
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  FileReaderInterface* reader_;  // weak
+  const uint8_t* mapping_;  // weak
+  const size_t mapping_size_;
+  const FileOffset start_;
+  FileOffset consumed_;
+  char buffer_[4096];
+  size_t buffer_offset_;
+  size_t buffer_size_;
+  bool compact_;
+};
+
+IOSIntermediateDumpReader::IOSIntermediateDumpReader()
+    : mapping_(), intermediate_dump_(), initialized_() {}
+
+IOSIntermediateDumpReader::~IOSIntermediateDumpReader() {}
+
 IOSIntermediateDumpReaderInitializeResult IOSIntermediateDumpReader::Initialize(
     const IOSIntermediateDumpInterface& dump_interface) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
@@ -39,9 +197,31 @@ IOSIntermediateDumpReaderInitializeResult IOSIntermediateDumpReader::Initialize(
     return IOSIntermediateDumpReaderInitializeResult::kFailure;
   }
 
+  // Prefer to map the file, so that data objects can refer to the mapping
+  // rather than each holding a copy of their data.
+  FileHandle handle = dump_interface.MappableFileHandle();
+  if (handle != kInvalidFileHandle && size > 0 &&
+      !mapping_.ResetMmap(nullptr,
+                          static_cast<size_t>(size),
+                          PROT_READ,
+                          MAP_PRIVATE,
+                          handle,
+                          0)) {
+    LOG(WARNING) << "Mapping intermediate dump failed, reading instead";
+  }
+
   IOSIntermediateDumpReaderInitializeResult result =
       IOSIntermediateDumpReaderInitializeResult::kSuccess;
-  if (!Parse(dump_interface.FileReader(), size)) {
+  bool parsed;
+  if (mapping_.is_valid()) {
+    IntermediateDumpParseReader parse_reader(
+        mapping_.addr_as<const uint8_t*>(), mapping_.len());
+    parsed = Parse(&parse_reader, size);
+  } else {
+    IntermediateDumpParseReader parse_reader(dump_interface.FileReader());
+    parsed = Parse(&parse_reader, size);
+  }
+  if (!parsed) {
     LOG(ERROR) << "Intermediate dump parsing failed";
     result = IOSIntermediateDumpReaderInitializeResult::kIncomplete;
   }
@@ -55,7 +235,7 @@ const IOSIntermediateDumpMap* IOSIntermediateDumpReader::RootMap() {
   return &intermediate_dump_;
 }
 
-bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
+bool IOSIntermediateDumpReader::Parse(IntermediateDumpParseReader* parse_reader,
                                       FileOffset file_size) {
   std::stack<IOSIntermediateDumpObject*> stack;
   stack.push(&intermediate_dump_);
@@ -63,13 +243,15 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
   using Type = IOSIntermediateDumpObject::Type;
 
   Command command;
-  if (!reader->ReadExactly(&command, sizeof(Command)) ||
-      command != Command::kRootMapStart) {
+  if (!parse_reader->ReadExactly(&command, sizeof(Command)) ||
+      (command != Command::kRootMapStart &&
+       command != Command::kCompactRootMapStart)) {
     LOG(ERROR) << "Unexpected start to root map.";
     return false;
   }
+  parse_reader->SetCompact(command == Command::kCompactRootMapStart);
 
-  while (reader->ReadExactly(&command, sizeof(Command))) {
+  while (parse_reader->ReadExactly(&command, sizeof(Command))) {
     constexpr int kMaxStackDepth = 10;
     if (stack.size() > kMaxStackDepth) {
       LOG(ERROR) << "Unexpected depth of intermediate dump data.";
@@ -85,7 +267,7 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           const auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
           stack.push(new_map.get());
           IntermediateDumpKey key;
-          if (!reader->ReadExactly(&key, sizeof(key)))
+          if (!parse_reader->ReadKey(&key))
             return false;
           if (key == IntermediateDumpKey::kInvalid)
             return false;
@@ -109,7 +291,7 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
         }
 
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!parse_reader->ReadKey(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
@@ -148,13 +330,13 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!parse_reader->ReadKey(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
 
         size_t value_length;
-        if (!reader->ReadExactly(&value_length, sizeof(value_length))) {
+        if (!parse_reader->ReadLength(&value_length)) {
           return false;
         }
 
@@ -165,16 +347,25 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        std::vector<uint8_t> data(value_length);
-        if (!reader->ReadExactly(data.data(), value_length)) {
-          return false;
+        std::unique_ptr<IOSIntermediateDumpData> data;
+        if (parse_reader->is_mapped()) {
+          base::span<const uint8_t> bytes;
+          if (!parse_reader->ReadMapped(value_length, &bytes)) {
+            return false;
+          }
+          data = std::make_unique<IOSIntermediateDumpData>(bytes);
+        } else {
+          std::vector<uint8_t> bytes(value_length);
+          if (!parse_reader->ReadExactly(bytes.data(), value_length)) {
+            return false;
+          }
+          data = std::make_unique<IOSIntermediateDumpData>(std::move(bytes));
         }
         auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
         if (parent_map->map_.find(key) != parent_map->map_.end()) {
           LOG(ERROR) << "Inserting duplicate key";
         }
-        parent_map->map_[key] =
-            std::make_unique<IOSIntermediateDumpData>(std::move(data));
+        parent_map->map_[key] = std::move(data);
         break;
       }
       case Command::kRootMapEnd: {
@@ -183,7 +374,7 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        if (reader->Seek(0, SEEK_CUR) != file_size) {
+        if (parse_reader->Position() != file_size) {
           LOG(ERROR) << "Root map ended before end of file.";
           return false;
         }
@@ -18,10 +18,13 @@
 #include "util/ios/ios_intermediate_dump_interface.h"
 #include "util/ios/ios_intermediate_dump_map.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
 
 namespace crashpad {
 namespace internal {
 
+class IntermediateDumpParseReader;
+
 //! \brief The return value for IOSIntermediateDumpReader::Initialize.
 enum class IOSIntermediateDumpReaderInitializeResult : int {
   //! \brief The intermediate dump was read successfully, initialization
@@ -40,18 +43,25 @@ enum class IOSIntermediateDumpReaderInitializeResult : int {
 //! \brief Open and parse iOS intermediate dumps.
 class IOSIntermediateDumpReader {
  public:
-  IOSIntermediateDumpReader() {}
+  IOSIntermediateDumpReader();
 
   IOSIntermediateDumpReader(const IOSIntermediateDumpReader&) = delete;
   IOSIntermediateDumpReader& operator=(const IOSIntermediateDumpReader&) =
       delete;
 
+  ~IOSIntermediateDumpReader();
+
   //! \brief Open and parses \a dump_interface.
   //!
   //! Will attempt to parse the binary file, similar to a JSON file, using the
   //! same format used by IOSIntermediateDumpWriter, resulting in an
   //! IOSIntermediateDumpMap
   //!
+  //! If \a dump_interface is backed by a file, the file is memory-mapped for
+  //! the lifetime of this object, and the IOSIntermediateDumpData objects in
+  //! the resulting map refer to the mapping rather than holding copies of
+  //! their data.
+  //!
   //! \param[in] dump_interface An interface corresponding to an intermediate
   //!     dump file.
   //!
@@ -66,7 +76,10 @@ class IOSIntermediateDumpReader {
   const IOSIntermediateDumpMap* RootMap();
 
  private:
-  bool Parse(FileReaderInterface* reader, FileOffset file_size);
+  bool Parse(IntermediateDumpParseReader* parse_reader, FileOffset file_size);
+
+  // Declared before intermediate_dump_, whose data may refer to it.
+  ScopedMmap mapping_;
   IOSIntermediateDumpMap intermediate_dump_;
   InitializationStateDcheck initialized_;
 };
@@ -260,6 +260,69 @@ TEST_F(IOSIntermediateDumpReaderTest, ReadValidData) {
   EXPECT_EQ(system_info, nullptr);
 }
 
+TEST_F(IOSIntermediateDumpReaderTest, ReadValidCompactData) {
+  IOSIntermediateDumpWriter writer(
+      IOSIntermediateDumpWriter::kDefaultBufferSize,
+      IOSIntermediateDumpWriter::Encoding::kCompact);
+  ASSERT_TRUE(writer.Open(path()));
+
+  // Long enough that its length takes more than one byte to encode.
+  const std::string region_data(300, 'r');
+  uint8_t version = 1;
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap scopedRoot(&writer);
+    EXPECT_TRUE(writer.AddProperty(Key::kVersion, &version));
+    {
+      IOSIntermediateDumpWriter::ScopedArray threadArray(
+          &writer, Key::kThreadContextMemoryRegions);
+      IOSIntermediateDumpWriter::ScopedArrayMap threadMap(&writer);
+      EXPECT_TRUE(writer.AddProperty(Key::kThreadContextMemoryRegionData,
+                                     region_data.c_str(),
+                                     region_data.length()));
+    }
+
+    {
+      IOSIntermediateDumpWriter::ScopedMap map(&writer, Key::kProcessInfo);
+      pid_t p_pid = getpid();
+      EXPECT_TRUE(writer.AddProperty(Key::kPID, &p_pid));
+    }
+  }
+  EXPECT_TRUE(writer.Close());
+
+  // The fixture’s dump_interface() refers to the file that writer_ opened, so
+  // read this one with its own.
+  internal::IOSIntermediateDumpFilePath dump_interface;
+  ASSERT_TRUE(dump_interface.Initialize(path()));
+  internal::IOSIntermediateDumpReader reader;
+  EXPECT_EQ(reader.Initialize(dump_interface), Result::kSuccess);
+  EXPECT_FALSE(IsRegularFile(path()));
+
+  auto root_map = reader.RootMap();
+  version = 0;
+  const auto version_data = root_map->GetAsData(Key::kVersion);
+  ASSERT_NE(version_data, nullptr);
+  EXPECT_TRUE(version_data->GetValue<uint8_t>(&version));
+  EXPECT_EQ(version, 1);
+
+  const auto process_info = root_map->GetAsMap(Key::kProcessInfo);
+  ASSERT_NE(process_info, nullptr);
+  const auto pid_data = process_info->GetAsData(Key::kPID);
+  ASSERT_NE(pid_data, nullptr);
+  pid_t p_pid = -1;
+  EXPECT_TRUE(pid_data->GetValue<pid_t>(&p_pid));
+  EXPECT_EQ(p_pid, getpid());
+
+  const auto thread_context_memory_regions =
+      root_map->GetAsList(Key::kThreadContextMemoryRegions);
+  ASSERT_NE(thread_context_memory_regions, nullptr);
+  ASSERT_EQ(thread_context_memory_regions->size(), 1UL);
+  for (const auto& region : *thread_context_memory_regions) {
+    const auto data = region->GetAsData(Key::kThreadContextMemoryRegionData);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(data->GetString(), region_data);
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
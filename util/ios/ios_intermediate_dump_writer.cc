@@ -17,9 +17,11 @@
 #include <fcntl.h>
 #include <mach/mach.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <iterator>
 #include <ostream>
 
 #include "base/check.h"
@@ -47,6 +49,50 @@ bool RawLoggingWriteFile(int fd, const void* data, size_t size) {
   return true;
 }
 
+// Like RawLoggingWriteFile, but writes each of the \a iovcnt buffers in \a iov
+// in order. \a iov is modified to track partial writes.
+bool RawLoggingWritevFile(int fd, iovec* iov, int iovcnt) {
+  while (true) {
+    while (iovcnt > 0 && iov->iov_len == 0) {
+      ++iov;
+      --iovcnt;
+    }
+    if (iovcnt == 0) {
+      return true;
+    }
+
+    ssize_t bytes_written = HANDLE_EINTR(writev(fd, iov, iovcnt));
+    if (bytes_written < 0 || bytes_written == 0) {
+      CRASHPAD_RAW_LOG_ERROR(bytes_written, "RawLoggingWritevFile");
+      return false;
+    }
+
+    size_t remaining = bytes_written;
+    while (remaining > 0) {
+      size_t consumed = std::min(remaining, iov->iov_len);
+      iov->iov_base = static_cast<char*>(iov->iov_base) + consumed;
+      iov->iov_len -= consumed;
+      remaining -= consumed;
+      if (iov->iov_len == 0) {
+        ++iov;
+        --iovcnt;
+      }
+    }
+  }
+}
+
+// Encodes value into data as an unsigned LEB128 varint, returning the number of
+// bytes written.
+size_t EncodeVarint(uint64_t value, uint8_t* data) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    data[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  data[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
 // Similar to LoggingCloseFile but with CRASHPAD_RAW_LOG.
 bool RawLoggingCloseFile(int fd) {
   int rv = IGNORE_EINTR(close(fd));
@@ -56,6 +102,14 @@ bool RawLoggingCloseFile(int fd) {
   return rv == 0;
 }
 
+IOSIntermediateDumpWriter::IOSIntermediateDumpWriter(size_t buffer_size,
+                                                     Encoding encoding)
+    : buffer_(new char[buffer_size]),
+      buffer_size_(buffer_size),
+      buffer_occupied_(0),
+      encoding_(encoding),
+      fd_(-1) {}
+
 IOSIntermediateDumpWriter::~IOSIntermediateDumpWriter() {
   CHECK_EQ(fd_, -1) << "Call Close() before this object is destroyed.";
 }
@@ -151,6 +205,39 @@ bool IOSIntermediateDumpWriter::ReadCStringInternal(const char* value,
 bool IOSIntermediateDumpWriter::AddPropertyInternal(IntermediateDumpKey key,
                                                     const char* value,
                                                     size_t value_length) {
+  uint8_t header[kMaxPropertyHeaderSize];
+  const size_t header_size = EncodePropertyHeader(key, value_length, header);
+
+  // Values that fit in `buffer_` are read with vm_read_overwrite() directly
+  // into it, which avoids mapping a copy of them with ScopedVMRead, and copying
+  // that into `buffer_`.
+  if (buffer_size_ >= header_size &&
+      value_length <= buffer_size_ - header_size) {
+    if (buffer_size_ - buffer_occupied_ < header_size + value_length &&
+        !FlushWriteBuffer()) {
+      return false;
+    }
+
+    char* value_buffer = buffer_.get() + buffer_occupied_ + header_size;
+    if (value_length > 0) {
+      vm_size_t bytes_read = 0;
+      kern_return_t kr =
+          vm_read_overwrite(mach_task_self(),
+                            reinterpret_cast<vm_address_t>(value),
+                            value_length,
+                            reinterpret_cast<vm_address_t>(value_buffer),
+                            &bytes_read);
+      if (kr != KERN_SUCCESS || bytes_read != value_length) {
+        // It's expected that this will sometimes fail. Don't log here.
+        return false;
+      }
+    }
+
+    memcpy(buffer_.get() + buffer_occupied_, header, header_size);
+    buffer_occupied_ += header_size + value_length;
+    return true;
+  }
+
   ScopedVMRead<char> vmread;
   if (!vmread.Read(value, value_length))
     return false;
@@ -163,15 +250,11 @@ bool IOSIntermediateDumpWriter::ArrayMapStart() {
 }
 
 bool IOSIntermediateDumpWriter::MapStart(IntermediateDumpKey key) {
-  const CommandType command_type = CommandType::kMapStart;
-  return BufferedWrite(&command_type, sizeof(command_type)) &&
-         BufferedWrite(&key, sizeof(key));
+  return KeyedCommand(CommandType::kMapStart, key);
 }
 
 bool IOSIntermediateDumpWriter::ArrayStart(IntermediateDumpKey key) {
-  const CommandType command_type = CommandType::kArrayStart;
-  return BufferedWrite(&command_type, sizeof(command_type)) &&
-         BufferedWrite(&key, sizeof(key));
+  return KeyedCommand(CommandType::kArrayStart, key);
 }
 
 bool IOSIntermediateDumpWriter::MapEnd() {
@@ -185,7 +268,9 @@ bool IOSIntermediateDumpWriter::ArrayEnd() {
 }
 
 bool IOSIntermediateDumpWriter::RootMapStart() {
-  const CommandType command_type = CommandType::kRootMapStart;
+  const CommandType command_type = encoding_ == Encoding::kCompact
+                                       ? CommandType::kCompactRootMapStart
+                                       : CommandType::kRootMapStart;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
@@ -197,62 +282,69 @@ bool IOSIntermediateDumpWriter::RootMapEnd() {
 bool IOSIntermediateDumpWriter::Property(IntermediateDumpKey key,
                                          const void* value,
                                          size_t value_length) {
-  const CommandType command_type = CommandType::kProperty;
-  return BufferedWrite(&command_type, sizeof(command_type)) &&
-         BufferedWrite(&key, sizeof(key)) &&
-         BufferedWrite(&value_length, sizeof(size_t)) &&
+  uint8_t header[kMaxPropertyHeaderSize];
+  const size_t header_size = EncodePropertyHeader(key, value_length, header);
+  return BufferedWrite(header, header_size) &&
          BufferedWrite(value, value_length);
 }
 
+size_t IOSIntermediateDumpWriter::EncodePropertyHeader(
+    IntermediateDumpKey key,
+    size_t value_length,
+    uint8_t* header) const {
+  const CommandType command_type = CommandType::kProperty;
+  memcpy(header, &command_type, sizeof(command_type));
+  size_t size = sizeof(command_type);
+  size += EncodeKey(key, header + size);
+  if (encoding_ == Encoding::kCompact) {
+    size += EncodeVarint(value_length, header + size);
+  } else {
+    memcpy(header + size, &value_length, sizeof(value_length));
+    size += sizeof(value_length);
+  }
+  return size;
+}
+
+size_t IOSIntermediateDumpWriter::EncodeKey(IntermediateDumpKey key,
+                                            uint8_t* data) const {
+  if (encoding_ == Encoding::kCompact) {
+    return EncodeVarint(static_cast<uint16_t>(key), data);
+  }
+  memcpy(data, &key, sizeof(key));
+  return sizeof(key);
+}
+
+bool IOSIntermediateDumpWriter::KeyedCommand(CommandType command_type,
+                                             IntermediateDumpKey key) {
+  uint8_t command[sizeof(command_type) + kMaxVarintSize];
+  memcpy(command, &command_type, sizeof(command_type));
+  const size_t key_size = EncodeKey(key, command + sizeof(command_type));
+  return BufferedWrite(command, sizeof(command_type) + key_size);
+}
+
 bool IOSIntermediateDumpWriter::FlushWriteBuffer() {
   size_t size = buffer_occupied_;
   buffer_occupied_ = 0;
-  return RawLoggingWriteFile(fd_, buffer_, size);
+  return RawLoggingWriteFile(fd_, buffer_.get(), size);
 }
 
 bool IOSIntermediateDumpWriter::BufferedWrite(const void* data,
                                               size_t data_size) {
-  const char* data_char = static_cast<const char*>(data);
-  // If `buffer_` is occupied, fill it up first, and flush if full.
-  if (buffer_occupied_ > 0) {
-    size_t data_size_to_copy =
-        std::min(kBufferSize - buffer_occupied_, data_size);
-    memcpy(buffer_ + buffer_occupied_, data_char, data_size_to_copy);
-    buffer_occupied_ += data_size_to_copy;
-    data_char += data_size_to_copy;
-    data_size -= data_size_to_copy;
-
-    if (buffer_occupied_ == kBufferSize) {
-      if (!FlushWriteBuffer()) {
-        return false;
-      }
-    }
-  }
-
-  // Either `data_size` is big enough that it could fill `buffer_`, trigger
-  // a FlushWriteBuffer, and reset `buffer_occuppied_` to zero, or there is no
-  // data left to process.
-  DCHECK(buffer_occupied_ == 0 || data_size == 0);
-
-  // Write the rest of the `data` in an increment of kBufferSize.
-  if (data_size >= kBufferSize) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    size_t data_size_to_write = data_size - (data_size % kBufferSize);
-    if (!RawLoggingWriteFile(fd_, data_char, data_size_to_write)) {
-      return false;
-    }
-    data_char += data_size_to_write;
-    data_size -= data_size_to_write;
-  }
-
-  // If there's any `data` left, put it in `buffer_`.
-  if (data_size > 0) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    memcpy(buffer_, data_char, data_size);
-    buffer_occupied_ = data_size;
+  if (data_size <= buffer_size_ - buffer_occupied_) {
+    memcpy(buffer_.get() + buffer_occupied_, data, data_size);
+    buffer_occupied_ += data_size;
+    return true;
   }
 
-  return true;
+  // `data` doesn’t fit in `buffer_`. Rather than filling and flushing
+  // `buffer_` and then writing the rest of `data`, write both at once.
+  iovec iov[2];
+  iov[0].iov_base = buffer_.get();
+  iov[0].iov_len = buffer_occupied_;
+  iov[1].iov_base = const_cast<void*>(data);
+  iov[1].iov_len = data_size;
+  buffer_occupied_ = 0;
+  return RawLoggingWritevFile(fd_, iov, static_cast<int>(std::size(iov)));
 }
 
 }  // namespace internal
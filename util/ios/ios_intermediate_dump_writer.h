@@ -17,6 +17,8 @@
 
 #include <sys/types.h>
 
+#include <memory>
+
 #include "base/files/file_path.h"
 #include "util/ios/ios_intermediate_dump_format.h"
 
@@ -38,10 +40,32 @@ namespace internal {
 //!
 //!  Similar to JSON, maps can contain other maps, arrays and properties.
 //!
+//! Keys and lengths are written either at their native widths, or, in the
+//! compact encoding, as unsigned LEB128 varints. The command that starts the
+//! root map identifies the encoding of the rest of the file.
+//!
 //! Note: All methods are `RUNS-DURING-CRASH`.
 class IOSIntermediateDumpWriter final {
  public:
-  IOSIntermediateDumpWriter() : buffer_occupied_(0), fd_(-1) {}
+  //! \brief The default size of the write buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \brief The encoding of keys and lengths.
+  enum class Encoding {
+    //! \brief Keys and lengths are written at their native widths.
+    kFixedWidth,
+
+    //! \brief Keys and lengths are written as unsigned LEB128 varints.
+    kCompact,
+  };
+
+  //! \param[in] buffer_size The size of the write buffer, which is allocated
+  //!     here so that no allocation is needed while writing a dump. Larger
+  //!     buffers result in fewer `write()` calls while a dump is written.
+  //! \param[in] encoding The encoding to write keys and lengths with.
+  explicit IOSIntermediateDumpWriter(
+      size_t buffer_size = kDefaultBufferSize,
+      Encoding encoding = Encoding::kFixedWidth);
 
   IOSIntermediateDumpWriter(const IOSIntermediateDumpWriter&) = delete;
   IOSIntermediateDumpWriter& operator=(const IOSIntermediateDumpWriter&) =
@@ -72,6 +96,10 @@ class IOSIntermediateDumpWriter final {
     //! \brief Indicates the end of the root map, and that there is nothing left
     //!     to parse.
     kRootMapEnd = 0x07,
+
+    //! \brief Indicates the start of the root map, and that the remaining keys
+    //!     and lengths are in the compact encoding.
+    kCompactRootMapStart = 0x08,
   };
 
   //! \brief Open and lock an intermediate dump file. This is the only method
@@ -229,23 +257,47 @@ class IOSIntermediateDumpWriter final {
                 const void* value,
                 size_t value_length);
 
+  //! \brief Encodes a kProperty command with the \a key \a value_length pair
+  //!     into \a header, which must be at least kMaxPropertyHeaderSize bytes.
+  //!
+  //! \return The number of bytes written to \a header.
+  size_t EncodePropertyHeader(IntermediateDumpKey key,
+                              size_t value_length,
+                              uint8_t* header) const;
+
+  //! \brief Encodes \a key into \a data, which must be at least
+  //!     kMaxVarintSize bytes.
+  //!
+  //! \return The number of bytes written to \a data.
+  size_t EncodeKey(IntermediateDumpKey key, uint8_t* data) const;
+
+  //! \return `true` if able to write a \a command_type command with the
+  //!     \a key.
+  bool KeyedCommand(CommandType command_type, IntermediateDumpKey key);
+
   //! \return `true` if able to write \a data up to \a size. The \a data might
-  //!     not be written to fd_  until `buffer_` is full or the writer is
-  //!     closed. All writes will be 4096 bytes (the size of your kBufferSize)
-  //!     except for the final flush, which might be partial.
+  //!     not be written to fd_ until `buffer_` is full or the writer is
+  //!     closed. When \a data doesn’t fit in `buffer_`, the buffered data and
+  //!     \a data are written together with a single `writev()`.
   bool BufferedWrite(const void* data, size_t size);
 
   //! \return `true` if able to write `buffer_` up to `buffer_occupied_`.
   bool FlushWriteBuffer();
 
-  //! \brief The maximum size of the write buffer.
-  static constexpr size_t kBufferSize = 4096;
+  //! \brief The maximum size of an unsigned LEB128 encoding of a `uint64_t`.
+  static constexpr size_t kMaxVarintSize = 10;
 
-  //! \brief The write data buffer and amount of that buffer occupied with data
-  //!   to be written.
-  char buffer_[kBufferSize];
-  size_t buffer_occupied_;
+  //! \brief The maximum size of the encoding of a kProperty command, key, and
+  //!     length.
+  static constexpr size_t kMaxPropertyHeaderSize =
+      sizeof(CommandType) + 2 * kMaxVarintSize;
 
+  //! \brief The write data buffer, its size, and the amount of that buffer
+  //!   occupied with data to be written.
+  std::unique_ptr<char[]> buffer_;
+  const size_t buffer_size_;
+  size_t buffer_occupied_;
+  const Encoding encoding_;
   int fd_;
 };
 
@@ -108,6 +108,43 @@ TEST_F(IOSIntermediateDumpWriterTest, Property) {
   ASSERT_EQ(contents, result);
 }
 
+TEST_F(IOSIntermediateDumpWriterTest, SmallBuffer) {
+  // Properties that don’t fit in the buffer must be written through it intact,
+  // as must those that are read directly into it afterwards.
+  IOSIntermediateDumpWriter writer(16);
+  EXPECT_TRUE(writer.Open(path()));
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap rootMap(&writer);
+    EXPECT_TRUE(writer.AddProperty(Key::kVersion, "version", 7));
+    EXPECT_TRUE(writer.AddProperty(Key::kVersion, "ab", 2));
+  }
+  EXPECT_TRUE(writer.Close());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path(), &contents));
+  std::string result(
+      "\6\5\1\0\a\0\0\0\0\0\0\0version\5\1\0\2\0\0\0\0\0\0\0ab\a", 33);
+  ASSERT_EQ(contents, result);
+}
+
+TEST_F(IOSIntermediateDumpWriterTest, CompactEncoding) {
+  IOSIntermediateDumpWriter writer(
+      IOSIntermediateDumpWriter::kDefaultBufferSize,
+      IOSIntermediateDumpWriter::Encoding::kCompact);
+  EXPECT_TRUE(writer.Open(path()));
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap rootMap(&writer);
+    IOSIntermediateDumpWriter::ScopedMap map(&writer, Key::kMachException);
+    EXPECT_TRUE(writer.AddProperty(Key::kVersion, "version", 7));
+  }
+  EXPECT_TRUE(writer.Close());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path(), &contents));
+  std::string result("\x08\1\xe8\7\5\1\7version\2\a", 16);
+  ASSERT_EQ(contents, result);
+}
+
 TEST_F(IOSIntermediateDumpWriterTest, PropertyString) {
   EXPECT_TRUE(writer_->Open(path()));
   EXPECT_TRUE(writer_->AddPropertyCString(Key::kVersion, 64, "version"));
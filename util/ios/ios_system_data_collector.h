@@ -17,6 +17,7 @@
 
 #import <CoreFoundation/CoreFoundation.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -42,10 +43,17 @@ class IOSSystemDataCollector {
   int DaylightOffsetSeconds() const { return daylight_offset_seconds_; }
   const std::string& StandardName() const { return standard_name_; }
   const std::string& DaylightName() const { return daylight_name_; }
-  bool IsApplicationActive() const { return active_; }
+  // May be called on any thread.
+  bool IsApplicationActive() const {
+    return active_.load(std::memory_order_relaxed);
+  }
   uint64_t AddressMask() const { return address_mask_; }
   uint64_t InitializationTime() const { return initialization_time_ns_; }
 
+  // Whether the device is warm enough to be throttled, or in Low Power Mode, so
+  // that work which is not urgent should be deferred.
+  bool IsDeviceUnderLoad() const;
+
   // Currently unused by minidump.
   int Orientation() const { return orientation_; }
 
@@ -72,7 +80,8 @@ class IOSSystemDataCollector {
   bool is_extension_;
   std::string machine_description_;
   int orientation_;
-  bool active_;
+  // Written on the main thread, and read on any.
+  std::atomic<bool> active_;
   int processor_count_;
   std::string cpu_vendor_;
   bool has_next_daylight_saving_time_;
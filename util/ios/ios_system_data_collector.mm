@@ -62,6 +62,7 @@ IOSSystemDataCollector::IOSSystemDataCollector()
       build_(),
       machine_description_(),
       orientation_(0),
+      active_(false),
       processor_count_(0),
       cpu_vendor_(),
       has_next_daylight_saving_time_(false),
@@ -148,6 +149,15 @@ void IOSSystemDataCollector::OSVersion(int* major,
   *bugfix = patch_version_;
 }
 
+bool IOSSystemDataCollector::IsDeviceUnderLoad() const {
+  // Unlike the other state here, this is read when needed rather than tracked
+  // with notifications, as it is only consulted occasionally. NSProcessInfo
+  // may be used from any thread.
+  NSProcessInfo* process_info = [NSProcessInfo processInfo];
+  return process_info.thermalState >= NSProcessInfoThermalStateFair ||
+         process_info.lowPowerModeEnabled;
+}
+
 void IOSSystemDataCollector::InstallHandlers() {
   // Timezone.
   AddObserver<IOSSystemDataCollector,
@@ -223,11 +233,11 @@ void IOSSystemDataCollector::ApplicationDidChangeActiveNotification() {
   NOTREACHED();
 #else
   dispatch_assert_queue_debug(dispatch_get_main_queue());
-  bool old_active = active_;
-  active_ = [UIApplication sharedApplication].applicationState ==
-            UIApplicationStateActive;
-  if (active_ != old_active && active_application_callback_) {
-    active_application_callback_(active_);
+  const bool active = [UIApplication sharedApplication].applicationState ==
+                      UIApplicationStateActive;
+  const bool old_active = active_.exchange(active, std::memory_order_relaxed);
+  if (active != old_active && active_application_callback_) {
+    active_application_callback_(active);
   }
 #endif
 }
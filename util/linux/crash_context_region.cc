@@ -0,0 +1,614 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/crash_context_region.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "build/build_config.h"
+#include "third_party/lss/lss.h"
+#include "util/linux/ptrace_connection.h"
+#include "util/linux/thread_info.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory_linux.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <asm/prctl.h>
+#endif
+
+#if !defined(MFD_CLOEXEC)
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint32_t kSignature = 'CPcx';
+
+// The ranges are the ExceptionInformation, the current stack, and the
+// interrupted stack.
+constexpr size_t kMaxRanges = 3;
+
+// Captured stacks start this far below the stack pointer, to include any
+// red zone.
+constexpr VMSize kRedZoneSize = 128;
+
+struct RegionHeader {
+  struct Range {
+    uint64_t address;
+    uint64_t size;
+    uint64_t offset;
+  };
+
+  uint32_t signature;
+  uint32_t range_count;
+  int32_t process_id;
+  uint32_t reserved;
+  Range ranges[kMaxRanges];
+
+  // The states of other threads, in thread_count slots starting at
+  // thread_offset. thread_slot_size is the client's sizeof(ThreadSlot), so that
+  // a handler that lays the slots out differently ignores them.
+  uint64_t thread_offset;
+  uint32_t thread_count;
+  uint32_t thread_slot_size;
+
+  // Nonzero once threads blocked in CaptureThisThread() may resume.
+  std::atomic<int32_t> resume;
+  uint32_t reserved_2;
+};
+
+// The state of a thread, captured by the thread itself.
+struct ThreadSlot {
+  enum State : int32_t {
+    // No capture was requested.
+    kEmpty = 0,
+
+    // The thread was signaled to capture its state.
+    kRequested,
+
+    // The thread is copying its state.
+    kCapturing,
+
+    // The thread's state is in info, and the thread is blocked.
+    kCaptured,
+
+    // The thread didn't capture its state in time, or couldn't.
+    kAbandoned,
+  };
+
+  int32_t thread_id;
+  std::atomic<int32_t> state;
+  ThreadContext thread_context;
+  FloatContext float_context;
+  uint64_t thread_specific_data_address;
+};
+
+static_assert(std::atomic<int32_t>::is_always_lock_free,
+              "futexes require lock-free atomics");
+
+constexpr size_t kDataOffset = (sizeof(RegionHeader) + 15) & ~size_t{15};
+constexpr size_t kThreadSlotSize = (sizeof(ThreadSlot) + 15) & ~size_t{15};
+
+// How long CaptureOtherThreads() waits for all threads to capture their states.
+constexpr int64_t kThreadCaptureTimeoutNanoseconds = 200 * 1000 * 1000;
+
+// A directory entry, as read by getdents64().
+struct LinuxDirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  uint16_t d_reclen;
+  uint8_t d_type;
+  char d_name[1];
+};
+
+int* FutexAddress(std::atomic<int32_t>* value) {
+  return reinterpret_cast<int*>(value);
+}
+
+void FutexWait(std::atomic<int32_t>* value,
+               int32_t expected,
+               const kernel_timespec* timeout) {
+  sys_futex(FutexAddress(value),
+            FUTEX_WAIT_PRIVATE,
+            expected,
+            timeout,
+            nullptr,
+            0);
+}
+
+void FutexWake(std::atomic<int32_t>* value) {
+  sys_futex(
+      FutexAddress(value), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+int64_t MonotonicNanoseconds() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return int64_t{now.tv_sec} * 1000 * 1000 * 1000 + now.tv_nsec;
+}
+
+// Fills info with the state of the calling thread, which was interrupted with
+// context. Returns false if this isn't supported.
+bool ThreadInfoFromContext(const ucontext_t* context, ThreadInfo* info) {
+#if defined(ARCH_CPU_X86_64)
+  const greg_t* gregs = context->uc_mcontext.gregs;
+  ThreadContext::t64_t& registers = info->thread_context.t64;
+  registers.r15 = gregs[REG_R15];
+  registers.r14 = gregs[REG_R14];
+  registers.r13 = gregs[REG_R13];
+  registers.r12 = gregs[REG_R12];
+  registers.rbp = gregs[REG_RBP];
+  registers.rbx = gregs[REG_RBX];
+  registers.r11 = gregs[REG_R11];
+  registers.r10 = gregs[REG_R10];
+  registers.r9 = gregs[REG_R9];
+  registers.r8 = gregs[REG_R8];
+  registers.rax = gregs[REG_RAX];
+  registers.rcx = gregs[REG_RCX];
+  registers.rdx = gregs[REG_RDX];
+  registers.rsi = gregs[REG_RSI];
+  registers.rdi = gregs[REG_RDI];
+  registers.orig_rax = static_cast<uint64_t>(-1);
+  registers.rip = gregs[REG_RIP];
+  registers.eflags = gregs[REG_EFL];
+  registers.rsp = gregs[REG_RSP];
+
+  // From the kernel’s struct sigcontext, cs, gs, fs, and ss are packed into
+  // this register. ss is only saved by newer kernels, and is 0 otherwise.
+  const uint64_t csgsfsss = gregs[REG_CSGSFS];
+  registers.cs = csgsfsss & 0xffff;
+  registers.gs = (csgsfsss >> 16) & 0xffff;
+  registers.fs = (csgsfsss >> 32) & 0xffff;
+  registers.ss = (csgsfsss >> 48) & 0xffff;
+  registers.ds = 0;
+  registers.es = 0;
+
+  // The thread's segment bases aren't changed by signal delivery.
+  unsigned long fs_base = 0;
+  unsigned long gs_base = 0;
+  syscall(SYS_arch_prctl, ARCH_GET_FS, &fs_base);
+  syscall(SYS_arch_prctl, ARCH_GET_GS, &gs_base);
+  registers.fs_base = fs_base;
+  registers.gs_base = gs_base;
+
+  static_assert(sizeof(info->float_context.f64.fxsave) ==
+                    sizeof(*context->uc_mcontext.fpregs),
+                "fxsave size mismatch");
+  if (context->uc_mcontext.fpregs) {
+    memcpy(&info->float_context.f64.fxsave,
+           context->uc_mcontext.fpregs,
+           sizeof(info->float_context.f64.fxsave));
+  }
+
+  info->thread_specific_data_address = fs_base;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// The largest region a handler accepts.
+constexpr size_t kMaxRegionSize = 4 * 1024 * 1024;
+
+VMAddress InterruptedStackPointer(const ucontext_t* context) {
+#if defined(ARCH_CPU_X86_64)
+  return context->uc_mcontext.gregs[REG_RSP];
+#elif defined(ARCH_CPU_X86)
+  return context->uc_mcontext.gregs[REG_ESP];
+#elif defined(ARCH_CPU_ARMEL)
+  return context->uc_mcontext.arm_sp;
+#elif defined(ARCH_CPU_ARM64)
+  return context->uc_mcontext.sp;
+#elif defined(ARCH_CPU_RISCV64)
+  return context->uc_mcontext.__gregs[2];
+#else
+  return 0;
+#endif
+}
+
+// Copies up to size bytes of this process' memory at address to buffer,
+// stopping at the first inaccessible page instead of faulting. Returns the
+// number of bytes copied.
+size_t CopyOwnMemory(VMAddress address, size_t size, void* buffer) {
+  iovec local_iov = {buffer, size};
+  iovec remote_iov = {reinterpret_cast<void*>(static_cast<uintptr_t>(address)),
+                      size};
+  // Use syscall() directly because older C libraries don’t provide a wrapper.
+  ssize_t bytes_copied = syscall(
+      SYS_process_vm_readv, sys_getpid(), &local_iov, 1, &remote_iov, 1, 0);
+  return bytes_copied > 0 ? bytes_copied : 0;
+}
+
+}  // namespace
+
+CrashContextRegion::CrashContextRegion()
+    : mapping_(), fd_(), stack_copy_size_(0), owner_process_id_(-1) {}
+
+CrashContextRegion::~CrashContextRegion() = default;
+
+bool CrashContextRegion::Initialize(size_t stack_copy_size,
+                                    size_t max_thread_contexts) {
+#if !defined(ARCH_CPU_X86_64)
+  if (max_thread_contexts > 0) {
+    LOG(ERROR) << "thread context capture not implemented";
+    return false;
+  }
+#endif
+
+  const size_t thread_offset =
+      (kDataOffset + sizeof(ExceptionInformation) + 2 * stack_copy_size + 15) &
+      ~size_t{15};
+  if (max_thread_contexts >
+          (kMaxRegionSize - std::min(thread_offset, kMaxRegionSize)) /
+              kThreadSlotSize ||
+      thread_offset > kMaxRegionSize) {
+    LOG(ERROR) << "crash context region too large";
+    return false;
+  }
+  const size_t size = thread_offset + max_thread_contexts * kThreadSlotSize;
+
+  // Use syscall() directly because older C libraries don’t provide a wrapper.
+  ScopedFileHandle fd(static_cast<int>(
+      syscall(SYS_memfd_create, "crashpad-crash-context", MFD_CLOEXEC)));
+  if (!fd.is_valid()) {
+    PLOG(ERROR) << "memfd_create";
+    return false;
+  }
+
+  if (ftruncate(fd.get(), size) != 0) {
+    PLOG(ERROR) << "ftruncate";
+    return false;
+  }
+
+  if (!mapping_.ResetMmap(
+          nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0)) {
+    return false;
+  }
+
+  // A forked child shares the region's file but mustn't capture into it, so
+  // the mapping isn't inherited at all.
+  if (madvise(mapping_.addr(), mapping_.len(), MADV_DONTFORK) != 0) {
+    PLOG(WARNING) << "madvise";
+  }
+
+  auto header = mapping_.addr_as<RegionHeader*>();
+  header->thread_offset = thread_offset;
+  header->thread_count = static_cast<uint32_t>(max_thread_contexts);
+  header->thread_slot_size = sizeof(ThreadSlot);
+
+  fd_ = std::move(fd);
+  stack_copy_size_ = stack_copy_size;
+  owner_process_id_ = getpid();
+  return true;
+}
+
+void CrashContextRegion::Capture(const ExceptionInformation* info) {
+  if (RequestFD() < 0) {
+    return;
+  }
+
+  auto header = mapping_.addr_as<RegionHeader*>();
+  char* const data = mapping_.addr_as<char*>();
+  header->signature = 0;
+
+  size_t offset = kDataOffset;
+  uint32_t range_count = 0;
+  auto add_range = [&](VMAddress address, size_t size) {
+    header->ranges[range_count].address = address;
+    header->ranges[range_count].size = size;
+    header->ranges[range_count].offset = offset;
+    ++range_count;
+    offset += size;
+  };
+
+  memcpy(data + offset, info, sizeof(*info));
+  add_range(FromPointerCast<VMAddress>(info), sizeof(*info));
+
+  // The current stack holds this signal handler's frames and, unless the
+  // interrupted stack is used for signal handling, the signal frame.
+  const VMAddress current_start =
+      FromPointerCast<VMAddress>(&header) - kRedZoneSize;
+  size_t current_size =
+      CopyOwnMemory(current_start, stack_copy_size_, data + offset);
+  if (current_size > 0) {
+    add_range(current_start, current_size);
+  }
+  const VMAddress current_end = current_start + current_size;
+
+  const VMAddress interrupted_sp = InterruptedStackPointer(
+      reinterpret_cast<const ucontext_t*>(info->context_address));
+  if (interrupted_sp > kRedZoneSize) {
+    VMAddress interrupted_start = interrupted_sp - kRedZoneSize;
+    VMAddress interrupted_end = interrupted_start + stack_copy_size_;
+
+    // Ranges mustn't overlap. When both stack pointers are on the same stack,
+    // only the part of the interrupted stack outside the current stack's
+    // range is copied.
+    if (current_size > 0 && interrupted_end > current_start &&
+        interrupted_start < current_end) {
+      if (interrupted_start >= current_start) {
+        interrupted_start = current_end;
+      } else {
+        interrupted_end = current_start;
+      }
+    }
+    if (interrupted_end > interrupted_start) {
+      size_t interrupted_size =
+          CopyOwnMemory(interrupted_start,
+                        interrupted_end - interrupted_start,
+                        data + offset);
+      if (interrupted_size > 0) {
+        add_range(interrupted_start, interrupted_size);
+      }
+    }
+  }
+
+  header->range_count = range_count;
+  header->process_id = owner_process_id_;
+  header->reserved = 0;
+  header->signature = kSignature;
+}
+
+void CrashContextRegion::CaptureOtherThreads(int signo) {
+  if (RequestFD() < 0) {
+    return;
+  }
+  auto header = mapping_.addr_as<RegionHeader*>();
+  if (header->thread_count == 0) {
+    return;
+  }
+  auto slot_at = [this, header](size_t index) {
+    return reinterpret_cast<ThreadSlot*>(mapping_.addr_as<char*>() +
+                                         header->thread_offset +
+                                         index * kThreadSlotSize);
+  };
+
+  header->resume.store(0);
+  for (size_t index = 0; index < header->thread_count; ++index) {
+    slot_at(index)->state.store(ThreadSlot::kEmpty);
+  }
+
+  const pid_t pid = sys_getpid();
+  const pid_t self = sys_gettid();
+  int task_directory =
+      HANDLE_EINTR(open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+  if (task_directory < 0) {
+    return;
+  }
+
+  // Request every thread's state before waiting for any of them.
+  size_t requested = 0;
+  char entries[4096];
+  long bytes_read;
+  while (requested < header->thread_count &&
+         (bytes_read = syscall(
+              SYS_getdents64, task_directory, entries, sizeof(entries))) > 0) {
+    for (long offset = 0; offset < bytes_read;) {
+      const auto entry =
+          reinterpret_cast<const LinuxDirent64*>(entries + offset);
+      offset += entry->d_reclen;
+
+      pid_t tid = 0;
+      const char* digit = entry->d_name;
+      for (; *digit >= '0' && *digit <= '9' && tid < INT_MAX / 10; ++digit) {
+        tid = tid * 10 + (*digit - '0');
+      }
+      if (*digit != '\0' || tid <= 0 || tid == self ||
+          requested == header->thread_count) {
+        continue;
+      }
+
+      ThreadSlot* slot = slot_at(requested);
+      slot->thread_id = tid;
+      slot->state.store(ThreadSlot::kRequested);
+      if (syscall(SYS_tgkill, pid, tid, signo) == 0) {
+        ++requested;
+      } else {
+        slot->state.store(ThreadSlot::kEmpty);
+      }
+    }
+  }
+  close(task_directory);
+
+  const int64_t deadline =
+      MonotonicNanoseconds() + kThreadCaptureTimeoutNanoseconds;
+  for (size_t index = 0; index < requested; ++index) {
+    ThreadSlot* slot = slot_at(index);
+    int32_t state;
+    while ((state = slot->state.load()) == ThreadSlot::kRequested ||
+           state == ThreadSlot::kCapturing) {
+      const int64_t remaining = deadline - MonotonicNanoseconds();
+      if (remaining <= 0 && state == ThreadSlot::kRequested) {
+        // The thread may still be about to capture its state, so only abandon
+        // it if it hasn't started.
+        if (slot->state.compare_exchange_strong(state,
+                                                ThreadSlot::kAbandoned)) {
+          break;
+        }
+        continue;
+      }
+
+      // A thread that started capturing its state finishes quickly, so it's
+      // waited for briefly even after the deadline.
+      kernel_timespec timeout;
+      const int64_t wait = std::max(remaining, int64_t{1000 * 1000});
+      timeout.tv_sec = wait / (1000 * 1000 * 1000);
+      timeout.tv_nsec = wait % (1000 * 1000 * 1000);
+      FutexWait(&slot->state, state, &timeout);
+    }
+  }
+}
+
+void CrashContextRegion::CaptureThisThread(const ucontext_t* context) {
+  if (RequestFD() < 0) {
+    return;
+  }
+  auto header = mapping_.addr_as<RegionHeader*>();
+
+  const pid_t self = sys_gettid();
+  ThreadSlot* slot = nullptr;
+  for (size_t index = 0; index < header->thread_count; ++index) {
+    auto candidate = reinterpret_cast<ThreadSlot*>(
+        mapping_.addr_as<char*>() + header->thread_offset +
+        index * kThreadSlotSize);
+    if (candidate->thread_id == self) {
+      slot = candidate;
+      break;
+    }
+  }
+
+  int32_t expected = ThreadSlot::kRequested;
+  if (!slot ||
+      !slot->state.compare_exchange_strong(expected, ThreadSlot::kCapturing)) {
+    return;
+  }
+
+  ThreadInfo info;
+  const bool captured = ThreadInfoFromContext(context, &info);
+  slot->thread_context = info.thread_context;
+  slot->float_context = info.float_context;
+  slot->thread_specific_data_address = info.thread_specific_data_address;
+  slot->state.store(captured ? ThreadSlot::kCaptured : ThreadSlot::kAbandoned);
+  FutexWake(&slot->state);
+  if (!captured) {
+    return;
+  }
+
+  while (header->resume.load() == 0) {
+    FutexWait(&header->resume, 0, nullptr);
+  }
+}
+
+void CrashContextRegion::ResumeOtherThreads() {
+  if (RequestFD() < 0) {
+    return;
+  }
+  auto header = mapping_.addr_as<RegionHeader*>();
+  header->resume.store(1);
+  FutexWake(&header->resume);
+}
+
+int CrashContextRegion::RequestFD() const {
+  if (!fd_.is_valid() || sys_getpid() != owner_process_id_) {
+    return -1;
+  }
+  return fd_.get();
+}
+
+bool CrashContextRegion::InitializeFromFD(ScopedFileHandle fd) {
+  struct stat st;
+  if (fstat(fd.get(), &st) != 0) {
+    PLOG(ERROR) << "fstat";
+    return false;
+  }
+  if (!S_ISREG(st.st_mode) || st.st_size < static_cast<off_t>(kDataOffset) ||
+      st.st_size > static_cast<off_t>(kMaxRegionSize)) {
+    LOG(ERROR) << "invalid crash context region size " << st.st_size;
+    return false;
+  }
+
+  // The client could still modify the region, so it's copied once and only the
+  // copy is validated and used.
+  std::vector<char> contents(st.st_size);
+  if (HANDLE_EINTR(pread(fd.get(), contents.data(), contents.size(), 0)) !=
+      static_cast<ssize_t>(contents.size())) {
+    PLOG(ERROR) << "pread";
+    return false;
+  }
+
+  const auto header = reinterpret_cast<const RegionHeader*>(contents.data());
+  if (header->signature != kSignature || header->range_count > kMaxRanges) {
+    LOG(ERROR) << "invalid crash context region";
+    return false;
+  }
+  for (uint32_t index = 0; index < header->range_count; ++index) {
+    const RegionHeader::Range& range = header->ranges[index];
+    if (range.offset < kDataOffset || range.offset > contents.size() ||
+        range.size > contents.size() - range.offset) {
+      LOG(ERROR) << "invalid crash context range";
+      return false;
+    }
+  }
+  if (header->thread_count > 0 &&
+      (header->thread_offset < kDataOffset ||
+       header->thread_offset > contents.size() ||
+       header->thread_count >
+           (contents.size() - header->thread_offset) / kThreadSlotSize)) {
+    LOG(ERROR) << "invalid crash context threads";
+    return false;
+  }
+
+  contents_ = std::move(contents);
+  return true;
+}
+
+void CrashContextRegion::AddThreadContexts(
+    PtraceConnection* connection) const {
+  if (contents_.empty()) {
+    return;
+  }
+
+  const auto header = reinterpret_cast<const RegionHeader*>(contents_.data());
+  if (header->thread_count > 0 &&
+      header->thread_slot_size != sizeof(ThreadSlot)) {
+    LOG(WARNING) << "ignoring thread contexts of a different architecture";
+    return;
+  }
+
+  for (uint32_t index = 0; index < header->thread_count; ++index) {
+    const auto slot = reinterpret_cast<const ThreadSlot*>(
+        contents_.data() + header->thread_offset + index * kThreadSlotSize);
+    if (slot->state.load() == ThreadSlot::kCaptured && slot->thread_id > 0) {
+      ThreadInfo info;
+      info.thread_context = slot->thread_context;
+      info.float_context = slot->float_context;
+      info.thread_specific_data_address = slot->thread_specific_data_address;
+      connection->SetCapturedThreadInfo(slot->thread_id, info);
+    }
+  }
+}
+
+void CrashContextRegion::AddToMemory(ProcessMemoryLinux* memory) const {
+  if (contents_.empty()) {
+    return;
+  }
+
+  const auto header = reinterpret_cast<const RegionHeader*>(contents_.data());
+  for (uint32_t index = 0; index < header->range_count; ++index) {
+    const RegionHeader::Range& range = header->ranges[index];
+    memory->AddLocalCopy(
+        range.address, contents_.data() + range.offset, range.size);
+  }
+}
+
+}  // namespace crashpad
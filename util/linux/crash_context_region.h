@@ -0,0 +1,143 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_CRASH_CONTEXT_REGION_H_
+#define CRASHPAD_UTIL_LINUX_CRASH_CONTEXT_REGION_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <ucontext.h>
+
+#include <vector>
+
+#include "util/file/file_io.h"
+#include "util/linux/exception_information.h"
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+
+class ProcessMemoryLinux;
+class PtraceConnection;
+
+//! \brief Memory shared between a client and its handler, into which the
+//!     client's signal handler copies the memory that the handler reads first.
+//!
+//! A client creates a region with Initialize() before it crashes. In its signal
+//! handler, Capture() copies the client's ExceptionInformation and the tops of
+//! the crashing thread's current and interrupted stacks, which hold the
+//! `siginfo_t` and `ucontext_t`, into the region. The region's file descriptor
+//! is sent with the crash dump request.
+//!
+//! The handler copies the region with InitializeFromFD() and uses AddToMemory()
+//! to serve reads of the copied ranges locally, reading only the remainder from
+//! the client.
+//!
+//! A region may also hold the states of the client's other threads. The
+//! crashing thread calls CaptureOtherThreads(), which sends each of them a
+//! cooperative signal whose handler calls CaptureThisThread(). That copies the
+//! thread's state into the region and blocks the thread until the crashing
+//! thread calls ResumeOtherThreads(). The handler uses AddThreadContexts() so
+//! that those threads needn't be attached to.
+class CrashContextRegion {
+ public:
+  CrashContextRegion();
+
+  CrashContextRegion(const CrashContextRegion&) = delete;
+  CrashContextRegion& operator=(const CrashContextRegion&) = delete;
+
+  ~CrashContextRegion();
+
+  //! \brief Creates a region in a client.
+  //!
+  //! \param[in] stack_copy_size The maximum number of bytes to copy from each
+  //!     of the crashing thread's current and interrupted stacks.
+  //! \param[in] max_thread_contexts The maximum number of other threads whose
+  //!     states CaptureOtherThreads() can capture. This is only supported on
+  //!     x86-64.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool Initialize(size_t stack_copy_size, size_t max_thread_contexts = 0);
+
+  //! \brief Copies the crashing thread's state into the region.
+  //!
+  //! This method is async-signal-safe. It does nothing in a process other than
+  //! the one that called Initialize(), such as a child forked later.
+  //!
+  //! \param[in] info The ExceptionInformation that will be given to the
+  //!     handler, which must be up to date. It mustn't be on the crashing
+  //!     thread's stack.
+  void Capture(const ExceptionInformation* info);
+
+  //! \brief Sends \a signo to each of the calling thread's sibling threads,
+  //!     and waits for their signal handlers to call CaptureThisThread().
+  //!
+  //! This method is async-signal-safe. It waits a limited time for the other
+  //! threads, so a thread which has \a signo blocked, or which doesn't respond
+  //! in time, is left running and attached to by the handler as usual.
+  //!
+  //! \param[in] signo The cooperative signal, whose handler calls
+  //!     CaptureThisThread().
+  void CaptureOtherThreads(int signo);
+
+  //! \brief Copies the calling thread's state into the region, if
+  //!     CaptureOtherThreads() requested it, and then blocks until
+  //!     ResumeOtherThreads() is called.
+  //!
+  //! This method is async-signal-safe. It is called by the cooperative signal's
+  //! handler.
+  //!
+  //! \param[in] context The context the signal handler received.
+  void CaptureThisThread(const ucontext_t* context);
+
+  //! \brief Resumes threads blocked in CaptureThisThread().
+  //!
+  //! This method is async-signal-safe.
+  void ResumeOtherThreads();
+
+  //! \brief Returns the file descriptor to send to the handler, or `-1` in a
+  //!     process other than the one that called Initialize().
+  //!
+  //! This method is async-signal-safe.
+  int RequestFD() const;
+
+  //! \brief Copies in a region received from a client.
+  //!
+  //! \param[in] fd The file descriptor received from the client.
+  //! \return `true` on success. `false` with a message logged if the region
+  //!     couldn't be read or its contents are invalid.
+  bool InitializeFromFD(ScopedFileHandle fd);
+
+  //! \brief Serves reads of the copied ranges in \a memory from the region.
+  //!
+  //! This object must outlive \a memory.
+  void AddToMemory(ProcessMemoryLinux* memory) const;
+
+  //! \brief Supplies the captured states of the client's threads to \a
+  //!     connection with PtraceConnection::SetCapturedThreadInfo().
+  void AddThreadContexts(PtraceConnection* connection) const;
+
+ private:
+  // In a client, the shared region.
+  ScopedMmap mapping_;
+  ScopedFileHandle fd_;
+
+  // In a handler, a copy of the received region.
+  std::vector<char> contents_;
+
+  size_t stack_copy_size_;
+  pid_t owner_process_id_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_CRASH_CONTEXT_REGION_H_
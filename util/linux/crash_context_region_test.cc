@@ -0,0 +1,179 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/crash_context_region.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <ucontext.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "test/linux/get_tls.h"
+#include "third_party/lss/lss.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/posix/signals.h"
+#include "util/process/process_memory_linux.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(CrashContextRegion, Uninitialized) {
+  CrashContextRegion region;
+  EXPECT_EQ(region.RequestFD(), -1);
+
+  ExceptionInformation info = {};
+  region.Capture(&info);
+}
+
+TEST(CrashContextRegion, CaptureAndRead) {
+  CrashContextRegion region;
+  ASSERT_TRUE(region.Initialize(4096));
+  ASSERT_GE(region.RequestFD(), 0);
+
+  // The ExceptionInformation is copied separately from the stack, so it
+  // mustn't be on the stack.
+  ucontext_t context = {};
+  static ExceptionInformation info;
+  info.siginfo_address = 0x1234;
+  info.context_address = FromPointerCast<VMAddress>(&context);
+  info.thread_id = 42;
+  region.Capture(&info);
+
+  // Change the original so that reads served from the copy can be told apart.
+  const ExceptionInformation captured = info;
+  info.thread_id = 43;
+
+  ScopedFileHandle dup_fd(fcntl(region.RequestFD(), F_DUPFD_CLOEXEC, 0));
+  ASSERT_TRUE(dup_fd.is_valid()) << ErrnoMessage("fcntl");
+  CrashContextRegion received;
+  ASSERT_TRUE(received.InitializeFromFD(std::move(dup_fd)));
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+  ProcessMemoryLinux memory(&connection);
+  received.AddToMemory(&memory);
+
+  ExceptionInformation read_info;
+  ASSERT_TRUE(memory.Read(
+      FromPointerCast<VMAddress>(&info), sizeof(read_info), &read_info));
+  EXPECT_EQ(read_info.siginfo_address, captured.siginfo_address);
+  EXPECT_EQ(read_info.context_address, captured.context_address);
+  EXPECT_EQ(read_info.thread_id, captured.thread_id);
+
+  // Reads outside of the copy still come from the process.
+  static int value = 7;
+  int read_value;
+  ASSERT_TRUE(memory.Read(
+      FromPointerCast<VMAddress>(&value), sizeof(read_value), &read_value));
+  EXPECT_EQ(read_value, value);
+}
+
+#if defined(ARCH_CPU_X86_64)
+CrashContextRegion* g_capture_region;
+
+void HandleCaptureSignal(int signo, siginfo_t* siginfo, void* context) {
+  g_capture_region->CaptureThisThread(static_cast<const ucontext_t*>(context));
+}
+
+TEST(CrashContextRegion, CaptureOtherThreads) {
+  CrashContextRegion region;
+  ASSERT_TRUE(region.Initialize(4096, 8));
+  g_capture_region = &region;
+
+  struct sigaction old_action;
+  ASSERT_TRUE(
+      Signals::InstallHandler(SIGUSR2, HandleCaptureSignal, 0, &old_action));
+
+  struct ThreadState {
+    pid_t tid;
+    LinuxVMAddress tls;
+  };
+  constexpr size_t kThreadCount = 3;
+  std::mutex states_lock;
+  std::vector<ThreadState> states;
+  Semaphore started(0);
+  Semaphore finish(0);
+  std::vector<std::thread> threads;
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    threads.emplace_back([&]() {
+      {
+        std::lock_guard<std::mutex> lock(states_lock);
+        states.push_back({sys_gettid(), GetTLS()});
+      }
+      started.Signal();
+      finish.Wait();
+    });
+    started.Wait();
+  }
+
+  ucontext_t context = {};
+  static ExceptionInformation info;
+  info.context_address = FromPointerCast<VMAddress>(&context);
+  info.thread_id = sys_gettid();
+  region.Capture(&info);
+  region.CaptureOtherThreads(SIGUSR2);
+
+  ScopedFileHandle dup_fd(fcntl(region.RequestFD(), F_DUPFD_CLOEXEC, 0));
+  ASSERT_TRUE(dup_fd.is_valid()) << ErrnoMessage("fcntl");
+  CrashContextRegion received;
+  ASSERT_TRUE(received.InitializeFromFD(std::move(dup_fd)));
+
+  region.ResumeOtherThreads();
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    finish.Signal();
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(sigaction(SIGUSR2, &old_action, nullptr), 0)
+      << ErrnoMessage("sigaction");
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+  received.AddThreadContexts(&connection);
+
+  EXPECT_FALSE(connection.CapturedThreadInfo(sys_gettid()));
+  for (const ThreadState& state : states) {
+    const ThreadInfo* thread_info = connection.CapturedThreadInfo(state.tid);
+    ASSERT_TRUE(thread_info);
+    EXPECT_EQ(thread_info->thread_specific_data_address, state.tls);
+    EXPECT_NE(thread_info->thread_context.t64.rsp, 0u);
+    EXPECT_NE(thread_info->thread_context.t64.rip, 0u);
+  }
+}
+#endif  // ARCH_CPU_X86_64
+
+TEST(CrashContextRegion, InvalidRegion) {
+  ScopedFileHandle fd(static_cast<int>(
+      syscall(SYS_memfd_create, "crash-context-test", 0)));
+  ASSERT_TRUE(fd.is_valid()) << ErrnoMessage("memfd_create");
+  ASSERT_EQ(ftruncate(fd.get(), 4096), 0) << ErrnoMessage("ftruncate");
+
+  CrashContextRegion region;
+  EXPECT_FALSE(region.InitializeFromFD(std::move(fd)));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
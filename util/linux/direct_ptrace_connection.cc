@@ -14,6 +14,8 @@
 
 #include "util/linux/direct_ptrace_connection.h"
 
+#include <stdio.h>
+
 #include <utility>
 
 #include "util/file/file_io.h"
@@ -57,6 +59,21 @@ bool DirectPtraceConnection::Attach(pid_t tid) {
   return true;
 }
 
+bool DirectPtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                           std::vector<pid_t>* attached) {
+  std::vector<bool> thread_attached;
+  bool result = PtraceAttachMultiple(tids, &thread_attached);
+  for (size_t index = 0; index < tids.size(); ++index) {
+    if (thread_attached[index]) {
+      auto attach = std::make_unique<ScopedPtraceAttach>();
+      attach->ResetAttached(tids[index]);
+      attachments_.push_back(std::move(attach));
+      attached->push_back(tids[index]);
+    }
+  }
+  return result;
+}
+
 bool DirectPtraceConnection::Is64Bit() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return ptracer_.Is64Bit();
@@ -67,12 +84,31 @@ bool DirectPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
   return ptracer_.GetThreadInfo(tid, info);
 }
 
+bool DirectPtraceConnection::GetThreadInfoWithoutFloatingPoint(
+    pid_t tid,
+    ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return ptracer_.GetThreadInfo(tid, info, false);
+}
+
 bool DirectPtraceConnection::ReadFileContents(const base::FilePath& path,
                                               std::string* contents) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return LoggingReadEntireFile(path, contents);
 }
 
+ScopedFileHandle DirectPtraceConnection::OpenMapsFile() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  char path[32];
+  snprintf(path, sizeof(path), "/proc/%d/maps", pid_);
+  return ScopedFileHandle(OpenFileForRead(base::FilePath(path)));
+}
+
+ScopedFileHandle DirectPtraceConnection::OpenTaskDirectory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return crashpad::OpenTaskDirectory(pid_);
+}
+
 ProcessMemoryLinux* DirectPtraceConnection::Memory() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (!memory_) {
@@ -54,10 +54,15 @@ class DirectPtraceConnection : public PtraceConnection {
 
   pid_t GetProcessID() override;
   bool Attach(pid_t tid) override;
+  bool AttachThreads(const std::vector<pid_t>& tids,
+                     std::vector<pid_t>* attached) override;
   bool Is64Bit() override;
   bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetThreadInfoWithoutFloatingPoint(pid_t tid, ThreadInfo* info) override;
   bool ReadFileContents(const base::FilePath& path,
                         std::string* contents) override;
+  ScopedFileHandle OpenMapsFile() override;
+  ScopedFileHandle OpenTaskDirectory() override;
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
   ssize_t ReadUpTo(VMAddress, size_t size, void* buffer) override;
@@ -0,0 +1,208 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/directory_watcher.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class DirectoryWatcher::WatchThread final : public Thread {
+ public:
+  WatchThread(base::ScopedFD inotify_fd,
+              base::ScopedFD stop_fd,
+              double delay,
+              const Callback& callback,
+              const EndedCallback& ended_callback)
+      : inotify_fd_(std::move(inotify_fd)),
+        stop_fd_(std::move(stop_fd)),
+        delay_milliseconds_(static_cast<int>(delay * 1E3)),
+        callback_(callback),
+        ended_callback_(ended_callback) {}
+
+  WatchThread(const WatchThread&) = delete;
+  WatchThread& operator=(const WatchThread&) = delete;
+
+  ~WatchThread() override {}
+
+  void RequestStop() {
+    uint64_t value = 1;
+    PCHECK(HANDLE_EINTR(write(stop_fd_.get(), &value, sizeof(value))) ==
+           sizeof(value))
+        << "write";
+  }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    if (!Watch() && ended_callback_) {
+      ended_callback_();
+    }
+  }
+
+  // Reports files moved into the directory until a stop is requested, in
+  // which case this returns true, or the watch ends on its own, in which case
+  // this returns false.
+  bool Watch() {
+    std::vector<base::FilePath> names;
+    bool watching = true;
+    while (watching) {
+      pollfd fds[2] = {};
+      fds[0].fd = stop_fd_.get();
+      fds[0].events = POLLIN;
+      fds[1].fd = inotify_fd_.get();
+      fds[1].events = POLLIN;
+      if (HANDLE_EINTR(poll(fds, std::size(fds), -1)) < 0) {
+        PLOG(ERROR) << "poll";
+        return false;
+      }
+      if (fds[0].revents) {
+        return true;
+      }
+      if (!fds[1].revents) {
+        continue;
+      }
+      watching = ReadEvents(&names);
+
+      if (delay_milliseconds_ > 0) {
+        // Wait out the delay, ending early only for Stop().
+        int result = HANDLE_EINTR(poll(fds, 1, delay_milliseconds_));
+        if (result < 0) {
+          PLOG(ERROR) << "poll";
+          return false;
+        }
+        if (result > 0) {
+          return true;
+        }
+        if (watching) {
+          watching = ReadEvents(&names);
+        }
+      }
+
+      for (const base::FilePath& name : names) {
+        callback_(name);
+      }
+      names.clear();
+    }
+    return false;
+  }
+
+  // Reads all available events, appending the names of files moved into the
+  // directory to names. Returns false if the watch can't continue.
+  bool ReadEvents(std::vector<base::FilePath>* names) {
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+      ssize_t bytes_read =
+          HANDLE_EINTR(read(inotify_fd_.get(), buffer, sizeof(buffer)));
+      if (bytes_read < 0) {
+        if (errno == EAGAIN) {
+          return true;
+        }
+        PLOG(ERROR) << "read";
+        return false;
+      }
+
+      for (ssize_t offset = 0; offset < bytes_read;) {
+        inotify_event event;
+        memcpy(&event, buffer + offset, sizeof(event));
+        const char* name = buffer + offset + sizeof(event);
+        offset += sizeof(event) + event.len;
+
+        if (event.mask & IN_Q_OVERFLOW) {
+          names->push_back(base::FilePath());
+        } else if ((event.mask & IN_MOVED_TO) && event.len > 0) {
+          names->push_back(base::FilePath(name));
+        }
+        if (event.mask & IN_IGNORED) {
+          // The directory was removed, or is on a file system that was
+          // unmounted.
+          LOG(WARNING) << "directory watch removed";
+          return false;
+        }
+      }
+    }
+  }
+
+  base::ScopedFD inotify_fd_;
+  base::ScopedFD stop_fd_;
+  int delay_milliseconds_;
+  Callback callback_;
+  EndedCallback ended_callback_;
+};
+
+DirectoryWatcher::DirectoryWatcher() = default;
+
+DirectoryWatcher::~DirectoryWatcher() {
+  if (thread_) {
+    Stop();
+  }
+}
+
+bool DirectoryWatcher::Start(const base::FilePath& directory,
+                             double delay,
+                             const Callback& callback,
+                             const EndedCallback& ended_callback) {
+  DCHECK(!thread_);
+  DCHECK_GE(delay, 0);
+
+  base::ScopedFD inotify_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+  if (!inotify_fd.is_valid()) {
+    PLOG(ERROR) << "inotify_init1";
+    return false;
+  }
+  if (inotify_add_watch(inotify_fd.get(),
+                        directory.value().c_str(),
+                        IN_MOVED_TO | IN_ONLYDIR) < 0) {
+    PLOG(ERROR) << "inotify_add_watch " << directory.value();
+    return false;
+  }
+
+  base::ScopedFD stop_fd(eventfd(0, EFD_CLOEXEC));
+  if (!stop_fd.is_valid()) {
+    PLOG(ERROR) << "eventfd";
+    return false;
+  }
+
+  thread_ = std::make_unique<WatchThread>(std::move(inotify_fd),
+                                          std::move(stop_fd),
+                                          delay,
+                                          callback,
+                                          ended_callback);
+  thread_->Start();
+  return true;
+}
+
+void DirectoryWatcher::Stop() {
+  DCHECK(thread_);
+  thread_->RequestStop();
+  thread_->Join();
+  thread_.reset();
+}
+
+}  // namespace crashpad
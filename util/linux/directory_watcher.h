@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
+#define CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
+
+#include <functional>
+#include <memory>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_file.h"
+
+namespace crashpad {
+
+//! \brief Watches a directory for files being moved into it, using inotify.
+//!
+//! Notifications are delivered on a dedicated thread, so that the watcher can
+//! be used alongside threads that otherwise only wake periodically. They can be
+//! delayed, so that a process that moves a file into the directory has a
+//! chance to finish with it first.
+class DirectoryWatcher {
+ public:
+  //! \brief Called on the watcher’s thread with the name of each file moved
+  //!     into the watched directory, relative to it.
+  //!
+  //! If the kernel’s event queue overflowed so that some names were lost, this
+  //! is called with an empty name.
+  using Callback = std::function<void(const base::FilePath& name)>;
+
+  //! \brief Called on the watcher’s thread if watching ends other than by
+  //!     Stop(), such as when the directory is removed or can’t be read.
+  //!
+  //! No more files will be reported. Stop() must still be called before
+  //! watching can be started again.
+  using EndedCallback = std::function<void()>;
+
+  DirectoryWatcher();
+
+  DirectoryWatcher(const DirectoryWatcher&) = delete;
+  DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+  //! \brief Stops watching, if Start() succeeded and Stop() hasn’t been called.
+  ~DirectoryWatcher();
+
+  //! \brief Starts watching a directory.
+  //!
+  //! This may only be called on a newly-constructed object or after a call to
+  //! Stop().
+  //!
+  //! \param[in] directory The directory to watch.
+  //! \param[in] delay The number of seconds to wait after a file is moved
+  //!     into \a directory before calling \a callback. Files moved in during
+  //!     the delay are reported together at its end.
+  //! \param[in] callback The function to call for each file moved into \a
+  //!     directory. It is copied into this object.
+  //! \param[in] ended_callback The function to call if watching ends other
+  //!     than by Stop(), or an empty function. It is copied into this object.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Start(const base::FilePath& directory,
+             double delay,
+             const Callback& callback,
+             const EndedCallback& ended_callback);
+
+  //! \brief Stops watching, waiting for any callback in progress to return.
+  //!
+  //! Files moved into the directory during a delay that is in progress are not
+  //! reported.
+  //!
+  //! This must not be called from within the callback.
+  void Stop();
+
+  //! \return `true` if Start() succeeded and Stop() hasn’t been called since.
+  //!     This remains `true` after watching ends on its own.
+  bool is_running() const { return !!thread_; }
+
+ private:
+  class WatchThread;
+
+  std::unique_ptr<WatchThread> thread_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
@@ -0,0 +1,181 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/directory_watcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "gtest/gtest.h"
+#include "test/filesystem.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/filesystem.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class NameRecorder {
+ public:
+  NameRecorder() : lock_(), names_(), semaphore_(0) {}
+
+  NameRecorder(const NameRecorder&) = delete;
+  NameRecorder& operator=(const NameRecorder&) = delete;
+
+  DirectoryWatcher::Callback Callback() {
+    return [this](const base::FilePath& name) {
+      {
+        base::AutoLock lock(lock_);
+        names_.push_back(name.value());
+      }
+      semaphore_.Signal();
+    };
+  }
+
+  // Waits for a name to be reported, and returns it.
+  std::string WaitForName() {
+    if (!semaphore_.TimedWait(10)) {
+      ADD_FAILURE() << "timed out";
+      return std::string();
+    }
+    base::AutoLock lock(lock_);
+    std::string name = names_.front();
+    names_.erase(names_.begin());
+    return name;
+  }
+
+  // Returns `true` if no names have been reported that haven’t been waited
+  // for.
+  bool Empty() {
+    base::AutoLock lock(lock_);
+    return names_.empty();
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<std::string> names_;
+  Semaphore semaphore_;
+};
+
+TEST(DirectoryWatcher, FilesMovedIn) {
+  ScopedTempDir temp_dir;
+  const base::FilePath watched(temp_dir.path().Append("watched"));
+  ASSERT_TRUE(
+      LoggingCreateDirectory(watched, FilePermissions::kOwnerOnly, false));
+
+  NameRecorder recorder;
+  DirectoryWatcher watcher;
+  EXPECT_FALSE(watcher.is_running());
+  ASSERT_TRUE(watcher.Start(watched, 0, recorder.Callback(), nullptr));
+  EXPECT_TRUE(watcher.is_running());
+
+  // Files created directly in the directory aren’t reported.
+  ASSERT_TRUE(CreateFile(watched.Append("created")));
+
+  const base::FilePath outside(temp_dir.path().Append("report"));
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("report")));
+  EXPECT_EQ(recorder.WaitForName(), "report");
+
+  // Renames within the directory are.
+  ASSERT_TRUE(
+      MoveFileOrDirectory(watched.Append("created"), watched.Append("moved")));
+  EXPECT_EQ(recorder.WaitForName(), "moved");
+
+  watcher.Stop();
+  EXPECT_FALSE(watcher.is_running());
+
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("unwatched")));
+  EXPECT_TRUE(recorder.Empty());
+
+  // The watcher can be restarted.
+  ASSERT_TRUE(watcher.Start(watched, 0, recorder.Callback(), nullptr));
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("restarted")));
+  EXPECT_EQ(recorder.WaitForName(), "restarted");
+  EXPECT_TRUE(recorder.Empty());
+}
+
+TEST(DirectoryWatcher, Delay) {
+  ScopedTempDir temp_dir;
+  const base::FilePath watched(temp_dir.path().Append("watched"));
+  ASSERT_TRUE(
+      LoggingCreateDirectory(watched, FilePermissions::kOwnerOnly, false));
+
+  NameRecorder recorder;
+  DirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Start(watched, 0.2, recorder.Callback(), nullptr));
+
+  const base::FilePath outside(temp_dir.path().Append("report"));
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("first")));
+  EXPECT_TRUE(recorder.Empty());
+
+  // A file moved in during the delay is reported with the first.
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("second")));
+  EXPECT_EQ(recorder.WaitForName(), "first");
+  EXPECT_EQ(recorder.WaitForName(), "second");
+
+  // Stop() doesn’t wait for a delay in progress.
+  ASSERT_TRUE(CreateFile(outside));
+  ASSERT_TRUE(MoveFileOrDirectory(outside, watched.Append("third")));
+  watcher.Stop();
+  EXPECT_TRUE(recorder.Empty());
+}
+
+TEST(DirectoryWatcher, DirectoryRemoved) {
+  ScopedTempDir temp_dir;
+  const base::FilePath watched(temp_dir.path().Append("watched"));
+  ASSERT_TRUE(
+      LoggingCreateDirectory(watched, FilePermissions::kOwnerOnly, false));
+
+  NameRecorder recorder;
+  Semaphore ended(0);
+  DirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Start(
+      watched, 0, recorder.Callback(), [&ended]() { ended.Signal(); }));
+
+  // Removing the directory ends the watch, which is reported.
+  ASSERT_TRUE(LoggingRemoveDirectory(watched));
+  EXPECT_TRUE(ended.TimedWait(10));
+  EXPECT_TRUE(watcher.is_running());
+  watcher.Stop();
+  EXPECT_FALSE(watcher.is_running());
+  EXPECT_TRUE(recorder.Empty());
+
+  // Stop() isn’t reported.
+  ASSERT_TRUE(
+      LoggingCreateDirectory(watched, FilePermissions::kOwnerOnly, false));
+  ASSERT_TRUE(watcher.Start(
+      watched, 0, recorder.Callback(), [&ended]() { ended.Signal(); }));
+  watcher.Stop();
+  EXPECT_FALSE(ended.TimedWait(0));
+}
+
+TEST(DirectoryWatcher, MissingDirectory) {
+  ScopedTempDir temp_dir;
+  NameRecorder recorder;
+  DirectoryWatcher watcher;
+  EXPECT_FALSE(watcher.Start(
+      temp_dir.path().Append("missing"), 0, recorder.Callback(), nullptr));
+  EXPECT_FALSE(watcher.is_running());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
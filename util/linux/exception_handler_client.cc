@@ -66,6 +66,9 @@ class ScopedSigprocmaskRestore {
 
 ExceptionHandlerClient::ExceptionHandlerClient(int sock, bool multiple_clients)
     : server_sock_(sock),
+      crash_context_fd_(-1),
+      broker_buffer_(nullptr),
+      broker_buffer_size_(0),
       ptracer_(-1),
       can_set_ptracer_(true),
       multiple_clients_(multiple_clients) {}
@@ -153,6 +156,10 @@ int ExceptionHandlerClient::SendCrashDumpRequest(
       ExceptionHandlerProtocol::ClientToServerMessage::kTypeCrashDumpRequest;
   message.requesting_thread_stack_address = stack_pointer;
   message.client_info = info;
+  if (crash_context_fd_ >= 0) {
+    return UnixCredentialSocket::SendMsg(
+        server_sock_, &message, sizeof(message), &crash_context_fd_, 1);
+  }
   return UnixCredentialSocket::SendMsg(server_sock_, &message, sizeof(message));
 }
 
@@ -187,6 +194,10 @@ int ExceptionHandlerClient::WaitForCrashDumpComplete() {
 #endif  // ARCH_CPU_64_BITS
 
           PtraceBroker broker(server_sock_, getppid(), am_64_bit);
+          if (broker_buffer_ &&
+              broker_buffer_size_ > PtraceBroker::kDefaultBufferSize) {
+            broker.SetBuffer(broker_buffer_, broker_buffer_size_);
+          }
           _exit(broker.Run());
         }
 
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_UTIL_LINUX_EXCEPTION_HANDLER_CLIENT_H_
 #define CRASHPAD_UTIL_LINUX_EXCEPTION_HANDLER_CLIENT_H_
 
+#include <stddef.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -68,6 +69,26 @@ class ExceptionHandlerClient {
   //! \param[in] can_set_ptracer Whether SetPtracer should be enabled.
   void SetCanSetPtracer(bool can_set_ptracer);
 
+  //! \brief Sends a CrashContextRegion with crash dump requests.
+  //!
+  //! \param[in] fd The file descriptor returned by
+  //!     CrashContextRegion::RequestFD(), or `-1` to send no region.
+  void SetCrashContextFD(int fd) { crash_context_fd_ = fd; }
+
+  //! \brief Sets a buffer for a PtraceBroker forked at the handler's request
+  //!     to stage data in.
+  //!
+  //! \param[in] buffer A buffer, which should have been allocated before the
+  //!     crash, or `nullptr` to have the broker use its default buffer.
+  //! \param[in] size The size of \a buffer. Buffers no larger than
+  //!     PtraceBroker::kDefaultBufferSize aren't used.
+  //!
+  //! \sa PtraceBroker::SetBuffer()
+  void SetBrokerBuffer(char* buffer, size_t size) {
+    broker_buffer_ = buffer;
+    broker_buffer_size_ = size;
+  }
+
  private:
   int SendCrashDumpRequest(
       const ExceptionHandlerProtocol::ClientInformation& info,
@@ -77,6 +98,9 @@ class ExceptionHandlerClient {
   int WaitForCrashDumpComplete();
 
   int server_sock_;
+  int crash_context_fd_;
+  char* broker_buffer_;
+  size_t broker_buffer_size_;
   pid_t ptracer_;
   bool can_set_ptracer_;
   bool multiple_clients_;
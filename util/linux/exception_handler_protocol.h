@@ -23,6 +23,7 @@
 #include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/misc/address_types.h"
+#include "util/misc/uuid.h"
 
 namespace crashpad {
 
@@ -81,6 +82,8 @@ class ExceptionHandlerProtocol {
       kTypeCheckCredentials,
 
       //! \brief Used to request a crash dump for the sending client.
+      //!
+      //! The message may carry the file descriptor of a CrashContextRegion.
       kTypeCrashDumpRequest
     };
 
@@ -123,6 +126,28 @@ class ExceptionHandlerProtocol {
     pid_t pid;
   };
 
+  //! \brief The message a handler sends to a minidump consumer.
+  //!
+  //! The handler connects to the consumer’s `AF_UNIX` `SOCK_SEQPACKET` socket
+  //! for each minidump it hands off, and sends this message with the file
+  //! descriptor of a memfd holding the minidump, passed with `SCM_RIGHTS`.
+  struct MinidumpHandoffMessage {
+    static constexpr int32_t kVersion = 1;
+
+    //! \brief Indicates what message version is being used.
+    int32_t version;
+
+    //! \brief The process ID of the client that the minidump is of.
+    pid_t client_pid;
+
+    //! \brief The size of the minidump, which starts at offset 0 of the memfd.
+    uint64_t minidump_size;
+
+    //! \brief The report ID recorded in the minidump. When the minidump was
+    //!     also written to a crash report database, this is its ID there.
+    UUID report_id;
+  };
+
   ExceptionHandlerProtocol() = delete;
   ExceptionHandlerProtocol(const ExceptionHandlerProtocol&) = delete;
   ExceptionHandlerProtocol& operator=(const ExceptionHandlerProtocol&) = delete;
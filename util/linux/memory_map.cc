@@ -14,26 +14,67 @@
 
 #include "util/linux/memory_map.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <linux/fs.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/sysmacros.h>
 
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
-#include "util/file/delimited_file_reader.h"
 #include "util/file/file_io.h"
-#include "util/file/string_file.h"
-#include "util/stdlib/string_number_conversion.h"
+#include "util/misc/from_pointer_cast.h"
 
 namespace crashpad {
 
 namespace {
 
+// Parses a number in |base| from the start of |string|, up to |delimiter|, and
+// removes the number and the delimiter from |string|. The number must have at
+// least |min_digits| digits and be followed by the delimiter. This operates in
+// place, so that parsing large maps files doesn’t require a string allocation
+// for each field.
 template <typename Type>
-bool HexStringToNumber(const std::string& string, Type* number) {
-  return StringToNumber("0x" + string, number);
+bool ConsumeNumber(std::string_view* string,
+                   unsigned int base,
+                   char delimiter,
+                   size_t min_digits,
+                   Type* number) {
+  Type value = 0;
+  size_t index;
+  for (index = 0; index < string->size() && (*string)[index] != delimiter;
+       ++index) {
+    const char c = (*string)[index];
+    unsigned int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (base == 16 && c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (base == 16 && c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (value > (std::numeric_limits<Type>::max() - digit) / base) {
+      return false;
+    }
+    value = value * base + digit;
+  }
+  if (index < std::max(min_digits, size_t{1}) || index == string->size()) {
+    return false;
+  }
+  *number = value;
+  string->remove_prefix(index + 1);
+  return true;
 }
 
 // The result from parsing a line from the maps file.
@@ -52,32 +93,35 @@ enum class ParseResult {
   kError
 };
 
-// Reads a line from a maps file being read by maps_file_reader and extends
-// mappings with a new MemoryMap::Mapping describing the line.
-ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
+// Parses the line at the start of |contents|, removes it from |contents|, and
+// extends mappings with a new MemoryMap::Mapping describing the line.
+ParseResult ParseMapsLine(std::string_view* contents,
                           std::vector<MemoryMap::Mapping>* mappings) {
-  std::string field;
+  if (contents->empty()) {
+    return ParseResult::kEndOfFile;
+  }
+
+  const size_t line_end = contents->find('\n');
+  if (line_end == std::string_view::npos) {
+    LOG(ERROR) << "format error";
+    return ParseResult::kError;
+  }
+  // The trailing newline is left in |line| so that each field, including the
+  // last, is followed by a delimiter.
+  std::string_view line = contents->substr(0, line_end + 1);
+  contents->remove_prefix(line_end + 1);
+
   LinuxVMAddress start_address;
-  switch (maps_file_reader->GetDelim('-', &field)) {
-    case DelimitedFileReader::Result::kError:
-      return ParseResult::kError;
-    case DelimitedFileReader::Result::kEndOfFile:
-      return ParseResult::kEndOfFile;
-    case DelimitedFileReader::Result::kSuccess:
-      field.pop_back();
-      if (!HexStringToNumber(field, &start_address)) {
-        LOG(ERROR) << "format error";
-        return ParseResult::kError;
-      }
-      if (!mappings->empty() && start_address < mappings->back().range.End()) {
-        return ParseResult::kRetry;
-      }
+  if (!ConsumeNumber(&line, 16, '-', 1, &start_address)) {
+    LOG(ERROR) << "format error";
+    return ParseResult::kError;
+  }
+  if (!mappings->empty() && start_address < mappings->back().range.End()) {
+    return ParseResult::kRetry;
   }
 
   LinuxVMAddress end_address;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &end_address))) {
+  if (!ConsumeNumber(&line, 16, ' ', 1, &end_address)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
@@ -87,12 +131,6 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   }
   // Skip zero-length mappings.
   if (end_address == start_address) {
-    std::string rest_of_line;
-    if (maps_file_reader->GetLine(&rest_of_line) !=
-        DelimitedFileReader::Result::kSuccess) {
-      LOG(ERROR) << "format error";
-      return ParseResult::kError;
-    }
     return ParseResult::kSuccess;
   }
 
@@ -106,9 +144,7 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   MemoryMap::Mapping mapping;
   mapping.range.SetRange(is_64_bit, start_address, end_address - start_address);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size() != 4)) {
+  if (line.size() < 5 || line[4] != ' ') {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
@@ -123,62 +159,40 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
       return ParseResult::kError;                            \
     }                                                        \
   } while (false)
-  SET_FIELD(field[0], &mapping.readable, "r", "-");
-  SET_FIELD(field[1], &mapping.writable, "w", "-");
-  SET_FIELD(field[2], &mapping.executable, "x", "-");
-  SET_FIELD(field[3], &mapping.shareable, "sS", "p");
+  SET_FIELD(line[0], &mapping.readable, "r", "-");
+  SET_FIELD(line[1], &mapping.writable, "w", "-");
+  SET_FIELD(line[2], &mapping.executable, "x", "-");
+  SET_FIELD(line[3], &mapping.shareable, "sS", "p");
 #undef SET_FIELD
+  line.remove_prefix(5);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &mapping.offset))) {
+  if (!ConsumeNumber(&line, 16, ' ', 1, &mapping.offset)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
 
   uint32_t major;
-  if (maps_file_reader->GetDelim(':', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &major)) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-
   uint32_t minor;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &minor)) {
+  if (!ConsumeNumber(&line, 16, ':', 2, &major) ||
+      !ConsumeNumber(&line, 16, ' ', 2, &minor)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-
   mapping.device = makedev(major, minor);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !StringToNumber(field, &mapping.inode))) {
+  if (!ConsumeNumber(&line, 10, ' ', 1, &mapping.inode)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
 
-  if (maps_file_reader->GetDelim('\n', &field) !=
-      DelimitedFileReader::Result::kSuccess) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-  if (field.back() != '\n') {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-  field.pop_back();
+  // Drop the trailing newline.
+  line.remove_suffix(1);
 
   mappings->push_back(mapping);
 
-  size_t path_start = field.find_first_not_of(' ');
-  if (path_start != std::string::npos) {
-    mappings->back().name = field.substr(path_start);
+  size_t path_start = line.find_first_not_of(' ');
+  if (path_start != std::string_view::npos) {
+    mappings->back().name = std::string(line.substr(path_start));
   }
   return ParseResult::kSuccess;
 }
@@ -233,6 +247,16 @@ struct FastRange {
   VMSize size;
 };
 
+// Returns true if the PROCMAP_QUERY ioctl() can be used with maps_file.
+bool SupportsProcmapQuery(FileHandle maps_file) {
+  procmap_query query = {};
+  query.size = sizeof(query);
+  query.query_flags = PROCMAP_QUERY_COVERING_OR_NEXT_VMA;
+  query.query_addr = 0;
+  return HANDLE_EINTR(ioctl(maps_file, PROCMAP_QUERY, &query)) == 0 ||
+         errno == ENOENT;
+}
+
 }  // namespace
 
 MemoryMap::Mapping::Mapping()
@@ -246,7 +270,18 @@ MemoryMap::Mapping::Mapping()
       executable(false),
       shareable(false) {}
 
-MemoryMap::MemoryMap() : mappings_(), connection_(nullptr), initialized_() {}
+MemoryMap::MemoryMap()
+    : mappings_(),
+      mappings_read_(false),
+      queried_mappings_(),
+      file_mappings_(),
+      file_mappings_read_(false),
+      bounds_low_(1),
+      bounds_high_(0),
+      bounds_read_(false),
+      maps_file_(),
+      connection_(nullptr),
+      initialized_() {}
 
 MemoryMap::~MemoryMap() {}
 
@@ -264,11 +299,31 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   connection_ = connection;
 
+  // Looking mappings up as they’re needed avoids reading and parsing the
+  // entire maps file, which is slow for processes with many mappings, when
+  // only a few of them are needed.
+  maps_file_ = connection_->OpenMapsFile();
+  if (maps_file_.is_valid() && !SupportsProcmapQuery(maps_file_.get())) {
+    maps_file_.reset();
+  }
+
+  if (!maps_file_.is_valid()) {
+    if (!ReadMappings()) {
+      return false;
+    }
+    mappings_read_ = true;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool MemoryMap::ReadMappings() const {
   // If the maps file is not read atomically, entries can be read multiple times
   // or missed entirely. The kernel reads entries from this file into a page
   // sized buffer, so maps files larger than a page require multiple reads.
   // Attempt to reduce the time between reads by reading the entire file into a
-  // StringFile before attempting to parse it. If ParseMapsLine detects
+  // string before attempting to parse it. If ParseMapsLine detects
   // duplicate, overlapping, or out-of-order entries, it will trigger restarting
   // the read up to |attempts| times.
   int attempts = 3;
@@ -280,19 +335,20 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
       return false;
     }
 
-    StringFile maps_file;
-    maps_file.SetString(contents);
-    DelimitedFileReader maps_file_reader(&maps_file);
+    // Mappings from a previous attempt may have been read inconsistently.
+    mappings_.clear();
+    mappings_.reserve(std::count(contents.begin(), contents.end(), '\n'));
 
+    std::string_view unparsed(contents);
     ParseResult result;
-    while ((result = ParseMapsLine(&maps_file_reader, &mappings_)) ==
+    while ((result = ParseMapsLine(&unparsed, &mappings_)) ==
            ParseResult::kSuccess) {
     }
     if (result == ParseResult::kEndOfFile) {
-      INITIALIZATION_STATE_SET_VALID(initialized_);
       return true;
     }
     if (result == ParseResult::kError) {
+      mappings_.clear();
       return false;
     }
 
@@ -300,13 +356,106 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   } while (--attempts > 0);
 
   LOG(ERROR) << "retry count exceeded";
+  mappings_.clear();
   return false;
 }
 
+const std::vector<MemoryMap::Mapping>& MemoryMap::Mappings() const {
+  if (!mappings_read_) {
+    mappings_read_ = true;
+    ReadMappings();
+  }
+  return mappings_;
+}
+
+const std::vector<MemoryMap::Mapping>& MemoryMap::FileMappings() const {
+  DCHECK(maps_file_.is_valid());
+  if (!file_mappings_read_) {
+    file_mappings_read_ = true;
+    Mapping mapping;
+    LinuxVMAddress address = 0;
+    while (QueryMapping(address,
+                        /* covering_or_next= */ true,
+                        /* file_backed_only= */ true,
+                        &mapping)) {
+      address = mapping.range.End();
+      file_mappings_.push_back(std::move(mapping));
+    }
+  }
+  return file_mappings_;
+}
+
+bool MemoryMap::QueryMapping(LinuxVMAddress address,
+                             bool covering_or_next,
+                             bool file_backed_only,
+                             Mapping* mapping) const {
+  char name[PATH_MAX];
+  procmap_query query = {};
+  query.size = sizeof(query);
+  query.query_flags = (covering_or_next ? PROCMAP_QUERY_COVERING_OR_NEXT_VMA
+                                        : 0) |
+                      (file_backed_only ? PROCMAP_QUERY_FILE_BACKED_VMA : 0);
+  query.query_addr = address;
+  query.vma_name_addr = FromPointerCast<uint64_t>(name);
+  query.vma_name_size = sizeof(name);
+  if (HANDLE_EINTR(ioctl(maps_file_.get(), PROCMAP_QUERY, &query)) != 0) {
+    if (errno != ENOENT) {
+      PLOG(ERROR) << "ioctl";
+    }
+    return false;
+  }
+
+  // TODO(jperaza): set bitness properly
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool is_64_bit = true;
+#else
+  constexpr bool is_64_bit = false;
+#endif
+
+  mapping->range.SetRange(
+      is_64_bit, query.vma_start, query.vma_end - query.vma_start);
+  mapping->offset = query.vma_offset;
+  mapping->device = makedev(query.dev_major, query.dev_minor);
+  mapping->inode = query.inode;
+  mapping->readable = query.vma_flags & PROCMAP_QUERY_VMA_READABLE;
+  mapping->writable = query.vma_flags & PROCMAP_QUERY_VMA_WRITABLE;
+  mapping->executable = query.vma_flags & PROCMAP_QUERY_VMA_EXECUTABLE;
+  mapping->shareable = query.vma_flags & PROCMAP_QUERY_VMA_SHARED;
+
+  // vma_name_size includes the NUL terminator, and is 0 for unnamed mappings.
+  mapping->name.assign(name, query.vma_name_size ? query.vma_name_size - 1 : 0);
+  return true;
+}
+
+const MemoryMap::Mapping* MemoryMap::FindQueriedMapping(
+    LinuxVMAddress address) const {
+  auto iterator = queried_mappings_.upper_bound(address);
+  if (iterator != queried_mappings_.begin()) {
+    --iterator;
+    if (iterator->second.range.ContainsValue(address)) {
+      return &iterator->second;
+    }
+  }
+
+  Mapping mapping;
+  if (!QueryMapping(address,
+                    /* covering_or_next= */ false,
+                    /* file_backed_only= */ false,
+                    &mapping)) {
+    return nullptr;
+  }
+  LinuxVMAddress base = mapping.range.Base();
+  return &queried_mappings_.emplace(base, std::move(mapping)).first->second;
+}
+
 const MemoryMap::Mapping* MemoryMap::FindMapping(LinuxVMAddress address) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   address = connection_->Memory()->PointerToAddress(address);
 
+  if (maps_file_.is_valid()) {
+    return FindQueriedMapping(address);
+  }
+
   for (const auto& mapping : mappings_) {
     if (mapping.range.Base() <= address && mapping.range.End() > address) {
       return &mapping;
@@ -319,24 +468,97 @@ const MemoryMap::Mapping* MemoryMap::FindMappingWithName(
     const std::string& name) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  for (const auto& mapping : mappings_) {
+  for (const auto& mapping : Mappings()) {
     if (mapping.name == name) {
-      return &mapping;
+      return maps_file_.is_valid() ? FindQueriedMapping(mapping.range.Base())
+                                   : &mapping;
     }
   }
   return nullptr;
 }
 
+bool MemoryMap::GetAddressBounds(LinuxVMAddress* low,
+                                 LinuxVMAddress* high) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (!bounds_read_) {
+    bounds_read_ = true;
+    if (maps_file_.is_valid()) {
+      // Only the lowest mapping can be found directly. The end of the highest
+      // is found by searching for the highest address above which some
+      // mapping ends, invariantly keeping end at the end of a known mapping
+      // and no mapping ending above limit.
+      Mapping mapping;
+      if (QueryMapping(0,
+                       /* covering_or_next= */ true,
+                       /* file_backed_only= */ false,
+                       &mapping)) {
+        bounds_low_ = mapping.range.Base();
+        LinuxVMAddress end = mapping.range.End();
+        LinuxVMAddress limit = std::numeric_limits<LinuxVMAddress>::max();
+        while (end < limit) {
+          const LinuxVMAddress middle = end + (limit - end) / 2;
+          if (QueryMapping(middle,
+                           /* covering_or_next= */ true,
+                           /* file_backed_only= */ false,
+                           &mapping)) {
+            end = mapping.range.End();
+          } else {
+            limit = middle;
+          }
+        }
+        bounds_high_ = end;
+      }
+    } else {
+      for (const auto& mapping : mappings_) {
+        if (!mapping.readable) {
+          continue;
+        }
+        if (bounds_low_ > bounds_high_) {
+          bounds_low_ = mapping.range.Base();
+        }
+        bounds_high_ = mapping.range.End();
+      }
+    }
+  }
+
+  if (bounds_low_ > bounds_high_) {
+    return false;
+  }
+  *low = bounds_low_;
+  *high = bounds_high_;
+  return true;
+}
+
 std::vector<CheckedRange<VMAddress>> MemoryMap::GetReadableRanges(
     const CheckedRange<VMAddress, VMSize>& range) const {
   using Range = CheckedRange<VMAddress, VMSize>;
 
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
   VMAddress range_base = range.base();
   VMAddress range_end = range.end();
   std::vector<FastRange> overlapping;
 
+  // When mappings are queried, only those overlapping the target range are
+  // obtained.
+  std::vector<Mapping> queried;
+  if (maps_file_.is_valid()) {
+    Mapping mapping;
+    VMAddress address = range_base;
+    while (address < range_end &&
+           QueryMapping(address,
+                        /* covering_or_next= */ true,
+                        /* file_backed_only= */ false,
+                        &mapping) &&
+           mapping.range.Base() < range_end) {
+      address = mapping.range.End();
+      queried.push_back(std::move(mapping));
+    }
+  }
+
   // Find all readable ranges overlapping the target range, maintaining order.
-  for (const auto& mapping : mappings_) {
+  for (const auto& mapping : maps_file_.is_valid() ? queried : mappings_) {
     if (!mapping.readable)
       continue;
     if (mapping.range.End() < range_base)
@@ -387,17 +609,21 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
   // If the mapping is anonymous, as is for the VDSO, there is no mapped file to
   // find the start of, so just return the input mapping.
   if (mapping.device == 0 && mapping.inode == 0) {
-    for (const auto& candidate : mappings_) {
-      if (mapping.Equals(candidate)) {
-        possible_starts.push_back(&candidate);
-        return std::make_unique<SparseReverseIterator>(possible_starts);
-      }
+    const Mapping* candidate = FindMapping(mapping.range.Base());
+    if (candidate && mapping.Equals(*candidate)) {
+      possible_starts.push_back(candidate);
+      return std::make_unique<SparseReverseIterator>(possible_starts);
     }
 
     LOG(ERROR) << "mapping not found";
     return std::make_unique<SparseReverseIterator>();
   }
 
+  // Only file-backed mappings can be possible starts, so when mappings are
+  // queried, anonymous mappings needn’t be considered.
+  const std::vector<Mapping>& candidates =
+      maps_file_.is_valid() ? FileMappings() : mappings_;
+
 #if BUILDFLAG(IS_ANDROID)
   // The Android Chromium linker uses ashmem to share RELRO segments between
   // processes. The original RELRO segment has been unmapped and replaced with a
@@ -418,7 +644,7 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
 
     std::string libname =
         mapping.name.substr(strlen(kRelro), libname_end - strlen(kRelro));
-    for (const auto& candidate : mappings_) {
+    for (const auto& candidate : candidates) {
       if (candidate.name.rfind(libname) != std::string::npos) {
         possible_starts.push_back(&candidate);
       }
@@ -429,7 +655,7 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
   }
 #endif  // BUILDFLAG(IS_ANDROID)
 
-  for (const auto& candidate : mappings_) {
+  for (const auto& candidate : candidates) {
     if (candidate.device == mapping.device &&
         candidate.inode == mapping.inode
 #if !BUILDFLAG(IS_ANDROID)
@@ -451,13 +677,16 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
 
 std::unique_ptr<MemoryMap::Iterator> MemoryMap::ReverseIteratorFrom(
     const Mapping& target) const {
-  for (auto riter = mappings_.crbegin(); riter != mappings_.rend(); ++riter) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const std::vector<Mapping>& mappings = Mappings();
+  for (auto riter = mappings.crbegin(); riter != mappings.rend(); ++riter) {
     if (riter->Equals(target)) {
-      return std::make_unique<FullReverseIterator>(riter, mappings_.rend());
+      return std::make_unique<FullReverseIterator>(riter, mappings.rend());
     }
   }
-  return std::make_unique<FullReverseIterator>(mappings_.rend(),
-                                               mappings_.rend());
+  return std::make_unique<FullReverseIterator>(mappings.rend(),
+                                               mappings.rend());
 }
 
 }  // namespace crashpad
@@ -17,10 +17,12 @@
 
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "util/file/file_io.h"
 #include "util/linux/address_types.h"
 #include "util/linux/checked_linux_address_range.h"
 #include "util/linux/ptrace_connection.h"
@@ -34,6 +36,11 @@ namespace crashpad {
 //! target process is not stopped, mappings may be invalid after the return from
 //! Initialize(), and even mappings existing at the time Initialize() was called
 //! may not be found.
+//!
+//! Where the connection permits and the kernel supports the `PROCMAP_QUERY`
+//! `ioctl()`, mappings are looked up on demand. In that case, the full list of
+//! mappings is only read from `/proc/pid/maps` when a method that needs it is
+//! first called. Methods of this class must not be called concurrently.
 class MemoryMap {
  public:
   //! \brief Information about a mapped region of memory.
@@ -87,6 +94,15 @@ class MemoryMap {
   std::vector<CheckedRange<uint64_t>> GetReadableRanges(
       const CheckedRange<LinuxVMAddress, LinuxVMSize>& range) const;
 
+  //! \brief Returns bounds that enclose every readable mapping.
+  //!
+  //! The bounds may also enclose mappings that aren't readable.
+  //!
+  //! \param[out] low The lowest address in any readable mapping.
+  //! \param[out] high The end of the highest readable mapping.
+  //! \return `true` on success. `false` if there are no mappings.
+  bool GetAddressBounds(LinuxVMAddress* low, LinuxVMAddress* high) const;
+
   //! \brief An abstract base class for iterating over ordered sets of mappings
   //!   in a MemoryMap.
   class Iterator {
@@ -138,7 +154,48 @@ class MemoryMap {
   std::unique_ptr<Iterator> ReverseIteratorFrom(const Mapping& mapping) const;
 
  private:
-  std::vector<Mapping> mappings_;
+  //! \brief Reads and parses the maps file into #mappings_.
+  bool ReadMappings() const;
+
+  //! \brief Returns all of the mappings, reading them if necessary.
+  const std::vector<Mapping>& Mappings() const;
+
+  //! \brief Returns all of the file-backed mappings, querying them if
+  //!     necessary. Only valid when mappings are queried.
+  const std::vector<Mapping>& FileMappings() const;
+
+  //! \brief Queries the kernel for the mapping containing \a address, or if
+  //!     \a covering_or_next is `true`, the first mapping ending above it.
+  //!
+  //! \return `true` on success. `false` if there is no such mapping, or on
+  //!     failure with a message logged.
+  bool QueryMapping(LinuxVMAddress address,
+                    bool covering_or_next,
+                    bool file_backed_only,
+                    Mapping* mapping) const;
+
+  //! \brief Returns the mapping containing \a address from #queried_mappings_,
+  //!     querying it if it hasn’t been queried before.
+  const Mapping* FindQueriedMapping(LinuxVMAddress address) const;
+
+  // Populated on demand when mappings are queried, otherwise by Initialize().
+  mutable std::vector<Mapping> mappings_;
+  mutable bool mappings_read_;
+
+  // Used only when mappings are queried. Mappings in queried_mappings_ are
+  // keyed by base address and are what the methods returning a single Mapping
+  // return, so that the same mapping is always returned at the same address.
+  mutable std::map<LinuxVMAddress, Mapping> queried_mappings_;
+  mutable std::vector<Mapping> file_mappings_;
+  mutable bool file_mappings_read_;
+
+  // Computed on demand by GetAddressBounds(). bounds_low_ > bounds_high_ if
+  // there are no mappings.
+  mutable LinuxVMAddress bounds_low_;
+  mutable LinuxVMAddress bounds_high_;
+  mutable bool bounds_read_;
+  ScopedFileHandle maps_file_;
+
   PtraceConnection* connection_;
   InitializationStateDcheck initialized_;
 };
@@ -397,6 +397,133 @@ TEST(MemoryMap, MapRunningChild) {
   test.Run();
 }
 
+void ExpectMappingsEqual(const MemoryMap::Mapping* expected,
+                         const MemoryMap::Mapping* observed) {
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(observed);
+  EXPECT_TRUE(expected->Equals(*observed));
+  EXPECT_EQ(observed->name, expected->name);
+}
+
+void ExpectRangesEqual(const std::vector<CheckedRange<uint64_t>>& expected,
+                       const std::vector<CheckedRange<uint64_t>>& observed) {
+  ASSERT_EQ(observed.size(), expected.size());
+  for (size_t index = 0; index < expected.size(); ++index) {
+    EXPECT_EQ(observed[index].base(), expected[index].base());
+    EXPECT_EQ(observed[index].size(), expected[index].size());
+  }
+}
+
+// Compares a MemoryMap which may look mappings up as they’re needed against
+// one that reads the entire maps file when initialized.
+class QueriedMappingsChildTest : public Multiprocess {
+ public:
+  QueriedMappingsChildTest() : Multiprocess(), page_size_(getpagesize()) {}
+
+  QueriedMappingsChildTest(const QueriedMappingsChildTest&) = delete;
+  QueriedMappingsChildTest& operator=(const QueriedMappingsChildTest&) =
+      delete;
+
+  ~QueriedMappingsChildTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    LinuxVMAddress region_addr;
+    CheckedReadFileExactly(ReadPipeHandle(), &region_addr, sizeof(region_addr));
+    LinuxVMAddress code_address;
+    CheckedReadFileExactly(
+        ReadPipeHandle(), &code_address, sizeof(code_address));
+
+    DirectPtraceConnection direct_connection;
+    ASSERT_TRUE(direct_connection.Initialize(ChildPID()));
+    MemoryMap queried_map;
+    ASSERT_TRUE(queried_map.Initialize(&direct_connection));
+
+    FakePtraceConnection fake_connection;
+    ASSERT_TRUE(fake_connection.Initialize(ChildPID()));
+    MemoryMap read_map;
+    ASSERT_TRUE(read_map.Initialize(&fake_connection));
+
+    for (size_t index = 0; index < kNumMappings; ++index) {
+      SCOPED_TRACE(base::StringPrintf("index %zu", index));
+      LinuxVMAddress address = region_addr + index * page_size_;
+      ExpectMappingsEqual(read_map.FindMapping(address),
+                          queried_map.FindMapping(address));
+    }
+
+    CheckedRange<LinuxVMAddress, LinuxVMSize> region(
+        region_addr - page_size_, (kNumMappings + 2) * page_size_);
+    ExpectRangesEqual(read_map.GetReadableRanges(region),
+                      queried_map.GetReadableRanges(region));
+
+    const MemoryMap::Mapping* read_code = read_map.FindMapping(code_address);
+    const MemoryMap::Mapping* queried_code =
+        queried_map.FindMapping(code_address);
+    ASSERT_NO_FATAL_FAILURE(ExpectMappingsEqual(read_code, queried_code));
+    CheckedRange<LinuxVMAddress, LinuxVMSize> code_range(
+        read_code->range.Base(), read_code->range.Size());
+    ExpectRangesEqual(read_map.GetReadableRanges(code_range),
+                      queried_map.GetReadableRanges(code_range));
+
+    const MemoryMap::Mapping* named =
+        queried_map.FindMappingWithName(queried_code->name);
+    ASSERT_TRUE(named);
+    EXPECT_EQ(queried_map.FindMapping(named->range.Base()), named);
+
+    LinuxVMAddress read_low, read_high;
+    ASSERT_TRUE(read_map.GetAddressBounds(&read_low, &read_high));
+    LinuxVMAddress queried_low, queried_high;
+    ASSERT_TRUE(queried_map.GetAddressBounds(&queried_low, &queried_high));
+    EXPECT_LE(queried_low, read_low);
+    for (LinuxVMAddress address : {region_addr, code_address}) {
+      EXPECT_GE(address, read_low);
+      EXPECT_LT(address, read_high);
+      EXPECT_GE(address, queried_low);
+      EXPECT_LT(address, queried_high);
+    }
+
+    auto read_starts = read_map.FindFilePossibleMmapStarts(*read_code);
+    auto queried_starts = queried_map.FindFilePossibleMmapStarts(*queried_code);
+    ASSERT_EQ(queried_starts->Count(), read_starts->Count());
+    EXPECT_GT(queried_starts->Count(), 0u);
+    const MemoryMap::Mapping* read_start;
+    while ((read_start = read_starts->Next())) {
+      ExpectMappingsEqual(read_start, queried_starts->Next());
+    }
+  }
+
+  void MultiprocessChild() override {
+    ScopedMmap mappings;
+    ASSERT_NO_FATAL_FAILURE(
+        InitializeMappings(&mappings, kNumMappings, page_size_));
+
+    // Leave some holes in the readable ranges.
+    auto region_addr = mappings.addr_as<LinuxVMAddress>();
+    for (size_t index = 3; index < kNumMappings; index += 4) {
+      ASSERT_EQ(mprotect(reinterpret_cast<void*>(region_addr +
+                                                 index * page_size_),
+                         page_size_,
+                         PROT_NONE),
+                0)
+          << ErrnoMessage("mprotect");
+    }
+
+    CheckedWriteFile(WritePipeHandle(), &region_addr, sizeof(region_addr));
+    auto code_address = FromPointerCast<LinuxVMAddress>(getpid);
+    CheckedWriteFile(WritePipeHandle(), &code_address, sizeof(code_address));
+
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  static constexpr size_t kNumMappings = 32;
+  const size_t page_size_;
+};
+
+TEST(MemoryMap, QueriedMappingsChild) {
+  QueriedMappingsChildTest test;
+  test.Run();
+}
+
 // Expects first and third pages from mapping_start to refer to the same mapped
 // file. The second page should not.
 void ExpectFindFilePossibleMmapStarts(LinuxVMAddress mapping_start,
@@ -40,5 +40,19 @@ VMAddress StripPACBits(VMAddress address) {
     return address;
 }
 
+VMAddress PACAddressMask() {
+  static const VMAddress mask = [] {
+    // The number of bits holding the authentication code depends on the
+    // kernel's virtual address size and whether tagged addresses are in use,
+    // so it's measured by stripping an address with every bit but 55 set. The
+    // bits that are cleared are the ones holding the code. Without pointer
+    // authentication, nothing is stripped and the mask is all ones.
+    constexpr VMAddress kProbe = ~(VMAddress{1} << 55);
+    const VMAddress stripped = StripPACBits(kProbe);
+    return stripped == kProbe ? ~VMAddress{0} : stripped;
+  }();
+  return mask;
+}
+
 }  // namespace crashpad
 
@@ -0,0 +1,48 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/pac_helper.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(PACHelper, StripWithMaskMatchesStrip) {
+  const VMAddress mask = PACAddressMask();
+  constexpr VMAddress kAddresses[] = {
+      0,
+      0x1000,
+      0x0000007fffff1234,
+      0x0012007fffff1234,
+      0x8012007fffff1234,
+      0xff80ffffffff5678,
+      0xffffffffffffffff,
+      0x7f7fffffffffffff,
+  };
+  for (VMAddress address : kAddresses) {
+    SCOPED_TRACE(address);
+    EXPECT_EQ(StripPACBitsWithMask(address, mask), StripPACBits(address));
+  }
+
+  // Addresses without authentication codes are never changed.
+  EXPECT_EQ(StripPACBitsWithMask(0x0000007fffff1234, mask),
+            VMAddress{0x0000007fffff1234});
+  EXPECT_EQ(PACAddressMask(), mask);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -23,6 +23,7 @@
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "util/file/file_io.h"
+#include "util/linux/proc_task_reader.h"
 #include "util/misc/lexing.h"
 #include "util/misc/time.h"
 
@@ -50,10 +51,28 @@ bool ProcStatReader::Initialize(PtraceConnection* connection, pid_t tid) {
 
   char path[32];
   snprintf(path, std::size(path), "/proc/%d/stat", tid);
-  if (!connection->ReadFileContents(base::FilePath(path), &contents_)) {
+  if (!connection->ReadFileContents(base::FilePath(path), &contents_) ||
+      !FindThirdColumn()) {
     return false;
   }
 
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcStatReader::Initialize(FileHandle task_directory, pid_t tid) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!ReadTaskFile(task_directory, tid, "stat", &contents_) ||
+      !FindThirdColumn()) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcStatReader::FindThirdColumn() {
   // The first column is process ID and the second column is the executable name
   // in parentheses. This class only cares about columns after the second, so
   // find the start of the third here and save it for later.
@@ -71,8 +90,6 @@ bool ProcStatReader::Initialize(PtraceConnection* connection, pid_t tid) {
     LOG(ERROR) << "format error";
     return false;
   }
-
-  INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
@@ -21,6 +21,7 @@
 
 #include <string>
 
+#include "util/file/file_io.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/initialization_state_dcheck.h"
 
@@ -45,6 +46,19 @@ class ProcStatReader {
   //! \param[in] tid The thread ID to read the stat file for.
   bool Initialize(PtraceConnection* connection, pid_t tid);
 
+  //! \brief Initializes the reader, reading the stat file relative to an open
+  //!     task directory.
+  //!
+  //! This method must be successfully called before calling any other. It is
+  //! an alternative to the other Initialize() that avoids resolving the full
+  //! path to each thread’s stat file when reading many of them.
+  //!
+  //! \param[in] task_directory A handle to the task directory of the process
+  //!     to which the target thread belongs, as returned by
+  //!     OpenTaskDirectory().
+  //! \param[in] tid The thread ID to read the stat file for.
+  bool Initialize(FileHandle task_directory, pid_t tid);
+
   //! \brief Determines the time the thread has spent executing in user mode.
   //!
   //! \param[out] user_time The time spent executing in user mode.
@@ -71,6 +85,7 @@ class ProcStatReader {
   bool StartTime(const timeval& boot_time, timeval* start_time) const;
 
  private:
+  bool FindThirdColumn();
   bool FindColumn(int index, const char** column) const;
   bool ReadTimeAtIndex(int index, timeval* time_val) const;
 
@@ -14,19 +14,67 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <fcntl.h>
 #include <stdio.h>
 
+#include <string.h>
+
+#include <algorithm>
 #include <iterator>
+#include <map>
+#include <set>
 
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
 #include "util/misc/as_underlying_type.h"
 
 namespace crashpad {
 
+namespace {
+
+// Reads the parent process ID from a process’ stat file, opened relative to
+// proc_directory. Returns false without logging if the process has exited.
+bool ReadParentProcessID(int proc_directory, pid_t pid, pid_t* parent) {
+  char path[32];
+  snprintf(path, std::size(path), "%d/stat", pid);
+  ScopedFileHandle handle(HANDLE_EINTR(
+      openat(proc_directory, path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (!handle.is_valid()) {
+    return false;
+  }
+
+  // The parent is the fourth column, after the process ID, the executable
+  // name, which is at most 16 bytes, and the state. This is enough to hold
+  // them, and the file need not be read in full.
+  char contents[128];
+  const FileOperationResult size =
+      ReadFile(handle.get(), contents, sizeof(contents) - 1);
+  if (size <= 0) {
+    return false;
+  }
+  contents[size] = '\0';
+
+  // The executable name may itself contain parentheses, so its end is found
+  // from the last closing parenthesis.
+  const char* name_end = strrchr(contents, ')');
+  char state;
+  int parent_value;
+  if (!name_end ||
+      sscanf(name_end + 1, " %c %d", &state, &parent_value) != 2) {
+    LOG(ERROR) << "format error in /proc/" << pid << "/stat";
+    return false;
+  }
+  *parent = parent_value;
+  return true;
+}
+
+}  // namespace
+
 bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
   DCHECK(tids->empty());
 
@@ -39,9 +87,16 @@ bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
 
   std::vector<pid_t> local_tids;
   base::FilePath tid_str;
+  DirectoryReader::FileType type;
   DirectoryReader::Result result;
-  while ((result = reader.NextFile(&tid_str)) ==
+  while ((result = reader.NextFile(&tid_str, &type)) ==
          DirectoryReader::Result::kSuccess) {
+    // Every entry in the task directory is a directory. procfs reports the
+    // type in its entries, so checking it costs nothing.
+    if (type != DirectoryReader::FileType::kDirectory) {
+      continue;
+    }
+
     pid_t tid;
     if (!base::StringToInt(tid_str.value(), &tid)) {
       LOG(ERROR) << "format error";
@@ -58,4 +113,95 @@ bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
   return true;
 }
 
+ScopedFileHandle OpenTaskDirectory(pid_t pid) {
+  char path[32];
+  snprintf(path, std::size(path), "/proc/%d/task", pid);
+  ScopedFileHandle handle(
+      HANDLE_EINTR(open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  PLOG_IF(ERROR, !handle.is_valid()) << "open " << path;
+  return handle;
+}
+
+bool ReadTaskFile(FileHandle task_directory,
+                  pid_t tid,
+                  const char* name,
+                  std::string* contents) {
+  char path[64];
+  snprintf(path, std::size(path), "%d/%s", tid, name);
+  ScopedFileHandle handle(HANDLE_EINTR(
+      openat(task_directory, path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (!handle.is_valid()) {
+    PLOG(ERROR) << "openat " << path;
+    return false;
+  }
+
+  // Files in /proc report a size of 0, so read until EOF. The files read for
+  // threads are generally far smaller than this.
+  constexpr size_t kMinReadSize = 1024;
+  contents->resize(std::max(contents->capacity(), kMinReadSize));
+  size_t size = 0;
+  FileOperationResult rv;
+  do {
+    if (contents->size() - size < kMinReadSize) {
+      contents->resize(contents->size() * 2);
+    }
+    rv = ReadFile(handle.get(), &(*contents)[size], contents->size() - size);
+    if (rv > 0) {
+      size += rv;
+    }
+  } while (rv > 0);
+  if (rv < 0) {
+    PLOG(ERROR) << "read " << path;
+    contents->clear();
+    return false;
+  }
+  contents->resize(size);
+  return true;
+}
+
+bool ReadDescendantProcessIDs(pid_t pid, std::vector<pid_t>* descendants) {
+  DCHECK(descendants->empty());
+
+  DirectoryReader reader;
+  if (!reader.Open(base::FilePath("/proc"))) {
+    return false;
+  }
+
+  std::multimap<pid_t, pid_t> children;
+  base::FilePath entry;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&entry)) ==
+         DirectoryReader::Result::kSuccess) {
+    // Entries other than processes, such as "self" and "sys", aren’t numbers.
+    pid_t child;
+    pid_t parent;
+    if (base::StringToInt(entry.value(), &child) &&
+        ReadParentProcessID(reader.DirectoryFD(), child, &parent)) {
+      children.emplace(parent, child);
+    }
+  }
+  if (result != DirectoryReader::Result::kNoMoreFiles) {
+    return false;
+  }
+
+  // Visit the tree breadth first, so that each process follows its parent.
+  // The kernel doesn’t allow cycles, but a process ID reused while /proc was
+  // being read could appear to make one, so each process is visited once.
+  std::vector<pid_t> local_descendants;
+  std::set<pid_t> visited;
+  visited.insert(pid);
+  for (size_t index = 0; index <= local_descendants.size(); ++index) {
+    const pid_t parent = index == 0 ? pid : local_descendants[index - 1];
+    auto range = children.equal_range(parent);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (visited.insert(it->second).second) {
+        local_descendants.push_back(it->second);
+      }
+    }
+  }
+
+  descendants->swap(local_descendants);
+  return true;
+}
+
 }  // namespace crashpad
@@ -17,8 +17,11 @@
 
 #include <sys/types.h>
 
+#include <string>
 #include <vector>
 
+#include "util/file/file_io.h"
+
 namespace crashpad {
 
 //! \brief Enumerates the thread IDs of a process by reading
@@ -30,6 +33,46 @@ namespace crashpad {
 //!     are logged, but won't cause this function to return `false`.
 bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids);
 
+//! \brief Opens the <code>/proc/<i>pid</i>/task</code> directory of a process,
+//!     for use with ReadTaskFile().
+//!
+//! \param[in] pid The process ID of the process.
+//! \return A handle to the directory, or an invalid handle on failure with a
+//!     message logged.
+ScopedFileHandle OpenTaskDirectory(pid_t pid);
+
+//! \brief Reads a file from the <code>/proc/<i>pid</i>/task/<i>tid</i></code>
+//!     directory of a thread.
+//!
+//! The file is opened relative to \a task_directory, so the kernel doesn’t
+//! need to resolve the full path to it for each thread, and is read directly
+//! into \a contents, reusing any storage it has already allocated. This makes
+//! reading the same file for each of a process’ threads considerably cheaper
+//! than reading each with LoggingReadEntireFile().
+//!
+//! \param[in] task_directory A handle to the process’ task directory, as
+//!     returned by OpenTaskDirectory().
+//! \param[in] tid The thread ID of the thread.
+//! \param[in] name The name of the file in the thread’s directory, such as
+//!     `"stat"`.
+//! \param[out] contents The contents of the file.
+//! \return `true` on success. `false` on failure with a message logged.
+bool ReadTaskFile(FileHandle task_directory,
+                  pid_t tid,
+                  const char* name,
+                  std::string* contents);
+
+//! \brief Finds the descendants of a process by reading the `stat` file of
+//!     every process in `/proc`.
+//!
+//! \param[in] pid The process ID of the process.
+//! \param[out] descendants The process IDs of \a pid’s children, their
+//!     children, and so on. Each process appears after its parent. Processes
+//!     that exit while `/proc` is being read are silently left out.
+//! \return `true` if `/proc` could be read. `false` on failure with a message
+//!     logged.
+bool ReadDescendantProcessIDs(pid_t pid, std::vector<pid_t>* descendants);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_LINUX_PROC_TASK_READER_H_
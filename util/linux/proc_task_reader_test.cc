@@ -14,10 +14,20 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
+#include "test/multiprocess.h"
 #include "test/multiprocess_exec.h"
 #include "third_party/lss/lss.h"
+#include "util/file/file_io.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
 
@@ -82,6 +92,36 @@ TEST(ProcTaskReader, Self) {
   EXPECT_TRUE(FindThreadID(thread2_tid, tids));
 }
 
+TEST(ProcTaskReader, ReadTaskFile) {
+  ScopedBlockingThread thread;
+  thread.Start();
+  pid_t tid = thread.ThreadID();
+
+  ScopedFileHandle task_directory = OpenTaskDirectory(getpid());
+  ASSERT_TRUE(task_directory.is_valid());
+
+  std::string contents;
+  ASSERT_TRUE(ReadTaskFile(task_directory.get(), tid, "stat", &contents));
+  std::string expected;
+  ASSERT_TRUE(LoggingReadEntireFile(
+      base::FilePath(
+          base::StringPrintf("/proc/%d/task/%d/stat", getpid(), tid)),
+      &expected));
+  EXPECT_EQ(contents.substr(0, contents.find(' ')),
+            expected.substr(0, expected.find(' ')));
+  EXPECT_EQ(contents.substr(0, contents.find(' ')), std::to_string(tid));
+
+  // Reading into a string that already has contents replaces them.
+  ASSERT_TRUE(
+      ReadTaskFile(task_directory.get(), getpid(), "comm", &contents));
+  ASSERT_TRUE(LoggingReadEntireFile(
+      base::FilePath(base::StringPrintf("/proc/%d/comm", getpid())),
+      &expected));
+  EXPECT_EQ(contents, expected);
+
+  EXPECT_FALSE(ReadTaskFile(task_directory.get(), -1, "stat", &contents));
+}
+
 TEST(ProcTaskReader, BadPID) {
   std::vector<pid_t> tids;
   EXPECT_FALSE(ReadThreadIDs(-1, &tids));
@@ -156,6 +196,57 @@ TEST(ProcTaskReader, ReadChild) {
   test.Run();
 }
 
+class DescendantsTest : public Multiprocess {
+ public:
+  DescendantsTest() : Multiprocess() {}
+
+  DescendantsTest(const DescendantsTest&) = delete;
+  DescendantsTest& operator=(const DescendantsTest&) = delete;
+
+ private:
+  void MultiprocessParent() override {
+    pid_t grandchild;
+    ASSERT_TRUE(LoggingReadFileExactly(
+        ReadPipeHandle(), &grandchild, sizeof(grandchild)));
+
+    std::vector<pid_t> descendants;
+    ASSERT_TRUE(ReadDescendantProcessIDs(getpid(), &descendants));
+    auto child_it =
+        std::find(descendants.begin(), descendants.end(), ChildPID());
+    auto grandchild_it =
+        std::find(descendants.begin(), descendants.end(), grandchild);
+    ASSERT_NE(child_it, descendants.end());
+    ASSERT_NE(grandchild_it, descendants.end());
+    EXPECT_LT(child_it, grandchild_it);
+    EXPECT_EQ(std::find(descendants.begin(), descendants.end(), getpid()),
+              descendants.end());
+
+    descendants.clear();
+    ASSERT_TRUE(ReadDescendantProcessIDs(grandchild, &descendants));
+    EXPECT_TRUE(descendants.empty());
+  }
+
+  void MultiprocessChild() override {
+    pid_t grandchild = fork();
+    if (grandchild == 0) {
+      CheckedReadFileAtEOF(ReadPipeHandle());
+      _exit(0);
+    }
+    ASSERT_GT(grandchild, 0);
+    CheckedWriteFile(WritePipeHandle(), &grandchild, sizeof(grandchild));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+
+    int status;
+    ASSERT_EQ(HANDLE_EINTR(waitpid(grandchild, &status, 0)), grandchild);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+};
+
+TEST(ProcTaskReader, Descendants) {
+  DescendantsTest test;
+  test.Run();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
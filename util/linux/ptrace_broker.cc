@@ -16,6 +16,7 @@
 
 #include <fcntl.h>
 #include <limits.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <syscall.h>
@@ -107,6 +108,8 @@ PtraceBroker::PtraceBroker(int sock, pid_t pid, bool is_64_bit)
     : ptracer_(is_64_bit, /* can_log= */ false),
       file_root_(file_root_buffer_),
       memory_file_(),
+      buffer_(default_buffer_),
+      buffer_size_(sizeof(default_buffer_)),
       sock_(sock),
       memory_pid_(pid),
       tried_opening_mem_file_(false) {
@@ -133,6 +136,14 @@ void PtraceBroker::SetFileRoot(const char* new_root) {
   file_root_ = new_root;
 }
 
+void PtraceBroker::SetBuffer(char* buffer, size_t size) {
+  DCHECK(buffer);
+  DCHECK_GE(size, kDefaultBufferSize);
+  DCHECK_LE(size, size_t{INT32_MAX});
+  buffer_ = buffer;
+  buffer_size_ = size;
+}
+
 int PtraceBroker::Run() {
   AttachmentsArray attachments;
   attachments.Initialize();
@@ -183,9 +194,13 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
 
       case Request::kTypeGetThreadInfo: {
         GetThreadInfoResponse response;
-        response.success = ptracer_.GetThreadInfo(request.tid, &response.info)
-                               ? ExceptionHandlerProtocol::kBoolTrue
-                               : ExceptionHandlerProtocol::kBoolFalse;
+        response.success =
+            ptracer_.GetThreadInfo(request.tid,
+                                   &response.info,
+                                   request.thread_info.skip_floating_point !=
+                                       ExceptionHandlerProtocol::kBoolTrue)
+                ? ExceptionHandlerProtocol::kBoolTrue
+                : ExceptionHandlerProtocol::kBoolFalse;
 
         if (!WriteFile(sock_, &response, sizeof(response))) {
           return errno;
@@ -249,6 +264,14 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
         continue;
       }
 
+      case Request::kTypeReadMemoryBatch: {
+        int result = SendMemoryBatch(request.tid, request.ranges.count);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
       case Request::kTypeExit:
         return 0;
     }
@@ -275,10 +298,9 @@ int PtraceBroker::SendOpenResult(OpenResult result) {
 }
 
 int PtraceBroker::SendFileContents(FileHandle handle) {
-  char buffer[4096];
   int32_t rv;
   do {
-    rv = ReadFile(handle, buffer, sizeof(buffer));
+    rv = ReadFile(handle, buffer_, buffer_size_);
 
     if (rv < 0) {
       return SendReadError(static_cast<ReadError>(errno));
@@ -289,7 +311,7 @@ int PtraceBroker::SendFileContents(FileHandle handle) {
     }
 
     if (rv > 0) {
-      if (!WriteFile(sock_, buffer, static_cast<size_t>(rv))) {
+      if (!WriteFile(sock_, buffer_, static_cast<size_t>(rv))) {
         return errno;
       }
     }
@@ -333,11 +355,10 @@ int PtraceBroker::SendMemory(pid_t pid, VMAddress address, VMSize size) {
                : this->ptracer_.ReadUpTo(pid, address, size, buffer);
   };
 
-  char buffer[4096];
   while (size > 0) {
-    size_t to_read = std::min(size, VMSize{sizeof(buffer)});
+    size_t to_read = std::min(size, VMSize{buffer_size_});
 
-    int32_t bytes_read = read_memory(address, to_read, buffer);
+    int32_t bytes_read = read_memory(address, to_read, buffer_);
 
     if (bytes_read < 0) {
       return SendReadError(static_cast<ReadError>(errno));
@@ -351,7 +372,7 @@ int PtraceBroker::SendMemory(pid_t pid, VMAddress address, VMSize size) {
       return 0;
     }
 
-    if (!WriteFile(sock_, buffer, bytes_read)) {
+    if (!WriteFile(sock_, buffer_, bytes_read)) {
       return errno;
     }
 
@@ -361,15 +382,35 @@ int PtraceBroker::SendMemory(pid_t pid, VMAddress address, VMSize size) {
   return 0;
 }
 
+int PtraceBroker::SendMemoryBatch(pid_t pid, VMSize count) {
+  if (count > kMaxMemoryRanges) {
+    return EINVAL;
+  }
+
+  // Receive every range before responding so that a client that writes the
+  // whole request before reading can't deadlock against a full socket.
+  MemoryRange ranges[kMaxMemoryRanges];
+  if (!ReadFileExactly(sock_, ranges, sizeof(ranges[0]) * count)) {
+    return errno;
+  }
+
+  for (size_t index = 0; index < count; ++index) {
+    int result = SendMemory(pid, ranges[index].base, ranges[index].size);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 #if defined(MEMORY_SANITIZER)
-// MSan doesn't intercept syscall() and doesn't see that buffer is initialized.
+// MSan doesn't intercept syscall() and doesn't see that buffer_ is initialized.
 __attribute__((no_sanitize("memory")))
 #endif  // defined(MEMORY_SANITIZER)
 int PtraceBroker::SendDirectory(FileHandle handle) {
-  char buffer[4096];
   int rv;
   do {
-    rv = syscall(SYS_getdents64, handle, buffer, sizeof(buffer));
+    rv = syscall(SYS_getdents64, handle, buffer_, buffer_size_);
 
     if (rv < 0) {
       return SendReadError(static_cast<ReadError>(errno));
@@ -380,7 +421,7 @@ int PtraceBroker::SendDirectory(FileHandle handle) {
     }
 
     if (rv > 0) {
-      if (!WriteFile(sock_, buffer, static_cast<size_t>(rv))) {
+      if (!WriteFile(sock_, buffer_, static_cast<size_t>(rv))) {
         return errno;
       }
     }
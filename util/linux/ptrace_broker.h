@@ -54,9 +54,10 @@ class PtraceBroker {
       kTypeIs64Bit,
 
       //! \brief Responds with a GetThreadInfoResponse containing a ThreadInfo
-      //!     for the specified thread ID. If an error occurs,
-      //!     GetThreadInfoResponse::success is set to kBoolFalse and is
-      //!     followed by an Errno.
+      //!     for the specified thread ID, including its floating-point
+      //!     registers unless #thread_info.skip_floating_point is kBoolTrue. If
+      //!     an error occurs, GetThreadInfoResponse::success is set to
+      //!     kBoolFalse and is followed by an Errno.
       kTypeGetThreadInfo,
 
       //! \brief Reads memory from the attached process. The data is returned in
@@ -85,14 +86,28 @@ class PtraceBroker {
 
       //! \brief Causes the broker to return from Run(), detaching all attached
       //!     threads. Does not respond.
-      kTypeExit
+      kTypeExit,
+
+      //! \brief Reads several memory regions from the attached process. The
+      //!     request is followed by #ranges.count MemoryRange structures. For
+      //!     each range in order, the data is returned as for kTypeReadMemory:
+      //!     the response for a range ends once all of its bytes have been
+      //!     sent, after a message indicating end-of-file, or after an error.
+      kTypeReadMemoryBatch,
     } type;
 
     //! \brief The thread ID associated with this request. Valid for kTypeAttach,
-    //!     kTypeGetThreadInfo, and kTypeReadMemory.
+    //!     kTypeGetThreadInfo, kTypeReadMemory, and kTypeReadMemoryBatch.
     pid_t tid;
 
     union {
+      //! \brief Options for a kTypeGetThreadInfo request.
+      struct {
+        //! \brief kBoolTrue to leave out the thread’s floating-point and
+        //!     vector registers, which are then zeroed in the ThreadInfo.
+        ExceptionHandlerProtocol::Bool skip_floating_point;
+      } thread_info;
+
       //! \brief Specifies the memory region to read for a kTypeReadMemory
       //! request.
       struct {
@@ -112,9 +127,27 @@ class PtraceBroker {
         //! \brief The file path to read.
         char path[];
       } path;
+
+      //! \brief Specifies the number of memory regions to read for a
+      //!     kTypeReadMemoryBatch request.
+      struct {
+        //! \brief The number of MemoryRange structures following the request.
+        //!     Must not exceed kMaxMemoryRanges.
+        VMSize count;
+      } ranges;
     };
   };
 
+  //! \brief A memory region sent following a Request with type
+  //!     kTypeReadMemoryBatch.
+  struct MemoryRange {
+    //! \brief The base address of the memory region.
+    VMAddress base;
+
+    //! \brief The size of the memory region.
+    VMSize size;
+  };
+
   //! \brief A result used in operations that accept paths.
   //!
   //! Positive values of this enum are reserved for sending errno values.
@@ -148,6 +181,13 @@ class PtraceBroker {
   };
 #pragma pack(pop)
 
+  //! \brief The maximum number of ranges in a kTypeReadMemoryBatch request.
+  static constexpr size_t kMaxMemoryRanges = 256;
+
+  //! \brief The size of the buffer the broker stages data in if SetBuffer()
+  //!     isn't called.
+  static constexpr size_t kDefaultBufferSize = 4096;
+
   //! \brief Constructs this object.
   //!
   //! \param[in] sock A socket on which to read requests from a connected
@@ -182,6 +222,19 @@ class PtraceBroker {
   //!     broker.
   void SetFileRoot(const char* root);
 
+  //! \brief Stages the memory, files, and directories that the broker sends
+  //!     in \a buffer.
+  //!
+  //! If this method is not called, the broker stages data in a
+  //! kDefaultBufferSize buffer of its own. A larger buffer, preallocated
+  //! before a crash, lets the broker serve large reads in fewer system calls.
+  //!
+  //! \param[in] buffer The buffer to use. The caller must ensure that \a buffer
+  //!     remains valid for the lifetime of the broker.
+  //! \param[in] size The size of \a buffer, which must be at least
+  //!     kDefaultBufferSize and no larger than `INT32_MAX`.
+  void SetBuffer(char* buffer, size_t size);
+
   //! \brief Begin serving requests on the configured socket.
   //!
   //! This method returns when a PtraceBrokerRequest with type kTypeExit is
@@ -201,14 +254,18 @@ class PtraceBroker {
   int SendDirectory(FileHandle handle);
   void TryOpeningMemFile();
   int SendMemory(pid_t pid, VMAddress address, VMSize size);
+  int SendMemoryBatch(pid_t pid, VMSize count);
   int ReceiveAndOpenFilePath(VMSize path_length,
                              bool is_directory,
                              ScopedFileHandle* handle);
 
   char file_root_buffer_[32];
+  char default_buffer_[kDefaultBufferSize];
   Ptracer ptracer_;
   const char* file_root_;
   ScopedFileHandle memory_file_;
+  char* buffer_;
+  size_t buffer_size_;
   int sock_;
   pid_t memory_pid_;
   bool tried_opening_mem_file_;
@@ -17,9 +17,12 @@
 #include <sys/socket.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
@@ -136,6 +139,7 @@ class SameBitnessTest : public Multiprocess {
 
  private:
   void BrokerTests(bool set_broker_pid,
+                   size_t broker_buffer_size,
                    LinuxVMAddress child1_tls,
                    LinuxVMAddress child2_tls,
                    pid_t child2_tid,
@@ -155,6 +159,10 @@ class SameBitnessTest : public Multiprocess {
 
     PtraceBroker broker(
         broker_sock.get(), set_broker_pid ? ChildPID() : -1, am_64_bit);
+    std::vector<char> broker_buffer(broker_buffer_size);
+    if (broker_buffer_size > 0) {
+      broker.SetBuffer(broker_buffer.data(), broker_buffer.size());
+    }
     RunBrokerThread broker_thread(&broker);
     broker_thread.Start();
 
@@ -205,6 +213,35 @@ class SameBitnessTest : public Multiprocess {
                               &unmapped),
               -1);
 
+    std::vector<ProcessMemory::ReadRequest> requests;
+    std::vector<std::vector<char>> buffers(PtraceBroker::kMaxMemoryRanges + 1);
+    for (size_t index = 0; index < buffers.size(); ++index) {
+      const size_t offset = index % mapping_.len();
+      buffers[index].resize(std::min(index + 1, mapping_.len() - offset));
+      requests.push_back({mapping_.addr_as<VMAddress>() + offset,
+                          buffers[index].size(),
+                          buffers[index].data()});
+    }
+    ASSERT_TRUE(client.ReadMemoryBatch(requests));
+    for (size_t index = 0; index < buffers.size(); ++index) {
+      const size_t offset = index % mapping_.len();
+      EXPECT_EQ(memcmp(buffers[index].data(),
+                       expected_buffer + offset,
+                       buffers[index].size()),
+                0);
+    }
+
+    requests.push_back(
+        {mapping_.addr_as<VMAddress>() + mapping_.len(), 1, &unmapped});
+    requests.push_back({mapping_.addr_as<VMAddress>(), 1, &first});
+    EXPECT_FALSE(client.ReadMemoryBatch(requests));
+
+    // The connection must still be usable after a failed batch.
+    ASSERT_EQ(
+        client.ReadUpTo(mapping_.addr_as<VMAddress>(), sizeof(first), &first),
+        1);
+    EXPECT_EQ(first, expected_buffer[0]);
+
     std::string file_root = file_dir.value() + '/';
     broker.SetFileRoot(file_root.c_str());
 
@@ -249,6 +286,7 @@ class SameBitnessTest : public Multiprocess {
     }
 
     BrokerTests(true,
+                0,
                 child1_tls,
                 child2_tls,
                 child2_tid,
@@ -256,6 +294,25 @@ class SameBitnessTest : public Multiprocess {
                 file_path,
                 expected_file_contents);
     BrokerTests(false,
+                0,
+                child1_tls,
+                child2_tls,
+                child2_tid,
+                temp_dir.path(),
+                file_path,
+                expected_file_contents);
+
+    // Buffers larger than the default split reads differently.
+    BrokerTests(true,
+                6000,
+                child1_tls,
+                child2_tls,
+                child2_tid,
+                temp_dir.path(),
+                file_path,
+                expected_file_contents);
+    BrokerTests(true,
+                64 * 1024,
                 child1_tls,
                 child2_tls,
                 child2_tid,
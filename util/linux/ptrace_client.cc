@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <iterator>
 #include <string>
 
@@ -188,10 +189,24 @@ bool PtraceClient::Is64Bit() {
 
 bool PtraceClient::GetThreadInfo(pid_t tid, ThreadInfo* info) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return RequestThreadInfo(tid, true, info);
+}
+
+bool PtraceClient::GetThreadInfoWithoutFloatingPoint(pid_t tid,
+                                                     ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return RequestThreadInfo(tid, false, info);
+}
 
+bool PtraceClient::RequestThreadInfo(pid_t tid,
+                                     bool include_floating_point,
+                                     ThreadInfo* info) {
   PtraceBroker::Request request = {};
   request.type = PtraceBroker::Request::kTypeGetThreadInfo;
   request.tid = tid;
+  request.thread_info.skip_floating_point =
+      include_floating_point ? ExceptionHandlerProtocol::kBoolFalse
+                             : ExceptionHandlerProtocol::kBoolTrue;
   if (!LoggingWriteFile(sock_, &request, sizeof(request))) {
     return false;
   }
@@ -304,7 +319,6 @@ bool PtraceClient::Threads(std::vector<pid_t>* threads) {
 
 ssize_t PtraceClient::ReadUpTo(VMAddress address, size_t size, void* buffer) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  char* buffer_c = reinterpret_cast<char*>(buffer);
 
   PtraceBroker::Request request = {};
   request.type = PtraceBroker::Request::kTypeReadMemory;
@@ -316,37 +330,95 @@ ssize_t PtraceClient::ReadUpTo(VMAddress address, size_t size, void* buffer) {
     return false;
   }
 
+  ssize_t bytes_read;
+  if (!ReceiveMemory(size, reinterpret_cast<char*>(buffer), &bytes_read)) {
+    return -1;
+  }
+  return bytes_read;
+}
+
+bool PtraceClient::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRequest>& requests) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  bool success = true;
+  for (size_t start = 0; start < requests.size();
+       start += PtraceBroker::kMaxMemoryRanges) {
+    const size_t count = std::min(requests.size() - start,
+                                  PtraceBroker::kMaxMemoryRanges);
+
+    PtraceBroker::Request request = {};
+    request.type = PtraceBroker::Request::kTypeReadMemoryBatch;
+    request.tid = pid_;
+    request.ranges.count = count;
+
+    PtraceBroker::MemoryRange ranges[PtraceBroker::kMaxMemoryRanges];
+    for (size_t index = 0; index < count; ++index) {
+      ranges[index].base = requests[start + index].address;
+      ranges[index].size = requests[start + index].size;
+    }
+
+    if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+        !LoggingWriteFile(sock_, ranges, sizeof(ranges[0]) * count)) {
+      return false;
+    }
+
+    // The broker responds to every range, so keep receiving after a range
+    // fails to stay in sync with the stream.
+    for (size_t index = 0; index < count; ++index) {
+      const ProcessMemory::ReadRequest& read_request = requests[start + index];
+      const size_t size = static_cast<size_t>(read_request.size);
+      ssize_t bytes_read;
+      if (!ReceiveMemory(
+              size, static_cast<char*>(read_request.buffer), &bytes_read)) {
+        return false;
+      }
+      if (bytes_read < 0) {
+        success = false;
+      } else if (static_cast<size_t>(bytes_read) < size) {
+        LOG(ERROR) << "short read";
+        success = false;
+      }
+    }
+  }
+  return success;
+}
+
+bool PtraceClient::ReceiveMemory(size_t size,
+                                 char* buffer,
+                                 ssize_t* bytes_read) {
   ssize_t total_read = 0;
   while (size > 0) {
-    int32_t bytes_read;
-    if (!LoggingReadFileExactly(sock_, &bytes_read, sizeof(bytes_read))) {
-      return -1;
+    int32_t message_size;
+    if (!LoggingReadFileExactly(sock_, &message_size, sizeof(message_size))) {
+      return false;
     }
 
-    if (bytes_read < 0) {
-      ReceiveAndLogReadError(sock_, "PtraceBroker ReadMemory");
-      return -1;
+    if (message_size < 0) {
+      *bytes_read = -1;
+      return ReceiveAndLogReadError(sock_, "PtraceBroker ReadMemory");
     }
 
-    if (bytes_read == 0) {
-      return total_read;
+    if (message_size == 0) {
+      break;
     }
 
-    if (static_cast<size_t>(bytes_read) > size) {
-      LOG(ERROR) << "invalid size " << bytes_read;
-      return -1;
+    if (static_cast<size_t>(message_size) > size) {
+      LOG(ERROR) << "invalid size " << message_size;
+      return false;
     }
 
-    if (!LoggingReadFileExactly(sock_, buffer_c, bytes_read)) {
-      return -1;
+    if (!LoggingReadFileExactly(sock_, buffer, message_size)) {
+      return false;
     }
 
-    size -= bytes_read;
-    buffer_c += bytes_read;
-    total_read += bytes_read;
+    size -= message_size;
+    buffer += message_size;
+    total_read += message_size;
   }
 
-  return total_read;
+  *bytes_read = total_read;
+  return true;
 }
 
 bool PtraceClient::SendFilePath(const char* path, size_t length) {
@@ -58,14 +58,21 @@ class PtraceClient : public PtraceConnection {
   bool Attach(pid_t tid) override;
   bool Is64Bit() override;
   bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetThreadInfoWithoutFloatingPoint(pid_t tid, ThreadInfo* info) override;
   bool ReadFileContents(const base::FilePath& path,
                         std::string* contents) override;
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  bool ReadMemoryBatch(
+      const std::vector<ProcessMemory::ReadRequest>& requests) override;
 
  private:
+  bool RequestThreadInfo(pid_t tid,
+                         bool include_floating_point,
+                         ThreadInfo* info);
   bool SendFilePath(const char* path, size_t length);
+  bool ReceiveMemory(size_t size, char* buffer, ssize_t* bytes_read);
 
   std::unique_ptr<ProcessMemoryLinux> memory_;
   int sock_;
@@ -0,0 +1,88 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection.h"
+
+#include <string.h>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+bool PtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                     std::vector<pid_t>* attached) {
+  bool result = true;
+  for (pid_t tid : tids) {
+    if (Attach(tid)) {
+      attached->push_back(tid);
+    } else {
+      result = false;
+    }
+  }
+  return result;
+}
+
+bool PtraceConnection::GetThreadInfoWithoutFloatingPoint(pid_t tid,
+                                                         ThreadInfo* info) {
+  if (!GetThreadInfo(tid, info)) {
+    return false;
+  }
+  memset(&info->float_context, 0, sizeof(info->float_context));
+  return true;
+}
+
+void PtraceConnection::SetCapturedThreadInfo(pid_t tid,
+                                             const ThreadInfo& info) {
+  captured_threads_[tid] = info;
+}
+
+const ThreadInfo* PtraceConnection::CapturedThreadInfo(pid_t tid) const {
+  auto iterator = captured_threads_.find(tid);
+  return iterator != captured_threads_.end() ? &iterator->second : nullptr;
+}
+
+ScopedFileHandle PtraceConnection::OpenMapsFile() {
+  return ScopedFileHandle();
+}
+
+ScopedFileHandle PtraceConnection::OpenTaskDirectory() {
+  return ScopedFileHandle();
+}
+
+bool PtraceConnection::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRequest>& requests) {
+  for (const ProcessMemory::ReadRequest& request : requests) {
+    VMAddress address = request.address;
+    size_t size = static_cast<size_t>(request.size);
+    char* buffer = static_cast<char*>(request.buffer);
+    while (size > 0) {
+      ssize_t bytes_read = ReadUpTo(address, size, buffer);
+      if (bytes_read < 0) {
+        return false;
+      }
+      if (bytes_read == 0) {
+        LOG(ERROR) << "short read";
+        return false;
+      }
+      DCHECK_LE(static_cast<size_t>(bytes_read), size);
+      size -= bytes_read;
+      address += bytes_read;
+      buffer += bytes_read;
+    }
+  }
+  return true;
+}
+
+}  // namespace crashpad
@@ -17,10 +17,12 @@
 
 #include <sys/types.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "util/file/file_io.h"
 #include "util/linux/thread_info.h"
 #include "util/process/process_memory_linux.h"
 
@@ -41,6 +43,22 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool Attach(pid_t tid) = 0;
 
+  //! \brief Adds several new threads to this connection.
+  //!
+  //! The default implementation attaches to each thread with Attach().
+  //! Implementations able to request several attachments before waiting for
+  //! any of them to complete may override this, so that attaching to a process
+  //! with many threads doesn’t take a round trip through the scheduler for
+  //! each thread.
+  //!
+  //! \param[in] tids The thread IDs of the threads to attach.
+  //! \param[out] attached The thread IDs from \a tids that were successfully
+  //!     attached, in the same order.
+  //! \return `true` if every thread was attached. `false` on failure with a
+  //!     message logged for each thread that couldn’t be attached.
+  virtual bool AttachThreads(const std::vector<pid_t>& tids,
+                             std::vector<pid_t>* attached);
+
   //! \brief Returns `true` if connected to a 64-bit process.
   virtual bool Is64Bit() = 0;
 
@@ -51,6 +69,33 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool GetThreadInfo(pid_t tid, ThreadInfo* info) = 0;
 
+  //! \brief Retrieves a ThreadInfo for a target thread, leaving out its
+  //!     floating-point and vector registers.
+  //!
+  //! The ThreadInfo::float_context of \a info is zeroed. Implementations that
+  //! can avoid reading those registers at all should override the default,
+  //! which calls GetThreadInfo().
+  //!
+  //! \param[in] tid The thread ID of the target thread.
+  //! \param[out] info Information about the thread.
+  //! \return `true` on success. `false` on failure with a message logged.
+  virtual bool GetThreadInfoWithoutFloatingPoint(pid_t tid, ThreadInfo* info);
+
+  //! \brief Supplies the state of a thread as captured by the thread itself.
+  //!
+  //! Threads of a client that captured their own state in response to a
+  //! cooperative signal needn’t be attached to. Their state is more accurate
+  //! than GetThreadInfo() would report, because they’re blocked in a signal
+  //! handler until the client is resumed.
+  //!
+  //! \param[in] tid The thread ID of the thread.
+  //! \param[in] info The thread’s state.
+  void SetCapturedThreadInfo(pid_t tid, const ThreadInfo& info);
+
+  //! \brief Returns the state of a thread supplied with
+  //!     SetCapturedThreadInfo(), or `nullptr` if there is none.
+  const ThreadInfo* CapturedThreadInfo(pid_t tid) const;
+
   //! \brief Reads the entire contents of a file.
   //!
   //! \param[in] path The path of the file to read.
@@ -60,6 +105,28 @@ class PtraceConnection {
   virtual bool ReadFileContents(const base::FilePath& path,
                                 std::string* contents) = 0;
 
+  //! \brief Opens the connected process’ `/proc/pid/maps` file so that it can
+  //!     be queried with the `PROCMAP_QUERY` `ioctl()`.
+  //!
+  //! The default implementation returns an invalid handle. This is appropriate
+  //! for connections through which files can’t be opened directly, such as
+  //! those that forward requests to another process.
+  //!
+  //! \return A handle to the open file, or an invalid handle if the file can’t
+  //!     be opened. No message is logged.
+  virtual ScopedFileHandle OpenMapsFile();
+
+  //! \brief Opens the connected process’ `/proc/pid/task` directory so that
+  //!     files for each of its threads can be read with ReadTaskFile().
+  //!
+  //! The default implementation returns an invalid handle, for the same
+  //! reasons as OpenMapsFile(). Callers should read files with
+  //! ReadFileContents() in that case.
+  //!
+  //! \return A handle to the open directory, or an invalid handle if the
+  //!     directory can’t be opened.
+  virtual ScopedFileHandle OpenTaskDirectory();
+
   //! \brief Returns a memory reader for the connected process.
   //!
   //! The caller does not take ownership of the reader. The reader is valid for
@@ -87,6 +154,27 @@ class PtraceConnection {
   //! \return the number of bytes copied, 0 if there is no more data to read, or
   //!     -1 on failure with a message logged.
   virtual ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) = 0;
+
+  //! \brief Copies several memory regions from the connected process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! The default implementation reads each region with ReadUpTo().
+  //! Implementations for which each request is costly, such as those which
+  //! forward requests to another process, may override this to transfer all of
+  //! the regions at once.
+  //!
+  //! \param[in] requests The regions to copy. Each request must be completely
+  //!     read for this method to succeed. The sizes of the requests must be
+  //!     representable as a `size_t`.
+  //!
+  //! \return `true` on success, with every buffer filled. `false` on failure,
+  //!     with a message logged. The contents of the buffers are unspecified on
+  //!     failure.
+  virtual bool ReadMemoryBatch(
+      const std::vector<ProcessMemory::ReadRequest>& requests);
+
+ private:
+  std::map<pid_t, ThreadInfo> captured_threads_;
 };
 
 }  // namespace crashpad
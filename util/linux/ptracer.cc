@@ -522,12 +522,19 @@ bool Ptracer::Is64Bit() {
   return is_64_bit_;
 }
 
-bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+bool Ptracer::GetThreadInfo(pid_t tid,
+                            ThreadInfo* info,
+                            bool include_floating_point) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  if (!include_floating_point) {
+    memset(&info->float_context, 0, sizeof(info->float_context));
+  }
+
   if (is_64_bit_) {
     return GetGeneralPurposeRegisters64(tid, &info->thread_context, can_log_) &&
-           GetFloatingPointRegisters64(tid, &info->float_context, can_log_) &&
+           (!include_floating_point ||
+            GetFloatingPointRegisters64(tid, &info->float_context, can_log_)) &&
            GetThreadArea64(tid,
                            info->thread_context,
                            &info->thread_specific_data_address,
@@ -536,7 +543,8 @@ bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info) {
 
 #if !defined(ARCH_CPU_RISCV64)
   return GetGeneralPurposeRegisters32(tid, &info->thread_context, can_log_) &&
-         GetFloatingPointRegisters32(tid, &info->float_context, can_log_) &&
+         (!include_floating_point ||
+          GetFloatingPointRegisters32(tid, &info->float_context, can_log_)) &&
          GetThreadArea32(tid,
                          info->thread_context,
                          &info->thread_specific_data_address,
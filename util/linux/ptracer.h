@@ -69,9 +69,15 @@ class Ptracer {
   //!
   //! \param[in] tid The thread ID of the thread to collect information for.
   //! \param[out] info A ThreadInfo for the thread.
+  //! \param[in] include_floating_point Whether to read the thread’s
+  //!     floating-point and vector registers. If `false`, the
+  //!     ThreadInfo::float_context of \a info is zeroed instead, saving a
+  //!     system call.
   //! \return `true` on success. `false` on failure with a message logged, if
   //!     enabled.
-  bool GetThreadInfo(pid_t tid, ThreadInfo* info);
+  bool GetThreadInfo(pid_t tid,
+                     ThreadInfo* info,
+                     bool include_floating_point = true);
 
   //! \brief Uses `ptrace` to read memory from the process with process ID \a
   //!     pid, up to a maximum number of bytes.
@@ -14,6 +14,8 @@
 
 #include "util/linux/ptracer.h"
 
+#include <stddef.h>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/linux/get_tls.h"
@@ -61,6 +63,18 @@ class SameBitnessTest : public Multiprocess {
 #endif  // ARCH_CPU_X86_64
 
     EXPECT_EQ(thread_info.thread_specific_data_address, expected_tls);
+
+    // Reusing thread_info checks that the registers already read are cleared.
+    ASSERT_TRUE(ptracer.GetThreadInfo(ChildPID(),
+                                      &thread_info,
+                                      /* include_floating_point= */ false));
+    EXPECT_EQ(thread_info.thread_specific_data_address, expected_tls);
+    const char* float_context =
+        reinterpret_cast<const char*>(&thread_info.float_context);
+    for (size_t index = 0; index < sizeof(thread_info.float_context);
+         ++index) {
+      EXPECT_EQ(float_context[index], 0) << "index " << index;
+    }
   }
 
   void MultiprocessChild() override {
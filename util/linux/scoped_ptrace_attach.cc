@@ -14,9 +14,12 @@
 
 #include "util/linux/scoped_ptrace_attach.h"
 
+#include <errno.h>
 #include <sys/ptrace.h>
 #include <sys/wait.h>
 
+#include <map>
+
 #include "base/logging.h"
 #include "base/posix/eintr_wrapper.h"
 
@@ -40,6 +43,68 @@ bool PtraceAttach(pid_t pid, bool can_log) {
   return true;
 }
 
+bool PtraceAttachMultiple(const std::vector<pid_t>& pids,
+                          std::vector<bool>* attached,
+                          bool can_log) {
+  attached->assign(pids.size(), false);
+  bool result = true;
+
+  // Seizing a process and then interrupting it stops it without sending it a
+  // SIGSTOP, and every interruption is requested before waiting for any of the
+  // processes to stop. PTRACE_ATTACH is used for any process that can’t be
+  // seized because the kernel doesn’t support PTRACE_SEIZE.
+  std::map<pid_t, size_t> pending;
+  for (size_t index = 0; index < pids.size(); ++index) {
+    const pid_t pid = pids[index];
+    if (ptrace(PTRACE_SEIZE, pid, nullptr, nullptr) == 0) {
+      if (ptrace(PTRACE_INTERRUPT, pid, nullptr, nullptr) != 0) {
+        PLOG_IF(ERROR, can_log) << "ptrace";
+        result = false;
+        continue;
+      }
+    } else if (errno != EIO ||
+               ptrace(PTRACE_ATTACH, pid, nullptr, nullptr) != 0) {
+      PLOG_IF(ERROR, can_log) << "ptrace";
+      result = false;
+      continue;
+    }
+    pending.emplace(pid, index);
+  }
+
+  // Collect the stops in the order that they arrive. Each state change is only
+  // peeked at with WNOWAIT before it’s consumed, so that waiting doesn’t
+  // consume state changes of unrelated children. If an unrelated child’s state
+  // change is pending, wait for the remaining processes in order instead.
+  while (!pending.empty()) {
+    siginfo_t siginfo = {};
+    auto next = pending.begin();
+    if (HANDLE_EINTR(waitid(P_ALL,
+                            0,
+                            &siginfo,
+                            WEXITED | WSTOPPED | WNOWAIT | __WALL)) == 0) {
+      auto arrived = pending.find(siginfo.si_pid);
+      if (arrived != pending.end()) {
+        next = arrived;
+      }
+    }
+    const pid_t pid = next->first;
+    const size_t index = next->second;
+    pending.erase(next);
+
+    int status;
+    if (HANDLE_EINTR(waitpid(pid, &status, __WALL)) < 0) {
+      PLOG_IF(ERROR, can_log) << "waitpid";
+      result = false;
+    } else if (!WIFSTOPPED(status)) {
+      LOG_IF(ERROR, can_log) << "process not stopped";
+      result = false;
+    } else {
+      (*attached)[index] = true;
+    }
+  }
+  return result;
+}
+
 bool PtraceDetach(pid_t pid, bool can_log) {
   if (pid >= 0 && ptrace(PTRACE_DETACH, pid, nullptr, nullptr) != 0) {
     PLOG_IF(ERROR, can_log) << "ptrace";
@@ -74,4 +139,9 @@ bool ScopedPtraceAttach::ResetAttach(pid_t pid) {
   return true;
 }
 
+void ScopedPtraceAttach::ResetAttached(pid_t pid) {
+  Reset();
+  pid_ = pid;
+}
+
 }  // namespace crashpad
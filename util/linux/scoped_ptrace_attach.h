@@ -17,6 +17,7 @@
 
 #include <sys/types.h>
 
+#include <vector>
 
 namespace crashpad {
 
@@ -29,6 +30,28 @@ namespace crashpad {
 //!     can_log is `true`.
 bool PtraceAttach(pid_t pid, bool can_log = true);
 
+//! \brief Attaches to several processes and blocks until each of the target
+//!     processes successfully attached to has stopped.
+//!
+//! Each target process is attached to with `PTRACE_SEIZE` and stopped with
+//! `PTRACE_INTERRUPT`, falling back to `PTRACE_ATTACH` if the kernel doesn’t
+//! support `PTRACE_SEIZE`. Every stop is requested before waiting for any of
+//! the target processes, and stops are collected as they arrive, so that the
+//! targets stop concurrently. When attaching to many threads, this is much
+//! faster than calling PtraceAttach() for each of them.
+//!
+//! \param pids The process IDs of the processes to attach to.
+//! \param attached For each element of \a pids, whether it was attached to and
+//!     has stopped. The caller is responsible for detaching from each process
+//!     attached to.
+//! \param can_log Whether this function may log messages on failure.
+//! \return `true` if every process was attached to. `false` on failure with a
+//!     message logged for each process that couldn’t be attached to if \a
+//!     can_log is `true`.
+bool PtraceAttachMultiple(const std::vector<pid_t>& pids,
+                          std::vector<bool>* attached,
+                          bool can_log = true);
+
 //! \brief Detaches the process  with process ID \a pid. The process must
 //!     already be ptrace attached.
 //!
@@ -62,6 +85,11 @@ class ScopedPtraceAttach {
   //! \return `true` on success. `false` on failure, with a message logged.
   bool ResetAttach(pid_t pid);
 
+  //! \brief Detaches from any previously attached process and takes
+  //!     responsibility for detaching from the process with process ID \a pid,
+  //!     which must already be attached, as by PtraceAttachMultiple().
+  void ResetAttached(pid_t pid);
+
  private:
   pid_t pid_;
 };
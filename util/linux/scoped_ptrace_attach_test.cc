@@ -18,11 +18,16 @@
 #include <sys/ptrace.h>
 #include <unistd.h>
 
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/errors.h"
 #include "test/multiprocess.h"
 #include "util/file/file_io.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
+#include "util/synchronization/semaphore.h"
 
 namespace crashpad {
 namespace test {
@@ -181,6 +186,82 @@ TEST(ScopedPtraceAttach, AttachParentDestructor) {
   test.Run();
 }
 
+class AttachMultipleTest : public AttachTest {
+ public:
+  AttachMultipleTest() : AttachTest() {}
+
+  AttachMultipleTest(const AttachMultipleTest&) = delete;
+  AttachMultipleTest& operator=(const AttachMultipleTest&) = delete;
+
+  ~AttachMultipleTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    std::vector<pid_t> tids(kThreads + 1);
+    CheckedReadFileExactly(
+        ReadPipeHandle(), tids.data(), tids.size() * sizeof(pid_t));
+
+    // A process that doesn’t exist can’t be attached to, but doesn’t prevent
+    // attaching to the others.
+    tids.push_back(-1);
+
+    std::vector<bool> attached;
+    EXPECT_FALSE(PtraceAttachMultiple(tids, &attached));
+    ASSERT_EQ(attached.size(), tids.size());
+    EXPECT_FALSE(attached.back());
+
+    std::vector<ScopedPtraceAttach> attachments(kThreads + 1);
+    for (size_t index = 0; index < attachments.size(); ++index) {
+      ASSERT_TRUE(attached[index]);
+      EXPECT_EQ(ptrace(PTRACE_PEEKDATA, tids[index], &kWord, nullptr), kWord)
+          << ErrnoMessage("ptrace");
+      attachments[index].ResetAttached(tids[index]);
+    }
+
+    for (size_t index = 0; index < attachments.size(); ++index) {
+      ASSERT_TRUE(attachments[index].Reset());
+      ASSERT_EQ(ptrace(PTRACE_PEEKDATA, tids[index], &kWord, nullptr), -1);
+      EXPECT_EQ(errno, ESRCH) << ErrnoMessage("ptrace");
+    }
+  }
+
+  void MultiprocessChild() override {
+    ScopedPrSetPtracer set_ptracer(getppid(), /* may_log= */ true);
+
+    std::vector<pid_t> tids(1, getpid());
+    Semaphore started(0);
+    std::mutex tids_lock;
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < kThreads; ++index) {
+      threads.emplace_back([&started, &tids_lock, &tids]() {
+        {
+          std::lock_guard<std::mutex> lock(tids_lock);
+          tids.push_back(gettid());
+        }
+        started.Signal();
+        while (true) {
+          pause();
+        }
+      });
+      started.Wait();
+    }
+
+    CheckedWriteFile(
+        WritePipeHandle(), tids.data(), tids.size() * sizeof(pid_t));
+    CheckedReadFileAtEOF(ReadPipeHandle());
+    for (std::thread& thread : threads) {
+      thread.detach();
+    }
+  }
+
+  static constexpr size_t kThreads = 4;
+};
+
+TEST(ScopedPtraceAttach, AttachMultiple) {
+  AttachMultipleTest test;
+  test.Run();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -14,6 +14,9 @@
 
 #include "util/linux/socket.h"
 
+#include <errno.h>
+#include <string.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include "base/check_op.h"
@@ -51,6 +54,51 @@ bool UnixCredentialSocket::CreateCredentialSocketpair(ScopedFileHandle* sock1,
   return true;
 }
 
+// static
+ScopedFileHandle UnixCredentialSocket::CreateListeningSocket(
+    const base::FilePath& path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  const std::string& path_string = path.value();
+  if (path_string.empty() || path_string.size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "invalid socket path " << path_string;
+    return ScopedFileHandle();
+  }
+  memcpy(address.sun_path, path_string.c_str(), path_string.size() + 1);
+
+  ScopedFileHandle sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+  if (!sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return ScopedFileHandle();
+  }
+
+  int optval = 1;
+  if (setsockopt(
+          sock.get(), SOL_SOCKET, SO_PASSCRED, &optval, sizeof(optval)) != 0) {
+    PLOG(ERROR) << "setsockopt";
+    return ScopedFileHandle();
+  }
+
+  if (unlink(path_string.c_str()) != 0 && errno != ENOENT) {
+    PLOG(ERROR) << "unlink " << path_string;
+    return ScopedFileHandle();
+  }
+
+  if (bind(sock.get(),
+           reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0) {
+    PLOG(ERROR) << "bind " << path_string;
+    return ScopedFileHandle();
+  }
+
+  if (listen(sock.get(), SOMAXCONN) != 0) {
+    PLOG(ERROR) << "listen";
+    return ScopedFileHandle();
+  }
+
+  return sock;
+}
+
 // static
 int UnixCredentialSocket::SendMsg(int fd,
                                   const void* buf,
@@ -20,6 +20,7 @@
 
 #include <vector>
 
+#include "base/files/file_path.h"
 #include "util/file/file_io.h"
 
 namespace crashpad {
@@ -41,6 +42,18 @@ class UnixCredentialSocket {
   static bool CreateCredentialSocketpair(ScopedFileHandle* s1,
                                          ScopedFileHandle* s2);
 
+  //! \brief Creates an `AF_UNIX` family `SOCK_SEQPACKET` socket with
+  //!     `SO_PASSCRED` set, bound to \a path and listening for connections.
+  //!
+  //! Accepted connections inherit `SO_PASSCRED`, so a client's credentials
+  //! are available with the first message it sends. Any existing file at
+  //! \a path is replaced.
+  //!
+  //! \param[in] path The path to bind the socket to.
+  //! \return The listening socket on success. Otherwise, an invalid handle
+  //!     with a message logged.
+  static ScopedFileHandle CreateListeningSocket(const base::FilePath& path);
+
   //! \brief The maximum number of file descriptors that may be sent/received
   //!     with `SendMsg()` or `RecvMsg()`.
   static constexpr size_t kMaxSendRecvMsgFDs = 4;
@@ -16,6 +16,7 @@
 
 #include <errno.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/xattr.h>
 
@@ -27,6 +28,62 @@
 
 namespace crashpad {
 
+namespace {
+
+XattrStatus ParseXattrBool(const base::FilePath& file,
+                           const base::StringPiece& name,
+                           const std::string& tmp,
+                           bool* value) {
+  if (tmp == "1") {
+    *value = true;
+    return XattrStatus::kOK;
+  } else if (tmp == "0") {
+    *value = false;
+    return XattrStatus::kOK;
+  } else {
+    LOG(ERROR) << "ReadXattrBool " << name << " on file " << file.value()
+               << " could not be interpreted as boolean";
+    return XattrStatus::kOtherError;
+  }
+}
+
+XattrStatus ParseXattrInt(const base::FilePath& file,
+                          const base::StringPiece& name,
+                          const std::string& tmp,
+                          int* value) {
+  if (!base::StringToInt(tmp, value)) {
+    LOG(ERROR) << "ReadXattrInt " << name << " on file " << file.value()
+               << " could not be converted to an int";
+    return XattrStatus::kOtherError;
+  }
+  return XattrStatus::kOK;
+}
+
+XattrStatus ParseXattrTimeT(const base::FilePath& file,
+                            const base::StringPiece& name,
+                            const std::string& tmp,
+                            time_t* value) {
+  // time_t on macOS is defined as a long, but it will be read into an int64_t
+  // here, since there is no string conversion method for long.
+  int64_t encoded_value;
+  if (!base::StringToInt64(tmp, &encoded_value)) {
+    LOG(ERROR) << "ReadXattrTimeT " << name << " on file " << file.value()
+               << " could not be converted to an int";
+    return XattrStatus::kOtherError;
+  }
+
+  *value = base::saturated_cast<time_t>(encoded_value);
+  if (!base::IsValueInRangeForNumericType<time_t>(encoded_value)) {
+    LOG(ERROR) << "ReadXattrTimeT " << name << " on file " << file.value()
+               << " read over-sized value and will saturate";
+    return XattrStatus::kOtherError;
+  }
+
+  return XattrStatus::kOK;
+}
+
+}  // namespace
+
 XattrStatus ReadXattr(const base::FilePath& file,
                       const base::StringPiece& name,
                       std::string* value) {
@@ -73,17 +130,7 @@ XattrStatus ReadXattrBool(const base::FilePath& file,
   XattrStatus status;
   if ((status = ReadXattr(file, name, &tmp)) != XattrStatus::kOK)
     return status;
-  if (tmp == "1") {
-    *value = true;
-    return XattrStatus::kOK;
-  } else if (tmp == "0") {
-    *value = false;
-    return XattrStatus::kOK;
-  } else {
-    LOG(ERROR) << "ReadXattrBool " << name << " on file " << file.value()
-               << " could not be interpreted as boolean";
-    return XattrStatus::kOtherError;
-  }
+  return ParseXattrBool(file, name, tmp, value);
 }
 
 bool WriteXattrBool(const base::FilePath& file,
@@ -99,12 +146,7 @@ XattrStatus ReadXattrInt(const base::FilePath& file,
   XattrStatus status;
   if ((status = ReadXattr(file, name, &tmp)) != XattrStatus::kOK)
     return status;
-  if (!base::StringToInt(tmp, value)) {
-    LOG(ERROR) << "ReadXattrInt " << name << " on file " << file.value()
-               << " could not be converted to an int";
-    return XattrStatus::kOtherError;
-  }
-  return XattrStatus::kOK;
+  return ParseXattrInt(file, name, tmp, value);
 }
 
 bool WriteXattrInt(const base::FilePath& file,
@@ -117,28 +159,11 @@ bool WriteXattrInt(const base::FilePath& file,
 XattrStatus ReadXattrTimeT(const base::FilePath& file,
                            const base::StringPiece& name,
                            time_t* value) {
-  // time_t on macOS is defined as a long, but it will be read into an int64_t
-  // here, since there is no string conversion method for long.
   std::string tmp;
   XattrStatus status;
   if ((status = ReadXattr(file, name, &tmp)) != XattrStatus::kOK)
     return status;
-
-  int64_t encoded_value;
-  if (!base::StringToInt64(tmp, &encoded_value)) {
-    LOG(ERROR) << "ReadXattrTimeT " << name << " on file " << file.value()
-               << " could not be converted to an int";
-    return XattrStatus::kOtherError;
-  }
-
-  *value = base::saturated_cast<time_t>(encoded_value);
-  if (!base::IsValueInRangeForNumericType<time_t>(encoded_value)) {
-    LOG(ERROR) << "ReadXattrTimeT " << name << " on file " << file.value()
-               << " read over-sized value and will saturate";
-    return XattrStatus::kOtherError;
-  }
-
-  return XattrStatus::kOK;
+  return ParseXattrTimeT(file, name, tmp, value);
 }
 
 bool WriteXattrTimeT(const base::FilePath& file,
@@ -160,4 +185,115 @@ XattrStatus RemoveXattr(const base::FilePath& file,
   return XattrStatus::kOK;
 }
 
+XattrSet::XattrSet() : file_(), values_() {}
+
+XattrSet::~XattrSet() {}
+
+bool XattrSet::Read(int fd,
+                    const base::FilePath& file,
+                    const base::StringPiece& prefix) {
+  file_ = file;
+  values_.clear();
+
+  // The attribute list may grow between sizing and reading it if another
+  // process doesn't hold the lock, so retry a few times on ERANGE.
+  std::string names;
+  for (int attempt = 0;; ++attempt) {
+    ssize_t names_size = flistxattr(fd, nullptr, 0, 0);
+    if (names_size < 0) {
+      PLOG(ERROR) << "flistxattr size on file " << file.value();
+      return false;
+    }
+    names.resize(names_size);
+    if (names.empty())
+      return true;
+    names_size = flistxattr(fd, &names[0], names.size(), 0);
+    if (names_size >= 0) {
+      names.resize(names_size);
+      break;
+    }
+    if (errno != ERANGE || attempt == 2) {
+      PLOG(ERROR) << "flistxattr on file " << file.value();
+      return false;
+    }
+  }
+
+  // Database values are short, so try to read each with a single fgetxattr()
+  // into a fixed buffer, only sizing the value first if it doesn't fit.
+  char buffer[256];
+  for (size_t offset = 0; offset < names.size();) {
+    const char* name = &names[offset];
+    size_t name_length = strnlen(name, names.size() - offset);
+    offset += name_length + 1;
+    if (base::StringPiece(name, name_length).substr(0, prefix.size()) !=
+        prefix) {
+      continue;
+    }
+
+    ssize_t value_size = fgetxattr(fd, name, buffer, sizeof(buffer), 0, 0);
+    if (value_size >= 0) {
+      values_[name].assign(buffer, value_size);
+      continue;
+    }
+    if (errno == ENOATTR)
+      continue;
+    if (errno != ERANGE) {
+      PLOG(ERROR) << "fgetxattr " << name << " on file " << file.value();
+      return false;
+    }
+
+    value_size = fgetxattr(fd, name, nullptr, 0, 0, 0);
+    if (value_size < 0) {
+      PLOG(ERROR) << "fgetxattr size " << name << " on file " << file.value();
+      return false;
+    }
+    std::string& value = values_[name];
+    value.resize(value_size);
+    value_size = fgetxattr(fd, name, &value[0], value.size(), 0, 0);
+    if (value_size < 0) {
+      PLOG(ERROR) << "fgetxattr " << name << " on file " << file.value();
+      return false;
+    }
+    value.resize(value_size);
+  }
+
+  return true;
+}
+
+XattrStatus XattrSet::Get(const base::StringPiece& name,
+                          std::string* value) const {
+  auto it = values_.find(std::string(name));
+  if (it == values_.end())
+    return XattrStatus::kNoAttribute;
+  *value = it->second;
+  return XattrStatus::kOK;
+}
+
+XattrStatus XattrSet::GetBool(const base::StringPiece& name,
+                              bool* value) const {
+  std::string tmp;
+  XattrStatus status;
+  if ((status = Get(name, &tmp)) != XattrStatus::kOK)
+    return status;
+  return ParseXattrBool(file_, name, tmp, value);
+}
+
+XattrStatus XattrSet::GetInt(const base::StringPiece& name,
+                             int* value) const {
+  std::string tmp;
+  XattrStatus status;
+  if ((status = Get(name, &tmp)) != XattrStatus::kOK)
+    return status;
+  return ParseXattrInt(file_, name, tmp, value);
+}
+
+XattrStatus XattrSet::GetTimeT(const base::StringPiece& name,
+                               time_t* value) const {
+  std::string tmp;
+  XattrStatus status;
+  if ((status = Get(name, &tmp)) != XattrStatus::kOK)
+    return status;
+  return ParseXattrTimeT(file_, name, tmp, value);
+}
+
 }  // namespace crashpad
@@ -17,6 +17,7 @@
 
 #include <time.h>
 
+#include <map>
 #include <string>
 
 #include "base/files/file_path.h"
@@ -101,6 +102,54 @@ bool WriteXattrTimeT(const base::FilePath& file,
 XattrStatus RemoveXattr(const base::FilePath& file,
                         const base::StringPiece& name);
 
+//! \brief The extended attributes of an open file, read all at once.
+//!
+//! Each ReadXattr() call looks up the file's path twice. When several
+//! attributes of the same file are needed, this lists them with a single
+//! flistxattr() and reads each with usually one fgetxattr() on an already-open
+//! file descriptor.
+class XattrSet {
+ public:
+  XattrSet();
+
+  XattrSet(const XattrSet&) = delete;
+  XattrSet& operator=(const XattrSet&) = delete;
+
+  ~XattrSet();
+
+  //! \brief Reads the extended attributes of a file, replacing any previously
+  //!     read.
+  //!
+  //! \param[in] fd An open file descriptor for the file.
+  //! \param[in] file The path to the file, used in log messages.
+  //! \param[in] prefix Only attributes whose names begin with this prefix are
+  //!     read.
+  //!
+  //! \return `true` on success. `false` on error, with a message logged.
+  bool Read(int fd,
+            const base::FilePath& file,
+            const base::StringPiece& prefix);
+
+  //! \brief Returns the value of an attribute that was read.
+  //!
+  //! This and the other accessors behave as the corresponding ReadXattr*()
+  //! functions do, including in the errors that they log.
+  XattrStatus Get(const base::StringPiece& name, std::string* value) const;
+
+  //! \copydoc Get
+  XattrStatus GetBool(const base::StringPiece& name, bool* value) const;
+
+  //! \copydoc Get
+  XattrStatus GetInt(const base::StringPiece& name, int* value) const;
+
+  //! \copydoc Get
+  XattrStatus GetTimeT(const base::StringPiece& name, time_t* value) const;
+
+ private:
+  base::FilePath file_;
+  std::map<std::string, std::string> values_;
+};
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_MAC_XATTR_H_
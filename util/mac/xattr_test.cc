@@ -132,6 +132,49 @@ TEST_F(Xattr, RemoveAndRead) {
   EXPECT_EQ(RemoveXattr(path(), kKey), XattrStatus::kNoAttribute);
 }
 
+TEST_F(Xattr, ReadSet) {
+  const std::string long_value(533, 'A');
+  const time_t time_value = time(nullptr);
+  const std::string prefix = std::string(kKey) + ".";
+  EXPECT_TRUE(WriteXattr(path(), prefix + "string", "hello world"));
+  EXPECT_TRUE(WriteXattr(path(), prefix + "long", long_value));
+  EXPECT_TRUE(WriteXattrBool(path(), prefix + "bool", true));
+  EXPECT_TRUE(WriteXattrInt(path(), prefix + "int", 42));
+  EXPECT_TRUE(WriteXattrTimeT(path(), prefix + "time", time_value));
+  EXPECT_TRUE(WriteXattr(path(), "org.chromium.crashpad.other", "skipped"));
+
+  base::ScopedFD fd(HANDLE_EINTR(
+      open(path().value().c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  ASSERT_GE(fd.get(), 0) << ErrnoMessage("open");
+
+  XattrSet xattrs;
+  ASSERT_TRUE(xattrs.Read(fd.get(), path(), prefix));
+
+  std::string string_actual;
+  EXPECT_EQ(xattrs.Get(prefix + "string", &string_actual), XattrStatus::kOK);
+  EXPECT_EQ(string_actual, "hello world");
+  EXPECT_EQ(xattrs.Get(prefix + "long", &string_actual), XattrStatus::kOK);
+  EXPECT_EQ(string_actual, long_value);
+  EXPECT_EQ(xattrs.Get("org.chromium.crashpad.other", &string_actual),
+            XattrStatus::kNoAttribute);
+  EXPECT_EQ(xattrs.Get(prefix + "missing", &string_actual),
+            XattrStatus::kNoAttribute);
+
+  bool bool_actual = false;
+  EXPECT_EQ(xattrs.GetBool(prefix + "bool", &bool_actual), XattrStatus::kOK);
+  EXPECT_TRUE(bool_actual);
+  EXPECT_EQ(xattrs.GetBool(prefix + "string", &bool_actual),
+            XattrStatus::kOtherError);
+
+  int int_actual = 0;
+  EXPECT_EQ(xattrs.GetInt(prefix + "int", &int_actual), XattrStatus::kOK);
+  EXPECT_EQ(int_actual, 42);
+
+  time_t time_actual = 0;
+  EXPECT_EQ(xattrs.GetTimeT(prefix + "time", &time_actual), XattrStatus::kOK);
+  EXPECT_EQ(time_actual, time_value);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
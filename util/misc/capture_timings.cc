@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/capture_timings.h"
+
+#include "base/check_op.h"
+#include "base/notreached.h"
+#include "util/misc/clock.h"
+#include "util/misc/trace_events.h"
+
+namespace crashpad {
+
+CaptureTimings::ScopedPhase::ScopedPhase(CaptureTimings* timings, Phase phase)
+    : timings_(timings),
+      phase_(phase),
+      start_ns_(timings ? ClockMonotonicNanoseconds() : 0) {
+  TraceEvents::Begin("capture", PhaseName(phase_));
+}
+
+CaptureTimings::ScopedPhase::~ScopedPhase() {
+  if (timings_) {
+    timings_->AddDuration(phase_, ClockMonotonicNanoseconds() - start_ns_);
+  }
+  TraceEvents::End("capture", PhaseName(phase_));
+}
+
+CaptureTimings::CaptureTimings()
+    : durations_ns_(), recorded_(), remote_reads_() {}
+
+CaptureTimings::~CaptureTimings() = default;
+
+// static
+const char* CaptureTimings::PhaseName(Phase phase) {
+  switch (phase) {
+    case Phase::kSuspended:
+      return "Suspended";
+    case Phase::kThreadEnumeration:
+      return "ThreadEnumeration";
+    case Phase::kModuleParsing:
+      return "ModuleParsing";
+    case Phase::kMemoryCapture:
+      return "MemoryCapture";
+    case Phase::kMinidumpWrite:
+      return "MinidumpWrite";
+    case Phase::kDatabaseCommit:
+      return "DatabaseCommit";
+    case Phase::kMaxValue:
+      break;
+  }
+  NOTREACHED();
+}
+
+void CaptureTimings::AddDuration(Phase phase, uint64_t duration_ns) {
+  const size_t index = static_cast<size_t>(phase);
+  DCHECK_LT(index, kPhaseCount);
+  durations_ns_[index] += duration_ns;
+  recorded_[index] = true;
+}
+
+void CaptureTimings::Merge(const CaptureTimings& other) {
+  for (size_t index = 0; index < kPhaseCount; ++index) {
+    if (other.recorded_[index]) {
+      AddDuration(static_cast<Phase>(index), other.durations_ns_[index]);
+    }
+  }
+  for (size_t index = 0; index < kReadCategoryCount; ++index) {
+    if (other.remote_reads_[index].reads) {
+      remote_reads_[index] = other.remote_reads_[index];
+    }
+  }
+}
+
+bool CaptureTimings::HasDuration(Phase phase) const {
+  const size_t index = static_cast<size_t>(phase);
+  DCHECK_LT(index, kPhaseCount);
+  return recorded_[index];
+}
+
+uint64_t CaptureTimings::Duration(Phase phase) const {
+  const size_t index = static_cast<size_t>(phase);
+  DCHECK_LT(index, kPhaseCount);
+  return durations_ns_[index];
+}
+
+void CaptureTimings::SetRemoteReads(ReadCategory category,
+                                    const RemoteReads& reads) {
+  const size_t index = static_cast<size_t>(category);
+  DCHECK_LT(index, kReadCategoryCount);
+  remote_reads_[index] = reads;
+}
+
+const CaptureTimings::RemoteReads& CaptureTimings::GetRemoteReads(
+    ReadCategory category) const {
+  const size_t index = static_cast<size_t>(category);
+  DCHECK_LT(index, kReadCategoryCount);
+  return remote_reads_[index];
+}
+
+void CaptureTimings::ReportMetrics() const {
+  for (size_t index = 0; index < kPhaseCount; ++index) {
+    if (recorded_[index]) {
+      Metrics::CapturePhaseDuration(static_cast<Phase>(index),
+                                    durations_ns_[index]);
+    }
+  }
+  for (size_t index = 0; index < kReadCategoryCount; ++index) {
+    const RemoteReads& reads = remote_reads_[index];
+    if (reads.reads) {
+      Metrics::RemoteReads(static_cast<ReadCategory>(index),
+                           reads.reads,
+                           reads.bytes,
+                           reads.failures,
+                           reads.duration_ns);
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,127 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
+#define CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
+
+#include <stdint.h>
+
+#include <array>
+
+#include "util/misc/metrics.h"
+
+namespace crashpad {
+
+//! \brief Accumulates the time taken by each Metrics::CapturePhase of
+//!     capturing a report, and the reads from the client process’ memory made
+//!     in each Metrics::RemoteReadCategory.
+class CaptureTimings {
+ public:
+  using Phase = Metrics::CapturePhase;
+  using ReadCategory = Metrics::RemoteReadCategory;
+
+  //! \brief Counts of the reads from a client process’ memory made in one
+  //!     ReadCategory.
+  struct RemoteReads {
+    //! \brief The number of reads.
+    uint64_t reads;
+
+    //! \brief The number of bytes read successfully.
+    uint64_t bytes;
+
+    //! \brief The number of reads that failed.
+    uint64_t failures;
+
+    //! \brief The total time spent reading, in nanoseconds.
+    uint64_t duration_ns;
+  };
+
+  //! \brief Times a phase from construction to destruction, adding its
+  //!     duration to a CaptureTimings.
+  //!
+  //! The phase is also recorded as a trace event if TraceEvents are enabled.
+  class ScopedPhase {
+   public:
+    //! \param[in] timings The object to record the duration in. If `nullptr`,
+    //!     only the trace event is recorded.
+    //! \param[in] phase The phase being timed.
+    ScopedPhase(CaptureTimings* timings, Phase phase);
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    ~ScopedPhase();
+
+   private:
+    CaptureTimings* timings_;  // weak
+    Phase phase_;
+    uint64_t start_ns_;
+  };
+
+  CaptureTimings();
+
+  CaptureTimings(const CaptureTimings&) = default;
+  CaptureTimings& operator=(const CaptureTimings&) = default;
+
+  ~CaptureTimings();
+
+  //! \return The name of \a phase, such as `"ModuleParsing"`.
+  static const char* PhaseName(Phase phase);
+
+  //! \brief Adds \a duration_ns to the time recorded for \a phase.
+  //!
+  //! A phase may be recorded more than once, for example when it is entered
+  //! for each of several threads. Its durations are summed.
+  void AddDuration(Phase phase, uint64_t duration_ns);
+
+  //! \brief Adds every phase recorded in \a other to this object.
+  //!
+  //! Remote reads recorded in \a other replace those recorded in this object,
+  //! as with SetRemoteReads().
+  void Merge(const CaptureTimings& other);
+
+  //! \return `true` if a duration has been recorded for \a phase.
+  bool HasDuration(Phase phase) const;
+
+  //! \return The total duration recorded for \a phase, in nanoseconds, or `0`
+  //!     if none was recorded.
+  uint64_t Duration(Phase phase) const;
+
+  //! \brief Sets the reads made in \a category.
+  //!
+  //! Read counts are running totals, so this replaces any reads previously
+  //! recorded for \a category.
+  void SetRemoteReads(ReadCategory category, const RemoteReads& reads);
+
+  //! \return The reads recorded for \a category, all `0` if none were
+  //!     recorded.
+  const RemoteReads& GetRemoteReads(ReadCategory category) const;
+
+  //! \brief Reports each recorded phase to Metrics::CapturePhaseDuration(),
+  //!     and each category with reads to Metrics::RemoteReads().
+  void ReportMetrics() const;
+
+ private:
+  static constexpr size_t kPhaseCount = static_cast<size_t>(Phase::kMaxValue);
+  static constexpr size_t kReadCategoryCount =
+      static_cast<size_t>(ReadCategory::kMaxValue);
+
+  std::array<uint64_t, kPhaseCount> durations_ns_;
+  std::array<bool, kPhaseCount> recorded_;
+  std::array<RemoteReads, kReadCategoryCount> remote_reads_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
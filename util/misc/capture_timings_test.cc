@@ -0,0 +1,98 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/capture_timings.h"
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using Phase = CaptureTimings::Phase;
+using ReadCategory = CaptureTimings::ReadCategory;
+
+TEST(CaptureTimings, Empty) {
+  const CaptureTimings timings;
+  for (int32_t index = 0; index < static_cast<int32_t>(Phase::kMaxValue);
+       ++index) {
+    EXPECT_FALSE(timings.HasDuration(static_cast<Phase>(index)));
+    EXPECT_EQ(timings.Duration(static_cast<Phase>(index)), 0u);
+  }
+}
+
+TEST(CaptureTimings, AddAndMerge) {
+  CaptureTimings timings;
+  timings.AddDuration(Phase::kModuleParsing, 10);
+  timings.AddDuration(Phase::kModuleParsing, 5);
+  timings.AddDuration(Phase::kMinidumpWrite, 0);
+  EXPECT_TRUE(timings.HasDuration(Phase::kModuleParsing));
+  EXPECT_EQ(timings.Duration(Phase::kModuleParsing), 15u);
+  EXPECT_TRUE(timings.HasDuration(Phase::kMinidumpWrite));
+  EXPECT_EQ(timings.Duration(Phase::kMinidumpWrite), 0u);
+  EXPECT_FALSE(timings.HasDuration(Phase::kSuspended));
+
+  CaptureTimings other;
+  other.AddDuration(Phase::kModuleParsing, 1);
+  other.AddDuration(Phase::kSuspended, 100);
+  timings.Merge(other);
+  EXPECT_EQ(timings.Duration(Phase::kModuleParsing), 16u);
+  EXPECT_TRUE(timings.HasDuration(Phase::kSuspended));
+  EXPECT_EQ(timings.Duration(Phase::kSuspended), 100u);
+  EXPECT_FALSE(timings.HasDuration(Phase::kDatabaseCommit));
+
+  timings.ReportMetrics();
+}
+
+TEST(CaptureTimings, RemoteReads) {
+  CaptureTimings timings;
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).reads, 0u);
+
+  timings.SetRemoteReads(ReadCategory::kStack, {4, 4096, 1, 1000});
+  timings.SetRemoteReads(ReadCategory::kAnnotations, {2, 64, 0, 10});
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).reads, 4u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).bytes, 4096u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).failures, 1u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).duration_ns, 1000u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kModuleHeaders).reads, 0u);
+
+  // Reads in a merged object replace the existing totals.
+  CaptureTimings other;
+  other.SetRemoteReads(ReadCategory::kStack, {8, 8192, 1, 2000});
+  timings.Merge(other);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).reads, 8u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kStack).bytes, 8192u);
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kAnnotations).reads, 2u);
+
+  timings.ReportMetrics();
+}
+
+TEST(CaptureTimings, ScopedPhase) {
+  constexpr uint64_t kSleepNs = 1000000;
+  CaptureTimings timings;
+  {
+    CaptureTimings::ScopedPhase phase(&timings, Phase::kThreadEnumeration);
+    SleepNanoseconds(kSleepNs);
+  }
+  EXPECT_TRUE(timings.HasDuration(Phase::kThreadEnumeration));
+  EXPECT_GE(timings.Duration(Phase::kThreadEnumeration), kSleepNs);
+
+  { CaptureTimings::ScopedPhase phase(nullptr, Phase::kMemoryCapture); }
+  EXPECT_FALSE(timings.HasDuration(Phase::kMemoryCapture));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,50 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/deadline.h"
+
+#include <limits>
+
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+Deadline::Deadline() : deadline_ns_(0) {}
+
+// static
+Deadline Deadline::FromNow(uint64_t time_limit_ns) {
+  Deadline deadline;
+  if (time_limit_ns != 0) {
+    const uint64_t now_ns = ClockMonotonicNanoseconds();
+    deadline.deadline_ns_ =
+        time_limit_ns > std::numeric_limits<uint64_t>::max() - now_ns
+            ? std::numeric_limits<uint64_t>::max()
+            : now_ns + time_limit_ns;
+  }
+  return deadline;
+}
+
+bool Deadline::Expired() const {
+  return IsSet() && ClockMonotonicNanoseconds() >= deadline_ns_;
+}
+
+uint64_t Deadline::RemainingNanoseconds() const {
+  if (!IsSet()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const uint64_t now_ns = ClockMonotonicNanoseconds();
+  return now_ns >= deadline_ns_ ? 0 : deadline_ns_ - now_ns;
+}
+
+}  // namespace crashpad
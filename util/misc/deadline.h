@@ -0,0 +1,53 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_DEADLINE_H_
+#define CRASHPAD_UTIL_MISC_DEADLINE_H_
+
+#include <stdint.h>
+
+namespace crashpad {
+
+//! \brief A point in time, on the clock returned by
+//!     ClockMonotonicNanoseconds(), by which an operation should finish.
+//!
+//! A default-constructed Deadline never expires.
+class Deadline {
+ public:
+  Deadline();
+
+  //! \brief Returns a Deadline that expires \a time_limit_ns nanoseconds from
+  //!     now.
+  //!
+  //! \param[in] time_limit_ns The time limit, in nanoseconds. If `0`, the
+  //!     returned Deadline never expires.
+  static Deadline FromNow(uint64_t time_limit_ns);
+
+  //! \return `true` if this Deadline can expire.
+  bool IsSet() const { return deadline_ns_ != 0; }
+
+  //! \return `true` if this Deadline has passed.
+  bool Expired() const;
+
+  //! \return The number of nanoseconds until this Deadline expires, `0` if it
+  //!     has expired, or the largest `uint64_t` if it never expires.
+  uint64_t RemainingNanoseconds() const;
+
+ private:
+  uint64_t deadline_ns_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_DEADLINE_H_
@@ -0,0 +1,58 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/deadline.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(Deadline, Unset) {
+  const Deadline deadline;
+  EXPECT_FALSE(deadline.IsSet());
+  EXPECT_FALSE(deadline.Expired());
+  EXPECT_EQ(deadline.RemainingNanoseconds(),
+            std::numeric_limits<uint64_t>::max());
+
+  EXPECT_FALSE(Deadline::FromNow(0).IsSet());
+}
+
+TEST(Deadline, FromNow) {
+  constexpr uint64_t kTimeLimitNs = 60 * static_cast<uint64_t>(1E9);
+  const Deadline deadline = Deadline::FromNow(kTimeLimitNs);
+  EXPECT_TRUE(deadline.IsSet());
+  EXPECT_FALSE(deadline.Expired());
+  EXPECT_GT(deadline.RemainingNanoseconds(), 0u);
+  EXPECT_LE(deadline.RemainingNanoseconds(), kTimeLimitNs);
+
+  const Deadline far = Deadline::FromNow(std::numeric_limits<uint64_t>::max());
+  EXPECT_TRUE(far.IsSet());
+  EXPECT_FALSE(far.Expired());
+}
+
+TEST(Deadline, Expires) {
+  const Deadline deadline = Deadline::FromNow(1);
+  SleepNanoseconds(1000);
+  EXPECT_TRUE(deadline.Expired());
+  EXPECT_EQ(deadline.RemainingNanoseconds(), 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
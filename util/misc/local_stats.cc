@@ -0,0 +1,357 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/local_stats.h"
+
+#include <inttypes.h>
+
+#include <atomic>
+#include <iterator>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/process/process_id.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+
+#include "base/strings/utf_string_conversions.h"
+#elif BUILDFLAG(IS_FUCHSIA)
+#include <lib/zx/process.h>
+
+#include "util/fuchsia/koid_utilities.h"
+#else
+#include <unistd.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+constexpr char kCounterNames[][24] = {
+    "exceptions_encountered",
+    "captures_succeeded",
+    "captures_failed",
+    "uploads_succeeded",
+    "uploads_failed",
+    "uploads_skipped",
+};
+static_assert(std::size(kCounterNames) ==
+                  static_cast<size_t>(LocalStats::Counter::kMaxValue),
+              "counter names");
+
+constexpr char kLatencyNames[][32] = {
+    "capture_suspended",
+    "capture_thread_enumeration",
+    "capture_module_parsing",
+    "capture_memory_capture",
+    "capture_minidump_write",
+    "capture_database_commit",
+    "upload",
+    "prune",
+};
+static_assert(std::size(kLatencyNames) ==
+                  static_cast<size_t>(LocalStats::Latency::kMaxValue),
+              "latency names");
+
+constexpr char kGaugeNames[][24] = {
+    "exception_queue_depth",
+    "database_reports",
+    "database_bytes",
+    "pending_reports",
+};
+static_assert(std::size(kGaugeNames) ==
+                  static_cast<size_t>(LocalStats::Gauge::kMaxValue),
+              "gauge names");
+
+// Durations below kSubBuckets microseconds each have a bucket. Above that, each
+// power of two is split into kSubBuckets equal buckets, so a bucket is never
+// wider than 1 / kSubBuckets of its lower bound.
+constexpr int kSubBucketBits = 2;
+constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+constexpr size_t kLatencyBuckets =
+    kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+size_t BucketForMicroseconds(uint64_t us) {
+  if (us < kSubBuckets) {
+    return static_cast<size_t>(us);
+  }
+  int high_bit = 63;
+  while (!(us & (uint64_t{1} << high_bit))) {
+    --high_bit;
+  }
+  const int shift = high_bit - kSubBucketBits;
+  const uint64_t sub_bucket = (us >> shift) & (kSubBuckets - 1);
+  return static_cast<size_t>(kSubBuckets + shift * kSubBuckets + sub_bucket);
+}
+
+// The exclusive upper bound of a bucket, in microseconds.
+uint64_t BucketLimitMicroseconds(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket + 1;
+  }
+  const size_t shift = (bucket - kSubBuckets) / kSubBuckets;
+  const uint64_t sub_bucket = (bucket - kSubBuckets) % kSubBuckets;
+  const uint64_t limit = kSubBuckets + sub_bucket + 1;
+  return limit > (UINT64_MAX >> shift) ? UINT64_MAX : limit << shift;
+}
+
+struct LatencyHistogram {
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> sum_us;
+  std::atomic<uint64_t> max_us;
+  std::atomic<uint64_t> buckets[kLatencyBuckets];
+};
+
+// Gauges that haven’t been set hold this.
+constexpr uint64_t kGaugeUnset = UINT64_MAX;
+
+struct StatsState {
+  StatsState() { Reset(); }
+
+  void Reset() {
+    for (auto& counter : counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& latency : latencies) {
+      latency.count.store(0, std::memory_order_relaxed);
+      latency.sum_us.store(0, std::memory_order_relaxed);
+      latency.max_us.store(0, std::memory_order_relaxed);
+      for (auto& bucket : latency.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& gauge : gauges) {
+      gauge.store(kGaugeUnset, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64_t>
+      counters[static_cast<size_t>(LocalStats::Counter::kMaxValue)];
+  LatencyHistogram
+      latencies[static_cast<size_t>(LocalStats::Latency::kMaxValue)];
+  std::atomic<uint64_t>
+      gauges[static_cast<size_t>(LocalStats::Gauge::kMaxValue)];
+
+  // Guards path.
+  base::Lock lock;
+  base::FilePath path;
+};
+
+std::atomic<bool> g_enabled;
+
+StatsState* GetStatsState() {
+  // This is never destroyed, so that threads still recording at exit don’t use
+  // destroyed state.
+  static StatsState* stats_state = new StatsState();
+  return stats_state;
+}
+
+ProcessID GetSelfProcessID() {
+#if BUILDFLAG(IS_WIN)
+  return GetCurrentProcessId();
+#elif BUILDFLAG(IS_FUCHSIA)
+  return GetKoidForHandle(*zx::process::self());
+#else
+  return getpid();
+#endif
+}
+
+// Returns the smallest bucket limit below which at least fraction of the
+// histogram’s durations fall, in milliseconds. The maximum bounds this, so a
+// percentile is never reported above the longest duration seen.
+double HistogramPercentileMilliseconds(const LatencyHistogram& histogram,
+                                       uint64_t count,
+                                       double fraction) {
+  const uint64_t max_us = histogram.max_us.load(std::memory_order_relaxed);
+  const uint64_t target = static_cast<uint64_t>(count * fraction + 0.5);
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kLatencyBuckets; ++bucket) {
+    seen += histogram.buckets[bucket].load(std::memory_order_relaxed);
+    if (seen >= target && seen > 0) {
+      const uint64_t limit_us = BucketLimitMicroseconds(bucket);
+      return (limit_us < max_us ? limit_us : max_us) / 1e3;
+    }
+  }
+  return max_us / 1e3;
+}
+
+}  // namespace
+
+// static
+void LocalStats::Enable(const base::FilePath& path) {
+  StatsState* stats_state = GetStatsState();
+  {
+    base::AutoLock lock(stats_state->lock);
+    stats_state->path = path;
+  }
+  g_enabled.store(true, std::memory_order_release);
+}
+
+// static
+void LocalStats::EnableInDirectory(const base::FilePath& directory) {
+  const std::string name = base::StringPrintf(
+      "crashpad_stats_%" PRI_PROCESS_ID ".json", GetSelfProcessID());
+#if BUILDFLAG(IS_WIN)
+  Enable(directory.Append(base::UTF8ToWide(name)));
+#else
+  Enable(directory.Append(name));
+#endif
+}
+
+// static
+void LocalStats::Disable() {
+  g_enabled.store(false, std::memory_order_release);
+}
+
+// static
+bool LocalStats::IsEnabled() {
+  return g_enabled.load(std::memory_order_acquire);
+}
+
+// static
+void LocalStats::Increment(Counter counter) {
+  if (IsEnabled()) {
+    GetStatsState()
+        ->counters[static_cast<size_t>(counter)]
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// static
+void LocalStats::RecordLatency(Latency latency, uint64_t duration_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  const uint64_t duration_us = duration_ns / 1000;
+  LatencyHistogram& histogram =
+      GetStatsState()->latencies[static_cast<size_t>(latency)];
+  histogram.buckets[BucketForMicroseconds(duration_us)].fetch_add(
+      1, std::memory_order_relaxed);
+  histogram.sum_us.fetch_add(duration_us, std::memory_order_relaxed);
+  uint64_t max_us = histogram.max_us.load(std::memory_order_relaxed);
+  while (duration_us > max_us &&
+         !histogram.max_us.compare_exchange_weak(
+             max_us, duration_us, std::memory_order_relaxed)) {
+  }
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// static
+void LocalStats::SetGauge(Gauge gauge, uint64_t value) {
+  if (IsEnabled()) {
+    GetStatsState()
+        ->gauges[static_cast<size_t>(gauge)]
+        .store(value, std::memory_order_relaxed);
+  }
+}
+
+// static
+std::string LocalStats::ToJSON() {
+  StatsState* stats_state = GetStatsState();
+  std::string json = base::StringPrintf(
+      "{\n  \"pid\": %" PRI_PROCESS_ID ",\n  \"counters\": {",
+      GetSelfProcessID());
+
+  const char* separator = "\n";
+  for (size_t index = 0; index < std::size(kCounterNames); ++index) {
+    base::StringAppendF(
+        &json,
+        "%s    \"%s\": %" PRIu64,
+        separator,
+        kCounterNames[index],
+        stats_state->counters[index].load(std::memory_order_relaxed));
+    separator = ",\n";
+  }
+
+  json.append("\n  },\n  \"gauges\": {");
+  separator = "\n";
+  for (size_t index = 0; index < std::size(kGaugeNames); ++index) {
+    const uint64_t value =
+        stats_state->gauges[index].load(std::memory_order_relaxed);
+    if (value == kGaugeUnset) {
+      continue;
+    }
+    base::StringAppendF(&json,
+                        "%s    \"%s\": %" PRIu64,
+                        separator,
+                        kGaugeNames[index],
+                        value);
+    separator = ",\n";
+  }
+
+  json.append("\n  },\n  \"latencies_ms\": {");
+  separator = "\n";
+  for (size_t index = 0; index < std::size(kLatencyNames); ++index) {
+    const LatencyHistogram& histogram = stats_state->latencies[index];
+    const uint64_t count = histogram.count.load(std::memory_order_relaxed);
+    const uint64_t sum_us = histogram.sum_us.load(std::memory_order_relaxed);
+    base::StringAppendF(
+        &json,
+        "%s    \"%s\": {\"count\": %" PRIu64
+        ", \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, "
+        "\"max\": %.3f}",
+        separator,
+        kLatencyNames[index],
+        count,
+        count ? sum_us / 1e3 / count : 0.0,
+        count ? HistogramPercentileMilliseconds(histogram, count, 0.5) : 0.0,
+        count ? HistogramPercentileMilliseconds(histogram, count, 0.9) : 0.0,
+        count ? HistogramPercentileMilliseconds(histogram, count, 0.99) : 0.0,
+        histogram.max_us.load(std::memory_order_relaxed) / 1e3);
+    separator = ",\n";
+  }
+  json.append("\n  }\n}\n");
+  return json;
+}
+
+// static
+bool LocalStats::Write() {
+  if (!IsEnabled()) {
+    return false;
+  }
+
+  base::FilePath path;
+  {
+    StatsState* stats_state = GetStatsState();
+    base::AutoLock lock(stats_state->lock);
+    path = stats_state->path;
+  }
+
+  const std::string json = ToJSON();
+  const base::FilePath temp_path(path.value() + FILE_PATH_LITERAL(".tmp"));
+  {
+    ScopedFileHandle file(LoggingOpenFileForWrite(
+        temp_path,
+        FileWriteMode::kTruncateOrCreate,
+        FilePermissions::kOwnerOnly));
+    if (!file.is_valid() ||
+        !LoggingWriteFile(file.get(), json.data(), json.size())) {
+      return false;
+    }
+  }
+  return MoveFileOrDirectory(temp_path, path);
+}
+
+// static
+void LocalStats::ResetForTesting() {
+  GetStatsState()->Reset();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,169 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_LOCAL_STATS_H_
+#define CRASHPAD_UTIL_MISC_LOCAL_STATS_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+
+namespace crashpad {
+
+//! \brief Counts events and records latency histograms in the current process,
+//!     to be written to a local file as JSON.
+//!
+//! Metrics reports to UMA, which only records anything when Crashpad is built
+//! in Chromium. This keeps counts of the same events in the process, so that
+//! they can be inspected anywhere. Metrics forwards what it’s given here, so
+//! callers needn’t record to both.
+//!
+//! Recording is off until Enable() is called. While it is off, recording costs
+//! only an atomic load. While it is on, recording doesn’t take a lock, so it
+//! may be done from any thread.
+class LocalStats {
+ public:
+  //! \brief Events that are counted.
+  enum class Counter : int32_t {
+    //! \brief The handler started capturing an exception.
+    kExceptionsEncountered = 0,
+
+    //! \brief A capture finished with Metrics::CaptureResult::kSuccess.
+    kCapturesSucceeded,
+
+    //! \brief A capture finished with any other Metrics::CaptureResult.
+    kCapturesFailed,
+
+    //! \brief An upload attempt succeeded.
+    kUploadsSucceeded,
+
+    //! \brief An upload attempt failed.
+    kUploadsFailed,
+
+    //! \brief A report’s upload was skipped, for any
+    //!     Metrics::CrashSkippedReason.
+    kUploadsSkipped,
+
+    //! \brief The number of counters.
+    kMaxValue
+  };
+
+  //! \brief Operations whose durations are recorded in histograms.
+  //!
+  //! The capture phases have the values of the corresponding
+  //! Metrics::CapturePhase, so that one can be converted to the other.
+  enum class Latency : int32_t {
+    //! \brief Metrics::CapturePhase::kSuspended.
+    kCaptureSuspended = 0,
+
+    //! \brief Metrics::CapturePhase::kThreadEnumeration.
+    kCaptureThreadEnumeration = 1,
+
+    //! \brief Metrics::CapturePhase::kModuleParsing.
+    kCaptureModuleParsing = 2,
+
+    //! \brief Metrics::CapturePhase::kMemoryCapture.
+    kCaptureMemoryCapture = 3,
+
+    //! \brief Metrics::CapturePhase::kMinidumpWrite.
+    kCaptureMinidumpWrite = 4,
+
+    //! \brief Metrics::CapturePhase::kDatabaseCommit.
+    kCaptureDatabaseCommit = 5,
+
+    //! \brief Uploading a report, from preparing its body to receiving the
+    //!     server’s response.
+    kUpload,
+
+    //! \brief Cleaning and pruning a crash report database.
+    kPrune,
+
+    //! \brief The number of latencies.
+    kMaxValue
+  };
+
+  //! \brief Values that are sampled, rather than accumulated.
+  enum class Gauge : int32_t {
+    //! \brief The number of exceptions waiting to be handled, including the
+    //!     one most recently received.
+    kExceptionQueueDepth = 0,
+
+    //! \brief The number of reports in the crash report database.
+    kDatabaseReports,
+
+    //! \brief The total size of the reports in the crash report database, in
+    //!     bytes.
+    kDatabaseBytes,
+
+    //! \brief The number of reports pending upload.
+    kPendingReports,
+
+    //! \brief The number of gauges.
+    kMaxValue
+  };
+
+  LocalStats() = delete;
+  LocalStats(const LocalStats&) = delete;
+  LocalStats& operator=(const LocalStats&) = delete;
+
+  //! \brief Begins recording, to be written by Write() to \a path.
+  static void Enable(const base::FilePath& path);
+
+  //! \brief Begins recording, to be written by Write() to a file in
+  //!     \a directory named for the current process.
+  static void EnableInDirectory(const base::FilePath& directory);
+
+  //! \brief Stops recording. Values already recorded are kept.
+  static void Disable();
+
+  //! \return `true` if events are being recorded.
+  static bool IsEnabled();
+
+  //! \brief Adds one to \a counter.
+  static void Increment(Counter counter);
+
+  //! \brief Adds a duration to the histogram for \a latency.
+  //!
+  //! Durations are kept with microsecond resolution in buckets whose widths
+  //! are a quarter of a power of two, so percentiles computed from them are
+  //! within 25% of the true value.
+  static void RecordLatency(Latency latency, uint64_t duration_ns);
+
+  //! \brief Sets the most recent sample of \a gauge.
+  static void SetGauge(Gauge gauge, uint64_t value);
+
+  //! \brief Returns everything recorded so far as a JSON object.
+  //!
+  //! Each latency has its count, mean, 50th, 90th and 99th percentiles, and
+  //! maximum, in milliseconds. Gauges that haven’t been set are omitted.
+  static std::string ToJSON();
+
+  //! \brief Replaces the file given to Enable() with ToJSON().
+  //!
+  //! The file is written under a temporary name and moved into place, so that
+  //! readers never see a partial file.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged, or
+  //!     if recording isn’t enabled.
+  static bool Write();
+
+  //! \brief Discards everything recorded.
+  static void ResetForTesting();
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_LOCAL_STATS_H_
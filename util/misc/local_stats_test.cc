@@ -0,0 +1,144 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/local_stats.h"
+
+#include <stdlib.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerMillisecond = 1000000;
+
+// Returns the number following "\"key\": " inside the object named \a object,
+// or -1 if it isn’t found.
+double JSONValue(const std::string& json,
+                 const std::string& object,
+                 const std::string& key) {
+  size_t position = json.find("\"" + object + "\"");
+  if (position == std::string::npos) {
+    return -1;
+  }
+  const std::string needle = "\"" + key + "\": ";
+  position = json.find(needle, position);
+  if (position == std::string::npos) {
+    return -1;
+  }
+  return strtod(json.c_str() + position + needle.size(), nullptr);
+}
+
+class LocalStatsTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    LocalStats::ResetForTesting();
+    LocalStats::Enable(
+        temp_dir_.path().Append(FILE_PATH_LITERAL("stats.json")));
+  }
+
+  void TearDown() override {
+    LocalStats::Disable();
+    LocalStats::ResetForTesting();
+  }
+
+  const base::FilePath& temp_dir() const { return temp_dir_.path(); }
+
+ private:
+  ScopedTempDir temp_dir_;
+};
+
+TEST_F(LocalStatsTest, Disabled) {
+  LocalStats::Disable();
+  EXPECT_FALSE(LocalStats::IsEnabled());
+
+  // None of these should have any effect.
+  LocalStats::Increment(LocalStats::Counter::kCapturesSucceeded);
+  LocalStats::RecordLatency(LocalStats::Latency::kUpload,
+                            kNanosecondsPerMillisecond);
+  LocalStats::SetGauge(LocalStats::Gauge::kPendingReports, 3);
+  EXPECT_FALSE(LocalStats::Write());
+
+  const std::string json = LocalStats::ToJSON();
+  EXPECT_EQ(JSONValue(json, "counters", "captures_succeeded"), 0);
+  EXPECT_EQ(JSONValue(json, "upload", "count"), 0);
+  EXPECT_EQ(json.find("pending_reports"), std::string::npos);
+}
+
+TEST_F(LocalStatsTest, CountersAndGauges) {
+  EXPECT_TRUE(LocalStats::IsEnabled());
+
+  LocalStats::Increment(LocalStats::Counter::kExceptionsEncountered);
+  LocalStats::Increment(LocalStats::Counter::kExceptionsEncountered);
+  LocalStats::Increment(LocalStats::Counter::kUploadsFailed);
+  LocalStats::SetGauge(LocalStats::Gauge::kDatabaseReports, 7);
+  LocalStats::SetGauge(LocalStats::Gauge::kDatabaseReports, 5);
+
+  const std::string json = LocalStats::ToJSON();
+  EXPECT_EQ(JSONValue(json, "counters", "exceptions_encountered"), 2);
+  EXPECT_EQ(JSONValue(json, "counters", "uploads_failed"), 1);
+  EXPECT_EQ(JSONValue(json, "counters", "uploads_succeeded"), 0);
+  EXPECT_EQ(JSONValue(json, "gauges", "database_reports"), 5);
+
+  // Gauges that were never set are left out, rather than reported as 0.
+  EXPECT_EQ(json.find("database_bytes"), std::string::npos);
+}
+
+TEST_F(LocalStatsTest, Percentiles) {
+  for (uint64_t milliseconds = 1; milliseconds <= 100; ++milliseconds) {
+    LocalStats::RecordLatency(LocalStats::Latency::kPrune,
+                              milliseconds * kNanosecondsPerMillisecond);
+  }
+
+  const std::string json = LocalStats::ToJSON();
+  EXPECT_EQ(JSONValue(json, "prune", "count"), 100);
+  EXPECT_DOUBLE_EQ(JSONValue(json, "prune", "mean"), 50.5);
+  EXPECT_DOUBLE_EQ(JSONValue(json, "prune", "max"), 100);
+
+  // Percentiles come from buckets, so they’re only as precise as the buckets
+  // are narrow.
+  EXPECT_NEAR(JSONValue(json, "prune", "p50"), 50, 50 * 0.25);
+  EXPECT_NEAR(JSONValue(json, "prune", "p90"), 90, 90 * 0.25);
+  EXPECT_NEAR(JSONValue(json, "prune", "p99"), 99, 99 * 0.25);
+  EXPECT_LE(JSONValue(json, "prune", "p99"), 100);
+
+  EXPECT_EQ(JSONValue(json, "upload", "count"), 0);
+  EXPECT_EQ(JSONValue(json, "upload", "p50"), 0);
+}
+
+TEST_F(LocalStatsTest, Write) {
+  LocalStats::Increment(LocalStats::Counter::kUploadsSkipped);
+  ASSERT_TRUE(LocalStats::Write());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(
+      temp_dir().Append(FILE_PATH_LITERAL("stats.json")), &contents));
+  EXPECT_EQ(contents, LocalStats::ToJSON());
+
+  // A second write replaces the first.
+  LocalStats::Increment(LocalStats::Counter::kUploadsSkipped);
+  ASSERT_TRUE(LocalStats::Write());
+  ASSERT_TRUE(LoggingReadEntireFile(
+      temp_dir().Append(FILE_PATH_LITERAL("stats.json")), &contents));
+  EXPECT_EQ(JSONValue(contents, "counters", "uploads_skipped"), 2);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -18,6 +18,7 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "build/build_config.h"
+#include "util/misc/local_stats.h"
 
 #if BUILDFLAG(IS_APPLE)
 #define METRICS_OS_NAME "Mac"
@@ -76,6 +77,19 @@ void Metrics::CrashReportSize(FileOffset size) {
 // static
 void Metrics::CrashUploadAttempted(bool successful) {
   UMA_HISTOGRAM_BOOLEAN("Crashpad.CrashUpload.AttemptSuccessful", successful);
+  LocalStats::Increment(successful ? LocalStats::Counter::kUploadsSucceeded
+                                   : LocalStats::Counter::kUploadsFailed);
+}
+
+// static
+void Metrics::CrashUploadDuration(uint64_t duration_ns) {
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Crashpad.CrashUpload.Duration",
+      base::saturated_cast<int>(duration_ns / 1000000),
+      1,
+      10 * 60 * 1000,
+      50);
+  LocalStats::RecordLatency(LocalStats::Latency::kUpload, duration_ns);
 }
 
 #if BUILDFLAG(IS_APPLE)
@@ -89,6 +103,7 @@ void Metrics::CrashUploadErrorCode(int error_code) {
 void Metrics::CrashUploadSkipped(CrashSkippedReason reason) {
   UMA_HISTOGRAM_ENUMERATION(
       "Crashpad.CrashUpload.Skipped", reason, CrashSkippedReason::kMaxValue);
+  LocalStats::Increment(LocalStats::Counter::kUploadsSkipped);
 }
 
 // static
@@ -96,6 +111,9 @@ void Metrics::ExceptionCaptureResult(CaptureResult result) {
   ExceptionProcessing(ExceptionProcessingState::kFinished);
   UMA_HISTOGRAM_ENUMERATION(
       "Crashpad.ExceptionCaptureResult", result, CaptureResult::kMaxValue);
+  LocalStats::Increment(result == CaptureResult::kSuccess
+                            ? LocalStats::Counter::kCapturesSucceeded
+                            : LocalStats::Counter::kCapturesFailed);
 }
 
 // static
@@ -107,6 +125,119 @@ void Metrics::ExceptionCode(uint32_t exception_code) {
 // static
 void Metrics::ExceptionEncountered() {
   ExceptionProcessing(ExceptionProcessingState::kStarted);
+  LocalStats::Increment(LocalStats::Counter::kExceptionsEncountered);
+}
+
+// static
+void Metrics::ExceptionQueueDepth(size_t depth) {
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.ExceptionQueueDepth",
+                              base::saturated_cast<int>(depth),
+                              1,
+                              100,
+                              50);
+  LocalStats::SetGauge(LocalStats::Gauge::kExceptionQueueDepth, depth);
+}
+
+// static
+void Metrics::CapturePhaseDuration(CapturePhase phase, uint64_t duration_ns) {
+  // Histogram names must be compile-time constants, so each phase has its own
+  // call site.
+#define CAPTURE_PHASE_HISTOGRAM(name)                                \
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.CapturePhaseDuration." name, \
+                              base::saturated_cast<int>(             \
+                                  duration_ns / 1000000),            \
+                              1,                                     \
+                              60 * 1000,                             \
+                              50)
+
+  switch (phase) {
+    case CapturePhase::kSuspended:
+      CAPTURE_PHASE_HISTOGRAM("Suspended");
+      break;
+    case CapturePhase::kThreadEnumeration:
+      CAPTURE_PHASE_HISTOGRAM("ThreadEnumeration");
+      break;
+    case CapturePhase::kModuleParsing:
+      CAPTURE_PHASE_HISTOGRAM("ModuleParsing");
+      break;
+    case CapturePhase::kMemoryCapture:
+      CAPTURE_PHASE_HISTOGRAM("MemoryCapture");
+      break;
+    case CapturePhase::kMinidumpWrite:
+      CAPTURE_PHASE_HISTOGRAM("MinidumpWrite");
+      break;
+    case CapturePhase::kDatabaseCommit:
+      CAPTURE_PHASE_HISTOGRAM("DatabaseCommit");
+      break;
+    case CapturePhase::kMaxValue:
+      break;
+  }
+
+#undef CAPTURE_PHASE_HISTOGRAM
+
+  static_assert(static_cast<int32_t>(CapturePhase::kMaxValue) ==
+                    static_cast<int32_t>(LocalStats::Latency::kUpload),
+                "each capture phase must have a latency");
+  if (phase != CapturePhase::kMaxValue) {
+    LocalStats::RecordLatency(static_cast<LocalStats::Latency>(phase),
+                              duration_ns);
+  }
+}
+
+// static
+void Metrics::RemoteReads(RemoteReadCategory category,
+                          uint64_t reads,
+                          uint64_t bytes,
+                          uint64_t failures,
+                          uint64_t duration_ns) {
+  // Histogram names must be compile-time constants, so each category has its
+  // own call site.
+#define REMOTE_READ_HISTOGRAMS(name)                                      \
+  do {                                                                    \
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.RemoteReads.Count." name,       \
+                                base::saturated_cast<int>(reads),         \
+                                1,                                        \
+                                1000 * 1000,                              \
+                                50);                                      \
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.RemoteReads.KB." name,          \
+                                base::saturated_cast<int>(bytes / 1024),  \
+                                1,                                        \
+                                1000 * 1000,                              \
+                                50);                                      \
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.RemoteReads.Failures." name,    \
+                                base::saturated_cast<int>(failures),      \
+                                1,                                        \
+                                10 * 1000,                                \
+                                50);                                      \
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.RemoteReads.Duration." name,    \
+                                base::saturated_cast<int>(duration_ns /   \
+                                                          1000000),       \
+                                1,                                        \
+                                60 * 1000,                                \
+                                50);                                      \
+  } while (false)
+
+  switch (category) {
+    case RemoteReadCategory::kOther:
+      REMOTE_READ_HISTOGRAMS("Other");
+      break;
+    case RemoteReadCategory::kStack:
+      REMOTE_READ_HISTOGRAMS("Stack");
+      break;
+    case RemoteReadCategory::kModuleHeaders:
+      REMOTE_READ_HISTOGRAMS("ModuleHeaders");
+      break;
+    case RemoteReadCategory::kAnnotations:
+      REMOTE_READ_HISTOGRAMS("Annotations");
+      break;
+    case RemoteReadCategory::kIndirectMemory:
+      REMOTE_READ_HISTOGRAMS("IndirectMemory");
+      break;
+    case RemoteReadCategory::kMaxValue:
+      break;
+  }
+
+#undef REMOTE_READ_HISTOGRAMS
 }
 
 // static
@@ -122,6 +253,17 @@ void Metrics::HandlerCrashed(uint32_t exception_code) {
       "Crashpad.HandlerCrash.ExceptionCode." METRICS_OS_NAME, exception_code);
 }
 
+// static
+void Metrics::DatabasePruneDuration(uint64_t duration_ns) {
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Crashpad.DatabasePrune.Duration",
+      base::saturated_cast<int>(duration_ns / 1000000),
+      1,
+      10 * 60 * 1000,
+      50);
+  LocalStats::RecordLatency(LocalStats::Latency::kPrune, duration_ns);
+}
+
 #if BUILDFLAG(IS_IOS)
 // static
 void Metrics::MissingIntermediateDumpKey(
@@ -16,6 +16,7 @@
 #define CRASHPAD_UTIL_MISC_METRICS_H_
 
 #include <inttypes.h>
+#include <stddef.h>
 
 #include "build/build_config.h"
 #include "util/file/file_io.h"
@@ -32,6 +33,9 @@ namespace crashpad {
 //! `base/metrics/histogram_macros.h`. When building Crashpad standalone,
 //! (against mini_chromium), these macros do nothing. When built against
 //! Chromium's base, they allow integration with its metrics system.
+//!
+//! Most of these are also forwarded to LocalStats, which keeps the values in
+//! the process regardless of how Crashpad is built.
 class Metrics {
  public:
   Metrics() = delete;
@@ -63,6 +67,10 @@ class Metrics {
   //! \brief Reports on a crash upload attempt, and if it succeeded.
   static void CrashUploadAttempted(bool successful);
 
+  //! \brief Reports the time taken by an upload attempt, from preparing the
+  //!     report’s body to receiving the server’s response.
+  static void CrashUploadDuration(uint64_t duration_ns);
+
 #if BUILDFLAG(IS_APPLE) || DOXYGEN
   //! \brief Records error codes from
   //!     `+[NSURLConnection sendSynchronousRequest:returningResponse:error:]`.
@@ -99,6 +107,10 @@ class Metrics {
     //!     server, but the upload can be retried later.
     kUploadFailedButCanRetry = 6,
 
+    //! \brief Too many reports with the same crash signature were uploaded
+    //!     recently.
+    kDuplicate = 7,
+
     //! \brief The number of values in this enumeration; not a valid value.
     kMaxValue
   };
@@ -160,6 +172,12 @@ class Metrics {
     //! \brief Failure to open a memfd caused this crash dump to be skipped.
     kOpenMemfdFailed = 12,
 
+    //! \brief The crash was part of a crash loop, and was skipped without a
+    //!     full report.
+    //!
+    //! This value is only used on Linux/Android.
+    kSkippedDueToCrashLoop = 13,
+
     //! \brief The number of values in this enumeration; not a valid value.
     kMaxValue
   };
@@ -177,6 +195,90 @@ class Metrics {
   //! \brief The exception handler server started capturing an exception.
   static void ExceptionEncountered();
 
+  //! \brief Reports the number of crash dump requests, including a newly
+  //!     received one, that are waiting for other requests to be handled
+  //!     before they can be. `0` means that the new request was handled
+  //!     immediately.
+  static void ExceptionQueueDepth(size_t depth);
+
+  //! \brief Phases of capturing a report, for CapturePhaseDuration().
+  //!
+  //! \note These are used as metrics enumeration values and are recorded in
+  //!     minidump files, so new values should always be added at the end,
+  //!     before CapturePhase::kMaxValue.
+  enum class CapturePhase : int32_t {
+    //! \brief The time that the client process was suspended while the
+    //!     handler read from it.
+    kSuspended = 0,
+
+    //! \brief Enumerating the client’s threads and reading their contexts
+    //!     and stacks.
+    kThreadEnumeration = 1,
+
+    //! \brief Reading and parsing the client’s modules.
+    kModuleParsing = 2,
+
+    //! \brief Capturing memory indirectly referenced by the client’s
+    //!     threads.
+    kMemoryCapture = 3,
+
+    //! \brief Serializing the minidump file.
+    kMinidumpWrite = 4,
+
+    //! \brief Committing the report to the crash report database.
+    kDatabaseCommit = 5,
+
+    //! \brief The number of values in this enumeration; not a valid value.
+    kMaxValue
+  };
+
+  //! \brief Reports the time taken by one phase of capturing a report.
+  //!
+  //! \param[in] phase The phase that was timed.
+  //! \param[in] duration_ns The duration of the phase, in nanoseconds.
+  static void CapturePhaseDuration(CapturePhase phase, uint64_t duration_ns);
+
+  //! \brief The kinds of data read from a client process’ memory, for
+  //!     RemoteReads().
+  //!
+  //! \note These are used as metrics enumeration values and are recorded in
+  //!     minidump files, so new values should always be added at the end,
+  //!     before RemoteReadCategory::kMaxValue.
+  enum class RemoteReadCategory : int32_t {
+    //! \brief Reads not attributed to any other category.
+    kOther = 0,
+
+    //! \brief Reading threads’ stacks.
+    kStack = 1,
+
+    //! \brief Reading and parsing module headers, such as ELF headers, program
+    //!     headers, and notes.
+    kModuleHeaders = 2,
+
+    //! \brief Reading modules’ annotations.
+    kAnnotations = 3,
+
+    //! \brief Reading memory indirectly referenced by the client’s threads.
+    kIndirectMemory = 4,
+
+    //! \brief The number of values in this enumeration; not a valid value.
+    kMaxValue
+  };
+
+  //! \brief Reports the reads from a client process’ memory made in one
+  //!     category while capturing a report.
+  //!
+  //! \param[in] category The category of the reads.
+  //! \param[in] reads The number of reads.
+  //! \param[in] bytes The number of bytes read successfully.
+  //! \param[in] failures The number of reads that failed.
+  //! \param[in] duration_ns The total time spent reading, in nanoseconds.
+  static void RemoteReads(RemoteReadCategory category,
+                          uint64_t reads,
+                          uint64_t bytes,
+                          uint64_t failures,
+                          uint64_t duration_ns);
+
   //! \brief An important event in a handler process’ lifetime.
   //!
   //! \note These are used as metrics enumeration values, so new values should
@@ -213,6 +315,9 @@ class Metrics {
   //! This is currently only reported on Windows.
   static void HandlerCrashed(uint32_t exception_code);
 
+  //! \brief Reports the time taken to clean and prune a crash report database.
+  static void DatabasePruneDuration(uint64_t duration_ns);
+
 #if BUILDFLAG(IS_IOS) || DOXYGEN
   //! \brief Records a missing key from an intermediate dump.
   static void MissingIntermediateDumpKey(
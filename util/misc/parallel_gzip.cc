@@ -0,0 +1,247 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/parallel_gzip.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+namespace {
+
+// The size of the deflate window, and so the most input preceding a block
+// that can be referred to from within it.
+constexpr size_t kDictionarySize = 32 * 1024;
+
+// Batches hold a few blocks per thread so that threads finishing blocks of
+// easily-compressed data early can pick up more work.
+constexpr size_t kBlocksPerThread = 2;
+
+// The default values for zlib’s internal MAX_WBITS and DEF_MEM_LEVEL, as used
+// by GzipHTTPBodyStream.
+constexpr int kZlibMaxWindowBits = 15;
+constexpr int kZlibDefaultMemoryLevel = 8;
+
+struct Block {
+  const uint8_t* data;
+  size_t size;
+  const uint8_t* dictionary;
+  size_t dictionary_size;
+  std::vector<uint8_t> output;
+  unsigned long crc;
+  bool last;
+  bool ok;
+};
+
+bool CompressBlock(Block* block) {
+  z_stream zlib_stream = {};
+  int zr = deflateInit2(&zlib_stream,
+                        Z_DEFAULT_COMPRESSION,
+                        Z_DEFLATED,
+                        -kZlibMaxWindowBits,
+                        kZlibDefaultMemoryLevel,
+                        Z_DEFAULT_STRATEGY);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateInit2: " << ZlibErrorString(zr);
+    return false;
+  }
+
+  if (block->dictionary_size > 0) {
+    zr = deflateSetDictionary(&zlib_stream,
+                              block->dictionary,
+                              static_cast<uInt>(block->dictionary_size));
+    if (zr != Z_OK) {
+      LOG(ERROR) << "deflateSetDictionary: " << ZlibErrorString(zr);
+      deflateEnd(&zlib_stream);
+      return false;
+    }
+  }
+
+  // deflateBound() accounts for Z_FINISH but not for the empty stored block
+  // that Z_SYNC_FLUSH ends with. The loop below grows the buffer regardless.
+  block->output.resize(deflateBound(&zlib_stream, block->size) + 16);
+  zlib_stream.next_in = block->data;
+  zlib_stream.avail_in = static_cast<uInt>(block->size);
+  zlib_stream.next_out = block->output.data();
+  zlib_stream.avail_out = static_cast<uInt>(block->output.size());
+
+  const int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+  while (true) {
+    zr = deflate(&zlib_stream, flush);
+    if (zr == Z_STREAM_END ||
+        (zr == Z_OK && flush == Z_SYNC_FLUSH && zlib_stream.avail_out > 0)) {
+      break;
+    }
+    if (zr != Z_OK && zr != Z_BUF_ERROR) {
+      LOG(ERROR) << "deflate: " << ZlibErrorString(zr);
+      deflateEnd(&zlib_stream);
+      return false;
+    }
+
+    const size_t used = block->output.size() - zlib_stream.avail_out;
+    block->output.resize(block->output.size() * 2);
+    zlib_stream.next_out = block->output.data() + used;
+    zlib_stream.avail_out = static_cast<uInt>(block->output.size() - used);
+  }
+  block->output.resize(block->output.size() - zlib_stream.avail_out);
+
+  // A stream that ends in a sync flush is still in progress as far as zlib is
+  // concerned, so deflateEnd() reports Z_DATA_ERROR for it.
+  zr = deflateEnd(&zlib_stream);
+  if (zr != Z_OK && !(zr == Z_DATA_ERROR && flush == Z_SYNC_FLUSH)) {
+    LOG(ERROR) << "deflateEnd: " << ZlibErrorString(zr);
+    return false;
+  }
+
+  block->crc = ZlibCrc32(0, block->data, block->size);
+  return true;
+}
+
+void CompressBlocks(std::vector<Block>* blocks, std::atomic<size_t>* next) {
+  size_t index;
+  while ((index = next->fetch_add(1, std::memory_order_relaxed)) <
+         blocks->size()) {
+    Block& block = (*blocks)[index];
+    block.ok = CompressBlock(&block);
+  }
+}
+
+class CompressionThread final : public Thread {
+ public:
+  CompressionThread(std::vector<Block>* blocks, std::atomic<size_t>* next)
+      : Thread(), blocks_(blocks), next_(next) {}
+
+  CompressionThread(const CompressionThread&) = delete;
+  CompressionThread& operator=(const CompressionThread&) = delete;
+
+  ~CompressionThread() override = default;
+
+ private:
+  // Thread:
+  void ThreadMain() override { CompressBlocks(blocks_, next_); }
+
+  std::vector<Block>* blocks_;  // weak
+  std::atomic<size_t>* next_;  // weak
+};
+
+void AppendLittleEndian32(uint32_t value, std::vector<uint8_t>* output) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    output->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+}  // namespace
+
+ParallelGzipCompressor::ParallelGzipCompressor(size_t threads)
+    : dictionary_(),
+      uncompressed_size_(0),
+      threads_(std::max(threads, size_t{1})),
+      crc_(crc32(0, Z_NULL, 0)),
+      header_written_(false),
+      finished_(false) {}
+
+ParallelGzipCompressor::~ParallelGzipCompressor() = default;
+
+size_t ParallelGzipCompressor::BatchSize() const {
+  return threads_ * kBlocksPerThread * kBlockSize;
+}
+
+bool ParallelGzipCompressor::Compress(const uint8_t* data,
+                                      size_t size,
+                                      bool finish,
+                                      std::vector<uint8_t>* output) {
+  DCHECK(!finished_);
+  if (finished_) {
+    LOG(ERROR) << "gzip stream already finished";
+    return false;
+  }
+
+  if (!header_written_) {
+    // RFC 1952 §2.3: ID1, ID2, CM (deflate), FLG, MTIME (4 bytes), XFL, and
+    // OS (unknown).
+    static constexpr uint8_t kHeader[] = {
+        0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    output->insert(output->end(), std::begin(kHeader), std::end(kHeader));
+    header_written_ = true;
+  }
+
+  std::vector<Block> blocks;
+  for (size_t offset = 0; offset < size || (finish && blocks.empty());
+       offset += kBlockSize) {
+    Block block = {};
+    block.data = data + offset;
+    block.size = std::min(size - offset, kBlockSize);
+    if (offset == 0) {
+      block.dictionary = dictionary_.data();
+      block.dictionary_size = dictionary_.size();
+    } else {
+      block.dictionary_size = std::min(offset, kDictionarySize);
+      block.dictionary = block.data - block.dictionary_size;
+    }
+    block.last = finish && offset + block.size == size;
+    blocks.push_back(std::move(block));
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::unique_ptr<CompressionThread>> threads;
+  const size_t thread_count = std::min(threads_, blocks.size());
+  for (size_t index = 1; index < thread_count; ++index) {
+    threads.push_back(std::make_unique<CompressionThread>(&blocks, &next));
+    threads.back()->Start();
+  }
+  CompressBlocks(&blocks, &next);
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  for (const Block& block : blocks) {
+    if (!block.ok) {
+      return false;
+    }
+    output->insert(output->end(), block.output.begin(), block.output.end());
+    crc_ = crc32_combine(crc_, block.crc, static_cast<z_off_t>(block.size));
+  }
+  uncompressed_size_ += size;
+
+  // Keep the end of the input to prime the first block of the next batch.
+  if (size >= kDictionarySize) {
+    dictionary_.assign(data + size - kDictionarySize, data + size);
+  } else {
+    dictionary_.insert(dictionary_.end(), data, data + size);
+    if (dictionary_.size() > kDictionarySize) {
+      dictionary_.erase(dictionary_.begin(),
+                        dictionary_.end() - kDictionarySize);
+    }
+  }
+
+  if (finish) {
+    // RFC 1952 §2.3.1: CRC32 and ISIZE, the input size modulo 2^32.
+    AppendLittleEndian32(static_cast<uint32_t>(crc_), output);
+    AppendLittleEndian32(static_cast<uint32_t>(uncompressed_size_), output);
+    finished_ = true;
+  }
+
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,89 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_PARALLEL_GZIP_H_
+#define CRASHPAD_UTIL_MISC_PARALLEL_GZIP_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Produces a `gzip` stream by compressing fixed-size blocks of its
+//!     input on several threads at once.
+//!
+//! Each block is compressed as an independent raw deflate stream, primed with
+//! the 32kB of input that precede it so that matches spanning block
+//! boundaries are still found. Every block but the last ends with a sync
+//! flush, which aligns it to a byte boundary, so that the blocks can be
+//! concatenated into a single deflate stream behind one `gzip` header. The
+//! result can be decompressed by any `gzip` implementation, and is only
+//! slightly larger than a stream compressed on one thread.
+//!
+//! Input is compressed in batches of BatchSize() bytes. Each batch is divided
+//! among up to \a threads threads, one of which is the calling thread, and
+//! Compress() returns once the whole batch has been compressed.
+class ParallelGzipCompressor {
+ public:
+  //! \brief The number of bytes of input compressed as each block.
+  static constexpr size_t kBlockSize = 128 * 1024;
+
+  //! \param[in] threads The maximum number of threads, including the calling
+  //!     thread, to compress each batch with. `0` is treated as `1`.
+  explicit ParallelGzipCompressor(size_t threads);
+
+  ParallelGzipCompressor(const ParallelGzipCompressor&) = delete;
+  ParallelGzipCompressor& operator=(const ParallelGzipCompressor&) = delete;
+
+  ~ParallelGzipCompressor();
+
+  //! \brief The number of bytes of input that keep all threads busy.
+  //!
+  //! Callers that buffer their input should pass this much to each call to
+  //! Compress() but the last.
+  size_t BatchSize() const;
+
+  //! \brief Compresses \a size bytes at \a data, appending the compressed data
+  //!     to \a output.
+  //!
+  //! The `gzip` header is appended by the first call. Once \a finish is
+  //! `true`, the stream is completed by appending the `gzip` trailer, and this
+  //! method must not be called again.
+  //!
+  //! \param[in] data The data to compress.
+  //! \param[in] size The number of bytes at \a data. This may be `0`, and may
+  //!     exceed BatchSize().
+  //! \param[in] finish Whether \a data ends the uncompressed stream.
+  //! \param[out] output The vector that compressed data is appended to.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Compress(const uint8_t* data,
+                size_t size,
+                bool finish,
+                std::vector<uint8_t>* output);
+
+ private:
+  std::vector<uint8_t> dictionary_;
+  uint64_t uncompressed_size_;
+  size_t threads_;
+  unsigned long crc_;
+  bool header_written_;
+  bool finished_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_PARALLEL_GZIP_H_
@@ -0,0 +1,138 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/parallel_gzip.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/numerics/safe_conversions.h"
+#include "base/rand_util.h"
+#include "gtest/gtest.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Decompresses a single gzip member, requiring that it occupy all of
+// |compressed|.
+void GzipInflate(const std::vector<uint8_t>& compressed,
+                 size_t expected_size,
+                 std::vector<uint8_t>* decompressed) {
+  decompressed->resize(expected_size + 1);
+  z_stream zlib = {};
+  zlib.next_in = compressed.data();
+  zlib.avail_in = base::checked_cast<uInt>(compressed.size());
+  zlib.next_out = decompressed->data();
+  zlib.avail_out = base::checked_cast<uInt>(decompressed->size());
+
+  int zr = inflateInit2(&zlib, ZlibWindowBitsWithGzipWrapper(0));
+  ASSERT_EQ(zr, Z_OK) << "inflateInit2: " << ZlibErrorString(zr);
+  zr = inflate(&zlib, Z_FINISH);
+  EXPECT_EQ(zr, Z_STREAM_END) << "inflate: " << ZlibErrorString(zr);
+  EXPECT_EQ(zlib.avail_in, 0u);
+  decompressed->resize(decompressed->size() - zlib.avail_out);
+  EXPECT_EQ(inflateEnd(&zlib), Z_OK);
+}
+
+// Returns data that compresses well, with repetitions that span blocks.
+std::vector<uint8_t> MakeCompressibleData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t index = 0; index < size; ++index) {
+    data[index] = static_cast<uint8_t>((index / 7) % 251);
+  }
+  return data;
+}
+
+void TestRoundTrip(const std::vector<uint8_t>& data,
+                   size_t threads,
+                   size_t chunk_size) {
+  ParallelGzipCompressor compressor(threads);
+  std::vector<uint8_t> compressed;
+  size_t offset = 0;
+  do {
+    const size_t size = std::min(chunk_size, data.size() - offset);
+    const bool finish = offset + size == data.size();
+    ASSERT_TRUE(
+        compressor.Compress(data.data() + offset, size, finish, &compressed));
+    offset += size;
+  } while (offset < data.size());
+
+  ASSERT_GE(compressed.size(), 18u);
+  EXPECT_EQ(compressed[0], 0x1f);
+  EXPECT_EQ(compressed[1], 0x8b);
+  EXPECT_EQ(compressed[2], Z_DEFLATED);
+
+  std::vector<uint8_t> decompressed;
+  ASSERT_NO_FATAL_FAILURE(GzipInflate(compressed, data.size(), &decompressed));
+  EXPECT_TRUE(decompressed == data);
+}
+
+TEST(ParallelGzipCompressor, Empty) {
+  TestRoundTrip(std::vector<uint8_t>(), 4, 1);
+}
+
+TEST(ParallelGzipCompressor, SingleBatch) {
+  ParallelGzipCompressor compressor(4);
+  TestRoundTrip(MakeCompressibleData(compressor.BatchSize()),
+                4,
+                compressor.BatchSize());
+}
+
+TEST(ParallelGzipCompressor, CompressibleData) {
+  ParallelGzipCompressor compressor(3);
+  const std::vector<uint8_t> data =
+      MakeCompressibleData(compressor.BatchSize() * 2 + 12345);
+  TestRoundTrip(data, 3, compressor.BatchSize());
+  TestRoundTrip(data, 3, compressor.BatchSize() * 5);
+  TestRoundTrip(data, 3, ParallelGzipCompressor::kBlockSize - 1);
+  TestRoundTrip(data, 1, compressor.BatchSize());
+}
+
+TEST(ParallelGzipCompressor, RandomData) {
+  std::vector<uint8_t> data(ParallelGzipCompressor::kBlockSize * 9 + 1);
+  base::RandBytes(data);
+  TestRoundTrip(data, 4, data.size());
+  TestRoundTrip(data, 8, 1000);
+}
+
+TEST(ParallelGzipCompressor, MatchesAcrossBlocks) {
+  // Each block repeats the one before it. Because every block is primed with
+  // the end of the input preceding it, the repetitions are found even where
+  // they straddle blocks and batches.
+  std::vector<uint8_t> pattern(16 * 1024);
+  base::RandBytes(pattern);
+  std::vector<uint8_t> data;
+  while (data.size() < ParallelGzipCompressor::kBlockSize * 8) {
+    data.insert(data.end(), pattern.begin(), pattern.end());
+  }
+
+  ParallelGzipCompressor compressor(4);
+  std::vector<uint8_t> compressed;
+  ASSERT_TRUE(compressor.Compress(data.data(), data.size(), true, &compressed));
+  EXPECT_LT(compressed.size(), pattern.size() * 2);
+
+  std::vector<uint8_t> decompressed;
+  ASSERT_NO_FATAL_FAILURE(GzipInflate(compressed, data.size(), &decompressed));
+  EXPECT_TRUE(decompressed == data);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
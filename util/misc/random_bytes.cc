@@ -0,0 +1,183 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/random_bytes.h"
+
+#include <stdint.h>
+
+#include "base/rand_util.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <new>
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+namespace crashpad {
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+namespace {
+
+#if !defined(MADV_WIPEONFORK)
+#define MADV_WIPEONFORK 18
+#endif
+
+// The pool occupies a page of its own so that the page can be wiped on fork()
+// without affecting anything else. Every field is zero in a wiped page, which
+// leaves the pool empty and not busy.
+constexpr size_t kPoolPageSize = 4096;
+
+struct Pool {
+  std::atomic<uint32_t> busy;
+  uint32_t available;
+
+  // The process that filled the pool, checked only if the page couldn’t be
+  // set to be wiped on fork().
+  pid_t pid;
+
+  uint8_t bytes[kPoolPageSize - 16];
+};
+static_assert(sizeof(Pool) <= kPoolPageSize, "Pool must fit in its page");
+
+// Larger requests are made to the kernel directly. They would otherwise drain
+// the pool in a few requests, and the cost of the system call is small next to
+// theirs.
+constexpr size_t kMaxPooledRequestSize = 256;
+
+std::atomic<Pool*> g_pool;
+std::atomic<bool> g_pool_wiped_on_fork;
+
+// Reads from the kernel’s random source, returning false if getrandom() isn’t
+// available.
+bool GetRandom(void* buffer, size_t size) {
+#if defined(SYS_getrandom)
+  uint8_t* bytes = static_cast<uint8_t*>(buffer);
+  while (size > 0) {
+    const long result = syscall(SYS_getrandom, bytes, size, 0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += result;
+    size -= result;
+  }
+  return true;
+#else
+  return false;
+#endif  // SYS_getrandom
+}
+
+// Returns the pool, mapping it on first use. Mapping memory is safe in a
+// signal handler, and if two threads race to do it, one mapping is discarded.
+Pool* GetPool() {
+  Pool* pool = g_pool.load(std::memory_order_acquire);
+  if (pool) {
+    return pool;
+  }
+
+  void* page = mmap(nullptr,
+                    kPoolPageSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1,
+                    0);
+  if (page == MAP_FAILED) {
+    return nullptr;
+  }
+  if (madvise(page, kPoolPageSize, MADV_WIPEONFORK) == 0) {
+    g_pool_wiped_on_fork.store(true, std::memory_order_relaxed);
+  }
+  Pool* new_pool = new (page) Pool();
+
+  if (!g_pool.compare_exchange_strong(
+          pool, new_pool, std::memory_order_acq_rel)) {
+    munmap(page, kPoolPageSize);
+    return pool;
+  }
+  return new_pool;
+}
+
+bool ReadFromPool(void* buffer, size_t size) {
+  Pool* pool = GetPool();
+  if (!pool) {
+    return false;
+  }
+
+  uint32_t busy = 0;
+  if (!pool->busy.compare_exchange_strong(
+          busy, 1, std::memory_order_acquire)) {
+    return false;
+  }
+
+  // Without wiping, a child process inherits its parent’s pool, which must
+  // not be used again.
+  if (!g_pool_wiped_on_fork.load(std::memory_order_relaxed) &&
+      pool->pid != getpid()) {
+    memset(pool->bytes, 0, sizeof(pool->bytes));
+    pool->available = 0;
+  }
+
+  bool success = true;
+  if (pool->available < size) {
+    if (GetRandom(pool->bytes, sizeof(pool->bytes))) {
+      pool->available = sizeof(pool->bytes);
+      pool->pid = getpid();
+    } else {
+      success = false;
+    }
+  }
+
+  if (success) {
+    uint8_t* bytes = pool->bytes + sizeof(pool->bytes) - pool->available;
+    memcpy(buffer, bytes, size);
+    memset(bytes, 0, size);
+    pool->available -= size;
+  }
+
+  pool->busy.store(0, std::memory_order_release);
+  return success;
+}
+
+}  // namespace
+
+void RandomBytes(void* buffer, size_t size) {
+  const int saved_errno = errno;
+  if (!(size <= kMaxPooledRequestSize && ReadFromPool(buffer, size)) &&
+      !GetRandom(buffer, size)) {
+    // Kernels older than 3.17 don’t have getrandom().
+    base::RandBytes(base::span<uint8_t>(static_cast<uint8_t*>(buffer), size));
+  }
+  errno = saved_errno;
+}
+
+#else
+
+void RandomBytes(void* buffer, size_t size) {
+  base::RandBytes(base::span<uint8_t>(static_cast<uint8_t*>(buffer), size));
+}
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+}  // namespace crashpad
@@ -0,0 +1,45 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_RANDOM_BYTES_H_
+#define CRASHPAD_UTIL_MISC_RANDOM_BYTES_H_
+
+#include <stddef.h>
+
+namespace crashpad {
+
+//! \brief Fills \a buffer with \a size cryptographically secure random bytes.
+//!
+//! On Linux, ChromeOS, and Android, small requests are served from a
+//! per-process pool, which is refilled from the kernel’s random source by a
+//! single `getrandom()` call for many requests. Bytes are removed from the pool
+//! as they’re handed out, so they’re never given out twice or left behind in
+//! memory. The pool is wiped in child processes created by `fork()`, so a child
+//! never repeats its parent’s bytes.
+//!
+//! There, this function is async-signal-safe and doesn’t change `errno`. If a
+//! signal handler interrupts a thread that’s using the pool, or the pool is
+//! otherwise in use, the request is made to the kernel directly instead of
+//! waiting.
+//!
+//! On other systems, this calls `base::RandBytes()`, whose system sources need
+//! no buffering.
+//!
+//! \param[out] buffer The buffer to fill.
+//! \param[in] size The number of bytes to write to \a buffer.
+void RandomBytes(void* buffer, size_t size);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_RANDOM_BYTES_H_
@@ -0,0 +1,133 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/random_bytes.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+#include <set>
+#include <vector>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <signal.h>
+
+#include "test/multiprocess.h"
+#include "util/file/file_io.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using Bytes = std::array<uint8_t, 16>;
+
+Bytes NewBytes() {
+  Bytes bytes = {};
+  RandomBytes(bytes.data(), bytes.size());
+  return bytes;
+}
+
+TEST(RandomBytes, Unique) {
+  // Enough requests to refill any pool several times. Collisions are possible,
+  // but extremely unlikely.
+  std::set<Bytes> seen;
+  for (size_t index = 0; index < 2048; ++index) {
+    EXPECT_TRUE(seen.insert(NewBytes()).second);
+  }
+  EXPECT_EQ(seen.count(Bytes()), 0u);
+}
+
+TEST(RandomBytes, SizesAndErrno) {
+  RandomBytes(nullptr, 0);
+
+  for (size_t size : {1, 255, 256, 257, 4095, 65536}) {
+    SCOPED_TRACE(size);
+    std::vector<uint8_t> first(size);
+    std::vector<uint8_t> second(size);
+    errno = EBADF;
+    RandomBytes(first.data(), first.size());
+    RandomBytes(second.data(), second.size());
+    EXPECT_EQ(errno, EBADF);
+    if (size >= 16) {
+      EXPECT_NE(first, second);
+    }
+  }
+}
+
+#if BUILDFLAG(IS_POSIX)
+
+Bytes g_signal_bytes;
+
+void RandomBytesSignalHandler(int signal) {
+  RandomBytes(g_signal_bytes.data(), g_signal_bytes.size());
+}
+
+TEST(RandomBytes, SignalHandler) {
+  struct sigaction action = {};
+  action.sa_handler = RandomBytesSignalHandler;
+  struct sigaction old_action;
+  ASSERT_EQ(sigaction(SIGUSR1, &action, &old_action), 0);
+  const Bytes before = NewBytes();
+  ASSERT_EQ(raise(SIGUSR1), 0);
+  EXPECT_EQ(sigaction(SIGUSR1, &old_action, nullptr), 0);
+  EXPECT_NE(g_signal_bytes, Bytes());
+  EXPECT_NE(g_signal_bytes, before);
+  EXPECT_NE(NewBytes(), g_signal_bytes);
+}
+
+class RandomBytesForkTest : public Multiprocess {
+ public:
+  RandomBytesForkTest() : Multiprocess() {}
+
+  RandomBytesForkTest(const RandomBytesForkTest&) = delete;
+  RandomBytesForkTest& operator=(const RandomBytesForkTest&) = delete;
+
+ private:
+  void PreFork() override {
+    ASSERT_NO_FATAL_FAILURE(Multiprocess::PreFork());
+
+    // Fill any pool before forking, so that the child inherits it.
+    NewBytes();
+  }
+
+  void MultiprocessParent() override {
+    const Bytes parent_bytes = NewBytes();
+    Bytes child_bytes;
+    ASSERT_TRUE(LoggingReadFileExactly(
+        ReadPipeHandle(), child_bytes.data(), child_bytes.size()));
+    EXPECT_NE(parent_bytes, child_bytes);
+  }
+
+  void MultiprocessChild() override {
+    const Bytes child_bytes = NewBytes();
+    CheckedWriteFile(WritePipeHandle(), child_bytes.data(), child_bytes.size());
+  }
+};
+
+TEST(RandomBytes, Fork) {
+  RandomBytesForkTest test;
+  test.Run();
+}
+
+#endif  // BUILDFLAG(IS_POSIX)
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
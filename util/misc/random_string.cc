@@ -14,14 +14,38 @@
 
 #include "util/misc/random_string.h"
 
-#include "base/rand_util.h"
+#include <stdint.h>
+
+#include "base/check_op.h"
+#include "util/misc/random_bytes.h"
 
 namespace crashpad {
 
 std::string RandomString() {
+  return RandomString("ABCDEFGHIJKLMNOPQRSTUVWXYZ", 16);
+}
+
+std::string RandomString(std::string_view characters, size_t length) {
+  DCHECK(!characters.empty());
+  DCHECK_LE(characters.size(), 256u);
+
+  // Bytes at or above the largest multiple of the number of characters are
+  // discarded, so that no character is more likely than another. Bytes are
+  // requested in batches, rather than one for each character.
+  const size_t limit = 256 - 256 % characters.size();
   std::string random_string;
-  for (int index = 0; index < 16; ++index) {
-    random_string.append(1, static_cast<char>(base::RandInt('A', 'Z')));
+  random_string.reserve(length);
+  uint8_t bytes[64];
+  while (random_string.size() < length) {
+    RandomBytes(bytes, sizeof(bytes));
+    for (uint8_t byte : bytes) {
+      if (random_string.size() == length) {
+        break;
+      }
+      if (byte < limit) {
+        random_string.push_back(characters[byte % characters.size()]);
+      }
+    }
   }
   return random_string;
 }
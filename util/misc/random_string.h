@@ -15,7 +15,10 @@
 #ifndef CRASHPAD_UTIL_MISC_RANDOM_STRING_H_
 #define CRASHPAD_UTIL_MISC_RANDOM_STRING_H_
 
+#include <stddef.h>
+
 #include <string>
+#include <string_view>
 
 namespace crashpad {
 
@@ -26,6 +29,14 @@ namespace crashpad {
 //! 2<sup>75</sup>).
 std::string RandomString();
 
+//! \brief Returns a string of \a length characters, each chosen at random with
+//!     equal probability from \a characters.
+//!
+//! \param[in] characters The characters to choose from. There must be at
+//!     least 1 and at most 256 of them.
+//! \param[in] length The length of the string to return.
+std::string RandomString(std::string_view characters, size_t length);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_MISC_RANDOM_STRING_H_
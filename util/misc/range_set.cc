@@ -15,10 +15,14 @@
 #include "util/misc/range_set.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace crashpad {
 
-RangeSet::RangeSet() = default;
+RangeSet::RangeSet()
+    : ranges_(),
+      lowest_(std::numeric_limits<VMAddress>::max()),
+      highest_(0) {}
 
 RangeSet::~RangeSet() = default;
 
@@ -29,11 +33,15 @@ void RangeSet::Insert(VMAddress base, VMSize size) {
 
   VMAddress last = base + size - 1;
 
-  auto overlapping_range = ranges_.lower_bound(base);
+  // Start at the first range that ends no earlier than just before base, so
+  // that a range abutting this one from below is merged with it too.
+  auto overlapping_range = ranges_.lower_bound(base == 0 ? 0 : base - 1);
 #define OVERLAPPING_RANGES_BASE overlapping_range->second
 #define OVERLAPPING_RANGES_LAST overlapping_range->first
   while (overlapping_range != ranges_.end() &&
-         OVERLAPPING_RANGES_BASE <= last) {
+         (OVERLAPPING_RANGES_BASE <= last ||
+          (last != std::numeric_limits<VMAddress>::max() &&
+           OVERLAPPING_RANGES_BASE == last + 1))) {
     base = std::min(base, OVERLAPPING_RANGES_BASE);
     last = std::max(last, OVERLAPPING_RANGES_LAST);
     auto tmp = overlapping_range;
@@ -44,12 +52,59 @@ void RangeSet::Insert(VMAddress base, VMSize size) {
 #undef OVERLAPPING_RANGES_LAST
 
   ranges_[last] = base;
+  lowest_ = std::min(lowest_, base);
+  highest_ = std::max(highest_, last);
 }
 
 bool RangeSet::Contains(VMAddress address) const {
+  VMAddress base, last;
+  return Find(address, &base, &last);
+}
+
+bool RangeSet::ContainsRange(VMAddress base, VMSize size) const {
+  VMAddress range_base, range_last;
+  return size != 0 && Find(base, &range_base, &range_last) &&
+         size - 1 <= range_last - base;
+}
+
+bool RangeSet::Overlaps(VMAddress base, VMSize size) const {
+  if (!size) {
+    return false;
+  }
+
+  const VMAddress last = base + size - 1;
+  if (last < lowest_ || base > highest_) {
+    return false;
+  }
+
+  // The first range ending at or after base is the only one that can overlap
+  // without also being entirely above last.
+  auto range = ranges_.lower_bound(base);
+  return range != ranges_.end() && range->second <= last;
+}
+
+std::vector<CheckedRange<VMAddress, VMSize>> RangeSet::Ranges() const {
+  std::vector<CheckedRange<VMAddress, VMSize>> ranges;
+  ranges.reserve(ranges_.size());
+  for (const auto& range : ranges_) {
+    ranges.emplace_back(range.second, range.first - range.second + 1);
+  }
+  return ranges;
+}
+
+bool RangeSet::Find(VMAddress address, VMAddress* base, VMAddress* last) const {
+  if (address < lowest_ || address > highest_) {
+    return false;
+  }
+
   auto range_above_address = ranges_.lower_bound(address);
-  return range_above_address != ranges_.end() &&
-         range_above_address->second <= address;
+  if (range_above_address == ranges_.end() ||
+      range_above_address->second > address) {
+    return false;
+  }
+  *base = range_above_address->second;
+  *last = range_above_address->first;
+  return true;
 }
 
 }  // namespace crashpad
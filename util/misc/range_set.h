@@ -15,13 +15,21 @@
 #ifndef CRASHPAD_UTIL_MISC_RANGE_SET_H_
 #define CRASHPAD_UTIL_MISC_RANGE_SET_H_
 
+#include <sys/types.h>
+
 #include <map>
+#include <vector>
 
 #include "util/misc/address_types.h"
+#include "util/numeric/checked_range.h"
 
 namespace crashpad {
 
 //! \brief A set of VMAddress ranges.
+//!
+//! Ranges that overlap or abut are merged as they’re inserted, so the set
+//! always holds the fewest ranges that cover the inserted addresses. Insertion
+//! and lookup take logarithmic time in the number of ranges held.
 class RangeSet {
  public:
   RangeSet();
@@ -40,11 +48,46 @@ class RangeSet {
   //! \brief Returns `true` if \a address falls within a range in this set.
   bool Contains(VMAddress address) const;
 
+  //! \brief Returns `true` if every address in the range of \a size bytes at
+  //!     \a base falls within a single range in this set. Ranges of zero
+  //!     size are never contained.
+  bool ContainsRange(VMAddress base, VMSize size) const;
+
+  //! \brief Returns `true` if any address in the range of \a size bytes at
+  //!     \a base falls within a range in this set.
+  bool Overlaps(VMAddress base, VMSize size) const;
+
+  //! \brief Returns the ranges in this set, sorted by address. No two of them
+  //!     overlap or abut.
+  std::vector<CheckedRange<VMAddress, VMSize>> Ranges() const;
+
+  //! \brief Returns the number of ranges in this set.
+  size_t size() const { return ranges_.size(); }
+
+  //! \brief Returns `true` if this set holds no ranges.
+  bool empty() const { return ranges_.empty(); }
+
+  //! \brief Returns `true` if \a address falls within a range in this set.
+  //!
+  //! Callers that test many nearby addresses can test against the range
+  //! returned here before calling this method again.
+  //!
+  //! \param[in] address The address to look up.
+  //! \param[out] base The low address of the range containing \a address.
+  //!     Unchanged if \a address isn't in this set.
+  //! \param[out] last The highest address in the range containing \a address.
+  //!     Unchanged if \a address isn't in this set.
+  bool Find(VMAddress address, VMAddress* base, VMAddress* last) const;
+
  private:
   // Keys are the highest address in the range. Values are the base address of
-  // the range. Overlapping ranges are merged on insertion. Adjacent ranges may
-  // be merged.
+  // the range. Overlapping and adjacent ranges are merged on insertion.
   std::map<VMAddress, VMAddress> ranges_;
+
+  // The bounds of all ranges, which reject most addresses outside of them
+  // without searching ranges_. lowest_ > highest_ when the set is empty.
+  VMAddress lowest_;
+  VMAddress highest_;
 };
 
 }  // namespace crashpad
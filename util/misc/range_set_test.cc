@@ -17,6 +17,8 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
@@ -111,6 +113,93 @@ TEST(RangeSet, LargeOverlappingRanges) {
   EXPECT_TRUE(ranges.Contains(addr + kBufferSize - 1));
 }
 
+TEST(RangeSet, Find) {
+  RangeSet ranges;
+  VMAddress base = 0;
+  VMAddress last = 0;
+  EXPECT_FALSE(ranges.Find(0x2000, &base, &last));
+
+  ranges.Insert(0x1000, 0x100);
+  ranges.Insert(0x3000, 0x100);
+  ranges.Insert(0x3080, 0x100);
+
+  ASSERT_TRUE(ranges.Find(0x1000, &base, &last));
+  EXPECT_EQ(base, 0x1000u);
+  EXPECT_EQ(last, 0x10ffu);
+
+  ASSERT_TRUE(ranges.Find(0x3100, &base, &last));
+  EXPECT_EQ(base, 0x3000u);
+  EXPECT_EQ(last, 0x317fu);
+
+  // Misses leave base and last unchanged.
+  EXPECT_FALSE(ranges.Find(0x2000, &base, &last));
+  EXPECT_FALSE(ranges.Find(0xfff, &base, &last));
+  EXPECT_FALSE(ranges.Find(0x3180, &base, &last));
+  EXPECT_EQ(base, 0x3000u);
+  EXPECT_EQ(last, 0x317fu);
+}
+
+std::vector<std::pair<VMAddress, VMSize>> RangesOf(const RangeSet& ranges) {
+  std::vector<std::pair<VMAddress, VMSize>> result;
+  for (const auto& range : ranges.Ranges()) {
+    result.emplace_back(range.base(), range.size());
+  }
+  return result;
+}
+
+TEST(RangeSet, AbuttingRangesMerge) {
+  RangeSet ranges;
+  ranges.Insert(0x2000, 0x100);
+  ranges.Insert(0x1f00, 0x100);
+  ranges.Insert(0x2100, 0x100);
+  ranges.Insert(0x3000, 0x100);
+  ranges.Insert(0x2f00, 0xff);
+
+  std::vector<std::pair<VMAddress, VMSize>> expected = {
+      {0x1f00, 0x300},
+      {0x2f00, 0xff},
+      {0x3000, 0x100},
+  };
+  EXPECT_EQ(RangesOf(ranges), expected);
+  EXPECT_EQ(ranges.size(), 3u);
+
+  // A range bridging two others merges all three.
+  ranges.Insert(0x2fff, 1);
+  expected = {{0x1f00, 0x300}, {0x2f00, 0x200}};
+  EXPECT_EQ(RangesOf(ranges), expected);
+
+  // Ranges at the bottom of the address space merge too.
+  ranges.Insert(1, 1);
+  ranges.Insert(0, 1);
+  expected = {{0, 2}, {0x1f00, 0x300}, {0x2f00, 0x200}};
+  EXPECT_EQ(RangesOf(ranges), expected);
+}
+
+TEST(RangeSet, ContainsRangeAndOverlaps) {
+  RangeSet ranges;
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_FALSE(ranges.Overlaps(0, 0x10000));
+
+  ranges.Insert(0x1000, 0x100);
+  ranges.Insert(0x1200, 0x100);
+  EXPECT_FALSE(ranges.empty());
+
+  EXPECT_TRUE(ranges.ContainsRange(0x1000, 0x100));
+  EXPECT_TRUE(ranges.ContainsRange(0x1010, 0x10));
+  EXPECT_FALSE(ranges.ContainsRange(0x1010, 0x100));
+  EXPECT_FALSE(ranges.ContainsRange(0x1000, 0x300));
+  EXPECT_FALSE(ranges.ContainsRange(0x1000, 0));
+
+  EXPECT_TRUE(ranges.Overlaps(0xf00, 0x101));
+  EXPECT_FALSE(ranges.Overlaps(0xf00, 0x100));
+  EXPECT_TRUE(ranges.Overlaps(0x10ff, 0x10));
+  EXPECT_FALSE(ranges.Overlaps(0x1100, 0x100));
+  EXPECT_TRUE(ranges.Overlaps(0x1100, 0x101));
+  EXPECT_TRUE(ranges.Overlaps(0, 0x10000));
+  EXPECT_FALSE(ranges.Overlaps(0x1300, 0x10000));
+  EXPECT_FALSE(ranges.Overlaps(0x1050, 0));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,188 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_events.h"
+
+#include <inttypes.h>
+
+#include <atomic>
+#include <string>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
+#include "util/file/file_io.h"
+#include "util/misc/clock.h"
+#include "util/process/process_id.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+
+#include "base/strings/utf_string_conversions.h"
+#elif BUILDFLAG(IS_FUCHSIA)
+#include <lib/zx/process.h>
+
+#include "util/fuchsia/koid_utilities.h"
+#else
+#include <unistd.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+struct TraceState {
+  base::Lock lock;
+  FileHandle file = kInvalidFileHandle;
+  ProcessID process_id = 0;
+};
+
+std::atomic<bool> g_enabled;
+
+TraceState* GetTraceState() {
+  // This is never destroyed, so that threads still recording events at exit
+  // don’t use a destroyed lock.
+  static TraceState* trace_state = new TraceState();
+  return trace_state;
+}
+
+ProcessID GetSelfProcessID() {
+#if BUILDFLAG(IS_WIN)
+  return GetCurrentProcessId();
+#elif BUILDFLAG(IS_FUCHSIA)
+  return GetKoidForHandle(*zx::process::self());
+#else
+  return getpid();
+#endif
+}
+
+// Trace viewers group events by thread ID, but nothing relates it to the
+// system’s thread IDs, so a small sequential number is used. This avoids
+// differences between platforms in how to obtain a thread ID.
+uint64_t GetTraceThreadID() {
+  static std::atomic<uint64_t> next_thread_id(1);
+  thread_local uint64_t thread_id = 0;
+  if (thread_id == 0) {
+    thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  }
+  return thread_id;
+}
+
+void RecordEvent(const char* category,
+                 const char* name,
+                 char phase,
+                 uint64_t timestamp_ns,
+                 uint64_t duration_ns) {
+  std::string event = base::StringPrintf(
+      "{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,",
+      category,
+      name,
+      phase,
+      timestamp_ns / 1e3);
+  if (phase == 'X') {
+    base::StringAppendF(&event, "\"dur\":%.3f,", duration_ns / 1e3);
+  }
+
+  TraceState* trace_state = GetTraceState();
+  base::AutoLock lock(trace_state->lock);
+  if (trace_state->file == kInvalidFileHandle) {
+    return;
+  }
+  base::StringAppendF(&event,
+                      "\"pid\":%" PRI_PROCESS_ID ",\"tid\":%" PRIu64 "},\n",
+                      trace_state->process_id,
+                      GetTraceThreadID());
+  // Failures are not logged, because logging each one would flood the log.
+  WriteFile(trace_state->file, event.data(), event.size());
+}
+
+}  // namespace
+
+// static
+bool TraceEvents::Enable(const base::FilePath& path) {
+  ScopedFileHandle file(LoggingOpenFileForWrite(
+      path, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  static constexpr char kHeader[] = "[\n";
+  if (!file.is_valid() ||
+      !LoggingWriteFile(file.get(), kHeader, strlen(kHeader))) {
+    return false;
+  }
+
+  TraceState* trace_state = GetTraceState();
+  {
+    base::AutoLock lock(trace_state->lock);
+    if (trace_state->file != kInvalidFileHandle) {
+      CheckedCloseFile(trace_state->file);
+    }
+    trace_state->file = file.release();
+    trace_state->process_id = GetSelfProcessID();
+  }
+  g_enabled.store(true, std::memory_order_release);
+  return true;
+}
+
+// static
+bool TraceEvents::EnableInDirectory(const base::FilePath& directory) {
+  const std::string name = base::StringPrintf(
+      "crashpad_trace_%" PRI_PROCESS_ID ".json", GetSelfProcessID());
+#if BUILDFLAG(IS_WIN)
+  return Enable(directory.Append(base::UTF8ToWide(name)));
+#else
+  return Enable(directory.Append(name));
+#endif
+}
+
+// static
+void TraceEvents::Disable() {
+  g_enabled.store(false, std::memory_order_release);
+
+  TraceState* trace_state = GetTraceState();
+  base::AutoLock lock(trace_state->lock);
+  if (trace_state->file != kInvalidFileHandle) {
+    CheckedCloseFile(trace_state->file);
+    trace_state->file = kInvalidFileHandle;
+  }
+}
+
+// static
+bool TraceEvents::IsEnabled() {
+  return g_enabled.load(std::memory_order_acquire);
+}
+
+// static
+void TraceEvents::Begin(const char* category, const char* name) {
+  if (IsEnabled()) {
+    RecordEvent(category, name, 'B', ClockMonotonicNanoseconds(), 0);
+  }
+}
+
+// static
+void TraceEvents::End(const char* category, const char* name) {
+  if (IsEnabled()) {
+    RecordEvent(category, name, 'E', ClockMonotonicNanoseconds(), 0);
+  }
+}
+
+// static
+void TraceEvents::Complete(const char* category,
+                           const char* name,
+                           uint64_t start_ns) {
+  if (IsEnabled()) {
+    RecordEvent(
+        category, name, 'X', start_ns, ClockMonotonicNanoseconds() - start_ns);
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
+#define CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
+
+#include <stdint.h>
+
+#include "base/files/file_path.h"
+
+namespace crashpad {
+
+//! \brief Records trace events to a file in the Chrome JSON trace event
+//!     format, for viewing as a timeline in Perfetto or `chrome://tracing`.
+//!
+//! Tracing is off until Enable() is called. While it is off, recording an
+//! event costs only an atomic load.
+//!
+//! Each event is written to the file as soon as it is recorded, in the JSON
+//! array format, whose closing `]` is optional. A trace is readable even if the
+//! process that wrote it crashed.
+//!
+//! Event categories and names are written without escaping, so they must not
+//! contain `"` or `\`. String literals are expected.
+class TraceEvents {
+ public:
+  TraceEvents() = delete;
+  TraceEvents(const TraceEvents&) = delete;
+  TraceEvents& operator=(const TraceEvents&) = delete;
+
+  //! \brief Begins recording trace events to \a path, replacing any file
+  //!     there.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  static bool Enable(const base::FilePath& path);
+
+  //! \brief Begins recording trace events to a file in \a directory named for
+  //!     the current process.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  static bool EnableInDirectory(const base::FilePath& directory);
+
+  //! \brief Stops recording trace events and closes the file.
+  static void Disable();
+
+  //! \return `true` if trace events are being recorded.
+  static bool IsEnabled();
+
+  //! \brief Records the beginning of an event on the calling thread.
+  static void Begin(const char* category, const char* name);
+
+  //! \brief Records the end of an event begun on the calling thread by
+  //!     Begin().
+  static void End(const char* category, const char* name);
+
+  //! \brief Records an event from \a start_ns until now.
+  //!
+  //! Unlike Begin() and End(), events recorded this way need not nest, so this
+  //! is suitable for operations that overlap on one thread.
+  //!
+  //! \param[in] category The event’s category.
+  //! \param[in] name The event’s name.
+  //! \param[in] start_ns The time at which the event began, as returned by
+  //!     ClockMonotonicNanoseconds().
+  static void Complete(const char* category,
+                       const char* name,
+                       uint64_t start_ns);
+};
+
+//! \brief Records a trace event on the calling thread from construction until
+//!     destruction.
+class ScopedTraceEvent {
+ public:
+  ScopedTraceEvent(const char* category, const char* name)
+      : category_(category), name_(name) {
+    TraceEvents::Begin(category_, name_);
+  }
+
+  ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+  ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+  ~ScopedTraceEvent() { TraceEvents::End(category_, name_); }
+
+ private:
+  const char* category_;
+  const char* name_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
@@ -0,0 +1,90 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_events.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+size_t CountOccurrences(const std::string& haystack,
+                        const std::string& needle) {
+  size_t count = 0;
+  for (size_t position = haystack.find(needle); position != std::string::npos;
+       position = haystack.find(needle, position + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(TraceEvents, Disabled) {
+  EXPECT_FALSE(TraceEvents::IsEnabled());
+
+  // None of these should have any effect.
+  TraceEvents::Begin("test", "disabled");
+  TraceEvents::End("test", "disabled");
+  TraceEvents::Complete("test", "disabled", ClockMonotonicNanoseconds());
+  { ScopedTraceEvent event("test", "disabled"); }
+}
+
+TEST(TraceEvents, Record) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("trace.json"));
+  ASSERT_TRUE(TraceEvents::Enable(path));
+  EXPECT_TRUE(TraceEvents::IsEnabled());
+
+  {
+    ScopedTraceEvent outer("test", "outer");
+    { ScopedTraceEvent inner("test", "inner"); }
+  }
+  TraceEvents::Complete("other", "complete", ClockMonotonicNanoseconds());
+
+  TraceEvents::Disable();
+  EXPECT_FALSE(TraceEvents::IsEnabled());
+  TraceEvents::Begin("test", "after");
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &contents));
+  ASSERT_FALSE(contents.empty());
+  EXPECT_EQ(contents[0], '[');
+  EXPECT_EQ(CountOccurrences(contents, "\n{"), 5u);
+  EXPECT_EQ(CountOccurrences(contents, "\"ph\":\"B\""), 2u);
+  EXPECT_EQ(CountOccurrences(contents, "\"ph\":\"E\""), 2u);
+  EXPECT_EQ(CountOccurrences(contents, "\"ph\":\"X\""), 1u);
+  EXPECT_EQ(CountOccurrences(contents, "\"name\":\"outer\""), 2u);
+  EXPECT_EQ(CountOccurrences(contents, "\"name\":\"inner\""), 2u);
+  EXPECT_EQ(CountOccurrences(contents,
+                             "\"cat\":\"other\",\"name\":\"complete\""),
+            1u);
+  EXPECT_EQ(CountOccurrences(contents, "\"dur\":"), 1u);
+  EXPECT_EQ(CountOccurrences(contents, "\"name\":\"after\""), 0u);
+
+  // Events are nested in the order they were recorded.
+  EXPECT_LT(contents.find("\"name\":\"outer\""),
+            contents.find("\"name\":\"inner\""));
+  EXPECT_LT(contents.rfind("\"name\":\"inner\""),
+            contents.rfind("\"name\":\"outer\""));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -29,10 +29,10 @@
 
 #include "base/containers/span.h"
 #include "base/numerics/byte_conversions.h"
-#include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
+#include "util/misc/random_bytes.h"
 
 #if BUILDFLAG(IS_APPLE)
 #include <uuid/uuid.h>
@@ -116,7 +116,7 @@ bool UUID::InitializeWithNew() {
   // from libuuid is not available everywhere.
   // On Windows, do not use UuidCreate() to avoid a dependency on rpcrt4, so
   // that this function is usable early in DllMain().
-  base::RandBytes(base::byte_span_from_ref(*this));
+  RandomBytes(this, sizeof(*this));
 
   // Set six bits per RFC 4122 §4.4 to identify this as a pseudo-random UUID.
   data_3 = (4 << 12) | (data_3 & 0x0fff);  // §4.1.3
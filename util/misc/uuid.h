@@ -71,6 +71,9 @@ struct UUID {
   //! \brief Initializes the %UUID using a standard system facility to generate
   //!     the value.
   //!
+  //! On Linux, ChromeOS, and Android, the value comes from RandomBytes(), so
+  //! this is async-signal-safe there.
+  //!
   //! \return `true` if the %UUID was initialized correctly, `false` otherwise
   //!     with a message logged.
   bool InitializeWithNew();
@@ -14,12 +14,20 @@
 
 #include "util/misc/zlib.h"
 
+#include <algorithm>
+#include <limits>
 #include <ostream>
 
 #include "base/check.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "third_party/zlib/zlib_crashpad.h"
 
+#if defined(CRASHPAD_USE_LIBDEFLATE)
+#include "third_party/libdeflate/libdeflate_crashpad.h"
+#endif  // CRASHPAD_USE_LIBDEFLATE
+
 namespace crashpad {
 
 int ZlibWindowBitsWithGzipWrapper(int window_bits) {
@@ -36,4 +44,103 @@ std::string ZlibErrorString(int zr) {
   return base::StringPrintf("%s (%d)", zError(zr), zr);
 }
 
+uint32_t ZlibCrc32(uint32_t crc, const void* data, size_t size) {
+#if defined(CRASHPAD_USE_LIBDEFLATE)
+  return libdeflate_crc32(crc, data, size);
+#else
+  // zlib takes its length as a uInt, so feed it pieces that fit.
+  const Bytef* bytes = static_cast<const Bytef*>(data);
+  uLong result = crc;
+  while (size > 0) {
+    const uInt chunk = static_cast<uInt>(
+        std::min(size, size_t{std::numeric_limits<uInt>::max()}));
+    result = crc32(result, bytes, chunk);
+    bytes += chunk;
+    size -= chunk;
+  }
+  return static_cast<uint32_t>(result);
+#endif  // CRASHPAD_USE_LIBDEFLATE
+}
+
+bool GzipCompressBuffer(const void* data,
+                        size_t size,
+                        std::vector<uint8_t>* compressed) {
+#if defined(CRASHPAD_USE_LIBDEFLATE)
+  // libdeflate’s level 6 corresponds to zlib’s Z_DEFAULT_COMPRESSION.
+  constexpr int kLibdeflateDefaultLevel = 6;
+  libdeflate_compressor* compressor =
+      libdeflate_alloc_compressor(kLibdeflateDefaultLevel);
+  if (!compressor) {
+    LOG(ERROR) << "libdeflate_alloc_compressor failed";
+    return false;
+  }
+
+  compressed->resize(libdeflate_gzip_compress_bound(compressor, size));
+  const size_t compressed_size = libdeflate_gzip_compress(
+      compressor, data, size, compressed->data(), compressed->size());
+  libdeflate_free_compressor(compressor);
+  if (compressed_size == 0) {
+    LOG(ERROR) << "libdeflate_gzip_compress failed";
+    return false;
+  }
+  compressed->resize(compressed_size);
+  return true;
+#else
+  // The default values for zlib’s internal MAX_WBITS and DEF_MEM_LEVEL.
+  constexpr int kZlibMaxWindowBits = 15;
+  constexpr int kZlibDefaultMemoryLevel = 8;
+
+  z_stream zlib_stream = {};
+  int zr = deflateInit2(&zlib_stream,
+                        Z_DEFAULT_COMPRESSION,
+                        Z_DEFLATED,
+                        ZlibWindowBitsWithGzipWrapper(kZlibMaxWindowBits),
+                        kZlibDefaultMemoryLevel,
+                        Z_DEFAULT_STRATEGY);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateInit2: " << ZlibErrorString(zr);
+    return false;
+  }
+
+  // deflateBound() takes a uLong, which can be narrower than size_t. The
+  // output buffer grows below if this proves too small.
+  compressed->resize(
+      deflateBound(&zlib_stream, base::saturated_cast<uLong>(size)));
+  const Bytef* input = static_cast<const Bytef*>(data);
+  size_t input_remaining = size;
+  size_t output_used = 0;
+  do {
+    if (zlib_stream.avail_in == 0) {
+      zlib_stream.next_in = input;
+      zlib_stream.avail_in = base::saturated_cast<uInt>(input_remaining);
+      input += zlib_stream.avail_in;
+      input_remaining -= zlib_stream.avail_in;
+    }
+    if (output_used == compressed->size()) {
+      compressed->resize(std::max(compressed->size() * 2, size_t{64}));
+    }
+    zlib_stream.next_out = compressed->data() + output_used;
+    zlib_stream.avail_out =
+        base::saturated_cast<uInt>(compressed->size() - output_used);
+    const uInt avail_out = zlib_stream.avail_out;
+
+    zr = deflate(&zlib_stream, input_remaining == 0 ? Z_FINISH : Z_NO_FLUSH);
+    output_used += avail_out - zlib_stream.avail_out;
+    if (zr != Z_OK && zr != Z_STREAM_END && zr != Z_BUF_ERROR) {
+      LOG(ERROR) << "deflate: " << ZlibErrorString(zr);
+      deflateEnd(&zlib_stream);
+      return false;
+    }
+  } while (zr != Z_STREAM_END);
+  compressed->resize(output_used);
+
+  zr = deflateEnd(&zlib_stream);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateEnd: " << ZlibErrorString(zr);
+    return false;
+  }
+  return true;
+#endif  // CRASHPAD_USE_LIBDEFLATE
+}
+
 }  // namespace crashpad
@@ -15,7 +15,11 @@
 #ifndef CRASHPAD_UTIL_MISC_ZLIB_H_
 #define CRASHPAD_UTIL_MISC_ZLIB_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
+#include <vector>
 
 namespace crashpad {
 
@@ -37,6 +41,40 @@ int ZlibWindowBitsWithGzipWrapper(int window_bits);
 //! \return A formatted string.
 std::string ZlibErrorString(int zr);
 
+//! \brief Updates a CRC-32 checksum, as used by the `gzip` format, with
+//!     additional data.
+//!
+//! When Crashpad is built with libdeflate, its implementation, which uses
+//! carry-less multiplication instructions where the CPU has them, is used
+//! instead of zlib’s.
+//!
+//! \param[in] crc The checksum of the data preceding \a data, or `0` to begin
+//!     a new checksum.
+//! \param[in] data The data to add to the checksum.
+//! \param[in] size The number of bytes at \a data.
+//!
+//! \return The checksum of the data covered by \a crc followed by \a data.
+uint32_t ZlibCrc32(uint32_t crc, const void* data, size_t size);
+
+//! \brief Compresses a buffer held entirely in memory into a single `gzip`
+//!     member.
+//!
+//! The default compression level is used, as by GzipHTTPBodyStream. When
+//! Crashpad is built with libdeflate, which compresses a whole buffer
+//! considerably faster than zlib’s streaming interface, it is used instead of
+//! zlib. Either way, the result can be decompressed by any `gzip`
+//! implementation.
+//!
+//! \param[in] data The data to compress.
+//! \param[in] size The number of bytes at \a data.
+//! \param[out] compressed The compressed data, replacing any previous
+//!     contents.
+//!
+//! \return `true` on success, `false` on failure with a message logged.
+bool GzipCompressBuffer(const void* data,
+                        size_t size,
+                        std::vector<uint8_t>* compressed);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_MISC_ZLIB_H_
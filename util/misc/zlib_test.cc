@@ -0,0 +1,73 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/zlib.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "base/numerics/safe_conversions.h"
+#include "base/rand_util.h"
+#include "gtest/gtest.h"
+#include "third_party/zlib/zlib_crashpad.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(Zlib, Crc32) {
+  // The check value for CRC-32/ISO-HDLC, the variant used by gzip.
+  static constexpr char kCheck[] = "123456789";
+  EXPECT_EQ(ZlibCrc32(0, kCheck, strlen(kCheck)), 0xcbf43926u);
+  EXPECT_EQ(ZlibCrc32(ZlibCrc32(0, kCheck, 4), kCheck + 4, strlen(kCheck) - 4),
+            0xcbf43926u);
+  EXPECT_EQ(ZlibCrc32(0, nullptr, 0), 0u);
+}
+
+void TestGzipCompressBuffer(const std::string& data) {
+  std::vector<uint8_t> compressed;
+  ASSERT_TRUE(GzipCompressBuffer(data.data(), data.size(), &compressed));
+  ASSERT_GE(compressed.size(), 18u);
+  EXPECT_EQ(compressed[0], 0x1f);
+  EXPECT_EQ(compressed[1], 0x8b);
+
+  std::string decompressed(data.size() + 1, '\0');
+  z_stream zlib = {};
+  zlib.next_in = compressed.data();
+  zlib.avail_in = base::checked_cast<uInt>(compressed.size());
+  zlib.next_out = reinterpret_cast<Bytef*>(&decompressed[0]);
+  zlib.avail_out = base::checked_cast<uInt>(decompressed.size());
+  int zr = inflateInit2(&zlib, ZlibWindowBitsWithGzipWrapper(0));
+  ASSERT_EQ(zr, Z_OK) << "inflateInit2: " << ZlibErrorString(zr);
+  zr = inflate(&zlib, Z_FINISH);
+  EXPECT_EQ(zr, Z_STREAM_END) << "inflate: " << ZlibErrorString(zr);
+  EXPECT_EQ(zlib.avail_in, 0u);
+  decompressed.resize(decompressed.size() - zlib.avail_out);
+  EXPECT_EQ(inflateEnd(&zlib), Z_OK);
+
+  EXPECT_EQ(decompressed, data);
+}
+
+TEST(Zlib, GzipCompressBuffer) {
+  TestGzipCompressBuffer(std::string());
+  TestGzipCompressBuffer("Z");
+  TestGzipCompressBuffer(std::string(1024 * 1024, 'a'));
+  TestGzipCompressBuffer(base::RandBytesAsString(300000));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -24,6 +24,17 @@
 
 namespace crashpad {
 
+FileOperationResult HTTPBodyStream::GetBytesSpan(uint8_t* buffer,
+                                                 size_t max_len,
+                                                 const uint8_t** data) {
+  *data = buffer;
+  return GetBytesBuffer(buffer, max_len);
+}
+
+bool HTTPBodyStream::Reset() {
+  return false;
+}
+
 StringHTTPBodyStream::StringHTTPBodyStream(const std::string& string)
     : HTTPBodyStream(), string_(string), bytes_read_() {
 }
@@ -33,6 +44,17 @@ StringHTTPBodyStream::~StringHTTPBodyStream() {
 
 FileOperationResult StringHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
                                                          size_t max_len) {
+  const uint8_t* data;
+  FileOperationResult rv = GetBytesSpan(buffer, max_len, &data);
+  if (rv > 0) {
+    memcpy(buffer, data, rv);
+  }
+  return rv;
+}
+
+FileOperationResult StringHTTPBodyStream::GetBytesSpan(uint8_t* buffer,
+                                                       size_t max_len,
+                                                       const uint8_t** data) {
   size_t num_bytes_remaining = string_.length() - bytes_read_;
   if (num_bytes_remaining == 0) {
     return num_bytes_remaining;
@@ -41,13 +63,18 @@ FileOperationResult StringHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   size_t num_bytes_returned = std::min(
       std::min(num_bytes_remaining, max_len),
       implicit_cast<size_t>(std::numeric_limits<FileOperationResult>::max()));
-  memcpy(buffer, &string_[bytes_read_], num_bytes_returned);
+  *data = reinterpret_cast<const uint8_t*>(&string_[bytes_read_]);
   bytes_read_ += num_bytes_returned;
   return num_bytes_returned;
 }
 
+bool StringHTTPBodyStream::Reset() {
+  bytes_read_ = 0;
+  return true;
+}
+
 FileReaderHTTPBodyStream::FileReaderHTTPBodyStream(FileReaderInterface* reader)
-    : HTTPBodyStream(), reader_(reader), reached_eof_(false) {
+    : HTTPBodyStream(), reader_(reader), bytes_read_(0), reached_eof_(false) {
   DCHECK(reader_);
 }
 
@@ -62,10 +89,21 @@ FileOperationResult FileReaderHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   FileOperationResult rv = reader_->Read(buffer, max_len);
   if (rv == 0) {
     reached_eof_ = true;
+  } else if (rv > 0) {
+    bytes_read_ += rv;
   }
   return rv;
 }
 
+bool FileReaderHTTPBodyStream::Reset() {
+  if (bytes_read_ > 0 && reader_->Seek(-bytes_read_, SEEK_CUR) < 0) {
+    return false;
+  }
+  bytes_read_ = 0;
+  reached_eof_ = false;
+  return true;
+}
+
 CompositeHTTPBodyStream::CompositeHTTPBodyStream(
     const CompositeHTTPBodyStream::PartsList& parts)
     : HTTPBodyStream(), parts_(parts), current_part_(parts_.begin()) {
@@ -100,4 +138,32 @@ FileOperationResult CompositeHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return bytes_copied;
 }
 
+FileOperationResult CompositeHTTPBodyStream::GetBytesSpan(
+    uint8_t* buffer,
+    size_t max_len,
+    const uint8_t** data) {
+  // Unlike GetBytesBuffer(), each call provides data from only one part, which
+  // can’t be combined with the next without copying.
+  while (current_part_ != parts_.end()) {
+    FileOperationResult this_read =
+        (*current_part_)->GetBytesSpan(buffer, max_len, data);
+    if (this_read != 0) {
+      return this_read;
+    }
+    ++current_part_;
+  }
+
+  return 0;
+}
+
+bool CompositeHTTPBodyStream::Reset() {
+  for (HTTPBodyStream* part : parts_) {
+    if (!part->Reset()) {
+      return false;
+    }
+  }
+  current_part_ = parts_.begin();
+  return true;
+}
+
 }  // namespace crashpad
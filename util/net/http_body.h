@@ -44,6 +44,34 @@ class HTTPBodyStream {
   virtual FileOperationResult GetBytesBuffer(uint8_t* buffer,
                                              size_t max_len) = 0;
 
+  //! \brief Provides up to \a max_len bytes from the stream, without copying
+  //!     them if the stream already holds them in memory.
+  //!
+  //! Streams that hold their data in memory point \a data at it. Others copy
+  //! it into \a buffer as GetBytesBuffer() does, and point \a data at
+  //! \a buffer, which is what the default implementation does.
+  //!
+  //! \param[in] buffer A user-supplied buffer into which this method may copy
+  //!     bytes from the stream.
+  //! \param[in] max_len The length (or size) of \a buffer. At most this many
+  //!     bytes will be provided.
+  //! \param[out] data On success, the bytes provided. These remain valid until
+  //!     this object is next read from or destroyed.
+  //!
+  //! \return The same as GetBytesBuffer().
+  virtual FileOperationResult GetBytesSpan(uint8_t* buffer,
+                                           size_t max_len,
+                                           const uint8_t** data);
+
+  //! \brief Rewinds the stream so that its contents are provided again from
+  //!     the beginning, allowing a request to be resent.
+  //!
+  //! The default implementation doesn’t support rewinding.
+  //!
+  //! \return `true` on success. `false` if the stream can’t be rewound, in
+  //!     which case it must not be read from again.
+  virtual bool Reset();
+
  protected:
   HTTPBodyStream() {}
 };
@@ -64,6 +92,10 @@ class StringHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  FileOperationResult GetBytesSpan(uint8_t* buffer,
+                                   size_t max_len,
+                                   const uint8_t** data) override;
+  bool Reset() override;
 
  private:
   std::string string_;
@@ -76,6 +108,8 @@ class FileReaderHTTPBodyStream : public HTTPBodyStream {
  public:
   //! \brief Creates a stream for reading from a FileReaderInterface.
   //!
+  //! Reset() seeks \a reader back to where this stream started reading it.
+  //!
   //! \param[in] reader A FileReaderInterface from which this HTTPBodyStream
   //!     will read.
   explicit FileReaderHTTPBodyStream(FileReaderInterface* reader);
@@ -87,9 +121,11 @@ class FileReaderHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool Reset() override;
 
  private:
   FileReaderInterface* reader_;  // weak
+  FileOffset bytes_read_;
   bool reached_eof_;
 };
 
@@ -114,6 +150,10 @@ class CompositeHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  FileOperationResult GetBytesSpan(uint8_t* buffer,
+                                   size_t max_len,
+                                   const uint8_t** data) override;
+  bool Reset() override;
 
  private:
   PartsList parts_;
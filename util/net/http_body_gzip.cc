@@ -14,20 +14,33 @@
 
 #include "util/net/http_body_gzip.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/parallel_gzip.h"
 #include "util/misc/zlib.h"
 
 namespace crashpad {
 
-GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source)
+GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                                       size_t compression_threads)
     : input_(),
+      parallel_input_(),
+      parallel_output_(),
+      parallel_output_offset_(0),
+      parallel_compressor_(
+          compression_threads > 1
+              ? std::make_unique<ParallelGzipCompressor>(compression_threads)
+              : nullptr),
       source_(std::move(source)),
       z_stream_(new z_stream()),
+      compression_threads_(compression_threads),
       state_(State::kUninitialized) {}
 
 GzipHTTPBodyStream::~GzipHTTPBodyStream() {
@@ -46,6 +59,10 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
     return 0;
   }
 
+  if (parallel_compressor_) {
+    return GetBytesBufferParallel(buffer, max_len);
+  }
+
   if (state_ == State::kUninitialized) {
     z_stream_->zalloc = Z_NULL;
     z_stream_->zfree = Z_NULL;
@@ -78,8 +95,10 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
 
   while (state_ != State::kFinished && z_stream_->avail_out > 0) {
     if (state_ != State::kInputEOF && z_stream_->avail_in == 0) {
+      // Data that the source holds in memory is compressed in place.
+      const uint8_t* input;
       FileOperationResult input_bytes =
-          source_->GetBytesBuffer(input_, sizeof(input_));
+          source_->GetBytesSpan(input_, sizeof(input_), &input);
       if (input_bytes == -1) {
         Done(State::kError);
         return -1;
@@ -89,7 +108,9 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
         state_ = State::kInputEOF;
       }
 
-      z_stream_->next_in = input_;
+      // next_in is only const when ZLIB_CONST is defined. zlib doesn’t write
+      // to it regardless.
+      z_stream_->next_in = const_cast<uint8_t*>(input);
       z_stream_->avail_in = base::checked_cast<uInt>(input_bytes);
     }
 
@@ -111,6 +132,96 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return max_len - z_stream_->avail_out;
 }
 
+FileOperationResult GzipHTTPBodyStream::GetBytesBufferParallel(
+    uint8_t* buffer,
+    size_t max_len) {
+  if (state_ == State::kUninitialized) {
+    parallel_input_.resize(parallel_compressor_->BatchSize());
+    state_ = State::kOperating;
+  }
+
+  size_t bytes_copied = 0;
+  while (bytes_copied < max_len) {
+    if (parallel_output_offset_ < parallel_output_.size()) {
+      const size_t chunk =
+          std::min(max_len - bytes_copied,
+                   parallel_output_.size() - parallel_output_offset_);
+      memcpy(buffer + bytes_copied,
+             parallel_output_.data() + parallel_output_offset_,
+             chunk);
+      bytes_copied += chunk;
+      parallel_output_offset_ += chunk;
+      continue;
+    }
+
+    // All of the compressed data has been returned once the input has been
+    // exhausted.
+    if (state_ == State::kInputEOF) {
+      state_ = State::kFinished;
+      parallel_input_ = std::vector<uint8_t>();
+      parallel_output_ = std::vector<uint8_t>();
+      break;
+    }
+
+    size_t input_size = 0;
+    while (input_size < parallel_input_.size()) {
+      FileOperationResult input_bytes = source_->GetBytesBuffer(
+          parallel_input_.data() + input_size,
+          parallel_input_.size() - input_size);
+      if (input_bytes == -1) {
+        state_ = State::kError;
+        return -1;
+      }
+      if (input_bytes == 0) {
+        state_ = State::kInputEOF;
+        break;
+      }
+      input_size += input_bytes;
+    }
+
+    parallel_output_.clear();
+    parallel_output_offset_ = 0;
+    if (!parallel_compressor_->Compress(parallel_input_.data(),
+                                        input_size,
+                                        state_ == State::kInputEOF,
+                                        &parallel_output_)) {
+      state_ = State::kError;
+      return -1;
+    }
+  }
+
+  return bytes_copied;
+}
+
+bool GzipHTTPBodyStream::Reset() {
+  if (!source_->Reset()) {
+    return false;
+  }
+
+  if (parallel_compressor_) {
+    // The compressor carries the gzip header, checksum, and dictionary from one
+    // batch to the next, so a new one is needed to start over.
+    parallel_compressor_ =
+        std::make_unique<ParallelGzipCompressor>(compression_threads_);
+    parallel_input_ = std::vector<uint8_t>();
+    parallel_output_ = std::vector<uint8_t>();
+    parallel_output_offset_ = 0;
+  } else if (state_ == State::kOperating || state_ == State::kInputEOF) {
+    // deflateEnd() returns Z_DATA_ERROR for a stream abandoned before it was
+    // finished, as this one is.
+    int zr = deflateEnd(z_stream_.get());
+    if (zr != Z_OK && zr != Z_DATA_ERROR) {
+      LOG(ERROR) << "deflateEnd: " << ZlibErrorString(zr);
+      state_ = State::kError;
+      return false;
+    }
+  }
+
+  *z_stream_ = z_stream();
+  state_ = State::kUninitialized;
+  return true;
+}
+
 void GzipHTTPBodyStream::Done(State state) {
   DCHECK(state_ == State::kOperating || state_ == State::kInputEOF) << state_;
   DCHECK(state == State::kFinished || state == State::kError) << state;
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 #include "util/file/file_io.h"
 #include "util/net/http_body.h"
@@ -29,11 +30,19 @@ typedef struct z_stream_s z_stream;
 
 namespace crashpad {
 
+class ParallelGzipCompressor;
+
 //! \brief An implementation of HTTPBodyStream that `gzip`-compresses another
 //!     HTTPBodyStream.
 class GzipHTTPBodyStream : public HTTPBodyStream {
  public:
-  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source);
+  //! \param[in] source The stream to compress.
+  //! \param[in] compression_threads The maximum number of threads, including
+  //!     the thread reading from this object, to compress with. When this is
+  //!     greater than `1`, \a source is read in batches that are compressed
+  //!     by ParallelGzipCompressor.
+  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                              size_t compression_threads = 1);
 
   GzipHTTPBodyStream(const GzipHTTPBodyStream&) = delete;
   GzipHTTPBodyStream& operator=(const GzipHTTPBodyStream&) = delete;
@@ -42,6 +51,7 @@ class GzipHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool Reset() override;
 
  private:
   enum State : int {
@@ -56,9 +66,17 @@ class GzipHTTPBodyStream : public HTTPBodyStream {
   // logs a message and transitions state_ to State::kError.
   void Done(State state);
 
+  // GetBytesBuffer() for objects that compress with |parallel_compressor_|.
+  FileOperationResult GetBytesBufferParallel(uint8_t* buffer, size_t max_len);
+
   uint8_t input_[4096];
+  std::vector<uint8_t> parallel_input_;
+  std::vector<uint8_t> parallel_output_;
+  size_t parallel_output_offset_;
+  std::unique_ptr<ParallelGzipCompressor> parallel_compressor_;
   std::unique_ptr<HTTPBodyStream> source_;
   std::unique_ptr<z_stream> z_stream_;
+  size_t compression_threads_;
   State state_;
 };
 
@@ -175,6 +175,59 @@ TEST(GzipHTTPBodyStream, ManyBytes_Random) {
   TestGzipDeflateInflate(base::RandBytesAsString(kManyBytes));
 }
 
+TEST(GzipHTTPBodyStream, Reset) {
+  const std::string string =
+      MakeString(kManyBytes) + base::RandBytesAsString(kManyBytes);
+
+  for (size_t compression_threads : {1, 4}) {
+    SCOPED_TRACE(compression_threads);
+
+    GzipHTTPBodyStream gzip_stream(
+        std::make_unique<StringHTTPBodyStream>(string), compression_threads);
+
+    // Stop partway through the stream, then start over.
+    uint8_t buf[4096];
+    ASSERT_GT(gzip_stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+    ASSERT_TRUE(gzip_stream.Reset());
+
+    std::string compressed;
+    FileOperationResult compressed_bytes;
+    while ((compressed_bytes = gzip_stream.GetBytesBuffer(buf, sizeof(buf))) >
+           0) {
+      compressed.append(reinterpret_cast<char*>(buf), compressed_bytes);
+    }
+    ASSERT_EQ(compressed_bytes, 0);
+
+    std::string decompressed;
+    ASSERT_NO_FATAL_FAILURE(
+        GzipInflate(compressed, &decompressed, string.size()));
+    EXPECT_EQ(decompressed, string);
+  }
+}
+
+TEST(GzipHTTPBodyStream, CompressionThreads) {
+  const std::string string =
+      MakeString(kManyBytes) + base::RandBytesAsString(kManyBytes) +
+      std::string(kManyBytes, '\0') + MakeString(kManyBytes);
+
+  GzipHTTPBodyStream gzip_stream(std::make_unique<StringHTTPBodyStream>(string),
+                                 4);
+  uint8_t buf[4096];
+  std::string compressed;
+  FileOperationResult compressed_bytes;
+  while ((compressed_bytes = gzip_stream.GetBytesBuffer(buf, sizeof(buf))) >
+         0) {
+    compressed.append(reinterpret_cast<char*>(buf), compressed_bytes);
+  }
+  ASSERT_EQ(compressed_bytes, 0);
+  ASSERT_EQ(gzip_stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+
+  std::string decompressed;
+  ASSERT_NO_FATAL_FAILURE(
+      GzipInflate(compressed, &decompressed, string.size()));
+  EXPECT_EQ(decompressed, string);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
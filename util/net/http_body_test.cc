@@ -96,6 +96,29 @@ TEST(StringHTTPBodyStream, MultipleReads) {
   }
 }
 
+TEST(StringHTTPBodyStream, Span) {
+  uint8_t buf[4];
+  memset(buf, '!', sizeof(buf));
+
+  std::string string("Hello, world");
+  StringHTTPBodyStream stream(string);
+
+  // The data is provided in place, without being copied into buf.
+  const uint8_t* data;
+  ASSERT_EQ(stream.GetBytesSpan(buf, sizeof(buf), &data), 4);
+  EXPECT_NE(data, buf);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), 4), "Hell");
+  ExpectBufferSet(buf, '!', sizeof(buf));
+
+  // Spans and copies can be mixed.
+  ASSERT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 4);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(buf), 4), "o, w");
+  ASSERT_EQ(stream.GetBytesSpan(buf, sizeof(buf), &data), 4);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), 4), "orld");
+
+  EXPECT_EQ(stream.GetBytesSpan(buf, sizeof(buf), &data), 0);
+}
+
 TEST(FileReaderHTTPBodyStream, ReadASCIIFile) {
   base::FilePath path = TestPaths::TestDataRoot().Append(
       FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
@@ -161,6 +184,48 @@ TEST(CompositeHTTPBodyStream, TwoEmptyStrings) {
   ExpectBufferSet(buf, '!', sizeof(buf));
 }
 
+TEST(CompositeHTTPBodyStream, Spans) {
+  std::string string1("Hello! ");
+  std::string string2(" Goodbye :)");
+
+  std::vector<HTTPBodyStream*> parts;
+  parts.push_back(new StringHTTPBodyStream(std::string()));
+  parts.push_back(new StringHTTPBodyStream(string1));
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  parts.push_back(new FileReaderHTTPBodyStream(&reader));
+  parts.push_back(new StringHTTPBodyStream(string2));
+
+  CompositeHTTPBodyStream stream(parts);
+
+  // Each span comes from a single part. Those of the strings are provided in
+  // place, while the file is read into buf.
+  uint8_t buf[32];
+  const uint8_t* data;
+  FileOperationResult rv = stream.GetBytesSpan(buf, sizeof(buf), &data);
+  ASSERT_EQ(rv, implicit_cast<FileOperationResult>(string1.size()));
+  EXPECT_NE(data, buf);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), rv), string1);
+
+  rv = stream.GetBytesSpan(buf, sizeof(buf), &data);
+  ASSERT_GT(rv, 0);
+  EXPECT_EQ(data, buf);
+  std::string file_contents(reinterpret_cast<const char*>(data), rv);
+  while ((rv = stream.GetBytesSpan(buf, sizeof(buf), &data)) > 0 &&
+         data == buf) {
+    file_contents.append(reinterpret_cast<const char*>(data), rv);
+  }
+  EXPECT_EQ(file_contents, "This is a test.\n");
+
+  ASSERT_EQ(rv, implicit_cast<FileOperationResult>(string2.size()));
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), rv), string2);
+
+  EXPECT_EQ(stream.GetBytesSpan(buf, sizeof(buf), &data), 0);
+}
+
 class CompositeHTTPBodyStreamBufferSize
     : public testing::TestWithParam<size_t> {
 };
@@ -207,6 +272,36 @@ TEST_P(CompositeHTTPBodyStreamBufferSize, StringsAndFile) {
   EXPECT_EQ(actual_string, expected_string);
 }
 
+TEST(CompositeHTTPBodyStream, Reset) {
+  std::string string1("Hello! ");
+  std::string string2(" Goodbye :)");
+
+  std::vector<HTTPBodyStream*> parts;
+  parts.push_back(new StringHTTPBodyStream(string1));
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  parts.push_back(new FileReaderHTTPBodyStream(&reader));
+  parts.push_back(new StringHTTPBodyStream(string2));
+
+  CompositeHTTPBodyStream stream(parts);
+
+  // Stop partway through the file.
+  uint8_t buf[12];
+  ASSERT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)),
+            implicit_cast<FileOperationResult>(sizeof(buf)));
+
+  std::string expected_string = string1 + "This is a test.\n" + string2;
+  ASSERT_TRUE(stream.Reset());
+  EXPECT_EQ(ReadStreamToString(&stream), expected_string);
+
+  // A stream that has been read to the end can be rewound too.
+  ASSERT_TRUE(stream.Reset());
+  EXPECT_EQ(ReadStreamToString(&stream), expected_string);
+}
+
 INSTANTIATE_TEST_SUITE_P(VariableBufferSize,
                          CompositeHTTPBodyStreamBufferSize,
                          testing::Values(1, 2, 9, 16, 31, 128, 1024));
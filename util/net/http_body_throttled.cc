@@ -0,0 +1,93 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_throttled.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint64_t kNanosecondsPerSecond = 1E9;
+
+}  // namespace
+
+HTTPBodyStreamThrottle::HTTPBodyStreamThrottle(uint64_t bytes_per_second)
+    : bytes_per_second_(bytes_per_second), lock_(), next_release_ns_(0) {
+  DCHECK_GT(bytes_per_second_, 0u);
+}
+
+HTTPBodyStreamThrottle::~HTTPBodyStreamThrottle() = default;
+
+size_t HTTPBodyStreamThrottle::MaxChunkSize() const {
+  // Release about a tenth of a second’s worth of data at a time.
+  return static_cast<size_t>(
+      std::max(bytes_per_second_ / 10, static_cast<uint64_t>(1)));
+}
+
+void HTTPBodyStreamThrottle::Consume(size_t bytes) {
+  uint64_t release_ns;
+  {
+    base::AutoLock lock(lock_);
+    uint64_t now_ns = ClockMonotonicNanoseconds();
+    release_ns = std::max(now_ns, next_release_ns_);
+    next_release_ns_ =
+        release_ns + bytes * kNanosecondsPerSecond / bytes_per_second_;
+  }
+
+  uint64_t now_ns = ClockMonotonicNanoseconds();
+  if (release_ns > now_ns) {
+    SleepNanoseconds(release_ns - now_ns);
+  }
+}
+
+ThrottledHTTPBodyStream::ThrottledHTTPBodyStream(
+    std::unique_ptr<HTTPBodyStream> source,
+    HTTPBodyStreamThrottle* throttle)
+    : HTTPBodyStream(), source_(std::move(source)), throttle_(throttle) {}
+
+ThrottledHTTPBodyStream::~ThrottledHTTPBodyStream() = default;
+
+FileOperationResult ThrottledHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                            size_t max_len) {
+  FileOperationResult rv = source_->GetBytesBuffer(
+      buffer, std::min(max_len, throttle_->MaxChunkSize()));
+  if (rv > 0) {
+    throttle_->Consume(rv);
+  }
+  return rv;
+}
+
+FileOperationResult ThrottledHTTPBodyStream::GetBytesSpan(
+    uint8_t* buffer,
+    size_t max_len,
+    const uint8_t** data) {
+  FileOperationResult rv = source_->GetBytesSpan(
+      buffer, std::min(max_len, throttle_->MaxChunkSize()), data);
+  if (rv > 0) {
+    throttle_->Consume(rv);
+  }
+  return rv;
+}
+
+bool ThrottledHTTPBodyStream::Reset() {
+  return source_->Reset();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,88 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_BODY_THROTTLED_H_
+#define CRASHPAD_UTIL_NET_HTTP_BODY_THROTTLED_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/synchronization/lock.h"
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+
+namespace crashpad {
+
+//! \brief Limits the combined rate at which one or more
+//!     ThrottledHTTPBodyStream objects produce data.
+//!
+//! This class is thread-safe. A single object may be shared by streams that are
+//! read on different threads.
+class HTTPBodyStreamThrottle {
+ public:
+  //! \param[in] bytes_per_second The maximum combined rate, which must be
+  //!     greater than `0`.
+  explicit HTTPBodyStreamThrottle(uint64_t bytes_per_second);
+
+  HTTPBodyStreamThrottle(const HTTPBodyStreamThrottle&) = delete;
+  HTTPBodyStreamThrottle& operator=(const HTTPBodyStreamThrottle&) = delete;
+
+  ~HTTPBodyStreamThrottle();
+
+  //! \brief The largest amount of data that a stream should produce at once,
+  //!     so that the throttled rate is maintained smoothly.
+  size_t MaxChunkSize() const;
+
+  //! \brief Accounts for \a bytes of data, blocking until they may be released
+  //!     without exceeding the throttled rate.
+  void Consume(size_t bytes);
+
+ private:
+  const uint64_t bytes_per_second_;
+  base::Lock lock_;
+  uint64_t next_release_ns_;  // Protected by lock_.
+};
+
+//! \brief An implementation of HTTPBodyStream that limits the rate at which
+//!     another HTTPBodyStream is read.
+class ThrottledHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \param[in] source The stream to read from.
+  //! \param[in] throttle The throttle to account data against. This object
+  //!     does not take ownership of \a throttle, which must outlive this
+  //!     object.
+  ThrottledHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                          HTTPBodyStreamThrottle* throttle);
+
+  ThrottledHTTPBodyStream(const ThrottledHTTPBodyStream&) = delete;
+  ThrottledHTTPBodyStream& operator=(const ThrottledHTTPBodyStream&) = delete;
+
+  ~ThrottledHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  FileOperationResult GetBytesSpan(uint8_t* buffer,
+                                   size_t max_len,
+                                   const uint8_t** data) override;
+  bool Reset() override;
+
+ private:
+  std::unique_ptr<HTTPBodyStream> source_;
+  HTTPBodyStreamThrottle* throttle_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_BODY_THROTTLED_H_
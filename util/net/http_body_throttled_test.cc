@@ -0,0 +1,76 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_throttled.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_test_util.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerSecond = 1E9;
+
+TEST(ThrottledHTTPBodyStream, Empty) {
+  HTTPBodyStreamThrottle throttle(1);
+  ThrottledHTTPBodyStream stream(std::make_unique<StringHTTPBodyStream>(""),
+                                 &throttle);
+  EXPECT_EQ(ReadStreamToString(&stream), "");
+}
+
+TEST(ThrottledHTTPBodyStream, Rate) {
+  constexpr uint64_t kBytesPerSecond = 4000;
+  const std::string data(1000, 'x');
+
+  HTTPBodyStreamThrottle throttle(kBytesPerSecond);
+
+  // The first chunk is released immediately, and each subsequent one is
+  // released once the previous one has been accounted for.
+  const uint64_t minimum_ns = (data.size() - throttle.MaxChunkSize()) *
+                              kNanosecondsPerSecond / kBytesPerSecond;
+
+  uint64_t start_ns = ClockMonotonicNanoseconds();
+  ThrottledHTTPBodyStream stream(std::make_unique<StringHTTPBodyStream>(data),
+                                 &throttle);
+  EXPECT_EQ(ReadStreamToString(&stream, data.size()), data);
+  EXPECT_GE(ClockMonotonicNanoseconds() - start_ns, minimum_ns);
+}
+
+TEST(ThrottledHTTPBodyStream, SharedThrottle) {
+  constexpr uint64_t kBytesPerSecond = 4000;
+  const std::string data(500, 'y');
+
+  HTTPBodyStreamThrottle throttle(kBytesPerSecond);
+  const uint64_t minimum_ns = (2 * data.size() - throttle.MaxChunkSize()) *
+                              kNanosecondsPerSecond / kBytesPerSecond;
+
+  uint64_t start_ns = ClockMonotonicNanoseconds();
+  ThrottledHTTPBodyStream stream_1(
+      std::make_unique<StringHTTPBodyStream>(data), &throttle);
+  ThrottledHTTPBodyStream stream_2(
+      std::make_unique<StringHTTPBodyStream>(data), &throttle);
+  EXPECT_EQ(ReadStreamToString(&stream_1), data);
+  EXPECT_EQ(ReadStreamToString(&stream_2), data);
+  EXPECT_GE(ClockMonotonicNanoseconds() - start_ns, minimum_ns);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,155 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_zstd.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "third_party/zstd/zstd_crashpad.h"
+
+namespace crashpad {
+
+namespace {
+
+// The largest window that RFC 9659 permits for the zstd content coding, 8MB.
+constexpr int kMaxHTTPWindowLog = 23;
+
+// The highest compression level whose default window fits within
+// kMaxHTTPWindowLog. Higher (“ultra”) levels use larger windows.
+constexpr int kMaxCompressionLevelWithinHTTPWindow = 19;
+
+}  // namespace
+
+ZstdHTTPBodyStream::ZstdHTTPBodyStream(int compression_level,
+                                       bool long_distance_matching,
+                                       std::unique_ptr<HTTPBodyStream> source)
+    : input_(),
+      input_data_(input_),
+      source_(std::move(source)),
+      cctx_(nullptr),
+      input_pos_(0),
+      input_size_(0),
+      compression_level_(compression_level),
+      long_distance_matching_(long_distance_matching),
+      state_(State::kUninitialized) {}
+
+ZstdHTTPBodyStream::~ZstdHTTPBodyStream() {
+  ZSTD_freeCCtx(cctx_);
+}
+
+FileOperationResult ZstdHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                       size_t max_len) {
+  if (state_ == State::kError) {
+    return -1;
+  }
+
+  if (state_ == State::kFinished) {
+    return 0;
+  }
+
+  if (state_ == State::kUninitialized) {
+    state_ = State::kError;
+
+    cctx_ = ZSTD_createCCtx();
+    if (!cctx_) {
+      LOG(ERROR) << "ZSTD_createCCtx";
+      return -1;
+    }
+
+    const struct {
+      ZSTD_cParameter parameter;
+      int value;
+      bool set;
+    } kParameters[] = {
+        {ZSTD_c_compressionLevel, compression_level_, true},
+        {ZSTD_c_checksumFlag, 1, true},
+        {ZSTD_c_enableLongDistanceMatching, 1, long_distance_matching_},
+        {ZSTD_c_windowLog,
+         kMaxHTTPWindowLog,
+         long_distance_matching_ ||
+             compression_level_ > kMaxCompressionLevelWithinHTTPWindow},
+    };
+    for (const auto& parameter : kParameters) {
+      if (!parameter.set) {
+        continue;
+      }
+      size_t result = ZSTD_CCtx_setParameter(
+          cctx_, parameter.parameter, parameter.value);
+      if (ZSTD_isError(result)) {
+        LOG(ERROR) << "ZSTD_CCtx_setParameter: " << ZSTD_getErrorName(result);
+        return -1;
+      }
+    }
+
+    state_ = State::kOperating;
+  }
+
+  ZSTD_outBuffer output = {buffer, max_len, 0};
+  while (state_ != State::kFinished && output.pos < output.size) {
+    if (state_ != State::kInputEOF && input_pos_ == input_size_) {
+      // Data that the source holds in memory is compressed in place.
+      FileOperationResult input_bytes =
+          source_->GetBytesSpan(input_, sizeof(input_), &input_data_);
+      if (input_bytes == -1) {
+        state_ = State::kError;
+        return -1;
+      }
+
+      if (input_bytes == 0) {
+        state_ = State::kInputEOF;
+      }
+
+      input_pos_ = 0;
+      input_size_ = input_bytes;
+    }
+
+    ZSTD_inBuffer input = {input_data_, input_size_, input_pos_};
+    size_t result = ZSTD_compressStream2(
+        cctx_,
+        &output,
+        &input,
+        state_ == State::kInputEOF ? ZSTD_e_end : ZSTD_e_continue);
+    if (ZSTD_isError(result)) {
+      LOG(ERROR) << "ZSTD_compressStream2: " << ZSTD_getErrorName(result);
+      state_ = State::kError;
+      return -1;
+    }
+    input_pos_ = input.pos;
+
+    if (state_ == State::kInputEOF && result == 0) {
+      state_ = State::kFinished;
+    }
+  }
+
+  DCHECK_LE(output.pos, max_len);
+  return output.pos;
+}
+
+bool ZstdHTTPBodyStream::Reset() {
+  if (!source_->Reset()) {
+    return false;
+  }
+
+  ZSTD_freeCCtx(cctx_);
+  cctx_ = nullptr;
+  input_data_ = input_;
+  input_pos_ = 0;
+  input_size_ = 0;
+  state_ = State::kUninitialized;
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
+#define CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+
+extern "C" {
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+}  // extern "C"
+
+namespace crashpad {
+
+//! \brief An implementation of HTTPBodyStream that Zstandard-compresses another
+//!     HTTPBodyStream into a single frame, suitable for use with
+//!     `Content-Encoding: zstd`.
+//!
+//! This class is only available when Crashpad is built with Zstandard support,
+//! indicated by `CRASHPAD_USE_ZSTD` being defined.
+class ZstdHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! The compression window is limited to the 8MB that RFC 9659 requires of the
+  //! `zstd` content coding, even for compression levels and long-distance
+  //! matching that would otherwise use a larger one.
+  //!
+  //! \param[in] compression_level The Zstandard compression level. 0 selects
+  //!     the library’s default.
+  //! \param[in] long_distance_matching Whether to enable long-distance
+  //!     matching, which finds repetitions far apart in the source at some cost
+  //!     in memory and speed.
+  //! \param[in] source The stream to compress.
+  ZstdHTTPBodyStream(int compression_level,
+                     bool long_distance_matching,
+                     std::unique_ptr<HTTPBodyStream> source);
+
+  ZstdHTTPBodyStream(const ZstdHTTPBodyStream&) = delete;
+  ZstdHTTPBodyStream& operator=(const ZstdHTTPBodyStream&) = delete;
+
+  ~ZstdHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool Reset() override;
+
+ private:
+  enum State : int {
+    kUninitialized,
+    kOperating,
+    kInputEOF,
+    kFinished,
+    kError,
+  };
+
+  uint8_t input_[4096];
+  const uint8_t* input_data_;  // weak, input_ or held by source_
+  std::unique_ptr<HTTPBodyStream> source_;
+  ZSTD_CCtx* cctx_;  // owned
+  size_t input_pos_;
+  size_t input_size_;
+  int compression_level_;
+  bool long_distance_matching_;
+  State state_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
@@ -0,0 +1,173 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_zstd.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/containers/heap_array.h"
+#include "base/rand_util.h"
+#include "gtest/gtest.h"
+#include "third_party/zstd/zstd_crashpad.h"
+#include "util/net/http_body.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Decompresses with the window limit that RFC 9659 places on decoders of the
+// zstd content coding, so that a frame needing a larger window fails.
+void ZstdDecompress(const std::string& compressed, std::string* decompressed) {
+  decompressed->clear();
+
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(ZSTD_createDCtx(),
+                                                             ZSTD_freeDCtx);
+  ASSERT_TRUE(dctx);
+  size_t result = ZSTD_DCtx_setParameter(dctx.get(), ZSTD_d_windowLogMax, 23);
+  ASSERT_FALSE(ZSTD_isError(result)) << ZSTD_getErrorName(result);
+
+  ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+  char buf[4096];
+  do {
+    ZSTD_outBuffer output = {buf, sizeof(buf), 0};
+    result = ZSTD_decompressStream(dctx.get(), &output, &input);
+    ASSERT_FALSE(ZSTD_isError(result))
+        << "ZSTD_decompressStream: " << ZSTD_getErrorName(result);
+    decompressed->append(buf, output.pos);
+  } while (result != 0);
+  EXPECT_EQ(input.pos, input.size);
+}
+
+void TestZstdCompressDecompress(const std::string& string,
+                                int compression_level,
+                                bool long_distance_matching) {
+  std::unique_ptr<HTTPBodyStream> string_stream(
+      new StringHTTPBodyStream(string));
+  ZstdHTTPBodyStream zstd_stream(
+      compression_level, long_distance_matching, std::move(string_stream));
+
+  auto buf =
+      base::HeapArray<uint8_t>::Uninit(ZSTD_compressBound(string.size()));
+  FileOperationResult compressed_bytes =
+      zstd_stream.GetBytesBuffer(buf.data(), buf.size());
+  ASSERT_NE(compressed_bytes, -1);
+  ASSERT_LE(static_cast<size_t>(compressed_bytes), buf.size());
+
+  // Make sure that the stream is really at EOF.
+  uint8_t eof_buf[16];
+  ASSERT_EQ(zstd_stream.GetBytesBuffer(eof_buf, sizeof(eof_buf)), 0);
+
+  std::string compressed(reinterpret_cast<char*>(buf.data()), compressed_bytes);
+
+  // The frame magic number, per RFC 8878.
+  ASSERT_GE(compressed.size(), 4u);
+  EXPECT_EQ(compressed.substr(0, 4), std::string("\x28\xb5\x2f\xfd"));
+
+  std::string decompressed;
+  ASSERT_NO_FATAL_FAILURE(ZstdDecompress(compressed, &decompressed));
+  EXPECT_EQ(decompressed, string);
+
+  // Reading in smaller blocks should produce a stream that decompresses to the
+  // same data.
+  string_stream.reset(new StringHTTPBodyStream(string));
+  ZstdHTTPBodyStream block_zstd_stream(
+      compression_level, long_distance_matching, std::move(string_stream));
+  uint8_t block_buf[100];
+  std::string block_compressed;
+  FileOperationResult block_compressed_bytes;
+  while ((block_compressed_bytes = block_zstd_stream.GetBytesBuffer(
+              block_buf, sizeof(block_buf))) > 0) {
+    block_compressed.append(reinterpret_cast<char*>(block_buf),
+                            block_compressed_bytes);
+  }
+  ASSERT_EQ(block_compressed_bytes, 0);
+  ASSERT_NO_FATAL_FAILURE(ZstdDecompress(block_compressed, &decompressed));
+  EXPECT_EQ(decompressed, string);
+}
+
+void TestZstdCompressDecompress(const std::string& string) {
+  TestZstdCompressDecompress(string, 0, false);
+}
+
+std::string MakeString(size_t size) {
+  std::string string;
+  for (size_t i = 0; i < size; ++i) {
+    string.append(1, static_cast<char>((i % 256) ^ ((i >> 8) % 256)));
+  }
+  return string;
+}
+
+constexpr size_t kFourKBytes = 4096;
+constexpr size_t kManyBytes = 375017;
+
+TEST(ZstdHTTPBodyStream, Empty) {
+  TestZstdCompressDecompress(std::string());
+}
+
+TEST(ZstdHTTPBodyStream, OneByte) {
+  TestZstdCompressDecompress(std::string("Z"));
+}
+
+TEST(ZstdHTTPBodyStream, FourKBytes_NUL) {
+  TestZstdCompressDecompress(std::string(kFourKBytes, '\0'));
+}
+
+TEST(ZstdHTTPBodyStream, ManyBytes_Deterministic) {
+  TestZstdCompressDecompress(MakeString(kManyBytes));
+}
+
+TEST(ZstdHTTPBodyStream, ManyBytes_Random) {
+  TestZstdCompressDecompress(base::RandBytesAsString(kManyBytes));
+}
+
+TEST(ZstdHTTPBodyStream, LongDistanceMatching) {
+  // Two copies of random data, further apart than a default window.
+  const std::string random = base::RandBytesAsString(kManyBytes);
+  const std::string string =
+      random + std::string(4 * 1024 * 1024, 'x') + random;
+  TestZstdCompressDecompress(string, 1, true);
+}
+
+TEST(ZstdHTTPBodyStream, Reset) {
+  const std::string string = MakeString(kManyBytes);
+  ZstdHTTPBodyStream zstd_stream(
+      0, false, std::make_unique<StringHTTPBodyStream>(string));
+
+  // Stop partway through the stream, then start over.
+  uint8_t buf[100];
+  ASSERT_GT(zstd_stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+  ASSERT_TRUE(zstd_stream.Reset());
+
+  std::string compressed;
+  FileOperationResult compressed_bytes;
+  while ((compressed_bytes = zstd_stream.GetBytesBuffer(buf, sizeof(buf))) >
+         0) {
+    compressed.append(reinterpret_cast<char*>(buf), compressed_bytes);
+  }
+  ASSERT_EQ(compressed_bytes, 0);
+
+  std::string decompressed;
+  ASSERT_NO_FATAL_FAILURE(ZstdDecompress(compressed, &decompressed));
+  EXPECT_EQ(decompressed, string);
+}
+
+TEST(ZstdHTTPBodyStream, UltraCompressionLevel) {
+  TestZstdCompressDecompress(MakeString(kFourKBytes), 22, false);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,110 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_MULTI_TRANSPORT_H_
+#define CRASHPAD_UTIL_NET_HTTP_MULTI_TRANSPORT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace crashpad {
+
+class HTTPTransport;
+
+//! \brief Performs several HTTP requests at the same time on a single thread.
+//!
+//! Each request is made by an HTTPTransport, configured as it would be for
+//! HTTPTransport::ExecuteSynchronously(). Instead of calling that method, the
+//! transport is passed to AddRequest(), and Run() performs every added request
+//! concurrently, without blocking on any one of them, until all are complete.
+//!
+//! This is not supported by every HTTPTransport implementation. Where it isn’t,
+//! Create() returns `nullptr`, and HTTPTransport::ExecuteSynchronously() must
+//! be used instead.
+class HTTPMultiTransport {
+ public:
+  //! \brief The outcome of a request added with AddRequest().
+  enum class Result {
+    //! \brief The request was successful, as defined by
+    //!     HTTPTransport::ExecuteSynchronously().
+    kSuccess,
+
+    //! \brief The request failed.
+    kFailure,
+
+    //! \brief The request was abandoned because Cancel() was called.
+    kCancelled,
+  };
+
+  //! \brief A function called on the thread running Run() when a request
+  //!     completes. It may call AddRequest().
+  using CompletionCallback = std::function<void(Result result)>;
+
+  HTTPMultiTransport(const HTTPMultiTransport&) = delete;
+  HTTPMultiTransport& operator=(const HTTPMultiTransport&) = delete;
+
+  virtual ~HTTPMultiTransport();
+
+  //! \brief Instantiates a concrete HTTPMultiTransport class for the current
+  //!     operating system.
+  //!
+  //! \return A new caller-owned HTTPMultiTransport object, or `nullptr` if
+  //!     concurrent requests aren’t supported.
+  static std::unique_ptr<HTTPMultiTransport> Create();
+
+  //! \brief Adds a request to be performed by Run().
+  //!
+  //! This must be called on the thread that calls Run(), either before calling
+  //! it or from a \a callback.
+  //!
+  //! \param[in] transport An HTTPTransport obtained from
+  //!     HTTPTransport::Create(), configured for the request. It must not be
+  //!     used for anything else, and must remain valid, until \a callback has
+  //!     been called.
+  //! \param[out] response_body On success, this will be set to the HTTP
+  //!     response body. It must remain valid until \a callback has been called.
+  //! \param[in] callback The function to call when the request completes.
+  //!
+  //! \return `true` if the request was added, in which case \a callback will be
+  //!     called exactly once from Run(). `false`, with a message logged, if the
+  //!     request could not be started or Cancel() has been called, in which
+  //!     case \a callback will not be called.
+  virtual bool AddRequest(HTTPTransport* transport,
+                          std::string* response_body,
+                          CompletionCallback callback) = 0;
+
+  //! \brief Performs all added requests, returning when none remain.
+  //!
+  //! If Cancel() is called, this returns promptly, after calling the callbacks
+  //! of the requests that were still in progress with Result::kCancelled.
+  virtual void Run() = 0;
+
+  //! \brief Abandons all requests in progress and prevents new ones.
+  //!
+  //! This may be called from any thread. It takes effect in Run(), and
+  //! permanently: requests added afterwards are refused.
+  virtual void Cancel() = 0;
+
+  //! \return `true` if Cancel() has been called, `false` otherwise. This may be
+  //!     called from any thread.
+  virtual bool IsCancelled() const = 0;
+
+ protected:
+  HTTPMultiTransport();
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_MULTI_TRANSPORT_H_
@@ -0,0 +1,192 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_multi_transport.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "util/net/http_body.h"
+#include "util/net/http_transport.h"
+#include "util/thread/thread.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::unique_ptr<HTTPTransport> CreateTransport(const std::string& url) {
+  std::unique_ptr<HTTPTransport> transport = HTTPTransport::Create();
+  if (!transport) {
+    return nullptr;
+  }
+  transport->SetURL(url);
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>("body"));
+  return transport;
+}
+
+TEST(HTTPMultiTransport, CancelBeforeRun) {
+  std::unique_ptr<HTTPMultiTransport> multi_transport =
+      HTTPMultiTransport::Create();
+  if (!multi_transport) {
+    GTEST_SKIP() << "HTTPMultiTransport not supported";
+  }
+
+  // Nothing listens at port 1, but the request is cancelled before it’s tried.
+  std::unique_ptr<HTTPTransport> transport =
+      CreateTransport("http://127.0.0.1:1/");
+  ASSERT_TRUE(transport);
+  std::string response_body;
+  std::vector<HTTPMultiTransport::Result> results;
+  ASSERT_TRUE(multi_transport->AddRequest(
+      transport.get(),
+      &response_body,
+      [&results](HTTPMultiTransport::Result result) {
+        results.push_back(result);
+      }));
+
+  EXPECT_FALSE(multi_transport->IsCancelled());
+  multi_transport->Cancel();
+  EXPECT_TRUE(multi_transport->IsCancelled());
+  multi_transport->Run();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0], HTTPMultiTransport::Result::kCancelled);
+
+  // Requests are refused once cancelled.
+  EXPECT_FALSE(multi_transport->AddRequest(
+      transport.get(),
+      &response_body,
+      [](HTTPMultiTransport::Result result) { ADD_FAILURE(); }));
+  multi_transport->Run();
+}
+
+TEST(HTTPMultiTransport, ConnectionFailure) {
+  std::unique_ptr<HTTPMultiTransport> multi_transport =
+      HTTPMultiTransport::Create();
+  if (!multi_transport) {
+    GTEST_SKIP() << "HTTPMultiTransport not supported";
+  }
+
+  std::unique_ptr<HTTPTransport> transport =
+      CreateTransport("http://127.0.0.1:1/");
+  ASSERT_TRUE(transport);
+  std::string response_body;
+  std::vector<HTTPMultiTransport::Result> results;
+  ASSERT_TRUE(multi_transport->AddRequest(
+      transport.get(),
+      &response_body,
+      [&results](HTTPMultiTransport::Result result) {
+        results.push_back(result);
+      }));
+  multi_transport->Run();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0], HTTPMultiTransport::Result::kFailure);
+  EXPECT_TRUE(response_body.empty());
+}
+
+#if BUILDFLAG(IS_POSIX)
+
+class CancelThread : public Thread {
+ public:
+  explicit CancelThread(HTTPMultiTransport* multi_transport)
+      : Thread(), multi_transport_(multi_transport) {}
+
+  CancelThread(const CancelThread&) = delete;
+  CancelThread& operator=(const CancelThread&) = delete;
+
+  ~CancelThread() override {}
+
+ private:
+  void ThreadMain() override {
+    // Let the requests get underway.
+    usleep(100000);
+    multi_transport_->Cancel();
+  }
+
+  HTTPMultiTransport* multi_transport_;  // weak
+};
+
+TEST(HTTPMultiTransport, CancelWhileRunning) {
+  std::unique_ptr<HTTPMultiTransport> multi_transport =
+      HTTPMultiTransport::Create();
+  if (!multi_transport) {
+    GTEST_SKIP() << "HTTPMultiTransport not supported";
+  }
+
+  // A server that accepts connections, by way of its backlog, but never
+  // responds.
+  base::ScopedFD server(socket(AF_INET, SOCK_STREAM, 0));
+  ASSERT_TRUE(server.is_valid());
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(bind(server.get(),
+                 reinterpret_cast<sockaddr*>(&address),
+                 sizeof(address)),
+            0);
+  ASSERT_EQ(listen(server.get(), 8), 0);
+  socklen_t address_length = sizeof(address);
+  ASSERT_EQ(getsockname(server.get(),
+                        reinterpret_cast<sockaddr*>(&address),
+                        &address_length),
+            0);
+  const std::string url =
+      base::StringPrintf("http://127.0.0.1:%d/", ntohs(address.sin_port));
+
+  constexpr size_t kRequests = 3;
+  std::vector<std::unique_ptr<HTTPTransport>> transports;
+  std::vector<std::string> response_bodies(kRequests);
+  std::vector<HTTPMultiTransport::Result> results;
+  for (size_t index = 0; index < kRequests; ++index) {
+    transports.push_back(CreateTransport(url));
+    ASSERT_TRUE(transports.back());
+
+    // Without cancellation, the requests would time out after a minute.
+    transports.back()->SetTimeout(60);
+    ASSERT_TRUE(multi_transport->AddRequest(
+        transports.back().get(),
+        &response_bodies[index],
+        [&results](HTTPMultiTransport::Result result) {
+          results.push_back(result);
+        }));
+  }
+
+  CancelThread cancel_thread(multi_transport.get());
+  cancel_thread.Start();
+  multi_transport->Run();
+  cancel_thread.Join();
+
+  ASSERT_EQ(results.size(), kRequests);
+  for (HTTPMultiTransport::Result result : results) {
+    EXPECT_EQ(result, HTTPMultiTransport::Result::kCancelled);
+  }
+}
+
+#endif  // BUILDFLAG(IS_POSIX)
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -21,11 +21,15 @@
 #include <vector>
 
 #include "base/check.h"
-#include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
+#include "util/misc/random_string.h"
 #include "util/net/http_body.h"
 #include "util/net/http_body_gzip.h"
 
+#if defined(CRASHPAD_USE_ZSTD)
+#include "util/net/http_body_zstd.h"
+#endif  // CRASHPAD_USE_ZSTD
+
 namespace crashpad {
 
 namespace {
@@ -46,16 +50,9 @@ std::string GenerateBoundaryString() {
   //
   // This implementation produces a 56-character string with over 190 bits of
   // randomness (62^32 > 2^190).
-  std::string boundary_string = "---MultipartBoundary-";
-  for (int index = 0; index < 32; ++index) {
-    static constexpr char kCharacters[] =
-        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-    int random_value =
-        base::RandInt(0, static_cast<int>(strlen(kCharacters)) - 1);
-    boundary_string += kCharacters[random_value];
-  }
-  boundary_string += "---";
-  return boundary_string;
+  static constexpr char kCharacters[] =
+      "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  return "---MultipartBoundary-" + RandomString(kCharacters, 32) + "---";
 }
 
 // Escapes the specified name to be suitable for the name field of a
@@ -116,7 +113,11 @@ HTTPMultipartBuilder::HTTPMultipartBuilder()
     : boundary_(GenerateBoundaryString()),
       form_data_(),
       file_attachments_(),
-      gzip_enabled_(false) {}
+      gzip_compression_threads_(1),
+      zstd_compression_level_(0),
+      gzip_enabled_(false),
+      zstd_enabled_(false),
+      zstd_long_distance_matching_(false) {}
 
 HTTPMultipartBuilder::~HTTPMultipartBuilder() {
 }
@@ -125,6 +126,20 @@ void HTTPMultipartBuilder::SetGzipEnabled(bool gzip_enabled) {
   gzip_enabled_ = gzip_enabled;
 }
 
+void HTTPMultipartBuilder::SetGzipCompressionThreads(size_t threads) {
+  gzip_compression_threads_ = threads;
+}
+
+#if defined(CRASHPAD_USE_ZSTD)
+void HTTPMultipartBuilder::SetZstdEnabled(bool zstd_enabled,
+                                          int compression_level,
+                                          bool long_distance_matching) {
+  zstd_enabled_ = zstd_enabled;
+  zstd_compression_level_ = compression_level;
+  zstd_long_distance_matching_ = long_distance_matching;
+}
+#endif  // CRASHPAD_USE_ZSTD
+
 void HTTPMultipartBuilder::SetFormData(const std::string& key,
                                        const std::string& value) {
   EraseKey(key);
@@ -141,6 +156,7 @@ void HTTPMultipartBuilder::SetFileAttachment(
   FileAttachment attachment;
   attachment.filename = EncodeMIMEField(upload_file_name);
   attachment.reader = reader;
+  attachment.gzip_compressed = false;
 
   if (content_type.empty()) {
     attachment.content_type = "application/octet-stream";
@@ -152,12 +168,36 @@ void HTTPMultipartBuilder::SetFileAttachment(
   file_attachments_[key] = attachment;
 }
 
+void HTTPMultipartBuilder::SetGzipCompressedFileAttachment(
+    const std::string& key,
+    const std::string& upload_file_name,
+    FileReaderInterface* reader,
+    const std::string& content_type) {
+  SetFileAttachment(key, upload_file_name, reader, content_type);
+  file_attachments_[key].gzip_compressed = true;
+}
+
 std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
-  // The objects inserted into this vector will be owned by the returned
+  // The objects inserted into these vectors will be owned by the returned
   // CompositeHTTPBodyStream. Take care to not early-return without deleting
   // this memory.
   std::vector<HTTPBodyStream*> streams;
 
+  DCHECK(!(gzip_enabled_ && zstd_enabled_));
+
+  // When gzip is enabled, streams holds the parts that still need to be
+  // compressed, and gzip_members holds the gzip members that precede them.
+  // Already-compressed attachments become gzip members of their own.
+  std::vector<HTTPBodyStream*> gzip_members;
+  auto end_gzip_member = [this, &streams, &gzip_members]() {
+    if (!streams.empty()) {
+      gzip_members.push_back(new GzipHTTPBodyStream(
+          std::make_unique<CompositeHTTPBodyStream>(streams),
+          gzip_compression_threads_));
+      streams.clear();
+    }
+  };
+
   for (const auto& pair : form_data_) {
     std::string field = GetFormDataBoundary(boundary_, pair.first);
     field += kBoundaryCRLF;
@@ -175,19 +215,38 @@ std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
         attachment.content_type.c_str(), kBoundaryCRLF);
 
     streams.push_back(new StringHTTPBodyStream(header));
-    streams.push_back(new FileReaderHTTPBodyStream(attachment.reader));
+    if (attachment.gzip_compressed) {
+      DCHECK(gzip_enabled_);
+      end_gzip_member();
+      gzip_members.push_back(new FileReaderHTTPBodyStream(attachment.reader));
+    } else {
+      streams.push_back(new FileReaderHTTPBodyStream(attachment.reader));
+    }
     streams.push_back(new StringHTTPBodyStream(kCRLF));
   }
 
   streams.push_back(
       new StringHTTPBodyStream("--"  + boundary_ + "--" + kCRLF));
 
+  if (!gzip_members.empty()) {
+    end_gzip_member();
+    return std::make_unique<CompositeHTTPBodyStream>(gzip_members);
+  }
+
   auto composite =
       std::unique_ptr<HTTPBodyStream>(new CompositeHTTPBodyStream(streams));
   if (gzip_enabled_) {
     return std::unique_ptr<HTTPBodyStream>(
-        new GzipHTTPBodyStream(std::move(composite)));
+        new GzipHTTPBodyStream(std::move(composite),
+                               gzip_compression_threads_));
+  }
+#if defined(CRASHPAD_USE_ZSTD)
+  if (zstd_enabled_) {
+    return std::make_unique<ZstdHTTPBodyStream>(zstd_compression_level_,
+                                                zstd_long_distance_matching_,
+                                                std::move(composite));
   }
+#endif  // CRASHPAD_USE_ZSTD
   return composite;
 }
 
@@ -199,6 +258,8 @@ void HTTPMultipartBuilder::PopulateContentHeaders(
 
   if (gzip_enabled_) {
     (*http_headers)[kContentEncoding] = "gzip";
+  } else if (zstd_enabled_) {
+    (*http_headers)[kContentEncoding] = "zstd";
   }
 }
 
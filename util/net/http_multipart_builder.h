@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_NET_HTTP_MULTIPART_BUILDER_H_
 #define CRASHPAD_UTIL_NET_HTTP_MULTIPART_BUILDER_H_
 
+#include <stddef.h>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -46,6 +48,33 @@ class HTTPMultipartBuilder {
   //! PopulateContentHeaders() will contain `Content-Encoding: gzip`.
   void SetGzipEnabled(bool gzip_enabled);
 
+  //! \brief Sets the number of threads that `gzip` compression may use.
+  //!
+  //! \param[in] threads The maximum number of threads to compress with, as
+  //!     for GzipHTTPBodyStream. The default is `1`.
+  void SetGzipCompressionThreads(size_t threads);
+
+#if defined(CRASHPAD_USE_ZSTD) || DOXYGEN
+  //! \brief Enables or disables Zstandard compression.
+  //!
+  //! \param[in] zstd_enabled Whether to enable or disable Zstandard
+  //!     compression. This may not be combined with `gzip` compression.
+  //! \param[in] compression_level The Zstandard compression level, as for
+  //!     ZstdHTTPBodyStream.
+  //! \param[in] long_distance_matching Whether to enable long-distance
+  //!     matching, as for ZstdHTTPBodyStream.
+  //!
+  //! When Zstandard compression is enabled, the body stream returned by
+  //! GetBodyStream() will be Zstandard-compressed, and the content headers set
+  //! by PopulateContentHeaders() will contain `Content-Encoding: zstd`.
+  //!
+  //! This method is only available when Crashpad is built with Zstandard
+  //! support.
+  void SetZstdEnabled(bool zstd_enabled,
+                      int compression_level,
+                      bool long_distance_matching);
+#endif  // CRASHPAD_USE_ZSTD || DOXYGEN
+
   //! \brief Sets a `Content-Disposition: form-data` key-value pair.
   //!
   //! \param[in] key The key of the form data, specified as the `name` in the
@@ -71,6 +100,23 @@ class HTTPMultipartBuilder {
                          FileReaderInterface* reader,
                          const std::string& content_type);
 
+  //! \brief Specifies the `gzip`-compressed contents read from \a reader to be
+  //!     uploaded as multipart data, available at `name` of \a
+  //!     upload_file_name.
+  //!
+  //! `gzip` compression must be enabled with SetGzipEnabled(). The contents of
+  //! \a reader are not recompressed. Instead, they are sent as one member of
+  //! the `gzip` body stream returned by GetBodyStream(), with the rest of the
+  //! message compressed into the members around it. The recipient must
+  //! decompress every member of the body to obtain the decompressed contents
+  //! of \a reader in place.
+  //!
+  //! The parameters are the same as those of SetFileAttachment().
+  void SetGzipCompressedFileAttachment(const std::string& key,
+                                       const std::string& upload_file_name,
+                                       FileReaderInterface* reader,
+                                       const std::string& content_type);
+
   //! \brief Generates the HTTPBodyStream for the data currently supplied to
   //!     the builder.
   //!
@@ -88,6 +134,7 @@ class HTTPMultipartBuilder {
     std::string filename;
     std::string content_type;
     FileReaderInterface* reader;
+    bool gzip_compressed;
   };
 
   // Removes elements from both data maps at the specified |key|, to ensure
@@ -97,7 +144,11 @@ class HTTPMultipartBuilder {
   std::string boundary_;
   std::map<std::string, std::string> form_data_;
   std::map<std::string, FileAttachment> file_attachments_;
+  size_t gzip_compression_threads_;
+  int zstd_compression_level_;
   bool gzip_enabled_;
+  bool zstd_enabled_;
+  bool zstd_long_distance_matching_;
 };
 
 }  // namespace crashpad
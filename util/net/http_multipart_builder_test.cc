@@ -21,8 +21,16 @@
 #include "gtest/gtest.h"
 #include "test/gtest_death.h"
 #include "test/test_paths.h"
+#include "util/file/string_file.h"
 #include "util/net/http_body.h"
+#include "util/net/http_body_gzip.h"
 #include "util/net/http_body_test_util.h"
+#include "util/stream/test_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
+
+#if defined(CRASHPAD_USE_ZSTD)
+#include "util/stream/zstd_output_stream.h"
+#endif  // CRASHPAD_USE_ZSTD
 
 namespace crashpad {
 namespace test {
@@ -278,6 +286,105 @@ TEST(HTTPMultipartBuilder, SharedFormDataAndAttachmentKeyNamespace) {
   EXPECT_EQ(lines_it, lines.end());
 }
 
+TEST(HTTPMultipartBuilder, GzipCompressedFileAttachment) {
+  HTTPMultipartBuilder builder;
+  builder.SetGzipEnabled(true);
+
+  static constexpr char kKey[] = "key";
+  static constexpr char kValue[] = "value";
+  builder.SetFormData(kKey, kValue);
+
+  static constexpr char kFileContents[] = "This is a test.";
+  GzipHTTPBodyStream gzip_stream(
+      std::make_unique<StringHTTPBodyStream>(kFileContents));
+  StringFile compressed_file;
+  compressed_file.SetString(ReadStreamToString(&gzip_stream));
+  builder.SetGzipCompressedFileAttachment(
+      "minidump", "minidump.dmp", &compressed_file, "");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(headers["Content-Encoding"], "gzip");
+
+  std::unique_ptr<HTTPBodyStream> body(builder.GetBodyStream());
+  ASSERT_TRUE(body.get());
+  std::string compressed_contents = ReadStreamToString(body.get());
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream zlib_output_stream(ZlibOutputStream::Mode::kDecompress,
+                                      ZlibOutputStream::Format::kGzip,
+                                      std::move(test_output_stream));
+  ASSERT_TRUE(zlib_output_stream.Write(
+      reinterpret_cast<const uint8_t*>(compressed_contents.data()),
+      compressed_contents.size()));
+  ASSERT_TRUE(zlib_output_stream.Flush());
+  const std::vector<uint8_t>& contents = test_output_stream_weak->all_data();
+
+  auto lines = SplitCRLF(std::string(contents.begin(), contents.end()));
+  ASSERT_EQ(lines.size(), 10u);
+  auto lines_it = lines.begin();
+
+  const std::string& boundary = *lines_it++;
+  EXPECT_EQ(*lines_it++, "Content-Disposition: form-data; name=\"key\"");
+  EXPECT_EQ(*lines_it++, "");
+  EXPECT_EQ(*lines_it++, kValue);
+
+  EXPECT_EQ(*lines_it++, boundary);
+  EXPECT_EQ(*lines_it++,
+            "Content-Disposition: form-data; "
+            "name=\"minidump\"; filename=\"minidump.dmp\"");
+  EXPECT_EQ(*lines_it++, "Content-Type: application/octet-stream");
+  EXPECT_EQ(*lines_it++, "");
+  EXPECT_EQ(*lines_it++, kFileContents);
+
+  EXPECT_EQ(*lines_it++, boundary + "--");
+
+  EXPECT_EQ(lines_it, lines.end());
+}
+
+#if defined(CRASHPAD_USE_ZSTD)
+TEST(HTTPMultipartBuilder, ZstdEnabled) {
+  HTTPMultipartBuilder builder;
+  builder.SetZstdEnabled(true, 0, true);
+
+  static constexpr char kKey[] = "key";
+  static constexpr char kValue[] = "value";
+  builder.SetFormData(kKey, kValue);
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(headers["Content-Encoding"], "zstd");
+
+  std::unique_ptr<HTTPBodyStream> body(builder.GetBodyStream());
+  ASSERT_TRUE(body.get());
+  std::string compressed_contents = ReadStreamToString(body.get());
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZstdOutputStream zstd_output_stream(ZstdOutputStream::Mode::kDecompress,
+                                      std::move(test_output_stream));
+  ASSERT_TRUE(zstd_output_stream.Write(
+      reinterpret_cast<const uint8_t*>(compressed_contents.data()),
+      compressed_contents.size()));
+  ASSERT_TRUE(zstd_output_stream.Flush());
+  const std::vector<uint8_t>& contents = test_output_stream_weak->all_data();
+
+  auto lines = SplitCRLF(std::string(contents.begin(), contents.end()));
+  ASSERT_EQ(lines.size(), 5u);
+  auto lines_it = lines.begin();
+
+  const std::string& boundary = *lines_it++;
+  EXPECT_EQ(*lines_it++, "Content-Disposition: form-data; name=\"key\"");
+  EXPECT_EQ(*lines_it++, "");
+  EXPECT_EQ(*lines_it++, kValue);
+
+  EXPECT_EQ(*lines_it++, boundary + "--");
+
+  EXPECT_EQ(lines_it, lines.end());
+}
+#endif  // CRASHPAD_USE_ZSTD
+
 TEST(HTTPMultipartBuilderDeathTest, AssertUnsafeMIMEType) {
   HTTPMultipartBuilder builder;
   FileReader reader;
@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_retry_after.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace crashpad {
+
+namespace {
+
+// Returns the number of days from 1970-01-01 to the given date in the
+// proleptic Gregorian calendar, following
+// https://howardhinnant.github.io/date_algorithms.html#days_from_civil.
+int64_t DaysFromCivil(int64_t year, unsigned int month, unsigned int day) {
+  year -= month <= 2;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const unsigned int year_of_era = static_cast<unsigned int>(year - era * 400);
+  const unsigned int day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned int day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+bool ParseIMFFixdate(const std::string& date, time_t* time) {
+  // Sun, 06 Nov 1994 08:49:37 GMT
+  char day_name[4];
+  unsigned int day;
+  char month_name[4];
+  unsigned int year;
+  unsigned int hour;
+  unsigned int minute;
+  unsigned int second;
+  int consumed = -1;
+  if (sscanf(date.c_str(),
+             "%3[A-Za-z], %2u %3[A-Za-z] %4u %2u:%2u:%2u GMT%n",
+             day_name,
+             &day,
+             month_name,
+             &year,
+             &hour,
+             &minute,
+             &second,
+             &consumed) != 7 ||
+      consumed != static_cast<int>(date.size())) {
+    return false;
+  }
+
+  static constexpr const char* kMonthNames[] = {"Jan",
+                                                "Feb",
+                                                "Mar",
+                                                "Apr",
+                                                "May",
+                                                "Jun",
+                                                "Jul",
+                                                "Aug",
+                                                "Sep",
+                                                "Oct",
+                                                "Nov",
+                                                "Dec"};
+  unsigned int month = 0;
+  while (month < std::size(kMonthNames) &&
+         strcmp(month_name, kMonthNames[month]) != 0) {
+    ++month;
+  }
+  if (month == std::size(kMonthNames)) {
+    return false;
+  }
+  ++month;
+
+  // A leap second (second 60) is permitted, and treated as the start of the
+  // following minute.
+  if (day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+    return false;
+  }
+
+  const int64_t seconds = DaysFromCivil(year, month, day) * 24 * 60 * 60 +
+                          hour * 60 * 60 + minute * 60 + second;
+  if (!base::IsValueInRangeForNumericType<time_t>(seconds)) {
+    return false;
+  }
+
+  *time = static_cast<time_t>(seconds);
+  return true;
+}
+
+}  // namespace
+
+bool ParseHTTPRetryAfter(const std::string& retry_after,
+                         time_t now,
+                         time_t* retry_time) {
+  if (!retry_after.empty() &&
+      retry_after.find_first_not_of("0123456789") == std::string::npos) {
+    // A number of seconds. A value too large to represent is clamped, as it
+    // indicates that the retry should be deferred indefinitely.
+    uint64_t delay;
+    if (!base::StringToUint64(retry_after, &delay)) {
+      delay = std::numeric_limits<uint64_t>::max();
+    }
+    const uint64_t max_delay =
+        static_cast<uint64_t>(std::numeric_limits<time_t>::max() - now);
+    *retry_time = now + static_cast<time_t>(std::min(delay, max_delay));
+    return true;
+  }
+
+  return ParseIMFFixdate(retry_after, retry_time);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,42 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_RETRY_AFTER_H_
+#define CRASHPAD_UTIL_NET_HTTP_RETRY_AFTER_H_
+
+#include <time.h>
+
+#include <string>
+
+namespace crashpad {
+
+//! \brief Interprets the value of an HTTP `Retry-After` header field, following
+//!     RFC 9110 §10.2.3.
+//!
+//! \param[in] retry_after The field value, either a number of seconds to wait
+//!     or an HTTP-date in the IMF-fixdate format, such as
+//!     `"Sun, 06 Nov 1994 08:49:37 GMT"`.
+//! \param[in] now The time at which the response was received, which a number
+//!     of seconds is relative to.
+//! \param[out] retry_time The time after which the request may be retried.
+//!
+//! \return `true` on success, with \a retry_time set. `false` if \a retry_after
+//!     could not be interpreted, in which case \a retry_time is unmodified.
+bool ParseHTTPRetryAfter(const std::string& retry_after,
+                         time_t now,
+                         time_t* retry_time);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_RETRY_AFTER_H_
@@ -0,0 +1,78 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_retry_after.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(HTTPRetryAfter, DelaySeconds) {
+  constexpr time_t kNow = 1000000000;
+  time_t retry_time;
+  ASSERT_TRUE(ParseHTTPRetryAfter("120", kNow, &retry_time));
+  EXPECT_EQ(retry_time, kNow + 120);
+
+  ASSERT_TRUE(ParseHTTPRetryAfter("0", kNow, &retry_time));
+  EXPECT_EQ(retry_time, kNow);
+
+  // A delay too long to represent is clamped.
+  ASSERT_TRUE(ParseHTTPRetryAfter(
+      "999999999999999999999999999999", kNow, &retry_time));
+  EXPECT_GT(retry_time, kNow);
+}
+
+TEST(HTTPRetryAfter, Date) {
+  time_t retry_time;
+  ASSERT_TRUE(
+      ParseHTTPRetryAfter("Sun, 06 Nov 1994 08:49:37 GMT", 0, &retry_time));
+  EXPECT_EQ(retry_time, 784111777);
+
+  ASSERT_TRUE(
+      ParseHTTPRetryAfter("Thu, 01 Jan 1970 00:00:00 GMT", 0, &retry_time));
+  EXPECT_EQ(retry_time, 0);
+
+  ASSERT_TRUE(
+      ParseHTTPRetryAfter("Thu, 29 Feb 2024 23:59:59 GMT", 0, &retry_time));
+  EXPECT_EQ(retry_time, 1709251199);
+}
+
+TEST(HTTPRetryAfter, Invalid) {
+  constexpr time_t kUnmodified = 12345;
+  static constexpr const char* kInvalid[] = {
+      "",
+      "-1",
+      "1.5",
+      " 120",
+      "soon",
+      "Sun, 06 Nov 1994 08:49:37",
+      "Sun, 06 Nov 1994 08:49:37 GMT trailing",
+      "Sun, 06 Foo 1994 08:49:37 GMT",
+      "Sun, 32 Nov 1994 08:49:37 GMT",
+      "Sun, 06 Nov 1994 24:49:37 GMT",
+      "Sunday, 06-Nov-94 08:49:37 GMT",
+  };
+  for (const char* retry_after : kInvalid) {
+    SCOPED_TRACE(retry_after);
+    time_t retry_time = kUnmodified;
+    EXPECT_FALSE(ParseHTTPRetryAfter(retry_after, 0, &retry_time));
+    EXPECT_EQ(retry_time, kUnmodified);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
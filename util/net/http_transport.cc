@@ -14,6 +14,8 @@
 
 #include "util/net/http_transport.h"
 
+#include <strings.h>
+
 #include <utility>
 
 #include "util/net/http_body.h"
@@ -25,7 +27,11 @@ HTTPTransport::HTTPTransport()
       method_("POST"),
       headers_(),
       body_stream_(),
-      timeout_(15.0) {
+      timeout_(15.0),
+      send_buffer_size_(kDefaultSendBufferSize),
+      response_headers_(),
+      response_retry_after_(),
+      response_status_code_(0) {
 }
 
 HTTPTransport::~HTTPTransport() {
@@ -44,6 +50,10 @@ void HTTPTransport::SetHeader(const std::string& header,
   headers_[header] = value;
 }
 
+void HTTPTransport::ClearHeaders() {
+  headers_.clear();
+}
+
 void HTTPTransport::SetBodyStream(std::unique_ptr<HTTPBodyStream> stream) {
   body_stream_ = std::move(stream);
 }
@@ -56,4 +66,28 @@ void HTTPTransport::SetRootCACertificatePath(const base::FilePath& cert) {
   root_ca_certificate_path_ = cert;
 }
 
+void HTTPTransport::SetSendBufferSize(size_t size) {
+  send_buffer_size_ = size;
+}
+
+bool HTTPTransport::GetResponseHeader(const std::string& name,
+                                      std::string* value) const {
+  for (const auto& header : response_headers_) {
+    if (strcasecmp(header.first.c_str(), name.c_str()) == 0) {
+      *value = header.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+void HTTPTransport::SetResponseStatus(int status_code,
+                                      const HTTPHeaders& response_headers) {
+  response_status_code_ = status_code;
+  response_headers_ = response_headers;
+  if (!GetResponseHeader("Retry-After", &response_retry_after_)) {
+    response_retry_after_.clear();
+  }
+}
+
 }  // namespace crashpad
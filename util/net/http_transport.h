@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_NET_HTTP_TRANSPORT_H_
 #define CRASHPAD_UTIL_NET_HTTP_TRANSPORT_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <string>
 
@@ -32,6 +34,13 @@ class HTTPBodyStream;
 //! This class cannot be instantiated directly. A concrete subclass must be
 //! instantiated instead, which provides an implementation to execute the
 //! request that is appropriate for the host operating system.
+//!
+//! An object of this class may be used to execute more than one request, by
+//! calling SetBodyStream() and any other setters needed before each call to
+//! ExecuteSynchronously(). Settings, including headers, persist from one
+//! request to the next. Where the implementation supports it, connections and
+//! TLS sessions are kept between requests and reused for subsequent requests to
+//! the same server.
 class HTTPTransport {
  public:
   HTTPTransport(const HTTPTransport&) = delete;
@@ -63,6 +72,12 @@ class HTTPTransport {
   //! \param[in] value The value to set for the header.
   void SetHeader(const std::string& header, const std::string& value);
 
+  //! \brief Removes all header-value pairs set by SetHeader().
+  //!
+  //! This allows a transport to be reused for a request that should not carry
+  //! the previous request’s header fields.
+  void ClearHeaders();
+
   //! \brief Sets the stream object from which to generate the HTTP body.
   //!
   //! \param[in] stream A HTTPBodyStream, of which this class will take
@@ -84,6 +99,19 @@ class HTTPTransport {
   //!     cert to be used for TLS connections.
   void SetRootCACertificatePath(const base::FilePath& cert);
 
+  //! \brief The default value of SetSendBufferSize().
+  static constexpr size_t kDefaultSendBufferSize = 128 * 1024;
+
+  //! \brief Sets the amount of the request body to read before sending it.
+  //!
+  //! Implementations that send the request themselves gather up to this much
+  //! of the body from its stream, however many reads that takes, and send it
+  //! at once, so that a body stream producing small pieces doesn’t result in
+  //! small writes to the network. Others ignore it.
+  //!
+  //! \param[in] size The size of the buffer, in bytes.
+  void SetSendBufferSize(size_t size);
+
   //! \brief Performs the HTTP request with the configured parameters and waits
   //!     for the execution to complete.
   //!
@@ -92,17 +120,50 @@ class HTTPTransport {
   //!     if the response body is not required.
   //!
   //! \return Whether or not the request was successful, defined as returning
-  //!     a HTTP status code in the range 200-203 (inclusive).
+  //!     a HTTP status code in the range 200-204 (inclusive).
   virtual bool ExecuteSynchronously(std::string* response_body) = 0;
 
+  //! \return The HTTP status code of the response to the most recent request,
+  //!     or `0` if no response was received. This is available whether or not
+  //!     the request was successful.
+  int response_status_code() const { return response_status_code_; }
+
+  //! \return The value of the `Retry-After` header field of the response to
+  //!     the most recent request, or an empty string if the response had no
+  //!     such field or no response was received.
+  const std::string& response_retry_after() const {
+    return response_retry_after_;
+  }
+
+  //! \brief Obtains the value of a header field of the response to the most
+  //!     recent request.
+  //!
+  //! \param[in] name The name of the field, which is matched without regard
+  //!     to case.
+  //! \param[out] value The value of the field. Only valid if this returns
+  //!     `true`.
+  //!
+  //! \return `true` if the response had the field, or `false` if it didn’t or
+  //!     no response was received.
+  bool GetResponseHeader(const std::string& name, std::string* value) const;
+
  protected:
   HTTPTransport();
 
+  //! \brief Records the status of a response, to be returned by
+  //!     response_status_code(), response_retry_after(), and
+  //!     GetResponseHeader().
+  //!
+  //! Implementations call this with `0` and no header fields when beginning a
+  //! request, and again when a response is received.
+  void SetResponseStatus(int status_code, const HTTPHeaders& response_headers);
+
   const std::string& url() const { return url_; }
   const std::string& method() const { return method_; }
   const HTTPHeaders& headers() const { return headers_; }
   HTTPBodyStream* body_stream() const { return body_stream_.get(); }
   double timeout() const { return timeout_; }
+  size_t send_buffer_size() const { return send_buffer_size_; }
   const base::FilePath& root_ca_certificate_path() const {
     return root_ca_certificate_path_;
   }
@@ -114,6 +175,10 @@ class HTTPTransport {
   HTTPHeaders headers_;
   std::unique_ptr<HTTPBodyStream> body_stream_;
   double timeout_;
+  size_t send_buffer_size_;
+  HTTPHeaders response_headers_;
+  std::string response_retry_after_;
+  int response_status_code_;
 };
 
 }  // namespace crashpad
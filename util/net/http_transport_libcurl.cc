@@ -16,11 +16,16 @@
 
 #include <curl/curl.h>
 #include <dlfcn.h>
+#include <stdio.h>
 #include <string.h>
 #include <sys/utsname.h>
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/logging.h"
@@ -32,6 +37,7 @@
 #include "package.h"
 #include "util/misc/no_cfi_icall.h"
 #include "util/net/http_body.h"
+#include "util/net/http_multi_transport.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
@@ -51,6 +57,13 @@ class Libcurl {
     return initialized;
   }
 
+  // The curl_multi procedures are linked separately, because some of those
+  // used are newer than the rest, added in libcurl 7.68.0.
+  static bool MultiInitialized() {
+    static bool initialized = Initialized() && Get()->InitializeMulti();
+    return initialized;
+  }
+
   static void CurlEasyCleanup(CURL* curl) {
     return Get()->curl_easy_cleanup_(curl);
   }
@@ -61,6 +74,10 @@ class Libcurl {
     return Get()->curl_easy_perform_(curl);
   }
 
+  static void CurlEasyReset(CURL* curl) {
+    return Get()->curl_easy_reset_(curl);
+  }
+
   static const char* CurlEasyStrError(CURLcode code) {
     return Get()->curl_easy_strerror_(code);
   }
@@ -90,6 +107,52 @@ class Libcurl {
 
   static char* CurlVersion() { return Get()->curl_version_(); }
 
+  static CURLMcode CurlMultiAddHandle(CURLM* multi, CURL* curl) {
+    return Get()->curl_multi_add_handle_(multi, curl);
+  }
+
+  static CURLMcode CurlMultiCleanup(CURLM* multi) {
+    return Get()->curl_multi_cleanup_(multi);
+  }
+
+  static CURLMsg* CurlMultiInfoRead(CURLM* multi, int* msgs_in_queue) {
+    return Get()->curl_multi_info_read_(multi, msgs_in_queue);
+  }
+
+  static CURLM* CurlMultiInit() { return Get()->curl_multi_init_(); }
+
+  static CURLMcode CurlMultiPerform(CURLM* multi, int* running_handles) {
+    return Get()->curl_multi_perform_(multi, running_handles);
+  }
+
+  static CURLMcode CurlMultiPoll(CURLM* multi,
+                                 struct curl_waitfd extra_fds[],
+                                 unsigned int extra_nfds,
+                                 int timeout_ms,
+                                 int* ret) {
+    return Get()->curl_multi_poll_(
+        multi, extra_fds, extra_nfds, timeout_ms, ret);
+  }
+
+  static CURLMcode CurlMultiRemoveHandle(CURLM* multi, CURL* curl) {
+    return Get()->curl_multi_remove_handle_(multi, curl);
+  }
+
+  template <typename Parameter>
+  static CURLMcode CurlMultiSetOpt(CURLM* multi,
+                                   CURLMoption option,
+                                   Parameter param) {
+    return Get()->curl_multi_setopt_(multi, option, param);
+  }
+
+  static const char* CurlMultiStrError(CURLMcode code) {
+    return Get()->curl_multi_strerror_(code);
+  }
+
+  static CURLMcode CurlMultiWakeup(CURLM* multi) {
+    return Get()->curl_multi_wakeup_(multi);
+  }
+
  private:
   Libcurl() = default;
   ~Libcurl() = delete;
@@ -100,7 +163,7 @@ class Libcurl {
   }
 
   bool Initialize() {
-    void* libcurl = []() {
+    libcurl_ = []() {
       std::vector<std::string> errors;
       for (const auto& lib : {
                "libcurl.so",
@@ -119,22 +182,23 @@ class Libcurl {
       }
       return static_cast<void*>(nullptr);
     }();
-    if (!libcurl) {
+    if (!libcurl_) {
       return false;
     }
 
-#define LINK_OR_RETURN_FALSE(symbol)               \
-  do {                                             \
-    symbol##_.SetPointer(dlsym(libcurl, #symbol)); \
-    if (!symbol##_) {                              \
-      LOG(ERROR) << "dlsym:" << dlerror();         \
-      return false;                                \
-    }                                              \
+#define LINK_OR_RETURN_FALSE(symbol)                \
+  do {                                              \
+    symbol##_.SetPointer(dlsym(libcurl_, #symbol)); \
+    if (!symbol##_) {                               \
+      LOG(ERROR) << "dlsym:" << dlerror();          \
+      return false;                                 \
+    }                                               \
   } while (0);
 
     LINK_OR_RETURN_FALSE(curl_easy_cleanup);
     LINK_OR_RETURN_FALSE(curl_easy_init);
     LINK_OR_RETURN_FALSE(curl_easy_perform);
+    LINK_OR_RETURN_FALSE(curl_easy_reset);
     LINK_OR_RETURN_FALSE(curl_easy_strerror);
     LINK_OR_RETURN_FALSE(curl_easy_getinfo);
     LINK_OR_RETURN_FALSE(curl_easy_setopt);
@@ -143,14 +207,32 @@ class Libcurl {
     LINK_OR_RETURN_FALSE(curl_slist_append);
     LINK_OR_RETURN_FALSE(curl_version);
 
+    return true;
+  }
+
+  bool InitializeMulti() {
+    LINK_OR_RETURN_FALSE(curl_multi_add_handle);
+    LINK_OR_RETURN_FALSE(curl_multi_cleanup);
+    LINK_OR_RETURN_FALSE(curl_multi_info_read);
+    LINK_OR_RETURN_FALSE(curl_multi_init);
+    LINK_OR_RETURN_FALSE(curl_multi_perform);
+    LINK_OR_RETURN_FALSE(curl_multi_poll);
+    LINK_OR_RETURN_FALSE(curl_multi_remove_handle);
+    LINK_OR_RETURN_FALSE(curl_multi_setopt);
+    LINK_OR_RETURN_FALSE(curl_multi_strerror);
+    LINK_OR_RETURN_FALSE(curl_multi_wakeup);
+
 #undef LINK_OR_RETURN_FALSE
 
     return true;
   }
 
+  void* libcurl_ = nullptr;
+
   NoCfiIcall<decltype(curl_easy_cleanup)*> curl_easy_cleanup_;
   NoCfiIcall<decltype(curl_easy_init)*> curl_easy_init_;
   NoCfiIcall<decltype(curl_easy_perform)*> curl_easy_perform_;
+  NoCfiIcall<decltype(curl_easy_reset)*> curl_easy_reset_;
   NoCfiIcall<decltype(curl_easy_strerror)*> curl_easy_strerror_;
   NoCfiIcall<decltype(curl_easy_getinfo)*> curl_easy_getinfo_;
   NoCfiIcall<decltype(curl_easy_setopt)*> curl_easy_setopt_;
@@ -158,6 +240,16 @@ class Libcurl {
   NoCfiIcall<decltype(curl_slist_free_all)*> curl_slist_free_all_;
   NoCfiIcall<decltype(curl_slist_append)*> curl_slist_append_;
   NoCfiIcall<decltype(curl_version)*> curl_version_;
+  NoCfiIcall<decltype(curl_multi_add_handle)*> curl_multi_add_handle_;
+  NoCfiIcall<decltype(curl_multi_cleanup)*> curl_multi_cleanup_;
+  NoCfiIcall<decltype(curl_multi_info_read)*> curl_multi_info_read_;
+  NoCfiIcall<decltype(curl_multi_init)*> curl_multi_init_;
+  NoCfiIcall<decltype(curl_multi_perform)*> curl_multi_perform_;
+  NoCfiIcall<decltype(curl_multi_poll)*> curl_multi_poll_;
+  NoCfiIcall<decltype(curl_multi_remove_handle)*> curl_multi_remove_handle_;
+  NoCfiIcall<decltype(curl_multi_setopt)*> curl_multi_setopt_;
+  NoCfiIcall<decltype(curl_multi_strerror)*> curl_multi_strerror_;
+  NoCfiIcall<decltype(curl_multi_wakeup)*> curl_multi_wakeup_;
 };
 
 std::string UserAgent() {
@@ -261,6 +353,27 @@ std::string CurlErrorMessage(CURLcode curl_err, const std::string& base) {
                             curl_err);
 }
 
+std::string CurlMultiErrorMessage(CURLMcode curlm_err,
+                                  const std::string& base) {
+  return base::StringPrintf("%s: %s (%d)",
+                            base.c_str(),
+                            Libcurl::CurlMultiStrError(curlm_err),
+                            curlm_err);
+}
+
+// curl_easy_init() and curl_multi_init() will do this on the first call if it
+// hasn’t been done yet, but not in a thread-safe way as is done here.
+bool CurlGlobalInit() {
+  static CURLcode curl_global_init_err = []() {
+    return Libcurl::CurlGlobalInit(CURL_GLOBAL_DEFAULT);
+  }();
+  if (curl_global_init_err != CURLE_OK) {
+    LOG(ERROR) << CurlErrorMessage(curl_global_init_err, "curl_global_init");
+    return false;
+  }
+  return true;
+}
+
 struct ScopedCURLTraits {
   static CURL* InvalidValue() { return nullptr; }
   static void Free(CURL* curl) {
@@ -286,6 +399,13 @@ class CurlSList {
 
   curl_slist* get() const { return list_; }
 
+  void Reset() {
+    if (list_) {
+      Libcurl::CurlSlistFreeAll(list_);
+      list_ = nullptr;
+    }
+  }
+
   bool Append(const char* data) {
     curl_slist* list = Libcurl::CurlSlistAppend(list_, data);
     if (!list_) {
@@ -329,42 +449,94 @@ class HTTPTransportLibcurl final : public HTTPTransport {
   // HTTPTransport:
   bool ExecuteSynchronously(std::string* response_body) override;
 
+  //! \brief Configures curl() to perform the request, writing the response
+  //!     body to \a response_body.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool PrepareRequest(std::string* response_body);
+
+  //! \brief Determines the result of a request performed by curl() after a
+  //!     call to PrepareRequest().
+  //!
+  //! \param[in] curl_err The result of the transfer.
+  //! \param[in] operation The name of the libcurl function that performed the
+  //!     transfer, for use in log messages.
+  //! \param[in,out] response_body The response body, which is cleared if the
+  //!     request was not successful.
+  //!
+  //! \return Whether the request was successful.
+  bool FinishRequest(CURLcode curl_err,
+                     const char* operation,
+                     std::string* response_body);
+
+  CURL* curl() const { return curl_.get(); }
+
  private:
   static size_t ReadRequestBody(char* buffer,
                                 size_t size,
                                 size_t nitems,
                                 void* userdata);
+  static int SeekRequestBody(void* userdata, curl_off_t offset, int origin);
   static size_t WriteResponseBody(char* buffer,
                                   size_t size,
                                   size_t nitems,
                                   void* userdata);
+  static size_t ReadResponseHeader(char* buffer,
+                                   size_t size,
+                                   size_t nitems,
+                                   void* userdata);
+
+  // Kept between requests so that libcurl can reuse connections, and resume TLS
+  // sessions, to the same server.
+  ScopedCURL curl_;
+
+  // The request header fields, which must outlive the request.
+  CurlSList curl_headers_;
+
+  // The header fields of the response being received.
+  HTTPHeaders response_headers_;
 };
 
-HTTPTransportLibcurl::HTTPTransportLibcurl() : HTTPTransport() {}
+HTTPTransportLibcurl::HTTPTransportLibcurl()
+    : HTTPTransport(), curl_(), curl_headers_(), response_headers_() {}
 
 HTTPTransportLibcurl::~HTTPTransportLibcurl() {}
 
 bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
+  if (!PrepareRequest(response_body)) {
+    return false;
+  }
+
+  // Do it.
+  return FinishRequest(Libcurl::CurlEasyPerform(curl_.get()),
+                       "curl_easy_perform",
+                       response_body);
+}
+
+bool HTTPTransportLibcurl::PrepareRequest(std::string* response_body) {
   DCHECK(body_stream());
 
   response_body->clear();
+  SetResponseStatus(0, HTTPHeaders());
+  response_headers_.clear();
 
-  // curl_easy_init() will do this on the first call if it hasn’t been done yet,
-  // but not in a thread-safe way as is done here.
-  static CURLcode curl_global_init_err = []() {
-    return Libcurl::CurlGlobalInit(CURL_GLOBAL_DEFAULT);
-  }();
-  if (curl_global_init_err != CURLE_OK) {
-    LOG(ERROR) << CurlErrorMessage(curl_global_init_err, "curl_global_init");
+  if (!CurlGlobalInit()) {
     return false;
   }
 
-  CurlSList curl_headers;
-  ScopedCURL curl(Libcurl::CurlEasyInit());
-  if (!curl.get()) {
-    LOG(ERROR) << "curl_easy_init";
-    return false;
+  curl_headers_.Reset();
+  if (curl_.is_valid()) {
+    // Discard the options set for the previous request. This retains the
+    // handle’s open connections and TLS session cache.
+    Libcurl::CurlEasyReset(curl_.get());
+  } else {
+    curl_.reset(Libcurl::CurlEasyInit());
+    if (!curl_.is_valid()) {
+      LOG(ERROR) << "curl_easy_init";
+      return false;
+    }
   }
+  CURL* const curl = curl_.get();
 
 // These macros wrap the repetitive “try something, log an error and return
 // false on failure” pattern. Macros are convenient because the log messages
@@ -387,23 +559,33 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     }                                      \
   } while (false)
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_USERAGENT, UserAgent().c_str());
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_USERAGENT, UserAgent().c_str());
 
   // Accept and automatically decode any encoding that libcurl understands.
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_ACCEPT_ENCODING, "");
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_ACCEPT_ENCODING, "");
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_URL, url().c_str());
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_URL, url().c_str());
 
   if (!root_ca_certificate_path().empty()) {
     TRY_CURL_EASY_SETOPT(
-        curl.get(), CURLOPT_CAINFO, root_ca_certificate_path().value().c_str());
+        curl, CURLOPT_CAINFO, root_ca_certificate_path().value().c_str());
   }
 
   constexpr int kMillisecondsPerSecond = 1E3;
-  TRY_CURL_EASY_SETOPT(curl.get(),
+  TRY_CURL_EASY_SETOPT(curl,
                        CURLOPT_TIMEOUT_MS,
                        static_cast<long>(timeout() * kMillisecondsPerSecond));
 
+  // Negotiate HTTP/2 with HTTPS servers that support it, so that concurrent
+  // requests made by HTTPMultiTransport are multiplexed over one connection,
+  // with their header fields compressed. When a connection to the server is
+  // being established, wait to learn whether it can be multiplexed instead of
+  // opening another. Both are the default in newer versions of libcurl. Older
+  // ones, and ones built without HTTP/2 support, reject these options, and
+  // continue to use HTTP/1.1.
+  Libcurl::CurlEasySetOpt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  Libcurl::CurlEasySetOpt(curl, CURLOPT_PIPEWAIT, 1l);
+
   // If the request body size is known ahead of time, a Content-Length header
   // field will be present. Store that to use as CURLOPT_POSTFIELDSIZE_LARGE,
   // which will both set the Content-Length field in the request header and
@@ -416,14 +598,25 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
       chunked = !base::StringToSizeT(pair.second, &content_length);
       DCHECK(!chunked);
     } else {
-      TRY_CURL_SLIST_APPEND(curl_headers,
+      TRY_CURL_SLIST_APPEND(curl_headers_,
                             (pair.first + ": " + pair.second).c_str());
     }
   }
 
+  // Requests made with other methods, such as PATCH, are sent the way that
+  // libcurl sends PUT requests, but under the requested method’s name.
+  const bool upload = method() != "POST" && method() != "GET" &&
+                      method() != "HEAD";
   if (method() == "POST") {
-    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_POST, 1l);
+    TRY_CURL_EASY_SETOPT(curl, CURLOPT_POST, 1l);
+  } else if (method() == "HEAD") {
+    TRY_CURL_EASY_SETOPT(curl, CURLOPT_NOBODY, 1l);
+  } else if (upload) {
+    TRY_CURL_EASY_SETOPT(curl, CURLOPT_UPLOAD, 1l);
+    TRY_CURL_EASY_SETOPT(curl, CURLOPT_CUSTOMREQUEST, method().c_str());
+  }
 
+  if (method() == "POST" || upload) {
     // By default when sending a POST request, libcurl includes an “Expect:
     // 100-continue” header field. Althogh this header is specified in HTTP/1.1
     // (RFC 2616 §8.2.3, RFC 7231 §5.1.1), even collection servers that claim to
@@ -433,10 +626,10 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     // delay is avoided by telling libcurl not to send this header field at all.
     // The drawback is that certain HTTP error statuses may not be received
     // until after substantial amounts of data have been sent to the server.
-    TRY_CURL_SLIST_APPEND(curl_headers, "Expect:");
+    TRY_CURL_SLIST_APPEND(curl_headers_, "Expect:");
 
     if (chunked) {
-      TRY_CURL_SLIST_APPEND(curl_headers, "Transfer-Encoding: chunked");
+      TRY_CURL_SLIST_APPEND(curl_headers_, "Transfer-Encoding: chunked");
     } else {
       curl_off_t content_length_curl;
       if (!AssignIfInRange(&content_length_curl, content_length)) {
@@ -444,44 +637,52 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
                                          content_length);
         return false;
       }
-      TRY_CURL_EASY_SETOPT(
-          curl.get(), CURLOPT_POSTFIELDSIZE_LARGE, content_length_curl);
+      TRY_CURL_EASY_SETOPT(curl,
+                           upload ? CURLOPT_INFILESIZE_LARGE
+                                  : CURLOPT_POSTFIELDSIZE_LARGE,
+                           content_length_curl);
     }
-  } else if (method() != "GET") {
-    // Untested.
-    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_CUSTOMREQUEST, method().c_str());
   }
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_HTTPHEADER, curl_headers.get());
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_HTTPHEADER, curl_headers_.get());
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_READFUNCTION, ReadRequestBody);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_READDATA, this);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEFUNCTION, WriteResponseBody);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEDATA, response_body);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_READFUNCTION, ReadRequestBody);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_READDATA, this);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_SEEKFUNCTION, SeekRequestBody);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_SEEKDATA, this);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_WRITEFUNCTION, WriteResponseBody);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_WRITEDATA, response_body);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_HEADERFUNCTION, ReadResponseHeader);
+  TRY_CURL_EASY_SETOPT(curl, CURLOPT_HEADERDATA, this);
 
 #undef TRY_CURL_EASY_SETOPT
 #undef TRY_CURL_SLIST_APPEND
 
+  return true;
+}
+
+bool HTTPTransportLibcurl::FinishRequest(CURLcode curl_err,
+                                         const char* operation,
+                                         std::string* response_body) {
   // If a partial response body is received and then a failure occurs, ensure
   // that response_body is cleared.
   ScopedClearString clear_response_body(response_body);
 
-  // Do it.
-  CURLcode curl_err = Libcurl::CurlEasyPerform(curl.get());
   if (curl_err != CURLE_OK) {
-    LOG(ERROR) << CurlErrorMessage(curl_err, "curl_easy_perform");
+    LOG(ERROR) << CurlErrorMessage(curl_err, operation);
     return false;
   }
 
   long status;
   curl_err =
-      Libcurl::CurlEasyGetInfo(curl.get(), CURLINFO_RESPONSE_CODE, &status);
+      Libcurl::CurlEasyGetInfo(curl_.get(), CURLINFO_RESPONSE_CODE, &status);
   if (curl_err != CURLE_OK) {
     LOG(ERROR) << CurlErrorMessage(curl_err, "curl_easy_getinfo");
     return false;
   }
+  SetResponseStatus(static_cast<int>(status), response_headers_);
 
-  if (status != 200) {
+  if (status < 200 || status > 204) {
     LOG(ERROR) << base::StringPrintf("HTTP status %ld", status);
     return false;
   }
@@ -519,6 +720,21 @@ size_t HTTPTransportLibcurl::ReadRequestBody(char* buffer,
   return bytes_read;
 }
 
+// static
+int HTTPTransportLibcurl::SeekRequestBody(void* userdata,
+                                          curl_off_t offset,
+                                          int origin) {
+  HTTPTransportLibcurl* self =
+      reinterpret_cast<HTTPTransportLibcurl*>(userdata);
+
+  // libcurl rewinds the request body to resend it, such as when a reused
+  // connection turns out to have been closed by the server.
+  if (offset != 0 || origin != SEEK_SET || !self->body_stream()->Reset()) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+  return CURL_SEEKFUNC_OK;
+}
+
 // static
 size_t HTTPTransportLibcurl::WriteResponseBody(char* buffer,
                                                size_t size,
@@ -539,6 +755,214 @@ size_t HTTPTransportLibcurl::WriteResponseBody(char* buffer,
   return len;
 }
 
+// static
+size_t HTTPTransportLibcurl::ReadResponseHeader(char* buffer,
+                                                size_t size,
+                                                size_t nitems,
+                                                void* userdata) {
+  HTTPTransportLibcurl* self =
+      reinterpret_cast<HTTPTransportLibcurl*>(userdata);
+
+  // This libcurl callback mimics the silly stdio-style fread() interface: size
+  // and nitems have been separated and must be multiplied.
+  base::CheckedNumeric<size_t> checked_len = base::CheckMul(size, nitems);
+  size_t len = checked_len.ValueOrDefault(std::numeric_limits<size_t>::max());
+
+  // Each header line is delivered separately, including the status line of
+  // every response received, such as an interim “100 Continue” response. Only
+  // the final response’s fields are of interest.
+  std::string line(buffer, len);
+  if (line.compare(0, strlen("HTTP/"), "HTTP/") == 0) {
+    self->response_headers_.clear();
+  } else {
+    size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+      static constexpr char kWhitespace[] = " \t\r\n";
+      size_t begin = line.find_first_not_of(kWhitespace, colon + 1);
+      size_t end = line.find_last_not_of(kWhitespace);
+      self->response_headers_[line.substr(0, colon)] =
+          begin == std::string::npos ? std::string()
+                                     : line.substr(begin, end - begin + 1);
+    }
+  }
+
+  return len;
+}
+
+struct ScopedCURLMTraits {
+  static CURLM* InvalidValue() { return nullptr; }
+  static void Free(CURLM* multi) {
+    if (multi) {
+      CURLMcode curlm_err = Libcurl::CurlMultiCleanup(multi);
+      LOG_IF(ERROR, curlm_err != CURLM_OK)
+          << CurlMultiErrorMessage(curlm_err, "curl_multi_cleanup");
+    }
+  }
+};
+using ScopedCURLM = base::ScopedGeneric<CURLM*, ScopedCURLMTraits>;
+
+class HTTPMultiTransportLibcurl final : public HTTPMultiTransport {
+ public:
+  explicit HTTPMultiTransportLibcurl(ScopedCURLM multi);
+
+  HTTPMultiTransportLibcurl(const HTTPMultiTransportLibcurl&) = delete;
+  HTTPMultiTransportLibcurl& operator=(const HTTPMultiTransportLibcurl&) =
+      delete;
+
+  ~HTTPMultiTransportLibcurl() override;
+
+  // HTTPMultiTransport:
+  bool AddRequest(HTTPTransport* transport,
+                  std::string* response_body,
+                  CompletionCallback callback) override;
+  void Run() override;
+  void Cancel() override;
+  bool IsCancelled() const override;
+
+ private:
+  struct Request {
+    HTTPTransportLibcurl* transport;
+    std::string* response_body;
+    CompletionCallback callback;
+  };
+
+  // Removes every request and calls its callback with result.
+  void AbandonRequests(Result result);
+
+  // Removes the request made with curl and returns it.
+  Request RemoveRequest(CURL* curl);
+
+  // The multi handle also holds the cache of connections, shared by all
+  // requests.
+  ScopedCURLM multi_;
+  std::map<CURL*, Request> requests_;
+  std::atomic<bool> cancelled_;
+};
+
+HTTPMultiTransportLibcurl::HTTPMultiTransportLibcurl(ScopedCURLM multi)
+    : HTTPMultiTransport(),
+      multi_(std::move(multi)),
+      requests_(),
+      cancelled_(false) {}
+
+HTTPMultiTransportLibcurl::~HTTPMultiTransportLibcurl() {
+  DCHECK(requests_.empty());
+}
+
+bool HTTPMultiTransportLibcurl::AddRequest(HTTPTransport* transport,
+                                           std::string* response_body,
+                                           CompletionCallback callback) {
+  if (cancelled_) {
+    LOG(ERROR) << "cancelled";
+    return false;
+  }
+
+  // HTTPTransport::Create() only makes HTTPTransportLibcurl objects in this
+  // configuration.
+  HTTPTransportLibcurl* transport_libcurl =
+      static_cast<HTTPTransportLibcurl*>(transport);
+  if (!transport_libcurl->PrepareRequest(response_body)) {
+    return false;
+  }
+
+  CURL* const curl = transport_libcurl->curl();
+  DCHECK(requests_.find(curl) == requests_.end());
+  CURLMcode curlm_err = Libcurl::CurlMultiAddHandle(multi_.get(), curl);
+  if (curlm_err != CURLM_OK) {
+    LOG(ERROR) << CurlMultiErrorMessage(curlm_err, "curl_multi_add_handle");
+    return false;
+  }
+
+  requests_[curl] = {transport_libcurl, response_body, std::move(callback)};
+  return true;
+}
+
+void HTTPMultiTransportLibcurl::Run() {
+  while (!requests_.empty()) {
+    if (cancelled_) {
+      AbandonRequests(Result::kCancelled);
+      return;
+    }
+
+    int running_handles;
+    CURLMcode curlm_err =
+        Libcurl::CurlMultiPerform(multi_.get(), &running_handles);
+    if (curlm_err != CURLM_OK) {
+      LOG(ERROR) << CurlMultiErrorMessage(curlm_err, "curl_multi_perform");
+      AbandonRequests(Result::kFailure);
+      return;
+    }
+
+    // The messages don’t survive curl_multi_remove_handle(), so collect the
+    // completed transfers before removing any of them.
+    std::vector<std::pair<CURL*, CURLcode>> completed;
+    CURLMsg* message;
+    int messages_in_queue;
+    while ((message = Libcurl::CurlMultiInfoRead(multi_.get(),
+                                                 &messages_in_queue))) {
+      if (message->msg == CURLMSG_DONE) {
+        completed.emplace_back(message->easy_handle, message->data.result);
+      }
+    }
+
+    for (const auto& [curl, curl_err] : completed) {
+      Request request = RemoveRequest(curl);
+      bool success = request.transport->FinishRequest(
+          curl_err, "curl_multi_perform", request.response_body);
+      request.callback(success ? Result::kSuccess : Result::kFailure);
+    }
+
+    if (requests_.empty() || !completed.empty()) {
+      // Either there’s nothing left to do, or a callback may have added a
+      // request that should be started before waiting.
+      continue;
+    }
+
+    // This waits no longer than libcurl’s own timeouts call for, and returns
+    // early when Cancel() calls curl_multi_wakeup().
+    constexpr int kPollTimeoutMilliseconds = 1000;
+    curlm_err = Libcurl::CurlMultiPoll(
+        multi_.get(), nullptr, 0, kPollTimeoutMilliseconds, nullptr);
+    if (curlm_err != CURLM_OK) {
+      LOG(ERROR) << CurlMultiErrorMessage(curlm_err, "curl_multi_poll");
+      AbandonRequests(Result::kFailure);
+      return;
+    }
+  }
+}
+
+void HTTPMultiTransportLibcurl::Cancel() {
+  cancelled_ = true;
+  CURLMcode curlm_err = Libcurl::CurlMultiWakeup(multi_.get());
+  LOG_IF(ERROR, curlm_err != CURLM_OK)
+      << CurlMultiErrorMessage(curlm_err, "curl_multi_wakeup");
+}
+
+bool HTTPMultiTransportLibcurl::IsCancelled() const {
+  return cancelled_;
+}
+
+void HTTPMultiTransportLibcurl::AbandonRequests(Result result) {
+  while (!requests_.empty()) {
+    Request request = RemoveRequest(requests_.begin()->first);
+    request.response_body->clear();
+    request.callback(result);
+  }
+}
+
+HTTPMultiTransportLibcurl::Request HTTPMultiTransportLibcurl::RemoveRequest(
+    CURL* curl) {
+  CURLMcode curlm_err = Libcurl::CurlMultiRemoveHandle(multi_.get(), curl);
+  LOG_IF(ERROR, curlm_err != CURLM_OK)
+      << CurlMultiErrorMessage(curlm_err, "curl_multi_remove_handle");
+
+  auto it = requests_.find(curl);
+  DCHECK(it != requests_.end());
+  Request request = std::move(it->second);
+  requests_.erase(it);
+  return request;
+}
+
 }  // namespace
 
 // static
@@ -547,4 +971,24 @@ std::unique_ptr<HTTPTransport> HTTPTransport::Create() {
       Libcurl::Initialized() ? new HTTPTransportLibcurl() : nullptr);
 }
 
+// static
+std::unique_ptr<HTTPMultiTransport> HTTPMultiTransport::Create() {
+  if (!Libcurl::MultiInitialized() || !CurlGlobalInit()) {
+    return nullptr;
+  }
+
+  ScopedCURLM multi(Libcurl::CurlMultiInit());
+  if (!multi.is_valid()) {
+    LOG(ERROR) << "curl_multi_init";
+    return nullptr;
+  }
+
+  // This is the default in newer versions of libcurl. Without it, requests
+  // are made over connections of their own.
+  Libcurl::CurlMultiSetOpt(
+      multi.get(), CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+  return std::make_unique<HTTPMultiTransportLibcurl>(std::move(multi));
+}
+
 }  // namespace crashpad
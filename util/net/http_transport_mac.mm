@@ -27,6 +27,7 @@
 #include "util/misc/implicit_cast.h"
 #include "util/misc/metrics.h"
 #include "util/net/http_body.h"
+#include "util/net/http_multi_transport.h"
 
 // An implementation of NSInputStream that reads from a
 // crashpad::HTTPBodyStream.
@@ -219,6 +220,7 @@ HTTPTransportMac::~HTTPTransportMac() {
 
 bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
   DCHECK(body_stream());
+  SetResponseStatus(0, HTTPHeaders());
 
   @autoreleasepool {
     NSString* url_ns_string = base::SysUTF8ToNSString(url());
@@ -241,9 +243,12 @@ bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
           forHTTPHeaderField:base::SysUTF8ToNSString(pair.first)];
     }
 
-    NSInputStream* input_stream = [[CrashpadHTTPBodyStreamTransport alloc]
-        initWithBodyStream:body_stream()];
-    [request setHTTPBodyStream:input_stream];
+    // A HEAD request can’t have a body.
+    if (method() != "HEAD") {
+      NSInputStream* input_stream = [[CrashpadHTTPBodyStreamTransport alloc]
+          initWithBodyStream:body_stream()];
+      [request setHTTPBodyStream:input_stream];
+    }
 
     NSURLResponse* response = nil;
     NSError* error = nil;
@@ -274,7 +279,19 @@ bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
       return false;
     }
     NSInteger http_status = [http_response statusCode];
-    if (http_status < 200 || http_status > 203) {
+
+    HTTPHeaders response_headers;
+    NSDictionary* header_fields = [http_response allHeaderFields];
+    for (NSString* field in header_fields) {
+      NSString* value = base::apple::ObjCCast<NSString>(header_fields[field]);
+      if (value) {
+        response_headers[base::SysNSStringToUTF8(field)] =
+            base::SysNSStringToUTF8(value);
+      }
+    }
+    SetResponseStatus(static_cast<int>(http_status), response_headers);
+
+    if (http_status < 200 || http_status > 204) {
       LOG(ERROR) << base::StringPrintf("HTTP status %ld",
                                        implicit_cast<long>(http_status));
       return false;
@@ -296,4 +313,9 @@ std::unique_ptr<HTTPTransport> HTTPTransport::Create() {
   return std::unique_ptr<HTTPTransport>(new HTTPTransportMac());
 }
 
+// static
+std::unique_ptr<HTTPMultiTransport> HTTPMultiTransport::Create() {
+  return nullptr;
+}
+
 }  // namespace crashpad
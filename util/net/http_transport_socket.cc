@@ -14,11 +14,17 @@
 
 #include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/socket.h>
 
+#include <algorithm>
 #include <iterator>
+#include <memory>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -30,6 +36,7 @@
 #include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/net/http_body.h"
+#include "util/net/http_multi_transport.h"
 #include "util/net/http_transport.h"
 #include "util/net/url.h"
 #include "util/stdlib/string_number_conversion.h"
@@ -45,16 +52,61 @@ namespace {
 
 constexpr const char kCRLFTerminator[] = "\r\n";
 
+#if defined(CRASHPAD_USE_BORINGSSL)
+struct ScopedSSLCTXTraits {
+  static SSL_CTX* InvalidValue() { return nullptr; }
+  static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
+};
+using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
+
+struct ScopedSSLSessionTraits {
+  static SSL_SESSION* InvalidValue() { return nullptr; }
+  static void Free(SSL_SESSION* session) { SSL_SESSION_free(session); }
+};
+using ScopedSSLSession =
+    base::ScopedGeneric<SSL_SESSION*, ScopedSSLSessionTraits>;
+#endif  // CRASHPAD_USE_BORINGSSL
+
 class HTTPTransportSocket final : public HTTPTransport {
  public:
-  HTTPTransportSocket() = default;
+  HTTPTransportSocket();
 
   HTTPTransportSocket(const HTTPTransportSocket&) = delete;
   HTTPTransportSocket& operator=(const HTTPTransportSocket&) = delete;
 
-  ~HTTPTransportSocket() override = default;
+  ~HTTPTransportSocket() override;
 
   bool ExecuteSynchronously(std::string* response_body) override;
+
+ private:
+  struct Connection;
+
+  // Returns a connection to the server at hostname and port, reusing the
+  // connection kept from the previous request if it is to the same server and
+  // is still usable. *reused is set to whether the connection was reused.
+  // Returns nullptr on failure, with a message logged.
+  std::unique_ptr<Connection> Connect(const std::string& scheme,
+                                      const std::string& hostname,
+                                      const std::string& port,
+                                      bool* reused);
+
+  // Sends the request on connection and reads the response into
+  // response_body. *keep_alive is set as by ReadResponse().
+  bool SendRequest(Connection* connection,
+                   const std::string& resource,
+                   std::string* response_body,
+                   bool* keep_alive);
+
+  // The connection used for the previous request, if the server permitted it
+  // to be kept alive.
+  std::unique_ptr<Connection> connection_;
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  // Shared by all TLS connections made by this object, so that a session
+  // established by one connection can be resumed by the next.
+  ScopedSSLCTX ssl_ctx_;
+  ScopedSSLSession ssl_session_;
+#endif  // CRASHPAD_USE_BORINGSSL
 };
 
 struct ScopedAddrinfoTraits {
@@ -70,6 +122,16 @@ class Stream {
   virtual bool LoggingWrite(const void* data, size_t size) = 0;
   virtual bool LoggingRead(void* data, size_t size) = 0;
   virtual bool LoggingReadToEOF(std::string* contents) = 0;
+
+  // Returns the number of bytes read from this stream.
+  uint64_t BytesRead() const { return bytes_read_; }
+
+ protected:
+  // Called by implementations when size bytes have been read.
+  void AddBytesRead(size_t size) { bytes_read_ += size; }
+
+ private:
+  uint64_t bytes_read_ = 0;
 };
 
 class FdStream : public Stream {
@@ -80,15 +142,35 @@ class FdStream : public Stream {
   FdStream& operator=(const FdStream&) = delete;
 
   bool LoggingWrite(const void* data, size_t size) override {
-    return LoggingWriteFile(fd_, data, size);
+    // MSG_NOSIGNAL reports a connection closed by the server as EPIPE instead
+    // of raising SIGPIPE, so that the request can be retried.
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+      ssize_t rv = HANDLE_EINTR(send(fd_, bytes, size, MSG_NOSIGNAL));
+      if (rv < 0) {
+        PLOG(ERROR) << "send";
+        return false;
+      }
+      bytes += rv;
+      size -= rv;
+    }
+    return true;
   }
 
   bool LoggingRead(void* data, size_t size) override {
-    return LoggingReadFileExactly(fd_, data, size);
+    if (!LoggingReadFileExactly(fd_, data, size)) {
+      return false;
+    }
+    AddBytesRead(size);
+    return true;
   }
 
   bool LoggingReadToEOF(std::string* result) override {
-    return crashpad::LoggingReadToEOF(fd_, result);
+    if (!crashpad::LoggingReadToEOF(fd_, result)) {
+      return false;
+    }
+    AddBytesRead(result->size());
+    return true;
   }
 
  private:
@@ -103,50 +185,60 @@ class SSLStream : public Stream {
   SSLStream(const SSLStream&) = delete;
   SSLStream& operator=(const SSLStream&) = delete;
 
-  bool Initialize(const base::FilePath& root_cert_path,
-                  int sock,
-                  const std::string& hostname) {
+  static ScopedSSLCTX CreateContext(const base::FilePath& root_cert_path) {
     SSL_library_init();
 
-    ctx_.reset(SSL_CTX_new(TLS_method()));
-    if (!ctx_.is_valid()) {
+    ScopedSSLCTX ctx(SSL_CTX_new(TLS_method()));
+    if (!ctx.is_valid()) {
       LOG(ERROR) << "SSL_CTX_new";
-      return false;
+      return ScopedSSLCTX();
     }
 
-    if (SSL_CTX_set_min_proto_version(ctx_.get(), TLS1_2_VERSION) <= 0) {
+    if (SSL_CTX_set_min_proto_version(ctx.get(), TLS1_2_VERSION) <= 0) {
       LOG(ERROR) << "SSL_CTX_set_min_proto_version";
-      return false;
+      return ScopedSSLCTX();
     }
 
-    SSL_CTX_set_verify(ctx_.get(), SSL_VERIFY_PEER, nullptr);
-    SSL_CTX_set_verify_depth(ctx_.get(), 5);
+    SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER, nullptr);
+    SSL_CTX_set_verify_depth(ctx.get(), 5);
+
+    // Client-side session caching is required in order to be able to resume a
+    // session on a new connection.
+    SSL_CTX_set_session_cache_mode(ctx.get(), SSL_SESS_CACHE_CLIENT);
 
     if (!root_cert_path.empty()) {
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
+              ctx.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return ScopedSSLCTX();
       }
     } else {
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), nullptr, "/etc/ssl/certs") <= 0) {
+              ctx.get(), nullptr, "/etc/ssl/certs") <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return ScopedSSLCTX();
       }
 #elif BUILDFLAG(IS_FUCHSIA)
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
+              ctx.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return ScopedSSLCTX();
       }
 #else
 #error cert store location
 #endif
     }
 
-    ssl_.reset(SSL_new(ctx_.get()));
+    return ctx;
+  }
+
+  //! \param[in] session A session to attempt to resume, or `nullptr`.
+  bool Initialize(SSL_CTX* ctx,
+                  int sock,
+                  const std::string& hostname,
+                  SSL_SESSION* session) {
+    ssl_.reset(SSL_new(ctx));
     if (!ssl_.is_valid()) {
       LOG(ERROR) << "SSL_new";
       return false;
@@ -166,6 +258,10 @@ class SSLStream : public Stream {
       return false;
     }
 
+    if (session && SSL_set_session(ssl_.get(), session) == 0) {
+      LOG(WARNING) << "SSL_set_session";
+    }
+
     if (SSL_connect(ssl_.get()) <= 0) {
       LOG(ERROR) << "SSL_connect";
       return false;
@@ -179,7 +275,11 @@ class SSLStream : public Stream {
   }
 
   bool LoggingRead(void* data, size_t size) override {
-    return SSL_read(ssl_.get(), data, size) != 0;
+    if (SSL_read(ssl_.get(), data, size) == 0) {
+      return false;
+    }
+    AddBytesRead(size);
+    return true;
   }
 
   bool LoggingReadToEOF(std::string* contents) override {
@@ -189,6 +289,7 @@ class SSLStream : public Stream {
     while ((rv = SSL_read(ssl_.get(), buffer, sizeof(buffer))) > 0) {
       DCHECK_LE(static_cast<size_t>(rv), sizeof(buffer));
       contents->append(buffer, rv);
+      AddBytesRead(rv);
     }
     if (rv < 0) {
       LOG(ERROR) << "SSL_read";
@@ -198,13 +299,13 @@ class SSLStream : public Stream {
     return true;
   }
 
- private:
-  struct ScopedSSLCTXTraits {
-    static SSL_CTX* InvalidValue() { return nullptr; }
-    static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
-  };
-  using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
+  //! \brief Returns the session negotiated on this connection, which may be
+  //!     used to resume it on another connection, or `nullptr`.
+  ScopedSSLSession Session() {
+    return ScopedSSLSession(SSL_get1_session(ssl_.get()));
+  }
 
+ private:
   struct ScopedSSLTraits {
     static SSL* InvalidValue() { return nullptr; }
     static void Free(SSL* ssl) {
@@ -214,7 +315,6 @@ class SSLStream : public Stream {
   };
   using ScopedSSL = base::ScopedGeneric<SSL*, ScopedSSLTraits>;
 
-  ScopedSSLCTX ctx_;
   ScopedSSL ssl_;
 };
 #endif
@@ -250,6 +350,21 @@ bool WaitUntilSocketIsReady(int sock) {
   return false;
 }
 
+// Returns true if a connection kept from a previous request can be used for
+// another. A usable idle connection has nothing to read: if it is readable, the
+// server has either closed it or sent something unexpected.
+bool IdleSocketIsUsable(int sock) {
+  pollfd pollfds;
+  pollfds.fd = sock;
+  pollfds.events = POLLIN;
+  int ret = HANDLE_EINTR(poll(&pollfds, 1, 0));
+  if (ret < 0) {
+    PLOG(ERROR) << "poll";
+    return false;
+  }
+  return ret == 0;
+}
+
 class ScopedSetNonblocking {
  public:
   explicit ScopedSetNonblocking(int sock) : sock_(sock) {
@@ -309,6 +424,18 @@ base::ScopedFD CreateSocket(const std::string& hostname,
       continue;
     }
 
+    // Requests are written in large blocks, and a straggling partial segment
+    // at the end of one shouldn’t wait for an acknowledgement before being
+    // sent.
+    int nodelay = 1;
+    if (setsockopt(result.get(),
+                   IPPROTO_TCP,
+                   TCP_NODELAY,
+                   &nodelay,
+                   sizeof(nodelay)) < 0) {
+      PLOG(WARNING) << "setsockopt TCP_NODELAY";
+    }
+
     {
       // Set socket to non-blocking to avoid hanging for a long time if the
       // network is down.
@@ -331,112 +458,180 @@ base::ScopedFD CreateSocket(const std::string& hostname,
   return base::ScopedFD();
 }
 
+// Holds back partial segments of data written to a socket until the object is
+// destroyed, so that the request is sent in full-sized segments however it is
+// broken up into writes.
+class ScopedTCPCork {
+ public:
+  explicit ScopedTCPCork(int sock) : sock_(sock) {
+#if defined(TCP_CORK)
+    int cork = 1;
+    if (setsockopt(sock_, IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork)) < 0) {
+      PLOG(WARNING) << "setsockopt TCP_CORK";
+      sock_ = -1;
+    }
+#endif  // TCP_CORK
+  }
+
+  ScopedTCPCork(const ScopedTCPCork&) = delete;
+  ScopedTCPCork& operator=(const ScopedTCPCork&) = delete;
+
+  ~ScopedTCPCork() {
+#if defined(TCP_CORK)
+    int cork = 0;
+    if (sock_ >= 0 &&
+        setsockopt(sock_, IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork)) < 0) {
+      PLOG(WARNING) << "setsockopt TCP_CORK";
+    }
+#endif  // TCP_CORK
+  }
+
+ private:
+  int sock_;
+};
+
 bool WriteRequest(Stream* stream,
                   const std::string& method,
                   const std::string& resource,
                   const HTTPHeaders& headers,
-                  HTTPBodyStream* body_stream) {
-  std::string request_line = base::StringPrintf(
+                  HTTPBodyStream* body_stream,
+                  size_t send_buffer_size) {
+  std::string request = base::StringPrintf(
       "%s %s HTTP/1.0\r\n", method.c_str(), resource.c_str());
-  if (!stream->LoggingWrite(request_line.data(), request_line.size()))
-    return false;
 
-  // Write headers, and determine if Content-Length has been specified.
+  // Add headers, and determine if Content-Length has been specified.
   bool chunked = true;
   size_t content_length = 0;
+  bool connection_specified = false;
   for (const auto& header : headers) {
-    std::string header_str = base::StringPrintf(
-        "%s: %s\r\n", header.first.c_str(), header.second.c_str());
+    request.append(base::StringPrintf(
+        "%s: %s\r\n", header.first.c_str(), header.second.c_str()));
     if (header.first == kContentLength) {
       chunked = !base::StringToSizeT(header.second, &content_length);
       DCHECK(!chunked);
+    } else if (header.first == "Connection") {
+      connection_specified = true;
     }
+  }
 
-    if (!stream->LoggingWrite(header_str.data(), header_str.size()))
-      return false;
+  // Ask the server to keep the connection open after responding, so that it
+  // can be reused for a subsequent request.
+  if (!connection_specified) {
+    request.append("Connection: keep-alive\r\n");
   }
 
   // If no Content-Length, then encode as chunked, so add that header too.
   if (chunked) {
-    static constexpr const char kTransferEncodingChunked[] =
-        "Transfer-Encoding: chunked\r\n";
-    if (!stream->LoggingWrite(kTransferEncodingChunked,
-                              strlen(kTransferEncodingChunked))) {
-      return false;
-    }
+    request.append("Transfer-Encoding: chunked\r\n");
   }
 
-  if (!stream->LoggingWrite(kCRLFTerminator, strlen(kCRLFTerminator))) {
-    return false;
-  }
-
-  FileOperationResult data_bytes;
+  request.append(kCRLFTerminator);
+
+  // The headers are sent along with the first block of the body, and each
+  // block is sent with a single write. buffer has room before the body data
+  // for the headers and a chunk size, and room after it for the chunk’s
+  // trailing CRLF and, following the last block, the zero-length chunk that
+  // signals EOF. The chunk size is presented in hexadecimal without any
+  // leading "0x" or zeroes, so it must fit in kChunkSizeMaxLength digits.
+  // Spans of at least kMinimumDirectWriteSize that the stream holds in memory
+  // are sent without being copied into buffer.
+  constexpr size_t kCRLFSize = std::size(kCRLFTerminator) - 1;
+  constexpr size_t kChunkSizeMaxLength = 8;
+  static constexpr char kLastChunk[] = "0\r\n\r\n";
+  constexpr size_t kLastChunkSize = std::size(kLastChunk) - 1;
+  constexpr size_t kMinimumDirectWriteSize = 16 * 1024;
+  const size_t data_capacity = std::clamp(
+      send_buffer_size, static_cast<size_t>(1), static_cast<size_t>(1) << 30);
+  const size_t data_offset = request.size() + kChunkSizeMaxLength + kCRLFSize;
+  std::unique_ptr<uint8_t[]> buffer(
+      new uint8_t[data_offset + data_capacity + kCRLFSize + kLastChunkSize]);
+
+  bool eof = false;
   do {
-    constexpr size_t kCRLFSize = std::size(kCRLFTerminator) - 1;
-    struct __attribute__((packed)) {
-      char size[8];
-      char crlf[2];
-      uint8_t data[32 * 1024 + kCRLFSize];
-    } buf;
-    static_assert(
-        sizeof(buf) == sizeof(buf.size) + sizeof(buf.crlf) + sizeof(buf.data),
-        "buf should not have padding");
-
-    // Read a block of data.
-    data_bytes =
-        body_stream->GetBytesBuffer(buf.data, sizeof(buf.data) - kCRLFSize);
-    if (data_bytes == -1) {
-      return false;
+    // Read until the buffer is full or the body is exhausted. A large span
+    // that the stream holds in memory is instead sent from there once what
+    // has been gathered so far is sent.
+    size_t data_size = 0;
+    const uint8_t* direct_data = nullptr;
+    size_t direct_size = 0;
+    while (data_size < data_capacity) {
+      uint8_t* const fill = &buffer[data_offset + data_size];
+      const uint8_t* data;
+      FileOperationResult data_bytes =
+          body_stream->GetBytesSpan(fill, data_capacity - data_size, &data);
+      if (data_bytes < 0) {
+        return false;
+      }
+      DCHECK_LE(static_cast<size_t>(data_bytes), data_capacity - data_size);
+      if (data_bytes == 0) {
+        eof = true;
+        break;
+      }
+      if (data != fill) {
+        if (static_cast<size_t>(data_bytes) >= kMinimumDirectWriteSize) {
+          direct_data = data;
+          direct_size = data_bytes;
+          break;
+        }
+        memcpy(fill, data, data_bytes);
+      }
+      data_size += data_bytes;
     }
-    DCHECK_GE(data_bytes, 0);
-    DCHECK_LE(static_cast<size_t>(data_bytes), sizeof(buf.data) - kCRLFSize);
-
-    void* write_start;
-    size_t write_size;
 
+    size_t write_start = data_offset;
+    size_t write_end = data_offset + data_size;
     if (chunked) {
-      // Chunked encoding uses the entirety of buf. buf.size is presented in
-      // hexadecimal without any leading "0x". The terminating CR and LF will be
-      // placed immediately following the used portion of buf.data, even if
-      // buf.data is not full.
-
-      char tmp[9];
-      int rv = snprintf(tmp,
-                        sizeof(tmp),
-                        "%08x",
-                        base::checked_cast<unsigned int>(data_bytes));
-      DCHECK_EQ(static_cast<size_t>(rv), sizeof(buf.size));
-      strncpy(buf.size, tmp, sizeof(buf.size));
-      DCHECK_NE(buf.size[sizeof(buf.size) - 1], '\0');
-
-      memcpy(&buf.crlf[0], kCRLFTerminator, kCRLFSize);
-      memcpy(&buf.data[data_bytes], kCRLFTerminator, kCRLFSize);
-
-      // Skip leading zeroes in the chunk size.
-      size_t size_len;
-      for (size_len = sizeof(buf.size); size_len > 1; --size_len) {
-        if (buf.size[sizeof(buf.size) - size_len] != '0') {
-          break;
-        }
+      // A zero-length chunk must be sent to signal EOF. It’s sent alone if the
+      // body ended exactly at the end of the previous block.
+      if (data_size != 0) {
+        char size[kChunkSizeMaxLength + 1];
+        int size_length = snprintf(size,
+                                   sizeof(size),
+                                   "%x",
+                                   base::checked_cast<unsigned int>(data_size));
+        DCHECK_GT(size_length, 0);
+        DCHECK_LE(static_cast<size_t>(size_length), kChunkSizeMaxLength);
+
+        write_start -= kCRLFSize;
+        memcpy(&buffer[write_start], kCRLFTerminator, kCRLFSize);
+        write_start -= size_length;
+        memcpy(&buffer[write_start], size, size_length);
+        memcpy(&buffer[write_end], kCRLFTerminator, kCRLFSize);
+        write_end += kCRLFSize;
       }
+      if (eof) {
+        memcpy(&buffer[write_end], kLastChunk, kLastChunkSize);
+        write_end += kLastChunkSize;
+      }
+    }
 
-      write_start = static_cast<char*>(buf.crlf) - size_len;
-      write_size = size_len + sizeof(buf.crlf) + data_bytes + kCRLFSize;
-    } else {
-      // When not using chunked encoding, only use buf.data.
-      write_start = buf.data;
-      write_size = data_bytes;
+    if (!request.empty()) {
+      write_start -= request.size();
+      memcpy(&buffer[write_start], request.data(), request.size());
+      request.clear();
     }
 
-    // write_size will be 0 at EOF in non-chunked mode. Skip the write in that
-    // case. In contrast, at EOF in chunked mode, a zero-length chunk must be
-    // sent to signal EOF. This will happen when processing the EOF indicated by
-    // a 0 return from body_stream()->GetBytesBuffer() above.
-    if (write_size != 0) {
-      if (!stream->LoggingWrite(write_start, write_size))
+    // The write will be empty at EOF in non-chunked mode if the body ended
+    // exactly at the end of the previous block, and when a span to be sent
+    // directly was the first thing read into the block.
+    if (write_end != write_start &&
+        !stream->LoggingWrite(&buffer[write_start], write_end - write_start)) {
+      return false;
+    }
+
+    if (direct_size != 0) {
+      if (chunked) {
+        std::string size = base::StringPrintf("%zx\r\n", direct_size);
+        if (!stream->LoggingWrite(size.data(), size.size())) {
+          return false;
+        }
+      }
+      if (!stream->LoggingWrite(direct_data, direct_size) ||
+          (chunked && !stream->LoggingWrite(kCRLFTerminator, kCRLFSize))) {
         return false;
+      }
     }
-  } while (data_bytes > 0);
+  } while (!eof);
 
   return true;
 }
@@ -459,7 +654,7 @@ bool StartsWith(const std::string& str, const char* with, size_t len) {
   return str.compare(0, len, with) == 0;
 }
 
-bool ReadResponseLine(Stream* stream) {
+bool ReadResponseLine(Stream* stream, unsigned int* http_status) {
   std::string response_line;
   if (!ReadLine(stream, &response_line)) {
     LOG(ERROR) << "ReadLine";
@@ -473,10 +668,8 @@ bool ReadResponseLine(Stream* stream) {
       response_line.at(strlen(kHttp10) + 3) != ' ') {
     return false;
   }
-  unsigned int http_status = 0;
   return base::StringToUint(response_line.substr(strlen(kHttp10), 3),
-                            &http_status) &&
-         http_status >= 200 && http_status <= 203;
+                            http_status);
 }
 
 bool ReadResponseHeaders(Stream* stream, HTTPHeaders* headers) {
@@ -510,35 +703,70 @@ bool ReadContentChunked(Stream* stream, std::string* body) {
   return false;
 }
 
-bool ReadResponse(Stream* stream, std::string* response_body) {
+// On success, *keep_alive is set to whether the server permitted the
+// connection to be reused for another request. *http_status and
+// *response_headers are set once the response header has been read, whether or
+// not the status indicates success.
+bool ReadResponse(Stream* stream,
+                  bool head,
+                  std::string* response_body,
+                  bool* keep_alive,
+                  unsigned int* http_status,
+                  HTTPHeaders* response_headers) {
   response_body->clear();
+  *keep_alive = false;
 
-  if (!ReadResponseLine(stream)) {
+  unsigned int status;
+  if (!ReadResponseLine(stream, &status)) {
     return false;
   }
 
-  HTTPHeaders response_headers;
-  if (!ReadResponseHeaders(stream, &response_headers)) {
+  if (!ReadResponseHeaders(stream, response_headers)) {
+    return false;
+  }
+
+  *http_status = status;
+
+  if (status < 200 || status > 204) {
+    LOG(ERROR) << base::StringPrintf("HTTP status %u", status);
     return false;
   }
 
-  auto it = response_headers.find("Content-Length");
-  size_t len = 0;
-  if (it != response_headers.end()) {
+  auto it = response_headers->find("Connection");
+  const bool connection_keep_alive =
+      it != response_headers->end() &&
+      strcasecmp(it->second.c_str(), "keep-alive") == 0;
+  // Neither a response to a HEAD request nor a 204 (No Content) response has a
+  // body, so either leaves the connection at a request boundary.
+  if (head || status == 204) {
+    *keep_alive = connection_keep_alive;
+    return true;
+  }
+
+  it = response_headers->find("Content-Length");
+  if (it != response_headers->end()) {
+    size_t len;
     if (!base::StringToSizeT(it->second, &len)) {
       LOG(ERROR) << "invalid Content-Length";
       return false;
     }
-  }
 
-  if (len) {
-    response_body->resize(len, 0);
-    return stream->LoggingRead(&(*response_body)[0], len);
+    if (len) {
+      response_body->resize(len, 0);
+      if (!stream->LoggingRead(&(*response_body)[0], len)) {
+        return false;
+      }
+    }
+
+    // Only a response whose length is known leaves the connection at a
+    // request boundary.
+    *keep_alive = connection_keep_alive;
+    return true;
   }
 
-  it = response_headers.find("Transfer-Encoding");
+  it = response_headers->find("Transfer-Encoding");
   bool chunked = false;
-  if (it != response_headers.end() && it->second == "chunked") {
+  if (it != response_headers->end() && it->second == "chunked") {
     chunked = true;
   }
 
@@ -546,7 +774,82 @@ bool ReadResponse(Stream* stream, std::string* response_body) {
                  : stream->LoggingReadToEOF(response_body);
 }
 
+struct HTTPTransportSocket::Connection {
+  std::string scheme;
+  std::string hostname;
+  std::string port;
+
+  // sock is declared before stream so that stream, which uses it, is destroyed
+  // first.
+  base::ScopedFD sock;
+  std::unique_ptr<Stream> stream;
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  SSLStream* ssl_stream = nullptr;  // weak, stream when scheme is https
+#endif  // CRASHPAD_USE_BORINGSSL
+};
+
+HTTPTransportSocket::HTTPTransportSocket() = default;
+
+HTTPTransportSocket::~HTTPTransportSocket() = default;
+
+std::unique_ptr<HTTPTransportSocket::Connection> HTTPTransportSocket::Connect(
+    const std::string& scheme,
+    const std::string& hostname,
+    const std::string& port,
+    bool* reused) {
+  *reused = false;
+  if (connection_) {
+    std::unique_ptr<Connection> connection = std::move(connection_);
+    if (connection->scheme == scheme && connection->hostname == hostname &&
+        connection->port == port &&
+        IdleSocketIsUsable(connection->sock.get())) {
+      *reused = true;
+      return connection;
+    }
+  }
+
+  auto connection = std::make_unique<Connection>();
+  connection->scheme = scheme;
+  connection->hostname = hostname;
+  connection->port = port;
+  connection->sock = CreateSocket(hostname, port);
+  if (!connection->sock.is_valid()) {
+    return nullptr;
+  }
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  if (scheme == "https") {
+    if (!ssl_ctx_.is_valid()) {
+      ssl_ctx_ = SSLStream::CreateContext(root_ca_certificate_path());
+      if (!ssl_ctx_.is_valid()) {
+        return nullptr;
+      }
+    }
+
+    auto ssl_stream = std::make_unique<SSLStream>();
+    if (!ssl_stream->Initialize(ssl_ctx_.get(),
+                                connection->sock.get(),
+                                hostname,
+                                ssl_session_.get())) {
+      LOG(ERROR) << "SSLStream Initialize";
+      return nullptr;
+    }
+    connection->ssl_stream = ssl_stream.get();
+    connection->stream = std::move(ssl_stream);
+  } else {
+    connection->stream = std::make_unique<FdStream>(connection->sock.get());
+  }
+#else  // CRASHPAD_USE_BORINGSSL
+  connection->stream = std::make_unique<FdStream>(connection->sock.get());
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  return connection;
+}
+
 bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
+  SetResponseStatus(0, HTTPHeaders());
+
   std::string scheme, hostname, port, resource;
   if (!CrackURL(url(), &scheme, &hostname, &port, &resource)) {
     return false;
@@ -557,40 +860,79 @@ bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
                           << "'";
 #endif
 
-  base::ScopedFD sock(CreateSocket(hostname, port));
-  if (!sock.is_valid()) {
+  bool reused;
+  std::unique_ptr<Connection> connection =
+      Connect(scheme, hostname, port, &reused);
+  if (!connection) {
     return false;
   }
 
-#if defined(CRASHPAD_USE_BORINGSSL)
-  std::unique_ptr<Stream> stream;
-  if (scheme == "https") {
-    auto ssl_stream = std::make_unique<SSLStream>();
-    if (!ssl_stream->Initialize(
-            root_ca_certificate_path(), sock.get(), hostname)) {
-      LOG(ERROR) << "SSLStream Initialize";
+  const uint64_t bytes_read = connection->stream->BytesRead();
+  bool keep_alive;
+  if (!SendRequest(connection.get(), resource, response_body, &keep_alive)) {
+    // The server may close a kept-alive connection at any time, including
+    // after IdleSocketIsUsable() has checked it. A request on such a
+    // connection fails before any of the response arrives, and is retried
+    // once on a new connection.
+    if (!reused || connection->stream->BytesRead() != bytes_read ||
+        !body_stream()->Reset()) {
+      return false;
+    }
+    LOG(WARNING) << "retrying on a new connection";
+
+    connection = Connect(scheme, hostname, port, &reused);
+    if (!connection ||
+        !SendRequest(connection.get(), resource, response_body, &keep_alive)) {
       return false;
     }
-    stream = std::move(ssl_stream);
-  } else {
-    stream = std::make_unique<FdStream>(sock.get());
   }
-#else  // CRASHPAD_USE_BORINGSSL
-  std::unique_ptr<Stream> stream(std::make_unique<FdStream>(sock.get()));
-#endif  // CRASHPAD_USE_BORINGSSL
 
-  if (!WriteRequest(
-          stream.get(), method(), resource, headers(), body_stream())) {
-    return false;
+#if defined(CRASHPAD_USE_BORINGSSL)
+  // Any session tickets have been received by the time the response has been
+  // read.
+  if (connection->ssl_stream) {
+    ScopedSSLSession session = connection->ssl_stream->Session();
+    if (session.is_valid()) {
+      ssl_session_ = std::move(session);
+    }
   }
+#endif  // CRASHPAD_USE_BORINGSSL
 
-  if (!ReadResponse(stream.get(), response_body)) {
-    return false;
+  if (keep_alive) {
+    connection_ = std::move(connection);
   }
 
   return true;
 }
 
+bool HTTPTransportSocket::SendRequest(Connection* connection,
+                                      const std::string& resource,
+                                      std::string* response_body,
+                                      bool* keep_alive) {
+  {
+    ScopedTCPCork cork(connection->sock.get());
+    if (!WriteRequest(connection->stream.get(),
+                      method(),
+                      resource,
+                      headers(),
+                      body_stream(),
+                      send_buffer_size())) {
+      return false;
+    }
+  }
+
+  unsigned int http_status = 0;
+  HTTPHeaders response_headers;
+  bool success = ReadResponse(connection->stream.get(),
+                              method() == "HEAD",
+                              response_body,
+                              keep_alive,
+                              &http_status,
+                              &response_headers);
+  SetResponseStatus(http_status, response_headers);
+  return success;
+}
+
 }  // namespace
 
 // static
@@ -598,4 +940,9 @@ std::unique_ptr<HTTPTransport> HTTPTransport::Create() {
   return std::unique_ptr<HTTPTransportSocket>(new HTTPTransportSocket);
 }
 
+// static
+std::unique_ptr<HTTPMultiTransport> HTTPMultiTransport::Create() {
+  return nullptr;
+}
+
 }  // namespace crashpad
@@ -29,14 +29,26 @@
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "gtest/gtest.h"
+#include "test/errors.h"
 #include "test/multiprocess_exec.h"
 #include "test/test_paths.h"
 #include "util/file/file_io.h"
 #include "util/misc/random_string.h"
 #include "util/net/http_body.h"
 #include "util/net/http_headers.h"
+#include "util/net/http_multi_transport.h"
 #include "util/net/http_multipart_builder.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#include "util/thread/thread.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 namespace test {
 namespace {
@@ -67,7 +79,9 @@ class HTTPTransportTestFixture : public MultiprocessExec {
         response_code_(http_response_code),
         request_validator_(request_validator),
         cert_(),
-        scheme_and_host_() {
+        scheme_and_host_(),
+        send_buffer_size_(HTTPTransport::kDefaultSendBufferSize),
+        use_multi_transport_(false) {
     base::FilePath server_path = TestPaths::Executable().DirName().Append(
         FILE_PATH_LITERAL("http_transport_test_server")
 #if BUILDFLAG(IS_WIN)
@@ -95,6 +109,16 @@ class HTTPTransportTestFixture : public MultiprocessExec {
 
   const HTTPHeaders& headers() { return headers_; }
 
+  void set_send_buffer_size(size_t send_buffer_size) {
+    send_buffer_size_ = send_buffer_size;
+  }
+
+  // Performs the request with HTTPMultiTransport instead of
+  // HTTPTransport::ExecuteSynchronously().
+  void set_use_multi_transport(bool use_multi_transport) {
+    use_multi_transport_ = use_multi_transport;
+  }
+
  private:
   void MultiprocessParent() override {
     // Use Logging*File() instead of Checked*File() so that the test can fail
@@ -132,13 +156,41 @@ class HTTPTransportTestFixture : public MultiprocessExec {
       transport->SetHeader(pair.first, pair.second);
     }
     transport->SetBodyStream(std::move(body_stream_));
+    transport->SetSendBufferSize(send_buffer_size_);
 
     std::string response_body;
-    bool success = transport->ExecuteSynchronously(&response_body);
-    if (response_code_ >= 200 && response_code_ <= 203) {
+    bool success;
+    if (use_multi_transport_) {
+      std::unique_ptr<HTTPMultiTransport> multi_transport =
+          HTTPMultiTransport::Create();
+      ASSERT_TRUE(multi_transport);
+      HTTPMultiTransport::Result result =
+          HTTPMultiTransport::Result::kCancelled;
+      ASSERT_TRUE(multi_transport->AddRequest(
+          transport.get(),
+          &response_body,
+          [&result](HTTPMultiTransport::Result request_result) {
+            result = request_result;
+          }));
+      multi_transport->Run();
+      success = result == HTTPMultiTransport::Result::kSuccess;
+    } else {
+      success = transport->ExecuteSynchronously(&response_body);
+    }
+    EXPECT_EQ(transport->response_status_code(), response_code_);
+    EXPECT_TRUE(transport->response_retry_after().empty());
+    if (response_code_ == 204) {
+      EXPECT_TRUE(success);
+      EXPECT_TRUE(response_body.empty());
+    } else if (response_code_ >= 200 && response_code_ <= 203) {
       EXPECT_TRUE(success);
       std::string expect_response_body = random_string + "\r\n";
       EXPECT_EQ(response_body, expect_response_body);
+
+      // Field names are matched without regard to case.
+      std::string content_type;
+      EXPECT_TRUE(transport->GetResponseHeader("content-type", &content_type));
+      EXPECT_EQ(content_type, "text/plain");
     } else {
       EXPECT_FALSE(success);
       EXPECT_TRUE(response_body.empty());
@@ -163,6 +215,8 @@ class HTTPTransportTestFixture : public MultiprocessExec {
   RequestValidator request_validator_;
   base::FilePath cert_;
   std::string scheme_and_host_;
+  size_t send_buffer_size_;
+  bool use_multi_transport_;
 };
 
 constexpr char kMultipartFormData[] = "multipart/form-data";
@@ -273,6 +327,24 @@ TEST_P(HTTPTransport, ValidFormData_Gzip) {
   test.Run();
 }
 
+TEST_P(HTTPTransport, ValidFormData_MultiTransport) {
+  if (!HTTPMultiTransport::Create()) {
+    GTEST_SKIP() << "HTTPMultiTransport not supported";
+  }
+
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key1", "test");
+  builder.SetFormData("key2", "--abcdefg123");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 200, &ValidFormData);
+  test.set_use_multi_transport(true);
+  test.Run();
+}
+
 constexpr char kTextPlain[] = "text/plain";
 
 void ErrorResponse(HTTPTransportTestFixture* fixture,
@@ -291,6 +363,29 @@ TEST_P(HTTPTransport, ErrorResponse) {
   test.Run();
 }
 
+TEST_P(HTTPTransport, ErrorResponse_MultiTransport) {
+  if (!HTTPMultiTransport::Create()) {
+    GTEST_SKIP() << "HTTPMultiTransport not supported";
+  }
+
+  HTTPMultipartBuilder builder;
+  HTTPHeaders headers;
+  headers[kContentType] = kTextPlain;
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 404, &ErrorResponse);
+  test.set_use_multi_transport(true);
+  test.Run();
+}
+
+TEST_P(HTTPTransport, NoContentResponse) {
+  HTTPMultipartBuilder builder;
+  HTTPHeaders headers;
+  headers[kContentType] = kTextPlain;
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 204, nullptr);
+  test.Run();
+}
+
 constexpr char kTextBody[] = "hello world";
 
 void UnchunkedPlainText(HTTPTransportTestFixture* fixture,
@@ -323,7 +418,9 @@ TEST_P(HTTPTransport, UnchunkedPlainText) {
   test.Run();
 }
 
-void RunUpload33k(const std::string& scheme, bool has_content_length) {
+void RunUpload33k(const std::string& scheme,
+                  bool has_content_length,
+                  size_t send_buffer_size) {
   // On macOS, NSMutableURLRequest winds up calling into a CFReadStream’s Read()
   // callback with a 32kB buffer. Make sure that it’s able to get everything
   // when enough is available to fill this buffer, requiring more than one
@@ -348,17 +445,159 @@ void RunUpload33k(const std::string& scheme, bool has_content_length) {
         size_t body_start = request.rfind("\r\n");
         EXPECT_EQ(request.size() - body_start, 33 * 1024u + 2);
       });
+  test.set_send_buffer_size(send_buffer_size);
   test.Run();
 }
 
 TEST_P(HTTPTransport, Upload33k) {
-  RunUpload33k(GetParam(), true);
+  RunUpload33k(
+      GetParam(), true, crashpad::HTTPTransport::kDefaultSendBufferSize);
 }
 
 TEST_P(HTTPTransport, Upload33k_LengthUnknown) {
   // The same as Upload33k, but without declaring Content-Length ahead of time.
-  RunUpload33k(GetParam(), false);
+  RunUpload33k(
+      GetParam(), false, crashpad::HTTPTransport::kDefaultSendBufferSize);
+}
+
+TEST_P(HTTPTransport, Upload33k_SmallSendBuffer) {
+  // The body is larger than the send buffer, so it’s sent in many blocks.
+  RunUpload33k(GetParam(), true, 1000);
+  RunUpload33k(GetParam(), false, 1000);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+constexpr char kClosedIdleConnectionBody[] = "crash report";
+
+// Stands in for a server whose idle timeout expires just as a request is sent
+// on a kept-alive connection. The first connection is kept alive after the
+// first request, and is closed without a response when the second request
+// arrives on it. The request on the next connection is answered.
+class ClosingIdleConnectionServer final : public Thread {
+ public:
+  ClosingIdleConnectionServer() : Thread(), listen_socket_(), bodies_() {}
+
+  ClosingIdleConnectionServer(const ClosingIdleConnectionServer&) = delete;
+  ClosingIdleConnectionServer& operator=(const ClosingIdleConnectionServer&) =
+      delete;
+
+  ~ClosingIdleConnectionServer() override = default;
+
+  // Listens on a loopback port, returning it, or 0 on failure.
+  uint16_t Listen() {
+    listen_socket_.reset(socket(AF_INET, SOCK_STREAM, 0));
+    if (!listen_socket_.is_valid()) {
+      ADD_FAILURE() << ErrnoMessage("socket");
+      return 0;
+    }
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_size = sizeof(address);
+    if (bind(listen_socket_.get(),
+             reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+        listen(listen_socket_.get(), 2) != 0 ||
+        getsockname(listen_socket_.get(),
+                    reinterpret_cast<sockaddr*>(&address),
+                    &address_size) != 0) {
+      ADD_FAILURE() << ErrnoMessage("bind");
+      return 0;
+    }
+    return ntohs(address.sin_port);
+  }
+
+  // Wakes ThreadMain() if it is still waiting for a connection.
+  void Stop() { shutdown(listen_socket_.get(), SHUT_RDWR); }
+
+  // The bodies of the requests received, valid after Join().
+  const std::vector<std::string>& bodies() const { return bodies_; }
+
+ private:
+  void ThreadMain() override {
+    base::ScopedFD first(
+        HANDLE_EINTR(accept(listen_socket_.get(), nullptr, nullptr)));
+    ASSERT_TRUE(first.is_valid()) << ErrnoMessage("accept");
+    ASSERT_TRUE(ReadRequest(first.get()));
+    ASSERT_TRUE(Respond(first.get()));
+    ASSERT_TRUE(ReadRequest(first.get()));
+    first.reset();
+
+    base::ScopedFD second(
+        HANDLE_EINTR(accept(listen_socket_.get(), nullptr, nullptr)));
+    ASSERT_TRUE(second.is_valid()) << ErrnoMessage("accept");
+    ASSERT_TRUE(ReadRequest(second.get()));
+    ASSERT_TRUE(Respond(second.get()));
+  }
+
+  // Reads the request header, then a body of kClosedIdleConnectionBody’s size.
+  bool ReadRequest(int sock) {
+    std::string header;
+    while (header.size() < 4 ||
+           header.compare(header.size() - 4, 4, "\r\n\r\n") != 0) {
+      char byte;
+      if (!LoggingReadFileExactly(sock, &byte, 1)) {
+        return false;
+      }
+      header.push_back(byte);
+    }
+
+    std::string body(strlen(kClosedIdleConnectionBody), '\0');
+    if (!LoggingReadFileExactly(sock, &body[0], body.size())) {
+      return false;
+    }
+    bodies_.push_back(body);
+    return true;
+  }
+
+  bool Respond(int sock) {
+    static constexpr char kResponse[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Connection: keep-alive\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n"
+        "OK";
+    return LoggingWriteFile(sock, kResponse, strlen(kResponse));
+  }
+
+  base::ScopedFD listen_socket_;
+  std::vector<std::string> bodies_;
+};
+
+TEST(HTTPTransportConnectionReuse, RetryOnClosedIdleConnection) {
+  ClosingIdleConnectionServer server;
+  const uint16_t port = server.Listen();
+  ASSERT_NE(port, 0);
+  server.Start();
+
+  std::unique_ptr<crashpad::HTTPTransport> transport(
+      crashpad::HTTPTransport::Create());
+  ASSERT_TRUE(transport);
+  transport->SetURL(base::StringPrintf("http://127.0.0.1:%u/upload", port));
+  transport->SetHeader(
+      kContentLength,
+      base::StringPrintf("%" PRIuS, strlen(kClosedIdleConnectionBody)));
+
+  // The second request is sent on the kept-alive connection, which the server
+  // closes, and is then resent on a new connection.
+  for (int request = 0; request < 2; ++request) {
+    SCOPED_TRACE(request);
+    transport->SetBodyStream(
+        std::make_unique<StringHTTPBodyStream>(kClosedIdleConnectionBody));
+    std::string response_body;
+    EXPECT_TRUE(transport->ExecuteSynchronously(&response_body));
+    EXPECT_EQ(transport->response_status_code(), 200);
+    EXPECT_EQ(response_body, "OK");
+  }
+
+  transport.reset();
+  server.Stop();
+  server.Join();
+  EXPECT_EQ(server.bodies(),
+            std::vector<std::string>(3, kClosedIdleConnectionBody));
 }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
 // This should be on for Fuchsia, but DX-382. Debug and re-enabled.
 #if defined(CRASHPAD_USE_BORINGSSL) && !BUILDFLAG(IS_FUCHSIA)
@@ -18,9 +18,10 @@
 // which port the server is listening. It will then read one integer from stdin,
 // indicating the response code to be sent in response to a request. It also
 // reads 16 characters from stdin, which, after having "\r\n" appended, will
-// form the response body in a successful response (one with code 200). The
-// server will process one HTTP request, deliver the prearranged response to the
-// client, and write the entire request to stdout. It will then terminate.
+// form the response body in a successful response (one with code 200). A
+// response with code 204 has no body. The server will process one HTTP request,
+// deliver the prearranged response to the client, and write the entire request
+// to stdout. It will then terminate.
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -81,7 +82,7 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
                  if (response_code == 200) {
                    res.set_content(std::string(response, 16) + "\r\n",
                                    "text/plain");
-                 } else {
+                 } else if (response_code != 204) {
                    res.set_content("error", "text/plain");
                  }
 
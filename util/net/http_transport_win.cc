@@ -35,6 +35,7 @@
 #include "package.h"
 #include "util/file/file_io.h"
 #include "util/net/http_body.h"
+#include "util/net/http_multi_transport.h"
 #include "util/numeric/safe_assignment.h"
 #include "util/win/module_version.h"
 
@@ -130,6 +131,76 @@ struct ScopedHINTERNETTraits {
 
 using ScopedHINTERNET = base::ScopedGeneric<HINTERNET, ScopedHINTERNETTraits>;
 
+// Returns the session that every request made by this process is made in, or
+// nullptr on failure. WinHTTP keeps connections open in the session, so
+// sharing it allows requests to reuse them, and with HTTP/2, to be multiplexed
+// over one, even when they’re made concurrently by several threads. The
+// session is never closed.
+HINTERNET Session() {
+  static HINTERNET session = []() {
+    HINTERNET session = WinHttpOpen(base::UTF8ToWide(UserAgent()).c_str(),
+                                    WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                                    WINHTTP_NO_PROXY_NAME,
+                                    WINHTTP_NO_PROXY_BYPASS,
+                                    0);
+    if (!session) {
+      LOG(ERROR) << WinHttpMessage("WinHttpOpen");
+    }
+    return session;
+  }();
+  return session;
+}
+
+// Obtains the header fields of the response to request.
+HTTPHeaders QueryResponseHeaders(HINTERNET request) {
+  HTTPHeaders headers;
+
+  // The first call only obtains the size of the header. The header is a status
+  // line followed by a line for each field, and ends with an empty line.
+  DWORD sizeof_raw_headers = 0;
+  if (WinHttpQueryHeaders(request,
+                          WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                          WINHTTP_HEADER_NAME_BY_INDEX,
+                          WINHTTP_NO_OUTPUT_BUFFER,
+                          &sizeof_raw_headers,
+                          WINHTTP_NO_HEADER_INDEX) ||
+      GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    LOG(ERROR) << WinHttpMessage("WinHttpQueryHeaders");
+    return headers;
+  }
+  std::wstring raw_headers(sizeof_raw_headers / sizeof(wchar_t), L'\0');
+  if (!WinHttpQueryHeaders(request,
+                           WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                           WINHTTP_HEADER_NAME_BY_INDEX,
+                           &raw_headers[0],
+                           &sizeof_raw_headers,
+                           WINHTTP_NO_HEADER_INDEX)) {
+    LOG(ERROR) << WinHttpMessage("WinHttpQueryHeaders");
+    return headers;
+  }
+  raw_headers.resize(sizeof_raw_headers / sizeof(wchar_t));
+
+  const std::string raw_headers_utf8 = base::WideToUTF8(raw_headers);
+  size_t line_start = raw_headers_utf8.find("\r\n");
+  while (line_start != std::string::npos) {
+    line_start += 2;
+    const size_t line_end = raw_headers_utf8.find("\r\n", line_start);
+    const std::string line = raw_headers_utf8.substr(
+        line_start,
+        line_end == std::string::npos ? std::string::npos
+                                      : line_end - line_start);
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+      const size_t value_start = line.find_first_not_of(" \t", colon + 1);
+      headers[line.substr(0, colon)] = value_start == std::string::npos
+                                           ? std::string()
+                                           : line.substr(value_start);
+    }
+    line_start = line_end;
+  }
+  return headers;
+}
+
 class HTTPTransportWin final : public HTTPTransport {
  public:
   HTTPTransportWin();
@@ -149,23 +220,10 @@ HTTPTransportWin::~HTTPTransportWin() {
 }
 
 bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
-  ScopedHINTERNET session(WinHttpOpen(base::UTF8ToWide(UserAgent()).c_str(),
-                                      WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                      WINHTTP_NO_PROXY_NAME,
-                                      WINHTTP_NO_PROXY_BYPASS,
-                                      0));
-  if (!session.get()) {
-    LOG(ERROR) << WinHttpMessage("WinHttpOpen");
-    return false;
-  }
+  SetResponseStatus(0, HTTPHeaders());
 
-  int timeout_in_ms = static_cast<int>(timeout() * 1000);
-  if (!WinHttpSetTimeouts(session.get(),
-                          timeout_in_ms,
-                          timeout_in_ms,
-                          timeout_in_ms,
-                          timeout_in_ms)) {
-    LOG(ERROR) << WinHttpMessage("WinHttpSetTimeouts");
+  HINTERNET session = Session();
+  if (!session) {
     return false;
   }
 
@@ -200,8 +258,8 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
   std::wstring request_target(
       url_path.append(extra_info.substr(0, extra_info.find(L'#'))));
 
-  ScopedHINTERNET connect(WinHttpConnect(
-      session.get(), host_name.c_str(), url_components.nPort, 0));
+  ScopedHINTERNET connect(
+      WinHttpConnect(session, host_name.c_str(), url_components.nPort, 0));
   if (!connect.get()) {
     LOG(ERROR) << WinHttpMessage("WinHttpConnect");
     return false;
@@ -221,6 +279,17 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
+  // The timeouts are set on the request, because the session is shared.
+  int timeout_in_ms = static_cast<int>(timeout() * 1000);
+  if (!WinHttpSetTimeouts(request.get(),
+                          timeout_in_ms,
+                          timeout_in_ms,
+                          timeout_in_ms,
+                          timeout_in_ms)) {
+    LOG(ERROR) << WinHttpMessage("WinHttpSetTimeouts");
+    return false;
+  }
+
   // Add headers to the request.
   //
   // If Content-Length is not provided, implement chunked mode per RFC 7230
@@ -265,8 +334,24 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     }
 
     content_length_dword = WINHTTP_IGNORE_REQUEST_TOTAL_LENGTH;
-  } else if (!AssignIfInRange(&content_length_dword, content_length)) {
-    content_length_dword = WINHTTP_IGNORE_REQUEST_TOTAL_LENGTH;
+  } else {
+    if (!AssignIfInRange(&content_length_dword, content_length)) {
+      content_length_dword = WINHTTP_IGNORE_REQUEST_TOTAL_LENGTH;
+    }
+
+#if defined(WINHTTP_PROTOCOL_FLAG_HTTP2)
+    // Negotiate HTTP/2 with HTTPS servers that support it, so that concurrent
+    // requests are multiplexed over one connection, with their header fields
+    // compressed. This isn’t done for a chunked request body, because this
+    // transport encodes it itself, which HTTP/2 doesn’t allow. Versions of
+    // Windows before Windows 10 1607 don’t support this option, and continue to
+    // use HTTP/1.1.
+    DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+    WinHttpSetOption(request.get(),
+                     WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL,
+                     &protocols,
+                     sizeof(protocols));
+#endif  // WINHTTP_PROTOCOL_FLAG_HTTP2
   }
 
   if (!WinHttpSendRequest(request.get(),
@@ -381,7 +466,10 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
-  if (status_code < 200 || status_code > 203) {
+  SetResponseStatus(static_cast<int>(status_code),
+                    QueryResponseHeaders(request.get()));
+
+  if (status_code < 200 || status_code > 204) {
     LOG(ERROR) << base::StringPrintf("HTTP status %lu", status_code);
     return false;
   }
@@ -416,4 +504,9 @@ std::unique_ptr<HTTPTransport> HTTPTransport::Create() {
   return std::unique_ptr<HTTPTransportWin>(new HTTPTransportWin);
 }
 
+// static
+std::unique_ptr<HTTPMultiTransport> HTTPMultiTransport::Create() {
+  return nullptr;
+}
+
 }  // namespace crashpad
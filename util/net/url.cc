@@ -16,6 +16,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 
@@ -89,4 +91,36 @@ bool CrackURL(const std::string& url,
   return true;
 }
 
+std::string ResolveURL(const std::string& base, const std::string& reference) {
+  static constexpr char kSchemeSeparator[] = "://";
+  const size_t scheme_end = base.find(kSchemeSeparator);
+  if (reference.find(kSchemeSeparator) != std::string::npos ||
+      scheme_end == std::string::npos || reference.empty()) {
+    return reference;
+  }
+
+  if (reference.compare(0, 2, "//") == 0) {
+    return base.substr(0, scheme_end + 1) + reference;
+  }
+
+  const size_t authority_start = scheme_end + strlen(kSchemeSeparator);
+  const size_t path_start = base.find_first_of("/?#", authority_start);
+  if (reference[0] == '/') {
+    return base.substr(0, path_start) + reference;
+  }
+
+  // A relative path replaces the last segment of the base URL’s path.
+  std::string resolved =
+      base.substr(0, base.find_first_of("?#", authority_start));
+  const size_t last_slash = resolved.rfind('/');
+  if (path_start == std::string::npos || last_slash < authority_start ||
+      base[path_start] != '/') {
+    resolved.resize(std::min(resolved.size(), path_start));
+    resolved.append(1, '/');
+  } else {
+    resolved.resize(last_slash + 1);
+  }
+  return resolved + reference;
+}
+
 }  // namespace crashpad
@@ -45,6 +45,21 @@ bool CrackURL(const std::string& url,
               std::string* port,
               std::string* rest);
 
+//! \brief Resolves a URL reference, such as the value of a `Location` header
+//!     field, relative to the URL of the request that it was received for.
+//!
+//! This handles absolute URLs, network-path references (beginning with `//`),
+//! absolute-path references (beginning with `/`), and relative-path
+//! references, following RFC 3986 §5.2. Dot segments in \a reference aren’t
+//! removed, and a reference consisting of only a query or fragment is treated
+//! as a relative path.
+//!
+//! \param[in] base The URL of the request.
+//! \param[in] reference The URL reference.
+//! \return The resolved URL. If \a base isn’t an absolute URL, \a reference
+//!     is returned unchanged.
+std::string ResolveURL(const std::string& base, const std::string& reference);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_NET_URL_H_
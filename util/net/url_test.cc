@@ -127,6 +127,34 @@ TEST(CrackURL, WithURLParams) {
   EXPECT_EQ(rest, "/things?blah=stuff:3");
 }
 
+TEST(ResolveURL, Absolute) {
+  EXPECT_EQ(ResolveURL("https://a.example/files", "http://b.example/x"),
+            "http://b.example/x");
+  EXPECT_EQ(ResolveURL("not a url", "/x"), "/x");
+}
+
+TEST(ResolveURL, NetworkPath) {
+  EXPECT_EQ(ResolveURL("https://a.example/files", "//b.example/x"),
+            "https://b.example/x");
+}
+
+TEST(ResolveURL, AbsolutePath) {
+  EXPECT_EQ(ResolveURL("https://a.example:8080/files/?q=1", "/x/y"),
+            "https://a.example:8080/x/y");
+  EXPECT_EQ(ResolveURL("https://a.example", "/x"), "https://a.example/x");
+  EXPECT_EQ(ResolveURL("https://a.example?q=1", "/x"), "https://a.example/x");
+}
+
+TEST(ResolveURL, RelativePath) {
+  EXPECT_EQ(ResolveURL("https://a.example/files/", "abc"),
+            "https://a.example/files/abc");
+  EXPECT_EQ(ResolveURL("https://a.example/files?q=/1", "abc"),
+            "https://a.example/abc");
+  EXPECT_EQ(ResolveURL("https://a.example", "abc"), "https://a.example/abc");
+  EXPECT_EQ(ResolveURL("https://a.example?q=1", "abc"),
+            "https://a.example/abc");
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
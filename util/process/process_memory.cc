@@ -17,14 +17,73 @@
 #include <string.h>
 
 #include <algorithm>
+#include <limits>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "util/misc/clock.h"
+#include "util/misc/trace_events.h"
 #include "util/numeric/safe_assignment.h"
+#include "util/process/process_memory_accounting.h"
 
 namespace crashpad {
 
+namespace {
+
+// Whether an AccountedRead is recording a read on this thread.
+thread_local bool g_in_accounted_read = false;
+
+// Records a read in a ProcessMemoryAccounting, if there is one, when it goes
+// out of scope. Only the outermost read on a thread is recorded, so that a read
+// implemented with other reads, such as ReadBatchInternal() falling back to
+// Read(), is counted once.
+class AccountedRead {
+ public:
+  explicit AccountedRead(ProcessMemoryAccounting* accounting)
+      : accounting_(g_in_accounted_read ? nullptr : accounting),
+        start_ns_(accounting_ ? ClockMonotonicNanoseconds() : 0),
+        bytes_(0),
+        succeeded_(false) {
+    if (accounting_) {
+      g_in_accounted_read = true;
+    }
+  }
+
+  AccountedRead(const AccountedRead&) = delete;
+  AccountedRead& operator=(const AccountedRead&) = delete;
+
+  ~AccountedRead() {
+    if (accounting_) {
+      accounting_->RecordRead(
+          succeeded_, bytes_, ClockMonotonicNanoseconds() - start_ns_);
+      g_in_accounted_read = false;
+    }
+  }
+
+  // Sets the result of the read, and returns succeeded.
+  bool Finish(bool succeeded, uint64_t bytes) {
+    succeeded_ = succeeded;
+    bytes_ = bytes;
+    return succeeded;
+  }
+
+ private:
+  ProcessMemoryAccounting* accounting_;  // weak
+  uint64_t start_ns_;
+  uint64_t bytes_;
+  bool succeeded_;
+};
+
+}  // namespace
+
 bool ProcessMemory::Read(VMAddress address, VMSize size, void* buffer) const {
+  AccountedRead accounted_read(accounting_);
+  return accounted_read.Finish(ReadUnaccounted(address, size, buffer), size);
+}
+
+bool ProcessMemory::ReadUnaccounted(VMAddress address,
+                                    VMSize size,
+                                    void* buffer) const {
   size_t local_size;
   if (!AssignIfInRange(&local_size, size)) {
     LOG(ERROR) << "size " << size << " out of bounds for size_t";
@@ -49,6 +108,104 @@ bool ProcessMemory::Read(VMAddress address, VMSize size, void* buffer) const {
   return true;
 }
 
+bool ProcessMemory::ReadBatch(const std::vector<ReadRequest>& requests) const {
+  ScopedTraceEvent trace_event("memory", "ReadBatch");
+  AccountedRead accounted_read(accounting_);
+
+  std::vector<ReadRequest> nonempty_requests;
+  nonempty_requests.reserve(requests.size());
+  uint64_t bytes = 0;
+  for (const ReadRequest& request : requests) {
+    size_t local_size;
+    if (!AssignIfInRange(&local_size, request.size)) {
+      LOG(ERROR) << "size " << request.size << " out of bounds for size_t";
+      return accounted_read.Finish(false, 0);
+    }
+    if (local_size > 0) {
+      nonempty_requests.push_back(request);
+      bytes += local_size;
+    }
+  }
+  if (nonempty_requests.empty()) {
+    return accounted_read.Finish(true, 0);
+  }
+  return accounted_read.Finish(ReadBatchInternal(nonempty_requests), bytes);
+}
+
+bool ProcessMemory::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  // Visit the requests in address order so that requests for adjacent or
+  // overlapping regions can be satisfied by a single Read().
+  std::vector<size_t> order(requests.size());
+  for (size_t index = 0; index < order.size(); ++index) {
+    order[index] = index;
+  }
+  std::stable_sort(order.begin(), order.end(), [&requests](size_t a, size_t b) {
+    return requests[a].address < requests[b].address;
+  });
+
+  std::vector<char> coalesced;
+  size_t first = 0;
+  while (first < order.size()) {
+    const ReadRequest& first_request = requests[order[first]];
+    const VMAddress start = first_request.address;
+    if (first_request.size > std::numeric_limits<VMAddress>::max() - start) {
+      LOG(ERROR) << "address " << start << " size " << first_request.size
+                 << " out of range";
+      return false;
+    }
+    VMAddress end = start + first_request.size;
+
+    size_t last = first + 1;
+    while (last < order.size()) {
+      const ReadRequest& request = requests[order[last]];
+      if (request.address > end) {
+        break;
+      }
+      if (request.size > std::numeric_limits<VMAddress>::max() -
+                             request.address) {
+        break;
+      }
+      end = std::max(end, request.address + request.size);
+      ++last;
+    }
+
+    if (last == first + 1) {
+      if (!Read(start, first_request.size, first_request.buffer)) {
+        return false;
+      }
+    } else {
+      size_t coalesced_size;
+      if (!AssignIfInRange(&coalesced_size, end - start)) {
+        LOG(ERROR) << "size " << end - start << " out of bounds for size_t";
+        return false;
+      }
+      coalesced.resize(coalesced_size);
+      if (!Read(start, coalesced_size, coalesced.data())) {
+        return false;
+      }
+      for (size_t index = first; index < last; ++index) {
+        const ReadRequest& request = requests[order[index]];
+        memcpy(request.buffer,
+               coalesced.data() + (request.address - start),
+               static_cast<size_t>(request.size));
+      }
+    }
+
+    first = last;
+  }
+  return true;
+}
+
+bool ProcessMemory::ReadCStringAccounted(VMAddress address,
+                                         bool has_size,
+                                         VMSize size,
+                                         std::string* string) const {
+  AccountedRead accounted_read(accounting_);
+  const bool succeeded = ReadCStringInternal(address, has_size, size, string);
+  return accounted_read.Finish(succeeded, string->size() + 1);
+}
+
 bool ProcessMemory::ReadCStringInternal(VMAddress address,
                                         bool has_size,
                                         VMSize size,
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <string>
+#include <vector>
 
 #include "build/build_config.h"
 #include "util/misc/address_types.h"
@@ -29,11 +30,27 @@ typedef SSIZE_T ssize_t;
 
 namespace crashpad {
 
+class ProcessMemoryAccounting;
+
 //! \brief Abstract base class for accessing the memory of another process.
 //!
 //! Implementations are platform-specific.
 class ProcessMemory {
  public:
+  //! \brief A single region to be copied by ReadBatch().
+  struct ReadRequest {
+    //! \brief The address, in the target process' address space, of the
+    //!     memory region to copy.
+    VMAddress address;
+
+    //! \brief The size, in bytes, of the memory region to copy.
+    VMSize size;
+
+    //! \brief The buffer into which the memory region will be copied. It must
+    //!     be at least #size bytes.
+    void* buffer;
+  };
+
   //! \brief Copies memory from the target process into a caller-provided buffer
   //!     in the current process.
   //!
@@ -48,6 +65,19 @@ class ProcessMemory {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief Copies several memory regions from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! This is equivalent to calling Read() for each element of \a requests, but
+  //! implementations may satisfy all of the requests with fewer system calls.
+  //!
+  //! \param[in] requests The regions to copy and the buffers to copy them into.
+  //!
+  //! \return `true` on success, with every buffer filled appropriately. `false`
+  //!     on failure, with a message logged. On failure, the contents of the
+  //!     buffers are unspecified.
+  bool ReadBatch(const std::vector<ReadRequest>& requests) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -62,7 +92,7 @@ class ProcessMemory {
   //!     failure, with a message logged. Failures can occur, for example, when
   //!     encountering unmapped or unreadable pages.
   bool ReadCString(VMAddress address, std::string* string) const {
-    return ReadCStringInternal(address, false, 0, string);
+    return ReadCStringAccounted(address, false, 0, string);
   }
 
   //! \brief Reads a `NUL`-terminated C string from the target process into a
@@ -81,7 +111,20 @@ class ProcessMemory {
   bool ReadCStringSizeLimited(VMAddress address,
                               VMSize size,
                               std::string* string) const {
-    return ReadCStringInternal(address, true, size, string);
+    return ReadCStringAccounted(address, true, size, string);
+  }
+
+  //! \brief Starts or stops counting the reads made through this object.
+  //!
+  //! Each call to Read(), ReadBatch(), ReadCString(), or
+  //! ReadCStringSizeLimited() is recorded as one read, in the category set on
+  //! the calling thread by ProcessMemoryAccounting::ScopedCategory.
+  //!
+  //! \param[in] accounting The object to record reads in, or `nullptr` to stop
+  //!     counting reads. This object does not take ownership of \a accounting,
+  //!     which must outlive it or be replaced first.
+  void SetAccounting(ProcessMemoryAccounting* accounting) {
+    accounting_ = accounting;
   }
 
   virtual ~ProcessMemory() = default;
@@ -90,6 +133,15 @@ class ProcessMemory {
   ProcessMemory() = default;
 
  private:
+  // Implements Read() without recording the read in accounting_.
+  bool ReadUnaccounted(VMAddress address, VMSize size, void* buffer) const;
+
+  // Calls ReadCStringInternal(), recording the read in accounting_.
+  bool ReadCStringAccounted(VMAddress address,
+                            bool has_size,
+                            VMSize size,
+                            std::string* string) const;
+
   //! \brief Copies memory from the target process into a caller-provided buffer
   //!     in the current process, up to a maximum number of bytes.
   //!
@@ -106,6 +158,21 @@ class ProcessMemory {
                            size_t size,
                            void* buffer) const = 0;
 
+  //! \brief Copies several memory regions from the target process.
+  //!
+  //! The default implementation coalesces requests for adjacent or
+  //! overlapping regions and calls Read() once for each coalesced region.
+  //! Subclasses may override this to service the requests with fewer system
+  //! calls.
+  //!
+  //! \param[in] requests The regions to copy and the buffers to copy them into.
+  //!     No request has a size of 0.
+  //!
+  //! \return `true` on success, with every buffer filled appropriately. `false`
+  //!     on failure, with a message logged.
+  virtual bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -127,8 +194,11 @@ class ProcessMemory {
                                    VMSize size,
                                    std::string* string) const;
 
-  // Allow ProcessMemorySanitized to call ReadUpTo.
+  // Allow ProcessMemoryCaching and ProcessMemorySanitized to call ReadUpTo.
+  friend class ProcessMemoryCaching;
   friend class ProcessMemorySanitized;
+
+  ProcessMemoryAccounting* accounting_ = nullptr;  // weak
 };
 
 }  // namespace crashpad
@@ -0,0 +1,78 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_accounting.h"
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+namespace {
+
+thread_local ProcessMemoryAccounting::ReadCategory g_current_category =
+    ProcessMemoryAccounting::ReadCategory::kOther;
+
+}  // namespace
+
+ProcessMemoryAccounting::ScopedCategory::ScopedCategory(ReadCategory category)
+    : previous_(g_current_category) {
+  g_current_category = category;
+}
+
+ProcessMemoryAccounting::ScopedCategory::~ScopedCategory() {
+  g_current_category = previous_;
+}
+
+ProcessMemoryAccounting::ProcessMemoryAccounting() : counters_() {}
+
+ProcessMemoryAccounting::~ProcessMemoryAccounting() = default;
+
+// static
+ProcessMemoryAccounting::ReadCategory
+ProcessMemoryAccounting::CurrentCategory() {
+  return g_current_category;
+}
+
+void ProcessMemoryAccounting::RecordRead(bool succeeded,
+                                         uint64_t bytes,
+                                         uint64_t duration_ns) {
+  const size_t index = static_cast<size_t>(CurrentCategory());
+  DCHECK_LT(index, kReadCategoryCount);
+  Counters& counters = counters_[index];
+  counters.reads.fetch_add(1, std::memory_order_relaxed);
+  if (succeeded) {
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  } else {
+    counters.failures.fetch_add(1, std::memory_order_relaxed);
+  }
+  counters.duration_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+}
+
+void ProcessMemoryAccounting::GetRemoteReads(
+    CaptureTimings* capture_timings) const {
+  for (size_t index = 0; index < kReadCategoryCount; ++index) {
+    const Counters& counters = counters_[index];
+    CaptureTimings::RemoteReads reads;
+    reads.reads = counters.reads.load(std::memory_order_relaxed);
+    if (!reads.reads) {
+      continue;
+    }
+    reads.bytes = counters.bytes.load(std::memory_order_relaxed);
+    reads.failures = counters.failures.load(std::memory_order_relaxed);
+    reads.duration_ns = counters.duration_ns.load(std::memory_order_relaxed);
+    capture_timings->SetRemoteReads(static_cast<ReadCategory>(index), reads);
+  }
+}
+
+}  // namespace crashpad
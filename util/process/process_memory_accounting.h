@@ -0,0 +1,95 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_ACCOUNTING_H_
+#define CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_ACCOUNTING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "util/misc/capture_timings.h"
+
+namespace crashpad {
+
+//! \brief Counts the reads made through ProcessMemory objects, broken down by
+//!     the category of data being read.
+//!
+//! Reads are attributed to the category set on the reading thread by the
+//! innermost ScopedCategory, or to ReadCategory::kOther if there is none. A
+//! ProcessMemory only records its reads here once
+//! ProcessMemory::SetAccounting() has been called.
+//!
+//! Reads may be recorded from several threads at once.
+class ProcessMemoryAccounting {
+ public:
+  using ReadCategory = CaptureTimings::ReadCategory;
+
+  //! \brief Attributes the reads made on the current thread to a category
+  //!     from construction to destruction.
+  class ScopedCategory {
+   public:
+    //! \param[in] category The category to attribute reads to.
+    explicit ScopedCategory(ReadCategory category);
+
+    ScopedCategory(const ScopedCategory&) = delete;
+    ScopedCategory& operator=(const ScopedCategory&) = delete;
+
+    ~ScopedCategory();
+
+   private:
+    ReadCategory previous_;
+  };
+
+  ProcessMemoryAccounting();
+
+  ProcessMemoryAccounting(const ProcessMemoryAccounting&) = delete;
+  ProcessMemoryAccounting& operator=(const ProcessMemoryAccounting&) = delete;
+
+  ~ProcessMemoryAccounting();
+
+  //! \return The category that reads made on the current thread are
+  //!     attributed to.
+  static ReadCategory CurrentCategory();
+
+  //! \brief Records a read in CurrentCategory().
+  //!
+  //! \param[in] succeeded Whether the read succeeded.
+  //! \param[in] bytes The number of bytes read, if \a succeeded.
+  //! \param[in] duration_ns The time taken by the read, in nanoseconds.
+  void RecordRead(bool succeeded, uint64_t bytes, uint64_t duration_ns);
+
+  //! \brief Sets the reads recorded so far in each category that has any in
+  //!     \a capture_timings, as with CaptureTimings::SetRemoteReads().
+  void GetRemoteReads(CaptureTimings* capture_timings) const;
+
+ private:
+  struct Counters {
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> failures;
+    std::atomic<uint64_t> duration_ns;
+  };
+
+  static constexpr size_t kReadCategoryCount =
+      static_cast<size_t>(ReadCategory::kMaxValue);
+
+  std::array<Counters, kReadCategoryCount> counters_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_ACCOUNTING_H_
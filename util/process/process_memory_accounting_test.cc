@@ -0,0 +1,132 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_accounting.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using ReadCategory = ProcessMemoryAccounting::ReadCategory;
+
+// A ProcessMemory backed by a local buffer. Memory beyond the buffer is
+// unreadable.
+class BufferProcessMemory : public ProcessMemory {
+ public:
+  explicit BufferProcessMemory(const std::string& data) : data_(data) {}
+
+  BufferProcessMemory(const BufferProcessMemory&) = delete;
+  BufferProcessMemory& operator=(const BufferProcessMemory&) = delete;
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    if (address >= data_.size()) {
+      return -1;
+    }
+    const size_t read_size = std::min(size, data_.size() - address);
+    memcpy(buffer, &data_[address], read_size);
+    return read_size;
+  }
+
+  std::string data_;
+};
+
+TEST(ProcessMemoryAccounting, ScopedCategory) {
+  EXPECT_EQ(ProcessMemoryAccounting::CurrentCategory(), ReadCategory::kOther);
+  {
+    ProcessMemoryAccounting::ScopedCategory stack(ReadCategory::kStack);
+    EXPECT_EQ(ProcessMemoryAccounting::CurrentCategory(), ReadCategory::kStack);
+    {
+      ProcessMemoryAccounting::ScopedCategory annotations(
+          ReadCategory::kAnnotations);
+      EXPECT_EQ(ProcessMemoryAccounting::CurrentCategory(),
+                ReadCategory::kAnnotations);
+    }
+    EXPECT_EQ(ProcessMemoryAccounting::CurrentCategory(), ReadCategory::kStack);
+  }
+  EXPECT_EQ(ProcessMemoryAccounting::CurrentCategory(), ReadCategory::kOther);
+}
+
+TEST(ProcessMemoryAccounting, CountsReads) {
+  const std::string data("abcdefgh\0ijklmnop", 17);
+  BufferProcessMemory memory(data);
+
+  // Reads aren’t counted until accounting is set.
+  char buffer[8];
+  ASSERT_TRUE(memory.Read(0, 4, buffer));
+
+  ProcessMemoryAccounting accounting;
+  memory.SetAccounting(&accounting);
+
+  ASSERT_TRUE(memory.Read(0, 4, buffer));
+  {
+    ProcessMemoryAccounting::ScopedCategory category(ReadCategory::kStack);
+    ASSERT_TRUE(memory.Read(4, 4, buffer));
+    EXPECT_FALSE(memory.Read(16, 8, buffer));
+
+    // A batch is counted as a single read, although it’s serviced by reading
+    // each region.
+    std::vector<ProcessMemory::ReadRequest> requests = {
+        {0, 2, buffer}, {8, 2, buffer + 2}, {12, 2, buffer + 4}};
+    ASSERT_TRUE(memory.ReadBatch(requests));
+  }
+  {
+    ProcessMemoryAccounting::ScopedCategory category(
+        ReadCategory::kAnnotations);
+    std::string string;
+    ASSERT_TRUE(memory.ReadCString(0, &string));
+    EXPECT_EQ(string, "abcdefgh");
+  }
+
+  memory.SetAccounting(nullptr);
+  ASSERT_TRUE(memory.Read(0, 4, buffer));
+
+  CaptureTimings timings;
+  accounting.GetRemoteReads(&timings);
+
+  const CaptureTimings::RemoteReads& other =
+      timings.GetRemoteReads(ReadCategory::kOther);
+  EXPECT_EQ(other.reads, 1u);
+  EXPECT_EQ(other.bytes, 4u);
+  EXPECT_EQ(other.failures, 0u);
+
+  const CaptureTimings::RemoteReads& stack =
+      timings.GetRemoteReads(ReadCategory::kStack);
+  EXPECT_EQ(stack.reads, 3u);
+  EXPECT_EQ(stack.bytes, 10u);
+  EXPECT_EQ(stack.failures, 1u);
+
+  const CaptureTimings::RemoteReads& annotations =
+      timings.GetRemoteReads(ReadCategory::kAnnotations);
+  EXPECT_EQ(annotations.reads, 1u);
+  EXPECT_EQ(annotations.bytes, 9u);
+  EXPECT_EQ(annotations.failures, 0u);
+
+  EXPECT_EQ(timings.GetRemoteReads(ReadCategory::kModuleHeaders).reads, 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,205 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_caching.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/page_size.h"
+
+namespace crashpad {
+
+ProcessMemoryCaching::ProcessMemoryCaching()
+    : ProcessMemory(),
+      cached_pages_(),
+      page_index_(),
+      cache_hits_(0),
+      cache_misses_(0),
+      lock_(),
+      memory_(nullptr),
+      page_size_(0),
+      max_cached_pages_(0),
+      initialized_() {}
+
+ProcessMemoryCaching::~ProcessMemoryCaching() {}
+
+bool ProcessMemoryCaching::Initialize(const ProcessMemory* memory,
+                                      size_t max_cached_pages) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  if (max_cached_pages == 0) {
+    LOG(ERROR) << "invalid cache size";
+    return false;
+  }
+  memory_ = memory;
+  page_size_ = base::GetPageSize();
+  max_cached_pages_ = max_cached_pages;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+uint64_t ProcessMemoryCaching::CacheHits() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock_owner(lock_);
+  return cache_hits_;
+}
+
+uint64_t ProcessMemoryCaching::CacheMisses() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock_owner(lock_);
+  return cache_misses_;
+}
+
+ssize_t ProcessMemoryCaching::ReadUpTo(VMAddress address,
+                                       size_t size,
+                                       void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (size > page_size_) {
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+
+  const VMAddress page_address = address & ~VMAddress{page_size_ - 1};
+  const size_t page_offset = address - page_address;
+  const size_t read_size = std::min(size, page_size_ - page_offset);
+
+  base::AutoLock lock_owner(lock_);
+
+  if (CopyFromCachedPage(page_address, page_offset, read_size, buffer)) {
+    return read_size;
+  }
+
+  ++cache_misses_;
+  auto data = base::HeapArray<uint8_t>::Uninit(page_size_);
+  size_t page_bytes_read = 0;
+  while (page_bytes_read < page_size_) {
+    ssize_t bytes_read = memory_->ReadUpTo(page_address + page_bytes_read,
+                                           page_size_ - page_bytes_read,
+                                           data.data() + page_bytes_read);
+    if (bytes_read <= 0) {
+      break;
+    }
+    page_bytes_read += bytes_read;
+  }
+
+  if (page_bytes_read < page_size_) {
+    // Only part of the page was available. Satisfy as much of this read as
+    // possible, but don’t cache the page.
+    if (page_bytes_read <= page_offset) {
+      return memory_->ReadUpTo(address, read_size, buffer);
+    }
+    const size_t partial_size =
+        std::min(read_size, page_bytes_read - page_offset);
+    memcpy(buffer, data.data() + page_offset, partial_size);
+    return partial_size;
+  }
+
+  memcpy(buffer, data.data() + page_offset, read_size);
+  CachePage(page_address, std::move(data));
+  return read_size;
+}
+
+bool ProcessMemoryCaching::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Requests within a single page are satisfied from the cache where possible.
+  // The pages that they miss, and the requests that don’t fit within a single
+  // page, are read from the underlying memory object in one batch.
+  std::vector<ReadRequest> underlying_requests;
+  std::vector<const ReadRequest*> missed_requests;
+  std::map<VMAddress, base::HeapArray<uint8_t>> missed_pages;
+  {
+    base::AutoLock lock_owner(lock_);
+    for (const ReadRequest& request : requests) {
+      const VMAddress page_address =
+          request.address & ~VMAddress{page_size_ - 1};
+      const size_t page_offset = request.address - page_address;
+      if (request.size > page_size_ - page_offset) {
+        underlying_requests.push_back(request);
+        continue;
+      }
+      if (CopyFromCachedPage(page_address,
+                             page_offset,
+                             static_cast<size_t>(request.size),
+                             request.buffer)) {
+        continue;
+      }
+      missed_requests.push_back(&request);
+      auto [page_it, inserted] = missed_pages.try_emplace(page_address);
+      if (inserted) {
+        page_it->second = base::HeapArray<uint8_t>::Uninit(page_size_);
+        underlying_requests.push_back(
+            {page_address, page_size_, page_it->second.data()});
+      }
+    }
+  }
+
+  if (!memory_->ReadBatch(underlying_requests)) {
+    // A whole page may not be readable even though the part of it that was
+    // requested is. Fall back to reading each request individually, which
+    // caches the pages that can be read in full.
+    return ProcessMemory::ReadBatchInternal(requests);
+  }
+
+  for (const ReadRequest* request : missed_requests) {
+    const VMAddress page_address =
+        request->address & ~VMAddress{page_size_ - 1};
+    memcpy(request->buffer,
+           missed_pages[page_address].data() +
+               (request->address - page_address),
+           static_cast<size_t>(request->size));
+  }
+
+  base::AutoLock lock_owner(lock_);
+  cache_misses_ += missed_pages.size();
+  for (auto& [page_address, data] : missed_pages) {
+    // Another thread may have cached this page while the lock was released.
+    if (page_index_.find(page_address) == page_index_.end()) {
+      CachePage(page_address, std::move(data));
+    }
+  }
+  return true;
+}
+
+bool ProcessMemoryCaching::CopyFromCachedPage(VMAddress page_address,
+                                              size_t page_offset,
+                                              size_t size,
+                                              void* buffer) const {
+  lock_.AssertAcquired();
+  auto index_it = page_index_.find(page_address);
+  if (index_it == page_index_.end()) {
+    return false;
+  }
+  ++cache_hits_;
+  cached_pages_.splice(cached_pages_.begin(), cached_pages_, index_it->second);
+  memcpy(buffer, index_it->second->data.data() + page_offset, size);
+  return true;
+}
+
+void ProcessMemoryCaching::CachePage(VMAddress page_address,
+                                     base::HeapArray<uint8_t> data) const {
+  lock_.AssertAcquired();
+  if (cached_pages_.size() >= max_cached_pages_) {
+    page_index_.erase(cached_pages_.back().address);
+    cached_pages_.pop_back();
+  }
+  cached_pages_.push_front({page_address, std::move(data)});
+  page_index_[page_address] = cached_pages_.begin();
+}
+
+}  // namespace crashpad
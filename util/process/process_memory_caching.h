@@ -0,0 +1,109 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHING_H_
+#define CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHING_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "base/containers/heap_array.h"
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+
+//! \brief Cached access to the memory of another process.
+//!
+//! Reads of up to one page are satisfied from a bounded cache of whole,
+//! page-aligned copies of the target process’ memory. When the cache is full,
+//! the least recently used page is evicted. Larger reads bypass the cache.
+//! Batched reads are satisfied from the cache in the same way, and the pages
+//! that they miss are read from the underlying memory object in one batch.
+//!
+//! This is only appropriate when the target process’ memory will not change
+//! during the lifetime of this object, such as while a crashed process is
+//! suspended for a snapshot.
+class ProcessMemoryCaching final : public ProcessMemory {
+ public:
+  ProcessMemoryCaching();
+
+  ProcessMemoryCaching(const ProcessMemoryCaching&) = delete;
+  ProcessMemoryCaching& operator=(const ProcessMemoryCaching&) = delete;
+
+  ~ProcessMemoryCaching();
+
+  //! \brief Initializes this object to read memory from the underlying
+  //!     \a memory object.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory from.
+  //! \param[in] max_cached_pages The maximum number of pages to cache. Must be
+  //!     greater than 0.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Initialize(const ProcessMemory* memory, size_t max_cached_pages);
+
+  //! \brief Returns the number of reads satisfied from the cache.
+  uint64_t CacheHits() const;
+
+  //! \brief Returns the number of reads that required reading a page from the
+  //!     underlying memory object.
+  uint64_t CacheMisses() const;
+
+ private:
+  struct CachedPage {
+    VMAddress address;
+    base::HeapArray<uint8_t> data;
+  };
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const override;
+
+  // If the page at page_address is cached, copies size bytes at page_offset
+  // within it to buffer, marks it most recently used, and returns true. lock_
+  // must be held.
+  bool CopyFromCachedPage(VMAddress page_address,
+                          size_t page_offset,
+                          size_t size,
+                          void* buffer) const;
+
+  // Caches data, a whole-page copy of the page at page_address, evicting the
+  // least recently used page if the cache is full. lock_ must be held.
+  void CachePage(VMAddress page_address, base::HeapArray<uint8_t> data) const;
+
+  // The most recently used page is at the front of cached_pages_.
+  mutable std::list<CachedPage> cached_pages_;
+  mutable std::map<VMAddress, std::list<CachedPage>::iterator> page_index_;
+  mutable uint64_t cache_hits_;
+  mutable uint64_t cache_misses_;
+  mutable base::Lock lock_;
+  const ProcessMemory* memory_;  // weak
+  size_t page_size_;
+  size_t max_cached_pages_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHING_H_
@@ -0,0 +1,231 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_caching.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/memory/page_size.h"
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A ProcessMemory backed by a local buffer that counts the reads made of it.
+// Memory at or beyond readable_size is unreadable.
+class CountingProcessMemory : public ProcessMemory {
+ public:
+  CountingProcessMemory(VMAddress base, size_t size)
+      : data_(size), base_(base), readable_size_(size), reads_(0) {
+    for (size_t index = 0; index < data_.size(); ++index) {
+      data_[index] = static_cast<char>(index % 251);
+    }
+  }
+
+  CountingProcessMemory(const CountingProcessMemory&) = delete;
+  CountingProcessMemory& operator=(const CountingProcessMemory&) = delete;
+
+  void set_readable_size(size_t readable_size) {
+    readable_size_ = readable_size;
+  }
+
+  char ExpectedByte(VMAddress address) const {
+    return data_[address - base_];
+  }
+
+  size_t reads() const { return reads_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++reads_;
+    if (address < base_ || address >= base_ + readable_size_) {
+      return -1;
+    }
+    size_t offset = address - base_;
+    size_t read_size = std::min(size, readable_size_ - offset);
+    memcpy(buffer, &data_[offset], read_size);
+    return read_size;
+  }
+
+  std::vector<char> data_;
+  VMAddress base_;
+  size_t readable_size_;
+  mutable size_t reads_;
+};
+
+TEST(ProcessMemoryCaching, HitsAndMisses) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size * 4);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 2));
+
+  char buffer[16];
+  ASSERT_TRUE(caching.Read(base + 8, sizeof(buffer), buffer));
+  EXPECT_EQ(buffer[0], memory.ExpectedByte(base + 8));
+  EXPECT_EQ(caching.CacheMisses(), 1u);
+  EXPECT_EQ(caching.CacheHits(), 0u);
+  EXPECT_EQ(memory.reads(), 1u);
+
+  // Another read from the same page is satisfied from the cache.
+  ASSERT_TRUE(caching.Read(base + 100, sizeof(buffer), buffer));
+  EXPECT_EQ(buffer[0], memory.ExpectedByte(base + 100));
+  EXPECT_EQ(caching.CacheMisses(), 1u);
+  EXPECT_EQ(caching.CacheHits(), 1u);
+  EXPECT_EQ(memory.reads(), 1u);
+
+  // A read straddling two pages is split at the page boundary.
+  ASSERT_TRUE(caching.Read(base + page_size - 4, sizeof(buffer), buffer));
+  for (size_t index = 0; index < sizeof(buffer); ++index) {
+    EXPECT_EQ(buffer[index],
+              memory.ExpectedByte(base + page_size - 4 + index));
+  }
+  EXPECT_EQ(caching.CacheMisses(), 2u);
+  EXPECT_EQ(caching.CacheHits(), 2u);
+  EXPECT_EQ(memory.reads(), 2u);
+
+  // Reading a third page evicts the least recently used page, which is the
+  // first one.
+  ASSERT_TRUE(caching.Read(base + 2 * page_size, sizeof(buffer), buffer));
+  EXPECT_EQ(caching.CacheMisses(), 3u);
+  ASSERT_TRUE(caching.Read(base + page_size, sizeof(buffer), buffer));
+  EXPECT_EQ(caching.CacheMisses(), 3u);
+  ASSERT_TRUE(caching.Read(base, sizeof(buffer), buffer));
+  EXPECT_EQ(caching.CacheMisses(), 4u);
+  EXPECT_EQ(buffer[0], memory.ExpectedByte(base));
+}
+
+TEST(ProcessMemoryCaching, LargeReadsBypassCache) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size * 4);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 8));
+
+  std::vector<char> buffer(page_size * 2);
+  ASSERT_TRUE(caching.Read(base + 1, buffer.size(), buffer.data()));
+  for (size_t index = 0; index < buffer.size(); ++index) {
+    EXPECT_EQ(buffer[index], memory.ExpectedByte(base + 1 + index));
+  }
+  EXPECT_EQ(caching.CacheHits(), 0u);
+  EXPECT_EQ(caching.CacheMisses(), 0u);
+}
+
+TEST(ProcessMemoryCaching, PartiallyReadablePage) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size);
+  memory.set_readable_size(page_size / 2);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 8));
+
+  char buffer[16];
+  ASSERT_TRUE(caching.Read(base, sizeof(buffer), buffer));
+  EXPECT_EQ(buffer[0], memory.ExpectedByte(base));
+  EXPECT_FALSE(caching.Read(base + page_size / 2 - 4, sizeof(buffer), buffer));
+  EXPECT_FALSE(caching.Read(base + page_size / 2, sizeof(buffer), buffer));
+
+  // The partially readable page was never cached.
+  EXPECT_EQ(caching.CacheHits(), 0u);
+  EXPECT_EQ(caching.CacheMisses(), 4u);
+}
+
+TEST(ProcessMemoryCaching, ReadBatch) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size * 4);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 8));
+
+  char first[16];
+  char second[16];
+  std::vector<char> large(page_size * 2);
+  ASSERT_TRUE(caching.ReadBatch(
+      {{base + 8, sizeof(first), first},
+       {base + 100, sizeof(second), second},
+       {base + 2 * page_size, large.size(), large.data()}}));
+  EXPECT_EQ(first[0], memory.ExpectedByte(base + 8));
+  EXPECT_EQ(second[0], memory.ExpectedByte(base + 100));
+  EXPECT_EQ(large[0], memory.ExpectedByte(base + 2 * page_size));
+  EXPECT_EQ(large.back(), memory.ExpectedByte(base + 4 * page_size - 1));
+
+  // Both small requests missed the same page, which was read once. The large
+  // request bypassed the cache.
+  EXPECT_EQ(caching.CacheHits(), 0u);
+  EXPECT_EQ(caching.CacheMisses(), 1u);
+  const size_t reads = memory.reads();
+
+  // A later batch within the cached page is satisfied from the cache, as is a
+  // single read.
+  ASSERT_TRUE(caching.ReadBatch({{base + 200, sizeof(first), first},
+                                 {base + 300, sizeof(second), second}}));
+  EXPECT_EQ(first[0], memory.ExpectedByte(base + 200));
+  EXPECT_EQ(second[0], memory.ExpectedByte(base + 300));
+  ASSERT_TRUE(caching.Read(base + 400, sizeof(first), first));
+  EXPECT_EQ(first[0], memory.ExpectedByte(base + 400));
+  EXPECT_EQ(caching.CacheHits(), 3u);
+  EXPECT_EQ(caching.CacheMisses(), 1u);
+  EXPECT_EQ(memory.reads(), reads);
+}
+
+TEST(ProcessMemoryCaching, ReadBatchPartiallyReadablePage) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size);
+  memory.set_readable_size(page_size / 2);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 8));
+
+  // The whole page can’t be read, but the part of it requested can.
+  char buffer[16];
+  ASSERT_TRUE(caching.ReadBatch({{base + 8, sizeof(buffer), buffer}}));
+  EXPECT_EQ(buffer[0], memory.ExpectedByte(base + 8));
+  EXPECT_FALSE(
+      caching.ReadBatch({{base + page_size / 2, sizeof(buffer), buffer}}));
+  EXPECT_EQ(caching.CacheHits(), 0u);
+}
+
+TEST(ProcessMemoryCaching, ReadCString) {
+  const size_t page_size = base::GetPageSize();
+  const VMAddress base = page_size * 16;
+  CountingProcessMemory memory(base, page_size * 2);
+
+  ProcessMemoryCaching caching;
+  ASSERT_TRUE(caching.Initialize(&memory, 8));
+
+  // Byte 251 of the backing buffer is the first NUL after the start.
+  std::string string;
+  ASSERT_TRUE(caching.ReadCString(base + 1, &string));
+  EXPECT_EQ(string.size(), 250u);
+  ASSERT_TRUE(caching.ReadCString(base + 1, &string));
+  EXPECT_EQ(string.size(), 250u);
+  EXPECT_EQ(caching.CacheHits(), 1u);
+  EXPECT_EQ(caching.CacheMisses(), 1u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
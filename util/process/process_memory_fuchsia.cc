@@ -14,6 +14,9 @@
 
 #include "util/process/process_memory_fuchsia.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <limits>
 
 #include "base/check_op.h"
@@ -22,6 +25,19 @@
 
 namespace crashpad {
 
+namespace {
+
+// Requests separated by at most this many bytes are read together. The bytes
+// in between are read and discarded, which is cheaper than another system call
+// as long as the gap is small. A gap this small rarely spans a hole in the
+// address space, and if it does, the group is read again piece by piece.
+constexpr VMSize kMaxCoalescingGap = 4096;
+
+// The largest span read in one piece, bounding the temporary buffer.
+constexpr VMSize kMaxCoalescedReadSize = 1024 * 1024;
+
+}  // namespace
+
 ProcessMemoryFuchsia::ProcessMemoryFuchsia()
     : ProcessMemory(), process_(), initialized_() {}
 
@@ -55,4 +71,87 @@ ssize_t ProcessMemoryFuchsia::ReadUpTo(VMAddress address,
   return actual;
 }
 
+bool ProcessMemoryFuchsia::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<const ReadRequest*> sorted;
+  sorted.reserve(requests.size());
+  for (const ReadRequest& request : requests) {
+    sorted.push_back(&request);
+  }
+  std::stable_sort(sorted.begin(),
+                   sorted.end(),
+                   [](const ReadRequest* a, const ReadRequest* b) {
+                     return a->address < b->address;
+                   });
+
+  std::vector<char> coalesced;
+  size_t first = 0;
+  while (first < sorted.size()) {
+    const VMAddress start = sorted[first]->address;
+    if (sorted[first]->size > std::numeric_limits<VMAddress>::max() - start) {
+      LOG(ERROR) << "address " << start << " size " << sorted[first]->size
+                 << " out of range";
+      return false;
+    }
+    VMAddress end = start + sorted[first]->size;
+
+    size_t last = first + 1;
+    while (last < sorted.size()) {
+      const ReadRequest& request = *sorted[last];
+      if (request.address > end && request.address - end > kMaxCoalescingGap) {
+        break;
+      }
+      if (request.size >
+          std::numeric_limits<VMAddress>::max() - request.address) {
+        break;
+      }
+      const VMAddress request_end =
+          std::max(end, request.address + request.size);
+      if (request_end - start > kMaxCoalescedReadSize) {
+        break;
+      }
+      end = request_end;
+      ++last;
+    }
+
+    if (last == first + 1) {
+      const ReadRequest& request = *sorted[first];
+      if (!Read(request.address, request.size, request.buffer)) {
+        return false;
+      }
+      first = last;
+      continue;
+    }
+
+    const size_t size = end - start;
+    coalesced.resize(size);
+    size_t actual;
+    zx_status_t status =
+        process_->read_memory(start, coalesced.data(), size, &actual);
+    if (status == ZX_OK && actual == size) {
+      for (size_t index = first; index < last; ++index) {
+        const ReadRequest& request = *sorted[index];
+        memcpy(request.buffer,
+               &coalesced[request.address - start],
+               request.size);
+      }
+    } else {
+      // Part of the span, possibly only a gap between requests, isn't
+      // readable. Read the group's requests individually, which logs an
+      // appropriate message if any of them can't be read either.
+      for (size_t index = first; index < last; ++index) {
+        const ReadRequest& request = *sorted[index];
+        if (!Read(request.address, request.size, request.buffer)) {
+          return false;
+        }
+      }
+    }
+    first = last;
+  }
+
+  return true;
+}
+
 }  // namespace crashpad
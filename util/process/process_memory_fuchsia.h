@@ -18,6 +18,7 @@
 #include <lib/zx/process.h>
 
 #include <string>
+#include <vector>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -51,6 +52,12 @@ class ProcessMemoryFuchsia final : public ProcessMemory {
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  // Reads requests that are close together, but not necessarily adjacent,
+  // with a single zx_process_read_memory() call, falling back to reading each
+  // request of a group that can't be read in one piece.
+  bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const override;
+
   zx::unowned_process process_;
   InitializationStateDcheck initialized_;
 };
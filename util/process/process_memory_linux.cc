@@ -14,9 +14,13 @@
 
 #include "util/process/process_memory_linux.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -31,8 +35,36 @@
 
 namespace crashpad {
 
+namespace {
+
+// The kernel rejects process_vm_readv() calls with more than UIO_MAXIOV iovecs
+// on either side.
+constexpr size_t kMaxIovecs = 1024;
+
+ssize_t ProcessVMReadv(pid_t pid,
+                       const iovec* local_iov,
+                       unsigned long local_count,
+                       const iovec* remote_iov,
+                       unsigned long remote_count) {
+  // Use syscall() directly because older C libraries don’t provide a wrapper.
+  return syscall(SYS_process_vm_readv,
+                 pid,
+                 local_iov,
+                 local_count,
+                 remote_iov,
+                 remote_count,
+                 0);
+}
+
+}  // namespace
+
 ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection)
-    : ProcessMemory(), mem_fd_(), ignore_top_byte_(false) {
+    : ProcessMemory(),
+      connection_(connection),
+      mem_fd_(),
+      pid_(connection->GetProcessID()),
+      process_vm_readv_usable_(false),
+      ignore_top_byte_(false) {
 #if defined(ARCH_CPU_ARM_FAMILY)
   if (connection->Is64Bit()) {
     ignore_top_byte_ = true;
@@ -43,6 +75,9 @@ ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection)
   snprintf(path, sizeof(path), "/proc/%d/mem", connection->GetProcessID());
   mem_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
   if (mem_fd_.is_valid()) {
+    // Being able to open /proc/pid/mem implies ptrace access to the target,
+    // which is the same access check that process_vm_readv() performs.
+    process_vm_readv_usable_ = true;
     read_up_to_ = [this](VMAddress address, size_t size, void* buffer) {
       ssize_t bytes_read =
           HANDLE_EINTR(pread64(mem_fd_.get(), buffer, size, address));
@@ -67,11 +102,184 @@ VMAddress ProcessMemoryLinux::PointerToAddress(VMAddress address) const {
   return ignore_top_byte_ ? address & 0x00ffffffffffffff : address;
 }
 
+bool ProcessMemoryLinux::AddLocalCopy(VMAddress address,
+                                      const void* data,
+                                      size_t size) {
+  address = PointerToAddress(address);
+  if (size == 0 || address + size < address) {
+    LOG(ERROR) << "invalid local copy";
+    return false;
+  }
+
+  auto next = std::upper_bound(
+      local_copies_.begin(),
+      local_copies_.end(),
+      address,
+      [](VMAddress address, const LocalCopy& copy) {
+        return address < copy.address;
+      });
+  if ((next != local_copies_.end() && address + size > next->address) ||
+      (next != local_copies_.begin() &&
+       (next - 1)->address + (next - 1)->size > address)) {
+    LOG(ERROR) << "overlapping local copy";
+    return false;
+  }
+
+  local_copies_.insert(next, {address, static_cast<const char*>(data), size});
+  return true;
+}
+
 ssize_t ProcessMemoryLinux::ReadUpTo(VMAddress address,
                                      size_t size,
                                      void* buffer) const {
   DCHECK_LE(size, size_t{std::numeric_limits<ssize_t>::max()});
-  return read_up_to_(PointerToAddress(address), size, buffer);
+  address = PointerToAddress(address);
+
+  for (const LocalCopy& copy : local_copies_) {
+    if (address - copy.address < copy.size) {
+      size_t offset = address - copy.address;
+      size_t local_size = std::min(size, copy.size - offset);
+      memcpy(buffer, copy.data + offset, local_size);
+      return local_size;
+    }
+    if (copy.address > address) {
+      // Read from the target process only up to the start of the copy.
+      size = std::min(size, static_cast<size_t>(copy.address - address));
+      break;
+    }
+  }
+
+  return read_up_to_(address, size, buffer);
+}
+
+bool ProcessMemoryLinux::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  if (local_copies_.empty()) {
+    return ReadBatchRemote(requests);
+  }
+
+  // Requests wholly within a local copy are served here, and the rest are
+  // batched as usual.
+  std::vector<ReadRequest> remote_requests;
+  for (const ReadRequest& request : requests) {
+    const VMAddress address = PointerToAddress(request.address);
+    auto copy = std::find_if(
+        local_copies_.begin(),
+        local_copies_.end(),
+        [address, &request](const LocalCopy& copy) {
+          return address - copy.address < copy.size &&
+                 request.size <= copy.size - (address - copy.address);
+        });
+    if (copy == local_copies_.end()) {
+      remote_requests.push_back(request);
+      continue;
+    }
+    memcpy(request.buffer,
+           copy->data + (address - copy->address),
+           request.size);
+  }
+  return remote_requests.empty() || ReadBatchRemote(remote_requests);
+}
+
+bool ProcessMemoryLinux::ReadBatchRemote(
+    const std::vector<ReadRequest>& requests) const {
+  if (!mem_fd_.is_valid()) {
+    // Reads are served by the connection, which may be able to transfer all of
+    // the requests at once.
+    std::vector<ReadRequest> connection_requests(requests);
+    for (ReadRequest& request : connection_requests) {
+      request.address = PointerToAddress(request.address);
+    }
+    return connection_->ReadMemoryBatch(connection_requests);
+  }
+
+  std::vector<iovec> local_iovs;
+  std::vector<iovec> remote_iovs;
+
+  // index is the first request not yet fully satisfied, and offset is the
+  // number of bytes of that request that have already been copied.
+  size_t index = 0;
+  size_t offset = 0;
+  while (index < requests.size()) {
+    if (!process_vm_readv_usable_) {
+      break;
+    }
+
+    local_iovs.clear();
+    remote_iovs.clear();
+    size_t batch_size = 0;
+    constexpr size_t kMaxBatchSize = std::numeric_limits<ssize_t>::max();
+    for (size_t request_index = index;
+         request_index < requests.size() && local_iovs.size() < kMaxIovecs &&
+         batch_size < kMaxBatchSize;
+         ++request_index) {
+      const ReadRequest& request = requests[request_index];
+      const size_t skip = request_index == index ? offset : 0;
+      const size_t size = std::min(static_cast<size_t>(request.size) - skip,
+                                   kMaxBatchSize - batch_size);
+      local_iovs.push_back({static_cast<char*>(request.buffer) + skip, size});
+      remote_iovs.push_back({reinterpret_cast<void*>(static_cast<uintptr_t>(
+                                 PointerToAddress(request.address) + skip)),
+                             size});
+      batch_size += size;
+    }
+
+    ssize_t bytes_read = HANDLE_EINTR(ProcessVMReadv(pid_,
+                                                     local_iovs.data(),
+                                                     local_iovs.size(),
+                                                     remote_iovs.data(),
+                                                     remote_iovs.size()));
+    if (bytes_read < 0) {
+      if (errno == ENOSYS || errno == EPERM) {
+        // The system call isn’t available, or is blocked by a sandbox policy.
+        // Don’t try it again.
+        PLOG(WARNING) << "process_vm_readv";
+        process_vm_readv_usable_ = false;
+        break;
+      }
+      bytes_read = 0;
+    }
+
+    if (bytes_read == 0) {
+      // The kernel stops at the first remote range that can’t be read. Read the
+      // rest of the current request with ReadUpTo(), which logs an appropriate
+      // message if it fails too.
+      const ReadRequest& request = requests[index];
+      if (!Read(request.address + offset,
+                request.size - offset,
+                static_cast<char*>(request.buffer) + offset)) {
+        return false;
+      }
+      ++index;
+      offset = 0;
+      continue;
+    }
+
+    size_t remaining = bytes_read;
+    while (remaining > 0) {
+      DCHECK_LT(index, requests.size());
+      const size_t request_remaining =
+          static_cast<size_t>(requests[index].size) - offset;
+      if (remaining < request_remaining) {
+        offset += remaining;
+        break;
+      }
+      remaining -= request_remaining;
+      ++index;
+      offset = 0;
+    }
+  }
+
+  for (; index < requests.size(); ++index) {
+    const ReadRequest& request = requests[index];
+    if (!Read(request.address + offset,
+              request.size - offset,
+              static_cast<char*>(request.buffer) + offset)) {
+      return false;
+    }
+    offset = 0;
+  }
+  return true;
 }
 
 }  // namespace crashpad
@@ -17,8 +17,10 @@
 
 #include <sys/types.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "base/files/scoped_file.h"
 #include "util/misc/address_types.h"
@@ -42,11 +44,48 @@ class ProcessMemoryLinux final : public ProcessMemory {
   //!     tags removed.
   VMAddress PointerToAddress(VMAddress address) const;
 
+  //! \brief Returns `true` if this object may be used to read memory from
+  //!     several threads at once.
+  //!
+  //! Reads are thread-safe when they're served from `/proc/pid/mem`. Otherwise
+  //! they're forwarded to the PtraceConnection, which must only be used from
+  //! the thread that created it.
+  bool SupportsConcurrentReads() const { return mem_fd_.is_valid(); }
+
+  //! \brief Serves reads of `[address, address + size)` from a local copy of
+  //!     the target process' memory instead of from the process itself.
+  //!
+  //! Reads that partially overlap a local copy are served from it where they
+  //! overlap and from the target process elsewhere. This must be called before
+  //! any concurrent reads.
+  //!
+  //! \param[in] address The address in the target process of the copied memory.
+  //! \param[in] data The copy, which must outlive this object.
+  //! \param[in] size The size of \a data.
+  //! \return `true` on success. `false` with a message logged if the range
+  //!     overlaps an existing local copy.
+  bool AddLocalCopy(VMAddress address, const void* data, size_t size);
+
  private:
+  struct LocalCopy {
+    VMAddress address;
+    const char* data;
+    size_t size;
+  };
+
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const override;
+
+  // Implements ReadBatchInternal() for requests not served by local_copies_.
+  bool ReadBatchRemote(const std::vector<ReadRequest>& requests) const;
 
   std::function<ssize_t(VMAddress, size_t, void*)> read_up_to_;
+  std::vector<LocalCopy> local_copies_;  // Sorted by address.
+  PtraceConnection* connection_;  // weak
   base::ScopedFD mem_fd_;
+  pid_t pid_;
+  mutable std::atomic<bool> process_vm_readv_usable_;
   bool ignore_top_byte_;
 };
 
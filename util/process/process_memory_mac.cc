@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <utility>
 
 #include "base/apple/mach_logging.h"
 #include "base/check_op.h"
@@ -64,11 +65,21 @@ ProcessMemoryMac::MappedMemory::MappedMemory(vm_address_t vm_address,
   DCHECK_LE(user_end, vm_end);
 }
 
-ProcessMemoryMac::ProcessMemoryMac() : task_(TASK_NULL), initialized_() {}
-
-bool ProcessMemoryMac::Initialize(task_t task) {
+ProcessMemoryMac::ProcessMemoryMac()
+    : known_ranges_(),
+      cached_mappings_(),
+      mapping_index_(),
+      cache_hits_(0),
+      cache_misses_(0),
+      lock_(),
+      task_(TASK_NULL),
+      max_cached_mappings_(0),
+      initialized_() {}
+
+bool ProcessMemoryMac::Initialize(task_t task, size_t max_cached_mappings) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   task_ = task;
+  max_cached_mappings_ = max_cached_mappings;
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -77,7 +88,33 @@ std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
     mach_vm_address_t address,
     size_t size) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return ReadMappedInternal(address, size, true);
+}
+
+void ProcessMemoryMac::AddKnownRange(
+    mach_vm_address_t address,
+    std::shared_ptr<const std::vector<uint8_t>> data) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(data);
+  known_ranges_[address] = std::move(data);
+}
 
+uint64_t ProcessMemoryMac::CacheHits() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock_owner(lock_);
+  return cache_hits_;
+}
+
+uint64_t ProcessMemoryMac::CacheMisses() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock_owner(lock_);
+  return cache_misses_;
+}
+
+std::unique_ptr<ProcessMemoryMac::MappedMemory>
+ProcessMemoryMac::ReadMappedInternal(mach_vm_address_t address,
+                                     size_t size,
+                                     bool log_failures) const {
   if (size == 0) {
     return std::unique_ptr<MappedMemory>(new MappedMemory(0, 0, 0, 0));
   }
@@ -91,7 +128,7 @@ std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
   kern_return_t kr =
       mach_vm_read(task_, region_address, region_size, &region, &region_count);
   if (kr != KERN_SUCCESS) {
-    MACH_LOG(WARNING, kr) << base::StringPrintf(
+    MACH_LOG_IF(WARNING, log_failures, kr) << base::StringPrintf(
         "mach_vm_read(0x%llx, 0x%llx)", region_address, region_size);
     return std::unique_ptr<MappedMemory>();
   }
@@ -115,6 +152,14 @@ ssize_t ProcessMemoryMac::ReadUpTo(VMAddress address,
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   DCHECK_LE(size, (size_t)std::numeric_limits<ssize_t>::max());
 
+  if (!known_ranges_.empty() && ReadFromKnownRange(address, size, buffer)) {
+    return static_cast<ssize_t>(size);
+  }
+
+  if (max_cached_mappings_ > 0 && ReadFromCache(address, size, buffer)) {
+    return static_cast<ssize_t>(size);
+  }
+
   std::unique_ptr<MappedMemory> memory = ReadMapped(address, size);
   if (!memory) {
     // If we can not read the entire mapping, try to perform a short read of the
@@ -134,4 +179,76 @@ ssize_t ProcessMemoryMac::ReadUpTo(VMAddress address,
   return static_cast<ssize_t>(size);
 }
 
+bool ProcessMemoryMac::ReadFromKnownRange(mach_vm_address_t address,
+                                          size_t size,
+                                          void* buffer) const {
+  auto iterator = known_ranges_.upper_bound(address);
+  if (iterator == known_ranges_.begin()) {
+    return false;
+  }
+  --iterator;
+
+  const std::vector<uint8_t>& data = *iterator->second;
+  const mach_vm_address_t offset = address - iterator->first;
+  if (offset > data.size() || size > data.size() - offset) {
+    return false;
+  }
+
+  memcpy(buffer, data.data() + offset, size);
+  return true;
+}
+
+bool ProcessMemoryMac::ReadFromCache(mach_vm_address_t address,
+                                     size_t size,
+                                     void* buffer) const {
+  const mach_vm_address_t mapping_address =
+      address & ~mach_vm_address_t{kCachedMappingSize - 1};
+  const size_t mapping_offset = address - mapping_address;
+  if (size > kCachedMappingSize - mapping_offset) {
+    // Reads that cross a mapping boundary are rare enough that they’re not
+    // worth assembling from more than one mapping.
+    return false;
+  }
+
+  base::AutoLock lock_owner(lock_);
+
+  auto index_it = mapping_index_.find(mapping_address);
+  const bool cached = index_it != mapping_index_.end();
+  if (cached) {
+    cached_mappings_.splice(
+        cached_mappings_.begin(), cached_mappings_, index_it->second);
+  } else {
+    // mach_vm_read() will fail if any part of the mapping is unreadable, such
+    // as at the end of a region. The failure is cached too, so that reads in
+    // the readable part don’t attempt this mapping again, and are left to
+    // ReadUpTo()’s uncached path.
+    ++cache_misses_;
+    CachedMapping cached_mapping;
+    cached_mapping.address = mapping_address;
+    cached_mapping.memory =
+        ReadMappedInternal(mapping_address, kCachedMappingSize, false);
+
+    if (cached_mappings_.size() >= max_cached_mappings_) {
+      mapping_index_.erase(cached_mappings_.back().address);
+      cached_mappings_.pop_back();
+    }
+    cached_mappings_.push_front(std::move(cached_mapping));
+    index_it =
+        mapping_index_.emplace(mapping_address, cached_mappings_.begin()).first;
+  }
+
+  const MappedMemory* memory = index_it->second->memory.get();
+  if (!memory) {
+    return false;
+  }
+
+  if (cached) {
+    ++cache_hits_;
+  }
+  memcpy(buffer,
+         reinterpret_cast<const char*>(memory->data()) + mapping_offset,
+         size);
+  return true;
+}
+
 }  // namespace crashpad
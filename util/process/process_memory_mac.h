@@ -16,12 +16,17 @@
 #define CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_MAC_H_
 
 #include <mach/mach.h>
+#include <stdint.h>
 #include <sys/types.h>
 
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/apple/scoped_mach_vm.h"
+#include "base/synchronization/lock.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -105,9 +110,17 @@ class ProcessMemoryMac : public ProcessMemory {
   //!
   //! \param[in] task A send right to the target task's task port. This object
   //!     does not take ownership of the send right.
+  //! \param[in] max_cached_mappings If nonzero, small reads through Read() are
+  //!     served from up to this many cached mappings of kCachedMappingSize
+  //!     bytes each, so that each part of the target task’s address space is
+  //!     mapped into the current task at most once. When the limit is reached,
+  //!     the least recently used mapping is released. This is only
+  //!     appropriate when the target task’s memory will not change during the
+  //!     lifetime of this object, such as while it is suspended for a
+  //!     snapshot.
   //!
   //! \return `true` on success, `false` on failure with a message logged.
-  bool Initialize(task_t task);
+  bool Initialize(task_t task, size_t max_cached_mappings = 0);
 
   //! \brief Maps memory from the target task into the current task.
   //!
@@ -125,10 +138,76 @@ class ProcessMemoryMac : public ProcessMemory {
   std::unique_ptr<MappedMemory> ReadMapped(mach_vm_address_t address,
                                            size_t size) const;
 
+  //! \brief Supplies the already-known contents of a range of the target
+  //!     task’s memory.
+  //!
+  //! Reads through Read() that fall entirely within the \a data.size() bytes
+  //! at \a address will be served from \a data without reading the target
+  //! task. This is only appropriate for memory that can’t change, such as the
+  //! read-only headers and load commands of loaded images. ReadMapped() is not
+  //! affected.
+  //!
+  //! This method must not be called concurrently with any other method of
+  //! this class.
+  void AddKnownRange(mach_vm_address_t address,
+                     std::shared_ptr<const std::vector<uint8_t>> data);
+
+  //! \brief Returns the number of reads satisfied from a cached mapping.
+  uint64_t CacheHits() const;
+
+  //! \brief Returns the number of reads that required mapping memory from the
+  //!     target task into the cache.
+  uint64_t CacheMisses() const;
+
+  //! \brief The size and alignment of each mapping cached when a nonzero \a
+  //!     max_cached_mappings is passed to Initialize().
+  static constexpr size_t kCachedMappingSize = 64 * 1024;
+
  private:
+  struct CachedMapping {
+    mach_vm_address_t address;
+
+    // nullptr if the memory at address could not be mapped in its entirety.
+    std::unique_ptr<MappedMemory> memory;
+  };
+
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  //! \brief Performs the work of ReadMapped(), logging failures only if \a
+  //!     log_failures is `true`.
+  std::unique_ptr<MappedMemory> ReadMappedInternal(mach_vm_address_t address,
+                                                   size_t size,
+                                                   bool log_failures) const;
+
+  //! \brief Attempts to satisfy a read from a range given to AddKnownRange().
+  //!
+  //! \return `true` with \a buffer filled if the read was satisfied from a
+  //!     known range. `false` if the read must be performed another way.
+  bool ReadFromKnownRange(mach_vm_address_t address,
+                          size_t size,
+                          void* buffer) const;
+
+  //! \brief Attempts to satisfy a read from a cached mapping.
+  //!
+  //! \return `true` with \a buffer filled if the read was satisfied from the
+  //!     cache. `false` if the read must be performed without the cache.
+  bool ReadFromCache(mach_vm_address_t address,
+                     size_t size,
+                     void* buffer) const;
+
+  // Keyed by the address of each known range in the target task.
+  std::map<mach_vm_address_t, std::shared_ptr<const std::vector<uint8_t>>>
+      known_ranges_;
+
+  // The most recently used mapping is at the front of cached_mappings_.
+  mutable std::list<CachedMapping> cached_mappings_;
+  mutable std::map<mach_vm_address_t, std::list<CachedMapping>::iterator>
+      mapping_index_;
+  mutable uint64_t cache_hits_;
+  mutable uint64_t cache_misses_;
+  mutable base::Lock lock_;
   task_t task_;  // weak
+  size_t max_cached_mappings_;
   InitializationStateDcheck initialized_;
 };
 
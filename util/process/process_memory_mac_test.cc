@@ -233,6 +233,70 @@ bool IsAddressMapped(vm_address_t address) {
   return false;
 }
 
+TEST(ProcessMemoryMac, ReadCachedSelf) {
+  constexpr size_t kMappingSize = ProcessMemoryMac::kCachedMappingSize;
+
+  // Allocate enough to contain four aligned cache mappings.
+  vm_address_t allocation = 0;
+  const vm_size_t kAllocationSize = 5 * kMappingSize;
+  kern_return_t kr = vm_allocate(
+      mach_task_self(), &allocation, kAllocationSize, VM_FLAGS_ANYWHERE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_allocate");
+  base::apple::ScopedMachVM vm_owner(allocation, kAllocationSize);
+
+  const vm_address_t address =
+      (allocation + kMappingSize - 1) & ~vm_address_t{kMappingSize - 1};
+  char* region = reinterpret_cast<char*>(address);
+  for (size_t index = 0; index < 4 * kMappingSize; ++index) {
+    region[index] = (index % 256) ^ ((index >> 8) % 256);
+  }
+
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self(), 2));
+
+  char result[16];
+  ASSERT_TRUE(memory.Read(address + 1, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + 1, result, sizeof(result)), 0);
+  EXPECT_EQ(memory.CacheMisses(), 1u);
+  EXPECT_EQ(memory.CacheHits(), 0u);
+
+  ASSERT_TRUE(memory.Read(address + 100, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + 100, result, sizeof(result)), 0);
+  EXPECT_EQ(memory.CacheMisses(), 1u);
+  EXPECT_EQ(memory.CacheHits(), 1u);
+
+  // A read that crosses a mapping boundary bypasses the cache.
+  ASSERT_TRUE(memory.Read(address + kMappingSize - 4, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + kMappingSize - 4, result, sizeof(result)), 0);
+  EXPECT_EQ(memory.CacheMisses(), 1u);
+  EXPECT_EQ(memory.CacheHits(), 1u);
+
+  // Filling the cache evicts the least recently used mapping.
+  ASSERT_TRUE(memory.Read(address + kMappingSize, sizeof(result), result));
+  ASSERT_TRUE(memory.Read(address + 2 * kMappingSize, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + 2 * kMappingSize, result, sizeof(result)), 0);
+  EXPECT_EQ(memory.CacheMisses(), 3u);
+  ASSERT_TRUE(memory.Read(address, sizeof(result), result));
+  EXPECT_EQ(memcmp(region, result, sizeof(result)), 0);
+  EXPECT_EQ(memory.CacheMisses(), 4u);
+  EXPECT_EQ(memory.CacheHits(), 1u);
+
+  // A mapping that’s only partly readable isn’t cached, but the readable part
+  // can still be read.
+  kr = vm_protect(mach_task_self(),
+                  address + 4 * kMappingSize - PAGE_SIZE,
+                  PAGE_SIZE,
+                  FALSE,
+                  VM_PROT_NONE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_protect");
+  ASSERT_TRUE(memory.Read(address + 3 * kMappingSize, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + 3 * kMappingSize, result, sizeof(result)), 0);
+  ASSERT_TRUE(memory.Read(address + 3 * kMappingSize, sizeof(result), result));
+  EXPECT_EQ(memory.CacheHits(), 1u);
+  EXPECT_FALSE(memory.Read(
+      address + 4 * kMappingSize - PAGE_SIZE, sizeof(result), result));
+}
+
 TEST(ProcessMemoryMac, MappedMemoryDeallocates) {
   // This tests that once a ProcessMemoryMac::MappedMemory object is destroyed,
   // it releases the mapped memory that it owned. Technically, this test is not
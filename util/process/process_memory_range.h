@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <string>
+#include <vector>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -102,6 +103,18 @@ class ProcessMemoryRange {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief Copies several memory regions from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! Every region must lie within the range of this object.
+  //!
+  //! \param[in] requests The regions to copy and the buffers to copy them into.
+  //!
+  //! \return `true` on success, with every buffer filled appropriately. `false`
+  //!     on failure, with a message logged.
+  bool ReadBatch(
+      const std::vector<ProcessMemory::ReadRequest>& requests) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -37,23 +37,64 @@ bool ProcessMemorySanitized::Initialize(
     const std::vector<std::pair<VMAddress, VMAddress>>* allowed_ranges) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   memory_ = memory;
-  if (allowed_ranges)
-    allowed_ranges_ = *allowed_ranges;
+
+  allowed_ranges_.clear();
+  if (allowed_ranges) {
+    std::vector<std::pair<VMAddress, VMAddress>> ranges;
+    ranges.reserve(allowed_ranges->size());
+    for (const auto& range : *allowed_ranges) {
+      if (range.first < range.second) {
+        ranges.push_back(range);
+      }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    // A read spanning ranges that touch or overlap is allowed, because every
+    // byte it covers is.
+    for (const auto& range : ranges) {
+      if (!allowed_ranges_.empty() &&
+          range.first <= allowed_ranges_.back().second) {
+        allowed_ranges_.back().second =
+            std::max(allowed_ranges_.back().second, range.second);
+      } else {
+        allowed_ranges_.push_back(range);
+      }
+    }
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+bool ProcessMemorySanitized::IsAllowed(VMAddress address, VMSize size) const {
+  const VMAddress end = address + size;
+  if (end < address) {
+    return false;
+  }
+
+  // Find the last range starting at or before address. Since the ranges don’t
+  // overlap, it’s the only one that can contain the read.
+  auto it = std::upper_bound(
+      allowed_ranges_.begin(),
+      allowed_ranges_.end(),
+      address,
+      [](VMAddress address, const std::pair<VMAddress, VMAddress>& range) {
+        return address < range.first;
+      });
+  if (it == allowed_ranges_.begin()) {
+    return false;
+  }
+  --it;
+  return address < it->second && end <= it->second;
+}
+
 ssize_t ProcessMemorySanitized::ReadUpTo(VMAddress address,
                                          size_t size,
                                          void* buffer) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  VMAddress end = address + size;
-  for (auto&& entry : allowed_ranges_) {
-    if (address >= entry.first && address < entry.second &&
-        end >= entry.first && end <= entry.second) {
-      return memory_->ReadUpTo(address, size, buffer);
-    }
+  if (IsAllowed(address, size)) {
+    return memory_->ReadUpTo(address, size, buffer);
   }
 
   DLOG(ERROR)
@@ -62,4 +103,22 @@ ssize_t ProcessMemorySanitized::ReadUpTo(VMAddress address,
   return 0;
 }
 
+bool ProcessMemorySanitized::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Check the whole batch before reading any of it, so that the underlying
+  // memory object can still service it with as few reads as it can manage.
+  for (const ReadRequest& request : requests) {
+    if (!IsAllowed(request.address, request.size)) {
+      DLOG(ERROR) << "ProcessMemorySanitized failed to read disallowed "
+                     "region. address="
+                  << request.address << " size=" << request.size;
+      return false;
+    }
+  }
+
+  return memory_->ReadBatchInternal(requests);
+}
+
 }  // namespace crashpad
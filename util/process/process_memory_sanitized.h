@@ -43,18 +43,33 @@ class ProcessMemorySanitized final : public ProcessMemory {
   //! in this class.
   //!
   //! \param[in] memory The memory object to read memory from.
-  //! \param[in] allowed_ranges A list of allowed memory ranges.
+  //! \param[in] allowed_ranges A list of allowed memory ranges, each a pair of
+  //!     its start address and its end address. The ranges may be in any order
+  //!     and may overlap.
   //!
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(
       const ProcessMemory* memory,
       const std::vector<std::pair<VMAddress, VMAddress>>* allowed_ranges);
 
+  //! \brief Determines whether a memory range may be read.
+  //!
+  //! \param[in] address The base address of the range.
+  //! \param[in] size The size of the range.
+  //!
+  //! \return `true` if the range lies entirely within the allowed ranges.
+  bool IsAllowed(VMAddress address, VMSize size) const;
+
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const override;
 
   const ProcessMemory* memory_;
   InitializationStateDcheck initialized_;
+
+  // Sorted by start address, with overlapping and adjacent ranges merged, so
+  // that a read can be checked with a binary search.
   std::vector<std::pair<VMAddress, VMAddress>> allowed_ranges_;
 };
 
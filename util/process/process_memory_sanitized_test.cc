@@ -14,6 +14,10 @@
 
 #include "util/process/process_memory_sanitized.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/process_type.h"
@@ -78,6 +82,56 @@ TEST(ProcessMemorySanitized, AllowedMemory) {
   EXPECT_FALSE(sanitized.Read(FromPointerCast<VMAddress>(str + 2), 1, &out));
 }
 
+TEST(ProcessMemorySanitized, MergedRanges) {
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS)
+
+  char str[16] = "ABCDEFGHIJKLMNO";
+  char out[16];
+  const VMAddress base = FromPointerCast<VMAddress>(str);
+
+  // Out of order, overlapping, adjacent, and empty ranges.
+  std::vector<std::pair<VMAddress, VMAddress>> allowed_memory;
+  allowed_memory.push_back(std::make_pair(base + 10, base + 12));
+  allowed_memory.push_back(std::make_pair(base + 3, base + 6));
+  allowed_memory.push_back(std::make_pair(base + 1, base + 4));
+  allowed_memory.push_back(std::make_pair(base + 6, base + 8));
+  allowed_memory.push_back(std::make_pair(base + 14, base + 14));
+
+  ProcessMemorySanitized sanitized;
+  sanitized.Initialize(&memory, &allowed_memory);
+
+  EXPECT_FALSE(sanitized.Read(base, 1, out));
+  EXPECT_TRUE(sanitized.Read(base + 1, 7, out));
+  EXPECT_EQ(std::string(out, 7), "BCDEFGH");
+  EXPECT_FALSE(sanitized.Read(base + 1, 8, out));
+  EXPECT_FALSE(sanitized.Read(base + 8, 1, out));
+  EXPECT_TRUE(sanitized.Read(base + 10, 2, out));
+  EXPECT_FALSE(sanitized.Read(base + 7, 4, out));
+  EXPECT_FALSE(sanitized.Read(base + 14, 1, out));
+
+  char first[2];
+  char second[3];
+  std::vector<ProcessMemory::ReadRequest> requests = {
+      {base + 10, sizeof(first), first},
+      {base + 2, sizeof(second), second},
+  };
+  ASSERT_TRUE(sanitized.ReadBatch(requests));
+  EXPECT_EQ(std::string(first, sizeof(first)), "KL");
+  EXPECT_EQ(std::string(second, sizeof(second)), "CDE");
+
+  // One disallowed request fails the whole batch.
+  requests.push_back({base + 8, 1, out});
+  EXPECT_FALSE(sanitized.ReadBatch(requests));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -16,6 +16,9 @@
 
 #include <string.h>
 
+#include <utility>
+#include <vector>
+
 #include "base/containers/heap_array.h"
 #include "base/memory/page_size.h"
 #include "build/build_config.h"
@@ -208,6 +211,30 @@ class ReadTest : public MultiprocessAdaptor {
     ASSERT_TRUE(memory.Read(address + 2, 1, result.data()));
     EXPECT_EQ(result[0], 2);
     EXPECT_EQ(result[1], 'J');
+
+    // Ensure that a batch of discontiguous, unaligned, and empty reads works.
+    char first[3];
+    char second[5];
+    auto third = base::HeapArray<char>::Uninit(page_size + 2);
+    std::vector<ProcessMemory::ReadRequest> requests;
+    requests.push_back({address + 1, sizeof(first), first});
+    requests.push_back({address, 0, nullptr});
+    requests.push_back({address + page_size - 2, sizeof(second), second});
+    requests.push_back(
+        {address + 2 * page_size - 1, third.size(), third.data()});
+    ASSERT_TRUE(memory.ReadBatch(requests));
+    for (size_t i = 0; i < sizeof(first); ++i) {
+      EXPECT_EQ(first[i], static_cast<char>((i + 1) % 256));
+    }
+    for (size_t i = 0; i < sizeof(second); ++i) {
+      EXPECT_EQ(second[i], static_cast<char>((i + page_size - 2) % 256));
+    }
+    for (size_t i = 0; i < third.size(); ++i) {
+      EXPECT_EQ(third[i], static_cast<char>((i + 2 * page_size - 1) % 256));
+    }
+
+    // An empty batch trivially succeeds.
+    EXPECT_TRUE(memory.ReadBatch(std::vector<ProcessMemory::ReadRequest>()));
   }
 };
 
@@ -439,6 +466,21 @@ class ReadUnmappedTest : public MultiprocessAdaptor {
     EXPECT_FALSE(memory.Read(page_addr1, result.size(), result.data()));
     EXPECT_FALSE(memory.Read(page_addr2, base::GetPageSize(), result.data()));
     EXPECT_FALSE(memory.Read(page_addr2 - 1, 2, result.data()));
+
+    std::vector<ProcessMemory::ReadRequest> requests;
+    requests.push_back({page_addr1, 1, result.data()});
+    requests.push_back({page_addr2 - 1, 1, result.data() + 1});
+    EXPECT_TRUE(memory.ReadBatch(requests));
+    EXPECT_EQ(result[0], 0);
+    EXPECT_EQ(result[1], static_cast<char>((base::GetPageSize() - 1) % 256));
+
+    // A batch fails if any of its requests can’t be satisfied, whether the
+    // unreadable request comes first, last, or straddles the guard page.
+    requests.push_back({page_addr2 - 1, 2, result.data() + 2});
+    EXPECT_FALSE(memory.ReadBatch(requests));
+    requests.insert(requests.begin(), {page_addr2, 1, result.data() + 4});
+    requests.pop_back();
+    EXPECT_FALSE(memory.ReadBatch(requests));
   }
 };
 
@@ -601,6 +643,66 @@ TEST(ProcessMemory, ReadCStringSizeLimitedUnmappedChild) {
   test.RunAgainstChild();
 }
 
+// Serves reads from a local buffer, recording each read that it is asked for.
+class LocalProcessMemory : public ProcessMemory {
+ public:
+  explicit LocalProcessMemory(const std::vector<char>* data) : data_(data) {}
+
+  const std::vector<std::pair<VMAddress, size_t>>& reads() const {
+    return reads_;
+  }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    reads_.push_back({address, size});
+    if (address > data_->size() || size > data_->size() - address) {
+      return -1;
+    }
+    memcpy(buffer, data_->data() + address, size);
+    return size;
+  }
+
+  const std::vector<char>* data_;
+  mutable std::vector<std::pair<VMAddress, size_t>> reads_;
+};
+
+TEST(ProcessMemory, ReadBatchCoalesces) {
+  std::vector<char> data(64);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i);
+  }
+  LocalProcessMemory memory(&data);
+
+  // Out of order, adjacent, overlapping, and separate requests.
+  char first[4];
+  char second[4];
+  char third[4];
+  char fourth[4];
+  std::vector<ProcessMemory::ReadRequest> requests;
+  requests.push_back({4, sizeof(second), second});
+  requests.push_back({0, sizeof(first), first});
+  requests.push_back({6, sizeof(third), third});
+  requests.push_back({32, sizeof(fourth), fourth});
+  ASSERT_TRUE(memory.ReadBatch(requests));
+
+  ASSERT_EQ(memory.reads().size(), 2u);
+  EXPECT_EQ(memory.reads()[0], std::make_pair(VMAddress{0}, size_t{10}));
+  EXPECT_EQ(memory.reads()[1], std::make_pair(VMAddress{32}, size_t{4}));
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(first[i], static_cast<char>(i));
+    EXPECT_EQ(second[i], static_cast<char>(i + 4));
+    EXPECT_EQ(third[i], static_cast<char>(i + 6));
+    EXPECT_EQ(fourth[i], static_cast<char>(i + 32));
+  }
+
+  // A coalesced region that can't be read fails the batch.
+  requests.push_back({60, 8, first});
+  requests.push_back({56, 4, second});
+  EXPECT_FALSE(memory.ReadBatch(requests));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -16,6 +16,8 @@
 
 #include <windows.h>
 
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
 
@@ -27,6 +29,19 @@
 
 namespace crashpad {
 
+namespace {
+
+// Requests separated by at most this many bytes are read together, as long as
+// the memory in between is readable. The bytes in between are read and
+// discarded, which is cheaper than another ReadProcessMemory() call as long as
+// the gap is small.
+constexpr VMSize kMaxCoalescingGap = 4096;
+
+// The largest span read in one piece, bounding the temporary buffer.
+constexpr VMSize kMaxCoalescedReadSize = 1024 * 1024;
+
+}  // namespace
+
 ProcessMemoryWin::ProcessMemoryWin()
     : ProcessMemory(), handle_(), process_info_(), initialized_() {}
 
@@ -116,4 +131,101 @@ size_t ProcessMemoryWin::ReadAvailableMemory(VMAddress address,
   return base::checked_cast<size_t>(result);
 }
 
+bool ProcessMemoryWin::ReadBatchInternal(
+    const std::vector<ReadRequest>& requests) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<const ReadRequest*> sorted;
+  sorted.reserve(requests.size());
+  for (const ReadRequest& request : requests) {
+    sorted.push_back(&request);
+  }
+  std::stable_sort(sorted.begin(),
+                   sorted.end(),
+                   [](const ReadRequest* a, const ReadRequest* b) {
+                     return a->address < b->address;
+                   });
+
+  // A gap is only read if the memory map shows that it's readable, so that a
+  // group isn't abandoned for a hole that no request needs.
+  auto gap_is_readable = [this](VMAddress address, VMSize size) {
+    const auto ranges = process_info_.GetReadableRanges(
+        CheckedRange<WinVMAddress, WinVMSize>(address, size));
+    return ranges.size() == 1 && ranges.front().base() == address &&
+           ranges.front().size() == size;
+  };
+
+  std::vector<char> coalesced;
+  size_t first = 0;
+  while (first < sorted.size()) {
+    const VMAddress start = sorted[first]->address;
+    if (sorted[first]->size > std::numeric_limits<VMAddress>::max() - start) {
+      LOG(ERROR) << "address " << start << " size " << sorted[first]->size
+                 << " out of range";
+      return false;
+    }
+    VMAddress end = start + sorted[first]->size;
+
+    size_t last = first + 1;
+    while (last < sorted.size()) {
+      const ReadRequest& request = *sorted[last];
+      if (request.address > end &&
+          (request.address - end > kMaxCoalescingGap ||
+           !gap_is_readable(end, request.address - end))) {
+        break;
+      }
+      if (request.size >
+          std::numeric_limits<VMAddress>::max() - request.address) {
+        break;
+      }
+      const VMAddress request_end =
+          std::max(end, request.address + request.size);
+      if (request_end - start > kMaxCoalescedReadSize) {
+        break;
+      }
+      end = request_end;
+      ++last;
+    }
+
+    if (last == first + 1) {
+      const ReadRequest& request = *sorted[first];
+      if (!Read(request.address, request.size, request.buffer)) {
+        return false;
+      }
+      first = last;
+      continue;
+    }
+
+    const size_t size = base::checked_cast<size_t>(end - start);
+    coalesced.resize(size);
+    SIZE_T size_out = 0;
+    if (ReadProcessMemory(handle_,
+                          reinterpret_cast<void*>(start),
+                          coalesced.data(),
+                          size,
+                          &size_out) &&
+        size_out == size) {
+      for (size_t index = first; index < last; ++index) {
+        const ReadRequest& request = *sorted[index];
+        memcpy(request.buffer,
+               &coalesced[request.address - start],
+               static_cast<size_t>(request.size));
+      }
+    } else {
+      // Part of the span isn't readable after all. Read the group's requests
+      // individually, which reads as much as possible a page at a time and
+      // logs an appropriate message if any of them can't be read either.
+      for (size_t index = first; index < last; ++index) {
+        const ReadRequest& request = *sorted[index];
+        if (!Read(request.address, request.size, request.buffer)) {
+          return false;
+        }
+      }
+    }
+    first = last;
+  }
+
+  return true;
+}
+
 }  // namespace crashpad
@@ -17,6 +17,8 @@
 
 #include <windows.h>
 
+#include <vector>
+
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -57,6 +59,12 @@ class ProcessMemoryWin final : public ProcessMemory {
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  // Reads requests that are close together, and separated only by readable
+  // memory, with a single ReadProcessMemory() call, falling back to reading
+  // each request of a group that can't be read in one piece.
+  bool ReadBatchInternal(
+      const std::vector<ReadRequest>& requests) const override;
+
   HANDLE handle_;
   ProcessInfo process_info_;
   InitializationStateDcheck initialized_;
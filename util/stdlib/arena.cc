@@ -0,0 +1,94 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stdlib/arena.h"
+
+#include <stdint.h>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+namespace {
+
+char* AlignUp(char* pointer, size_t alignment) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+  return pointer + ((alignment - (address & (alignment - 1))) &
+                    (alignment - 1));
+}
+
+}  // namespace
+
+Arena::Arena(size_t block_size)
+    : retired_blocks_(),
+      current_block_(),
+      next_(nullptr),
+      end_(nullptr),
+      block_size_(block_size),
+      bytes_allocated_(0),
+      bytes_reserved_(0) {
+  DCHECK_GT(block_size_, 0u);
+}
+
+Arena::~Arena() = default;
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  DCHECK(alignment != 0 && (alignment & (alignment - 1)) == 0) << alignment;
+
+  if (current_block_) {
+    char* const aligned = AlignUp(next_, alignment);
+    if (aligned <= end_ && size <= static_cast<size_t>(end_ - aligned)) {
+      bytes_allocated_ += aligned + size - next_;
+      next_ = aligned + size;
+      return aligned;
+    }
+  }
+
+  // Large allocations get blocks of their own so that they don’t waste the
+  // remainder of the current block.
+  if (size > block_size_ / 4) {
+    std::unique_ptr<char[]> block = AllocateBlock(size + alignment - 1);
+    char* const aligned = AlignUp(block.get(), alignment);
+    bytes_allocated_ += size + alignment - 1;
+    retired_blocks_.push_back(std::move(block));
+    return aligned;
+  }
+
+  if (current_block_) {
+    retired_blocks_.push_back(std::move(current_block_));
+  }
+  current_block_ = AllocateBlock(block_size_ + alignment - 1);
+  char* const aligned = AlignUp(current_block_.get(), alignment);
+  end_ = current_block_.get() + block_size_ + alignment - 1;
+  bytes_allocated_ += aligned + size - current_block_.get();
+  next_ = aligned + size;
+  return aligned;
+}
+
+void Arena::Reset() {
+  retired_blocks_.clear();
+  bytes_reserved_ = 0;
+  bytes_allocated_ = 0;
+  if (current_block_) {
+    next_ = current_block_.get();
+    bytes_reserved_ = end_ - next_;
+  }
+}
+
+std::unique_ptr<char[]> Arena::AllocateBlock(size_t size) {
+  bytes_reserved_ += size;
+  return std::unique_ptr<char[]>(new char[size]);
+}
+
+}  // namespace crashpad
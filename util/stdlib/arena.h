@@ -0,0 +1,122 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_STDLIB_ARENA_H_
+#define CRASHPAD_UTIL_STDLIB_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief A deleter for objects constructed in an Arena.
+//!
+//! This runs the object’s destructor but leaves its storage to the Arena,
+//! which releases it all at once.
+struct ArenaDeleter {
+  template <typename T>
+  void operator()(T* object) const {
+    object->~T();
+  }
+};
+
+//! \brief An owning pointer to an object constructed in an Arena.
+//!
+//! An ArenaPtr must not outlive the Arena that its object was constructed in.
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+//! \brief Allocates memory from a small number of large blocks, releasing it
+//!     all in one step.
+//!
+//! Objects that make up a short-lived graph, such as the snapshot of a process
+//! that is written to a single report, can be allocated from an Arena instead
+//! of individually from the heap. This makes allocation cheap and avoids
+//! leaving the heap fragmented by many small allocations with similar
+//! lifetimes.
+//!
+//! Allocations larger than a quarter of the block size are made in blocks of
+//! their own.
+//!
+//! This class is not thread-safe.
+class Arena {
+ public:
+  //! \brief The default size of each block, in bytes.
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  //! \param[in] block_size The size of each block, in bytes.
+  explicit Arena(size_t block_size = kDefaultBlockSize);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  //! \brief Releases all memory allocated from this arena.
+  //!
+  //! Destructors are not run for objects constructed in the arena. Objects
+  //! returned by New() must have been destroyed before the arena is.
+  ~Arena();
+
+  //! \brief Allocates \a size bytes aligned to \a alignment.
+  //!
+  //! \param[in] size The number of bytes to allocate.
+  //! \param[in] alignment The required alignment, which must be a power of 2.
+  //!
+  //! \return The allocated memory, which remains valid until Reset() is called
+  //!     or the arena is destroyed. This function does not return `nullptr`.
+  void* Allocate(size_t size, size_t alignment);
+
+  //! \brief Constructs an object of type \a T in this arena.
+  //!
+  //! \return An owning pointer to the object, which runs its destructor when
+  //!     it is destroyed or reset. The object’s storage is not reused until
+  //!     Reset() is called or the arena is destroyed.
+  template <typename T, typename... Args>
+  ArenaPtr<T> New(Args&&... args) {
+    void* storage = Allocate(sizeof(T), alignof(T));
+    return ArenaPtr<T>(new (storage) T(std::forward<Args>(args)...));
+  }
+
+  //! \brief Releases all memory allocated from this arena, retaining one
+  //!     block for reuse.
+  //!
+  //! Any objects returned by New() must have been destroyed already.
+  void Reset();
+
+  //! \brief Returns the number of bytes handed out since this arena was
+  //!     constructed or last reset, including padding for alignment.
+  size_t BytesAllocated() const { return bytes_allocated_; }
+
+  //! \brief Returns the number of bytes held in blocks by this arena.
+  size_t BytesReserved() const { return bytes_reserved_; }
+
+ private:
+  // Allocates a block of size bytes and accounts for it in bytes_reserved_.
+  std::unique_ptr<char[]> AllocateBlock(size_t size);
+
+  std::vector<std::unique_ptr<char[]>> retired_blocks_;
+  std::unique_ptr<char[]> current_block_;
+  char* next_;
+  char* end_;
+  size_t block_size_;
+  size_t bytes_allocated_;
+  size_t bytes_reserved_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_STDLIB_ARENA_H_
@@ -0,0 +1,131 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stdlib/arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+bool IsAligned(void* pointer, size_t alignment) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+  return (address & (alignment - 1)) == 0;
+}
+
+TEST(Arena, Allocate) {
+  Arena arena(1024);
+  EXPECT_EQ(arena.BytesAllocated(), 0u);
+  EXPECT_EQ(arena.BytesReserved(), 0u);
+
+  std::vector<char*> allocations;
+  for (size_t index = 0; index < 100; ++index) {
+    char* allocation = static_cast<char*>(arena.Allocate(index + 1, 1));
+    memset(allocation, static_cast<int>(index), index + 1);
+    allocations.push_back(allocation);
+  }
+  EXPECT_GE(arena.BytesAllocated(), 100u * 101u / 2u);
+  EXPECT_GE(arena.BytesReserved(), arena.BytesAllocated());
+
+  for (size_t index = 0; index < allocations.size(); ++index) {
+    for (size_t offset = 0; offset <= index; ++offset) {
+      ASSERT_EQ(allocations[index][offset], static_cast<char>(index));
+    }
+  }
+}
+
+TEST(Arena, Alignment) {
+  Arena arena(1024);
+  for (size_t alignment = 1; alignment <= 128; alignment *= 2) {
+    arena.Allocate(1, 1);
+    EXPECT_TRUE(IsAligned(arena.Allocate(8, alignment), alignment))
+        << alignment;
+  }
+
+  // Large allocations get blocks of their own, which must be aligned too.
+  EXPECT_TRUE(IsAligned(arena.Allocate(4096, 64), 64));
+}
+
+TEST(Arena, LargeAllocationKeepsCurrentBlock) {
+  Arena arena(1024);
+  char* first = static_cast<char*>(arena.Allocate(16, 1));
+  arena.Allocate(4096, 1);
+  char* second = static_cast<char*>(arena.Allocate(16, 1));
+  EXPECT_EQ(second, first + 16);
+}
+
+TEST(Arena, New) {
+  class Counted {
+   public:
+    Counted(int* count, const std::string& name) : count_(count), name_(name) {
+      ++*count_;
+    }
+    ~Counted() { --*count_; }
+
+    const std::string& name() const { return name_; }
+
+   private:
+    int* count_;
+    std::string name_;
+  };
+
+  Arena arena;
+  int count = 0;
+  {
+    std::vector<ArenaPtr<Counted>> objects;
+    for (int index = 0; index < 10; ++index) {
+      objects.push_back(
+          arena.New<Counted>(&count, std::string(index + 1, 'a')));
+      EXPECT_TRUE(IsAligned(objects.back().get(), alignof(Counted)));
+    }
+    EXPECT_EQ(count, 10);
+    EXPECT_EQ(objects[4]->name(), "aaaaa");
+
+    objects[0].reset();
+    EXPECT_EQ(count, 9);
+  }
+  EXPECT_EQ(count, 0);
+}
+
+TEST(Arena, Reset) {
+  Arena arena(1024);
+  for (size_t index = 0; index < 10; ++index) {
+    arena.Allocate(200, 1);
+  }
+  arena.Allocate(4096, 1);
+  const size_t reserved = arena.BytesReserved();
+
+  arena.Reset();
+  EXPECT_EQ(arena.BytesAllocated(), 0u);
+  EXPECT_LT(arena.BytesReserved(), reserved);
+  EXPECT_GT(arena.BytesReserved(), 0u);
+
+  // The retained block is reused, so allocating as much as it holds doesn’t
+  // reserve any more memory.
+  const size_t retained = arena.BytesReserved();
+  EXPECT_NE(arena.Allocate(16, 1), nullptr);
+  arena.Allocate(256, 1);
+  EXPECT_EQ(arena.BytesReserved(), retained);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,11 +14,8 @@
 
 #include "util/stream/base94_output_stream.h"
 
-#include <algorithm>
-
 #include "base/check.h"
 #include "base/logging.h"
-#include "base/numerics/safe_conversions.h"
 
 namespace crashpad {
 
@@ -32,15 +29,37 @@ constexpr uint16_t kMaxValueOf14BitEncoding = (94 * 94 - 1) & 0x1FFF;
 
 constexpr size_t kMaxBuffer = 4096;
 
-inline uint8_t EncodeByte(uint8_t byte) {
-  DCHECK(byte < 94);
-  return (byte >= 94u) ? 0xff : (byte + '!');
-}
+// The pair of symbols encoding each value of a block, in the order that
+// they’re written.
+struct EncodeTable {
+  constexpr EncodeTable() {
+    for (size_t block = 0; block < 94 * 94; ++block) {
+      symbols[block][0] = static_cast<uint8_t>('!' + block % 94);
+      symbols[block][1] = static_cast<uint8_t>('!' + block / 94);
+    }
+  }
 
-inline uint8_t DecodeByte(uint8_t byte) {
-  DCHECK(byte >= '!' && byte <= '~');
-  return std::min(static_cast<uint8_t>(byte - '!'), static_cast<uint8_t>(94));
-}
+  uint8_t symbols[94 * 94][2] = {};
+};
+
+constexpr EncodeTable kEncodeTable;
+
+constexpr uint8_t kInvalidSymbol = 0xff;
+
+// The value of each symbol, or kInvalidSymbol for bytes that aren’t symbols.
+struct DecodeTable {
+  constexpr DecodeTable() {
+    for (size_t byte = 0; byte < 256; ++byte) {
+      values[byte] = byte >= '!' && byte <= '~'
+                         ? static_cast<uint8_t>(byte - '!')
+                         : kInvalidSymbol;
+    }
+  }
+
+  uint8_t values[256] = {};
+};
+
+constexpr DecodeTable kDecodeTable;
 
 }  // namespace
 
@@ -49,13 +68,13 @@ Base94OutputStream::Base94OutputStream(
     std::unique_ptr<OutputStreamInterface> output_stream)
     : mode_(mode),
       output_stream_(std::move(output_stream)),
+      buffer_(new uint8_t[kMaxBuffer]),
+      buffer_used_(0),
       bit_buf_(0),
       bit_count_(0),
       symbol_buffer_(0),
       flush_needed_(false),
-      flushed_(false) {
-  buffer_.reserve(kMaxBuffer);
-}
+      flushed_(false) {}
 
 Base94OutputStream::~Base94OutputStream() {
   DCHECK(!flush_needed_);
@@ -78,70 +97,100 @@ bool Base94OutputStream::Flush() {
 }
 
 bool Base94OutputStream::Encode(const uint8_t* data, size_t size) {
-  const uint8_t* cur = data;
-  while (size--) {
-    bit_buf_ |= *(cur++) << bit_count_;
-    bit_count_ += 8;
-    if (bit_count_ < 14)
-      continue;
+  // The state is kept in locals while encoding, because stores to buffer_
+  // could otherwise alias it.
+  uint64_t bit_buf = bit_buf_;
+  size_t bit_count = bit_count_;
+  uint8_t* const buffer = buffer_.get();
+  size_t buffer_used = buffer_used_;
+  const uint8_t* const end = data + size;
+  bool result = true;
+  while (data != end && result) {
+    // Take as many whole bytes as fit, and then encode as many blocks as
+    // there are bits for. Encoding a block as soon as 14 bits are available
+    // produces the same symbols no matter how the input is divided.
+    while (data != end && bit_count <= 56) {
+      bit_buf |= static_cast<uint64_t>(*data++) << bit_count;
+      bit_count += 8;
+    }
 
-    uint16_t block;
-    // Check if 13-bit or 14-bit data should be encoded.
-    if ((bit_buf_ & 0x1FFF) > kMaxValueOf14BitEncoding) {
-      block = bit_buf_ & 0x1FFF;
-      bit_buf_ >>= 13;
-      bit_count_ -= 13;
-    } else {
-      block = bit_buf_ & 0x3FFF;
-      bit_buf_ >>= 14;
-      bit_count_ -= 14;
+    while (bit_count >= 14) {
+      // Check if 13-bit or 14-bit data should be encoded.
+      const size_t block_bits =
+          (bit_buf & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+      const size_t block = bit_buf & ((1 << block_bits) - 1);
+      bit_buf >>= block_bits;
+      bit_count -= block_bits;
+      buffer[buffer_used++] = kEncodeTable.symbols[block][0];
+      buffer[buffer_used++] = kEncodeTable.symbols[block][1];
     }
-    buffer_.push_back(EncodeByte(block % 94));
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(block / 94)));
 
-    if (buffer_.size() > kMaxBuffer - 2 && !WriteOutputStream())
-      return false;
+    // Up to four blocks, or eight symbols, are encoded for each refill.
+    if (buffer_used > kMaxBuffer - 16) {
+      buffer_used_ = buffer_used;
+      result = WriteOutputStream();
+      buffer_used = 0;
+    }
   }
-  return WriteOutputStream();
+  bit_buf_ = bit_buf;
+  bit_count_ = bit_count;
+  buffer_used_ = buffer_used;
+  return result && WriteOutputStream();
 }
 
 bool Base94OutputStream::Decode(const uint8_t* data, size_t size) {
-  const uint8_t* cur = data;
-  while (size--) {
-    if (DecodeByte(*cur) == 94) {
+  // As in Encode(), the state is kept in locals while decoding.
+  uint64_t bit_buf = bit_buf_;
+  size_t bit_count = bit_count_;
+  uint8_t symbol = symbol_buffer_;
+  uint8_t* const buffer = buffer_.get();
+  size_t buffer_used = buffer_used_;
+  bool result = true;
+  for (const uint8_t* const end = data + size; data != end; ++data) {
+    const uint8_t value = kDecodeTable.values[*data];
+    if (value == kInvalidSymbol) {
       LOG(ERROR) << "Decode: invalid input";
-      return false;
+      result = false;
+      break;
     }
-    if (symbol_buffer_ == 0) {
-      symbol_buffer_ = *cur;
-      cur++;
+    if (symbol == 0) {
+      symbol = *data;
       continue;
     }
-    uint16_t v = DecodeByte(symbol_buffer_) + DecodeByte(*cur) * 94;
-    cur++;
-    symbol_buffer_ = 0;
-    bit_buf_ |= v << bit_count_;
-    bit_count_ += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
-    while (bit_count_ > 7) {
-      buffer_.push_back(bit_buf_ & 0xff);
-      bit_buf_ >>= 8;
-      bit_count_ -= 8;
+    const uint32_t v = kDecodeTable.values[symbol] + value * 94;
+    symbol = 0;
+    bit_buf |= static_cast<uint64_t>(v) << bit_count;
+    bit_count += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+    while (bit_count > 7) {
+      buffer[buffer_used++] = bit_buf & 0xff;
+      bit_buf >>= 8;
+      bit_count -= 8;
     }
-    if (buffer_.size() > kMaxBuffer - 2) {
-      if (!WriteOutputStream())
-        return false;
+
+    // Up to 21 bits are available, so at most two bytes are decoded.
+    if (buffer_used > kMaxBuffer - 2) {
+      buffer_used_ = buffer_used;
+      if (!WriteOutputStream()) {
+        result = false;
+        break;
+      }
+      buffer_used = 0;
     }
   }
-  return WriteOutputStream();
+  bit_buf_ = bit_buf;
+  bit_count_ = bit_count;
+  symbol_buffer_ = symbol;
+  buffer_used_ = buffer_used;
+  return result && WriteOutputStream();
 }
 
 bool Base94OutputStream::FinishEncoding() {
   if (bit_count_ == 0)
     return true;
   // Up to 13 bits data is left over.
-  buffer_.push_back(EncodeByte(bit_buf_ % 94));
+  buffer_[buffer_used_++] = kEncodeTable.symbols[bit_buf_][0];
   if (bit_buf_ > 93 || bit_count_ > 8)
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(bit_buf_ / 94)));
+    buffer_[buffer_used_++] = kEncodeTable.symbols[bit_buf_][1];
   bit_count_ = 0;
   bit_buf_ = 0;
   return WriteOutputStream();
@@ -154,8 +203,9 @@ bool Base94OutputStream::FinishDecoding() {
     DCHECK(!bit_buf_);
     return true;
   }
-  bit_buf_ |= DecodeByte(symbol_buffer_) << bit_count_;
-  buffer_.push_back(bit_buf_ & 0xff);
+  bit_buf_ |= static_cast<uint64_t>(kDecodeTable.values[symbol_buffer_])
+              << bit_count_;
+  buffer_[buffer_used_++] = bit_buf_ & 0xff;
   bit_buf_ >>= 8;
   // The remaining bits are either encode padding or zeros from bit shift.
   DCHECK(!bit_buf_);
@@ -163,11 +213,11 @@ bool Base94OutputStream::FinishDecoding() {
 }
 
 bool Base94OutputStream::WriteOutputStream() {
-  if (buffer_.empty())
+  if (buffer_used_ == 0)
     return true;
 
-  bool result = output_stream_->Write(buffer_.data(), buffer_.size());
-  buffer_.clear();
+  bool result = output_stream_->Write(buffer_.get(), buffer_used_);
+  buffer_used_ = 0;
   return result;
 }
 
@@ -19,7 +19,6 @@
 #include <stdint.h>
 
 #include <memory>
-#include <vector>
 
 #include "util/stream/output_stream_interface.h"
 
@@ -66,11 +65,12 @@ class Base94OutputStream : public OutputStreamInterface {
 
   Mode mode_;
   std::unique_ptr<OutputStreamInterface> output_stream_;
-  std::vector<uint8_t> buffer_;
-  uint32_t bit_buf_;
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t buffer_used_;
+  uint64_t bit_buf_;
   // The number of valid bit in bit_buf_.
   size_t bit_count_;
-  char symbol_buffer_;
+  uint8_t symbol_buffer_;
   bool flush_needed_;
   bool flushed_;
 };
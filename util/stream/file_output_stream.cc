@@ -20,7 +20,16 @@
 namespace crashpad {
 
 FileOutputStream::FileOutputStream(FileHandle file_handle)
-    : writer_(file_handle), flush_needed_(false), flushed_(false) {}
+    : handle_writer_(file_handle),
+      writer_(&handle_writer_),
+      flush_needed_(false),
+      flushed_(false) {}
+
+FileOutputStream::FileOutputStream(FileWriterInterface* file_writer)
+    : handle_writer_(kInvalidFileHandle),
+      writer_(file_writer),
+      flush_needed_(false),
+      flushed_(false) {}
 
 FileOutputStream::~FileOutputStream() {
   DCHECK(!flush_needed_);
@@ -29,7 +38,7 @@ FileOutputStream::~FileOutputStream() {
 bool FileOutputStream::Write(const uint8_t* data, size_t size) {
   DCHECK(!flushed_);
 
-  if (!writer_.Write(data, size)) {
+  if (!writer_->Write(data, size)) {
     LOG(ERROR) << "Write: Failed";
     return false;
   }
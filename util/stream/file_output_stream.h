@@ -27,6 +27,10 @@ class FileOutputStream : public OutputStreamInterface {
   //! \param[in] file_handle The file that this object writes to.
   explicit FileOutputStream(FileHandle file_handle);
 
+  //! \param[in] file_writer The writer that this object writes to. It must
+  //!     outlive this object.
+  explicit FileOutputStream(FileWriterInterface* file_writer);
+
   FileOutputStream(const FileOutputStream&) = delete;
   FileOutputStream& operator=(const FileOutputStream&) = delete;
 
@@ -37,7 +41,8 @@ class FileOutputStream : public OutputStreamInterface {
   bool Flush() override;
 
  private:
-  WeakFileHandleFileWriter writer_;
+  WeakFileHandleFileWriter handle_writer_;
+  FileWriterInterface* writer_;  // weak
   bool flush_needed_;
   bool flushed_;
 };
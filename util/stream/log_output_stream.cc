@@ -14,21 +14,47 @@
 
 #include "util/stream/log_output_stream.h"
 
+#include <errno.h>
 #include <string.h>
 
 #include <algorithm>
 
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "util/misc/clock.h"
+#include "util/misc/time.h"
 
 namespace crashpad {
 
-LogOutputStream::LogOutputStream(std::unique_ptr<Delegate> delegate)
+namespace {
+
+constexpr char kBeginMessage[] = "-----BEGIN CRASHPAD MINIDUMP-----";
+constexpr char kEndMessage[] = "-----END CRASHPAD MINIDUMP-----";
+constexpr char kAbortMessage[] = "-----ABORT CRASHPAD MINIDUMP-----";
+
+std::string ResumeMessage(size_t offset) {
+  return base::StringPrintf("-----RESUME CRASHPAD MINIDUMP AT %zu-----",
+                            offset);
+}
+
+}  // namespace
+
+LogOutputStream::LogOutputStream(std::unique_ptr<Delegate> delegate,
+                                 size_t resume_offset)
     : delegate_(std::move(delegate)),
+      message_lines_(0),
       output_count_(0),
+      stream_offset_(0),
+      logged_offset_(resume_offset),
+      resume_offset_(resume_offset),
+      rate_window_start_ns_(0),
+      rate_window_bytes_(0),
+      started_(false),
+      truncated_(false),
       flush_needed_(false),
       flushed_(false) {
-  buffer_.reserve(delegate_->LineWidth());
+  line_.reserve(delegate_->LineWidth());
 }
 
 LogOutputStream::~LogOutputStream() {
@@ -38,51 +64,107 @@ LogOutputStream::~LogOutputStream() {
 bool LogOutputStream::Write(const uint8_t* data, size_t size) {
   DCHECK(!flushed_);
 
-  static constexpr char kBeginMessage[] = "-----BEGIN CRASHPAD MINIDUMP-----";
-  if (output_count_ == 0 && WriteToLog(kBeginMessage) < 0) {
-    return false;
+  // Data that was logged before output was cut short is skipped.
+  if (stream_offset_ < resume_offset_) {
+    const size_t skip = std::min(resume_offset_ - stream_offset_, size);
+    stream_offset_ += skip;
+    data += skip;
+    size -= skip;
+    if (size == 0) {
+      return true;
+    }
+  }
+
+  if (!started_) {
+    started_ = true;
+    if (WriteToLog(kBeginMessage) < 0 ||
+        (resume_offset_ &&
+         WriteToLog(ResumeMessage(resume_offset_).c_str()) < 0)) {
+      return false;
+    }
   }
 
   flush_needed_ = true;
   while (size > 0) {
-    size_t m = std::min(delegate_->LineWidth() - buffer_.size(), size);
-    buffer_.append(reinterpret_cast<const char*>(data), m);
+    size_t m = std::min(delegate_->LineWidth() - line_.size(), size);
+    line_.append(reinterpret_cast<const char*>(data), m);
     data += m;
     size -= m;
-    if (buffer_.size() == delegate_->LineWidth() && !WriteBuffer()) {
+    stream_offset_ += m;
+    if (line_.size() == delegate_->LineWidth() && !WriteLine()) {
       return false;
     }
   }
   return true;
 }
 
-bool LogOutputStream::WriteBuffer() {
-  if (buffer_.empty())
+bool LogOutputStream::WriteLine() {
+  if (line_.empty())
     return true;
 
-  static constexpr char kAbortMessage[] = "-----ABORT CRASHPAD MINIDUMP-----";
-
-  output_count_ += buffer_.size();
+  output_count_ += line_.size();
   if (output_count_ > delegate_->OutputCap()) {
-    WriteToLog(kAbortMessage);
-    flush_needed_ = false;
+    // The lines already in message_ are within the cap.
+    if (WriteMessage()) {
+      Abort();
+    }
     return false;
   }
 
-  int result = WriteToLog(buffer_.c_str());
+  if (!message_.empty()) {
+    message_.push_back('\n');
+  }
+  message_.append(line_);
+  line_.clear();
+  if (++message_lines_ >= delegate_->LinesPerMessage()) {
+    return WriteMessage();
+  }
+  return true;
+}
+
+bool LogOutputStream::WriteMessage() {
+  if (message_.empty())
+    return true;
+
+  int result = WriteToLog(message_.c_str());
+  message_.clear();
+  message_lines_ = 0;
   if (result < 0) {
     if (result == -EAGAIN) {
-      WriteToLog(kAbortMessage);
+      Abort();
     }
     flush_needed_ = false;
     return false;
   }
 
-  buffer_.clear();
+  // Everything but a line still being collected has been logged.
+  logged_offset_ = stream_offset_ - line_.size();
   return true;
 }
 
+void LogOutputStream::Abort() {
+  truncated_ = true;
+  WriteToLog(ResumeMessage(logged_offset_).c_str());
+  WriteToLog(kAbortMessage);
+  flush_needed_ = false;
+}
+
 int LogOutputStream::WriteToLog(const char* buf) {
+  const size_t max_bytes_per_second = delegate_->MaxBytesPerSecond();
+  if (max_bytes_per_second) {
+    const size_t size = strlen(buf);
+    uint64_t now_ns = ClockMonotonicNanoseconds();
+    if (now_ns - rate_window_start_ns_ >= kNanosecondsPerSecond) {
+      rate_window_start_ns_ = now_ns;
+      rate_window_bytes_ = 0;
+    } else if (rate_window_bytes_ > 0 &&
+               rate_window_bytes_ + size > max_bytes_per_second) {
+      SleepNanoseconds(rate_window_start_ns_ + kNanosecondsPerSecond - now_ns);
+      rate_window_start_ns_ = ClockMonotonicNanoseconds();
+      rate_window_bytes_ = 0;
+    }
+    rate_window_bytes_ += size;
+  }
   return delegate_->Log(buf);
 }
 
@@ -92,8 +174,7 @@ bool LogOutputStream::Flush() {
     flush_needed_ = false;
     flushed_ = true;
 
-    static constexpr char kEndMessage[] = "-----END CRASHPAD MINIDUMP-----";
-    if (!WriteBuffer() || WriteToLog(kEndMessage) < 0) {
+    if (!WriteLine() || !WriteMessage() || WriteToLog(kEndMessage) < 0) {
       result = false;
     }
   }
@@ -26,6 +26,13 @@
 namespace crashpad {
 
 //! \brief This class outputs a stream of data as a series of log messages.
+//!
+//! The data is preceded by a “BEGIN” marker and followed by an “END” marker.
+//! If the output is cut short, by reaching the delegate’s output cap or by the
+//! log refusing a message, a “RESUME” marker carrying the offset of the data
+//! not yet logged is written, followed by an “ABORT” marker. A later
+//! LogOutputStream constructed with that offset can continue the output from
+//! there, given the same data.
 class LogOutputStream : public OutputStreamInterface {
  public:
   //! \brief An interface to a log output sink.
@@ -44,31 +51,73 @@ class LogOutputStream : public OutputStreamInterface {
     //! \brief Returns the maximum number of bytes to allow writing to this log.
     virtual size_t OutputCap() = 0;
 
-    //! \brief Returns the maximum length of buffers allowed to be passed to
-    //!     Log().
+    //! \brief Returns the maximum length of lines of data.
     virtual size_t LineWidth() = 0;
+
+    //! \brief Returns the maximum number of lines of data to pass to each call
+    //!     to Log(), separated by newlines.
+    //!
+    //! The default implementation returns `1`.
+    virtual size_t LinesPerMessage() { return 1; }
+
+    //! \brief Returns the maximum number of bytes to pass to Log() within any
+    //!     second, or `0` for no limit.
+    //!
+    //! Output is delayed as needed to stay within this rate. The default
+    //! implementation returns `0`.
+    virtual size_t MaxBytesPerSecond() { return 0; }
   };
 
-  explicit LogOutputStream(std::unique_ptr<Delegate> delegate);
+  //! \param[in] delegate The log output sink.
+  //! \param[in] resume_offset The offset in the data at which to begin output,
+  //!     as returned by ResumeOffset() for output that was cut short. Data
+  //!     before this offset is discarded.
+  explicit LogOutputStream(std::unique_ptr<Delegate> delegate,
+                           size_t resume_offset = 0);
 
   LogOutputStream(const LogOutputStream&) = delete;
   LogOutputStream& operator=(const LogOutputStream&) = delete;
 
   ~LogOutputStream() override;
 
+  //! \brief Returns the offset in the data at which to resume output that was
+  //!     cut short, or `0` if it wasn’t.
+  size_t ResumeOffset() const { return truncated_ ? logged_offset_ : 0; }
+
   // OutputStreamInterface:
   bool Write(const uint8_t* data, size_t size) override;
   bool Flush() override;
 
  private:
-  // Flushes buffer_, returning false on failure.
-  bool WriteBuffer();
+  // Adds line_ to message_, logging message_ if it’s full, and returns false
+  // on failure.
+  bool WriteLine();
+
+  // Logs message_, returning false on failure.
+  bool WriteMessage();
+
+  // Logs the markers for output that’s cut short.
+  void Abort();
 
   int WriteToLog(const char* buf);
 
-  std::string buffer_;
+  std::string line_;
+  std::string message_;
   std::unique_ptr<Delegate> delegate_;
+  size_t message_lines_;
   size_t output_count_;
+
+  // The offset in the data of the next byte passed to Write().
+  size_t stream_offset_;
+
+  // The offset in the data of the first byte that hasn’t been logged.
+  size_t logged_offset_;
+
+  const size_t resume_offset_;
+  uint64_t rate_window_start_ns_;
+  size_t rate_window_bytes_;
+  bool started_;
+  bool truncated_;
   bool flush_needed_;
   bool flushed_;
 };
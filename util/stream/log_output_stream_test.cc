@@ -14,11 +14,15 @@
 
 #include "util/stream/log_output_stream.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <memory>
 #include <string>
 
 #include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/misc/time.h"
 
 namespace crashpad {
 namespace test {
@@ -30,24 +34,50 @@ const char* kBeginGuard = "-----BEGIN CRASHPAD MINIDUMP-----";
 const char* kEndGuard = "-----END CRASHPAD MINIDUMP-----";
 const char* kAbortGuard = "-----ABORT CRASHPAD MINIDUMP-----";
 
+std::string ResumeGuard(size_t offset) {
+  return "-----RESUME CRASHPAD MINIDUMP AT " + std::to_string(offset) + "-----";
+}
+
 class LogOutputStreamTestDelegate final : public LogOutputStream::Delegate {
  public:
-  explicit LogOutputStreamTestDelegate(std::string* logging_destination)
-      : logging_destination_(logging_destination) {}
+  explicit LogOutputStreamTestDelegate(std::string* logging_destination,
+                                       size_t lines_per_message = 1,
+                                       size_t max_bytes_per_second = 0,
+                                       size_t* log_count = nullptr)
+      : logging_destination_(logging_destination),
+        lines_per_message_(lines_per_message),
+        max_bytes_per_second_(max_bytes_per_second),
+        log_count_(log_count) {}
   ~LogOutputStreamTestDelegate() override = default;
 
   int Log(const char* buf) override {
-    size_t len = strnlen(buf, kLineBufferSize + 1);
-    EXPECT_LE(len, kLineBufferSize);
-    logging_destination_->append(buf, len);
+    const size_t max_len = lines_per_message_ * (kLineBufferSize + 1) - 1;
+    size_t len = strnlen(buf, max_len + 1);
+    EXPECT_LE(len, max_len);
+    for (const char* line = buf; line < buf + len;) {
+      const char* newline =
+          static_cast<const char*>(memchr(line, '\n', buf + len - line));
+      const char* line_end = newline ? newline : buf + len;
+      EXPECT_LE(static_cast<size_t>(line_end - line), kLineBufferSize);
+      logging_destination_->append(line, line_end - line);
+      line = line_end + 1;
+    }
+    if (log_count_) {
+      ++*log_count_;
+    }
     return static_cast<int>(len);
   }
 
   size_t OutputCap() override { return kOutputCap; }
   size_t LineWidth() override { return kLineBufferSize; }
+  size_t LinesPerMessage() override { return lines_per_message_; }
+  size_t MaxBytesPerSecond() override { return max_bytes_per_second_; }
 
  private:
   std::string* logging_destination_;
+  size_t lines_per_message_;
+  size_t max_bytes_per_second_;
+  size_t* log_count_;
 };
 
 class LogOutputStreamTest : public testing::Test {
@@ -110,6 +140,64 @@ TEST_F(LogOutputStreamTest, WriteAbort) {
       kAbortGuard);
 }
 
+TEST_F(LogOutputStreamTest, WriteAbortAndResume) {
+  size_t input_length = kOutputCap + kLineBufferSize;
+  const uint8_t* input = BuildDeterministicInput(input_length);
+  EXPECT_FALSE(log_stream()->Write(input, input_length));
+  EXPECT_EQ(log_stream()->ResumeOffset(), kOutputCap);
+  const std::string truncated_tail = ResumeGuard(kOutputCap) + kAbortGuard;
+  ASSERT_GE(test_log_output().size(), truncated_tail.size());
+  EXPECT_EQ(test_log_output().substr(test_log_output().size() -
+                                     truncated_tail.size()),
+            truncated_tail);
+
+  std::string resumed_log_output;
+  LogOutputStream resumed_log_stream(
+      std::make_unique<LogOutputStreamTestDelegate>(&resumed_log_output),
+      log_stream()->ResumeOffset());
+  EXPECT_TRUE(resumed_log_stream.Write(input, input_length));
+  EXPECT_TRUE(resumed_log_stream.Flush());
+  EXPECT_EQ(resumed_log_stream.ResumeOffset(), 0u);
+  EXPECT_EQ(resumed_log_output,
+            std::string(kBeginGuard) + ResumeGuard(kOutputCap) +
+                std::string(kLineBufferSize, 'a') + kEndGuard);
+}
+
+TEST_F(LogOutputStreamTest, LinesPerMessage) {
+  std::string log_output;
+  size_t log_count = 0;
+  LogOutputStream log_stream(std::make_unique<LogOutputStreamTestDelegate>(
+      &log_output, 3, 0, &log_count));
+  size_t input_length = kLineBufferSize * 7 + kLineBufferSize / 2;
+  const uint8_t* input = BuildDeterministicInput(input_length);
+  EXPECT_TRUE(log_stream.Write(input, input_length));
+  EXPECT_TRUE(log_stream.Flush());
+  EXPECT_EQ(log_output,
+            std::string(kBeginGuard) + std::string(input_length, 'a') +
+                kEndGuard);
+
+  // The eight lines of data are logged in three messages, between the two
+  // guards.
+  EXPECT_EQ(log_count, 5u);
+}
+
+TEST_F(LogOutputStreamTest, MaxBytesPerSecond) {
+  std::string log_output;
+  LogOutputStream log_stream(std::make_unique<LogOutputStreamTestDelegate>(
+      &log_output, 1, kLineBufferSize * 3));
+  size_t input_length = kLineBufferSize * 3;
+  const uint8_t* input = BuildDeterministicInput(input_length);
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  EXPECT_TRUE(log_stream.Write(input, input_length));
+  EXPECT_TRUE(log_stream.Flush());
+  const uint64_t elapsed_ns = ClockMonotonicNanoseconds() - start_ns;
+  EXPECT_EQ(log_output.size(),
+            strlen(kBeginGuard) + input_length + strlen(kEndGuard));
+
+  // The guards and three lines don’t fit in one second’s worth of output.
+  EXPECT_GE(elapsed_ns, kNanosecondsPerSecond);
+}
+
 TEST_F(LogOutputStreamTest, FlushAbort) {
   size_t input_length = kOutputCap - strlen(kBeginGuard) + kLineBufferSize / 2;
   const uint8_t* input = BuildDeterministicInput(input_length);
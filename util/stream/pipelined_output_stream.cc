@@ -0,0 +1,146 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/pipelined_output_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class PipelinedOutputStream::WorkerThread final : public Thread {
+ public:
+  explicit WorkerThread(PipelinedOutputStream* stream)
+      : Thread(), stream_(stream) {}
+
+  WorkerThread(const WorkerThread&) = delete;
+  WorkerThread& operator=(const WorkerThread&) = delete;
+
+  ~WorkerThread() override = default;
+
+ private:
+  void ThreadMain() override { stream_->ConsumeSlots(); }
+
+  PipelinedOutputStream* stream_;  // weak
+};
+
+PipelinedOutputStream::PipelinedOutputStream(
+    std::unique_ptr<OutputStreamInterface> output_stream,
+    size_t block_size,
+    size_t queue_depth)
+    : slots_(queue_depth),
+      active_(),
+      output_stream_(std::move(output_stream)),
+      thread_(),
+      free_slots_(static_cast<int>(queue_depth)),
+      filled_slots_(0),
+      block_size_(block_size),
+      produce_index_(0),
+      consume_index_(0),
+      failed_(false),
+      flush_result_(false),
+      running_(true) {
+  DCHECK(output_stream_);
+  DCHECK_GT(block_size_, 0u);
+  DCHECK_GT(queue_depth, 0u);
+  thread_ = std::make_unique<WorkerThread>(this);
+  thread_->Start();
+}
+
+PipelinedOutputStream::~PipelinedOutputStream() {
+  if (running_) {
+    active_.clear();
+    Submit(SlotKind::kStop);
+    thread_->Join();
+  }
+}
+
+bool PipelinedOutputStream::Write(const uint8_t* data, size_t size) {
+  DCHECK(running_);
+  if (failed_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  while (size > 0) {
+    if (active_.capacity() < block_size_) {
+      active_.reserve(block_size_);
+    }
+    const size_t slice = std::min(size, block_size_ - active_.size());
+    active_.insert(active_.end(), data, data + slice);
+    data += slice;
+    size -= slice;
+
+    if (active_.size() == block_size_) {
+      Submit(SlotKind::kData);
+    }
+  }
+  return true;
+}
+
+bool PipelinedOutputStream::Flush() {
+  DCHECK(running_);
+  if (!active_.empty()) {
+    Submit(SlotKind::kData);
+  }
+  Submit(SlotKind::kFlush);
+  thread_->Join();
+  running_ = false;
+  return flush_result_;
+}
+
+void PipelinedOutputStream::Submit(SlotKind kind) {
+  free_slots_.Wait();
+  Slot& slot = slots_[produce_index_];
+  produce_index_ = (produce_index_ + 1) % slots_.size();
+
+  // The worker leaves consumed slots empty but allocated, so that active_
+  // takes over a previously used buffer here.
+  std::swap(slot.data, active_);
+  slot.kind = kind;
+  filled_slots_.Signal();
+}
+
+void PipelinedOutputStream::ConsumeSlots() {
+  while (true) {
+    filled_slots_.Wait();
+    Slot& slot = slots_[consume_index_];
+    consume_index_ = (consume_index_ + 1) % slots_.size();
+
+    switch (slot.kind) {
+      case SlotKind::kData:
+        // Once the wrapped stream has failed, the rest of the data is dropped.
+        if (!failed_.load(std::memory_order_relaxed) &&
+            !output_stream_->Write(slot.data.data(), slot.data.size())) {
+          failed_.store(true, std::memory_order_relaxed);
+        }
+        break;
+
+      case SlotKind::kFlush:
+        flush_result_ =
+            !failed_.load(std::memory_order_relaxed) && output_stream_->Flush();
+        return;
+
+      case SlotKind::kStop:
+        return;
+    }
+
+    slot.data.clear();
+    free_slots_.Signal();
+  }
+}
+
+}  // namespace crashpad
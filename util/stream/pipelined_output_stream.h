@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_STREAM_PIPELINED_OUTPUT_STREAM_H_
+#define CRASHPAD_UTIL_STREAM_PIPELINED_OUTPUT_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/stream/output_stream_interface.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+
+//! \brief An output stream that runs the stream it wraps on its own thread.
+//!
+//! Data written to this object is gathered into blocks. Each full block is
+//! placed in a bounded queue, and a worker thread passes the blocks from the
+//! queue to the wrapped stream. The caller only waits when the queue is
+//! full.
+//!
+//! Stacking these objects splits a stream pipeline into stages that run on
+//! separate cores. For example, placing one in front of a ZlibOutputStream
+//! and another between that ZlibOutputStream and a FileOutputStream lets
+//! data be produced, compressed, and written all at once.
+//!
+//! The queue is used by one producer, the caller, and one consumer, the
+//! worker thread. Neither side takes a lock. The two sides only wait on
+//! semaphores that count the free and filled slots in the queue.
+//!
+//! Errors from the wrapped stream are seen by a later call to Write() or by
+//! Flush().
+class PipelinedOutputStream : public OutputStreamInterface {
+ public:
+  //! \brief The block size used when none is specified.
+  static constexpr size_t kDefaultBlockSize = 256 * 1024;
+
+  //! \brief The queue length used when none is specified.
+  static constexpr size_t kDefaultQueueDepth = 4;
+
+  //! \param[in] output_stream The stream that the worker thread writes to.
+  //! \param[in] block_size The amount of data gathered before a block is
+  //!     placed in the queue.
+  //! \param[in] queue_depth The number of blocks that may wait to be written
+  //!     to \a output_stream.
+  explicit PipelinedOutputStream(
+      std::unique_ptr<OutputStreamInterface> output_stream,
+      size_t block_size = kDefaultBlockSize,
+      size_t queue_depth = kDefaultQueueDepth);
+
+  PipelinedOutputStream(const PipelinedOutputStream&) = delete;
+  PipelinedOutputStream& operator=(const PipelinedOutputStream&) = delete;
+
+  //! \brief Stops the worker thread.
+  //!
+  //! Data not yet passed to Flush() is discarded, and the wrapped stream is
+  //! not flushed.
+  ~PipelinedOutputStream() override;
+
+  // OutputStreamInterface:
+  bool Write(const uint8_t* data, size_t size) override;
+
+  //! \copydoc OutputStreamInterface::Flush()
+  //!
+  //! This waits for all queued blocks to be written, then flushes the wrapped
+  //! stream on the worker thread, and stops that thread.
+  bool Flush() override;
+
+ private:
+  class WorkerThread;
+
+  enum class SlotKind {
+    // The slot holds data for the wrapped stream.
+    kData,
+
+    // The wrapped stream should be flushed, and the worker should exit.
+    kFlush,
+
+    // The worker should exit without flushing the wrapped stream.
+    kStop,
+  };
+
+  struct Slot {
+    std::vector<uint8_t> data;
+    SlotKind kind;
+  };
+
+  // Places active_ in the next free slot, waiting for one if necessary.
+  void Submit(SlotKind kind);
+
+  // Called on the worker thread.
+  void ConsumeSlots();
+
+  std::vector<Slot> slots_;
+  std::vector<uint8_t> active_;
+  std::unique_ptr<OutputStreamInterface> output_stream_;
+  std::unique_ptr<WorkerThread> thread_;
+  Semaphore free_slots_;
+  Semaphore filled_slots_;
+  size_t block_size_;
+
+  // Each index is only used by one side of the queue.
+  size_t produce_index_;
+  size_t consume_index_;
+
+  std::atomic<bool> failed_;
+
+  // Set by the worker thread before it exits, and read after joining it.
+  bool flush_result_;
+  bool running_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_STREAM_PIPELINED_OUTPUT_STREAM_H_
@@ -0,0 +1,139 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/pipelined_output_stream.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/stream/test_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<uint8_t> BuildInput(size_t size) {
+  std::vector<uint8_t> input(size);
+  for (size_t index = 0; index < size; ++index) {
+    input[index] = static_cast<uint8_t>(index * 7 + index / 256);
+  }
+  return input;
+}
+
+// Fails every Write() after the first.
+class FailingOutputStream : public OutputStreamInterface {
+ public:
+  FailingOutputStream() = default;
+
+  FailingOutputStream(const FailingOutputStream&) = delete;
+  FailingOutputStream& operator=(const FailingOutputStream&) = delete;
+
+  ~FailingOutputStream() override = default;
+
+  bool Write(const uint8_t* data, size_t size) override {
+    return writes_++ == 0;
+  }
+  bool Flush() override { return true; }
+
+ private:
+  size_t writes_ = 0;
+};
+
+TEST(PipelinedOutputStream, WritesBlocksInOrder) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output = test_output_stream.get();
+  PipelinedOutputStream stream(std::move(test_output_stream), 16, 2);
+
+  const std::vector<uint8_t> input = BuildInput(1000);
+  for (size_t offset = 0; offset < input.size(); offset += 7) {
+    const size_t size = std::min(input.size() - offset, size_t{7});
+    EXPECT_TRUE(stream.Write(&input[offset], size));
+  }
+  EXPECT_TRUE(stream.Flush());
+
+  EXPECT_EQ(test_output->all_data(), input);
+  EXPECT_EQ(test_output->flush_count(), 1u);
+
+  // 62 full blocks and one partial block of 8 bytes.
+  EXPECT_EQ(test_output->write_count(), 63u);
+  EXPECT_EQ(test_output->last_written_data().size(), 8u);
+}
+
+TEST(PipelinedOutputStream, LargeWrite) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output = test_output_stream.get();
+  PipelinedOutputStream stream(std::move(test_output_stream), 64, 1);
+
+  const std::vector<uint8_t> input = BuildInput(64 * 10);
+  EXPECT_TRUE(stream.Write(input.data(), input.size()));
+  EXPECT_TRUE(stream.Flush());
+  EXPECT_EQ(test_output->all_data(), input);
+  EXPECT_EQ(test_output->write_count(), 10u);
+}
+
+TEST(PipelinedOutputStream, EmptyFlush) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output = test_output_stream.get();
+  PipelinedOutputStream stream(std::move(test_output_stream));
+
+  EXPECT_TRUE(stream.Flush());
+  EXPECT_EQ(test_output->write_count(), 0u);
+  EXPECT_EQ(test_output->flush_count(), 1u);
+}
+
+TEST(PipelinedOutputStream, DestroyWithoutFlush) {
+  // Destruction must stop the worker even with data still queued.
+  PipelinedOutputStream stream(std::make_unique<FailingOutputStream>(), 4);
+  const std::vector<uint8_t> input = BuildInput(10);
+  EXPECT_TRUE(stream.Write(input.data(), input.size()));
+}
+
+TEST(PipelinedOutputStream, Failure) {
+  PipelinedOutputStream stream(std::make_unique<FailingOutputStream>(), 4, 1);
+
+  const std::vector<uint8_t> input = BuildInput(4);
+  bool failed = false;
+  for (int index = 0; index < 100 && !failed; ++index) {
+    failed = !stream.Write(input.data(), input.size());
+  }
+  EXPECT_FALSE(stream.Flush());
+}
+
+TEST(PipelinedOutputStream, CompressionStages) {
+  // Produce → compress → decompress → collect, with each stage on its own
+  // thread.
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output = test_output_stream.get();
+  auto decompress = std::make_unique<ZlibOutputStream>(
+      ZlibOutputStream::Mode::kDecompress,
+      std::make_unique<PipelinedOutputStream>(std::move(test_output_stream),
+                                              1024));
+  auto compress = std::make_unique<ZlibOutputStream>(
+      ZlibOutputStream::Mode::kCompress,
+      std::make_unique<PipelinedOutputStream>(std::move(decompress), 512));
+  PipelinedOutputStream stream(std::move(compress), 4096);
+
+  const std::vector<uint8_t> input = BuildInput(256 * 1024);
+  EXPECT_TRUE(stream.Write(input.data(), input.size()));
+  EXPECT_TRUE(stream.Flush());
+  EXPECT_EQ(test_output->all_data(), input);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
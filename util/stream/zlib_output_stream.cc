@@ -14,6 +14,7 @@
 
 #include "util/stream/zlib_output_stream.h"
 
+#include <algorithm>
 #include <iterator>
 
 #include "base/check.h"
@@ -26,8 +27,18 @@ namespace crashpad {
 ZlibOutputStream::ZlibOutputStream(
     Mode mode,
     std::unique_ptr<OutputStreamInterface> output_stream)
-    : output_stream_(std::move(output_stream)),
+    : ZlibOutputStream(mode, Format::kZlib, std::move(output_stream)) {}
+
+ZlibOutputStream::ZlibOutputStream(
+    Mode mode,
+    Format format,
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : parallel_input_(),
+      parallel_output_(),
+      parallel_compressor_(),
+      output_stream_(std::move(output_stream)),
       mode_(mode),
+      format_(format),
       initialized_(),
       flush_needed_(false) {}
 
@@ -44,7 +55,47 @@ ZlibOutputStream::~ZlibOutputStream() {
   }
 }
 
+void ZlibOutputStream::SetCompressionThreads(size_t threads) {
+  DCHECK(initialized_.is_uninitialized());
+  DCHECK(parallel_input_.empty());
+  if (mode_ != Mode::kCompress || format_ != Format::kGzip || threads <= 1) {
+    parallel_compressor_.reset();
+    return;
+  }
+  parallel_compressor_ = std::make_unique<ParallelGzipCompressor>(threads);
+}
+
 bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
+  if (parallel_compressor_) {
+    // Input is gathered into whole batches, except that a caller’s batch-sized
+    // runs are compressed where they are.
+    const size_t batch_size = parallel_compressor_->BatchSize();
+    while (size > 0) {
+      if (parallel_input_.empty() && size >= batch_size) {
+        if (!CompressParallel(data, batch_size, false)) {
+          return false;
+        }
+        data += batch_size;
+        size -= batch_size;
+        continue;
+      }
+
+      const size_t chunk = std::min(size, batch_size - parallel_input_.size());
+      parallel_input_.insert(parallel_input_.end(), data, data + chunk);
+      data += chunk;
+      size -= chunk;
+      if (parallel_input_.size() == batch_size) {
+        if (!CompressParallel(
+                parallel_input_.data(), parallel_input_.size(), false)) {
+          return false;
+        }
+        parallel_input_.clear();
+      }
+    }
+    flush_needed_ = true;
+    return true;
+  }
+
   if (initialized_.is_uninitialized()) {
     initialized_.set_invalid();
 
@@ -52,14 +103,28 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
     zlib_stream_.zfree = Z_NULL;
     zlib_stream_.opaque = Z_NULL;
 
+    constexpr int kZlibMaxWindowBits = 15;
+    constexpr int kZlibDefaultMemoryLevel = 8;
+
     if (mode_ == Mode::kDecompress) {
-      int result = inflateInit(&zlib_stream_);
+      int result =
+          format_ == Format::kGzip
+              ? inflateInit2(&zlib_stream_, ZlibWindowBitsWithGzipWrapper(0))
+              : inflateInit(&zlib_stream_);
       if (result != Z_OK) {
         LOG(ERROR) << "inflateInit: " << ZlibErrorString(result);
         return false;
       }
     } else if (mode_ == Mode::kCompress) {
-      int result = deflateInit(&zlib_stream_, Z_BEST_COMPRESSION);
+      int result =
+          format_ == Format::kGzip
+              ? deflateInit2(&zlib_stream_,
+                             Z_DEFAULT_COMPRESSION,
+                             Z_DEFLATED,
+                             ZlibWindowBitsWithGzipWrapper(kZlibMaxWindowBits),
+                             kZlibDefaultMemoryLevel,
+                             Z_DEFAULT_STRATEGY)
+              : deflateInit(&zlib_stream_, Z_BEST_COMPRESSION);
       if (result != Z_OK) {
         LOG(ERROR) << "deflateInit: " << ZlibErrorString(result);
         return false;
@@ -86,8 +151,17 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
       int result = inflate(&zlib_stream_, Z_NO_FLUSH);
       if (result == Z_STREAM_END) {
         if (zlib_stream_.avail_in > 0) {
-          LOG(ERROR) << "inflate: unconsumed input";
-          return false;
+          if (format_ != Format::kGzip) {
+            LOG(ERROR) << "inflate: unconsumed input";
+            return false;
+          }
+
+          // Another gzip member follows.
+          result = inflateReset(&zlib_stream_);
+          if (result != Z_OK) {
+            LOG(ERROR) << "inflateReset: " << ZlibErrorString(result);
+            return false;
+          }
         }
       } else if (result != Z_OK) {
         LOG(ERROR) << "inflate: " << zlib_stream_.msg;
@@ -103,6 +177,20 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
 }
 
 bool ZlibOutputStream::Flush() {
+  if (parallel_compressor_) {
+    if (flush_needed_) {
+      flush_needed_ = false;
+      const bool compressed = CompressParallel(
+          parallel_input_.data(), parallel_input_.size(), true);
+      parallel_input_.clear();
+      parallel_input_.shrink_to_fit();
+      if (!compressed) {
+        return false;
+      }
+    }
+    return output_stream_->Flush();
+  }
+
   if (initialized_.is_valid() && flush_needed_) {
     flush_needed_ = false;
     int result = Z_OK;
@@ -138,4 +226,16 @@ bool ZlibOutputStream::WriteOutputStream() {
   return true;
 }
 
+bool ZlibOutputStream::CompressParallel(const uint8_t* data,
+                                        size_t size,
+                                        bool finish) {
+  parallel_output_.clear();
+  if (!parallel_compressor_->Compress(data, size, finish, &parallel_output_)) {
+    return false;
+  }
+  return parallel_output_.empty() ||
+         output_stream_->Write(parallel_output_.data(),
+                               parallel_output_.size());
+}
+
 }  // namespace crashpad
@@ -19,9 +19,11 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "third_party/zlib/zlib_crashpad.h"
 #include "util/misc/initialization_state.h"
+#include "util/misc/parallel_gzip.h"
 #include "util/stream/output_stream_interface.h"
 
 namespace crashpad {
@@ -37,6 +39,16 @@ class ZlibOutputStream : public OutputStreamInterface {
     kDecompress = true
   };
 
+  //! \brief The wrapper around the compressed data.
+  enum class Format : bool {
+    //! \brief The zlib wrapper, as described by RFC 1950.
+    kZlib = false,
+
+    //! \brief The gzip wrapper, as described by RFC 1952. When decompressing,
+    //!     consecutive gzip members are decompressed as a single stream.
+    kGzip = true,
+  };
+
   //! \param[in] mode The work mode of this object.
   //! \param[in] output_stream The output_stream that this object writes to.
   //!
@@ -56,11 +68,32 @@ class ZlibOutputStream : public OutputStreamInterface {
   ZlibOutputStream(Mode mode,
                    std::unique_ptr<OutputStreamInterface> output_stream);
 
+  //! \param[in] mode The work mode of this object.
+  //! \param[in] format The wrapper around the compressed data. Data compressed
+  //!     with Format::kGzip uses the default compression level, as
+  //!     GzipHTTPBodyStream does, instead of the best compression level.
+  //! \param[in] output_stream The output_stream that this object writes to.
+  ZlibOutputStream(Mode mode,
+                   Format format,
+                   std::unique_ptr<OutputStreamInterface> output_stream);
+
   ZlibOutputStream(const ZlibOutputStream&) = delete;
   ZlibOutputStream& operator=(const ZlibOutputStream&) = delete;
 
   ~ZlibOutputStream() override;
 
+  //! \brief Sets the number of threads that compress data at once.
+  //!
+  //! When \a threads is greater than `1`, input is buffered and compressed by
+  //! ParallelGzipCompressor, which produces a single `gzip` member from blocks
+  //! compressed on up to \a threads threads. This only applies to objects
+  //! constructed with Mode::kCompress and Format::kGzip, and must be called
+  //! before the first call to Write().
+  //!
+  //! \param[in] threads The maximum number of threads, including the thread
+  //!     calling Write() and Flush(), to compress with. The default is `1`.
+  void SetCompressionThreads(size_t threads);
+
   // OutputStreamInterface:
   bool Write(const uint8_t* data, size_t size) override;
   bool Flush() override;
@@ -70,10 +103,18 @@ class ZlibOutputStream : public OutputStreamInterface {
   // buffer in |zlib_stream_|.
   bool WriteOutputStream();
 
+  // Compresses |size| bytes at |data| with |parallel_compressor_| and writes
+  // the result to |output_stream_|.
+  bool CompressParallel(const uint8_t* data, size_t size, bool finish);
+
   uint8_t buffer_[4096];
+  std::vector<uint8_t> parallel_input_;
+  std::vector<uint8_t> parallel_output_;
+  std::unique_ptr<ParallelGzipCompressor> parallel_compressor_;
   z_stream zlib_stream_;
   std::unique_ptr<OutputStreamInterface> output_stream_;
   Mode mode_;
+  Format format_;
   InitializationState initialized_;  // protects zlib_stream_
   bool flush_needed_;
 };
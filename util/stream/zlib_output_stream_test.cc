@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include "base/containers/heap_array.h"
 #include "base/rand_util.h"
@@ -182,6 +184,73 @@ TEST_F(ZlibOutputStreamTest, WriteEmptyData) {
   EXPECT_TRUE(test_output_stream().all_data().empty());
 }
 
+std::vector<uint8_t> GzipCompress(const std::string& data) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream zlib_output_stream(ZlibOutputStream::Mode::kCompress,
+                                      ZlibOutputStream::Format::kGzip,
+                                      std::move(test_output_stream));
+  EXPECT_TRUE(zlib_output_stream.Write(
+      reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+  EXPECT_TRUE(zlib_output_stream.Flush());
+  return test_output_stream_weak->all_data();
+}
+
+TEST(ZlibOutputStreamGzip, ConcatenatedMembers) {
+  static constexpr char kFirst[] = "The first gzip member. ";
+  static constexpr char kSecond[] = "The second gzip member.";
+
+  std::vector<uint8_t> compressed = GzipCompress(kFirst);
+  ASSERT_GE(compressed.size(), 2u);
+  EXPECT_EQ(compressed[0], 0x1f);
+  EXPECT_EQ(compressed[1], 0x8b);
+  const std::vector<uint8_t> second = GzipCompress(kSecond);
+  compressed.insert(compressed.end(), second.begin(), second.end());
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream zlib_output_stream(ZlibOutputStream::Mode::kDecompress,
+                                      ZlibOutputStream::Format::kGzip,
+                                      std::move(test_output_stream));
+  EXPECT_TRUE(zlib_output_stream.Write(compressed.data(), compressed.size()));
+  EXPECT_TRUE(zlib_output_stream.Flush());
+
+  const std::vector<uint8_t>& all_data = test_output_stream_weak->all_data();
+  EXPECT_EQ(std::string(all_data.begin(), all_data.end()),
+            std::string(kFirst) + kSecond);
+}
+
+TEST(ZlibOutputStreamGzip, CompressionThreads) {
+  // Several batches' worth of input written in uneven pieces, so that the
+  // threaded path both buffers writes and compresses them in place.
+  std::string data;
+  for (size_t index = 0; data.size() < 5 * 1024 * 1024; ++index) {
+    data += base::StringPrintf("line %zu of a threaded gzip stream\n", index);
+  }
+
+  auto decompressed_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* decompressed_stream_weak = decompressed_stream.get();
+  ZlibOutputStream zlib_output_stream(
+      ZlibOutputStream::Mode::kCompress,
+      ZlibOutputStream::Format::kGzip,
+      std::make_unique<ZlibOutputStream>(ZlibOutputStream::Mode::kDecompress,
+                                         ZlibOutputStream::Format::kGzip,
+                                         std::move(decompressed_stream)));
+  zlib_output_stream.SetCompressionThreads(4);
+
+  const uint8_t* input = reinterpret_cast<const uint8_t*>(data.data());
+  size_t offset = 0;
+  for (size_t size = 1; offset < data.size(); size *= 3) {
+    size = std::min(size, data.size() - offset);
+    EXPECT_TRUE(zlib_output_stream.Write(input + offset, size));
+    offset += size;
+  }
+  EXPECT_TRUE(zlib_output_stream.Flush());
+
+  const std::vector<uint8_t>& all_data = decompressed_stream_weak->all_data();
+  EXPECT_TRUE(std::string(all_data.begin(), all_data.end()) == data);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,176 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/zstd_output_stream.h"
+
+#include <iterator>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "third_party/zstd/zstd_crashpad.h"
+
+namespace crashpad {
+
+ZstdOutputStream::ZstdOutputStream(
+    Mode mode,
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : ZstdOutputStream(mode,
+                       kDefaultCompressionLevel,
+                       false,
+                       std::move(output_stream)) {}
+
+ZstdOutputStream::ZstdOutputStream(
+    Mode mode,
+    int compression_level,
+    bool long_distance_matching,
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : output_stream_(std::move(output_stream)),
+      cctx_(nullptr),
+      dctx_(nullptr),
+      mode_(mode),
+      compression_level_(compression_level),
+      long_distance_matching_(long_distance_matching),
+      initialized_(),
+      flush_needed_(false) {}
+
+ZstdOutputStream::~ZstdOutputStream() {
+  DCHECK(!initialized_.is_valid() || mode_ == Mode::kDecompress ||
+         !flush_needed_);
+  ZSTD_freeCCtx(cctx_);
+  ZSTD_freeDCtx(dctx_);
+}
+
+bool ZstdOutputStream::Write(const uint8_t* data, size_t size) {
+  if (initialized_.is_uninitialized()) {
+    initialized_.set_invalid();
+    if (!InitializeContext())
+      return false;
+    initialized_.set_valid();
+  }
+
+  if (!initialized_.is_valid())
+    return false;
+
+  ZSTD_inBuffer input = {data, size, 0};
+  if (mode_ == Mode::kCompress) {
+    while (input.pos < input.size) {
+      ZSTD_outBuffer output = {buffer_, std::size(buffer_), 0};
+      size_t result =
+          ZSTD_compressStream2(cctx_, &output, &input, ZSTD_e_continue);
+      if (ZSTD_isError(result)) {
+        LOG(ERROR) << "ZSTD_compressStream2: " << ZSTD_getErrorName(result);
+        return false;
+      }
+      if (!WriteOutputStream(output.pos))
+        return false;
+      flush_needed_ = true;
+    }
+  } else if (mode_ == Mode::kDecompress) {
+    // When the output buffer is filled, the context may hold more decompressed
+    // data, so keep going until it’s drained even if the input is exhausted.
+    bool output_full = false;
+    while (input.pos < input.size || output_full) {
+      size_t input_pos = input.pos;
+      ZSTD_outBuffer output = {buffer_, std::size(buffer_), 0};
+      size_t result = ZSTD_decompressStream(dctx_, &output, &input);
+      if (ZSTD_isError(result)) {
+        LOG(ERROR) << "ZSTD_decompressStream: " << ZSTD_getErrorName(result);
+        return false;
+      }
+      if (!WriteOutputStream(output.pos))
+        return false;
+
+      // 0 means that a frame was completely decoded and flushed. A call that
+      // made no progress says nothing about the frame, so ignore its result.
+      if (input.pos != input_pos || output.pos > 0) {
+        flush_needed_ = result != 0;
+      }
+      output_full = output.pos == output.size;
+    }
+  }
+  return true;
+}
+
+bool ZstdOutputStream::Flush() {
+  if (initialized_.is_valid() && flush_needed_) {
+    if (mode_ == Mode::kCompress) {
+      flush_needed_ = false;
+      ZSTD_inBuffer input = {nullptr, 0, 0};
+      size_t remaining;
+      do {
+        ZSTD_outBuffer output = {buffer_, std::size(buffer_), 0};
+        remaining = ZSTD_compressStream2(cctx_, &output, &input, ZSTD_e_end);
+        if (ZSTD_isError(remaining)) {
+          LOG(ERROR) << "ZSTD_compressStream2: "
+                     << ZSTD_getErrorName(remaining);
+          return false;
+        }
+        if (!WriteOutputStream(output.pos))
+          return false;
+      } while (remaining != 0);
+    } else if (mode_ == Mode::kDecompress) {
+      // Pass on whatever was decompressed, but report the truncation.
+      LOG(ERROR) << "ZSTD_decompressStream: truncated input";
+      output_stream_->Flush();
+      return false;
+    }
+  }
+  return output_stream_->Flush();
+}
+
+bool ZstdOutputStream::InitializeContext() {
+  if (mode_ == Mode::kCompress) {
+    cctx_ = ZSTD_createCCtx();
+    if (!cctx_) {
+      LOG(ERROR) << "ZSTD_createCCtx";
+      return false;
+    }
+
+    size_t result = ZSTD_CCtx_setParameter(
+        cctx_, ZSTD_c_compressionLevel, compression_level_);
+    if (ZSTD_isError(result)) {
+      LOG(ERROR) << "ZSTD_CCtx_setParameter: " << ZSTD_getErrorName(result);
+      return false;
+    }
+
+    // Frames carry a checksum of their content, as gzip members do.
+    result = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_checksumFlag, 1);
+    if (ZSTD_isError(result)) {
+      LOG(ERROR) << "ZSTD_CCtx_setParameter: " << ZSTD_getErrorName(result);
+      return false;
+    }
+
+    if (long_distance_matching_) {
+      result =
+          ZSTD_CCtx_setParameter(cctx_, ZSTD_c_enableLongDistanceMatching, 1);
+      if (ZSTD_isError(result)) {
+        LOG(ERROR) << "ZSTD_CCtx_setParameter: " << ZSTD_getErrorName(result);
+        return false;
+      }
+    }
+  } else if (mode_ == Mode::kDecompress) {
+    dctx_ = ZSTD_createDCtx();
+    if (!dctx_) {
+      LOG(ERROR) << "ZSTD_createDCtx";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ZstdOutputStream::WriteOutputStream(size_t size) {
+  return size == 0 || output_stream_->Write(buffer_, size);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_STREAM_ZSTD_OUTPUT_STREAM_H_
+#define CRASHPAD_UTIL_STREAM_ZSTD_OUTPUT_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "util/misc/initialization_state.h"
+#include "util/stream/output_stream_interface.h"
+
+extern "C" {
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+}  // extern "C"
+
+namespace crashpad {
+
+//! \brief The class wraps Zstandard into \a OutputStreamInterface.
+//!
+//! Compressed data is in the Zstandard frame format described by RFC 8878. Each
+//! call to Flush() after data has been written ends a frame. When
+//! decompressing, consecutive frames are decompressed as a single stream.
+//!
+//! This class is only available when Crashpad is built with Zstandard support,
+//! indicated by `CRASHPAD_USE_ZSTD` being defined.
+class ZstdOutputStream : public OutputStreamInterface {
+ public:
+  //! \brief Whether this object is configured to compress or decompress data.
+  enum class Mode : bool {
+    //! \brief Data passed through this object is compressed.
+    kCompress = false,
+    //! \brief Data passed through this object is decompressed.
+    kDecompress = true
+  };
+
+  //! \brief A compression level requesting the Zstandard library’s default.
+  static constexpr int kDefaultCompressionLevel = 0;
+
+  //! \param[in] mode The work mode of this object.
+  //! \param[in] output_stream The output_stream that this object writes to.
+  //!
+  //! Data is compressed at the default compression level, without long-distance
+  //! matching.
+  ZstdOutputStream(Mode mode,
+                   std::unique_ptr<OutputStreamInterface> output_stream);
+
+  //! \param[in] mode The work mode of this object.
+  //! \param[in] compression_level The Zstandard compression level, or
+  //!     kDefaultCompressionLevel. Negative levels trade compression ratio for
+  //!     speed. Ignored when decompressing.
+  //! \param[in] long_distance_matching Whether to enable long-distance
+  //!     matching, which finds repetitions far apart in large inputs at the
+  //!     cost of memory. Ignored when decompressing.
+  //! \param[in] output_stream The output_stream that this object writes to.
+  ZstdOutputStream(Mode mode,
+                   int compression_level,
+                   bool long_distance_matching,
+                   std::unique_ptr<OutputStreamInterface> output_stream);
+
+  ZstdOutputStream(const ZstdOutputStream&) = delete;
+  ZstdOutputStream& operator=(const ZstdOutputStream&) = delete;
+
+  ~ZstdOutputStream() override;
+
+  // OutputStreamInterface:
+  bool Write(const uint8_t* data, size_t size) override;
+  bool Flush() override;
+
+ private:
+  // Creates and configures cctx_ or dctx_.
+  bool InitializeContext();
+
+  // Writes the first |size| bytes of buffer_ to |output_stream_|.
+  bool WriteOutputStream(size_t size);
+
+  uint8_t buffer_[4096];
+  std::unique_ptr<OutputStreamInterface> output_stream_;
+  ZSTD_CCtx* cctx_;  // owned
+  ZSTD_DCtx* dctx_;  // owned
+  Mode mode_;
+  int compression_level_;
+  bool long_distance_matching_;
+  InitializationState initialized_;  // protects cctx_ and dctx_
+
+  // When compressing, whether a frame has been started and not yet ended. When
+  // decompressing, whether the input so far ends within a frame.
+  bool flush_needed_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_STREAM_ZSTD_OUTPUT_STREAM_H_
@@ -0,0 +1,210 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/zstd_output_stream.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/containers/heap_array.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "util/stream/test_output_stream.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr size_t kShortDataLength = 10;
+constexpr size_t kLongDataLength = 4096 * 10;
+
+std::vector<uint8_t> ZstdCompress(const uint8_t* data,
+                                  size_t size,
+                                  int compression_level,
+                                  bool long_distance_matching) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZstdOutputStream zstd_output_stream(ZstdOutputStream::Mode::kCompress,
+                                      compression_level,
+                                      long_distance_matching,
+                                      std::move(test_output_stream));
+  EXPECT_TRUE(zstd_output_stream.Write(data, size));
+  EXPECT_TRUE(zstd_output_stream.Flush());
+  return test_output_stream_weak->all_data();
+}
+
+std::vector<uint8_t> ZstdDecompress(const std::vector<uint8_t>& compressed) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZstdOutputStream zstd_output_stream(ZstdOutputStream::Mode::kDecompress,
+                                      std::move(test_output_stream));
+  EXPECT_TRUE(zstd_output_stream.Write(compressed.data(), compressed.size()));
+  EXPECT_TRUE(zstd_output_stream.Flush());
+  return test_output_stream_weak->all_data();
+}
+
+class ZstdOutputStreamTest : public testing::Test {
+ public:
+  ZstdOutputStreamTest() : input_() {
+    auto test_output_stream = std::make_unique<TestOutputStream>();
+    test_output_stream_ = test_output_stream.get();
+    zstd_output_stream_ = std::make_unique<ZstdOutputStream>(
+        ZstdOutputStream::Mode::kCompress,
+        std::make_unique<ZstdOutputStream>(ZstdOutputStream::Mode::kDecompress,
+                                           std::move(test_output_stream)));
+  }
+
+  ZstdOutputStreamTest(const ZstdOutputStreamTest&) = delete;
+  ZstdOutputStreamTest& operator=(const ZstdOutputStreamTest&) = delete;
+
+  const uint8_t* BuildRandomInput(size_t size) {
+    input_ = base::HeapArray<uint8_t>::Uninit(size);
+    base::RandBytes(input_);
+    return input_.data();
+  }
+
+  const TestOutputStream& test_output_stream() const {
+    return *test_output_stream_;
+  }
+
+  ZstdOutputStream* zstd_output_stream() const {
+    return zstd_output_stream_.get();
+  }
+
+ private:
+  std::unique_ptr<ZstdOutputStream> zstd_output_stream_;
+  base::HeapArray<uint8_t> input_;
+  TestOutputStream* test_output_stream_;  // weak, owned by zstd_output_stream_
+};
+
+TEST_F(ZstdOutputStreamTest, WriteShortData) {
+  const uint8_t* input = BuildRandomInput(kShortDataLength);
+  EXPECT_TRUE(zstd_output_stream()->Write(input, kShortDataLength));
+  EXPECT_TRUE(zstd_output_stream()->Flush());
+  EXPECT_EQ(test_output_stream().all_data().size(), kShortDataLength);
+  EXPECT_EQ(
+      memcmp(test_output_stream().all_data().data(), input, kShortDataLength),
+      0);
+}
+
+TEST_F(ZstdOutputStreamTest, WriteLongDataMultipleTimes) {
+  const uint8_t* input = BuildRandomInput(kLongDataLength);
+
+  // Call Write() a random number of times.
+  size_t index = 0;
+  while (index < kLongDataLength) {
+    size_t write_length =
+        std::min(static_cast<size_t>(base::RandInt(0, 4096 * 2)),
+                 kLongDataLength - index);
+    SCOPED_TRACE(
+        base::StringPrintf("index %zu, write_length %zu", index, write_length));
+    EXPECT_TRUE(zstd_output_stream()->Write(input + index, write_length));
+    index += write_length;
+  }
+  EXPECT_TRUE(zstd_output_stream()->Flush());
+  EXPECT_EQ(test_output_stream().all_data().size(), kLongDataLength);
+  EXPECT_EQ(
+      memcmp(test_output_stream().all_data().data(), input, kLongDataLength),
+      0);
+}
+
+TEST_F(ZstdOutputStreamTest, FlushWithoutWrite) {
+  EXPECT_TRUE(zstd_output_stream()->Flush());
+  EXPECT_EQ(test_output_stream().write_count(), 0u);
+  EXPECT_EQ(test_output_stream().flush_count(), 1u);
+  EXPECT_TRUE(test_output_stream().all_data().empty());
+}
+
+TEST_F(ZstdOutputStreamTest, WriteEmptyData) {
+  std::vector<uint8_t> empty_data;
+  EXPECT_TRUE(zstd_output_stream()->Write(
+      static_cast<const uint8_t*>(empty_data.data()), empty_data.size()));
+  EXPECT_TRUE(zstd_output_stream()->Flush());
+  EXPECT_TRUE(zstd_output_stream()->Flush());
+  EXPECT_EQ(test_output_stream().write_count(), 0u);
+  EXPECT_EQ(test_output_stream().flush_count(), 2u);
+  EXPECT_TRUE(test_output_stream().all_data().empty());
+}
+
+TEST(ZstdOutputStream, CompressionLevels) {
+  // Highly compressible data that decompresses to more than a buffer’s worth
+  // from a small amount of input.
+  std::string input;
+  for (int index = 0; input.size() < kLongDataLength * 4; ++index) {
+    input.append(base::StringPrintf("line %d of the input\n", index % 100));
+  }
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+
+  for (int compression_level : {-5, ZstdOutputStream::kDefaultCompressionLevel,
+                                19}) {
+    for (bool long_distance_matching : {false, true}) {
+      SCOPED_TRACE(base::StringPrintf("compression_level %d, ldm %d",
+                                      compression_level,
+                                      long_distance_matching));
+      const std::vector<uint8_t> compressed = ZstdCompress(
+          data, input.size(), compression_level, long_distance_matching);
+      EXPECT_LT(compressed.size(), input.size() / 10);
+      const std::vector<uint8_t> decompressed = ZstdDecompress(compressed);
+      EXPECT_EQ(std::string(decompressed.begin(), decompressed.end()), input);
+    }
+  }
+}
+
+TEST(ZstdOutputStream, ConcatenatedFrames) {
+  static constexpr char kFirst[] = "The first zstd frame. ";
+  static constexpr char kSecond[] = "The second zstd frame.";
+
+  std::vector<uint8_t> compressed =
+      ZstdCompress(reinterpret_cast<const uint8_t*>(kFirst),
+                   strlen(kFirst),
+                   ZstdOutputStream::kDefaultCompressionLevel,
+                   false);
+  ASSERT_GE(compressed.size(), 4u);
+  static constexpr uint8_t kZstdMagic[] = {0x28, 0xb5, 0x2f, 0xfd};
+  EXPECT_EQ(memcmp(compressed.data(), kZstdMagic, sizeof(kZstdMagic)), 0);
+  const std::vector<uint8_t> second =
+      ZstdCompress(reinterpret_cast<const uint8_t*>(kSecond),
+                   strlen(kSecond),
+                   ZstdOutputStream::kDefaultCompressionLevel,
+                   false);
+  compressed.insert(compressed.end(), second.begin(), second.end());
+
+  const std::vector<uint8_t> decompressed = ZstdDecompress(compressed);
+  EXPECT_EQ(std::string(decompressed.begin(), decompressed.end()),
+            std::string(kFirst) + kSecond);
+}
+
+TEST(ZstdOutputStream, TruncatedInput) {
+  static constexpr char kData[] = "This frame will be cut short.";
+  std::vector<uint8_t> compressed =
+      ZstdCompress(reinterpret_cast<const uint8_t*>(kData),
+                   strlen(kData),
+                   ZstdOutputStream::kDefaultCompressionLevel,
+                   false);
+  ASSERT_GT(compressed.size(), 1u);
+  compressed.pop_back();
+
+  ZstdOutputStream zstd_output_stream(ZstdOutputStream::Mode::kDecompress,
+                                      std::make_unique<TestOutputStream>());
+  EXPECT_TRUE(zstd_output_stream.Write(compressed.data(), compressed.size()));
+  EXPECT_FALSE(zstd_output_stream.Flush());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,153 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_SYNCHRONIZATION_SEQLOCK_H_
+#define CRASHPAD_UTIL_SYNCHRONIZATION_SEQLOCK_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+#include "base/check.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+//! \brief Sequence counter state for `ScopedSeqlockWrite` and `SeqlockRead()`.
+//!
+//! The sequence is odd while a write is in progress and even otherwise. It is
+//! a single byte so that it can occupy the space of a `SpinGuardState`, which
+//! leaves an `Annotation`’s layout unchanged for older readers. A single byte
+//! wraps around after 128 writes, so a read that overlapped exactly a multiple
+//! of 128 writes can’t be told apart from one that overlapped none.
+//! `SeqlockRead()` limits how many overlapped reads it retries to
+//! `kSeqlockMaxReadAttempts`, so that a reader racing a busy writer fails
+//! instead of retrying until the sequence wraps into a match.
+struct SeqlockState final {
+  //! \brief A `SeqlockState` with no write in progress.
+  constexpr SeqlockState() : sequence(0) {}
+
+  SeqlockState(const SeqlockState&) = delete;
+  SeqlockState& operator=(const SeqlockState&) = delete;
+
+  //! \brief Returns `true` if \a sequence indicates that no write was in
+  //!     progress when it was observed.
+  static constexpr bool IsStable(uint8_t sequence) {
+    return (sequence & 1) == 0;
+  }
+
+  //! \brief The sequence counter, incremented once when a write begins and
+  //!     once when it ends.
+  std::atomic<uint8_t> sequence;
+  static_assert(std::atomic<uint8_t>::is_always_lock_free,
+                "std::atomic<uint8_t> may not be signal-safe");
+  static_assert(sizeof(std::atomic<uint8_t>) == sizeof(uint8_t),
+                "std::atomic<uint8_t> adds size to uint8_t");
+};
+
+//! \brief The maximum number of times that `SeqlockRead()` attempts a read
+//!     before it gives up because every attempt overlapped a write.
+constexpr int kSeqlockMaxReadAttempts = 100;
+
+//! \brief Marks a write to the data protected by a `SeqlockState` for the
+//!     lifetime of this object.
+//!
+//! Unlike `ScopedSpinGuard`, creating a `ScopedSeqlockWrite` never waits:
+//! readers detect and retry around writes instead of excluding them. Writers
+//! must still be serialized with respect to one another by the caller, for
+//! example by only writing from a single thread.
+class ScopedSeqlockWrite final {
+ public:
+  //! \brief Begins a write.
+  //!
+  //! \param[in,out] state The sequence state to update. This object holds a
+  //!     pointer to \a state, so \a state must outlive it.
+  explicit ScopedSeqlockWrite(SeqlockState& state) : state_(&state) {
+    uint8_t sequence = state.sequence.load(std::memory_order_relaxed);
+    DCHECK(SeqlockState::IsStable(sequence));
+    state.sequence.store(sequence + 1, std::memory_order_relaxed);
+    // Keep the writes to the protected data from becoming visible before the
+    // odd sequence.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  ScopedSeqlockWrite(const ScopedSeqlockWrite&) = delete;
+  ScopedSeqlockWrite& operator=(const ScopedSeqlockWrite&) = delete;
+  ScopedSeqlockWrite(ScopedSeqlockWrite&& other) noexcept : state_(nullptr) {
+    std::swap(state_, other.state_);
+  }
+  ScopedSeqlockWrite& operator=(ScopedSeqlockWrite&& other) {
+    std::swap(state_, other.state_);
+    return *this;
+  }
+
+  //! \brief Ends the write.
+  ~ScopedSeqlockWrite() {
+    if (state_) {
+      uint8_t sequence = state_->sequence.load(std::memory_order_relaxed);
+      DCHECK(!SeqlockState::IsStable(sequence));
+      state_->sequence.store(sequence + 1, std::memory_order_release);
+    }
+  }
+
+ private:
+  // The state to mark the end of the write in, or nullptr if this object has
+  // been moved from.
+  SeqlockState* state_;
+};
+
+//! \brief Reads data protected by a `SeqlockState` within the same address
+//!     space, retrying until the read did not overlap a write.
+//!
+//! \param[in] state The sequence state guarding the data.
+//! \param[in] timeout_nanos The time after which to stop retrying. With a
+//!     timeout of `0`, \a read is attempted at most once. Independently of
+//!     the timeout, \a read is attempted at most `kSeqlockMaxReadAttempts`
+//!     times.
+//! \param[in] read A callable that copies the protected data. It may be
+//!     invoked several times and must tolerate reading torn data, whose
+//!     copy will be discarded.
+//! \return `true` if \a read completed without overlapping a write, `false` if
+//!     the timeout elapsed or the attempts ran out first.
+template <typename ReadFunction>
+bool SeqlockRead(const SeqlockState& state,
+                 uint64_t timeout_nanos,
+                 ReadFunction read) {
+  constexpr uint64_t kSeqlockRetrySleepTimeNanos = 10;
+  const uint64_t clock_end_time_nanos =
+      ClockMonotonicNanoseconds() + timeout_nanos;
+  int attempts = 0;
+  while (true) {
+    const uint8_t before = state.sequence.load(std::memory_order_acquire);
+    if (SeqlockState::IsStable(before)) {
+      read();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (state.sequence.load(std::memory_order_relaxed) == before) {
+        return true;
+      }
+      if (++attempts >= kSeqlockMaxReadAttempts) {
+        return false;
+      }
+    }
+    if (ClockMonotonicNanoseconds() >= clock_end_time_nanos) {
+      return false;
+    }
+    SleepNanoseconds(kSeqlockRetrySleepTimeNanos);
+  }
+}
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_SYNCHRONIZATION_SEQLOCK_H_
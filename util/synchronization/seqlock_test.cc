@@ -0,0 +1,151 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/synchronization/seqlock.h"
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(Seqlock, WriteMakesSequenceOddWhileInScope) {
+  SeqlockState s;
+  EXPECT_EQ(s.sequence, 0);
+  {
+    ScopedSeqlockWrite write(s);
+    EXPECT_EQ(s.sequence, 1);
+    EXPECT_FALSE(SeqlockState::IsStable(s.sequence));
+  }
+  EXPECT_EQ(s.sequence, 2);
+  EXPECT_TRUE(SeqlockState::IsStable(s.sequence));
+}
+
+TEST(Seqlock, SequenceWrapsAroundEven) {
+  SeqlockState s;
+  s.sequence = 254;
+  {
+    ScopedSeqlockWrite write(s);
+    EXPECT_EQ(s.sequence, 255);
+  }
+  EXPECT_EQ(s.sequence, 0);
+}
+
+TEST(Seqlock, MovedFromWriteDoesNotEndWrite) {
+  SeqlockState s;
+  {
+    ScopedSeqlockWrite write(s);
+    ScopedSeqlockWrite moved(std::move(write));
+    EXPECT_EQ(s.sequence, 1);
+  }
+  EXPECT_EQ(s.sequence, 2);
+}
+
+TEST(Seqlock, ReadSucceedsWithoutWriter) {
+  SeqlockState s;
+  int reads = 0;
+  EXPECT_TRUE(SeqlockRead(s, /*timeout_nanos=*/0, [&reads] { ++reads; }));
+  EXPECT_EQ(reads, 1);
+}
+
+TEST(Seqlock, ReadWithZeroTimeoutFailsDuringWrite) {
+  SeqlockState s;
+  ScopedSeqlockWrite write(s);
+  int reads = 0;
+  EXPECT_FALSE(SeqlockRead(s, /*timeout_nanos=*/0, [&reads] { ++reads; }));
+  EXPECT_EQ(reads, 0);
+}
+
+TEST(Seqlock, ReadFailsIfWriteOverlapsIt) {
+  SeqlockState s;
+  EXPECT_FALSE(SeqlockRead(s, /*timeout_nanos=*/0, [&s] {
+    ScopedSeqlockWrite write(s);
+  }));
+}
+
+TEST(Seqlock, ReadGivesUpAfterMaxAttempts) {
+  SeqlockState s;
+  int reads = 0;
+  constexpr uint64_t kReadTimeoutNanos = 5000000000;  // 5 s
+  EXPECT_FALSE(SeqlockRead(s, kReadTimeoutNanos, [&s, &reads] {
+    ++reads;
+    ScopedSeqlockWrite write(s);
+  }));
+  EXPECT_EQ(reads, kSeqlockMaxReadAttempts);
+}
+
+TEST(Seqlock, ReadCannotDetectSequenceWrap) {
+  // A read that overlaps 128 writes sees the sequence it started with. This is
+  // the limitation that kSeqlockMaxReadAttempts bounds the exposure to.
+  SeqlockState s;
+  int reads = 0;
+  EXPECT_TRUE(SeqlockRead(s, /*timeout_nanos=*/0, [&s, &reads] {
+    ++reads;
+    for (int write_index = 0; write_index < 128; ++write_index) {
+      ScopedSeqlockWrite write(s);
+    }
+  }));
+  EXPECT_EQ(reads, 1);
+  EXPECT_EQ(s.sequence, 0);
+}
+
+TEST(Seqlock, ReadRetriesUntilWriteEnds) {
+  SeqlockState s;
+  s.sequence = 1;
+  std::thread end_write_thread([&s] {
+    constexpr uint64_t kEndWriteThreadSleepTimeNanos = 10000;  // 10 us
+    SleepNanoseconds(kEndWriteThreadSleepTimeNanos);
+    s.sequence = 2;
+  });
+  int reads = 0;
+  constexpr uint64_t kReadTimeoutNanos = 5000000000;  // 5 s
+  EXPECT_TRUE(SeqlockRead(s, kReadTimeoutNanos, [&reads] { ++reads; }));
+  EXPECT_EQ(reads, 1);
+  end_write_thread.join();
+}
+
+TEST(Seqlock, ReadObservesConsistentData) {
+  SeqlockState s;
+  std::atomic<uint32_t> first(0);
+  std::atomic<uint32_t> second(0);
+  std::atomic<bool> done(false);
+  std::thread writer_thread([&] {
+    for (uint32_t value = 1; value <= 10000; ++value) {
+      ScopedSeqlockWrite write(s);
+      first.store(value, std::memory_order_relaxed);
+      second.store(value, std::memory_order_relaxed);
+    }
+    done = true;
+  });
+
+  constexpr uint64_t kReadTimeoutNanos = 5000000000;  // 5 s
+  do {
+    uint32_t first_copy;
+    uint32_t second_copy;
+    ASSERT_TRUE(SeqlockRead(s, kReadTimeoutNanos, [&] {
+      first_copy = first.load(std::memory_order_relaxed);
+      second_copy = second.load(std::memory_order_relaxed);
+    }));
+    EXPECT_EQ(first_copy, second_copy);
+  } while (!done);
+  writer_thread.join();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -18,11 +18,22 @@
 
 namespace crashpad {
 
-Thread::Thread() : platform_thread_(0) {
+Thread::Thread()
+    : stack_size_(0), priority_(ThreadPriority::kDefault), platform_thread_(0) {
 }
 
 Thread::~Thread() {
   DCHECK(!platform_thread_);
 }
 
+void Thread::SetStackSize(size_t stack_size) {
+  DCHECK(!platform_thread_);
+  stack_size_ = stack_size;
+}
+
+void Thread::SetPriority(ThreadPriority priority) {
+  DCHECK(!platform_thread_);
+  priority_ = priority;
+}
+
 }  // namespace crashpad
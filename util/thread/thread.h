@@ -24,7 +24,10 @@
 #include <windows.h>
 #endif  // BUILDFLAG(IS_POSIX)
 
+#include <stddef.h>
+
 #include "build/build_config.h"
+#include "util/thread/thread_priority.h"
 
 namespace crashpad {
 
@@ -39,6 +42,29 @@ class Thread {
 
   virtual ~Thread();
 
+  //! \brief Sets the size of the stack of the platform thread created by
+  //!     Start().
+  //!
+  //! This must be called before Start(). A thread that is idle most of the
+  //! time and doesn’t need much stack can use this to avoid the platform’s
+  //! default, which may be several megabytes.
+  //!
+  //! \param[in] stack_size The stack size, in bytes. It is raised to the
+  //!     platform’s minimum and rounded up to a multiple of the page size as
+  //!     necessary. `0`, the default, uses the platform’s default stack size.
+  void SetStackSize(size_t stack_size);
+
+  //! \brief Sets the priority that the platform thread created by Start()
+  //!     runs ThreadMain() at.
+  //!
+  //! This must be called before Start(). The priority is set with
+  //! SetCurrentThreadPriority() on the new thread, before ThreadMain() is
+  //! called. If that fails, ThreadMain() still runs.
+  //!
+  //! \param[in] priority The priority. ThreadPriority::kDefault, the default,
+  //!     leaves the thread at the priority the platform starts it with.
+  void SetPriority(ThreadPriority priority);
+
   //! \brief Create a platform thread, and run ThreadMain() on that thread. Must
   //!     be paired with a call to Join().
   void Start();
@@ -64,6 +90,9 @@ class Thread {
 #endif  // BUILDFLAG(IS_POSIX)
       ThreadEntryThunk(void* argument);
 
+  size_t stack_size_;
+  ThreadPriority priority_;
+
 #if BUILDFLAG(IS_POSIX)
   pthread_t platform_thread_;
 #elif BUILDFLAG(IS_WIN)
@@ -15,7 +15,10 @@
 #include "util/thread/thread.h"
 
 #include <errno.h>
+#include <limits.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <ostream>
 
 #include "base/check.h"
@@ -25,8 +28,33 @@ namespace crashpad {
 
 void Thread::Start() {
   DCHECK(!platform_thread_);
-  errno = pthread_create(&platform_thread_, nullptr, ThreadEntryThunk, this);
+
+  pthread_attr_t attributes;
+  pthread_attr_t* attributes_pointer = nullptr;
+  if (stack_size_) {
+    errno = pthread_attr_init(&attributes);
+    PCHECK(errno == 0) << "pthread_attr_init";
+    attributes_pointer = &attributes;
+
+    // Some platforms reject stack sizes that aren’t a multiple of the page
+    // size.
+    const size_t page_size = getpagesize();
+    const size_t stack_size =
+        (std::max(stack_size_, static_cast<size_t>(PTHREAD_STACK_MIN)) +
+         page_size - 1) /
+        page_size * page_size;
+    errno = pthread_attr_setstacksize(&attributes, stack_size);
+    PCHECK(errno == 0) << "pthread_attr_setstacksize";
+  }
+
+  errno = pthread_create(
+      &platform_thread_, attributes_pointer, ThreadEntryThunk, this);
   PCHECK(errno == 0) << "pthread_create";
+
+  if (attributes_pointer) {
+    errno = pthread_attr_destroy(attributes_pointer);
+    PCHECK(errno == 0) << "pthread_attr_destroy";
+  }
 }
 
 void Thread::Join() {
@@ -48,6 +76,7 @@ uint64_t Thread::GetThreadIdForTesting() {
 // static
 void* Thread::ThreadEntryThunk(void* argument) {
   Thread* self = reinterpret_cast<Thread*>(argument);
+  SetCurrentThreadPriority(self->priority_);
   self->ThreadMain();
   return nullptr;
 }
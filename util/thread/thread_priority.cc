@@ -0,0 +1,41 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_priority.h"
+
+namespace crashpad {
+
+namespace {
+
+thread_local ThreadPriority g_current_thread_priority =
+    ThreadPriority::kDefault;
+
+}  // namespace
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+  if (priority == ThreadPriority::kDefault) {
+    return true;
+  }
+  if (!internal::SetCurrentThreadPlatformPriority(priority)) {
+    return false;
+  }
+  g_current_thread_priority = priority;
+  return true;
+}
+
+ThreadPriority GetCurrentThreadPriority() {
+  return g_current_thread_priority;
+}
+
+}  // namespace crashpad
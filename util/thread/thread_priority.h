@@ -0,0 +1,74 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_THREAD_THREAD_PRIORITY_H_
+#define CRASHPAD_UTIL_THREAD_THREAD_PRIORITY_H_
+
+namespace crashpad {
+
+//! \brief How a thread is scheduled, for both CPU time and I/O.
+enum class ThreadPriority {
+  //! \brief The priority the thread started with, left unchanged.
+  kDefault,
+
+  //! \brief Runs only when the system has little else to do, and yields the
+  //!     disk to other work. Suitable for work such as uploads that may take
+  //!     as long as it needs.
+  kBackground,
+
+  //! \brief Preferred over work at the normal priority. Suitable for short
+  //!     work that something else is waiting on.
+  kElevated,
+};
+
+//! \brief Sets the CPU and I/O priority of the calling thread.
+//!
+//! On Linux, the thread is made `SCHED_IDLE` with the idle I/O priority class
+//! for ThreadPriority::kBackground, or given a nice value of -10 and the
+//! highest best-effort I/O priority for ThreadPriority::kElevated. On Apple
+//! platforms, the thread’s quality of service class is set. On Windows, the
+//! thread enters background processing mode, or is given an above-normal
+//! priority.
+//!
+//! Whether threads started by the calling thread afterwards inherit the new
+//! priority depends on the platform. They do on Linux and Apple platforms, and
+//! don’t on Windows.
+//!
+//! \param[in] priority The priority to set.
+//!
+//! \return `true` on success. Otherwise, `false` with a message logged. Raising
+//!     a thread’s priority commonly requires privileges that the process may
+//!     not have, in which case the thread may be left with only some of the
+//!     \a priority applied.
+bool SetCurrentThreadPriority(ThreadPriority priority);
+
+//! \brief Returns the priority that SetCurrentThreadPriority() last applied to
+//!     the calling thread.
+//!
+//! \return The priority from the last successful call to
+//!     SetCurrentThreadPriority() on the calling thread, or
+//!     ThreadPriority::kDefault if there hasn’t been one.
+ThreadPriority GetCurrentThreadPriority();
+
+namespace internal {
+
+//! \brief The platform-specific part of SetCurrentThreadPriority(). Use
+//!     SetCurrentThreadPriority() instead.
+bool SetCurrentThreadPlatformPriority(ThreadPriority priority);
+
+}  // namespace internal
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_THREAD_THREAD_PRIORITY_H_
@@ -0,0 +1,35 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_priority.h"
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace internal {
+
+bool SetCurrentThreadPlatformPriority(ThreadPriority priority) {
+  // Fuchsia schedules threads by profiles obtained from a system service,
+  // which this doesn’t have access to.
+  if (priority != ThreadPriority::kDefault) {
+    LOG(WARNING) << "thread priorities are not supported";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+
+}  // namespace crashpad
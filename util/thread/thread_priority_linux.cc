@@ -0,0 +1,88 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_priority.h"
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+// From the kernel’s include/uapi/linux/ioprio.h, which isn’t available
+// everywhere this is built.
+constexpr int kIOPriorityWhoProcess = 1;
+constexpr int kIOPriorityClassShift = 13;
+constexpr int kIOPriorityClassBestEffort = 2;
+constexpr int kIOPriorityClassIdle = 3;
+
+constexpr int kElevatedNiceValue = -10;
+
+bool SetCurrentThreadIOPriority(int io_class, int level) {
+  // As with the scheduler calls, an ID of 0 names the calling thread rather
+  // than its whole thread group.
+  if (syscall(SYS_ioprio_set,
+              kIOPriorityWhoProcess,
+              0,
+              (io_class << kIOPriorityClassShift) | level) != 0) {
+    PLOG(WARNING) << "ioprio_set";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+namespace internal {
+
+bool SetCurrentThreadPlatformPriority(ThreadPriority priority) {
+  switch (priority) {
+    case ThreadPriority::kDefault:
+      return true;
+
+    case ThreadPriority::kBackground: {
+      // Any thread may lower its own priority, so this doesn’t fail for lack
+      // of privileges.
+      sched_param param = {};
+      if (sched_setscheduler(0, SCHED_IDLE, &param) != 0) {
+        PLOG(WARNING) << "sched_setscheduler";
+        return false;
+      }
+      return SetCurrentThreadIOPriority(kIOPriorityClassIdle, 0);
+    }
+
+    case ThreadPriority::kElevated: {
+      // A negative nice value requires CAP_SYS_NICE or a sufficient
+      // RLIMIT_NICE. The I/O priority is raised regardless, because the
+      // highest best-effort level doesn’t require either.
+      bool success = true;
+      if (setpriority(PRIO_PROCESS, 0, kElevatedNiceValue) != 0) {
+        PLOG(WARNING) << "setpriority";
+        success = false;
+      }
+      return SetCurrentThreadIOPriority(kIOPriorityClassBestEffort, 0) &&
+             success;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+
+}  // namespace crashpad
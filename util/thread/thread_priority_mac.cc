@@ -0,0 +1,53 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_priority.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <pthread/qos.h>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace internal {
+
+bool SetCurrentThreadPlatformPriority(ThreadPriority priority) {
+  qos_class_t qos_class;
+  switch (priority) {
+    case ThreadPriority::kDefault:
+      return true;
+    case ThreadPriority::kBackground:
+      // Background threads are also throttled when they use the disk.
+      qos_class = QOS_CLASS_BACKGROUND;
+      break;
+    case ThreadPriority::kElevated:
+      qos_class = QOS_CLASS_USER_INITIATED;
+      break;
+    default:
+      return false;
+  }
+
+  errno = pthread_set_qos_class_self_np(qos_class, 0);
+  if (errno != 0) {
+    PLOG(WARNING) << "pthread_set_qos_class_self_np";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+
+}  // namespace crashpad
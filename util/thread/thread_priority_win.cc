@@ -0,0 +1,51 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_priority.h"
+
+#include <windows.h>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace internal {
+
+bool SetCurrentThreadPlatformPriority(ThreadPriority priority) {
+  int thread_priority;
+  switch (priority) {
+    case ThreadPriority::kDefault:
+      return true;
+    case ThreadPriority::kBackground:
+      // Background mode lowers the thread’s I/O and memory priority along
+      // with its CPU priority.
+      thread_priority = THREAD_MODE_BACKGROUND_BEGIN;
+      break;
+    case ThreadPriority::kElevated:
+      thread_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+      break;
+    default:
+      return false;
+  }
+
+  if (!SetThreadPriority(GetCurrentThread(), thread_priority)) {
+    PLOG(WARNING) << "SetThreadPriority";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+
+}  // namespace crashpad
@@ -14,9 +14,16 @@
 
 #include "util/thread/thread.h"
 
+#include <string.h>
+
+#include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "util/synchronization/semaphore.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sched.h>
+#endif
+
 namespace crashpad {
 namespace test {
 namespace {
@@ -69,6 +76,52 @@ class JoinAndSignalThread : public Thread {
   Semaphore* semaphore_;
 };
 
+class StackUsingThread : public Thread {
+ public:
+  StackUsingThread() : used_(false) {}
+
+  StackUsingThread(const StackUsingThread&) = delete;
+  StackUsingThread& operator=(const StackUsingThread&) = delete;
+
+  ~StackUsingThread() override {}
+
+  bool used() const { return used_; }
+
+ private:
+  void ThreadMain() override {
+    volatile char buffer[32 * 1024];
+    memset(const_cast<char*>(buffer), 1, sizeof(buffer));
+    used_ = buffer[sizeof(buffer) - 1] == 1;
+  }
+
+  bool used_;
+};
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+class SchedulerPolicyThread : public Thread {
+ public:
+  SchedulerPolicyThread() : policy_(-1), priority_(ThreadPriority::kDefault) {}
+
+  SchedulerPolicyThread(const SchedulerPolicyThread&) = delete;
+  SchedulerPolicyThread& operator=(const SchedulerPolicyThread&) = delete;
+
+  ~SchedulerPolicyThread() override {}
+
+  int policy() const { return policy_; }
+  ThreadPriority priority() const { return priority_; }
+
+ private:
+  void ThreadMain() override {
+    policy_ = sched_getscheduler(0);
+    priority_ = GetCurrentThreadPriority();
+  }
+
+  int policy_;
+  ThreadPriority priority_;
+};
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 TEST(ThreadTest, NoStart) {
   NoopThread thread;
 }
@@ -79,6 +132,49 @@ TEST(ThreadTest, Start) {
   thread.Join();
 }
 
+TEST(ThreadTest, StackSize) {
+  StackUsingThread thread;
+  thread.SetStackSize(128 * 1024);
+  thread.Start();
+  thread.Join();
+  EXPECT_TRUE(thread.used());
+
+  // A stack size below the platform’s minimum is raised to it.
+  NoopThread small_thread;
+  small_thread.SetStackSize(1);
+  small_thread.Start();
+  small_thread.Join();
+}
+
+TEST(ThreadTest, Priority) {
+  NoopThread thread;
+  thread.SetPriority(ThreadPriority::kBackground);
+  thread.Start();
+  thread.Join();
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const int policy = sched_getscheduler(0);
+
+  SchedulerPolicyThread background_thread;
+  background_thread.SetPriority(ThreadPriority::kBackground);
+  background_thread.Start();
+  background_thread.Join();
+  EXPECT_EQ(background_thread.policy(), SCHED_IDLE);
+  EXPECT_EQ(background_thread.priority(), ThreadPriority::kBackground);
+
+  // Only the new thread is affected.
+  EXPECT_EQ(sched_getscheduler(0), policy);
+  EXPECT_EQ(GetCurrentThreadPriority(), ThreadPriority::kDefault);
+
+  SchedulerPolicyThread default_thread;
+  default_thread.Start();
+  default_thread.Join();
+  EXPECT_EQ(default_thread.policy(), policy);
+  EXPECT_EQ(default_thread.priority(), ThreadPriority::kDefault);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+}
+
 TEST(ThreadTest, JoinBlocks) {
   Semaphore unblock_wait_thread_semaphore(0);
   Semaphore join_completed_semaphore(0);
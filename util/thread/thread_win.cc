@@ -22,8 +22,10 @@ namespace crashpad {
 
 void Thread::Start() {
   DCHECK(!platform_thread_);
-  platform_thread_ =
-      CreateThread(nullptr, 0, ThreadEntryThunk, this, 0, nullptr);
+  // Only reserve stack_size_ bytes. The stack is committed as it’s used.
+  const DWORD flags = stack_size_ ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0;
+  platform_thread_ = CreateThread(
+      nullptr, stack_size_, ThreadEntryThunk, this, flags, nullptr);
   PCHECK(platform_thread_) << "CreateThread";
 }
 
@@ -37,6 +39,7 @@ void Thread::Join() {
 // static
 DWORD WINAPI Thread::ThreadEntryThunk(void* argument) {
   Thread* self = reinterpret_cast<Thread*>(argument);
+  SetCurrentThreadPriority(self->priority_);
   self->ThreadMain();
   return 0;
 }
@@ -56,6 +56,8 @@ class WorkerThreadImpl final : public Thread {
 WorkerThread::WorkerThread(double work_interval,
                            WorkerThread::Delegate* delegate)
     : work_interval_(work_interval),
+      stack_size_(0),
+      priority_(ThreadPriority::kDefault),
       delegate_(delegate),
       impl_(),
       running_(false),
@@ -65,12 +67,28 @@ WorkerThread::~WorkerThread() {
   DCHECK(!running_);
 }
 
+void WorkerThread::SetWorkInterval(double work_interval) {
+  work_interval_ = work_interval;
+}
+
+void WorkerThread::SetStackSize(size_t stack_size) {
+  DCHECK(!running_);
+  stack_size_ = stack_size;
+}
+
+void WorkerThread::SetPriority(ThreadPriority priority) {
+  DCHECK(!running_);
+  priority_ = priority;
+}
+
 void WorkerThread::Start(double initial_work_delay) {
   DCHECK(!impl_);
   DCHECK(!running_);
 
   running_ = true;
   impl_.reset(new internal::WorkerThreadImpl(this, initial_work_delay));
+  impl_->SetStackSize(stack_size_);
+  impl_->SetPriority(priority_);
   impl_->Start();
 }
 
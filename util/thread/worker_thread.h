@@ -15,10 +15,13 @@
 #ifndef CRASHPAD_UTIL_THREAD_WORKER_THREAD_H_
 #define CRASHPAD_UTIL_THREAD_WORKER_THREAD_H_
 
+#include <stddef.h>
+
 #include <atomic>
 #include <memory>
 
 #include "util/synchronization/semaphore.h"
+#include "util/thread/thread_priority.h"
 
 namespace crashpad {
 
@@ -59,6 +62,22 @@ class WorkerThread {
 
   ~WorkerThread();
 
+  //! \brief Changes the \a work_interval passed to the constructor.
+  //!
+  //! This may be called from any thread. If the thread is_running(), a wait
+  //! already in progress keeps the old interval. Call DoWorkNow() to end it.
+  void SetWorkInterval(double work_interval);
+
+  //! \brief Sets the stack size of the thread, as Thread::SetStackSize() does.
+  //!
+  //! This may not be called if the thread is_running().
+  void SetStackSize(size_t stack_size);
+
+  //! \brief Sets the priority of the thread, as Thread::SetPriority() does.
+  //!
+  //! This may not be called if the thread is_running().
+  void SetPriority(ThreadPriority priority);
+
   //! \brief Starts the worker thread.
   //!
   //! This may not be called if the thread is_running().
@@ -92,7 +111,9 @@ class WorkerThread {
  private:
   friend class internal::WorkerThreadImpl;
 
-  double work_interval_;
+  std::atomic<double> work_interval_;
+  size_t stack_size_;
+  ThreadPriority priority_;
   Delegate* delegate_;  // weak
   std::unique_ptr<internal::WorkerThreadImpl> impl_;
   bool running_;
@@ -159,6 +159,27 @@ TEST(WorkerThread, DoWorkNowAtStart) {
   EXPECT_FALSE(thread.is_running());
 }
 
+TEST(WorkerThread, SetWorkIntervalWhileRunning) {
+  WorkDelegate delegate;
+  WorkerThread thread(100, &delegate);
+
+  uint64_t start = ClockMonotonicNanoseconds();
+
+  delegate.SetDesiredWorkCount(1);
+  thread.Start(0);
+  delegate.WaitForWorkCount();
+
+  // The new interval applies once the wait in progress is ended.
+  thread.SetWorkInterval(0.05);
+  delegate.SetDesiredWorkCount(3);
+  thread.DoWorkNow();
+  delegate.WaitForWorkCount();
+  thread.Stop();
+  EXPECT_EQ(delegate.work_count(), 3);
+
+  EXPECT_GE(100 * kNanosecondsPerSecond, ClockMonotonicNanoseconds() - start);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
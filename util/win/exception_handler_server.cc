@@ -18,18 +18,23 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <atomic>
 #include <iterator>
+#include <memory>
 #include <utility>
 
 #include "base/check.h"
+#include "base/check_op.h"
 #include "base/containers/heap_array.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/rand_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "util/file/file_writer.h"
+#include "util/misc/metrics.h"
 #include "util/misc/tri_state.h"
 #include "util/misc/uuid.h"
+#include "util/synchronization/semaphore.h"
 #include "util/win/get_function.h"
 #include "util/win/handle.h"
 #include "util/win/registration_protocol_win.h"
@@ -64,18 +69,85 @@ HANDLE DuplicateEvent(HANDLE process, HANDLE event) {
 
 namespace internal {
 
+//! \brief Limits the number of dump requests that are handled at once.
+//!
+//! Requests beyond the limit block the thread pool thread they arrived on
+//! until a request being handled completes.
+class DumpLimiter {
+ public:
+  DumpLimiter() : slots_(), limit_(0), outstanding_(0) {}
+
+  DumpLimiter(const DumpLimiter&) = delete;
+  DumpLimiter& operator=(const DumpLimiter&) = delete;
+
+  ~DumpLimiter() {}
+
+  //! \brief Sets the limit. `0` means no limit. Must not be called while
+  //!     any request is being handled.
+  void SetLimit(size_t limit) {
+    DCHECK_EQ(outstanding_.load(), 0u);
+    limit_ = limit;
+    slots_ = limit ? std::make_unique<Semaphore>(static_cast<int>(limit))
+                   : nullptr;
+  }
+
+  //! \brief Waits until a request may be handled.
+  void Acquire() {
+    size_t outstanding = outstanding_++;
+    Metrics::ExceptionQueueDepth(
+        slots_ && outstanding >= limit_ ? outstanding - limit_ + 1 : 0);
+    if (slots_) {
+      slots_->Wait();
+    }
+  }
+
+  //! \brief Indicates that a request allowed by Acquire() has been handled.
+  void Release() {
+    if (slots_) {
+      slots_->Signal();
+    }
+    --outstanding_;
+  }
+
+ private:
+  std::unique_ptr<Semaphore> slots_;
+  size_t limit_;
+
+  // The number of requests being handled or waiting to be.
+  std::atomic<size_t> outstanding_;
+};
+
+//! \brief Holds one of a DumpLimiter’s slots for its lifetime.
+class ScopedDumpSlot {
+ public:
+  explicit ScopedDumpSlot(DumpLimiter* dump_limiter)
+      : dump_limiter_(dump_limiter) {
+    dump_limiter_->Acquire();
+  }
+
+  ScopedDumpSlot(const ScopedDumpSlot&) = delete;
+  ScopedDumpSlot& operator=(const ScopedDumpSlot&) = delete;
+
+  ~ScopedDumpSlot() { dump_limiter_->Release(); }
+
+ private:
+  DumpLimiter* dump_limiter_;  // weak
+};
+
 //! \brief Context information for the named pipe handler threads.
 class PipeServiceContext {
  public:
   PipeServiceContext(HANDLE port,
                      HANDLE pipe,
                      ExceptionHandlerServer::Delegate* delegate,
+                     DumpLimiter* dump_limiter,
                      base::Lock* clients_lock,
                      std::set<internal::ClientData*>* clients,
                      uint64_t shutdown_token)
       : port_(port),
         pipe_(pipe),
         delegate_(delegate),
+        dump_limiter_(dump_limiter),
         clients_lock_(clients_lock),
         clients_(clients),
         shutdown_token_(shutdown_token) {}
@@ -86,6 +158,7 @@ class PipeServiceContext {
   HANDLE port() const { return port_; }
   HANDLE pipe() const { return pipe_.get(); }
   ExceptionHandlerServer::Delegate* delegate() const { return delegate_; }
+  DumpLimiter* dump_limiter() const { return dump_limiter_; }
   base::Lock* clients_lock() const { return clients_lock_; }
   std::set<internal::ClientData*>* clients() const { return clients_; }
   uint64_t shutdown_token() const { return shutdown_token_; }
@@ -94,6 +167,7 @@ class PipeServiceContext {
   HANDLE port_;  // weak
   ScopedKernelHANDLE pipe_;
   ExceptionHandlerServer::Delegate* delegate_;  // weak
+  DumpLimiter* dump_limiter_;  // weak
   base::Lock* clients_lock_;  // weak
   std::set<internal::ClientData*>* clients_;  // weak
   uint64_t shutdown_token_;
@@ -108,6 +182,7 @@ class ClientData {
  public:
   ClientData(HANDLE port,
              ExceptionHandlerServer::Delegate* delegate,
+             DumpLimiter* dump_limiter,
              ScopedKernelHANDLE process,
              ScopedKernelHANDLE crash_dump_requested_event,
              ScopedKernelHANDLE non_crash_dump_requested_event,
@@ -124,6 +199,7 @@ class ClientData {
         lock_(),
         port_(port),
         delegate_(delegate),
+        dump_limiter_(dump_limiter),
         crash_dump_requested_event_(std::move(crash_dump_requested_event)),
         non_crash_dump_requested_event_(
             std::move(non_crash_dump_requested_event)),
@@ -153,6 +229,7 @@ class ClientData {
   base::Lock* lock() { return &lock_; }
   HANDLE port() const { return port_; }
   ExceptionHandlerServer::Delegate* delegate() const { return delegate_; }
+  DumpLimiter* dump_limiter() const { return dump_limiter_; }
   HANDLE crash_dump_requested_event() const {
     return crash_dump_requested_event_.get();
   }
@@ -178,12 +255,15 @@ class ClientData {
       WAITORTIMERCALLBACK crash_dump_request_callback,
       WAITORTIMERCALLBACK non_crash_dump_request_callback,
       WAITORTIMERCALLBACK process_end_callback) {
+    // Dump requests are long functions, and may wait on the DumpLimiter. Say
+    // so, so that the thread pool doesn't hold requests from other clients
+    // back while they run.
     if (!RegisterWaitForSingleObject(&crash_dump_request_thread_pool_wait_,
                                      crash_dump_requested_event_.get(),
                                      crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     WT_EXECUTELONGFUNCTION)) {
       LOG(ERROR) << "RegisterWaitForSingleObject crash dump requested";
     }
 
@@ -192,7 +272,7 @@ class ClientData {
                                      non_crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     WT_EXECUTELONGFUNCTION)) {
       LOG(ERROR) << "RegisterWaitForSingleObject non-crash dump requested";
     }
 
@@ -229,6 +309,7 @@ class ClientData {
   // Access to these fields must be guarded by lock_.
   HANDLE port_;  // weak
   ExceptionHandlerServer::Delegate* delegate_;  // weak
+  DumpLimiter* dump_limiter_;  // weak
   ScopedKernelHANDLE crash_dump_requested_event_;
   ScopedKernelHANDLE non_crash_dump_requested_event_;
   ScopedKernelHANDLE non_crash_dump_completed_event_;
@@ -247,6 +328,7 @@ ExceptionHandlerServer::ExceptionHandlerServer(bool persistent)
     : pipe_name_(),
       port_(CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1)),
       first_pipe_instance_(),
+      dump_limiter_(std::make_unique<internal::DumpLimiter>()),
       clients_lock_(),
       clients_(),
       persistent_(persistent) {
@@ -262,6 +344,10 @@ void ExceptionHandlerServer::SetPipeName(const std::wstring& pipe_name) {
   pipe_name_ = pipe_name;
 }
 
+void ExceptionHandlerServer::SetConcurrentDumpLimit(size_t limit) {
+  dump_limiter_->SetLimit(limit);
+}
+
 void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
     const InitialClientData& initial_client_data,
     Delegate* delegate) {
@@ -291,6 +377,7 @@ void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
     internal::ClientData* client = new internal::ClientData(
         port_.get(),
         delegate,
+        dump_limiter_.get(),
         ScopedKernelHANDLE(initial_client_data.client_process()),
         ScopedKernelHANDLE(initial_client_data.request_crash_dump()),
         ScopedKernelHANDLE(initial_client_data.request_non_crash_dump()),
@@ -324,6 +411,7 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
         new internal::PipeServiceContext(port_.get(),
                                          pipe,
                                          delegate,
+                                         dump_limiter_.get(),
                                          &clients_lock_,
                                          &clients_,
                                          shutdown_token);
@@ -481,6 +569,7 @@ bool ExceptionHandlerServer::ServiceClientConnection(
     client = new internal::ClientData(
         service_context.port(),
         service_context.delegate(),
+        service_context.dump_limiter(),
         ScopedKernelHANDLE(client_process),
         ScopedKernelHANDLE(
             CreateEvent(nullptr, false /* auto reset */, false, nullptr)),
@@ -540,6 +629,7 @@ DWORD __stdcall ExceptionHandlerServer::PipeServiceProc(void* ctx) {
 void __stdcall ExceptionHandlerServer::OnCrashDumpEvent(void* ctx, BOOLEAN) {
   // This function is executed on the thread pool.
   internal::ClientData* client = reinterpret_cast<internal::ClientData*>(ctx);
+  internal::ScopedDumpSlot dump_slot(client->dump_limiter());
   base::AutoLock lock(*client->lock());
 
   // Capture the exception.
@@ -555,6 +645,7 @@ void __stdcall ExceptionHandlerServer::OnCrashDumpEvent(void* ctx, BOOLEAN) {
 void __stdcall ExceptionHandlerServer::OnNonCrashDumpEvent(void* ctx, BOOLEAN) {
   // This function is executed on the thread pool.
   internal::ClientData* client = reinterpret_cast<internal::ClientData*>(ctx);
+  internal::ScopedDumpSlot dump_slot(client->dump_limiter());
   base::AutoLock lock(*client->lock());
 
   // Capture the exception.
@@ -15,6 +15,9 @@
 #ifndef CRASHPAD_UTIL_WIN_EXCEPTION_HANDLER_SERVER_H_
 #define CRASHPAD_UTIL_WIN_EXCEPTION_HANDLER_SERVER_H_
 
+#include <stddef.h>
+
+#include <memory>
 #include <set>
 #include <string>
 
@@ -29,6 +32,7 @@ namespace crashpad {
 namespace internal {
 class PipeServiceContext;
 class ClientData;
+class DumpLimiter;
 }  // namespace internal
 
 //! \brief Runs the main exception-handling server in Crashpad's handler
@@ -83,6 +87,18 @@ class ExceptionHandlerServer {
   //!     form "\\.\pipe\<some_name>".
   void SetPipeName(const std::wstring& pipe_name);
 
+  //! \brief Sets the maximum number of dump requests handled at once.
+  //!
+  //! Each request is handled on a system thread pool thread. Requests beyond
+  //! the limit wait for a request being handled to complete. With the default,
+  //! `0`, the number of requests handled at once is not limited. This method
+  //! must be called before Run() or
+  //! InitializeWithInheritedDataForInitialClient().
+  //!
+  //! \param[in] limit The maximum number of requests to handle at once, or
+  //!     `0` for no limit.
+  void SetConcurrentDumpLimit(size_t limit);
+
   //! \brief Sets the pipe to listen for client registrations on, providing
   //!     the first precreated instance.
   //!
@@ -129,6 +145,8 @@ class ExceptionHandlerServer {
   ScopedKernelHANDLE port_;
   ScopedFileHandle first_pipe_instance_;
 
+  std::unique_ptr<internal::DumpLimiter> dump_limiter_;
+
   base::Lock clients_lock_;
   std::set<internal::ClientData*> clients_;
 
@@ -25,6 +25,7 @@
 #define STATUS_INFO_LENGTH_MISMATCH ((NTSTATUS)0xC0000004L)
 #define STATUS_BUFFER_TOO_SMALL ((NTSTATUS)0xC0000023L)
 #define STATUS_PROCESS_IS_TERMINATING ((NTSTATUS)0xC000010AL)
+#define STATUS_INVALID_INFO_CLASS ((NTSTATUS)0xC0000003L)
 
 namespace crashpad {
 
@@ -51,6 +52,10 @@ enum { ThreadBasicInformation = 0 };
 // winternal.h defines SYSTEM_INFORMATION_CLASS, but not all members.
 enum { SystemExtendedHandleInformation = 64 };
 
+// winternal.h defines PROCESSINFOCLASS, but not all members. This one is
+// supported on Windows 8 and later.
+enum { ProcessHandleInformation = 51 };
+
 NTSTATUS NtQuerySystemInformation(
     SYSTEM_INFORMATION_CLASS system_information_class,
     PVOID system_information,
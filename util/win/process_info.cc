@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <memory>
 #include <new>
 #include <type_traits>
@@ -27,6 +28,7 @@
 #include "base/containers/heap_array.h"
 #include "base/logging.h"
 #include "base/memory/free_deleter.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/process/memory.h"
 #include "base/strings/stringprintf.h"
 #include "build/build_config.h"
@@ -180,6 +182,28 @@ base::HeapArray<uint8_t> QueryObject(
   return buffer;
 }
 
+// Returns the type name of the object that |handle|, a handle in this process,
+// refers to, or an empty string on failure.
+std::wstring QueryTypeName(HANDLE handle) {
+  auto object_type_information_buffer = QueryObject(
+      handle, ObjectTypeInformation, sizeof(PUBLIC_OBJECT_TYPE_INFORMATION));
+  if (object_type_information_buffer.empty())
+    return std::wstring();
+
+  PUBLIC_OBJECT_TYPE_INFORMATION* object_type_information =
+      reinterpret_cast<PUBLIC_OBJECT_TYPE_INFORMATION*>(
+          object_type_information_buffer.data());
+  DCHECK_EQ(object_type_information->TypeName.Length % sizeof(wchar_t), 0u);
+  return std::wstring(object_type_information->TypeName.Buffer,
+                      object_type_information->TypeName.Length /
+                          sizeof(wchar_t));
+}
+
+// Object type indices are shared by all handles of a type across the system,
+// so each type’s name only needs to be queried once while walking a handle
+// table.
+using HandleTypeNames = std::map<ULONG, std::wstring>;
+
 }  // namespace
 
 template <class Traits>
@@ -346,8 +370,122 @@ bool ReadMemoryInfo(HANDLE process, bool is_64_bit, ProcessInfo* process_info) {
   return true;
 }
 
+bool ProcessInfo::BuildHandleVectorFromProcessHandleSnapshot(
+    HANDLE process,
+    std::vector<Handle>* handles) const {
+  // Unlike SystemExtendedHandleInformation, ProcessHandleInformation reports
+  // the size it needs, but the client may open more handles before the next
+  // attempt, so this may still need to retry.
+  ULONG buffer_size = 64 * 1024;
+  NTSTATUS status;
+  ULONG returned_length = 0;
+  UniqueMallocPtr buffer;
+  for (int tries = 0; tries < 5; ++tries) {
+    buffer.reset();
+    buffer = UncheckedAllocate(buffer_size);
+    if (!buffer) {
+      // Falling back to the system-wide handle table would need even more
+      // memory, so give up on handles altogether.
+      LOG(ERROR) << "UncheckedAllocate";
+      return true;
+    }
+
+    status = crashpad::NtQueryInformationProcess(
+        process,
+        static_cast<PROCESSINFOCLASS>(ProcessHandleInformation),
+        buffer.get(),
+        buffer_size,
+        &returned_length);
+    if (status != STATUS_INFO_LENGTH_MISMATCH)
+      break;
+
+    buffer_size = std::max(buffer_size * 2, returned_length);
+  }
+
+  if (!NT_SUCCESS(status)) {
+    if (status != STATUS_INVALID_INFO_CLASS) {
+      NTSTATUS_LOG(ERROR, status)
+          << "NtQueryInformationProcess ProcessHandleInformation";
+    }
+    return false;
+  }
+
+  const auto& process_handle_snapshot_information =
+      *reinterpret_cast<process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION*>(
+          buffer.get());
+
+  DCHECK_LE(
+      offsetof(process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION, Handles) +
+          process_handle_snapshot_information.NumberOfHandles *
+              sizeof(process_handle_snapshot_information.Handles[0]),
+      returned_length);
+
+  HandleTypeNames type_names;
+  handles->clear();
+  size_t omitted = 0;
+  for (size_t i = 0; i < process_handle_snapshot_information.NumberOfHandles;
+       ++i) {
+    const auto& handle = process_handle_snapshot_information.Handles[i];
+
+    // Only the first handle of each type needs to be duplicated to find its
+    // type name. The counts come from the handle table itself, and so don’t
+    // include any reference taken by this process.
+    auto type_name = type_names.find(handle.ObjectTypeIndex);
+    if (type_name == type_names.end()) {
+      HANDLE dup_handle;
+      if (DuplicateHandle(process,
+                          handle.HandleValue,
+                          GetCurrentProcess(),
+                          &dup_handle,
+                          0,
+                          false,
+                          DUPLICATE_SAME_ACCESS)) {
+        ScopedKernelHANDLE scoped_dup_handle(dup_handle);
+        type_name = type_names
+                        .insert(std::make_pair(handle.ObjectTypeIndex,
+                                               QueryTypeName(dup_handle)))
+                        .first;
+      }
+    }
+
+    const std::wstring* type_name_string =
+        type_name != type_names.end() ? &type_name->second : nullptr;
+    if (type_name_string &&
+        handle_options_.excluded_types.count(*type_name_string)) {
+      continue;
+    }
+    if (handle_options_.max_handles &&
+        handles->size() == handle_options_.max_handles) {
+      ++omitted;
+      continue;
+    }
+
+    Handle result_handle;
+    if (type_name_string)
+      result_handle.type_name = *type_name_string;
+    result_handle.handle = HandleToInt(handle.HandleValue);
+    result_handle.attributes = handle.HandleAttributes;
+    result_handle.granted_access = handle.GrantedAccess;
+    result_handle.pointer_count =
+        base::saturated_cast<uint32_t>(handle.PointerCount);
+    result_handle.handle_count =
+        base::saturated_cast<uint32_t>(handle.HandleCount);
+    handles->push_back(result_handle);
+  }
+
+  if (omitted) {
+    LOG(WARNING) << "omitted " << omitted << " handles beyond "
+                 << handle_options_.max_handles;
+  }
+  return true;
+}
+
 std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
     HANDLE process) const {
+  std::vector<Handle> handles;
+  if (BuildHandleVectorFromProcessHandleSnapshot(process, &handles))
+    return handles;
+
   ULONG buffer_size = 2 * 1024 * 1024;
   // Typically if the buffer were too small, STATUS_INFO_LENGTH_MISMATCH would
   // return the correct size in the final argument, but it does not for
@@ -389,13 +527,26 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
                     sizeof(system_handle_information_ex.Handles[0]),
             returned_length);
 
-  std::vector<Handle> handles;
-
+  HandleTypeNames type_names;
+  size_t omitted = 0;
   for (size_t i = 0; i < system_handle_information_ex.NumberOfHandles; ++i) {
     const auto& handle = system_handle_information_ex.Handles[i];
     if (handle.UniqueProcessId != process_id_)
       continue;
 
+    // A type that has already been seen can be excluded, or the handle counted
+    // against the limit, without duplicating it.
+    auto type_name = type_names.find(handle.ObjectTypeIndex);
+    if (type_name != type_names.end() &&
+        handle_options_.excluded_types.count(type_name->second)) {
+      continue;
+    }
+    if (handle_options_.max_handles &&
+        handles.size() == handle_options_.max_handles) {
+      ++omitted;
+      continue;
+    }
+
     Handle result_handle;
     result_handle.handle = HandleToInt(handle.HandleValue);
     result_handle.attributes = handle.HandleAttributes;
@@ -441,27 +592,25 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
         result_handle.handle_count = object_basic_information->HandleCount - 1;
       }
 
-      auto object_type_information_buffer =
-          QueryObject(dup_handle,
-                      ObjectTypeInformation,
-                      sizeof(PUBLIC_OBJECT_TYPE_INFORMATION));
-      if (!object_type_information_buffer.empty()) {
-        PUBLIC_OBJECT_TYPE_INFORMATION* object_type_information =
-            reinterpret_cast<PUBLIC_OBJECT_TYPE_INFORMATION*>(
-                object_type_information_buffer.data());
-
-        DCHECK_EQ(object_type_information->TypeName.Length %
-                      sizeof(result_handle.type_name[0]),
-                  0u);
-        result_handle.type_name =
-            std::wstring(object_type_information->TypeName.Buffer,
-                         object_type_information->TypeName.Length /
-                             sizeof(result_handle.type_name[0]));
+      if (type_name == type_names.end()) {
+        type_name = type_names
+                        .insert(std::make_pair(handle.ObjectTypeIndex,
+                                               QueryTypeName(dup_handle)))
+                        .first;
+        if (handle_options_.excluded_types.count(type_name->second))
+          continue;
       }
     }
 
+    if (type_name != type_names.end())
+      result_handle.type_name = type_name->second;
     handles.push_back(result_handle);
   }
+
+  if (omitted) {
+    LOG(WARNING) << "omitted " << omitted << " handles beyond "
+                 << handle_options_.max_handles;
+  }
   return handles;
 }
 
@@ -471,6 +620,13 @@ ProcessInfo::Module::Module() : name(), dll_base(0), size(0), timestamp() {
 ProcessInfo::Module::~Module() {
 }
 
+ProcessInfo::HandleOptions::HandleOptions()
+    : max_handles(0), excluded_types() {
+}
+
+ProcessInfo::HandleOptions::~HandleOptions() {
+}
+
 ProcessInfo::Handle::Handle()
     : type_name(),
       handle(0),
@@ -493,6 +649,7 @@ ProcessInfo::ProcessInfo()
       modules_(),
       memory_info_(),
       handles_(),
+      handle_options_(),
       is_64_bit_(false),
       is_wow64_(false),
       initialized_() {
@@ -502,6 +659,10 @@ ProcessInfo::~ProcessInfo() {
 }
 
 bool ProcessInfo::Initialize(HANDLE process) {
+  return Initialize(process, process);
+}
+
+bool ProcessInfo::Initialize(HANDLE process, HANDLE memory_process) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_ = process;
@@ -547,15 +708,15 @@ bool ProcessInfo::Initialize(HANDLE process) {
   }
 
   result = is_64_bit_ ? ReadProcessData<process_types::internal::Traits64>(
-                            process, peb_address_, this)
+                            memory_process, peb_address_, this)
                       : ReadProcessData<process_types::internal::Traits32>(
-                            process, peb_address_, this);
+                            memory_process, peb_address_, this);
   if (!result) {
     LOG(ERROR) << "ReadProcessData failed";
     return false;
   }
 
-  if (!ReadMemoryInfo(process, is_64_bit_, this)) {
+  if (!ReadMemoryInfo(memory_process, is_64_bit_, this)) {
     LOG(ERROR) << "ReadMemoryInfo failed";
     return false;
   }
@@ -636,6 +797,11 @@ bool ProcessInfo::LoggingRangeIsFullyReadable(
   return true;
 }
 
+void ProcessInfo::SetHandleOptions(const HandleOptions& options) {
+  DCHECK(handles_.empty());
+  handle_options_ = options;
+}
+
 const std::vector<ProcessInfo::Handle>& ProcessInfo::Handles() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (handles_.empty())
@@ -657,19 +823,40 @@ std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
   // Find all the ranges that overlap the target range, maintaining their order.
   ProcessInfo::MemoryBasicInformation64Vector overlapping;
   const size_t size = memory_info.size();
+  if (size == 0)
+    return std::vector<Range>();
 
+  // The memory map is sorted by address and its regions don’t overlap, so
+  // binary search for the first region that ends after the start of the target
+  // range instead of scanning the whole map for every query. Large 64-bit
+  // processes have many thousands of regions, and callers such as the memory
+  // snapshot and module readers query it many times per capture.
+  //
   // This loop is written in an ugly fashion to make Debug performance
   // reasonable.
   const MEMORY_BASIC_INFORMATION64* begin = &memory_info[0];
-  for (size_t i = 0; i < size; ++i) {
+  size_t first = 0;
+  size_t count = size;
+  while (count > 0) {
+    const size_t step = count / 2;
+    const MEMORY_BASIC_INFORMATION64& mi = *(begin + first + step);
+    if (mi.BaseAddress + mi.RegionSize <= range_base) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+
+  for (size_t i = first; i < size; ++i) {
     const MEMORY_BASIC_INFORMATION64& mi = *(begin + i);
     static_assert(std::is_same<decltype(mi.BaseAddress), WinVMAddress>::value,
                   "expected range address to be WinVMAddress");
     static_assert(std::is_same<decltype(mi.RegionSize), WinVMSize>::value,
                   "expected range size to be WinVMSize");
-    WinVMAddress mi_end = mi.BaseAddress + mi.RegionSize;
-    if (range_base < mi_end && mi.BaseAddress < range_end)
-      overlapping.push_back(mi);
+    if (mi.BaseAddress >= range_end)
+      break;
+    overlapping.push_back(mi);
   }
   if (overlapping.empty())
     return std::vector<Range>();
@@ -18,6 +18,7 @@
 #include <windows.h>
 #include <sys/types.h>
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -85,6 +86,24 @@ class ProcessInfo {
     uint32_t handle_count;
   };
 
+  //! \brief Limits on the handles returned by Handles().
+  struct HandleOptions {
+    HandleOptions();
+    ~HandleOptions();
+
+    //! \brief The greatest number of handles to return, or `0` to return all
+    //!     of them.
+    //!
+    //! A process that leaks handles can have hundreds of thousands of them,
+    //! and describing each one slows the capture and bloats the minidump.
+    size_t max_handles;
+
+    //! \brief Handles whose type name, such as `L"EtwRegistration"`, is in
+    //!     this set are left out. Excluded handles don’t count toward
+    //!     #max_handles.
+    std::set<std::wstring> excluded_types;
+  };
+
   ProcessInfo();
 
   ProcessInfo(const ProcessInfo&) = delete;
@@ -101,6 +120,17 @@ class ProcessInfo {
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(HANDLE process);
 
+  //! \brief Initializes this object with information about the given
+  //!     \a process, reading its memory through \a memory_process.
+  //!
+  //! This is used to read a process through a clone of its address space,
+  //! such as PssSnapshot::VaCloneProcess(). The process’ identity and handles
+  //! are taken from \a process, and everything read from its memory, including
+  //! the module list and memory map, from \a memory_process.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Initialize(HANDLE process, HANDLE memory_process);
+
   //! \return `true` if the target process is a 64-bit process.
   bool Is64Bit() const;
 
@@ -133,6 +163,8 @@ class ProcessInfo {
   bool Modules(std::vector<Module>* modules) const;
 
   //! \brief Retrieves information about all pages mapped into the process.
+  //!
+  //! The regions are sorted by address and don’t overlap.
   const MemoryBasicInformation64Vector& MemoryInfo() const;
 
   //! \brief Given a range to be read from the target process, returns a vector
@@ -155,7 +187,17 @@ class ProcessInfo {
   bool LoggingRangeIsFullyReadable(
       const CheckedRange<WinVMAddress, WinVMSize>& range) const;
 
+  //! \brief Sets limits on the handles returned by Handles().
+  //!
+  //! This method must be called before the first call to Handles() to have
+  //! any effect. By default, all handles are returned.
+  void SetHandleOptions(const HandleOptions& options);
+
   //! \brief Retrieves information about open handles in the target process.
+  //!
+  //! The process’ own handle table is read with `ProcessHandleInformation`
+  //! where it is supported, on Windows 8 and later. Otherwise, the handles are
+  //! found by filtering the system-wide handle table.
   const std::vector<Handle>& Handles() const;
 
  private:
@@ -174,8 +216,14 @@ class ProcessInfo {
                              bool is_64_bit,
                              ProcessInfo* process_info);
 
-  // This function is best-effort under low memory conditions.
+  // These functions are best-effort under low memory conditions.
+  // BuildHandleVectorFromProcessHandleSnapshot() returns false if
+  // ProcessHandleInformation isn’t supported, in which case
+  // BuildHandleVector() falls back to SystemExtendedHandleInformation.
   std::vector<Handle> BuildHandleVector(HANDLE process) const;
+  bool BuildHandleVectorFromProcessHandleSnapshot(
+      HANDLE process,
+      std::vector<Handle>* handles) const;
 
   crashpad::ProcessID process_id_;
   crashpad::ProcessID inherited_from_process_id_;
@@ -201,6 +249,7 @@ class ProcessInfo {
   // Handles() is logically const, but updates this member on first retrieval.
   // See https://crashpad.chromium.org/bug/9.
   mutable std::vector<Handle> handles_;
+  HandleOptions handle_options_;
 
   bool is_64_bit_;
   bool is_wow64_;
@@ -211,6 +260,9 @@ class ProcessInfo {
 //!     target process, returns a vector of ranges, representing the readable
 //!     portions of the original range.
 //!
+//! \a memory_info must be sorted by address, with no overlapping regions, as
+//! ProcessInfo::MemoryInfo() is.
+//!
 //! This is a free function for testing, but prefer
 //! ProcessInfo::GetReadableRanges().
 std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
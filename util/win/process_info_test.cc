@@ -422,6 +422,39 @@ TEST(ProcessInfo, AccessibleRangesMiddleUnavailable) {
   EXPECT_EQ(result[1].size(), 35u);
 }
 
+TEST(ProcessInfo, AccessibleRangesManyRegions) {
+  // Alternate committed and free regions of 0x10 bytes, so that queries have to
+  // find their starting region among many.
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  MEMORY_BASIC_INFORMATION64 mbi = {0};
+  for (WinVMAddress index = 0; index < 1000; ++index) {
+    mbi.BaseAddress = index * 0x10;
+    mbi.RegionSize = 0x10;
+    mbi.State = index % 2 ? MEM_FREE : MEM_COMMIT;
+    memory_info.push_back(mbi);
+  }
+
+  std::vector<CheckedRange<WinVMAddress, WinVMSize>> result =
+      GetReadableRangesOfMemoryMap(
+          CheckedRange<WinVMAddress, WinVMSize>(0x2008, 0x30), memory_info);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[0].base(), 0x2008u);
+  EXPECT_EQ(result[0].size(), 0x8u);
+  EXPECT_EQ(result[1].base(), 0x2020u);
+  EXPECT_EQ(result[1].size(), 0x10u);
+
+  // The last committed region is at 0x3e60.
+  result = GetReadableRangesOfMemoryMap(
+      CheckedRange<WinVMAddress, WinVMSize>(0x3e68, 0x100), memory_info);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].base(), 0x3e68u);
+  EXPECT_EQ(result[0].size(), 0x8u);
+
+  result = GetReadableRangesOfMemoryMap(
+      CheckedRange<WinVMAddress, WinVMSize>(0x5000, 0x10), memory_info);
+  EXPECT_TRUE(result.empty());
+}
+
 TEST(ProcessInfo, RequestedBeforeMap) {
   ProcessInfo::MemoryBasicInformation64Vector memory_info;
   MEMORY_BASIC_INFORMATION64 mbi = {0};
@@ -630,6 +663,39 @@ TEST(ProcessInfo, Handles) {
   EXPECT_TRUE(found_mapping_handle);
 }
 
+TEST(ProcessInfo, HandleOptions) {
+  HKEY key;
+  ASSERT_EQ(RegOpenKeyEx(
+                HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft", 0, KEY_READ, &key),
+            ERROR_SUCCESS);
+  ScopedRegistryKey scoped_key(key);
+  ASSERT_TRUE(scoped_key.is_valid());
+
+  {
+    ProcessInfo::HandleOptions options;
+    options.excluded_types.insert(L"Key");
+
+    ProcessInfo info;
+    info.Initialize(GetCurrentProcess());
+    info.SetHandleOptions(options);
+    EXPECT_FALSE(info.Handles().empty());
+    for (const auto& handle : info.Handles()) {
+      EXPECT_NE(handle.type_name, L"Key");
+      EXPECT_NE(handle.handle, HandleToInt(scoped_key.get()));
+    }
+  }
+
+  {
+    ProcessInfo::HandleOptions options;
+    options.max_handles = 2;
+
+    ProcessInfo info;
+    info.Initialize(GetCurrentProcess());
+    info.SetHandleOptions(options);
+    EXPECT_EQ(info.Handles().size(), 2u);
+  }
+}
+
 TEST(ProcessInfo, OutOfRangeCheck) {
   auto safe_memory = base::HeapArray<char>::Uninit(12345);
 
@@ -0,0 +1,163 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/pss_snapshot.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "util/win/get_function.h"
+
+namespace crashpad {
+
+namespace {
+
+// The address space is cloned rather than copied, so capture takes time
+// proportional to the number of pages mapped, not to their contents.
+constexpr PSS_CAPTURE_FLAGS kCaptureFlags =
+    PSS_CAPTURE_VA_CLONE | PSS_CAPTURE_THREADS | PSS_CAPTURE_THREAD_CONTEXT |
+    PSS_CREATE_RELEASE_SECTION;
+
+}  // namespace
+
+PssSnapshot::Thread::Thread()
+    : context(), id(0), teb_address(0), suspend_count(0), priority(0) {}
+
+PssSnapshot::Thread::~Thread() {}
+
+PssSnapshot::PssSnapshot()
+    : threads_(),
+      snapshot_(nullptr),
+      va_clone_process_(nullptr),
+      initialized_() {}
+
+PssSnapshot::~PssSnapshot() {
+  if (snapshot_) {
+    static const auto pss_free_snapshot =
+        GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssFreeSnapshot);
+    DWORD error = pss_free_snapshot(GetCurrentProcess(), snapshot_);
+    if (error != ERROR_SUCCESS) {
+      LOG(ERROR) << "PssFreeSnapshot: "
+                 << logging::SystemErrorCodeToString(error);
+    }
+  }
+}
+
+// The other Pss*() functions are exported alongside PssCaptureSnapshot(), so
+// they are only looked up once it is known to be present.
+bool PssSnapshot::Initialize(HANDLE process) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  static const auto pss_capture_snapshot =
+      GET_FUNCTION(L"kernel32.dll", ::PssCaptureSnapshot);
+  if (!pss_capture_snapshot) {
+    LOG(ERROR) << "PssCaptureSnapshot unavailable";
+    return false;
+  }
+
+  DWORD error =
+      pss_capture_snapshot(process, kCaptureFlags, CONTEXT_ALL, &snapshot_);
+  if (error != ERROR_SUCCESS) {
+    snapshot_ = nullptr;
+    LOG(ERROR) << "PssCaptureSnapshot: "
+               << logging::SystemErrorCodeToString(error);
+    return false;
+  }
+
+  static const auto pss_query_snapshot =
+      GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssQuerySnapshot);
+  PSS_VA_CLONE_INFORMATION va_clone_information;
+  error = pss_query_snapshot(snapshot_,
+                             PSS_QUERY_VA_CLONE_INFORMATION,
+                             &va_clone_information,
+                             sizeof(va_clone_information));
+  if (error != ERROR_SUCCESS) {
+    LOG(ERROR) << "PssQuerySnapshot: "
+               << logging::SystemErrorCodeToString(error);
+    return false;
+  }
+  va_clone_process_ = va_clone_information.VaCloneHandle;
+
+  if (!ReadThreads()) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+HANDLE PssSnapshot::VaCloneProcess() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return va_clone_process_;
+}
+
+const std::vector<PssSnapshot::Thread>& PssSnapshot::Threads() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return threads_;
+}
+
+bool PssSnapshot::ReadThreads() {
+  static const auto pss_walk_marker_create =
+      GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssWalkMarkerCreate);
+  static const auto pss_walk_marker_free =
+      GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssWalkMarkerFree);
+  static const auto pss_walk_snapshot =
+      GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssWalkSnapshot);
+
+  HPSSWALK walk_marker;
+  DWORD error = pss_walk_marker_create(nullptr, &walk_marker);
+  if (error != ERROR_SUCCESS) {
+    LOG(ERROR) << "PssWalkMarkerCreate: "
+               << logging::SystemErrorCodeToString(error);
+    return false;
+  }
+
+  while (true) {
+    PSS_THREAD_ENTRY entry;
+    error = pss_walk_snapshot(
+        snapshot_, PSS_WALK_THREADS, walk_marker, &entry, sizeof(entry));
+    if (error != ERROR_SUCCESS) {
+      break;
+    }
+
+    if (entry.Flags & PSS_THREAD_FLAGS_TERMINATED) {
+      continue;
+    }
+
+    Thread thread;
+    thread.id = entry.ThreadId;
+    thread.teb_address = reinterpret_cast<WinVMAddress>(entry.TebBaseAddress);
+    thread.suspend_count = entry.SuspendCount;
+    thread.priority = entry.Priority;
+    if (entry.ContextRecord && entry.SizeOfContextRecord) {
+      // ContextRecord points into memory owned by walk_marker, which is only
+      // valid until the next walk.
+      const unsigned char* context =
+          reinterpret_cast<const unsigned char*>(entry.ContextRecord);
+      thread.context.assign(context, context + entry.SizeOfContextRecord);
+    }
+    threads_.push_back(std::move(thread));
+  }
+
+  pss_walk_marker_free(walk_marker);
+
+  if (error != ERROR_NO_MORE_ITEMS) {
+    LOG(ERROR) << "PssWalkSnapshot: "
+               << logging::SystemErrorCodeToString(error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_WIN_PSS_SNAPSHOT_H_
+#define CRASHPAD_UTIL_WIN_PSS_SNAPSHOT_H_
+
+#include <windows.h>
+#include <processsnapshot.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/win/address_types.h"
+
+namespace crashpad {
+
+//! \brief Captures a copy of another process with `PssCaptureSnapshot()`.
+//!
+//! The copy consists of a copy-on-write clone of the process’ address space,
+//! and of the state of its threads at the time of capture. Once the copy has
+//! been captured, the original process can be resumed, while the copy is
+//! read at leisure.
+class PssSnapshot {
+ public:
+  //! \brief The state of a thread at the time of capture.
+  struct Thread {
+    Thread();
+    ~Thread();
+
+    //! \brief The thread’s `CONTEXT` record, captured with `CONTEXT_ALL`.
+    std::vector<unsigned char> context;
+
+    uint32_t id;
+    WinVMAddress teb_address;
+    uint32_t suspend_count;
+    int32_t priority;
+  };
+
+  PssSnapshot();
+
+  PssSnapshot(const PssSnapshot&) = delete;
+  PssSnapshot& operator=(const PssSnapshot&) = delete;
+
+  ~PssSnapshot();
+
+  //! \brief Captures \a process.
+  //!
+  //! The capture is consistent only if \a process is suspended while this
+  //! method runs. The snapshot does not depend on \a process remaining
+  //! suspended after this method returns.
+  //!
+  //! \param[in] process The process to capture. It must have
+  //!     `PROCESS_CREATE_PROCESS`, `PROCESS_DUP_HANDLE`,
+  //!     `PROCESS_QUERY_INFORMATION`, and `PROCESS_VM_READ` access. Weak.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged. This
+  //!     fails on systems older than Windows 8.1, where `PssCaptureSnapshot()`
+  //!     is not available.
+  bool Initialize(HANDLE process);
+
+  //! \return A handle to the clone of the captured process’ address space. It
+  //!     may be used in place of the original process handle to read memory.
+  //!     It is valid only for the lifetime of this object.
+  HANDLE VaCloneProcess() const;
+
+  //! \return The threads of the captured process.
+  const std::vector<Thread>& Threads() const;
+
+ private:
+  bool ReadThreads();
+
+  std::vector<Thread> threads_;
+  HPSS snapshot_;
+  HANDLE va_clone_process_;  // owned by snapshot_
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_WIN_PSS_SNAPSHOT_H_
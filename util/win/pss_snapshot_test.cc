@@ -0,0 +1,63 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/pss_snapshot.h"
+
+#include <windows.h>
+
+#include "gtest/gtest.h"
+#include "test/errors.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(PssSnapshot, CaptureSelf) {
+  volatile uint32_t value = 1;
+
+  PssSnapshot pss_snapshot;
+  ASSERT_TRUE(pss_snapshot.Initialize(GetCurrentProcess()));
+
+  // The clone is copy-on-write, so it retains the value at the time of
+  // capture.
+  value = 2;
+
+  uint32_t cloned_value;
+  SIZE_T bytes_read;
+  ASSERT_TRUE(ReadProcessMemory(pss_snapshot.VaCloneProcess(),
+                                const_cast<uint32_t*>(&value),
+                                &cloned_value,
+                                sizeof(cloned_value),
+                                &bytes_read))
+      << ErrorMessage("ReadProcessMemory");
+  EXPECT_EQ(bytes_read, sizeof(cloned_value));
+  EXPECT_EQ(cloned_value, 1u);
+  EXPECT_EQ(value, 2u);
+
+  bool found_current_thread = false;
+  for (const PssSnapshot::Thread& thread : pss_snapshot.Threads()) {
+    EXPECT_NE(thread.teb_address, 0u);
+    EXPECT_GE(thread.context.size(), sizeof(CONTEXT));
+    if (thread.id == GetCurrentThreadId()) {
+      found_current_thread = true;
+      EXPECT_EQ(thread.teb_address,
+                reinterpret_cast<WinVMAddress>(NtCurrentTeb()));
+    }
+  }
+  EXPECT_TRUE(found_current_thread);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad